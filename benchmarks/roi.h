@@ -0,0 +1,36 @@
+/*
+ * Region of interest markers for the cs425 benchmarks, see README.md.
+ *
+ * The markers are address mapped m5ops, which every CPU model, KVM
+ * included, recognizes. cs425_pa3.py --roi maps the m5ops page at
+ * ROI_M5OPS_ADDR in the process, so there's no /dev/mem to map as in
+ * full system. Build with the m5 library of gem5/util/m5:
+ *
+ *   gcc -static -I$GEM5_DIR/include -I$GEM5_DIR/util/m5/src ... \
+ *       -L$GEM5_DIR/util/m5/build/x86/out -lm5
+ */
+
+#ifndef __CS425_ROI_H__
+#define __CS425_ROI_H__
+
+#include <gem5/m5ops.h>
+#include <m5_mmap.h>
+
+#define ROI_M5OPS_ADDR 0xffff0000UL
+
+/* Enter the region of interest, e.g. once the input is parsed. */
+static inline void
+roi_begin(void)
+{
+    m5_mem = (void *)ROI_M5OPS_ADDR;
+    m5_work_begin_addr(0, 0);
+}
+
+/* Leave the region of interest, which ends the simulation. */
+static inline void
+roi_end(void)
+{
+    m5_work_end_addr(0, 0);
+}
+
+#endif /* __CS425_ROI_H__ */
@@ -42,6 +42,7 @@
 
 import m5
 from m5.objects import *
+from m5.util.convert import toMemorySize
 from common.Caches import *
 from common import ObjectList
 
@@ -67,6 +68,20 @@ def _get_cache_opts(level, options):
     if hasattr(options, prefetcher_attr):
         opts['prefetcher'] = _get_hwp(getattr(options, prefetcher_attr))
 
+    # With sectoring, the line size is the tag reach of a sector, and the
+    # system line size is the size of the sub-blocks that are filled
+    sector_size = getattr(options, 'sector_size', 0)
+    if sector_size:
+        opts['tags'] = SectorTags(
+            num_blocks_per_sector=options.cacheline_size // sector_size)
+
+    victim_attr = '{}_victim_entries'.format(level)
+    if getattr(options, victim_attr, 0):
+        if sector_size:
+            fatal("Victim buffers do not support sectored caches.")
+        opts['tags'] = VictimTags(
+            victim_entries=getattr(options, victim_attr))
+
     return opts
 
 def config_cache(options, system):
@@ -104,8 +119,24 @@ def config_cache(options, system):
         if buildEnv['TARGET_ISA'] in ['x86', 'riscv']:
             walk_cache_class = PageTableWalkerCache
 
-    # Set the cache line size of the system
-    system.cache_line_size = options.cacheline_size
+    # Set the cache line size of the system, which is the fill granularity
+    # of the sectored caches
+    sector_size = getattr(options, 'sector_size', 0)
+    if sector_size:
+        if sector_size > options.cacheline_size or \
+           options.cacheline_size % sector_size:
+            fatal("The sector size must divide the cache line size.")
+        system.cache_line_size = sector_size
+    else:
+        system.cache_line_size = options.cacheline_size
+
+    if getattr(options, 'parallel_cpus', False):
+        return config_partitions(options, system, icache_class, dcache_class,
+                                 l2_cache_class, walk_cache_class)
+
+    if getattr(options, 'l3cache', False):
+        return config_shared_l3(options, system, icache_class, dcache_class,
+                                l2_cache_class, walk_cache_class)
 
     # If elastic trace generation is enabled, make sure the memory system is
     # minimal so that compute delays do not include memory access latencies.
@@ -198,6 +229,127 @@ def config_cache(options, system):
 
     return system
 
+def config_shared_l3(options, system, icache_class, dcache_class,
+                     l2_cache_class, walk_cache_class):
+    """Give every CPU private L1 and L2 caches, and share an L3 between
+    the L2s on a crossbar in front of the memory bus. A mostly exclusive
+    L3 behaves as a victim cache: it is only filled by L2 evictions, so
+    the L2s also write back their clean lines, and the snoop filter of
+    the memory bus has to cover the L2s as well as the L3."""
+    if not (options.caches and options.l2cache):
+        fatal("--l3cache needs --caches and --l2cache")
+    if options.memchecker or options.external_memory_system:
+        fatal("--l3cache does not support --memchecker or "
+              "an external memory system")
+
+    exclusive = options.l3_clusivity == 'mostly_excl'
+
+    system.l3 = L3Cache(clk_domain=system.cpu_clk_domain,
+                        clusivity=options.l3_clusivity,
+                        **_get_cache_opts('l3', options))
+    system.tol3bus = L2XBar(clk_domain=system.cpu_clk_domain)
+    system.l3.cpu_side = system.tol3bus.mem_side_ports
+    system.l3.mem_side = system.membus.cpu_side_ports
+
+    # size the snoop filters to the lines that can be cached above
+    # them, counting the L1s as the L2s are only mostly inclusive
+    private_bytes = options.num_cpus * sum(
+        [toMemorySize(s) for s in
+         [options.l1i_size, options.l1d_size, options.l2_size]])
+    l3_bytes = toMemorySize(options.l3_size)
+    system.tol3bus.snoop_filter.max_capacity = '%dB' % private_bytes
+    system.membus.snoop_filter.max_capacity = '%dB' % \
+        (l3_bytes + private_bytes if exclusive else l3_bytes)
+
+    for cpu in system.cpu:
+        if walk_cache_class:
+            iwalkcache = walk_cache_class()
+            dwalkcache = walk_cache_class()
+        else:
+            iwalkcache = None
+            dwalkcache = None
+
+        l2 = l2_cache_class(**_get_cache_opts('l2', options))
+        if options.clusivity:
+            l2.clusivity = options.clusivity
+        if exclusive:
+            l2.writeback_clean = True
+
+        cpu.addTwoLevelCacheHierarchy(
+            icache_class(**_get_cache_opts('l1i', options)),
+            dcache_class(**_get_cache_opts('l1d', options)),
+            l2, iwalkcache, dwalkcache)
+        cpu.createInterruptController()
+        cpu.connectAllPorts(system.tol3bus.cpu_side_ports,
+                            system.membus.cpu_side_ports,
+                            system.membus.mem_side_ports)
+
+    return system
+
+def config_partitions(options, system, icache_class, dcache_class,
+                      l2_cache_class, walk_cache_class):
+    """Give every CPU a private two-level cache hierarchy on an event
+    queue of its own. The L2 caches reach the memory bus, on event queue
+    0, through a PartitionBridge, whose delay is the lookahead that lets
+    the partitions run in parallel. The bridges do not forward snoops,
+    so the caches are only meant for workloads that do not share memory.
+    Without caches, the CPUs reach the memory bus directly, which keeps
+    the memory shared by the threads of a process coherent."""
+    if options.caches != options.l2cache:
+        fatal("--parallel-cpus needs both --caches and --l2cache, or "
+              "neither")
+    if options.memchecker or options.external_memory_system:
+        fatal("--parallel-cpus does not support --memchecker or "
+              "an external memory system")
+
+    for i, cpu in enumerate(system.cpu):
+        if walk_cache_class:
+            iwalkcache = walk_cache_class()
+            dwalkcache = walk_cache_class()
+        else:
+            iwalkcache = None
+            dwalkcache = None
+
+        if options.caches:
+            cpu.addTwoLevelCacheHierarchy(
+                icache_class(**_get_cache_opts('l1i', options)),
+                dcache_class(**_get_cache_opts('l1d', options)),
+                l2_cache_class(**_get_cache_opts('l2', options)),
+                iwalkcache, dwalkcache)
+        else:
+            cpu.partition_xbar = L2XBar()
+            cpu.connectCachedPorts(cpu.partition_xbar.cpu_side_ports)
+            cpu._cached_ports = ['partition_xbar.mem_side_ports']
+        cpu.createInterruptController()
+
+        # The CPU and everything below it inherit its event queue,
+        # except for the bridges towards the CPU, which live on the
+        # memory bus side.
+        cpu.eventq_index = i + 1
+
+        cpu.mem_bridge = PartitionBridge(delay=options.partition_delay)
+        cpu.connectCachedPorts(cpu.mem_bridge.cpu_side_port)
+        cpu.mem_bridge.mem_side_port = system.membus.cpu_side_ports
+
+        # Interrupt controllers with ports need a bridge per port
+        int_bridges = []
+        for p in cpu._uncached_interrupt_request_ports:
+            bridge = PartitionBridge(delay=options.partition_delay)
+            exec('cpu.%s = bridge.cpu_side_port' % p)
+            bridge.mem_side_port = system.membus.cpu_side_ports
+            int_bridges.append(bridge)
+        for p in cpu._uncached_interrupt_response_ports:
+            bridge = PartitionBridge(delay=options.partition_delay,
+                                     eventq_index=0,
+                                     mem_side_eventq_index=i + 1)
+            bridge.cpu_side_port = system.membus.mem_side_ports
+            exec('cpu.%s = bridge.mem_side_port' % p)
+            int_bridges.append(bridge)
+        if int_bridges:
+            cpu.int_bridges = int_bridges
+
+    return system
+
 # ExternalSlave provides a "port", but when that port connects to a cache,
 # the connecting CPU SimObject wants to refer to its "cpu_side".
 # The 'ExternalCache' class provides this adaptation by rewriting the name,
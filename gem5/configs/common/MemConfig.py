@@ -37,8 +37,31 @@ import m5.objects
 from common import ObjectList
 from common import HMC
 
+def auto_addr_mapping(interface, intlv_size):
+    """
+    Pick the address mapping of a DRAM that spreads consecutive bursts
+    over the channels, banks and ranks, while keeping the row locality
+    that an open page policy relies on.
+    """
+
+    # a closed page gains nothing from sequential bursts sharing a
+    # row, so interleave them over the banks and ranks instead
+    if interface.page_policy.value in ['close', 'close_adaptive']:
+        return 'RoCoRaBaCh'
+
+    # with channels interleaved at row buffer granularity or coarser,
+    # the column bits have to sit below the channel bits
+    rowbuffer_size = interface.device_rowbuffer_size.value * \
+        interface.devices_per_rank.value
+    if intlv_size >= rowbuffer_size:
+        return 'RoRaBaChCo'
+
+    # otherwise fill a row in each channel before moving to the next
+    # bank and rank
+    return 'RoRaBaCoCh'
+
 def create_mem_intf(intf, r, i, intlv_bits, intlv_size,
-                    xor_low_bit):
+                    xor_low_bit, addr_mapping=None):
     """
     Helper function for creating a single memoy controller from the given
     options.  This function is invoked multiple times in config_mem function
@@ -62,8 +85,16 @@ def create_mem_intf(intf, r, i, intlv_bits, intlv_size,
     # mapping and row-buffer size
     interface = intf()
 
+    # Override the address mapping of DRAMs if requested
+    if addr_mapping and issubclass(intf, (m5.objects.DRAMInterface,
+                                          m5.objects.AnalyticalDRAM)):
+        if addr_mapping == 'auto':
+            addr_mapping = auto_addr_mapping(interface, intlv_size)
+        interface.addr_mapping = addr_mapping
+
     # Only do this for DRAMs
-    if issubclass(intf, m5.objects.DRAMInterface):
+    if issubclass(intf, (m5.objects.DRAMInterface,
+                         m5.objects.AnalyticalDRAM)):
         # If the channel bits are appearing after the column
         # bits, we need to add the appropriate number of bits
         # for the row buffer size
@@ -134,6 +165,7 @@ def config_mem(options, system):
     opt_dram_powerdown = getattr(options, "enable_dram_powerdown", None)
     opt_mem_channels_intlv = getattr(options, "mem_channels_intlv", 128)
     opt_xor_low_bit = getattr(options, "xor_low_bit", 0)
+    opt_addr_mapping = getattr(options, "mem_addr_mapping", None)
 
     if opt_mem_type == "HMC_2500_1x32":
         HMChost = HMC.config_hmc_host_ctrl(options, system)
@@ -200,11 +232,13 @@ def config_mem(options, system):
             if opt_mem_type and (not opt_nvm_type or range_iter % 2 != 0):
                 # Create the DRAM interface
                 dram_intf = create_mem_intf(intf, r, i,
-                    intlv_bits, intlv_size, opt_xor_low_bit)
+                    intlv_bits, intlv_size, opt_xor_low_bit,
+                    opt_addr_mapping)
 
                 # Set the number of ranks based on the command-line
                 # options if it was explicitly set
-                if issubclass(intf, m5.objects.DRAMInterface) and \
+                if issubclass(intf, (m5.objects.DRAMInterface,
+                                     m5.objects.AnalyticalDRAM)) and \
                    opt_mem_ranks:
                     dram_intf.ranks_per_channel = opt_mem_ranks
 
@@ -130,6 +130,18 @@ def addNoISAOptions(parser):
                         help="Enable low-power states in DRAMInterface")
     parser.add_argument("--mem-channels-intlv", type=int, default=0,
                         help="Memory channels interleave")
+    parser.add_argument("--mem-addr-mapping", default=None,
+                        choices=["auto", "RoRaBaChCo", "RoRaBaCoCh",
+                                 "RoCoRaBaCh"],
+                        help="DRAM address mapping, 'auto' picks the one "
+                        "that maximises parallelism for the page policy "
+                        "and channel interleaving")
+    parser.add_argument("--mem-link-compressor", default=None,
+                        choices=["BDI", "CPack", "FPC", "FPCD",
+                                 "RepeatedQwordsCompressor",
+                                 "ZeroCompressor"],
+                        help="compressor applied to the lines moved over "
+                        "the DRAM data bus, to model link compression")
 
     parser.add_argument("--memchecker", action="store_true")
 
@@ -140,6 +152,8 @@ def addNoISAOptions(parser):
                         help="use external port for SystemC TLM cosimulation")
     parser.add_argument("--caches", action="store_true")
     parser.add_argument("--l2cache", action="store_true")
+    parser.add_argument("--l3cache", action="store_true",
+                        help="Add an L3 shared by the private L2 caches")
     parser.add_argument("--num-dirs", type=int, default=1)
     parser.add_argument("--num-l2caches", type=int, default=1)
     parser.add_argument("--num-l3caches", type=int, default=1)
@@ -150,11 +164,69 @@ def addNoISAOptions(parser):
     parser.add_argument("--l3_size", type=str, default="16MB")
     parser.add_argument("--l1d_assoc", type=int, default=1)
     parser.add_argument("--l1i_assoc", type=int, default=4)
+    parser.add_argument("--l1d_victim_entries", type=int, default=0,
+                        help="Back the L1D with a fully associative victim "
+                        "buffer of this many lines, checked on its misses "
+                        "(0 disables it)")
     parser.add_argument("--l2_assoc", type=int, default=4)
     parser.add_argument("--l3_assoc", type=int, default=16)
     parser.add_argument("--cacheline_size", type=int, default=32)
+    parser.add_argument("--sector_size", type=int, default=0,
+                        help="Sector the caches: --cacheline_size is the "
+                        "tag reach, and only the requested sub-blocks of "
+                        "this many bytes are fetched and tracked as valid "
+                        "(0 disables sectoring)")
     parser.add_argument("--clusivity", type=str)
+    parser.add_argument("--l3_clusivity", default="mostly_excl",
+                        choices=["mostly_incl", "mostly_excl"],
+                        help="Clusivity of the L3, mostly_excl makes it a "
+                        "victim cache of the L2s")
     parser.add_argument("--pref_degree", type=int, default=1)
+    parser.add_argument("--pref_feedback_interval", type=int, default=0,
+                        help="Adapt the prefetch degree and distance to "
+                        "the prefetch accuracy, lateness and pollution, "
+                        "re-evaluated every this many issued prefetches "
+                        "(0 keeps the fixed --pref_degree)")
+    parser.add_argument("--share_line_buffers", action="store_true",
+                        help="Share line payloads between the caches "
+                        "(copy-on-write) instead of copying them on every "
+                        "fill and writeback")
+    # shadow tag stores fed with the requests of the simulated caches
+    parser.add_argument("--l1d-shadow", action="append", default=[],
+                        metavar="SIZE:ASSOC[:RP[:LINE]]",
+                        help="Also evaluate this L1D geometry and "
+                        "replacement policy on the simulated L1D request "
+                        "stream (timing CPUs only, may be repeated)")
+    parser.add_argument("--l2-shadow", action="append", default=[],
+                        metavar="SIZE:ASSOC[:RP[:LINE]]",
+                        help="Same as --l1d-shadow, for the L2 cache")
+    parser.add_argument("--l2-mrc", default="", metavar="ASSOC,...",
+                        help="Measure the LRU miss ratio curves of L2 caches "
+                        "with these associativities (0 for fully "
+                        "associative) on the L2 request stream")
+    parser.add_argument("--l2-mrc-sizes", default="16kB:8MB",
+                        metavar="MIN:MAX",
+                        help="Power of two L2 sizes covered by --l2-mrc")
+    # x86 TLB hierarchy
+    parser.add_argument("--stlb_size", type=int, default=0,
+                        help="Entries of a unified second level TLB behind "
+                        "the ITB and the DTB (0 for none)")
+    parser.add_argument("--stlb_assoc", type=int, default=0,
+                        help="Associativity of the second level TLB (0 for "
+                        "fully associative)")
+    parser.add_argument("--pwc_entries", type=int, default=0,
+                        help="Entries of each level of the page walk caches "
+                        "(0 for none, full system only)")
+    parser.add_argument("--parallel-cpus", action="store_true",
+                        help="Simulate every CPU and its private L1 and L2 "
+                        "caches on a host thread of its own. The caches of "
+                        "different CPUs are not kept coherent, so "
+                        "multi-threaded workloads must run without "
+                        "--caches.")
+    parser.add_argument("--partition-delay", default="10ns",
+                        help="Latency between the CPU partitions and the "
+                        "memory bus when using --parallel-cpus, also used "
+                        "as the simulation quantum")
 
     # Enable Ruby
     parser.add_argument("--ruby", action="store_true")
@@ -171,6 +243,15 @@ def addNoISAOptions(parser):
     parser.add_argument("--maxtime", type=float, default=None,
                         help="Run to the specified absolute simulated time in "
                         "seconds")
+    parser.add_argument("--host-profile-period", type=int, default=0,
+                        metavar="N",
+                        help="Time one in N events with the host cycle "
+                        "counter and write host_profile.txt to the output "
+                        "directory")
+    parser.add_argument("--host-time-stats", action="store_true",
+                        help="Add hostTime stats with the host time spent "
+                        "in the events and timing port handlers of every "
+                        "SimObject")
     parser.add_argument(
         "-P", "--param", action="append", default=[],
         help="Set a SimObject parameter relative to the root node. "
@@ -198,6 +279,12 @@ def addCommonOptions(parser):
     parser.add_argument("--rp-type", default=None,
                         choices=ObjectList.rp_list.get_names(),
                         help="type of replacement policy to run with")
+    parser.add_argument("--rp-leader-sets", type=int, default=None,
+                        help="leader sets per sub-policy of set-dueling "
+                        "replacement policies (DIPRP, DRRIPRP)")
+    parser.add_argument("--rp-psel-bits", type=int, default=None,
+                        help="policy selector width of set-dueling "
+                        "replacement policies")
     parser.add_argument("--list-bp-types",
                         action=ListBp, nargs=0,
                         help="List available branch predictor types")
@@ -221,6 +308,9 @@ def addCommonOptions(parser):
 
     parser.add_argument("--btb_entries", type=int, default=2048)
     parser.add_argument("--ras_size", type=int, default=2048)
+    parser.add_argument("--bp-trace", default="",
+                        help="Record the committed branches in this trace "
+                        "file (see tutorial/bpred_replay.py)")
     #-------------------------------------------------------
 
     # Out-of-Order CPU wrapper for cs425 -- pa2
@@ -255,7 +345,70 @@ def addCommonOptions(parser):
     parser.add_argument("--fmult_pipelined", type=int, default=1)
     parser.add_argument("--num_float_FUs", type=int, default=2)
     #-------------------------------------------------------
-    
+
+    # Post-initialization checkpoints shared by sweeps for cs425
+    parser.add_argument("--init-checkpoint", default=None,
+                        help="Write a checkpoint of the initialized system "
+                        "to this directory and exit")
+    parser.add_argument("--restore-init-checkpoint", default=None,
+                        help="Start from a checkpoint written with "
+                        "--init-checkpoint")
+    parser.add_argument("--config-only", action="store_true",
+                        help="Write the configuration (config.ini) and exit "
+                        "once instantiated, e.g. for cs425_cached.py")
+    parser.add_argument("--binary-checkpoints", action="store_true",
+                        help="Write checkpoints as a binary container "
+                        "rather than INI text, see util/cpt_convert.py")
+    parser.add_argument("--fast-forward-cpu", default="AtomicSimpleCPU",
+                        choices=ObjectList.cpu_list.get_names(),
+                        help="CPU to run the --fast-forward instructions "
+                        "on before switching to --cpu-type, X86KvmCPU "
+                        "runs them natively")
+    parser.add_argument("--roi", action="store_true",
+                        help="Run on --fast-forward-cpu up to the "
+                        "m5_work_begin marker of the program, then "
+                        "simulate its region of interest on --cpu-type "
+                        "up to m5_work_end, see benchmarks/README.md")
+    parser.add_argument("--smarts-period", type=int, default=0,
+                        help="SMARTS systematic sampling: measure one "
+                        "unit every this many instructions and "
+                        "functionally warm on --fast-forward-cpu in "
+                        "between")
+    parser.add_argument("--smarts-unit", type=int, default=1000,
+                        help="Instructions in a SMARTS measurement unit")
+    parser.add_argument("--smarts-warmup", type=int, default=2000,
+                        help="Detailed warmup instructions before each "
+                        "SMARTS measurement unit")
+    parser.add_argument("--smarts-error", type=float, default=0.03,
+                        help="Stop sampling once the CPI confidence "
+                        "interval is within this fraction of the mean")
+    parser.add_argument("--smarts-z", type=float, default=3.0,
+                        help="Standard score of the CPI confidence "
+                        "interval, 3.0 for 99.7%% confidence")
+    parser.add_argument("--smarts-min-units", type=int, default=30,
+                        help="Measure at least this many SMARTS units "
+                        "before checking the confidence interval")
+    parser.add_argument("--state-digest-interval", type=int, default=0,
+                        help="Record a digest of the architectural state "
+                        "every this many instructions of the detailed CPU, "
+                        "see util/cs425_diffval.py")
+    parser.add_argument("--state-digest-mem-every", type=int, default=16,
+                        help="Also digest the memory contents every this "
+                        "many state digests (0 to never)")
+    parser.add_argument("--fork-sweep", action="append", default=[],
+                        metavar="OBJ.PARAM=V1,V2,...",
+                        help="Fork a simulation of the detailed part per "
+                        "value of the parameter of OBJ, relative to the "
+                        "system, once warmed up. Only parameters that can "
+                        "change after instantiation may be swept, e.g. "
+                        "l2cache.prefetcher.degree, "
+                        "l2cache.tags.replacement_policy (give the class "
+                        "names of the policies) or mem_ctrl.mem_sched_policy."
+                        " Repeat to sweep every combination")
+    parser.add_argument("--fork-sweep-jobs", type=int, default=0,
+                        help="Simulations of a --fork-sweep running at the "
+                        "same time (default: one per host CPU)")
+
 
     parser.add_argument("--list-indirect-bp-types",
                         action=ListIndirectBP, nargs=0,
@@ -320,6 +473,10 @@ def addCommonOptions(parser):
                         help="""Data dependency trace file input to
                       Elastic Trace probe in a capture simulation and
                       Trace CPU in a replay simulation""", default="")
+    parser.add_argument("--data-trace-start", action="store", type=str,
+                        help="""Data dependency trace record to start the
+                      replay from, or comma separated records for each
+                      Trace CPU""", default="0")
 
     # dist-gem5 options
     parser.add_argument("--dist", action="store_true",
@@ -446,6 +603,11 @@ def addCommonOptions(parser):
     parser.add_argument(
         "-F", "--fast-forward", action="store", type=str, default=None,
         help="Number of instructions to fast forward before switching")
+    parser.add_argument(
+        "--bp-functional-warming", action="store_true", default=False,
+        help="""Train the branch predictor of the switched-in CPU while fast
+                forwarding, so that detailed simulation starts with a warm
+                predictor (requires a simple CPU to fast forward with)""")
     parser.add_argument(
         "-S", "--simpoint", action="store_true", default=False,
         help="""Use workload simpoints as an instruction offset for
@@ -173,7 +173,7 @@ def findCptDir(options, cptdir, testsys):
         simpoint_start_insts.append(warmup_length)
         simpoint_start_insts.append(warmup_length + interval_length)
         testsys.cpu[0].simpoint_start_insts = simpoint_start_insts
-        if testsys.switch_cpus != None:
+        if getattr(testsys, "switch_cpus", None) != None:
             testsys.switch_cpus[0].simpoint_start_insts = simpoint_start_insts
 
         print("Resuming from SimPoint", end=' ')
@@ -488,6 +488,13 @@ def run(options, root, testsys, cpu_class):
                     options.indirect_bp_type)
                 switch_cpus[i].branchPred.indirectBranchPred = \
                     IndirectBPClass()
+            if options.bp_functional_warming:
+                # The fast forwarding CPU drives the predictor of the
+                # detailed CPU, which is then warm when switching in
+                if not isinstance(testsys.cpu[i], BaseSimpleCPU):
+                    fatal("--bp-functional-warming requires a simple CPU "
+                          "to fast forward with")
+                testsys.cpu[i].branchPred = switch_cpus[i].branchPred
 
         # If elastic tracing is enabled attach the elastic trace probe
         # to the switch CPUs
@@ -612,6 +619,10 @@ def run(options, root, testsys, cpu_class):
     if options.checkpoint_restore:
         cpt_starttick, checkpoint_dir = findCptDir(options, cptdir, testsys)
     root.apply_config(options.param)
+    if options.host_profile_period:
+        root.host_profile_period = options.host_profile_period
+    if options.host_time_stats:
+        root.host_time_stats = True
     m5.instantiate(checkpoint_dir)
 
     # Initialization is complete.  If we're not in control of simulation
@@ -63,15 +63,12 @@ if args.cpu_type != "TraceCPU":
     fatal("This is a script for elastic trace replay simulation, use "\
             "--cpu-type=TraceCPU\n");
 
-if args.num_cpus > 1:
-    fatal("This script does not support multi-processor trace replay.\n")
-
 # In this case FutureClass will be None as there is not fast forwarding or
 # switching
 (CPUClass, test_mem_mode, FutureClass) = Simulation.setCPUClass(args)
 CPUClass.numThreads = numThreads
 
-system = System(cpu = CPUClass(cpu_id=0),
+system = System(cpu = [CPUClass(cpu_id=i) for i in range(args.num_cpus)],
                 mem_mode = test_mem_mode,
                 mem_ranges = [AddrRange(args.mem_size)],
                 cache_line_size = args.cacheline_size)
@@ -103,9 +100,18 @@ for cpu in system.cpu:
 for cpu in system.cpu:
     cpu.createThreads()
 
-# Assign input trace files to the Trace CPU
-system.cpu.instTraceFile=args.inst_trace_file
-system.cpu.dataTraceFile=args.data_trace_file
+# Assign input trace files to the Trace CPUs. They all replay the same
+# traces, possibly from different records of the data trace, which they
+# then share if it was converted by util/map_inst_dep_trace.py
+starts = [int(s) for s in args.data_trace_start.split(',')]
+if len(starts) == 1:
+    starts *= args.num_cpus
+if len(starts) != args.num_cpus:
+    fatal("--data-trace-start needs one record or one per CPU\n")
+for cpu, start in zip(system.cpu, starts):
+    cpu.instTraceFile=args.inst_trace_file
+    cpu.dataTraceFile=args.data_trace_file
+    cpu.dataTraceStart=start
 
 # Configure the classic memory system args
 MemClass = Simulation.setMemClass(args)
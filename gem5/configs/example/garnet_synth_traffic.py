@@ -56,6 +56,12 @@ parser.add_argument("-i", "--injectionrate", type=float, default=0.1,
                         Takes decimal value between 0 to 1 (eg. 0.225). \
                         Number of digits after 0 depends upon --precision.")
 
+parser.add_argument("--injection-rates", type=float, nargs="+",
+                    default=[], metavar="I",
+                    help="Sweep these injection rates back to back, each \
+                        for --sim-cycles, dumping the stats after each \
+                        one. Overrides --injectionrate.")
+
 parser.add_argument("--precision", type=int, default=3,
                     help="Number of digits of precision after decimal point\
                         for injection rate")
@@ -95,6 +101,7 @@ cpus = [ GarnetSyntheticTraffic(
                      sim_cycles=args.sim_cycles,
                      traffic_type=args.synthetic,
                      inj_rate=args.injectionrate,
+                     inj_rates=args.injection_rates,
                      inj_vnet=args.inj_vnet,
                      precision=args.precision,
                      num_dest=args.num_dirs) \
@@ -137,7 +144,15 @@ m5.ticks.setGlobalFrequency('1ps')
 # instantiate configuration
 m5.instantiate()
 
-# simulate until program terminates
+# simulate until program terminates, dumping the stats of every
+# injection rate of a sweep separately
 exit_event = m5.simulate(args.abs_max_tick)
+for rate in args.injection_rates[:-1]:
+    if exit_event.getCause() != "Network Tester completed phase":
+        break
+    print('Injection rate', rate, 'completed @ tick', m5.curTick())
+    m5.stats.dump()
+    m5.stats.reset()
+    exit_event = m5.simulate(args.abs_max_tick)
 
 print('Exiting @ tick', m5.curTick(), 'because', exit_event.getCause())
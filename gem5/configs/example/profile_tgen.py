@@ -0,0 +1,126 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Run the memory traffic of a program, emulated by ProfileGen from a
+# profile of util/traffic_profile.py, through an optional L2 cache and a
+# memory, to sweep L2 and memory configurations at the speed of a
+# traffic generator rather than the one of a detailed CPU.
+#
+# The generator is closed loop: it has at most the max_outstanding
+# requests of the profile (or --mlp) in flight, as the program had its
+# memory level parallelism, and the think time of the profile between
+# two requests. The traffic only follows the statistics of the profile,
+# so the results are as good as the match of the footprint, the reuse
+# and the strides. Check, for a configuration of the real run, the L2
+# miss rate and the memory bandwidth against the real benchmark stats
+# before trusting a sweep.
+#
+# e.g.
+#   build/X86/gem5.opt configs/example/profile_tgen.py \
+#       --profile mcf.json --l2-size 1MB --mem-type DDR4_2400_8x8
+
+import argparse
+import json
+
+import m5
+from m5.objects import *
+from m5.util import addToPath, convert, fatal
+
+addToPath('../')
+
+from common import ObjectList
+from common import MemConfig
+
+parser = argparse.ArgumentParser()
+parser.add_argument("--profile", required=True,
+                    help="Profile of util/traffic_profile.py")
+parser.add_argument("--duration", default="10ms",
+                    help="Simulated time to generate traffic for")
+parser.add_argument("--mlp", type=int, default=None,
+                    help="Outstanding requests, overrides the profile")
+parser.add_argument("--l2-size", default=None,
+                    help="Size of the L2 cache, none by default")
+parser.add_argument("--l2-assoc", type=int, default=8)
+parser.add_argument("--mem-type", default="DDR3_1600_8x8",
+                    choices=ObjectList.mem_list.get_names(),
+                    help="type of memory to use")
+parser.add_argument("--mem-channels", type=int, default=1)
+parser.add_argument("--mem-ranks", type=int, default=None)
+parser.add_argument("--mem-size", default="4GB",
+                    help="Size of the memory, it must hold the regions of "
+                    "the profile")
+args = parser.parse_args()
+
+with open(args.profile) as f:
+    profile = json.load(f)
+streams = profile['streams']
+
+system = System(membus=SystemXBar())
+system.clk_domain = SrcClockDomain(clock='2.0GHz',
+                                   voltage_domain=VoltageDomain())
+system.cache_line_size = profile['line_size']
+
+mem_range = AddrRange(args.mem_size)
+if max(s['end'] for s in streams) > mem_range.end:
+    fatal("The profile regions do not fit in %s of memory", args.mem_size)
+system.mem_ranges = [mem_range]
+system.mmap_using_noreserve = True
+MemConfig.config_mem(args, system)
+
+mlp = args.mlp or profile['max_outstanding']
+system.tgen = PyTrafficGen(max_outstanding_reqs=mlp)
+
+if args.l2_size:
+    system.l2 = Cache(size=args.l2_size, assoc=args.l2_assoc,
+                      tag_latency=20, data_latency=20, response_latency=20,
+                      mshrs=max(mlp, 20), tgts_per_mshr=12)
+    system.tgen.port = system.l2.cpu_side
+    system.l2.mem_side = system.membus.cpu_side_ports
+else:
+    system.tgen.port = system.membus.cpu_side_ports
+system.system_port = system.membus.cpu_side_ports
+
+root = Root(full_system=False, system=system)
+root.system.mem_mode = 'timing'
+
+m5.instantiate()
+
+duration = m5.ticks.fromSeconds(convert.anyToLatency(args.duration))
+
+def traffic():
+    yield system.tgen.createProfile(
+        duration, profile['line_size'],
+        profile['min_period'], profile['max_period'], 0,
+        [s['start'] for s in streams], [s['end'] for s in streams],
+        [s['weight'] for s in streams],
+        [s['read_fraction'] for s in streams],
+        [[int(stride) for stride, _ in s['strides']] for s in streams],
+        [[prob for _, prob in s['strides']] for s in streams],
+        [[int(dist) for dist, _ in s['reuse']] for s in streams],
+        [[prob for _, prob in s['reuse']] for s in streams])
+    yield system.tgen.createExit(0)
+
+system.tgen.start(traffic())
+
+exit_event = m5.simulate()
+print("Exiting @ tick %i because %s" % (m5.curTick(), exit_event.getCause()))
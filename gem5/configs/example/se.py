@@ -164,6 +164,12 @@ if args.smt and args.num_cpus > 1:
 
 np = args.num_cpus
 mp0_path = multiprocesses[0].executable
+
+# The threads a process clones onto the other CPUs share its memory
+if args.parallel_cpus and args.caches and np > 1 and \
+   len(multiprocesses) == 1:
+    fatal("--parallel-cpus does not keep the caches of a multi-threaded "
+          "workload coherent, run it without --caches")
 system = System(cpu = [CPUClass(cpu_id=i) for i in range(np)],
                 mem_mode = test_mem_mode,
                 mem_ranges = [AddrRange(args.mem_size)],
@@ -268,4 +274,22 @@ if args.wait_gdb:
     system.workload.wait_for_remote_gdb = True
 
 root = Root(full_system = False, system = system)
+
+if args.parallel_cpus:
+    # The bridges between the CPU partitions and the memory bus bound
+    # how far the partitions may run ahead of each other
+    m5.ticks.fixGlobalFrequency()
+    root.sim_quantum = m5.ticks.fromSeconds(
+        m5.util.convert.anyToLatency(args.partition_delay))
+
+if args.ruby and args.network == "garnet" and args.network_partitions > 1:
+    # The links leaving each network partition bound how far it may run
+    # ahead of the others
+    m5.ticks.fixGlobalFrequency()
+    quantum = args.link_latency * m5.ticks.fromSeconds(
+        m5.util.convert.anyToLatency(args.ruby_clock))
+    if args.parallel_cpus:
+        quantum = min(quantum, m5.ticks.fromSeconds(
+            m5.util.convert.anyToLatency(args.partition_delay)))
+    root.sim_quantum = quantum
 Simulation.run(args, root, system, FutureClass)
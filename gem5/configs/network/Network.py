@@ -42,8 +42,12 @@ def define_options(parser):
         help="the number of rows in the mesh topology")
     parser.add_argument(
         "--network", default="simple",
-        choices=['simple', 'garnet'],
-        help="""'simple'|'garnet' (garnet2.0 will be deprecated.)""")
+        choices=['simple', 'garnet', 'analytical'],
+        help="""'simple'|'garnet'|'analytical' (garnet2.0 will be
+            deprecated.) 'analytical' approximates the latencies of
+            garnet with queueing delays. Its links carry their
+            bandwidth_factor in bytes per cycle, 16 by default like
+            the default --link-width-bits.""")
     parser.add_argument(
         "--router-latency", action="store", type=int,
         default=1,
@@ -80,6 +84,13 @@ def define_options(parser):
         "--garnet-deadlock-threshold", action="store",
         type=int, default=50000,
         help="network-level deadlock threshold.")
+    parser.add_argument(
+        "--network-partitions", action="store", type=int, default=1,
+        help="""number of host threads simulating the garnet routers.
+            Routers of consecutive ids share a thread. The latency of
+            the links between two partitions, and between the routers
+            and the network interfaces, bounds the simulation
+            quantum.""")
 
 def create_network(options, ruby):
 
@@ -99,6 +110,13 @@ def create_network(options, ruby):
         RouterClass = GarnetRouter
         InterfaceClass = GarnetNetworkInterface
 
+    elif options.network == "analytical":
+        NetworkClass = AnalyticalNetwork
+        IntLinkClass = BasicIntLink
+        ExtLinkClass = BasicExtLink
+        RouterClass = BasicRouter
+        InterfaceClass = None
+
     else:
         NetworkClass = SimpleNetwork
         IntLinkClass = SimpleIntLink
@@ -194,7 +212,50 @@ def init_network(options, network, InterfaceClass):
                   for (i,n) in enumerate(network.ext_links)]
         network.netifs = netifs
 
+    if options.network == "garnet" and options.network_partitions > 1:
+        partition_network(options.network_partitions, network)
+
     if options.network_fault_model:
         assert(options.network == "garnet")
         network.enable_fault_model = True
         network.fault_model = FaultModel()
+
+def partition_network(num_partitions, network):
+    """Simulate the routers of a garnet network on num_partitions event
+    queues, e.g. bands of rows in a mesh. Every link runs on the queue of
+    the object it takes the flits from, and every bridge on the queue of
+    the router at its end. The network interfaces stay on queue 0 with
+    the controllers."""
+
+    num_routers = len(network.routers)
+    if num_partitions > num_routers:
+        fatal("%d network partitions for %d routers" %
+              (num_partitions, num_routers))
+
+    def partition(router):
+        return router.router_id * num_partitions // num_routers
+
+    for router in network.routers:
+        router.eventq_index = partition(router)
+
+    for intLink in network.int_links:
+        src = partition(intLink.src_node)
+        dst = partition(intLink.dst_node)
+        intLink.network_link.eventq_index = src
+        intLink.credit_link.eventq_index = dst
+        intLink.src_net_bridge.eventq_index = src
+        intLink.src_cred_bridge.eventq_index = src
+        intLink.dst_net_bridge.eventq_index = dst
+        intLink.dst_cred_bridge.eventq_index = dst
+
+    for extLink in network.ext_links:
+        # index 0 is the direction into the network, 1 out of it
+        rtr = partition(extLink.int_node)
+        extLink.network_links[0].eventq_index = 0
+        extLink.network_links[1].eventq_index = rtr
+        extLink.credit_links[0].eventq_index = rtr
+        extLink.credit_links[1].eventq_index = 0
+        for bridge in extLink.ext_net_bridge + extLink.ext_cred_bridge:
+            bridge.eventq_index = 0
+        for bridge in extLink.int_net_bridge + extLink.int_cred_bridge:
+            bridge.eventq_index = rtr
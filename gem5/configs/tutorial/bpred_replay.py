@@ -0,0 +1,85 @@
+# Replay a branch trace recorded with cs425_pa3.py --bp-trace against one or
+# more branch predictor configurations, without simulating a CPU. The trace
+# is read once and every configuration sees the same branch stream; the
+# usual branch predictor statistics end up in stats.txt, one set per
+# predictor (system.replay.predictors0, system.replay.predictors1, ...).
+#
+# e.g. compare three GAp history sizes and the local predictor:
+#   gem5.opt configs/tutorial/bpred_replay.py --trace=m5out/branches.gz \
+#       --predictor=GApPred --sweep=history_size=2,4,8 --predictor=LocalBP
+
+import m5
+
+import argparse
+import copy
+import itertools
+
+from m5.objects import *
+from m5.util import fatal
+from staticpred import *
+from gap import *
+from localpred import *
+from pag import *
+
+m5.util.addToPath('../')
+from common import Options
+from common import ObjectList
+
+parser = argparse.ArgumentParser(
+    description='Trace driven branch predictor evaluation.')
+
+# the predictor wrappers pick their sizes from the common options
+Options.addCommonOptions(parser)
+
+parser.add_argument("--trace", required=True,
+                    help="Branch trace to replay")
+parser.add_argument("--predictor", action="append", default=[],
+                    choices=ObjectList.bp_list.get_names(),
+                    help="Branch predictor to evaluate, may be repeated")
+parser.add_argument("--sweep", action="append", default=[],
+                    metavar="OPTION=V1,V2,...",
+                    help="Evaluate every predictor for each of these values "
+                    "of a predictor option (e.g. history_size=2,4,8), "
+                    "may be repeated")
+
+options = parser.parse_args()
+
+def makePredictor(bp_type, opts):
+    if bp_type == "StaticPred":
+        return StaticPredPar(opts)
+    elif bp_type == "GApPred":
+        return GApPar(opts)
+    elif bp_type == "LocalBP":
+        return LocalBPPar(opts)
+    elif bp_type == "PAgPred":
+        return PAgPar(opts)
+    return ObjectList.bp_list.get(bp_type)()
+
+sweeps = []
+for sweep in options.sweep:
+    name, _, values = sweep.partition('=')
+    if not hasattr(options, name) or not values:
+        fatal("Invalid sweep '%s'" % sweep)
+    sweeps.append([(name, int(v)) for v in values.split(',')])
+
+predictors = []
+for bp_type in options.predictor or [options.bp_type or "LocalBP"]:
+    for point in itertools.product(*sweeps):
+        opts = copy.copy(options)
+        for name, value in point:
+            setattr(opts, name, value)
+        print("predictors%d: %s %s" % (len(predictors), bp_type,
+            " ".join("%s=%d" % p for p in point)))
+        predictors.append(makePredictor(bp_type, opts))
+
+system = System()
+system.clk_domain = SrcClockDomain(clock='1GHz',
+                                   voltage_domain=VoltageDomain())
+system.replay = BranchTraceReplay(trace_file=options.trace,
+                                  predictors=predictors)
+
+root = Root(full_system = False, system = system)
+m5.instantiate()
+
+exit_event = m5.simulate()
+print('Exiting @ tick %i because %s' % (m5.curTick(), exit_event.getCause()))
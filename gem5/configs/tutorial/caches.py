@@ -5,6 +5,10 @@ from m5.objects import TaggedPrefetcher
 from m5.objects import System
 from m5.objects import LRURP
 from m5.objects import RandomRP
+from m5.objects import DuelingRP
+from m5.objects import BaseSetAssoc
+from m5.objects import ShadowTagsProbe
+from m5.util.convert import toMemorySize
 
 m5.util.addToPath('../')
 
@@ -14,6 +18,10 @@ class CustStridePref(StridePrefetcher):
   def __init__(self, options=None):
     super(CustStridePref,self).__init__()
 
+    if options and getattr(options, 'pref_feedback_interval', 0):
+      self.feedback_interval = options.pref_feedback_interval
+      self.adaptive = True
+
     if not options or not options.pref_degree:
       return
     self.degree = options.pref_degree
@@ -22,6 +30,10 @@ class CustTaggedPref(TaggedPrefetcher):
   def __init__(self, options=None):
     super(CustTaggedPref, self).__init__()
 
+    if options and getattr(options, 'pref_feedback_interval', 0):
+      self.feedback_interval = options.pref_feedback_interval
+      self.adaptive = True
+
     if not options or not options.pref_degree:
       return
     self.degree = options.pref_degree
@@ -56,7 +68,8 @@ class L1Cache(Cache):
 
   def __init__(self, options=None):
     super(L1Cache, self).__init__()
-    pass
+    if options and getattr(options, 'share_line_buffers', False):
+      self.share_line_buffers = True
 
 class L1ICache(L1Cache):
   size = '32kB'
@@ -96,6 +109,9 @@ class L2Cache(Cache):
 
   def __init__(self, options=None):
     super(L2Cache, self).__init__()
+    if options and getattr(options, 'share_line_buffers', False):
+      self.share_line_buffers = True
+
     if not options or not options.l2_size:
       return
     self.size = options.l2_size
@@ -112,6 +128,9 @@ class L2Cache(Cache):
       return
     Rp_Class = ObjectList.rp_list.get(options.rp_type)
     self.replacement_policy = Rp_Class()
+    if isinstance(self.replacement_policy, DuelingRP):
+      duelingGeometry(self.replacement_policy, self.size.value, self.assoc,
+                      getattr(options, 'cacheline_size', None), options)
 
     if not options or not options.l2_hwp_type:
       return
@@ -124,4 +143,76 @@ class L2Cache(Cache):
     self.cpu_side = bus.mem_side_ports
 
   def connectMemSideBus(self, bus):
-    self.mem_side = bus.cpu_side_ports
\ No newline at end of file
+    self.mem_side = bus.cpu_side_ports
+
+class L3Cache(Cache):
+  size = '16MB'
+  assoc = '16'
+  tag_latency = 10
+  data_latency = 20
+  response_latency = 10
+  mshrs = 32
+  tgts_per_mshr = 24
+  write_buffers = 16
+  replacement_policy = LRURP()
+
+  def __init__(self, options=None):
+    super(L3Cache, self).__init__()
+    if not options:
+      return
+    self.size = options.l3_size
+    self.assoc = options.l3_assoc
+    self.clusivity = options.l3_clusivity
+
+  def connectCPUSideBus(self, bus):
+    self.cpu_side = bus.mem_side_ports
+
+  def connectMemSideBus(self, bus):
+    self.mem_side = bus.cpu_side_ports
+
+def snoopFilterSize(caches):
+  """Capacity a snoop filter needs to track every line the given caches
+  can hold, as a size string."""
+  return '%dB' % sum([c.size.value for c in caches])
+
+def duelingGeometry(rp, size, assoc, line_size=None, options=None):
+  """Size the leader sets of a set-dueling policy (DIPRP, DRRIPRP) after
+  the tags it replaces, applying the leader set and selector options."""
+  if options and getattr(options, 'rp_leader_sets', None):
+    rp.leader_sets = options.rp_leader_sets
+  if options and getattr(options, 'rp_psel_bits', None):
+    rp.psel_bits = options.rp_psel_bits
+  rp.setGeometry(size, int(assoc), int(line_size or 64))
+
+def shadowTags(specs, default_rp):
+  """Build a ShadowTagsProbe from a list of SIZE:ASSOC[:RP[:LINE]] specs.
+  Every shadow gets its own replacement policy object, since some of them
+  keep state that cannot be shared with the simulated cache."""
+  tags = []
+  for spec in specs:
+    fields = spec.split(':')
+    if len(fields) < 2 or len(fields) > 4:
+      m5.util.fatal("Bad shadow tags specification '%s'" % spec)
+    shadow = BaseSetAssoc(size=fields[0], assoc=int(fields[1]))
+    rp = fields[2] if len(fields) > 2 and fields[2] else default_rp
+    shadow.replacement_policy = ObjectList.rp_list.get(rp)()
+    if len(fields) > 3:
+      shadow.block_size = int(fields[3])
+      shadow.entry_size = int(fields[3])
+    if isinstance(shadow.replacement_policy, DuelingRP):
+      duelingGeometry(shadow.replacement_policy,
+                      toMemorySize(fields[0]), fields[1],
+                      fields[3] if len(fields) > 3 else None)
+    tags.append(shadow)
+  return ShadowTagsProbe(tags=tags)
+
+def mrcSizes(size_range):
+  """Expand a MIN:MAX size range into the powers of two it covers."""
+  low, high = [toMemorySize(s) for s in size_range.split(':')]
+  sizes = []
+  size = 1
+  while size <= high:
+    if size >= low:
+      sizes.append('%dB' % size)
+    size *= 2
+  return sizes
@@ -0,0 +1,59 @@
+# Run a configuration of cs425_pa3.py from the config.ini of an earlier
+# run, without building it again in Python: the simulator is instantiated
+# straight from config.ini by the C++ configuration manager (see
+# m5.instantiate_from_config()), with the given parameter overrides. This
+# needs gem5 to be built with --with-cxx-config.
+#
+# Only parameters of the objects in config.ini can be overridden, and the
+# run simulates the detailed CPU of config.ini to the end, so fast
+# forwarding, sampling, state digests and fork sweeps are not supported.
+#
+# e.g. write config.ini (and an init checkpoint) once, then sweep the L2
+# associativity from it:
+#   gem5.opt -d base configs/tutorial/cs425_pa3.py --cmd=... \
+#       --init-checkpoint=base/cpt
+#   gem5.opt -d l2_16 configs/tutorial/cs425_cached.py base/config.ini \
+#       --param system.l2cache.assoc=16 \
+#       --param system.l2cache.tags.assoc=16
+
+import m5
+
+import argparse
+
+from m5.util import fatal
+
+parser = argparse.ArgumentParser(
+    description='Run cs425_pa3.py from the config.ini of an earlier run')
+parser.add_argument("config", help="config.ini of an earlier run")
+parser.add_argument("--param", action="append", default=[],
+                    metavar="OBJ.PARAM=VALUE",
+                    help="Override a parameter, as written in config.ini, "
+                    "e.g. system.cpu.numROBEntries=64. May be repeated")
+parser.add_argument("--vector-param", action="append", default=[],
+                    metavar="OBJ.PARAM=V1,V2,...",
+                    help="Override a vector parameter. May be repeated")
+parser.add_argument("--restore", default=None,
+                    help="Checkpoint to restore from, e.g. one written with "
+                    "cs425_pa3.py --init-checkpoint")
+parser.add_argument("--maxtick", type=int, default=m5.MaxTick,
+                    help="Stop after this many ticks")
+options = parser.parse_args()
+
+overrides = {}
+for param in options.param:
+    path, sep, value = param.partition("=")
+    if not sep:
+        fatal("Invalid parameter override %s" % param)
+    overrides[path] = value
+for param in options.vector_param:
+    path, sep, values = param.partition("=")
+    if not sep:
+        fatal("Invalid parameter override %s" % param)
+    overrides[path] = values.split(",") if values else []
+
+m5.instantiate_from_config(options.config, overrides, options.restore)
+
+print("Beginning simulation!")
+exit_event = m5.simulate(options.maxtick - m5.curTick())
+print('Exiting @ tick %i because %s' %
+      (m5.curTick(), exit_event.getCause()))
@@ -2,6 +2,8 @@
 import m5
 
 import argparse
+import itertools
+import math
 import sys
 import os
 
@@ -18,6 +20,7 @@ m5.util.addToPath('../')
 from common import Options
 from common import Simulation
 from common import ObjectList
+from common import MemConfig
 
 parser = argparse.ArgumentParser(description='A simple system with 2-level cache.')
 
@@ -40,8 +43,36 @@ system.clk_domain.voltage_domain = VoltageDomain()
 system.mem_mode = Mem_Mode
 system.cpu = Cpu_Class()
 
+# with -F, run the first instructions on --fast-forward-cpu and switch to
+# the detailed CPU for the region of interest. The fast forwarding CPU is
+# the one connected to the caches and the detailed CPU takes them over
+# when switching in. SMARTS sampling switches back and forth between
+# the two, with the fast forwarding CPU functionally warming the caches
+# and the branch predictor of the detailed CPU. With --roi, the switch
+# happens at the m5_work_begin marker of the program rather than after a
+# number of instructions.
+sampling = options.smarts_period > 0
+roi = options.roi
+if roi and options.fast_forward:
+    m5.util.fatal("--roi fast forwards to the region of interest, "
+                  "drop -F")
+if options.fast_forward or sampling or roi:
+    (FF_Class, FF_Mode) = Simulation.getCPUClass(options.fast_forward_cpu)
+    if not FF_Class.support_take_over():
+        m5.util.fatal("%s can't be switched out" % options.fast_forward_cpu)
+    if sampling and not issubclass(FF_Class, AtomicSimpleCPU):
+        m5.util.fatal("SMARTS sampling warms up on an atomic CPU")
+    system.mem_mode = FF_Mode
+    system.ff_cpu = FF_Class()
+    if sampling:
+        system.ff_cpu.functional_warmup = True
+    system.cpu.switched_out = True
+    port_cpu = system.ff_cpu
+else:
+    port_cpu = system.cpu
+
 # in case of a valid cacheline size option, set appropriately the corresponding fetchBufferSize of the O3CPU
-if(options.cacheline_size):
+if options.cacheline_size and issubclass(Cpu_Class, O3CPU):
     system.cpu.fetchBufferSize = options.cacheline_size
 #system.cpu = OoOCPU(options)
 
@@ -60,12 +91,31 @@ else:
     bpClass = ObjectList.bp_list.get(options.bp_type)
     system.cpu.branchPred = bpClass()
 
+# record the committed branch stream for trace driven predictor studies
+if options.bp_trace:
+    system.cpu.branchPred.trace = BranchTraceProbe(
+        trace_file=options.bp_trace)
+
+if sampling:
+    system.ff_cpu.branchPred = system.cpu.branchPred
+
+# the second level TLB and the page walk caches of every CPU model
+if m5.defines.buildEnv['TARGET_ISA'] == "x86":
+    cpus = [system.cpu]
+    if options.fast_forward or sampling or roi:
+        cpus.append(system.ff_cpu)
+    for cpu in cpus:
+        if options.stlb_size:
+            cpu.mmu.addSharedTLB(options.stlb_size, options.stlb_assoc)
+        cpu.mmu.itb.walker.pwc_entries = options.pwc_entries
+        cpu.mmu.dtb.walker.pwc_entries = options.pwc_entries
+
 # allocate L1 ICache and DCache with the given options
 system.cpu.icache = L1ICache(options)
 system.cpu.dcache = L1DCache(options)
 
-system.cpu.icache.connectCPU(system.cpu)
-system.cpu.dcache.connectCPU(system.cpu)
+system.cpu.icache.connectCPU(port_cpu)
+system.cpu.dcache.connectCPU(port_cpu)
 
 system.l2bus = L2XBar()
 
@@ -75,32 +125,97 @@ system.cpu.dcache.connectBus(system.l2bus)
 # allocate L2 Unified Cache with the given options
 system.l2cache = L2Cache(options)
 
-system.l2cache.connectCPUSideBus(system.l2bus)
+# with --l2-mrc, a monitor between the L2 bus and the L2 feeds the L2
+# request stream to a stack distance probe, which gives the miss ratio of
+# every L2 size and associativity in a single run
+if options.l2_mrc:
+    system.l2mon = CommMonitor()
+    system.l2mon.cpu_side_port = system.l2bus.mem_side_ports
+    system.l2cache.cpu_side = system.l2mon.mem_side_port
+    system.l2mon.stackdist = StackDistProbe(
+        mrc_sizes=mrcSizes(options.l2_mrc_sizes),
+        mrc_assocs=[int(a) for a in options.l2_mrc.split(',')])
+else:
+    system.l2cache.connectCPUSideBus(system.l2bus)
 
 # Create a memory bus, a system crossbar, in this case
 system.membus = SystemXBar()
 
-system.l2cache.connectMemSideBus(system.membus)
+# with --l3cache, put a shared L3 between the L2 and the memory bus. A
+# mostly exclusive L3 is a victim cache, filled by the L2 evictions,
+# including the clean ones, and the snoop filter of the memory bus has
+# to track the lines of every level as they no longer overlap.
+if options.l3cache:
+    system.l3bus = L2XBar()
+    system.l2cache.connectMemSideBus(system.l3bus)
+    system.l3cache = L3Cache(options)
+    system.l3cache.connectCPUSideBus(system.l3bus)
+    system.l3cache.connectMemSideBus(system.membus)
+    private = [system.cpu.icache, system.cpu.dcache, system.l2cache]
+    system.l3bus.snoop_filter.max_capacity = snoopFilterSize(private)
+    if options.l3_clusivity == 'mostly_excl':
+        system.l2cache.writeback_clean = True
+        system.membus.snoop_filter.max_capacity = snoopFilterSize(
+            private + [system.l3cache])
+    else:
+        system.membus.snoop_filter.max_capacity = snoopFilterSize(
+            [system.l3cache])
+else:
+    system.l2cache.connectMemSideBus(system.membus)
+
+# replay the L1D and L2 request streams on shadow tag stores
+if options.l1d_shadow or options.l2_shadow:
+    if Mem_Mode != 'timing':
+        m5.util.fatal("Shadow tags need a timing CPU")
+if options.l1d_shadow:
+    system.cpu.dcache.shadow = shadowTags(options.l1d_shadow, 'LRURP')
+if options.l2_shadow:
+    system.l2cache.shadow = shadowTags(options.l2_shadow,
+                                       options.rp_type or 'RandomRP')
 
 # Hook the CPU ports up to the membus
 #system.cpu.icache_port = system.membus.cpu_side_ports
 #system.cpu.dcache_port = system.membus.cpu_side_ports
 
-# create the interrupt controller for the CPU and connect to the membus
-system.cpu.createInterruptController()
+# create the interrupt controller for the CPU and connect to the membus,
+# a CPU switching in takes it over
+port_cpu.createInterruptController()
 
 # For x86 only, make sure the interrupts are connected to the memory
 # Note: these are directly connected to the memory bus and are not cached
 if m5.defines.buildEnv['TARGET_ISA'] == "x86":
-    system.cpu.interrupts[0].pio = system.membus.mem_side_ports
-    system.cpu.interrupts[0].int_requestor = system.membus.cpu_side_ports
-    system.cpu.interrupts[0].int_responder = system.membus.mem_side_ports
-
-# Create a DDR3 memory controller and connect it to the membus
-system.mem_ctrl = MemCtrl()
-system.mem_ctrl.dram = DDR3_1600_8x8()
-system.mem_ctrl.dram.range = system.mem_ranges[0]
-system.mem_ctrl.port = system.membus.mem_side_ports
+    port_cpu.interrupts[0].pio = system.membus.mem_side_ports
+    port_cpu.interrupts[0].int_requestor = system.membus.cpu_side_ports
+    port_cpu.interrupts[0].int_responder = system.membus.mem_side_ports
+
+# Create a DDR3 memory controller and connect it to the membus, or
+# its faster analytical model if selected with --mem-type. With
+# --mem-channels or --mem-addr-mapping, build interleaved channels of
+# --mem-type through MemConfig instead.
+if options.mem_channels > 1 or options.mem_addr_mapping:
+    MemConfig.config_mem(options, system)
+elif options.mem_type == "AnalyticalDRAM":
+    system.mem_ctrl = AnalyticalDRAM()
+    system.mem_ctrl.range = system.mem_ranges[0]
+    system.mem_ctrl.port = system.membus.mem_side_ports
+else:
+    system.mem_ctrl = MemCtrl()
+    system.mem_ctrl.dram = DDR3_1600_8x8()
+    system.mem_ctrl.dram.range = system.mem_ranges[0]
+    system.mem_ctrl.port = system.membus.mem_side_ports
+
+# Compress the lines moved over the DRAM data bus, so that bursts only
+# take the data bus for the compressed bytes
+if options.mem_link_compressor:
+    if options.mem_channels > 1 or options.mem_addr_mapping:
+        ctrls = system.mem_ctrls
+    else:
+        ctrls = [system.mem_ctrl]
+    for ctrl in ctrls:
+        if not isinstance(ctrl, MemCtrl):
+            m5.util.fatal("Link compression needs a MemCtrl")
+        ctrl.link_compressor = getattr(m5.objects,
+                                       options.mem_link_compressor)()
 
 # Connect the system up to the membus
 system.system_port = system.membus.cpu_side_ports
@@ -138,15 +253,306 @@ system.workload = SEWorkload.init_compatible(process.executable)
 
 # Set the cpu to use the process as its workload and create thread contexts
 system.cpu.workload = process
+if options.fast_forward or sampling or roi:
+    system.ff_cpu.workload = process
+    system.ff_cpu.createThreads()
+    # sampling and the ROI markers stop the fast forwarding CPU
+    if options.fast_forward and not sampling:
+        system.ff_cpu.max_insts_any_thread = int(options.fast_forward)
+    # both CPUs work on the same architectural state
+    system.cpu.isa = system.ff_cpu.isa
+
+    # KVM runs the process natively in a VM, with syscalls and page
+    # faults trapping back to the syscall emulation
+    if ObjectList.is_kvm_cpu(FF_Class):
+        if isa != 'x86':
+            m5.util.fatal("KVM fast forwarding needs x86")
+        system.kvm_vm = KvmVM()
+        process.useArchPT = True
+        process.kvmInSE = True
 system.cpu.createThreads()
 
 system.cpu.max_insts_any_thread = options.maxinsts
 
+# The ROI markers are address mapped m5ops: the program accesses the
+# 64KiB m5ops page at roi_m5ops_vaddr, which the process maps to the
+# m5ops physical range, and the CPUs, including KVM through its MMIO
+# exits, turn the accesses into m5_work_begin and m5_work_end calls which
+# exit the simulation loop. The range is kept above the memory, which
+# would otherwise shadow it for KVM.
+roi_m5ops_vaddr = 0xffff0000
+if roi:
+    roi_m5ops_paddr = max(roi_m5ops_vaddr, system.mem_ranges[0].size())
+    system.m5ops_base = roi_m5ops_paddr
+    system.exit_on_work_items = True
+
+# O3 doesn't count nops and instruction prefetches as committed
+# instructions, the simple CPUs have to do the same for the state digests
+# of the two models to be taken at the same instructions
+if options.state_digest_interval:
+    for cpu in system.descendants():
+        if isinstance(cpu, BaseSimpleCPU):
+            cpu.count_nops = False
+
+# SimPoint sampling, see util/cs425_simpoint.py: profile the basic block
+# vectors of the program, take checkpoints ahead of the simpoints, then
+# simulate the simpoints one at a time after a warmup
+if options.simpoint_profile:
+    if not issubclass(Cpu_Class, AtomicSimpleCPU):
+        m5.util.fatal("SimPoint profiling needs an atomic CPU")
+    system.cpu.addSimPointProbe(options.simpoint_interval)
+
+if options.take_simpoint_checkpoints:
+    simpoints, interval_length = \
+        Simulation.parseSimpointAnalysisFile(options, system)
+
+# --fork-sweep: the parameters to sweep in simulations forked once warmed
+# up. The objects a SimObject parameter is swept over are created here,
+# as children of the object, to be instantiated with the rest.
+sweep_axes = []
+for sweep in options.fork_sweep:
+    path, _, values = sweep.partition('=')
+    obj_path, _, param = path.rpartition('.')
+    obj = system
+    for name in obj_path.split('.') if obj_path else []:
+        obj = getattr(obj, name)
+    if not isinstance(obj, SimObject) or param not in obj._params:
+        m5.util.fatal("No parameter %s to sweep" % path)
+    values = values.split(',')
+    if issubclass(obj._params[param].ptype, SimObject):
+        values = [getattr(m5.objects, v)() for v in values]
+        for i, value in enumerate(values):
+            setattr(obj, "%s_sweep%d" % (param, i), value)
+    sweep_axes.append((obj, param, values))
+if sweep_axes:
+    if sampling or options.state_digest_interval:
+        m5.util.fatal("Can't fork sweeps while sampling or taking state "
+                      "digests")
+    m5.disableAllListeners()
+
 # set up the root SimObject and start the simulation
 root = Root(full_system = False, system = system)
-# instantiate all of the objects we've created above
-m5.instantiate()
+root.binary_checkpoints = options.binary_checkpoints
+# instantiate all of the objects we've created above, possibly restoring
+# them from a post-init checkpoint shared by several configurations or
+# from a simpoint checkpoint
+checkpoint = options.restore_init_checkpoint
+if options.restore_simpoint_checkpoint:
+    if options.fast_forward or sampling:
+        m5.util.fatal("Can't fast forward from a simpoint checkpoint")
+    _, checkpoint = Simulation.findCptDir(
+        options, options.checkpoint_dir or m5.options.outdir, system)
+m5.instantiate(checkpoint)
+
+if options.take_simpoint_checkpoints:
+    Simulation.takeSimpointCheckpoints(simpoints, interval_length,
+                                       m5.options.outdir)
+if options.restore_simpoint_checkpoint:
+    Simulation.restoreSimpointCheckpoint()
+
+if options.config_only:
+    print("Wrote the configuration to %s" % m5.options.outdir)
+    sys.exit(0)
+
+if options.init_checkpoint:
+    m5.checkpoint(options.init_checkpoint)
+    print("Wrote post-init checkpoint to %s" % options.init_checkpoint)
+    sys.exit(0)
+
+# SMARTS systematic sampling: every --smarts-period instructions, switch
+# to the detailed CPU, warm up its pipeline for --smarts-warmup
+# instructions and measure the CPI of the next --smarts-unit ones. The
+# switches don't dump or reset stats, the units are measured from
+# snapshots of the cycle and instruction counts of the detailed CPU.
+# Sampling ends once the confidence interval of the mean CPI is within
+# --smarts-error of the mean, or with the program.
+def smartsSample(system, options):
+    cause = "smarts sample"
+    detailed = options.smarts_warmup + options.smarts_unit
+    if options.smarts_unit <= 0:
+        m5.util.fatal("--smarts-unit must be positive")
+    if options.smarts_period <= detailed:
+        m5.util.fatal("--smarts-period must be larger than --smarts-warmup "
+                      "plus --smarts-unit")
+    skip = options.smarts_period - detailed + int(options.fast_forward or 0)
+
+    units = open(os.path.join(m5.options.outdir, "smarts_units.csv"), "w")
+    units.write("unit,tick,insts,cycles,cpi\n")
+    cpis = []
+    while True:
+        system.ff_cpu.scheduleInstStop(0, skip, cause)
+        exit_event = m5.simulate()
+        if exit_event.getCause() != cause:
+            break
+        skip = options.smarts_period - detailed
+
+        m5.switchCpus(system, [(system.ff_cpu, system.cpu)], verbose=False)
+        if options.smarts_warmup:
+            system.cpu.scheduleInstStop(0, options.smarts_warmup, cause)
+            exit_event = m5.simulate()
+            if exit_event.getCause() != cause:
+                break
+        cycles = system.cpu.resolveStat("numCycles").value
+        insts = system.cpu.totalInsts()
+        system.cpu.scheduleInstStop(0, options.smarts_unit, cause)
+        exit_event = m5.simulate()
+        if exit_event.getCause() != cause:
+            break
+        cycles = system.cpu.resolveStat("numCycles").value - cycles
+        insts = system.cpu.totalInsts() - insts
+        m5.switchCpus(system, [(system.cpu, system.ff_cpu)], verbose=False)
+
+        cpis.append(cycles / insts)
+        units.write("%d,%d,%d,%d,%f\n" % (len(cpis) - 1, m5.curTick(),
+                                          insts, cycles, cpis[-1]))
+
+        n = len(cpis)
+        if n < max(options.smarts_min_units, 2):
+            continue
+        mean = sum(cpis) / n
+        stdev = math.sqrt(sum((cpi - mean) ** 2 for cpi in cpis) / (n - 1))
+        if options.smarts_z * stdev / math.sqrt(n) <= \
+                options.smarts_error * mean:
+            exit_event = None
+            break
+    units.close()
+
+    n = len(cpis)
+    if n < 2:
+        print("SMARTS: only %d units measured, no CPI estimate" % n)
+    else:
+        mean = sum(cpis) / n
+        stdev = math.sqrt(sum((cpi - mean) ** 2 for cpi in cpis) / (n - 1))
+        error = options.smarts_z * stdev / math.sqrt(n)
+        print("SMARTS: CPI %f +/- %f (%.1f%%, z=%.2f) over %d units, "
+              "IPC %f" % (mean, error, 100 * error / mean, options.smarts_z,
+                          n, 1 / mean))
+    return exit_event
+
+# Architectural state digests, see util/cs425_diffval.py: stop the
+# detailed CPU every --state-digest-interval instructions and record a
+# digest of its registers, and of the memory contents every
+# --state-digest-mem-every stops. A memory digest drains the system and
+# writes the caches back first, so it sees every committed store. The
+# instruction counts include the fast forwarded ones, so runs of
+# different CPU models line up.
+def memDigest(system):
+    digest = 0
+    for obj in system.descendants():
+        if isinstance(obj, AbstractMemory):
+            digest = (digest + obj.getCCObject().digest()) % (1 << 64)
+    return digest
+
+def digestRun(system, options):
+    cause = "state digest"
+    interval = options.state_digest_interval
+    base = int(options.fast_forward or 0)
+    cpu = system.cpu
+
+    digests = open(os.path.join(m5.options.outdir, "state_digest.csv"), "w")
+    digests.write("insts,tick,regs,mem\n")
+    stops = 0
+    while True:
+        cpu.scheduleInstStop(0, interval, cause)
+        exit_event = m5.simulate()
+        if exit_event.getCause() != cause:
+            break
+        stops += 1
+        mem = ""
+        if options.state_digest_mem_every and \
+                stops % options.state_digest_mem_every == 0:
+            m5.drain()
+            m5.memWriteback(system)
+            mem = "%016x" % memDigest(system)
+        digests.write("%d,%d,%016x,%s\n" % (base + cpu.totalInsts(),
+                                             m5.curTick(),
+                                             cpu.archStateDigest(0), mem))
+    digests.close()
+    return exit_event
+
+if options.state_digest_interval:
+    if sampling:
+        m5.util.fatal("Can't take state digests while SMARTS sampling")
+    if options.state_digest_interval < 0:
+        m5.util.fatal("--state-digest-interval must be positive")
+
+# Fork a simulation of the detailed part per combination of the swept
+# parameter values, which starts from the warm state of this one. Only
+# the children return, the parent waits for them and exits.
+def forkSweep(axes, options):
+    for obj, param, _ in axes:
+        if not obj.reconfigurable(param):
+            m5.util.fatal("%s.%s can't be changed after instantiation" %
+                          (obj.path(), param))
+    combos = list(itertools.product(
+        *[[(obj, param, value) for value in values]
+          for obj, param, values in axes]))
+    deltas = [[(obj, {param: value}) for obj, param, value in combo]
+              for combo in combos]
+
+    def name(value):
+        return type(value).__name__ if isinstance(value, SimObject) \
+            else str(value)
+
+    with open(os.path.join(m5.options.outdir, "fork_sweep.csv"), "w") as f:
+        f.write("outdir,%s\n" % ",".join("%s.%s" % (obj.path(), param)
+                                         for obj, param, _ in axes))
+        for i, combo in enumerate(combos):
+            f.write("sweep%d,%s\n" % (i, ",".join(name(value)
+                                                  for _, _, value in combo)))
+
+    delta = m5.fork_sweep(deltas,
+                          simout=os.path.join("%(parent)s", "sweep%(delta)i"),
+                          max_children=options.fork_sweep_jobs or None)
+    if delta is None:
+        print("Ran %d forked simulations, see %s" %
+              (len(deltas), os.path.join(m5.options.outdir, "fork_sweep.csv")))
+        sys.exit(0)
+    print("Sweep %d: %s" % (delta, ", ".join(
+        "%s.%s=%s" % (obj.path(), param, name(value))
+        for obj, param, value in combos[delta])))
+    m5.stats.reset()
+
+if roi:
+    process.map(roi_m5ops_vaddr, roi_m5ops_paddr, 0x10000)
+
+if sweep_axes and not (options.fast_forward or roi):
+    forkSweep(sweep_axes, options)
 
 print("Beginning simulation!")
-exit_event = m5.simulate()
-print('Exiting @ tick %i because %s' % (m5.curTick(), exit_event.getCause()))
\ No newline at end of file
+if roi:
+    exit_event = m5.simulate()
+    if exit_event.getCause() != "workbegin":
+        m5.util.fatal("Exited because %s before the region of interest, "
+                      "does the program have an m5_work_begin marker?" %
+                      exit_event.getCause())
+    print("Reached the region of interest @ tick %i" % m5.curTick())
+    # the fast forwarding CPU warms up between the SMARTS units of the
+    # region of interest, and sampling stops at m5_work_end
+    if sampling:
+        m5.stats.reset()
+        exit_event = smartsSample(system, options)
+elif sampling:
+    exit_event = smartsSample(system, options)
+elif options.state_digest_interval and not options.fast_forward:
+    exit_event = digestRun(system, options)
+else:
+    exit_event = m5.simulate()
+
+if not sampling and (roi or options.fast_forward and exit_event.getCause()
+                    == "a thread reached the max instruction count"):
+    print("Switching to %s @ tick %i" % (options.cpu_type, m5.curTick()))
+    m5.switchCpus(system, [(system.ff_cpu, system.cpu)])
+    m5.stats.reset()
+    if sweep_axes:
+        forkSweep(sweep_axes, options)
+    if options.state_digest_interval:
+        exit_event = digestRun(system, options)
+    else:
+        exit_event = m5.simulate()
+if exit_event is None:
+    print('Exiting @ tick %i because the SMARTS CPI estimate converged'
+          % m5.curTick())
+else:
+    print('Exiting @ tick %i because %s' %
+          (m5.curTick(), exit_event.getCause()))
\ No newline at end of file
@@ -91,6 +91,10 @@ void libDRAMPower::calcWindowEnergy(int64_t timestamp)
   clearCounters(timestamp);
 }
 
+void libDRAMPower::evaluateCommands(int64_t timestamp)
+{
+  updateCounters(false, timestamp);
+}
 
 void libDRAMPower::clearState()
 {
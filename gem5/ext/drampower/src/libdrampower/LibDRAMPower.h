@@ -65,6 +65,11 @@ class libDRAMPower {
 
   void calcWindowEnergy(int64_t timestamp);
 
+  // Evaluate the commands given so far, which must all be issued up to
+  // timestamp, to free them without computing the energy of the window.
+  // No later command may be issued before timestamp.
+  void evaluateCommands(int64_t timestamp);
+
   const Data::MemoryPowerModel::Energy& getEnergy() const;
   const Data::MemoryPowerModel::Power& getPower() const;
 
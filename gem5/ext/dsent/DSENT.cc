@@ -113,8 +113,8 @@ namespace DSENT
         cout << "==============" << endl;
     }
 
-    static Model *buildModel(const map<String, String> &params,
-                             TechModel *tech_model)
+    Model *buildModel(const map<String, String> &params,
+                      TechModel *tech_model)
     {
         // Create the model specified
         const String& model_name = params.at("ModelName");
@@ -251,7 +251,7 @@ namespace DSENT
         }
     }
 
-    static TechModel* constructTechModel(const map<String, String>& params)
+    TechModel* constructTechModel(const map<String, String>& params)
     {
         // Allocate static TechModel instance
         const String& electrical_tech_model_filename =
@@ -320,6 +320,13 @@ namespace DSENT
         calc.evaluateString(eval_str, params, ms_model, outputs);
     }
 
+    double query(const String &query, Model *ms_model)
+    {
+        const Result* result = (const Result*)processQuery(
+            query + "@0", ms_model, false);
+        return result->calculateSum();
+    }
+
     DSENTCalculator::DSENTCalculator() {}
 
     DSENTCalculator::~DSENTCalculator() {}
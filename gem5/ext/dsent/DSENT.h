@@ -64,6 +64,17 @@ namespace DSENT
 
     void run(const std::map<String, String> &config, Model *ms_model,
              std::map<std::string, double> &outputs);
+
+    // The steps of initialize(), to build several models that only differ
+    // in some of their parameters with the same technology model
+    TechModel *constructTechModel(const std::map<String, String> &config);
+
+    Model *buildModel(const std::map<String, String> &config,
+                      TechModel *tech_model);
+
+    // The sum of the result of a query on a model, such as
+    // "Energy>>Router:ReadBuffer" or "NddPower>>Router:Leakage"
+    double query(const String &query, Model *ms_model);
 } // namespace DSENT
 
 #endif // __DSENT_DSENT_H__
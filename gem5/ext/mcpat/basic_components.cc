@@ -173,6 +173,14 @@ void McPATComponent::computeEnergy() {
     }
 }
 
+void McPATComponent::updateStats() {
+    int i;
+    int numChildren = children.size();
+    for (i = 0; i < numChildren; i++) {
+        children[i]->updateStats();
+    }
+}
+
 void McPATComponent::displayData(uint32_t indent, int plevel) {
     if (debug) {
         fprintf(stderr, "WARNING: Called displayData from %s, with 'type' ",
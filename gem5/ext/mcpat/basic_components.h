@@ -242,6 +242,10 @@ public:
     // the modifying process to know for sure. Note that each component has
     // to calculate it's own power consumption
     virtual void computeEnergy();
+    // Re-read the stats from the XML data after they were updated, so that
+    // computeEnergy can be called again for a new interval without redoing
+    // the CACTI search of the component and its area
+    virtual void updateStats();
     virtual void displayData(uint32_t indent, int plevel);
     ~McPATComponent();
 
@@ -137,7 +137,20 @@ void BusInterconnect::set_param_stats() {
     interface_ip.wire_is_mat_type = mat_type;
     interface_ip.wire_os_mat_type = mat_type;
 
-    num_children = xml_data->nChildNode("stat");
+    set_bus_stats();
+
+    clockRate = bus_params.clockRate;
+    bus_params.min_ports =
+        min(bus_params.input_ports, bus_params.output_ports);
+
+    assert(bus_params.chip_coverage <= 1);
+    assert(bus_params.route_over_perc <= 1);
+    assert(link_len > 0);
+}
+
+void BusInterconnect::set_bus_stats() {
+    int num_children = xml_data->nChildNode("stat");
+    int i;
     for (i = 0; i < num_children; i++) {
         XMLNode* statNode = xml_data->getChildNodePtr("stat", &i);
         XMLCSTR node_name = statNode->getAttribute("name");
@@ -153,14 +166,11 @@ void BusInterconnect::set_param_stats() {
             warnUnrecognizedStat(node_name);
         }
     }
+}
 
-    clockRate = bus_params.clockRate;
-    bus_params.min_ports =
-        min(bus_params.input_ports, bus_params.output_ports);
-
-    assert(bus_params.chip_coverage <= 1);
-    assert(bus_params.route_over_perc <= 1);
-    assert(link_len > 0);
+void BusInterconnect::updateStats() {
+    set_bus_stats();
+    McPATComponent::updateStats();
 }
 
 void
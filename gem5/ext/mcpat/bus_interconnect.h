@@ -86,6 +86,8 @@ public:
 
     BusInterconnect(XMLNode* _xml_data, InputParameter* interface_ip_);
     void set_param_stats();
+    void set_bus_stats();
+    void updateStats();
     void set_duty_cycle(double duty_cycle);
     void set_number_of_accesses(double total_accesses);
     void computeEnergy();
@@ -54,7 +54,9 @@ bool CacheUnit::opt_local = true;
 bool CacheUnit::force_cache_config = false;
 
 CacheUnit::CacheUnit(XMLNode* _xml_data, InputParameter* _interface_ip)
-        : dir_overhead(0), McPATComponent(_xml_data, _interface_ip) {
+        : dir_overhead(0), dataArray(NULL), missBuffer(NULL), fillBuffer(NULL),
+          prefetchBuffer(NULL), writebackBuffer(NULL),
+          McPATComponent(_xml_data, _interface_ip) {
 
     int tag;
     int data;
@@ -124,92 +126,9 @@ CacheUnit::CacheUnit(XMLNode* _xml_data, InputParameter* _interface_ip)
                               cache_params.core_ty);
     children.push_back(arrayPtr);
 
-    // This is for calculating TDP, which depends on the number of
-    // available ports
-    int num_tdp_ports = arrayPtr->l_ip.num_rw_ports +
-        arrayPtr->l_ip.num_rd_ports + arrayPtr->l_ip.num_wr_ports;
-
-    // Set new array stats for calculating TDP and runtime power
-    arrayPtr->tdp_stats.reset();
-    arrayPtr->tdp_stats.readAc.access = cache_stats.tdp_read_access_scalar *
-        num_tdp_ports * cache_stats.duty_cycle *
-        cache_stats.homenode_access_scalar;
-    arrayPtr->tdp_stats.readAc.miss = 0;
-    arrayPtr->tdp_stats.readAc.hit = arrayPtr->tdp_stats.readAc.access -
-        arrayPtr->tdp_stats.readAc.miss;
-    arrayPtr->tdp_stats.writeAc.access = cache_stats.tdp_write_access_scalar *
-        num_tdp_ports * cache_stats.duty_cycle *
-        cache_stats.homenode_access_scalar;
-    arrayPtr->tdp_stats.writeAc.miss = 0;
-    arrayPtr->tdp_stats.writeAc.hit = arrayPtr->tdp_stats.writeAc.access -
-        arrayPtr->tdp_stats.writeAc.miss;
-    arrayPtr->tdp_stats.searchAc.access = 0;
-    arrayPtr->tdp_stats.searchAc.miss = 0;
-    arrayPtr->tdp_stats.searchAc.hit = 0;
-
-    arrayPtr->rtp_stats.reset();
-    if (cache_stats.use_detailed_stats) {
-        arrayPtr->rtp_stats.dataReadAc.access =
-            cache_stats.num_data_array_reads;
-        arrayPtr->rtp_stats.dataWriteAc.access =
-            cache_stats.num_data_array_writes;
-        arrayPtr->rtp_stats.tagReadAc.access =
-            cache_stats.num_tag_array_reads;
-        arrayPtr->rtp_stats.tagWriteAc.access =
-            cache_stats.num_tag_array_writes;
-    } else {
-        // This code makes assumptions. For instance, it assumes that
-        // tag and data arrays are accessed in parallel on a read request and
-        // this is a write-allocate cache. It also ignores any coherence
-        // requests. Using detailed stats as above can avoid the ambiguity
-        // that is introduced here
-        arrayPtr->rtp_stats.dataReadAc.access =
-            cache_stats.read_accesses + cache_stats.write_misses;
-        arrayPtr->rtp_stats.dataWriteAc.access =
-            cache_stats.write_accesses + cache_stats.read_misses;
-        arrayPtr->rtp_stats.tagReadAc.access =
-            cache_stats.read_accesses + cache_stats.write_accesses;
-        arrayPtr->rtp_stats.tagWriteAc.access =
-            cache_stats.read_misses + cache_stats.write_misses;
-    }
-
-    // Set SBT stats if this is an SBT directory type
+    dataArray = arrayPtr;
     if (dir_overhead > 0) {
         arrayPtr->setSBTDirOverhead(dir_overhead);
-
-        // TDP stats
-        arrayPtr->sbt_tdp_stats.readAc.access =
-            cache_stats.tdp_read_access_scalar *
-            num_tdp_ports * cache_stats.dir_duty_cycle *
-            (1 - cache_stats.homenode_access_scalar);
-        arrayPtr->sbt_tdp_stats.readAc.miss = 0;
-        arrayPtr->sbt_tdp_stats.readAc.hit =
-            arrayPtr->sbt_tdp_stats.readAc.access -
-            arrayPtr->sbt_tdp_stats.readAc.miss;
-        arrayPtr->sbt_tdp_stats.writeAc.access =
-            cache_stats.tdp_sbt_write_access_scalar *
-            num_tdp_ports * cache_stats.dir_duty_cycle *
-            (1 - cache_stats.homenode_access_scalar);
-        arrayPtr->sbt_tdp_stats.writeAc.miss = 0;
-        arrayPtr->sbt_tdp_stats.writeAc.hit =
-            arrayPtr->sbt_tdp_stats.writeAc.access -
-            arrayPtr->sbt_tdp_stats.writeAc.miss;
-
-        // Runtime power stats
-        arrayPtr->sbt_rtp_stats.readAc.access =
-            cache_stats.homenode_read_accesses;
-        arrayPtr->sbt_rtp_stats.readAc.miss =
-            cache_stats.homenode_read_misses;
-        arrayPtr->sbt_rtp_stats.readAc.access =
-            cache_stats.homenode_read_accesses -
-            cache_stats.homenode_read_misses;
-        arrayPtr->sbt_rtp_stats.writeAc.access =
-            cache_stats.homenode_write_accesses;
-        arrayPtr->sbt_rtp_stats.writeAc.miss =
-            cache_stats.homenode_write_misses;
-        arrayPtr->sbt_rtp_stats.writeAc.hit =
-            cache_stats.homenode_write_accesses -
-            cache_stats.homenode_write_misses;
     }
 
     interface_ip.force_cache_config = force_cache_config;
@@ -259,24 +178,7 @@ CacheUnit::CacheUnit(XMLNode* _xml_data, InputParameter* _interface_ip)
                                   cache_params.core_ty);
         children.push_back(arrayPtr);
 
-        arrayPtr->tdp_stats.reset();
-        arrayPtr->tdp_stats.readAc.access = 0;
-        arrayPtr->tdp_stats.writeAc.access = arrayPtr->l_ip.num_search_ports;
-        arrayPtr->tdp_stats.searchAc.access = arrayPtr->l_ip.num_search_ports;
-
-        arrayPtr->rtp_stats.reset();
-        arrayPtr->rtp_stats.readAc.access =
-            cache_stats.read_misses + cache_stats.write_misses;
-        arrayPtr->rtp_stats.writeAc.access =
-            cache_stats.read_misses + cache_stats.write_misses;
-        arrayPtr->rtp_stats.searchAc.access = 0;
-
-        if (cache_params.dir_ty == SBT) {
-            arrayPtr->rtp_stats.readAc.access +=
-                cache_stats.homenode_write_misses;
-            arrayPtr->rtp_stats.writeAc.access +=
-                cache_stats.homenode_write_misses;
-        }
+        missBuffer = arrayPtr;
 
         // Fill Buffer
         tag = physical_address_width + EXTRA_TAG_BITS;
@@ -314,24 +216,7 @@ CacheUnit::CacheUnit(XMLNode* _xml_data, InputParameter* _interface_ip)
                                   cache_params.core_ty);
         children.push_back(arrayPtr);
 
-        arrayPtr->tdp_stats.reset();
-        arrayPtr->tdp_stats.readAc.access = 0;
-        arrayPtr->tdp_stats.writeAc.access = arrayPtr->l_ip.num_search_ports;
-        arrayPtr->tdp_stats.searchAc.access = arrayPtr->l_ip.num_search_ports;
-
-        arrayPtr->rtp_stats.reset();
-        arrayPtr->rtp_stats.readAc.access =
-            cache_stats.read_misses + cache_stats.write_misses;
-        arrayPtr->rtp_stats.writeAc.access =
-            cache_stats.read_misses + cache_stats.write_misses;
-        arrayPtr->rtp_stats.searchAc.access = 0;
-
-        if (cache_params.dir_ty == SBT) {
-            arrayPtr->rtp_stats.readAc.access +=
-                cache_stats.homenode_write_misses;
-            arrayPtr->rtp_stats.writeAc.access +=
-                cache_stats.homenode_write_misses;
-        }
+        fillBuffer = arrayPtr;
 
         // Prefetch Buffer
         tag = physical_address_width + EXTRA_TAG_BITS;
@@ -370,22 +255,7 @@ CacheUnit::CacheUnit(XMLNode* _xml_data, InputParameter* _interface_ip)
                                   cache_params.core_ty);
         children.push_back(arrayPtr);
 
-        arrayPtr->tdp_stats.reset();
-        arrayPtr->tdp_stats.readAc.access = 0;
-        arrayPtr->tdp_stats.writeAc.access = arrayPtr->l_ip.num_search_ports;
-        arrayPtr->tdp_stats.searchAc.access = arrayPtr->l_ip.num_search_ports;
-
-        arrayPtr->rtp_stats.reset();
-        arrayPtr->rtp_stats.readAc.access = cache_stats.read_misses;
-        arrayPtr->rtp_stats.writeAc.access = cache_stats.read_misses;
-        arrayPtr->rtp_stats.searchAc.access = 0;
-
-        if (cache_params.dir_ty == SBT) {
-            arrayPtr->rtp_stats.readAc.access +=
-                cache_stats.homenode_write_misses;
-            arrayPtr->rtp_stats.writeAc.access +=
-                cache_stats.homenode_write_misses;
-        }
+        prefetchBuffer = arrayPtr;
 
         // Writeback Buffer
         if (cache_params.wbb_size > 0) {
@@ -426,24 +296,185 @@ CacheUnit::CacheUnit(XMLNode* _xml_data, InputParameter* _interface_ip)
                                       opt_local, cache_params.core_ty);
             children.push_back(arrayPtr);
 
-            arrayPtr->tdp_stats.reset();
-            arrayPtr->tdp_stats.readAc.access = 0;
-            arrayPtr->tdp_stats.writeAc.access =
-                arrayPtr->l_ip.num_search_ports;
-            arrayPtr->tdp_stats.searchAc.access =
-                arrayPtr->l_ip.num_search_ports;
-
-            arrayPtr->rtp_stats.reset();
-            arrayPtr->rtp_stats.readAc.access = cache_stats.write_misses;
-            arrayPtr->rtp_stats.writeAc.access = cache_stats.write_misses;
-            arrayPtr->rtp_stats.searchAc.access = 0;
-
-            if (cache_params.dir_ty == SBT) {
-                arrayPtr->rtp_stats.readAc.access +=
-                    cache_stats.homenode_write_misses;
-                arrayPtr->rtp_stats.writeAc.access +=
-                    cache_stats.homenode_write_misses;
-            }
+            writebackBuffer = arrayPtr;
+        }
+    }
+
+    set_array_stats();
+}
+
+void CacheUnit::set_array_stats() {
+    // This is for calculating TDP, which depends on the number of
+    // available ports
+    int num_tdp_ports = dataArray->l_ip.num_rw_ports +
+        dataArray->l_ip.num_rd_ports + dataArray->l_ip.num_wr_ports;
+
+    // Set new array stats for calculating TDP and runtime power
+    dataArray->tdp_stats.reset();
+    dataArray->tdp_stats.readAc.access = cache_stats.tdp_read_access_scalar *
+        num_tdp_ports * cache_stats.duty_cycle *
+        cache_stats.homenode_access_scalar;
+    dataArray->tdp_stats.readAc.miss = 0;
+    dataArray->tdp_stats.readAc.hit = dataArray->tdp_stats.readAc.access -
+        dataArray->tdp_stats.readAc.miss;
+    dataArray->tdp_stats.writeAc.access = cache_stats.tdp_write_access_scalar *
+        num_tdp_ports * cache_stats.duty_cycle *
+        cache_stats.homenode_access_scalar;
+    dataArray->tdp_stats.writeAc.miss = 0;
+    dataArray->tdp_stats.writeAc.hit = dataArray->tdp_stats.writeAc.access -
+        dataArray->tdp_stats.writeAc.miss;
+    dataArray->tdp_stats.searchAc.access = 0;
+    dataArray->tdp_stats.searchAc.miss = 0;
+    dataArray->tdp_stats.searchAc.hit = 0;
+
+    dataArray->rtp_stats.reset();
+    if (cache_stats.use_detailed_stats) {
+        dataArray->rtp_stats.dataReadAc.access =
+            cache_stats.num_data_array_reads;
+        dataArray->rtp_stats.dataWriteAc.access =
+            cache_stats.num_data_array_writes;
+        dataArray->rtp_stats.tagReadAc.access =
+            cache_stats.num_tag_array_reads;
+        dataArray->rtp_stats.tagWriteAc.access =
+            cache_stats.num_tag_array_writes;
+    } else {
+        // This code makes assumptions. For instance, it assumes that
+        // tag and data arrays are accessed in parallel on a read request and
+        // this is a write-allocate cache. It also ignores any coherence
+        // requests. Using detailed stats as above can avoid the ambiguity
+        // that is introduced here
+        dataArray->rtp_stats.dataReadAc.access =
+            cache_stats.read_accesses + cache_stats.write_misses;
+        dataArray->rtp_stats.dataWriteAc.access =
+            cache_stats.write_accesses + cache_stats.read_misses;
+        dataArray->rtp_stats.tagReadAc.access =
+            cache_stats.read_accesses + cache_stats.write_accesses;
+        dataArray->rtp_stats.tagWriteAc.access =
+            cache_stats.read_misses + cache_stats.write_misses;
+    }
+
+    // Set SBT stats if this is an SBT directory type
+    if (dir_overhead > 0) {
+        // TDP stats
+        dataArray->sbt_tdp_stats.readAc.access =
+            cache_stats.tdp_read_access_scalar *
+            num_tdp_ports * cache_stats.dir_duty_cycle *
+            (1 - cache_stats.homenode_access_scalar);
+        dataArray->sbt_tdp_stats.readAc.miss = 0;
+        dataArray->sbt_tdp_stats.readAc.hit =
+            dataArray->sbt_tdp_stats.readAc.access -
+            dataArray->sbt_tdp_stats.readAc.miss;
+        dataArray->sbt_tdp_stats.writeAc.access =
+            cache_stats.tdp_sbt_write_access_scalar *
+            num_tdp_ports * cache_stats.dir_duty_cycle *
+            (1 - cache_stats.homenode_access_scalar);
+        dataArray->sbt_tdp_stats.writeAc.miss = 0;
+        dataArray->sbt_tdp_stats.writeAc.hit =
+            dataArray->sbt_tdp_stats.writeAc.access -
+            dataArray->sbt_tdp_stats.writeAc.miss;
+
+        // Runtime power stats
+        dataArray->sbt_rtp_stats.readAc.access =
+            cache_stats.homenode_read_accesses;
+        dataArray->sbt_rtp_stats.readAc.miss =
+            cache_stats.homenode_read_misses;
+        dataArray->sbt_rtp_stats.readAc.access =
+            cache_stats.homenode_read_accesses -
+            cache_stats.homenode_read_misses;
+        dataArray->sbt_rtp_stats.writeAc.access =
+            cache_stats.homenode_write_accesses;
+        dataArray->sbt_rtp_stats.writeAc.miss =
+            cache_stats.homenode_write_misses;
+        dataArray->sbt_rtp_stats.writeAc.hit =
+            cache_stats.homenode_write_accesses -
+            cache_stats.homenode_write_misses;
+    }
+
+    if (missBuffer) {
+        missBuffer->tdp_stats.reset();
+        missBuffer->tdp_stats.readAc.access = 0;
+        missBuffer->tdp_stats.writeAc.access =
+            missBuffer->l_ip.num_search_ports;
+        missBuffer->tdp_stats.searchAc.access =
+            missBuffer->l_ip.num_search_ports;
+
+        missBuffer->rtp_stats.reset();
+        missBuffer->rtp_stats.readAc.access =
+            cache_stats.read_misses + cache_stats.write_misses;
+        missBuffer->rtp_stats.writeAc.access =
+            cache_stats.read_misses + cache_stats.write_misses;
+        missBuffer->rtp_stats.searchAc.access = 0;
+
+        if (cache_params.dir_ty == SBT) {
+            missBuffer->rtp_stats.readAc.access +=
+                cache_stats.homenode_write_misses;
+            missBuffer->rtp_stats.writeAc.access +=
+                cache_stats.homenode_write_misses;
+        }
+    }
+
+    if (fillBuffer) {
+        fillBuffer->tdp_stats.reset();
+        fillBuffer->tdp_stats.readAc.access = 0;
+        fillBuffer->tdp_stats.writeAc.access =
+            fillBuffer->l_ip.num_search_ports;
+        fillBuffer->tdp_stats.searchAc.access =
+            fillBuffer->l_ip.num_search_ports;
+
+        fillBuffer->rtp_stats.reset();
+        fillBuffer->rtp_stats.readAc.access =
+            cache_stats.read_misses + cache_stats.write_misses;
+        fillBuffer->rtp_stats.writeAc.access =
+            cache_stats.read_misses + cache_stats.write_misses;
+        fillBuffer->rtp_stats.searchAc.access = 0;
+
+        if (cache_params.dir_ty == SBT) {
+            fillBuffer->rtp_stats.readAc.access +=
+                cache_stats.homenode_write_misses;
+            fillBuffer->rtp_stats.writeAc.access +=
+                cache_stats.homenode_write_misses;
+        }
+    }
+
+    if (prefetchBuffer) {
+        prefetchBuffer->tdp_stats.reset();
+        prefetchBuffer->tdp_stats.readAc.access = 0;
+        prefetchBuffer->tdp_stats.writeAc.access =
+            prefetchBuffer->l_ip.num_search_ports;
+        prefetchBuffer->tdp_stats.searchAc.access =
+            prefetchBuffer->l_ip.num_search_ports;
+
+        prefetchBuffer->rtp_stats.reset();
+        prefetchBuffer->rtp_stats.readAc.access = cache_stats.read_misses;
+        prefetchBuffer->rtp_stats.writeAc.access = cache_stats.read_misses;
+        prefetchBuffer->rtp_stats.searchAc.access = 0;
+
+        if (cache_params.dir_ty == SBT) {
+            prefetchBuffer->rtp_stats.readAc.access +=
+                cache_stats.homenode_write_misses;
+            prefetchBuffer->rtp_stats.writeAc.access +=
+                cache_stats.homenode_write_misses;
+        }
+    }
+
+    if (writebackBuffer) {
+        writebackBuffer->tdp_stats.reset();
+        writebackBuffer->tdp_stats.readAc.access = 0;
+        writebackBuffer->tdp_stats.writeAc.access =
+            writebackBuffer->l_ip.num_search_ports;
+        writebackBuffer->tdp_stats.searchAc.access =
+            writebackBuffer->l_ip.num_search_ports;
+
+        writebackBuffer->rtp_stats.reset();
+        writebackBuffer->rtp_stats.readAc.access = cache_stats.write_misses;
+        writebackBuffer->rtp_stats.writeAc.access = cache_stats.write_misses;
+        writebackBuffer->rtp_stats.searchAc.access = 0;
+
+        if (cache_params.dir_ty == SBT) {
+            writebackBuffer->rtp_stats.readAc.access +=
+                cache_stats.homenode_write_misses;
+            writebackBuffer->rtp_stats.writeAc.access +=
+                cache_stats.homenode_write_misses;
         }
     }
 }
@@ -591,9 +622,14 @@ void CacheUnit::set_cache_param_from_xml_data() {
         exit(1);
     }
 
+    set_cache_stats_from_xml_data();
+}
+
+void CacheUnit::set_cache_stats_from_xml_data() {
     cache_stats.use_detailed_stats = false;
 
-    num_children = xml_data->nChildNode("stat");
+    int num_children = xml_data->nChildNode("stat");
+    int i;
     for (i = 0; i < num_children; i++) {
         XMLNode* statNode = xml_data->getChildNodePtr("stat", &i);
         XMLCSTR node_name = statNode->getAttribute("name");
@@ -645,3 +681,8 @@ void CacheUnit::set_cache_param_from_xml_data() {
         calculate_runtime_data_and_tag = true;
     }
 }
+
+void CacheUnit::updateStats() {
+    set_cache_stats_from_xml_data();
+    set_array_stats();
+}
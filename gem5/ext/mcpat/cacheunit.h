@@ -38,6 +38,7 @@
 #include "area.h"
 #include "array.h"
 #include "basic_components.h"
+#include "cachearray.h"
 #include "logic.h"
 #include "parameter.h"
 
@@ -157,10 +158,19 @@ public:
 
     double scktRatio;
 
+    CacheArray* dataArray;
+    CacheArray* missBuffer;
+    CacheArray* fillBuffer;
+    CacheArray* prefetchBuffer;
+    CacheArray* writebackBuffer;
+
     // TODO: REMOVE _interface_ip... It promotes a mess. Find a better way...
     CacheUnit(XMLNode* _xml_data, InputParameter* _interface_ip);
     void set_cache_param_from_xml_data();
+    void set_cache_stats_from_xml_data();
+    void set_array_stats();
     void computeEnergy();
+    void updateStats();
     ~CacheUnit() {};
 };
 
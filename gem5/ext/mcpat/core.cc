@@ -2461,6 +2461,16 @@ void InstFetchU::computeEnergy() {
     }
 }
 
+void InstFetchU::updateStats() {
+    if (!exist) return;
+
+    set_params_stats();
+    if (BPT) {
+        BPT->core_stats = core_stats;
+    }
+    McPATComponent::updateStats();
+}
+
 void InstFetchU::displayData(uint32_t indent, int plevel) {
     if (!exist) return;
 
@@ -2994,6 +3004,20 @@ void SchedulerU::computeEnergy() {
     */
 }
 
+void SchedulerU::updateStats() {
+    if (!exist) return;
+
+    if (int_instruction_selection) {
+        int_instruction_selection->accesses =
+            core_stats.inst_window_wakeup_accesses;
+    }
+    if (fp_instruction_selection) {
+        fp_instruction_selection->accesses =
+            core_stats.fp_inst_window_wakeup_accesses;
+    }
+    McPATComponent::updateStats();
+}
+
 void SchedulerU::displayData(uint32_t indent, int plevel) {
     if (!exist) return;
 
@@ -3176,6 +3200,13 @@ void MemManU::computeEnergy() {
     }
 }
 
+void MemManU::updateStats() {
+    if (!exist) return;
+
+    set_params_stats();
+    McPATComponent::updateStats();
+}
+
 void MemManU::displayData(uint32_t indent, int plevel) {
     if (!exist) return;
 
@@ -3275,18 +3306,20 @@ void RegFU::computeEnergy() {
     if (IRF) {
         IRF->output_data.peak_dynamic_power =
             IRF->power_t.readOp.dynamic * clockRate;
-        IRF->output_data.subthreshold_leakage_power *=
-            core_params.num_hthreads;
-        IRF->output_data.gate_leakage_power *= core_params.num_hthreads;
+        IRF->output_data.subthreshold_leakage_power =
+            IRF->power.readOp.leakage * core_params.num_hthreads;
+        IRF->output_data.gate_leakage_power =
+            IRF->power.readOp.gate_leakage * core_params.num_hthreads;
         IRF->output_data.runtime_dynamic_energy = IRF->rt_power.readOp.dynamic;
         output_data += IRF->output_data;
     }
     if (FRF) {
         FRF->output_data.peak_dynamic_power =
             FRF->power_t.readOp.dynamic * clockRate;
-        FRF->output_data.subthreshold_leakage_power *=
-            core_params.num_hthreads;
-        FRF->output_data.gate_leakage_power *= core_params.num_hthreads;
+        FRF->output_data.subthreshold_leakage_power =
+            FRF->power.readOp.leakage * core_params.num_hthreads;
+        FRF->output_data.gate_leakage_power =
+            FRF->power.readOp.gate_leakage * core_params.num_hthreads;
         FRF->output_data.runtime_dynamic_energy = FRF->rt_power.readOp.dynamic;
         output_data += FRF->output_data;
     }
@@ -3366,6 +3399,28 @@ void EXECU::computeEnergy() {
     }
 }
 
+void EXECU::updateStats() {
+    if (!exist) return;
+
+    if (rfu) {
+        rfu->core_stats = core_stats;
+    }
+    if (scheu) {
+        scheu->core_stats = core_stats;
+        scheu->updateStats();
+    }
+    if (fp_u) {
+        fp_u->core_stats = core_stats;
+    }
+    if (exeu) {
+        exeu->core_stats = core_stats;
+    }
+    if (mul) {
+        mul->core_stats = core_stats;
+    }
+    McPATComponent::updateStats();
+}
+
 void EXECU::displayData(uint32_t indent, int plevel) {
     if (!exist) return;
 
@@ -3844,77 +3899,7 @@ void Core::set_core_param() {
     core_params.peak_commitW = core_params.peak_issueW;
     core_params.fp_decodeW = core_params.fp_issueW;
 
-
-    num_children = xml_data->nChildNode("stat");
-    for (i = 0; i < num_children; i++) {
-        XMLNode* statNode = xml_data->getChildNodePtr("stat", &i);
-        XMLCSTR node_name = statNode->getAttribute("name");
-        XMLCSTR value = statNode->getAttribute("value");
-
-        if (!node_name)
-            warnMissingStatName(statNode->getAttribute("id"));
-
-        ASSIGN_FP_IF("ALU_duty_cycle", core_stats.ALU_duty_cycle);
-        ASSIGN_FP_IF("FPU_duty_cycle", core_stats.FPU_duty_cycle);
-        ASSIGN_FP_IF("MUL_duty_cycle", core_stats.MUL_duty_cycle);
-        ASSIGN_FP_IF("ALU_cdb_duty_cycle", core_stats.ALU_cdb_duty_cycle);
-        ASSIGN_FP_IF("FPU_cdb_duty_cycle", core_stats.FPU_cdb_duty_cycle);
-        ASSIGN_FP_IF("MUL_cdb_duty_cycle", core_stats.MUL_cdb_duty_cycle);
-        ASSIGN_FP_IF("pipeline_duty_cycle", core_stats.pipeline_duty_cycle);
-        ASSIGN_FP_IF("total_cycles", core_stats.total_cycles);
-        ASSIGN_FP_IF("busy_cycles", core_stats.busy_cycles);
-        ASSIGN_FP_IF("idle_cycles", core_stats.idle_cycles);
-        ASSIGN_FP_IF("IFU_duty_cycle", core_stats.IFU_duty_cycle);
-        ASSIGN_FP_IF("BR_duty_cycle", core_stats.BR_duty_cycle);
-        ASSIGN_FP_IF("LSU_duty_cycle", core_stats.LSU_duty_cycle);
-        ASSIGN_FP_IF("MemManU_D_duty_cycle", core_stats.MemManU_D_duty_cycle);
-        ASSIGN_FP_IF("MemManU_I_duty_cycle", core_stats.MemManU_I_duty_cycle);
-        ASSIGN_FP_IF("cdb_fpu_accesses", core_stats.cdb_fpu_accesses);
-        ASSIGN_FP_IF("cdb_alu_accesses", core_stats.cdb_alu_accesses);
-        ASSIGN_FP_IF("cdb_mul_accesses", core_stats.cdb_mul_accesses);
-        ASSIGN_FP_IF("function_calls", core_stats.function_calls);
-        ASSIGN_FP_IF("total_instructions", core_stats.total_instructions);
-        ASSIGN_FP_IF("int_instructions", core_stats.int_instructions);
-        ASSIGN_FP_IF("fp_instructions", core_stats.fp_instructions);
-        ASSIGN_FP_IF("branch_instructions", core_stats.branch_instructions);
-        ASSIGN_FP_IF("branch_mispredictions",
-                     core_stats.branch_mispredictions);
-        ASSIGN_FP_IF("load_instructions", core_stats.load_instructions);
-        ASSIGN_FP_IF("store_instructions", core_stats.store_instructions);
-        ASSIGN_FP_IF("committed_instructions",
-                     core_stats.committed_instructions);
-        ASSIGN_FP_IF("committed_int_instructions",
-                     core_stats.committed_int_instructions);
-        ASSIGN_FP_IF("committed_fp_instructions",
-                     core_stats.committed_fp_instructions);
-        ASSIGN_FP_IF("ROB_reads", core_stats.ROB_reads);
-        ASSIGN_FP_IF("ROB_writes", core_stats.ROB_writes);
-        ASSIGN_FP_IF("rename_reads", core_stats.rename_reads);
-        ASSIGN_FP_IF("rename_writes", core_stats.rename_writes);
-        ASSIGN_FP_IF("fp_rename_reads", core_stats.fp_rename_reads);
-        ASSIGN_FP_IF("fp_rename_writes", core_stats.fp_rename_writes);
-        ASSIGN_FP_IF("inst_window_reads", core_stats.inst_window_reads);
-        ASSIGN_FP_IF("inst_window_writes", core_stats.inst_window_writes);
-        ASSIGN_FP_IF("inst_window_wakeup_accesses",
-                     core_stats.inst_window_wakeup_accesses);
-        ASSIGN_FP_IF("fp_inst_window_reads", core_stats.fp_inst_window_reads);
-        ASSIGN_FP_IF("fp_inst_window_writes",
-                     core_stats.fp_inst_window_writes);
-        ASSIGN_FP_IF("fp_inst_window_wakeup_accesses",
-                     core_stats.fp_inst_window_wakeup_accesses);
-        ASSIGN_FP_IF("int_regfile_reads", core_stats.int_regfile_reads);
-        ASSIGN_FP_IF("float_regfile_reads", core_stats.float_regfile_reads);
-        ASSIGN_FP_IF("int_regfile_writes", core_stats.int_regfile_writes);
-        ASSIGN_FP_IF("float_regfile_writes", core_stats.float_regfile_writes);
-        ASSIGN_FP_IF("context_switches", core_stats.context_switches);
-        ASSIGN_FP_IF("ialu_accesses", core_stats.ialu_accesses);
-        ASSIGN_FP_IF("fpu_accesses", core_stats.fpu_accesses);
-        ASSIGN_FP_IF("mul_accesses", core_stats.mul_accesses);
-
-        else {
-            warnUnrecognizedStat(node_name);
-        }
-    }
+    set_core_stats();
 
     // Initialize a few variables
     core_params.multithreaded = core_params.num_hthreads > 1 ? true : false;
@@ -4007,3 +3992,92 @@ void Core::set_core_param() {
     }
 
 }
+
+void Core::set_core_stats() {
+    int num_children = xml_data->nChildNode("stat");
+    int i;
+    for (i = 0; i < num_children; i++) {
+        XMLNode* statNode = xml_data->getChildNodePtr("stat", &i);
+        XMLCSTR node_name = statNode->getAttribute("name");
+        XMLCSTR value = statNode->getAttribute("value");
+
+        if (!node_name)
+            warnMissingStatName(statNode->getAttribute("id"));
+
+        ASSIGN_FP_IF("ALU_duty_cycle", core_stats.ALU_duty_cycle);
+        ASSIGN_FP_IF("FPU_duty_cycle", core_stats.FPU_duty_cycle);
+        ASSIGN_FP_IF("MUL_duty_cycle", core_stats.MUL_duty_cycle);
+        ASSIGN_FP_IF("ALU_cdb_duty_cycle", core_stats.ALU_cdb_duty_cycle);
+        ASSIGN_FP_IF("FPU_cdb_duty_cycle", core_stats.FPU_cdb_duty_cycle);
+        ASSIGN_FP_IF("MUL_cdb_duty_cycle", core_stats.MUL_cdb_duty_cycle);
+        ASSIGN_FP_IF("pipeline_duty_cycle", core_stats.pipeline_duty_cycle);
+        ASSIGN_FP_IF("total_cycles", core_stats.total_cycles);
+        ASSIGN_FP_IF("busy_cycles", core_stats.busy_cycles);
+        ASSIGN_FP_IF("idle_cycles", core_stats.idle_cycles);
+        ASSIGN_FP_IF("IFU_duty_cycle", core_stats.IFU_duty_cycle);
+        ASSIGN_FP_IF("BR_duty_cycle", core_stats.BR_duty_cycle);
+        ASSIGN_FP_IF("LSU_duty_cycle", core_stats.LSU_duty_cycle);
+        ASSIGN_FP_IF("MemManU_D_duty_cycle", core_stats.MemManU_D_duty_cycle);
+        ASSIGN_FP_IF("MemManU_I_duty_cycle", core_stats.MemManU_I_duty_cycle);
+        ASSIGN_FP_IF("cdb_fpu_accesses", core_stats.cdb_fpu_accesses);
+        ASSIGN_FP_IF("cdb_alu_accesses", core_stats.cdb_alu_accesses);
+        ASSIGN_FP_IF("cdb_mul_accesses", core_stats.cdb_mul_accesses);
+        ASSIGN_FP_IF("function_calls", core_stats.function_calls);
+        ASSIGN_FP_IF("total_instructions", core_stats.total_instructions);
+        ASSIGN_FP_IF("int_instructions", core_stats.int_instructions);
+        ASSIGN_FP_IF("fp_instructions", core_stats.fp_instructions);
+        ASSIGN_FP_IF("branch_instructions", core_stats.branch_instructions);
+        ASSIGN_FP_IF("branch_mispredictions",
+                     core_stats.branch_mispredictions);
+        ASSIGN_FP_IF("load_instructions", core_stats.load_instructions);
+        ASSIGN_FP_IF("store_instructions", core_stats.store_instructions);
+        ASSIGN_FP_IF("committed_instructions",
+                     core_stats.committed_instructions);
+        ASSIGN_FP_IF("committed_int_instructions",
+                     core_stats.committed_int_instructions);
+        ASSIGN_FP_IF("committed_fp_instructions",
+                     core_stats.committed_fp_instructions);
+        ASSIGN_FP_IF("ROB_reads", core_stats.ROB_reads);
+        ASSIGN_FP_IF("ROB_writes", core_stats.ROB_writes);
+        ASSIGN_FP_IF("rename_reads", core_stats.rename_reads);
+        ASSIGN_FP_IF("rename_writes", core_stats.rename_writes);
+        ASSIGN_FP_IF("fp_rename_reads", core_stats.fp_rename_reads);
+        ASSIGN_FP_IF("fp_rename_writes", core_stats.fp_rename_writes);
+        ASSIGN_FP_IF("inst_window_reads", core_stats.inst_window_reads);
+        ASSIGN_FP_IF("inst_window_writes", core_stats.inst_window_writes);
+        ASSIGN_FP_IF("inst_window_wakeup_accesses",
+                     core_stats.inst_window_wakeup_accesses);
+        ASSIGN_FP_IF("fp_inst_window_reads", core_stats.fp_inst_window_reads);
+        ASSIGN_FP_IF("fp_inst_window_writes",
+                     core_stats.fp_inst_window_writes);
+        ASSIGN_FP_IF("fp_inst_window_wakeup_accesses",
+                     core_stats.fp_inst_window_wakeup_accesses);
+        ASSIGN_FP_IF("int_regfile_reads", core_stats.int_regfile_reads);
+        ASSIGN_FP_IF("float_regfile_reads", core_stats.float_regfile_reads);
+        ASSIGN_FP_IF("int_regfile_writes", core_stats.int_regfile_writes);
+        ASSIGN_FP_IF("float_regfile_writes", core_stats.float_regfile_writes);
+        ASSIGN_FP_IF("context_switches", core_stats.context_switches);
+        ASSIGN_FP_IF("ialu_accesses", core_stats.ialu_accesses);
+        ASSIGN_FP_IF("fpu_accesses", core_stats.fpu_accesses);
+        ASSIGN_FP_IF("mul_accesses", core_stats.mul_accesses);
+
+        else {
+            warnUnrecognizedStat(node_name);
+        }
+    }
+}
+
+void Core::updateStats() {
+    set_core_stats();
+
+    // The units keep their own copy of the stats of the core
+    ifu->core_stats = core_stats;
+    lsu->core_stats = core_stats;
+    mmu->core_stats = core_stats;
+    exu->core_stats = core_stats;
+    if (rnu) {
+        rnu->core_stats = core_stats;
+    }
+
+    McPATComponent::updateStats();
+}
@@ -126,6 +126,7 @@ public:
                bool exsit = true);
     void set_params_stats();
     void computeEnergy();
+    void updateStats();
     void displayData(uint32_t indent = 0, int plevel = 100);
     ~InstFetchU();
 };
@@ -153,6 +154,7 @@ public:
                const CoreStatistics & _core_stats,
                bool exist_ = true);
     void computeEnergy();
+    void updateStats();
     void displayData(uint32_t indent = 0, int plevel = 100);
     ~SchedulerU();
 };
@@ -250,6 +252,7 @@ public:
             const CoreStatistics & _core_stats, bool exist_ = true);
     void set_params_stats();
     void computeEnergy();
+    void updateStats();
     void displayData(uint32_t indent = 0, int plevel = 100);
     ~MemManU();
 };
@@ -303,6 +306,7 @@ public:
           double lsq_height_, const CoreParameters & _core_params,
           const CoreStatistics & _core_stats, bool exist_ = true);
     void computeEnergy();
+    void updateStats();
     void displayData(uint32_t indent = 0, int plevel = 100);
     ~EXECU();
 };
@@ -331,7 +335,9 @@ public:
     void initialize_params();
     void initialize_stats();
     void set_core_param();
+    void set_core_stats();
     void computeEnergy();
+    void updateStats();
     ~Core();
 };
 
@@ -217,7 +217,12 @@ void NIUController::set_niu_param() {
     // Change from MHz to Hz
     niup.clockRate *= 1e6;
 
-    num_children = xml_data->nChildNode("stat");
+    set_niu_stats();
+}
+
+void NIUController::set_niu_stats() {
+    int num_children = xml_data->nChildNode("stat");
+    int i;
     for (i = 0; i < num_children; i++) {
         XMLNode* statNode = xml_data->getChildNodePtr("stat", &i);
         XMLCSTR node_name = statNode->getAttribute("name");
@@ -235,6 +240,10 @@ void NIUController::set_niu_param() {
     }
 }
 
+void NIUController::updateStats() {
+    set_niu_stats();
+}
+
 PCIeController::PCIeController(XMLNode* _xml_data,
                                InputParameter* interface_ip_)
     : McPATComponent(_xml_data, interface_ip_) {
@@ -380,7 +389,12 @@ void PCIeController::set_pcie_param() {
     // Change from MHz to Hz
     pciep.clockRate *= 1e6;
 
-    num_children = xml_data->nChildNode("stat");
+    set_pcie_stats();
+}
+
+void PCIeController::set_pcie_stats() {
+    int num_children = xml_data->nChildNode("stat");
+    int i;
     for (i = 0; i < num_children; i++) {
         XMLNode* statNode = xml_data->getChildNodePtr("stat", &i);
         XMLCSTR node_name = statNode->getAttribute("name");
@@ -398,6 +412,10 @@ void PCIeController::set_pcie_param() {
     }
 }
 
+void PCIeController::updateStats() {
+    set_pcie_stats();
+}
+
 FlashController::FlashController(XMLNode* _xml_data,
                                  InputParameter* interface_ip_)
     : McPATComponent(_xml_data, interface_ip_) {
@@ -521,7 +539,12 @@ void FlashController::set_fc_param()
         }
     }
 
-    num_children = xml_data->nChildNode("stat");
+    set_fc_stats();
+}
+
+void FlashController::set_fc_stats() {
+    int num_children = xml_data->nChildNode("stat");
+    int i;
     for (i = 0; i < num_children; i++) {
         XMLNode* statNode = xml_data->getChildNodePtr("stat", &i);
         XMLCSTR node_name = statNode->getAttribute("name");
@@ -538,3 +561,7 @@ void FlashController::set_fc_param()
         }
     }
 }
+
+void FlashController::updateStats() {
+    set_fc_stats();
+}
@@ -45,6 +45,8 @@ class NIUController : public McPATComponent {
 
     NIUController(XMLNode* _xml_data, InputParameter* interface_ip_);
     void set_niu_param();
+    void set_niu_stats();
+    void updateStats();
     void computeArea();
     void computeEnergy();
     ~NIUController(){};
@@ -57,6 +59,8 @@ class PCIeController : public McPATComponent {
 
     PCIeController(XMLNode* _xml_data, InputParameter* interface_ip_);
     void set_pcie_param();
+    void set_pcie_stats();
+    void updateStats();
     void computeArea();
     void computeEnergy();
     ~PCIeController(){};
@@ -69,6 +73,8 @@ class FlashController : public McPATComponent {
 
     FlashController(XMLNode* _xml_data, InputParameter* interface_ip_);
     void set_fc_param();
+    void set_fc_stats();
+    void updateStats();
     void computeArea();
     void computeEnergy();
     ~FlashController(){};
@@ -385,6 +385,11 @@ void Pipeline::compute() {
     output_data.runtime_dynamic_energy = power.readOp.dynamic * total_cycles;
 }
 
+void Pipeline::updateStats() {
+    // The runtime energy depends on the number of cycles of the interval
+    output_data.runtime_dynamic_energy = power.readOp.dynamic * total_cycles;
+}
+
 void Pipeline::compute_stage_vector() {
     double num_stages, tot_stage_vector, per_stage_vector;
     int opcode_length = coredynp.x86 ?
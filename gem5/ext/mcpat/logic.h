@@ -181,6 +181,7 @@ public:
     void computeArea() {};
     // TODO: Move energy computation to this function to unify hierarchy
     void computeEnergy() {};
+    void updateStats();
     ~Pipeline() {
         local_result.cleanup();
     };
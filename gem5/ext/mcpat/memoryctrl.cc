@@ -77,7 +77,10 @@ MCBackend::MCBackend(XMLNode* _xml_data, InputParameter* interface_ip_,
     name = "Transaction Engine";
     local_result = init_interface(&l_ip, name);
 
-    // Set up stats for the power calculations
+    set_access_stats();
+}
+
+void MCBackend::set_access_stats() {
     tdp_stats.reset();
     tdp_stats.readAc.access = 0.5 * mcp.num_channels * mcp.clockRate;
     tdp_stats.writeAc.access = 0.5 * mcp.num_channels * mcp.clockRate;
@@ -86,6 +89,10 @@ MCBackend::MCBackend(XMLNode* _xml_data, InputParameter* interface_ip_,
     rtp_stats.writeAc.access = mcs.writes;
 }
 
+void MCBackend::updateStats() {
+    set_access_stats();
+}
+
 void MCBackend::computeArea() {
     // The area is in nm^2
     if (mcp.mc_type == MC) {
@@ -206,7 +213,10 @@ MCPHY::MCPHY(XMLNode* _xml_data, InputParameter* interface_ip_,
     name = "Physical Interface (PHY)";
     local_result = init_interface(&l_ip, name);
 
-    // Set up stats for the power calculations
+    set_access_stats();
+}
+
+void MCPHY::set_access_stats() {
     // TODO: Figure out why TDP stats aren't used
     tdp_stats.reset();
     tdp_stats.readAc.access = 0.5 * mcp.num_channels;
@@ -216,6 +226,10 @@ MCPHY::MCPHY(XMLNode* _xml_data, InputParameter* interface_ip_,
     rtp_stats.writeAc.access = mcs.writes;
 }
 
+void MCPHY::updateStats() {
+    set_access_stats();
+}
+
 void MCPHY::computeArea() {
     if (mcp.mc_type == MC) {
         if (mcp.type == 0) {
@@ -361,30 +375,6 @@ MCFrontEnd::MCFrontEnd(XMLNode* _xml_data, InputParameter* interface_ip_,
                                     Uncore_device, mcp.clockRate);
     children.push_back(frontendBuffer);
 
-    frontendBuffer->tdp_stats.reset();
-    frontendBuffer->tdp_stats.readAc.access =
-        frontendBuffer->l_ip.num_search_ports +
-        frontendBuffer->l_ip.num_wr_ports;
-    frontendBuffer->tdp_stats.writeAc.access =
-        frontendBuffer->l_ip.num_search_ports;
-    frontendBuffer->tdp_stats.searchAc.access =
-        frontendBuffer->l_ip.num_wr_ports;
-    frontendBuffer->rtp_stats.reset();
-    // TODO: These stats assume that access power is calculated per buffer
-    // bit, which requires the stats to take into account the number of
-    // bits for each buffer slot. This should be revised...
-    //For each channel, each memory word need to check the address data to
-    //achieve best scheduling results.
-    //and this need to be done on all physical DIMMs in each logical memory
-    //DIMM *mcp.dataBusWidth/72
-    frontendBuffer->rtp_stats.readAc.access = mcs.reads * mcp.llcBlockSize *
-        BITS_PER_BYTE / mcp.dataBusWidth * mcp.dataBusWidth / 72;
-    frontendBuffer->rtp_stats.writeAc.access = mcs.writes * mcp.llcBlockSize *
-        BITS_PER_BYTE / mcp.dataBusWidth * mcp.dataBusWidth / 72;
-    frontendBuffer->rtp_stats.searchAc.access =
-        frontendBuffer->rtp_stats.readAc.access +
-        frontendBuffer->rtp_stats.writeAc.access;
-
     // Read Buffers
     //Support key words first operation
     data = (int)ceil(mcp.dataBusWidth / BITS_PER_BYTE);
@@ -415,17 +405,6 @@ MCFrontEnd::MCFrontEnd(XMLNode* _xml_data, InputParameter* interface_ip_,
                                 Uncore_device, mcp.clockRate);
     children.push_back(readBuffer);
 
-    readBuffer->tdp_stats.reset();
-    readBuffer->tdp_stats.readAc.access = readBuffer->l_ip.num_rd_ports *
-        mcs.duty_cycle;
-    readBuffer->tdp_stats.writeAc.access = readBuffer->l_ip.num_wr_ports *
-        mcs.duty_cycle;
-    readBuffer->rtp_stats.reset();
-    readBuffer->rtp_stats.readAc.access = mcs.reads * mcp.llcBlockSize *
-        BITS_PER_BYTE / mcp.dataBusWidth;
-    readBuffer->rtp_stats.writeAc.access = mcs.reads * mcp.llcBlockSize *
-        BITS_PER_BYTE / mcp.dataBusWidth;
-
     // Write Buffer
     //Support key words first operation
     data = (int)ceil(mcp.dataBusWidth / BITS_PER_BYTE);
@@ -456,6 +435,55 @@ MCFrontEnd::MCFrontEnd(XMLNode* _xml_data, InputParameter* interface_ip_,
                                  Uncore_device, mcp.clockRate);
     children.push_back(writeBuffer);
 
+    // TODO: Set up selection logic as a leaf node in tree
+    //selection and arbitration logic
+    MC_arb =
+        new selection_logic(xml_data, is_default,
+                            mcp.req_window_size_per_channel, 1, &interface_ip,
+                            "Arbitration Logic", (mcs.reads + mcs.writes),
+                            mcp.clockRate, Uncore_device);
+    // MC_arb is not included in the roll-up due to the uninitialized area
+    //children.push_back(MC_arb);
+
+    set_access_stats();
+}
+
+void MCFrontEnd::set_access_stats() {
+    frontendBuffer->tdp_stats.reset();
+    frontendBuffer->tdp_stats.readAc.access =
+        frontendBuffer->l_ip.num_search_ports +
+        frontendBuffer->l_ip.num_wr_ports;
+    frontendBuffer->tdp_stats.writeAc.access =
+        frontendBuffer->l_ip.num_search_ports;
+    frontendBuffer->tdp_stats.searchAc.access =
+        frontendBuffer->l_ip.num_wr_ports;
+    frontendBuffer->rtp_stats.reset();
+    // TODO: These stats assume that access power is calculated per buffer
+    // bit, which requires the stats to take into account the number of
+    // bits for each buffer slot. This should be revised...
+    //For each channel, each memory word need to check the address data to
+    //achieve best scheduling results.
+    //and this need to be done on all physical DIMMs in each logical memory
+    //DIMM *mcp.dataBusWidth/72
+    frontendBuffer->rtp_stats.readAc.access = mcs.reads * mcp.llcBlockSize *
+        BITS_PER_BYTE / mcp.dataBusWidth * mcp.dataBusWidth / 72;
+    frontendBuffer->rtp_stats.writeAc.access = mcs.writes * mcp.llcBlockSize *
+        BITS_PER_BYTE / mcp.dataBusWidth * mcp.dataBusWidth / 72;
+    frontendBuffer->rtp_stats.searchAc.access =
+        frontendBuffer->rtp_stats.readAc.access +
+        frontendBuffer->rtp_stats.writeAc.access;
+
+    readBuffer->tdp_stats.reset();
+    readBuffer->tdp_stats.readAc.access = readBuffer->l_ip.num_rd_ports *
+        mcs.duty_cycle;
+    readBuffer->tdp_stats.writeAc.access = readBuffer->l_ip.num_wr_ports *
+        mcs.duty_cycle;
+    readBuffer->rtp_stats.reset();
+    readBuffer->rtp_stats.readAc.access = mcs.reads * mcp.llcBlockSize *
+        BITS_PER_BYTE / mcp.dataBusWidth;
+    readBuffer->rtp_stats.writeAc.access = mcs.reads * mcp.llcBlockSize *
+        BITS_PER_BYTE / mcp.dataBusWidth;
+
     writeBuffer->tdp_stats.reset();
     writeBuffer->tdp_stats.readAc.access = writeBuffer->l_ip.num_rd_ports *
         mcs.duty_cycle;
@@ -467,28 +495,28 @@ MCFrontEnd::MCFrontEnd(XMLNode* _xml_data, InputParameter* interface_ip_,
     writeBuffer->rtp_stats.writeAc.access = mcs.writes * mcp.llcBlockSize *
         BITS_PER_BYTE / mcp.dataBusWidth;
 
-    // TODO: Set up selection logic as a leaf node in tree
-    //selection and arbitration logic
-    MC_arb =
-        new selection_logic(xml_data, is_default,
-                            mcp.req_window_size_per_channel, 1, &interface_ip,
-                            "Arbitration Logic", (mcs.reads + mcs.writes),
-                            mcp.clockRate, Uncore_device);
-    // MC_arb is not included in the roll-up due to the uninitialized area
-    //children.push_back(MC_arb);
+    MC_arb->accesses = mcs.reads + mcs.writes;
+}
+
+void MCFrontEnd::updateStats() {
+    set_access_stats();
 }
 
 MemoryController::MemoryController(XMLNode* _xml_data,
                                    InputParameter* interface_ip_)
-    : McPATComponent(_xml_data), interface_ip(*interface_ip_) {
+    : McPATComponent(_xml_data), frontend(NULL), backend(NULL), phy(NULL),
+      interface_ip(*interface_ip_) {
     name = "Memory Controller";
     set_mc_param();
     // TODO: Pass params and stats as pointers
-    children.push_back(new MCFrontEnd(xml_data, &interface_ip, mcp, mcs));
-    children.push_back(new MCBackend(xml_data, &interface_ip, mcp, mcs));
+    frontend = new MCFrontEnd(xml_data, &interface_ip, mcp, mcs);
+    children.push_back(frontend);
+    backend = new MCBackend(xml_data, &interface_ip, mcp, mcs);
+    children.push_back(backend);
 
     if (mcp.type==0 || (mcp.type == 1 && mcp.withPHY)) {
-        children.push_back(new MCPHY(xml_data, &interface_ip, mcp, mcs));
+        phy = new MCPHY(xml_data, &interface_ip, mcp, mcs);
+        children.push_back(phy);
     }
 }
 
@@ -561,7 +589,18 @@ void MemoryController::set_mc_param() {
     interface_ip.wire_is_mat_type = mat_type;
     interface_ip.wire_os_mat_type = mat_type;
 
-    num_children = xml_data->nChildNode("stat");
+    set_mc_stats();
+
+    // Add ECC overhead
+    mcp.llcBlockSize = int(ceil(mcp.llc_line_length / BITS_PER_BYTE)) +
+        mcp.llc_line_length;
+    mcp.dataBusWidth = int(ceil(mcp.databus_width / BITS_PER_BYTE)) +
+        mcp.databus_width;
+}
+
+void MemoryController::set_mc_stats() {
+    int num_children = xml_data->nChildNode("stat");
+    int i;
     for (i = 0; i < num_children; i++) {
         XMLNode* statNode = xml_data->getChildNodePtr("stat", &i);
         XMLCSTR node_name = statNode->getAttribute("name");
@@ -579,12 +618,18 @@ void MemoryController::set_mc_param() {
             warnUnrecognizedStat(node_name);
         }
     }
+}
 
-    // Add ECC overhead
-    mcp.llcBlockSize = int(ceil(mcp.llc_line_length / BITS_PER_BYTE)) +
-        mcp.llc_line_length;
-    mcp.dataBusWidth = int(ceil(mcp.databus_width / BITS_PER_BYTE)) +
-        mcp.databus_width;
+void MemoryController::updateStats() {
+    set_mc_stats();
+
+    // The parts of the controller keep their own copy of the stats
+    frontend->mcs = mcs;
+    backend->mcs = mcs;
+    if (phy) {
+        phy->mcs = mcs;
+    }
+    McPATComponent::updateStats();
 }
 
 MCFrontEnd ::~MCFrontEnd() {
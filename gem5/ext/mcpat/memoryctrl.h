@@ -50,6 +50,8 @@ public:
               const MCParameters & mcp_, const MCStatistics & mcs_);
     void computeArea();
     void computeEnergy();
+    void set_access_stats();
+    void updateStats();
     ~MCBackend() {};
 };
 
@@ -65,6 +67,8 @@ public:
           const MCParameters & mcp_, const MCStatistics & mcs_);
     void computeArea();
     void computeEnergy();
+    void set_access_stats();
+    void updateStats();
     ~MCPHY() {};
 };
 
@@ -82,11 +86,17 @@ public:
     MCFrontEnd(XMLNode* _xml_data,
                InputParameter* interface_ip_, const MCParameters & mcp_,
                const MCStatistics & mcs_);
+    void set_access_stats();
+    void updateStats();
     ~MCFrontEnd();
 };
 
 class MemoryController : public McPATComponent {
 public:
+    MCFrontEnd* frontend;
+    MCBackend* backend;
+    MCPHY* phy;
+
     InputParameter interface_ip;
     MCParameters mcp;
     MCStatistics mcs;
@@ -94,6 +104,8 @@ public:
     MemoryController(XMLNode* _xml_data, InputParameter* interface_ip_);
     void initialize_params();
     void set_mc_param();
+    void set_mc_stats();
+    void updateStats();
     ~MemoryController();
 };
 
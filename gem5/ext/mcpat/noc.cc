@@ -226,7 +226,26 @@ void OnChipNetwork::set_param_stats() {
     interface_ip.wire_is_mat_type = mat_type;
     interface_ip.wire_os_mat_type = mat_type;
 
-    num_children = xml_data->nChildNode("stat");
+    set_noc_stats();
+
+    clockRate = noc_params.clockRate;
+    noc_params.min_ports =
+        min(noc_params.input_ports, noc_params.output_ports);
+    if (noc_params.type) {
+        noc_params.global_linked_ports = (noc_params.input_ports - 1) +
+            (noc_params.output_ports - 1);
+    }
+    noc_params.total_nodes =
+        noc_params.horizontal_nodes * noc_params.vertical_nodes;
+
+    assert(noc_params.chip_coverage <= 1);
+    assert(noc_params.route_over_perc <= 1);
+    assert(link_len > 0);
+}
+
+void OnChipNetwork::set_noc_stats() {
+    int num_children = xml_data->nChildNode("stat");
+    int i;
     for (i = 0; i < num_children; i++) {
         XMLNode* statNode = xml_data->getChildNodePtr("stat", &i);
         XMLCSTR node_name = statNode->getAttribute("name");
@@ -242,20 +261,11 @@ void OnChipNetwork::set_param_stats() {
             warnUnrecognizedStat(node_name);
         }
     }
+}
 
-    clockRate = noc_params.clockRate;
-    noc_params.min_ports =
-        min(noc_params.input_ports, noc_params.output_ports);
-    if (noc_params.type) {
-        noc_params.global_linked_ports = (noc_params.input_ports - 1) +
-            (noc_params.output_ports - 1);
-    }
-    noc_params.total_nodes =
-        noc_params.horizontal_nodes * noc_params.vertical_nodes;
-
-    assert(noc_params.chip_coverage <= 1);
-    assert(noc_params.route_over_perc <= 1);
-    assert(link_len > 0);
+void OnChipNetwork::updateStats() {
+    set_noc_stats();
+    McPATComponent::updateStats();
 }
 
 OnChipNetwork ::~OnChipNetwork() {
@@ -92,6 +92,8 @@ public:
     OnChipNetwork(XMLNode* _xml_data, int ithNoC_,
                   InputParameter* interface_ip_);
     void set_param_stats();
+    void set_noc_stats();
+    void updateStats();
     void computeEnergy();
     void init_link_bus();
     void init_router();
@@ -254,21 +254,7 @@ void System::set_proc_param() {
     interconnect_projection_type =
         (interconnect_projection_type == 0) ? 0 : 1;
 
-    num_children = xml_data->nChildNode("stat");
-    for (i = 0; i < num_children; i++) {
-        XMLNode* statNode = xml_data->getChildNodePtr("stat", &i);
-        XMLCSTR node_name = statNode->getAttribute("name");
-        XMLCSTR value = statNode->getAttribute("value");
-
-        if (!node_name)
-            warnMissingStatName(statNode->getAttribute("id"));
-
-        ASSIGN_FP_IF("total_cycles", total_cycles);
-
-        else {
-            warnUnrecognizedStat(node_name);
-        }
-    }
+    set_proc_stats();
 
     if (temperature < 0) {
         errorUnspecifiedParam("temperature");
@@ -300,7 +286,6 @@ void System::set_proc_param() {
     }
 
     clockRate = target_core_clockrate;
-    execution_time = total_cycles / (target_core_clockrate);
 
     /* Basic parameters*/
     interface_ip.data_arr_ram_cell_tech_type = device_type;
@@ -345,6 +330,32 @@ void System::set_proc_param() {
     interface_ip.num_se_rd_ports = 0;
 }
 
+void System::set_proc_stats() {
+    int num_children = xml_data->nChildNode("stat");
+    int i;
+    for (i = 0; i < num_children; i++) {
+        XMLNode* statNode = xml_data->getChildNodePtr("stat", &i);
+        XMLCSTR node_name = statNode->getAttribute("name");
+        XMLCSTR value = statNode->getAttribute("value");
+
+        if (!node_name)
+            warnMissingStatName(statNode->getAttribute("id"));
+
+        ASSIGN_FP_IF("total_cycles", total_cycles);
+
+        else {
+            warnUnrecognizedStat(node_name);
+        }
+    }
+
+    execution_time = total_cycles / (target_core_clockrate);
+}
+
+void System::updateStats() {
+    set_proc_stats();
+    McPATComponent::updateStats();
+}
+
 System::~System() {
     // TODO: Delete children... do this in McPATComponent
 };
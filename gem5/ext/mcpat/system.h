@@ -61,6 +61,8 @@ public:
 
     System(XMLNode* _xml_data);
     void set_proc_param();
+    void set_proc_stats();
+    void updateStats();
     // TODO: make this recursively compute energy on subcomponents
     void displayData(uint32_t indent = 0, int plevel = 100);
     void displayDeviceType(int device_type_, uint32_t indent = 0);
@@ -511,7 +511,7 @@ namespace Gcn3ISA
 
             for (int lane = 0; lane < NumVecElemPerVecReg; ++lane) {
                 if (wf->execMask(lane)) {
-                    gpuDynInst->addr.at(lane) = (Addr)addr[lane];
+                    gpuDynInst->addr[lane] = (Addr)addr[lane];
                 }
             }
         }
@@ -593,7 +593,7 @@ namespace Gcn3ISA
             // create request and set flags
             gpuDynInst->resetEntireStatusVector();
             gpuDynInst->setStatusVector(0, 1);
-            RequestPtr req = std::make_shared<Request>(0, 0, 0,
+            RequestPtr req = makeRequest(0, 0, 0,
                                        gpuDynInst->computeUnit()->
                                        requestorId(), 0,
                                        gpuDynInst->wfDynId);
@@ -718,7 +718,7 @@ namespace Gcn3ISA
                             "stride = %llx, buf_idx = %llx, buf_off = %llx\n",
                             lane, vaddr, base_addr, stride,
                             buf_idx, buf_off);
-                    gpuDynInst->addr.at(lane) = vaddr;
+                    gpuDynInst->addr[lane] = vaddr;
                 }
             }
         }
@@ -908,7 +908,7 @@ namespace Gcn3ISA
         {
             for (int lane = 0; lane < NumVecElemPerVecReg; ++lane) {
                 if (gpuDynInst->exec_mask[lane]) {
-                    gpuDynInst->addr.at(lane) = addr[lane];
+                    gpuDynInst->addr[lane] = addr[lane];
                 }
             }
             gpuDynInst->resolveFlatSegment(gpuDynInst->exec_mask);
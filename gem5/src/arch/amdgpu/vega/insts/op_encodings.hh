@@ -473,7 +473,7 @@ namespace VegaISA
 
             for (int lane = 0; lane < NumVecElemPerVecReg; ++lane) {
                 if (wf->execMask(lane)) {
-                    gpuDynInst->addr.at(lane) = (Addr)addr[lane];
+                    gpuDynInst->addr[lane] = (Addr)addr[lane];
                 }
             }
         }
@@ -555,7 +555,7 @@ namespace VegaISA
             // create request and set flags
             gpuDynInst->resetEntireStatusVector();
             gpuDynInst->setStatusVector(0, 1);
-            RequestPtr req = std::make_shared<Request>(0, 0, 0,
+            RequestPtr req = makeRequest(0, 0, 0,
                                        gpuDynInst->computeUnit()->
                                        requestorId(), 0,
                                        gpuDynInst->wfDynId);
@@ -677,7 +677,7 @@ namespace VegaISA
                             "stride = %llx, buf_idx = %llx, buf_off = %llx\n",
                             lane, vaddr, base_addr, stride,
                             buf_idx, buf_off);
-                    gpuDynInst->addr.at(lane) = vaddr;
+                    gpuDynInst->addr[lane] = vaddr;
                 }
             }
         }
@@ -845,7 +845,7 @@ namespace VegaISA
         {
             for (int lane = 0; lane < NumVecElemPerVecReg; ++lane) {
                 if (gpuDynInst->exec_mask[lane]) {
-                    gpuDynInst->addr.at(lane) =
+                    gpuDynInst->addr[lane] =
                         (vaddr[lane] + saddr.rawData() + offset) & 0xffffffff;
                 }
             }
@@ -857,7 +857,7 @@ namespace VegaISA
         {
             for (int lane = 0; lane < NumVecElemPerVecReg; ++lane) {
                 if (gpuDynInst->exec_mask[lane]) {
-                    gpuDynInst->addr.at(lane) = addr[lane] + offset;
+                    gpuDynInst->addr[lane] = addr[lane] + offset;
                 }
             }
         }
@@ -558,9 +558,6 @@ ISA::copyRegsFrom(ThreadContext *src)
     for (int i = 0; i < NUM_CCREGS; i++)
         tc->setCCReg(i, src->readCCReg(i));
 
-    for (int i = 0; i < NUM_MISCREGS; i++)
-        tc->setMiscRegNoEffect(i, src->readMiscRegNoEffect(i));
-
     for (int i = 0; i < NumVecRegs; i++)
         tc->setVecRegFlat(i, src->readVecRegFlat(i));
 
@@ -570,6 +567,15 @@ ISA::copyRegsFrom(ThreadContext *src)
         }
     }
 
+    copyMiscRegsFrom(src);
+}
+
+void
+ISA::copyMiscRegsFrom(ThreadContext *src)
+{
+    for (int i = 0; i < NUM_MISCREGS; i++)
+        tc->setMiscRegNoEffect(i, src->readMiscRegNoEffect(i));
+
     // setMiscReg "with effect" will set the misc register mapping correctly.
     // e.g. updateRegMap(val)
     tc->setMiscReg(MISCREG_CPSR, src->readMiscRegNoEffect(MISCREG_CPSR));
@@ -2635,7 +2641,7 @@ ISA::addressTranslation64(MMU::ArmTranslationType tran_type,
     // with unexpected atomic snoop requests.
     warn_once("Doing AT (address translation) in functional mode! Fix Me!\n");
 
-    auto req = std::make_shared<Request>(
+    auto req = makeRequest(
         val, 0, flags,  Request::funcRequestorId,
         tc->pcState().instAddr(), tc->contextId());
 
@@ -2686,7 +2692,7 @@ ISA::addressTranslation(MMU::ArmTranslationType tran_type,
     // with unexpected atomic snoop requests.
     warn_once("Doing AT (address translation) in functional mode! Fix Me!\n");
 
-    auto req = std::make_shared<Request>(
+    auto req = makeRequest(
         val, 0, flags,  Request::funcRequestorId,
         tc->pcState().instAddr(), tc->contextId());
 
@@ -1029,6 +1029,7 @@ namespace ArmISA
         }
 
         void copyRegsFrom(ThreadContext *src) override;
+        void copyMiscRegsFrom(ThreadContext *src) override;
 
         void handleLockedRead(const RequestPtr &req) override;
         void handleLockedRead(ExecContext *xc, const RequestPtr &req) override;
@@ -75,6 +75,14 @@ class BaseISA : public SimObject
     virtual bool inUserMode() const = 0;
     virtual void copyRegsFrom(ThreadContext *src) = 0;
 
+    /**
+     * Copy the state that isn't kept in the register files of the thread,
+     * i.e., the misc registers and the PC. This is used after the register
+     * files have been copied in bulk. ISAs that don't override it copy all
+     * of their registers.
+     */
+    virtual void copyMiscRegsFrom(ThreadContext *src) { copyRegsFrom(src); }
+
     const RegClasses &regClasses() const { return _regClasses; }
 
     // Locked memory handling functions.
@@ -41,11 +41,14 @@
 #ifndef __ARCH_GENERIC_TYPES_HH__
 #define __ARCH_GENERIC_TYPES_HH__
 
+#include <cstddef>
 #include <iostream>
 #include <memory>
+#include <new>
 #include <type_traits>
 
 #include "base/compiler.hh"
+#include "base/pool_allocator.hh"
 #include "base/trace.hh"
 #include "base/types.hh"
 #include "sim/serialize.hh"
@@ -64,9 +67,44 @@ class PCStateBase : public Serializable
     PCStateBase &operator=(const PCStateBase &other) = default;
     PCStateBase() {}
 
+    /** Largest PC state served from a FreeListPool by operator new */
+    static const std::size_t pooledSize = 64;
+
+    /** Helper for the ISA PC states to implement cloneInto. */
+    template <class PCState>
+    static PCStateBase *
+    cloneAt(const PCState &pc, void *mem)
+    {
+        static_assert(sizeof(PCState) <= inlineSize,
+                      "PC state too large for an InlinePCState");
+        return ::new (mem) PCState(pc);
+    }
+
   public:
     virtual ~PCStateBase() = default;
 
+    /**
+     * The CPU models clone PC states for every fetched line, instruction
+     * and prediction, so clones no larger than pooledSize, which covers
+     * the PC states of all the ISAs, are kept on a free list.
+     */
+    static void *
+    operator new(std::size_t size)
+    {
+        if (size > pooledSize)
+            return ::operator new(size);
+        return FreeListPool<pooledSize>::allocate();
+    }
+
+    static void
+    operator delete(void *ptr, std::size_t size)
+    {
+        if (size > pooledSize)
+            ::operator delete(ptr);
+        else
+            FreeListPool<pooledSize>::deallocate(ptr);
+    }
+
     template<class Target>
     Target &
     as()
@@ -82,6 +120,18 @@ class PCStateBase : public Serializable
     }
 
     virtual PCStateBase *clone() const = 0;
+
+    /**
+     * Largest PC state that can be kept in an InlinePCState, which covers
+     * the PC states of all the ISAs.
+     */
+    static const std::size_t inlineSize = pooledSize;
+
+    /**
+     * Copy constructs this PC state in the given storage, which must be
+     * inlineSize bytes and suitably aligned.
+     */
+    virtual PCStateBase *cloneInto(void *mem) const = 0;
     virtual void
     update(const PCStateBase &other)
     {
@@ -243,6 +293,87 @@ set(PCStateBase &dest, const PCStateBase &src)
 
 } // anonymous namespace
 
+/**
+ * A PC state kept in storage of its own rather than in a clone on the heap,
+ * for the PC states that the CPU models copy for every instruction or
+ * prediction. Like set() on a pointer, the first assignment copy constructs
+ * the PC state in place, and later ones update it, which is a plain copy of
+ * its fields.
+ */
+class InlinePCState
+{
+  private:
+    alignas(std::max_align_t) unsigned char storage[PCStateBase::inlineSize];
+    PCStateBase *ptr = nullptr;
+
+  public:
+    InlinePCState() {}
+    explicit InlinePCState(const PCStateBase &other) { *this = other; }
+    InlinePCState(const InlinePCState &other) { *this = other; }
+    ~InlinePCState() { reset(); }
+
+    InlinePCState &
+    operator=(const PCStateBase &other)
+    {
+        if (GEM5_LIKELY(ptr))
+            ptr->update(other);
+        else
+            ptr = other.cloneInto(storage);
+        return *this;
+    }
+
+    InlinePCState &
+    operator=(const InlinePCState &other)
+    {
+        if (other.ptr)
+            *this = *other.ptr;
+        else
+            reset();
+        return *this;
+    }
+
+    /** Destroys the PC state, if any. */
+    void
+    reset()
+    {
+        if (ptr) {
+            ptr->~PCStateBase();
+            ptr = nullptr;
+        }
+    }
+
+    PCStateBase *get() { return ptr; }
+    const PCStateBase *get() const { return ptr; }
+
+    PCStateBase &operator*() { return *ptr; }
+    const PCStateBase &operator*() const { return *ptr; }
+    PCStateBase *operator->() { return ptr; }
+    const PCStateBase *operator->() const { return ptr; }
+
+    explicit operator bool() const { return ptr != nullptr; }
+};
+
+inline void
+set(InlinePCState &dest, const PCStateBase &src)
+{
+    dest = src;
+}
+
+inline void
+set(InlinePCState &dest, const PCStateBase *src)
+{
+    if (src)
+        dest = *src;
+    else
+        dest.reset();
+}
+
+inline void
+set(InlinePCState &dest, const std::unique_ptr<PCStateBase> &src)
+{
+    set(dest, src.get());
+}
+
 namespace GenericISA
 {
 
@@ -352,6 +483,12 @@ class SimplePCState : public PCStateWithNext
         return new SimplePCState<InstWidth>(*this);
     }
 
+    PCStateBase *
+    cloneInto(void *mem) const override
+    {
+        return PCStateBase::cloneAt(*this, mem);
+    }
+
     /**
      * Force this PC to reflect a particular value, resetting all its other
      * fields around it. This is useful for in place (re)initialization.
@@ -401,6 +538,12 @@ class UPCState : public SimplePCState<InstWidth>
         return new UPCState<InstWidth>(*this);
     }
 
+    PCStateBase *
+    cloneInto(void *mem) const override
+    {
+        return PCStateBase::cloneAt(*this, mem);
+    }
+
     void
     set(Addr val)
     {
@@ -461,6 +604,12 @@ class DelaySlotPCState : public SimplePCState<InstWidth>
         return new DelaySlotPCState<InstWidth>(*this);
     }
 
+    PCStateBase *
+    cloneInto(void *mem) const override
+    {
+        return PCStateBase::cloneAt(*this, mem);
+    }
+
     void
     update(const PCStateBase &other) override
     {
@@ -546,6 +695,12 @@ class DelaySlotUPCState : public DelaySlotPCState<InstWidth>
         return new DelaySlotUPCState<InstWidth>(*this);
     }
 
+    PCStateBase *
+    cloneInto(void *mem) const override
+    {
+        return PCStateBase::cloneAt(*this, mem);
+    }
+
     void
     set(Addr val)
     {
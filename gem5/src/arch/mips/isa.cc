@@ -178,6 +178,12 @@ ISA::copyRegsFrom(ThreadContext *src)
     for (int i = 0; i < NumFloatRegs; i++)
         tc->setFloatRegFlat(i, src->readFloatRegFlat(i));
 
+    copyMiscRegsFrom(src);
+}
+
+void
+ISA::copyMiscRegsFrom(ThreadContext *src)
+{
     // Copy misc. registers
     for (int i = 0; i < MISCREG_NUMREGS; i++)
         tc->setMiscRegNoEffect(i, src->readMiscRegNoEffect(i));
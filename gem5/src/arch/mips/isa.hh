@@ -174,6 +174,7 @@ namespace MipsISA
         }
 
         void copyRegsFrom(ThreadContext *src) override;
+        void copyMiscRegsFrom(ThreadContext *src) override;
     };
 } // namespace MipsISA
 } // namespace gem5
@@ -72,6 +72,12 @@ ISA::copyRegsFrom(ThreadContext *src)
     for (int i = 0; i < NumFloatRegs; ++i)
         tc->setFloatReg(i, src->readFloatReg(i));
 
+    copyMiscRegsFrom(src);
+}
+
+void
+ISA::copyMiscRegsFrom(ThreadContext *src)
+{
     //TODO Copy misc. registers
 
     // Lastly copy PC/NPC
@@ -144,6 +144,7 @@ class ISA : public BaseISA
     }
 
     void copyRegsFrom(ThreadContext *src) override;
+    void copyMiscRegsFrom(ThreadContext *src) override;
 
     using Params = PowerISAParams;
 
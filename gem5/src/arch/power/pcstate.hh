@@ -55,6 +55,12 @@ class PCState : public GenericISA::SimplePCState<4>
 
     PCStateBase *clone() const override { return new PCState(*this); }
 
+    PCStateBase *
+    cloneInto(void *mem) const override
+    {
+        return cloneAt(*this, mem);
+    }
+
     void
     update(const PCStateBase &other) override
     {
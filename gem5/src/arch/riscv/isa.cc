@@ -221,6 +221,12 @@ ISA::copyRegsFrom(ThreadContext *src)
     for (int i = 0; i < NumFloatRegs; ++i)
         tc->setFloatReg(i, src->readFloatReg(i));
 
+    copyMiscRegsFrom(src);
+}
+
+void
+ISA::copyMiscRegsFrom(ThreadContext *src)
+{
     // Lastly copy PC/NPC
     tc->pcState(src->pcState());
 }
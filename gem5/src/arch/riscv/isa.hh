@@ -100,6 +100,7 @@ class ISA : public BaseISA
 
     bool inUserMode() const override;
     void copyRegsFrom(ThreadContext *src) override;
+    void copyMiscRegsFrom(ThreadContext *src) override;
 
     void serialize(CheckpointOut &cp) const override;
     void unserialize(CheckpointIn &cp) override;
@@ -61,6 +61,12 @@ class PCState : public GenericISA::UPCState<4>
 
     PCStateBase *clone() const override { return new PCState(*this); }
 
+    PCStateBase *
+    cloneInto(void *mem) const override
+    {
+        return cloneAt(*this, mem);
+    }
+
     void
     update(const PCStateBase &other) override
     {
@@ -52,3 +52,9 @@ class X86MMU(BaseMMU):
     def connectWalkerPorts(self, iport, dport):
         self.itb.walker.port = iport
         self.dtb.walker.port = dport
+
+    def addSharedTLB(self, size, assoc=0):
+        """Add a unified second level TLB behind the ITB and the DTB"""
+        self.stlb = X86TLB(entry_type="unified", size=size, assoc=assoc)
+        self.itb.next_level = self.stlb
+        self.dtb.next_level = self.stlb
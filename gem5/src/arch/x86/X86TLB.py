@@ -48,6 +48,9 @@ class X86PagetableWalker(ClockedObject):
     system = Param.System(Parent.any, "system object")
     num_squash_per_cycle = Param.Unsigned(4,
             "Number of outstanding walks that can be squashed per cycle")
+    num_walkers = Param.Unsigned(1, "Number of walks in flight at once")
+    pwc_entries = Param.Unsigned(0, "Entries of each level (PML4, PDP and "
+            "PD) of the page walk cache, 0 for none")
 
 class X86TLB(BaseTLB):
     type = 'X86TLB'
@@ -55,6 +58,8 @@ class X86TLB(BaseTLB):
     cxx_header = 'arch/x86/tlb.hh'
 
     size = Param.Unsigned(64, "TLB size")
+    assoc = Param.Unsigned(0, "Number of ways of each set, 0 for a fully "
+        "associative TLB")
     system = Param.System(Parent.any, "system object")
     walker = Param.X86PagetableWalker(\
             X86PagetableWalker(), "page table walker")
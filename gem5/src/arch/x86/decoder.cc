@@ -43,14 +43,9 @@ namespace X86ISA
 
 X86ISAInst::MicrocodeRom Decoder::microcodeRom;
 
-Decoder::State
-Decoder::doResetState()
+void
+Decoder::resetEmi()
 {
-    origPC = basePC + offset;
-    DPRINTF(Decoder, "Setting origPC to %#x\n", origPC);
-    instBytes = &decodePages->lookup(origPC);
-    chunkIdx = 0;
-
     emi.rex = 0;
     emi.legacy = 0;
     emi.vex = 0;
@@ -65,11 +60,21 @@ Decoder::doResetState()
 
     emi.modRM = 0;
     emi.sib = 0;
+}
+
+Decoder::State
+Decoder::doResetState()
+{
+    origPC = basePC + offset;
+    DPRINTF(Decoder, "Setting origPC to %#x\n", origPC);
+    instBytes = &decodePages->lookup(origPC);
+    chunkIdx = 0;
 
     if (instBytes->si) {
         return FromCacheState;
     } else {
-        instBytes->chunks.clear();
+        resetEmi();
+        instBytes->numChunks = 0;
         return PrefixState;
     }
 }
@@ -90,7 +95,7 @@ Decoder::process()
     if (state == FromCacheState) {
         state = doFromCacheState();
     } else {
-        instBytes->chunks.push_back(fetchChunk);
+        instBytes->addChunk(fetchChunk);
     }
 
     // While there's still something to do...
@@ -154,14 +159,15 @@ Decoder::doFromCacheState()
         // The chached chunks didn't match what was fetched. Fall back to the
         // predecoder.
         instBytes->chunks[chunkIdx] = fetchChunk;
-        instBytes->chunks.resize(chunkIdx + 1);
+        instBytes->numChunks = chunkIdx + 1;
         instBytes->si = NULL;
+        resetEmi();
         chunkIdx = 0;
         fetchChunk = instBytes->chunks[0];
         offset = origPC % sizeof(MachInst);
         basePC = origPC - offset;
         return PrefixState;
-    } else if (chunkIdx == instBytes->chunks.size() - 1) {
+    } else if (chunkIdx == instBytes->numChunks - 1) {
         // We matched the cache, so use its value.
         instDone = true;
         offset = instBytes->lastOffset;
@@ -711,27 +717,28 @@ Decoder::decode(PCStateBase &next_pc)
 
     instBytes->lastOffset = offset;
 
-    Addr firstBasePC = basePC - (instBytes->chunks.size() - 1) * chunkSize;
+    Addr firstBasePC = basePC - (instBytes->numChunks - 1) * chunkSize;
     Addr firstOffset = origPC - firstBasePC;
     Addr totalSize = instBytes->lastOffset - firstOffset +
-        (instBytes->chunks.size() - 1) * chunkSize;
+        (instBytes->numChunks - 1) * chunkSize;
     int start = firstOffset;
-    instBytes->masks.clear();
+    int idx = 0;
 
     while (totalSize) {
         int end = start + totalSize;
         end = (chunkSize < end) ? chunkSize : end;
         int size = end - start;
-        int idx = instBytes->masks.size();
 
         MachInst maskVal = mask(size * 8) << (start * 8);
         assert(maskVal);
 
-        instBytes->masks.push_back(maskVal);
-        instBytes->chunks[idx] &= instBytes->masks[idx];
+        instBytes->masks[idx] = maskVal;
+        instBytes->chunks[idx] &= maskVal;
+        idx++;
         totalSize -= size;
         start = 0;
     }
+    assert(idx == instBytes->numChunks);
 
     si = decode(emi, origPC);
     return si;
@@ -31,7 +31,6 @@
 
 #include <cassert>
 #include <unordered_map>
-#include <vector>
 
 #include "arch/generic/decoder.hh"
 #include "arch/x86/microcode_rom.hh"
@@ -77,15 +76,34 @@ class Decoder : public InstDecoder
   protected:
     using MachInst = uint64_t;
 
+    /**
+     * The raw bytes of an instruction which has been decoded before and the
+     * StaticInst they decoded to. An instruction is at most 15 bytes long,
+     * so it is spread over at most three fetch chunks, which are kept in
+     * place rather than on the heap to check a hit without chasing
+     * pointers.
+     */
     struct InstBytes
     {
+        static const int MaxChunks = 3;
+
         StaticInstPtr si;
-        std::vector<MachInst> chunks;
-        std::vector<MachInst> masks;
+        MachInst chunks[MaxChunks];
+        MachInst masks[MaxChunks];
+        int numChunks;
         int lastOffset;
 
-        InstBytes() : lastOffset(0)
+        InstBytes() : numChunks(0), lastOffset(0)
         {}
+
+        void
+        addChunk(MachInst chunk)
+        {
+            panic_if(numChunks == MaxChunks,
+                    "x86 instruction spread over more than %d chunks.",
+                    MaxChunks);
+            chunks[numChunks++] = chunk;
+        }
     };
 
     static InstBytes dummy;
@@ -147,9 +165,9 @@ class Decoder : public InstDecoder
         assert(offset <= sizeof(MachInst));
         if (offset == sizeof(MachInst)) {
             DPRINTF(Decoder, "At the end of a chunk, idx = %d, chunks = %d.\n",
-                    chunkIdx, instBytes->chunks.size());
+                    chunkIdx, instBytes->numChunks);
             chunkIdx++;
-            if (chunkIdx == instBytes->chunks.size()) {
+            if (chunkIdx == instBytes->numChunks) {
                 outOfBytes = true;
             } else {
                 offset = 0;
@@ -206,6 +224,10 @@ class Decoder : public InstDecoder
 
     State state = ResetState;
 
+    // Clear the ExtMachInst before running the state machine over the
+    // bytes of an instruction. Decode cache hits skip it.
+    void resetEmi();
+
     // Functions to handle each of the states
     State doResetState();
     State doFromCacheState();
@@ -185,6 +185,12 @@ ISA::copyRegsFrom(ThreadContext *src)
     //copy condition-code regs
     for (int i = 0; i < NUM_CCREGS; ++i)
          tc->setCCRegFlat(i, src->readCCRegFlat(i));
+    copyMiscRegsFrom(src);
+}
+
+void
+ISA::copyMiscRegsFrom(ThreadContext *src)
+{
     copyMiscRegs(src, tc);
     tc->pcState(src->pcState());
 }
@@ -120,6 +120,7 @@ class ISA : public BaseISA
     }
 
     void copyRegsFrom(ThreadContext *src) override;
+    void copyMiscRegsFrom(ThreadContext *src) override;
 
     void serialize(CheckpointOut &cp) const override;
     void unserialize(CheckpointIn &cp) override;
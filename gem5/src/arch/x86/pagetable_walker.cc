@@ -55,7 +55,6 @@
 #include "arch/x86/pagetable.hh"
 #include "arch/x86/tlb.hh"
 #include "base/bitfield.hh"
-#include "base/trie.hh"
 #include "cpu/base.hh"
 #include "cpu/thread_context.hh"
 #include "debug/PageTableWalker.hh"
@@ -67,31 +66,193 @@ namespace gem5
 
 namespace X86ISA {
 
+Walker::Walker(const Params &params) :
+    ClockedObject(params), port(name() + ".port", this),
+    activeWalks(0), numWalkers(params.num_walkers),
+    funcState(this, NULL, NULL, true), tlb(NULL), sys(params.system),
+    requestorId(sys->getRequestorId(this)),
+    numSquashable(params.num_squash_per_cycle), pwcSeq(0), stats(this),
+    startWalkWrapperEvent([this]{ startWalkWrapper(); }, name())
+{
+    fatal_if(!numWalkers, "%s: needs at least one walker.", name());
+    for (auto &level: pwc)
+        level.resize(params.pwc_entries);
+}
+
+const Walker::PwcEntry *
+Walker::pwcLookup(Addr vaddr, int &level)
+{
+    for (level = PwcLevels - 1; level >= 0; level--) {
+        Addr tag = vaddr >> pwcShift[level];
+        for (auto &entry: pwc[level]) {
+            if (entry.valid && entry.tag == tag) {
+                entry.lruSeq = ++pwcSeq;
+                return &entry;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void
+Walker::pwcInsert(int level, const PwcEntry &entry)
+{
+    auto &entries = pwc[level];
+    if (entries.empty())
+        return;
+
+    // Refresh the entry for the same tag, or replace a free or the least
+    // recently used one.
+    PwcEntry *victim = &entries[0];
+    for (auto &e: entries) {
+        if (e.valid && e.tag == entry.tag) {
+            victim = &e;
+            break;
+        }
+        if (!e.valid || (victim->valid && e.lruSeq < victim->lruSeq))
+            victim = &e;
+    }
+    *victim = entry;
+    victim->valid = true;
+    victim->lruSeq = ++pwcSeq;
+}
+
+void
+Walker::flushPwc()
+{
+    for (auto &level: pwc) {
+        for (auto &entry: level)
+            entry.valid = false;
+    }
+}
+
+Walker::WalkerStats::WalkerStats(statistics::Group *parent)
+  : statistics::Group(parent),
+    ADD_STAT(walks, statistics::units::Count::get(),
+             "Page table walks, not counting the functional ones"),
+    ADD_STAT(walkLatency, statistics::units::Tick::get(),
+             "Page table walk latency"),
+    ADD_STAT(pwcHits, statistics::units::Count::get(),
+             "Walks starting below a level thanks to the page walk cache"),
+    ADD_STAT(pwcHitRate, statistics::units::Ratio::get(),
+             "Fraction of the walks that hit in the page walk cache",
+             statistics::sum(pwcHits) / walks),
+    ADD_STAT(reads, statistics::units::Count::get(),
+             "Page table entries read at each level"),
+    ADD_STAT(writes, statistics::units::Count::get(),
+             "Page table entries written back (accessed bit) at each level"),
+    ADD_STAT(coalescedWalks, statistics::units::Count::get(),
+             "TLB misses that waited for a walk of the same page in flight")
+{
+    walkLatency
+        .init(16)
+        .flags(statistics::pdf | statistics::nozero | statistics::nonan);
+
+    pwcHits.init(PwcLevels);
+    pwcHits.subname(0, "pml4");
+    pwcHits.subname(1, "pdp");
+    pwcHits.subname(2, "pd");
+
+    pwcHitRate.flags(statistics::nozero | statistics::nonan);
+
+    for (auto *v: {&reads, &writes}) {
+        v->init(4);
+        v->subname(0, "pml4");
+        v->subname(1, "pdp");
+        v->subname(2, "pd");
+        v->subname(3, "pt");
+    }
+}
+
 Fault
 Walker::start(ThreadContext * _tc, BaseMMU::Translation *_translation,
               const RequestPtr &_req, BaseMMU::Mode _mode)
 {
-    // TODO: in timing mode, instead of blocking when there are other
-    // outstanding requests, see if this request can be coalesced with
-    // another one (i.e. either coalesce or start walk)
-    WalkerState * newState = new WalkerState(this, _translation, _req);
+    if (sys->isTimingMode() && coalesce(_tc, _translation, _req, _mode))
+        return NoFault;
+
+    WalkerState * newState = allocState(_translation, _req);
     newState->initState(_tc, _mode, sys->isTimingMode());
-    if (currStates.size()) {
+    // Wait behind the walks that are already waiting for a walker.
+    if (activeWalks == numWalkers || currStates.size() > activeWalks) {
         assert(newState->isTiming());
         DPRINTF(PageTableWalker, "Walks in progress: %d\n", currStates.size());
         currStates.push_back(newState);
         return NoFault;
     } else {
         currStates.push_back(newState);
+        activeWalks++;
         Fault fault = newState->startWalk();
         if (!newState->isTiming()) {
-            currStates.pop_front();
-            delete newState;
+            currStates.pop_back();
+            activeWalks--;
+            freeState(newState);
         }
         return fault;
     }
 }
 
+Walker::WalkerState *
+Walker::allocState(BaseMMU::Translation *translation, const RequestPtr &req)
+{
+    if (freeStates.empty()) {
+        statePool.emplace_back(new WalkerState(this, translation, req));
+        return statePool.back().get();
+    }
+    WalkerState *state = freeStates.back();
+    freeStates.pop_back();
+    state->reset(translation, req);
+    return state;
+}
+
+void
+Walker::freeState(WalkerState *state)
+{
+    freeStates.push_back(state);
+}
+
+bool
+Walker::coalesce(ThreadContext *tc, BaseMMU::Translation *translation,
+                 const RequestPtr &req, BaseMMU::Mode mode)
+{
+    // The page size is only known at the end of a walk, so only the walks
+    // of the same 4KB page are shared. The waiting requests translate
+    // again at the end, so the mode doesn't have to match.
+    const Addr page = req->getVaddr() >> 12;
+    for (auto *state: currStates) {
+        if (state->wasStarted() && !state->squashed && state->tc == tc &&
+                state->req->getVaddr() >> 12 == page) {
+            DPRINTF(PageTableWalker, "Coalescing the walk of %#x\n",
+                    req->getVaddr());
+            state->coalesced.push_back({req, translation, mode});
+            stats.coalescedWalks++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+Walker::finishCoalesced(ThreadContext *tc,
+        std::vector<WalkerState::Coalesced> &coalesced)
+{
+    for (auto &waiting: coalesced) {
+        if (waiting.translation->squashed()) {
+            waiting.translation->finish(
+                std::make_shared<UnimpFault>("Squashed Inst"),
+                waiting.req, tc, waiting.mode);
+            continue;
+        }
+        // This hits in the TLB, unless the walk faulted, in which case
+        // it starts a walk of its own.
+        bool delayed;
+        Fault fault = tlb->translate(waiting.req, tc, waiting.translation,
+                                     waiting.mode, delayed, true);
+        if (!delayed)
+            waiting.translation->finish(fault, waiting.req, tc, waiting.mode);
+    }
+}
+
 Fault
 Walker::startFunctional(ThreadContext * _tc, Addr &addr, unsigned &logBytes,
               BaseMMU::Mode _mode)
@@ -120,11 +281,16 @@ Walker::recvTimingResp(PacketPtr pkt)
             WalkerState * walkerState = *(iter);
             if (walkerState == senderWalk) {
                 iter = currStates.erase(iter);
+                activeWalks--;
                 break;
             }
         }
-        delete senderWalk;
-        // Since we block requests when another is outstanding, we
+        std::vector<WalkerState::Coalesced> coalesced;
+        coalesced.swap(senderWalk->coalesced);
+        ThreadContext *tc = senderWalk->tc;
+        freeState(senderWalk);
+        finishCoalesced(tc, coalesced);
+        // Since we block requests when all the walkers are busy, we
         // need to check if there is a waiting request to be serviced
         if (currStates.size() && !startWalkWrapperEvent.scheduled())
             // delay sending any new requests until we are finished
@@ -177,6 +343,24 @@ Walker::getPort(const std::string &if_name, PortID idx)
         return ClockedObject::getPort(if_name, idx);
 }
 
+void
+Walker::WalkerState::reset(BaseMMU::Translation *_translation,
+                           const RequestPtr &_req)
+{
+    assert(coalesced.empty() && writes.empty());
+    req = _req;
+    translation = _translation;
+    state = Ready;
+    nextState = Ready;
+    inflight = 0;
+    read = NULL;
+    timing = false;
+    retrying = false;
+    started = false;
+    squashed = false;
+    nxSeen = false;
+}
+
 void
 Walker::WalkerState::initState(ThreadContext * _tc,
         BaseMMU::Mode _mode, bool _isTiming)
@@ -191,38 +375,39 @@ Walker::WalkerState::initState(ThreadContext * _tc,
 void
 Walker::startWalkWrapper()
 {
+    // Start the waiting walks in order while there are free walkers,
+    // dropping the first squashed ones on the way.
     unsigned num_squashed = 0;
-    WalkerState *currState = currStates.front();
-    while ((num_squashed < numSquashable) && currState &&
-        currState->translation->squashed()) {
-        currStates.pop_front();
-        num_squashed++;
-
-        DPRINTF(PageTableWalker, "Squashing table walk for address %#x\n",
-            currState->req->getVaddr());
-
-        // finish the translation which will delete the translation object
-        currState->translation->finish(
-            std::make_shared<UnimpFault>("Squashed Inst"),
-            currState->req, currState->tc, currState->mode);
-
-        // delete the current request if there are no inflight packets.
-        // if there is something in flight, delete when the packets are
-        // received and inflight is zero.
-        if (currState->numInflight() == 0) {
-            delete currState;
-        } else {
-            currState->squash();
+    auto it = currStates.begin();
+    while (it != currStates.end() && activeWalks < numWalkers) {
+        WalkerState *currState = *it;
+        if (currState->wasStarted()) {
+            ++it;
+            continue;
         }
-
-        // check the next translation request, if it exists
-        if (currStates.size())
-            currState = currStates.front();
-        else
-            currState = NULL;
-    }
-    if (currState && !currState->wasStarted())
+        if (num_squashed < numSquashable &&
+                currState->translation->squashed()) {
+            it = currStates.erase(it);
+            num_squashed++;
+
+            DPRINTF(PageTableWalker, "Squashing table walk for address "
+                    "%#x\n", currState->req->getVaddr());
+
+            // finish the translation which will delete the translation
+            // object
+            currState->translation->finish(
+                std::make_shared<UnimpFault>("Squashed Inst"),
+                currState->req, currState->tc, currState->mode);
+
+            // A walk that didn't start has nothing in flight.
+            assert(currState->numInflight() == 0);
+            freeState(currState);
+            continue;
+        }
+        activeWalks++;
         currState->startWalk();
+        ++it;
+    }
 }
 
 Fault
@@ -231,6 +416,8 @@ Walker::WalkerState::startWalk()
     Fault fault = NoFault;
     assert(!started);
     started = true;
+    walker->stats.walks++;
+    startTick = curTick();
     setupWalk(req->getVaddr());
     if (timing) {
         nextState = state;
@@ -238,8 +425,11 @@ Walker::WalkerState::startWalk()
         timingFault = NoFault;
         sendPackets();
     } else {
+        // The accessed bit writes are posted, only the reads are on the
+        // critical path.
+        Tick latency = 0;
         do {
-            walker->port.sendAtomic(read);
+            latency += walker->port.sendAtomic(read);
             PacketPtr write = NULL;
             fault = stepWalk(write);
             assert(fault == NoFault || read == NULL);
@@ -250,6 +440,7 @@ Walker::WalkerState::startWalk()
         } while (read);
         state = Ready;
         nextState = Waiting;
+        walker->stats.walkLatency.sample(latency);
     }
     return fault;
 }
@@ -296,6 +487,28 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
     bool doTLBInsert = false;
     bool doEndWalk = false;
     bool badNX = pte.nx && mode == BaseMMU::Execute && enableNX;
+    // Level of the entry from the PML4 down, for the stats
+    int level;
+    switch (state) {
+      case LongPML4:
+        level = 0;
+        break;
+      case LongPDP:
+      case PAEPDP:
+        level = 1;
+        break;
+      case LongPD:
+      case PAEPD:
+      case PSEPD:
+      case PD:
+        level = 2;
+        break;
+      default:
+        level = 3;
+        break;
+    }
+    if (!functional)
+        walker->stats.reads[level]++;
     switch(state) {
       case LongPML4:
         DPRINTF(PageTableWalker,
@@ -311,6 +524,8 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
             break;
         }
         entry.noExec = pte.nx;
+        nxSeen = pte.nx;
+        pwcFill(0, (uint64_t)pte & (mask(40) << 12), uncacheable);
         nextState = LongPDP;
         break;
       case LongPDP:
@@ -326,6 +541,8 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
             fault = pageFault(pte.p);
             break;
         }
+        nxSeen = nxSeen || pte.nx;
+        pwcFill(1, (uint64_t)pte & (mask(40) << 12), uncacheable);
         nextState = LongPD;
         break;
       case LongPD:
@@ -345,6 +562,8 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
             entry.logBytes = 12;
             nextRead =
                 ((uint64_t)pte & (mask(40) << 12)) + vaddr.longl1 * dataSize;
+            nxSeen = nxSeen || pte.nx;
+            pwcFill(2, (uint64_t)pte & (mask(40) << 12), uncacheable);
             nextState = LongPTE;
             break;
         } else {
@@ -521,13 +740,15 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
         //If we didn't return, we're setting up another read.
         Request::Flags flags = oldRead->req->getFlags();
         flags.set(Request::UNCACHEABLE, uncacheable);
-        RequestPtr request = std::make_shared<Request>(
+        RequestPtr request = makeRequest(
             nextRead, oldRead->getSize(), flags, walker->requestorId);
         read = new Packet(request, MemCmd::ReadReq);
         read->allocate();
         // If we need to write, adjust the read packet to write the modified
         // value back to memory.
         if (doWrite) {
+            if (!functional)
+                walker->stats.writes[level]++;
             write = oldRead;
             write->setLE<uint64_t>(pte);
             write->cmd = MemCmd::WriteReq;
@@ -539,6 +760,23 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
     return fault;
 }
 
+void
+Walker::WalkerState::pwcFill(int level, Addr table, bool uncacheable)
+{
+    if (functional)
+        return;
+
+    PwcEntry pwc_entry;
+    pwc_entry.tag = entry.vaddr >> pwcShift[level];
+    pwc_entry.table = table;
+    pwc_entry.uncacheable = uncacheable;
+    pwc_entry.writable = entry.writable;
+    pwc_entry.user = entry.user;
+    pwc_entry.noExec = entry.noExec;
+    pwc_entry.nx = nxSeen;
+    walker->pwcInsert(level, pwc_entry);
+}
+
 void
 Walker::WalkerState::endWalk()
 {
@@ -585,12 +823,37 @@ Walker::WalkerState::setupWalk(Addr vaddr)
 
     nextState = Ready;
     entry.vaddr = vaddr;
+    nxSeen = false;
 
     Request::Flags flags = Request::PHYSICAL;
     if (cr3.pcd)
         flags.set(Request::UNCACHEABLE);
 
-    RequestPtr request = std::make_shared<Request>(
+    // Start below the levels the page walk cache has. The walks that
+    // would fault on an nx bit above go all the way, to raise it.
+    int level;
+    const PwcEntry *pwc_entry = efer.lma && !functional ?
+        walker->pwcLookup(vaddr, level) : nullptr;
+    if (pwc_entry && !(pwc_entry->nx && mode == BaseMMU::Execute &&
+                enableNX)) {
+        static const State states[PwcLevels] = {LongPDP, LongPD, LongPTE};
+        const Addr offsets[PwcLevels] = {
+            addr.longl3, addr.longl2, addr.longl1};
+        DPRINTF(PageTableWalker, "Page walk cache hit at level %d.\n",
+                level);
+        walker->stats.pwcHits[level]++;
+        state = states[level];
+        topAddr = pwc_entry->table + offsets[level] * dataSize;
+        entry.writable = pwc_entry->writable;
+        entry.user = pwc_entry->user;
+        entry.noExec = pwc_entry->noExec;
+        nxSeen = pwc_entry->nx;
+        flags.set(Request::UNCACHEABLE, pwc_entry->uncacheable);
+        if (level == PwcLevels - 1)
+            entry.logBytes = 12;
+    }
+
+    RequestPtr request = makeRequest(
         topAddr, dataSize, flags, walker->requestorId);
 
     read = new Packet(request, MemCmd::ReadReq);
@@ -633,6 +896,7 @@ Walker::WalkerState::recvPacket(PacketPtr pkt)
     if (inflight == 0 && read == NULL && writes.size() == 0) {
         state = Ready;
         nextState = Waiting;
+        walker->stats.walkLatency.sample(curTick() - startTick);
         if (timingFault == NoFault) {
             /*
              * Finish the translation. Now that we know the right entry is
@@ -38,6 +38,9 @@
 #ifndef __ARCH_X86_PAGE_TABLE_WALKER_HH__
 #define __ARCH_X86_PAGE_TABLE_WALKER_HH__
 
+#include <array>
+#include <list>
+#include <memory>
 #include <vector>
 
 #include "arch/generic/mmu.hh"
@@ -48,6 +51,7 @@
 #include "params/X86PagetableWalker.hh"
 #include "sim/clocked_object.hh"
 #include "sim/faults.hh"
+#include "sim/stats.hh"
 #include "sim/system.hh"
 
 namespace gem5
@@ -115,6 +119,19 @@ namespace X86ISA
             bool retrying;
             bool started;
             bool squashed;
+            // Whether an upper level so far had the nx bit set
+            bool nxSeen;
+            // When the walk started
+            Tick startTick;
+
+            // Translations of the same page that wait for this walk
+            struct Coalesced
+            {
+                RequestPtr req;
+                BaseMMU::Translation *translation;
+                BaseMMU::Mode mode;
+            };
+            std::vector<Coalesced> coalesced;
           public:
             WalkerState(Walker * _walker, BaseMMU::Translation *_translation,
                         const RequestPtr &_req, bool _isFunctional = false) :
@@ -122,9 +139,13 @@ namespace X86ISA
                 nextState(Ready), inflight(0),
                 translation(_translation),
                 functional(_isFunctional), timing(false),
-                retrying(false), started(false), squashed(false)
+                retrying(false), started(false), squashed(false),
+                nxSeen(false), startTick(0)
             {
             }
+            /** Get a pooled state ready for a new walk */
+            void reset(BaseMMU::Translation *_translation,
+                       const RequestPtr &_req);
             void initState(ThreadContext * _tc, BaseMMU::Mode _mode,
                            bool _isTiming = false);
             Fault startWalk();
@@ -144,12 +165,36 @@ namespace X86ISA
             void sendPackets();
             void endWalk();
             Fault pageFault(bool present);
+            /** Fill the page walk cache with this table at a level */
+            void pwcFill(int level, Addr table, bool uncacheable);
         };
 
         friend class WalkerState;
         // State for timing and atomic accesses (need multiple per walker in
-        // the case of multiple outstanding requests in timing mode)
+        // the case of multiple outstanding requests in timing mode), the
+        // walks in flight and the ones waiting for a free walker
         std::list<WalkerState *> currStates;
+        // Walks in flight, out of at most numWalkers
+        unsigned activeWalks;
+        const unsigned numWalkers;
+        // Every state ever allocated, and the ones free for a new walk
+        std::vector<std::unique_ptr<WalkerState>> statePool;
+        std::vector<WalkerState *> freeStates;
+
+        WalkerState *allocState(BaseMMU::Translation *translation,
+                                const RequestPtr &req);
+        void freeState(WalkerState *state);
+
+        /**
+         * Add a timing translation to a walk in flight of the same page,
+         * if there is one.
+         */
+        bool coalesce(ThreadContext *tc, BaseMMU::Translation *translation,
+                      const RequestPtr &req, BaseMMU::Mode mode);
+
+        /** Translate again the requests that waited for a walk */
+        void finishCoalesced(ThreadContext *tc,
+                std::vector<WalkerState::Coalesced> &coalesced);
         // State for functional accesses (only need one of these per walker)
         WalkerState funcState;
 
@@ -178,6 +223,51 @@ namespace X86ISA
         // The number of outstanding walks that can be squashed per cycle.
         unsigned numSquashable;
 
+        /**
+         * Page walk cache of the long mode walks. Each level keeps, by the
+         * virtual address bits it translates, the physical address of the
+         * table below and the permissions of the levels above, so that a
+         * walk can start at the deepest level it finds.
+         */
+        struct PwcEntry
+        {
+            bool valid = false;
+            // The virtual address bits above the level
+            Addr tag = 0;
+            // The table the entry points to
+            Addr table = 0;
+            bool uncacheable = false;
+            bool writable = false;
+            bool user = false;
+            bool noExec = false;
+            bool nx = false;
+            uint64_t lruSeq = 0;
+        };
+
+        /** Levels of the PML4, PDP and PD entries */
+        static constexpr int PwcLevels = 3;
+        static constexpr int pwcShift[PwcLevels] = {39, 30, 21};
+
+        std::array<std::vector<PwcEntry>, PwcLevels> pwc;
+        uint64_t pwcSeq;
+
+        /** The deepest entry for vaddr, or nullptr, and its level */
+        const PwcEntry *pwcLookup(Addr vaddr, int &level);
+        void pwcInsert(int level, const PwcEntry &entry);
+
+        struct WalkerStats : public statistics::Group
+        {
+            WalkerStats(statistics::Group *parent);
+
+            statistics::Scalar walks;
+            statistics::Histogram walkLatency;
+            statistics::Vector pwcHits;
+            statistics::Formula pwcHitRate;
+            statistics::Vector reads;
+            statistics::Vector writes;
+            statistics::Scalar coalescedWalks;
+        } stats;
+
         // Wrapper for checking for squashes before starting a translation.
         void startWalkWrapper();
 
@@ -198,16 +288,12 @@ namespace X86ISA
             tlb = _tlb;
         }
 
+        /** Drop the page walk cache, along with the TLB entries */
+        void flushPwc();
+
         using Params = X86PagetableWalkerParams;
 
-        Walker(const Params &params) :
-            ClockedObject(params), port(name() + ".port", this),
-            funcState(this, NULL, NULL, true), tlb(NULL), sys(params.system),
-            requestorId(sys->getRequestorId(this)),
-            numSquashable(params.num_squash_per_cycle),
-            startWalkWrapperEvent([this]{ startWalkWrapper(); }, name())
-        {
-        }
+        Walker(const Params &params);
     };
 
 } // namespace X86ISA
@@ -47,6 +47,8 @@
 #include "arch/x86/regs/misc.hh"
 #include "arch/x86/regs/msr.hh"
 #include "arch/x86/x86_traits.hh"
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
 #include "base/trace.hh"
 #include "cpu/thread_context.hh"
 #include "debug/TLB.hh"
@@ -64,82 +66,186 @@ namespace X86ISA {
 
 TLB::TLB(const Params &p)
     : BaseTLB(p), configAddress(0), size(p.size),
-      tlb(size), lruSeq(0), m5opRange(p.system->m5opRange()), stats(this)
+      assoc(p.assoc ? p.assoc : p.size), numSets(0), tlb(size),
+      valid(size, false), numValid(0), pageSizes(0), pageSizeCount{},
+      lastEntry{}, lruSeq(0), m5opRange(p.system->m5opRange()), stats(this)
 {
     if (!size)
         fatal("TLBs must have a non-zero size.\n");
+    fatal_if(assoc > size || size % assoc,
+             "%s: the TLB size (%d) must be a multiple of its "
+             "associativity (%d).", name(), size, assoc);
+    numSets = size / assoc;
 
-    for (int x = 0; x < size; x++) {
-        tlb[x].trieHandle = NULL;
-        freeList.push_back(&tlb[x]);
-    }
+    // Keep the hash table at most half full.
+    int index_bits = ceilLog2(size) + 1;
+    index.assign(1ULL << index_bits, -1);
+    indexShift = 64 - index_bits;
 
     walker = p.walker;
     walker->setTLB(this);
+
+    next = dynamic_cast<TLB *>(nextLevel());
+    fatal_if(nextLevel() && !next,
+             "%s: the next level of an X86TLB must be an X86TLB.", name());
 }
 
-void
-TLB::evictLRU()
+int
+TLB::findSlot(Addr vaddr, unsigned log_bytes) const
 {
-    // Find the entry with the lowest (and hence least recently updated)
-    // sequence number.
+    const size_t mask = index.size() - 1;
+    for (size_t i = hashSlot(vaddr, log_bytes); index[i] != -1;
+            i = (i + 1) & mask) {
+        const TlbEntry &entry = tlb[index[i]];
+        if (entry.vaddr == vaddr && entry.logBytes == log_bytes)
+            return i;
+    }
+    return -1;
+}
 
-    unsigned lru = 0;
-    for (unsigned i = 1; i < size; i++) {
-        if (tlb[i].lruSeq < tlb[lru].lruSeq)
-            lru = i;
+TlbEntry *
+TLB::probe(Addr va) const
+{
+    // The smallest page first, like the longest match of a trie.
+    for (uint64_t sizes = pageSizes; sizes; sizes &= sizes - 1) {
+        unsigned log_bytes = findLsbSet(sizes);
+        int slot = findSlot(va & ~mask(log_bytes), log_bytes);
+        if (slot != -1)
+            return const_cast<TlbEntry *>(&tlb[index[slot]]);
     }
+    return nullptr;
+}
 
-    assert(tlb[lru].trieHandle);
-    trie.remove(tlb[lru].trieHandle);
-    tlb[lru].trieHandle = NULL;
-    freeList.push_back(&tlb[lru]);
+TlbEntry *
+TLB::place(const TlbEntry &entry)
+{
+    const uint32_t set = (entry.vaddr >> entry.logBytes) % numSets;
+    const uint32_t first = set * assoc;
+
+    // A free way, or else the one with the lowest (and hence least
+    // recently updated) sequence number.
+    uint32_t way = first;
+    for (uint32_t i = first; i < first + assoc; i++) {
+        if (!valid[i]) {
+            way = i;
+            break;
+        }
+        if (tlb[i].lruSeq < tlb[way].lruSeq)
+            way = i;
+    }
+    if (valid[way])
+        remove(way);
+
+    tlb[way] = entry;
+    valid[way] = true;
+    numValid++;
+    if (!pageSizeCount[entry.logBytes]++)
+        pageSizes |= 1ULL << entry.logBytes;
+
+    const size_t mask = index.size() - 1;
+    size_t i = hashSlot(entry.vaddr, entry.logBytes);
+    while (index[i] != -1)
+        i = (i + 1) & mask;
+    index[i] = way;
+
+    // A smaller page may now shadow the last translations.
+    lastEntry.fill(nullptr);
+    return &tlb[way];
+}
+
+void
+TLB::remove(uint32_t i)
+{
+    assert(valid[i]);
+    TlbEntry &entry = tlb[i];
+    int slot = findSlot(entry.vaddr, entry.logBytes);
+    assert(slot != -1);
+
+    // Backward shift deletion: move up the entries after the removed one
+    // that wouldn't be found anymore past the hole.
+    const size_t mask = index.size() - 1;
+    size_t hole = slot;
+    for (size_t j = (hole + 1) & mask; index[j] != -1; j = (j + 1) & mask) {
+        const TlbEntry &moved = tlb[index[j]];
+        size_t home = hashSlot(moved.vaddr, moved.logBytes);
+        if (((j - home) & mask) >= ((j - hole) & mask)) {
+            index[hole] = index[j];
+            hole = j;
+        }
+    }
+    index[hole] = -1;
+
+    if (!--pageSizeCount[entry.logBytes])
+        pageSizes &= ~(1ULL << entry.logBytes);
+    valid[i] = false;
+    numValid--;
+    lastEntry.fill(nullptr);
 }
 
 TlbEntry *
 TLB::insert(Addr vpn, const TlbEntry &entry)
 {
     // If somebody beat us to it, just use that existing entry.
-    TlbEntry *newEntry = trie.lookup(vpn);
+    TlbEntry *newEntry = probe(vpn);
     if (newEntry) {
         assert(newEntry->vaddr == vpn);
         return newEntry;
     }
 
-    if (freeList.empty())
-        evictLRU();
+    // The levels below keep what the walks bring in too.
+    if (next)
+        next->insert(vpn, entry);
 
-    newEntry = freeList.front();
-    freeList.pop_front();
-
-    *newEntry = entry;
-    newEntry->lruSeq = nextSeq();
-    newEntry->vaddr = vpn;
-    newEntry->trieHandle =
-    trie.insert(vpn, TlbEntryTrie::MaxBits - entry.logBytes, newEntry);
-    return newEntry;
+    TlbEntry aligned = entry;
+    aligned.lruSeq = nextSeq();
+    aligned.vaddr = vpn;
+    return place(aligned);
 }
 
 TlbEntry *
-TLB::lookup(Addr va, bool update_lru)
+TLB::lookup(Addr va, bool update_lru, BaseMMU::Mode mode)
 {
-    TlbEntry *entry = trie.lookup(va);
+    TlbEntry *entry = lastEntry[mode];
+    if (!entry || va - entry->vaddr >= (Addr(1) << entry->logBytes)) {
+        entry = probe(va);
+        // Only a page of the smallest size can't hide a smaller one at
+        // the next address.
+        if (entry && entry->logBytes == findLsbSet(pageSizes))
+            lastEntry[mode] = entry;
+    }
     if (entry && update_lru)
         entry->lruSeq = nextSeq();
     return entry;
 }
 
+TlbEntry *
+TLB::lookupNextLevel(Addr vaddr, BaseMMU::Mode mode)
+{
+    if (!next)
+        return nullptr;
+
+    TlbEntry *entry = next->lookup(vaddr, true, mode);
+    if (mode == BaseMMU::Read) {
+        next->stats.rdAccesses++;
+        if (!entry)
+            next->stats.rdMisses++;
+    } else {
+        next->stats.wrAccesses++;
+        if (!entry)
+            next->stats.wrMisses++;
+    }
+    return entry ? insert(entry->vaddr, *entry) : nullptr;
+}
+
 void
 TLB::flushAll()
 {
     DPRINTF(TLB, "Invalidating all entries.\n");
     for (unsigned i = 0; i < size; i++) {
-        if (tlb[i].trieHandle) {
-            trie.remove(tlb[i].trieHandle);
-            tlb[i].trieHandle = NULL;
-            freeList.push_back(&tlb[i]);
-        }
+        if (valid[i])
+            remove(i);
     }
+    walker->flushPwc();
 }
 
 void
@@ -153,23 +259,24 @@ TLB::flushNonGlobal()
 {
     DPRINTF(TLB, "Invalidating all non global entries.\n");
     for (unsigned i = 0; i < size; i++) {
-        if (tlb[i].trieHandle && !tlb[i].global) {
-            trie.remove(tlb[i].trieHandle);
-            tlb[i].trieHandle = NULL;
-            freeList.push_back(&tlb[i]);
-        }
+        if (valid[i] && !tlb[i].global)
+            remove(i);
     }
+    walker->flushPwc();
+    if (next)
+        next->flushNonGlobal();
 }
 
 void
 TLB::demapPage(Addr va, uint64_t asn)
 {
-    TlbEntry *entry = trie.lookup(va);
-    if (entry) {
-        trie.remove(entry->trieHandle);
-        entry->trieHandle = NULL;
-        freeList.push_back(entry);
-    }
+    TlbEntry *entry = probe(va);
+    if (entry)
+        remove(entry - tlb.data());
+    // Like invlpg, drop the paging structure caches too.
+    walker->flushPwc();
+    if (next)
+        next->demapPage(va, asn);
 }
 
 namespace
@@ -374,7 +481,7 @@ TLB::translate(const RequestPtr &req,
         if (m5Reg.paging) {
             DPRINTF(TLB, "Paging enabled.\n");
             // The vaddr already has the segment base applied.
-            TlbEntry *entry = lookup(vaddr);
+            TlbEntry *entry = lookup(vaddr, true, mode);
             if (mode == BaseMMU::Read) {
                 stats.rdAccesses++;
             } else {
@@ -389,6 +496,9 @@ TLB::translate(const RequestPtr &req,
                 } else {
                     stats.wrMisses++;
                 }
+                entry = lookupNextLevel(vaddr, mode);
+            }
+            if (!entry) {
                 if (FullSystem) {
                     Fault fault = walker->start(tc, translation, req, mode);
                     if (timing || fault != NoFault) {
@@ -396,7 +506,7 @@ TLB::translate(const RequestPtr &req,
                         delayedResponse = true;
                         return fault;
                     }
-                    entry = lookup(vaddr);
+                    entry = lookup(vaddr, true, mode);
                     assert(entry);
                 } else {
                     Process *p = tc->getProcessPtr();
@@ -541,13 +651,13 @@ void
 TLB::serialize(CheckpointOut &cp) const
 {
     // Only store the entries in use.
-    uint32_t _size = size - freeList.size();
+    uint32_t _size = numValid;
     SERIALIZE_SCALAR(_size);
     SERIALIZE_SCALAR(lruSeq);
 
     uint32_t _count = 0;
     for (uint32_t x = 0; x < size; x++) {
-        if (tlb[x].trieHandle != NULL)
+        if (valid[x])
             tlb[x].serializeSection(cp, csprintf("Entry%d", _count++));
     }
 }
@@ -564,13 +674,12 @@ TLB::unserialize(CheckpointIn &cp)
 
     UNSERIALIZE_SCALAR(lruSeq);
 
+    // With a different geometry, a set may not be able to hold all the
+    // entries the checkpoint has for it, the least recently used go.
     for (uint32_t x = 0; x < _size; x++) {
-        TlbEntry *newEntry = freeList.front();
-        freeList.pop_front();
-
-        newEntry->unserializeSection(cp, csprintf("Entry%d", x));
-        newEntry->trieHandle = trie.insert(newEntry->vaddr,
-            TlbEntryTrie::MaxBits - newEntry->logBytes, newEntry);
+        TlbEntry entry;
+        entry.unserializeSection(cp, csprintf("Entry%d", x));
+        place(entry);
     }
 }
 
@@ -38,12 +38,13 @@
 #ifndef __ARCH_X86_TLB_HH__
 #define __ARCH_X86_TLB_HH__
 
-#include <list>
+#include <array>
+#include <cstdint>
 #include <vector>
 
+#include "arch/generic/mmu.hh"
 #include "arch/generic/tlb.hh"
 #include "arch/x86/pagetable.hh"
-#include "base/trie.hh"
 #include "mem/request.hh"
 #include "params/X86TLB.hh"
 #include "sim/stats.hh"
@@ -57,13 +58,22 @@ namespace X86ISA
 {
     class Walker;
 
+    /**
+     * A set associative TLB (fully associative with the default assoc of
+     * 0) with an LRU replacement within each set. The sets index the
+     * entries by the low bits of their page number. The lookups don't
+     * search the sets, they probe a hash table of the entries once for
+     * each page size in the TLB, after checking the entry of the last
+     * translation of the same access type.
+     *
+     * On a miss, the TLB looks up its next level (another X86TLB) before
+     * walking the page table, and fills both.
+     */
     class TLB : public BaseTLB
     {
       protected:
         friend class Walker;
 
-        typedef std::list<TlbEntry *> EntryList;
-
         uint32_t configAddress;
 
       public:
@@ -73,16 +83,17 @@ namespace X86ISA
 
         void takeOverFrom(BaseTLB *otlb) override {}
 
-        TlbEntry *lookup(Addr va, bool update_lru = true);
+        TlbEntry *lookup(Addr va, bool update_lru = true,
+                         BaseMMU::Mode mode = BaseMMU::Read);
 
         void setConfigAddress(uint32_t addr);
 
       protected:
-
-        EntryList::iterator lookupIt(Addr va, bool update_lru = true);
-
         Walker * walker;
 
+        /** The next level of the TLB hierarchy, if any */
+        TLB *next;
+
       public:
         Walker *getWalker();
 
@@ -94,14 +105,57 @@ namespace X86ISA
 
       protected:
         uint32_t size;
+        /** Ways of each set */
+        uint32_t assoc;
+        uint32_t numSets;
 
+        /** The entries, set after set */
         std::vector<TlbEntry> tlb;
+        /** Whether each entry of tlb holds a translation */
+        std::vector<bool> valid;
+        uint32_t numValid;
+
+        /**
+         * Open addressing hash table, with linear probing, of the indices
+         * in tlb of the valid entries, keyed by their page and size. -1
+         * marks an empty slot.
+         */
+        std::vector<int32_t> index;
+        int indexShift;
+
+        /** Page sizes (as log2 of the bytes) in the TLB, and how many */
+        uint64_t pageSizes;
+        std::array<uint32_t, 64> pageSizeCount;
 
-        EntryList freeList;
+        /** Entry of the last hit of each access type */
+        std::array<TlbEntry *, BaseMMU::Execute + 1> lastEntry;
 
-        TlbEntryTrie trie;
         uint64_t lruSeq;
 
+        size_t
+        hashSlot(Addr vaddr, unsigned log_bytes) const
+        {
+            return ((vaddr >> log_bytes) * 0x9e3779b97f4a7c15ULL +
+                    log_bytes) >> indexShift;
+        }
+
+        /** Index slot of the entry mapping vaddr with that page size */
+        int findSlot(Addr vaddr, unsigned log_bytes) const;
+
+        /** Entry translating va, looking at every page size in turn */
+        TlbEntry *probe(Addr va) const;
+
+        /** Put entry in a free or LRU way of its set, and index it */
+        TlbEntry *place(const TlbEntry &entry);
+
+        void remove(uint32_t i);
+
+        /**
+         * Look the translation of vaddr up in the next level, counting
+         * the access there, and copy it in this one if it hits.
+         */
+        TlbEntry *lookupNextLevel(Addr vaddr, BaseMMU::Mode mode);
+
         AddrRange m5opRange;
 
         struct TlbStats : public statistics::Group
@@ -122,8 +176,6 @@ namespace X86ISA
 
       public:
 
-        void evictLRU();
-
         uint64_t
         nextSeq()
         {
@@ -315,6 +315,22 @@ class AddrRange
      */
     uint32_t stripes() const { return 1ULL << masks.size(); }
 
+    /**
+     * Get the masks selecting the interleaving bits, empty if the range
+     * is not interleaved.
+     *
+     * @ingroup api_addr_range
+     */
+    const std::vector<Addr> &intlvMasks() const { return masks; }
+
+    /**
+     * Get the value of the interleaving bits of the addresses in this
+     * range.
+     *
+     * @ingroup api_addr_range
+     */
+    uint8_t intlvMatchValue() const { return intlvMatch; }
+
     /**
      * Get the size of the address range. For a case where
      * interleaving is used we make the simplifying assumption that
@@ -0,0 +1,99 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "base/addr_range_map.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/** Pseudo random addresses within [0, end), a fixed set of them. */
+std::vector<Addr>
+randomAddrs(Addr end)
+{
+    std::mt19937_64 gen(1);
+    std::uniform_int_distribution<Addr> dist(0, end - 1);
+    std::vector<Addr> addrs(4096);
+    for (auto &addr : addrs)
+        addr = dist(gen);
+    return addrs;
+}
+
+/**
+ * Decode addresses among contiguous ranges of 1MiB, like the devices
+ * and memories of a crossbar.
+ */
+void
+BM_AddrRangeMapContains(benchmark::State &state)
+{
+    const Addr range_size = 1ULL << 20;
+    AddrRangeMap<int> map;
+    for (int i = 0; i < state.range(0); i++)
+        map.insert(RangeSize(i * range_size, range_size), i);
+    const auto addrs = randomAddrs(state.range(0) * range_size);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(map.contains(addrs[i]));
+        i = (i + 1) % addrs.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * Decode addresses among memory channels interleaved at a 256B
+ * granularity, with an XOR hash of the channel bits.
+ */
+void
+BM_AddrRangeMapContainsInterleaved(benchmark::State &state)
+{
+    const Addr size = 1ULL << 30;
+    const int bits = state.range(0);
+    AddrRangeMap<int> map;
+    for (int i = 0; i < (1 << bits); i++)
+        map.insert(AddrRange(0, size, 8 + bits - 1, 20 + bits - 1, bits, i),
+                   i);
+    const auto addrs = randomAddrs(size);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(map.contains(addrs[i]));
+        i = (i + 1) % addrs.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // anonymous namespace
+
+BENCHMARK(BM_AddrRangeMapContains)->RangeMultiplier(4)->Range(1, 256);
+BENCHMARK(BM_AddrRangeMapContainsInterleaved)->DenseRange(1, 3);
+
+BENCHMARK_MAIN();
@@ -42,12 +42,16 @@
 #define __BASE_ADDR_RANGE_MAP_HH__
 
 #include <cstddef>
+#include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <list>
 #include <map>
 #include <utility>
+#include <vector>
 
 #include "base/addr_range.hh"
+#include "base/bitfield.hh"
 #include "base/types.hh"
 
 namespace gem5
@@ -57,6 +61,14 @@ namespace gem5
  * The AddrRangeMap uses an STL map to implement an interval tree for
  * address decoding. The value stored is a template type and can be
  * e.g. a port identifier, or a pointer.
+ *
+ * Lookups of the entry containing an address or range go through a flat
+ * index of the map, rebuilt whenever it changes: the sorted start
+ * addresses of the ranges, searched with a branchless binary search. The
+ * interleaved ranges that merge with each other share a single entry of
+ * the index, and the one an address falls in is computed directly from
+ * the interleaving bits of the address, so decoding many channels costs
+ * the same as decoding a single one.
  */
 template <typename V, int max_cache_size=0>
 class AddrRangeMap
@@ -73,6 +85,23 @@ class AddrRangeMap
     typedef typename RangeMap::const_iterator const_iterator;
     /** @} */ // end of api_addr_range
 
+    AddrRangeMap() = default;
+
+    /** The cache and the index refer to the tree, so they are rebuilt. */
+    AddrRangeMap(const AddrRangeMap &other) : tree(other.tree)
+    {
+        rebuildIndex();
+    }
+
+    AddrRangeMap &
+    operator=(const AddrRangeMap &other)
+    {
+        cache.clear();
+        tree = other.tree;
+        rebuildIndex();
+        return *this;
+    }
+
     /**
      * Find entry that contains the given address range
      *
@@ -89,12 +118,21 @@ class AddrRangeMap
     const_iterator
     contains(const AddrRange &r) const
     {
-        return find(r, [r](const AddrRange r1) { return r.isSubset(r1); });
+        return const_cast<AddrRangeMap *>(this)->contains(r);
     }
     iterator
     contains(const AddrRange &r)
     {
-        return find(r, [r](const AddrRange r1) { return r.isSubset(r1); });
+        if (!indexValid) {
+            return find(r, [r](const AddrRange r1) {
+                return r.isSubset(r1);
+            });
+        }
+
+        // The ranges do not overlap, so only the one holding the start
+        // of the input range may contain it
+        iterator it = lookup(r.start());
+        return it != end() && r.isSubset(it->first) ? it : end();
     }
     /** @} */ // end of api_addr_range
 
@@ -114,12 +152,14 @@ class AddrRangeMap
     const_iterator
     contains(Addr r) const
     {
-        return contains(RangeSize(r, 1));
+        return const_cast<AddrRangeMap *>(this)->contains(r);
     }
     iterator
     contains(Addr r)
     {
-        return contains(RangeSize(r, 1));
+        if (!indexValid)
+            return contains(RangeSize(r, 1));
+        return lookup(r);
     }
     /** @} */ // end of api_addr_range
 
@@ -157,7 +197,9 @@ class AddrRangeMap
         if (intersects(r) != end())
             return tree.end();
 
-        return tree.insert(std::make_pair(r, d)).first;
+        iterator it = tree.insert(std::make_pair(r, d)).first;
+        rebuildIndex();
+        return it;
     }
 
     /**
@@ -168,6 +210,7 @@ class AddrRangeMap
     {
         cache.remove(p);
         tree.erase(p);
+        rebuildIndex();
     }
 
     /**
@@ -180,6 +223,7 @@ class AddrRangeMap
             cache.remove(p);
         }
         tree.erase(p,q);
+        rebuildIndex();
     }
 
     /**
@@ -190,6 +234,7 @@ class AddrRangeMap
     {
         cache.erase(cache.begin(), cache.end());
         tree.erase(tree.begin(), tree.end());
+        rebuildIndex();
     }
 
     /**
@@ -247,6 +292,105 @@ class AddrRangeMap
     }
 
   private:
+    /**
+     * An entry of the flat index: a range, or a group of interleaved
+     * ranges that merge with each other.
+     */
+    struct IndexEntry
+    {
+        /** End of the range(s). */
+        Addr end;
+        /** Position of the interleaving masks in indexMasks. */
+        uint32_t masks;
+        /** Number of interleaving masks, 0 if not interleaved. */
+        uint32_t numMasks;
+        /** Position of the slots of the range(s) in indexSlots. */
+        uint32_t slots;
+    };
+
+    /**
+     * Rebuild the flat index from the tree. The index is disabled if the
+     * ranges of the tree overlap, which only happens when a single
+     * address sits in a hole of an interleaved range; the lookups then
+     * search the tree.
+     */
+    void
+    rebuildIndex()
+    {
+        indexStarts.clear();
+        indexEntries.clear();
+        indexMasks.clear();
+        indexSlots.clear();
+        indexValid = true;
+
+        for (auto it = tree.begin(); it != tree.end(); ++it) {
+            const AddrRange &r = it->first;
+            if (!indexStarts.empty() && indexStarts.back() == r.start() &&
+                r.interleaved() && r.intlvMasks().size() ==
+                indexEntries.back().numMasks &&
+                r.end() == indexEntries.back().end) {
+                // Another range of the same interleaved group
+                const IndexEntry &e = indexEntries.back();
+                if (std::equal(r.intlvMasks().begin(),
+                               r.intlvMasks().end(),
+                               indexMasks.begin() + e.masks)) {
+                    indexSlots[e.slots + r.intlvMatchValue()] = it;
+                    continue;
+                }
+            }
+
+            if (!indexEntries.empty() &&
+                r.start() < indexEntries.back().end) {
+                indexValid = false;
+                return;
+            }
+
+            const auto &masks = r.intlvMasks();
+            indexStarts.push_back(r.start());
+            indexEntries.push_back({r.end(), (uint32_t)indexMasks.size(),
+                                    (uint32_t)masks.size(),
+                                    (uint32_t)indexSlots.size()});
+            indexMasks.insert(indexMasks.end(), masks.begin(), masks.end());
+            indexSlots.resize(indexSlots.size() + r.stripes(), tree.end());
+            indexSlots[indexEntries.back().slots + r.intlvMatchValue()] = it;
+        }
+    }
+
+    /**
+     * Find the entry containing an address with the flat index.
+     *
+     * @param a An input address
+     * @return An iterator to the entry containing the address, or end()
+     */
+    iterator
+    lookup(Addr a)
+    {
+        if (indexStarts.empty())
+            return end();
+
+        // Find the last range starting at or before the address, with
+        // conditional moves rather than branches
+        const Addr *base = indexStarts.data();
+        std::size_t n = indexStarts.size();
+        while (n > 1) {
+            const std::size_t half = n / 2;
+            base = base[half] <= a ? base + half : base;
+            n -= half;
+        }
+        if (*base > a)
+            return end();
+
+        const IndexEntry &e = indexEntries[base - indexStarts.data()];
+        if (a >= e.end)
+            return end();
+
+        // Select the stripe of the address like AddrRange::contains
+        unsigned sel = 0;
+        for (unsigned i = 0; i < e.numMasks; i++)
+            sel |= (popCount(a & indexMasks[e.masks + i]) & 1) << i;
+        return indexSlots[e.slots + sel];
+    }
+
     /**
      * Add an address range map entry to the cache.
      *
@@ -335,6 +479,15 @@ class AddrRangeMap
      * always be valid iterators of the tree.
      */
     mutable std::list<iterator> cache;
+
+    /** @{ */
+    /** The flat index of the tree used for lookups. */
+    std::vector<Addr> indexStarts;
+    std::vector<IndexEntry> indexEntries;
+    std::vector<Addr> indexMasks;
+    std::vector<iterator> indexSlots;
+    bool indexValid = true;
+    /** @} */
 };
 
 } // namespace gem5
@@ -156,3 +156,70 @@ TEST(AddrRangeMapTest, InterleavedTest2)
     // intlvMatch = 2 for start = 0x80000000
     EXPECT_EQ(i->second, 2);
 }
+
+/**
+ * Check the lookups of a map mixing interleaved and contiguous ranges
+ * against the ranges themselves, for every interleaving stripe.
+ */
+TEST(AddrRangeMapTest, IndexedLookup)
+{
+    const auto masks = std::vector<Addr>{0x40, 0x80, 0x100};
+    std::vector<AddrRange> ranges;
+    ranges.emplace_back(0x0, 0x1000);
+    for (int k = 0; k < 8; k++)
+        ranges.emplace_back(0x10000, 0x20000, masks, k);
+    ranges.emplace_back(0x30000, 0x30100);
+
+    AddrRangeMap<int> r;
+    for (int i = 0; i < (int)ranges.size(); i++)
+        ASSERT_NE(r.insert(ranges[i], i), r.end());
+
+    for (Addr a = 0; a < 0x31000; a += 0x20) {
+        int expected = -1;
+        for (int i = 0; i < (int)ranges.size(); i++) {
+            if (ranges[i].contains(a))
+                expected = i;
+        }
+        auto i = r.contains(a);
+        if (expected < 0) {
+            EXPECT_EQ(i, r.end()) << std::hex << a;
+        } else {
+            ASSERT_NE(i, r.end()) << std::hex << a;
+            EXPECT_EQ(i->second, expected) << std::hex << a;
+        }
+    }
+
+    EXPECT_NE(r.contains(RangeSize(0x10040, 0x40)), r.end());
+    EXPECT_EQ(r.contains(RangeSize(0x10040, 0x80)), r.end());
+}
+
+/** The lookups follow the changes of the map and its copies. */
+TEST(AddrRangeMapTest, IndexedLookupUpdates)
+{
+    const auto masks = std::vector<Addr>{0x40};
+    AddrRangeMap<int> r;
+    r.insert(AddrRange(0x1000, 0x2000, masks, 0), 0);
+    EXPECT_EQ(r.contains(0x1040), r.end());
+
+    r.insert(AddrRange(0x1000, 0x2000, masks, 1), 1);
+    ASSERT_NE(r.contains(0x1040), r.end());
+    EXPECT_EQ(r.contains(0x1040)->second, 1);
+
+    AddrRangeMap<int> copy(r);
+    r.erase(r.contains(0x1040));
+    EXPECT_EQ(r.contains(0x1040), r.end());
+    ASSERT_NE(copy.contains(0x1040), copy.end());
+    EXPECT_EQ(copy.contains(0x1040)->second, 1);
+
+    r.clear();
+    EXPECT_EQ(r.contains(0x1000), r.end());
+
+    // A single address in a hole of an interleaved range
+    r.insert(RangeSize(0x1040, 1), 2);
+    r.insert(AddrRange(0x1000, 0x2000, masks, 0), 0);
+    ASSERT_NE(r.contains(0x1040), r.end());
+    EXPECT_EQ(r.contains(0x1040)->second, 2);
+    ASSERT_NE(r.contains(0x1000), r.end());
+    EXPECT_EQ(r.contains(0x1000)->second, 0);
+    EXPECT_EQ(r.contains(0x1080), r.end());
+}
@@ -0,0 +1,156 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_BINARY_TRACE_WRITER_HH__
+#define __BASE_BINARY_TRACE_WRITER_HH__
+
+#include <unistd.h>
+#include <zlib.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+/**
+ * Writes buffers of fixed size trace records to a gzip stream on a thread
+ * of its own, so that the simulation only pays for copying the records
+ * into a buffer. Writing without compression goes through the same
+ * transparent gzip stream.
+ *
+ * The owner fills a buffer of bufferRecords records and hands it over
+ * with queue(), which gives it an empty buffer back. It only waits when
+ * maxQueued buffers are already waiting to be written.
+ */
+template <typename Record>
+class BinaryTraceWriter
+{
+  public:
+    /** Records of a buffer, and buffers queued before the owner waits */
+    static const size_t bufferRecords = 32768;
+    static const size_t maxQueued = 4;
+
+    BinaryTraceWriter(const std::string &_filename, bool compress)
+        : filename(_filename), pid(getpid())
+    {
+        file = gzopen(filename.c_str(), compress ? "wb" : "wbT");
+        if (!file)
+            fatal("Can't open trace file %s\n", filename);
+        thread = std::thread([this]() { run(); });
+    }
+
+    ~BinaryTraceWriter()
+    {
+        // a forked child has no writer thread, and must not write to
+        // the file of its parent
+        if (getpid() != pid)
+            return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+        }
+        ready.notify_one();
+        thread.join();
+        gzclose(file);
+    }
+
+    /** Write a header, before any buffer is queued. */
+    void
+    writeRaw(const void *data, size_t len)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (gzwrite(file, data, len) != (int)len)
+            fatal("Failed to write trace file %s\n", filename);
+    }
+
+    /** Hand a buffer over and get an empty one back in its place. */
+    void
+    queue(std::vector<Record> &buf)
+    {
+        if (getpid() != pid) {
+            buf.clear();
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        written.wait(lock, [this]() { return queued.size() < maxQueued; });
+        queued.push_back(std::move(buf));
+        if (spare.empty()) {
+            buf = std::vector<Record>();
+            buf.reserve(bufferRecords);
+        } else {
+            buf = std::move(spare.back());
+            spare.pop_back();
+        }
+        lock.unlock();
+        ready.notify_one();
+    }
+
+  private:
+    void
+    run()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            ready.wait(lock, [this]() { return done || !queued.empty(); });
+            if (queued.empty())
+                return;
+            std::vector<Record> buf = std::move(queued.front());
+            queued.pop_front();
+            lock.unlock();
+
+            size_t len = buf.size() * sizeof(Record);
+            if (gzwrite(file, buf.data(), len) != (int)len)
+                fatal("Failed to write trace file %s\n", filename);
+            buf.clear();
+
+            lock.lock();
+            spare.push_back(std::move(buf));
+            written.notify_one();
+        }
+    }
+
+    const std::string filename;
+    const pid_t pid;
+    gzFile file;
+    std::thread thread;
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::condition_variable written;
+    std::deque<std::vector<Record>> queued;
+    std::vector<std::vector<Record>> spare;
+    bool done = false;
+};
+
+} // namespace gem5
+
+#endif // __BASE_BINARY_TRACE_WRITER_HH__
@@ -315,5 +315,50 @@ Print::endArgs()
     stream.width(savedWidth);
 }
 
+StaticPrint::StaticPrint(std::ostream &stream, const char *format,
+                         const Chunk *begin, const Chunk *end)
+    : stream(stream), format(format), chunk(begin), end(end), cont(false)
+{
+    savedFlags = stream.flags();
+    savedFill = stream.fill();
+    savedPrecision = stream.precision();
+    savedWidth = stream.width();
+}
+
+void
+StaticPrint::process()
+{
+    for (; chunk != end; ++chunk) {
+        switch (chunk->kind) {
+          case Chunk::Text:
+            stream.write(format + chunk->offset, chunk->length);
+            break;
+
+          case Chunk::Newline:
+            stream << std::endl;
+            break;
+
+          case Chunk::Argument:
+            stream.fill(' ');
+            stream.flags((std::ios::fmtflags)0);
+            fmt = (chunk++)->fmt;
+            return;
+        }
+    }
+}
+
+void
+StaticPrint::endArgs()
+{
+    // The number of arguments is checked at compile time, so only text
+    // is left
+    process();
+
+    stream.flags(savedFlags);
+    stream.fill(savedFill);
+    stream.precision(savedPrecision);
+    stream.width(savedWidth);
+}
+
 } // namespace cp
 } // namespace gem5
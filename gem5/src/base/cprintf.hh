@@ -30,10 +30,15 @@
 #ifndef __BASE_CPRINTF_HH__
 #define __BASE_CPRINTF_HH__
 
+#include <array>
+#include <cstddef>
 #include <ios>
 #include <iostream>
 #include <list>
+#include <sstream>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 #include "base/cprintf_formats.hh"
 
@@ -42,6 +47,45 @@ namespace gem5
 
 namespace cp {
 
+/** Get a '*' width or precision, which must be an integer */
+template <typename T>
+inline int
+getNumber(const T& data)
+{
+    if constexpr (std::is_integral_v<T>)
+        return data;
+    else
+        return 0;
+}
+
+/** Format an argument according to the conversion in fmt */
+template <typename T>
+inline void
+formatArg(std::ostream &stream, const T &data, Format &fmt)
+{
+    switch (fmt.format) {
+      case Format::Character:
+        formatChar(stream, data, fmt);
+        break;
+
+      case Format::Integer:
+        formatInteger(stream, data, fmt);
+        break;
+
+      case Format::Floating:
+        formatFloat(stream, data, fmt);
+        break;
+
+      case Format::String:
+        formatString(stream, data, fmt);
+        break;
+
+      default:
+        stream << "<bad format>";
+        break;
+    }
+}
+
 struct Print
 {
   protected:
@@ -64,18 +108,324 @@ struct Print
     Print(std::ostream &stream, const char *format);
     ~Print();
 
-    int
-    getNumber(int data)
+    template <typename T>
+    void
+    addArg(const T &data)
     {
-        return data;
+        if (!cont)
+            process();
+
+        if (fmt.getWidth) {
+            fmt.getWidth = false;
+            cont = true;
+            fmt.width = getNumber(data);
+            return;
+        }
+
+        if (fmt.getPrecision) {
+            fmt.getPrecision = false;
+            cont = true;
+            fmt.precision = getNumber(data);
+            return;
+        }
+
+        cont = false;
+        formatArg(stream, data, fmt);
     }
 
-    template <typename T>
-    int
-    getNumber(const T& data)
+    void endArgs();
+};
+
+/**
+ * A piece of a format string parsed at compile time: text that is written
+ * as it is, a newline, or the conversion of an argument.
+ */
+struct Chunk
+{
+    enum Kind
     {
-        return 0;
+        Text,
+        Newline,
+        Argument
+    };
+
+    Kind kind = Text;
+    /** Position of the text in the format string */
+    size_t offset = 0;
+    size_t length = 0;
+    /** Conversion of the argument */
+    Format fmt;
+};
+
+/** Summary of a format string parsed at compile time */
+struct FormatInfo
+{
+    size_t chunks = 0;
+    /** Number of arguments, including the '*' widths and precisions */
+    size_t args = 0;
+    /** Whether all the conversions are supported */
+    bool valid = true;
+};
+
+/**
+ * Parse a format string at compile time, in the same way as Print does at
+ * run time. The chunks are stored if chunks is not null, and the arguments
+ * which are '*' widths or precisions are flagged if counts is not null.
+ */
+constexpr FormatInfo
+parseFormat(const char *str, Chunk *chunks, bool *counts)
+{
+    FormatInfo info;
+    size_t i = 0;
+    while (str[i]) {
+        Chunk chunk;
+        if (str[i] == '%' && str[i + 1] == '%') {
+            chunk.offset = i + 1;
+            chunk.length = 1;
+            i += 2;
+        } else if (str[i] == '%') {
+            // The same state machine as Print::processFlag()
+            Format &fmt = chunk.fmt;
+            bool done = false;
+            bool end_number = false;
+            bool have_precision = false;
+            int number = 0;
+            chunk.kind = Chunk::Argument;
+
+            while (!done) {
+                ++i;
+                const char c = str[i];
+                if (c >= '0' && c <= '9') {
+                    if (end_number)
+                        continue;
+                } else if (number > 0) {
+                    end_number = true;
+                }
+
+                switch (c) {
+                  case 's':
+                    fmt.format = Format::String;
+                    done = true;
+                    break;
+
+                  case 'c':
+                    fmt.format = Format::Character;
+                    done = true;
+                    break;
+
+                  case 'l':
+                    continue;
+
+                  case 'p':
+                    fmt.format = Format::Integer;
+                    fmt.base = Format::Hex;
+                    fmt.alternateForm = true;
+                    done = true;
+                    break;
+
+                  case 'X':
+                    fmt.uppercase = true;
+                    [[fallthrough]];
+                  case 'x':
+                    fmt.base = Format::Hex;
+                    fmt.format = Format::Integer;
+                    done = true;
+                    break;
+
+                  case 'o':
+                    fmt.base = Format::Oct;
+                    fmt.format = Format::Integer;
+                    done = true;
+                    break;
+
+                  case 'd':
+                  case 'i':
+                  case 'u':
+                    fmt.format = Format::Integer;
+                    done = true;
+                    break;
+
+                  case 'G':
+                    fmt.uppercase = true;
+                    [[fallthrough]];
+                  case 'g':
+                    fmt.format = Format::Floating;
+                    fmt.floatFormat = Format::Best;
+                    done = true;
+                    break;
+
+                  case 'E':
+                    fmt.uppercase = true;
+                    [[fallthrough]];
+                  case 'e':
+                    fmt.format = Format::Floating;
+                    fmt.floatFormat = Format::Scientific;
+                    done = true;
+                    break;
+
+                  case 'f':
+                    fmt.format = Format::Floating;
+                    fmt.floatFormat = Format::Fixed;
+                    done = true;
+                    break;
+
+                  case '#':
+                    fmt.alternateForm = true;
+                    break;
+
+                  case '-':
+                    fmt.flushLeft = true;
+                    break;
+
+                  case '+':
+                    fmt.printSign = true;
+                    break;
+
+                  case ' ':
+                    fmt.blankSpace = true;
+                    break;
+
+                  case '.':
+                    fmt.width = number;
+                    fmt.precision = 0;
+                    have_precision = true;
+                    number = 0;
+                    end_number = false;
+                    break;
+
+                  case '0':
+                    if (number == 0) {
+                        fmt.fillZero = true;
+                        break;
+                    }
+                    [[fallthrough]];
+                  case '1':
+                  case '2':
+                  case '3':
+                  case '4':
+                  case '5':
+                  case '6':
+                  case '7':
+                  case '8':
+                  case '9':
+                    number = number * 10 + (c - '0');
+                    break;
+
+                  case '*':
+                    if (counts)
+                        counts[info.args] = true;
+                    info.args++;
+                    if (have_precision)
+                        fmt.getPrecision = true;
+                    else
+                        fmt.getWidth = true;
+                    break;
+
+                  default:
+                    // %n, an unknown conversion or the end of the string
+                    info.valid = false;
+                    return info;
+                }
+
+                if (end_number) {
+                    if (have_precision)
+                        fmt.precision = number;
+                    else
+                        fmt.width = number;
+
+                    end_number = false;
+                    number = 0;
+                }
+
+                if (done) {
+                    if ((fmt.format == Format::Integer) && have_precision) {
+                        fmt.width = fmt.precision;
+                        fmt.fillZero = true;
+                    } else if ((fmt.format == Format::Floating) &&
+                               !have_precision && fmt.fillZero) {
+                        fmt.precision = fmt.width;
+                    }
+                }
+            }
+            ++i;
+            info.args++;
+        } else if (str[i] == '\n') {
+            chunk.kind = Chunk::Newline;
+            ++i;
+        } else if (str[i] == '\r') {
+            ++i;
+            if (str[i] == '\n')
+                continue;
+            chunk.kind = Chunk::Newline;
+        } else {
+            chunk.offset = i;
+            while (str[i] && str[i] != '%' && str[i] != '\n' &&
+                   str[i] != '\r') {
+                ++i;
+            }
+            chunk.length = i - chunk.offset;
+        }
+
+        if (chunks)
+            chunks[info.chunks] = chunk;
+        info.chunks++;
     }
+    return info;
+}
+
+/**
+ * A format string parsed at compile time, see GEM5_FMT(). Str::get()
+ * returns the string.
+ */
+template <typename Str>
+struct StaticFormat
+{
+    static constexpr FormatInfo info = parseFormat(Str::get(), nullptr,
+                                                   nullptr);
+    static_assert(info.valid, "Unsupported conversion in format string");
+
+    template <size_t Chunks, size_t Args>
+    struct Parsed
+    {
+        std::array<Chunk, Chunks> chunks{};
+        std::array<bool, Args> counts{};
+
+        constexpr Parsed()
+        {
+            parseFormat(Str::get(), chunks.data(), counts.data());
+        }
+    };
+
+    static constexpr Parsed<info.chunks, info.args> parsed{};
+
+    /** Convert to the string, for the functions without a fast path */
+    constexpr operator const char *() const { return Str::get(); }
+};
+
+/**
+ * Print an argument list with a format parsed at compile time. Only the
+ * text of the chunks is written between the arguments.
+ */
+struct StaticPrint
+{
+  protected:
+    std::ostream &stream;
+    const char *format;
+    const Chunk *chunk;
+    const Chunk *end;
+    bool cont;
+
+    std::ios::fmtflags savedFlags;
+    char savedFill;
+    int savedPrecision;
+    int savedWidth;
+
+    Format fmt;
+    void process();
+
+  public:
+    StaticPrint(std::ostream &stream, const char *format,
+                const Chunk *begin, const Chunk *end);
 
     template <typename T>
     void
@@ -98,34 +448,37 @@ struct Print
             return;
         }
 
-        switch (fmt.format) {
-          case Format::Character:
-            formatChar(stream, data, fmt);
-            break;
-
-          case Format::Integer:
-            formatInteger(stream, data, fmt);
-            break;
-
-          case Format::Floating:
-            formatFloat(stream, data, fmt);
-            break;
-
-          case Format::String:
-            formatString(stream, data, fmt);
-            break;
-
-          default:
-            stream << "<bad format>";
-            break;
-        }
+        cont = false;
+        formatArg(stream, data, fmt);
     }
 
     void endArgs();
 };
 
+/** Whether the '*' widths and precisions of Str are integers */
+template <typename Str, typename ...Args, size_t ...I>
+constexpr bool
+countsAreIntegers(std::index_sequence<I...>)
+{
+    return ((!StaticFormat<Str>::parsed.counts[I] ||
+             std::is_integral_v<Args>) && ...);
+}
+
 } // namespace cp
 
+/**
+ * Parse a format string literal at compile time, for ccprintf() and the
+ * functions built on it to write the arguments without parsing it on every
+ * call. The number of arguments is checked at compile time. For example:
+ *
+ *     ccprintf(stream, GEM5_FMT("%s: %#x\n"), name, addr);
+ */
+#define GEM5_FMT(fmt)                                               \
+    ([] {                                                           \
+        struct Str { static constexpr const char *get() { return fmt; } }; \
+        return ::gem5::cp::StaticFormat<Str>();                     \
+    }())
+
 inline void
 ccprintf(cp::Print &print)
 {
@@ -151,6 +504,38 @@ ccprintf(std::ostream &stream, const char *format, const Args &...args)
 }
 
 
+template<typename Str, typename ...Args> void
+ccprintf(std::ostream &stream, cp::StaticFormat<Str> format,
+         const Args &...args)
+{
+    using Format = cp::StaticFormat<Str>;
+    static_assert(Format::info.args == sizeof...(Args),
+                  "The number of arguments doesn't match the format");
+    static_assert(cp::countsAreIntegers<Str, Args...>(
+                      std::index_sequence_for<Args...>()),
+                  "A '*' width or precision isn't an integer");
+
+    const auto &chunks = Format::parsed.chunks;
+    cp::StaticPrint print(stream, Str::get(), chunks.data(),
+                          chunks.data() + chunks.size());
+    (print.addArg(args), ...);
+    print.endArgs();
+}
+
+template<typename Str, typename ...Args> void
+cprintf(cp::StaticFormat<Str> format, const Args &...args)
+{
+    ccprintf(std::cout, format, args...);
+}
+
+template<typename Str, typename ...Args> std::string
+csprintf(cp::StaticFormat<Str> format, const Args &...args)
+{
+    std::stringstream stream;
+    ccprintf(stream, format, args...);
+    return stream.str();
+}
+
 template<typename ...Args> void
 cprintf(const char *format, const Args &...args)
 {
@@ -180,3 +180,36 @@ TEST(CPrintf, SpecialFormatting)
     CPRINTF_TEST("%07.*f\n", 4, 1.234);
     CPRINTF_TEST("%#0*x\n", 9, 123412);
 }
+
+TEST(CPrintf, WidthArgument)
+{
+    EXPECT_EQ(csprintf("%*d %d|%s", 3, 1, 2, "x"), "  1 2|x");
+    EXPECT_EQ(csprintf("%-*s|", 5L, "ab"), "ab   |");
+}
+
+#define STATIC_CPRINTF_TEST(fmt, ...)                            \
+    EXPECT_EQ(csprintf(GEM5_FMT(fmt), __VA_ARGS__),              \
+              csprintf(fmt, __VA_ARGS__))
+
+TEST(CPrintf, StaticFormat)
+{
+    EXPECT_EQ(csprintf(GEM5_FMT("plain text")), "plain text");
+    EXPECT_EQ(csprintf(GEM5_FMT("")), "");
+    EXPECT_EQ(csprintf(GEM5_FMT("a\r\nb\rc%%")), "a\nb\nc%");
+
+    STATIC_CPRINTF_TEST("%s.%s", "foo", std::string("bar"));
+    STATIC_CPRINTF_TEST("%d %i %u %lld\n", -1, 2, 3U, 4LL);
+    STATIC_CPRINTF_TEST("%#x %X %o %p", 255, 0xab, 8, (void *)0x10);
+    STATIC_CPRINTF_TEST("%c  %c\n", 'c', 65);
+    STATIC_CPRINTF_TEST("%.2f%% %e %G", 12.345, 1e10, 2.5);
+    STATIC_CPRINTF_TEST("%08.4f|%-5d|%5.2s", 99.99, 3, "hello");
+    STATIC_CPRINTF_TEST("%0*.*f\n", 8, 4, 99.99);
+    STATIC_CPRINTF_TEST("%#0*x\n", 9, 123412);
+    STATIC_CPRINTF_TEST("%*d %d|%s", 3, 1, 2, "x");
+}
+
+TEST(CPrintf, StaticFormatConversion)
+{
+    const char *str = GEM5_FMT("%d");
+    EXPECT_STREQ(str, "%d");
+}
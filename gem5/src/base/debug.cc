@@ -87,6 +87,41 @@ allFlags()
 }
 
 bool Flag::_globalEnable = false;
+bool Flag::_anyTracing = false;
+
+std::vector<uint64_t> &
+Flag::enabledMask()
+{
+    static std::vector<uint64_t> mask;
+    return mask;
+}
+
+namespace
+{
+
+// Compound flags, to update when a simple flag changes
+std::vector<Flag *> &
+compoundFlags()
+{
+    static std::vector<Flag *> flags;
+    return flags;
+}
+
+// Index of the next simple flag
+int nextFlagIndex = 0;
+
+} // anonymous namespace
+
+void
+Flag::update()
+{
+    const auto &mask = enabledMask();
+    _anyTracing = _globalEnable &&
+        std::any_of(mask.begin(), mask.end(),
+                    [](uint64_t word) { return word != 0; });
+    for (auto *flag : compoundFlags())
+        flag->sync();
+}
 
 Flag *
 findFlag(const std::string &name)
@@ -120,6 +155,7 @@ Flag::globalEnable()
     _globalEnable = true;
     for (auto& i : allFlags())
         i.second->sync();
+    update();
 }
 
 void
@@ -128,16 +164,84 @@ Flag::globalDisable()
     _globalEnable = false;
     for (auto& i : allFlags())
         i.second->sync();
+    update();
 }
 
 SimpleFlag::SimpleFlag(const char *name, const char *desc, bool is_format)
-  : Flag(name, desc), _isFormat(is_format)
+  : Flag(name, desc), _isFormat(is_format), _index(nextFlagIndex++)
 {
+    auto &mask = enabledMask();
+    if (mask.size() <= (size_t)(_index / 64))
+        mask.resize(_index / 64 + 1, 0);
+
     // Add non-format flags to the special "All" compound flag.
     if (!isFormat())
         AllFlagsFlag::instance().add(this);
 }
 
+SimpleFlag::~SimpleFlag()
+{
+    if (!isFormat())
+        AllFlagsFlag::instance().remove(this);
+    if (_enabled)
+        setEnabled(false);
+}
+
+void
+SimpleFlag::setEnabled(bool enabled)
+{
+    _enabled = enabled;
+    uint64_t &word = enabledMask()[_index / 64];
+    if (enabled)
+        word |= 1ULL << (_index % 64);
+    else
+        word &= ~(1ULL << (_index % 64));
+    sync();
+    update();
+}
+
+void
+CompoundFlag::registerCompound()
+{
+    compoundFlags().push_back(this);
+}
+
+CompoundFlag::~CompoundFlag()
+{
+    auto &flags = compoundFlags();
+    flags.erase(std::remove(flags.begin(), flags.end(), (Flag *)this),
+                flags.end());
+}
+
+void
+CompoundFlag::collect(std::vector<uint64_t> &mask) const
+{
+    for (auto *kid : _kids) {
+        if (auto *simple = dynamic_cast<SimpleFlag *>(kid)) {
+            int index = simple->index();
+            if (mask.size() <= (size_t)(index / 64))
+                mask.resize(index / 64 + 1, 0);
+            mask[index / 64] |= 1ULL << (index % 64);
+        } else if (auto *compound = dynamic_cast<CompoundFlag *>(kid)) {
+            compound->collect(mask);
+        }
+    }
+}
+
+void
+CompoundFlag::sync()
+{
+    if (_mask.empty())
+        collect(_mask);
+
+    // every simple flag of the group must be on
+    const auto &enabled = enabledMask();
+    bool all = !_mask.empty();
+    for (size_t i = 0; i < _mask.size() && all; i++)
+        all = (enabled[i] & _mask[i]) == _mask[i];
+    _tracing = _globalEnable && all;
+}
+
 void
 CompoundFlag::enable()
 {
@@ -161,6 +265,16 @@ AllFlagsFlag::add(SimpleFlag *flag)
 {
     ++_version;
     _kids.push_back(flag);
+    _mask.clear();
+}
+
+void
+AllFlagsFlag::remove(SimpleFlag *flag)
+{
+    ++_version;
+    _kids.erase(std::remove(_kids.begin(), _kids.end(), (Flag *)flag),
+                _kids.end());
+    _mask.clear();
 }
 
 int AllFlagsFlag::_version = 0;
@@ -42,6 +42,7 @@
 #ifndef __BASE_DEBUG_HH__
 #define __BASE_DEBUG_HH__
 
+#include <cstdint>
 #include <initializer_list>
 #include <iostream>
 #include <map>
@@ -64,6 +65,14 @@ class Flag
   protected:
     static bool _globalEnable; // whether debug tracings are enabled
 
+    /**
+     * Whether tracing is enabled and any simple flag is on. It is checked
+     * before the flag itself, so that the debug checks of the hot paths
+     * read this one global rather than a flag each when nothing is traced,
+     * which is the common case.
+     */
+    static bool _anyTracing;
+
     bool _tracing = false; // tracing is enabled and flag is on
 
     const char *_name;
@@ -71,6 +80,15 @@ class Flag
 
     virtual void sync() { }
 
+    /**
+     * Bitmask of the simple flags which are on, indexed by
+     * SimpleFlag::index().
+     */
+    static std::vector<uint64_t> &enabledMask();
+
+    /** Update _anyTracing and the compound flags after a change */
+    static void update();
+
   public:
     Flag(const char *name, const char *desc);
     virtual ~Flag();
@@ -78,7 +96,7 @@ class Flag
     std::string name() const { return _name; }
     std::string desc() const { return _desc; }
 
-    bool tracing() const { return TRACING_ON && _tracing; }
+    bool tracing() const { return TRACING_ON && _anyTracing && _tracing; }
 
     virtual void enable() = 0;
     virtual void disable() = 0;
@@ -87,6 +105,9 @@ class Flag
 
     static void globalEnable();
     static void globalDisable();
+
+    /** Whether any flag is tracing, to skip a group of debug checks */
+    static bool anyTracing() { return TRACING_ON && _anyTracing; }
 };
 
 class SimpleFlag : public Flag
@@ -97,13 +118,21 @@ class SimpleFlag : public Flag
 
     bool _enabled = false; // flag enablement status
 
+    /** Bit of the flag in the mask of the enabled flags */
+    const int _index;
+
     void sync() override { _tracing = _globalEnable && _enabled; }
 
+    void setEnabled(bool enabled);
+
   public:
     SimpleFlag(const char *name, const char *desc, bool is_format=false);
+    ~SimpleFlag();
+
+    void enable() override  { setEnabled(true); }
+    void disable() override { setEnabled(false); }
 
-    void enable() override  { _enabled = true;  sync(); }
-    void disable() override { _enabled = false; sync(); }
+    int index() const { return _index; }
 
     /**
      * Checks whether this flag is a conventional debug flag, or a flag that
@@ -114,11 +143,25 @@ class SimpleFlag : public Flag
     bool isFormat() const { return _isFormat; }
 };
 
+/**
+ * A flag grouping other flags. It is tracing when all of the simple flags
+ * it groups, directly or through other compound flags, are on.
+ */
 class CompoundFlag : public Flag
 {
   protected:
     std::vector<Flag *> _kids;
 
+    /** Simple flags of the group, as a bitmask */
+    std::vector<uint64_t> _mask;
+
+    void sync() override;
+
+    /** Add the simple flags of the group to a bitmask */
+    void collect(std::vector<uint64_t> &mask) const;
+
+    void registerCompound();
+
   public:
     template<typename... Args>
     CompoundFlag(const char *name, const char *desc,
@@ -126,8 +169,11 @@ class CompoundFlag : public Flag
         : Flag(name, desc),
           _kids(flags)
     {
+        registerCompound();
     }
 
+    ~CompoundFlag();
+
     const std::vector<Flag *> &kids() const { return _kids; }
 
     void enable() override;
@@ -143,6 +189,7 @@ class AllFlagsFlag : public CompoundFlag
     AllFlagsFlag();
 
     void add(SimpleFlag *flag);
+    void remove(SimpleFlag *flag);
 
     static AllFlagsFlag &instance();
     static int version() { return _version; }
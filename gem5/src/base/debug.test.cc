@@ -136,6 +136,24 @@ TEST(DebugCompoundFlagTest, Enabled)
     ASSERT_FALSE(flag.tracing());
 }
 
+/** Test that anyTracing() follows the simple flags and the global enable. */
+TEST(DebugFlagTest, AnyTracing)
+{
+    debug::Flag::globalEnable();
+    debug::SimpleFlag flag("FlagAnyTracingTest", "");
+
+    ASSERT_FALSE(debug::Flag::anyTracing());
+    flag.enable();
+    ASSERT_TRUE(!TRACING_ON || debug::Flag::anyTracing());
+    debug::Flag::globalDisable();
+    ASSERT_FALSE(debug::Flag::anyTracing());
+    ASSERT_FALSE(flag.tracing());
+    debug::Flag::globalEnable();
+    ASSERT_TRUE(!TRACING_ON || debug::Flag::anyTracing());
+    flag.disable();
+    ASSERT_FALSE(debug::Flag::anyTracing());
+}
+
 /** Test that the conversion operator matches the enablement status. */
 TEST(DebugFlagTest, ConversionOperator)
 {
@@ -176,6 +194,7 @@ TEST(DebugCompoundFlagTest, EnabledKids)
     flag_b.enable();
     ASSERT_TRUE(!TRACING_ON || flag_a.tracing());
     ASSERT_TRUE(!TRACING_ON || flag_b.tracing());
+    ASSERT_TRUE(!TRACING_ON || flag.tracing());
 
     // Test that disabling one of the flags disables the compound flag
     flag_a.disable();
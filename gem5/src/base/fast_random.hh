@@ -0,0 +1,162 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_FAST_RANDOM_HH__
+#define __BASE_FAST_RANDOM_HH__
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+#include "sim/serialize.hh"
+
+namespace gem5
+{
+
+/**
+ * A small and fast xoshiro256** generator for components that draw random
+ * numbers on their hot path, e.g. replacement policies. Each owner keeps
+ * its own generator, so the sequence it sees doesn't depend on how other
+ * objects use the global random_mt, and bounded ranges are mapped with a
+ * multiply-shift rather than through a std distribution.
+ */
+class FastRandom : public Serializable
+{
+  private:
+    uint64_t state[4];
+
+    static uint64_t
+    rotl(uint64_t x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    /** An unbiased draw in [0, range), with range != 0. */
+    uint64_t
+    bounded(uint64_t range)
+    {
+        __uint128_t m = (__uint128_t)next() * range;
+        uint64_t low = (uint64_t)m;
+        if (low < range) {
+            const uint64_t threshold = -range % range;
+            while (low < threshold) {
+                m = (__uint128_t)next() * range;
+                low = (uint64_t)m;
+            }
+        }
+        return m >> 64;
+    }
+
+  public:
+    FastRandom(uint64_t seed=0) { init(seed); }
+
+    /** Seed from a name, usually the one of the owning SimObject. */
+    explicit FastRandom(const std::string &name) { init(hash(name)); }
+
+    /** FNV-1a, which unlike std::hash is the same on every host. */
+    static uint64_t
+    hash(const std::string &name)
+    {
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for (unsigned char c : name) {
+            h ^= c;
+            h *= 0x100000001b3ULL;
+        }
+        return h;
+    }
+
+    /** Expand a seed into the generator state with splitmix64. */
+    void
+    init(uint64_t seed)
+    {
+        for (auto &s : state) {
+            uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            s = z ^ (z >> 31);
+        }
+    }
+
+    /** The next 64 random bits. */
+    uint64_t
+    next()
+    {
+        const uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    /** [0, max_value] for integer types, like Random::random(). */
+    template <typename T>
+    typename std::enable_if_t<std::is_integral_v<T>, T>
+    random()
+    {
+        return random<T>(0, std::numeric_limits<T>::max());
+    }
+
+    /** [0, 1) for real types. */
+    template <typename T>
+    typename std::enable_if_t<std::is_floating_point_v<T>, T>
+    random()
+    {
+        return (next() >> 11) * (T(1) / T(1ULL << 53));
+    }
+
+    /** [min, max] for integer types. */
+    template <typename T>
+    typename std::enable_if_t<std::is_integral_v<T>, T>
+    random(T min, T max)
+    {
+        const uint64_t range = (uint64_t)max - (uint64_t)min + 1;
+        // A range of zero is the whole 64 bit space
+        return (T)((uint64_t)min + (range ? bounded(range) : next()));
+    }
+
+    void
+    serialize(CheckpointOut &cp) const override
+    {
+        SERIALIZE_ARRAY(state, 4);
+    }
+
+    void
+    unserialize(CheckpointIn &cp) override
+    {
+        // Checkpoints taken before the owner had a generator of its own
+        // don't have a state; keep the one it was seeded with
+        if (cp.entryExists(Serializable::currentSection(), "state"))
+            UNSERIALIZE_ARRAY(state, 4);
+    }
+};
+
+} // namespace gem5
+
+#endif // __BASE_FAST_RANDOM_HH__
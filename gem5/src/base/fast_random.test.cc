@@ -0,0 +1,102 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "base/fast_random.hh"
+
+using namespace gem5;
+
+/** Generators seeded alike produce the same sequence. */
+TEST(FastRandomTest, Deterministic)
+{
+    FastRandom a(42), b(42), c(43);
+    bool differs = false;
+    for (int i = 0; i < 100; i++) {
+        const uint64_t val = a.next();
+        EXPECT_EQ(val, b.next());
+        differs |= val != c.next();
+    }
+    EXPECT_TRUE(differs);
+}
+
+/** Names seed the generator the same way every time. */
+TEST(FastRandomTest, NameSeed)
+{
+    FastRandom a(std::string("system.l2.replacement_policy"));
+    FastRandom b(std::string("system.l2.replacement_policy"));
+    FastRandom c(std::string("system.l1.replacement_policy"));
+    EXPECT_EQ(a.next(), b.next());
+    EXPECT_NE(a.next(), c.next());
+}
+
+/** Bounded draws stay in range and hit both ends of it. */
+TEST(FastRandomTest, Bounds)
+{
+    FastRandom rng;
+    bool saw_min = false, saw_max = false;
+    for (int i = 0; i < 10000; i++) {
+        const unsigned val = rng.random<unsigned>(1, 100);
+        ASSERT_GE(val, 1);
+        ASSERT_LE(val, 100);
+        saw_min |= val == 1;
+        saw_max |= val == 100;
+    }
+    EXPECT_TRUE(saw_min);
+    EXPECT_TRUE(saw_max);
+
+    for (int i = 0; i < 1000; i++) {
+        const int val = rng.random<int>(-5, 5);
+        ASSERT_GE(val, -5);
+        ASSERT_LE(val, 5);
+    }
+    EXPECT_EQ(rng.random<unsigned>(7, 7), 7);
+}
+
+/** Draws over the whole 64 bit range don't get stuck at the minimum. */
+TEST(FastRandomTest, FullRange)
+{
+    FastRandom rng;
+    uint64_t acc = 0;
+    for (int i = 0; i < 64; i++)
+        acc |= rng.random<uint64_t>(0, UINT64_MAX);
+    EXPECT_NE(acc, 0);
+}
+
+/** Reals are in [0, 1). */
+TEST(FastRandomTest, Real)
+{
+    FastRandom rng;
+    double sum = 0;
+    for (int i = 0; i < 10000; i++) {
+        const double val = rng.random<double>();
+        ASSERT_GE(val, 0.0);
+        ASSERT_LT(val, 1.0);
+        sum += val;
+    }
+    EXPECT_NEAR(sum / 10000, 0.5, 0.05);
+}
@@ -0,0 +1,58 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_GBENCH_SIM_OBJECT_PARAMS_HH__
+#define __BASE_GBENCH_SIM_OBJECT_PARAMS_HH__
+
+#include <string>
+
+#include "params/SimObject.hh"
+
+namespace gem5
+{
+
+/**
+ * Parameters of a SimObject created by a microbenchmark rather than by
+ * the Python configuration, with the SimObject parameters set. The other
+ * parameters are left to the benchmark, the generated structs don't have
+ * the defaults of the Python classes.
+ *
+ * SimObjects keep a reference to their parameters, so they are never
+ * freed.
+ */
+template <class Params>
+Params &
+simObjectParams(const std::string &name)
+{
+    Params *params = new Params;
+    params->name = name;
+    params->eventq_index = 0;
+    params->host_time_stats = false;
+    return *params;
+}
+
+} // namespace gem5
+
+#endif // __BASE_GBENCH_SIM_OBJECT_PARAMS_HH__
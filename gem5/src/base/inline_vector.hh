@@ -0,0 +1,250 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_INLINE_VECTOR_HH__
+#define __BASE_INLINE_VECTOR_HH__
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace gem5
+{
+
+/**
+ * A vector which stores up to N elements inside the object itself, and only
+ * goes to the heap when it grows beyond that. The storage it grows into is
+ * kept until the vector is destroyed, so a vector that is cleared and
+ * reused does not allocate again.
+ *
+ * Elements are only ever copy or move constructed, never assigned, so
+ * element types with const members are supported. Iterators are plain
+ * pointers, and any insertion or removal invalidates them.
+ */
+template <class T, std::size_t N>
+class InlineVector
+{
+    static_assert(N > 0, "InlineVector needs some inline storage");
+
+  public:
+    typedef T value_type;
+    typedef T *iterator;
+    typedef const T *const_iterator;
+    typedef std::size_t size_type;
+
+  private:
+    /** The inline storage. */
+    alignas(T) unsigned char inlineStorage[N * sizeof(T)];
+
+    /** The storage in use, either inline or on the heap. */
+    T *elems;
+
+    /** Number of elements. */
+    size_type _size = 0;
+
+    /** Number of elements the storage in use can hold. */
+    size_type _capacity = N;
+
+    T *inlineElems() { return reinterpret_cast<T *>(inlineStorage); }
+
+    bool isInline() const
+    {
+        return elems == reinterpret_cast<const T *>(inlineStorage);
+    }
+
+    /** Move the elements to a larger heap storage. */
+    void
+    grow(size_type capacity)
+    {
+        T *new_elems = static_cast<T *>(::operator new(capacity * sizeof(T)));
+        for (size_type i = 0; i < _size; i++) {
+            new (&new_elems[i]) T(std::move(elems[i]));
+            elems[i].~T();
+        }
+        if (!isInline())
+            ::operator delete(elems);
+        elems = new_elems;
+        _capacity = capacity;
+    }
+
+    /** Take the elements of another vector, which is left empty. */
+    void
+    take(InlineVector &other)
+    {
+        assert(_size == 0);
+        if (isInline() && !other.isInline()) {
+            // Steal the heap storage
+            elems = other.elems;
+            _size = other._size;
+            _capacity = other._capacity;
+            other.elems = other.inlineElems();
+            other._size = 0;
+            other._capacity = N;
+            return;
+        }
+        reserve(other._size);
+        for (size_type i = 0; i < other._size; i++)
+            new (&elems[i]) T(std::move(other.elems[i]));
+        _size = other._size;
+        other.clear();
+    }
+
+  public:
+    InlineVector() : elems(inlineElems()) {}
+
+    InlineVector(const InlineVector &other) : InlineVector()
+    {
+        reserve(other._size);
+        for (const auto &e : other)
+            new (&elems[_size++]) T(e);
+    }
+
+    InlineVector(InlineVector &&other) : InlineVector() { take(other); }
+
+    ~InlineVector()
+    {
+        clear();
+        if (!isInline())
+            ::operator delete(elems);
+    }
+
+    InlineVector &
+    operator=(const InlineVector &other)
+    {
+        if (this != &other) {
+            clear();
+            reserve(other._size);
+            for (const auto &e : other)
+                new (&elems[_size++]) T(e);
+        }
+        return *this;
+    }
+
+    InlineVector &
+    operator=(InlineVector &&other)
+    {
+        if (this != &other) {
+            clear();
+            take(other);
+        }
+        return *this;
+    }
+
+    iterator begin() { return elems; }
+    iterator end() { return elems + _size; }
+    const_iterator begin() const { return elems; }
+    const_iterator end() const { return elems + _size; }
+
+    size_type size() const { return _size; }
+    size_type capacity() const { return _capacity; }
+    bool empty() const { return _size == 0; }
+
+    T &front() { assert(_size); return elems[0]; }
+    const T &front() const { assert(_size); return elems[0]; }
+    T &back() { assert(_size); return elems[_size - 1]; }
+    const T &back() const { assert(_size); return elems[_size - 1]; }
+
+    T &operator[](size_type idx) { assert(idx < _size); return elems[idx]; }
+    const T &
+    operator[](size_type idx) const
+    {
+        assert(idx < _size);
+        return elems[idx];
+    }
+
+    void
+    reserve(size_type capacity)
+    {
+        if (capacity > _capacity)
+            grow(capacity);
+    }
+
+    template <class... Args>
+    T &
+    emplace_back(Args&&... args)
+    {
+        if (_size == _capacity)
+            grow(2 * _capacity);
+        return *new (&elems[_size++]) T(std::forward<Args>(args)...);
+    }
+
+    void push_back(const T &e) { emplace_back(e); }
+    void push_back(T &&e) { emplace_back(std::move(e)); }
+
+    /**
+     * Remove a range of elements, shifting the following ones down.
+     *
+     * @return An iterator to the element following the removed ones.
+     */
+    iterator
+    erase(iterator first, iterator last)
+    {
+        assert(begin() <= first && first <= last && last <= end());
+        const size_type count = last - first;
+        if (count == 0)
+            return first;
+        for (iterator i = first; i + count != end(); i++) {
+            i->~T();
+            new (i) T(std::move(i[count]));
+        }
+        for (iterator i = end() - count; i != end(); i++)
+            i->~T();
+        _size -= count;
+        return first;
+    }
+
+    iterator erase(iterator pos) { return erase(pos, pos + 1); }
+
+    void pop_front() { erase(begin()); }
+
+    void
+    pop_back()
+    {
+        assert(_size);
+        elems[--_size].~T();
+    }
+
+    void
+    clear()
+    {
+        for (size_type i = 0; i < _size; i++)
+            elems[i].~T();
+        _size = 0;
+    }
+
+    /** Exchange the elements of two vectors. */
+    void
+    swap(InlineVector &other)
+    {
+        InlineVector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+};
+
+} // namespace gem5
+
+#endif // __BASE_INLINE_VECTOR_HH__
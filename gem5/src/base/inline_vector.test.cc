@@ -0,0 +1,142 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include "base/inline_vector.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/** An element which cannot be assigned and counts its live instances. */
+struct Element
+{
+    static int live;
+
+    const int value;
+    std::shared_ptr<int> payload;
+
+    Element(int v) : value(v), payload(std::make_shared<int>(v)) { live++; }
+    Element(const Element &other)
+        : value(other.value), payload(other.payload)
+    {
+        live++;
+    }
+    Element(Element &&other)
+        : value(other.value), payload(std::move(other.payload))
+    {
+        live++;
+    }
+    ~Element() { live--; }
+};
+
+int Element::live = 0;
+
+} // anonymous namespace
+
+TEST(InlineVectorTest, StaysInline)
+{
+    InlineVector<Element, 4> v;
+    EXPECT_TRUE(v.empty());
+    for (int i = 0; i < 4; i++)
+        v.emplace_back(i);
+    EXPECT_EQ(4u, v.size());
+    EXPECT_EQ(4u, v.capacity());
+    EXPECT_EQ(0, v.front().value);
+    EXPECT_EQ(3, v.back().value);
+}
+
+TEST(InlineVectorTest, Grows)
+{
+    {
+        InlineVector<Element, 2> v;
+        for (int i = 0; i < 9; i++)
+            v.emplace_back(i);
+        ASSERT_EQ(9u, v.size());
+        EXPECT_LE(9u, v.capacity());
+        for (int i = 0; i < 9; i++) {
+            EXPECT_EQ(i, v[i].value);
+            EXPECT_EQ(i, *v[i].payload);
+        }
+
+        // Clearing keeps the grown storage
+        const auto capacity = v.capacity();
+        v.clear();
+        EXPECT_EQ(capacity, v.capacity());
+        EXPECT_EQ(0, Element::live);
+    }
+    EXPECT_EQ(0, Element::live);
+}
+
+TEST(InlineVectorTest, Erase)
+{
+    InlineVector<Element, 4> v;
+    for (int i = 0; i < 6; i++)
+        v.emplace_back(i);
+
+    auto it = v.erase(v.begin() + 1);
+    EXPECT_EQ(2, it->value);
+    it = v.erase(v.begin() + 2, v.begin() + 4);
+    EXPECT_EQ(5, it->value);
+    it = v.erase(v.begin() + 2, v.end());
+    EXPECT_EQ(v.end(), it);
+    v.erase(v.begin(), v.begin());
+    v.pop_front();
+
+    ASSERT_EQ(1u, v.size());
+    EXPECT_EQ(2, v[0].value);
+    EXPECT_EQ(1, Element::live);
+}
+
+TEST(InlineVectorTest, CopyMoveSwap)
+{
+    InlineVector<Element, 2> small, large;
+    small.emplace_back(1);
+    for (int i = 10; i < 15; i++)
+        large.emplace_back(i);
+
+    InlineVector<Element, 2> copy(large);
+    ASSERT_EQ(5u, copy.size());
+    EXPECT_EQ(14, copy.back().value);
+
+    small.swap(large);
+    ASSERT_EQ(5u, small.size());
+    ASSERT_EQ(1u, large.size());
+    EXPECT_EQ(10, small.front().value);
+    EXPECT_EQ(1, large.front().value);
+
+    InlineVector<Element, 2> moved(std::move(small));
+    EXPECT_TRUE(small.empty());
+    EXPECT_EQ(5u, moved.size());
+
+    moved = large;
+    ASSERT_EQ(1u, moved.size());
+    EXPECT_EQ(1, *moved.front().payload);
+}
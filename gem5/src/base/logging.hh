@@ -98,17 +98,7 @@ class Logger
     template<typename ...Args> void
     print(const Loc &loc, const char *format, const Args &...args)
     {
-        std::stringstream ss;
-        ccprintf(ss, format, args...);
-        const std::string str = ss.str();
-
-        std::stringstream ss_formatted;
-        ss_formatted << prefix << str;
-        if (str.length() && str.back() != '\n' && str.back() != '\r')
-            ss_formatted << std::endl;
-        if (!enabled)
-            return;
-        log(loc, ss_formatted.str());
+        printFormat(loc, format, args...);
     }
 
     template<typename ...Args> void
@@ -117,6 +107,13 @@ class Logger
         print(loc, format.c_str(), args...);
     }
 
+    /** Print with a format parsed at compile time, see GEM5_FMT() */
+    template<typename Str, typename ...Args> void
+    print(const Loc &loc, cp::StaticFormat<Str> format, const Args &...args)
+    {
+        printFormat(loc, format, args...);
+    }
+
     /**
      * This helper is necessary since noreturn isn't inherited by virtual
      * functions, and gcc will get mad if a function calls panic and then
@@ -127,6 +124,22 @@ class Logger
   protected:
     bool enabled;
 
+    template<typename Format, typename ...Args> void
+    printFormat(const Loc &loc, const Format &format, const Args &...args)
+    {
+        std::stringstream ss;
+        ccprintf(ss, format, args...);
+        const std::string str = ss.str();
+
+        std::stringstream ss_formatted;
+        ss_formatted << prefix << str;
+        if (str.length() && str.back() != '\n' && str.back() != '\r')
+            ss_formatted << std::endl;
+        if (!enabled)
+            return;
+        log(loc, ss_formatted.str());
+    }
+
     /** Generates the log message. By default it is sent to cerr. */
     virtual void
     log(const Loc &loc, std::string s)
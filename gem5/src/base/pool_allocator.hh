@@ -0,0 +1,130 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_POOL_ALLOCATOR_HH__
+#define __BASE_POOL_ALLOCATOR_HH__
+
+#include <cstddef>
+#include <new>
+
+namespace gem5
+{
+
+/**
+ * A per-thread free list of fixed size chunks of memory. Freed chunks are
+ * kept on the list of the thread which frees them and handed out again by
+ * the next allocation on that thread, so once a simulation has warmed up,
+ * objects which are created and destroyed at a high rate (packets,
+ * requests) stop going to the system allocator.
+ *
+ * Chunks are never given back to the system. The list head is trivially
+ * destructible, so chunks freed during static destruction are still safe
+ * to push onto it.
+ */
+template <std::size_t Size>
+class FreeListPool
+{
+    static_assert(Size > 0, "FreeListPool chunks can't be empty");
+
+    union Chunk
+    {
+        Chunk *next;
+        alignas(std::max_align_t) unsigned char storage[Size];
+    };
+
+    static Chunk *&
+    head()
+    {
+        thread_local Chunk *list = nullptr;
+        return list;
+    }
+
+  public:
+    static void *
+    allocate()
+    {
+        Chunk *&list = head();
+        if (Chunk *chunk = list) {
+            list = chunk->next;
+            return chunk;
+        }
+        return ::operator new(sizeof(Chunk));
+    }
+
+    static void
+    deallocate(void *ptr)
+    {
+        if (!ptr)
+            return;
+        Chunk *chunk = static_cast<Chunk *>(ptr);
+        Chunk *&list = head();
+        chunk->next = list;
+        list = chunk;
+    }
+};
+
+/**
+ * A standard allocator which serves single objects from the FreeListPool
+ * for their size. Its main use is with std::allocate_shared, where the
+ * object and its reference count share one pooled chunk.
+ */
+template <class T>
+class PoolAllocator
+{
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+            "PoolAllocator doesn't support over-aligned types");
+
+  public:
+    typedef T value_type;
+
+    PoolAllocator() = default;
+    template <class U> PoolAllocator(const PoolAllocator<U> &) {}
+
+    T *
+    allocate(std::size_t n)
+    {
+        if (n == 1)
+            return static_cast<T *>(FreeListPool<sizeof(T)>::allocate());
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void
+    deallocate(T *ptr, std::size_t n)
+    {
+        if (n == 1)
+            FreeListPool<sizeof(T)>::deallocate(ptr);
+        else
+            ::operator delete(ptr);
+    }
+
+    template <class U>
+    bool operator==(const PoolAllocator<U> &) const { return true; }
+    template <class U>
+    bool operator!=(const PoolAllocator<U> &) const { return false; }
+};
+
+} // namespace gem5
+
+#endif // __BASE_POOL_ALLOCATOR_HH__
@@ -0,0 +1,92 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/pool_allocator.hh"
+
+using namespace gem5;
+
+TEST(FreeListPoolTest, RecyclesChunks)
+{
+    typedef FreeListPool<48> Pool;
+    void *a = Pool::allocate();
+    void *b = Pool::allocate();
+    EXPECT_NE(a, b);
+
+    // Freed chunks are handed out again, most recently freed first.
+    Pool::deallocate(a);
+    Pool::deallocate(b);
+    EXPECT_EQ(b, Pool::allocate());
+    EXPECT_EQ(a, Pool::allocate());
+    Pool::deallocate(a);
+    Pool::deallocate(b);
+}
+
+TEST(FreeListPoolTest, Alignment)
+{
+    typedef FreeListPool<3> Pool;
+    std::vector<void *> chunks;
+    for (int i = 0; i < 16; i++) {
+        chunks.push_back(Pool::allocate());
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(chunks.back()) %
+                alignof(std::max_align_t));
+    }
+    for (void *chunk : chunks)
+        Pool::deallocate(chunk);
+}
+
+TEST(PoolAllocatorTest, AllocateShared)
+{
+    std::weak_ptr<std::vector<int>> weak;
+    {
+        auto ptr = std::allocate_shared<std::vector<int>>(
+                PoolAllocator<std::vector<int>>(), 4, 7);
+        weak = ptr;
+        EXPECT_EQ(4u, ptr->size());
+        EXPECT_EQ(7, ptr->back());
+    }
+    EXPECT_TRUE(weak.expired());
+
+    // The control block and object are returned to the pool and reused.
+    auto first = std::allocate_shared<int>(PoolAllocator<int>(), 1);
+    int *addr = first.get();
+    first.reset();
+    auto second = std::allocate_shared<int>(PoolAllocator<int>(), 2);
+    EXPECT_EQ(addr, second.get());
+}
+
+TEST(PoolAllocatorTest, Arrays)
+{
+    PoolAllocator<int> alloc;
+    int *array = alloc.allocate(8);
+    for (int i = 0; i < 8; i++)
+        array[i] = i;
+    EXPECT_EQ(7, array[7]);
+    alloc.deallocate(array, 8);
+}
@@ -41,8 +41,10 @@
 #ifndef __BASE_SAT_COUNTER_HH__
 #define __BASE_SAT_COUNTER_HH__
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <vector>
 
 #include "base/logging.hh"
 #include "base/types.hh"
@@ -303,6 +305,16 @@ class GenericSatCounter
      */
     void reset() { counter = initialVal; }
 
+    /**
+     * Set the counter to a given value, e.g., when restoring it from a
+     * checkpoint. Values above the maximum saturate the counter.
+     *
+     * @param value The new value of the counter.
+     *
+     * @ingroup api_sat_counter
+     */
+    void set(T value) { counter = std::min(value, maxVal); }
+
     /**
      * Calculate saturation percentile of the current counter's value
      * with regard to its maximum possible value.
@@ -355,6 +367,202 @@ typedef GenericSatCounter<uint64_t> SatCounter64;
 [[deprecated("Use SatCounter8 (or variants) instead")]]
 typedef SatCounter8 SatCounter;
 
+/**
+ * A table of saturating counters that share their width and initial
+ * value, e.g., the pattern tables of branch predictors. Rather than a
+ * vector of SatCounter8, which keeps the maximum and initial values in
+ * every counter, the counters are packed into 64 bit words. Each counter
+ * takes a slot of the next power of two bits, 1, 2, 4 or 8, so that it
+ * never straddles two words and is found with shifts only: 2 bit counters
+ * are fully packed and 3 bit ones take 4 bits.
+ *
+ * The width can be fixed at compile time with the Bits parameter, so that
+ * the index arithmetic folds into constants, or given to the constructor
+ * when Bits is 0.
+ *
+ * @tparam Bits The number of bits of the counters, or 0 to give it to the
+ *              constructor.
+ *
+ * @ingroup api_sat_counter
+ */
+template <unsigned Bits = 0>
+class SatCounterArray
+{
+    static_assert(Bits <= 8, "Number of bits exceeds counter size");
+
+  public:
+    /**
+     * A reference to a counter of the table, with the operators of a
+     * saturating counter.
+     */
+    class Reference
+    {
+      public:
+        Reference(SatCounterArray &_array, size_t _index)
+            : array(_array), index(_index)
+        {}
+
+        operator uint8_t() const { return array.read(index); }
+
+        Reference &
+        operator++()
+        {
+            array.increment(index);
+            return *this;
+        }
+
+        uint8_t
+        operator++(int)
+        {
+            uint8_t old_value = *this;
+            array.increment(index);
+            return old_value;
+        }
+
+        Reference &
+        operator--()
+        {
+            array.decrement(index);
+            return *this;
+        }
+
+        uint8_t
+        operator--(int)
+        {
+            uint8_t old_value = *this;
+            array.decrement(index);
+            return old_value;
+        }
+
+        void set(uint8_t value) { array.set(index, value); }
+        void reset() { array.reset(index); }
+        bool isSaturated() const { return array.isSaturated(index); }
+
+      private:
+        SatCounterArray &array;
+        const size_t index;
+    };
+
+    /**
+     * Constructor of the table.
+     *
+     * @param size Number of counters.
+     * @param bits How many bits the counters have, must match Bits unless
+     *             it is 0.
+     * @param initial_val Starting value of the counters.
+     *
+     * @ingroup api_sat_counter
+     */
+    SatCounterArray(size_t size, unsigned bits, uint8_t initial_val = 0)
+        : numCounters(size), slotShift(slotShiftFor(Bits ? Bits : bits)),
+          initialVal(initial_val), maxVal((1ULL << bits) - 1)
+    {
+        fatal_if(bits > 8, "Number of bits exceeds counter size");
+        fatal_if(Bits && bits != Bits,
+                 "Number of bits does not match the counter table");
+        fatal_if(initial_val > maxVal,
+                 "Saturating counter's initial value exceeds max value.");
+
+        const uint64_t word = replicate(initialVal);
+        words.assign((size + perWord() - 1) / perWord(), word);
+    }
+
+    /** Number of counters in the table. */
+    size_t size() const { return numCounters; }
+
+    /** Read the value of a counter. */
+    uint8_t
+    read(size_t i) const
+    {
+        assert(i < numCounters);
+        return (words[wordIndex(i)] >> bitIndex(i)) & slotMask();
+    }
+
+    uint8_t operator[](size_t i) const { return read(i); }
+    Reference operator[](size_t i) { return Reference(*this, i); }
+
+    /** Increment a counter, unless it is saturated. */
+    void
+    increment(size_t i)
+    {
+        if (read(i) < maxVal)
+            words[wordIndex(i)] += 1ULL << bitIndex(i);
+    }
+
+    /** Decrement a counter, unless it is zero. */
+    void
+    decrement(size_t i)
+    {
+        if (read(i) > 0)
+            words[wordIndex(i)] -= 1ULL << bitIndex(i);
+    }
+
+    /**
+     * Set a counter to a given value, e.g., when restoring it from a
+     * checkpoint. Values above the maximum saturate the counter.
+     */
+    void
+    set(size_t i, uint8_t value)
+    {
+        assert(i < numCounters);
+        const uint64_t v = std::min(value, maxVal);
+        uint64_t &word = words[wordIndex(i)];
+        word = (word & ~(uint64_t(slotMask()) << bitIndex(i))) |
+               (v << bitIndex(i));
+    }
+
+    /** Reset a counter to the initial value. */
+    void reset(size_t i) { set(i, initialVal); }
+
+    /** Reset all the counters to the initial value. */
+    void
+    reset()
+    {
+        std::fill(words.begin(), words.end(), replicate(initialVal));
+    }
+
+    /** Whether a counter has reached the maximum value. */
+    bool isSaturated(size_t i) const { return read(i) == maxVal; }
+
+  private:
+    static constexpr unsigned
+    slotShiftFor(unsigned bits)
+    {
+        return bits <= 1 ? 0 : bits <= 2 ? 1 : bits <= 4 ? 2 : 3;
+    }
+
+    /** log2 of the bits of a slot, constant when Bits is given */
+    unsigned
+    shift() const
+    {
+        if constexpr (Bits != 0)
+            return slotShiftFor(Bits);
+        else
+            return slotShift;
+    }
+
+    unsigned perWord() const { return 64 >> shift(); }
+    uint8_t slotMask() const { return (1U << (1U << shift())) - 1; }
+    size_t wordIndex(size_t i) const { return i >> (6 - shift()); }
+    unsigned bitIndex(size_t i) const { return (i << shift()) & 63; }
+
+    /** A word with every slot set to value */
+    uint64_t
+    replicate(uint8_t value) const
+    {
+        uint64_t word = 0;
+        for (unsigned slot = 0; slot < perWord(); slot++)
+            word |= uint64_t(value) << (slot << shift());
+        return word;
+    }
+
+    const size_t numCounters;
+    const unsigned slotShift;
+    const uint8_t initialVal;
+    const uint8_t maxVal;
+    std::vector<uint64_t> words;
+};
+
 } // namespace gem5
 
 #endif // __BASE_SAT_COUNTER_HH__
@@ -149,6 +149,29 @@ TEST(SatCounterTest, Saturate)
     ASSERT_TRUE(counter.isSaturated());
 }
 
+/**
+ * Test setting the counter to arbitrary values.
+ */
+TEST(SatCounterTest, Set)
+{
+    const unsigned bits = 3;
+    const unsigned max_value = (1 << bits) - 1;
+    SatCounter8 counter(bits, 2);
+
+    counter.set(5);
+    ASSERT_EQ(counter, 5);
+    counter.set(0);
+    ASSERT_EQ(counter, 0);
+
+    // Values above the maximum saturate the counter
+    counter.set(max_value + 3);
+    ASSERT_TRUE(counter.isSaturated());
+
+    // The initial value is not affected
+    counter.reset();
+    ASSERT_EQ(counter, 2);
+}
+
 /**
  * Test back and forth against an int.
  */
@@ -513,3 +536,79 @@ TEST(SatCounterTest, Size64)
     counter_64 >>= 1;
     ASSERT_EQ(counter_64, 0);
 }
+
+/**
+ * Test that the counters of a table saturate like SatCounter8, for every
+ * width and without disturbing their neighbours in the same word.
+ */
+TEST(SatCounterArrayTest, MatchesSatCounter)
+{
+    for (unsigned bits = 1; bits <= 8; bits++) {
+        const size_t size = 100;
+        SatCounterArray<> table(size, bits, 1);
+        std::vector<SatCounter8> counters(size, SatCounter8(bits, 1));
+        ASSERT_EQ(table.size(), size);
+
+        for (int step = 0; step < 2000; step++) {
+            const size_t i = (step * 37 + step / 7) % size;
+            if ((step / 3 + i) % 5 < 3) {
+                table[i]++;
+                counters[i]++;
+            } else {
+                table[i]--;
+                counters[i]--;
+            }
+            for (size_t j = 0; j < size; j++) {
+                ASSERT_EQ(table[j], (uint8_t)counters[j]);
+                ASSERT_EQ(table[j].isSaturated(), counters[j].isSaturated());
+            }
+        }
+    }
+}
+
+/** Test setting and resetting the counters of a table. */
+TEST(SatCounterArrayTest, SetReset)
+{
+    SatCounterArray<3> table(70, 3, 2);
+    table[65].set(5);
+    ASSERT_EQ(table[65], 5);
+    table.set(3, 200);
+    ASSERT_EQ(table[3], 7);
+    ASSERT_EQ(table[2], 2);
+    ASSERT_EQ(table[4], 2);
+
+    table[65].reset();
+    ASSERT_EQ(table[65], 2);
+    table.reset();
+    ASSERT_EQ(table[3], 2);
+}
+
+/** Test the pre and post operators of the counter references. */
+TEST(SatCounterArrayTest, PrePostOperators)
+{
+    SatCounterArray<2> table(10, 2);
+    ASSERT_EQ(table[0]++, 0);
+    ASSERT_EQ(++table[0], 2);
+    ASSERT_EQ(++table[0], 3);
+    ASSERT_EQ(++table[0], 3);
+    ASSERT_EQ(table[0]--, 3);
+    ASSERT_EQ(--table[0], 1);
+    ASSERT_EQ(table[1], 0);
+}
+
+/**
+ * Test that an error is triggered when the initial value of a table is
+ * higher than the maximum value of its counters.
+ */
+TEST(SatCounterArrayDeathTest, InitialValueExceeds)
+{
+#ifdef NDEBUG
+    GTEST_SKIP() << "Skipping as assertions are "
+        "stripped out of fast builds";
+#endif
+
+    gtestLogOutput.str("");
+    EXPECT_ANY_THROW(SatCounterArray<> table(4, 2, 4));
+    ASSERT_NE(gtestLogOutput.str().find("Saturating counter's initial value "
+        "exceeds max value."), std::string::npos);
+}
@@ -249,6 +249,12 @@ Formula::str() const
     return root ? root->str() : "";
 }
 
+bool
+Formula::changed() const
+{
+    return root ? root->changed() : false;
+}
+
 Handler resetHandler = NULL;
 Handler dumpHandler = NULL;
 
@@ -815,6 +815,17 @@ class ScalarProxy
      */
     Result result() const { return stat.data(index)->result(); }
 
+    /**
+     * Check if the parent vector changed since the previous dump.
+     * @return true if any element of the parent vector changed.
+     */
+    bool
+    changed() const
+    {
+        const Stat &parent = stat;
+        return parent.info()->changed();
+    }
+
   public:
     /**
      * Create and initialize this proxy, do not register it with the database.
@@ -1544,6 +1555,12 @@ class Node
      */
     virtual std::string str() const = 0;
 
+    /**
+     * Check if any stat in the subtree changed since the previous
+     * dump, see Info::changed().
+     */
+    virtual bool changed() const = 0;
+
     virtual ~Node() {};
 };
 
@@ -1574,6 +1591,8 @@ class ScalarStatNode : public Node
      *
      */
     std::string str() const { return data->name; }
+
+    bool changed() const { return data->changed(); }
 };
 
 template <class Stat>
@@ -1615,6 +1634,8 @@ class ScalarProxyNode : public Node
     {
         return proxy.str();
     }
+
+    bool changed() const { return proxy.changed(); }
 };
 
 class VectorStatNode : public Node
@@ -1630,6 +1651,8 @@ class VectorStatNode : public Node
     size_type size() const { return data->size(); }
 
     std::string str() const { return data->name; }
+
+    bool changed() const { return data->changed(); }
 };
 
 template <class T>
@@ -1644,6 +1667,7 @@ class ConstNode : public Node
     Result total() const { return vresult[0]; };
     size_type size() const { return 1; }
     std::string str() const { return std::to_string(vresult[0]); }
+    bool changed() const { return false; }
 };
 
 template <class T>
@@ -1677,6 +1701,8 @@ class ConstVectorNode : public Node
         tmp += ")";
         return tmp;
     }
+
+    bool changed() const { return false; }
 };
 
 template <class Op>
@@ -1761,6 +1787,8 @@ class UnaryNode : public Node
     {
         return OpString<Op>::str() + l->str();
     }
+
+    bool changed() const { return l->changed(); }
 };
 
 template <class Op>
@@ -1858,6 +1886,12 @@ class BinaryNode : public Node
     {
         return csprintf("(%s %s %s)", l->str(), OpString<Op>::str(), r->str());
     }
+
+    bool
+    changed() const override
+    {
+        return l->changed() || r->changed();
+    }
 };
 
 template <class Op>
@@ -1909,6 +1943,8 @@ class SumNode : public Node
     {
         return csprintf("total(%s)", l->str());
     }
+
+    bool changed() const { return l->changed(); }
 };
 
 
@@ -2160,6 +2196,52 @@ class Histogram : public DistBase<Histogram, HistStor>
     }
 };
 
+/**
+ * A histogram with log-linear buckets, suited to values spanning several
+ * orders of magnitude such as latencies. Sampling costs the same whatever
+ * the value, and the histograms of several shards merge with add().
+ * @sa Stat, DistBase, LogHistStor
+ */
+class LogHistogram : public DistBase<LogHistogram, LogHistStor>
+{
+  public:
+    LogHistogram(Group *parent = nullptr)
+        : DistBase<LogHistogram, LogHistStor>(
+                parent, nullptr, units::Unspecified::get(), nullptr)
+    {
+    }
+
+    LogHistogram(Group *parent, const char *name,
+                 const char *desc = nullptr)
+        : DistBase<LogHistogram, LogHistStor>(
+                parent, name, units::Unspecified::get(), desc)
+    {
+    }
+
+    LogHistogram(Group *parent, const char *name, const units::Base *unit,
+                 const char *desc = nullptr)
+        : DistBase<LogHistogram, LogHistStor>(parent, name, unit, desc)
+    {
+    }
+
+    /**
+     * Set the parameters of this histogram. @sa LogHistStor::Params
+     * @param max The largest value to count in a bucket.
+     * @param sub_bucket_bits Log2 of the number of buckets each power of
+     *        two is split in, which bounds the relative bucket size.
+     * @return A reference to this histogram.
+     */
+    LogHistogram &
+    init(uint64_t max, unsigned sub_bucket_bits=3)
+    {
+        LogHistStor::Params *params =
+            new LogHistStor::Params(max, sub_bucket_bits);
+        this->setParams(params);
+        this->doInit();
+        return this->self();
+    }
+};
+
 /**
  * Calculates the mean and variance of all the samples.
  * @sa DistBase, SampleStor
@@ -2394,6 +2476,8 @@ class FormulaInfoProxy : public InfoProxy<Stat, FormulaInfo>
     VCounter &value() const { return cvec; }
 
     std::string str() const { return this->s.str(); }
+
+    bool changed() const override { return this->s.changed(); }
 };
 
 template <class Stat>
@@ -2626,6 +2710,12 @@ class Formula : public DataWrapVec<Formula, FormulaInfoProxy>
     bool zero() const;
 
     std::string str() const;
+
+    /**
+     * Check if any operand changed since the previous dump.
+     * @return true if the formula needs to be re-evaluated.
+     */
+    bool changed() const;
 };
 
 class FormulaNode : public Node
@@ -2642,6 +2732,8 @@ class FormulaNode : public Node
     Result total() const { return formula.total(); }
 
     std::string str() const { return formula.str(); }
+
+    bool changed() const { return formula.changed(); }
 };
 
 /**
@@ -0,0 +1,160 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/stats/binary.hh"
+
+#include <cassert>
+#include <cstring>
+
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "sim/cur_tick.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+/** File magic, including the terminating NUL. */
+const char binaryMagic[8] = "gem5stb";
+
+/** Written in native order so a reader can detect the byte order. */
+const uint32_t byteOrderMark = 0x01020304;
+
+template <typename T>
+void
+appendRaw(std::vector<char> &buf, const T &value)
+{
+    const char *p = reinterpret_cast<const char *>(&value);
+    buf.insert(buf.end(), p, p + sizeof(value));
+}
+
+void
+padTo8(std::vector<char> &buf)
+{
+    buf.resize((buf.size() + 7) & ~size_t(7), 0);
+}
+
+} // anonymous namespace
+
+GEM5_DEPRECATED_NAMESPACE(Stats, statistics);
+namespace statistics
+{
+
+Binary::Binary()
+    : stream(nullptr), schemaId(0)
+{
+}
+
+void
+Binary::open(std::ostream &_stream)
+{
+    if (stream)
+        panic("stream already set!");
+
+    stream = &_stream;
+    if (!valid())
+        fatal("Unable to open binary statistics output\n");
+
+    stream->write(binaryMagic, sizeof(binaryMagic));
+    stream->write(reinterpret_cast<const char *>(&version), sizeof(version));
+    stream->write(reinterpret_cast<const char *>(&byteOrderMark),
+                  sizeof(byteOrderMark));
+}
+
+bool
+Binary::valid() const
+{
+    return stream != nullptr && stream->good();
+}
+
+void
+Binary::end()
+{
+    assert(valid());
+    assert(path.size() == 1);
+
+    if (entries != schema)
+        writeSchema();
+
+    std::vector<char> payload;
+    payload.reserve(2 * sizeof(uint64_t) + values.size() * sizeof(double));
+    appendRaw(payload, schemaId);
+    appendRaw(payload, uint64_t(curTick()));
+    const char *p = reinterpret_cast<const char *>(values.data());
+    payload.insert(payload.end(), p, p + values.size() * sizeof(double));
+    writeRecord(Dump, payload);
+
+    stream->flush();
+}
+
+void
+Binary::writeRecord(RecordType type, const std::vector<char> &payload)
+{
+    assert(payload.size() % 8 == 0);
+    const uint32_t reserved = 0;
+    const uint64_t length = payload.size();
+    stream->write(reinterpret_cast<const char *>(&type), sizeof(type));
+    stream->write(reinterpret_cast<const char *>(&reserved),
+                  sizeof(reserved));
+    stream->write(reinterpret_cast<const char *>(&length), sizeof(length));
+    stream->write(payload.data(), payload.size());
+}
+
+void
+Binary::writeSchema()
+{
+    const std::vector<std::string> names = columnNames();
+
+    std::vector<char> payload;
+    appendRaw(payload, ++schemaId);
+    appendRaw(payload, uint64_t(names.size()));
+    for (const auto &name : names) {
+        appendRaw(payload, uint32_t(name.size()));
+        payload.insert(payload.end(), name.begin(), name.end());
+    }
+    padTo8(payload);
+    writeRecord(Schema, payload);
+
+    schema = entries;
+}
+
+Output *
+initBinary(const std::string &filename)
+{
+    static Binary binary;
+    static bool connected = false;
+
+    if (!connected) {
+        binary.open(*simout.findOrCreate(filename, true)->stream());
+        connected = true;
+    }
+
+    return &binary;
+}
+
+} // namespace statistics
+} // namespace gem5
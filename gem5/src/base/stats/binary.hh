@@ -0,0 +1,102 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_STATS_BINARY_HH__
+#define __BASE_STATS_BINARY_HH__
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "base/compiler.hh"
+#include "base/stats/columnar.hh"
+
+namespace gem5
+{
+
+GEM5_DEPRECATED_NAMESPACE(Stats, statistics);
+namespace statistics
+{
+
+/**
+ * Columnar binary stat output.
+ *
+ * Every stat is flattened into one or more double precision columns.
+ * The column names are written once in a schema record and each dump
+ * only appends the tick and the raw values, which avoids the string
+ * formatting cost of the text output when dumping frequently. A new
+ * schema record is only emitted if the set of visited stats changes
+ * between dumps.
+ *
+ * The file starts with a 16 byte header (the magic "gem5stb\0", a
+ * format version and a byte order marker) followed by a sequence of
+ * records. Each record has a 16 byte header (a 32 bit type, 32 bits
+ * of padding and a 64 bit payload length) and a payload that is
+ * padded to a multiple of 8 bytes, so the values of a dump record can
+ * be mapped directly from a memory mapped file. See
+ * util/stats/binary.py for a reader.
+ */
+class Binary : public Columnar
+{
+  public:
+    enum RecordType : uint32_t
+    {
+        /** Column names: schema id, column count, names. */
+        Schema = 1,
+        /** Values: schema id, tick, one double per column. */
+        Dump = 2,
+    };
+
+    static constexpr uint32_t version = 1;
+
+    Binary();
+
+    Binary(const Binary &other) = delete;
+
+    void open(std::ostream &stream);
+
+  public: // Output interface
+    void end() override;
+    bool valid() const override;
+
+  protected:
+    void writeRecord(RecordType type, const std::vector<char> &payload);
+    void writeSchema();
+
+  protected:
+    std::ostream *stream;
+
+    /** Stats described by the last schema record written. */
+    std::vector<Entry> schema;
+    uint64_t schemaId;
+};
+
+Output *initBinary(const std::string &filename);
+
+} // namespace statistics
+} // namespace gem5
+
+#endif // __BASE_STATS_BINARY_HH__
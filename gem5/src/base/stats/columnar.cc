@@ -0,0 +1,234 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/stats/columnar.hh"
+
+#include <cassert>
+
+#include "base/logging.hh"
+#include "base/stats/info.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+std::string
+subName(const std::vector<std::string> &subnames, size_t i)
+{
+    if (i < subnames.size() && !subnames[i].empty())
+        return subnames[i];
+    else
+        return std::to_string(i);
+}
+
+} // anonymous namespace
+
+GEM5_DEPRECATED_NAMESPACE(Stats, statistics);
+namespace statistics
+{
+
+void
+Columnar::begin()
+{
+    prefixes.clear();
+    prefixes.emplace_back();
+    path = std::stack<size_t>();
+    path.push(0);
+
+    entries.clear();
+    values.clear();
+}
+
+void
+Columnar::beginGroup(const char *name)
+{
+    const std::string &parent = prefixes[path.top()];
+    path.push(prefixes.size());
+    if (parent.empty())
+        prefixes.emplace_back(name);
+    else
+        prefixes.emplace_back(parent + "." + name);
+}
+
+void
+Columnar::endGroup()
+{
+    assert(path.size() > 1);
+    path.pop();
+}
+
+void
+Columnar::addEntry(const Info &info, size_t columns)
+{
+    entries.push_back({ &info, path.top(), columns });
+}
+
+void
+Columnar::visit(const ScalarInfo &info)
+{
+    values.push_back(info.result());
+    addEntry(info, 1);
+}
+
+void
+Columnar::visit(const VectorInfo &info)
+{
+    const VResult &result = info.result();
+    values.insert(values.end(), result.begin(), result.end());
+    size_t columns = result.size();
+    if (info.flags.isSet(total)) {
+        values.push_back(info.total());
+        columns++;
+    }
+    addEntry(info, columns);
+}
+
+void
+Columnar::visit(const FormulaInfo &info)
+{
+    visit(static_cast<const VectorInfo &>(info));
+}
+
+void
+Columnar::appendDist(const DistData &data)
+{
+    values.push_back(data.samples);
+    values.push_back(data.sum);
+    values.push_back(data.squares);
+    values.push_back(data.min_val);
+    values.push_back(data.max_val);
+    values.push_back(data.underflow);
+    values.push_back(data.overflow);
+    // Histograms grow their bucket size at run time, so the bucket
+    // bounds are stored as values rather than in the column names.
+    values.push_back(data.min);
+    values.push_back(data.bucket_size);
+    values.insert(values.end(), data.cvec.begin(), data.cvec.end());
+}
+
+void
+Columnar::distNames(const std::string &base, const DistData &data,
+                  std::vector<std::string> &names)
+{
+    for (const char *field : { "samples", "sum", "squares", "min_value",
+                               "max_value", "underflows", "overflows",
+                               "min", "bucket_size" }) {
+        names.push_back(base + "::" + field);
+    }
+    // Buckets of uneven sizes are named after their lowest value
+    for (size_t i = 0; i < data.cvec.size(); ++i) {
+        if (data.bucket_lows.empty()) {
+            names.push_back(base + "::bucket" + std::to_string(i));
+        } else {
+            names.push_back(base + "::bucket" +
+                std::to_string((uint64_t)data.bucket_lows[i]));
+        }
+    }
+}
+
+void
+Columnar::visit(const DistInfo &info)
+{
+    const size_t start = values.size();
+    appendDist(info.data);
+    addEntry(info, values.size() - start);
+}
+
+void
+Columnar::visit(const VectorDistInfo &info)
+{
+    const size_t start = values.size();
+    for (const auto &data : info.data)
+        appendDist(data);
+    addEntry(info, values.size() - start);
+}
+
+void
+Columnar::visit(const Vector2dInfo &info)
+{
+    values.insert(values.end(), info.cvec.begin(), info.cvec.end());
+    addEntry(info, info.cvec.size());
+}
+
+void
+Columnar::visit(const SparseHistInfo &info)
+{
+    warn_once("Binary stat files only store the sample count of sparse "
+              "histograms.\n");
+    values.push_back(info.data.samples);
+    addEntry(info, 1);
+}
+
+void
+Columnar::entryNames(const Entry &entry, std::vector<std::string> &names) const
+{
+    const Info &info = *entry.info;
+    const std::string &prefix = prefixes[entry.prefix];
+    const std::string base = prefix.empty() ?
+        info.name : prefix + "." + info.name;
+    const size_t start = names.size();
+
+    if (dynamic_cast<const ScalarInfo *>(&info)) {
+        names.push_back(base);
+    } else if (auto *vector = dynamic_cast<const VectorInfo *>(&info)) {
+        for (size_t i = 0; i < vector->size(); ++i)
+            names.push_back(base + "::" + subName(vector->subnames, i));
+        if (info.flags.isSet(total))
+            names.push_back(base + "::total");
+    } else if (auto *dist = dynamic_cast<const DistInfo *>(&info)) {
+        distNames(base, dist->data, names);
+    } else if (auto *vdist = dynamic_cast<const VectorDistInfo *>(&info)) {
+        for (size_t i = 0; i < vdist->data.size(); ++i) {
+            distNames(base + "::" + subName(vdist->subnames, i),
+                      vdist->data[i], names);
+        }
+    } else if (auto *v2d = dynamic_cast<const Vector2dInfo *>(&info)) {
+        for (size_t x = 0; x < v2d->x; ++x) {
+            const std::string xbase = base + "::" + subName(v2d->subnames, x);
+            for (size_t y = 0; y < v2d->y; ++y)
+                names.push_back(xbase + "::" + subName(v2d->y_subnames, y));
+        }
+    } else if (dynamic_cast<const SparseHistInfo *>(&info)) {
+        names.push_back(base + "::samples");
+    }
+
+    panic_if(names.size() - start != entry.columns,
+             "Column count mismatch for stat '%s'.", base);
+}
+
+std::vector<std::string>
+Columnar::columnNames() const
+{
+    std::vector<std::string> names;
+    names.reserve(values.size());
+    for (const auto &entry : entries)
+        entryNames(entry, names);
+    return names;
+}
+
+} // namespace statistics
+} // namespace gem5
@@ -0,0 +1,117 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_STATS_COLUMNAR_HH__
+#define __BASE_STATS_COLUMNAR_HH__
+
+#include <stack>
+#include <string>
+#include <vector>
+
+#include "base/compiler.hh"
+#include "base/stats/output.hh"
+#include "base/stats/types.hh"
+
+namespace gem5
+{
+
+GEM5_DEPRECATED_NAMESPACE(Stats, statistics);
+namespace statistics
+{
+
+/**
+ * Base of the outputs that flatten the stats they visit into double
+ * precision columns, named after the stats.
+ *
+ * Every visit appends the columns of a stat to the values, from begin()
+ * on, and the names of the columns are only built on demand, so that
+ * flattening the same stats over and over costs no string formatting.
+ */
+class Columnar : public Output
+{
+  public:
+    void begin() override;
+
+    void beginGroup(const char *name) override;
+    void endGroup() override;
+
+    void visit(const ScalarInfo &info) override;
+    void visit(const VectorInfo &info) override;
+    void visit(const DistInfo &info) override;
+    void visit(const VectorDistInfo &info) override;
+    void visit(const Vector2dInfo &info) override;
+    void visit(const FormulaInfo &info) override;
+    void visit(const SparseHistInfo &info) override;
+
+    /** Values of the stats visited since begin(). */
+    const std::vector<double> &columns() const { return values; }
+
+    /** Names of the columns of the stats visited since begin(). */
+    std::vector<std::string> columnNames() const;
+
+  protected:
+    /** A stat visited during a dump and the columns it produced. */
+    struct Entry
+    {
+        const Info *info;
+        /** Index into prefixes of the group containing the stat. */
+        size_t prefix;
+        size_t columns;
+
+        bool
+        operator==(const Entry &other) const
+        {
+            return info == other.info && prefix == other.prefix &&
+                columns == other.columns;
+        }
+    };
+
+    /** Record that the last columns values belong to info. */
+    void addEntry(const Info &info, size_t columns);
+
+    void appendDist(const DistData &data);
+
+    /** Column names for the distribution columns added by appendDist. */
+    static void distNames(const std::string &base, const DistData &data,
+                          std::vector<std::string> &names);
+
+    /** Column names produced by a single entry. */
+    void entryNames(const Entry &entry,
+                    std::vector<std::string> &names) const;
+
+  protected:
+    /** Full names of the groups visited in this dump. */
+    std::vector<std::string> prefixes;
+    std::stack<size_t> path;
+
+    /** Stats and values visited in the current dump. */
+    std::vector<Entry> entries;
+    std::vector<double> values;
+};
+
+} // namespace statistics
+} // namespace gem5
+
+#endif // __BASE_STATS_COLUMNAR_HH__
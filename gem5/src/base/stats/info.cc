@@ -41,7 +41,9 @@
 
 #include "base/stats/info.hh"
 
+#include <algorithm>
 #include <cctype>
+#include <cmath>
 
 #include "base/cprintf.hh"
 #include "base/debug.hh"
@@ -196,6 +198,93 @@ Info::enable()
 {
 }
 
+void
+Info::updateChanged()
+{
+    VCounter values;
+    if (!snapshot(values)) {
+        _changed = true;
+        return;
+    }
+
+    // NaN results (e.g., 0/0 averages) are not considered changes
+    auto same = [](Counter a, Counter b) {
+        return a == b || (std::isnan(a) && std::isnan(b));
+    };
+    _changed = !hasSnapshot ||
+        !std::equal(values.begin(), values.end(),
+                    lastSnapshot.begin(), lastSnapshot.end(), same);
+
+    lastSnapshot.swap(values);
+    hasSnapshot = true;
+}
+
+bool
+ScalarInfo::snapshot(VCounter &values) const
+{
+    values.assign(1, result());
+    return true;
+}
+
+bool
+VectorInfo::snapshot(VCounter &values) const
+{
+    const VResult &res = result();
+    values.assign(res.begin(), res.end());
+    return true;
+}
+
+namespace
+{
+
+void
+appendDistData(const DistData &data, VCounter &values)
+{
+    values.insert(values.end(), { data.samples, data.sum, data.squares,
+                                  data.underflow, data.overflow,
+                                  data.min_val, data.max_val,
+                                  data.bucket_size });
+    values.insert(values.end(), data.cvec.begin(), data.cvec.end());
+}
+
+} // anonymous namespace
+
+bool
+DistInfo::snapshot(VCounter &values) const
+{
+    values.clear();
+    appendDistData(data, values);
+    return true;
+}
+
+bool
+VectorDistInfo::snapshot(VCounter &values) const
+{
+    values.clear();
+    for (const auto &d : data)
+        appendDistData(d, values);
+    return true;
+}
+
+bool
+Vector2dInfo::snapshot(VCounter &values) const
+{
+    values = cvec;
+    return true;
+}
+
+bool
+SparseHistInfo::snapshot(VCounter &values) const
+{
+    values.clear();
+    values.push_back(data.samples);
+    for (const auto &entry : data.cmap) {
+        values.push_back(entry.first);
+        values.push_back(entry.second);
+    }
+    return true;
+}
+
 void
 VectorInfo::enable()
 {
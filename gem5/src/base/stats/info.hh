@@ -104,6 +104,22 @@ class Info
   private:
     std::unique_ptr<const StorageParams> storageParams;
 
+    /** Values of the stat at the previous call to updateChanged(). */
+    VCounter lastSnapshot;
+    bool hasSnapshot = false;
+    bool _changed = true;
+
+  protected:
+    /**
+     * Store the current values of the stat in a flat vector. Used by
+     * updateChanged() to detect changes between dumps.
+     *
+     * @param values Vector to store the values in.
+     * @return false if the stat can't be snapshotted, in which case it
+     * is always reported as changed.
+     */
+    virtual bool snapshot(VCounter &values) const { return false; }
+
   public:
     Info();
     virtual ~Info();
@@ -162,6 +178,18 @@ class Info
      */
     virtual void visit(Output &visitor) = 0;
 
+    /**
+     * Compare the stat with its values at the previous call and
+     * update changed(). This is called once per dump, after prepare().
+     */
+    void updateChanged();
+
+    /**
+     * @return true if the stat changed between the two most recent
+     * calls to updateChanged(), i.e., since the previous dump.
+     */
+    virtual bool changed() const { return _changed; }
+
     /**
      * Checks if the first stat's name is alphabetically less than the second.
      * This function breaks names up at periods and considers each subname
@@ -179,6 +207,9 @@ class ScalarInfo : public Info
     virtual Counter value() const = 0;
     virtual Result result() const = 0;
     virtual Result total() const = 0;
+
+  protected:
+    bool snapshot(VCounter &values) const override;
 };
 
 class VectorInfo : public Info
@@ -196,6 +227,9 @@ class VectorInfo : public Info
     virtual const VCounter &value() const = 0;
     virtual const VResult &result() const = 0;
     virtual Result total() const = 0;
+
+  protected:
+    bool snapshot(VCounter &values) const override;
 };
 
 class DistInfo : public Info
@@ -203,6 +237,9 @@ class DistInfo : public Info
   public:
     /** Local storage for the entry values, used for printing. */
     DistData data;
+
+  protected:
+    bool snapshot(VCounter &values) const override;
 };
 
 class VectorDistInfo : public Info
@@ -221,6 +258,9 @@ class VectorDistInfo : public Info
 
   public:
     virtual size_type size() const = 0;
+
+  protected:
+    bool snapshot(VCounter &values) const override;
 };
 
 class Vector2dInfo : public Info
@@ -240,12 +280,22 @@ class Vector2dInfo : public Info
     void enable();
 
     virtual Result total() const = 0;
+
+  protected:
+    bool snapshot(VCounter &values) const override;
 };
 
 class FormulaInfo : public VectorInfo
 {
   public:
     virtual std::string str() const = 0;
+
+  protected:
+    /**
+     * Formulas derive changed() from their operands instead, which
+     * avoids evaluating them.
+     */
+    bool snapshot(VCounter &values) const override { return false; }
 };
 
 class SparseHistInfo : public Info
@@ -253,6 +303,9 @@ class SparseHistInfo : public Info
   public:
     /** Local storage for the entry values, used for printing. */
     SparseHistData data;
+
+  protected:
+    bool snapshot(VCounter &values) const override;
 };
 
 typedef std::map<std::string, Info *> NameMapType;
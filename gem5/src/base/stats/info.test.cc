@@ -29,6 +29,8 @@
 #include <gtest/gtest-spi.h>
 #include <gtest/gtest.h>
 
+#include <cmath>
+
 #include "base/stats/info.hh"
 
 using namespace gem5;
@@ -47,6 +49,21 @@ class TestInfo : public statistics::Info
     void visit(statistics::Output &visitor) override {}
 };
 
+class TestScalarInfo : public statistics::ScalarInfo
+{
+  public:
+    statistics::Counter val = 0;
+
+    statistics::Counter value() const override { return val; }
+    statistics::Result result() const override { return val; }
+    statistics::Result total() const override { return val; }
+    bool check() const override { return true; }
+    void prepare() override {}
+    void reset() override { val = 0; }
+    bool zero() const override { return val == 0; }
+    void visit(statistics::Output &visitor) override {}
+};
+
 /** Test that a name is properly assigned under the new style. */
 TEST(StatsInfoTest, NameNewStyle)
 {
@@ -320,3 +337,41 @@ TEST(StatsInfoDeathTest, BaseCheckDisplayNoName)
     info.flags.set(statistics::init | statistics::display);
     ASSERT_ANY_THROW(info.baseCheck());
 }
+
+/** Test that stats without a snapshot are always reported as changed. */
+TEST(StatsInfoTest, ChangedNoSnapshot)
+{
+    TestInfo info;
+    ASSERT_TRUE(info.changed());
+    info.updateChanged();
+    ASSERT_TRUE(info.changed());
+    info.updateChanged();
+    ASSERT_TRUE(info.changed());
+}
+
+/** Test that changes are only reported between updateChanged() calls. */
+TEST(StatsInfoTest, ChangedScalar)
+{
+    TestScalarInfo info;
+    ASSERT_TRUE(info.changed());
+
+    // The first update is always a change
+    info.updateChanged();
+    ASSERT_TRUE(info.changed());
+    info.updateChanged();
+    ASSERT_FALSE(info.changed());
+
+    info.val = 3;
+    ASSERT_FALSE(info.changed());
+    info.updateChanged();
+    ASSERT_TRUE(info.changed());
+    info.updateChanged();
+    ASSERT_FALSE(info.changed());
+
+    // NaN results compare equal to themselves
+    info.val = std::nan("");
+    info.updateChanged();
+    ASSERT_TRUE(info.changed());
+    info.updateChanged();
+    ASSERT_FALSE(info.changed());
+}
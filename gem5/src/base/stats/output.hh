@@ -69,6 +69,8 @@ struct Output
     virtual void begin() = 0;
     virtual void end() = 0;
     virtual bool valid() const = 0;
+    /** Wait for the dumps written in the background, if any. */
+    virtual void flush() {}
 
     virtual void beginGroup(const char *name) = 0;
     virtual void endGroup() = 0;
@@ -0,0 +1,104 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "base/stats/storage.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/**
+ * Latency like samples: mostly short, with a long tail, which makes the
+ * histograms grow their buckets during the warmup.
+ */
+std::vector<Counter>
+latencies()
+{
+    std::mt19937 gen(1);
+    std::lognormal_distribution<double> dist(4.0, 1.5);
+    std::vector<Counter> samples(4096);
+    for (auto &sample : samples)
+        sample = static_cast<Counter>(dist(gen));
+    return samples;
+}
+
+/** The sampling of a stat, e.g. Histogram::sample, on its storage. */
+template <class Stor>
+void
+sample(benchmark::State &state, const statistics::StorageParams &params)
+{
+    Stor stor(&params);
+    const auto samples = latencies();
+
+    size_t i = 0;
+    for (auto _ : state) {
+        stor.sample(samples[i], 1);
+        benchmark::DoNotOptimize(stor);
+        i = (i + 1) % samples.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void
+BM_HistStorSample(benchmark::State &state)
+{
+    sample<statistics::HistStor>(state,
+        statistics::HistStor::Params(state.range(0)));
+}
+
+void
+BM_DistStorSample(benchmark::State &state)
+{
+    sample<statistics::DistStor>(state,
+        statistics::DistStor::Params(0, 1000, 10));
+}
+
+void
+BM_LogHistStorSample(benchmark::State &state)
+{
+    sample<statistics::LogHistStor>(state,
+        statistics::LogHistStor::Params(1ULL << 20, state.range(0)));
+}
+
+void
+BM_SampleStorSample(benchmark::State &state)
+{
+    sample<statistics::SampleStor>(state, statistics::SampleStor::Params());
+}
+
+} // anonymous namespace
+
+BENCHMARK(BM_HistStorSample)->Arg(10)->Arg(100);
+BENCHMARK(BM_DistStorSample);
+BENCHMARK(BM_LogHistStorSample)->Arg(2)->Arg(4);
+BENCHMARK(BM_SampleStorSample);
+
+BENCHMARK_MAIN();
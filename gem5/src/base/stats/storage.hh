@@ -30,8 +30,10 @@
 #ifndef __BASE_STATS_STORAGE_HH__
 #define __BASE_STATS_STORAGE_HH__
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
 
 #include "base/cast.hh"
 #include "base/compiler.hh"
@@ -553,6 +555,223 @@ class HistStor
     }
 };
 
+/**
+ * Templatized storage for a histogram with log-linear buckets, as in HDR
+ * histograms: values below 2^s have a bucket each, and every following
+ * power of two range is split in 2^s buckets, so that the relative size
+ * of a bucket never exceeds 2^-s. The bucket of a value is computed from
+ * its most significant bit, without divisions, and the bucket layout
+ * only depends on s and the maximum value, so that the storages of
+ * several shards of a histogram merge by adding their buckets.
+ *
+ * Negative samples count as underflows and the samples beyond the last
+ * bucket as overflows. Fractional samples fall in the bucket of their
+ * integer part.
+ */
+class LogHistStor
+{
+  private:
+    /** Number of bits of the sub-buckets of a power of two, s. */
+    unsigned subBucketBits;
+    /** The end of the last bucket. */
+    Counter bucketsEnd;
+
+    /** The smallest value sampled. */
+    Counter min_val;
+    /** The largest value sampled. */
+    Counter max_val;
+    /** The number of values less than zero. */
+    Counter underflow;
+    /** The number of values beyond the last bucket. */
+    Counter overflow;
+    /** The current sum. */
+    Counter sum;
+    /** The sum of squares. */
+    Counter squares;
+    /** The number of samples. */
+    Counter samples;
+    /** Counter for each bucket. */
+    VCounter cvec;
+
+  public:
+    /**
+     * The bucket of a value.
+     *
+     * @param val A value.
+     * @param sub_bucket_bits Number of bits of the sub-buckets, s.
+     * @return The index of the bucket.
+     */
+    static uint64_t
+    bucketIndex(uint64_t val, unsigned sub_bucket_bits)
+    {
+        // Values below 2^s keep a shift of 0 and are their own bucket
+        const unsigned msb = 63 - __builtin_clzll(val | 1);
+        const unsigned shift =
+            (msb > sub_bucket_bits ? msb : sub_bucket_bits) -
+            sub_bucket_bits;
+        return ((uint64_t)shift << sub_bucket_bits) + (val >> shift);
+    }
+
+    /**
+     * The lowest value of a bucket.
+     *
+     * @param idx The index of the bucket.
+     * @param sub_bucket_bits Number of bits of the sub-buckets, s.
+     * @return The lowest value falling in the bucket.
+     */
+    static uint64_t
+    bucketLow(uint64_t idx, unsigned sub_bucket_bits)
+    {
+        const uint64_t sub_buckets = 1ULL << sub_bucket_bits;
+        if (idx < sub_buckets)
+            return idx;
+        const unsigned shift = (idx >> sub_bucket_bits) - 1;
+        return (sub_buckets | (idx & (sub_buckets - 1))) << shift;
+    }
+
+    /** The parameters for a log-linear histogram stat. */
+    struct Params : public DistParams
+    {
+        /** Number of bits of the sub-buckets of a power of two. */
+        unsigned subBucketBits;
+        /** The number of buckets. */
+        size_type buckets;
+        /** The lowest value of each bucket, and the end of the last. */
+        VCounter lows;
+
+        Params(uint64_t max, unsigned sub_bucket_bits)
+          : DistParams(LogHist), subBucketBits(sub_bucket_bits)
+        {
+            fatal_if(sub_bucket_bits < 1 || sub_bucket_bits > 16,
+                "A log histogram needs 1 to 16 sub-bucket bits");
+            fatal_if(max > (1ULL << 48),
+                "The maximum value of a log histogram must be at most "
+                "2^48");
+            buckets = bucketIndex(max, sub_bucket_bits) + 1;
+            lows.resize(buckets + 1);
+            for (size_type i = 0; i <= buckets; ++i)
+                lows[i] = bucketLow(i, sub_bucket_bits);
+        }
+    };
+
+    LogHistStor(const StorageParams* const storage_params)
+        : subBucketBits(
+              safe_cast<const Params *>(storage_params)->subBucketBits),
+          bucketsEnd(safe_cast<const Params *>(storage_params)->lows.back()),
+          cvec(safe_cast<const Params *>(storage_params)->buckets)
+    {
+        reset(storage_params);
+    }
+
+    /**
+     * Add the contents of the storage of another shard of the same
+     * histogram to this storage.
+     * @param other The other storage to be added.
+     */
+    void
+    add(LogHistStor *other)
+    {
+        assert(size() == other->size());
+        assert(subBucketBits == other->subBucketBits);
+
+        min_val = std::min(min_val, other->min_val);
+        max_val = std::max(max_val, other->max_val);
+        underflow += other->underflow;
+        overflow += other->overflow;
+        sum += other->sum;
+        squares += other->squares;
+        samples += other->samples;
+        for (size_type i = 0; i < size(); ++i)
+            cvec[i] += other->cvec[i];
+    }
+
+    /**
+     * Add a value to the distribution for the given number of times.
+     * @param val The value to add.
+     * @param number The number of times to add the value.
+     */
+    void
+    sample(Counter val, int number)
+    {
+        if (val < 0)
+            underflow += number;
+        else if (val >= bucketsEnd)
+            overflow += number;
+        else
+            cvec[bucketIndex(val, subBucketBits)] += number;
+
+        if (val < min_val)
+            min_val = val;
+        if (val > max_val)
+            max_val = val;
+
+        sum += val * number;
+        squares += val * val * number;
+        samples += number;
+    }
+
+    /**
+     * Return the number of buckets in this distribution.
+     * @return the number of buckets.
+     */
+    size_type size() const { return cvec.size(); }
+
+    /**
+     * Returns true if any calls to sample have been made.
+     * @return True if any values have been sampled.
+     */
+    bool
+    zero() const
+    {
+        return samples == Counter();
+    }
+
+    void
+    prepare(const StorageParams* const storage_params, DistData &data)
+    {
+        const Params *params = safe_cast<const Params *>(storage_params);
+
+        assert(params->type == LogHist);
+        data.type = params->type;
+        data.min = 0;
+        data.max = params->lows.back() - 1;
+        data.bucket_size = 0;
+        data.bucket_lows.assign(params->lows.begin(),
+                                params->lows.end() - 1);
+
+        data.min_val = (min_val == CounterLimits::max()) ? 0 : min_val;
+        data.max_val = (max_val == CounterLimits::lowest()) ? 0 : max_val;
+
+        data.cvec = cvec;
+        data.underflow = underflow;
+        data.overflow = overflow;
+        data.sum = sum;
+        data.squares = squares;
+        data.logs = Counter();
+        data.samples = samples;
+    }
+
+    /**
+     * Reset stat value to default
+     */
+    void
+    reset(const StorageParams* const storage_params)
+    {
+        min_val = CounterLimits::max();
+        max_val = CounterLimits::lowest();
+        underflow = Counter();
+        overflow = Counter();
+
+        size_type size = cvec.size();
+        for (off_type i = 0; i < size; ++i)
+            cvec[i] = Counter();
+
+        sum = Counter();
+        squares = Counter();
+        samples = Counter();
+    }
+};
+
 /**
  * Templatized storage and interface for a distribution that calculates mean
  * and variance.
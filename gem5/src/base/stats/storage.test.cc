@@ -1214,3 +1214,106 @@ TEST(StatsSparseHistStorTest, SamplePrepare)
     }
     ASSERT_EQ(data.samples, total_samples);
 }
+
+/** Test that the log histogram parameters are checked. */
+TEST(StatsLogHistStorDeathTest, BadSubBucketBits)
+{
+    EXPECT_ANY_THROW(statistics::LogHistStor::Params params(1024, 0));
+    EXPECT_ANY_THROW(statistics::LogHistStor::Params params(1024, 17));
+}
+
+/**
+ * Test that the buckets of the log histogram are contiguous, and that each
+ * value falls in the bucket whose range contains it.
+ */
+TEST(StatsLogHistStorTest, BucketIndex)
+{
+    for (unsigned bits = 1; bits <= 4; bits++) {
+        for (uint64_t idx = 0; idx < (40 - bits) << bits; idx++) {
+            const uint64_t low = statistics::LogHistStor::bucketLow(idx, bits);
+            const uint64_t next =
+                statistics::LogHistStor::bucketLow(idx + 1, bits);
+            ASSERT_LT(low, next);
+            ASSERT_EQ(statistics::LogHistStor::bucketIndex(low, bits), idx);
+            ASSERT_EQ(statistics::LogHistStor::bucketIndex(next - 1, bits),
+                      idx);
+            // The size of a bucket is bounded relatively to its values
+            ASSERT_LE((next - low) << bits,
+                      std::max<uint64_t>(low, 1ULL << bits));
+        }
+    }
+}
+
+/** Test sampling values in the log histogram. */
+TEST(StatsLogHistStorTest, SamplePrepare)
+{
+    statistics::LogHistStor::Params params(1000, 2);
+    statistics::LogHistStor stor(&params);
+    statistics::DistData data;
+
+    ASSERT_TRUE(stor.zero());
+    stor.sample(0, 1);
+    stor.sample(5, 2);
+    stor.sample(5.5, 1);
+    stor.sample(100, 3);
+    stor.sample(-1, 1);
+    stor.sample(5000, 1);
+    ASSERT_FALSE(stor.zero());
+
+    stor.prepare(&params, data);
+    ASSERT_EQ(data.type, statistics::LogHist);
+    ASSERT_EQ(data.cvec.size(), stor.size());
+    ASSERT_EQ(data.bucket_lows.size(), stor.size());
+    ASSERT_EQ(data.bucket_size, 0);
+    ASSERT_GE(data.max, 1000);
+    ASSERT_EQ(data.samples, 9);
+    ASSERT_EQ(data.underflow, 1);
+    ASSERT_EQ(data.overflow, 1);
+    ASSERT_EQ(data.min_val, -1);
+    ASSERT_EQ(data.max_val, 5000);
+    ASSERT_EQ(data.sum, 0 + 5 * 2 + 5.5 + 100 * 3 - 1 + 5000);
+
+    // 5 and 5.5 share the bucket [5, 5], 100 is in [96, 111]
+    ASSERT_EQ(data.cvec[0], 1);
+    ASSERT_EQ(data.cvec[5], 3);
+    const auto idx = statistics::LogHistStor::bucketIndex(100, 2);
+    ASSERT_EQ(data.bucket_lows[idx], 96);
+    ASSERT_EQ(data.cvec[idx], 3);
+
+    stor.reset(&params);
+    ASSERT_TRUE(stor.zero());
+    stor.prepare(&params, data);
+    ASSERT_EQ(data.cvec[idx], 0);
+    ASSERT_EQ(data.underflow, 0);
+    ASSERT_EQ(data.min_val, 0);
+    ASSERT_EQ(data.max_val, 0);
+}
+
+/** Test that the storages of several shards merge. */
+TEST(StatsLogHistStorTest, Add)
+{
+    statistics::LogHistStor::Params params(1 << 20, 3);
+    statistics::LogHistStor merged(&params);
+    statistics::LogHistStor shard0(&params);
+    statistics::LogHistStor shard1(&params);
+    statistics::LogHistStor all(&params);
+
+    for (int i = 0; i < 1000; i++) {
+        const statistics::Counter val = (i * 7919) % 100000;
+        (i % 2 ? shard1 : shard0).sample(val, 1);
+        all.sample(val, 1);
+    }
+    merged.add(&shard0);
+    merged.add(&shard1);
+
+    statistics::DistData merged_data;
+    statistics::DistData all_data;
+    merged.prepare(&params, merged_data);
+    all.prepare(&params, all_data);
+    ASSERT_EQ(merged_data.cvec, all_data.cvec);
+    ASSERT_EQ(merged_data.samples, all_data.samples);
+    ASSERT_EQ(merged_data.sum, all_data.sum);
+    ASSERT_EQ(merged_data.squares, all_data.squares);
+    ASSERT_EQ(merged_data.min_val, all_data.min_val);
+    ASSERT_EQ(merged_data.max_val, all_data.max_val);
+}
@@ -44,6 +44,8 @@
 
 #include "base/stats/text.hh"
 
+#include <unistd.h>
+
 #include <cassert>
 #include <cmath>
 #include <fstream>
@@ -74,7 +76,9 @@ namespace statistics
 std::list<Info *> &statsList();
 
 Text::Text()
-    : mystream(false), stream(NULL), descriptions(false), spaces(false)
+    : mystream(false), stream(NULL), writerPid(0), writerExit(false),
+      writeFailed(false), descriptions(false), spaces(false),
+      changedOnly(false)
 {
 }
 
@@ -91,6 +95,16 @@ Text::Text(const std::string &file) : Text()
 
 Text::~Text()
 {
+    // a forked child has no writer thread
+    if (writer.joinable() && getpid() == writerPid) {
+        {
+            std::lock_guard<std::mutex> lock(writerMutex);
+            writerExit = true;
+        }
+        writerReady.notify_one();
+        writer.join();
+    }
+
     if (mystream) {
         assert(stream);
         delete stream;
@@ -121,23 +135,88 @@ Text::open(const std::string &file)
         fatal("Unable to open statistics file for writing\n");
 }
 
+void
+Text::writeAsync()
+{
+    assert(stream);
+    if (writer.joinable())
+        return;
+    writerPid = getpid();
+    writer = std::thread([this]() { writeDumps(); });
+}
+
+void
+Text::writeDumps()
+{
+    std::unique_lock<std::mutex> lock(writerMutex);
+    while (true) {
+        writerReady.wait(lock, [this]() {
+            return writerExit || !pendingDumps.empty();
+        });
+        if (pendingDumps.empty())
+            return;
+
+        // the dump stays queued while it is written, so that flush()
+        // also waits for the one in progress
+        const std::string &text = pendingDumps.front();
+        lock.unlock();
+        stream->write(text.data(), text.size());
+        stream->flush();
+        const bool failed = !stream->good();
+        lock.lock();
+
+        writeFailed = failed;
+        pendingDumps.pop_front();
+        writerDone.notify_all();
+    }
+}
+
+void
+Text::flush()
+{
+    std::unique_lock<std::mutex> lock(writerMutex);
+    writerDone.wait(lock, [this]() { return pendingDumps.empty(); });
+}
+
 bool
 Text::valid() const
 {
+    // the stream state is updated by the writer, which reports it
+    if (writer.joinable() && getpid() == writerPid) {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        return !writeFailed;
+    }
     return stream != NULL && stream->good();
 }
 
 void
 Text::begin()
 {
-    ccprintf(*stream, "\n---------- Begin Simulation Statistics ----------\n");
+    dumpText.str("");
+    ccprintf(dumpText,
+             "\n---------- Begin Simulation Statistics ----------\n");
 }
 
 void
 Text::end()
 {
-    ccprintf(*stream, "\n---------- End Simulation Statistics   ----------\n");
-    stream->flush();
+    ccprintf(dumpText,
+             "\n---------- End Simulation Statistics   ----------\n");
+
+    if (writer.joinable() && getpid() == writerPid) {
+        std::unique_lock<std::mutex> lock(writerMutex);
+        writerDone.wait(lock, [this]() {
+            return pendingDumps.size() < maxPendingDumps;
+        });
+        pendingDumps.push_back(dumpText.str());
+        lock.unlock();
+        writerReady.notify_one();
+    } else {
+        const std::string text = dumpText.str();
+        stream->write(text.data(), text.size());
+        stream->flush();
+    }
+    dumpText.str("");
 }
 
 std::string
@@ -146,7 +225,7 @@ Text::statName(const std::string &name) const
     if (path.empty())
         return name;
     else
-        return csprintf("%s.%s", path.top(), name);
+        return csprintf(GEM5_FMT("%s.%s"), path.top(), name);
 }
 
 void
@@ -155,7 +234,7 @@ Text::beginGroup(const char *name)
     if (path.empty()) {
         path.push(name);
     } else {
-        path.push(csprintf("%s.%s", path.top(), name));
+        path.push(csprintf(GEM5_FMT("%s.%s"), path.top(), name));
     }
 }
 
@@ -172,6 +251,10 @@ Text::noOutput(const Info &info)
     if (!info.flags.isSet(display))
         return true;
 
+    // Checked before the prereq since it doesn't evaluate formulas
+    if (changedOnly && !info.changed())
+        return true;
+
     if (info.prereq && info.prereq->zero())
         return true;
 
@@ -232,7 +315,7 @@ struct BasePrint
     printUnits(std::ostream &stream) const
     {
         if (enableUnits && !unitStr.empty()) {
-            ccprintf(stream, " (%s)", unitStr);
+            ccprintf(stream, GEM5_FMT(" (%s)"), unitStr);
         }
     }
 };
@@ -286,25 +369,26 @@ ScalarPrint::operator()(std::ostream &stream, bool oneLine) const
     std::stringstream pdfstr, cdfstr;
 
     if (!std::isnan(pdf))
-        ccprintf(pdfstr, "%.2f%%", pdf * 100.0);
+        ccprintf(pdfstr, GEM5_FMT("%.2f%%"), pdf * 100.0);
 
     if (!std::isnan(cdf))
-        ccprintf(cdfstr, "%.2f%%", cdf * 100.0);
+        ccprintf(cdfstr, GEM5_FMT("%.2f%%"), cdf * 100.0);
 
     if (oneLine) {
-        ccprintf(stream, " |");
+        ccprintf(stream, GEM5_FMT(" |"));
     } else {
-        ccprintf(stream, "%-*s ", nameSpaces, name);
+        ccprintf(stream, GEM5_FMT("%-*s "), nameSpaces, name);
     }
-    ccprintf(stream, "%*s", valueSpaces, ValueToString(value, precision));
+    ccprintf(stream, GEM5_FMT("%*s"), valueSpaces,
+             ValueToString(value, precision));
     if (spaces || pdfstr.rdbuf()->in_avail())
-        ccprintf(stream, " %*s", pdfstrSpaces, pdfstr.str());
+        ccprintf(stream, GEM5_FMT(" %*s"), pdfstrSpaces, pdfstr.str());
     if (spaces || cdfstr.rdbuf()->in_avail())
-        ccprintf(stream, " %*s", cdfstrSpaces, cdfstr.str());
+        ccprintf(stream, GEM5_FMT(" %*s"), cdfstrSpaces, cdfstr.str());
     if (!oneLine) {
         if (descriptions) {
             if (!desc.empty())
-                ccprintf(stream, " # %s", desc);
+                ccprintf(stream, GEM5_FMT(" # %s"), desc);
         }
         printUnits(stream);
         stream << std::endl;
@@ -369,7 +453,7 @@ VectorPrint::operator()(std::ostream &stream) const
 
     if ((!flags.isSet(nozero)) || (total != 0)) {
         if (flags.isSet(oneline)) {
-            ccprintf(stream, "%-*s", nameSpaces, name);
+            ccprintf(stream, GEM5_FMT("%-*s"), nameSpaces, name);
             print.flags = print.flags & (~nozero);
         }
 
@@ -388,7 +472,7 @@ VectorPrint::operator()(std::ostream &stream) const
         if (flags.isSet(oneline)) {
             if (descriptions) {
                 if (!desc.empty())
-                    ccprintf(stream, " # %s", desc);
+                    ccprintf(stream, GEM5_FMT(" # %s"), desc);
             }
             printUnits(stream);
             stream << std::endl;
@@ -509,14 +593,17 @@ DistPrint::operator()(std::ostream &stream) const
     if (data.type == Deviation)
         return;
 
+    // The distributions with a fixed range count the values outside it
+    const bool bounded = data.type == Dist || data.type == LogHist;
+
     size_t size = data.cvec.size();
 
     Result total = 0.0;
-    if (data.type == Dist && data.underflow != Nan)
+    if (bounded && data.underflow != Nan)
         total += data.underflow;
     for (off_type i = 0; i < size; ++i)
         total += data.cvec[i];
-    if (data.type == Dist && data.overflow != Nan)
+    if (bounded && data.overflow != Nan)
         total += data.overflow;
 
     if (total) {
@@ -524,22 +611,28 @@ DistPrint::operator()(std::ostream &stream) const
         print.cdf = 0.0;
     }
 
-    if (data.type == Dist && data.underflow != Nan) {
+    if (bounded && data.underflow != Nan) {
         print.name = base + "underflows";
         print.update(data.underflow, total);
         print(stream);
     }
 
     if (flags.isSet(oneline)) {
-        ccprintf(stream, "%-*s", nameSpaces, name);
+        ccprintf(stream, GEM5_FMT("%-*s"), nameSpaces, name);
     }
 
     for (off_type i = 0; i < size; ++i) {
         std::stringstream namestr;
         namestr << base;
 
-        Counter low = i * data.bucket_size + data.min;
-        Counter high = std::min(low + data.bucket_size - 1.0, data.max);
+        Counter low, high;
+        if (data.bucket_lows.empty()) {
+            low = i * data.bucket_size + data.min;
+            high = std::min(low + data.bucket_size - 1.0, data.max);
+        } else {
+            low = data.bucket_lows[i];
+            high = i + 1 < size ? data.bucket_lows[i + 1] - 1 : data.max;
+        }
         namestr << low;
         if (low < high)
             namestr << "-" << high;
@@ -552,13 +645,13 @@ DistPrint::operator()(std::ostream &stream) const
     if (flags.isSet(oneline)) {
         if (descriptions) {
             if (!desc.empty())
-                ccprintf(stream, " # %s", desc);
+                ccprintf(stream, GEM5_FMT(" # %s"), desc);
         }
         printUnits(stream);
         stream << std::endl;
     }
 
-    if (data.type == Dist && data.overflow != Nan) {
+    if (bounded && data.overflow != Nan) {
         print.name = base + "overflows";
         print.update(data.overflow, total);
         print(stream);
@@ -567,13 +660,13 @@ DistPrint::operator()(std::ostream &stream) const
     print.pdf = Nan;
     print.cdf = Nan;
 
-    if (data.type == Dist && data.min_val != Nan) {
+    if (bounded && data.min_val != Nan) {
         print.name = base + "min_value";
         print.value = data.min_val;
         print(stream);
     }
 
-    if (data.type == Dist && data.max_val != Nan) {
+    if (bounded && data.max_val != Nan) {
         print.name = base + "max_value";
         print.value = data.max_val;
         print(stream);
@@ -597,7 +690,7 @@ Text::visit(const ScalarInfo &info)
     print.pdf = Nan;
     print.cdf = Nan;
 
-    print(*stream);
+    print(dumpText);
 }
 
 void
@@ -633,7 +726,7 @@ Text::visit(const VectorInfo &info)
         }
     }
 
-    print(*stream);
+    print(dumpText);
 }
 
 void
@@ -687,7 +780,7 @@ Text::visit(const Vector2dInfo &info)
         print.unitStr = info.unit->getUnitString();
         print.vec = yvec;
         print.total = total;
-        print(*stream);
+        print(dumpText);
     }
 
     // Create a subname for printing the total
@@ -701,7 +794,7 @@ Text::visit(const Vector2dInfo &info)
         print.unitStr = info.unit->getUnitString();
         print.vec = VResult(1, info.total());
         print.flags = print.flags & ~total;
-        print(*stream);
+        print(dumpText);
     }
 }
 
@@ -712,7 +805,7 @@ Text::visit(const DistInfo &info)
         return;
 
     DistPrint print(this, info);
-    print(*stream);
+    print(dumpText);
 }
 
 void
@@ -723,7 +816,7 @@ Text::visit(const VectorDistInfo &info)
 
     for (off_type i = 0; i < info.size(); ++i) {
         DistPrint print(this, info, i);
-        print(*stream);
+        print(dumpText);
     }
 }
 
@@ -798,11 +891,11 @@ Text::visit(const SparseHistInfo &info)
         return;
 
     SparseHistPrint print(this, info);
-    print(*stream);
+    print(dumpText);
 }
 
 Output *
-initText(const std::string &filename, bool desc, bool spaces)
+initText(const std::string &filename, bool desc, bool spaces, bool changed)
 {
     static Text text;
     static bool connected = false;
@@ -812,6 +905,8 @@ initText(const std::string &filename, bool desc, bool spaces)
         text.descriptions = desc;
         text.enableUnits = desc; // the units are printed if descs are
         text.spaces = spaces;
+        text.changedOnly = changed;
+        text.writeAsync();
         connected = true;
     }
 
@@ -41,9 +41,16 @@
 #ifndef __BASE_STATS_TEXT_HH__
 #define __BASE_STATS_TEXT_HH__
 
+#include <sys/types.h>
+
+#include <condition_variable>
+#include <deque>
 #include <iosfwd>
+#include <mutex>
+#include <sstream>
 #include <stack>
 #include <string>
+#include <thread>
 
 #include "base/compiler.hh"
 #include "base/output.hh"
@@ -63,16 +70,47 @@ class Text : public Output
     bool mystream;
     std::ostream *stream;
 
+    /**
+     * Text of the dump in progress. A dump is formatted in memory and
+     * written to the stream in one go when it ends.
+     */
+    std::ostringstream dumpText;
+
     // Object/group path
     std::stack<std::string> path;
 
+    /**
+     * Writer thread of an asynchronous output, which writes the dumps
+     * to the stream while the simulation carries on. The stats are
+     * still evaluated and formatted on the simulation thread when they
+     * are dumped, so each dump is a consistent snapshot.
+     */
+    std::thread writer;
+    /** Process that started the writer, a forked child writes inline */
+    pid_t writerPid;
+    mutable std::mutex writerMutex;
+    std::condition_variable writerReady;
+    std::condition_variable writerDone;
+    /** Formatted dumps waiting for the writer, in dump order */
+    std::deque<std::string> pendingDumps;
+    bool writerExit;
+    /** The writer found the stream bad, only it touches the stream */
+    bool writeFailed;
+
+    /** Dumps that may be pending before a new one waits for the writer */
+    static const size_t maxPendingDumps = 2;
+
   protected:
     bool noOutput(const Info &info);
 
+    void writeDumps();
+
   public:
     bool enableUnits;
     bool descriptions;
     bool spaces;
+    /** Only print stats that changed since the previous dump. */
+    bool changedOnly;
 
   public:
     Text();
@@ -84,6 +122,13 @@ class Text : public Output
     void open(const std::string &file);
     std::string statName(const std::string &name) const;
 
+    /**
+     * Write the dumps to the stream on a thread of their own from now
+     * on. The stream must outlive this object.
+     */
+    void writeAsync();
+
+
     // Implement Visit
     void visit(const ScalarInfo &info) override;
     void visit(const VectorInfo &info) override;
@@ -101,11 +146,13 @@ class Text : public Output
     bool valid() const override;
     void begin() override;
     void end() override;
+    void flush() override;
 };
 
 std::string ValueToString(Result value, int precision);
 
-Output *initText(const std::string &filename, bool desc, bool spaces);
+Output *initText(const std::string &filename, bool desc, bool spaces,
+                 bool changed=false);
 
 } // namespace statistics
 } // namespace gem5
@@ -60,7 +60,7 @@ typedef std::vector<Result> VResult;
 typedef unsigned int size_type;
 typedef unsigned int off_type;
 
-enum DistType { Deviation, Dist, Hist };
+enum DistType { Deviation, Dist, Hist, LogHist };
 
 /** General container for distribution data. */
 struct DistData
@@ -79,6 +79,11 @@ struct DistData
     Counter squares;
     Counter logs;
     Counter samples;
+    /**
+     * Lower bounds of the buckets of the histograms whose buckets are of
+     * uneven sizes, in which case bucket_size is 0. Empty otherwise.
+     */
+    VCounter bucket_lows;
 };
 
 /** Data structure of sparse histogram */
@@ -31,10 +31,17 @@
 
 #include "base/trace.hh"
 
+#include <pthread.h>
+
+#include <atomic>
 #include <cctype>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <sstream>
+#include <thread>
 
 #include "base/atomicio.hh"
 #include "base/logging.hh"
@@ -170,5 +177,356 @@ OstreamLogger::logMessage(Tick when, const std::string &name,
     }
 }
 
+uint32_t
+BinaryLogger::Buffer::define(const std::string &str)
+{
+    uint32_t id = nextId++;
+    put(Define);
+    put(id);
+    putString(str.data(), str.size());
+    strings[str] = id;
+    return id;
+}
+
+/** The writer thread, and the buffers it writes out */
+struct BinaryLogger::Writer
+{
+    /** Chunks waiting to be written before the threads stall */
+    static constexpr size_t maxChunks = 16;
+
+    std::ostream &stream;
+
+    std::mutex mutex;
+    /** Notified when a chunk is queued or the writer is to stop */
+    std::condition_variable ready;
+    /** Notified when a chunk has been written */
+    std::condition_variable written;
+    std::deque<std::pair<uint32_t, std::vector<char>>> chunks;
+    /** Written chunks, for the threads to reuse their memory */
+    std::vector<std::vector<char>> spare;
+    bool writing = false;
+    bool stop = false;
+
+    /** Buffers of every thread, guarded by the mutex */
+    std::vector<std::unique_ptr<Buffer>> buffers;
+
+    std::thread thread;
+
+    Writer(std::ostream &stream) : stream(stream) {}
+
+    void
+    run()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            ready.wait(lock, [this]() { return stop || !chunks.empty(); });
+            if (chunks.empty())
+                return;
+            auto [thread, data] = std::move(chunks.front());
+            chunks.pop_front();
+            writing = true;
+            lock.unlock();
+
+            uint32_t size = data.size();
+            stream.write(reinterpret_cast<const char *>(&thread),
+                         sizeof(thread));
+            stream.write(reinterpret_cast<const char *>(&size),
+                         sizeof(size));
+            stream.write(data.data(), size);
+            data.clear();
+
+            lock.lock();
+            writing = false;
+            spare.push_back(std::move(data));
+            written.notify_all();
+        }
+    }
+
+    /** Queue the records of a buffer, and give it a fresh chunk */
+    void
+    queue(std::unique_lock<std::mutex> &lock, Buffer &buf)
+    {
+        written.wait(lock, [this]() { return chunks.size() < maxChunks; });
+        chunks.emplace_back(buf.thread, std::move(buf.data));
+        if (spare.empty()) {
+            buf.data = std::vector<char>();
+            buf.data.reserve(chunkSize);
+        } else {
+            buf.data = std::move(spare.back());
+            spare.pop_back();
+        }
+        ready.notify_one();
+    }
+};
+
+bool BinaryLogger::forked = false;
+
+namespace
+{
+
+constexpr char binaryTraceMagic[8] = {'g', 'e', 'm', '5', 'b', 't', 'r', 'c'};
+constexpr uint32_t binaryTraceVersion = 1;
+
+std::atomic<uint64_t> nextGeneration(1);
+
+} // anonymous namespace
+
+BinaryLogger::BinaryLogger(std::ostream &stream)
+    : generation(nextGeneration++), writer(new Writer(stream)),
+      textBuf(*this), textStream(&textBuf)
+{
+    binary = true;
+
+    // The writer thread does not survive a fork, the records of the child
+    // are dropped
+    static std::once_flag atfork;
+    std::call_once(atfork, []() {
+        pthread_atfork(nullptr, nullptr, []() { forked = true; });
+    });
+
+    stream.write(binaryTraceMagic, sizeof(binaryTraceMagic));
+    stream.write(reinterpret_cast<const char *>(&binaryTraceVersion),
+                 sizeof(binaryTraceVersion));
+    writer->thread = std::thread([this]() { writer->run(); });
+}
+
+BinaryLogger::~BinaryLogger()
+{
+    if (forked) {
+        // there is no writer thread to join
+        writer.release();
+        return;
+    }
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(writer->mutex);
+        writer->stop = true;
+    }
+    writer->ready.notify_one();
+    writer->thread.join();
+}
+
+BinaryLogger::Buffer &
+BinaryLogger::newBuffer()
+{
+    auto buf = std::make_unique<Buffer>();
+    buf->data.reserve(chunkSize);
+
+    std::lock_guard<std::mutex> lock(writer->mutex);
+    buf->thread = writer->buffers.size();
+    localBuffer = buf.get();
+    localGeneration = generation;
+    writer->buffers.push_back(std::move(buf));
+    return *localBuffer;
+}
+
+void
+BinaryLogger::handOver(Buffer &buf)
+{
+    std::unique_lock<std::mutex> lock(writer->mutex);
+    writer->queue(lock, buf);
+}
+
+void
+BinaryLogger::logMessage(Tick when, const std::string &name,
+        const std::string &flag, const std::string &message)
+{
+    if (!name.empty() && ignore.match(name))
+        return;
+    record(when, name, flag, "%s", message);
+}
+
+int
+BinaryLogger::TextBuf::sync()
+{
+    if (!str().empty()) {
+        logger.logMessage(MaxTick, "", "", str());
+        str("");
+    }
+    return 0;
+}
+
+void
+BinaryLogger::flush()
+{
+    if (forked)
+        return;
+    textStream.flush();
+
+    std::unique_lock<std::mutex> lock(writer->mutex);
+    for (auto &buf : writer->buffers) {
+        if (!buf->data.empty())
+            writer->queue(lock, *buf);
+    }
+    writer->written.wait(lock, [this]() {
+        return writer->chunks.empty() && !writer->writing;
+    });
+    writer->stream.flush();
+}
+
+namespace
+{
+
+/** Bounds checked reads from a chunk of records */
+struct ChunkReader
+{
+    const char *pos;
+    const char *end;
+    bool ok = true;
+
+    template <typename T>
+    T
+    get()
+    {
+        T value{};
+        if (end - pos < (ptrdiff_t)sizeof(T)) {
+            ok = false;
+            pos = end;
+        } else {
+            std::memcpy(&value, pos, sizeof(T));
+            pos += sizeof(T);
+        }
+        return value;
+    }
+
+    std::string
+    getString()
+    {
+        uint32_t len = get<uint32_t>();
+        if (end - pos < (ptrdiff_t)len) {
+            ok = false;
+            pos = end;
+            return std::string();
+        }
+        std::string str(pos, len);
+        pos += len;
+        return str;
+    }
+};
+
+/** Pass the next recorded argument on to a format */
+bool
+addArg(ChunkReader &reader, cp::Print &print)
+{
+    switch (reader.get<uint8_t>()) {
+      case BinaryLogger::Bool: print.addArg(reader.get<bool>()); break;
+      case BinaryLogger::Char: print.addArg(reader.get<char>()); break;
+      case BinaryLogger::SChar:
+        print.addArg(reader.get<signed char>());
+        break;
+      case BinaryLogger::UChar:
+        print.addArg(reader.get<unsigned char>());
+        break;
+      case BinaryLogger::Short: print.addArg(reader.get<short>()); break;
+      case BinaryLogger::UShort:
+        print.addArg(reader.get<unsigned short>());
+        break;
+      case BinaryLogger::Int: print.addArg(reader.get<int>()); break;
+      case BinaryLogger::UInt: print.addArg(reader.get<unsigned>()); break;
+      case BinaryLogger::Long: print.addArg(reader.get<long>()); break;
+      case BinaryLogger::ULong:
+        print.addArg(reader.get<unsigned long>());
+        break;
+      case BinaryLogger::LongLong:
+        print.addArg(reader.get<long long>());
+        break;
+      case BinaryLogger::ULongLong:
+        print.addArg(reader.get<unsigned long long>());
+        break;
+      case BinaryLogger::Float: print.addArg(reader.get<float>()); break;
+      case BinaryLogger::Double: print.addArg(reader.get<double>()); break;
+      case BinaryLogger::Pointer:
+        print.addArg(reader.get<const void *>());
+        break;
+      case BinaryLogger::String:
+      case BinaryLogger::Text:
+        print.addArg(reader.getString());
+        break;
+      default:
+        return false;
+    }
+    return reader.ok;
+}
+
+} // anonymous namespace
+
+bool
+replayBinaryTrace(std::istream &in, Logger &logger)
+{
+    char magic[sizeof(binaryTraceMagic)];
+    uint32_t version = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char *>(&version), sizeof(version));
+    if (!in || std::memcmp(magic, binaryTraceMagic, sizeof(magic)) != 0) {
+        warn("Not a binary debug trace\n");
+        return false;
+    }
+    if (version != binaryTraceVersion) {
+        warn("Unsupported binary debug trace version %d\n", version);
+        return false;
+    }
+
+    // strings defined by every thread
+    std::unordered_map<uint32_t, std::vector<std::string>> threads;
+    std::vector<char> chunk;
+    while (true) {
+        uint32_t thread, size;
+        if (!in.read(reinterpret_cast<char *>(&thread), sizeof(thread)))
+            return true;
+        in.read(reinterpret_cast<char *>(&size), sizeof(size));
+        chunk.resize(size);
+        if (!in.read(chunk.data(), size)) {
+            warn("Binary debug trace truncated\n");
+            return false;
+        }
+
+        auto &strings = threads[thread];
+        ChunkReader reader{chunk.data(), chunk.data() + size};
+        auto string = [&](uint32_t id) -> const std::string * {
+            if (id >= strings.size()) {
+                reader.ok = false;
+                return nullptr;
+            }
+            return &strings[id];
+        };
+        while (reader.ok && reader.pos != reader.end) {
+            auto kind = reader.get<uint8_t>();
+            if (kind == BinaryLogger::Define) {
+                uint32_t id = reader.get<uint32_t>();
+                std::string str = reader.getString();
+                if (id >= strings.size())
+                    strings.resize(id + 1);
+                strings[id] = std::move(str);
+                continue;
+            } else if (kind != BinaryLogger::Message) {
+                reader.ok = false;
+                break;
+            }
+
+            Tick when = reader.get<Tick>();
+            const std::string *name = string(reader.get<uint32_t>());
+            const std::string *flag = string(reader.get<uint32_t>());
+            const std::string *fmt = string(reader.get<uint32_t>());
+            uint8_t num_args = reader.get<uint8_t>();
+            if (!reader.ok)
+                break;
+
+            std::ostringstream line;
+            {
+                cp::Print print(line, *fmt);
+                for (int i = 0; i < num_args && reader.ok; i++)
+                    reader.ok = addArg(reader, print);
+                print.endArgs();
+            }
+            if (reader.ok)
+                logger.logMessage(when, *name, *flag, line.str());
+        }
+        if (!reader.ok) {
+            warn("Corrupt record in the binary debug trace\n");
+            return false;
+        }
+    }
+}
+
 } // namespace Trace
 } // namespace gem5
@@ -32,9 +32,17 @@
 #ifndef __BASE_TRACE_HH__
 #define __BASE_TRACE_HH__
 
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
 #include <ostream>
 #include <string>
 #include <sstream>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "base/compiler.hh"
 #include "base/cprintf.hh"
@@ -61,6 +69,10 @@ class Logger
     /** Name match for objects to ignore */
     ObjectMatch ignore;
 
+    /** Whether this is a BinaryLogger, which records the arguments of the
+     *  messages rather than formatting them */
+    bool binary = false;
+
   public:
     /** Log a single message */
     template <typename ...Args>
@@ -70,17 +82,33 @@ class Logger
         dprintf_flag(when, name, "", fmt, args...);
     }
 
+    /** Log a single message with a format parsed at compile time */
+    template <typename Str, typename ...Args>
+    void dprintf(Tick when, const std::string &name,
+                 cp::StaticFormat<Str> fmt, const Args &...args)
+    {
+        dprintf_flag(when, name, "", fmt, args...);
+    }
+
     /** Log a single message with a flag prefix. */
     template <typename ...Args>
-    void dprintf_flag(Tick when, const std::string &name,
+    void
+    dprintf_flag(Tick when, const std::string &name,
             const std::string &flag,
             const char *fmt, const Args &...args)
     {
-        if (!name.empty() && ignore.match(name))
-            return;
-        std::ostringstream line;
-        ccprintf(line, fmt, args...);
-        logMessage(when, name, flag, line.str());
+        logFormat(when, name, flag, fmt, args...);
+    }
+
+    /** Log a single message with a flag prefix and a format parsed at
+     *  compile time, see GEM5_FMT() */
+    template <typename Str, typename ...Args>
+    void
+    dprintf_flag(Tick when, const std::string &name,
+            const std::string &flag,
+            cp::StaticFormat<Str> fmt, const Args &...args)
+    {
+        logFormat(when, name, flag, fmt, args...);
     }
 
     /** Dump a block of data of length len */
@@ -105,6 +133,12 @@ class Logger
     void addIgnore(const ObjectMatch &ignore_) { ignore.add(ignore_); }
 
     virtual ~Logger() { }
+
+  private:
+    template <typename Format, typename ...Args>
+    void logFormat(Tick when, const std::string &name,
+            const std::string &flag,
+            const Format &fmt, const Args &...args);
 };
 
 /** Logging wrapper for ostreams with the format:
@@ -124,6 +158,239 @@ class OstreamLogger : public Logger
     std::ostream &getOstream() override { return stream; }
 };
 
+/**
+ * Logger which records the messages in a binary form rather than
+ * formatting them, for replayBinaryTrace() to render them later on. A
+ * message is recorded as its tick, the ids of its object name, flag and
+ * format string, and its raw arguments: integer, floating point, pointer
+ * and string arguments are copied as they are, and any other argument is
+ * recorded as it prints with operator<<.
+ *
+ * Every thread records into a buffer of its own, without any locking,
+ * and hands it over to a writer thread once it is full. The ids of the
+ * strings are per thread, and a thread defines a string in its record
+ * stream the first time it uses it.
+ */
+class BinaryLogger : public Logger
+{
+  public:
+    /** Kinds of the records */
+    enum Record : uint8_t { Define = 1, Message = 2 };
+
+    /** Types of the recorded arguments */
+    enum Arg : uint8_t
+    {
+        Bool = 1, Char, SChar, UChar, Short, UShort, Int, UInt, Long, ULong,
+        LongLong, ULongLong, Float, Double, Pointer, String, Text,
+        Unknown = 0
+    };
+
+    template <typename T>
+    static constexpr Arg
+    argType()
+    {
+        if constexpr (std::is_same_v<T, bool>) return Bool;
+        else if constexpr (std::is_same_v<T, char>) return Char;
+        else if constexpr (std::is_same_v<T, signed char>) return SChar;
+        else if constexpr (std::is_same_v<T, unsigned char>) return UChar;
+        else if constexpr (std::is_same_v<T, short>) return Short;
+        else if constexpr (std::is_same_v<T, unsigned short>) return UShort;
+        else if constexpr (std::is_same_v<T, int>) return Int;
+        else if constexpr (std::is_same_v<T, unsigned>) return UInt;
+        else if constexpr (std::is_same_v<T, long>) return Long;
+        else if constexpr (std::is_same_v<T, unsigned long>) return ULong;
+        else if constexpr (std::is_same_v<T, long long>) return LongLong;
+        else if constexpr (std::is_same_v<T, unsigned long long>)
+            return ULongLong;
+        else if constexpr (std::is_same_v<T, float>) return Float;
+        else if constexpr (std::is_same_v<T, double>) return Double;
+        else return Unknown;
+    }
+
+    /** Records of a thread, and the ids of the strings it defined */
+    struct Buffer
+    {
+        uint32_t thread = 0;
+        std::vector<char> data;
+
+        std::unordered_map<std::string, uint32_t> strings;
+        /** Format strings by address, with their text to tell a reused
+         *  address apart */
+        std::unordered_map<const char *, std::pair<uint32_t, std::string>>
+            formats;
+        uint32_t nextId = 0;
+
+        void
+        put(const void *p, size_t size)
+        {
+            const char *c = static_cast<const char *>(p);
+            data.insert(data.end(), c, c + size);
+        }
+
+        template <typename T>
+        void put(const T &value) { put(&value, sizeof(value)); }
+
+        void
+        putString(const char *str, uint32_t len)
+        {
+            put(len);
+            put(str, len);
+        }
+
+        uint32_t define(const std::string &str);
+
+        uint32_t
+        intern(const std::string &str)
+        {
+            auto it = strings.find(str);
+            return it != strings.end() ? it->second : define(str);
+        }
+
+        uint32_t
+        internFormat(const char *fmt)
+        {
+            auto it = formats.find(fmt);
+            if (GEM5_LIKELY(it != formats.end() &&
+                            it->second.second == fmt)) {
+                return it->second.first;
+            }
+            uint32_t id = define(fmt);
+            formats[fmt] = {id, fmt};
+            return id;
+        }
+
+        template <typename T>
+        void
+        putArg(const T &arg)
+        {
+            using Decayed = std::decay_t<T>;
+            if constexpr (argType<T>() != Unknown) {
+                put(argType<T>());
+                put(arg);
+            } else if constexpr (std::is_same_v<Decayed, char *> ||
+                                 std::is_same_v<Decayed, const char *>) {
+                put(String);
+                putString(arg, std::strlen(arg));
+            } else if constexpr (std::is_same_v<T, std::string>) {
+                put(String);
+                putString(arg.data(), arg.size());
+            } else if constexpr (std::is_pointer_v<T>) {
+                put(Pointer);
+                put(static_cast<const void *>(arg));
+            } else {
+                std::ostringstream stream;
+                stream << arg;
+                const std::string text = stream.str();
+                put(Text);
+                putString(text.data(), text.size());
+            }
+        }
+    };
+
+    /** Capacity of a buffer, which is handed over to the writer once
+     *  less than a page of it is left */
+    static constexpr size_t chunkSize = 1 << 20;
+
+    /** Record into a stream, which must outlive the logger */
+    BinaryLogger(std::ostream &stream);
+    ~BinaryLogger();
+
+    template <typename ...Args>
+    void
+    record(Tick when, const std::string &name, const std::string &flag,
+           const char *fmt, const Args &...args)
+    {
+        if (GEM5_UNLIKELY(forked))
+            return;
+        Buffer &buf = buffer();
+        uint32_t name_id = buf.intern(name);
+        uint32_t flag_id = buf.intern(flag);
+        uint32_t fmt_id = buf.internFormat(fmt);
+        buf.put(Message);
+        buf.put(when);
+        buf.put(name_id);
+        buf.put(flag_id);
+        buf.put(fmt_id);
+        buf.put(static_cast<uint8_t>(sizeof...(args)));
+        (buf.putArg(args), ...);
+        if (GEM5_UNLIKELY(buf.data.size() > chunkSize - 4096))
+            handOver(buf);
+    }
+
+    /** Record a message formatted elsewhere, e.g. by dump() */
+    void logMessage(Tick when, const std::string &name,
+            const std::string &flag, const std::string &message) override;
+
+    /** Text written to this stream is recorded a line at a time */
+    std::ostream &getOstream() override { return textStream; }
+
+    /** Write out every buffer and wait for the writer. No thread may
+     *  record in the meantime */
+    void flush();
+
+  private:
+    /** Text of getOstream(), recorded when flushed */
+    class TextBuf : public std::stringbuf
+    {
+      private:
+        BinaryLogger &logger;
+
+      public:
+        TextBuf(BinaryLogger &logger) : logger(logger) {}
+        int sync() override;
+    };
+
+    struct Writer;
+
+    /** Set in the child of a fork, which has no writer thread */
+    static bool forked;
+
+    /** Buffer of the thread, valid if it belongs to the logger of the
+     *  same generation */
+    static inline thread_local Buffer *localBuffer = nullptr;
+    static inline thread_local uint64_t localGeneration = 0;
+
+    const uint64_t generation;
+    std::unique_ptr<Writer> writer;
+    TextBuf textBuf;
+    std::ostream textStream;
+
+    Buffer &
+    buffer()
+    {
+        if (GEM5_UNLIKELY(localGeneration != generation))
+            return newBuffer();
+        return *localBuffer;
+    }
+
+    Buffer &newBuffer();
+    void handOver(Buffer &buf);
+};
+
+template <typename Format, typename ...Args>
+void
+Logger::logFormat(Tick when, const std::string &name,
+        const std::string &flag, const Format &fmt, const Args &...args)
+{
+    if (!name.empty() && ignore.match(name))
+        return;
+    if (binary) {
+        static_cast<BinaryLogger *>(this)->record(when, name, flag, fmt,
+                                                  args...);
+        return;
+    }
+    std::ostringstream line;
+    ccprintf(line, fmt, args...);
+    logMessage(when, name, flag, line.str());
+}
+
+/**
+ * Render the messages recorded by a BinaryLogger through another logger.
+ *
+ * @return Whether the whole stream could be read.
+ */
+bool replayBinaryTrace(std::istream &in, Logger &logger);
+
 /** Get the current global debug logger.  This takes ownership of the given
  *  logger which should be allocated using 'new' */
 Logger *getDebugLogger();
@@ -377,6 +377,17 @@ TEST(TraceTest, DprintfFlagMultipleArgs)
     ASSERT_EQ(getString(&logger), "    100: Foo: Test message A 217 30");
 }
 
+/** Test dprintf_flag with a format parsed at compile time. */
+TEST(TraceTest, DprintfFlagStaticFormat)
+{
+    std::stringstream ss;
+    Trace::OstreamLogger logger(ss);
+
+    logger.dprintf_flag(Tick(100), "Foo", "", GEM5_FMT("Test %s %c %d %x"),
+        "message", 'A', 217, 0x30);
+    ASSERT_EQ(getString(&logger), "    100: Foo: Test message A 217 30");
+}
+
 /** Test dprintf_flag with flag. */
 TEST(TraceTest, DprintfFlagEnabled)
 {
@@ -584,6 +595,52 @@ TEST(TraceTest, MacroDPRINTF_UNCONDITIONAL)
 #endif
 }
 
+/**
+ * Test that the messages recorded by a BinaryLogger render as an
+ * OstreamLogger would have printed them.
+ */
+TEST(TraceTest, BinaryLoggerReplay)
+{
+    std::stringstream ss_text, ss_binary, ss_replay;
+    Trace::OstreamLogger text(ss_text);
+    {
+        Trace::BinaryLogger binary(ss_binary);
+        for (Trace::Logger *logger :
+                std::initializer_list<Trace::Logger *>{&text, &binary}) {
+            logger->dprintf_flag(Tick(100), "Foo", "Bar", "Test %s %c %d %x",
+                "message", 'A', 217, 0x30);
+            logger->dprintf_flag(Tick(200), "Foo.baz", "Bar",
+                "%#8x %-4d|%.2f %s %s\n", (uint64_t)0xbeef, (int8_t)-3,
+                1.5, std::string("str"), true);
+            logger->dprintf(MaxTick, "", "%*d|%c", 5, 42, (char)'z');
+            logger->dump(Tick(300), "Foo", "0123456789abcdefXY", 18, "Bar");
+            logger->getOstream() << "raw text" << std::endl;
+        }
+    }
+    Trace::OstreamLogger replay(ss_replay);
+    ASSERT_TRUE(Trace::replayBinaryTrace(ss_binary, replay));
+    std::string expected = getString(&text);
+    ASSERT_NE(expected.find("    200: Foo.baz:   0xbeef -3  |1.50 str"),
+              std::string::npos);
+    ASSERT_EQ(getString(&replay), expected);
+}
+
+/** Test that a truncated binary trace is rejected. */
+TEST(TraceTest, BinaryLoggerTruncated)
+{
+    std::stringstream ss_binary, ss_replay;
+    {
+        Trace::BinaryLogger binary(ss_binary);
+        binary.dprintf(Tick(100), "Foo", "Test %d", 1);
+    }
+    std::string data = ss_binary.str();
+    std::stringstream ss_truncated(data.substr(0, data.size() - 1));
+    Trace::OstreamLogger replay(ss_replay);
+    gtestLogOutput.str("");
+    ASSERT_FALSE(Trace::replayBinaryTrace(ss_truncated, replay));
+    ASSERT_NE(gtestLogOutput.str().find("truncated"), std::string::npos);
+}
+
 /**
  * Test that there is a global name() to fall through when a locally scoped
  * name() is not defined.
@@ -33,6 +33,27 @@ class ExeTracer(InstTracer):
     cxx_class = 'gem5::Trace::ExeTracer'
     cxx_header = "cpu/exetrace.hh"
 
+class InstBinTrace(InstTracer):
+    type = 'InstBinTrace'
+    cxx_class = 'gem5::Trace::InstBinTrace'
+    cxx_header = "cpu/inst_bin_trace.hh"
+
+    # Boolean to compress the trace or not.
+    trace_compress = Param.Bool(True, "Enable trace compression")
+
+    # instruction trace output file, named after the tracer by default
+    trace_file = Param.String("", "Instruction trace output file")
+
+    # Only trace the instructions in these PC ranges, if any are given
+    pc_ranges = VectorParam.AddrRange([], "PC ranges to trace")
+
+    # Trace the first sample_length committed instructions of every
+    # sample_period, or all of them with a period of 0
+    sample_period = Param.Counter(0, "Period of the tracing windows, in "
+                                  "instructions, 0 to trace them all")
+    sample_length = Param.Counter(0, "Length of the tracing windows, in "
+                                  "instructions")
+
 class IntelTrace(InstTracer):
     type = 'IntelTrace'
     cxx_class = 'gem5::Trace::IntelTrace'
@@ -242,7 +242,7 @@ BaseCPU::mwaitAtomic(ThreadID tid, ThreadContext *tc, BaseMMU *mmu)
     assert(tid < numThreads);
     AddressMonitor &monitor = addressMonitor[tid];
 
-    RequestPtr req = std::make_shared<Request>();
+    RequestPtr req = makeRequest();
 
     Addr addr = monitor.vAddr;
     int block_size = cacheLineSize();
@@ -379,8 +379,11 @@ BaseCPUStats::BaseCPUStats(statistics::Group *parent)
       ADD_STAT(numWorkItemsStarted, statistics::units::Count::get(),
                "Number of work items this cpu started"),
       ADD_STAT(numWorkItemsCompleted, statistics::units::Count::get(),
-               "Number of work items this cpu completed")
+               "Number of work items this cpu completed"),
+      ADD_STAT(memStallCycles, statistics::units::Cycle::get(),
+               "Number of cycles stalled on data from memory")
 {
+    memStallCycles.flags(statistics::nozero);
 }
 
 void
@@ -680,6 +683,12 @@ BaseCPU::getCurrentInstCount(ThreadID tid)
     return threadContexts[tid]->getCurrentInstCount();
 }
 
+uint64_t
+BaseCPU::archStateDigest(ThreadID tid)
+{
+    return ThreadContext::digest(threadContexts[tid]);
+}
+
 AddressMonitor::AddressMonitor()
 {
     armed = false;
@@ -454,6 +454,15 @@ class BaseCPU : public ClockedObject
      */
     uint64_t getCurrentInstCount(ThreadID tid);
 
+    /**
+     * Get a digest of the architectural state of the specified thread,
+     * see ThreadContext::digest(). Used by Python to compare CPU models.
+     *
+     * @param tid Thread monitor
+     * @return Digest of the PC and registers
+     */
+    uint64_t archStateDigest(ThreadID tid);
+
   public:
     /**
      * @{
@@ -606,6 +615,9 @@ class BaseCPU : public ClockedObject
         statistics::Scalar numCycles;
         statistics::Scalar numWorkItemsStarted;
         statistics::Scalar numWorkItemsCompleted;
+        // Cycles lost waiting for data from memory, counted by the CPU
+        // models that can tell, e.g. for the DVFS governor
+        statistics::Scalar memStallCycles;
     } baseStats;
 
   private:
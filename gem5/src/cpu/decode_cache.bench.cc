@@ -0,0 +1,100 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "cpu/decode_cache.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/**
+ * Fetch like addresses: runs of sequential 4 byte instructions, which
+ * branch to one of a number of hot code pages.
+ */
+std::vector<Addr>
+fetchAddrs(int num_pages)
+{
+    std::mt19937_64 gen(1);
+    std::uniform_int_distribution<int> page_dist(0, num_pages - 1);
+    std::uniform_int_distribution<Addr> offset_dist(0, 1023);
+    std::geometric_distribution<int> run_dist(0.15);
+    std::vector<Addr> addrs;
+    while (addrs.size() < 8192) {
+        Addr pc = 0x400000 + page_dist(gen) * 0x1000 + offset_dist(gen) * 4;
+        for (int i = run_dist(gen); i >= 0; i--, pc += 4)
+            addrs.push_back(pc);
+    }
+    return addrs;
+}
+
+/** The per PC lookup of the decoded instruction of a fetch address. */
+void
+BM_DecodeCacheAddrMapLookup(benchmark::State &state)
+{
+    decode_cache::AddrMap<void *> map;
+    const auto addrs = fetchAddrs(state.range(0));
+    for (Addr addr : addrs)
+        map.lookup(addr) = &map;
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(map.lookup(addrs[i]));
+        i = (i + 1) % addrs.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/** The lookup of the decoded instruction of a machine instruction. */
+void
+BM_DecodeCacheInstMapFind(benchmark::State &state)
+{
+    decode_cache::FlatMap<uint64_t, void *> map;
+    std::mt19937_64 gen(1);
+    std::vector<uint64_t> insts(state.range(0));
+    for (auto &inst : insts) {
+        inst = gen();
+        map[inst] = &map;
+    }
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(map.find(insts[i]));
+        i = (i + 1) % insts.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // anonymous namespace
+
+BENCHMARK(BM_DecodeCacheAddrMapLookup)->RangeMultiplier(8)->Range(1, 512);
+BENCHMARK(BM_DecodeCacheInstMapFind)->RangeMultiplier(16)->Range(64, 65536);
+
+BENCHMARK_MAIN();
@@ -26,13 +26,19 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+
 #ifndef __CPU_DECODE_CACHE_HH__
 #define __CPU_DECODE_CACHE_HH__
 
-#include <unordered_map>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
 
 #include "base/bitfield.hh"
 #include "base/compiler.hh"
+#include "base/intmath.hh"
+#include "base/types.hh"
 #include "cpu/static_inst_fwd.hh"
 
 namespace gem5
@@ -42,9 +48,96 @@ GEM5_DEPRECATED_NAMESPACE(DecodeCache, decode_cache);
 namespace decode_cache
 {
 
+/// An insert only hash map with open addressing and linear probing.
+/// The keys and values live in one flat array, so a lookup is usually a
+/// single cache line access rather than a walk through heap allocated
+/// nodes. Unlike std::unordered_map, inserting may move the entries, so
+/// iterators and references are only valid until the next insertion.
+template <class Key, class Value, class Hash = std::hash<Key>>
+class FlatMap
+{
+  public:
+    typedef std::pair<Key, Value> value_type;
+    typedef value_type *iterator;
+
+  protected:
+    static constexpr std::size_t MinSlots = 64;
+
+    std::vector<value_type> slots;
+    std::vector<uint8_t> used;
+    std::size_t numUsed = 0;
+    // Shift that keeps the top log2(slots.size()) bits of the hash
+    unsigned hashShift = 64 - floorLog2(MinSlots);
+
+    /// Find the slot of a key, or the empty slot it would go in.
+    std::size_t
+    slotOf(const Key &key) const
+    {
+        // Fibonacci hashing spreads keys whose hash has zero low bits,
+        // like page aligned addresses, over the whole table
+        const uint64_t hash = Hash()(key) * 0x9e3779b97f4a7c15ULL;
+        const std::size_t mask = slots.size() - 1;
+        std::size_t slot = hash >> hashShift;
+        while (used[slot] && !(slots[slot].first == key))
+            slot = (slot + 1) & mask;
+        return slot;
+    }
+
+    /// Double the number of slots, keeping the load factor below 1/2.
+    void
+    grow()
+    {
+        std::vector<value_type> old_slots(slots.size() * 2);
+        std::vector<uint8_t> old_used(slots.size() * 2, 0);
+        old_slots.swap(slots);
+        old_used.swap(used);
+        hashShift--;
+
+        for (std::size_t i = 0; i < old_slots.size(); i++) {
+            if (old_used[i]) {
+                const std::size_t slot = slotOf(old_slots[i].first);
+                slots[slot] = std::move(old_slots[i]);
+                used[slot] = 1;
+            }
+        }
+    }
+
+  public:
+    FlatMap() : slots(MinSlots), used(MinSlots, 0) {}
+
+    iterator end() { return nullptr; }
+
+    std::size_t size() const { return numUsed; }
+
+    iterator
+    find(const Key &key)
+    {
+        const std::size_t slot = slotOf(key);
+        return used[slot] ? &slots[slot] : end();
+    }
+
+    Value &
+    operator[](const Key &key)
+    {
+        std::size_t slot = slotOf(key);
+        if (used[slot])
+            return slots[slot].second;
+
+        if (2 * (numUsed + 1) > slots.size()) {
+            grow();
+            slot = slotOf(key);
+        }
+
+        slots[slot] = value_type(key, Value());
+        used[slot] = 1;
+        numUsed++;
+        return slots[slot].second;
+    }
+};
+
 /// Hash for decoded instructions.
 template <typename EMI>
-using InstMap = std::unordered_map<EMI, StaticInstPtr>;
+using InstMap = FlatMap<EMI, StaticInstPtr>;
 
 /// A sparse map from an Addr to a Value, stored in page chunks.
 template<class Value, Addr CacheChunkShift = 12>
@@ -71,20 +164,18 @@ class AddrMap
         Value items[CacheChunkBytes];
     };
     // A map of cache chunks which allows a sparse mapping.
-    typedef typename std::unordered_map<Addr, CacheChunk *> ChunkMap;
-    typedef typename ChunkMap::iterator ChunkIt;
-    // Mini cache of recent lookups.
-    ChunkIt recent[2];
+    typedef FlatMap<Addr, CacheChunk *> ChunkMap;
     ChunkMap chunkMap;
 
-    /// Update the mini cache of recent lookups.
-    /// @param recentest The most recent result;
-    void
-    update(ChunkIt recentest)
+    // Direct mapped mini cache of recent lookups. Code usually runs
+    // from a handful of pages at a time, so most lookups stop here.
+    static constexpr unsigned RecentSize = 8;
+    struct RecentChunk
     {
-        recent[1] = recent[0];
-        recent[0] = recentest;
-    }
+        Addr addr;
+        CacheChunk *chunk;
+    };
+    RecentChunk recent[RecentSize];
 
     /// Attempt to find the CacheChunk which goes with a particular
     /// address. First check the small cache of recent results, then
@@ -96,36 +187,29 @@ class AddrMap
         Addr chunk_addr = chunkStart(addr);
 
         // Check against recent lookups.
-        if (recent[0] != chunkMap.end()) {
-            if (recent[0]->first == chunk_addr)
-                return recent[0]->second;
-            if (recent[1] != chunkMap.end() &&
-                    recent[1]->first == chunk_addr) {
-                update(recent[1]);
-                // recent[1] has just become recent[0].
-                return recent[0]->second;
-            }
-        }
-
-        // Actually look in the hash_map.
-        ChunkIt it = chunkMap.find(chunk_addr);
-        if (it != chunkMap.end()) {
-            update(it);
-            return it->second;
-        }
-
-        // Didn't find an existing chunk, so add a new one.
-        CacheChunk *newChunk = new CacheChunk;
-        typename ChunkMap::value_type to_insert(chunk_addr, newChunk);
-        update(chunkMap.insert(to_insert).first);
-        return newChunk;
+        RecentChunk &entry =
+            recent[(chunk_addr >> CacheChunkShift) % RecentSize];
+        if (entry.addr == chunk_addr)
+            return entry.chunk;
+
+        // Actually look in the hash map, adding a new chunk if there
+        // isn't one yet.
+        CacheChunk *&chunk = chunkMap[chunk_addr];
+        if (!chunk)
+            chunk = new CacheChunk;
+
+        entry.addr = chunk_addr;
+        entry.chunk = chunk;
+        return chunk;
     }
 
   public:
     /// Constructor
     AddrMap()
     {
-        recent[0] = recent[1] = chunkMap.end();
+        // No chunk starts at MaxAddr, so these never match.
+        for (auto &entry : recent)
+            entry = RecentChunk{MaxAddr, nullptr};
     }
 
     Value &
@@ -0,0 +1,95 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <unordered_map>
+
+#include "cpu/decode_cache.hh"
+
+using namespace gem5;
+
+/** Lookups of missing keys fail without inserting them. */
+TEST(FlatMapTest, FindMissing)
+{
+    decode_cache::FlatMap<Addr, int> map;
+    EXPECT_EQ(map.find(0x1000), map.end());
+    EXPECT_EQ(map.size(), 0);
+}
+
+/** operator[] inserts value initialized entries that find can see. */
+TEST(FlatMapTest, Insert)
+{
+    decode_cache::FlatMap<Addr, int> map;
+    EXPECT_EQ(map[0x1000], 0);
+    map[0x1000] = 5;
+    map[0x2000] = 7;
+    EXPECT_EQ(map.size(), 2);
+
+    auto it = map.find(0x1000);
+    ASSERT_NE(it, map.end());
+    EXPECT_EQ(it->first, 0x1000);
+    EXPECT_EQ(it->second, 5);
+    EXPECT_EQ(map[0x2000], 7);
+    EXPECT_EQ(map.size(), 2);
+}
+
+/** The entries survive the table growing, including colliding keys. */
+TEST(FlatMapTest, Grow)
+{
+    decode_cache::FlatMap<Addr, Addr> map;
+    std::unordered_map<Addr, Addr> ref;
+    for (Addr i = 0; i < 10000; i++) {
+        // Page aligned keys, which have no entropy in their low bits
+        const Addr key = (i * 7919) << 12;
+        map[key] = i;
+        ref[key] = i;
+    }
+
+    EXPECT_EQ(map.size(), ref.size());
+    for (const auto &key_value : ref) {
+        auto it = map.find(key_value.first);
+        ASSERT_NE(it, map.end());
+        EXPECT_EQ(it->second, key_value.second);
+    }
+    EXPECT_EQ(map.find(1), map.end());
+}
+
+/** Addresses map to distinct, stable entries across many pages. */
+TEST(AddrMapTest, Lookup)
+{
+    decode_cache::AddrMap<Addr> map;
+    for (Addr page = 0; page < 64; page++) {
+        for (Addr offset = 0; offset < 0x1000; offset += 0x100)
+            map.lookup((page << 12) + offset) = page * 0x1000 + offset;
+    }
+
+    for (Addr page = 0; page < 64; page++) {
+        for (Addr offset = 0; offset < 0x1000; offset += 0x100) {
+            const Addr addr = (page << 12) + offset;
+            EXPECT_EQ(map.lookup(addr), addr);
+        }
+    }
+}
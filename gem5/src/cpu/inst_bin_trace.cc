@@ -0,0 +1,225 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/inst_bin_trace.hh"
+
+#include <algorithm>
+#include <string>
+
+#include "base/callback.hh"
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "cpu/static_inst.hh"
+#include "cpu/thread_context.hh"
+#include "params/InstBinTrace.hh"
+#include "sim/core.hh"
+#include "sim/cur_tick.hh"
+
+namespace gem5
+{
+
+namespace Trace {
+
+void
+InstBinTraceRecord::dump()
+{
+    tracer.traceInst(*this);
+}
+
+InstBinTrace::InstBinTrace(const InstBinTraceParams &p)
+    : InstTracer(p),
+      pcRanges(p.pc_ranges.begin(), p.pc_ranges.end()),
+      samplePeriod(p.sample_period), sampleLength(p.sample_length)
+{
+    fatal_if(samplePeriod && (sampleLength == 0 ||
+                              sampleLength > samplePeriod),
+             "%s: sample_length must be between 1 and sample_period",
+             name());
+
+    std::string filename;
+    if (p.trace_file != "") {
+        // If the trace file is not specified as an absolute path,
+        // append the current simulation output directory
+        filename = simout.resolve(p.trace_file);
+
+        const std::string suffix = ".gz";
+        // If trace_compress has been set, check the suffix. Append
+        // accordingly.
+        if (p.trace_compress &&
+            filename.compare(filename.size() - suffix.size(), suffix.size(),
+                             suffix) != 0)
+            filename = filename + suffix;
+    } else {
+        // Generate a filename from the name of the SimObject. Append .trc
+        // and .gz if we want compression enabled.
+        filename = simout.resolve(name() + ".trc" +
+                                  (p.trace_compress ? ".gz" : ""));
+    }
+
+    writer.reset(new BinaryTraceWriter<Record>(filename, p.trace_compress));
+    buffer.reserve(BinaryTraceWriter<Record>::bufferRecords);
+
+    std::string header("g5it");
+    auto put32 = [&header](uint32_t val) {
+        for (int i = 0; i < 4; i++)
+            header.push_back(val >> (8 * i));
+    };
+    put32(1);
+    put32(sizeof(Record));
+    put32(sim_clock::Frequency);
+    put32(sim_clock::Frequency >> 32);
+    writer->writeRaw(header.data(), header.size());
+
+    // Register a callback to compensate for the destructor not
+    // being called. The callback forces the stream to flush and
+    // closes the output file.
+    registerExitCallback([this]() { closeStreams(); });
+}
+
+InstBinTraceRecord *
+InstBinTrace::getInstRecord(Tick when, ThreadContext *tc,
+                            const StaticInstPtr si, const PCStateBase &pc,
+                            const StaticInstPtr mi)
+{
+    // every instruction is seen, even the ones which are not traced, so
+    // that the one traced before them knows where control went
+    return new InstBinTraceRecord(*this, when, tc, si, pc, mi);
+}
+
+bool
+InstBinTrace::traced(Addr pc)
+{
+    if (!pcRanges.empty() &&
+        std::none_of(pcRanges.begin(), pcRanges.end(),
+                     [pc](const AddrRange &r) { return r.contains(pc); })) {
+        return false;
+    }
+
+    if (samplePeriod && sampleCount++ % samplePeriod >= sampleLength)
+        return false;
+
+    return true;
+}
+
+void
+InstBinTrace::traceInst(const InstRecord &inst)
+{
+    const PCStateBase &pc = inst.getPCState();
+    const StaticInstPtr &si = inst.getStaticInst();
+    const ContextID ctx = inst.getThread()->contextId();
+
+    if (ctx >= pending.size())
+        pending.resize(ctx + 1);
+
+    // the previous instruction of the context is complete now
+    Pending &prev = pending[ctx];
+    if (prev.valid) {
+        Record &rec = prev.rec;
+        rec.nextPC = pc.instAddr();
+        rec.flags |= NextValid;
+        if ((rec.flags & Control) && rec.nextPC != rec.pc + rec.fallThrough)
+            rec.flags |= Taken;
+        write(rec);
+        prev.valid = false;
+    }
+
+    if (!traced(pc.instAddr()))
+        return;
+
+    Record &rec = prev.rec;
+    rec = Record();
+    rec.tick = curTick();
+    rec.pc = pc.instAddr();
+    rec.upc = pc.microPC();
+    rec.opClass = si->opClass();
+    rec.context = ctx;
+
+    uint16_t flags = 0;
+    if (si->isControl()) {
+        flags |= Control;
+        if (si->isCondCtrl())
+            flags |= Conditional;
+        if (si->isCall())
+            flags |= Call;
+        if (si->isReturn())
+            flags |= Return;
+        if (si->isIndirectCtrl())
+            flags |= Indirect;
+
+        // where the control flow goes when the branch is not taken,
+        // worked out the same way as by the branch predictors
+        std::unique_ptr<PCStateBase> fall_through(pc.clone());
+        si->advancePC(*fall_through);
+        rec.fallThrough = fall_through->instAddr() - rec.pc;
+    }
+    if (si->isLoad())
+        flags |= Load;
+    if (si->isStore() || si->isAtomic())
+        flags |= Store;
+    if (inst.getMemValid()) {
+        flags |= MemValid;
+        rec.addr = inst.getAddr();
+        rec.size = inst.getSize();
+    }
+    if (si->isMicroop())
+        flags |= Microop;
+    if (si->isLastMicroop())
+        flags |= LastMicroop;
+    if (inst.getFaulting())
+        flags |= Faulting;
+    if (!inst.getPredicate())
+        flags |= NotExecuted;
+    rec.flags = flags;
+
+    prev.valid = true;
+}
+
+void
+InstBinTrace::write(const Record &rec)
+{
+    buffer.push_back(rec);
+    if (buffer.size() == BinaryTraceWriter<Record>::bufferRecords)
+        writer->queue(buffer);
+}
+
+void
+InstBinTrace::closeStreams()
+{
+    if (!writer)
+        return;
+
+    for (auto &prev : pending) {
+        if (prev.valid)
+            write(prev.rec);
+        prev.valid = false;
+    }
+
+    if (!buffer.empty())
+        writer->queue(buffer);
+    writer.reset();
+}
+
+} // namespace Trace
+} // namespace gem5
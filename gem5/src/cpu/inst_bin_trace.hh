@@ -0,0 +1,171 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_INST_BIN_TRACE_HH__
+#define __CPU_INST_BIN_TRACE_HH__
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "base/addr_range.hh"
+#include "base/binary_trace_writer.hh"
+#include "base/types.hh"
+#include "cpu/static_inst_fwd.hh"
+#include "sim/insttracer.hh"
+
+namespace gem5
+{
+
+struct InstBinTraceParams;
+class ThreadContext;
+
+namespace Trace {
+
+class InstBinTrace;
+
+class InstBinTraceRecord : public InstRecord
+{
+  public:
+    InstBinTraceRecord(InstBinTrace &_tracer, Tick when, ThreadContext *tc,
+                       const StaticInstPtr si, const PCStateBase &pc,
+                       const StaticInstPtr mi=nullptr)
+        : InstRecord(when, tc, si, pc, mi), tracer(_tracer)
+    {}
+
+    /** Called by the CPU when the instruction commits. */
+    void dump() override;
+
+  protected:
+    InstBinTrace &tracer;
+};
+
+/**
+ * An instruction tracer writing a fixed size binary record per committed
+ * instruction or micro-op, for traces of billions of instructions. The
+ * records are compressed and written out on a thread of their own. The
+ * instructions can be restricted to some PC ranges, and sampled in
+ * periodic windows of committed instructions.
+ *
+ * The file starts with the magic "g5it", the version, the record size
+ * and the tick frequency, as little endian 32 bit words, followed by the
+ * records in commit order for each hardware context.
+ */
+class InstBinTrace : public InstTracer
+{
+  public:
+    /** What the instruction of a record is and did. */
+    enum RecordFlags : uint16_t
+    {
+        Control = 0x1,
+        Conditional = 0x2,
+        Call = 0x4,
+        Return = 0x8,
+        Indirect = 0x10,
+        Taken = 0x20,
+        Load = 0x40,
+        Store = 0x80,
+        MemValid = 0x100,
+        Microop = 0x200,
+        LastMicroop = 0x400,
+        Faulting = 0x800,
+        NotExecuted = 0x1000,
+        NextValid = 0x2000
+    };
+
+    struct Record
+    {
+        /** Tick the instruction committed at */
+        uint64_t tick;
+        uint64_t pc;
+        /** Effective address, with MemValid */
+        uint64_t addr;
+        /** PC of the next instruction committed, with NextValid */
+        uint64_t nextPC;
+        /** Size of the memory access, with MemValid */
+        uint32_t size;
+        /** Index of the micro-op in its macro-op */
+        uint16_t upc;
+        uint16_t opClass;
+        uint16_t flags;
+        uint16_t context;
+        /** Distance to the instruction following a control instruction */
+        uint16_t fallThrough;
+        uint16_t reserved;
+    };
+    static_assert(sizeof(Record) == 48, "Unexpected binary record size");
+
+    InstBinTrace(const InstBinTraceParams &p);
+
+    InstBinTraceRecord *getInstRecord(Tick when, ThreadContext *tc,
+                                      const StaticInstPtr si,
+                                      const PCStateBase &pc,
+                                      const StaticInstPtr mi=nullptr)
+        override;
+
+  protected:
+    /** Record a committed instruction. */
+    void traceInst(const InstRecord &inst);
+
+    /** Check if an instruction at a PC is traced. */
+    bool traced(Addr pc);
+
+    void write(const Record &rec);
+
+    /**
+     * Write out the records still waiting for the next instruction of
+     * their context, and close the file.
+     */
+    void closeStreams();
+
+    /** Only trace the instructions in these ranges, if there are any */
+    const AddrRangeList pcRanges;
+
+    /** Trace the first sampleLength of every samplePeriod instructions */
+    const Counter samplePeriod;
+    const Counter sampleLength;
+    Counter sampleCount = 0;
+
+    /**
+     * The last traced instruction of each context, which is written out
+     * once the next one tells where the control flow went.
+     */
+    struct Pending
+    {
+        Record rec;
+        bool valid = false;
+    };
+    std::vector<Pending> pending;
+
+    std::unique_ptr<BinaryTraceWriter<Record>> writer;
+    std::vector<Record> buffer;
+
+    friend class InstBinTraceRecord;
+};
+
+} // namespace Trace
+} // namespace gem5
+
+#endif // __CPU_INST_BIN_TRACE_HH__
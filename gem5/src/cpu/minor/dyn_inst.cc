@@ -231,6 +231,8 @@ MinorDynInst::~MinorDynInst()
 {
     if (traceData)
         delete traceData;
+    if (flatDestRegIdx != inlineFlatDestRegIdx)
+        delete [] flatDestRegIdx;
 }
 
 } // namespace minor
@@ -46,10 +46,12 @@
 #ifndef __CPU_MINOR_DYN_INST_HH__
 #define __CPU_MINOR_DYN_INST_HH__
 
+#include <cstddef>
 #include <iostream>
 
 #include "arch/generic/isa.hh"
 #include "base/named.hh"
+#include "base/pool_allocator.hh"
 #include "base/refcnt.hh"
 #include "base/types.hh"
 #include "cpu/inst_seq.hh"
@@ -232,17 +234,47 @@ class MinorDynInst : public RefCounted
      *  to account for delay in absolute time */
     Cycles minimumCommitCycle{0};
 
+    /** Number of flat destination register indices kept in the
+     *  instruction itself rather than allocated separately */
+    static const unsigned int inlineDestRegs = 8;
+
+  private:
+    RegId inlineFlatDestRegIdx[inlineDestRegs];
+
+  public:
     /** Flat register indices so that, when clearing the scoreboard, we
      *  have the same register indices as when the instruction was marked
-     *  up */
-    std::vector<RegId> flatDestRegIdx;
+     *  up.  This points to inlineFlatDestRegIdx unless the instruction
+     *  has more destinations than that */
+    RegId *flatDestRegIdx;
 
   public:
     MinorDynInst(StaticInstPtr si, InstId id_=InstId(), Fault fault_=NoFault) :
         staticInst(si), id(id_), fault(fault_), translationFault(NoFault),
-        flatDestRegIdx(si ? si->numDestRegs() : 0)
+        flatDestRegIdx(si && si->numDestRegs() > inlineDestRegs ?
+            new RegId[si->numDestRegs()] : inlineFlatDestRegIdx)
     { }
 
+    /** MinorDynInsts are created and destroyed for every instruction and
+     *  micro-op, so they are kept on a free list rather than going to the
+     *  system allocator each time.  See FreeListPool */
+    static void *
+    operator new(std::size_t size)
+    {
+        if (size != sizeof(MinorDynInst))
+            return ::operator new(size);
+        return FreeListPool<sizeof(MinorDynInst)>::allocate();
+    }
+
+    static void
+    operator delete(void *ptr, std::size_t size)
+    {
+        if (size != sizeof(MinorDynInst))
+            ::operator delete(ptr);
+        else
+            FreeListPool<sizeof(MinorDynInst)>::deallocate(ptr);
+    }
+
   public:
     /** The BubbleIF interface. */
     bool isBubble() const { return id.fetchSeqNum == 0; }
@@ -70,7 +70,7 @@ class Execute;
  *  separates that interface from other classes such as Pipeline, MinorCPU
  *  and DynMinorInst and makes it easier to see what state is accessed by it.
  */
-class ExecContext : public gem5::ExecContext
+class ExecContext final : public gem5::ExecContext
 {
   public:
     MinorCPU &cpu;
@@ -197,7 +197,7 @@ Fetch2::predictBranch(MinorDynInstPtr inst, BranchData &branch)
 
     /* Skip non-control/sys call instructions */
     if (inst->staticInst->isControl() || inst->staticInst->isSyscall()){
-        std::unique_ptr<PCStateBase> inst_pc(inst->pc->clone());
+        InlinePCState inst_pc(*inst->pc);
 
         /* Tried to predict */
         inst->triedToPredict = true;
@@ -208,7 +208,7 @@ Fetch2::predictBranch(MinorDynInstPtr inst, BranchData &branch)
                     inst->id.fetchSeqNum, *inst_pc, inst->id.threadId)) {
             set(branch.target, *inst_pc);
             inst->predictedTaken = true;
-            set(inst->predictedTarget, inst_pc);
+            set(inst->predictedTarget, *inst_pc);
         }
     } else {
         DPRINTF(Branch, "Not attempting prediction for inst: %s\n", *inst);
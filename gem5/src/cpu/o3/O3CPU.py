@@ -44,9 +44,11 @@ from m5.objects.BaseCPU import BaseCPU
 from m5.objects.FUPool import *
 from m5.objects.O3Checker import O3Checker
 from m5.objects.BranchPredictor import *
+from m5.objects.ValuePredictor import *
 
 class SMTFetchPolicy(ScopedEnum):
-    vals = [ 'RoundRobin', 'Branch', 'IQCount', 'LSQCount' ]
+    vals = [ 'RoundRobin', 'Branch', 'IQCount', 'LSQCount', 'ICount',
+             'MissCount' ]
 
 class SMTQueuePolicy(ScopedEnum):
     vals = [ 'Dynamic', 'Partitioned', 'Threshold' ]
@@ -87,6 +89,23 @@ class O3CPU(BaseCPU):
     fetchBufferSize = Param.Unsigned(64, "Fetch buffer size in bytes")
     fetchQueueSize = Param.Unsigned(32, "Fetch queue size in micro-ops "
                                     "per-thread")
+    ftqSize = Param.Unsigned(0, "Fetch target queue size in fetch blocks "
+        "per-thread. The queue runs ahead of fetch and prefetches its "
+        "blocks into the I-cache, 0 disables it")
+    fetchTargetTableSize = Param.Unsigned(1024, "Number of entries of the "
+        "fetch block successor table filling the fetch target queue")
+    maxIcachePrefetches = Param.Unsigned(4, "Maximum number of outstanding "
+        "fetch target queue prefetches")
+    uopCacheSize = Param.Unsigned(0, "Micro-op cache size in fetch blocks, "
+        "0 disables it")
+    uopCacheAssoc = Param.Unsigned(8, "Micro-op cache associativity")
+    uopCacheWidth = Param.Unsigned(8, "Micro-ops fetched per cycle from "
+        "blocks that hit in the micro-op cache")
+    fetchBlockPrediction = Param.Bool(False, "Fetch past direct "
+        "conditional branches and predict the branches of a fetch block "
+        "together")
+    fetchTakenBranches = Param.Unsigned(1, "Number of taken branches "
+        "fetch can follow in a cycle, 1 or 2")
 
     renameToDecodeDelay = Param.Cycles(1, "Rename to decode delay")
     iewToDecodeDelay = Param.Cycles(1, "Issue/Execute/Writeback to decode "
@@ -94,6 +113,9 @@ class O3CPU(BaseCPU):
     commitToDecodeDelay = Param.Cycles(1, "Commit to decode delay")
     fetchToDecodeDelay = Param.Cycles(1, "Fetch to decode delay")
     decodeWidth = Param.Unsigned(8, "Decode width")
+    macroOpFusion = Param.Bool(False, "Fuse compare and branch, and "
+        "load and op pairs into macro-ops that take one slot of each "
+        "pipeline stage and one ROB entry")
 
     iewToRenameDelay = Param.Cycles(1, "Issue/Execute/Writeback to rename "
                                     "delay")
@@ -159,6 +181,12 @@ class O3CPU(BaseCPU):
 
     smtNumFetchingThreads = Param.Unsigned(1, "SMT Number of Fetching Threads")
     smtFetchPolicy = Param.SMTFetchPolicy('RoundRobin', "SMT Fetch policy")
+    smtLongLoadCycles = Param.Cycles(30, "Cycles a load has to wait on "
+        "memory to be a long latency load for the MissCount fetch policy")
+    smtStallOnLongLoad = Param.Bool(False, "Do not fetch from a thread "
+        "waiting on a long latency load")
+    smtAloneIPC = VectorParam.Float([], "IPC of each thread running alone, "
+        "to report the weighted speedup and fairness (1 if not set)")
     smtLSQPolicy    = Param.SMTQueuePolicy('Partitioned',
                                            "SMT LSQ Sharing Policy")
     smtLSQThreshold = Param.Int(100, "SMT LSQ Threshold Sharing Parameter")
@@ -173,6 +201,8 @@ class O3CPU(BaseCPU):
     branchPred = Param.BranchPredictor(TournamentBP(numThreads =
                                                        Parent.numThreads),
                                        "Branch Predictor")
+    valuePred = Param.ValuePredictor(NULL,
+                                     "Load value predictor, none if not set")
     needsTSO = Param.Bool(buildEnv['TARGET_ISA'] == 'x86',
                           "Enable TSO Memory model")
 
@@ -58,6 +58,20 @@ namespace gem5
 namespace o3
 {
 
+/**
+ * Drop the references held by the first size entries of a stage's
+ * instruction array, which are the only ones a stage fills in, and mark
+ * it empty. Used by the clear() of the structs below, which the time
+ * buffers call to recycle a slot instead of reconstructing it.
+ */
+inline void
+clearInsts(DynInstPtr *insts, int &size)
+{
+    for (int i = 0; i < size; ++i)
+        insts[i] = nullptr;
+    size = 0;
+}
+
 /** Struct that defines the information passed from fetch to decode. */
 struct FetchStruct
 {
@@ -67,6 +81,15 @@ struct FetchStruct
     Fault fetchFault;
     InstSeqNum fetchFaultSN;
     bool clearFetchFault;
+
+    void
+    clear()
+    {
+        clearInsts(insts, size);
+        fetchFault = NoFault;
+        fetchFaultSN = 0;
+        clearFetchFault = false;
+    }
 };
 
 /** Struct that defines the information passed from decode to rename. */
@@ -75,6 +98,8 @@ struct DecodeStruct
     int size;
 
     DynInstPtr insts[MaxWidth];
+
+    void clear() { clearInsts(insts, size); }
 };
 
 /** Struct that defines the information passed from rename to IEW. */
@@ -83,6 +108,8 @@ struct RenameStruct
     int size;
 
     DynInstPtr insts[MaxWidth];
+
+    void clear() { clearInsts(insts, size); }
 };
 
 /** Struct that defines the information passed from IEW to commit. */
@@ -100,6 +127,22 @@ struct IEWStruct
     bool branchMispredict[MaxThreads];
     bool branchTaken[MaxThreads];
     bool includeSquashInst[MaxThreads];
+
+    void
+    clear()
+    {
+        clearInsts(insts, size);
+        for (ThreadID tid = 0; tid < MaxThreads; ++tid) {
+            mispredictInst[tid] = nullptr;
+            mispredPC[tid] = 0;
+            squashedSeqNum[tid] = 0;
+            pc[tid].reset();
+            squash[tid] = false;
+            branchMispredict[tid] = false;
+            branchTaken[tid] = false;
+            includeSquashInst[tid] = false;
+        }
+    }
 };
 
 struct IssueStruct
@@ -107,6 +150,8 @@ struct IssueStruct
     int size;
 
     DynInstPtr insts[MaxWidth];
+
+    void clear() { clearInsts(insts, size); }
 };
 
 /** Struct that defines all backwards communication. */
@@ -144,6 +189,9 @@ struct TimeStruct
 
         unsigned iqCount;
         unsigned ldstqCount;
+        /** Loads waiting on memory for a long time, see
+         * LSQ::numLongLoads(). */
+        unsigned longLoads;
 
         unsigned dispatched;
         bool usedIQ;
@@ -224,6 +272,22 @@ struct TimeStruct
     bool renameUnblock[MaxThreads];
     bool iewBlock[MaxThreads];
     bool iewUnblock[MaxThreads];
+
+    void
+    clear()
+    {
+        for (ThreadID tid = 0; tid < MaxThreads; ++tid) {
+            decodeInfo[tid] = DecodeComm();
+            iewInfo[tid] = IewComm();
+            commitInfo[tid] = CommitComm();
+            decodeBlock[tid] = false;
+            decodeUnblock[tid] = false;
+            renameBlock[tid] = false;
+            renameUnblock[tid] = false;
+            iewBlock[tid] = false;
+            iewUnblock[tid] = false;
+        }
+    }
 };
 
 } // namespace o3
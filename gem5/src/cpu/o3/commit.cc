@@ -63,7 +63,6 @@
 #include "debug/Drain.hh"
 #include "debug/ExecFaulting.hh"
 #include "debug/HtmCpu.hh"
-#include "debug/O3PipeView.hh"
 #include "params/O3CPU.hh"
 #include "sim/faults.hh"
 #include "sim/full_system.hh"
@@ -343,9 +342,31 @@ Commit::clearStates(ThreadID tid)
     pc[tid].reset(cpu->tcBase(tid)->getIsaPtr()->newPCState());
     lastCommitedSeqNum[tid] = 0;
     squashAfterInst[tid] = NULL;
+    instCountStopInst[tid] = NULL;
 }
 
-void Commit::drain() { drainPending = true; }
+void
+Commit::drain()
+{
+    drainPending = true;
+
+    for (ThreadID tid = 0; tid < numThreads; tid++) {
+        const DynInstPtr &inst = instCountStopInst[tid];
+        if (!inst || interrupt != NoFault || thread[tid]->trapPending ||
+                pc[tid]->microPC() != 0)
+            continue;
+        if (commitStatus[tid] != Running && squashAfterInst[tid] != inst)
+            continue;
+
+        // Same as when commit reaches a safe point while draining, but
+        // without committing anything past the stop.
+        DPRINTF(Drain, "Draining after count event: %i:%s\n",
+                tid, *pc[tid]);
+        squashAfter(tid, inst);
+        cpu->commitDrained(tid);
+        drainImminent = true;
+    }
+}
 
 void
 Commit::drainResume()
@@ -959,9 +980,18 @@ Commit::commitInsts()
 
     DynInstPtr head_inst;
 
+    for (ThreadID tid = 0; tid < numThreads; tid++)
+        instCountStopInst[tid] = NULL;
+
+    // Commit slots used; an instruction fused with the one ahead of it
+    // takes none, and commits along with it past the bandwidth limit.
+    unsigned commit_slots = 0;
+    bool fused_next = false;
+
     // Commit as many instructions as possible until the commit bandwidth
     // limit is reached, or it becomes impossible to commit any more.
-    while (num_committed < commitWidth) {
+    while (commit_slots < commitWidth || fused_next) {
+        fused_next = false;
         // hardware transactionally memory
         // If executing within a transaction,
         // need to handle interrupts specially
@@ -993,6 +1023,9 @@ Commit::commitInsts()
 
         assert(tid == commit_thread);
 
+        if (commit_slots >= commitWidth && !head_inst->isFused())
+            break;
+
         DPRINTF(Commit,
                 "Trying to commit head instruction, [tid:%i] [sn:%llu]\n",
                 tid, head_inst->seqNum);
@@ -1020,6 +1053,10 @@ Commit::commitInsts()
 
             if (commit_success) {
                 ++num_committed;
+                if (!head_inst->isFused())
+                    ++commit_slots;
+                fused_next = rob->isHeadReady(tid) &&
+                    rob->readHeadInst(tid)->isFused();
                 stats.committedInstType[tid][head_inst->opClass()]++;
                 ppCommit->notify(head_inst);
 
@@ -1123,6 +1160,16 @@ Commit::commitInsts()
                 if (!interrupt && avoidQuiesceLiveLock &&
                     onInstBoundary && cpu->checkInterrupts(0))
                     squashAfter(tid, head_inst);
+
+                // Stop here if an instruction count event fired so that
+                // whatever it triggers (e.g. an exit) sees the state right
+                // after the instruction it was scheduled for.
+                if (cpu->takeInstCountEvent(tid)) {
+                    DPRINTF(Commit, "Instruction count event, "
+                            "stopping commit\n");
+                    instCountStopInst[tid] = head_inst;
+                    break;
+                }
             } else {
                 DPRINTF(Commit, "Unable to commit head instruction PC:%s "
                         "[tid:%i] [sn:%llu].\n",
@@ -1135,7 +1182,22 @@ Commit::commitInsts()
     DPRINTF(CommitRate, "%i\n", num_committed);
     stats.numCommittedDist.sample(num_committed);
 
-    if (num_committed == commitWidth) {
+    // Nothing committed because a load at the head of a ROB is waiting
+    // for the memory system
+    if (num_committed == 0) {
+        for (ThreadID tid : *activeThreads) {
+            if (rob->isEmpty(tid))
+                continue;
+            const DynInstPtr &head = rob->readHeadInst(tid);
+            if (head->isLoad() && head->isIssued() &&
+                !head->readyToCommit()) {
+                cpu->baseStats.memStallCycles++;
+                break;
+            }
+        }
+    }
+
+    if (commit_slots == commitWidth) {
         stats.commitEligibleSamples++;
     }
 }
@@ -1312,11 +1374,9 @@ Commit::commitHead(const DynInstPtr &head_inst, unsigned inst_num)
     // Finally clear the head ROB entry.
     rob->retireHead(tid);
 
-#if TRACING_ON
-    if (debug::O3PipeView) {
+    if (cpu->tracePipeView()) {
         head_inst->commitTick = curTick() - head_inst->fetchTick;
     }
-#endif
 
     // If this was a store, record it for this cycle.
     if (head_inst->isStore() || head_inst->isAtomic())
@@ -1348,7 +1408,7 @@ Commit::getInsts()
 
             rob->insertInst(inst);
 
-            assert(rob->getThreadEntries(tid) <= rob->getMaxEntries(tid));
+            assert(rob->getUsedEntries(tid) <= rob->getMaxEntries(tid));
 
             youngestSeqNum[tid] = inst->seqNum;
         } else {
@@ -373,6 +373,13 @@ class Commit
      */
     DynInstPtr squashAfterInst[MaxThreads];
 
+    /**
+     * Instruction after which commit stopped for an instruction count
+     * event, cleared once commit resumes. A drain started right after
+     * the event drains from there rather than committing past it.
+     */
+    DynInstPtr instCountStopInst[MaxThreads];
+
     /** Priority List used for Commit Policy */
     std::list<ThreadID> priority_list;
 
@@ -42,6 +42,8 @@
 
 #include "cpu/o3/cpu.hh"
 
+#include <algorithm>
+
 #include "config/the_isa.hh"
 #include "cpu/activity.hh"
 #include "cpu/checker/cpu.hh"
@@ -98,7 +100,7 @@ CPU::CPU(const O3CPUParams &params)
 
       rob(this, params),
 
-      scoreboard(name() + ".scoreboard", regFile.totalNumPhysRegs(),
+      scoreboard(name() + ".scoreboard", &regFile,
               params.isa[0]->regClasses().at(IntRegClass).zeroReg()),
 
       isa(numThreads, NULL),
@@ -115,7 +117,8 @@ CPU::CPU(const O3CPUParams &params)
       globalSeqNum(1),
       system(params.system),
       lastRunningCycle(curCycle()),
-      cpuStats(this)
+      cpuStats(this, params),
+      topDownStats(this)
 {
     fatal_if(FullSystem && params.numThreads > 1,
             "SMT is not supported in O3 in full system mode currently.");
@@ -350,6 +353,8 @@ CPU::regProbePoints()
     ppDataAccessComplete = new ProbePointArg<
         std::pair<DynInstPtr, PacketPtr>>(
                 getProbeManager(), "DataAccessComplete");
+    ppPipeView = new ProbePointArg<const DynInst *>(
+            getProbeManager(), "PipeView");
 
     fetch.regProbePoints();
     rename.regProbePoints();
@@ -357,7 +362,7 @@ CPU::regProbePoints()
     commit.regProbePoints();
 }
 
-CPU::CPUStats::CPUStats(CPU *cpu)
+CPU::CPUStats::CPUStats(CPU *cpu, const O3CPUParams &params)
     : statistics::Group(cpu),
       ADD_STAT(timesIdled, statistics::units::Count::get(),
                "Number of times that the entire CPU went into an idle state "
@@ -384,6 +389,14 @@ CPU::CPUStats::CPUStats(CPU *cpu)
       ADD_STAT(totalIpc, statistics::units::Rate<
                     statistics::units::Count, statistics::units::Cycle>::get(),
                "IPC: Total IPC of All Threads"),
+      ADD_STAT(relativeIpc, statistics::units::Ratio::get(),
+               "IPC of each thread over its IPC alone"),
+      ADD_STAT(weightedSpeedup, statistics::units::Ratio::get(),
+               "Sum of the relative IPCs of the threads"),
+      ADD_STAT(hmeanSpeedup, statistics::units::Ratio::get(),
+               "Harmonic mean of the relative IPCs of the threads"),
+      ADD_STAT(fairness, statistics::units::Ratio::get(),
+               "Lowest over highest relative IPC of the threads"),
       ADD_STAT(intRegfileReads, statistics::units::Count::get(),
                "Number of integer regfile reads"),
       ADD_STAT(intRegfileWrites, statistics::units::Count::get(),
@@ -447,6 +460,34 @@ CPU::CPUStats::CPUStats(CPU *cpu)
         .precision(6);
     totalIpc = sum(committedInsts) / cpu->baseStats.numCycles;
 
+    // The IPC of each thread running alone comes from separate runs. It
+    // defaults to 1, which leaves the throughput figures as plain IPCs.
+    fatal_if(!params.smtAloneIPC.empty() &&
+             params.smtAloneIPC.size() != cpu->numThreads,
+             "%s: smtAloneIPC needs one IPC per thread (%d), has %d.\n",
+             cpu->name(), cpu->numThreads, params.smtAloneIPC.size());
+    std::vector<double> alone_ipc(params.smtAloneIPC);
+    alone_ipc.resize(cpu->numThreads, 1.0);
+    for (double alone : alone_ipc)
+        fatal_if(alone <= 0, "%s: smtAloneIPC must be positive.\n",
+                 cpu->name());
+
+    relativeIpc
+        .precision(6);
+    relativeIpc = ipc / statistics::constantVector(alone_ipc);
+
+    weightedSpeedup
+        .precision(6);
+    weightedSpeedup = sum(relativeIpc);
+
+    hmeanSpeedup
+        .precision(6);
+    hmeanSpeedup = statistics::constant(cpu->numThreads) /
+        sum(statistics::constantVector(alone_ipc) * cpi);
+
+    fairness
+        .precision(6);
+
     intRegfileReads
         .prereq(intRegfileReads);
 
@@ -484,6 +525,79 @@ CPU::CPUStats::CPUStats(CPU *cpu)
         .prereq(miscRegfileWrites);
 }
 
+void
+CPU::CPUStats::preDumpStats()
+{
+    statistics::Group::preDumpStats();
+
+    // There is no min or max in the formulas, so work out the fairness
+    // from the relative IPCs just before they are dumped.
+    statistics::VResult rel_ipc;
+    relativeIpc.result(rel_ipc);
+
+    auto [lowest, highest] =
+        std::minmax_element(rel_ipc.begin(), rel_ipc.end());
+    fairness = lowest != rel_ipc.end() && *highest > 0 ?
+        *lowest / *highest : 0;
+}
+
+CPU::TopDownStats::TopDownStats(CPU *cpu)
+    : statistics::Group(cpu, "topDown"),
+      ADD_STAT(slots, statistics::units::Count::get(),
+               "Number of rename slots"),
+      ADD_STAT(renamedSlots, statistics::units::Count::get(),
+               "Number of rename slots used by an instruction"),
+      ADD_STAT(recoverySlots, statistics::units::Count::get(),
+               "Number of rename slots lost to squash recovery"),
+      ADD_STAT(frontendLatencySlots, statistics::units::Count::get(),
+               "Number of rename slots lost in cycles when nothing was "
+               "delivered to rename"),
+      ADD_STAT(frontendBandwidthSlots, statistics::units::Count::get(),
+               "Number of rename slots lost in cycles when too few "
+               "instructions were delivered to rename"),
+      ADD_STAT(loadBoundSlots, statistics::units::Count::get(),
+               "Number of rename slots lost to a full LQ or a load waiting "
+               "on memory"),
+      ADD_STAT(storeBoundSlots, statistics::units::Count::get(),
+               "Number of rename slots lost to a full SQ or a store waiting "
+               "on memory"),
+      ADD_STAT(coreBoundSlots, statistics::units::Count::get(),
+               "Number of rename slots lost to other backend stalls"),
+      ADD_STAT(retiring, statistics::units::Ratio::get(),
+               "Fraction of rename slots used by committed ops"),
+      ADD_STAT(badSpeculation, statistics::units::Ratio::get(),
+               "Fraction of rename slots wasted on squashed instructions or "
+               "lost to squash recovery"),
+      ADD_STAT(frontendBound, statistics::units::Ratio::get(),
+               "Fraction of rename slots lost to the frontend"),
+      ADD_STAT(backendBound, statistics::units::Ratio::get(),
+               "Fraction of rename slots lost to the backend"),
+      ADD_STAT(memoryBound, statistics::units::Ratio::get(),
+               "Fraction of rename slots lost to the memory system"),
+      ADD_STAT(coreBound, statistics::units::Ratio::get(),
+               "Fraction of rename slots lost to core resources")
+{
+    for (auto *stat : {&slots, &renamedSlots, &recoverySlots,
+                       &frontendLatencySlots, &frontendBandwidthSlots,
+                       &loadBoundSlots, &storeBoundSlots, &coreBoundSlots}) {
+        stat->init(cpu->numThreads).flags(statistics::total);
+    }
+
+    const auto &committed_ops = cpu->cpuStats.committedOps;
+
+    retiring = committed_ops / slots;
+    badSpeculation = (renamedSlots - committed_ops + recoverySlots) / slots;
+    frontendBound = (frontendLatencySlots + frontendBandwidthSlots) / slots;
+    memoryBound = (loadBoundSlots + storeBoundSlots) / slots;
+    coreBound = coreBoundSlots / slots;
+    backendBound = memoryBound + coreBound;
+
+    for (auto *stat : {&retiring, &badSpeculation, &frontendBound,
+                       &backendBound, &memoryBound, &coreBound}) {
+        stat->precision(6);
+    }
+}
+
 void
 CPU::tick()
 {
@@ -1326,12 +1440,23 @@ CPU::squashFromTC(ThreadID tid)
     commit.generateTCEvent(tid);
 }
 
-CPU::ListIt
+void
 CPU::addInst(const DynInstPtr &inst)
 {
-    instList.push_back(inst);
+    instList.push_back(inst->seqNum, inst);
+    ++threadInsts[inst->threadNumber];
+}
 
-    return --(instList.end());
+unsigned
+CPU::preIssueInsts(ThreadID tid)
+{
+    // Everything on the list that has not reached the ROB yet is in the
+    // front end, and of what is in the ROB only the instructions still
+    // in the IQ wait to issue.
+    unsigned in_rob = rob.getThreadEntries(tid);
+    unsigned front_end = threadInsts[tid] > in_rob ?
+        threadInsts[tid] - in_rob : 0;
+    return front_end + iew.instQueue.getCount(tid);
 }
 
 void
@@ -1344,7 +1469,12 @@ CPU::instDone(ThreadID tid, const DynInstPtr &inst)
         cpuStats.committedInsts[tid]++;
 
         // Check for instruction-count-based events.
-        thread[tid]->comInstEventQueue.serviceEvents(thread[tid]->numInst);
+        EventQueue &inst_events = thread[tid]->comInstEventQueue;
+        if (!inst_events.empty() &&
+                inst_events.nextTick() <= thread[tid]->numInst) {
+            instCountEventServiced[tid] = true;
+            inst_events.serviceEvents(thread[tid]->numInst);
+        }
     }
     thread[tid]->numOp++;
     thread[tid]->threadStats.numOps++;
@@ -1363,7 +1493,7 @@ CPU::removeFrontInst(const DynInstPtr &inst)
     removeInstsThisCycle = true;
 
     // Remove the front instruction.
-    removeList.push(inst->getInstListIt());
+    removeList.push_back(inst->seqNum);
 }
 
 void
@@ -1372,42 +1502,26 @@ CPU::removeInstsNotInROB(ThreadID tid)
     DPRINTF(O3CPU, "Thread %i: Deleting instructions from instruction"
             " list.\n", tid);
 
-    ListIt end_it;
+    if (instList.empty())
+        return;
 
-    bool rob_empty = false;
+    // Everything younger than the youngest instruction in the ROB goes.
+    InstSeqNum end_sn;
 
-    if (instList.empty()) {
-        return;
-    } else if (rob.isEmpty(tid)) {
+    if (rob.isEmpty(tid)) {
         DPRINTF(O3CPU, "ROB is empty, squashing all insts.\n");
-        end_it = instList.begin();
-        rob_empty = true;
+        end_sn = instList.head() - 1;
     } else {
-        end_it = (rob.readTailInst(tid))->getInstListIt();
+        end_sn = rob.readTailInst(tid)->seqNum;
         DPRINTF(O3CPU, "ROB is not empty, squashing insts not in ROB.\n");
     }
 
     removeInstsThisCycle = true;
 
-    ListIt inst_it = instList.end();
-
-    inst_it--;
-
     // Walk through the instruction list, removing any instructions
-    // that were inserted after the given instruction iterator, end_it.
-    while (inst_it != end_it) {
-        assert(!instList.empty());
-
-        squashInstIt(inst_it, tid);
-
-        inst_it--;
-    }
-
-    // If the ROB was empty, then we actually need to remove the first
-    // instruction as well.
-    if (rob_empty) {
-        squashInstIt(inst_it, tid);
-    }
+    // that were inserted after the given instruction, end_sn.
+    for (InstSeqNum sn = instList.tail(); sn > end_sn; --sn)
+        squashInstIt(sn, tid);
 }
 
 void
@@ -1417,62 +1531,63 @@ CPU::removeInstsUntil(const InstSeqNum &seq_num, ThreadID tid)
 
     removeInstsThisCycle = true;
 
-    ListIt inst_iter = instList.end();
-
-    inst_iter--;
-
     DPRINTF(O3CPU, "Deleting instructions from instruction "
             "list that are from [tid:%i] and above [sn:%lli] (end=%lli).\n",
-            tid, seq_num, (*inst_iter)->seqNum);
-
-    while ((*inst_iter)->seqNum > seq_num) {
+            tid, seq_num, instList.tail());
 
-        bool break_loop = (inst_iter == instList.begin());
-
-        squashInstIt(inst_iter, tid);
-
-        inst_iter--;
-
-        if (break_loop)
+    const InstSeqNum head_sn = instList.head();
+    for (InstSeqNum sn = instList.tail(); sn > seq_num; --sn) {
+        squashInstIt(sn, tid);
+        if (sn == head_sn)
             break;
     }
 }
 
 void
-CPU::squashInstIt(const ListIt &instIt, ThreadID tid)
+CPU::squashInstIt(InstSeqNum seq_num, ThreadID tid)
 {
-    if ((*instIt)->threadNumber == tid) {
+    const DynInstPtr &inst = instList[seq_num];
+
+    if (inst && inst->threadNumber == tid) {
         DPRINTF(O3CPU, "Squashing instruction, "
                 "[tid:%i] [sn:%lli] PC %s\n",
-                (*instIt)->threadNumber,
-                (*instIt)->seqNum,
-                (*instIt)->pcState());
+                inst->threadNumber,
+                inst->seqNum,
+                inst->pcState());
 
         // Mark it as squashed.
-        (*instIt)->setSquashed();
+        inst->setSquashed();
 
         // @todo: Formulate a consistent method for deleting
         // instructions from the instruction list
         // Remove the instruction from the list.
-        removeList.push(instIt);
+        removeList.push_back(seq_num);
     }
 }
 
 void
 CPU::cleanUpRemovedInsts()
 {
-    while (!removeList.empty()) {
+    for (InstSeqNum seq_num : removeList) {
+        // An instruction may have been queued by more than one squash.
+        if (!instList.covers(seq_num) || !instList[seq_num])
+            continue;
+
         DPRINTF(O3CPU, "Removing instruction, "
                 "[tid:%i] [sn:%lli] PC %s\n",
-                (*removeList.front())->threadNumber,
-                (*removeList.front())->seqNum,
-                (*removeList.front())->pcState());
+                instList[seq_num]->threadNumber,
+                instList[seq_num]->seqNum,
+                instList[seq_num]->pcState());
 
-        instList.erase(removeList.front());
+        if (instList[seq_num]->vpHistory)
+            iew.retireValuePrediction(instList[seq_num]);
 
-        removeList.pop();
+        --threadInsts[instList[seq_num]->threadNumber];
+        instList.remove(seq_num);
     }
 
+    removeList.clear();
+
     removeInstsThisCycle = false;
 }
 /*
@@ -1487,18 +1602,21 @@ CPU::dumpInsts()
 {
     int num = 0;
 
-    ListIt inst_list_it = instList.begin();
-
     cprintf("Dumping Instruction List\n");
 
-    while (inst_list_it != instList.end()) {
+    if (instList.empty())
+        return;
+
+    for (InstSeqNum sn = instList.head(); sn <= instList.tail(); ++sn) {
+        const DynInstPtr &inst = instList[sn];
+        if (!inst)
+            continue;
         cprintf("Instruction:%i\nPC:%#x\n[tid:%i]\n[sn:%lli]\nIssued:%i\n"
                 "Squashed:%i\n\n",
-                num, (*inst_list_it)->pcState().instAddr(),
-                (*inst_list_it)->threadNumber,
-                (*inst_list_it)->seqNum, (*inst_list_it)->isIssued(),
-                (*inst_list_it)->isSquashed());
-        inst_list_it++;
+                num, inst->pcState().instAddr(),
+                inst->threadNumber,
+                inst->seqNum, inst->isIssued(),
+                inst->isSquashed());
         ++num;
     }
 }
@@ -1525,6 +1643,13 @@ CPU::wakeCPU()
         --cycles;
         cpuStats.idleCycles += cycles;
         baseStats.numCycles += cycles;
+
+        // The stages have been sitting in the state of their last tick
+        // all along, so count the skipped cycles against it in bulk.
+        fetch.skipCycles(cycles);
+        decode.skipCycles(cycles);
+        rename.skipCycles(cycles);
+        iew.skipCycles(cycles);
     }
 
     schedule(tickEvent, clockEdge());
@@ -1654,7 +1779,7 @@ CPU::htmSendAbortSignal(ThreadID tid, uint64_t htm_uid,
 
     // notify l1 d-cache (ruby) that core has aborted transaction
     RequestPtr req =
-        std::make_shared<Request>(addr, size, flags, _dataRequestorId);
+        makeRequest(addr, size, flags, _dataRequestorId);
 
     req->taskId(taskId());
     req->setContext(thread[tid]->contextId());
@@ -45,7 +45,6 @@
 
 #include <iostream>
 #include <list>
-#include <queue>
 #include <set>
 #include <vector>
 
@@ -59,6 +58,7 @@
 #include "cpu/o3/fetch.hh"
 #include "cpu/o3/free_list.hh"
 #include "cpu/o3/iew.hh"
+#include "cpu/o3/inst_ring.hh"
 #include "cpu/o3/limits.hh"
 #include "cpu/o3/rename.hh"
 #include "cpu/o3/rob.hh"
@@ -68,6 +68,7 @@
 #include "cpu/base.hh"
 #include "cpu/simple_thread.hh"
 #include "cpu/timebuf.hh"
+#include "debug/O3PipeView.hh"
 #include "params/O3CPU.hh"
 #include "sim/process.hh"
 
@@ -94,8 +95,6 @@ class ThreadContext;
 class CPU : public BaseCPU
 {
   public:
-    typedef std::list<DynInstPtr>::iterator ListIt;
-
     friend class ThreadContext;
 
   public:
@@ -174,6 +173,19 @@ class CPU : public BaseCPU
     ProbePointArg<PacketPtr> *ppInstAccessComplete;
     ProbePointArg<std::pair<DynInstPtr, PacketPtr> > *ppDataAccessComplete;
 
+    /** Notified with every instruction leaving the CPU, committed or
+     * squashed, once its pipeline stage ticks are final.
+     */
+    ProbePointArg<const DynInst *> *ppPipeView = nullptr;
+
+    /** Whether instructions should record their pipeline stage ticks. */
+    bool
+    tracePipeView() const
+    {
+        return (TRACING_ON && debug::O3PipeView) ||
+            ppPipeView->hasListeners();
+    }
+
     /** Register probe points. */
     void regProbePoints() override;
 
@@ -399,11 +411,28 @@ class CPU : public BaseCPU
     /** Function to add instruction onto the head of the list of the
      *  instructions.  Used when new instructions are fetched.
      */
-    ListIt addInst(const DynInstPtr &inst);
+    void addInst(const DynInstPtr &inst);
+
+    /** Number of instructions of a thread that were fetched and not
+     *  issued yet, as counted by the ICOUNT fetch policy. */
+    unsigned preIssueInsts(ThreadID tid);
 
     /** Function to tell the CPU that an instruction has completed. */
     void instDone(ThreadID tid, const DynInstPtr &inst);
 
+    /**
+     * Returns whether an instruction count event was serviced since the
+     * last call, and clears the flag. Commit uses this to stop at the
+     * exact instruction an event was scheduled for.
+     */
+    bool
+    takeInstCountEvent(ThreadID tid)
+    {
+        bool serviced = instCountEventServiced[tid];
+        instCountEventServiced[tid] = false;
+        return serviced;
+    }
+
     /** Remove an instruction from the front end of the list.  There's
      *  no restriction on location of the instruction.
      */
@@ -416,8 +445,9 @@ class CPU : public BaseCPU
     /** Remove all instructions younger than the given sequence number. */
     void removeInstsUntil(const InstSeqNum &seq_num, ThreadID tid);
 
-    /** Removes the instruction pointed to by the iterator. */
-    void squashInstIt(const ListIt &instIt, ThreadID tid);
+    /** Removes the instruction with the given sequence number, if it
+     *  belongs to the thread and is still in the list. */
+    void squashInstIt(InstSeqNum seq_num, ThreadID tid);
 
     /** Cleans up all instructions on the remove list. */
     void cleanUpRemovedInsts();
@@ -431,13 +461,14 @@ class CPU : public BaseCPU
     int instcount;
 #endif
 
-    /** List of all the instructions in flight. */
-    std::list<DynInstPtr> instList;
+    /** List of all the instructions in flight, indexed by sequence
+     *  number. */
+    InstRing<DynInstPtr> instList;
 
-    /** List of all the instructions that will be removed at the end of this
-     *  cycle.
+    /** Sequence numbers of all the instructions that will be removed at
+     *  the end of this cycle.
      */
-    std::queue<ListIt> removeList;
+    std::vector<InstSeqNum> removeList;
 
 #ifdef DEBUG
     /** Debug structure to keep track of the sequence numbers still in
@@ -479,6 +510,12 @@ class CPU : public BaseCPU
     /** The commit rename map. */
     UnifiedRenameMap commitRenameMap[MaxThreads];
 
+    /** Set by instDone when it services an instruction count event. */
+    bool instCountEventServiced[MaxThreads] = {};
+
+    /** Number of instructions of each thread on the instruction list. */
+    unsigned threadInsts[MaxThreads] = {};
+
     /** The re-order buffer. */
     ROB rob;
 
@@ -626,7 +663,9 @@ class CPU : public BaseCPU
 
     struct CPUStats : public statistics::Group
     {
-        CPUStats(CPU *cpu);
+        CPUStats(CPU *cpu, const O3CPUParams &params);
+
+        void preDumpStats() override;
 
         /** Stat for total number of times the CPU is descheduled. */
         statistics::Scalar timesIdled;
@@ -648,6 +687,14 @@ class CPU : public BaseCPU
         statistics::Formula ipc;
         /** Stat for the total IPC. */
         statistics::Formula totalIpc;
+        /** Stat for the IPC per thread relative to its IPC alone. */
+        statistics::Formula relativeIpc;
+        /** Stat for the sum of the relative IPCs. */
+        statistics::Formula weightedSpeedup;
+        /** Stat for the harmonic mean of the relative IPCs. */
+        statistics::Formula hmeanSpeedup;
+        /** Stat for the lowest over the highest relative IPC. */
+        statistics::Scalar fairness;
 
         //number of integer register file accesses
         statistics::Scalar intRegfileReads;
@@ -669,6 +716,48 @@ class CPU : public BaseCPU
         statistics::Scalar miscRegfileWrites;
     } cpuStats;
 
+    /**
+     * Top-down breakdown of the rename slots, per thread. Every cycle each
+     * thread is given renameWidth slots. A slot either renames an
+     * instruction or is lost: to the frontend when there is nothing to
+     * rename, to squash recovery, or to the backend when instructions are
+     * held back by a full ROB, IQ, LSQ or register file. Backend slots are
+     * charged to memory when the LSQ is full or the oldest instruction is
+     * an outstanding memory access, and to the core otherwise. Renamed
+     * slots are split into retiring and bad speculation by the number of
+     * committed ops.
+     */
+    struct TopDownStats : public statistics::Group
+    {
+        TopDownStats(CPU *cpu);
+
+        /** Rename slots available. */
+        statistics::Vector slots;
+        /** Slots used to rename an instruction. */
+        statistics::Vector renamedSlots;
+        /** Slots lost while recovering from a squash. */
+        statistics::Vector recoverySlots;
+        /** Slots lost with nothing delivered by the frontend this cycle. */
+        statistics::Vector frontendLatencySlots;
+        /** Slots lost with some, but not enough, instructions delivered. */
+        statistics::Vector frontendBandwidthSlots;
+        /** Backend slots lost to a full LQ or an outstanding load. */
+        statistics::Vector loadBoundSlots;
+        /** Backend slots lost to a full SQ or an outstanding store. */
+        statistics::Vector storeBoundSlots;
+        /** Backend slots lost to anything else. */
+        statistics::Vector coreBoundSlots;
+
+        /** Fractions of the slots in each top-level category. */
+        statistics::Formula retiring;
+        statistics::Formula badSpeculation;
+        statistics::Formula frontendBound;
+        statistics::Formula backendBound;
+        /** Fractions of the slots in the backend categories. */
+        statistics::Formula memoryBound;
+        statistics::Formula coreBound;
+    } topDownStats;
+
   public:
     // hardware transactional memory
     void htmSendAbortSignal(ThreadID tid, uint64_t htm_uid,
@@ -0,0 +1,76 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_CYCLE_STATS_HH__
+#define __CPU_O3_CYCLE_STATS_HH__
+
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+/**
+ * Remembers which per-cycle status stats (blocked, idle, squashing, ...) a
+ * stage counted in its last tick. The CPU stops ticking once no stage has
+ * anything to do, and nothing changes for these stages until it wakes up
+ * again, so each skipped cycle would have been counted against the same
+ * stats. The CPU credits the skipped cycles to them in bulk on wake up.
+ */
+class CycleStats
+{
+  private:
+    std::vector<statistics::Scalar *> lastCycle;
+
+  public:
+    /** Forget the stats counted in the previous tick. */
+    void newCycle() { lastCycle.clear(); }
+
+    /** Count this cycle against stat. */
+    void
+    count(statistics::Scalar &stat)
+    {
+        ++stat;
+        lastCycle.push_back(&stat);
+    }
+
+    /** Count cycles more cycles like the last ticked one. */
+    void
+    skip(Cycles cycles)
+    {
+        for (auto *stat : lastCycle)
+            *stat += cycles;
+    }
+};
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_CYCLE_STATS_HH__
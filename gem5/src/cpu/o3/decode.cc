@@ -48,7 +48,6 @@
 #include "cpu/o3/limits.hh"
 #include "debug/Activity.hh"
 #include "debug/Decode.hh"
-#include "debug/O3PipeView.hh"
 #include "params/O3CPU.hh"
 #include "sim/full_system.hh"
 
@@ -69,6 +68,7 @@ Decode::Decode(CPU *_cpu, const O3CPUParams &params)
       commitToDecodeDelay(params.commitToDecodeDelay),
       fetchToDecodeDelay(params.fetchToDecodeDelay),
       decodeWidth(params.decodeWidth),
+      macroOpFusion(params.macroOpFusion),
       numThreads(params.numThreads),
       stats(_cpu)
 {
@@ -85,6 +85,7 @@ Decode::Decode(CPU *_cpu, const O3CPUParams &params)
         bdelayDoneSeqNum[tid] = 0;
         squashInst[tid] = nullptr;
         squashAfterDelaySlot[tid] = 0;
+        fusingBranch[tid] = false;
     }
 }
 
@@ -142,7 +143,16 @@ Decode::DecodeStats::DecodeStats(CPU *cpu)
       ADD_STAT(decodedInsts, statistics::units::Count::get(),
                "Number of instructions handled by decode"),
       ADD_STAT(squashedInsts, statistics::units::Count::get(),
-               "Number of squashed instructions handled by decode")
+               "Number of squashed instructions handled by decode"),
+      ADD_STAT(fusedCompareBranches, statistics::units::Count::get(),
+               "Number of compares fused with a conditional branch"),
+      ADD_STAT(fusedLoadOps, statistics::units::Count::get(),
+               "Number of loads fused with the op using their result"),
+      ADD_STAT(fusedInsts, statistics::units::Count::get(),
+               "Number of instructions fused into the one ahead of them"),
+      ADD_STAT(fusionRate, statistics::units::Ratio::get(),
+               "Fraction of decoded instructions that were fused",
+               fusedInsts / decodedInsts)
 {
     idleCycles.prereq(idleCycles);
     blockedCycles.prereq(blockedCycles);
@@ -154,6 +164,10 @@ Decode::DecodeStats::DecodeStats(CPU *cpu)
     controlMispred.prereq(controlMispred);
     decodedInsts.prereq(decodedInsts);
     squashedInsts.prereq(squashedInsts);
+    fusedCompareBranches.prereq(fusedCompareBranches);
+    fusedLoadOps.prereq(fusedLoadOps);
+    fusedInsts.prereq(fusedInsts);
+    fusionRate.prereq(fusedInsts);
 }
 
 void
@@ -334,6 +348,9 @@ Decode::squash(const DynInstPtr &inst, ThreadID tid)
         skidBuffer[tid].pop();
     }
 
+    lastDecoded[tid] = nullptr;
+    fusingBranch[tid] = false;
+
     // Squash instructions up until this one
     cpu->removeInstsUntil(squash_seq_num, tid);
 }
@@ -382,6 +399,9 @@ Decode::squash(ThreadID tid)
         skidBuffer[tid].pop();
     }
 
+    lastDecoded[tid] = nullptr;
+    fusingBranch[tid] = false;
+
     return squash_count;
 }
 
@@ -544,10 +564,12 @@ void
 Decode::tick()
 {
     wroteToTimeBuffer = false;
+    cycleStats.newCycle();
 
     bool status_change = false;
 
     toRenameIndex = 0;
+    decodeSlots = 0;
 
     list<ThreadID>::iterator threads = activeThreads->begin();
     list<ThreadID>::iterator end = activeThreads->end();
@@ -586,9 +608,9 @@ Decode::decode(bool &status_change, ThreadID tid)
     //     check if stall conditions have passed
 
     if (decodeStatus[tid] == Blocked) {
-        ++stats.blockedCycles;
+        cycleStats.count(stats.blockedCycles);
     } else if (decodeStatus[tid] == Squashing) {
-        ++stats.squashCycles;
+        cycleStats.count(stats.squashCycles);
     }
 
     // Decode should try to decode as many instructions as its bandwidth
@@ -631,14 +653,14 @@ Decode::decodeInsts(ThreadID tid)
         DPRINTF(Decode, "[tid:%i] Nothing to do, breaking out"
                 " early.\n",tid);
         // Should I change the status to idle?
-        ++stats.idleCycles;
+        cycleStats.count(stats.idleCycles);
         return;
     } else if (decodeStatus[tid] == Unblocking) {
         DPRINTF(Decode, "[tid:%i] Unblocking, removing insts from skid "
                 "buffer.\n",tid);
-        ++stats.unblockCycles;
+        cycleStats.count(stats.unblockCycles);
     } else if (decodeStatus[tid] == Running) {
-        ++stats.runCycles;
+        cycleStats.count(stats.runCycles);
     }
 
     std::queue<DynInstPtr>
@@ -647,9 +669,20 @@ Decode::decodeInsts(ThreadID tid)
 
     DPRINTF(Decode, "[tid:%i] Sending instruction to rename.\n",tid);
 
-    while (insts_available > 0 && toRenameIndex < decodeWidth) {
+    // Instructions only fuse within a decode group.
+    lastDecoded[tid] = nullptr;
+    fusingBranch[tid] = false;
+
+    while (insts_available > 0 && toRenameIndex < MaxWidth) {
         assert(!insts_to_decode.empty());
 
+        // Once the decode slots are used up only the squashed and the
+        // fused instructions get through.
+        const DynInstPtr &front = insts_to_decode.front();
+        bool fused = !front->isSquashed() && fusesWithPrevious(front, tid);
+        if (decodeSlots >= decodeWidth && !front->isSquashed() && !fused)
+            break;
+
         DynInstPtr inst = std::move(insts_to_decode.front());
 
         insts_to_decode.pop();
@@ -677,6 +710,25 @@ Decode::decodeInsts(ThreadID tid)
             inst->setCanIssue();
         }
 
+        if (fused) {
+            DPRINTF(Decode, "[tid:%i] [sn:%llu] Fused with [sn:%llu].\n",
+                    tid, inst->seqNum, lastDecoded[tid]->seqNum);
+            if (lastDecoded[tid]->isLoad()) {
+                ++stats.fusedLoadOps;
+            } else if (!fusingBranch[tid]) {
+                ++stats.fusedCompareBranches;
+            }
+            ++stats.fusedInsts;
+            inst->setFused();
+            // The rest of the branch macroop fuses with the compare too.
+            fusingBranch[tid] = !lastDecoded[tid]->isLoad() &&
+                inst->isMicroop() && !inst->isLastMicroop();
+        } else {
+            ++decodeSlots;
+            fusingBranch[tid] = false;
+        }
+        lastDecoded[tid] = inst;
+
         // This current instruction is valid, so add it into the decode
         // queue.  The next instruction may not be valid, so check to
         // see if branches were predicted correctly.
@@ -687,11 +739,9 @@ Decode::decodeInsts(ThreadID tid)
         ++stats.decodedInsts;
         --insts_available;
 
-#if TRACING_ON
-        if (debug::O3PipeView) {
+        if (cpu->tracePipeView()) {
             inst->decodeTick = curTick() - inst->fetchTick;
         }
-#endif
 
         // Ensure that if it was predicted as a branch, it really is a
         // branch.
@@ -748,5 +798,68 @@ Decode::decodeInsts(ThreadID tid)
     }
 }
 
+bool
+Decode::isCondBranchMacroop(const DynInstPtr &inst)
+{
+    if (!inst->isMicroop())
+        return inst->isCondCtrl() && inst->isDirectCtrl();
+
+    if (!inst->isFirstMicroop() || !inst->macroop)
+        return false;
+
+    // Look ahead in the macroop, which may compute the target before it
+    // branches, but must not do anything else.
+    const unsigned max_microops = 4;
+    MicroPC upc = inst->pcState().microPC();
+    StaticInstPtr uop = inst->staticInst;
+    for (unsigned i = 0; i < max_microops; ++i) {
+        if (uop->isLastMicroop())
+            return uop->isCondCtrl() && uop->isDirectCtrl();
+        if (uop->isMemRef() || uop->isControl() ||
+                uop->numCCDestRegs() > 0) {
+            return false;
+        }
+        uop = inst->macroop->fetchMicroop(++upc);
+    }
+    return false;
+}
+
+bool
+Decode::fusesWithPrevious(const DynInstPtr &inst, ThreadID tid) const
+{
+    if (!macroOpFusion)
+        return false;
+
+    if (fusingBranch[tid])
+        return true;
+
+    const DynInstPtr &prev = lastDecoded[tid];
+    if (!prev || prev->isFused() || prev->isSquashed())
+        return false;
+
+    // A compare, a macroop that only writes the condition codes, fuses
+    // with a conditional branch.
+    bool prev_ends_macroop = !prev->isMicroop() || prev->isLastMicroop();
+    if (prev_ends_macroop && prev->numCCDestRegs() > 0 &&
+            !prev->isMemRef() && !prev->isControl() &&
+            !prev->isSerializing() && isCondBranchMacroop(inst)) {
+        return true;
+    }
+
+    // A load microop fuses with the next microop of its macroop when that
+    // one operates on the loaded value.
+    if (prev->isLoad() && prev->isMicroop() && !prev->isLastMicroop() &&
+            prev->numDestRegs() > 0 && !inst->isMemRef() &&
+            !inst->isControl() && !inst->isSerializing()) {
+        const RegId &loaded = prev->destRegIdx(0);
+        for (int i = 0; i < inst->numSrcRegs(); ++i) {
+            if (inst->srcRegIdx(i) == loaded)
+                return true;
+        }
+    }
+
+    return false;
+}
+
 } // namespace o3
 } // namespace gem5
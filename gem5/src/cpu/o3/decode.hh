@@ -45,6 +45,7 @@
 
 #include "base/statistics.hh"
 #include "cpu/o3/comm.hh"
+#include "cpu/o3/cycle_stats.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
 #include "cpu/o3/limits.hh"
 #include "cpu/timebuf.hh"
@@ -136,6 +137,9 @@ class Decode
      */
     void tick();
 
+    /** Accounts for cycles skipped while the CPU was not ticking. */
+    void skipCycles(Cycles cycles) { cycleStats.skip(cycles); }
+
     /** Determines what to do based on decode's current status.
      * @param status_change decode() sets this variable if there was a status
      * change (ie switching from from blocking to unblocking).
@@ -191,6 +195,22 @@ class Decode
      */
     bool unblock(ThreadID tid);
 
+    /**
+     * Whether an instruction fuses with the one decoded before it, into a
+     * single macro-op that takes one decode, rename, dispatch and commit
+     * slot and one ROB entry. A compare fuses with the conditional branch
+     * behind it, and a load microop with the microop that consumes its
+     * result.
+     */
+    bool fusesWithPrevious(const DynInstPtr &inst, ThreadID tid) const;
+
+    /**
+     * Whether an instruction starts a direct conditional branch macroop,
+     * or is one, whose microops ahead of the branch only compute its
+     * target.
+     */
+    static bool isCondBranchMacroop(const DynInstPtr &inst);
+
     /** Squashes if there is a PC-relative branch that was predicted
      * incorrectly. Sends squash information back to fetch.
      */
@@ -246,6 +266,9 @@ class Decode
      */
     bool wroteToTimeBuffer;
 
+    /** Per-cycle status stats counted in the last tick. */
+    CycleStats cycleStats;
+
     /** Source of possible stalls. */
     struct Stalls
     {
@@ -273,6 +296,19 @@ class Decode
     /** Index of instructions being sent to rename. */
     unsigned toRenameIndex;
 
+    /** Whether to fuse pairs of instructions into macro-ops. */
+    const bool macroOpFusion;
+
+    /** Decode slots used this cycle; fused instructions take none. */
+    unsigned decodeSlots;
+
+    /** The last instruction decoded this cycle, per thread. */
+    DynInstPtr lastDecoded[MaxThreads];
+
+    /** Whether the microops of a branch macroop being decoded are fused
+     *  with the compare ahead of it. */
+    bool fusingBranch[MaxThreads];
+
     /** number of Active Threads*/
     ThreadID numThreads;
 
@@ -320,6 +356,14 @@ class Decode
         statistics::Scalar decodedInsts;
         /** Stat for total number of squashed instructions. */
         statistics::Scalar squashedInsts;
+        /** Stat for number of compares fused with a branch. */
+        statistics::Scalar fusedCompareBranches;
+        /** Stat for number of loads fused with the op using them. */
+        statistics::Scalar fusedLoadOps;
+        /** Stat for number of instructions fused into the one ahead. */
+        statistics::Scalar fusedInsts;
+        /** Fraction of decoded instructions that were fused. */
+        statistics::Formula fusionRate;
     } stats;
 };
 
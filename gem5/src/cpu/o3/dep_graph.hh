@@ -41,7 +41,11 @@
 #ifndef __CPU_O3_DEP_GRAPH_HH__
 #define __CPU_O3_DEP_GRAPH_HH__
 
+#include <vector>
+
+#include "base/cprintf.hh"
 #include "cpu/o3/comm.hh"
+#include "cpu/o3/inst_bit_matrix.hh"
 
 namespace gem5
 {
@@ -49,91 +53,71 @@ namespace gem5
 namespace o3
 {
 
-/** Node in a linked list. */
-template <class DynInstPtr>
-class DependencyEntry
-{
-  public:
-    DependencyEntry()
-        : inst(NULL), next(NULL)
-    { }
-
-    DynInstPtr inst;
-    //Might want to include data about what arch. register the
-    //dependence is waiting on.
-    DependencyEntry<DynInstPtr> *next;
-};
-
-/** Array of linked list that maintains the dependencies between
- * producing instructions and consuming instructions.  Each linked
- * list represents a single physical register, having the future
- * producer of the register's value, and all consumers waiting on that
- * value on the list.  The head node of each linked list represents
- * the producing instruction of that register.  Instructions are put
- * on the list upon reaching the IQ, and are removed from the list
+/** Maintains the dependencies between producing instructions and
+ * consuming instructions.  Each physical register has the future
+ * producer of the register's value, and a bitmap of all consumers
+ * waiting on that value, indexed by sequence number.  Instructions are
+ * added to the bitmap upon reaching the IQ, and are removed from it
  * either when the producer completes, or the instruction is squashed.
+ * A consumer reading the same register through several of its sources
+ * is recorded once.
 */
 template <class DynInstPtr>
 class DependencyGraph
 {
   public:
-    typedef DependencyEntry<DynInstPtr> DepEntry;
-
     /** Default construction.  Must call resize() prior to use. */
     DependencyGraph()
-        : numEntries(0), memAllocCounter(0), nodesTraversed(0), nodesRemoved(0)
+        : numEntries(0), nodesTraversed(0), nodesRemoved(0)
     { }
 
-    ~DependencyGraph();
-
     /** Resize the dependency graph to have num_entries registers. */
     void resize(int num_entries);
 
-    /** Clears all of the linked lists. */
+    /** Clears all of the dependencies. */
     void reset();
 
     /** Inserts an instruction to be dependent on the given index. */
-    void insert(RegIndex idx, const DynInstPtr &new_inst);
+    void insert(RegIndex idx, const DynInstPtr &new_inst)
+    { consumers.set(idx, new_inst->seqNum, new_inst); }
 
     /** Sets the producing instruction of a given register. */
     void setInst(RegIndex idx, const DynInstPtr &new_inst)
-    { dependGraph[idx].inst = new_inst; }
+    { producers[idx] = new_inst; }
 
     /** Clears the producing instruction. */
     void clearInst(RegIndex idx)
-    { dependGraph[idx].inst = NULL; }
+    { producers[idx] = NULL; }
 
-    /** Removes an instruction from a single linked list. */
+    /** Removes an instruction from the dependents of a register. */
     void remove(RegIndex idx, const DynInstPtr &inst_to_remove);
 
-    /** Removes and returns the newest dependent of a specific register. */
+    /** Removes and returns the youngest dependent of a specific register. */
     DynInstPtr pop(RegIndex idx);
 
     /** Checks if the entire dependency graph is empty. */
-    bool empty() const;
+    bool empty() const { return consumers.empty(); }
 
     /** Checks if there are any dependents on a specific register. */
-    bool empty(RegIndex idx) const { return !dependGraph[idx].next; }
+    bool empty(RegIndex idx) const { return consumers.empty(idx); }
 
     /** Debugging function to dump out the dependency graph.
      */
     void dump();
 
   private:
-    /** Array of linked lists.  Each linked list is a list of all the
-     *  instructions that depend upon a given register.  The actual
-     *  register's index is used to index into the graph; ie all
-     *  instructions in flight that are dependent upon r34 will be
-     *  in the linked list of dependGraph[34].
+    /** Producing instruction of each register. */
+    std::vector<DynInstPtr> producers;
+
+    /** One row per register, holding all the instructions in flight
+     *  that depend upon it; ie all instructions dependent upon r34 are
+     *  in row 34.
      */
-    std::vector<DepEntry> dependGraph;
+    InstBitMatrix<DynInstPtr> consumers;
 
-    /** Number of linked lists; identical to the number of registers. */
+    /** Number of registers. */
     int numEntries;
 
-    // Debug variable, remove when done testing.
-    unsigned memAllocCounter;
-
   public:
     // Debug variable, remove when done testing.
     uint64_t nodesTraversed;
@@ -141,161 +125,75 @@ class DependencyGraph
     uint64_t nodesRemoved;
 };
 
-template <class DynInstPtr>
-DependencyGraph<DynInstPtr>::~DependencyGraph()
-{
-}
-
 template <class DynInstPtr>
 void
 DependencyGraph<DynInstPtr>::resize(int num_entries)
 {
     numEntries = num_entries;
-    dependGraph.resize(numEntries);
+    producers.resize(numEntries);
+    consumers.resize(numEntries);
 }
 
 template <class DynInstPtr>
 void
 DependencyGraph<DynInstPtr>::reset()
 {
-    // Clear the dependency graph
-    DepEntry *curr;
-    DepEntry *prev;
-
-    for (int i = 0; i < numEntries; ++i) {
-        curr = dependGraph[i].next;
-
-        while (curr) {
-            memAllocCounter--;
-
-            prev = curr;
-            curr = prev->next;
-            prev->inst = NULL;
-
-            delete prev;
-        }
-
-        if (dependGraph[i].inst) {
-            dependGraph[i].inst = NULL;
-        }
-
-        dependGraph[i].next = NULL;
-    }
-}
-
-template <class DynInstPtr>
-void
-DependencyGraph<DynInstPtr>::insert(RegIndex idx, const DynInstPtr &new_inst)
-{
-    //Add this new, dependent instruction at the head of the dependency
-    //chain.
+    consumers.clear();
 
-    // First create the entry that will be added to the head of the
-    // dependency chain.
-    DepEntry *new_entry = new DepEntry;
-    new_entry->next = dependGraph[idx].next;
-    new_entry->inst = new_inst;
-
-    // Then actually add it to the chain.
-    dependGraph[idx].next = new_entry;
-
-    ++memAllocCounter;
+    for (auto &producer : producers)
+        producer = NULL;
 }
 
-
 template <class DynInstPtr>
 void
 DependencyGraph<DynInstPtr>::remove(RegIndex idx,
                                     const DynInstPtr &inst_to_remove)
 {
-    DepEntry *prev = &dependGraph[idx];
-    DepEntry *curr = dependGraph[idx].next;
-
-    // Make sure curr isn't NULL.  Because this instruction is being
-    // removed from a dependency list, it must have been placed there at
-    // an earlier time.  The dependency chain should not be empty,
-    // unless the instruction dependent upon it is already ready.
-    if (curr == NULL) {
-        return;
-    }
-
-    nodesRemoved++;
-
-    // Find the instruction to remove within the dependency linked list.
-    while (curr->inst != inst_to_remove) {
-        prev = curr;
-        curr = curr->next;
-        nodesTraversed++;
-
-        assert(curr != NULL);
-    }
-
-    // Now remove this instruction from the list.
-    prev->next = curr->next;
-
-    --memAllocCounter;
-
-    // Could push this off to the destructor of DependencyEntry
-    curr->inst = NULL;
-
-    delete curr;
+    // The instruction may already have been woken up, or removed through
+    // another of its sources reading the same register.
+    if (consumers.reset(idx, inst_to_remove->seqNum))
+        nodesRemoved++;
 }
 
 template <class DynInstPtr>
 DynInstPtr
 DependencyGraph<DynInstPtr>::pop(RegIndex idx)
 {
-    DepEntry *node;
-    node = dependGraph[idx].next;
-    DynInstPtr inst = NULL;
-    if (node) {
-        inst = node->inst;
-        dependGraph[idx].next = node->next;
-        node->inst = NULL;
-        memAllocCounter--;
-        delete node;
-    }
-    return inst;
-}
+    if (consumers.empty(idx))
+        return NULL;
 
-template <class DynInstPtr>
-bool
-DependencyGraph<DynInstPtr>::empty() const
-{
-    for (int i = 0; i < numEntries; ++i) {
-        if (!empty(i))
-            return false;
-    }
-    return true;
+    const InstSeqNum seq_num = consumers.youngest(idx);
+    DynInstPtr inst = consumers[seq_num];
+    consumers.reset(idx, seq_num);
+    nodesTraversed++;
+    return inst;
 }
 
 template <class DynInstPtr>
 void
 DependencyGraph<DynInstPtr>::dump()
 {
-    DepEntry *curr;
-
     for (int i = 0; i < numEntries; ++i)
     {
-        curr = &dependGraph[i];
-
-        if (curr->inst) {
+        if (producers[i]) {
             cprintf("dependGraph[%i]: producer: %s [sn:%lli] consumer: ",
-                    i, curr->inst->pcState(), curr->inst->seqNum);
+                    i, producers[i]->pcState(), producers[i]->seqNum);
         } else {
             cprintf("dependGraph[%i]: No producer. consumer: ", i);
         }
 
-        while (curr->next != NULL) {
-            curr = curr->next;
-
-            cprintf("%s [sn:%lli] ",
-                    curr->inst->pcState(), curr->inst->seqNum);
+        if (!consumers.empty(i)) {
+            const InstSeqNum youngest = consumers.youngest(i);
+            for (InstSeqNum sn = consumers.oldest(i); sn <= youngest; ++sn) {
+                if (consumers.test(i, sn)) {
+                    cprintf("%s [sn:%lli] ",
+                            consumers[sn]->pcState(), consumers[sn]->seqNum);
+                }
+            }
         }
 
         cprintf("\n");
     }
-    cprintf("memAllocCounter: %i\n", memAllocCounter);
 }
 
 } // namespace o3
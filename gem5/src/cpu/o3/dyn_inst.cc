@@ -41,6 +41,7 @@
 #include "cpu/o3/dyn_inst.hh"
 
 #include <algorithm>
+#include <cstddef>
 
 #include "base/intmath.hh"
 #include "debug/DynInst.hh"
@@ -53,6 +54,40 @@ namespace gem5
 namespace o3
 {
 
+namespace
+{
+
+/*
+ * DynInst buffers are recycled through free lists, one per size class, so
+ * that fetching instructions, most of which are squashed or retired soon
+ * after, does not go to the heap once the in-flight window has been
+ * filled. Every buffer starts with a header recording its size class, as
+ * operator delete is only told the size of the DynInst itself. The lists
+ * are per-thread, like the packet pools, and never give memory back.
+ */
+constexpr size_t dynInstGranularity = 64;
+constexpr size_t numDynInstSizeClasses = 32;
+
+union DynInstHeader
+{
+    size_t sizeClass;
+    std::max_align_t align;
+};
+
+struct FreeDynInst
+{
+    FreeDynInst *next;
+};
+
+FreeDynInst *&
+freeDynInsts(size_t size_class)
+{
+    thread_local FreeDynInst *lists[numDynInstSizeClasses] = {};
+    return lists[size_class];
+}
+
+} // anonymous namespace
+
 DynInst::DynInst(const Arrays &arrays, const StaticInstPtr &static_inst,
         const StaticInstPtr &_macroop, InstSeqNum seq_num, CPU *_cpu)
     : seqNum(seq_num), staticInst(static_inst), cpu(_cpu),
@@ -167,8 +202,23 @@ DynInst::operator new(size_t count, Arrays &arrays)
     // Figure out how much space we need in total.
     size_t total_size = ready_src_idx + ready_src_idx_size;
 
-    // Actually allocate it.
-    uint8_t *buf = (uint8_t *)::operator new(total_size);
+    // Actually allocate it, reusing a buffer of the same size class if
+    // one was freed. Buffers too large for the classes use the heap.
+    const size_t size_class =
+        divCeil(sizeof(DynInstHeader) + total_size, dynInstGranularity);
+    DynInstHeader *header;
+    if (size_class >= numDynInstSizeClasses) {
+        header = (DynInstHeader *)::operator new(
+                sizeof(DynInstHeader) + total_size);
+    } else if (FreeDynInst *free_inst = freeDynInsts(size_class)) {
+        freeDynInsts(size_class) = free_inst->next;
+        header = (DynInstHeader *)free_inst;
+    } else {
+        header = (DynInstHeader *)::operator new(
+                size_class * dynInstGranularity);
+    }
+    header->sizeClass = size_class;
+    uint8_t *buf = (uint8_t *)(header + 1);
 
     // Fill in "arrays" with pointers to all the arrays.
     arrays.flatDestIdx = (RegId *)(buf + flat_dest_idx);
@@ -187,6 +237,24 @@ DynInst::operator new(size_t count, Arrays &arrays)
     return buf;
 }
 
+void
+DynInst::operator delete(void *ptr)
+{
+    if (!ptr)
+        return;
+
+    DynInstHeader *header = (DynInstHeader *)ptr - 1;
+    const size_t size_class = header->sizeClass;
+    if (size_class >= numDynInstSizeClasses) {
+        ::operator delete(header);
+        return;
+    }
+
+    FreeDynInst *free_inst = (FreeDynInst *)header;
+    free_inst->next = freeDynInsts(size_class);
+    freeDynInsts(size_class) = free_inst;
+}
+
 DynInst::~DynInst()
 {
     /*
@@ -242,6 +310,9 @@ DynInst::~DynInst()
     }
 #endif
 
+    if (fetchTick != -1 && cpu && cpu->ppPipeView)
+        cpu->ppPipeView->notify(this);
+
     delete [] memData;
     delete traceData;
     fault = NoFault;
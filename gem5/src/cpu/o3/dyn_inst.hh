@@ -45,7 +45,6 @@
 #include <algorithm>
 #include <array>
 #include <deque>
-#include <list>
 #include <string>
 
 #include "base/refcnt.hh"
@@ -73,16 +72,13 @@ class Packet;
 namespace o3
 {
 
-class DynInst : public ExecContext, public RefCounted
+class DynInst final : public ExecContext, public RefCounted
 {
   private:
     DynInst(const StaticInstPtr &staticInst, const StaticInstPtr &macroop,
             InstSeqNum seq_num, CPU *cpu);
 
   public:
-    // The list of instructions iterator type.
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
-
     struct Arrays
     {
         size_t numSrcs;
@@ -96,6 +92,7 @@ class DynInst : public ExecContext, public RefCounted
     };
 
     static void *operator new(size_t count, Arrays &arrays);
+    static void operator delete(void *ptr);
 
     /** BaseDynInst constructor given a binary instruction. */
     DynInst(const Arrays &arrays, const StaticInstPtr &staticInst,
@@ -187,6 +184,9 @@ class DynInst : public ExecContext, public RefCounted
         ReqMade,
         MemOpDone,
         HtmFromTransaction,
+        ValuePredicted,
+        ValueLoaded,
+        Fused,
         MaxFlags
     };
 
@@ -197,6 +197,12 @@ class DynInst : public ExecContext, public RefCounted
     /** The status of this BaseDynInst.  Several bits can be set. */
     std::bitset<NumStatus> status;
 
+    /** The value predicted for a load. */
+    RegVal _predictedValue = 0;
+
+    /** The value a load read. */
+    RegVal _loadedValue = 0;
+
   protected:
     /** The result of the instruction; assumes an instruction can have many
      *  destination registers.
@@ -204,7 +210,7 @@ class DynInst : public ExecContext, public RefCounted
     std::queue<InstResult> instResult;
 
     /** PC state for this instruction. */
-    std::unique_ptr<PCStateBase> pc;
+    InlinePCState pc;
 
     /** Values to be written to the destination misc. registers. */
     std::vector<RegVal> _destMiscRegVal;
@@ -316,12 +322,9 @@ class DynInst : public ExecContext, public RefCounted
     /** The thread this instruction is from. */
     ThreadID threadNumber = 0;
 
-    /** Iterator pointing to this BaseDynInst in the list of all insts. */
-    ListIt instListIt;
-
     ////////////////////// Branch Data ///////////////
     /** Predicted PC state after this instruction. */
-    std::unique_ptr<PCStateBase> predPC;
+    InlinePCState predPC;
 
     /** The Macroop if one exists */
     const StaticInstPtr macroop;
@@ -381,6 +384,35 @@ class DynInst : public ExecContext, public RefCounted
     bool notAnInst() const { return instFlags[NotAnInst]; }
     void setNotAnInst() { instFlags[NotAnInst] = true; }
 
+    /** Whether the instruction was fused with the one ahead of it, and
+     *  shares its pipeline slots and ROB entry. */
+    bool isFused() const { return instFlags[Fused]; }
+    void setFused() { instFlags[Fused] = true; }
+
+    /** Whether the dependents of the load were woken up with a predicted
+     *  value, and that value. */
+    bool valuePredicted() const { return instFlags[ValuePredicted]; }
+    RegVal predictedValue() const { return _predictedValue; }
+    void
+    predictedValue(RegVal value)
+    {
+        instFlags[ValuePredicted] = true;
+        _predictedValue = value;
+    }
+
+    /** Whether the load read its value, and that value. */
+    bool valueLoaded() const { return instFlags[ValueLoaded]; }
+    RegVal loadedValue() const { return _loadedValue; }
+    void
+    loadedValue(RegVal value)
+    {
+        instFlags[ValueLoaded] = true;
+        _loadedValue = value;
+    }
+
+    /** Record of the value predictor lookup of the load, if any. */
+    void *vpHistory = nullptr;
+
 
     ////////////////////////////////////////////
     //
@@ -528,7 +560,7 @@ class DynInst : public ExecContext, public RefCounted
     bool
     mispredicted()
     {
-        std::unique_ptr<PCStateBase> next_pc(pc->clone());
+        InlinePCState next_pc(*pc);
         staticInst->advancePC(*next_pc);
         return *next_pc != *predPC;
     }
@@ -944,12 +976,6 @@ class DynInst : public ExecContext, public RefCounted
     /** Assert this instruction has generated a memory request. */
     void setRequest() { instFlags[ReqMade] = true; }
 
-    /** Returns iterator to this instruction in the list of all insts. */
-    ListIt &getInstListIt() { return instListIt; }
-
-    /** Sets iterator for this instruction in the list of all insts. */
-    void setInstListIt(ListIt _instListIt) { instListIt = _instListIt; }
-
   public:
     /** Returns the number of consecutive store conditional failures. */
     unsigned int
@@ -61,7 +61,6 @@
 #include "debug/Drain.hh"
 #include "debug/Fetch.hh"
 #include "debug/O3CPU.hh"
-#include "debug/O3PipeView.hh"
 #include "mem/packet.hh"
 #include "params/O3CPU.hh"
 #include "sim/byteswap.hh"
@@ -99,8 +98,19 @@ Fetch::Fetch(CPU *_cpu, const O3CPUParams &params)
       fetchQueueSize(params.fetchQueueSize),
       numThreads(params.numThreads),
       numFetchingThreads(params.smtNumFetchingThreads),
+      stallOnLongLoad(params.smtStallOnLongLoad),
       icachePort(this, _cpu),
-      finishTranslationEvent(this), fetchStats(_cpu, this)
+      finishTranslationEvent(this),
+      ftqSize(params.ftqSize),
+      maxIcachePrefetches(params.maxIcachePrefetches),
+      outstandingPrefetches(0),
+      fetchTargets(ftqSize ? params.fetchTargetTableSize : 1,
+                   fetchBufferSize),
+      uopCache(params.uopCacheSize, params.uopCacheAssoc, fetchBufferSize),
+      uopCacheWidth(params.uopCacheSize ? params.uopCacheWidth : 0),
+      blockPrediction(params.fetchBlockPrediction),
+      maxTakenBranches(params.fetchTakenBranches),
+      fetchStats(_cpu, this)
 {
     if (numThreads > MaxThreads)
         fatal("numThreads (%d) is larger than compiled limit (%d),\n"
@@ -110,6 +120,13 @@ Fetch::Fetch(CPU *_cpu, const O3CPUParams &params)
         fatal("fetchWidth (%d) is larger than compiled limit (%d),\n"
              "\tincrease MaxWidth in src/cpu/o3/limits.hh\n",
              fetchWidth, static_cast<int>(MaxWidth));
+    if (uopCacheWidth > MaxWidth)
+        fatal("uopCacheWidth (%d) is larger than compiled limit (%d),\n"
+             "\tincrease MaxWidth in src/cpu/o3/limits.hh\n",
+             uopCacheWidth, static_cast<int>(MaxWidth));
+    fatal_if(maxTakenBranches < 1 || maxTakenBranches > 2,
+             "fetchTakenBranches must be 1 or 2, got %d\n",
+             maxTakenBranches);
     if (fetchBufferSize > cacheBlkSize)
         fatal("fetch buffer size (%u bytes) is greater than the cache "
               "block size (%u bytes)\n", fetchBufferSize, cacheBlkSize);
@@ -131,10 +148,24 @@ Fetch::Fetch(CPU *_cpu, const O3CPUParams &params)
         fetchBufferValid[i] = false;
         lastIcacheStall[i] = 0;
         issuePipelinedIfetch[i] = false;
+        ftqBlock[i] = MaxAddr;
+        lastFetchBlock[i] = MaxAddr;
+        lastPrefetch[i] = MaxAddr;
     }
 
     branchPred = params.branchPred;
 
+    // The predictor keeps a fixed number of in-flight branches per thread.
+    // Every instruction in the ROB or between fetch and rename may be a
+    // branch, so anything smaller than that window can overflow it.
+    if (branchPred->historyCapacity() <
+            params.numROBEntries + fetchQueueSize) {
+        warn("%s: maxInFlightBranches (%u) is smaller than the ROB plus "
+             "the fetch queue (%u)\n", branchPred->name(),
+             branchPred->historyCapacity(),
+             params.numROBEntries + fetchQueueSize);
+    }
+
     for (ThreadID tid = 0; tid < numThreads; tid++) {
         decoder[tid] = params.decoder[tid];
         // Create space to buffer the cache line data,
@@ -197,6 +228,26 @@ Fetch::FetchStatGroup::FetchStatGroup(CPU *cpu, Fetch *fetch)
              "Number of outstanding Icache misses that were squashed"),
     ADD_STAT(tlbSquashes, statistics::units::Count::get(),
              "Number of outstanding ITLB misses that were squashed"),
+    ADD_STAT(ftqPrefetches, statistics::units::Count::get(),
+             "Number of I-cache prefetches sent by the fetch target queue"),
+    ADD_STAT(ftqResteers, statistics::units::Count::get(),
+             "Number of times fetch left the fetch target queue path"),
+    ADD_STAT(uopCacheHits, statistics::units::Count::get(),
+             "Number of fetch blocks that hit in the micro-op cache"),
+    ADD_STAT(uopCacheMisses, statistics::units::Count::get(),
+             "Number of fetch blocks that missed in the micro-op cache"),
+    ADD_STAT(longLoadStalls, statistics::units::Count::get(),
+             "Number of times a thread was not fetched from while waiting "
+             "on a long latency load"),
+    ADD_STAT(blockPredictions, statistics::units::Count::get(),
+             "Number of fetch blocks whose branches were predicted "
+             "together"),
+    ADD_STAT(blockDroppedInsts, statistics::units::Count::get(),
+             "Number of instructions fetched behind a taken branch of a "
+             "fetch block and dropped"),
+    ADD_STAT(secondTakenBranches, statistics::units::Count::get(),
+             "Number of taken branches fetch followed after another one in "
+             "the same cycle"),
     ADD_STAT(nisnDist, statistics::units::Count::get(),
              "Number of instructions fetched each cycle (Total)"),
     ADD_STAT(idleRate, statistics::units::Ratio::get(),
@@ -246,9 +297,26 @@ Fetch::FetchStatGroup::FetchStatGroup(CPU *cpu, Fetch *fetch)
             .prereq(icacheSquashes);
         tlbSquashes
             .prereq(tlbSquashes);
+        ftqPrefetches
+            .prereq(ftqPrefetches);
+        ftqResteers
+            .prereq(ftqResteers);
+        uopCacheHits
+            .prereq(uopCacheHits);
+        uopCacheMisses
+            .prereq(uopCacheMisses);
+        longLoadStalls
+            .prereq(longLoadStalls);
+        blockPredictions
+            .prereq(blockPredictions);
+        blockDroppedInsts
+            .prereq(blockDroppedInsts);
+        secondTakenBranches
+            .prereq(secondTakenBranches);
         nisnDist
             .init(/* base value */ 0,
-              /* last value */ fetch->fetchWidth,
+              /* last value */ std::max(fetch->fetchWidth,
+                                        fetch->uopCacheWidth),
               /* bucket size */ 1)
             .flags(statistics::pdf);
         idleRate
@@ -308,6 +376,9 @@ Fetch::clearStates(ThreadID tid)
     fetchBufferPC[tid] = 0;
     fetchBufferValid[tid] = false;
     fetchQueue[tid].clear();
+    fetchTargetQueue[tid].clear();
+    ftqBlock[tid] = MaxAddr;
+    lastFetchBlock[tid] = MaxAddr;
 
     // TODO not sure what to do with priorityList for now
     // priorityList.push_back(tid);
@@ -350,6 +421,14 @@ Fetch::resetStage()
 void
 Fetch::processCacheCompletion(PacketPtr pkt)
 {
+    if (pkt->req->isPrefetch()) {
+        // Fetch target prefetches only fill the I-cache.
+        assert(outstandingPrefetches);
+        --outstandingPrefetches;
+        delete pkt;
+        return;
+    }
+
     ThreadID tid = cpu->contextToThread(pkt->req->contextId());
 
     DPRINTF(Fetch, "[tid:%i] Waking up from cache miss.\n", tid);
@@ -550,6 +629,87 @@ Fetch::lookupAndUpdateNextPC(const DynInstPtr &inst, PCStateBase &next_pc)
     return predict_taken;
 }
 
+bool
+Fetch::addToFetchBlock(const DynInstPtr &inst, PCStateBase &next_pc,
+                       bool branching)
+{
+    if (fetchBlock.startPC == MaxAddr)
+        fetchBlock.startPC = inst->pcState().instAddr();
+
+    if (!inst->isControl()) {
+        inst->staticInst->advancePC(next_pc);
+        inst->setPredTarg(next_pc);
+        inst->setPredTaken(false);
+        // Fetch must not halt on a quiesce behind a taken branch.
+        return !inst->isQuiesce() || fetchBlock.empty();
+    }
+
+    ++fetchStats.branches;
+    fetchBlockInsts[fetchBlock.numBranches] = inst;
+    fetchBlock.append(inst->staticInst, inst->seqNum, next_pc);
+
+    // Fetch can only carry on behind a branch that falls through to the
+    // next macro-op, and whose target does not depend on the prediction
+    // of anything but its direction.
+    if (fetchBlock.full() || branching || !inst->isCondCtrl() ||
+        !inst->isDirectCtrl() || inst->isCall() || inst->isReturn() ||
+        (inst->isMicroop() && !inst->isLastMicroop())) {
+        return false;
+    }
+
+    inst->staticInst->advancePC(next_pc);
+    inst->setPredTarg(next_pc);
+    inst->setPredTaken(false);
+    return true;
+}
+
+const branch_prediction::BPredUnit::BlockBranch *
+Fetch::predictFetchBlock(ThreadID tid, PCStateBase &next_pc)
+{
+    assert(!fetchBlock.empty());
+    ++fetchStats.blockPredictions;
+
+    const unsigned num_branches = fetchBlock.numBranches;
+    const unsigned exit = branchPred->predictBlock(fetchBlock, tid);
+    const unsigned last = std::min(exit, num_branches - 1);
+
+    for (unsigned i = 0; i <= last; ++i) {
+        const auto &branch = fetchBlock.branches[i];
+        DPRINTF(Fetch, "[tid:%i] [sn:%llu] Branch of the fetch block "
+                "predicted to go to %s\n", tid, branch.seqNum, *branch.pc);
+        fetchBlockInsts[i]->setPredTarg(*branch.pc);
+        fetchBlockInsts[i]->setPredTaken(branch.taken);
+        if (branch.taken)
+            ++fetchStats.predictedBranches;
+    }
+
+    for (unsigned i = 0; i < num_branches; ++i)
+        fetchBlockInsts[i] = nullptr;
+    fetchBlock.clear();
+
+    if (exit == num_branches)
+        return nullptr;
+
+    // Drop what was fetched on the fall through path of the taken branch.
+    set(next_pc, *fetchBlock.branches[exit].pc);
+
+    const InstSeqNum exit_sn = fetchBlock.branches[exit].seqNum;
+    auto &queue = fetchQueue[tid];
+    unsigned dropped = 0;
+    while (!queue.empty() && queue.back()->seqNum > exit_sn) {
+        queue.pop_back();
+        ++dropped;
+    }
+    if (dropped) {
+        DPRINTF(Fetch, "[tid:%i] Dropping %i instructions fetched behind "
+                "taken branch [sn:%llu]\n", tid, dropped, exit_sn);
+        cpu->removeInstsUntil(exit_sn, tid);
+        numInst -= dropped;
+        fetchStats.blockDroppedInsts += dropped;
+    }
+    return &fetchBlock.branches[exit];
+}
+
 bool
 Fetch::fetchCacheLine(Addr vaddr, ThreadID tid, Addr pc)
 {
@@ -582,7 +742,7 @@ Fetch::fetchCacheLine(Addr vaddr, ThreadID tid, Addr pc)
     // Setup the memReq to do a read of the first instruction's address.
     // Set the appropriate read size and flags as well.
     // Build request here.
-    RequestPtr mem_req = std::make_shared<Request>(
+    RequestPtr mem_req = makeRequest(
         fetchBufferBlockPC, fetchBufferSize,
         Request::INST_FETCH, cpu->instRequestorId(), pc,
         cpu->thread[tid]->contextId());
@@ -632,6 +792,9 @@ Fetch::finishTranslation(const Fault &fault, const RequestPtr &mem_req)
             return;
         }
 
+        if (ftqSize)
+            trainFetchTargets(tid, fetchBufferBlockPC, mem_req->getPaddr());
+
         // Build packet here.
         PacketPtr data_pkt = new Packet(mem_req, MemCmd::ReadReq);
         data_pkt->dataDynamic(new uint8_t[fetchBufferSize]);
@@ -747,6 +910,13 @@ Fetch::doSquash(const PCStateBase &new_pc, const DynInstPtr squashInst,
     // Empty fetch queue
     fetchQueue[tid].clear();
 
+    // Restart the fetch target queue from the new PC. The squashing
+    // instruction's block is followed by the block of the new PC.
+    fetchTargetQueue[tid].clear();
+    ftqBlock[tid] = MaxAddr;
+    lastFetchBlock[tid] = squashInst ?
+        fetchBufferAlignPC(squashInst->pcState().instAddr()) : MaxAddr;
+
     // microops are being squashed, it is not known wheather the
     // youngest non-squashed microop was  marked delayed commit
     // or not. Setting the flag to true ensures that the
@@ -754,7 +924,7 @@ Fetch::doSquash(const PCStateBase &new_pc, const DynInstPtr squashInst,
     // some opportunities to handle interrupts may be missed.
     delayedCommit[tid] = true;
 
-    ++fetchStats.squashCycles;
+    cycleStats.count(fetchStats.squashCycles);
 }
 
 void
@@ -843,6 +1013,7 @@ Fetch::tick()
     bool status_change = false;
 
     wroteToTimeBuffer = false;
+    cycleStats.newCycle();
 
     for (ThreadID i = 0; i < numThreads; ++i) {
         issuePipelinedIfetch[i] = false;
@@ -869,6 +1040,9 @@ Fetch::tick()
         }
     }
 
+    std::fill(std::begin(fetchedThisCycle), std::end(fetchedThisCycle),
+              false);
+
     for (threadFetched = 0; threadFetched < numFetchingThreads;
          threadFetched++) {
         // Fetch each of the actively fetching threads.
@@ -890,6 +1064,11 @@ Fetch::tick()
         }
     }
 
+    if (ftqSize) {
+        for (auto tid : *activeThreads)
+            runFetchTargetQueue(tid);
+    }
+
     // Send instructions enqueued into the fetch queue to decode.
     // Limit rate by fetchWidth.  Stall if decode is stalled.
     unsigned insts_to_decode = 0;
@@ -1075,7 +1254,7 @@ Fetch::buildInst(ThreadID tid, StaticInstPtr staticInst,
 #endif
 
     // Add instruction to the CPU's list of instructions.
-    instruction->setInstListIt(cpu->addInst(instruction));
+    cpu->addInst(instruction);
 
     // Write the instruction to the first slot in the queue
     // that heads to decode.
@@ -1113,6 +1292,8 @@ Fetch::fetch(bool &status_change)
         return;
     }
 
+    fetchedThisCycle[tid] = true;
+
     DPRINTF(Fetch, "Attempting to fetch from [tid:%i]\n", tid);
 
     // The current PC.
@@ -1147,24 +1328,24 @@ Fetch::fetch(bool &status_change)
             fetchCacheLine(fetchAddr, tid, this_pc.instAddr());
 
             if (fetchStatus[tid] == IcacheWaitResponse)
-                ++fetchStats.icacheStallCycles;
+                cycleStats.count(fetchStats.icacheStallCycles);
             else if (fetchStatus[tid] == ItlbWait)
-                ++fetchStats.tlbCycles;
+                cycleStats.count(fetchStats.tlbCycles);
             else
-                ++fetchStats.miscStallCycles;
+                cycleStats.count(fetchStats.miscStallCycles);
             return;
         } else if (checkInterrupt(this_pc.instAddr()) &&
                 !delayedCommit[tid]) {
             // Stall CPU if an interrupt is posted and we're not issuing
             // an delayed commit micro-op currently (delayed commit
             // instructions are not interruptable by interrupts, only faults)
-            ++fetchStats.miscStallCycles;
+            cycleStats.count(fetchStats.miscStallCycles);
             DPRINTF(Fetch, "[tid:%i] Fetch is stalled!\n", tid);
             return;
         }
     } else {
         if (fetchStatus[tid] == Idle) {
-            ++fetchStats.idleCycles;
+            cycleStats.count(fetchStats.idleCycles);
             DPRINTF(Fetch, "[tid:%i] Fetch is idle!\n", tid);
         }
 
@@ -1174,7 +1355,19 @@ Fetch::fetch(bool &status_change)
 
     ++fetchStats.cycles;
 
-    std::unique_ptr<PCStateBase> next_pc(this_pc.clone());
+    // Fetch blocks held in the micro-op cache skip the legacy decoders, so
+    // more of their micro-ops can be delivered in a cycle.
+    unsigned width = fetchWidth;
+    if (uopCacheWidth) {
+        if (uopCache.access(fetchBufferAlignPC(fetchAddr), tid)) {
+            ++fetchStats.uopCacheHits;
+            width = uopCacheWidth;
+        } else {
+            ++fetchStats.uopCacheMisses;
+        }
+    }
+
+    InlinePCState next_pc(this_pc);
 
     StaticInstPtr staticInst = NULL;
     StaticInstPtr curMacroop = macroop[tid];
@@ -1190,6 +1383,9 @@ Fetch::fetch(bool &status_change)
     // ended this fetch block.
     bool predictedBranch = false;
 
+    // Number of taken branches followed so far.
+    unsigned takenBranches = 0;
+
     // Need to halt fetch if quiesce instruction detected
     bool quiesce = false;
 
@@ -1200,9 +1396,9 @@ Fetch::fetch(bool &status_change)
     const Addr pc_mask = dec_ptr->pcMask();
 
     // Loop through instruction memory from the cache.
-    // Keep issuing while fetchWidth is available and branch is not
+    // Keep issuing while fetch width is available and branch is not
     // predicted taken
-    while (numInst < fetchWidth && fetchQueue[tid].size() < fetchQueueSize
+    while (numInst < width && fetchQueue[tid].size() < fetchQueueSize
            && !predictedBranch && !quiesce) {
         // We need to process more memory if we aren't going to get a
         // StaticInst from the rom, the current macroop, or what's already
@@ -1276,20 +1472,40 @@ Fetch::fetch(bool &status_change)
             ppFetch->notify(instruction);
             numInst++;
 
-#if TRACING_ON
-            if (debug::O3PipeView) {
+            if (cpu->tracePipeView()) {
                 instruction->fetchTick = curTick();
             }
-#endif
 
             set(next_pc, this_pc);
 
             // If we're branching after this instruction, quit fetching
-            // from the same block.
-            predictedBranch |= this_pc.branching();
-            predictedBranch |= lookupAndUpdateNextPC(instruction, *next_pc);
-            if (predictedBranch) {
+            // from the same block, unless fetch can follow another taken
+            // branch this cycle.
+            const bool branching = this_pc.branching();
+            bool taken;
+            if (!blockPrediction) {
+                taken = lookupAndUpdateNextPC(instruction, *next_pc);
+            } else if (addToFetchBlock(instruction, *next_pc, branching)) {
+                taken = false;
+            } else {
+                // This instruction ends the fetch block.
+                const auto *exit = predictFetchBlock(tid, *next_pc);
+                taken = exit;
+                if (!exit) {
+                    set(next_pc, instruction->readPredTarg());
+                } else if (exit->seqNum != instruction->seqNum) {
+                    // An older branch of the block was taken, this
+                    // instruction and the ones before it up to the branch
+                    // are gone, as is what the decoder has of the path.
+                    dec_ptr->reset();
+                    newMacro = true;
+                }
+            }
+            if (branching || taken) {
                 DPRINTF(Fetch, "Branch detected with PC = %s\n", this_pc);
+                if (takenBranches++)
+                    ++fetchStats.secondTakenBranches;
+                predictedBranch = takenBranches >= maxTakenBranches;
             }
 
             newMacro |= this_pc.instAddr() != next_pc->instAddr();
@@ -1305,7 +1521,7 @@ Fetch::fetch(bool &status_change)
                 curMacroop = NULL;
             }
 
-            if (instruction->isQuiesce()) {
+            if (instruction->isQuiesce() && !instruction->isSquashed()) {
                 DPRINTF(Fetch,
                         "Quiesce instruction encountered, halting fetch!\n");
                 fetchStatus[tid] = QuiescePending;
@@ -1314,7 +1530,7 @@ Fetch::fetch(bool &status_change)
                 break;
             }
         } while ((curMacroop || dec_ptr->instReady()) &&
-                 numInst < fetchWidth &&
+                 numInst < width &&
                  fetchQueue[tid].size() < fetchQueueSize);
 
         // Re-evaluate whether the next instruction to fetch is in micro-op ROM
@@ -1322,10 +1538,23 @@ Fetch::fetch(bool &status_change)
         inRom = isRomMicroPC(this_pc.microPC());
     }
 
+    // Predict the branches fetched since the last prediction, fetch
+    // resumes at the taken one next cycle.
+    if (!fetchBlock.empty()) {
+        if (predictFetchBlock(tid, *next_pc)) {
+            set(this_pc, *next_pc);
+            inRom = isRomMicroPC(this_pc.microPC());
+            curMacroop = NULL;
+            pcOffset = 0;
+            dec_ptr->reset();
+            predictedBranch = true;
+        }
+    }
+
     if (predictedBranch) {
         DPRINTF(Fetch, "[tid:%i] Done fetching, predicted branch "
                 "instruction encountered.\n", tid);
-    } else if (numInst >= fetchWidth) {
+    } else if (numInst >= width) {
         DPRINTF(Fetch, "[tid:%i] Done fetching, reached fetch bandwidth "
                 "for this cycle.\n", tid);
     } else if (blkOffset >= fetchBufferSize) {
@@ -1395,6 +1624,10 @@ Fetch::getFetchingThread()
             return lsqCount();
           case SMTFetchPolicy::Branch:
             return branchCount();
+          case SMTFetchPolicy::ICount:
+            return icount();
+          case SMTFetchPolicy::MissCount:
+            return missCount();
           default:
             return InvalidThreadID;
         }
@@ -1430,9 +1663,10 @@ Fetch::roundRobin()
 
         assert(high_pri <= numThreads);
 
-        if (fetchStatus[high_pri] == Running ||
-            fetchStatus[high_pri] == IcacheAccessComplete ||
-            fetchStatus[high_pri] == Idle) {
+        if ((fetchStatus[high_pri] == Running ||
+             fetchStatus[high_pri] == IcacheAccessComplete ||
+             fetchStatus[high_pri] == Idle) &&
+            !longLoadStalled(high_pri)) {
 
             priorityList.erase(pri_iter);
             priorityList.push_back(high_pri);
@@ -1446,82 +1680,101 @@ Fetch::roundRobin()
     return InvalidThreadID;
 }
 
-ThreadID
-Fetch::iqCount()
+bool
+Fetch::longLoadStalled(ThreadID tid)
 {
-    //sorted from lowest->highest
-    std::priority_queue<unsigned, std::vector<unsigned>,
-                        std::greater<unsigned> > PQ;
-    std::map<unsigned, ThreadID> threadMap;
+    // A thread waiting on a load that missed far down the hierarchy
+    // would only fill the shared queues with instructions that cannot
+    // issue, so leave the fetch bandwidth to the others.
+    if (!stallOnLongLoad || fromIEW->iewInfo[tid].longLoads == 0)
+        return false;
 
-    std::list<ThreadID>::iterator threads = activeThreads->begin();
-    std::list<ThreadID>::iterator end = activeThreads->end();
+    ++fetchStats.longLoadStalls;
+    return true;
+}
 
-    while (threads != end) {
-        ThreadID tid = *threads++;
-        unsigned iqCount = fromIEW->iewInfo[tid].iqCount;
+bool
+Fetch::canFetchFrom(ThreadID tid)
+{
+    return (fetchStatus[tid] == Running ||
+            fetchStatus[tid] == IcacheAccessComplete ||
+            fetchStatus[tid] == Idle) &&
+        !fetchedThisCycle[tid] && !longLoadStalled(tid);
+}
 
-        //we can potentially get tid collisions if two threads
-        //have the same iqCount, but this should be rare.
-        PQ.push(iqCount);
-        threadMap[iqCount] = tid;
+template <typename Count>
+ThreadID
+Fetch::fewestFirst(Count count)
+{
+    // The priority list is in least recently picked order, so keeping
+    // the first of the threads with the lowest count breaks the ties
+    // round robin.
+    auto best = priorityList.end();
+    uint64_t best_count = 0;
+
+    for (auto it = priorityList.begin(); it != priorityList.end(); ++it) {
+        ThreadID tid = *it;
+        assert(tid <= numThreads);
+
+        if (!canFetchFrom(tid))
+            continue;
+
+        uint64_t tid_count = count(tid);
+        if (best == priorityList.end() || tid_count < best_count) {
+            best = it;
+            best_count = tid_count;
+        }
     }
 
-    while (!PQ.empty()) {
-        ThreadID high_pri = threadMap[PQ.top()];
+    if (best == priorityList.end())
+        return InvalidThreadID;
 
-        if (fetchStatus[high_pri] == Running ||
-            fetchStatus[high_pri] == IcacheAccessComplete ||
-            fetchStatus[high_pri] == Idle)
-            return high_pri;
-        else
-            PQ.pop();
+    ThreadID high_pri = *best;
+    priorityList.erase(best);
+    priorityList.push_back(high_pri);
 
-    }
+    return high_pri;
+}
 
-    return InvalidThreadID;
+ThreadID
+Fetch::iqCount()
+{
+    return fewestFirst([this](ThreadID tid) {
+        return fromIEW->iewInfo[tid].iqCount;
+    });
 }
 
 ThreadID
 Fetch::lsqCount()
 {
-    //sorted from lowest->highest
-    std::priority_queue<unsigned, std::vector<unsigned>,
-                        std::greater<unsigned> > PQ;
-    std::map<unsigned, ThreadID> threadMap;
-
-    std::list<ThreadID>::iterator threads = activeThreads->begin();
-    std::list<ThreadID>::iterator end = activeThreads->end();
-
-    while (threads != end) {
-        ThreadID tid = *threads++;
-        unsigned ldstqCount = fromIEW->iewInfo[tid].ldstqCount;
-
-        //we can potentially get tid collisions if two threads
-        //have the same iqCount, but this should be rare.
-        PQ.push(ldstqCount);
-        threadMap[ldstqCount] = tid;
-    }
-
-    while (!PQ.empty()) {
-        ThreadID high_pri = threadMap[PQ.top()];
+    return fewestFirst([this](ThreadID tid) {
+        return fromIEW->iewInfo[tid].ldstqCount;
+    });
+}
 
-        if (fetchStatus[high_pri] == Running ||
-            fetchStatus[high_pri] == IcacheAccessComplete ||
-            fetchStatus[high_pri] == Idle)
-            return high_pri;
-        else
-            PQ.pop();
-    }
+ThreadID
+Fetch::branchCount()
+{
+    return fewestFirst([this](ThreadID tid) {
+        return branchPred->numInFlight(tid);
+    });
+}
 
-    return InvalidThreadID;
+ThreadID
+Fetch::icount()
+{
+    return fewestFirst([this](ThreadID tid) {
+        return cpu->preIssueInsts(tid);
+    });
 }
 
 ThreadID
-Fetch::branchCount()
+Fetch::missCount()
 {
-    panic("Branch Count Fetch policy unimplemented\n");
-    return InvalidThreadID;
+    return fewestFirst([this](ThreadID tid) {
+        return (uint64_t(fromIEW->iewInfo[tid].longLoads) << 32) |
+            cpu->preIssueInsts(tid);
+    });
 }
 
 void
@@ -1553,6 +1806,97 @@ Fetch::pipelineIcacheAccesses(ThreadID tid)
     }
 }
 
+void
+Fetch::trainFetchTargets(ThreadID tid, Addr block, Addr paddr)
+{
+    if (lastFetchBlock[tid] != MaxAddr && lastFetchBlock[tid] != block)
+        fetchTargets.update(lastFetchBlock[tid], {block, paddr});
+    lastFetchBlock[tid] = block;
+}
+
+void
+Fetch::runFetchTargetQueue(ThreadID tid)
+{
+    switch (fetchStatus[tid]) {
+      case Idle:
+      case Squashing:
+      case TrapPending:
+      case QuiescePending:
+      case NoGoodAddr:
+        return;
+      default:
+        break;
+    }
+
+    const PCStateBase &this_pc = *pc[tid];
+    Addr fetchAddr = (this_pc.instAddr() + fetchOffset[tid]) &
+        decoder[tid]->pcMask();
+    Addr block = fetchBufferAlignPC(fetchAddr);
+
+    auto &ftq = fetchTargetQueue[tid];
+    if (block != ftqBlock[tid]) {
+        // Retire the targets up to the block fetch moved to. If fetch went
+        // somewhere the queue did not predict, start over from there.
+        while (!ftq.empty() && ftq.front().vaddr != block)
+            ftq.pop_front();
+        if (!ftq.empty())
+            ftq.pop_front();
+        else if (ftqBlock[tid] != MaxAddr)
+            ++fetchStats.ftqResteers;
+        ftqBlock[tid] = block;
+    }
+
+    // The table provides one target per cycle.
+    if (ftq.size() >= ftqSize)
+        return;
+
+    FetchTargetTable::Target target;
+    if (!fetchTargets.lookup(ftq.empty() ? block : ftq.back().vaddr, target))
+        return;
+
+    ftq.push_back(target);
+    prefetchFetchTarget(tid, target);
+}
+
+void
+Fetch::prefetchFetchTarget(ThreadID tid,
+                           const FetchTargetTable::Target &target)
+{
+    Addr blk_addr = target.paddr & ~Addr(cacheBlkSize - 1);
+
+    if (cacheBlocked || cpu->isDraining() ||
+            outstandingPrefetches >= maxIcachePrefetches ||
+            blk_addr == lastPrefetch[tid]) {
+        return;
+    }
+
+    lastPrefetch[tid] = blk_addr;
+
+    // The translation was recorded on an earlier fetch and may be stale.
+    if (!cpu->system->isMemAddr(blk_addr))
+        return;
+
+    RequestPtr req = makeRequest(blk_addr, cacheBlkSize,
+        Request::INST_FETCH | Request::PREFETCH, cpu->instRequestorId());
+    req->taskId(cpu->taskId());
+
+    PacketPtr pkt = new Packet(req, MemCmd::SoftPFReq);
+    pkt->allocate();
+
+    if (!icachePort.sendTimingReq(pkt)) {
+        // Drop the prefetch and wait for the retry like a squashed access.
+        delete pkt;
+        cacheBlocked = true;
+        return;
+    }
+
+    DPRINTF(Fetch, "[tid:%i] Prefetching fetch target %#x (%#x).\n",
+            tid, target.vaddr, blk_addr);
+
+    ++outstandingPrefetches;
+    ++fetchStats.ftqPrefetches;
+}
+
 void
 Fetch::profileStall(ThreadID tid)
 {
@@ -1561,35 +1905,35 @@ Fetch::profileStall(ThreadID tid)
     // @todo Per-thread stats
 
     if (stalls[tid].drain) {
-        ++fetchStats.pendingDrainCycles;
+        cycleStats.count(fetchStats.pendingDrainCycles);
         DPRINTF(Fetch, "Fetch is waiting for a drain!\n");
     } else if (activeThreads->empty()) {
-        ++fetchStats.noActiveThreadStallCycles;
+        cycleStats.count(fetchStats.noActiveThreadStallCycles);
         DPRINTF(Fetch, "Fetch has no active thread!\n");
     } else if (fetchStatus[tid] == Blocked) {
-        ++fetchStats.blockedCycles;
+        cycleStats.count(fetchStats.blockedCycles);
         DPRINTF(Fetch, "[tid:%i] Fetch is blocked!\n", tid);
     } else if (fetchStatus[tid] == Squashing) {
-        ++fetchStats.squashCycles;
+        cycleStats.count(fetchStats.squashCycles);
         DPRINTF(Fetch, "[tid:%i] Fetch is squashing!\n", tid);
     } else if (fetchStatus[tid] == IcacheWaitResponse) {
-        ++fetchStats.icacheStallCycles;
+        cycleStats.count(fetchStats.icacheStallCycles);
         DPRINTF(Fetch, "[tid:%i] Fetch is waiting cache response!\n",
                 tid);
     } else if (fetchStatus[tid] == ItlbWait) {
-        ++fetchStats.tlbCycles;
+        cycleStats.count(fetchStats.tlbCycles);
         DPRINTF(Fetch, "[tid:%i] Fetch is waiting ITLB walk to "
                 "finish!\n", tid);
     } else if (fetchStatus[tid] == TrapPending) {
-        ++fetchStats.pendingTrapStallCycles;
+        cycleStats.count(fetchStats.pendingTrapStallCycles);
         DPRINTF(Fetch, "[tid:%i] Fetch is waiting for a pending trap!\n",
                 tid);
     } else if (fetchStatus[tid] == QuiescePending) {
-        ++fetchStats.pendingQuiesceStallCycles;
+        cycleStats.count(fetchStats.pendingQuiesceStallCycles);
         DPRINTF(Fetch, "[tid:%i] Fetch is waiting for a pending quiesce "
                 "instruction!\n", tid);
     } else if (fetchStatus[tid] == IcacheWaitRetry) {
-        ++fetchStats.icacheWaitRetryStallCycles;
+        cycleStats.count(fetchStats.icacheWaitRetryStallCycles);
         DPRINTF(Fetch, "[tid:%i] Fetch is waiting for an I-cache retry!\n",
                 tid);
     } else if (fetchStatus[tid] == NoGoodAddr) {
@@ -46,7 +46,9 @@
 #include "base/statistics.hh"
 #include "config/the_isa.hh"
 #include "cpu/o3/comm.hh"
+#include "cpu/o3/cycle_stats.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
+#include "cpu/o3/fetch_target.hh"
 #include "cpu/o3/limits.hh"
 #include "cpu/pc_event.hh"
 #include "cpu/pred/bpred_unit.hh"
@@ -286,6 +288,29 @@ class Fetch
      */
     bool lookupAndUpdateNextPC(const DynInstPtr &inst, PCStateBase &pc);
 
+    /**
+     * Adds an instruction to the fetch block when the branches of fetch
+     * blocks are predicted together. Direct conditional branches are
+     * assumed not taken until the block is predicted, so fetch carries on
+     * behind them.
+     * @param next_pc The PC of the instruction, advanced to its fall
+     * through PC if the instruction was handled.
+     * @param branching Whether the PC state of the instruction branches.
+     * @return Whether the instruction was handled, if not it ends the
+     * block and the block has to be predicted.
+     */
+    bool addToFetchBlock(const DynInstPtr &inst, PCStateBase &next_pc,
+                         bool branching);
+
+    /**
+     * Predicts the branches of the fetch block, and drops the
+     * instructions fetched behind the taken one, if any.
+     * @param next_pc Set to the target of the taken branch, if any.
+     * @return The taken branch, nullptr if none is.
+     */
+    const branch_prediction::BPredUnit::BlockBranch *
+    predictFetchBlock(ThreadID tid, PCStateBase &next_pc);
+
     /**
      * Fetches the cache line that contains the fetch PC.  Returns any
      * fault that happened.  Puts the data into the class variable
@@ -337,6 +362,9 @@ class Fetch
      */
     void tick();
 
+    /** Accounts for cycles skipped while the CPU was not ticking. */
+    void skipCycles(Cycles cycles) { cycleStats.skip(cycles); }
+
     /** Checks all input signals and updates the status as necessary.
      *  @return: Returns if the status has changed due to input signals.
      */
@@ -381,9 +409,45 @@ class Fetch
      * policy. */
     ThreadID branchCount();
 
+    /** Returns the appropriate thread to fetch using the ICOUNT policy,
+     * fewest instructions not issued yet first. */
+    ThreadID icount();
+
+    /** Returns the appropriate thread to fetch using the miss count
+     * policy, fewest long latency loads first, then ICOUNT. */
+    ThreadID missCount();
+
+    /**
+     * Pick the thread with the lowest count that can be fetched from,
+     * ties going to the one which was picked least recently.
+     *
+     * @param count Function giving the count of a thread
+     */
+    template <typename Count>
+    ThreadID fewestFirst(Count count);
+
+    /** Check if a thread can be picked by a priority based policy. */
+    bool canFetchFrom(ThreadID tid);
+
+    /** Check if a thread is kept from fetching by a long latency load. */
+    bool longLoadStalled(ThreadID tid);
+
     /** Pipeline the next I-cache access to the current one. */
     void pipelineIcacheAccesses(ThreadID tid);
 
+    /** Record the block a thread translated for the fetch target table. */
+    void trainFetchTargets(ThreadID tid, Addr block, Addr paddr);
+
+    /**
+     * Retire the fetch target queue entries fetch has reached and add the
+     * next predicted fetch block to the queue.
+     */
+    void runFetchTargetQueue(ThreadID tid);
+
+    /** Prefetch a fetch target into the I-cache. */
+    void prefetchFetchTarget(ThreadID tid,
+                             const FetchTargetTable::Target &target);
+
     /** Profile the reasons of fetch stall. */
     void profileStall(ThreadID tid);
 
@@ -430,6 +494,9 @@ class Fetch
      */
     bool wroteToTimeBuffer;
 
+    /** Per-cycle status stats counted in the last tick. */
+    CycleStats cycleStats;
+
     /** Tracks how many instructions has been fetched this cycle. */
     int numInst;
 
@@ -514,6 +581,12 @@ class Fetch
     /** Thread ID being fetched. */
     ThreadID threadFetched;
 
+    /** Threads already fetched from this cycle. */
+    bool fetchedThisCycle[MaxThreads];
+
+    /** Do not fetch from a thread waiting on a long latency load. */
+    const bool stallOnLongLoad;
+
     /** Checks if there is an interrupt pending.  If there is, fetch
      * must stop once it is not fetching PAL instructions.
      */
@@ -528,6 +601,51 @@ class Fetch
     /** Event used to delay fault generation of translation faults */
     FinishTranslationEvent finishTranslationEvent;
 
+    /** Number of fetch target queue entries, 0 if it is disabled. */
+    unsigned ftqSize;
+
+    /** Maximum number of outstanding fetch target prefetches. */
+    unsigned maxIcachePrefetches;
+
+    /** Number of fetch target prefetches sent to the I-cache. */
+    unsigned outstandingPrefetches;
+
+    /** Successor of each recently fetched block. */
+    FetchTargetTable fetchTargets;
+
+    /** Blocks predicted to be fetched after ftqBlock, oldest first. */
+    std::deque<FetchTargetTable::Target> fetchTargetQueue[MaxThreads];
+
+    /** The fetch block the fetch target queue runs ahead of. */
+    Addr ftqBlock[MaxThreads];
+
+    /** The last block translated by each thread, to train the table. */
+    Addr lastFetchBlock[MaxThreads];
+
+    /** The last cache block prefetched by each thread. */
+    Addr lastPrefetch[MaxThreads];
+
+    /** Micro-op cache tags. */
+    UopCacheTags uopCache;
+
+    /** Micro-ops delivered per cycle on a micro-op cache hit, 0 if the
+     * micro-op cache is disabled.
+     */
+    unsigned uopCacheWidth;
+
+    /** Whether the branches of a fetch block are predicted together. */
+    const bool blockPrediction;
+
+    /** Number of taken branches fetch can follow in a cycle. */
+    const unsigned maxTakenBranches;
+
+    /** The branches fetched since the last prediction. */
+    branch_prediction::BPredUnit::FetchBlock fetchBlock;
+
+    /** The instructions of the branches of the fetch block. */
+    std::array<DynInstPtr, branch_prediction::BPredUnit::MaxBlockBranches>
+        fetchBlockInsts;
+
   protected:
     struct FetchStatGroup : public statistics::Group
     {
@@ -578,6 +696,25 @@ class Fetch
          * due to a squash.
          */
         statistics::Scalar tlbSquashes;
+        /** Number of I-cache prefetches sent by the fetch target queue. */
+        statistics::Scalar ftqPrefetches;
+        /** Number of times fetch left the path of the fetch target queue. */
+        statistics::Scalar ftqResteers;
+        /** Number of fetch blocks found in the micro-op cache. */
+        statistics::Scalar uopCacheHits;
+        /** Number of fetch blocks missing in the micro-op cache. */
+        statistics::Scalar uopCacheMisses;
+        /** Number of times a thread was passed over by the fetch policy
+         * while waiting on a long latency load. */
+        statistics::Scalar longLoadStalls;
+        /** Number of fetch blocks predicted. */
+        statistics::Scalar blockPredictions;
+        /** Number of instructions fetched behind a taken branch of a fetch
+         * block and dropped. */
+        statistics::Scalar blockDroppedInsts;
+        /** Number of taken branches followed after another one in the
+         * same cycle. */
+        statistics::Scalar secondTakenBranches;
         /** Distribution of number of instructions fetched each cycle. */
         statistics::Distribution nisnDist;
         /** Rate of how often fetch was idle. */
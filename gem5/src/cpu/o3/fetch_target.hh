@@ -0,0 +1,178 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_FETCH_TARGET_HH__
+#define __CPU_O3_FETCH_TARGET_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+/**
+ * Fetch block successor table, used to fill a fetch target queue ahead of
+ * fetch. Each entry maps a fetch block to the block fetch moved to after
+ * it, together with the physical address that block translated to, so
+ * the queue can prefetch its targets into the I-cache without going
+ * through the ITLB.
+ */
+class FetchTargetTable
+{
+  public:
+    struct Target
+    {
+        Addr vaddr;
+        Addr paddr;
+    };
+
+  private:
+    struct Entry
+    {
+        Addr block = MaxAddr;
+        Target next;
+    };
+
+    std::vector<Entry> entries;
+    unsigned blockShift;
+
+    Entry &
+    entry(Addr block)
+    {
+        return entries[(block >> blockShift) & (entries.size() - 1)];
+    }
+
+    const Entry &
+    entry(Addr block) const
+    {
+        return entries[(block >> blockShift) & (entries.size() - 1)];
+    }
+
+  public:
+    FetchTargetTable(size_t size, unsigned block_size)
+      : entries(size), blockShift(floorLog2(block_size))
+    {
+        fatal_if(!isPowerOf2(size),
+                 "Fetch target table size must be a power of two.\n");
+    }
+
+    /** Record that fetch moved from block to next. */
+    void
+    update(Addr block, const Target &next)
+    {
+        Entry &e = entry(block);
+        e.block = block;
+        e.next = next;
+    }
+
+    /** Look up the block fetch last moved to after block. */
+    bool
+    lookup(Addr block, Target &next) const
+    {
+        const Entry &e = entry(block);
+        if (e.block != block)
+            return false;
+        next = e.next;
+        return true;
+    }
+};
+
+/**
+ * Tags of a micro-op cache holding the decoded micro-ops of whole fetch
+ * blocks. Only hits and misses are modelled. Fetch still decodes every
+ * instruction, the micro-op cache decides how many micro-ops it may
+ * deliver in a cycle.
+ */
+class UopCacheTags
+{
+  private:
+    struct Entry
+    {
+        Addr block = MaxAddr;
+        ThreadID tid = InvalidThreadID;
+        uint64_t lastUse = 0;
+    };
+
+    std::vector<Entry> entries;
+    unsigned assoc;
+    unsigned numSets;
+    unsigned blockShift;
+    uint64_t useCount = 0;
+
+    Entry *set(Addr block) { return &entries[setIndex(block) * assoc]; }
+
+    unsigned
+    setIndex(Addr block) const
+    {
+        return (block >> blockShift) & (numSets - 1);
+    }
+
+  public:
+    UopCacheTags(size_t size, unsigned _assoc, unsigned block_size)
+      : entries(size), assoc(_assoc ? _assoc : 1),
+        numSets(size / assoc), blockShift(floorLog2(block_size))
+    {
+        fatal_if(size && (size % assoc || !isPowerOf2(numSets)),
+                 "Micro-op cache size must be a power of two multiple of "
+                 "its associativity.\n");
+    }
+
+    /**
+     * Look up a fetch block, allocating it over the least recently used
+     * way of its set on a miss.
+     *
+     * @return Whether the block was already cached.
+     */
+    bool
+    access(Addr block, ThreadID tid)
+    {
+        Entry *ways = set(block);
+        Entry *victim = ways;
+        for (unsigned i = 0; i < assoc; i++) {
+            if (ways[i].block == block && ways[i].tid == tid) {
+                ways[i].lastUse = ++useCount;
+                return true;
+            }
+            if (ways[i].lastUse < victim->lastUse)
+                victim = &ways[i];
+        }
+        victim->block = block;
+        victim->tid = tid;
+        victim->lastUse = ++useCount;
+        return false;
+    }
+};
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_FETCH_TARGET_HH__
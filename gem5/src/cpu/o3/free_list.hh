@@ -42,9 +42,13 @@
 #ifndef __CPU_O3_FREE_LIST_HH__
 #define __CPU_O3_FREE_LIST_HH__
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
-#include <queue>
+#include <vector>
 
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "cpu/o3/comm.hh"
@@ -65,44 +69,82 @@ class UnifiedRenameMap;
  * determined by the rename map instance being accessed, all
  * architectural register index parameters and values in this class
  * are relative (e.g., %fp2 is just index 2).
+ *
+ * The register file keeps the PhysRegIds of a class in one array, so the
+ * list is a bitmap over that array and hands out the lowest free
+ * register first.
  */
 class SimpleFreeList
 {
   private:
 
-    /** The actual free list */
-    std::queue<PhysRegIdPtr> freeRegs;
+    /** The first register of the class. */
+    PhysRegIdPtr regs = nullptr;
+
+    /** One bit per register of the class, set if the register is free. */
+    std::vector<uint64_t> freeMap;
+
+    /** The lowest word of freeMap that may have a bit set. */
+    size_t firstWord = 0;
+
+    /** Number of bits set in freeMap. */
+    unsigned numFree = 0;
 
   public:
 
     SimpleFreeList() {};
 
     /** Add a physical register to the free list */
-    void addReg(PhysRegIdPtr reg) { freeRegs.push(reg); }
+    void
+    addReg(PhysRegIdPtr reg)
+    {
+        assert(regs && reg >= regs);
+        const size_t idx = reg - regs;
+        assert(idx / 64 < freeMap.size());
+
+        uint64_t &word = freeMap[idx / 64];
+        const uint64_t bit = 1ULL << (idx % 64);
+        if (word & bit)
+            return;
+        word |= bit;
+        ++numFree;
+        firstWord = std::min(firstWord, idx / 64);
+    }
 
     /** Add physical registers to the free list */
     template<class InputIt>
     void
     addRegs(InputIt first, InputIt last) {
+        if (first == last)
+            return;
+        if (!regs) {
+            regs = &*first;
+            freeMap.resize(divCeil(last - first, 64));
+        }
         std::for_each(first, last, [this](typename InputIt::value_type& reg) {
-            freeRegs.push(&reg);
+            addReg(&reg);
         });
     }
 
     /** Get the next available register from the free list */
     PhysRegIdPtr getReg()
     {
-        assert(!freeRegs.empty());
-        PhysRegIdPtr free_reg = freeRegs.front();
-        freeRegs.pop();
+        assert(numFree);
+        while (!freeMap[firstWord])
+            ++firstWord;
+
+        uint64_t &word = freeMap[firstWord];
+        PhysRegIdPtr free_reg = regs + firstWord * 64 + findLsbSet(word);
+        word &= word - 1;
+        --numFree;
         return free_reg;
     }
 
     /** Return the number of free registers on the list. */
-    unsigned numFreeRegs() const { return freeRegs.size(); }
+    unsigned numFreeRegs() const { return numFree; }
 
     /** True iff there are free registers on the list. */
-    bool hasFreeRegs() const { return !freeRegs.empty(); }
+    bool hasFreeRegs() const { return numFree; }
 };
 
 
@@ -304,8 +346,6 @@ UnifiedFreeList::addReg(PhysRegIdPtr freed_reg)
 {
     DPRINTF(FreeList,"Freeing register %i (%s).\n", freed_reg->index(),
             freed_reg->className());
-    //Might want to add in a check for whether or not this register is
-    //already in there.  A bit vector or something similar would be useful.
     switch (freed_reg->classValue()) {
         case IntRegClass:
             intList.addReg(freed_reg);
@@ -330,17 +370,8 @@ UnifiedFreeList::addReg(PhysRegIdPtr freed_reg)
                                    freed_reg->className());
     }
 
-    // These assert conditions ensure that the number of free
-    // registers are not more than the # of total Physical  Registers.
-    // If this were false, it would mean that registers
-    // have been freed twice, overflowing the free register
-    // pool and potentially crashing SMT workloads.
-    // ----
-    // Comment out for now so as to not potentially break
-    // CMP and single-threaded workloads
-    // ----
-    // assert(freeIntRegs.size() <= numPhysicalIntRegs);
-    // assert(freeFloatRegs.size() <= numPhysicalFloatRegs);
+    // The per-class lists are bitmaps, so freeing a register twice
+    // cannot overflow the free register pool.
 }
 
 } // namespace o3
@@ -56,7 +56,6 @@
 #include "debug/Activity.hh"
 #include "debug/Drain.hh"
 #include "debug/IEW.hh"
-#include "debug/O3PipeView.hh"
 #include "params/O3CPU.hh"
 
 namespace gem5
@@ -80,6 +79,11 @@ IEW::IEW(CPU *_cpu, const O3CPUParams &params)
       wbCycle(0),
       wbWidth(params.wbWidth),
       numThreads(params.numThreads),
+      longLoadCycles(params.smtLongLoadCycles),
+      trackLongLoads(params.smtFetchPolicy == SMTFetchPolicy::MissCount ||
+                     params.smtStallOnLongLoad),
+      valuePred(params.valuePred),
+      zeroReg(params.isa[0]->regClasses().at(IntRegClass).zeroReg()),
       iewStats(cpu)
 {
     if (dispatchWidth > MaxWidth)
@@ -112,7 +116,9 @@ IEW::IEW(CPU *_cpu, const O3CPUParams &params)
 
     updateLSQNextCycle = false;
 
-    skidBufferMax = (renameToIEWDelay + 1) * params.renameWidth;
+    // Rename sends more instructions than its width when they are fused.
+    skidBufferMax = (renameToIEWDelay + 1) *
+        (params.macroOpFusion ? MaxWidth : params.renameWidth);
 }
 
 std::string
@@ -168,6 +174,21 @@ IEW::IEWStats::IEWStats(CPU *cpu)
              "Number of times the LSQ has become full, causing a stall"),
     ADD_STAT(memOrderViolationEvents, statistics::units::Count::get(),
              "Number of memory order violations"),
+    ADD_STAT(valuePredLookups, statistics::units::Count::get(),
+             "Number of loads the value predictor was looked up for"),
+    ADD_STAT(valuePredicted, statistics::units::Count::get(),
+             "Number of loads whose dependents used a predicted value"),
+    ADD_STAT(valuePredCorrect, statistics::units::Count::get(),
+             "Number of predicted load values that were right"),
+    ADD_STAT(valuePredIncorrect, statistics::units::Count::get(),
+             "Number of predicted load values that were wrong"),
+    ADD_STAT(valuePredCoverage, statistics::units::Ratio::get(),
+             "Fraction of the looked up loads that were predicted",
+             valuePredicted / valuePredLookups),
+    ADD_STAT(valuePredAccuracy, statistics::units::Ratio::get(),
+             "Fraction of the checked load value predictions that were "
+             "right",
+             valuePredCorrect / (valuePredCorrect + valuePredIncorrect)),
     ADD_STAT(predictedTakenIncorrect, statistics::units::Count::get(),
              "Number of branches that were predicted taken incorrectly"),
     ADD_STAT(predictedNotTakenIncorrect, statistics::units::Count::get(),
@@ -214,6 +235,15 @@ IEW::IEWStats::IEWStats(CPU *cpu)
     wbFanout
         .flags(statistics::total);
     wbFanout = producerInst / consumerInst;
+
+    valuePredLookups
+        .prereq(valuePredLookups);
+    valuePredicted
+        .prereq(valuePredicted);
+    valuePredCorrect
+        .prereq(valuePredCorrect);
+    valuePredIncorrect
+        .prereq(valuePredIncorrect);
 }
 
 IEW::IEWStats::ExecutedInstStats::ExecutedInstStats(CPU *cpu)
@@ -427,6 +457,15 @@ IEW::squash(ThreadID tid)
     ldstQueue.squash(fromCommit->commitInfo[tid].doneSeqNum, tid);
     updatedQueues = true;
 
+    if (valuePred) {
+        const DynInstPtr &mispredict_inst =
+            fromCommit->commitInfo[tid].mispredictInst;
+        valuePred->squashHistory(tid, fromCommit->commitInfo[tid].doneSeqNum,
+                                 mispredict_inst &&
+                                 mispredict_inst->isCondCtrl(),
+                                 fromCommit->commitInfo[tid].branchTaken);
+    }
+
     // Clear the skid buffer in case it has any data in it.
     DPRINTF(IEW,
             "Removing skidbuffer instructions until "
@@ -500,6 +539,109 @@ IEW::squashDueToMemOrder(const DynInstPtr& inst, ThreadID tid)
     }
 }
 
+void
+IEW::squashDueToValueMispred(const DynInstPtr &inst, ThreadID tid)
+{
+    DPRINTF(IEW, "[tid:%i] Value misprediction, squashing insts after "
+            "load, PC: %s [sn:%llu].\n", tid, inst->pcState(), inst->seqNum);
+    // The load itself has its value, only the instructions behind it
+    // used the wrong one. Keeping it also keeps loads that execute at
+    // commit, as uncacheable ones do, from reading memory twice.
+    if (!toCommit->squash[tid] ||
+            inst->seqNum < toCommit->squashedSeqNum[tid]) {
+        toCommit->squash[tid] = true;
+        toCommit->squashedSeqNum[tid] = inst->seqNum;
+        toCommit->branchTaken[tid] = false;
+
+        set(toCommit->pc[tid], inst->pcState());
+        inst->staticInst->advancePC(*toCommit->pc[tid]);
+
+        toCommit->mispredictInst[tid] = NULL;
+        toCommit->includeSquashInst[tid] = false;
+
+        wroteToTimeBuffer = true;
+    }
+}
+
+void
+IEW::predictLoadValue(const DynInstPtr &inst)
+{
+    // Only loads that write a single scalar register are predicted.
+    if (inst->numDestRegs() != 1)
+        return;
+
+    const RegId &arch_dest = inst->destRegIdx(0);
+    PhysRegIdPtr dest = inst->renamedDestIdx(0);
+    if (!(arch_dest.is(IntRegClass) || arch_dest.is(FloatRegClass)) ||
+        (arch_dest.is(IntRegClass) && arch_dest.index() == zeroReg) ||
+        dest->isFixedMapping() || dest->isPinned()) {
+        return;
+    }
+
+    ThreadID tid = inst->threadNumber;
+    ++iewStats.valuePredLookups;
+
+    RegVal value;
+    if (!valuePred->lookup(tid, inst->pcState().instAddr(),
+                           inst->pcState().microPC(), value,
+                           inst->vpHistory)) {
+        return;
+    }
+
+    DPRINTF(IEW, "[tid:%i] Predicted value %#x for load [sn:%llu].\n",
+            tid, value, inst->seqNum);
+    ++iewStats.valuePredicted;
+
+    // The load writes its register again when it completes, and is
+    // checked then.
+    inst->predictedValue(value);
+    if (arch_dest.is(FloatRegClass))
+        cpu->setFloatReg(dest, value);
+    else
+        cpu->setIntReg(dest, value);
+
+    instQueue.wakeRegDependents(inst);
+    scoreboard->setReg(dest);
+}
+
+void
+IEW::checkValuePrediction(const DynInstPtr &inst)
+{
+    PhysRegIdPtr dest = inst->renamedDestIdx(0);
+    RegVal value = inst->destRegIdx(0).is(FloatRegClass) ?
+        cpu->readFloatReg(dest) : cpu->readIntReg(dest);
+    inst->loadedValue(value);
+
+    if (!inst->valuePredicted())
+        return;
+
+    if (value == inst->predictedValue()) {
+        ++iewStats.valuePredCorrect;
+        return;
+    }
+
+    DPRINTF(IEW, "[tid:%i] Load [sn:%llu] read %#x, predicted %#x.\n",
+            inst->threadNumber, inst->seqNum, value,
+            inst->predictedValue());
+    ++iewStats.valuePredIncorrect;
+
+    valuePred->mispredict(inst->threadNumber, inst->vpHistory);
+    squashDueToValueMispred(inst, inst->threadNumber);
+}
+
+void
+IEW::retireValuePrediction(const DynInstPtr &inst)
+{
+    assert(inst->vpHistory);
+    if (inst->isCommitted() && inst->valueLoaded()) {
+        valuePred->update(inst->threadNumber, inst->loadedValue(),
+                          inst->vpHistory);
+    } else {
+        valuePred->squash(inst->threadNumber, inst->vpHistory);
+    }
+    inst->vpHistory = nullptr;
+}
+
 void
 IEW::block(ThreadID tid)
 {
@@ -838,10 +980,10 @@ IEW::dispatch(ThreadID tid)
     //     check if stall conditions have passed
 
     if (dispatchStatus[tid] == Blocked) {
-        ++iewStats.blockCycles;
+        cycleStats.count(iewStats.blockCycles);
 
     } else if (dispatchStatus[tid] == Squashing) {
-        ++iewStats.squashCycles;
+        cycleStats.count(iewStats.squashCycles);
     }
 
     // Dispatch should try to dispatch as many instructions as its bandwidth
@@ -862,7 +1004,7 @@ IEW::dispatch(ThreadID tid)
         // the rest of unblocking.
         dispatchInsts(tid);
 
-        ++iewStats.unblockCycles;
+        cycleStats.count(iewStats.unblockCycles);
 
         if (fromRename->size != 0) {
             // Add the current inputs to the skid buffer so they can be
@@ -888,15 +1030,17 @@ IEW::dispatchInsts(ThreadID tid)
     DynInstPtr inst;
     bool add_to_iq = false;
     int dis_num_inst = 0;
+    unsigned dis_slots = 0;
 
     // Loop through the instructions, putting them in the instruction
     // queue.
-    for ( ; dis_num_inst < insts_to_add &&
-              dis_num_inst < dispatchWidth;
-          ++dis_num_inst)
-    {
+    for ( ; dis_num_inst < insts_to_add; ++dis_num_inst) {
         inst = insts_to_dispatch.front();
 
+        // An instruction fused with the one ahead of it takes no slot.
+        if (!inst->isFused() && dis_slots++ >= dispatchWidth)
+            break;
+
         if (dispatchStatus[tid] == Unblocking) {
             DPRINTF(IEW, "[tid:%i] Issue: Examining instruction from skid "
                     "buffer\n", tid);
@@ -1083,15 +1227,23 @@ IEW::dispatchInsts(ThreadID tid)
             instQueue.insert(inst);
         }
 
+        if (valuePred) {
+            if (inst->isCondCtrl()) {
+                valuePred->updateHistory(tid, inst->seqNum,
+                                         inst->readPredTaken());
+            } else if (add_to_iq && inst->isLoad()) {
+                predictLoadValue(inst);
+            }
+        }
+
         insts_to_dispatch.pop();
 
         toRename->iewInfo[tid].dispatched++;
 
         ++iewStats.dispatchedInsts;
 
-#if TRACING_ON
-        inst->dispatchTick = curTick() - inst->fetchTick;
-#endif
+        if (cpu->tracePipeView())
+            inst->dispatchTick = curTick() - inst->fetchTick;
         ppDispatch->notify(inst);
     }
 
@@ -1406,6 +1558,9 @@ IEW::writebackInsts()
         // when it's ready to execute the strictly ordered load.
         if (!inst->isSquashed() && inst->isExecuted() &&
                 inst->getFault() == NoFault) {
+            if (inst->vpHistory)
+                checkValuePrediction(inst);
+
             int dependents = instQueue.wakeDependents(inst);
 
             for (int i = 0; i < inst->numDestRegs(); i++) {
@@ -1435,6 +1590,7 @@ IEW::tick()
     wbCycle = 0;
 
     wroteToTimeBuffer = false;
+    cycleStats.newCycle();
     updatedQueues = false;
 
     ldstQueue.tick();
@@ -1506,6 +1662,11 @@ IEW::tick()
 
             updateLSQNextCycle = true;
             instQueue.commit(fromCommit->commitInfo[tid].doneSeqNum,tid);
+
+            if (valuePred) {
+                valuePred->commitHistory(tid,
+                        fromCommit->commitInfo[tid].doneSeqNum);
+            }
         }
 
         if (fromCommit->commitInfo[tid].nonSpecSeqNum != 0) {
@@ -1521,12 +1682,18 @@ IEW::tick()
             }
         }
 
-        if (broadcast_free_entries) {
-            toFetch->iewInfo[tid].iqCount =
-                instQueue.getCount(tid);
-            toFetch->iewInfo[tid].ldstqCount =
-                ldstQueue.getCount(tid);
+        // The SMT fetch policies look at the occupancy of each thread
+        // every cycle, not only when it changed.
+        if (numThreads > 1) {
+            toFetch->iewInfo[tid].iqCount = instQueue.getCount(tid);
+            toFetch->iewInfo[tid].ldstqCount = ldstQueue.getCount(tid);
+            if (trackLongLoads) {
+                toFetch->iewInfo[tid].longLoads = ldstQueue.numLongLoads(
+                    tid, cpu->cyclesToTicks(longLoadCycles));
+            }
+        }
 
+        if (broadcast_free_entries) {
             toRename->iewInfo[tid].usedIQ = true;
             toRename->iewInfo[tid].freeIQEntries =
                 instQueue.numFreeEntries(tid);
@@ -1564,11 +1731,9 @@ IEW::updateExeInstStats(const DynInstPtr& inst)
 
     iewStats.executedInstStats.numInsts++;
 
-#if TRACING_ON
-    if (debug::O3PipeView) {
+    if (cpu->tracePipeView()) {
         inst->completeTick = curTick() - inst->fetchTick;
     }
-#endif
 
     //
     //  Control operations
@@ -46,11 +46,13 @@
 
 #include "base/statistics.hh"
 #include "cpu/o3/comm.hh"
+#include "cpu/o3/cycle_stats.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
 #include "cpu/o3/inst_queue.hh"
 #include "cpu/o3/limits.hh"
 #include "cpu/o3/lsq.hh"
 #include "cpu/o3/scoreboard.hh"
+#include "cpu/pred/value_pred.hh"
 #include "cpu/timebuf.hh"
 #include "debug/IEW.hh"
 #include "sim/probe/probe.hh"
@@ -226,6 +228,10 @@ class IEW
     /** Check misprediction  */
     void checkMisprediction(const DynInstPtr &inst);
 
+    /** Trains the value predictor with a load that commits, or releases
+     *  its lookup if it was squashed. */
+    void retireValuePrediction(const DynInstPtr &inst);
+
     // hardware transactional memory
     // For debugging purposes, it is useful to keep track of the most recent
     // htmUid that has been committed (architecturally, not transactionally)
@@ -247,6 +253,19 @@ class IEW
      */
     void squashDueToMemOrder(const DynInstPtr &inst, ThreadID tid);
 
+    /** Sends commit proper information for a squash of the instructions
+     * behind a load whose value was mispredicted.
+     */
+    void squashDueToValueMispred(const DynInstPtr &inst, ThreadID tid);
+
+    /** Looks the value predictor up for a load being dispatched, and
+     * wakes its dependents up with the value if it is confident.
+     */
+    void predictLoadValue(const DynInstPtr &inst);
+
+    /** Checks the value predicted for a load against the value it read. */
+    void checkValuePrediction(const DynInstPtr &inst);
+
     /** Sets Dispatch to blocked, and signals back to other stages to block. */
     void block(ThreadID tid);
 
@@ -292,6 +311,9 @@ class IEW
      */
     void tick();
 
+    /** Accounts for cycles skipped while the CPU was not ticking. */
+    void skipCycles(Cycles cycles) { cycleStats.skip(cycles); }
+
   private:
     /** Updates execution stats based on the instruction. */
     void updateExeInstStats(const DynInstPtr &inst);
@@ -347,6 +369,9 @@ class IEW
      */
     bool wroteToTimeBuffer;
 
+    /** Per-cycle status stats counted in the last tick. */
+    CycleStats cycleStats;
+
     /** Debug function to print instructions that are issued this cycle. */
     void printAvailableInsts();
 
@@ -408,6 +433,18 @@ class IEW
     /** Number of active threads. */
     ThreadID numThreads;
 
+    /** Time a load has to wait on memory to be a long latency load. */
+    const Cycles longLoadCycles;
+
+    /** Whether fetch needs the long latency loads of each thread. */
+    const bool trackLongLoads;
+
+    /** Load value predictor, if any. */
+    value_prediction::ValuePredictor *valuePred;
+
+    /** Index of the integer zero register, never predicted. */
+    const RegIndex zeroReg;
+
     /** Pointer to list of active threads. */
     std::list<ThreadID> *activeThreads;
 
@@ -443,6 +480,22 @@ class IEW
         statistics::Scalar lsqFullEvents;
         /** Stat for total number of memory ordering violation events. */
         statistics::Scalar memOrderViolationEvents;
+        /** Stat for number of loads the value predictor was looked up
+         *  for. */
+        statistics::Scalar valuePredLookups;
+        /** Stat for number of loads whose dependents got a predicted
+         *  value. */
+        statistics::Scalar valuePredicted;
+        /** Stat for number of predicted values that were right. */
+        statistics::Scalar valuePredCorrect;
+        /** Stat for number of predicted values that were wrong. */
+        statistics::Scalar valuePredIncorrect;
+        /** Stat for the fraction of looked up loads that were
+         *  predicted. */
+        statistics::Formula valuePredCoverage;
+        /** Stat for the fraction of checked predictions that were
+         *  right. */
+        statistics::Formula valuePredAccuracy;
         /** Stat for total number of incorrect predicted taken branches. */
         statistics::Scalar predictedTakenIncorrect;
         /** Stat for total number of incorrect predicted not taken branches. */
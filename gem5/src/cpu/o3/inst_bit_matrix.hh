@@ -0,0 +1,359 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_INST_BIT_MATRIX_HH__
+#define __CPU_O3_INST_BIT_MATRIX_HH__
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "cpu/inst_seq.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+/**
+ * Set of in-flight instructions organised as a bit matrix: each row is a
+ * bitmap over a window of sequence numbers, and an instruction may be a
+ * member of any number of rows. Because sequence numbers follow program
+ * order, a bit's position in a row is also its age, so the oldest or
+ * youngest member of a row is found with a handful of word-wide bit scans,
+ * and membership tests and updates are single bit operations.
+ *
+ * The window spans from the oldest to the youngest member of any row and
+ * its storage grows when that span does not fit, so there is no limit on
+ * how far apart members may be.
+ *
+ * @tparam Ptr Reference-counted instruction pointer, convertible to bool.
+ */
+template <typename Ptr>
+class InstBitMatrix
+{
+  private:
+    static constexpr size_t WordBits = 64;
+
+    size_t numRows;
+    size_t capacity;
+    size_t mask;
+    size_t rowWords;
+
+    /** Row bitmaps, rowWords words per row. */
+    std::vector<uint64_t> bits;
+
+    /** Instruction in each window slot, and how many rows it is in. */
+    std::vector<Ptr> slots;
+    std::vector<uint16_t> refs;
+
+    std::vector<size_t> rowSize;
+    std::vector<InstSeqNum> rowOldest;
+
+    /** Bitmap of the non-empty rows. */
+    std::vector<uint64_t> rowMask;
+
+    /** Oldest and youngest sequence numbers in the window. */
+    InstSeqNum lo = 0;
+    InstSeqNum hi = 0;
+
+    /** Number of distinct instructions in the matrix. */
+    size_t numInsts = 0;
+
+    bool
+    covers(InstSeqNum seq_num) const
+    {
+        return numInsts && seq_num >= lo && seq_num <= hi;
+    }
+
+    uint64_t &
+    word(size_t row, InstSeqNum seq_num)
+    {
+        return bits[row * rowWords + (seq_num & mask) / WordBits];
+    }
+
+    uint64_t
+    word(size_t row, InstSeqNum seq_num) const
+    {
+        return bits[row * rowWords + (seq_num & mask) / WordBits];
+    }
+
+    static uint64_t
+    bit(InstSeqNum seq_num)
+    {
+        return uint64_t(1) << (seq_num % WordBits);
+    }
+
+    /** First member of the row at or after the given sequence number. */
+    InstSeqNum
+    scanForward(size_t row, InstSeqNum from) const
+    {
+        const uint64_t *words = &bits[row * rowWords];
+        const size_t pos = from & mask;
+        size_t w = pos / WordBits;
+        uint64_t cur = words[w] & (~uint64_t(0) << (pos % WordBits));
+        for (size_t n = 0; n <= rowWords; ++n) {
+            if (cur) {
+                const size_t b = w * WordBits + findLsbSet(cur);
+                return from + ((b - pos) & mask);
+            }
+            w = (w + 1) & (rowWords - 1);
+            cur = words[w];
+        }
+        panic("No member found in bit matrix row %d.", row);
+    }
+
+    /** Last member of the row at or before the given sequence number. */
+    InstSeqNum
+    scanBackward(size_t row, InstSeqNum from) const
+    {
+        const uint64_t *words = &bits[row * rowWords];
+        const size_t pos = from & mask;
+        size_t w = pos / WordBits;
+        uint64_t cur = words[w] &
+            (~uint64_t(0) >> (WordBits - 1 - pos % WordBits));
+        for (size_t n = 0; n <= rowWords; ++n) {
+            if (cur) {
+                const size_t b = w * WordBits + findMsbSet(cur);
+                return from - ((pos - b) & mask);
+            }
+            w = (w - 1) & (rowWords - 1);
+            cur = words[w];
+        }
+        panic("No member found in bit matrix row %d.", row);
+    }
+
+    void
+    allocate(size_t new_capacity)
+    {
+        capacity = std::max<size_t>(size_t(1) << ceilLog2(new_capacity),
+                                    WordBits);
+        mask = capacity - 1;
+        rowWords = capacity / WordBits;
+        bits.assign(numRows * rowWords, 0);
+        slots.assign(capacity, nullptr);
+        refs.assign(capacity, 0);
+    }
+
+    /** Re-lays the window out over storage fitting at least min_span. */
+    void
+    grow(size_t min_span)
+    {
+        std::vector<uint64_t> old_bits;
+        std::vector<Ptr> old_slots;
+        std::vector<uint16_t> old_refs;
+        old_bits.swap(bits);
+        old_slots.swap(slots);
+        old_refs.swap(refs);
+        const size_t old_mask = mask;
+        const size_t old_row_words = rowWords;
+
+        allocate(std::max(min_span, 2 * capacity));
+
+        for (InstSeqNum sn = lo; sn <= hi; ++sn) {
+            slots[sn & mask] = std::move(old_slots[sn & old_mask]);
+            refs[sn & mask] = old_refs[sn & old_mask];
+        }
+        const size_t lo_pos = lo & old_mask;
+        for (size_t row = 0; row < numRows; ++row) {
+            if (!rowSize[row])
+                continue;
+            for (size_t w = 0; w < old_row_words; ++w) {
+                uint64_t cur = old_bits[row * old_row_words + w];
+                while (cur) {
+                    const int b = findLsbSet(cur);
+                    cur &= cur - 1;
+                    const InstSeqNum sn =
+                        lo + ((w * WordBits + b - lo_pos) & old_mask);
+                    word(row, sn) |= bit(sn);
+                }
+            }
+        }
+    }
+
+    /** Shrinks the window past empty slots at either end. */
+    void
+    trim()
+    {
+        if (!numInsts)
+            return;
+        while (!refs[lo & mask])
+            ++lo;
+        while (!refs[hi & mask])
+            --hi;
+    }
+
+  public:
+    explicit InstBitMatrix(size_t num_rows=0, size_t init_capacity=256)
+      : numRows(num_rows), capacity(0), mask(0), rowWords(0)
+    {
+        resize(num_rows, init_capacity);
+    }
+
+    /** Empties the matrix and changes its number of rows. */
+    void
+    resize(size_t num_rows, size_t init_capacity=256)
+    {
+        numRows = num_rows;
+        allocate(init_capacity);
+        rowSize.assign(numRows, 0);
+        rowOldest.assign(numRows, 0);
+        rowMask.assign(divCeil(numRows, WordBits), 0);
+        numInsts = 0;
+    }
+
+    void clear() { resize(numRows, capacity); }
+
+    bool empty() const { return numInsts == 0; }
+    bool empty(size_t row) const { return rowSize[row] == 0; }
+    size_t size(size_t row) const { return rowSize[row]; }
+
+    bool
+    test(size_t row, InstSeqNum seq_num) const
+    {
+        return covers(seq_num) && (word(row, seq_num) & bit(seq_num));
+    }
+
+    /**
+     * Adds an instruction to a row.
+     *
+     * @return Whether it was not a member already.
+     */
+    bool
+    set(size_t row, InstSeqNum seq_num, const Ptr &inst)
+    {
+        if (test(row, seq_num))
+            return false;
+
+        if (!numInsts) {
+            lo = hi = seq_num;
+        } else {
+            const InstSeqNum new_lo = std::min(lo, seq_num);
+            const InstSeqNum new_hi = std::max(hi, seq_num);
+            if (new_hi - new_lo >= capacity)
+                grow(new_hi - new_lo + 1);
+            lo = new_lo;
+            hi = new_hi;
+        }
+
+        word(row, seq_num) |= bit(seq_num);
+        const size_t pos = seq_num & mask;
+        if (refs[pos]++ == 0) {
+            slots[pos] = inst;
+            ++numInsts;
+        }
+
+        if (rowSize[row]++ == 0) {
+            rowOldest[row] = seq_num;
+            rowMask[row / WordBits] |= uint64_t(1) << (row % WordBits);
+        } else if (seq_num < rowOldest[row]) {
+            rowOldest[row] = seq_num;
+        }
+        return true;
+    }
+
+    /**
+     * Removes an instruction from a row.
+     *
+     * @return Whether it was a member.
+     */
+    bool
+    reset(size_t row, InstSeqNum seq_num)
+    {
+        if (!test(row, seq_num))
+            return false;
+
+        word(row, seq_num) &= ~bit(seq_num);
+
+        if (--rowSize[row] == 0) {
+            rowMask[row / WordBits] &= ~(uint64_t(1) << (row % WordBits));
+        } else if (seq_num == rowOldest[row]) {
+            rowOldest[row] = scanForward(row, seq_num + 1);
+        }
+
+        const size_t pos = seq_num & mask;
+        if (--refs[pos] == 0) {
+            slots[pos] = nullptr;
+            --numInsts;
+            trim();
+        }
+        return true;
+    }
+
+    /** Oldest member of a non-empty row. */
+    InstSeqNum
+    oldest(size_t row) const
+    {
+        assert(rowSize[row]);
+        return rowOldest[row];
+    }
+
+    /** Youngest member of a non-empty row. */
+    InstSeqNum
+    youngest(size_t row) const
+    {
+        assert(rowSize[row]);
+        return scanBackward(row, hi);
+    }
+
+    /** Instruction with the given sequence number, if it is a member. */
+    const Ptr &
+    operator[](InstSeqNum seq_num) const
+    {
+        assert(covers(seq_num));
+        return slots[seq_num & mask];
+    }
+
+    /**
+     * Next non-empty row after the given one; pass -1 to get the first.
+     *
+     * @return The row index, or -1 if there are no more.
+     */
+    int
+    nextRow(int after) const
+    {
+        size_t row = after + 1;
+        while (row < numRows) {
+            const size_t w = row / WordBits;
+            const uint64_t cur =
+                rowMask[w] & (~uint64_t(0) << (row % WordBits));
+            if (cur)
+                return w * WordBits + findLsbSet(cur);
+            row = (w + 1) * WordBits;
+        }
+        return -1;
+    }
+};
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_INST_BIT_MATRIX_HH__
@@ -0,0 +1,193 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_INST_RING_HH__
+#define __CPU_O3_INST_RING_HH__
+
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "base/intmath.hh"
+#include "cpu/inst_seq.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+/**
+ * Age-ordered window of in-flight instructions, indexed directly by
+ * sequence number. Sequence numbers are handed out in fetch order, so the
+ * window always covers [head, tail] and an instruction's slot is its
+ * sequence number modulo the (power of two) capacity. Removed instructions
+ * leave an empty slot behind; empty slots at either end of the window are
+ * reclaimed immediately, and those in the middle (e.g., squashes of one SMT
+ * thread) once the window drains past them. The storage grows when the
+ * window outspans it, so there is no hard limit on the number of
+ * instructions in flight.
+ *
+ * @tparam T Entry type, e.g. an instruction pointer. A value-initialised T
+ *           is an empty slot, and an entry converts to true.
+ */
+template <typename T>
+class InstRing
+{
+  private:
+    std::vector<T> slots;
+    size_t mask;
+
+    /** Sequence number of the oldest slot in the window. */
+    InstSeqNum _head = 0;
+
+    /** Number of slots covered by the window, including empty ones. */
+    size_t _span = 0;
+
+    T &slot(InstSeqNum seq_num) { return slots[seq_num & mask]; }
+    const T &
+    slot(InstSeqNum seq_num) const
+    {
+        return slots[seq_num & mask];
+    }
+
+    void
+    grow(size_t min_capacity)
+    {
+        std::vector<T> resized(size_t(1) << ceilLog2(min_capacity));
+        const size_t resized_mask = resized.size() - 1;
+        for (InstSeqNum sn = _head; sn != _head + _span; ++sn)
+            resized[sn & resized_mask] = std::move(slot(sn));
+        slots.swap(resized);
+        mask = resized_mask;
+    }
+
+    /** Reclaims the empty slots at both ends of the window. */
+    void
+    trim()
+    {
+        while (_span && !slot(_head)) {
+            ++_head;
+            --_span;
+        }
+        while (_span && !slot(_head + _span - 1))
+            --_span;
+    }
+
+  public:
+    explicit InstRing(size_t capacity=256)
+      : slots(size_t(1) << ceilLog2(capacity)), mask(slots.size() - 1)
+    {}
+
+    bool empty() const { return _span == 0; }
+
+    /** Oldest valid sequence number; only meaningful if not empty. */
+    InstSeqNum head() const { return _head; }
+
+    /** Youngest valid sequence number; only meaningful if not empty. */
+    InstSeqNum tail() const { return _head + _span - 1; }
+
+    /** Whether the sequence number falls within the window. */
+    bool
+    covers(InstSeqNum seq_num) const
+    {
+        return _span && seq_num >= _head && seq_num - _head < _span;
+    }
+
+    T &front() { return slot(_head); }
+    const T &front() const { return slot(_head); }
+    T &back() { return slot(tail()); }
+    const T &back() const { return slot(tail()); }
+
+    /**
+     * Slot of the given sequence number, which is empty if the instruction
+     * has already been removed.
+     */
+    T &
+    operator[](InstSeqNum seq_num)
+    {
+        assert(covers(seq_num));
+        return slot(seq_num);
+    }
+
+    const T &
+    operator[](InstSeqNum seq_num) const
+    {
+        assert(covers(seq_num));
+        return slot(seq_num);
+    }
+
+    /** Entry with the given sequence number, or nullptr if there is none. */
+    T *
+    find(InstSeqNum seq_num)
+    {
+        if (!covers(seq_num) || !slot(seq_num))
+            return nullptr;
+        return &slot(seq_num);
+    }
+
+    /**
+     * Appends a new entry. Its sequence number must be younger than any
+     * other in the window; skipped numbers become empty slots.
+     */
+    void
+    push_back(InstSeqNum seq_num, T entry)
+    {
+        if (!_span) {
+            _head = seq_num;
+        } else {
+            assert(seq_num > tail());
+        }
+        const size_t span = seq_num - _head + 1;
+        if (span > slots.size())
+            grow(span);
+        _span = span;
+        slot(seq_num) = std::move(entry);
+    }
+
+    /** Removes an entry, if it is still in the window. */
+    void
+    remove(InstSeqNum seq_num)
+    {
+        if (!covers(seq_num))
+            return;
+        slot(seq_num) = T();
+        trim();
+    }
+
+    void
+    clear()
+    {
+        for (InstSeqNum sn = _head; sn != _head + _span; ++sn)
+            slot(sn) = T();
+        _span = 0;
+    }
+};
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_INST_RING_HH__
@@ -257,6 +257,8 @@ class LSQ
         std::vector<bool> _byteEnable;
         uint32_t _numOutstandingPackets;
         AtomicOpFunctorPtr _amo_op;
+        /** When the first packet of the request was sent. */
+        Tick _sentTick = MaxTick;
 
       protected:
         LSQUnit* lsqUnit() { return &_port; }
@@ -431,6 +433,19 @@ class LSQ
         packetSent()
         {
             flags.set(Flag::Sent);
+            if (_sentTick == MaxTick)
+                _sentTick = curTick();
+        }
+
+        /**
+         * Test if the request has been waiting on memory for at least a
+         * given time.
+         */
+        bool
+        waitedFor(Tick min_wait) const
+        {
+            return _numOutstandingPackets > 0 &&
+                curTick() - _sentTick >= min_wait;
         }
         /** Update the status to reflect that a packet was not sent.
          * When a packet fails to be sent, we mark the request as needing a
@@ -765,6 +780,12 @@ class LSQ
     /** Returns the number of free entries in the SQ for a specific thread. */
     unsigned numFreeStoreEntries(ThreadID tid);
 
+    /**
+     * Returns the number of loads of a thread that have been waiting on
+     * memory for at least a given time.
+     */
+    unsigned numLongLoads(ThreadID tid, Tick min_wait);
+
     /** Returns if the LSQ is full (either LQ or SQ is full). */
     bool isFull();
     /**
@@ -0,0 +1,148 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_LSQ_ADDR_INDEX_HH__
+#define __CPU_O3_LSQ_ADDR_INDEX_HH__
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "base/intmath.hh"
+#include "base/types.hh"
+#include "cpu/inst_seq.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+/**
+ * Block-address hashed index over the entries of one LSQ queue, standing
+ * in for the address CAM of a real LSQ. Each entry is recorded under every
+ * block its access touches, so a search only visits entries that share a
+ * block with the searched range; callers still apply their exact overlap
+ * test to every candidate. Entries are never removed explicitly: each one
+ * is tagged with its sequence number, and entries that have left the queue
+ * (or whose slot has been reused) are dropped whenever their bucket is
+ * visited.
+ */
+class LSQAddrIndex
+{
+  private:
+    struct Entry
+    {
+        /** Monotonic queue index of the entry. */
+        size_t idx;
+        InstSeqNum seqNum;
+    };
+
+    std::vector<std::vector<Entry>> buckets;
+    unsigned blockShift = 0;
+
+    template <typename Live>
+    static void
+    prune(std::vector<Entry> &bucket, Live live)
+    {
+        bucket.erase(std::remove_if(bucket.begin(), bucket.end(),
+                    [&](const Entry &e) { return !live(e.idx, e.seqNum); }),
+                bucket.end());
+    }
+
+    /** Call f on the bucket of every block in [lo, hi], once per bucket. */
+    template <typename F>
+    void
+    forEachBucket(Addr lo, Addr hi, F f)
+    {
+        const Addr first = lo >> blockShift;
+        const Addr last = hi >> blockShift;
+        const Addr mask = buckets.size() - 1;
+        for (Addr blk = first; blk <= last && blk - first <= mask; ++blk)
+            f(buckets[blk & mask]);
+    }
+
+  public:
+    /**
+     * @param entries Capacity of the indexed queue; the number of buckets
+     *                is the next power of two.
+     */
+    explicit LSQAddrIndex(size_t entries=1)
+        : buckets(size_t(1) << ceilLog2(std::max<size_t>(entries, 1)))
+    {}
+
+    /** Set the block size and drop every entry. */
+    void
+    reset(unsigned block_shift)
+    {
+        blockShift = block_shift;
+        for (auto &bucket : buckets)
+            bucket.clear();
+    }
+
+    /**
+     * Record queue entry idx as touching bytes [lo, hi]. live(idx, sn)
+     * tells whether an indexed entry is still in the queue.
+     */
+    template <typename Live>
+    void
+    insert(Addr lo, Addr hi, size_t idx, InstSeqNum sn, Live live)
+    {
+        forEachBucket(lo, hi, [&](std::vector<Entry> &bucket) {
+            prune(bucket, live);
+            for (const auto &e : bucket) {
+                if (e.idx == idx && e.seqNum == sn)
+                    return;
+            }
+            bucket.push_back({idx, sn});
+        });
+    }
+
+    /**
+     * Collect into out, sorted by age, the live entries in [min_idx,
+     * max_idx) that were recorded under a block of [lo, hi].
+     */
+    template <typename Live>
+    void
+    search(Addr lo, Addr hi, size_t min_idx, size_t max_idx, Live live,
+           std::vector<size_t> &out)
+    {
+        out.clear();
+        forEachBucket(lo, hi, [&](std::vector<Entry> &bucket) {
+            prune(bucket, live);
+            for (const auto &e : bucket) {
+                if (e.idx >= min_idx && e.idx < max_idx)
+                    out.push_back(e.idx);
+            }
+        });
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+};
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_LSQ_ADDR_INDEX_HH__
@@ -52,7 +52,6 @@
 #include "debug/HtmCpu.hh"
 #include "debug/IEW.hh"
 #include "debug/LSQUnit.hh"
-#include "debug/O3PipeView.hh"
 #include "mem/packet.hh"
 #include "mem/request.hh"
 
@@ -195,7 +194,8 @@ LSQUnit::LSQUnit(uint32_t lqEntries, uint32_t sqEntries)
       storesToWB(0),
       htmStarts(0), htmStops(0),
       lastRetiredHtmUid(0),
-      cacheBlockMask(0), stalled(false),
+      cacheBlockMask(0), loadAddrIndex(lqEntries),
+      storeAddrIndex(sqEntries), stalled(false),
       isStoreBlocked(false), storeInFlight(false), stats(nullptr)
 {
 }
@@ -240,6 +240,11 @@ LSQUnit::resetState()
     stalled = false;
 
     cacheBlockMask = ~(cpu->cacheLineSize() - 1);
+
+    const unsigned index_shift =
+        std::max<unsigned>(floorLog2(cpu->cacheLineSize()), depCheckShift);
+    loadAddrIndex.reset(index_shift);
+    storeAddrIndex.reset(index_shift);
 }
 
 std::string
@@ -415,6 +420,19 @@ LSQUnit::numFreeLoadEntries()
         return loadQueue.capacity() - loadQueue.size();
 }
 
+unsigned
+LSQUnit::numLongLoads(Tick min_wait)
+{
+    unsigned count = 0;
+    for (auto &entry : loadQueue) {
+        if (entry.valid() && entry.hasRequest() &&
+            entry.request()->waitedFor(min_wait)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
 unsigned
 LSQUnit::numFreeStoreEntries()
 {
@@ -507,6 +525,20 @@ LSQUnit::checkSnoop(PacketPtr pkt)
     return;
 }
 
+bool
+LSQUnit::inLoadQueue(size_t idx, InstSeqNum sn)
+{
+    return loadQueue.isValidIdx(idx) && loadQueue[idx].valid() &&
+        loadQueue[idx].instruction()->seqNum == sn;
+}
+
+bool
+LSQUnit::inStoreQueue(size_t idx, InstSeqNum sn)
+{
+    return storeQueue.isValidIdx(idx) && storeQueue[idx].valid() &&
+        storeQueue[idx].instruction()->seqNum == sn;
+}
+
 Fault
 LSQUnit::checkViolations(typename LoadQueue::iterator& loadIt,
         const DynInstPtr& inst)
@@ -519,12 +551,23 @@ LSQUnit::checkViolations(typename LoadQueue::iterator& loadIt,
      * all instructions that will execute before the store writes back. Thus,
      * like the implementation that came before it, we're overly conservative.
      */
-    while (loadIt != loadQueue.end()) {
+    // Only loads indexed under one of the blocks of the granules touched
+    // by this access can overlap it. They are visited in age order, as a
+    // walk of the whole load queue would. Note that a zero-sized access
+    // ends one granule before it starts.
+    loadAddrIndex.search(
+            std::min(inst_eff_addr1, inst_eff_addr2) << depCheckShift,
+            std::max(inst_eff_addr1, inst_eff_addr2) << depCheckShift,
+            loadIt.idx(), loadQueue.end().idx(),
+            [this](size_t idx, InstSeqNum sn)
+            { return inLoadQueue(idx, sn); },
+            addrCandidates);
+
+    for (size_t ld_idx : addrCandidates) {
+        loadIt = loadQueue.getIterator(ld_idx);
         DynInstPtr ld_inst = loadIt->instruction();
-        if (!ld_inst->effAddrValid() || ld_inst->strictlyOrdered()) {
-            ++loadIt;
+        if (!ld_inst->effAddrValid() || ld_inst->strictlyOrdered())
             continue;
-        }
 
         Addr ld_eff_addr1 = ld_inst->effAddr >> depCheckShift;
         Addr ld_eff_addr2 =
@@ -578,8 +621,6 @@ LSQUnit::checkViolations(typename LoadQueue::iterator& loadIt,
                     inst->seqNum, ld_inst->seqNum, ld_eff_addr1);
             }
         }
-
-        ++loadIt;
     }
     return NoFault;
 }
@@ -1162,12 +1203,10 @@ LSQUnit::completeStore(typename StoreQueue::iterator store_idx)
             "idx:%i\n",
             store_inst->seqNum, store_idx.idx() - 1, storeQueue.head() - 1);
 
-#if TRACING_ON
-    if (debug::O3PipeView) {
+    if (cpu->tracePipeView()) {
         store_inst->storeTick =
             curTick() - store_inst->fetchTick;
     }
-#endif
 
     if (isStalled() &&
         store_inst->seqNum == stallingStoreIsn) {
@@ -1292,6 +1331,18 @@ LSQUnit::read(LSQRequest *request, int load_idx)
 
     assert(!load_inst->isExecuted());
 
+    {
+        // Index the load under the dependence-check granules it touches.
+        Addr ld_addr1 = load_inst->effAddr >> depCheckShift;
+        Addr ld_addr2 =
+            (load_inst->effAddr + load_inst->effSize - 1) >> depCheckShift;
+        loadAddrIndex.insert(std::min(ld_addr1, ld_addr2) << depCheckShift,
+                std::max(ld_addr1, ld_addr2) << depCheckShift,
+                load_idx, load_inst->seqNum,
+                [this](size_t idx, InstSeqNum sn)
+                { return inLoadQueue(idx, sn); });
+    }
+
     // Make sure this isn't a strictly ordered load
     // A bit of a hackish way to get strictly ordered accesses to work
     // only if they're at the head of the LSQ and are ready to commit
@@ -1385,10 +1436,24 @@ LSQUnit::read(LSQRequest *request, int load_idx)
     // Check the SQ for any previous stores that might lead to forwarding
     auto store_it = load_inst->sqIt;
     assert (store_it >= storeWBIt);
-    // End once we've reached the top of the LSQ
-    while (store_it != storeWBIt && !load_inst->isDataPrefetch()) {
-        // Move the index to one younger
-        store_it--;
+    // Only stores indexed under a block of the load can overlap it. Visit
+    // them youngest first, down to the top of the LSQ, as a walk of the
+    // store queue would. A zero-sized load can still be covered by a store
+    // that ends right where it starts.
+    addrCandidates.clear();
+    if (!load_inst->isDataPrefetch()) {
+        const Addr req_s = request->mainReq()->getVaddr();
+        const Addr req_size = request->mainReq()->getSize();
+        storeAddrIndex.search(req_size || !req_s ? req_s : req_s - 1,
+                req_size ? req_s + req_size - 1 : req_s,
+                storeWBIt.idx(), store_it.idx(),
+                [this](size_t idx, InstSeqNum sn)
+                { return inStoreQueue(idx, sn); },
+                addrCandidates);
+    }
+    for (auto cand = addrCandidates.rbegin(); cand != addrCandidates.rend();
+            ++cand) {
+        store_it = storeQueue.getIterator(*cand);
         assert(store_it->valid());
         assert(store_it->instruction()->seqNum < load_inst->seqNum);
         int store_size = store_it->size();
@@ -1611,6 +1676,15 @@ LSQUnit::write(LSQRequest *request, uint8_t *data, int store_idx)
     storeQueue[store_idx].setRequest(request);
     unsigned size = request->_size;
     storeQueue[store_idx].size() = size;
+
+    if (size != 0) {
+        const DynInstPtr &store_inst = storeQueue[store_idx].instruction();
+        storeAddrIndex.insert(store_inst->effAddr,
+                store_inst->effAddr + size - 1, store_idx,
+                store_inst->seqNum,
+                [this](size_t idx, InstSeqNum sn)
+                { return inStoreQueue(idx, sn); });
+    }
     bool store_no_data =
         request->mainReq()->getFlags() & Request::STORE_NO_DATA;
     storeQueue[store_idx].isAllZeros() = store_no_data;
@@ -47,6 +47,7 @@
 #include <map>
 #include <memory>
 #include <queue>
+#include <vector>
 
 #include "arch/generic/debugfaults.hh"
 #include "arch/generic/vec_reg.hh"
@@ -58,6 +59,7 @@
 #include "cpu/o3/cpu.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
 #include "cpu/o3/lsq.hh"
+#include "cpu/o3/lsq_addr_index.hh"
 #include "cpu/timebuf.hh"
 #include "debug/HtmCpu.hh"
 #include "debug/LSQUnit.hh"
@@ -302,6 +304,10 @@ class LSQUnit
     /** Returns the number of loads in the LQ. */
     int numLoads() { return loadQueue.size(); }
 
+    /** Returns the number of loads waiting on memory for at least a
+     * given time. */
+    unsigned numLongLoads(Tick min_wait);
+
     /** Returns the number of stores in the SQ. */
     int numStores() { return storeQueue.size(); }
 
@@ -363,6 +369,12 @@ class LSQUnit
     /** Reset the LSQ state */
     void resetState();
 
+    /** Whether LQ entry idx still holds instruction sn. */
+    bool inLoadQueue(size_t idx, InstSeqNum sn);
+
+    /** Whether SQ entry idx still holds instruction sn. */
+    bool inStoreQueue(size_t idx, InstSeqNum sn);
+
     /** Writes back the instruction, sending it to IEW. */
     void writeback(const DynInstPtr &inst, PacketPtr pkt);
 
@@ -475,6 +487,17 @@ class LSQUnit
     /** Address Mask for a cache block (e.g. ~(cache_block_size-1)) */
     Addr cacheBlockMask;
 
+    /** Block-address indices over the executed loads and stores, so that
+     * violation checks and store-to-load forwarding only look at entries
+     * that share a block with the access. Blocks are at least a cache line
+     * and at least a dependence-check granule.
+     */
+    LSQAddrIndex loadAddrIndex;
+    LSQAddrIndex storeAddrIndex;
+
+    /** Scratch list of the queue indices found by an index search. */
+    std::vector<size_t> addrCandidates;
+
     /** Wire to read information from the issue stage time queue. */
     typename TimeBuffer<IssueStruct>::wire fromIssue;
 
@@ -28,8 +28,8 @@
 
 #include "cpu/o3/mem_dep_unit.hh"
 
+#include <algorithm>
 #include <map>
-#include <memory>
 #include <vector>
 
 #include "base/compiler.hh"
@@ -47,7 +47,6 @@ namespace o3
 {
 
 #ifdef DEBUG
-int MemDepUnit::MemDepEntry::memdep_count = 0;
 int MemDepUnit::MemDepEntry::memdep_insert = 0;
 int MemDepUnit::MemDepEntry::memdep_erase = 0;
 #endif
@@ -66,26 +65,7 @@ MemDepUnit::MemDepUnit(const O3CPUParams &params)
 
 MemDepUnit::~MemDepUnit()
 {
-    for (ThreadID tid = 0; tid < MaxThreads; tid++) {
-
-        ListIt inst_list_it = instList[tid].begin();
-
-        MemDepHashIt hash_it;
-
-        while (!instList[tid].empty()) {
-            hash_it = memDepHash.find((*inst_list_it)->seqNum);
-
-            assert(hash_it != memDepHash.end());
-
-            memDepHash.erase(hash_it);
-
-            instList[tid].erase(inst_list_it++);
-        }
-    }
-
-#ifdef DEBUG
-    assert(MemDepEntry::memdep_count == 0);
-#endif
+    memDepEntries.clear();
 }
 
 void
@@ -120,10 +100,7 @@ bool
 MemDepUnit::isDrained() const
 {
     bool drained = instsToReplay.empty()
-                 && memDepHash.empty()
-                 && instsToReplay.empty();
-    for (int i = 0; i < MaxThreads; ++i)
-        drained = drained && instList[i].empty();
+                 && memDepEntries.empty();
 
     return drained;
 }
@@ -132,11 +109,7 @@ void
 MemDepUnit::drainSanityCheck() const
 {
     assert(instsToReplay.empty());
-    assert(memDepHash.empty());
-    for (int i = 0; i < MaxThreads; ++i)
-        assert(instList[i].empty());
-    assert(instsToReplay.empty());
-    assert(memDepHash.empty());
+    assert(memDepEntries.empty());
 }
 
 void
@@ -159,10 +132,16 @@ MemDepUnit::insertBarrierSN(const DynInstPtr &barr_inst)
 {
     InstSeqNum barr_sn = barr_inst->seqNum;
 
-    if (barr_inst->isReadBarrier() || barr_inst->isHtmCmd())
-        loadBarrierSNs.insert(barr_sn);
-    if (barr_inst->isWriteBarrier() || barr_inst->isHtmCmd())
-        storeBarrierSNs.insert(barr_sn);
+    // Barriers arrive in program order, so appending keeps the lists
+    // sorted; a barrier that is also a memory op may be seen twice.
+    if (barr_inst->isReadBarrier() || barr_inst->isHtmCmd()) {
+        if (loadBarrierSNs.empty() || loadBarrierSNs.back() < barr_sn)
+            loadBarrierSNs.push_back(barr_sn);
+    }
+    if (barr_inst->isWriteBarrier() || barr_inst->isHtmCmd()) {
+        if (storeBarrierSNs.empty() || storeBarrierSNs.back() < barr_sn)
+            storeBarrierSNs.push_back(barr_sn);
+    }
 
     if (debug::MemDepUnit) {
         const char *barrier_type = nullptr;
@@ -187,22 +166,32 @@ MemDepUnit::insertBarrierSN(const DynInstPtr &barr_inst)
 }
 
 void
-MemDepUnit::insert(const DynInstPtr &inst)
+MemDepUnit::eraseBarrierSN(std::vector<InstSeqNum> &barrier_sns,
+                           InstSeqNum barr_sn)
 {
-    ThreadID tid = inst->threadNumber;
+    auto it = std::find(barrier_sns.begin(), barrier_sns.end(), barr_sn);
+    if (it != barrier_sns.end())
+        barrier_sns.erase(it);
+}
 
-    MemDepEntryPtr inst_entry = std::make_shared<MemDepEntry>(inst);
+MemDepUnit::MemDepEntry &
+MemDepUnit::addEntry(const DynInstPtr &inst)
+{
+    if (MemDepEntry *entry = memDepEntries.find(inst->seqNum))
+        return *entry;
 
-    // Add the MemDepEntry to the hash.
-    memDepHash.insert(
-        std::pair<InstSeqNum, MemDepEntryPtr>(inst->seqNum, inst_entry));
+    memDepEntries.push_back(inst->seqNum, MemDepEntry(inst));
 #ifdef DEBUG
     MemDepEntry::memdep_insert++;
 #endif
 
-    instList[tid].push_back(inst);
+    return memDepEntries.back();
+}
 
-    inst_entry->listIt = --(instList[tid].end());
+void
+MemDepUnit::insert(const DynInstPtr &inst)
+{
+    MemDepEntry &inst_entry = addEntry(inst);
 
     // Check any barriers and the dependence predictor for any
     // producing memrefs/stores.
@@ -225,16 +214,14 @@ MemDepUnit::insert(const DynInstPtr &inst)
             producing_stores.push_back(dep);
     }
 
-    std::vector<MemDepEntryPtr> store_entries;
+    std::vector<MemDepEntry *> store_entries;
 
     // If there is a producing store, try to find the entry.
     for (auto producing_store : producing_stores) {
         DPRINTF(MemDepUnit, "Searching for producer [sn:%lli]\n",
                             producing_store);
-        MemDepHashIt hash_it = memDepHash.find(producing_store);
-
-        if (hash_it != memDepHash.end()) {
-            store_entries.push_back((*hash_it).second);
+        if (MemDepEntry *store_entry = memDepEntries.find(producing_store)) {
+            store_entries.push_back(store_entry);
             DPRINTF(MemDepUnit, "Producer found\n");
         }
     }
@@ -245,10 +232,10 @@ MemDepUnit::insert(const DynInstPtr &inst)
         DPRINTF(MemDepUnit, "No dependency for inst PC "
                 "%s [sn:%lli].\n", inst->pcState(), inst->seqNum);
 
-        assert(inst_entry->memDeps == 0);
+        assert(inst_entry.memDeps == 0);
 
         if (inst->readyToIssue()) {
-            inst_entry->regsReady = true;
+            inst_entry.regsReady = true;
 
             moveToReady(inst_entry);
         }
@@ -260,7 +247,7 @@ MemDepUnit::insert(const DynInstPtr &inst)
                 inst->pcState(), producing_store);
 
         if (inst->readyToIssue()) {
-            inst_entry->regsReady = true;
+            inst_entry.regsReady = true;
         }
 
         // Clear the bit saying this instruction can issue.
@@ -268,9 +255,9 @@ MemDepUnit::insert(const DynInstPtr &inst)
 
         // Add this instruction to the list of dependents.
         for (auto store_entry : store_entries)
-            store_entry->dependInsts.push_back(inst_entry);
+            store_entry->dependInsts.push_back(inst->seqNum);
 
-        inst_entry->memDeps = store_entries.size();
+        inst_entry.memDeps = store_entries.size();
 
         if (inst->isLoad()) {
             ++stats.conflictingLoads;
@@ -322,21 +309,7 @@ MemDepUnit::insertNonSpec(const DynInstPtr &inst)
 void
 MemDepUnit::insertBarrier(const DynInstPtr &barr_inst)
 {
-    ThreadID tid = barr_inst->threadNumber;
-
-    MemDepEntryPtr inst_entry = std::make_shared<MemDepEntry>(barr_inst);
-
-    // Add the MemDepEntry to the hash.
-    memDepHash.insert(
-        std::pair<InstSeqNum, MemDepEntryPtr>(barr_inst->seqNum, inst_entry));
-#ifdef DEBUG
-    MemDepEntry::memdep_insert++;
-#endif
-
-    // Add the instruction to the instruction list.
-    instList[tid].push_back(barr_inst);
-
-    inst_entry->listIt = --(instList[tid].end());
+    addEntry(barr_inst);
 
     insertBarrierSN(barr_inst);
 }
@@ -348,11 +321,11 @@ MemDepUnit::regsReady(const DynInstPtr &inst)
             "instruction PC %s [sn:%lli].\n",
             inst->pcState(), inst->seqNum);
 
-    MemDepEntryPtr inst_entry = findInHash(inst);
+    MemDepEntry &inst_entry = findEntry(inst);
 
-    inst_entry->regsReady = true;
+    inst_entry.regsReady = true;
 
-    if (inst_entry->memDeps == 0) {
+    if (inst_entry.memDeps == 0) {
         DPRINTF(MemDepUnit, "Instruction has its memory "
                 "dependencies resolved, adding it to the ready list.\n");
 
@@ -370,9 +343,7 @@ MemDepUnit::nonSpecInstReady(const DynInstPtr &inst)
             "instruction PC %s as ready [sn:%lli].\n",
             inst->pcState(), inst->seqNum);
 
-    MemDepEntryPtr inst_entry = findInHash(inst);
-
-    moveToReady(inst_entry);
+    moveToReady(findEntry(inst));
 }
 
 void
@@ -390,7 +361,7 @@ MemDepUnit::replay()
     while (!instsToReplay.empty()) {
         temp_inst = instsToReplay.front();
 
-        MemDepEntryPtr inst_entry = findInHash(temp_inst);
+        MemDepEntry &inst_entry = findEntry(temp_inst);
 
         DPRINTF(MemDepUnit, "Replaying mem instruction PC %s [sn:%lli].\n",
                 temp_inst->pcState(), temp_inst->seqNum);
@@ -407,18 +378,10 @@ MemDepUnit::completed(const DynInstPtr &inst)
     DPRINTF(MemDepUnit, "Completed mem instruction PC %s [sn:%lli].\n",
             inst->pcState(), inst->seqNum);
 
-    ThreadID tid = inst->threadNumber;
+    // Remove the instruction's entry.
+    assert(memDepEntries.find(inst->seqNum));
 
-    // Remove the instruction from the hash and the list.
-    MemDepHashIt hash_it = memDepHash.find(inst->seqNum);
-
-    assert(hash_it != memDepHash.end());
-
-    instList[tid].erase((*hash_it).second->listIt);
-
-    (*hash_it).second = NULL;
-
-    memDepHash.erase(hash_it);
+    memDepEntries.remove(inst->seqNum);
 #ifdef DEBUG
     MemDepEntry::memdep_erase++;
 #endif
@@ -433,11 +396,11 @@ MemDepUnit::completeInst(const DynInstPtr &inst)
 
     if (inst->isWriteBarrier() || inst->isHtmCmd()) {
         assert(hasStoreBarrier());
-        storeBarrierSNs.erase(barr_sn);
+        eraseBarrierSN(storeBarrierSNs, barr_sn);
     }
     if (inst->isReadBarrier() || inst->isHtmCmd()) {
         assert(hasLoadBarrier());
-        loadBarrierSNs.erase(barr_sn);
+        eraseBarrierSN(loadBarrierSNs, barr_sn);
     }
     if (debug::MemDepUnit) {
         const char *barrier_type = nullptr;
@@ -464,13 +427,13 @@ MemDepUnit::wakeDependents(const DynInstPtr &inst)
         return;
     }
 
-    MemDepEntryPtr inst_entry = findInHash(inst);
+    MemDepEntry &inst_entry = findEntry(inst);
 
-    for (int i = 0; i < inst_entry->dependInsts.size(); ++i ) {
-        MemDepEntryPtr woken_inst = inst_entry->dependInsts[i];
+    for (InstSeqNum dep_sn : inst_entry.dependInsts) {
+        MemDepEntry *woken_inst = memDepEntries.find(dep_sn);
 
-        if (!woken_inst->inst) {
-            // Potentially removed mem dep entries could be on this list
+        if (!woken_inst) {
+            // Dependents may have been squashed since
             continue;
         }
 
@@ -481,40 +444,12 @@ MemDepUnit::wakeDependents(const DynInstPtr &inst)
         assert(woken_inst->memDeps > 0);
         woken_inst->memDeps -= 1;
 
-        if ((woken_inst->memDeps == 0) &&
-            woken_inst->regsReady &&
-            !woken_inst->squashed) {
-            moveToReady(woken_inst);
+        if ((woken_inst->memDeps == 0) && woken_inst->regsReady) {
+            moveToReady(*woken_inst);
         }
     }
 
-    inst_entry->dependInsts.clear();
-}
-
-MemDepUnit::MemDepEntry::MemDepEntry(const DynInstPtr &new_inst) :
-    inst(new_inst)
-{
-#ifdef DEBUG
-    ++memdep_count;
-
-    DPRINTF(MemDepUnit,
-            "Memory dependency entry created. memdep_count=%i %s\n",
-            memdep_count, inst->pcState());
-#endif
-}
-
-MemDepUnit::MemDepEntry::~MemDepEntry()
-{
-    for (int i = 0; i < dependInsts.size(); ++i) {
-        dependInsts[i] = NULL;
-    }
-#ifdef DEBUG
-    --memdep_count;
-
-    DPRINTF(MemDepUnit,
-            "Memory dependency entry deleted. memdep_count=%i %s\n",
-            memdep_count, inst->pcState());
-#endif
+    inst_entry.dependInsts.clear();
 }
 
 void
@@ -532,35 +467,24 @@ MemDepUnit::squash(const InstSeqNum &squashed_num, ThreadID tid)
         }
     }
 
-    ListIt squash_it = instList[tid].end();
-    --squash_it;
-
-    MemDepHashIt hash_it;
+    // Barriers are kept oldest first, so the squashed ones are at the back.
+    while (!loadBarrierSNs.empty() && loadBarrierSNs.back() > squashed_num)
+        loadBarrierSNs.pop_back();
+    while (!storeBarrierSNs.empty() &&
+           storeBarrierSNs.back() > squashed_num) {
+        storeBarrierSNs.pop_back();
+    }
 
-    while (!instList[tid].empty() &&
-           (*squash_it)->seqNum > squashed_num) {
+    while (!memDepEntries.empty() &&
+           memDepEntries.tail() > squashed_num) {
 
         DPRINTF(MemDepUnit, "Squashing inst [sn:%lli]\n",
-                (*squash_it)->seqNum);
-
-        loadBarrierSNs.erase((*squash_it)->seqNum);
-
-        storeBarrierSNs.erase((*squash_it)->seqNum);
-
-        hash_it = memDepHash.find((*squash_it)->seqNum);
+                memDepEntries.tail());
 
-        assert(hash_it != memDepHash.end());
-
-        (*hash_it).second->squashed = true;
-
-        (*hash_it).second = NULL;
-
-        memDepHash.erase(hash_it);
+        memDepEntries.remove(memDepEntries.tail());
 #ifdef DEBUG
         MemDepEntry::memdep_erase++;
 #endif
-
-        instList[tid].erase(squash_it--);
     }
 
     // Tell the dependency predictor to squash as well.
@@ -588,55 +512,53 @@ MemDepUnit::issue(const DynInstPtr &inst)
     depPred.issued(inst->pcState().instAddr(), inst->seqNum, inst->isStore());
 }
 
-MemDepUnit::MemDepEntryPtr &
-MemDepUnit::findInHash(const DynInstConstPtr &inst)
+MemDepUnit::MemDepEntry &
+MemDepUnit::findEntry(const DynInstConstPtr &inst)
 {
-    MemDepHashIt hash_it = memDepHash.find(inst->seqNum);
+    MemDepEntry *entry = memDepEntries.find(inst->seqNum);
 
-    assert(hash_it != memDepHash.end());
+    assert(entry);
 
-    return (*hash_it).second;
+    return *entry;
 }
 
 void
-MemDepUnit::moveToReady(MemDepEntryPtr &woken_inst_entry)
+MemDepUnit::moveToReady(MemDepEntry &woken_inst_entry)
 {
     DPRINTF(MemDepUnit, "Adding instruction [sn:%lli] "
-            "to the ready list.\n", woken_inst_entry->inst->seqNum);
+            "to the ready list.\n", woken_inst_entry.inst->seqNum);
 
-    assert(!woken_inst_entry->squashed);
-
-    iqPtr->addReadyMemInst(woken_inst_entry->inst);
+    iqPtr->addReadyMemInst(woken_inst_entry.inst);
 }
 
 
 void
 MemDepUnit::dumpLists()
 {
-    for (ThreadID tid = 0; tid < MaxThreads; tid++) {
-        cprintf("Instruction list %i size: %i\n",
-                tid, instList[tid].size());
-
-        ListIt inst_list_it = instList[tid].begin();
-        int num = 0;
-
-        while (inst_list_it != instList[tid].end()) {
+    int num = 0;
+
+    if (!memDepEntries.empty()) {
+        for (InstSeqNum sn = memDepEntries.head();
+             sn <= memDepEntries.tail(); ++sn) {
+            const DynInstPtr &inst = memDepEntries[sn].inst;
+            if (!inst)
+                continue;
             cprintf("Instruction:%i\nPC: %s\n[sn:%llu]\n[tid:%i]\nIssued:%i\n"
                     "Squashed:%i\n\n",
-                    num, (*inst_list_it)->pcState(),
-                    (*inst_list_it)->seqNum,
-                    (*inst_list_it)->threadNumber,
-                    (*inst_list_it)->isIssued(),
-                    (*inst_list_it)->isSquashed());
-            inst_list_it++;
+                    num, inst->pcState(),
+                    inst->seqNum,
+                    inst->threadNumber,
+                    inst->isIssued(),
+                    inst->isSquashed());
             ++num;
         }
     }
 
-    cprintf("Memory dependence hash size: %i\n", memDepHash.size());
+    cprintf("Instruction list %i size: %i\n", id, num);
 
 #ifdef DEBUG
-    cprintf("Memory dependence entries: %i\n", MemDepEntry::memdep_count);
+    cprintf("Memory dependence entries: %i\n",
+            MemDepEntry::memdep_insert - MemDepEntry::memdep_erase);
 #endif
 }
 
@@ -42,14 +42,12 @@
 #define __CPU_O3_MEM_DEP_UNIT_HH__
 
 #include <list>
-#include <memory>
-#include <set>
-#include <unordered_map>
-#include <unordered_set>
+#include <vector>
 
 #include "base/statistics.hh"
 #include "cpu/inst_seq.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
+#include "cpu/o3/inst_ring.hh"
 #include "cpu/o3/limits.hh"
 #include "cpu/o3/store_set.hh"
 #include "debug/MemDepUnit.hh"
@@ -57,17 +55,6 @@
 namespace gem5
 {
 
-struct SNHash
-{
-    size_t
-    operator()(const InstSeqNum &seq_num) const
-    {
-        unsigned a = (unsigned)seq_num;
-        unsigned hash = (((a >> 14) ^ ((a >> 2) & 0xffff))) & 0x7FFFFFFF;
-        return hash;
-    }
-};
-
 struct O3CPUParams;
 
 namespace o3
@@ -171,10 +158,6 @@ class MemDepUnit
 
     typedef typename std::list<DynInstPtr>::iterator ListIt;
 
-    class MemDepEntry;
-
-    typedef std::shared_ptr<MemDepEntry> MemDepEntryPtr;
-
     /** Memory dependence entries that track memory operations, marking
      *  when the instruction is ready to execute and what instructions depend
      *  upon it.
@@ -182,56 +165,56 @@ class MemDepUnit
     class MemDepEntry
     {
       public:
-        /** Constructs a memory dependence entry. */
-        MemDepEntry(const DynInstPtr &new_inst);
+        MemDepEntry() = default;
 
-        /** Frees any pointers. */
-        ~MemDepEntry();
+        /** Constructs a memory dependence entry. */
+        MemDepEntry(const DynInstPtr &new_inst) : inst(new_inst) {}
 
         /** Returns the name of the memory dependence entry. */
         std::string name() const { return "memdepentry"; }
 
+        /** Whether the entry is in use. */
+        explicit operator bool() const { return bool(inst); }
+
         /** The instruction being tracked. */
         DynInstPtr inst;
 
-        /** The iterator to the instruction's location inside the list. */
-        ListIt listIt;
-
-        /** A vector of any dependent instructions. */
-        std::vector<MemDepEntryPtr> dependInsts;
+        /** Sequence numbers of any dependent instructions. Entries that
+         *  have been squashed since are no longer found. */
+        std::vector<InstSeqNum> dependInsts;
 
         /** If the registers are ready or not. */
         bool regsReady = false;
+
         /** Number of memory dependencies that need to be satisfied. */
         int memDeps = 0;
+
         /** If the instruction is completed. */
         bool completed = false;
-        /** If the instruction is squashed. */
-        bool squashed = false;
 
         /** For debugging. */
 #ifdef DEBUG
-        static int memdep_count;
         static int memdep_insert;
         static int memdep_erase;
 #endif
     };
 
-    /** Finds the memory dependence entry in the hash map. */
-    MemDepEntryPtr &findInHash(const DynInstConstPtr& inst);
+    /** Finds the memory dependence entry of an instruction. */
+    MemDepEntry &findEntry(const DynInstConstPtr& inst);
 
     /** Moves an entry to the ready list. */
-    void moveToReady(MemDepEntryPtr &ready_inst_entry);
-
-    typedef std::unordered_map<InstSeqNum, MemDepEntryPtr, SNHash> MemDepHash;
+    void moveToReady(MemDepEntry &ready_inst_entry);
 
-    typedef typename MemDepHash::iterator MemDepHashIt;
-
-    /** A hash map of all memory dependence entries. */
-    MemDepHash memDepHash;
+    /** Adds an entry for a new instruction, unless it already has one.
+     *  @return The entry of the instruction.
+     */
+    MemDepEntry &addEntry(const DynInstPtr &inst);
 
-    /** A list of all instructions in the memory dependence unit. */
-    std::list<DynInstPtr> instList[MaxThreads];
+    /** All memory dependence entries, indexed by sequence number.  As each
+     *  unit serves a single thread, this is also the list of all
+     *  instructions in the unit in program order.
+     */
+    InstRing<MemDepEntry> memDepEntries;
 
     /** A list of all instructions that are going to be replayed. */
     std::list<DynInstPtr> instsToReplay;
@@ -243,11 +226,15 @@ class MemDepUnit
      */
     StoreSet depPred;
 
-    /** Sequence numbers of outstanding load barriers. */
-    std::unordered_set<InstSeqNum> loadBarrierSNs;
+    /** Sequence numbers of outstanding load barriers, oldest first. */
+    std::vector<InstSeqNum> loadBarrierSNs;
+
+    /** Sequence numbers of outstanding store barriers, oldest first. */
+    std::vector<InstSeqNum> storeBarrierSNs;
 
-    /** Sequence numbers of outstanding store barriers. */
-    std::unordered_set<InstSeqNum> storeBarrierSNs;
+    /** Removes a sequence number from a list of barriers. */
+    static void eraseBarrierSN(std::vector<InstSeqNum> &barrier_sns,
+                               InstSeqNum barr_sn);
 
     /** Is there an outstanding load barrier that loads must wait on. */
     bool hasLoadBarrier() const { return !loadBarrierSNs.empty(); }
@@ -0,0 +1,46 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+
+from m5.objects.Probe import *
+
+class PipeViewTrace(ProbeListenerObject):
+    type = 'PipeViewTrace'
+    cxx_class = 'gem5::o3::PipeViewTrace'
+    cxx_header = 'cpu/o3/probe/pipeview_trace.hh'
+
+    # The trace file is created in the output directory.
+    traceFile = Param.String("", "Protobuf trace file name, defaults to " \
+                             "<name>.pipeview.pb.gz")
+    # Sampling controls, applied to the fetch tick and the sequence number
+    # of every instruction leaving the CPU.
+    startTick = Param.Tick(0, "Only trace instructions fetched at or " \
+                           "after this tick")
+    stopTick = Param.Tick(MaxTick, "Only trace instructions fetched " \
+                          "before this tick")
+    samplePeriod = Param.UInt64(0, "Trace sampleLength out of every " \
+                                "samplePeriod instructions, by sequence " \
+                                "number. Zero traces every instruction.")
+    sampleLength = Param.UInt64(1000, "Number of consecutive instructions " \
+                                "traced per sample period")
+    traceDisasm = Param.Bool(False, "Record the disassembly of every " \
+                             "instruction, which makes the trace " \
+                             "considerably larger")
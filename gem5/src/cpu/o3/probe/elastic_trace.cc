@@ -37,7 +37,10 @@
 
 #include "cpu/o3/probe/elastic_trace.hh"
 
+#include <algorithm>
+
 #include "base/callback.hh"
+#include "base/intmath.hh"
 #include "base/output.hh"
 #include "base/trace.hh"
 #include "cpu/o3/dyn_inst.hh"
@@ -55,7 +58,9 @@ ElasticTrace::ElasticTrace(const ElasticTraceParams &params)
     :  ProbeListenerObject(params),
        regEtraceListenersEvent([this]{ regEtraceListeners(); }, name()),
        firstWin(true),
+       tempStoreSize(0),
        lastClearedSeqNum(0),
+       physRegDepMapSize(0),
        depWindowSize(params.depWindowSize),
        dataTraceStream(nullptr),
        instTraceStream(nullptr),
@@ -77,6 +82,14 @@ ElasticTrace::ElasticTrace(const ElasticTraceParams &params)
 
     fatal_if(cpu->numThreads > 1, "numThreads = %i, %s supports tracing for"\
                 "single-threaded workload only", cpu->numThreads, name());
+
+    // The instructions in flight fit in a window, and the dependency trace
+    // holds two windows of records
+    tempStore.resize(1ULL << ceilLog2(depWindowSize));
+    traceInfoPool.resize(2 * depWindowSize);
+    for (auto &record : traceInfoPool)
+        freeTraceInfo.push_back(&record);
+
     // Initialize the protobuf output stream
     fatal_if(params.instFetchTraceFile == "", "Assign instruction fetch "\
                 "trace file path to instFetchTraceFile");
@@ -84,21 +97,22 @@ ElasticTrace::ElasticTrace(const ElasticTraceParams &params)
                 "trace file path to dataDepTraceFile");
     std::string filename = simout.resolve(name() + "." +
                                             params.instFetchTraceFile);
-    instTraceStream = new ProtoOutputStream(filename);
+    instTraceStream =
+        new AsyncProtoOutputStream<ProtoMessage::Packet>(filename);
     filename = simout.resolve(name() + "." + params.dataDepTraceFile);
-    dataTraceStream = new ProtoOutputStream(filename);
+    dataTraceStream = new AsyncProtoOutputStream<Record>(filename);
     // Create a protobuf message for the header and write it to the stream
     ProtoMessage::PacketHeader inst_pkt_header;
     inst_pkt_header.set_obj_id(name());
     inst_pkt_header.set_tick_freq(sim_clock::Frequency);
-    instTraceStream->write(inst_pkt_header);
+    instTraceStream->writeHeader(inst_pkt_header);
     // Create a protobuf message for the header and write it to
     // the stream
     ProtoMessage::InstDepRecordHeader data_rec_header;
     data_rec_header.set_obj_id(name());
     data_rec_header.set_tick_freq(sim_clock::Frequency);
     data_rec_header.set_window_size(depWindowSize);
-    dataTraceStream->write(data_rec_header);
+    dataTraceStream->writeHeader(data_rec_header);
     // Register a callback to flush trace records and close the output streams.
     registerExitCallback([this]() {  flushTraces(); });
 }
@@ -159,17 +173,15 @@ ElasticTrace::fetchReqTrace(const RequestPtr &req)
              req->getPC(), req->getVaddr(), req->getPaddr(),
              req->getFlags(), req->getSize(), curTick());
 
-    // Create a protobuf message including the request fields necessary to
-    // recreate the request in the TraceCPU.
-    ProtoMessage::Packet inst_fetch_pkt;
+    // Fill a protobuf message including the request fields necessary to
+    // recreate the request in the TraceCPU. It is written by the stream.
+    ProtoMessage::Packet &inst_fetch_pkt = instTraceStream->next();
     inst_fetch_pkt.set_tick(curTick());
     inst_fetch_pkt.set_cmd(MemCmd::ReadReq);
     inst_fetch_pkt.set_pc(req->getPC());
     inst_fetch_pkt.set_flags(req->getFlags());
     inst_fetch_pkt.set_addr(req->getPaddr());
     inst_fetch_pkt.set_size(req->getSize());
-    // Write the message to the stream.
-    instTraceStream->write(inst_fetch_pkt);
 }
 
 void
@@ -195,17 +207,13 @@ ElasticTrace::recordExecTick(const DynInstConstPtr& dyn_inst)
     // instruction had a register dependency recorded in the rename probe
     // listener before entering execute stage or it will not exist and will
     // need to be created here.
-    InstExecInfo* exec_info_ptr;
-    auto itr_exec_info = tempStore.find(dyn_inst->seqNum);
-    if (itr_exec_info != tempStore.end()) {
-        exec_info_ptr = itr_exec_info->second;
-    } else {
-        exec_info_ptr = new InstExecInfo;
-        tempStore[dyn_inst->seqNum] = exec_info_ptr;
+    InstExecInfo* exec_info_ptr = findExecInfo(dyn_inst->seqNum);
+    if (!exec_info_ptr) {
+        exec_info_ptr = allocExecInfo(dyn_inst->seqNum);
     }
 
     exec_info_ptr->executeTick = curTick();
-    stats.maxTempStoreSize = std::max(tempStore.size(),
+    stats.maxTempStoreSize = std::max(tempStoreSize,
                                 (std::size_t)stats.maxTempStoreSize.value());
 }
 
@@ -216,8 +224,8 @@ ElasticTrace::recordToCommTick(const DynInstConstPtr& dyn_inst)
     // execution is far enough that we cannot gather info about its past like
     // the tick it started execution. Simply return until we see an instruction
     // that is found in the tempStore.
-    auto itr_exec_info = tempStore.find(dyn_inst->seqNum);
-    if (itr_exec_info == tempStore.end()) {
+    InstExecInfo* exec_info_ptr = findExecInfo(dyn_inst->seqNum);
+    if (!exec_info_ptr) {
         DPRINTFR(ElasticTrace, "recordToCommTick: [sn:%lli] Not in temp store,"
                     " skipping.\n", dyn_inst->seqNum);
         return;
@@ -225,7 +233,6 @@ ElasticTrace::recordToCommTick(const DynInstConstPtr& dyn_inst)
 
     DPRINTFR(ElasticTrace, "[sn:%lli] To Commit Tick = %i\n", dyn_inst->seqNum,
                 curTick());
-    InstExecInfo* exec_info_ptr = itr_exec_info->second;
     exec_info_ptr->toCommitTick = curTick();
 
 }
@@ -241,8 +248,7 @@ ElasticTrace::updateRegDep(const DynInstConstPtr& dyn_inst)
     // Since this is the first probe activated in the pipeline, create
     // a new execution info object to track this instruction as it
     // progresses through the pipeline.
-    InstExecInfo* exec_info_ptr = new InstExecInfo;
-    tempStore[seq_num] = exec_info_ptr;
+    InstExecInfo* exec_info_ptr = allocExecInfo(seq_num);
 
     // Loop through the source registers and look up the dependency map. If
     // the source register entry is found in the dependency map, add a
@@ -258,17 +264,23 @@ ElasticTrace::updateRegDep(const DynInstConstPtr& dyn_inst)
             DPRINTFR(ElasticTrace, "[sn:%lli] Check map for src reg"
                      " %i (%s)\n", seq_num,
                      phys_src_reg->flatIndex(), phys_src_reg->className());
-            auto itr_writer = physRegDepMap.find(phys_src_reg->flatIndex());
-            if (itr_writer != physRegDepMap.end()) {
-                InstSeqNum last_writer = itr_writer->second;
+            RegIndex src_idx_flat = phys_src_reg->flatIndex();
+            if (src_idx_flat < physRegDepMap.size() &&
+                    physRegDepMap[src_idx_flat] != 0) {
+                InstSeqNum last_writer = physRegDepMap[src_idx_flat];
                 // Additionally the dependency distance is kept less than the
                 // window size parameter to limit the memory allocation to
                 // nodes in the graph. If the window were tending to infinite
                 // we would have to load a large number of node objects during
                 // replay.
                 if (seq_num - last_writer < depWindowSize) {
-                    // Record a physical register dependency.
-                    exec_info_ptr->physRegDepSet.insert(last_writer);
+                    // Record a physical register dependency, keeping the
+                    // set sorted and without duplicates.
+                    auto &dep_set = exec_info_ptr->physRegDepSet;
+                    auto pos = std::lower_bound(dep_set.begin(),
+                                                dep_set.end(), last_writer);
+                    if (pos == dep_set.end() || *pos != last_writer)
+                        dep_set.insert(pos, last_writer);
                 }
             }
 
@@ -292,10 +304,15 @@ ElasticTrace::updateRegDep(const DynInstConstPtr& dyn_inst)
             DPRINTFR(ElasticTrace, "[sn:%lli] Update map for dest reg"
                      " %i (%s)\n", seq_num, phys_dest_reg->flatIndex(),
                      dest_reg.className());
-            physRegDepMap[phys_dest_reg->flatIndex()] = seq_num;
+            RegIndex dest_idx_flat = phys_dest_reg->flatIndex();
+            if (dest_idx_flat >= physRegDepMap.size())
+                physRegDepMap.resize(dest_idx_flat + 1, 0);
+            if (physRegDepMap[dest_idx_flat] == 0)
+                ++physRegDepMapSize;
+            physRegDepMap[dest_idx_flat] = seq_num;
         }
     }
-    stats.maxPhysRegDepMapSize = std::max(physRegDepMap.size(),
+    stats.maxPhysRegDepMapSize = std::max(physRegDepMapSize,
                             (std::size_t)stats.maxPhysRegDepMapSize.value());
 }
 
@@ -304,9 +321,11 @@ ElasticTrace::removeRegDepMapEntry(const SeqNumRegPair &inst_reg_pair)
 {
     DPRINTFR(ElasticTrace, "Remove Map entry for Reg %i\n",
             inst_reg_pair.second);
-    auto itr_regdep_map = physRegDepMap.find(inst_reg_pair.second);
-    if (itr_regdep_map != physRegDepMap.end())
-        physRegDepMap.erase(itr_regdep_map);
+    RegIndex reg = inst_reg_pair.second;
+    if (reg < physRegDepMap.size() && physRegDepMap[reg] != 0) {
+        physRegDepMap[reg] = 0;
+        --physRegDepMapSize;
+    }
 }
 
 void
@@ -315,16 +334,14 @@ ElasticTrace::addSquashedInst(const DynInstConstPtr& head_inst)
     // If the squashed instruction was squashed before being processed by
     // execute stage then it will not be in the temporary store. In this case
     // do nothing and return.
-    auto itr_exec_info = tempStore.find(head_inst->seqNum);
-    if (itr_exec_info == tempStore.end())
+    InstExecInfo* exec_info_ptr = findExecInfo(head_inst->seqNum);
+    if (!exec_info_ptr)
         return;
 
     // If there is a squashed load for which a read request was
     // sent before it got squashed then add it to the trace.
     DPRINTFR(ElasticTrace, "Attempt to add squashed inst [sn:%lli]\n",
                 head_inst->seqNum);
-    // Get pointer to the execution info object corresponding to the inst.
-    InstExecInfo* exec_info_ptr = itr_exec_info->second;
     if (head_inst->isLoad() && exec_info_ptr->executeTick != MaxTick &&
         exec_info_ptr->toCommitTick != MaxTick &&
         head_inst->hasRequest() &&
@@ -350,15 +367,13 @@ ElasticTrace::addCommittedInst(const DynInstConstPtr& head_inst)
         // of execution is far enough that we cannot gather info about its past
         // like the tick it started execution. Simply return until we see an
         // instruction that is found in the tempStore.
-        auto itr_temp_store = tempStore.find(head_inst->seqNum);
-        if (itr_temp_store == tempStore.end()) {
+        InstExecInfo* exec_info_ptr = findExecInfo(head_inst->seqNum);
+        if (!exec_info_ptr) {
             DPRINTFR(ElasticTrace, "addCommittedInst: [sn:%lli] Not in temp "
                 "store, skipping.\n", head_inst->seqNum);
             return;
         }
 
-        // Get pointer to the execution info object corresponding to the inst.
-        InstExecInfo* exec_info_ptr = itr_temp_store->second;
         assert(exec_info_ptr->executeTick != MaxTick);
         assert(exec_info_ptr->toCommitTick != MaxTick);
 
@@ -400,10 +415,13 @@ void
 ElasticTrace::addDepTraceRecord(const DynInstConstPtr& head_inst,
                                 InstExecInfo* exec_info_ptr, bool commit)
 {
-    // Create a record to assign dynamic intruction related fields.
-    TraceInfo* new_record = new TraceInfo;
-    // Add to map for sequence number look up to retrieve the TraceInfo pointer
-    traceInfoMap[head_inst->seqNum] = new_record;
+    // Take a record to assign dynamic intruction related fields. The records
+    // are in commit order, so they are looked up by sequence number with a
+    // binary search of depTrace.
+    assert(!freeTraceInfo.empty());
+    assert(depTrace.empty() || depTrace.back()->instNum < head_inst->seqNum);
+    TraceInfo* new_record = freeTraceInfo.back();
+    freeTraceInfo.pop_back();
 
     // Assign fields from the instruction
     new_record->instNum = head_inst->seqNum;
@@ -449,18 +467,17 @@ ElasticTrace::addDepTraceRecord(const DynInstConstPtr& head_inst,
     }
 
     // Assign the register dependencies stored in the execution info object
-    std::set<InstSeqNum>::const_iterator dep_set_it;
+    std::vector<InstSeqNum>::const_iterator dep_set_it;
     for (dep_set_it = (exec_info_ptr->physRegDepSet).begin();
          dep_set_it != (exec_info_ptr->physRegDepSet).end();
          ++dep_set_it) {
-        auto trace_info_itr = traceInfoMap.find(*dep_set_it);
-        if (trace_info_itr != traceInfoMap.end()) {
+        TraceInfo* reg_dep = findTraceInfo(*dep_set_it);
+        if (reg_dep) {
             // The register dependency is valid. Assign it and calculate
             // computational delay
             new_record->physRegDepList.push_back(*dep_set_it);
             DPRINTF(ElasticTrace, "Inst %lli has register dependency on "
                     "%lli\n", new_record->instNum, *dep_set_it);
-            TraceInfo* reg_dep = trace_info_itr->second;
             reg_dep->numDepts++;
             compDelayPhysRegDep(reg_dep, new_record);
             ++stats.numRegDep;
@@ -661,25 +678,84 @@ ElasticTrace::hasCompCompleted(TraceInfo* past_record,
 void
 ElasticTrace::clearTempStoreUntil(const DynInstConstPtr& head_inst)
 {
-    // Clear from temp store starting with the execution info object
-    // corresponding the head_inst and continue clearing by decrementing the
-    // sequence number until the last cleared sequence number.
+    // Free the execution info objects from the one after the last cleared
+    // sequence number until the one corresponding to the head_inst. Only
+    // the sequence numbers the ring can hold need to be looked at, any older
+    // entry is free anyway once older than the last cleared sequence number.
     InstSeqNum temp_sn = (head_inst->seqNum);
-    while (temp_sn > lastClearedSeqNum) {
-        auto itr_exec_info = tempStore.find(temp_sn);
-        if (itr_exec_info != tempStore.end()) {
-            InstExecInfo* exec_info_ptr = itr_exec_info->second;
-            // Free allocated memory for the info object
-            delete exec_info_ptr;
-            // Remove entry from temporary store
-            tempStore.erase(itr_exec_info);
+    if (temp_sn > lastClearedSeqNum) {
+        const InstSeqNum size = tempStore.size();
+        InstSeqNum first_sn = lastClearedSeqNum + 1;
+        if (temp_sn - lastClearedSeqNum > size)
+            first_sn = temp_sn - size + 1;
+        for (InstSeqNum sn = first_sn; sn <= temp_sn; sn++) {
+            InstExecInfo &exec_info = tempStore[sn & (size - 1)];
+            if (exec_info.seqNum == sn) {
+                exec_info.seqNum = 0;
+                --tempStoreSize;
+            }
         }
-        temp_sn--;
     }
     // Update the last cleared sequence number to that of the head_inst
     lastClearedSeqNum = head_inst->seqNum;
 }
 
+ElasticTrace::InstExecInfo*
+ElasticTrace::findExecInfo(InstSeqNum seq_num)
+{
+    InstExecInfo &exec_info = tempStore[seq_num & (tempStore.size() - 1)];
+    if (exec_info.seqNum != seq_num || seq_num <= lastClearedSeqNum)
+        return nullptr;
+    return &exec_info;
+}
+
+ElasticTrace::InstExecInfo*
+ElasticTrace::allocExecInfo(InstSeqNum seq_num)
+{
+    // An entry is in use if it belongs to an instruction that has not been
+    // cleared yet
+    auto in_use = [this](const InstExecInfo &exec_info) {
+        return exec_info.seqNum > lastClearedSeqNum;
+    };
+
+    InstExecInfo *exec_info = &tempStore[seq_num & (tempStore.size() - 1)];
+    while (in_use(*exec_info) && exec_info->seqNum != seq_num) {
+        // Another instruction in flight has the entry, double the ring and
+        // move the entries in use to their place in it
+        std::vector<InstExecInfo> old_store(tempStore.size() * 2);
+        tempStore.swap(old_store);
+        tempStoreSize = 0;
+        for (auto &old_info : old_store) {
+            if (in_use(old_info)) {
+                tempStore[old_info.seqNum & (tempStore.size() - 1)] =
+                    std::move(old_info);
+                ++tempStoreSize;
+            }
+        }
+        exec_info = &tempStore[seq_num & (tempStore.size() - 1)];
+    }
+
+    if (exec_info->seqNum == 0)
+        ++tempStoreSize;
+    exec_info->seqNum = seq_num;
+    exec_info->executeTick = MaxTick;
+    exec_info->toCommitTick = MaxTick;
+    exec_info->physRegDepSet.clear();
+    return exec_info;
+}
+
+ElasticTrace::TraceInfo*
+ElasticTrace::findTraceInfo(InstSeqNum seq_num)
+{
+    auto itr = std::lower_bound(depTrace.begin(), depTrace.end(), seq_num,
+        [](const TraceInfo *record, InstSeqNum sn) {
+            return record->instNum < sn;
+        });
+    if (itr == depTrace.end() || (*itr)->instNum != seq_num)
+        return nullptr;
+    return *itr;
+}
+
 void
 ElasticTrace::compDelayRob(TraceInfo* past_record, TraceInfo* new_record)
 {
@@ -830,8 +906,9 @@ ElasticTrace::writeDepTrace(uint32_t num_to_write)
             DPRINTFR(ElasticTrace, "\thas computational delay %lli\n",
                      temp_ptr->compDelay);
 
-            // Create a protobuf message for the dependency record
-            ProtoMessage::InstDepRecord dep_pkt;
+            // Fill a protobuf message for the dependency record, which is
+            // written by the stream
+            Record &dep_pkt = dataTraceStream->next();
             dep_pkt.set_seq_num(temp_ptr->instNum);
             dep_pkt.set_type(temp_ptr->type);
             dep_pkt.set_pc(temp_ptr->pc);
@@ -848,20 +925,18 @@ ElasticTrace::writeDepTrace(uint32_t num_to_write)
             if (temp_ptr->robDepList.empty()) {
                 DPRINTFR(ElasticTrace, "\thas no order (rob) dependencies\n");
             }
-            while (!temp_ptr->robDepList.empty()) {
+            for (InstSeqNum rob_dep : temp_ptr->robDepList) {
                 DPRINTFR(ElasticTrace, "\thas order (rob) dependency on %lli\n",
-                         temp_ptr->robDepList.front());
-                dep_pkt.add_rob_dep(temp_ptr->robDepList.front());
-                temp_ptr->robDepList.pop_front();
+                         rob_dep);
+                dep_pkt.add_rob_dep(rob_dep);
             }
             if (temp_ptr->physRegDepList.empty()) {
                 DPRINTFR(ElasticTrace, "\thas no register dependencies\n");
             }
-            while (!temp_ptr->physRegDepList.empty()) {
+            for (InstSeqNum reg_dep : temp_ptr->physRegDepList) {
                 DPRINTFR(ElasticTrace, "\thas register dependency on %lli\n",
-                         temp_ptr->physRegDepList.front());
-                dep_pkt.add_reg_dep(temp_ptr->physRegDepList.front());
-                temp_ptr->physRegDepList.pop_front();
+                         reg_dep);
+                dep_pkt.add_reg_dep(reg_dep);
             }
             if (num_filtered_nodes != 0) {
                 // Set the weight of this node as the no. of filtered nodes
@@ -871,8 +946,6 @@ ElasticTrace::writeDepTrace(uint32_t num_to_write)
                 dep_pkt.set_weight(num_filtered_nodes);
                 num_filtered_nodes = 0;
             }
-            // Write the message to the protobuf output stream
-            dataTraceStream->write(dep_pkt);
         } else {
             // Don't write the node to the trace but note that we have filtered
             // out a node.
@@ -880,8 +953,10 @@ ElasticTrace::writeDepTrace(uint32_t num_to_write)
             ++num_filtered_nodes;
         }
         dep_trace_itr++;
-        traceInfoMap.erase(temp_ptr->instNum);
-        delete temp_ptr;
+        // Give the record back, its lists keep their memory
+        temp_ptr->robDepList.clear();
+        temp_ptr->physRegDepList.clear();
+        freeTraceInfo.push_back(temp_ptr);
         num_to_write--;
     }
     depTrace.erase(dep_trace_itr_start, dep_trace_itr);
@@ -46,9 +46,8 @@
 #ifndef __CPU_O3_PROBE_ELASTIC_TRACE_HH__
 #define __CPU_O3_PROBE_ELASTIC_TRACE_HH__
 
-#include <set>
-#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "base/statistics.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
@@ -210,16 +209,20 @@ class ElasticTrace : public ProbeListenerObject
          */
         Tick toCommitTick;
         /**
-         * Set of instruction sequence numbers that this instruction depends on
-         * due to Read After Write data dependency based on physical register.
+         * Sorted instruction sequence numbers that this instruction depends
+         * on due to Read After Write data dependency based on physical
+         * register. Its memory is kept when the entry is reused.
          */
-        std::set<InstSeqNum> physRegDepSet;
+        std::vector<InstSeqNum> physRegDepSet;
+        /** Sequence number of the instruction, 0 if the entry is free */
+        InstSeqNum seqNum;
         /** @} */
 
         /** Constructor */
         InstExecInfo()
           : executeTick(MaxTick),
-            toCommitTick(MaxTick)
+            toCommitTick(MaxTick),
+            seqNum(0)
         { }
     };
 
@@ -229,8 +232,15 @@ class ElasticTrace : public ProbeListenerObject
      * the output trace then this information is looked up using the instruction
      * sequence number as the key. If it is not chosen then the entry for it in
      * the store is cleared.
+     *
+     * The instructions in flight have consecutive sequence numbers, so the
+     * store is a ring of preallocated entries indexed by sequence number,
+     * which is grown if two instructions in flight fall in the same entry.
      */
-    std::unordered_map<InstSeqNum, InstExecInfo*> tempStore;
+    std::vector<InstExecInfo> tempStore;
+
+    /** Number of entries in use in the temporary store */
+    size_t tempStoreSize;
 
     /**
      * The last cleared instruction sequence number used to free up the memory
@@ -240,10 +250,14 @@ class ElasticTrace : public ProbeListenerObject
 
     /**
      * Map for recording the producer of a physical register to check Read
-     * After Write dependencies. The key is the renamed physical register and
-     * the value is the instruction sequence number of its last producer.
+     * After Write dependencies. It is indexed by the flat index of the
+     * renamed physical register and holds the instruction sequence number of
+     * its last producer, or 0 if there is none.
      */
-    std::unordered_map<RegIndex, InstSeqNum> physRegDepMap;
+    std::vector<InstSeqNum> physRegDepMap;
+
+    /** Number of physical registers with a producer in physRegDepMap */
+    size_t physRegDepMapSize;
 
     /**
      * @defgroup TraceInfo Struct for a record in the instruction dependency
@@ -274,9 +288,9 @@ class ElasticTrace : public ProbeListenerObject
         /* If instruction was committed, as against squashed. */
         bool commit;
         /* List of order dependencies. */
-        std::list<InstSeqNum> robDepList;
+        std::vector<InstSeqNum> robDepList;
         /* List of physical register RAW dependencies. */
-        std::list<InstSeqNum> physRegDepList;
+        std::vector<InstSeqNum> physRegDepList;
         /**
          * Computational delay after the last dependent inst. completed.
          * A value of -1 which means instruction has no dependencies.
@@ -331,10 +345,12 @@ class ElasticTrace : public ProbeListenerObject
     std::vector<TraceInfo*> depTrace;
 
     /**
-     * Map where the instruction sequence number is mapped to the pointer to
-     * the TraceInfo object.
+     * The TraceInfo objects, preallocated for the two windows the
+     * dependency trace holds at most, and the ones not in the trace. The
+     * records are reused so that their dependency lists keep their memory.
      */
-    std::unordered_map<InstSeqNum, TraceInfo*> traceInfoMap;
+    std::vector<TraceInfo> traceInfoPool;
+    std::vector<TraceInfo*> freeTraceInfo;
 
     /** Typedef of iterator to the instruction dependency trace. */
     typedef typename std::vector<TraceInfo*>::iterator depTraceItr;
@@ -351,10 +367,10 @@ class ElasticTrace : public ProbeListenerObject
     uint32_t depWindowSize;
 
     /** Protobuf output stream for data dependency trace */
-    ProtoOutputStream* dataTraceStream;
+    AsyncProtoOutputStream<Record>* dataTraceStream;
 
     /** Protobuf output stream for instruction fetch trace. */
-    ProtoOutputStream* instTraceStream;
+    AsyncProtoOutputStream<ProtoMessage::Packet>* instTraceStream;
 
     /** Number of instructions after which to enable tracing. */
     const InstSeqNum startTraceInst;
@@ -394,6 +410,32 @@ class ElasticTrace : public ProbeListenerObject
      */
     void clearTempStoreUntil(const DynInstConstPtr& head_inst);
 
+    /**
+     * Look up the execution info object of an instruction in the temporary
+     * store.
+     *
+     * @param seq_num sequence number of the instruction
+     * @return the object, or nullptr if the instruction has none
+     */
+    InstExecInfo* findExecInfo(InstSeqNum seq_num);
+
+    /**
+     * Get a cleared execution info object for an instruction in the
+     * temporary store, growing the store if needed.
+     *
+     * @param seq_num sequence number of the instruction
+     * @return the object
+     */
+    InstExecInfo* allocExecInfo(InstSeqNum seq_num);
+
+    /**
+     * Look up the record of an instruction still in the dependency trace.
+     *
+     * @param seq_num sequence number of the instruction
+     * @return the record, or nullptr if the instruction has none
+     */
+    TraceInfo* findTraceInfo(InstSeqNum seq_num);
+
     /**
      * Calculate the computational delay between an instruction and a
      * subsequent instruction that has an ROB (order) dependency on it
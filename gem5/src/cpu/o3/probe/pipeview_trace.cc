@@ -0,0 +1,126 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/o3/probe/pipeview_trace.hh"
+
+#include "base/callback.hh"
+#include "base/output.hh"
+#include "cpu/o3/dyn_inst.hh"
+#include "proto/pipeview.pb.h"
+#include "sim/core.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+PipeViewTrace::PipeViewTrace(const PipeViewTraceParams &params)
+    : ProbeListenerObject(params),
+      traceStream(nullptr),
+      startTick(params.startTick),
+      stopTick(params.stopTick),
+      samplePeriod(params.samplePeriod),
+      sampleLength(params.sampleLength),
+      traceDisasm(params.traceDisasm)
+{
+    fatal_if(samplePeriod && sampleLength > samplePeriod,
+             "%s: sampleLength must not exceed samplePeriod", name());
+
+    std::string filename = simout.resolve(params.traceFile.empty() ?
+            name() + ".pb.gz" : params.traceFile);
+    traceStream = new ProtoOutputStream(filename);
+
+    ProtoMessage::PipeViewHeader header_msg;
+    header_msg.set_obj_id(name());
+    header_msg.set_tick_freq(sim_clock::Frequency);
+    traceStream->write(header_msg);
+
+    // Register a callback to compensate for the destructor not
+    // being called. The callback forces the stream to flush and
+    // closes the output file.
+    registerExitCallback([this]() { closeStreams(); });
+}
+
+void
+PipeViewTrace::regProbeListeners()
+{
+    typedef ProbeListenerArg<PipeViewTrace, const DynInst *> InstListener;
+    listeners.push_back(new InstListener(this, "PipeView",
+                &PipeViewTrace::traceInst));
+}
+
+void
+PipeViewTrace::closeStreams()
+{
+    delete traceStream;
+    traceStream = nullptr;
+}
+
+void
+PipeViewTrace::traceInst(const DynInst * const &inst)
+{
+    const Tick fetch = inst->fetchTick;
+    if (!traceStream || fetch == -1 || fetch < startTick || fetch >= stopTick)
+        return;
+    if (samplePeriod && inst->seqNum % samplePeriod >= sampleLength)
+        return;
+
+    ProtoMessage::PipeViewInst inst_msg;
+    inst_msg.set_seq_num(inst->seqNum);
+    inst_msg.set_pc(inst->pcState().instAddr());
+    if (inst->pcState().microPC())
+        inst_msg.set_upc(inst->pcState().microPC());
+    if (inst->threadNumber)
+        inst_msg.set_tid(inst->threadNumber);
+    inst_msg.set_fetch(fetch);
+
+    // Stage ticks are kept relative to fetch, and -1 until reached.
+    if (inst->decodeTick != -1)
+        inst_msg.set_decode(inst->decodeTick);
+    if (inst->renameTick != -1)
+        inst_msg.set_rename(inst->renameTick);
+    if (inst->dispatchTick != -1)
+        inst_msg.set_dispatch(inst->dispatchTick);
+    if (inst->issueTick != -1)
+        inst_msg.set_issue(inst->issueTick);
+    if (inst->completeTick != -1)
+        inst_msg.set_complete(inst->completeTick);
+    if (inst->commitTick != -1)
+        inst_msg.set_commit(inst->commitTick);
+    if (inst->storeTick != -1)
+        inst_msg.set_store(inst->storeTick);
+    if (inst->isSquashed())
+        inst_msg.set_squashed(true);
+    if (traceDisasm) {
+        inst_msg.set_disasm(
+                inst->staticInst->disassemble(inst->pcState().instAddr()));
+    }
+
+    traceStream->write(inst_msg);
+}
+
+} // namespace o3
+} // namespace gem5
@@ -0,0 +1,105 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declares a probe listener that writes a compact protobuf record of the
+ * pipeline stage ticks of every instruction leaving an O3CPU. It carries
+ * the same information as the O3PipeView debug flag output, at a
+ * fraction of the cost, so it can be left on for long runs.
+ */
+
+#ifndef __CPU_O3_PROBE_PIPEVIEW_TRACE_HH__
+#define __CPU_O3_PROBE_PIPEVIEW_TRACE_HH__
+
+#include <cstdint>
+#include <string>
+
+#include "base/types.hh"
+#include "params/PipeViewTrace.hh"
+#include "proto/protoio.hh"
+#include "sim/probe/probe.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+class DynInst;
+
+/**
+ * Listens to the PipeView probe point of an O3CPU, which is notified with
+ * every instruction that leaves the CPU (committed or squashed) once its
+ * stage ticks are final, and writes one PipeViewInst message for each
+ * sampled instruction. util/decode_pipeview_trace.py turns the trace into
+ * o3-pipeview.py input or a per-PC stall breakdown.
+ */
+class PipeViewTrace : public ProbeListenerObject
+{
+  public:
+    PipeViewTrace(const PipeViewTraceParams &params);
+
+    /** Register the probe listeners. */
+    void regProbeListeners() override;
+
+    std::string
+    name() const override
+    {
+        return ProbeListenerObject::name() + ".pipeview";
+    }
+
+  private:
+    /** Write the record of one instruction, if it is sampled. */
+    void traceInst(const DynInst * const &inst);
+
+    /**
+     * Callback to flush and close the output stream on exit. If we were
+     * calling the destructor it could be done there.
+     */
+    void closeStreams();
+
+    /** Trace output stream. */
+    ProtoOutputStream *traceStream;
+
+    /** Only instructions fetched in [startTick, stopTick) are traced. */
+    const Tick startTick;
+    const Tick stopTick;
+
+    /**
+     * Trace sampleLength out of every samplePeriod instructions, by
+     * sequence number; a zero period traces every instruction.
+     */
+    const uint64_t samplePeriod;
+    const uint64_t sampleLength;
+
+    /** Record the disassembly of every instruction. */
+    const bool traceDisasm;
+};
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_PROBE_PIPEVIEW_TRACE_HH__
@@ -71,29 +71,40 @@ class PhysRegFile
     using IdRange = std::pair<PhysIds::iterator,
                               PhysIds::iterator>;
   private:
+    /**
+     * A physical register and its scoreboard bit. Writeback sets both, so
+     * they are kept in the same entry of the per-class array.
+     */
+    template <class Value>
+    struct Entry
+    {
+        Value value = {};
+        bool ready = true;
+    };
+
     /** Integer register file. */
-    std::vector<RegVal> intRegFile;
+    std::vector<Entry<RegVal>> intRegFile;
     std::vector<PhysRegId> intRegIds;
     RegId zeroReg;
 
     /** Floating point register file. */
-    std::vector<RegVal> floatRegFile;
+    std::vector<Entry<RegVal>> floatRegFile;
     std::vector<PhysRegId> floatRegIds;
 
     /** Vector register file. */
-    std::vector<TheISA::VecRegContainer> vectorRegFile;
+    std::vector<Entry<TheISA::VecRegContainer>> vectorRegFile;
     std::vector<PhysRegId> vecRegIds;
 
     /** Vector element register file. */
-    std::vector<RegVal> vectorElemRegFile;
+    std::vector<Entry<RegVal>> vectorElemRegFile;
     std::vector<PhysRegId> vecElemIds;
 
     /** Predicate register file. */
-    std::vector<TheISA::VecPredRegContainer> vecPredRegFile;
+    std::vector<Entry<TheISA::VecPredRegContainer>> vecPredRegFile;
     std::vector<PhysRegId> vecPredRegIds;
 
     /** Condition-code register file. */
-    std::vector<RegVal> ccRegFile;
+    std::vector<Entry<RegVal>> ccRegFile;
     std::vector<PhysRegId> ccRegIds;
 
     /** Misc Reg Ids */
@@ -183,8 +194,9 @@ class PhysRegFile
         assert(phys_reg->is(IntRegClass));
 
         DPRINTF(IEW, "RegFile: Access to int register %i, has data "
-                "%#x\n", phys_reg->index(), intRegFile[phys_reg->index()]);
-        return intRegFile[phys_reg->index()];
+                "%#x\n", phys_reg->index(),
+                intRegFile[phys_reg->index()].value);
+        return intRegFile[phys_reg->index()].value;
     }
 
     RegVal
@@ -192,7 +204,7 @@ class PhysRegFile
     {
         assert(phys_reg->is(FloatRegClass));
 
-        RegVal floatRegBits = floatRegFile[phys_reg->index()];
+        RegVal floatRegBits = floatRegFile[phys_reg->index()].value;
 
         DPRINTF(IEW, "RegFile: Access to float register %i as int, "
                 "has data %#x\n", phys_reg->index(), floatRegBits);
@@ -208,9 +220,9 @@ class PhysRegFile
 
         DPRINTF(IEW, "RegFile: Access to vector register %i, has "
                 "data %s\n", int(phys_reg->index()),
-                vectorRegFile[phys_reg->index()]);
+                vectorRegFile[phys_reg->index()].value);
 
-        return vectorRegFile[phys_reg->index()];
+        return vectorRegFile[phys_reg->index()].value;
     }
 
     /** Reads a vector register for modification. */
@@ -228,7 +240,7 @@ class PhysRegFile
         assert(phys_reg->is(VecElemClass));
         RegVal val = vectorElemRegFile[
                 phys_reg->index() * TheISA::NumVecElemPerVecReg +
-                phys_reg->elemIndex()];
+                phys_reg->elemIndex()].value;
         DPRINTF(IEW, "RegFile: Access to element %d of vector register %i,"
                 " has data %#x\n", phys_reg->elemIndex(),
                 phys_reg->index(), val);
@@ -244,9 +256,9 @@ class PhysRegFile
 
         DPRINTF(IEW, "RegFile: Access to predicate register %i, has "
                 "data %s\n", int(phys_reg->index()),
-                vecPredRegFile[phys_reg->index()]);
+                vecPredRegFile[phys_reg->index()].value);
 
-        return vecPredRegFile[phys_reg->index()];
+        return vecPredRegFile[phys_reg->index()].value;
     }
 
     TheISA::VecPredRegContainer&
@@ -265,9 +277,9 @@ class PhysRegFile
 
         DPRINTF(IEW, "RegFile: Access to cc register %i, has "
                 "data %#x\n", phys_reg->index(),
-                ccRegFile[phys_reg->index()]);
+                ccRegFile[phys_reg->index()].value);
 
-        return ccRegFile[phys_reg->index()];
+        return ccRegFile[phys_reg->index()].value;
     }
 
     /** Sets an integer register to the given value. */
@@ -280,7 +292,7 @@ class PhysRegFile
                 phys_reg->index(), val);
 
         if (phys_reg->index() != zeroReg.index())
-            intRegFile[phys_reg->index()] = val;
+            intRegFile[phys_reg->index()].value = val;
     }
 
     void
@@ -291,7 +303,7 @@ class PhysRegFile
         DPRINTF(IEW, "RegFile: Setting float register %i to %#x\n",
                 phys_reg->index(), (uint64_t)val);
 
-        floatRegFile[phys_reg->index()] = val;
+        floatRegFile[phys_reg->index()].value = val;
     }
 
     /** Sets a vector register to the given value. */
@@ -303,7 +315,7 @@ class PhysRegFile
         DPRINTF(IEW, "RegFile: Setting vector register %i to %s\n",
                 int(phys_reg->index()), val);
 
-        vectorRegFile[phys_reg->index()] = val;
+        vectorRegFile[phys_reg->index()].value = val;
     }
 
     /** Sets a vector register to the given value. */
@@ -316,7 +328,7 @@ class PhysRegFile
                 " %#x\n", phys_reg->elemIndex(), int(phys_reg->index()), val);
 
         vectorElemRegFile[phys_reg->index() * TheISA::NumVecElemPerVecReg +
-                phys_reg->elemIndex()] = val;
+                phys_reg->elemIndex()].value = val;
     }
 
     /** Sets a predicate register to the given value. */
@@ -329,7 +341,7 @@ class PhysRegFile
         DPRINTF(IEW, "RegFile: Setting predicate register %i to %s\n",
                 int(phys_reg->index()), val);
 
-        vecPredRegFile[phys_reg->index()] = val;
+        vecPredRegFile[phys_reg->index()].value = val;
     }
 
     /** Sets a condition-code register to the given value. */
@@ -341,9 +353,49 @@ class PhysRegFile
         DPRINTF(IEW, "RegFile: Setting cc register %i to %#x\n",
                 phys_reg->index(), (uint64_t)val);
 
-        ccRegFile[phys_reg->index()] = val;
+        ccRegFile[phys_reg->index()].value = val;
     }
 
+    /** Checks whether a physical register has been written back. */
+    bool
+    isReady(PhysRegIdPtr phys_reg) const
+    {
+        /* const_cast for not duplicating code below. */
+        return const_cast<PhysRegFile *>(this)->readyBit(phys_reg);
+    }
+
+    /** Sets or clears the scoreboard bit of a physical register. */
+    void setReady(PhysRegIdPtr phys_reg, bool ready)
+    {
+        readyBit(phys_reg) = ready;
+    }
+
+  private:
+    /** The scoreboard bit of a physical register. */
+    bool &
+    readyBit(PhysRegIdPtr phys_reg)
+    {
+        const RegIndex idx = phys_reg->index();
+        switch (phys_reg->classValue()) {
+          case IntRegClass:
+            return intRegFile[idx].ready;
+          case FloatRegClass:
+            return floatRegFile[idx].ready;
+          case VecRegClass:
+            return vectorRegFile[idx].ready;
+          case VecElemClass:
+            return vectorElemRegFile[idx * TheISA::NumVecElemPerVecReg +
+                phys_reg->elemIndex()].ready;
+          case VecPredRegClass:
+            return vecPredRegFile[idx].ready;
+          case CCRegClass:
+            return ccRegFile[idx].ready;
+          default:
+            panic("Unexpected RegClass (%s)", phys_reg->className());
+        }
+    }
+
+  public:
     /**
      * Get the PhysRegIds of the elems of all vector registers.
      * Auxiliary function to transition from Full vector mode to Elem mode
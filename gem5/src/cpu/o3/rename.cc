@@ -48,7 +48,6 @@
 #include "cpu/o3/limits.hh"
 #include "cpu/reg_class.hh"
 #include "debug/Activity.hh"
-#include "debug/O3PipeView.hh"
 #include "debug/Rename.hh"
 #include "params/O3CPU.hh"
 
@@ -73,7 +72,9 @@ Rename::Rename(CPU *_cpu, const O3CPUParams &params)
              renameWidth, static_cast<int>(MaxWidth));
 
     // @todo: Make into a parameter.
-    skidBufferMax = (decodeToRenameDelay + 1) * params.decodeWidth;
+    // Decode sends more instructions than its width when it fuses them.
+    skidBufferMax = (decodeToRenameDelay + 1) *
+        (params.macroOpFusion ? MaxWidth : params.decodeWidth);
     for (uint32_t tid = 0; tid < MaxThreads; tid++) {
         renameStatus[tid] = Idle;
         renameMap[tid] = nullptr;
@@ -83,6 +84,10 @@ Rename::Rename(CPU *_cpu, const O3CPUParams &params)
         freeEntries[tid] = {0, 0, 0, 0};
         emptyROB[tid] = true;
         stalls[tid] = {false, false};
+        renamedThisCycle[tid] = 0;
+        fullThisCycle[tid] = NONE;
+        lastTopDownStat[tid] = nullptr;
+        lastTopDownLost[tid] = 0;
         serializeInst[tid] = nullptr;
         serializeOnNextInst[tid] = false;
     }
@@ -389,12 +394,14 @@ void
 Rename::tick()
 {
     wroteToTimeBuffer = false;
+    cycleStats.newCycle();
 
     blockThisCycle = false;
 
     bool status_change = false;
 
     toIEWIndex = 0;
+    renameSlots = 0;
 
     sortInsts();
 
@@ -409,7 +416,12 @@ Rename::tick()
 
         status_change = checkSignalsAndUpdate(tid) || status_change;
 
+        renamedThisCycle[tid] = 0;
+        fullThisCycle[tid] = NONE;
+
         rename(status_change, tid);
+
+        countTopDownSlots(tid);
     }
 
     if (status_change) {
@@ -459,11 +471,11 @@ Rename::rename(bool &status_change, ThreadID tid)
     //     check if stall conditions have passed
 
     if (renameStatus[tid] == Blocked) {
-        ++stats.blockCycles;
+        cycleStats.count(stats.blockCycles);
     } else if (renameStatus[tid] == Squashing) {
-        ++stats.squashCycles;
+        cycleStats.count(stats.squashCycles);
     } else if (renameStatus[tid] == SerializeStall) {
-        ++stats.serializeStallCycles;
+        cycleStats.count(stats.serializeStallCycles);
         // If we are currently in SerializeStall and resumeSerialize
         // was set, then that means that we are resuming serializing
         // this cycle.  Tell the previous stages to block.
@@ -517,12 +529,12 @@ Rename::renameInsts(ThreadID tid)
         DPRINTF(Rename, "[tid:%i] Nothing to do, breaking out early.\n",
                 tid);
         // Should I change status to idle?
-        ++stats.idleCycles;
+        cycleStats.count(stats.idleCycles);
         return;
     } else if (renameStatus[tid] == Unblocking) {
-        ++stats.unblockCycles;
+        cycleStats.count(stats.unblockCycles);
     } else if (renameStatus[tid] == Running) {
-        ++stats.runCycles;
+        cycleStats.count(stats.runCycles);
     }
 
     // Will have to do a different calculation for the number of free
@@ -550,7 +562,7 @@ Rename::renameInsts(ThreadID tid)
 
         block(tid);
 
-        incrFullStat(source);
+        incrFullStat(source, tid);
 
         return;
     } else if (min_free_entries < insts_available) {
@@ -565,7 +577,7 @@ Rename::renameInsts(ThreadID tid)
 
         blockThisCycle = true;
 
-        incrFullStat(source);
+        incrFullStat(source, tid);
     }
 
     InstQueue &insts_to_rename = renameStatus[tid] == Unblocking ?
@@ -594,13 +606,19 @@ Rename::renameInsts(ThreadID tid)
 
     int renamed_insts = 0;
 
-    while (insts_available > 0 &&  toIEWIndex < renameWidth) {
+    while (insts_available > 0 &&  toIEWIndex < MaxWidth) {
         DPRINTF(Rename, "[tid:%i] Sending instructions to IEW.\n", tid);
 
         assert(!insts_to_rename.empty());
 
         DynInstPtr inst = insts_to_rename.front();
 
+        // An instruction fused with the one ahead of it takes no slot.
+        if (renameSlots >= renameWidth && !inst->isSquashed() &&
+                !inst->isFused()) {
+            break;
+        }
+
         //For all kind of instructions, check ROB and IQ first For load
         //instruction, check LQ size and take into account the inflight loads
         //For store instruction, check SQ size and take into account the
@@ -611,7 +629,7 @@ Rename::renameInsts(ThreadID tid)
                 DPRINTF(Rename, "[tid:%i] Cannot rename due to no free LQ\n",
                         tid);
                 source = LQ;
-                incrFullStat(source);
+                incrFullStat(source, tid);
                 break;
             }
         }
@@ -621,7 +639,7 @@ Rename::renameInsts(ThreadID tid)
                 DPRINTF(Rename, "[tid:%i] Cannot rename due to no free SQ\n",
                         tid);
                 source = SQ;
-                incrFullStat(source);
+                incrFullStat(source, tid);
                 break;
             }
         }
@@ -733,12 +751,15 @@ Rename::renameInsts(ThreadID tid)
 
         // Increment which instruction we're on.
         ++toIEWIndex;
+        if (!inst->isFused())
+            ++renameSlots;
 
         // Decrement how many instructions are available.
         --insts_available;
     }
 
     instsInProgress[tid] += renamed_insts;
+    renamedThisCycle[tid] = renamed_insts;
     stats.renamedInsts += renamed_insts;
 
     // If we wrote to the time buffer, record this.
@@ -758,6 +779,79 @@ Rename::renameInsts(ThreadID tid)
     }
 }
 
+void
+Rename::countTopDownSlots(ThreadID tid)
+{
+    auto &top_down = cpu->topDownStats;
+    const unsigned renamed = renamedThisCycle[tid];
+
+    top_down.slots[tid] += renameWidth;
+    top_down.renamedSlots[tid] += renamed;
+    lastTopDownStat[tid] = nullptr;
+
+    if (renamed >= renameWidth)
+        return;
+    const unsigned lost = renameWidth - renamed;
+
+    if (renameStatus[tid] == StartSquash || renameStatus[tid] == Squashing) {
+        chargeTopDown(top_down.recoverySlots, tid, lost);
+        return;
+    }
+
+    // Anything rename was given but could not rename is held back by the
+    // backend. This includes the slots of SMT threads that found the
+    // rename width used up by other threads.
+    const bool backend = renameStatus[tid] == Blocked ||
+        renameStatus[tid] == SerializeStall ||
+        !insts[tid].empty() || !skidBuffer[tid].empty();
+
+    if (!backend) {
+        if (renamed)
+            chargeTopDown(top_down.frontendBandwidthSlots, tid, lost);
+        else
+            chargeTopDown(top_down.frontendLatencySlots, tid, lost);
+        return;
+    }
+
+    if (fullThisCycle[tid] == LQ) {
+        chargeTopDown(top_down.loadBoundSlots, tid, lost);
+        return;
+    } else if (fullThisCycle[tid] == SQ) {
+        chargeTopDown(top_down.storeBoundSlots, tid, lost);
+        return;
+    }
+
+    // The oldest instruction waiting on memory holds the ROB and IQ back.
+    const DynInstPtr &head = commit_ptr->rob->readHeadInst(tid);
+    if (!commit_ptr->rob->isEmpty(tid) && head->isIssued() &&
+            !head->readyToCommit()) {
+        if (head->isLoad()) {
+            chargeTopDown(top_down.loadBoundSlots, tid, lost);
+            return;
+        } else if (head->isStore() || head->isAtomic()) {
+            chargeTopDown(top_down.storeBoundSlots, tid, lost);
+            return;
+        }
+    }
+
+    chargeTopDown(top_down.coreBoundSlots, tid, lost);
+}
+
+void
+Rename::skipCycles(Cycles cycles)
+{
+    cycleStats.skip(cycles);
+
+    // Rename renames nothing while the CPU is not ticking, and every active
+    // thread keeps losing its slots for the same reason as in the last
+    // cycle.
+    for (ThreadID tid : *activeThreads) {
+        cpu->topDownStats.slots[tid] += renameWidth * cycles;
+        if (lastTopDownStat[tid])
+            (*lastTopDownStat[tid])[tid] += lastTopDownLost[tid] * cycles;
+    }
+}
+
 void
 Rename::skidInsert(ThreadID tid)
 {
@@ -798,11 +892,9 @@ Rename::sortInsts()
     for (int i = 0; i < insts_from_decode; ++i) {
         const DynInstPtr &inst = fromDecode->insts[i];
         insts[inst->threadNumber].push_back(inst);
-#if TRACING_ON
-        if (debug::O3PipeView) {
+        if (cpu->tracePipeView()) {
             inst->renameTick = curTick() - inst->fetchTick;
         }
-#endif
     }
 }
 
@@ -1379,8 +1471,10 @@ Rename::serializeAfter(InstQueue &inst_list, ThreadID tid)
 }
 
 void
-Rename::incrFullStat(const FullSource &source)
+Rename::incrFullStat(const FullSource &source, ThreadID tid)
 {
+    fullThisCycle[tid] = source;
+
     switch (source) {
       case ROB:
         ++stats.ROBFullEvents;
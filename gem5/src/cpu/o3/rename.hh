@@ -48,6 +48,7 @@
 #include "base/statistics.hh"
 #include "cpu/o3/comm.hh"
 #include "cpu/o3/commit.hh"
+#include "cpu/o3/cycle_stats.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
 #include "cpu/o3/free_list.hh"
 #include "cpu/o3/iew.hh"
@@ -195,6 +196,9 @@ class Rename
      */
     void tick();
 
+    /** Accounts for cycles skipped while the CPU was not ticking. */
+    void skipCycles(Cycles cycles);
+
     /** Debugging function used to dump history buffer of renamings. */
     void dumpHistory();
 
@@ -385,6 +389,9 @@ class Rename
      */
     bool wroteToTimeBuffer;
 
+    /** Per-cycle status stats counted in the last tick. */
+    CycleStats cycleStats;
+
     /** Structures whose free entries impact the amount of instructions that
      * can be renamed.
      */
@@ -442,6 +449,9 @@ class Rename
      */
     unsigned toIEWIndex;
 
+    /** Rename slots used this cycle; fused instructions take none. */
+    unsigned renameSlots;
+
     /** Whether or not rename needs to block this cycle. */
     bool blockThisCycle;
 
@@ -474,7 +484,31 @@ class Rename
     /** Function used to increment the stat that corresponds to the source of
      * the stall.
      */
-    void incrFullStat(const FullSource &source);
+    void incrFullStat(const FullSource &source, ThreadID tid);
+
+    /** Number of instructions renamed this cycle, per thread. */
+    unsigned renamedThisCycle[MaxThreads];
+
+    /** The full resource that stopped renaming this cycle, per thread. */
+    FullSource fullThisCycle[MaxThreads];
+
+    /** The top-down category charged with the slots lost in the last
+     * cycle, per thread, and how many slots were lost.
+     */
+    statistics::Vector *lastTopDownStat[MaxThreads];
+    unsigned lastTopDownLost[MaxThreads];
+
+    /** Charge the rename slots of this cycle to the top-down categories. */
+    void countTopDownSlots(ThreadID tid);
+
+    /** Charge lost slots of thread tid to the top-down category stat. */
+    void
+    chargeTopDown(statistics::Vector &stat, ThreadID tid, unsigned lost)
+    {
+        stat[tid] += lost;
+        lastTopDownStat[tid] = &stat;
+        lastTopDownLost[tid] = lost;
+    }
 
     struct RenameStats : public statistics::Group
     {
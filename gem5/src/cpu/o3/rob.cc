@@ -61,6 +61,7 @@ ROB::ROB(CPU *_cpu, const O3CPUParams &params)
       numEntries(params.numROBEntries),
       squashWidth(params.squashWidth),
       numInstsInROB(0),
+      numFusedInROB(0),
       numThreads(params.numThreads),
       stats(_cpu)
 {
@@ -105,11 +106,13 @@ ROB::resetState()
 {
     for (ThreadID tid = 0; tid  < MaxThreads; tid++) {
         threadEntries[tid] = 0;
+        fusedEntries[tid] = 0;
         squashIt[tid] = instList[tid].end();
         squashedSeqNum[tid] = 0;
         doneSquashing[tid] = true;
     }
     numInstsInROB = 0;
+    numFusedInROB = 0;
 
     // Initialize the "universal" ROB head & tail point to invalid
     // pointers
@@ -202,7 +205,7 @@ ROB::insertInst(const DynInstPtr &inst)
 
     DPRINTF(ROB, "Adding inst PC %s to the ROB.\n", inst->pcState());
 
-    assert(numInstsInROB != numEntries);
+    assert(inst->isFused() || numInstsInROB - numFusedInROB != numEntries);
 
     ThreadID tid = inst->threadNumber;
 
@@ -223,6 +226,10 @@ ROB::insertInst(const DynInstPtr &inst)
 
     ++numInstsInROB;
     ++threadEntries[tid];
+    if (inst->isFused()) {
+        ++numFusedInROB;
+        ++fusedEntries[tid];
+    }
 
     assert((*tail) == inst);
 
@@ -251,6 +258,10 @@ ROB::retireHead(ThreadID tid)
 
     --numInstsInROB;
     --threadEntries[tid];
+    if (head_inst->isFused()) {
+        --numFusedInROB;
+        --fusedEntries[tid];
+    }
 
     head_inst->clearInROB();
     head_inst->setCommitted();
@@ -296,13 +307,13 @@ ROB::canCommit()
 unsigned
 ROB::numFreeEntries()
 {
-    return numEntries - numInstsInROB;
+    return numEntries - (numInstsInROB - numFusedInROB);
 }
 
 unsigned
 ROB::numFreeEntries(ThreadID tid)
 {
-    return maxEntries[tid] - threadEntries[tid];
+    return maxEntries[tid] - getUsedEntries(tid);
 }
 
 void
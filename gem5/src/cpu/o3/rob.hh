@@ -179,17 +179,22 @@ class ROB
     unsigned getMaxEntries(ThreadID tid)
     { return maxEntries[tid]; }
 
-    /** Returns the number of entries being used by a specific thread. */
+    /** Returns the number of instructions of a specific thread. */
     unsigned getThreadEntries(ThreadID tid)
     { return threadEntries[tid]; }
 
+    /** Returns the number of entries being used by a specific thread. An
+     *  instruction fused with the one ahead of it shares its entry. */
+    unsigned getUsedEntries(ThreadID tid)
+    { return threadEntries[tid] - fusedEntries[tid]; }
+
     /** Returns if the ROB is full. */
     bool isFull()
-    { return numInstsInROB == numEntries; }
+    { return numInstsInROB - numFusedInROB == numEntries; }
 
     /** Returns if a specific thread's partition is full. */
     bool isFull(ThreadID tid)
-    { return threadEntries[tid] == numEntries; }
+    { return getUsedEntries(tid) == numEntries; }
 
     /** Returns if the ROB is empty. */
     bool isEmpty() const
@@ -283,6 +288,9 @@ class ROB
     /** Entries Per Thread */
     unsigned threadEntries[MaxThreads];
 
+    /** Fused instructions per thread, which take no entry of their own. */
+    unsigned fusedEntries[MaxThreads];
+
     /** Max Insts a Thread Can Have in the ROB */
     unsigned maxEntries[MaxThreads];
 
@@ -309,7 +317,7 @@ class ROB
      *  when squashing, the instructions are marked as squashed but not
      *  immediately removed, meaning the tail iterator remains the same before
      *  and after a squash.
-     *  This will always be set to cpu->instList.end() if it is invalid.
+     *  This will always be set to instList[tid].end() if it is invalid.
      */
     InstIt squashIt[MaxThreads];
 
@@ -317,6 +325,9 @@ class ROB
     /** Number of instructions in the ROB. */
     int numInstsInROB;
 
+    /** Number of fused instructions in the ROB. */
+    int numFusedInROB;
+
     /** Dummy instruction returned if there are no insts left. */
     DynInstPtr dummyInst;
 
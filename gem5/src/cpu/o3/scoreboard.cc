@@ -35,10 +35,10 @@ namespace gem5
 namespace o3
 {
 
-Scoreboard::Scoreboard(const std::string &_my_name, unsigned _numPhysicalRegs,
+Scoreboard::Scoreboard(const std::string &_my_name, PhysRegFile *_regFile,
         RegIndex zero_reg) :
-    _name(_my_name), zeroReg(zero_reg), regScoreBoard(_numPhysicalRegs, true),
-    numPhysRegs(_numPhysicalRegs)
+    _name(_my_name), zeroReg(zero_reg), regFile(_regFile),
+    numPhysRegs(_regFile->totalNumPhysRegs())
 {}
 
 } // namespace o3
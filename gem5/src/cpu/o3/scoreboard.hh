@@ -31,10 +31,11 @@
 #define __CPU_O3_SCOREBOARD_HH__
 
 #include <cassert>
-#include <vector>
+#include <string>
 
 #include "base/compiler.hh"
 #include "base/trace.hh"
+#include "cpu/o3/regfile.hh"
 #include "cpu/reg_class.hh"
 #include "debug/Scoreboard.hh"
 
@@ -60,19 +61,19 @@ class Scoreboard
     /** Index of the zero integer register. */
     const RegIndex zeroReg;
 
-    /** Scoreboard of physical integer registers, saying whether or not they
-     *  are ready. */
-    std::vector<bool> regScoreBoard;
+    /** The register file, which keeps the scoreboard bit of each
+     *  physical register next to its value. */
+    PhysRegFile *regFile;
 
     /** The number of actual physical registers */
     GEM5_CLASS_VAR_USED unsigned numPhysRegs;
 
   public:
     /** Constructs a scoreboard.
-     *  @param _numPhysicalRegs Number of physical registers.
-     *  @param _numMiscRegs Number of miscellaneous registers.
+     *  @param _regFile The physical register file.
+     *  @param _zero_reg Index of the zero integer register.
      */
-    Scoreboard(const std::string &_my_name, unsigned _numPhysicalRegs,
+    Scoreboard(const std::string &_my_name, PhysRegFile *_regFile,
                RegIndex _zero_reg);
 
     /** Destructor. */
@@ -92,7 +93,7 @@ class Scoreboard
             return true;
         }
 
-        bool ready = regScoreBoard[phys_reg->flatIndex()];
+        bool ready = regFile->isReady(phys_reg);
 
         if (phys_reg->is(IntRegClass) && phys_reg->index() == zeroReg)
             assert(ready);
@@ -115,7 +116,7 @@ class Scoreboard
         DPRINTF(Scoreboard, "Setting reg %i (%s) as ready\n",
                 phys_reg->index(), phys_reg->className());
 
-        regScoreBoard[phys_reg->flatIndex()] = true;
+        regFile->setReady(phys_reg, true);
     }
 
     /** Sets the register as not ready. */
@@ -134,7 +135,7 @@ class Scoreboard
         if (phys_reg->is(IntRegClass) && phys_reg->index() == zeroReg)
             return;
 
-        regScoreBoard[phys_reg->flatIndex()] = false;
+        regFile->setReady(phys_reg, false);
     }
 
 };
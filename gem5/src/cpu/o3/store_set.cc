@@ -232,7 +232,10 @@ StoreSet::insertStore(Addr store_PC, InstSeqNum store_seq_num, ThreadID tid)
 
         validLFST[store_SSID] = 1;
 
-        storeList[store_seq_num] = store_SSID;
+        if (StoreListEntry *entry = storeList.find(store_seq_num))
+            entry->ssid = store_SSID;
+        else
+            storeList.push_back(store_seq_num, {SSID(store_SSID), true});
 
         DPRINTF(StoreSet, "Store %#x updated the LFST, SSID: %i\n",
                 store_PC, store_SSID);
@@ -288,11 +291,7 @@ StoreSet::issued(Addr issued_PC, InstSeqNum issued_seq_num, bool is_store)
 
     assert(index < SSITSize);
 
-    SeqNumMapIt store_list_it = storeList.find(issued_seq_num);
-
-    if (store_list_it != storeList.end()) {
-        storeList.erase(store_list_it);
-    }
+    storeList.remove(issued_seq_num);
 
     // Make sure the SSIT still has a valid entry for the issued store.
     if (!validSSIT[index]) {
@@ -317,27 +316,18 @@ StoreSet::squash(InstSeqNum squashed_num, ThreadID tid)
     DPRINTF(StoreSet, "StoreSet: Squashing until inum %i\n",
             squashed_num);
 
-    int idx;
-    SeqNumMapIt store_list_it = storeList.begin();
-
     //@todo:Fix to only delete from correct thread
-    while (!storeList.empty()) {
-        idx = (*store_list_it).second;
-
-        if ((*store_list_it).first <= squashed_num) {
-            break;
-        }
+    while (!storeList.empty() && storeList.tail() > squashed_num) {
+        SSID idx = storeList.back().ssid;
 
         bool younger = LFST[idx] > squashed_num;
 
         if (validLFST[idx] && younger) {
             DPRINTF(StoreSet, "Squashed [sn:%lli]\n", LFST[idx]);
             validLFST[idx] = false;
-
-            storeList.erase(store_list_it++);
-        } else if (!validLFST[idx] && younger) {
-            storeList.erase(store_list_it++);
         }
+
+        storeList.remove(storeList.tail());
     }
 }
 
@@ -358,17 +348,19 @@ StoreSet::clear()
 void
 StoreSet::dump()
 {
-    cprintf("storeList.size(): %i\n", storeList.size());
-    SeqNumMapIt store_list_it = storeList.begin();
-
     int num = 0;
 
-    while (store_list_it != storeList.end()) {
-        cprintf("%i: [sn:%lli] SSID:%i\n",
-                num, (*store_list_it).first, (*store_list_it).second);
-        num++;
-        store_list_it++;
+    if (!storeList.empty()) {
+        for (InstSeqNum sn = storeList.tail(); sn >= storeList.head(); --sn) {
+            if (storeList[sn]) {
+                cprintf("%i: [sn:%lli] SSID:%i\n",
+                        num, sn, storeList[sn].ssid);
+                num++;
+            }
+        }
     }
+
+    cprintf("storeList.size(): %i\n", num);
 }
 
 } // namespace o3
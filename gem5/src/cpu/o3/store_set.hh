@@ -29,13 +29,11 @@
 #ifndef __CPU_O3_STORE_SET_HH__
 #define __CPU_O3_STORE_SET_HH__
 
-#include <list>
-#include <map>
-#include <utility>
 #include <vector>
 
 #include "base/types.hh"
 #include "cpu/inst_seq.hh"
+#include "cpu/o3/inst_ring.hh"
 
 namespace gem5
 {
@@ -43,15 +41,6 @@ namespace gem5
 namespace o3
 {
 
-struct ltseqnum
-{
-    bool
-    operator()(const InstSeqNum &lhs, const InstSeqNum &rhs) const
-    {
-        return lhs > rhs;
-    }
-};
-
 /**
  * Implements a store set predictor for determining if memory
  * instructions are dependent upon each other.  See paper "Memory
@@ -135,12 +124,19 @@ class StoreSet
     /** Bit vector to tell if the LFST has a valid entry. */
     std::vector<bool> validLFST;
 
-    /** Map of stores that have been inserted into the store set, but
-     * not yet issued or squashed.
-     */
-    std::map<InstSeqNum, int, ltseqnum> storeList;
+    /** Store set of a store in the store list. */
+    struct StoreListEntry
+    {
+        SSID ssid = 0;
+        bool valid = false;
 
-    typedef std::map<InstSeqNum, int, ltseqnum>::iterator SeqNumMapIt;
+        explicit operator bool() const { return valid; }
+    };
+
+    /** Stores that have been inserted into the store set, but not yet
+     * issued or squashed, indexed by sequence number.
+     */
+    InstRing<StoreListEntry> storeList;
 
     /** Number of loads/stores to process before wiping predictor so all
      * entries don't get saturated
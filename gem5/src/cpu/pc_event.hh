@@ -29,6 +29,7 @@
 #ifndef __PC_EVENT_HH__
 #define __PC_EVENT_HH__
 
+#include <algorithm>
 #include <vector>
 
 #include "base/logging.hh"
@@ -122,6 +123,15 @@ class PCEventQueue : public PCEventScope
         return doService(pc, tc);
     }
 
+    /** Check if any event is scheduled for a PC in [start, end]. */
+    bool
+    anyInRange(Addr start, Addr end) const
+    {
+        auto i = std::lower_bound(pcMap.begin(), pcMap.end(), start,
+                                  MapCompare());
+        return i != pcMap.end() && (*i)->pc() <= end;
+    }
+
     range_t equal_range(Addr pc);
     range_t equal_range(PCEvent *event) { return equal_range(event->pc()); }
 
@@ -44,7 +44,7 @@ LocalBP::LocalBP(const LocalBPParams &params)
       localPredictorSize(params.localPredictorSize),
       localCtrBits(params.localCtrBits),
       localPredictorSets(localPredictorSize / localCtrBits),
-      localCtrs(localPredictorSets, SatCounter8(localCtrBits)),
+      localCtrs(localPredictorSets, localCtrBits),
       indexMask(localPredictorSets - 1)
 {
     if (!isPowerOf2(localPredictorSize)) {
@@ -140,5 +140,17 @@ LocalBP::uncondBranch(ThreadID tid, Addr pc, void *&bp_history)
 {
 }
 
+void
+LocalBP::serialize(CheckpointOut &cp) const
+{
+    serializeCounters(cp, "localCtrs", localCtrs);
+}
+
+void
+LocalBP::unserialize(CheckpointIn &cp)
+{
+    unserializeCounters(cp, "localCtrs", localCtrs);
+}
+
 } // namespace branch_prediction
 } // namespace gem5
@@ -100,6 +100,9 @@ class LocalBP : public BPredUnit
     void squash(ThreadID tid, void *bp_history)
     { assert(bp_history == NULL); }
 
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+
   private:
     /**
      *  Returns the taken/not taken prediction given the value of the
@@ -122,7 +125,7 @@ class LocalBP : public BPredUnit
     const unsigned localPredictorSets;
 
     /** Array of counters that make up the local predictor. */
-    std::vector<SatCounter8> localCtrs;
+    SatCounterArray<> localCtrs;
 
     /** Mask to get index bits. */
     const unsigned indexMask;
@@ -29,6 +29,8 @@ from m5.SimObject import SimObject
 from m5.params import *
 from m5.proxy import *
 
+from m5.objects.ReplacementPolicies import *
+
 class IndirectPredictor(SimObject):
     type = 'IndirectPredictor'
     cxx_class = 'gem5::branch_prediction::IndirectPredictor'
@@ -52,6 +54,30 @@ class SimpleIndirectPredictor(IndirectPredictor):
     indirectGHRBits = Param.Unsigned(13, "Indirect GHR number of bits")
     instShiftAmt = Param.Unsigned(2, "Number of bits to shift instructions by")
 
+# ITTAGE indirect target predictor, see "A 64-Kbytes ITTAGE indirect branch
+# predictor", A. Seznec, JWAC-2, 2011
+class ITTAGE(IndirectPredictor):
+    type = 'ITTAGE'
+    cxx_class = 'gem5::branch_prediction::ITTAGE'
+    cxx_header = "cpu/pred/ittage.hh"
+
+    instShiftAmt = Param.Unsigned(2, "Number of bits to shift instructions by")
+    nHistoryTables = Param.Unsigned(8, "Number of tagged tables")
+    minHist = Param.Unsigned(4, "History length of the shortest table")
+    maxHist = Param.Unsigned(320, "History length of the longest table")
+    logTableSizes = VectorParam.Unsigned([10, 9, 9, 9, 9, 9, 9, 8, 8],
+        "Log2 of the table sizes, the base table first")
+    tagTableTagWidths = VectorParam.Unsigned(
+        [0, 9, 10, 10, 11, 11, 12, 12, 13],
+        "Tag widths of the tables, 0 for the untagged base table")
+    confBits = Param.Unsigned(2, "Number of bits of the confidence counters")
+    uBits = Param.Unsigned(1, "Number of bits of the useful counters")
+    histBufferSize = Param.Unsigned(4096,
+        "Size of the circular global history, in branch outcomes")
+    pathHistBits = Param.Unsigned(32, "Path history size")
+    logUResetPeriod = Param.Unsigned(14, "Log period in number of indirect "
+        "branches to age the useful counters")
+
 class BranchPredictor(SimObject):
     type = 'BranchPredictor'
     cxx_class = 'gem5::branch_prediction::BPredUnit'
@@ -61,8 +87,24 @@ class BranchPredictor(SimObject):
     numThreads = Param.Unsigned(Parent.numThreads, "Number of threads")
     BTBEntries = Param.Unsigned(4096, "Number of BTB entries")
     BTBTagSize = Param.Unsigned(16, "Size of the BTB tags, in bits")
+    BTBAssoc = Param.Unsigned(1, "Associativity of the BTB")
+    BTBReplPolicy = Param.BaseReplacementPolicy(LRURP(),
+        "Replacement policy of the BTB")
+    L0BTBEntries = Param.Unsigned(0, "Number of entries of the zero bubble "
+        "BTB looked up before the main BTB, 0 to disable it")
+    L0BTBAssoc = Param.Unsigned(Self.L0BTBEntries,
+        "Associativity of the zero bubble BTB")
+    L0BTBReplPolicy = Param.BaseReplacementPolicy(LRURP(),
+        "Replacement policy of the zero bubble BTB")
     RASSize = Param.Unsigned(16, "RAS size")
+    maxInFlightBranches = Param.Unsigned(512, "Maximum number of "
+        "in-flight branches tracked per thread, should cover the "
+        "instruction window of the CPU")
     instShiftAmt = Param.Unsigned(2, "Number of bits to shift instructions by")
+    profileEntries = Param.Unsigned(0, "Number of branches tracked in "
+        "the profile of the most mispredicted branches, 0 to disable it")
+    profileFile = Param.String("", "File the misprediction profile is "
+        "written to at every stats dump, <name>.mispredicts.txt if empty")
 
     indirectBranchPred = Param.IndirectPredictor(SimpleIndirectPredictor(),
       "Indirect branch predictor, set to NULL to disable indirect predictions")
@@ -100,6 +142,38 @@ class PAgPred(BranchPredictor):
     gtableHeight = Param.Unsigned(32, "Height of 2nd level global table")
     gpredSize = Param.Unsigned(2, "Width of predictor")
 
+class HashedPerceptron(BranchPredictor):
+    type = 'HashedPerceptron'
+    cxx_class = 'gem5::branch_prediction::HashedPerceptron'
+    cxx_header = "cpu/pred/hashed_perceptron.hh"
+
+    # The defaults give a 32KB predictor, 16 tables of 2K 8 bit weights
+    logTableEntries = Param.Unsigned(11, "Log2 of the number of weights "
+        "per table")
+    historyLengths = VectorParam.Unsigned([0, 3, 5, 8, 12, 17, 23, 30, 38,
+        48, 60, 75, 93, 115, 140, 170], "End of the global history segment "
+        "of each table, there is one table per entry")
+    weightBits = Param.Unsigned(8, "Number of bits of a weight")
+    pathBits = Param.Unsigned(2, "Number of address bits pushed into the "
+        "path history per branch")
+    theta = Param.Int(-1, "Training threshold, -1 to derive it from the "
+        "number of tables")
+    adaptiveTheta = Param.Bool(True, "Adapt the training threshold to the "
+        "misprediction rate")
+
+class HashedPerceptron8KB(HashedPerceptron):
+    logTableEntries = 9
+    historyLengths = [0, 2, 4, 7, 10, 14, 18, 23, 29, 36, 44, 53, 63, 74,
+        87, 101]
+
+class HashedPerceptron32KB(HashedPerceptron):
+    pass
+
+class HashedPerceptron64KB(HashedPerceptron):
+    logTableEntries = 12
+    historyLengths = [0, 3, 6, 10, 15, 21, 28, 37, 48, 61, 77, 96, 119,
+        147, 180, 220]
+
 class TournamentBP(BranchPredictor):
     type = 'TournamentBP'
     cxx_class = 'gem5::branch_prediction::TournamentBP'
@@ -149,7 +223,7 @@ class TAGEBase(SimObject):
     tagTableUBits = Param.Unsigned(2, "Number of tag table u bits")
 
     histBufferSize = Param.Unsigned(2097152,
-            "A large number to track all branch histories(2MEntries default)")
+            "Size of the circular global history, in branch outcomes")
 
     pathHistBits = Param.Unsigned(16, "Path history size")
     logUResetPeriod = Param.Unsigned(18,
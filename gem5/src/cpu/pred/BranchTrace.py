@@ -0,0 +1,57 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.SimObject import SimObject
+from m5.params import *
+from m5.proxy import *
+from m5.objects.Probe import ProbeListenerObject
+
+class BranchTraceProbe(ProbeListenerObject):
+    """Record the branches committed by a branch predictor in a protobuf
+    trace that can later be fed to a BranchTraceReplay object."""
+    type = 'BranchTraceProbe'
+    cxx_header = "cpu/pred/branch_trace.hh"
+    cxx_class = 'gem5::branch_prediction::BranchTraceProbe'
+
+    # Boolean to compress the trace or not.
+    trace_compress = Param.Bool(True, "Enable trace compression")
+
+    # Unconditional branches are needed to replay the RAS and global
+    # histories faithfully.
+    with_uncond = Param.Bool(True, "Include unconditional branches")
+
+    # branch trace output file, disabled by default
+    trace_file = Param.String("", "Branch trace output file")
+
+class BranchTraceReplay(SimObject):
+    """Replay a branch trace against a set of branch predictors without
+    simulating a CPU."""
+    type = 'BranchTraceReplay'
+    cxx_header = "cpu/pred/branch_trace_replay.hh"
+    cxx_class = 'gem5::branch_prediction::BranchTraceReplay'
+
+    trace_file = Param.String("Branch trace to replay")
+    predictors = VectorParam.BranchPredictor("Branch predictors to evaluate")
+    batch_size = Param.Unsigned(65536, "Number of branches read from the "
+        "trace and replayed against every predictor at a time")
+    numThreads = Param.Unsigned(1, "Number of threads in the trace")
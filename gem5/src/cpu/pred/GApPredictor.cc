@@ -12,39 +12,120 @@ namespace branch_prediction
 {
 
 GApPred::GApPred(const GApPredParams &params)
-    : BPredUnit(params)
-      // more parameters are needed to be passed here, check BranchPredictor.py
+    : BPredUnit(params),
+      ptableHeight(params.ptableHeight),
+      ptableWidth(params.ptableWidth),
+      predSize(params.predSize),
+      ptable(ptableHeight * ptableWidth, predSize),
+      threshold((1ULL << (predSize - 1)) - 1),
+      specHistory(params.numThreads, params.historySize),
+      historyPool(params.numThreads)
 {
-    // you may want to add some checks of the passed parameters here
+    fatal_if(!isPowerOf2(ptableHeight), "Invalid pattern table height!\n");
+    fatal_if(!isPowerOf2(ptableWidth), "Invalid pattern table width!\n");
+    fatal_if(ptableWidth > (1ULL << params.historySize),
+             "Pattern table wider than the global history can index!\n");
+}
+
+inline
+unsigned
+GApPred::getIndex(Addr branch_addr, unsigned global_history)
+{
+    unsigned row = (branch_addr >> instShiftAmt) & (ptableHeight - 1);
+    return row * ptableWidth + (global_history & (ptableWidth - 1));
 }
 
-// unused
 void
 GApPred::btbUpdate(ThreadID tid, Addr branch_addr, void * &bp_history)
 {
-// Place holder for a function that is called to update predictor history when
-// a BTB entry is invalid or not found.
+    // Update the global history to Not Taken
+    specHistory.clearLast(tid);
 }
 
 bool
 GApPred::lookup(ThreadID tid, Addr branch_addr, void * &bp_history)
 {
-    // implement the lookup logic here
+    bool prediction =
+        ptable[getIndex(branch_addr, specHistory.global(tid))] > threshold;
+
+    BPHistory *history = historyPool.acquire(tid);
+    history->hist = specHistory.checkpoint(tid);
+    bp_history = static_cast<void *>(history);
 
-    return 0;
+    specHistory.speculate(tid, SpeculativeHistory::noLocal, prediction);
+    return prediction;
+}
+
+unsigned
+GApPred::lookupBlock(ThreadID tid, const Addr *pcs, unsigned num, bool *taken,
+                     void **bp_history)
+{
+    unsigned i = 0;
+    while (i < num) {
+        taken[i] = GApPred::lookup(tid, pcs[i], bp_history[i]);
+        if (taken[i++])
+            break;
+    }
+    return i;
 }
 
 void
 GApPred::update(ThreadID tid, Addr branch_addr, bool taken, void *bp_history,
                 bool squashed, const StaticInstPtr & inst, Addr corrTarget)
 {
-    // implement the update logic here
+    assert(bp_history);
+
+    BPHistory *history = static_cast<BPHistory *>(bp_history);
+
+    // The branch was mispredicted, redo its history update with the
+    // actual outcome. The counters are only updated at commit.
+    if (squashed) {
+        specHistory.repair(tid, history->hist, taken);
+        return;
+    }
+
+    unsigned idx = getIndex(branch_addr, history->hist.global);
+    if (taken) {
+        ptable[idx]++;
+    } else {
+        ptable[idx]--;
+    }
+
+    historyPool.release(tid, history);
 }
 
-// unused
 void
 GApPred::uncondBranch(ThreadID tid, Addr pc, void *&bp_history)
 {
+    BPHistory *history = historyPool.acquire(tid);
+    history->hist = specHistory.checkpoint(tid);
+    bp_history = static_cast<void *>(history);
+
+    specHistory.speculate(tid, SpeculativeHistory::noLocal, true);
+}
+
+void
+GApPred::squash(ThreadID tid, void *bp_history)
+{
+    BPHistory *history = static_cast<BPHistory *>(bp_history);
+
+    specHistory.restore(tid, history->hist);
+
+    historyPool.release(tid, history);
+}
+
+void
+GApPred::serialize(CheckpointOut &cp) const
+{
+    serializeCounters(cp, "ptable", ptable);
+    arrayParamOut(cp, "globalHistory", specHistory.globalHistory());
+}
+
+void
+GApPred::unserialize(CheckpointIn &cp)
+{
+    unserializeCounters(cp, "ptable", ptable);
+    unserializeTable(cp, "globalHistory", specHistory.globalHistory());
 }
 
 }
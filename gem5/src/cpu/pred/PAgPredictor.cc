@@ -12,39 +12,122 @@ namespace branch_prediction
 {
 
 PAgPred::PAgPred(const PAgPredParams &params)
-    : BPredUnit(params)
-      // more parameters are needed to be passed here, check BranchPredictor.py
+    : BPredUnit(params),
+      ltableHeight(params.ltableHeight),
+      gtableHeight(params.gtableHeight),
+      gpredSize(params.gpredSize),
+      gtable(gtableHeight, gpredSize),
+      threshold((1ULL << (gpredSize - 1)) - 1),
+      specHistory(params.numThreads, 0, ltableHeight, params.lhistoryWidth),
+      historyPool(params.numThreads)
 {
-    // you may want to add some checks of the passed parameters here
+    fatal_if(!isPowerOf2(ltableHeight), "Invalid local history table "
+             "height!\n");
+    fatal_if(!isPowerOf2(gtableHeight), "Invalid pattern table height!\n");
+    fatal_if(gtableHeight > (1ULL << params.lhistoryWidth),
+             "Pattern table larger than the local history can index!\n");
+}
+
+inline
+unsigned
+PAgPred::calcLocHistIdx(Addr branch_addr)
+{
+    return (branch_addr >> instShiftAmt) & (ltableHeight - 1);
 }
 
-// unused
 void
 PAgPred::btbUpdate(ThreadID tid, Addr branch_addr, void * &bp_history)
 {
-// Place holder for a function that is called to update predictor history when
-// a BTB entry is invalid or not found.
+    // Update the local history to Not Taken
+    specHistory.clearLast(tid, calcLocHistIdx(branch_addr));
 }
 
 bool
 PAgPred::lookup(ThreadID tid, Addr branch_addr, void * &bp_history)
 {
-    // implement the lookup logic here
+    unsigned local_history_idx = calcLocHistIdx(branch_addr);
+    bool prediction = gtable[specHistory.local(local_history_idx)
+                             & (gtableHeight - 1)] > threshold;
+
+    BPHistory *history = historyPool.acquire(tid);
+    history->hist = specHistory.checkpoint(tid, local_history_idx);
+    bp_history = static_cast<void *>(history);
 
-    return 0;
+    specHistory.speculate(tid, local_history_idx, prediction);
+    return prediction;
+}
+
+unsigned
+PAgPred::lookupBlock(ThreadID tid, const Addr *pcs, unsigned num, bool *taken,
+                     void **bp_history)
+{
+    unsigned i = 0;
+    while (i < num) {
+        taken[i] = PAgPred::lookup(tid, pcs[i], bp_history[i]);
+        if (taken[i++])
+            break;
+    }
+    return i;
 }
 
 void
 PAgPred::update(ThreadID tid, Addr branch_addr, bool taken, void *bp_history,
                 bool squashed, const StaticInstPtr & inst, Addr corrTarget)
 {
-    // implement the update logic here
+    assert(bp_history);
+
+    BPHistory *history = static_cast<BPHistory *>(bp_history);
+
+    // The branch was mispredicted, redo its history update with the
+    // actual outcome. The counters are only updated at commit.
+    if (squashed) {
+        specHistory.repair(tid, history->hist, taken);
+        return;
+    }
+
+    // Unconditional branches do not use local history.
+    if (history->hist.hasLocal()) {
+        unsigned idx = history->hist.local & (gtableHeight - 1);
+        if (taken) {
+            gtable[idx]++;
+        } else {
+            gtable[idx]--;
+        }
+    }
+
+    historyPool.release(tid, history);
 }
 
-// unused
 void
 PAgPred::uncondBranch(ThreadID tid, Addr pc, void *&bp_history)
 {
+    BPHistory *history = historyPool.acquire(tid);
+    history->hist = specHistory.checkpoint(tid);
+    bp_history = static_cast<void *>(history);
+}
+
+void
+PAgPred::squash(ThreadID tid, void *bp_history)
+{
+    BPHistory *history = static_cast<BPHistory *>(bp_history);
+
+    specHistory.restore(tid, history->hist);
+
+    historyPool.release(tid, history);
+}
+
+void
+PAgPred::serialize(CheckpointOut &cp) const
+{
+    arrayParamOut(cp, "localHistoryTable", specHistory.localHistory());
+    serializeCounters(cp, "gtable", gtable);
+}
+
+void
+PAgPred::unserialize(CheckpointIn &cp)
+{
+    unserializeTable(cp, "localHistoryTable", specHistory.localHistory());
+    unserializeCounters(cp, "gtable", gtable);
 }
 
 }
@@ -6,6 +6,8 @@
 #include "base/sat_counter.hh"
 #include "base/types.hh"
 #include "cpu/pred/bpred_unit.hh"
+#include "cpu/pred/history_pool.hh"
+#include "cpu/pred/spec_history.hh"
 #include "params/PAgPred.hh"
 
 namespace gem5
@@ -14,40 +16,64 @@ namespace gem5
 namespace branch_prediction
 {
 
+/**
+ * A PAg two level predictor. The branch address selects a local history,
+ * which selects a counter in a pattern table shared by all branches. The
+ * local histories are updated speculatively at lookup.
+ */
 class PAgPred : public BPredUnit
 {
   public:
 
-    // this is basically the constructor of our class
     PAgPred(const PAgPredParams &params);
 
-    // we will ignore it
-    virtual void uncondBranch(ThreadID tid, Addr pc, void * &bp_history);
+    void uncondBranch(ThreadID tid, Addr pc, void * &bp_history);
 
-    // this function implements the main functionality of the predictor,
-    // that is we will lookup the Global Predictor Table based on the index
-    // we get from the Global History Register and we will return the found
-    // prediction
-    // Note that we inherit this pure virtual function from the main prediction
-    // unit, thus we may or may not use these arguments
     bool lookup(ThreadID tid, Addr branch_addr, void * &bp_history);
 
-    // we will ignore it
+    unsigned lookupBlock(ThreadID tid, const Addr *pcs, unsigned num,
+                         bool *taken, void **bp_history) override;
+
     void btbUpdate(ThreadID tid, Addr branch_addr, void * &bp_history);
 
-    // this function implements the update logic of the predictor,
-    // that is when we have the real result of a branch we have to update
-    // the GPT first (using the same index, +taken -not_taken) and secondly
-    // the GHR by shifting to the left AND 1taken 0not_taken
-    void update(ThreadID tid, Addr branch_addr, bool taken, void *bp_history, bool squashed, const StaticInstPtr & inst, Addr corrTarget);
+    void update(ThreadID tid, Addr branch_addr, bool taken, void *bp_history,
+                bool squashed, const StaticInstPtr & inst, Addr corrTarget);
+
+    void squash(ThreadID tid, void *bp_history);
 
-    void squash(ThreadID tid, void *bp_history)
-    { assert(bp_history == NULL); }
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
 
   private:
+    struct BPHistory
+    {
+        /** The local history the branch was predicted with, if any. */
+        SpeculativeHistory::Checkpoint hist;
+    };
+
+    /** Returns the local history index of a branch. */
+    inline unsigned calcLocHistIdx(Addr branch_addr);
+
+    /** Number of entries of the local history table. */
+    unsigned ltableHeight;
+
+    /** Number of entries of the pattern table. */
+    unsigned gtableHeight;
+
+    /** Number of bits of the counters. */
+    unsigned gpredSize;
+
+    /** The pattern table. */
+    SatCounterArray<> gtable;
+
+    /** Counter values above the threshold predict taken. */
+    unsigned threshold;
 
-        // implement your private fields here, check BranchPredictor.py
+    /** The local history table. */
+    SpeculativeHistory specHistory;
 
+    /** Recycled storage for the in-flight BPHistory records. */
+    HistoryPool<BPHistory> historyPool;
 };
 
 } // branch_prediction
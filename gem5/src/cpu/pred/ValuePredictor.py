@@ -0,0 +1,68 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.SimObject import SimObject
+from m5.params import *
+from m5.proxy import *
+
+class ValuePredictor(SimObject):
+    type = 'ValuePredictor'
+    cxx_class = 'gem5::value_prediction::ValuePredictor'
+    cxx_header = "cpu/pred/value_pred.hh"
+    abstract = True
+
+    numThreads = Param.Unsigned(Parent.numThreads, "Number of threads")
+    instShiftAmt = Param.Unsigned(2, "Number of bits to shift instructions by")
+
+class StrideValuePredictor(ValuePredictor):
+    type = 'StrideValuePredictor'
+    cxx_class = 'gem5::value_prediction::StrideValuePredictor'
+    cxx_header = "cpu/pred/stride_value_pred.hh"
+
+    tableSize = Param.Unsigned(1024, "Number of entries of the table")
+    confBits = Param.Unsigned(3, "Number of bits of the confidence counters")
+    useStride = Param.Bool(True, "Predict the last value plus the last "
+        "stride, rather than the last value")
+
+class LastValuePredictor(StrideValuePredictor):
+    useStride = False
+
+# VTAGE load value predictor, see "Practical data value speculation for
+# future high-end processors", A. Perais and A. Seznec, HPCA 2014
+class VTAGE(ValuePredictor):
+    type = 'VTAGE'
+    cxx_class = 'gem5::value_prediction::VTAGE'
+    cxx_header = "cpu/pred/vtage.hh"
+
+    nHistoryTables = Param.Unsigned(6, "Number of tagged tables")
+    minHist = Param.Unsigned(2, "History length of the shortest table")
+    maxHist = Param.Unsigned(64, "History length of the longest table")
+    logTableSizes = VectorParam.Unsigned([10, 8, 8, 8, 8, 8, 8],
+        "Log2 of the table sizes, the base table first")
+    tagTableTagWidths = VectorParam.Unsigned([0, 12, 12, 13, 13, 14, 14],
+        "Tag widths of the tables, 0 for the untagged base table")
+    confBits = Param.Unsigned(3, "Number of bits of the confidence counters")
+    histBufferSize = Param.Unsigned(1024,
+        "Size of the circular global history, in branch outcomes")
+    logUResetPeriod = Param.Unsigned(16, "Log period in number of trained "
+        "loads to reset the useful bits")
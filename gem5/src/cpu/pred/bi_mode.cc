@@ -43,22 +43,22 @@ namespace branch_prediction
 
 BiModeBP::BiModeBP(const BiModeBPParams &params)
     : BPredUnit(params),
-      globalHistoryReg(params.numThreads, 0),
       globalHistoryBits(ceilLog2(params.globalPredictorSize)),
       choicePredictorSize(params.choicePredictorSize),
       choiceCtrBits(params.choiceCtrBits),
       globalPredictorSize(params.globalPredictorSize),
       globalCtrBits(params.globalCtrBits),
-      choiceCounters(choicePredictorSize, SatCounter8(choiceCtrBits)),
-      takenCounters(globalPredictorSize, SatCounter8(globalCtrBits)),
-      notTakenCounters(globalPredictorSize, SatCounter8(globalCtrBits))
+      choiceCounters(choicePredictorSize, choiceCtrBits),
+      takenCounters(globalPredictorSize, globalCtrBits),
+      notTakenCounters(globalPredictorSize, globalCtrBits),
+      specHistory(params.numThreads, globalHistoryBits),
+      historyPool(params.numThreads)
 {
     if (!isPowerOf2(choicePredictorSize))
         fatal("Invalid choice predictor size.\n");
     if (!isPowerOf2(globalPredictorSize))
         fatal("Invalid global history predictor size.\n");
 
-    historyRegisterMask = mask(globalHistoryBits);
     choiceHistoryMask = choicePredictorSize - 1;
     globalHistoryMask = globalPredictorSize - 1;
 
@@ -75,23 +75,23 @@ BiModeBP::BiModeBP(const BiModeBPParams &params)
 void
 BiModeBP::uncondBranch(ThreadID tid, Addr pc, void * &bpHistory)
 {
-    BPHistory *history = new BPHistory;
-    history->globalHistoryReg = globalHistoryReg[tid];
+    BPHistory *history = historyPool.acquire(tid);
+    history->hist = specHistory.checkpoint(tid);
     history->takenUsed = true;
     history->takenPred = true;
     history->notTakenPred = true;
     history->finalPred = true;
     bpHistory = static_cast<void*>(history);
-    updateGlobalHistReg(tid, true);
+    specHistory.speculate(tid, SpeculativeHistory::noLocal, true);
 }
 
 void
 BiModeBP::squash(ThreadID tid, void *bpHistory)
 {
     BPHistory *history = static_cast<BPHistory*>(bpHistory);
-    globalHistoryReg[tid] = history->globalHistoryReg;
+    specHistory.restore(tid, history->hist);
 
-    delete history;
+    historyPool.release(tid, history);
 }
 
 /*
@@ -109,7 +109,7 @@ BiModeBP::lookup(ThreadID tid, Addr branchAddr, void * &bpHistory)
     unsigned choiceHistoryIdx = ((branchAddr >> instShiftAmt)
                                 & choiceHistoryMask);
     unsigned globalHistoryIdx = (((branchAddr >> instShiftAmt)
-                                ^ globalHistoryReg[tid])
+                                ^ specHistory.global(tid))
                                 & globalHistoryMask);
 
     assert(choiceHistoryIdx < choicePredictorSize);
@@ -123,8 +123,8 @@ BiModeBP::lookup(ThreadID tid, Addr branchAddr, void * &bpHistory)
                                  > notTakenThreshold;
     bool finalPrediction;
 
-    BPHistory *history = new BPHistory;
-    history->globalHistoryReg = globalHistoryReg[tid];
+    BPHistory *history = historyPool.acquire(tid);
+    history->hist = specHistory.checkpoint(tid);
     history->takenUsed = choicePrediction;
     history->takenPred = takenGHBPrediction;
     history->notTakenPred = notTakenGHBPrediction;
@@ -137,7 +137,7 @@ BiModeBP::lookup(ThreadID tid, Addr branchAddr, void * &bpHistory)
 
     history->finalPred = finalPrediction;
     bpHistory = static_cast<void*>(history);
-    updateGlobalHistReg(tid, finalPrediction);
+    specHistory.speculate(tid, SpeculativeHistory::noLocal, finalPrediction);
 
     return finalPrediction;
 }
@@ -145,7 +145,7 @@ BiModeBP::lookup(ThreadID tid, Addr branchAddr, void * &bpHistory)
 void
 BiModeBP::btbUpdate(ThreadID tid, Addr branchAddr, void * &bpHistory)
 {
-    globalHistoryReg[tid] &= (historyRegisterMask & ~1ULL);
+    specHistory.clearLast(tid);
 }
 
 /* Only the selected direction predictor will be updated with the final
@@ -165,14 +165,14 @@ BiModeBP::update(ThreadID tid, Addr branchAddr, bool taken, void *bpHistory,
     // We do not update the counters speculatively on a squash.
     // We just restore the global history register.
     if (squashed) {
-        globalHistoryReg[tid] = (history->globalHistoryReg << 1) | taken;
+        specHistory.repair(tid, history->hist, taken);
         return;
     }
 
     unsigned choiceHistoryIdx = ((branchAddr >> instShiftAmt)
                                 & choiceHistoryMask);
     unsigned globalHistoryIdx = (((branchAddr >> instShiftAmt)
-                                ^ history->globalHistoryReg)
+                                ^ history->hist.global)
                                 & globalHistoryMask);
 
     assert(choiceHistoryIdx < choicePredictorSize);
@@ -221,15 +221,25 @@ BiModeBP::update(ThreadID tid, Addr branchAddr, bool taken, void *bpHistory,
         }
     }
 
-    delete history;
+    historyPool.release(tid, history);
 }
 
 void
-BiModeBP::updateGlobalHistReg(ThreadID tid, bool taken)
+BiModeBP::serialize(CheckpointOut &cp) const
 {
-    globalHistoryReg[tid] = taken ? (globalHistoryReg[tid] << 1) | 1 :
-                               (globalHistoryReg[tid] << 1);
-    globalHistoryReg[tid] &= historyRegisterMask;
+    arrayParamOut(cp, "globalHistoryReg", specHistory.globalHistory());
+    serializeCounters(cp, "choiceCounters", choiceCounters);
+    serializeCounters(cp, "takenCounters", takenCounters);
+    serializeCounters(cp, "notTakenCounters", notTakenCounters);
+}
+
+void
+BiModeBP::unserialize(CheckpointIn &cp)
+{
+    unserializeTable(cp, "globalHistoryReg", specHistory.globalHistory());
+    unserializeCounters(cp, "choiceCounters", choiceCounters);
+    unserializeCounters(cp, "takenCounters", takenCounters);
+    unserializeCounters(cp, "notTakenCounters", notTakenCounters);
 }
 
 } // namespace branch_prediction
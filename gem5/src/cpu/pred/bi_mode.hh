@@ -35,6 +35,8 @@
 
 #include "base/sat_counter.hh"
 #include "cpu/pred/bpred_unit.hh"
+#include "cpu/pred/history_pool.hh"
+#include "cpu/pred/spec_history.hh"
 #include "params/BiModeBP.hh"
 
 namespace gem5
@@ -68,12 +70,14 @@ class BiModeBP : public BPredUnit
     void update(ThreadID tid, Addr branch_addr, bool taken, void *bp_history,
                 bool squashed, const StaticInstPtr & inst, Addr corrTarget);
 
-  private:
-    void updateGlobalHistReg(ThreadID tid, bool taken);
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
 
+  private:
     struct BPHistory
     {
-        unsigned globalHistoryReg;
+        // the global history the branch was predicted with
+        SpeculativeHistory::Checkpoint hist;
         // was the taken array's prediction used?
         // true: takenPred used
         // false: notPred used
@@ -92,9 +96,7 @@ class BiModeBP : public BPredUnit
         bool finalPred;
     };
 
-    std::vector<unsigned> globalHistoryReg;
     unsigned globalHistoryBits;
-    unsigned historyRegisterMask;
 
     unsigned choicePredictorSize;
     unsigned choiceCtrBits;
@@ -104,15 +106,21 @@ class BiModeBP : public BPredUnit
     unsigned globalHistoryMask;
 
     // choice predictors
-    std::vector<SatCounter8> choiceCounters;
+    SatCounterArray<> choiceCounters;
     // taken direction predictors
-    std::vector<SatCounter8> takenCounters;
+    SatCounterArray<> takenCounters;
     // not-taken direction predictors
-    std::vector<SatCounter8> notTakenCounters;
+    SatCounterArray<> notTakenCounters;
 
     unsigned choiceThreshold;
     unsigned takenThreshold;
     unsigned notTakenThreshold;
+
+    /** The global history registers. */
+    SpeculativeHistory specHistory;
+
+    /** Recycled storage for the in-flight BPHistory records. */
+    HistoryPool<BPHistory> historyPool;
 };
 
 } // namespace branch_prediction
@@ -0,0 +1,211 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "base/gbench/sim_object_params.hh"
+#include "cpu/pred/2bit_local.hh"
+#include "cpu/pred/GApPredictor.hh"
+#include "cpu/pred/PAgPredictor.hh"
+#include "cpu/pred/StaticPredictor.hh"
+#include "cpu/pred/bi_mode.hh"
+#include "cpu/pred/tournament.hh"
+#include "mem/cache/replacement_policies/lru_rp.hh"
+#include "params/BiModeBP.hh"
+#include "params/GApPred.hh"
+#include "params/LRURP.hh"
+#include "params/LocalBP.hh"
+#include "params/PAgPred.hh"
+#include "params/StaticPred.hh"
+#include "params/TournamentBP.hh"
+
+using namespace gem5;
+using namespace gem5::branch_prediction;
+
+namespace
+{
+
+/** The BranchPredictor parameters of all the predictors. */
+template <class Params>
+Params &
+bpredParams(const std::string &name)
+{
+    auto &p = simObjectParams<Params>(name);
+    auto &rp = simObjectParams<LRURPParams>(name + ".btb_repl");
+    rp.set_size = 0;
+    p.numThreads = 1;
+    p.BTBEntries = 4096;
+    p.BTBTagSize = 16;
+    p.BTBAssoc = 1;
+    p.BTBReplPolicy = rp.create();
+    p.L0BTBEntries = 0;
+    p.L0BTBAssoc = 0;
+    p.L0BTBReplPolicy = nullptr;
+    p.RASSize = 16;
+    p.maxInFlightBranches = 512;
+    p.instShiftAmt = 2;
+    p.profileEntries = 0;
+    p.indirectBranchPred = nullptr;
+    return p;
+}
+
+/** The predictors to benchmark, with their default parameters. */
+const std::map<std::string, std::function<BPredUnit *()>> predictors = {
+    { "LocalBP", []() -> BPredUnit * {
+        auto &p = bpredParams<LocalBPParams>("local");
+        p.localPredictorSize = 2048;
+        p.localCtrBits = 2;
+        return p.create();
+    } },
+    { "TournamentBP", []() -> BPredUnit * {
+        auto &p = bpredParams<TournamentBPParams>("tournament");
+        p.localPredictorSize = 2048;
+        p.localCtrBits = 2;
+        p.localHistoryTableSize = 2048;
+        p.globalPredictorSize = 8192;
+        p.globalCtrBits = 2;
+        p.choicePredictorSize = 8192;
+        p.choiceCtrBits = 2;
+        return p.create();
+    } },
+    { "BiModeBP", []() -> BPredUnit * {
+        auto &p = bpredParams<BiModeBPParams>("bi_mode");
+        p.globalPredictorSize = 8192;
+        p.globalCtrBits = 2;
+        p.choicePredictorSize = 8192;
+        p.choiceCtrBits = 2;
+        return p.create();
+    } },
+    { "GApPred", []() -> BPredUnit * {
+        auto &p = bpredParams<GApPredParams>("gap");
+        p.historySize = 5;
+        p.ptableHeight = 32;
+        p.ptableWidth = 32;
+        p.predSize = 2;
+        return p.create();
+    } },
+    { "PAgPred", []() -> BPredUnit * {
+        auto &p = bpredParams<PAgPredParams>("pag");
+        p.ltableHeight = 256;
+        p.lhistoryWidth = 5;
+        p.gtableHeight = 32;
+        p.gpredSize = 2;
+        return p.create();
+    } },
+    { "StaticPred", []() -> BPredUnit * {
+        return bpredParams<StaticPredParams>("static").create();
+    } },
+};
+
+struct Branch
+{
+    Addr pc;
+    bool taken;
+};
+
+/**
+ * The conditional branches of a program: some biased one way, some
+ * loops taken a fixed number of times, some random.
+ */
+std::vector<Branch>
+branchStream(int num_branches)
+{
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<int> branch_dist(0, num_branches - 1);
+    std::uniform_int_distribution<int> kind_dist(0, 2);
+    std::uniform_int_distribution<int> trip_dist(2, 16);
+    std::bernoulli_distribution coin(0.5);
+    std::vector<Branch> stream;
+    while (stream.size() < 16384) {
+        Addr pc = 0x400000 + 64 * branch_dist(gen);
+        switch (kind_dist(gen)) {
+          case 0:
+            for (int i = 0; i < 8; i++)
+                stream.push_back({ pc, (pc & 0x40) != 0 });
+            break;
+          case 1:
+            for (int i = trip_dist(gen); i > 0; i--)
+                stream.push_back({ pc, i > 1 });
+            break;
+          default:
+            stream.push_back({ pc, coin(gen) });
+        }
+    }
+    return stream;
+}
+
+/**
+ * Predict and resolve conditional branches, as a pipeline does at fetch
+ * and commit, repairing the speculative state of the predictor when the
+ * prediction was wrong.
+ */
+void
+BM_BPredLookupUpdate(benchmark::State &state, const std::string &name)
+{
+    BPredUnit *bp = predictors.at(name)();
+    const auto stream = branchStream(state.range(0));
+    const ThreadID tid = 0;
+
+    size_t i = 0;
+    uint64_t mispredicts = 0;
+    for (auto _ : state) {
+        const Branch &branch = stream[i];
+        void *history = nullptr;
+        bool taken = bp->lookup(tid, branch.pc, history);
+        if (taken != branch.taken) {
+            bp->update(tid, branch.pc, branch.taken, history, true,
+                       nullptr, 0);
+            mispredicts++;
+        }
+        bp->update(tid, branch.pc, branch.taken, history, false, nullptr, 0);
+        i = (i + 1) % stream.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["mispredict_rate"] =
+        static_cast<double>(mispredicts) / state.iterations();
+}
+
+} // anonymous namespace
+
+BENCHMARK_CAPTURE(BM_BPredLookupUpdate, LocalBP, "LocalBP")
+    ->Arg(64)->Arg(4096);
+BENCHMARK_CAPTURE(BM_BPredLookupUpdate, TournamentBP, "TournamentBP")
+    ->Arg(64)->Arg(4096);
+BENCHMARK_CAPTURE(BM_BPredLookupUpdate, BiModeBP, "BiModeBP")
+    ->Arg(64)->Arg(4096);
+BENCHMARK_CAPTURE(BM_BPredLookupUpdate, GApPred, "GApPred")
+    ->Arg(64)->Arg(4096);
+BENCHMARK_CAPTURE(BM_BPredLookupUpdate, PAgPred, "PAgPred")
+    ->Arg(64)->Arg(4096);
+BENCHMARK_CAPTURE(BM_BPredLookupUpdate, StaticPred, "StaticPred")
+    ->Arg(64)->Arg(4096);
+
+BENCHMARK_MAIN();
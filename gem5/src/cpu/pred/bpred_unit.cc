@@ -46,9 +46,11 @@
 
 #include "arch/generic/pcstate.hh"
 #include "base/compiler.hh"
+#include "base/cprintf.hh"
 #include "base/trace.hh"
 #include "config/the_isa.hh"
 #include "debug/Branch.hh"
+#include "sim/cur_tick.hh"
 
 namespace gem5
 {
@@ -59,18 +61,63 @@ namespace branch_prediction
 BPredUnit::BPredUnit(const Params &params)
     : SimObject(params),
       numThreads(params.numThreads),
-      predHist(numThreads),
+      maxInFlightBranches(params.maxInFlightBranches),
       BTB(params.BTBEntries,
           params.BTBTagSize,
           params.instShiftAmt,
-          params.numThreads),
+          params.numThreads,
+          params.BTBAssoc,
+          params.BTBReplPolicy),
       RAS(numThreads),
       iPred(params.indirectBranchPred),
       stats(this),
       instShiftAmt(params.instShiftAmt)
 {
+    fatal_if(maxInFlightBranches == 0,
+             "%s: maxInFlightBranches must be non-zero\n", name());
+
+    predHist.reserve(numThreads);
+    for (int i = 0; i < numThreads; i++)
+        predHist.emplace_back(maxInFlightBranches);
+
     for (auto& r : RAS)
         r.init(params.RASSize);
+
+    if (params.L0BTBEntries) {
+        L0BTB = std::make_unique<DefaultBTB>(params.L0BTBEntries,
+                                             params.BTBTagSize,
+                                             params.instShiftAmt,
+                                             params.numThreads,
+                                             params.L0BTBAssoc,
+                                             params.L0BTBReplPolicy);
+    }
+
+    if (params.profileEntries) {
+        profile = std::make_unique<BranchProfile>(params.profileEntries);
+        profileStream = simout.create(params.profileFile.empty() ?
+            name() + ".mispredicts.txt" : params.profileFile);
+        fatal_if(!profileStream, "%s: unable to open the profile file\n",
+                 name());
+        statistics::registerDumpCallback([this]() { dumpProfile(); });
+        statistics::registerResetCallback([this]() { profile->clear(); });
+    }
+}
+
+BPredUnit::~BPredUnit()
+{
+    if (profileStream)
+        simout.close(profileStream);
+}
+
+void
+BPredUnit::dumpProfile()
+{
+    std::ostream &os = *profileStream->stream();
+    ccprintf(os, "---------- Begin misprediction profile at tick %d "
+             "----------\n", curTick());
+    profile->dump(os);
+    ccprintf(os, "---------- End misprediction profile ----------\n\n");
+    os.flush();
 }
 
 BPredUnit::BPredUnitStats::BPredUnitStats(statistics::Group *parent)
@@ -86,10 +133,20 @@ BPredUnit::BPredUnitStats::BPredUnitStats(statistics::Group *parent)
       ADD_STAT(BTBHits, statistics::units::Count::get(), "Number of BTB hits"),
       ADD_STAT(BTBHitRatio, statistics::units::Ratio::get(), "BTB Hit Ratio",
                BTBHits / BTBLookups),
+      ADD_STAT(L0BTBHits, statistics::units::Count::get(),
+               "Number of BTB hits in the zero bubble BTB"),
+      ADD_STAT(L1BTBHits, statistics::units::Count::get(),
+               "Number of BTB hits in the main BTB"),
       ADD_STAT(RASUsed, statistics::units::Count::get(),
                "Number of times the RAS was used to get a target."),
       ADD_STAT(RASIncorrect, statistics::units::Count::get(),
                "Number of incorrect RAS predictions."),
+      ADD_STAT(RASOverflows, statistics::units::Count::get(),
+               "Number of calls that overwrote the oldest RAS entry."),
+      ADD_STAT(RASUnderflows, statistics::units::Count::get(),
+               "Number of returns predicted with an empty RAS."),
+      ADD_STAT(RASRepairs, statistics::units::Count::get(),
+               "Number of squashed calls and returns that repaired the RAS."),
       ADD_STAT(indirectLookups, statistics::units::Count::get(),
                "Number of indirect predictor lookups."),
       ADD_STAT(indirectHits, statistics::units::Count::get(),
@@ -102,6 +159,40 @@ BPredUnit::BPredUnitStats::BPredUnitStats(statistics::Group *parent)
     BTBHitRatio.precision(6);
 }
 
+const PCStateBase *
+BPredUnit::lookupBTBs(Addr inst_pc, ThreadID tid)
+{
+    if (L0BTB) {
+        if (const PCStateBase *target = L0BTB->lookup(inst_pc, tid)) {
+            ++stats.L0BTBHits;
+            return target;
+        }
+    }
+
+    const PCStateBase *target = BTB.lookup(inst_pc, tid);
+    if (target) {
+        ++stats.L1BTBHits;
+        if (L0BTB)
+            L0BTB->update(inst_pc, *target, tid);
+    }
+    return target;
+}
+
+void
+BPredUnit::updateBTBs(Addr inst_pc, const PCStateBase &target, ThreadID tid)
+{
+    BTB.update(inst_pc, target, tid);
+    // Only fix up the zero bubble BTB, it is filled by main BTB hits.
+    if (L0BTB)
+        L0BTB->updateIfPresent(inst_pc, target, tid);
+}
+
+void
+BPredUnit::BTBUpdate(Addr instPC, const PCStateBase &target)
+{
+    updateBTBs(instPC, target, 0);
+}
+
 probing::PMUUPtr
 BPredUnit::pmuProbePoint(const char *name)
 {
@@ -116,6 +207,31 @@ BPredUnit::regProbePoints()
 {
     ppBranches = pmuProbePoint("Branches");
     ppMisses = pmuProbePoint("Misses");
+
+    ppCommittedBranches.reset(new ProbePointArg<CommittedBranch>(
+        getProbeManager(), "CommittedBranches"));
+}
+
+void
+BPredUnit::serializeCounters(CheckpointOut &cp, const std::string &name,
+                             const SatCounterArray<> &ctrs)
+{
+    std::vector<uint8_t> values(ctrs.size());
+    for (size_t i = 0; i < ctrs.size(); ++i) {
+        values[i] = ctrs[i];
+    }
+    arrayParamOut(cp, name, values);
+}
+
+void
+BPredUnit::unserializeCounters(CheckpointIn &cp, const std::string &name,
+                               SatCounterArray<> &ctrs) const
+{
+    std::vector<uint8_t> values(ctrs.size());
+    unserializeTable(cp, name, values);
+    for (size_t i = 0; i < ctrs.size(); ++i) {
+        ctrs.set(i, values[i]);
+    }
 }
 
 void
@@ -137,13 +253,11 @@ BPredUnit::predict(const StaticInstPtr &inst, const InstSeqNum &seqNum,
     // up once it's done.
 
     bool pred_taken = false;
-    std::unique_ptr<PCStateBase> target(pc.clone());
 
     ++stats.lookups;
     ppBranches->notify(1);
 
     void *bp_history = NULL;
-    void *indirect_history = NULL;
 
     if (inst->isUncondCtrl()) {
         DPRINTF(Branch, "[tid:%i] [sn:%llu] Unconditional control\n",
@@ -160,6 +274,80 @@ BPredUnit::predict(const StaticInstPtr &inst, const InstSeqNum &seqNum,
                 tid, seqNum,  pred_taken, pc);
     }
 
+    return predictTarget(inst, seqNum, pc, tid, pred_taken, bp_history);
+}
+
+unsigned
+BPredUnit::predictBlock(FetchBlock &block, ThreadID tid)
+{
+    Addr pcs[MaxBlockBranches];
+    bool taken[MaxBlockBranches];
+    void *bp_history[MaxBlockBranches];
+
+    DPRINTF(Branch, "[tid:%i] Predicting %i branches of the block at %#x\n",
+            tid, block.numBranches, block.startPC);
+
+    unsigned idx = 0;
+    while (idx < block.numBranches) {
+        BlockBranch &first = block.branches[idx];
+        if (first.inst->isUncondCtrl()) {
+            first.taken = predict(first.inst, first.seqNum, *first.pc, tid);
+            if (first.taken)
+                return idx;
+            ++idx;
+            continue;
+        }
+
+        // Look the run of conditional branches up in one go.
+        unsigned run = 0;
+        while (idx + run < block.numBranches &&
+               !block.branches[idx + run].inst->isUncondCtrl()) {
+            pcs[run] = block.branches[idx + run].pc->instAddr();
+            ++run;
+        }
+
+        const unsigned looked_up = lookupBlock(tid, pcs, run, taken,
+                                               bp_history);
+        assert(looked_up > 0 && looked_up <= run);
+        stats.lookups += looked_up;
+        stats.condPredicted += looked_up;
+        ppBranches->notify(looked_up);
+
+        for (unsigned i = 0; i < looked_up; ++i, ++idx) {
+            BlockBranch &branch = block.branches[idx];
+            // A taken branch that misses in the BTB falls through, and
+            // the branches behind it are looked up next.
+            branch.taken = predictTarget(branch.inst, branch.seqNum,
+                                         *branch.pc, tid, taken[i],
+                                         bp_history[i]);
+            if (branch.taken)
+                return idx;
+        }
+    }
+    return block.numBranches;
+}
+
+unsigned
+BPredUnit::lookupBlock(ThreadID tid, const Addr *pcs, unsigned num,
+                       bool *taken, void **bp_history)
+{
+    unsigned i = 0;
+    while (i < num) {
+        taken[i] = lookup(tid, pcs[i], bp_history[i]);
+        if (taken[i++])
+            break;
+    }
+    return i;
+}
+
+bool
+BPredUnit::predictTarget(const StaticInstPtr &inst, const InstSeqNum &seqNum,
+                         PCStateBase &pc, ThreadID tid, bool pred_taken,
+                         void *bp_history)
+{
+    InlinePCState target(pc);
+    void *indirect_history = NULL;
+
     const bool orig_pred_taken = pred_taken;
     if (iPred) {
         iPred->genIndirectInfo(tid, indirect_history);
@@ -169,39 +357,59 @@ BPredUnit::predict(const StaticInstPtr &inst, const InstSeqNum &seqNum,
             "[tid:%i] [sn:%llu] Creating prediction history for PC %s\n",
             tid, seqNum, pc);
 
-    PredictorHistory predict_record(seqNum, pc.instAddr(), pred_taken,
-                                    bp_history, indirect_history, tid, inst);
+    // Claim the next slot of the history ring and fill it in place.
+    History &pred_hist = predHist[tid];
+    fatal_if(pred_hist.full(), "%s: more than %u branches in flight on "
+             "thread %i, increase maxInFlightBranches\n", name(),
+             maxInFlightBranches, tid);
+    pred_hist.advance_tail();
+    PredictorHistory &predict_record = pred_hist.back();
+    predict_record.reset(seqNum, pc.instAddr(), pred_taken, bp_history,
+                         indirect_history, tid, inst);
+
+    // Calls and returns remember the top of the RAS, so that whatever they
+    // do to it can be undone exactly on a squash. A call keeps its PC to
+    // push it when it turns out to be taken after all.
+    predict_record.wasCall = inst->isCall();
+    predict_record.wasReturn = inst->isReturn();
+    if (predict_record.wasCall || predict_record.wasReturn)
+        RAS[tid].checkpoint(predict_record.RASCheckpoint);
+    if (predict_record.wasCall)
+        set(predict_record.callPC, pc);
+
+    // Listeners of the commit probe want to know where a call returns to,
+    // which is only known while we still have the full PC state.
+    if (ppCommittedBranches->hasListeners()) {
+        set(fallThroughPC, pc);
+        inst->advancePC(*fallThroughPC);
+        predict_record.fallThrough = fallThroughPC->instAddr();
+    }
 
     // Now lookup in the BTB or RAS.
     if (pred_taken) {
         if (inst->isReturn()) {
             ++stats.RASUsed;
-            predict_record.wasReturn = true;
+            if (RAS[tid].empty())
+                ++stats.RASUnderflows;
             // If it's a function return call, then look up the address
             // in the RAS.
             const PCStateBase *ras_top = RAS[tid].top();
             if (ras_top)
                 set(target, inst->buildRetPC(pc, *ras_top));
 
-            // Record the top entry of the RAS, and its index.
             predict_record.usedRAS = true;
-            predict_record.RASIndex = RAS[tid].topIdx();
-            set(predict_record.RASTarget, ras_top);
-
-            RAS[tid].pop();
 
             DPRINTF(Branch, "[tid:%i] [sn:%llu] Instruction %s is a return, "
                     "RAS predicted target: %s, RAS index: %i\n",
-                    tid, seqNum, pc, *target, predict_record.RASIndex);
+                    tid, seqNum, pc, *target, RAS[tid].topIdx());
+
+            RAS[tid].pop();
         } else {
 
             if (inst->isCall()) {
-                RAS[tid].push(pc);
-                predict_record.pushedRAS = true;
-
-                // Record that it was a call so that the top RAS entry can
-                // be popped off if the speculation is incorrect.
-                predict_record.wasCall = true;
+                if (RAS[tid].full())
+                    ++stats.RASOverflows;
+                RAS[tid].push(pc, predict_record.RASCheckpoint);
 
                 DPRINTF(Branch,
                         "[tid:%i] [sn:%llu] Instruction %s was a call, adding "
@@ -212,10 +420,12 @@ BPredUnit::predict(const StaticInstPtr &inst, const InstSeqNum &seqNum,
             if (inst->isDirectCtrl() || !iPred) {
                 ++stats.BTBLookups;
                 // Check BTB on direct branches
-                if (BTB.valid(pc.instAddr(), tid)) {
+                const PCStateBase *btb_target =
+                    lookupBTBs(pc.instAddr(), tid);
+                if (btb_target) {
                     ++stats.BTBHits;
                     // If it's not a return, use the BTB to get target addr.
-                    set(target, BTB.lookup(pc.instAddr(), tid));
+                    set(target, btb_target);
                     DPRINTF(Branch,
                             "[tid:%i] [sn:%llu] Instruction %s predicted "
                             "target is %s\n",
@@ -223,6 +433,7 @@ BPredUnit::predict(const StaticInstPtr &inst, const InstSeqNum &seqNum,
                 } else {
                     DPRINTF(Branch, "[tid:%i] [sn:%llu] BTB doesn't have a "
                             "valid entry\n", tid, seqNum);
+                    predict_record.btbMiss = true;
                     pred_taken = false;
                     predict_record.predTaken = pred_taken;
                     // The Direction of the branch predictor is altered
@@ -235,8 +446,7 @@ BPredUnit::predict(const StaticInstPtr &inst, const InstSeqNum &seqNum,
                                 "called for %s\n",
                                 tid, seqNum, pc);
                     } else if (inst->isCall() && !inst->isUncondCtrl()) {
-                        RAS[tid].pop();
-                        predict_record.pushedRAS = false;
+                        RAS[tid].restore(predict_record.RASCheckpoint);
                     }
                     inst->advancePC(*target);
                 }
@@ -262,8 +472,7 @@ BPredUnit::predict(const StaticInstPtr &inst, const InstSeqNum &seqNum,
                     if (!inst->isCall() && !inst->isReturn()) {
 
                     } else if (inst->isCall() && !inst->isUncondCtrl()) {
-                        RAS[tid].pop();
-                        predict_record.pushedRAS = false;
+                        RAS[tid].restore(predict_record.RASCheckpoint);
                     }
                     inst->advancePC(*target);
                 }
@@ -272,9 +481,6 @@ BPredUnit::predict(const StaticInstPtr &inst, const InstSeqNum &seqNum,
             }
         }
     } else {
-        if (inst->isReturn()) {
-           predict_record.wasReturn = true;
-        }
         inst->advancePC(*target);
     }
     predict_record.target = target->instAddr();
@@ -290,12 +496,10 @@ BPredUnit::predict(const StaticInstPtr &inst, const InstSeqNum &seqNum,
         iPred->updateDirectionInfo(tid, orig_pred_taken);
     }
 
-    predHist[tid].push_front(predict_record);
-
     DPRINTF(Branch,
             "[tid:%i] [sn:%llu] History entry added. "
             "predHist.size(): %i\n",
-            tid, seqNum, predHist[tid].size());
+            tid, seqNum, pred_hist.size());
 
     return pred_taken;
 }
@@ -306,20 +510,32 @@ BPredUnit::update(const InstSeqNum &done_sn, ThreadID tid)
     DPRINTF(Branch, "[tid:%i] Committing branches until "
             "sn:%llu]\n", tid, done_sn);
 
-    while (!predHist[tid].empty() &&
-           predHist[tid].back().seqNum <= done_sn) {
+    History &pred_hist = predHist[tid];
+
+    while (!pred_hist.empty() &&
+           pred_hist.front().seqNum <= done_sn) {
+        PredictorHistory &oldest = pred_hist.front();
+
         // Update the branch predictor with the correct results.
-        update(tid, predHist[tid].back().pc,
-                    predHist[tid].back().predTaken,
-                    predHist[tid].back().bpHistory, false,
-                    predHist[tid].back().inst,
-                    predHist[tid].back().target);
+        update(tid, oldest.pc, oldest.predTaken, oldest.bpHistory, false,
+               oldest.inst, oldest.target);
+
+        if (profile) {
+            profile->record(oldest.pc, oldest.mispredicted, oldest.btbMiss);
+        }
+
+        if (ppCommittedBranches->hasListeners()) {
+            ppCommittedBranches->notify({tid, oldest.pc, oldest.target,
+                                         oldest.fallThrough,
+                                         oldest.predTaken,
+                                         oldest.inst.get()});
+        }
 
         if (iPred) {
-            iPred->commit(done_sn, tid, predHist[tid].back().indirectHistory);
+            iPred->commit(done_sn, tid, oldest.indirectHistory);
         }
 
-        predHist[tid].pop_back();
+        pred_hist.pop_front();
     }
 }
 
@@ -333,35 +549,31 @@ BPredUnit::squash(const InstSeqNum &squashed_sn, ThreadID tid)
     }
 
     while (!pred_hist.empty() &&
-           pred_hist.front().seqNum > squashed_sn) {
-        if (pred_hist.front().usedRAS) {
-            DPRINTF(Branch, "[tid:%i] [squash sn:%llu]"
-                    " Restoring top of RAS to: %i,"
-                    " target: %s\n", tid, squashed_sn,
-                    pred_hist.front().RASIndex, *pred_hist.front().RASTarget);
-
-            RAS[tid].restore(pred_hist.front().RASIndex,
-                             pred_hist.front().RASTarget.get());
-        } else if (pred_hist.front().wasCall && pred_hist.front().pushedRAS) {
-             // Was a call but predicated false. Pop RAS here
-             DPRINTF(Branch, "[tid:%i] [squash sn:%llu] Squashing"
-                     "  Call [sn:%llu] PC: %s Popping RAS\n", tid, squashed_sn,
-                     pred_hist.front().seqNum, pred_hist.front().pc);
-             RAS[tid].pop();
+           pred_hist.back().seqNum > squashed_sn) {
+        PredictorHistory &youngest = pred_hist.back();
+
+        if (youngest.wasCall || youngest.wasReturn) {
+            ++stats.RASRepairs;
+            DPRINTF(Branch, "[tid:%i] [squash sn:%llu] Squashing"
+                    " call/return [sn:%llu] PC: %#x, restoring top of RAS"
+                    " to: %i\n", tid, squashed_sn, youngest.seqNum,
+                    youngest.pc, youngest.RASCheckpoint.tos);
+
+            RAS[tid].restore(youngest.RASCheckpoint);
         }
 
         // This call should delete the bpHistory.
-        squash(tid, pred_hist.front().bpHistory);
+        squash(tid, youngest.bpHistory);
         if (iPred) {
-            iPred->deleteIndirectInfo(tid, pred_hist.front().indirectHistory);
+            iPred->deleteIndirectInfo(tid, youngest.indirectHistory);
         }
 
         DPRINTF(Branch, "[tid:%i] [squash sn:%llu] "
                 "Removing history for [sn:%llu] "
-                "PC %#x\n", tid, squashed_sn, pred_hist.front().seqNum,
-                pred_hist.front().pc);
+                "PC %#x\n", tid, squashed_sn, youngest.seqNum,
+                youngest.pc);
 
-        pred_hist.pop_front();
+        pred_hist.pop_back();
 
         DPRINTF(Branch, "[tid:%i] [squash sn:%llu] predHist.size(): %i\n",
                 tid, squashed_sn, predHist[tid].size());
@@ -400,16 +612,14 @@ BPredUnit::squash(const InstSeqNum &squashed_sn,
     // fix up the entry.
     if (!pred_hist.empty()) {
 
-        auto hist_it = pred_hist.begin();
-        //HistoryIt hist_it = find(pred_hist.begin(), pred_hist.end(),
-        //                       squashed_sn);
-
-        //assert(hist_it != pred_hist.end());
-        if (pred_hist.front().seqNum != squashed_sn) {
-            DPRINTF(Branch, "Front sn %i != Squash sn %i\n",
-                    pred_hist.front().seqNum, squashed_sn);
+        // Everything younger is gone, so the mispredicted branch is now
+        // the youngest entry.
+        auto hist_it = pred_hist.getIterator(pred_hist.tail());
+        if (pred_hist.back().seqNum != squashed_sn) {
+            DPRINTF(Branch, "Back sn %i != Squash sn %i\n",
+                    pred_hist.back().seqNum, squashed_sn);
 
-            assert(pred_hist.front().seqNum == squashed_sn);
+            assert(pred_hist.back().seqNum == squashed_sn);
         }
 
 
@@ -430,33 +640,46 @@ BPredUnit::squash(const InstSeqNum &squashed_sn,
         // the branch actually commits.
 
         // Remember the correct direction for the update at commit.
-        pred_hist.front().predTaken = actually_taken;
-        pred_hist.front().target = corr_target.instAddr();
+        pred_hist.back().mispredicted = true;
+        pred_hist.back().predTaken = actually_taken;
+        pred_hist.back().target = corr_target.instAddr();
 
         update(tid, (*hist_it).pc, actually_taken,
-               pred_hist.front().bpHistory, true, pred_hist.front().inst,
+               pred_hist.back().bpHistory, true, pred_hist.back().inst,
                corr_target.instAddr());
 
         if (iPred) {
             iPred->changeDirectionPrediction(tid,
-                pred_hist.front().indirectHistory, actually_taken);
+                pred_hist.back().indirectHistory, actually_taken);
         }
 
-        if (actually_taken) {
-            if (hist_it->wasReturn && !hist_it->usedRAS) {
-                 DPRINTF(Branch, "[tid:%i] [squash sn:%llu] "
-                        "Incorrectly predicted "
-                        "return [sn:%llu] PC: %#x\n", tid, squashed_sn,
-                        hist_it->seqNum,
-                        hist_it->pc);
-                 RAS[tid].pop();
-                 hist_it->usedRAS = true;
+        // Undo what the branch did to the RAS, and redo it with the
+        // actual direction.
+        if (hist_it->wasCall || hist_it->wasReturn) {
+            RAS[tid].restore(hist_it->RASCheckpoint);
+            hist_it->usedRAS = false;
+            if (actually_taken && hist_it->wasCall) {
+                DPRINTF(Branch, "[tid:%i] [squash sn:%llu] Incorrectly "
+                        "predicted call [sn:%llu] PC: %#x Pushing RAS\n",
+                        tid, squashed_sn, hist_it->seqNum, hist_it->pc);
+                if (RAS[tid].full())
+                    ++stats.RASOverflows;
+                RAS[tid].push(*hist_it->callPC, hist_it->RASCheckpoint);
+            } else if (actually_taken && hist_it->wasReturn) {
+                DPRINTF(Branch, "[tid:%i] [squash sn:%llu] Incorrectly "
+                        "predicted return [sn:%llu] PC: %#x Popping RAS\n",
+                        tid, squashed_sn, hist_it->seqNum, hist_it->pc);
+                RAS[tid].pop();
+                hist_it->usedRAS = true;
             }
+        }
+
+        if (actually_taken) {
             if (hist_it->wasIndirect) {
                 ++stats.indirectMispredicted;
                 if (iPred) {
                     iPred->recordTarget(
-                        hist_it->seqNum, pred_hist.front().indirectHistory,
+                        hist_it->seqNum, pred_hist.back().indirectHistory,
                         corr_target, tid);
                 }
             } else {
@@ -465,33 +688,8 @@ BPredUnit::squash(const InstSeqNum &squashed_sn,
                         "PC %#x\n", tid, squashed_sn,
                         hist_it->seqNum, hist_it->pc);
 
-                BTB.update(hist_it->pc, corr_target, tid);
+                updateBTBs(hist_it->pc, corr_target, tid);
             }
-        } else {
-           //Actually not Taken
-           if (hist_it->usedRAS) {
-                DPRINTF(Branch,
-                        "[tid:%i] [squash sn:%llu] Incorrectly predicted "
-                        "return [sn:%llu] PC: %#x Restoring RAS\n", tid,
-                        squashed_sn,
-                        hist_it->seqNum, hist_it->pc);
-                DPRINTF(Branch,
-                        "[tid:%i] [squash sn:%llu] Restoring top of RAS "
-                        "to: %i, target: %s\n", tid, squashed_sn,
-                        hist_it->RASIndex, *hist_it->RASTarget);
-                RAS[tid].restore(hist_it->RASIndex, hist_it->RASTarget.get());
-                hist_it->usedRAS = false;
-           } else if (hist_it->wasCall && hist_it->pushedRAS) {
-                 //Was a Call but predicated false. Pop RAS here
-                 DPRINTF(Branch,
-                        "[tid:%i] [squash sn:%llu] "
-                        "Incorrectly predicted "
-                        "Call [sn:%llu] PC: %s Popping RAS\n",
-                        tid, squashed_sn,
-                        hist_it->seqNum, hist_it->pc);
-                 RAS[tid].pop();
-                 hist_it->pushedRAS = false;
-           }
         }
     } else {
         DPRINTF(Branch, "[tid:%i] [sn:%llu] pred_hist empty, can't "
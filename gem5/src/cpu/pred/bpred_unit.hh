@@ -42,10 +42,15 @@
 #ifndef __CPU_PRED_BPRED_UNIT_HH__
 #define __CPU_PRED_BPRED_UNIT_HH__
 
-#include <deque>
+#include <array>
+#include <memory>
 
+#include "base/circular_queue.hh"
+#include "base/output.hh"
+#include "base/sat_counter.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
+#include "cpu/pred/branch_profile.hh"
 #include "cpu/pred/btb.hh"
 #include "cpu/pred/indirect.hh"
 #include "cpu/pred/ras.hh"
@@ -53,6 +58,7 @@
 #include "cpu/static_inst.hh"
 #include "params/BranchPredictor.hh"
 #include "sim/probe/pmu.hh"
+#include "sim/probe/probe.hh"
 #include "sim/sim_object.hh"
 
 namespace gem5
@@ -69,11 +75,84 @@ class BPredUnit : public SimObject
 {
   public:
       typedef BranchPredictorParams Params;
+
+    /**
+     * Outcome of a committed control instruction, as passed to the
+     * CommittedBranches probe point.
+     */
+    struct CommittedBranch
+    {
+        /** The thread the branch belongs to. */
+        ThreadID tid;
+        /** The PC of the branch. */
+        Addr pc;
+        /** The resolved target, the fall through PC if not taken. */
+        Addr target;
+        /**
+         * The PC of the next sequential instruction, only valid while
+         * somebody listens to the probe point.
+         */
+        Addr fallThrough;
+        /** The resolved direction. */
+        bool taken;
+        /** The branch instruction. */
+        const StaticInst *inst;
+    };
+
+    /** Most branches a fetch block predicted in one go can hold. */
+    static constexpr unsigned MaxBlockBranches = 8;
+
+    /** A branch of a fetch block. */
+    struct BlockBranch
+    {
+        /** The branch instruction. */
+        StaticInstPtr inst;
+        /** The sequence number of the branch. */
+        InstSeqNum seqNum = 0;
+        /** The PC of the branch, the predicted next PC once predicted. */
+        std::unique_ptr<PCStateBase> pc;
+        /** Whether the branch was predicted taken. */
+        bool taken = false;
+    };
+
+    /**
+     * The branches of a block of instructions fetched along its fall
+     * through path, in program order. Every branch but the last one is
+     * assumed not taken, so the block ends at its first taken branch.
+     */
+    struct FetchBlock
+    {
+        /** The PC the block starts at. */
+        Addr startPC = MaxAddr;
+        /** Number of valid entries of branches. */
+        unsigned numBranches = 0;
+        std::array<BlockBranch, MaxBlockBranches> branches;
+
+        bool empty() const { return numBranches == 0; }
+        bool full() const { return numBranches == MaxBlockBranches; }
+
+        void clear() { numBranches = 0; startPC = MaxAddr; }
+
+        /** Appends the next branch of the block. */
+        void
+        append(const StaticInstPtr &inst, InstSeqNum seq_num,
+               const PCStateBase &pc)
+        {
+            assert(!full());
+            BlockBranch &branch = branches[numBranches++];
+            branch.inst = inst;
+            branch.seqNum = seq_num;
+            set(branch.pc, pc);
+            branch.taken = false;
+        }
+    };
     /**
      * @param params The params object, that has the size of the BP and BTB.
      */
     BPredUnit(const Params &p);
 
+    ~BPredUnit();
+
     void regProbePoints() override;
 
     /** Perform sanity checks after a drain. */
@@ -90,6 +169,19 @@ class BPredUnit : public SimObject
     bool predict(const StaticInstPtr &inst, const InstSeqNum &seqNum,
                  PCStateBase &pc, ThreadID tid);
 
+    /**
+     * Predicts the branches of a fetch block in order, until one is
+     * predicted taken. Runs of conditional branches are looked up with a
+     * single call to lookupBlock(). The branches after the taken one are
+     * left alone, the fetch stage has to drop them.
+     * @param block The fetch block. The PC of each predicted branch is
+     * replaced by its predicted next PC, so the next fetch address is the
+     * PC of the taken branch.
+     * @param tid The thread id.
+     * @return Index of the taken branch, numBranches if none is.
+     */
+    unsigned predictBlock(FetchBlock &block, ThreadID tid);
+
     // @todo: Rename this function.
     virtual void uncondBranch(ThreadID tid, Addr pc, void * &bp_history) = 0;
 
@@ -137,6 +229,20 @@ class BPredUnit : public SimObject
      */
     virtual bool lookup(ThreadID tid, Addr instPC, void * &bp_history) = 0;
 
+    /**
+     * Looks up consecutive conditional branches of a fetch block, until
+     * one is predicted taken. Each lookup sees the histories updated by
+     * the ones before it, as with lookup(). Predictors override this to
+     * look a block up without a virtual call per branch.
+     * @param pcs The PCs of the branches, in program order.
+     * @param num Number of branches.
+     * @param taken The predicted directions are passed back through this.
+     * @param bp_history The history objects are passed back through this.
+     * @return Number of branches looked up.
+     */
+    virtual unsigned lookupBlock(ThreadID tid, const Addr *pcs, unsigned num,
+                                 bool *taken, void **bp_history);
+
      /**
      * If a branch is not taken, because the BTB address is invalid or missing,
      * this function sets the appropriate counter in the global and local
@@ -188,40 +294,48 @@ class BPredUnit : public SimObject
      * @param inst_PC The branch's PC that will be updated.
      * @param target_PC The branch's target that will be added to the BTB.
      */
-    void
-    BTBUpdate(Addr instPC, const PCStateBase &target)
-    {
-        BTB.update(instPC, target, 0);
-    }
+    void BTBUpdate(Addr instPC, const PCStateBase &target);
 
 
     void dump();
 
+    /** Number of in-flight branches the history can track per thread. */
+    unsigned historyCapacity() const { return maxInFlightBranches; }
+
+    /** Number of branches of a thread predicted and not committed yet. */
+    unsigned numInFlight(ThreadID tid) const { return predHist[tid].size(); }
+
   private:
     struct PredictorHistory
     {
         /**
-         * Makes a predictor history struct that contains any
-         * information needed to update the predictor, BTB, and RAS.
+         * Fill in a predictor history entry with any information needed
+         * to update the predictor, BTB, and RAS. Entries live in a ring
+         * buffer and are reinitialized in place every time they are
+         * reused, so this resets every field a previous branch may have
+         * set. The storage of the RAS checkpoint and of the call PC is kept
+         * around for the next user.
          */
-        PredictorHistory(const InstSeqNum &seq_num, Addr instPC,
-                         bool pred_taken, void *bp_history,
-                         void *indirect_history, ThreadID _tid,
-                         const StaticInstPtr & inst)
-            : seqNum(seq_num), pc(instPC), bpHistory(bp_history),
-              indirectHistory(indirect_history), tid(_tid),
-              predTaken(pred_taken), inst(inst)
-        {}
-
-        PredictorHistory(const PredictorHistory &other) :
-            seqNum(other.seqNum), pc(other.pc), bpHistory(other.bpHistory),
-            indirectHistory(other.indirectHistory), RASIndex(other.RASIndex),
-            tid(other.tid), predTaken(other.predTaken), usedRAS(other.usedRAS),
-            pushedRAS(other.pushedRAS), wasCall(other.wasCall),
-            wasReturn(other.wasReturn), wasIndirect(other.wasIndirect),
-            target(other.target), inst(other.inst)
+        void
+        reset(const InstSeqNum &seq_num, Addr instPC, bool pred_taken,
+              void *bp_history, void *indirect_history, ThreadID _tid,
+              const StaticInstPtr &_inst)
         {
-            set(RASTarget, other.RASTarget);
+            seqNum = seq_num;
+            pc = instPC;
+            bpHistory = bp_history;
+            indirectHistory = indirect_history;
+            tid = _tid;
+            predTaken = pred_taken;
+            usedRAS = false;
+            wasCall = false;
+            wasReturn = false;
+            wasIndirect = false;
+            mispredicted = false;
+            btbMiss = false;
+            target = MaxAddr;
+            fallThrough = MaxAddr;
+            inst = _inst;
         }
 
         bool
@@ -231,10 +345,10 @@ class BPredUnit : public SimObject
         }
 
         /** The sequence number for the predictor history entry. */
-        InstSeqNum seqNum;
+        InstSeqNum seqNum = 0;
 
         /** The PC associated with the sequence number. */
-        Addr pc;
+        Addr pc = 0;
 
         /** Pointer to the history object passed back from the branch
          * predictor.  It is used to update or restore state of the
@@ -244,24 +358,22 @@ class BPredUnit : public SimObject
 
         void *indirectHistory = nullptr;
 
-        /** The RAS target (only valid if a return). */
-        std::unique_ptr<PCStateBase> RASTarget;
+        /** The RAS as it was before this branch pushed or popped. */
+        ReturnAddrStack::Checkpoint RASCheckpoint;
 
-        /** The RAS index of the instruction (only valid if a call). */
-        unsigned RASIndex = 0;
+        /** The PC state of the call, to push it if it was mispredicted
+         *  (only valid if a call). */
+        std::unique_ptr<PCStateBase> callPC;
 
         /** The thread id. */
-        ThreadID tid;
+        ThreadID tid = InvalidThreadID;
 
         /** Whether or not it was predicted taken. */
-        bool predTaken;
+        bool predTaken = false;
 
         /** Whether or not the RAS was used. */
         bool usedRAS = false;
 
-        /* Whether or not the RAS was pushed */
-        bool pushedRAS = false;
-
         /** Whether or not the instruction was a call. */
         bool wasCall = false;
 
@@ -271,20 +383,38 @@ class BPredUnit : public SimObject
         /** Wether this instruction was an indirect branch */
         bool wasIndirect = false;
 
+        /** Whether the branch was squashed as mispredicted. */
+        bool mispredicted = false;
+
+        /** Whether the branch missed in the BTB. */
+        bool btbMiss = false;
+
         /** Target of the branch. First it is predicted, and fixed later
          *  if necessary
          */
         Addr target = MaxAddr;
 
+        /** PC of the next sequential instruction (only valid if traced). */
+        Addr fallThrough = MaxAddr;
+
         /** The branch instrction */
-        const StaticInstPtr inst;
+        StaticInstPtr inst;
     };
 
-    typedef std::deque<PredictorHistory> History;
+    /**
+     * In-flight branches of a thread, oldest at the front and youngest at
+     * the back. Sequence numbers increase monotonically from front to
+     * back, so commit retires from the front and squashes unwind from the
+     * back.
+     */
+    typedef CircularQueue<PredictorHistory> History;
 
     /** Number of the threads for which the branch history is maintained. */
     const unsigned numThreads;
 
+    /** Number of in-flight branches the history can track per thread. */
+    const unsigned maxInFlightBranches;
+
 
     /**
      * The per-thread predictor history. This is used to update the predictor
@@ -296,12 +426,49 @@ class BPredUnit : public SimObject
     /** The BTB. */
     DefaultBTB BTB;
 
+    /**
+     * The optional zero bubble BTB. It is small enough to redirect fetch
+     * in the cycle of the lookup, and is looked up before the main BTB,
+     * which refills it on a hit.
+     */
+    std::unique_ptr<DefaultBTB> L0BTB;
+
+    /**
+     * Looks up a branch in the BTB hierarchy and counts the hits of
+     * each level.
+     * @return The target of the branch, or nullptr on a miss.
+     */
+    const PCStateBase *lookupBTBs(Addr inst_pc, ThreadID tid);
+
+    /** Updates the BTB hierarchy with the target of a branch. */
+    void updateBTBs(Addr inst_pc, const PCStateBase &target, ThreadID tid);
+
     /** The per-thread return address stack. */
     std::vector<ReturnAddrStack> RAS;
 
+    /**
+     * Predicts the target of a branch whose direction was looked up, and
+     * records its history.
+     * @param pred_taken The predicted direction.
+     * @param bp_history The history object of the direction lookup.
+     * @return Whether the branch is predicted taken.
+     */
+    bool predictTarget(const StaticInstPtr &inst, const InstSeqNum &seqNum,
+                       PCStateBase &pc, ThreadID tid, bool pred_taken,
+                       void *bp_history);
+
     /** The indirect target predictor. */
     IndirectPredictor * iPred;
 
+    /** The most mispredicted branches, null if not profiled. */
+    std::unique_ptr<BranchProfile> profile;
+
+    /** The file the profile is written to. */
+    OutputStream *profileStream = nullptr;
+
+    /** Appends the profile to its file, on a stats dump. */
+    void dumpProfile();
+
     struct BPredUnitStats : public statistics::Group
     {
         BPredUnitStats(statistics::Group *parent);
@@ -318,10 +485,20 @@ class BPredUnit : public SimObject
         statistics::Scalar BTBHits;
         /** Stat for the ratio between BTB hits and BTB lookups. */
         statistics::Formula BTBHitRatio;
+        /** Stat for number of BTB hits served by the zero bubble BTB. */
+        statistics::Scalar L0BTBHits;
+        /** Stat for number of BTB hits served by the main BTB. */
+        statistics::Scalar L1BTBHits;
         /** Stat for number of times the RAS is used to get a target. */
         statistics::Scalar RASUsed;
         /** Stat for number of times the RAS is incorrect. */
         statistics::Scalar RASIncorrect;
+        /** Stat for number of pushes that dropped the oldest entry. */
+        statistics::Scalar RASOverflows;
+        /** Stat for number of returns predicted with an empty RAS. */
+        statistics::Scalar RASUnderflows;
+        /** Stat for number of squashed branches that repaired the RAS. */
+        statistics::Scalar RASRepairs;
 
         /** Stat for the number of indirect target lookups.*/
         statistics::Scalar indirectLookups;
@@ -337,6 +514,56 @@ class BPredUnit : public SimObject
     /** Number of bits to shift instructions by for predictor addresses. */
     const unsigned instShiftAmt;
 
+    /**
+     * @{
+     * @name Checkpointing helpers.
+     *
+     * Predictors checkpoint their tables and committed histories so that
+     * a detailed simulation restored from a checkpoint, or switched in
+     * after a fast-forward, starts with a warm predictor. Checkpoints are
+     * taken drained, so there is no speculative state to save. The BTB and
+     * the RAS hold ISA PC states and are not checkpointed.
+     */
+
+    /**
+     * Serialize a table of saturating counters.
+     * @param cp The checkpoint.
+     * @param name Name of the table in the checkpoint.
+     * @param ctrs The table.
+     */
+    static void serializeCounters(CheckpointOut &cp, const std::string &name,
+                                  const SatCounterArray<> &ctrs);
+
+    /**
+     * Restore a table of saturating counters, which must have the same
+     * size as the checkpointed one.
+     * @param cp The checkpoint.
+     * @param name Name of the table in the checkpoint.
+     * @param ctrs The table.
+     */
+    void unserializeCounters(CheckpointIn &cp, const std::string &name,
+                             SatCounterArray<> &ctrs) const;
+
+    /**
+     * Restore a table of plain values, which must have the same size as
+     * the checkpointed one.
+     * @param cp The checkpoint.
+     * @param name Name of the table in the checkpoint.
+     * @param table The table.
+     */
+    template <class T>
+    void
+    unserializeTable(CheckpointIn &cp, const std::string &name,
+                     std::vector<T> &table) const
+    {
+        const size_t size = table.size();
+        arrayParamIn(cp, name, table);
+        fatal_if(table.size() != size, "%s: checkpointed %s has %d entries, "
+                 "expected %d\n", this->name(), name, table.size(), size);
+    }
+
+    /** @} */
+
     /**
      * @{
      * @name PMU Probe points.
@@ -362,6 +589,12 @@ class BPredUnit : public SimObject
     /** Miss-predicted branches */
     probing::PMUUPtr ppMisses;
 
+    /** Committed branches along with their resolved outcome */
+    std::unique_ptr<ProbePointArg<CommittedBranch>> ppCommittedBranches;
+
+    /** Scratch PC used to compute fall through addresses for the probe */
+    std::unique_ptr<PCStateBase> fallThroughPC;
+
     /** @} */
 };
 
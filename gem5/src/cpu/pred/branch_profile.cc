@@ -0,0 +1,120 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/pred/branch_profile.hh"
+
+#include <algorithm>
+
+#include "base/cprintf.hh"
+
+namespace gem5
+{
+
+namespace branch_prediction
+{
+
+BranchProfile::BranchProfile(unsigned num_entries)
+    : numEntries(num_entries)
+{
+    entries.reserve(numEntries);
+    index.reserve(numEntries);
+}
+
+unsigned
+BranchProfile::minEntry() const
+{
+    unsigned min = 0;
+    for (unsigned i = 1; i < entries.size(); ++i) {
+        if (entries[i].mispredicts < entries[min].mispredicts)
+            min = i;
+    }
+    return min;
+}
+
+void
+BranchProfile::record(Addr pc, bool mispredicted, bool btb_miss)
+{
+    auto it = index.find(pc);
+    Entry *entry;
+    if (it != index.end()) {
+        entry = &entries[it->second];
+    } else if (!mispredicted) {
+        // Only mispredictions earn a branch an entry.
+        return;
+    } else if (entries.size() < numEntries) {
+        index.emplace(pc, entries.size());
+        entries.emplace_back();
+        entry = &entries.back();
+        entry->pc = pc;
+    } else {
+        // Replace the least mispredicted branch, the scan is only done
+        // when a new branch mispredicts.
+        unsigned victim = minEntry();
+        entry = &entries[victim];
+        index.erase(entry->pc);
+        index.emplace(pc, victim);
+        *entry = Entry{pc, entry->mispredicts, entry->mispredicts, 0, 0};
+    }
+
+    ++entry->executions;
+    entry->mispredicts += mispredicted;
+    entry->btbMisses += btb_miss;
+}
+
+std::vector<BranchProfile::Entry>
+BranchProfile::sorted() const
+{
+    std::vector<Entry> result(entries);
+    std::sort(result.begin(), result.end(),
+              [](const Entry &a, const Entry &b)
+              {
+                  if (a.mispredicts != b.mispredicts)
+                      return a.mispredicts > b.mispredicts;
+                  return a.pc < b.pc;
+              });
+    return result;
+}
+
+void
+BranchProfile::clear()
+{
+    entries.clear();
+    index.clear();
+}
+
+void
+BranchProfile::dump(std::ostream &os) const
+{
+    ccprintf(os, "%-18s %12s %12s %12s %12s\n", "pc", "mispredicts",
+             "error", "executions", "btb_misses");
+    for (const auto &entry : sorted()) {
+        ccprintf(os, "%#-18x %12d %12d %12d %12d\n", entry.pc,
+                 entry.mispredicts, entry.error, entry.executions,
+                 entry.btbMisses);
+    }
+}
+
+} // namespace branch_prediction
+} // namespace gem5
@@ -0,0 +1,106 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_PRED_BRANCH_PROFILE_HH__
+#define __CPU_PRED_BRANCH_PROFILE_HH__
+
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+#include "base/types.hh"
+
+namespace gem5
+{
+
+namespace branch_prediction
+{
+
+/**
+ * Profile of the branches that mispredict the most, kept in a fixed number
+ * of entries with the space-saving heavy hitter algorithm.
+ *
+ * The profile counts the mispredictions of committed branches. A branch
+ * that mispredicts and is not tracked replaces the entry with the fewest
+ * mispredictions, and inherits its count. The count of an entry thus
+ * overestimates the mispredictions of its branch by at most the inherited
+ * error, and any branch that mispredicts more often than one in the number
+ * of entries is guaranteed to be tracked. Executions and BTB misses are only
+ * counted from the time a branch is tracked.
+ */
+class BranchProfile
+{
+  public:
+    struct Entry
+    {
+        /** The PC of the branch. */
+        Addr pc = 0;
+        /** Number of mispredictions, including the inherited error. */
+        uint64_t mispredicts = 0;
+        /** Count inherited from the entry that was replaced. */
+        uint64_t error = 0;
+        /** Number of times the branch committed since it is tracked. */
+        uint64_t executions = 0;
+        /** Number of BTB misses since the branch is tracked. */
+        uint64_t btbMisses = 0;
+    };
+
+  private:
+    const unsigned numEntries;
+
+    std::vector<Entry> entries;
+
+    /** Map from the PC of a tracked branch to its entry. */
+    std::unordered_map<Addr, unsigned> index;
+
+    /** Index of the entry with the fewest mispredictions. */
+    unsigned minEntry() const;
+
+  public:
+    /** @param num_entries Number of branches that are tracked. */
+    BranchProfile(unsigned num_entries);
+
+    /**
+     * Count a committed branch.
+     * @param pc The PC of the branch.
+     * @param mispredicted Whether the branch was mispredicted.
+     * @param btb_miss Whether the branch missed in the BTB.
+     */
+    void record(Addr pc, bool mispredicted, bool btb_miss);
+
+    /** The tracked branches, most mispredicted first. */
+    std::vector<Entry> sorted() const;
+
+    /** Forget all the branches. */
+    void clear();
+
+    /** Write the tracked branches as a table. */
+    void dump(std::ostream &os) const;
+};
+
+} // namespace branch_prediction
+} // namespace gem5
+
+#endif // __CPU_PRED_BRANCH_PROFILE_HH__
@@ -0,0 +1,112 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "cpu/pred/branch_profile.hh"
+
+using namespace gem5;
+using namespace gem5::branch_prediction;
+
+TEST(BranchProfileTest, OnlyMispredictionsAllocate)
+{
+    BranchProfile profile(2);
+    profile.record(0x100, false, true);
+    EXPECT_TRUE(profile.sorted().empty());
+
+    profile.record(0x100, true, false);
+    profile.record(0x100, false, true);
+    auto entries = profile.sorted();
+    ASSERT_EQ(1, entries.size());
+    EXPECT_EQ(0x100, entries[0].pc);
+    EXPECT_EQ(1, entries[0].mispredicts);
+    EXPECT_EQ(0, entries[0].error);
+    EXPECT_EQ(2, entries[0].executions);
+    EXPECT_EQ(1, entries[0].btbMisses);
+}
+
+TEST(BranchProfileTest, SortedByMispredictions)
+{
+    BranchProfile profile(4);
+    for (int i = 0; i < 3; i++)
+        profile.record(0x200, true, false);
+    profile.record(0x100, true, false);
+    for (int i = 0; i < 2; i++)
+        profile.record(0x300, true, false);
+
+    auto entries = profile.sorted();
+    ASSERT_EQ(3, entries.size());
+    EXPECT_EQ(0x200, entries[0].pc);
+    EXPECT_EQ(0x300, entries[1].pc);
+    EXPECT_EQ(0x100, entries[2].pc);
+}
+
+TEST(BranchProfileTest, ReplacesLeastMispredicted)
+{
+    BranchProfile profile(2);
+    for (int i = 0; i < 5; i++)
+        profile.record(0x100, true, false);
+    profile.record(0x200, true, false);
+    profile.record(0x300, true, false);
+
+    auto entries = profile.sorted();
+    ASSERT_EQ(2, entries.size());
+    EXPECT_EQ(0x100, entries[0].pc);
+    EXPECT_EQ(5, entries[0].mispredicts);
+    EXPECT_EQ(0x300, entries[1].pc);
+    EXPECT_EQ(2, entries[1].mispredicts);
+    EXPECT_EQ(1, entries[1].error);
+    EXPECT_EQ(1, entries[1].executions);
+}
+
+/** A branch that mispredicts often enough always ends up tracked. */
+TEST(BranchProfileTest, HeavyHitterIsTracked)
+{
+    BranchProfile profile(4);
+    for (int i = 0; i < 1000; i++) {
+        profile.record(0x1000 + 4 * i, true, false);
+        if (i % 3 == 0)
+            profile.record(0x40, true, false);
+    }
+
+    auto entries = profile.sorted();
+    ASSERT_EQ(4, entries.size());
+    EXPECT_EQ(0x40, entries[0].pc);
+    EXPECT_GE(entries[0].mispredicts, 334);
+}
+
+TEST(BranchProfileTest, Clear)
+{
+    BranchProfile profile(2);
+    profile.record(0x100, true, false);
+    profile.clear();
+    EXPECT_TRUE(profile.sorted().empty());
+
+    std::ostringstream os;
+    profile.dump(os);
+    EXPECT_EQ(std::string::npos, os.str().find("0x"));
+}
@@ -0,0 +1,135 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/pred/branch_trace.hh"
+
+#include "base/output.hh"
+#include "params/BranchTraceProbe.hh"
+#include "proto/branch.pb.h"
+#include "sim/sim_exit.hh"
+
+namespace gem5
+{
+
+namespace branch_prediction
+{
+
+uint32_t
+branchTraceFlags(const StaticInst &inst)
+{
+    uint32_t flags = 0;
+    if (inst.isCondCtrl())
+        flags |= BranchConditional;
+    if (inst.isCall())
+        flags |= BranchCall;
+    if (inst.isReturn())
+        flags |= BranchReturn;
+    if (inst.isIndirectCtrl())
+        flags |= BranchIndirect;
+    return flags;
+}
+
+BranchTraceProbe::BranchTraceProbe(const BranchTraceProbeParams &p)
+    : ProbeListenerObject(p),
+      traceStream(nullptr),
+      withUncond(p.with_uncond)
+{
+    std::string filename;
+    if (p.trace_file != "") {
+        // If the trace file is not specified as an absolute path,
+        // append the current simulation output directory
+        filename = simout.resolve(p.trace_file);
+
+        const std::string suffix = ".gz";
+        // If trace_compress has been set, check the suffix. Append
+        // accordingly.
+        if (p.trace_compress &&
+            filename.compare(filename.size() - suffix.size(), suffix.size(),
+                             suffix) != 0)
+            filename = filename + suffix;
+    } else {
+        // Generate a filename from the name of the SimObject. Append .trc
+        // and .gz if we want compression enabled.
+        filename = simout.resolve(name() + ".trc" +
+                                  (p.trace_compress ? ".gz" : ""));
+    }
+
+    traceStream = new ProtoOutputStream(filename);
+
+    // Register a callback to compensate for the destructor not
+    // being called. The callback forces the stream to flush and
+    // closes the output file.
+    registerExitCallback([this]() { closeStreams(); });
+}
+
+void
+BranchTraceProbe::regProbeListeners()
+{
+    typedef ProbeListenerArg<BranchTraceProbe, BPredUnit::CommittedBranch>
+        CommittedBranchListener;
+    listeners.push_back(new CommittedBranchListener(this,
+                "CommittedBranches", &BranchTraceProbe::traceBranch));
+}
+
+void
+BranchTraceProbe::startup()
+{
+    ProtoMessage::BranchHeader header_msg;
+    header_msg.set_obj_id(name());
+    traceStream->write(header_msg);
+}
+
+void
+BranchTraceProbe::closeStreams()
+{
+    if (traceStream != nullptr) {
+        delete traceStream;
+        traceStream = nullptr;
+    }
+}
+
+void
+BranchTraceProbe::traceBranch(const BPredUnit::CommittedBranch &branch)
+{
+    const uint32_t flags = branchTraceFlags(*branch.inst);
+    if (!withUncond && !(flags & BranchConditional))
+        return;
+
+    ProtoMessage::Branch branch_msg;
+    branch_msg.set_pc(branch.pc);
+    branch_msg.set_target(branch.target);
+    branch_msg.set_taken(branch.taken);
+    if (branch.fallThrough != MaxAddr)
+        branch_msg.set_fall_through(branch.fallThrough);
+    if (flags)
+        branch_msg.set_flags(flags);
+    if (branch.tid)
+        branch_msg.set_tid(branch.tid);
+
+    traceStream->write(branch_msg);
+}
+
+} // namespace branch_prediction
+} // namespace gem5
@@ -0,0 +1,209 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/pred/branch_trace_replay.hh"
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/Branch.hh"
+#include "params/BranchTraceReplay.hh"
+#include "proto/branch.pb.h"
+#include "sim/sim_exit.hh"
+
+namespace gem5
+{
+
+namespace branch_prediction
+{
+
+namespace
+{
+
+/**
+ * Stand-in for the control instruction of a trace record. It only
+ * carries the flags the predictors look at and knows how to step a
+ * ReplayPCState.
+ */
+class ReplayBranchInst : public StaticInst
+{
+  private:
+    typedef GenericISA::SimplePCState<1> ReplayPCState;
+
+  public:
+    ReplayBranchInst(uint32_t flags)
+        : StaticInst("replay_branch", No_OpClass)
+    {
+        setFlag(IsControl);
+        setFlag(flags & BranchConditional ? IsCondControl : IsUncondControl);
+        setFlag(flags & BranchIndirect ? IsIndirectControl : IsDirectControl);
+        if (flags & BranchCall)
+            setFlag(IsCall);
+        if (flags & BranchReturn)
+            setFlag(IsReturn);
+    }
+
+    Fault
+    execute(ExecContext *xc, Trace::InstRecord *traceData) const override
+    {
+        panic("Replayed branches are never executed.\n");
+    }
+
+    void
+    advancePC(PCStateBase &pc_state) const override
+    {
+        pc_state.as<ReplayPCState>().advance();
+    }
+
+    std::unique_ptr<PCStateBase>
+    buildRetPC(const PCStateBase &cur_pc,
+               const PCStateBase &call_pc) const override
+    {
+        // The recorded call carried the address of the instruction after
+        // it as its next PC.
+        std::unique_ptr<PCStateBase> ret_pc(call_pc.clone());
+        ret_pc->advance();
+        return ret_pc;
+    }
+
+  protected:
+    std::string
+    generateDisassembly(Addr pc,
+                        const loader::SymbolTable *symtab) const override
+    {
+        return mnemonic;
+    }
+};
+
+} // anonymous namespace
+
+BranchTraceReplay::BranchTraceReplay(const BranchTraceReplayParams &p)
+    : SimObject(p),
+      predictors(p.predictors),
+      batchSize(p.batch_size),
+      numThreads(p.numThreads),
+      trace(p.trace_file),
+      replayEvent([this]{ processReplay(); }, name())
+{
+    fatal_if(predictors.empty(), "%s: no branch predictor to evaluate\n",
+             name());
+    fatal_if(batchSize == 0, "%s: batch_size must be non-zero\n", name());
+
+    for (uint32_t flags = 0; flags <= BranchFlagMask; flags++)
+        branchInsts[flags] = new ReplayBranchInst(flags);
+
+    batch.reserve(batchSize);
+
+    ProtoMessage::BranchHeader header_msg;
+    fatal_if(!trace.read(header_msg),
+             "%s: could not read the header of trace %s\n", name(),
+             p.trace_file);
+    inform("%s: replaying branch trace of %s\n", name(), header_msg.obj_id());
+}
+
+void
+BranchTraceReplay::startup()
+{
+    schedule(replayEvent, curTick());
+}
+
+bool
+BranchTraceReplay::readBatch()
+{
+    batch.clear();
+
+    ProtoMessage::Branch branch_msg;
+    while (batch.size() < batchSize && trace.read(branch_msg)) {
+        Record rec;
+        rec.pc = branch_msg.pc();
+        rec.target = branch_msg.target();
+        rec.taken = branch_msg.taken();
+        rec.flags = branch_msg.flags() & BranchFlagMask;
+        rec.tid = branch_msg.tid();
+        // Traces without the fall through can still be replayed, but
+        // returns can then not be predicted by the RAS.
+        rec.fallThrough = branch_msg.has_fall_through() ?
+            branch_msg.fall_through() : rec.pc + 1;
+
+        fatal_if(rec.tid >= numThreads, "%s: trace record for thread %i, "
+                 "but only %u threads configured\n", name(), rec.tid,
+                 numThreads);
+        batch.push_back(rec);
+    }
+
+    return batch.size() == batchSize;
+}
+
+void
+BranchTraceReplay::replayBatch(BPredUnit &bp)
+{
+    InstSeqNum seq_num = batchSeqNum;
+    for (const auto &rec : batch) {
+        const StaticInstPtr &inst = branchInsts[rec.flags];
+
+        // Fetch: predict direction and target from the branch PC.
+        pcState.set(rec.pc);
+        pcState.npc(rec.fallThrough);
+        bp.predict(inst, seq_num, pcState, rec.tid);
+
+        // Execute: a wrong direction or target squashes the branch the
+        // same way the CPU would.
+        const Addr actual = rec.taken ? rec.target : rec.fallThrough;
+        if (pcState.instAddr() != actual) {
+            corrTarget.set(actual);
+            bp.squash(seq_num, corrTarget, rec.taken, rec.tid);
+        }
+
+        // Commit: train the predictor with the resolved outcome.
+        bp.update(seq_num, rec.tid);
+        ++seq_num;
+    }
+}
+
+void
+BranchTraceReplay::processReplay()
+{
+    const bool more = readBatch();
+
+    // Walk the whole batch through one predictor at a time, so that its
+    // tables stay hot in the host caches, rather than interleaving all
+    // the predictors on every record.
+    for (auto bp : predictors)
+        replayBatch(*bp);
+
+    batchSeqNum += batch.size();
+    replayed += batch.size();
+
+    DPRINTF(Branch, "%s: replayed %llu branches\n", name(), replayed);
+
+    if (more) {
+        schedule(replayEvent, curTick());
+    } else {
+        exitSimLoop(csprintf("end of branch trace, %llu branches replayed",
+                             replayed));
+    }
+}
+
+} // namespace branch_prediction
+} // namespace gem5
@@ -0,0 +1,131 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Trace driven branch predictor evaluation. A BranchTraceReplay object
+ * reads a committed branch stream recorded by a BranchTraceProbe and
+ * feeds it to any number of branch predictors, without a CPU model, so
+ * that predictor configurations can be compared at a fraction of the
+ * cost of a detailed simulation. Every predictor goes through the same
+ * predict/squash/update sequence the CPU would drive at fetch, execute
+ * and commit, so its regular statistics (condIncorrect, BTBHits, ...)
+ * are directly comparable to the ones of a full run.
+ */
+
+#ifndef __CPU_PRED_BRANCH_TRACE_REPLAY_HH__
+#define __CPU_PRED_BRANCH_TRACE_REPLAY_HH__
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "arch/generic/pcstate.hh"
+#include "base/types.hh"
+#include "cpu/inst_seq.hh"
+#include "cpu/pred/bpred_unit.hh"
+#include "cpu/pred/branch_trace.hh"
+#include "cpu/static_inst.hh"
+#include "proto/protoio.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_object.hh"
+
+namespace gem5
+{
+
+struct BranchTraceReplayParams;
+
+namespace branch_prediction
+{
+
+class BranchTraceReplay : public SimObject
+{
+  public:
+    BranchTraceReplay(const BranchTraceReplayParams &params);
+
+    void startup() override;
+
+  protected:
+    /** PC state of the replayed branches, one address unit per step. */
+    typedef GenericISA::SimplePCState<1> ReplayPCState;
+
+    /** A decoded trace record. */
+    struct Record
+    {
+        Addr pc;
+        Addr target;
+        Addr fallThrough;
+        ThreadID tid;
+        uint32_t flags;
+        bool taken;
+    };
+
+    /**
+     * Read the next batch of records from the trace.
+     * @return False if the end of the trace was reached.
+     */
+    bool readBatch();
+
+    /** Replay the current batch against one predictor. */
+    void replayBatch(BPredUnit &bp);
+
+    /** Process one batch and schedule the next one. */
+    void processReplay();
+
+    /** The predictors under evaluation. */
+    const std::vector<BPredUnit *> predictors;
+
+    /** Number of records replayed per event. */
+    const unsigned batchSize;
+
+    /** Number of threads the predictors are configured for. */
+    const unsigned numThreads;
+
+    /** Input trace */
+    ProtoInputStream trace;
+
+    /** The records of the batch being replayed. */
+    std::vector<Record> batch;
+
+    /** Sequence number given to the first record of the batch. */
+    InstSeqNum batchSeqNum = 1;
+
+    /** Total number of records replayed so far. */
+    uint64_t replayed = 0;
+
+    /** One synthetic control instruction per combination of flags. */
+    std::array<StaticInstPtr, BranchFlagMask + 1> branchInsts;
+
+    /** Scratch PC states handed to the predictors. */
+    ReplayPCState pcState;
+    ReplayPCState corrTarget;
+
+    EventFunctionWrapper replayEvent;
+};
+
+} // namespace branch_prediction
+} // namespace gem5
+
+#endif // __CPU_PRED_BRANCH_TRACE_REPLAY_HH__
@@ -41,8 +41,12 @@ namespace branch_prediction
 DefaultBTB::DefaultBTB(unsigned _numEntries,
                        unsigned _tagBits,
                        unsigned _instShiftAmt,
-                       unsigned _num_threads)
+                       unsigned _num_threads,
+                       unsigned _numWays,
+                       replacement_policy::Base *_replPolicy)
     : numEntries(_numEntries),
+      numWays(_numWays),
+      replPolicy(_replPolicy),
       tagBits(_tagBits),
       instShiftAmt(_instShiftAmt),
       log2NumThreads(floorLog2(_num_threads))
@@ -53,17 +57,30 @@ DefaultBTB::DefaultBTB(unsigned _numEntries,
         fatal("BTB entries is not a power of 2!");
     }
 
+    fatal_if(numWays == 0 || !isPowerOf2(numWays) || numWays > numEntries,
+             "BTB associativity must be a power of 2 no larger than the "
+             "number of entries!");
+    fatal_if(numWays > 1 && !replPolicy,
+             "A set associative BTB needs a replacement policy!");
+
+    numSets = numEntries / numWays;
+
     btb.resize(numEntries);
+    candidates.resize(numEntries);
 
     for (unsigned i = 0; i < numEntries; ++i) {
         btb[i].valid = false;
+        btb[i].setPosition(i / numWays, i % numWays);
+        if (replPolicy)
+            btb[i].replacementData = replPolicy->instantiateEntry();
+        candidates[i] = &btb[i];
     }
 
-    idxMask = numEntries - 1;
+    idxMask = numSets - 1;
 
     tagMask = (1 << tagBits) - 1;
 
-    tagShiftAmt = instShiftAmt + floorLog2(numEntries);
+    tagShiftAmt = instShiftAmt + floorLog2(numSets);
 }
 
 void
@@ -71,6 +88,8 @@ DefaultBTB::reset()
 {
     for (unsigned i = 0; i < numEntries; ++i) {
         btb[i].valid = false;
+        if (replPolicy)
+            replPolicy->invalidate(btb[i].replacementData);
     }
 }
 
@@ -78,10 +97,12 @@ inline
 unsigned
 DefaultBTB::getIndex(Addr instPC, ThreadID tid)
 {
-    // Need to shift PC over by the word offset.
-    return ((instPC >> instShiftAmt)
-            ^ (tid << (tagShiftAmt - instShiftAmt - log2NumThreads)))
-            & idxMask;
+    // Need to shift PC over by the word offset. The thread id is hashed
+    // into the top bits of the index, when there are enough of them.
+    unsigned idx_bits = tagShiftAmt - instShiftAmt;
+    Addr tid_hash = idx_bits >= log2NumThreads ?
+        tid << (idx_bits - log2NumThreads) : 0;
+    return ((instPC >> instShiftAmt) ^ tid_hash) & idxMask;
 }
 
 inline
@@ -91,56 +112,92 @@ DefaultBTB::getTag(Addr instPC)
     return (instPC >> tagShiftAmt) & tagMask;
 }
 
-bool
-DefaultBTB::valid(Addr instPC, ThreadID tid)
+DefaultBTB::BTBEntry *
+DefaultBTB::findEntry(Addr instPC, ThreadID tid)
 {
     unsigned btb_idx = getIndex(instPC, tid);
 
     Addr inst_tag = getTag(instPC);
 
-    assert(btb_idx < numEntries);
+    assert(btb_idx < numSets);
 
-    if (btb[btb_idx].valid
-        && inst_tag == btb[btb_idx].tag
-        && btb[btb_idx].tid == tid) {
-        return true;
-    } else {
-        return false;
+    BTBEntry *ways = &btb[btb_idx * numWays];
+    for (unsigned way = 0; way < numWays; ++way) {
+        if (ways[way].valid
+            && inst_tag == ways[way].tag
+            && ways[way].tid == tid) {
+            return &ways[way];
+        }
     }
+    return nullptr;
+}
+
+bool
+DefaultBTB::valid(Addr instPC, ThreadID tid)
+{
+    return findEntry(instPC, tid) != nullptr;
 }
 
-// @todo Create some sort of return struct that has both whether or not the
-// address is valid, and also the address.  For now will just use addr = 0 to
-// represent invalid entry.
 const PCStateBase *
 DefaultBTB::lookup(Addr inst_pc, ThreadID tid)
 {
-    unsigned btb_idx = getIndex(inst_pc, tid);
+    BTBEntry *entry = findEntry(inst_pc, tid);
+    if (!entry)
+        return nullptr;
 
-    Addr inst_tag = getTag(inst_pc);
+    if (replPolicy)
+        replPolicy->touch(entry->replacementData);
+    return entry->target.get();
+}
 
-    assert(btb_idx < numEntries);
+bool
+DefaultBTB::updateIfPresent(Addr inst_pc, const PCStateBase &target,
+                            ThreadID tid)
+{
+    BTBEntry *entry = findEntry(inst_pc, tid);
+    if (!entry)
+        return false;
 
-    if (btb[btb_idx].valid
-        && inst_tag == btb[btb_idx].tag
-        && btb[btb_idx].tid == tid) {
-        return btb[btb_idx].target.get();
-    } else {
-        return nullptr;
-    }
+    set(entry->target, target);
+    if (replPolicy)
+        replPolicy->touch(entry->replacementData);
+    return true;
 }
 
 void
 DefaultBTB::update(Addr inst_pc, const PCStateBase &target, ThreadID tid)
 {
+    if (updateIfPresent(inst_pc, target, tid))
+        return;
+
     unsigned btb_idx = getIndex(inst_pc, tid);
 
-    assert(btb_idx < numEntries);
+    assert(btb_idx < numSets);
+
+    // fill an invalid way if there is one, or evict the victim of the
+    // replacement policy
+    BTBEntry *entry = nullptr;
+    BTBEntry *ways = &btb[btb_idx * numWays];
+    for (unsigned way = 0; way < numWays && !entry; ++way) {
+        if (!ways[way].valid)
+            entry = &ways[way];
+    }
+    if (!entry) {
+        if (numWays == 1) {
+            entry = ways;
+        } else {
+            entry = static_cast<BTBEntry *>(replPolicy->getVictim(
+                ReplacementCandidates(&candidates[btb_idx * numWays],
+                                      numWays)));
+        }
+    }
 
-    btb[btb_idx].tid = tid;
-    btb[btb_idx].valid = true;
-    set(btb[btb_idx].target, target);
-    btb[btb_idx].tag = getTag(inst_pc);
+    entry->tid = tid;
+    entry->valid = true;
+    set(entry->target, target);
+    entry->tag = getTag(inst_pc);
+    if (replPolicy)
+        replPolicy->reset(entry->replacementData);
 }
 
 } // namespace branch_prediction
@@ -29,10 +29,15 @@
 #ifndef __CPU_PRED_BTB_HH__
 #define __CPU_PRED_BTB_HH__
 
+#include <memory>
+#include <vector>
+
 #include "arch/generic/pcstate.hh"
 #include "base/logging.hh"
 #include "base/types.hh"
 #include "config/the_isa.hh"
+#include "mem/cache/replacement_policies/base.hh"
+#include "mem/cache/replacement_policies/replaceable_entry.hh"
 
 namespace gem5
 {
@@ -40,10 +45,16 @@ namespace gem5
 namespace branch_prediction
 {
 
+/**
+ * A set associative BTB. The entries keep partial tags of tagBits bits, so
+ * different branches may alias, and the victim of a set is chosen by a
+ * replacement policy. A single way makes it direct mapped, and a single
+ * set fully associative.
+ */
 class DefaultBTB
 {
   private:
-    struct BTBEntry
+    struct BTBEntry : public ReplaceableEntry
     {
         /** The entry's tag. */
         Addr tag = 0;
@@ -64,16 +75,21 @@ class DefaultBTB
      *  @param numEntries Number of entries for the BTB.
      *  @param tagBits Number of bits for each tag in the BTB.
      *  @param instShiftAmt Offset amount for instructions to ignore alignment.
+     *  @param numWays Associativity of the BTB.
+     *  @param replPolicy Replacement policy, only needed with several ways.
      */
     DefaultBTB(unsigned numEntries, unsigned tagBits,
-               unsigned instShiftAmt, unsigned numThreads);
+               unsigned instShiftAmt, unsigned numThreads,
+               unsigned numWays = 1,
+               replacement_policy::Base *replPolicy = nullptr);
 
     void reset();
 
-    /** Looks up an address in the BTB. Must call valid() first on the address.
+    /** Looks up an address in the BTB.
      *  @param inst_PC The address of the branch to look up.
      *  @param tid The thread id.
-     *  @return Returns the target of the branch.
+     *  @return Returns the target of the branch, or nullptr if the branch
+     *  is not in the BTB.
      */
     const PCStateBase *lookup(Addr instPC, ThreadID tid);
 
@@ -91,7 +107,17 @@ class DefaultBTB
      */
     void update(Addr inst_pc, const PCStateBase &target_pc, ThreadID tid);
 
+    /** Updates the target of a branch only if it is already in the BTB.
+     *  @return Whether the branch was in the BTB.
+     */
+    bool updateIfPresent(Addr inst_pc, const PCStateBase &target_pc,
+                         ThreadID tid);
+
   private:
+    /** Returns the entry of a branch, or nullptr if it is not in the BTB.
+     */
+    BTBEntry *findEntry(Addr instPC, ThreadID tid);
+
     /** Returns the index into the BTB, based on the branch's PC.
      *  @param inst_PC The branch to look up.
      *  @return Returns the index into the BTB.
@@ -104,12 +130,24 @@ class DefaultBTB
      */
     inline Addr getTag(Addr instPC);
 
-    /** The actual BTB. */
+    /** The actual BTB, set by set. */
     std::vector<BTBEntry> btb;
 
+    /** The entries of btb, as replacement candidates of their set. */
+    std::vector<ReplaceableEntry *> candidates;
+
     /** The number of entries in the BTB. */
     unsigned numEntries;
 
+    /** The associativity of the BTB. */
+    unsigned numWays;
+
+    /** The number of sets of the BTB. */
+    unsigned numSets;
+
+    /** Replacement policy choosing the victim of a set. */
+    replacement_policy::Base *replPolicy;
+
     /** The index mask. */
     unsigned idxMask;
 
@@ -0,0 +1,260 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/pred/hashed_perceptron.hh"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "base/bitfield.hh"
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+namespace branch_prediction
+{
+
+namespace
+{
+
+/** Fold the low n bits of a value into an index of idx_bits bits. */
+uint64_t
+foldBits(uint64_t value, unsigned n, unsigned idx_bits)
+{
+    uint64_t folded = 0;
+    value &= mask(n);
+    for (unsigned pos = 0; pos < n; pos += idx_bits)
+        folded ^= value >> pos;
+    return folded & mask(idx_bits);
+}
+
+} // anonymous namespace
+
+HashedPerceptron::HashedPerceptron(const HashedPerceptronParams &params)
+    : BPredUnit(params),
+      numTables(params.historyLengths.size()),
+      logTableEntries(params.logTableEntries),
+      historyLengths(params.historyLengths),
+      maxWeight((1 << (params.weightBits - 1)) - 1),
+      minWeight(-(1 << (params.weightBits - 1))),
+      pathBits(params.pathBits),
+      weights(numTables << logTableEntries, 0),
+      theta(params.theta >= 0 ? params.theta :
+            static_cast<int>(2.14 * (numTables + 1) + 20.58)),
+      adaptiveTheta(params.adaptiveTheta),
+      threadHistory(params.numThreads),
+      historyPool(params.numThreads)
+{
+    fatal_if(numTables == 0 || numTables > maxTables,
+             "%s: between 1 and %d weight tables are supported\n", name(),
+             maxTables);
+    fatal_if(logTableEntries == 0 || logTableEntries > 24,
+             "%s: invalid number of table entries\n", name());
+    fatal_if(params.weightBits < 2 || params.weightBits > 8,
+             "%s: weights must have between 2 and 8 bits\n", name());
+    fatal_if(pathBits == 0 || pathBits > 8,
+             "%s: between 1 and 8 path bits per branch are supported\n",
+             name());
+    for (unsigned t = 1; t < numTables; ++t) {
+        fatal_if(historyLengths[t] < historyLengths[t - 1],
+                 "%s: history lengths must not decrease\n", name());
+    }
+    fatal_if(historyLengths.back() > maxHistoryLength,
+             "%s: history lengths are limited to %d\n", name(),
+             maxHistoryLength);
+}
+
+unsigned
+HashedPerceptron::foldHistory(const GlobalHistory &global, unsigned start,
+                              unsigned end) const
+{
+    uint64_t folded = 0;
+    for (unsigned pos = start; pos < end; pos += logTableEntries) {
+        const unsigned n = std::min(logTableEntries, end - pos);
+        const unsigned word = pos / 64;
+        const unsigned offset = pos % 64;
+        uint64_t chunk = global[word] >> offset;
+        if (offset + n > 64)
+            chunk |= global[word + 1] << (64 - offset);
+        folded ^= chunk & mask(n);
+    }
+    return folded;
+}
+
+int
+HashedPerceptron::computeSum(Addr branch_addr, const ThreadHistory &hist,
+                             BPHistory &record) const
+{
+    const Addr pc = branch_addr >> instShiftAmt;
+    const uint64_t pc_hash = pc ^ (pc >> logTableEntries);
+    const unsigned path_length = 64 / pathBits;
+
+    unsigned start = 0;
+    for (unsigned t = 0; t < numTables; ++t) {
+        const unsigned end = historyLengths[t];
+        uint64_t hash = pc_hash ^ foldHistory(hist.global, start, end);
+        if (start < path_length) {
+            const unsigned path_end = std::min(end, path_length);
+            hash ^= foldBits(hist.path >> (start * pathBits),
+                             (path_end - start) * pathBits,
+                             logTableEntries);
+        }
+        record.indices[t] =
+            (t << logTableEntries) | (hash & mask(logTableEntries));
+        start = end;
+    }
+
+    // Kept apart from the hashing so that it vectorizes.
+    int sum = 0;
+    for (unsigned t = 0; t < numTables; ++t)
+        sum += weights[record.indices[t]];
+    return sum;
+}
+
+void
+HashedPerceptron::updateHistories(ThreadID tid, Addr branch_addr, bool taken)
+{
+    ThreadHistory &hist = threadHistory[tid];
+    for (size_t w = hist.global.size() - 1; w > 0; --w)
+        hist.global[w] = (hist.global[w] << 1) | (hist.global[w - 1] >> 63);
+    hist.global[0] = (hist.global[0] << 1) | taken;
+
+    hist.path = (hist.path << pathBits) |
+        ((branch_addr >> instShiftAmt) & mask(pathBits));
+}
+
+bool
+HashedPerceptron::lookup(ThreadID tid, Addr branch_addr, void * &bp_history)
+{
+    BPHistory *history = historyPool.acquire(tid);
+    history->hist = threadHistory[tid];
+    history->conditional = true;
+    history->sum = computeSum(branch_addr, history->hist, *history);
+    bp_history = static_cast<void *>(history);
+
+    const bool prediction = history->sum >= 0;
+    updateHistories(tid, branch_addr, prediction);
+    return prediction;
+}
+
+void
+HashedPerceptron::uncondBranch(ThreadID tid, Addr pc, void * &bp_history)
+{
+    BPHistory *history = historyPool.acquire(tid);
+    history->hist = threadHistory[tid];
+    history->conditional = false;
+    bp_history = static_cast<void *>(history);
+
+    updateHistories(tid, pc, true);
+}
+
+void
+HashedPerceptron::btbUpdate(ThreadID tid, Addr branch_addr,
+                            void * &bp_history)
+{
+    // The branch was predicted taken but has no target, it falls through.
+    threadHistory[tid].global[0] &= ~1ULL;
+}
+
+void
+HashedPerceptron::update(ThreadID tid, Addr branch_addr, bool taken,
+                         void *bp_history, bool squashed,
+                         const StaticInstPtr & inst, Addr corrTarget)
+{
+    assert(bp_history);
+
+    BPHistory *history = static_cast<BPHistory *>(bp_history);
+
+    // Redo the history update of a mispredicted branch with its actual
+    // outcome. The weights are only trained at commit.
+    if (squashed) {
+        threadHistory[tid] = history->hist;
+        updateHistories(tid, branch_addr, taken);
+        return;
+    }
+
+    if (history->conditional) {
+        const bool mispredicted = (history->sum >= 0) != taken;
+        const bool low_confidence = std::abs(history->sum) <= theta;
+
+        if (mispredicted || low_confidence) {
+            for (unsigned t = 0; t < numTables; ++t) {
+                int8_t &weight = weights[history->indices[t]];
+                if (taken && weight < maxWeight)
+                    ++weight;
+                else if (!taken && weight > minWeight)
+                    --weight;
+            }
+        }
+
+        // Raise theta when mispredictions dominate, and lower it when
+        // correct predictions keep training the weights.
+        if (adaptiveTheta) {
+            if (mispredicted) {
+                if (++thetaCounter >= 64) {
+                    ++theta;
+                    thetaCounter = 0;
+                }
+            } else if (low_confidence) {
+                if (--thetaCounter <= -64) {
+                    theta = std::max(theta - 1, 0);
+                    thetaCounter = 0;
+                }
+            }
+        }
+    }
+
+    historyPool.release(tid, history);
+}
+
+void
+HashedPerceptron::squash(ThreadID tid, void *bp_history)
+{
+    BPHistory *history = static_cast<BPHistory *>(bp_history);
+
+    threadHistory[tid] = history->hist;
+
+    historyPool.release(tid, history);
+}
+
+void
+HashedPerceptron::serialize(CheckpointOut &cp) const
+{
+    SERIALIZE_CONTAINER(weights);
+    SERIALIZE_SCALAR(theta);
+    SERIALIZE_SCALAR(thetaCounter);
+}
+
+void
+HashedPerceptron::unserialize(CheckpointIn &cp)
+{
+    unserializeTable(cp, "weights", weights);
+    UNSERIALIZE_SCALAR(theta);
+    UNSERIALIZE_SCALAR(thetaCounter);
+}
+
+} // namespace branch_prediction
+} // namespace gem5
@@ -0,0 +1,153 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_PRED_HASHED_PERCEPTRON_HH__
+#define __CPU_PRED_HASHED_PERCEPTRON_HH__
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "base/types.hh"
+#include "cpu/pred/bpred_unit.hh"
+#include "cpu/pred/history_pool.hh"
+#include "params/HashedPerceptron.hh"
+
+namespace gem5
+{
+
+namespace branch_prediction
+{
+
+/**
+ * A hashed perceptron predictor. The global history is cut into segments
+ * of increasing length, one per weight table. Each table is indexed by a
+ * hash of the branch address, its history segment and the matching part
+ * of the path history, and the prediction is the sign of the sum of the
+ * selected weights. The first table, with an empty segment, is the bias.
+ *
+ * The weights of all the tables are kept in a single contiguous array of
+ * bytes, so that summing them is a short loop the host compiler can
+ * vectorize. The global and path histories are updated speculatively and
+ * restored from the history record on a squash.
+ */
+class HashedPerceptron : public BPredUnit
+{
+  public:
+    HashedPerceptron(const HashedPerceptronParams &params);
+
+    bool lookup(ThreadID tid, Addr branch_addr, void * &bp_history) override;
+    void uncondBranch(ThreadID tid, Addr pc, void * &bp_history) override;
+    void btbUpdate(ThreadID tid, Addr branch_addr,
+                   void * &bp_history) override;
+    void update(ThreadID tid, Addr branch_addr, bool taken, void *bp_history,
+                bool squashed, const StaticInstPtr & inst,
+                Addr corrTarget) override;
+    void squash(ThreadID tid, void *bp_history) override;
+
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+
+    /** Longest global history supported, in branches. */
+    static constexpr unsigned maxHistoryLength = 256;
+
+    /** Largest number of weight tables supported. */
+    static constexpr unsigned maxTables = 32;
+
+  private:
+    /** Global history bits, the most recent branch in bit 0. */
+    using GlobalHistory =
+        std::array<uint64_t, (maxHistoryLength + 63) / 64>;
+
+    /** The speculative histories of a thread. */
+    struct ThreadHistory
+    {
+        GlobalHistory global{};
+        /** A few address bits of each recent branch. */
+        uint64_t path = 0;
+    };
+
+    struct BPHistory
+    {
+        /** The histories the branch was predicted with. */
+        ThreadHistory hist;
+        /** Weight selected in each table, as an index in weights. */
+        std::array<unsigned, maxTables> indices;
+        /** Sum of the selected weights. */
+        int sum = 0;
+        /** Whether the branch was conditional, and so trains. */
+        bool conditional = false;
+    };
+
+    /** Shift the outcome and address of a branch into the histories. */
+    void updateHistories(ThreadID tid, Addr branch_addr, bool taken);
+
+    /** Fold bits [start, end) of a global history into an index. */
+    unsigned foldHistory(const GlobalHistory &global, unsigned start,
+                         unsigned end) const;
+
+    /** Compute the weight indices of a branch and sum the weights. */
+    int computeSum(Addr branch_addr, const ThreadHistory &hist,
+                   BPHistory &record) const;
+
+    /** Number of weight tables. */
+    const unsigned numTables;
+
+    /** Number of log2 entries of each table. */
+    const unsigned logTableEntries;
+
+    /** End of the history segment of each table, in branches. */
+    const std::vector<unsigned> historyLengths;
+
+    /** Largest and smallest value of a weight. */
+    const int maxWeight;
+    const int minWeight;
+
+    /** Number of address bits pushed into the path history. */
+    const unsigned pathBits;
+
+    /** The weights, table after table. */
+    std::vector<int8_t> weights;
+
+    /** Training threshold, adapted at runtime when enabled. */
+    int theta;
+
+    /** Whether theta is adapted to the misprediction rate. */
+    const bool adaptiveTheta;
+
+    /** Counter steering the adaptation of theta. */
+    int thetaCounter = 0;
+
+    /** Speculative histories of each thread. */
+    std::vector<ThreadHistory> threadHistory;
+
+    /** Recycled storage for the in-flight BPHistory records. */
+    HistoryPool<BPHistory> historyPool;
+};
+
+} // namespace branch_prediction
+} // namespace gem5
+
+#endif // __CPU_PRED_HASHED_PERCEPTRON_HH__
@@ -0,0 +1,159 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_PRED_HISTORY_POOL_HH__
+#define __CPU_PRED_HISTORY_POOL_HH__
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "base/types.hh"
+
+namespace gem5
+{
+
+namespace branch_prediction
+{
+
+/**
+ * Per-thread recycling pool for the history records a branch predictor
+ * hands back through the opaque bp_history pointer. Records are carved
+ * out of fixed size slabs which are only allocated when a thread runs out
+ * of free slots, so once the number of in-flight branches has reached its
+ * steady state, acquire() and release() never go to the heap.
+ *
+ * Objects are constructed in place on acquire() and destroyed on
+ * release(), so a record always starts with the state its constructor
+ * gives it. Released slots are reused in LIFO order to keep the most
+ * recently used records hot in the host caches.
+ *
+ * @tparam T Type of the history record.
+ */
+template <class T>
+class HistoryPool
+{
+  private:
+    /** Raw, suitably aligned storage for a single record. */
+    struct Slot
+    {
+        alignas(T) unsigned char data[sizeof(T)];
+    };
+
+    struct ThreadPool
+    {
+        /** Slabs owned by this thread. Never shrinks. */
+        std::vector<std::unique_ptr<Slot[]>> slabs;
+        /** Unused slots, handed out from the back. */
+        std::vector<Slot *> freeList;
+        /** Number of records currently handed out. */
+        size_t inUse = 0;
+    };
+
+    /** Number of records carved out of a slab. */
+    const size_t slabSize;
+
+    std::vector<ThreadPool> threads;
+
+    void
+    grow(ThreadPool &pool)
+    {
+        pool.slabs.emplace_back(new Slot[slabSize]);
+        Slot *slab = pool.slabs.back().get();
+        pool.freeList.reserve(pool.slabs.size() * slabSize);
+        // Push in reverse so that the first slot is handed out first.
+        for (size_t i = slabSize; i > 0; --i)
+            pool.freeList.push_back(&slab[i - 1]);
+    }
+
+  public:
+    /**
+     * @param num_threads Number of hardware threads using the pool.
+     * @param slab_size Number of records allocated at once when a thread
+     *                  runs out of free records.
+     */
+    HistoryPool(unsigned num_threads, size_t slab_size = 64)
+        : slabSize(slab_size), threads(num_threads)
+    {
+        assert(slab_size > 0);
+    }
+
+    HistoryPool(const HistoryPool &) = delete;
+    HistoryPool &operator=(const HistoryPool &) = delete;
+
+    /**
+     * Get a fresh record for the given thread, constructed from args.
+     */
+    template <class... Args>
+    T *
+    acquire(ThreadID tid, Args&&... args)
+    {
+        assert(tid >= 0 && static_cast<size_t>(tid) < threads.size());
+        ThreadPool &pool = threads[tid];
+        if (pool.freeList.empty())
+            grow(pool);
+
+        Slot *slot = pool.freeList.back();
+        pool.freeList.pop_back();
+        ++pool.inUse;
+        return ::new (static_cast<void *>(slot->data))
+            T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * Destroy a record and return its storage to the thread it was
+     * acquired from.
+     */
+    void
+    release(ThreadID tid, T *record)
+    {
+        assert(tid >= 0 && static_cast<size_t>(tid) < threads.size());
+        assert(record);
+        ThreadPool &pool = threads[tid];
+        assert(pool.inUse > 0);
+
+        record->~T();
+        pool.freeList.push_back(reinterpret_cast<Slot *>(record));
+        --pool.inUse;
+    }
+
+    /** Number of records currently handed out to a thread. */
+    size_t inUse(ThreadID tid) const { return threads[tid].inUse; }
+
+    /** Number of records a thread can hold without growing. */
+    size_t
+    capacity(ThreadID tid) const
+    {
+        return threads[tid].slabs.size() * slabSize;
+    }
+};
+
+} // namespace branch_prediction
+} // namespace gem5
+
+#endif // __CPU_PRED_HISTORY_POOL_HH__
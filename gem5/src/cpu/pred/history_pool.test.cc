@@ -0,0 +1,112 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <set>
+
+#include "cpu/pred/history_pool.hh"
+
+using namespace gem5;
+using namespace gem5::branch_prediction;
+
+namespace
+{
+
+struct Record
+{
+    static int live;
+
+    Record(int v=0) : value(v) { ++live; }
+    ~Record() { --live; }
+
+    int value;
+};
+
+int Record::live = 0;
+
+} // anonymous namespace
+
+TEST(HistoryPoolTest, AcquireConstructs)
+{
+    HistoryPool<Record> pool(1, 4);
+    Record *r = pool.acquire(0, 42);
+    EXPECT_EQ(42, r->value);
+    EXPECT_EQ(1, Record::live);
+    EXPECT_EQ(1u, pool.inUse(0));
+    pool.release(0, r);
+    EXPECT_EQ(0, Record::live);
+    EXPECT_EQ(0u, pool.inUse(0));
+}
+
+TEST(HistoryPoolTest, ReleasedSlotIsReused)
+{
+    HistoryPool<Record> pool(1, 4);
+    Record *first = pool.acquire(0);
+    pool.release(0, first);
+    Record *second = pool.acquire(0, 7);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(7, second->value);
+    pool.release(0, second);
+}
+
+TEST(HistoryPoolTest, GrowsOneSlabAtATime)
+{
+    HistoryPool<Record> pool(1, 4);
+    EXPECT_EQ(0u, pool.capacity(0));
+
+    std::set<Record *> records;
+    for (int i = 0; i < 5; ++i)
+        records.insert(pool.acquire(0, i));
+    EXPECT_EQ(5u, records.size());
+    EXPECT_EQ(8u, pool.capacity(0));
+
+    for (auto r : records)
+        pool.release(0, r);
+    EXPECT_EQ(0u, pool.inUse(0));
+
+    // Steady state: no further growth.
+    records.clear();
+    for (int i = 0; i < 8; ++i)
+        records.insert(pool.acquire(0, i));
+    EXPECT_EQ(8u, pool.capacity(0));
+
+    for (auto r : records)
+        pool.release(0, r);
+}
+
+TEST(HistoryPoolTest, ThreadsAreIndependent)
+{
+    HistoryPool<Record> pool(2, 2);
+    Record *a = pool.acquire(0, 1);
+    Record *b = pool.acquire(1, 2);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(1u, pool.inUse(0));
+    EXPECT_EQ(1u, pool.inUse(1));
+    EXPECT_EQ(2u, pool.capacity(0));
+    EXPECT_EQ(2u, pool.capacity(1));
+    pool.release(0, a);
+    pool.release(1, b);
+}
@@ -0,0 +1,402 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/pred/ittage.hh"
+
+#include <cmath>
+#include <cstdlib>
+
+#include "base/bitfield.hh"
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/Indirect.hh"
+
+namespace gem5
+{
+
+namespace branch_prediction
+{
+
+ITTAGE::ITTAGE(const ITTAGEParams &p)
+    : IndirectPredictor(p),
+      nHistoryTables(p.nHistoryTables),
+      instShiftAmt(p.instShiftAmt),
+      logTableSizes(p.logTableSizes),
+      tagWidths(p.tagTableTagWidths),
+      maxConf(mask(p.confBits)),
+      maxU(mask(p.uBits)),
+      pathHistBits(p.pathHistBits),
+      uResetPeriod(1ULL << p.logUResetPeriod),
+      histLengths(p.nHistoryTables + 1, 0),
+      tables(p.nHistoryTables + 1),
+      threadHistory(p.numThreads),
+      lastInfo(p.numThreads, nullptr),
+      historyPool(p.numThreads),
+      stats(this, p.nHistoryTables)
+{
+    fatal_if(nHistoryTables == 0 || nHistoryTables > maxTables,
+             "%s: between 1 and %d tagged tables are supported\n", name(),
+             maxTables);
+    fatal_if(logTableSizes.size() != nHistoryTables + 1 ||
+             tagWidths.size() != nHistoryTables + 1,
+             "%s: there must be a table size and a tag width for the base "
+             "table and each tagged table\n", name());
+    fatal_if(tagWidths[0] != 0, "%s: the base table is untagged\n", name());
+    for (unsigned t = 1; t <= nHistoryTables; ++t) {
+        fatal_if(tagWidths[t] < 2 || tagWidths[t] > 16,
+                 "%s: tags must have between 2 and 16 bits\n", name());
+    }
+    fatal_if(p.minHist == 0 || p.maxHist < p.minHist,
+             "%s: invalid history lengths\n", name());
+    fatal_if(p.histBufferSize <= p.maxHist * 2,
+             "%s: the history buffer must hold twice the longest history\n",
+             name());
+    fatal_if(pathHistBits > 64, "%s: the path history is limited to 64 "
+             "bits\n", name());
+
+    // geometric history lengths, as in TAGEBase::calculateParameters()
+    histLengths[1] = p.minHist;
+    histLengths[nHistoryTables] = p.maxHist;
+    for (unsigned t = 2; t < nHistoryTables; ++t) {
+        histLengths[t] = (unsigned)(p.minHist *
+            std::pow((double)p.maxHist / p.minHist,
+                     (double)(t - 1) / (nHistoryTables - 1)) + 0.5);
+    }
+
+    for (unsigned t = 0; t <= nHistoryTables; ++t)
+        tables[t].resize(1ULL << logTableSizes[t]);
+
+    for (auto &hist : threadHistory) {
+        hist.globalHistory.init(p.histBufferSize);
+        for (unsigned t = 1; t <= nHistoryTables; ++t) {
+            hist.computeIndices[t].init(histLengths[t], logTableSizes[t]);
+            hist.computeTags[0][t].init(histLengths[t], tagWidths[t]);
+            hist.computeTags[1][t].init(histLengths[t], tagWidths[t] - 1);
+        }
+    }
+}
+
+void
+ITTAGE::calculateIndicesAndTags(ThreadID tid, Addr pc, BranchInfo &bi)
+{
+    const ThreadHistory &hist = threadHistory[tid];
+    const Addr pc_s = pc >> instShiftAmt;
+
+    bi.indices[0] = pc_s & mask(logTableSizes[0]);
+    for (unsigned t = 1; t <= nHistoryTables; ++t) {
+        const unsigned log_size = logTableSizes[t];
+        uint64_t path = hist.pathHist &
+            mask(std::min(histLengths[t], pathHistBits));
+        uint64_t path_hash = 0;
+        for (; path; path >>= log_size)
+            path_hash ^= path;
+
+        bi.indices[t] = (pc_s ^ (pc_s >> (std::abs((int)log_size - (int)t)
+                         + 1)) ^ hist.computeIndices[t].comp ^ path_hash) &
+            mask(log_size);
+        bi.tags[t] = (pc_s ^ hist.computeTags[0][t].comp ^
+                      (hist.computeTags[1][t].comp << 1)) &
+            mask(tagWidths[t]);
+    }
+}
+
+bool
+ITTAGE::matches(const BranchInfo &bi, unsigned t) const
+{
+    const Entry &entry = tables[t][bi.indices[t]];
+    return entry.target && (t == 0 || entry.tag == bi.tags[t]);
+}
+
+void
+ITTAGE::genIndirectInfo(ThreadID tid, void* & indirect_history)
+{
+    // record the histories as they were before this prediction, to
+    // recover them if this prediction is wrong or on the wrong path
+    const ThreadHistory &hist = threadHistory[tid];
+    BranchInfo *bi = historyPool.acquire(tid);
+    bi->ptGhist = hist.ptGhist;
+    bi->pathHist = hist.pathHist;
+    for (unsigned t = 1; t <= nHistoryTables; ++t) {
+        bi->ci[t] = hist.computeIndices[t].comp;
+        bi->ct0[t] = hist.computeTags[0][t].comp;
+        bi->ct1[t] = hist.computeTags[1][t].comp;
+    }
+    lastInfo[tid] = bi;
+    indirect_history = bi;
+}
+
+bool
+ITTAGE::lookup(Addr br_addr, PCStateBase& target, ThreadID tid)
+{
+    // The lookup belongs to the branch genIndirectInfo() was just called
+    // for, whose record is still the last one of the thread.
+    assert(lastInfo[tid]);
+    BranchInfo &bi = *lastInfo[tid];
+    bi.lookedUp = true;
+    bi.pc = br_addr;
+    ++stats.lookups;
+
+    calculateIndicesAndTags(tid, br_addr, bi);
+
+    bi.provider = bi.alt = 0;
+    for (unsigned t = nHistoryTables; t > 0; --t) {
+        if (!matches(bi, t))
+            continue;
+        if (!bi.provider) {
+            bi.provider = t;
+        } else {
+            bi.alt = t;
+            break;
+        }
+    }
+
+    bi.used = bi.provider;
+    if (bi.provider && bi.alt &&
+        tables[bi.provider][bi.indices[bi.provider]].conf == 0) {
+        // a newly allocated entry is not trusted yet
+        bi.used = bi.alt;
+        ++stats.altUsed;
+    }
+
+    const Entry &entry = tables[bi.used][bi.indices[bi.used]];
+    bi.hit = entry.target != nullptr;
+    if (!bi.hit) {
+        DPRINTF(Indirect, "Miss %x\n", br_addr);
+        ++stats.misses;
+        return false;
+    }
+
+    DPRINTF(Indirect, "Hit %x in table %d (target:%s)\n", br_addr, bi.used,
+            *entry.target);
+    ++stats.tableHits[bi.used];
+    bi.predTarget = entry.target->instAddr();
+    set(target, *entry.target);
+    return true;
+}
+
+void
+ITTAGE::pushHistory(ThreadHistory &hist, bool taken)
+{
+    hist.ptGhist = hist.globalHistory.next(hist.ptGhist);
+    hist.globalHistory.set(hist.ptGhist, taken);
+    for (unsigned t = 1; t <= nHistoryTables; ++t) {
+        hist.computeIndices[t].update(hist.globalHistory, hist.ptGhist);
+        hist.computeTags[0][t].update(hist.globalHistory, hist.ptGhist);
+        hist.computeTags[1][t].update(hist.globalHistory, hist.ptGhist);
+    }
+}
+
+void
+ITTAGE::restoreHistory(ThreadHistory &hist, const BranchInfo &bi)
+{
+    hist.ptGhist = bi.ptGhist;
+    hist.pathHist = bi.pathHist;
+    for (unsigned t = 1; t <= nHistoryTables; ++t) {
+        hist.computeIndices[t].comp = bi.ci[t];
+        hist.computeTags[0][t].comp = bi.ct0[t];
+        hist.computeTags[1][t].comp = bi.ct1[t];
+    }
+}
+
+void
+ITTAGE::pushPath(ThreadHistory &hist, Addr target)
+{
+    hist.pathHist = ((hist.pathHist << 2) ^ (target >> instShiftAmt)) &
+        mask(pathHistBits);
+}
+
+void
+ITTAGE::updateDirectionInfo(ThreadID tid, bool actually_taken)
+{
+    pushHistory(threadHistory[tid], actually_taken);
+}
+
+void
+ITTAGE::changeDirectionPrediction(ThreadID tid, void * indirect_history,
+                                  bool actually_taken)
+{
+    BranchInfo *bi = static_cast<BranchInfo *>(indirect_history);
+    ThreadHistory &hist = threadHistory[tid];
+    restoreHistory(hist, *bi);
+    pushHistory(hist, actually_taken);
+
+    // A target that turned out not to be taken says nothing about the
+    // entry that provided it.
+    if (!actually_taken)
+        bi->trained = true;
+}
+
+void
+ITTAGE::recordIndirect(Addr br_addr, Addr tgt_addr, InstSeqNum seq_num,
+                       ThreadID tid)
+{
+    DPRINTF(Indirect, "Recording %x seq:%d\n", br_addr, seq_num);
+    pushPath(threadHistory[tid], tgt_addr);
+}
+
+void
+ITTAGE::updateEntry(Entry &entry, const PCStateBase &target)
+{
+    if (entry.target && entry.target->instAddr() == target.instAddr()) {
+        if (entry.conf < maxConf)
+            ++entry.conf;
+    } else if (entry.conf > 0) {
+        --entry.conf;
+    } else {
+        set(entry.target, target);
+    }
+}
+
+void
+ITTAGE::allocate(const BranchInfo &bi, const PCStateBase &target)
+{
+    for (unsigned t = bi.provider + 1; t <= nHistoryTables; ++t) {
+        Entry &entry = tables[t][bi.indices[t]];
+        if (entry.u == 0) {
+            entry.tag = bi.tags[t];
+            set(entry.target, target);
+            entry.conf = 0;
+            ++stats.allocations;
+            return;
+        }
+    }
+
+    // every candidate is useful, age them so that a later allocation
+    // succeeds
+    ++stats.allocationFailures;
+    for (unsigned t = bi.provider + 1; t <= nHistoryTables; ++t) {
+        Entry &entry = tables[t][bi.indices[t]];
+        if (entry.u > 0)
+            --entry.u;
+    }
+}
+
+void
+ITTAGE::recordTarget(InstSeqNum seq_num, void * indirect_history,
+                     const PCStateBase& target, ThreadID tid)
+{
+    BranchInfo *bi = static_cast<BranchInfo *>(indirect_history);
+
+    // changeDirectionPrediction() already restored the histories of the
+    // branch, it only misses its actual target
+    pushPath(threadHistory[tid], target.instAddr());
+
+    if (!bi->lookedUp)
+        return;
+
+    DPRINTF(Indirect, "Mispredicted %x seq:%d (target:%s)\n", bi->pc,
+            seq_num, target);
+    ++stats.mispredicted;
+    bi->trained = true;
+
+    bool provider_right = false;
+    if (bi->provider) {
+        if (matches(*bi, bi->provider)) {
+            Entry &entry = tables[bi->provider][bi->indices[bi->provider]];
+            provider_right = entry.target->instAddr() == target.instAddr();
+            updateEntry(entry, target);
+        }
+    } else {
+        updateEntry(tables[0][bi->indices[0]], target);
+    }
+
+    if (!provider_right && bi->provider < nHistoryTables)
+        allocate(*bi, target);
+}
+
+void
+ITTAGE::commit(InstSeqNum seq_num, ThreadID tid, void * indirect_history)
+{
+    DPRINTF(Indirect, "Committing seq:%d\n", seq_num);
+    BranchInfo *bi = static_cast<BranchInfo *>(indirect_history);
+
+    // A target that was not found mispredicted was right
+    if (bi->lookedUp && bi->hit && !bi->trained) {
+        Entry &used = tables[bi->used][bi->indices[bi->used]];
+        if (matches(*bi, bi->used) &&
+            used.target->instAddr() == bi->predTarget) {
+            if (used.conf < maxConf)
+                ++used.conf;
+            // the provider is useful when the alternate would have been
+            // wrong
+            if (bi->used == bi->provider && bi->alt &&
+                matches(*bi, bi->alt) && used.u < maxU) {
+                const Entry &alt = tables[bi->alt][bi->indices[bi->alt]];
+                if (alt.target->instAddr() != bi->predTarget)
+                    ++used.u;
+            }
+        }
+
+        if (++uResetCounter >= uResetPeriod) {
+            uResetCounter = 0;
+            for (unsigned t = 1; t <= nHistoryTables; ++t) {
+                for (auto &entry : tables[t])
+                    entry.u >>= 1;
+            }
+        }
+    }
+
+    historyPool.release(tid, bi);
+}
+
+void
+ITTAGE::squash(InstSeqNum seq_num, ThreadID tid)
+{
+    // The histories are restored branch by branch in deleteIndirectInfo()
+    DPRINTF(Indirect, "Squashing seq:%d\n", seq_num);
+}
+
+void
+ITTAGE::deleteIndirectInfo(ThreadID tid, void * indirect_history)
+{
+    BranchInfo *bi = static_cast<BranchInfo *>(indirect_history);
+    restoreHistory(threadHistory[tid], *bi);
+    historyPool.release(tid, bi);
+}
+
+ITTAGE::ITTAGEStats::ITTAGEStats(statistics::Group *parent,
+                                 unsigned n_tables)
+    : statistics::Group(parent),
+      ADD_STAT(lookups, statistics::units::Count::get(),
+               "Number of indirect target lookups"),
+      ADD_STAT(misses, statistics::units::Count::get(),
+               "Number of lookups that found no target"),
+      ADD_STAT(tableHits, statistics::units::Count::get(),
+               "Number of targets provided by each table, 0 being the base "
+               "table"),
+      ADD_STAT(altUsed, statistics::units::Count::get(),
+               "Number of targets provided by the alternate table"),
+      ADD_STAT(mispredicted, statistics::units::Count::get(),
+               "Number of mispredicted targets"),
+      ADD_STAT(allocations, statistics::units::Count::get(),
+               "Number of entries allocated"),
+      ADD_STAT(allocationFailures, statistics::units::Count::get(),
+               "Number of mispredictions that could not allocate an entry")
+{
+    tableHits.init(n_tables + 1);
+}
+
+} // namespace branch_prediction
+} // namespace gem5
@@ -0,0 +1,207 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_PRED_ITTAGE_HH__
+#define __CPU_PRED_ITTAGE_HH__
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "cpu/inst_seq.hh"
+#include "cpu/pred/history_pool.hh"
+#include "cpu/pred/indirect.hh"
+#include "cpu/pred/tage_base.hh"
+#include "params/ITTAGE.hh"
+
+namespace gem5
+{
+
+namespace branch_prediction
+{
+
+/**
+ * An ITTAGE indirect target predictor, after Seznec's "A 64-Kbytes ITTAGE
+ * indirect branch predictor" (JWAC-2, 2011). A tagless base table indexed
+ * by the branch address backs tagged tables indexed with geometrically
+ * increasing lengths of global history. The longest matching table
+ * provides the target, unless its confidence is null and a shorter table
+ * also matches. The global history and its folded copies are the ones of
+ * TAGEBase, and the path history mixes in the targets of the indirect
+ * branches.
+ *
+ * The histories are updated speculatively. The record handed back by
+ * genIndirectInfo() holds their checkpoint, and the lookup done for the
+ * same branch fills in the entries it used, so that they can be trained
+ * when the branch commits or is found mispredicted.
+ */
+class ITTAGE : public IndirectPredictor
+{
+  public:
+    ITTAGE(const ITTAGEParams &params);
+
+    bool lookup(Addr br_addr, PCStateBase& br_target,
+                ThreadID tid) override;
+    void recordIndirect(Addr br_addr, Addr tgt_addr, InstSeqNum seq_num,
+                        ThreadID tid) override;
+    void commit(InstSeqNum seq_num, ThreadID tid,
+                void * indirect_history) override;
+    void squash(InstSeqNum seq_num, ThreadID tid) override;
+    void recordTarget(InstSeqNum seq_num, void * indirect_history,
+                      const PCStateBase& target, ThreadID tid) override;
+    void genIndirectInfo(ThreadID tid, void* & indirect_history) override;
+    void updateDirectionInfo(ThreadID tid, bool actually_taken) override;
+    void deleteIndirectInfo(ThreadID tid, void * indirect_history) override;
+    void changeDirectionPrediction(ThreadID tid, void * indirect_history,
+                                   bool actually_taken) override;
+
+    /** Largest number of tagged tables supported. */
+    static constexpr unsigned maxTables = 16;
+
+  private:
+    using GlobalHistory = TAGEBase::GlobalHistory;
+    using FoldedHistory = TAGEBase::FoldedHistory;
+
+    struct Entry
+    {
+        std::unique_ptr<PCStateBase> target;
+        uint16_t tag = 0;
+        uint8_t conf = 0;
+        uint8_t u = 0;
+    };
+
+    struct ThreadHistory
+    {
+        GlobalHistory globalHistory;
+        int ptGhist = 0;
+        uint64_t pathHist = 0;
+        std::array<FoldedHistory, maxTables + 1> computeIndices;
+        std::array<FoldedHistory, maxTables + 1> computeTags[2];
+    };
+
+    /** Per branch record, passed around as the indirect history. */
+    struct BranchInfo
+    {
+        /** @{ */
+        /** Checkpoint of the histories before the branch. */
+        int ptGhist = 0;
+        uint64_t pathHist = 0;
+        std::array<unsigned, maxTables + 1> ci;
+        std::array<unsigned, maxTables + 1> ct0;
+        std::array<unsigned, maxTables + 1> ct1;
+        /** @} */
+
+        /** Whether the branch looked up a target. */
+        bool lookedUp = false;
+        /** Whether the branch was found mispredicted and trained. */
+        bool trained = false;
+        Addr pc = 0;
+        /** Longest and second longest matching tables, 0 if none. */
+        unsigned provider = 0;
+        unsigned alt = 0;
+        /** Table whose target was used, 0 for the base table. */
+        unsigned used = 0;
+        /** Whether any table had a target. */
+        bool hit = false;
+        Addr predTarget = 0;
+        std::array<unsigned, maxTables + 1> indices;
+        std::array<uint16_t, maxTables + 1> tags;
+    };
+
+    /** Compute the table indices and tags of a branch. */
+    void calculateIndicesAndTags(ThreadID tid, Addr pc, BranchInfo &bi);
+
+    /** Whether the entry of table t used by a branch is still its own. */
+    bool matches(const BranchInfo &bi, unsigned t) const;
+
+    /** Move the confidence of an entry towards its target, or retarget
+     *  it when it has no confidence left. */
+    void updateEntry(Entry &entry, const PCStateBase &target);
+
+    /** Allocate entries for a mispredicted branch in longer tables. */
+    void allocate(const BranchInfo &bi, const PCStateBase &target);
+
+    /** Push a direction into the global and folded histories. */
+    void pushHistory(ThreadHistory &hist, bool taken);
+
+    /** Restore the histories of a thread to the checkpoint of a branch. */
+    void restoreHistory(ThreadHistory &hist, const BranchInfo &bi);
+
+    /** Fold a target into the path history. */
+    void pushPath(ThreadHistory &hist, Addr target);
+
+    const unsigned nHistoryTables;
+    const unsigned instShiftAmt;
+    const std::vector<unsigned> logTableSizes;
+    const std::vector<unsigned> tagWidths;
+    const unsigned maxConf;
+    const unsigned maxU;
+    const unsigned pathHistBits;
+    const uint64_t uResetPeriod;
+
+    /** History lengths of the tagged tables, 1-based. */
+    std::vector<unsigned> histLengths;
+
+    /** The tables, the base one first. */
+    std::vector<std::vector<Entry>> tables;
+
+    std::vector<ThreadHistory> threadHistory;
+
+    /** The record of the last branch of each thread, the one a lookup
+     *  belongs to. */
+    std::vector<BranchInfo *> lastInfo;
+
+    /** Indirect branches committed since the last useful bits reset. */
+    uint64_t uResetCounter = 0;
+
+    HistoryPool<BranchInfo> historyPool;
+
+    struct ITTAGEStats : public statistics::Group
+    {
+        ITTAGEStats(statistics::Group *parent, unsigned n_tables);
+
+        /** Stat for number of target lookups. */
+        statistics::Scalar lookups;
+        /** Stat for number of lookups without any target. */
+        statistics::Scalar misses;
+        /** Stat for the table providing each target, 0 is the base. */
+        statistics::Vector tableHits;
+        /** Stat for number of times the alternate table was used. */
+        statistics::Scalar altUsed;
+        /** Stat for number of mispredicted targets. */
+        statistics::Scalar mispredicted;
+        /** Stat for number of entries allocated. */
+        statistics::Scalar allocations;
+        /** Stat for number of failed allocations. */
+        statistics::Scalar allocationFailures;
+    } stats;
+};
+
+} // namespace branch_prediction
+} // namespace gem5
+
+#endif // __CPU_PRED_ITTAGE_HH__
@@ -80,6 +80,63 @@ LoopPredictor::init()
     assert(logSizeLoopPred >= logLoopTableAssoc);
 
     ltable = new LoopEntry[1ULL << logSizeLoopPred];
+    ltags = new uint16_t[1ULL << logSizeLoopPred]();
+}
+
+void
+LoopPredictor::serialize(CheckpointOut &cp) const
+{
+    const size_t size = 1ULL << logSizeLoopPred;
+    std::vector<uint16_t> numIter(size), currentIter(size);
+    std::vector<uint16_t> currentIterSpec(size), tag(size);
+    std::vector<uint8_t> confidence(size), age(size);
+    std::vector<bool> dir(size);
+    for (size_t i = 0; i < size; i++) {
+        numIter[i] = ltable[i].numIter;
+        currentIter[i] = ltable[i].currentIter;
+        currentIterSpec[i] = ltable[i].currentIterSpec;
+        tag[i] = ltags[i];
+        confidence[i] = ltable[i].confidence;
+        age[i] = ltable[i].age;
+        dir[i] = ltable[i].dir;
+    }
+    SERIALIZE_CONTAINER(numIter);
+    SERIALIZE_CONTAINER(currentIter);
+    SERIALIZE_CONTAINER(currentIterSpec);
+    SERIALIZE_CONTAINER(tag);
+    SERIALIZE_CONTAINER(confidence);
+    SERIALIZE_CONTAINER(age);
+    SERIALIZE_CONTAINER(dir);
+    SERIALIZE_SCALAR(loopUseCounter);
+}
+
+void
+LoopPredictor::unserialize(CheckpointIn &cp)
+{
+    const size_t size = 1ULL << logSizeLoopPred;
+    std::vector<uint16_t> numIter(size), currentIter(size);
+    std::vector<uint16_t> currentIterSpec(size), tag(size);
+    std::vector<uint8_t> confidence(size), age(size);
+    std::vector<bool> dir;
+    arrayParamIn(cp, "numIter", numIter.data(), size);
+    arrayParamIn(cp, "currentIter", currentIter.data(), size);
+    arrayParamIn(cp, "currentIterSpec", currentIterSpec.data(), size);
+    arrayParamIn(cp, "tag", tag.data(), size);
+    arrayParamIn(cp, "confidence", confidence.data(), size);
+    arrayParamIn(cp, "age", age.data(), size);
+    UNSERIALIZE_CONTAINER(dir);
+    fatal_if(dir.size() != size, "%s: checkpointed loop table has %d "
+             "entries, expected %d\n", name(), dir.size(), size);
+    for (size_t i = 0; i < size; i++) {
+        ltable[i].numIter = numIter[i];
+        ltable[i].currentIter = currentIter[i];
+        ltable[i].currentIterSpec = currentIterSpec[i];
+        ltags[i] = tag[i];
+        ltable[i].confidence = confidence[i];
+        ltable[i].age = age[i];
+        ltable[i].dir = dir[i];
+    }
+    UNSERIALIZE_SCALAR(loopUseCounter);
 }
 
 LoopPredictor::BranchInfo*
@@ -133,23 +190,30 @@ LoopPredictor::getLoop(Addr pc, BranchInfo* bi, bool speculative,
         // bi->loopIndexB is not used without hash
     }
 
+    // Only the tags are probed, the entry is read once the way is known
+    int idx = -1;
     for (int i = 0; i < (1 << logLoopTableAssoc); i++) {
-        int idx = finallindex(bi->loopIndex, bi->loopIndexB, i);
-        if (ltable[idx].tag == bi->loopTag) {
+        int way_idx = finallindex(bi->loopIndex, bi->loopIndexB, i);
+        if (ltags[way_idx] == bi->loopTag) {
             bi->loopHit = i;
-            bi->loopPredValid = calcConf(idx);
+            idx = way_idx;
+            break;
+        }
+    }
+    if (idx < 0) {
+        return false;
+    }
 
-            uint16_t iter = speculative ? ltable[idx].currentIterSpec
-                                        : ltable[idx].currentIter;
+    bi->loopPredValid = calcConf(idx);
 
-            if ((iter + 1) == ltable[idx].numIter) {
-                return useDirectionBit ? !(ltable[idx].dir) : false;
-            } else {
-                return useDirectionBit ? (ltable[idx].dir) : true;
-            }
-        }
+    const LoopEntry &entry = ltable[idx];
+    uint16_t iter = speculative ? entry.currentIterSpec : entry.currentIter;
+
+    if ((iter + 1) == entry.numIter) {
+        return useDirectionBit ? !(entry.dir) : false;
+    } else {
+        return useDirectionBit ? (entry.dir) : true;
     }
-    return false;
 }
 
 bool
@@ -255,7 +319,7 @@ LoopPredictor::loopUpdate(Addr pc, bool taken, BranchInfo* bi, bool tage_pred)
                             "Allocating loop pred entry for branch %lx\n",
                             pc);
                     ltable[idx].dir = !taken; // ignored if no useDirectionBit
-                    ltable[idx].tag = bi->loopTag;
+                    ltags[idx] = bi->loopTag;
                     ltable[idx].numIter = 0;
                     ltable[idx].age = initialLoopAge;
                     ltable[idx].confidence = 0;
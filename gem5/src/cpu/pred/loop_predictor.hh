@@ -61,23 +61,26 @@ class LoopPredictor : public SimObject
     const int loopSetMask;
 
     // Prediction Structures
-    // Loop Predictor Entry
+    // Loop Predictor Entry, its tag is kept apart in ltags
     struct LoopEntry
     {
         uint16_t numIter;
         uint16_t currentIter;
         uint16_t currentIterSpec; // only for useSpeculation
         uint8_t confidence;
-        uint16_t tag;
         uint8_t age;
         bool dir; // only for useDirectionBit
 
         LoopEntry() : numIter(0), currentIter(0), currentIterSpec(0),
-                      confidence(0), tag(0), age(0), dir(0) { }
+                      confidence(0), age(0), dir(0) { }
     };
 
     LoopEntry *ltable;
 
+    // The tags of the entries, packed apart from the rest of the entries
+    // so that probing the ways of a set only reads its tags
+    uint16_t *ltags;
+
     int8_t loopUseCounter;
     unsigned withLoopBits;
 
@@ -259,6 +262,9 @@ class LoopPredictor : public SimObject
      */
     void init() override;
 
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+
     LoopPredictor(const LoopPredictorParams &p);
 
     size_t getSizeInBits() const;
@@ -61,6 +61,12 @@ LTAGE::init()
     TAGE::init();
 }
 
+void
+LTAGE::freeBranchInfo(ThreadID tid, TageBranchInfo *bi)
+{
+    delete bi;
+}
+
 //prediction
 bool
 LTAGE::predict(ThreadID tid, Addr branch_pc, bool cond_branch, void* &b)
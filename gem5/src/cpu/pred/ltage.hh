@@ -101,6 +101,9 @@ class LTAGE : public TAGE
         }
     };
 
+    /** LTageBranchInfo records are heap allocated by predict(). */
+    void freeBranchInfo(ThreadID tid, TageBranchInfo *bi) override;
+
     /**
      * Get a branch prediction from LTAGE. *NOT* an override of
      * BpredUnit::predict().
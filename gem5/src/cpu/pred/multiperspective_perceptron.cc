@@ -71,7 +71,10 @@ MultiperspectivePerceptron::ThreadData::ThreadData(int num_filters,
         ghist_words(ghist_length/block_size+1, 0),
         path_history(path_length, 0), imli_counter(4,0),
         localHistories(n_local_histories, local_history_length),
-        recency_stack(assoc), last_ghist_bit(false), occupancy(0)
+        recency_stack(assoc), last_ghist_bit(false), occupancy(0),
+        mpreds(table_sizes.size(), 0), tables(table_sizes),
+        sign_bits(table_sizes), indices(table_sizes.size()),
+        best_preds(table_sizes.size())
 {
     for (int i = 0; i < blurrypath_bits.size(); i+= 1) {
         blurrypath_histories[i].resize(blurrypath_bits[i].size());
@@ -105,9 +108,6 @@ MultiperspectivePerceptron::ThreadData::ThreadData(int num_filters,
     }
 
     for (int i = 0; i < table_sizes.size(); i += 1) {
-        mpreds.push_back(0);
-        tables.push_back(std::vector<short int>(table_sizes[i]));
-        sign_bits.push_back(std::vector<std::array<bool, 2>>(table_sizes[i]));
         for (int j = 0; j < table_sizes[i]; j += 1) {
             for (int k = 0; k < n_sign_bits; k += 1) {
                 sign_bits[i][j][k] = (i & 1) | (k & 1);
@@ -156,6 +156,17 @@ MultiperspectivePerceptron::init()
     for (auto &spec : specs) {
         spec->setBitRequirements();
     }
+
+    // Fold the coefficient of each feature into its transfer function
+    scaledXlat.resize(specs.size() * xlatSize);
+    for (int i = 0; i < specs.size(); i += 1) {
+        const HistorySpec &spec = *specs[i];
+        const int n = (spec.width == 5) ? 16 : xlatSize;
+        for (int c = 0; c < n; c += 1) {
+            scaledXlat[i * xlatSize + c] =
+                spec.coeff * ((spec.width == 5) ? xlat4[c] : xlat[c]);
+        }
+    }
     const MultiperspectivePerceptronParams &p =
         static_cast<const MultiperspectivePerceptronParams &>(params());
 
@@ -306,11 +317,23 @@ MultiperspectivePerceptron::getIndex(ThreadID tid, const MPPBranchInfo &bi,
     return h;
 }
 
+void
+MultiperspectivePerceptron::computeIndices(ThreadID tid,
+        const MPPBranchInfo &bi, std::vector<unsigned int> &indices) const
+{
+    for (int i = 0; i < specs.size(); i += 1) {
+        indices[i] = getIndex(tid, bi, *specs[i], i);
+    }
+}
+
 int
 MultiperspectivePerceptron::computeOutput(ThreadID tid, MPPBranchInfo &bi)
 {
+    ThreadData &td = *threadData[tid];
+
     // list of best predictors
-    std::vector<int> best_preds(specs.size(), -1);
+    std::vector<int> &best_preds = td.best_preds;
+    std::fill(best_preds.begin(), best_preds.end(), -1);
 
     // initialize sum
     bi.yout = 0;
@@ -335,18 +358,20 @@ MultiperspectivePerceptron::computeOutput(ThreadID tid, MPPBranchInfo &bi)
     // begin computation of the sum for low-confidence branch
     int bestval = 0;
 
+    // get the hashes to index the tables first, so that the summation
+    // below is a plain gather from the weight tables
+    std::vector<unsigned int> &indices = td.indices;
+    computeIndices(tid, bi, indices);
+
+    const int sign_idx = bi.getHPC() % n_sign_bits;
     for (int i = 0; i < specs.size(); i += 1) {
-        HistorySpec const &spec = *specs[i];
-        // get the hash to index the table
-        unsigned int hashed_idx = getIndex(tid, bi, spec, i);
+        unsigned int hashed_idx = indices[i];
         // add the weight; first get the weight's magnitude
-        int counter = threadData[tid]->tables[i][hashed_idx];
+        int counter = td.tables[i][hashed_idx];
         // get the sign
-        bool sign =
-          threadData[tid]->sign_bits[i][hashed_idx][bi.getHPC() % n_sign_bits];
+        bool sign = td.sign_bits[i][hashed_idx][sign_idx];
         // apply the transfer function and multiply by a coefficient
-        int weight = spec.coeff * ((spec.width == 5) ?
-                                   xlat4[counter] : xlat[counter]);
+        int weight = scaledXlat[i * xlatSize + counter];
         // apply the sign
         int val = sign ? -weight : weight;
         // add the value
@@ -409,10 +434,13 @@ MultiperspectivePerceptron::satIncDec(bool taken, bool &sign, int &counter,
 void
 MultiperspectivePerceptron::train(ThreadID tid, MPPBranchInfo &bi, bool taken)
 {
-    std::vector<std::vector<short int>> &tables = threadData[tid]->tables;
-    std::vector<std::vector<std::array<bool, 2>>> &sign_bits =
-            threadData[tid]->sign_bits;
+    FlatTables<short int> &tables = threadData[tid]->tables;
+    FlatTables<std::array<bool, 2>> &sign_bits = threadData[tid]->sign_bits;
     std::vector<int> &mpreds = threadData[tid]->mpreds;
+    // the histories do not change while training, so the table indices
+    // are only computed once
+    std::vector<unsigned int> &indices = threadData[tid]->indices;
+    computeIndices(tid, bi, indices);
     // was the prediction correct?
     bool correct = (bi.yout >= 1) == taken;
     // what is the magnitude of yout?
@@ -423,13 +451,10 @@ MultiperspectivePerceptron::train(ThreadID tid, MPPBranchInfo &bi, bool taken)
 
         // for each table, figure out if there was a misprediction
         for (int i = 0; i < specs.size(); i += 1) {
-            HistorySpec const &spec = *specs[i];
-            // get the hash to index the table
-            unsigned int hashed_idx = getIndex(tid, bi, spec, i);
+            unsigned int hashed_idx = indices[i];
             bool sign = sign_bits[i][hashed_idx][bi.getHPC() % n_sign_bits];
             int counter = tables[i][hashed_idx];
-            int weight = spec.coeff * ((spec.width == 5) ?
-                                       xlat4[counter] : xlat[counter]);
+            int weight = scaledXlat[i * xlatSize + counter];
             if (sign) weight = -weight;
             bool pred = weight >= 1;
             if (pred != taken) {
@@ -473,7 +498,7 @@ MultiperspectivePerceptron::train(ThreadID tid, MPPBranchInfo &bi, bool taken)
     for (int i = 0; i < specs.size(); i += 1) {
         HistorySpec const &spec = *specs[i];
         // get the magnitude
-        unsigned int hashed_idx = getIndex(tid, bi, spec, i);
+        unsigned int hashed_idx = indices[i];
         int counter = tables[i][hashed_idx];
         // get the sign
         bool sign = sign_bits[i][hashed_idx][bi.getHPC() % n_sign_bits];
@@ -507,7 +532,7 @@ MultiperspectivePerceptron::train(ThreadID tid, MPPBranchInfo &bi, bool taken)
                 for (int j = 0; j < specs.size(); j += 1) {
                     int i = (nrand + j) % specs.size();
                     HistorySpec const &spec = *specs[i];
-                    unsigned int hashed_idx = getIndex(tid, bi, spec, i);
+                    unsigned int hashed_idx = indices[i];
                     int counter = tables[i][hashed_idx];
                     bool sign =
                         sign_bits[i][hashed_idx][bi.getHPC() % n_sign_bits];
@@ -525,7 +550,7 @@ MultiperspectivePerceptron::train(ThreadID tid, MPPBranchInfo &bi, bool taken)
                 if (besti != -1) {
                     int i = besti;
                     HistorySpec const &spec = *specs[i];
-                    unsigned int hashed_idx = getIndex(tid, bi, spec, i);
+                    unsigned int hashed_idx = indices[i];
                     int counter = tables[i][hashed_idx];
                     bool sign =
                         sign_bits[i][hashed_idx][bi.getHPC() % n_sign_bits];
@@ -40,6 +40,7 @@
 #define __CPU_PRED_MULTIPERSPECTIVE_PERCEPTRON_HH__
 
 #include <array>
+#include <memory>
 #include <vector>
 
 #include "cpu/pred/bpred_unit.hh"
@@ -294,6 +295,60 @@ class MultiperspectivePerceptron : public BPredUnit
     /** Transfer function for 5-width tables */
     static int xlat4[];
 
+    /** Number of entries of the largest transfer function */
+    static constexpr int xlatSize = 32;
+
+    /**
+     * Transfer function of each table, already multiplied by the
+     * coefficient of its feature, indexed by table * xlatSize + counter
+     */
+    std::vector<int> scaledXlat;
+
+    /**
+     * A set of tables of different sizes kept in a single allocation. Each
+     * table starts on a cache line boundary, so that the weights read by a
+     * prediction come from one contiguous, aligned buffer instead of one
+     * heap block per table.
+     */
+    template <typename T>
+    class FlatTables
+    {
+        /** Alignment of the start of every table, in bytes */
+        static constexpr size_t alignment = 64;
+        static_assert(alignment % sizeof(T) == 0,
+                      "Table entries must tile a cache line");
+
+        std::vector<T> storage;
+        std::vector<size_t> offsets;
+        T *base;
+
+      public:
+        FlatTables(const std::vector<int> &sizes)
+        {
+            const size_t line = alignment / sizeof(T);
+            size_t total = 0;
+            for (int size : sizes) {
+                offsets.push_back(total);
+                total += (size + line - 1) / line * line;
+            }
+            // Over allocate by one line so that the base can be aligned
+            storage.resize(total + line);
+            void *ptr = storage.data();
+            size_t space = storage.size() * sizeof(T);
+            base = static_cast<T *>(
+                std::align(alignment, total * sizeof(T), ptr, space));
+        }
+
+        FlatTables(const FlatTables &) = delete;
+        FlatTables &operator=(const FlatTables &) = delete;
+
+        /** Number of tables */
+        size_t size() const { return offsets.size(); }
+
+        T *operator[](int i) { return base + offsets[i]; }
+        const T *operator[](int i) const { return base + offsets[i]; }
+    };
+
     /** History data is kept for each thread */
     struct ThreadData
     {
@@ -353,8 +408,13 @@ class MultiperspectivePerceptron : public BPredUnit
         int occupancy;
 
         std::vector<int> mpreds;
-        std::vector<std::vector<short int>> tables;
-        std::vector<std::vector<std::array<bool, 2>>> sign_bits;
+        FlatTables<short int> tables;
+        FlatTables<std::array<bool, 2>> sign_bits;
+
+        /** Scratch storage for the table indices of a branch */
+        std::vector<unsigned int> indices;
+        /** Scratch storage for the best features of a branch */
+        std::vector<int> best_preds;
     };
     std::vector<ThreadData *> threadData;
 
@@ -473,6 +533,15 @@ class MultiperspectivePerceptron : public BPredUnit
      */
     void train(ThreadID tid, MPPBranchInfo &bi, bool taken);
 
+    /**
+     * Computes the index of every predictor table for a given branch
+     * @param tid Thread ID of the branch
+     * @param bi branch informaiton data
+     * @param indices vector to write the index of each table to
+     */
+    void computeIndices(ThreadID tid, const MPPBranchInfo &bi,
+                        std::vector<unsigned int> &indices) const;
+
     /**
      * Auxiliary function to increase a table counter depending on the
      * direction of the branch
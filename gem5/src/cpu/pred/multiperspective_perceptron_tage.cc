@@ -223,12 +223,12 @@ MPP_TAGE::updatePathAndGlobalHistory(
         tmp >>= 1;
         int pathbit = (path & 127);
         path >>= 1;
-        updateGHist(tHist.gHist, dir, tHist.globalHistory, tHist.ptGhist);
+        updateGHist(tHist.globalHistory, dir, tHist.ptGhist);
         tHist.pathHist = (tHist.pathHist << 1) ^ pathbit;
         for (int i = 1; i <= nHistoryTables; i++) {
-            tHist.computeIndices[i].update(tHist.gHist);
-            tHist.computeTags[0][i].update(tHist.gHist);
-            tHist.computeTags[1][i].update(tHist.gHist);
+            tHist.computeIndices[i].update(tHist.globalHistory, tHist.ptGhist);
+            tHist.computeTags[0][i].update(tHist.globalHistory, tHist.ptGhist);
+            tHist.computeTags[1][i].update(tHist.globalHistory, tHist.ptGhist);
         }
     }
 }
@@ -324,16 +324,16 @@ MPP_StatisticalCorrector::getIndUpd(Addr branch_pc) const
 
 void
 MPP_StatisticalCorrector::gUpdate(Addr branch_pc, bool taken, int64_t hist,
-                   std::vector<int> & length, std::vector<int8_t> * tab,
+                   std::vector<int> & length, std::vector<int8_t> & tab,
                    int nbr, int logs, std::vector<int8_t> & w,
                    StatisticalCorrector::BranchInfo* bi)
 {
-    int percsum = 0;
+    int64_t indices[maxGEHLLengths];
+    gIndices(branch_pc, hist, length, nbr, logs, indices);
+
     for (int i = 0; i < nbr; i++) {
-        int64_t bhist = hist & ((int64_t) ((1 << length[i]) - 1));
-        int64_t index = gIndex(branch_pc, bhist, logs, nbr, i);
-        percsum += (2 * tab[i][index] + 1);
-        ctrUpdate(tab[i][index], taken, scCountersWidth - (i < (nbr - 1)));
+        ctrUpdate(tab[indices[i]], taken,
+                  scCountersWidth - (i < (nbr - 1)));
     }
 }
 
@@ -108,14 +108,14 @@ class MPP_StatisticalCorrector : public StatisticalCorrector
     const unsigned pnb;
     const unsigned logPnb;
     std::vector<int> pm;
-    std::vector<int8_t> * pgehl;
+    std::vector<int8_t> pgehl;
     std::vector<int8_t> wp;
 
     // global branch history GEHL
     const unsigned gnb;
     const unsigned logGnb;
     std::vector<int> gm;
-    std::vector<int8_t> * ggehl;
+    std::vector<int8_t> ggehl;
     std::vector<int8_t> wg;
 
     struct MPP_SCThreadHistory : public StatisticalCorrector::SCThreadHistory
@@ -186,7 +186,7 @@ class MPP_StatisticalCorrector : public StatisticalCorrector
 
     void gUpdate(
         Addr branch_pc, bool taken, int64_t hist, std::vector<int> & length,
-        std::vector<int8_t> * tab, int nbr, int logs,
+        std::vector<int8_t> & tab, int nbr, int logs,
         std::vector<int8_t> &w, StatisticalCorrector::BranchInfo* bi) override;
 };
 
@@ -58,14 +58,14 @@ class MPP_StatisticalCorrector_64KB : public MPP_StatisticalCorrector
     const unsigned snb;
     const unsigned logSnb;
     std::vector<int> sm;
-    std::vector<int8_t> * sgehl;
+    std::vector<int8_t> sgehl;
     std::vector<int8_t> ws;
 
     // Third local history GEHL
     const unsigned tnb;
     const unsigned logTnb;
     std::vector<int> tm;
-    std::vector<int8_t> * tgehl;
+    std::vector<int8_t> tgehl;
     std::vector<int8_t> wt;
 
     StatisticalCorrector::SCThreadHistory *makeThreadHistory() override;
@@ -50,10 +50,24 @@ ReturnAddrStack::reset()
 }
 
 void
-ReturnAddrStack::push(const PCStateBase &return_addr)
+ReturnAddrStack::checkpoint(Checkpoint &ckpt) const
+{
+    ckpt.tos = tos;
+    ckpt.usedEntries = usedEntries;
+    ckpt.pushed = false;
+}
+
+void
+ReturnAddrStack::push(const PCStateBase &return_addr, Checkpoint &ckpt)
 {
     incrTos();
 
+    // Only the first push of a branch has to be saved, a later one goes to
+    // the same entry again.
+    if (!ckpt.pushed) {
+        set(ckpt.overwritten, addrStack[tos]);
+        ckpt.pushed = true;
+    }
     set(addrStack[tos], return_addr);
 
     if (usedEntries != numEntries) {
@@ -72,14 +86,15 @@ ReturnAddrStack::pop()
 }
 
 void
-ReturnAddrStack::restore(unsigned top_entry_idx, const PCStateBase *restored)
+ReturnAddrStack::restore(Checkpoint &ckpt)
 {
-    tos = top_entry_idx;
-
-    set(addrStack[tos], restored);
+    tos = ckpt.tos;
+    usedEntries = ckpt.usedEntries;
 
-    if (usedEntries != numEntries) {
-        ++usedEntries;
+    if (ckpt.pushed) {
+        unsigned idx = (tos + 1 == numEntries) ? 0 : tos + 1;
+        set(addrStack[idx], ckpt.overwritten);
+        ckpt.pushed = false;
     }
 }
 
@@ -29,6 +29,7 @@
 #ifndef __CPU_PRED_RAS_HH__
 #define __CPU_PRED_RAS_HH__
 
+#include <memory>
 #include <vector>
 
 #include "arch/generic/pcstate.hh"
@@ -40,10 +41,34 @@ namespace gem5
 namespace branch_prediction
 {
 
-/** Return address stack class, implements a simple RAS. */
+/**
+ * Return address stack class, implements a circular RAS that can be
+ * repaired exactly after a squash.
+ *
+ * Every branch takes a checkpoint of the top of stack before it pushes or
+ * pops. A pop leaves the entries in place, and a push overwrites exactly one
+ * entry, which is saved in the checkpoint of the branch that pushed. Undoing
+ * the squashed branches from the youngest to the oldest thus brings back the
+ * stack as it was, including the entries that wrong path calls overwrote.
+ * The only entries that are lost for good are the ones dropped when a push
+ * overflows a full stack.
+ */
 class ReturnAddrStack
 {
   public:
+    /** State of the RAS before a branch pushed or popped. */
+    struct Checkpoint
+    {
+        /** The top of stack index. */
+        unsigned tos = 0;
+        /** The number of used entries. */
+        unsigned usedEntries = 0;
+        /** Whether the branch pushed, and overwritten is valid. */
+        bool pushed = false;
+        /** The entry overwritten by the push, if any. */
+        std::unique_ptr<PCStateBase> overwritten;
+    };
+
     /** Creates a return address stack, but init() must be called prior to
      *  use.
      */
@@ -62,18 +87,23 @@ class ReturnAddrStack
     /** Returns the index of the top of the RAS. */
     unsigned topIdx() { return tos; }
 
-    /** Pushes an address onto the RAS. */
-    void push(const PCStateBase &return_addr);
+    /** Takes a checkpoint of the top of the RAS before a branch uses it. */
+    void checkpoint(Checkpoint &ckpt) const;
+
+    /** Pushes an address onto the RAS.
+     *  @param return_addr The address to push.
+     *  @param ckpt The checkpoint of the pushing branch, which saves the
+     *  entry that is overwritten.
+     */
+    void push(const PCStateBase &return_addr, Checkpoint &ckpt);
 
     /** Pops the top address from the RAS. */
     void pop();
 
-    /** Changes index to the top of the RAS, and replaces the top address with
-     *  a new target.
-     *  @param top_entry_idx The index of the RAS that will now be the top.
-     *  @param restored The new target address of the new top of the RAS.
+    /** Undoes the pushes and pops a branch did since its checkpoint.
+     *  @param ckpt The checkpoint taken before the branch used the RAS.
      */
-    void restore(unsigned top_entry_idx, const PCStateBase *restored);
+    void restore(Checkpoint &ckpt);
 
     bool empty() { return usedEntries == 0; }
 
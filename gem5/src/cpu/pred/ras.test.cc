@@ -0,0 +1,131 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "arch/generic/pcstate.hh"
+#include "cpu/pred/ras.hh"
+
+using namespace gem5;
+using namespace gem5::branch_prediction;
+
+namespace
+{
+
+using TestPCState = GenericISA::SimplePCState<4>;
+
+Addr
+topAddr(ReturnAddrStack &ras)
+{
+    return ras.top() ? ras.top()->instAddr() : 0;
+}
+
+} // anonymous namespace
+
+TEST(ReturnAddrStackTest, PushPop)
+{
+    ReturnAddrStack ras;
+    ras.init(4);
+    ReturnAddrStack::Checkpoint a, b;
+
+    EXPECT_TRUE(ras.empty());
+    ras.checkpoint(a);
+    ras.push(TestPCState(0x100), a);
+    ras.checkpoint(b);
+    ras.push(TestPCState(0x200), b);
+    EXPECT_EQ(0x200, topAddr(ras));
+    ras.pop();
+    EXPECT_EQ(0x100, topAddr(ras));
+    ras.pop();
+    EXPECT_TRUE(ras.empty());
+}
+
+TEST(ReturnAddrStackTest, RestoreUndoesPush)
+{
+    ReturnAddrStack ras;
+    ras.init(4);
+    ReturnAddrStack::Checkpoint a, b;
+
+    ras.checkpoint(a);
+    ras.push(TestPCState(0x100), a);
+    ras.checkpoint(b);
+    ras.push(TestPCState(0x200), b);
+    ras.restore(b);
+    EXPECT_EQ(0x100, topAddr(ras));
+    ras.restore(a);
+    EXPECT_TRUE(ras.empty());
+}
+
+/**
+ * A wrong path return followed by a wrong path call overwrites the entry
+ * the return popped. Undoing both brings the entry back.
+ */
+TEST(ReturnAddrStackTest, RestoreRepairsOverwrittenEntry)
+{
+    ReturnAddrStack ras;
+    ras.init(4);
+    ReturnAddrStack::Checkpoint call0, call1, ret, call2;
+
+    ras.checkpoint(call0);
+    ras.push(TestPCState(0x100), call0);
+    ras.checkpoint(call1);
+    ras.push(TestPCState(0x200), call1);
+
+    // Wrong path.
+    ras.checkpoint(ret);
+    ras.pop();
+    ras.checkpoint(call2);
+    ras.push(TestPCState(0x300), call2);
+    EXPECT_EQ(0x300, topAddr(ras));
+
+    // Squash youngest first.
+    ras.restore(call2);
+    ras.restore(ret);
+    EXPECT_EQ(0x200, topAddr(ras));
+    ras.pop();
+    EXPECT_EQ(0x100, topAddr(ras));
+}
+
+TEST(ReturnAddrStackTest, OverflowDropsOldest)
+{
+    ReturnAddrStack ras;
+    ras.init(2);
+    ReturnAddrStack::Checkpoint ckpt;
+
+    for (Addr addr : {0x100, 0x200, 0x300}) {
+        ras.checkpoint(ckpt);
+        ras.push(TestPCState(addr), ckpt);
+    }
+    EXPECT_TRUE(ras.full());
+    EXPECT_EQ(0x300, topAddr(ras));
+    ras.pop();
+    EXPECT_EQ(0x200, topAddr(ras));
+    ras.pop();
+    EXPECT_TRUE(ras.empty());
+
+    // Undoing the last push brings back the dropped entry as well.
+    ras.restore(ckpt);
+    EXPECT_EQ(0x200, topAddr(ras));
+}
@@ -0,0 +1,162 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_PRED_SPEC_HISTORY_HH__
+#define __CPU_PRED_SPEC_HISTORY_HH__
+
+#include <cassert>
+#include <vector>
+
+#include "base/bitfield.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+
+namespace branch_prediction
+{
+
+/**
+ * Branch histories that are updated with the predicted outcome of a branch
+ * at lookup, so that the branches behind it in the pipeline are predicted
+ * with an up to date history. There is a global history register per
+ * thread and an optional table of local histories, indexed by branch.
+ *
+ * A predictor takes a checkpoint of the histories a branch used before
+ * shifting its prediction in, and keeps it in its history record. On a
+ * squash the checkpoint is restored, and when the branch itself was
+ * mispredicted the histories are repaired with its actual outcome.
+ */
+class SpeculativeHistory
+{
+  public:
+    /** Local history index of a branch that has no local history. */
+    static constexpr int noLocal = -1;
+
+    /** The histories seen by a branch when it was predicted. */
+    struct Checkpoint
+    {
+        /** The global history register. */
+        unsigned global = 0;
+        /** Index of the local history, or noLocal. */
+        int localIdx = noLocal;
+        /** The local history. */
+        unsigned local = 0;
+
+        bool hasLocal() const { return localIdx != noLocal; }
+    };
+
+  private:
+    const unsigned globalMask;
+    const unsigned localMask;
+
+    std::vector<unsigned> globalRegs;
+    std::vector<unsigned> localTable;
+
+  public:
+    /**
+     * @param num_threads Number of hardware threads.
+     * @param global_bits Number of bits of a global history register.
+     * @param local_entries Number of entries of the local history table.
+     * @param local_bits Number of bits of a local history.
+     */
+    SpeculativeHistory(unsigned num_threads, unsigned global_bits,
+                       unsigned local_entries = 0, unsigned local_bits = 0)
+        : globalMask(mask(global_bits)), localMask(mask(local_bits)),
+          globalRegs(num_threads, 0), localTable(local_entries, 0)
+    {}
+
+    /** The global history of a thread. */
+    unsigned global(ThreadID tid) const { return globalRegs[tid]; }
+
+    /** The local history at an index of the local history table. */
+    unsigned local(unsigned idx) const { return localTable[idx]; }
+
+    /** Take a checkpoint of the histories a branch is predicted with. */
+    Checkpoint
+    checkpoint(ThreadID tid, int local_idx=noLocal) const
+    {
+        Checkpoint ckpt;
+        ckpt.global = globalRegs[tid];
+        ckpt.localIdx = local_idx;
+        if (local_idx != noLocal)
+            ckpt.local = localTable[local_idx];
+        return ckpt;
+    }
+
+    /** Shift the predicted outcome of a branch into the histories. */
+    void
+    speculate(ThreadID tid, int local_idx, bool taken)
+    {
+        globalRegs[tid] = ((globalRegs[tid] << 1) | taken) & globalMask;
+        if (local_idx != noLocal) {
+            assert(static_cast<size_t>(local_idx) < localTable.size());
+            localTable[local_idx] =
+                ((localTable[local_idx] << 1) | taken) & localMask;
+        }
+    }
+
+    /** Undo the update of a squashed branch. */
+    void
+    restore(ThreadID tid, const Checkpoint &ckpt)
+    {
+        globalRegs[tid] = ckpt.global;
+        if (ckpt.hasLocal())
+            localTable[ckpt.localIdx] = ckpt.local;
+    }
+
+    /** Redo the update of a mispredicted branch with its outcome. */
+    void
+    repair(ThreadID tid, const Checkpoint &ckpt, bool taken)
+    {
+        restore(tid, ckpt);
+        speculate(tid, ckpt.localIdx, taken);
+    }
+
+    /**
+     * Turn the last outcome shifted into the histories into not taken,
+     * for a branch predicted taken that has no target in the BTB.
+     */
+    void
+    clearLast(ThreadID tid, int local_idx=noLocal)
+    {
+        globalRegs[tid] &= ~1U;
+        if (local_idx != noLocal)
+            localTable[local_idx] &= ~1U;
+    }
+
+    /** @{ */
+    /** The raw registers and table, to checkpoint them. */
+    std::vector<unsigned> &globalHistory() { return globalRegs; }
+    const std::vector<unsigned> &globalHistory() const { return globalRegs; }
+    std::vector<unsigned> &localHistory() { return localTable; }
+    const std::vector<unsigned> &localHistory() const { return localTable; }
+    /** @} */
+};
+
+} // namespace branch_prediction
+} // namespace gem5
+
+#endif // __CPU_PRED_SPEC_HISTORY_HH__
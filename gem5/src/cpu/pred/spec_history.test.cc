@@ -0,0 +1,97 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "cpu/pred/spec_history.hh"
+
+using namespace gem5;
+using namespace gem5::branch_prediction;
+
+TEST(SpeculativeHistoryTest, SpeculateShiftsAndMasks)
+{
+    SpeculativeHistory hist(1, 3, 4, 2);
+    hist.speculate(0, 1, true);
+    hist.speculate(0, 1, true);
+    hist.speculate(0, 1, false);
+    hist.speculate(0, 1, true);
+    EXPECT_EQ(0x5u, hist.global(0));
+    EXPECT_EQ(0x1u, hist.local(1));
+    EXPECT_EQ(0u, hist.local(0));
+}
+
+TEST(SpeculativeHistoryTest, RestoreUndoesLaterBranches)
+{
+    SpeculativeHistory hist(1, 8, 4, 8);
+    hist.speculate(0, 2, true);
+    auto ckpt = hist.checkpoint(0, 2);
+    hist.speculate(0, 2, true);
+    hist.speculate(0, SpeculativeHistory::noLocal, false);
+    hist.speculate(0, 2, false);
+    hist.restore(0, ckpt);
+    EXPECT_EQ(0x1u, hist.global(0));
+    EXPECT_EQ(0x1u, hist.local(2));
+}
+
+TEST(SpeculativeHistoryTest, RepairShiftsActualOutcome)
+{
+    SpeculativeHistory hist(1, 8, 4, 8);
+    auto ckpt = hist.checkpoint(0, 3);
+    hist.speculate(0, 3, false);
+    hist.repair(0, ckpt, true);
+    EXPECT_EQ(0x1u, hist.global(0));
+    EXPECT_EQ(0x1u, hist.local(3));
+}
+
+TEST(SpeculativeHistoryTest, NoLocalLeavesLocalHistories)
+{
+    SpeculativeHistory hist(1, 8, 2, 8);
+    auto ckpt = hist.checkpoint(0);
+    EXPECT_FALSE(ckpt.hasLocal());
+    hist.speculate(0, SpeculativeHistory::noLocal, true);
+    hist.restore(0, ckpt);
+    EXPECT_EQ(0u, hist.global(0));
+    EXPECT_EQ(0u, hist.local(0));
+    EXPECT_EQ(0u, hist.local(1));
+}
+
+TEST(SpeculativeHistoryTest, ThreadsAreIndependent)
+{
+    SpeculativeHistory hist(2, 8);
+    hist.speculate(0, SpeculativeHistory::noLocal, true);
+    hist.speculate(1, SpeculativeHistory::noLocal, false);
+    EXPECT_EQ(0x1u, hist.global(0));
+    EXPECT_EQ(0x0u, hist.global(1));
+}
+
+TEST(SpeculativeHistoryTest, ClearLastMakesNotTaken)
+{
+    SpeculativeHistory hist(1, 8, 2, 8);
+    hist.speculate(0, 1, true);
+    hist.speculate(0, 1, true);
+    hist.clearLast(0, 1);
+    EXPECT_EQ(0x2u, hist.global(0));
+    EXPECT_EQ(0x2u, hist.local(1));
+}
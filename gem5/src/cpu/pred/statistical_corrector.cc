@@ -132,19 +132,20 @@ StatisticalCorrector::initBias()
 
 void
 StatisticalCorrector::initGEHLTable(unsigned numLenghts,
-    std::vector<int> lengths, std::vector<int8_t> * & table,
+    std::vector<int> lengths, std::vector<int8_t> & table,
     unsigned logNumEntries, std::vector<int8_t> & w, int8_t wInitValue)
 {
     assert(lengths.size() == numLenghts);
+    fatal_if(numLenghts > maxGEHLLengths, "%s: a GEHL can have at most "
+             "%d lengths, %d given\n", name(), maxGEHLLengths, numLenghts);
     if (numLenghts == 0) {
         return;
     }
-    table = new std::vector<int8_t> [numLenghts];
+    table.resize(numLenghts << logNumEntries, 0);
     for (int i = 0; i < numLenghts; ++i) {
-        table[i].resize(1 << logNumEntries, 0);
         for (int j = 0; j < ((1 << logNumEntries) - 1); ++j) {
             if (! (j & 1)) {
-                table[i][j] = -1;
+                table[(i << logNumEntries) + j] = -1;
             }
         }
     }
@@ -189,17 +190,29 @@ StatisticalCorrector::gIndex(Addr branch_pc, int64_t bhist, int logs, int nbr,
            ((1 << (logs - gIndexLogsSubstr(nbr, i))) - 1);
 }
 
+void
+StatisticalCorrector::gIndices(Addr branch_pc, int64_t hist,
+        const std::vector<int> & length, int nbr, int logs,
+        int64_t * indices)
+{
+    for (int i = 0; i < nbr; i++) {
+        int64_t bhist = hist & ((int64_t) ((1 << length[i]) - 1));
+        indices[i] = ((int64_t) i << logs) +
+                     gIndex(branch_pc, bhist, logs, nbr, i);
+    }
+}
+
 int
 StatisticalCorrector::gPredict(Addr branch_pc, int64_t hist,
-        std::vector<int> & length, std::vector<int8_t> * tab, int nbr,
+        std::vector<int> & length, std::vector<int8_t> & tab, int nbr,
         int logs, std::vector<int8_t> & w)
 {
+    int64_t indices[maxGEHLLengths];
+    gIndices(branch_pc, hist, length, nbr, logs, indices);
+
     int percsum = 0;
     for (int i = 0; i < nbr; i++) {
-        int64_t bhist = hist & ((int64_t) ((1 << length[i]) - 1));
-        int64_t index = gIndex(branch_pc, bhist, logs, nbr, i);
-        int8_t ctr = tab[i][index];
-        percsum += (2 * ctr + 1);
+        percsum += (2 * tab[indices[i]] + 1);
     }
     percsum = (1 + (w[getIndUpds(branch_pc)] >= 0)) * percsum;
     return percsum;
@@ -207,16 +220,17 @@ StatisticalCorrector::gPredict(Addr branch_pc, int64_t hist,
 
 void
 StatisticalCorrector::gUpdate(Addr branch_pc, bool taken, int64_t hist,
-                   std::vector<int> & length, std::vector<int8_t> * tab,
+                   std::vector<int> & length, std::vector<int8_t> & tab,
                    int nbr, int logs, std::vector<int8_t> & w,
                    BranchInfo* bi)
 {
+    int64_t indices[maxGEHLLengths];
+    gIndices(branch_pc, hist, length, nbr, logs, indices);
+
     int percsum = 0;
     for (int i = 0; i < nbr; i++) {
-        int64_t bhist = hist & ((int64_t) ((1 << length[i]) - 1));
-        int64_t index = gIndex(branch_pc, bhist, logs, nbr, i);
-        percsum += (2 * tab[i][index] + 1);
-        ctrUpdate(tab[i][index], taken, scCountersWidth);
+        percsum += (2 * tab[indices[i]] + 1);
+        ctrUpdate(tab[indices[i]], taken, scCountersWidth);
     }
 
     int xsum = bi->lsum - ((w[getIndUpds(branch_pc)] >= 0)) * percsum;
@@ -145,25 +145,30 @@ class StatisticalCorrector : public SimObject
 
     const unsigned numEntriesFirstLocalHistories;
 
+    // The tables of a GEHL are stored back to back in a single array,
+    // table i starting at entry (i << logs), so that the weights of all
+    // the tables can be gathered from their indices in a single pass
+    static constexpr int maxGEHLLengths = 16;
+
     // global backward branch history GEHL
     const unsigned bwnb;
     const unsigned logBwnb;
     std::vector<int> bwm;
-    std::vector<int8_t> * bwgehl;
+    std::vector<int8_t> bwgehl;
     std::vector<int8_t> wbw;
 
     // First local history GEHL
     const unsigned lnb;
     const unsigned logLnb;
     std::vector<int> lm;
-    std::vector<int8_t> * lgehl;
+    std::vector<int8_t> lgehl;
     std::vector<int8_t> wl;
 
     // IMLI GEHL
     const unsigned inb;
     const unsigned logInb;
     std::vector<int> im;
-    std::vector<int8_t> * igehl;
+    std::vector<int8_t> igehl;
     std::vector<int8_t> wi;
 
     std::vector<int8_t> bias;
@@ -248,19 +253,28 @@ class StatisticalCorrector : public SimObject
 
     virtual int gIndexLogsSubstr(int nbr, int i) = 0;
 
+    /**
+     * Computes the entries of all the tables of a GEHL at once, before
+     * any of them is accessed.
+     * @param indices Filled with the nbr entries in the GEHL array
+     */
+    void gIndices(
+        Addr branch_pc, int64_t hist, const std::vector<int> & length,
+        int nbr, int logs, int64_t * indices);
+
     int gPredict(
         Addr branch_pc, int64_t hist, std::vector<int> & length,
-        std::vector<int8_t> * tab, int nbr, int logs,
+        std::vector<int8_t> & tab, int nbr, int logs,
         std::vector<int8_t> & w);
 
     virtual void gUpdate(
         Addr branch_pc, bool taken, int64_t hist, std::vector<int> & length,
-        std::vector<int8_t> * tab, int nbr, int logs,
+        std::vector<int8_t> & tab, int nbr, int logs,
         std::vector<int8_t> & w, BranchInfo* bi);
 
     void initGEHLTable(
         unsigned numLenghts, std::vector<int> lengths,
-        std::vector<int8_t> * & table, unsigned logNumEntries,
+        std::vector<int8_t> & table, unsigned logNumEntries,
         std::vector<int8_t> & w, int8_t wInitValue);
 
     virtual void scHistoryUpdate(
@@ -0,0 +1,139 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/pred/stride_value_pred.hh"
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+namespace value_prediction
+{
+
+StrideValuePredictor::StrideValuePredictor(
+        const StrideValuePredictorParams &p)
+    : ValuePredictor(p),
+      instShiftAmt(p.instShiftAmt),
+      useStride(p.useStride),
+      maxConf(mask(p.confBits)),
+      table(p.tableSize),
+      historyPool(p.numThreads)
+{
+    fatal_if(!isPowerOf2(p.tableSize),
+             "%s: the table size must be a power of 2\n", name());
+    fatal_if(p.confBits == 0 || p.confBits > 8,
+             "%s: confidence counters have between 1 and 8 bits\n", name());
+}
+
+StrideValuePredictor::Entry *
+StrideValuePredictor::findEntry(ThreadID tid, const LoadInfo &li)
+{
+    Entry &entry = table[li.index];
+    if (!entry.valid || entry.tid != tid || entry.pc != li.pc ||
+        entry.upc != li.upc) {
+        return nullptr;
+    }
+    return &entry;
+}
+
+bool
+StrideValuePredictor::lookup(ThreadID tid, Addr pc, MicroPC upc,
+                             RegVal &value, void *&vp_history)
+{
+    LoadInfo *li = historyPool.acquire(tid);
+    li->pc = pc;
+    li->upc = upc;
+    li->index = (loadKey(pc, upc, instShiftAmt) ^ tid) & (table.size() - 1);
+    vp_history = li;
+
+    Entry *entry = findEntry(tid, *li);
+    if (!entry)
+        return false;
+
+    li->counted = true;
+    ++entry->inFlight;
+    value = entry->last + entry->stride * entry->inFlight;
+    return entry->conf == maxConf;
+}
+
+void
+StrideValuePredictor::mispredict(ThreadID tid, void *vp_history)
+{
+    Entry *entry = findEntry(tid, *static_cast<LoadInfo *>(vp_history));
+    if (entry)
+        entry->conf = 0;
+}
+
+void
+StrideValuePredictor::release(ThreadID tid, LoadInfo *li)
+{
+    Entry *entry = findEntry(tid, *li);
+    if (entry && li->counted && entry->inFlight > 0)
+        --entry->inFlight;
+    historyPool.release(tid, li);
+}
+
+void
+StrideValuePredictor::update(ThreadID tid, RegVal value, void *vp_history)
+{
+    LoadInfo *li = static_cast<LoadInfo *>(vp_history);
+
+    Entry *entry = findEntry(tid, *li);
+    if (entry) {
+        const RegVal stride = useStride ? value - entry->last : 0;
+        if (value == entry->last + entry->stride) {
+            if (entry->conf < maxConf)
+                ++entry->conf;
+        } else {
+            entry->conf = 0;
+            entry->stride = stride;
+        }
+        entry->last = value;
+    } else {
+        // Take the entry over, the loads of the previous owner that are
+        // still in flight stop being counted.
+        Entry &victim = table[li->index];
+        victim = Entry();
+        victim.valid = true;
+        victim.tid = tid;
+        victim.pc = li->pc;
+        victim.upc = li->upc;
+        victim.last = value;
+        li->counted = false;
+    }
+
+    release(tid, li);
+}
+
+void
+StrideValuePredictor::squash(ThreadID tid, void *vp_history)
+{
+    release(tid, static_cast<LoadInfo *>(vp_history));
+}
+
+} // namespace value_prediction
+} // namespace gem5
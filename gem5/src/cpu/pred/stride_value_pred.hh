@@ -0,0 +1,106 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_PRED_STRIDE_VALUE_PRED_HH__
+#define __CPU_PRED_STRIDE_VALUE_PRED_HH__
+
+#include <vector>
+
+#include "base/types.hh"
+#include "cpu/pred/history_pool.hh"
+#include "cpu/pred/value_pred.hh"
+#include "params/StrideValuePredictor.hh"
+
+namespace gem5
+{
+
+namespace value_prediction
+{
+
+/**
+ * A stride value predictor: a table indexed by the load address holds the
+ * last value the load read and the difference with the value before. The
+ * prediction is the last value plus the stride, once the same stride was
+ * seen enough times in a row. Without strides, it is a last value
+ * predictor.
+ *
+ * The table is trained at commit, so an entry also counts the instances
+ * of its load that were looked up and are still in flight, and the n-th
+ * of them is predicted n strides away from the last value.
+ */
+class StrideValuePredictor : public ValuePredictor
+{
+  public:
+    StrideValuePredictor(const StrideValuePredictorParams &params);
+
+    bool lookup(ThreadID tid, Addr pc, MicroPC upc, RegVal &value,
+                void *&vp_history) override;
+    void mispredict(ThreadID tid, void *vp_history) override;
+    void update(ThreadID tid, RegVal value, void *vp_history) override;
+    void squash(ThreadID tid, void *vp_history) override;
+
+  private:
+    struct Entry
+    {
+        bool valid = false;
+        ThreadID tid = 0;
+        Addr pc = 0;
+        MicroPC upc = 0;
+        RegVal last = 0;
+        RegVal stride = 0;
+        /** Instances looked up and not trained or squashed yet. */
+        unsigned inFlight = 0;
+        uint8_t conf = 0;
+    };
+
+    /** Per load record, passed around as the value history. */
+    struct LoadInfo
+    {
+        Addr pc = 0;
+        MicroPC upc = 0;
+        unsigned index = 0;
+        /** Whether the load is counted in flight by its entry. */
+        bool counted = false;
+    };
+
+    /** The entry of a load, if it still holds the load. */
+    Entry *findEntry(ThreadID tid, const LoadInfo &li);
+
+    /** Stop counting a load in flight. */
+    void release(ThreadID tid, LoadInfo *li);
+
+    const unsigned instShiftAmt;
+    const bool useStride;
+    const uint8_t maxConf;
+
+    std::vector<Entry> table;
+
+    branch_prediction::HistoryPool<LoadInfo> historyPool;
+};
+
+} // namespace value_prediction
+} // namespace gem5
+
+#endif // __CPU_PRED_STRIDE_VALUE_PRED_HH__
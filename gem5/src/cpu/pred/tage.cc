@@ -50,10 +50,17 @@ namespace gem5
 namespace branch_prediction
 {
 
-TAGE::TAGE(const TAGEParams &params) : BPredUnit(params), tage(params.tage)
+TAGE::TAGE(const TAGEParams &params)
+    : BPredUnit(params), tage(params.tage), historyPool(params.numThreads)
 {
 }
 
+void
+TAGE::freeBranchInfo(ThreadID tid, TageBranchInfo *bi)
+{
+    historyPool.release(tid, bi);
+}
+
 // PREDICTOR UPDATE
 void
 TAGE::update(ThreadID tid, Addr branch_pc, bool taken, void* bp_history,
@@ -83,7 +90,7 @@ TAGE::update(ThreadID tid, Addr branch_pc, bool taken, void* bp_history,
     // optional non speculative update of the histories
     tage->updateHistories(tid, branch_pc, taken, tage_bi, false, inst,
                           corrTarget);
-    delete bi;
+    freeBranchInfo(tid, bi);
 }
 
 void
@@ -91,13 +98,13 @@ TAGE::squash(ThreadID tid, void *bp_history)
 {
     TageBranchInfo *bi = static_cast<TageBranchInfo*>(bp_history);
     DPRINTF(Tage, "Deleting branch info: %lx\n", bi->tageBranchInfo->branchPC);
-    delete bi;
+    freeBranchInfo(tid, bi);
 }
 
 bool
 TAGE::predict(ThreadID tid, Addr branch_pc, bool cond_branch, void* &b)
 {
-    TageBranchInfo *bi = new TageBranchInfo(*tage);//nHistoryTables+1);
+    TageBranchInfo *bi = historyPool.acquire(tid, *tage);
     b = (void*)(bi);
     return tage->tagePredict(tid, branch_pc, cond_branch, bi->tageBranchInfo);
 }
@@ -116,6 +123,21 @@ TAGE::lookup(ThreadID tid, Addr branch_pc, void* &bp_history)
     return retval;
 }
 
+unsigned
+TAGE::lookupBlock(ThreadID tid, const Addr *pcs, unsigned num, bool *taken,
+                  void **bp_history)
+{
+    // Only the call to lookup() is bound statically, predict() stays
+    // virtual for the derived predictors.
+    unsigned i = 0;
+    while (i < num) {
+        taken[i] = TAGE::lookup(tid, pcs[i], bp_history[i]);
+        if (taken[i++])
+            break;
+    }
+    return i;
+}
+
 void
 TAGE::btbUpdate(ThreadID tid, Addr branch_pc, void* &bp_history)
 {
@@ -52,6 +52,7 @@
 
 #include "base/types.hh"
 #include "cpu/pred/bpred_unit.hh"
+#include "cpu/pred/history_pool.hh"
 #include "cpu/pred/tage_base.hh"
 #include "params/TAGE.hh"
 
@@ -79,6 +80,18 @@ class TAGE: public BPredUnit
         }
     };
 
+    /** Recycled storage for the TageBranchInfo records made by predict(). */
+    HistoryPool<TageBranchInfo> historyPool;
+
+    /**
+     * Dispose of a branch info record once the predictor is done with it.
+     * Predictors that override predict() with a derived record type must
+     * override this as well.
+     * @param tid The thread the record was allocated for.
+     * @param bi The record to free.
+     */
+    virtual void freeBranchInfo(ThreadID tid, TageBranchInfo *bi);
+
     virtual bool predict(ThreadID tid, Addr branch_pc, bool cond_branch,
                          void* &b);
 
@@ -89,6 +102,8 @@ class TAGE: public BPredUnit
     // Base class methods.
     void uncondBranch(ThreadID tid, Addr br_pc, void* &bp_history) override;
     bool lookup(ThreadID tid, Addr branch_addr, void* &bp_history) override;
+    unsigned lookupBlock(ThreadID tid, const Addr *pcs, unsigned num,
+                         bool *taken, void **bp_history) override;
     void btbUpdate(ThreadID tid, Addr branch_addr, void* &bp_history) override;
     void update(ThreadID tid, Addr branch_addr, bool taken, void *bp_history,
                 bool squashed, const StaticInstPtr & inst,
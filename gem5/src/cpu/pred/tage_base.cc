@@ -109,9 +109,7 @@ TAGEBase::init()
 
     for (auto& history : threadHistory) {
         history.pathHist = 0;
-        history.globalHistory = new uint8_t[histBufferSize];
-        history.gHist = history.globalHistory;
-        memset(history.gHist, 0, histBufferSize);
+        history.globalHistory.init(histBufferSize);
         history.ptGhist = 0;
     }
 
@@ -147,6 +145,106 @@ TAGEBase::init()
     initialized = true;
 }
 
+void
+TAGEBase::serialize(CheckpointOut &cp) const
+{
+    SERIALIZE_CONTAINER(btablePrediction);
+    SERIALIZE_CONTAINER(btableHysteresis);
+
+    for (int i = 1; i <= nHistoryTables; i++) {
+        const int size = 1 << logTagTableSizes[i];
+        std::vector<int8_t> ctr(size);
+        std::vector<uint16_t> tag(size);
+        std::vector<uint8_t> u(size);
+        for (int j = 0; j < size; j++) {
+            ctr[j] = gtable[i][j].ctr;
+            tag[j] = gtable[i][j].tag;
+            u[j] = gtable[i][j].u;
+        }
+        arrayParamOut(cp, csprintf("gtable%d.ctr", i), ctr);
+        arrayParamOut(cp, csprintf("gtable%d.tag", i), tag);
+        arrayParamOut(cp, csprintf("gtable%d.u", i), u);
+    }
+
+    SERIALIZE_CONTAINER(useAltPredForNewlyAllocated);
+    SERIALIZE_SCALAR(tCounter);
+
+    for (ThreadID tid = 0; tid < threadHistory.size(); tid++) {
+        ScopedCheckpointSection sec(cp, csprintf("thread%d", tid));
+        const ThreadHistory &history = threadHistory[tid];
+
+        paramOut(cp, "pathHist", history.pathHist);
+        paramOut(cp, "ptGhist", history.ptGhist);
+        history.globalHistory.serialize(cp, "globalHistory");
+
+        std::vector<unsigned> ci, ct0, ct1;
+        for (int i = 1; i <= nHistoryTables; i++) {
+            ci.push_back(history.computeIndices[i].comp);
+            ct0.push_back(history.computeTags[0][i].comp);
+            ct1.push_back(history.computeTags[1][i].comp);
+        }
+        SERIALIZE_CONTAINER(ci);
+        SERIALIZE_CONTAINER(ct0);
+        SERIALIZE_CONTAINER(ct1);
+    }
+}
+
+void
+TAGEBase::unserialize(CheckpointIn &cp)
+{
+    const size_t btable_size = btablePrediction.size();
+    const size_t hyst_size = btableHysteresis.size();
+    UNSERIALIZE_CONTAINER(btablePrediction);
+    UNSERIALIZE_CONTAINER(btableHysteresis);
+    fatal_if(btablePrediction.size() != btable_size ||
+             btableHysteresis.size() != hyst_size,
+             "%s: checkpointed bimodal table size mismatch\n", name());
+
+    for (int i = 1; i <= nHistoryTables; i++) {
+        const int size = 1 << logTagTableSizes[i];
+        std::vector<int8_t> ctr(size);
+        std::vector<uint16_t> tag(size);
+        std::vector<uint8_t> u(size);
+        arrayParamIn(cp, csprintf("gtable%d.ctr", i), ctr.data(), size);
+        arrayParamIn(cp, csprintf("gtable%d.tag", i), tag.data(), size);
+        arrayParamIn(cp, csprintf("gtable%d.u", i), u.data(), size);
+        for (int j = 0; j < size; j++) {
+            gtable[i][j].ctr = ctr[j];
+            gtable[i][j].tag = tag[j];
+            gtable[i][j].u = u[j];
+        }
+    }
+
+    arrayParamIn(cp, "useAltPredForNewlyAllocated",
+                 useAltPredForNewlyAllocated.data(),
+                 useAltPredForNewlyAllocated.size());
+    UNSERIALIZE_SCALAR(tCounter);
+
+    for (ThreadID tid = 0; tid < threadHistory.size(); tid++) {
+        ScopedCheckpointSection sec(cp, csprintf("thread%d", tid));
+        ThreadHistory &history = threadHistory[tid];
+
+        paramIn(cp, "pathHist", history.pathHist);
+        paramIn(cp, "ptGhist", history.ptGhist);
+        history.globalHistory.unserialize(cp, "globalHistory");
+        fatal_if(history.ptGhist < 0 ||
+                 history.ptGhist >= history.globalHistory.size(),
+                 "%s: checkpointed history pointer out of range\n", name());
+
+        std::vector<unsigned> ci(nHistoryTables);
+        std::vector<unsigned> ct0(nHistoryTables);
+        std::vector<unsigned> ct1(nHistoryTables);
+        arrayParamIn(cp, "ci", ci.data(), nHistoryTables);
+        arrayParamIn(cp, "ct0", ct0.data(), nHistoryTables);
+        arrayParamIn(cp, "ct1", ct1.data(), nHistoryTables);
+        for (int i = 1; i <= nHistoryTables; i++) {
+            history.computeIndices[i].comp = ci[i - 1];
+            history.computeTags[0][i].comp = ct0[i - 1];
+            history.computeTags[1][i].comp = ct1[i - 1];
+        }
+    }
+}
+
 void
 TAGEBase::initFoldedHistories(ThreadHistory & history)
 {
@@ -190,15 +288,14 @@ TAGEBase::btbUpdate(ThreadID tid, Addr branch_pc, BranchInfo* &bi)
     if (speculativeHistUpdate) {
         ThreadHistory& tHist = threadHistory[tid];
         DPRINTF(Tage, "BTB miss resets prediction: %lx\n", branch_pc);
-        assert(tHist.gHist == &tHist.globalHistory[tHist.ptGhist]);
-        tHist.gHist[0] = 0;
+        tHist.globalHistory.set(tHist.ptGhist, false);
         for (int i = 1; i <= nHistoryTables; i++) {
             tHist.computeIndices[i].comp = bi->ci[i];
             tHist.computeTags[0][i].comp = bi->ct0[i];
             tHist.computeTags[1][i].comp = bi->ct1[i];
-            tHist.computeIndices[i].update(tHist.gHist);
-            tHist.computeTags[0][i].update(tHist.gHist);
-            tHist.computeTags[1][i].update(tHist.gHist);
+            tHist.computeIndices[i].update(tHist.globalHistory, tHist.ptGhist);
+            tHist.computeTags[0][i].update(tHist.globalHistory, tHist.ptGhist);
+            tHist.computeTags[1][i].update(tHist.globalHistory, tHist.ptGhist);
         }
     }
 }
@@ -316,24 +413,14 @@ TAGEBase::baseUpdate(Addr pc, bool taken, BranchInfo* bi)
     DPRINTF(Tage, "Updating branch %lx, pred:%d, hyst:%d\n", pc, pred, hyst);
 }
 
-// shifting the global history:  we manage the history in a big table in order
-// to reduce simulation time
+// shifting the global history: the history is a circular bit buffer, so
+// that the pointers saved by in-flight branches remain valid and nothing
+// has to be copied when it wraps around
 void
-TAGEBase::updateGHist(uint8_t * &h, bool dir, uint8_t * tab, int &pt)
-{
-    if (pt == 0) {
-        DPRINTF(Tage, "Rolling over the histories\n");
-         // Copy beginning of globalHistoryBuffer to end, such that
-         // the last maxHist outcomes are still reachable
-         // through pt[0 .. maxHist - 1].
-         for (int i = 0; i < maxHist; i++)
-             tab[histBufferSize - maxHist + i] = tab[i];
-         pt =  histBufferSize - maxHist;
-         h = &tab[pt];
-    }
-    pt--;
-    h--;
-    h[0] = (dir) ? 1 : 0;
+TAGEBase::updateGHist(GlobalHistory &h, bool dir, int &pt)
+{
+    pt = h.next(pt);
+    h.set(pt, dir);
 }
 
 void
@@ -597,7 +684,7 @@ TAGEBase::updateHistories(ThreadID tid, Addr branch_pc, bool taken,
     bool pathbit = ((branch_pc >> instShiftAmt) & 1);
     //on a squash, return pointers to this and recompute indices.
     //update user history
-    updateGHist(tHist.gHist, taken, tHist.globalHistory, tHist.ptGhist);
+    updateGHist(tHist.globalHistory, taken, tHist.ptGhist);
     tHist.pathHist = (tHist.pathHist << 1) + pathbit;
     tHist.pathHist = (tHist.pathHist & ((1ULL << pathHistBits) - 1));
 
@@ -614,15 +701,13 @@ TAGEBase::updateHistories(ThreadID tid, Addr branch_pc, bool taken,
             bi->ct0[i] = tHist.computeTags[0][i].comp;
             bi->ct1[i] = tHist.computeTags[1][i].comp;
         }
-        tHist.computeIndices[i].update(tHist.gHist);
-        tHist.computeTags[0][i].update(tHist.gHist);
-        tHist.computeTags[1][i].update(tHist.gHist);
+        tHist.computeIndices[i].update(tHist.globalHistory, tHist.ptGhist);
+        tHist.computeTags[0][i].update(tHist.globalHistory, tHist.ptGhist);
+        tHist.computeTags[1][i].update(tHist.globalHistory, tHist.ptGhist);
     }
     DPRINTF(Tage, "Updating global histories with branch:%lx; taken?:%d, "
             "path Hist: %x; pointer:%d\n", branch_pc, taken, tHist.pathHist,
             tHist.ptGhist);
-    assert(threadHistory[tid].gHist ==
-            &threadHistory[tid].globalHistory[threadHistory[tid].ptGhist]);
 }
 
 void
@@ -639,15 +724,14 @@ TAGEBase::squash(ThreadID tid, bool taken, TAGEBase::BranchInfo *bi,
             "pointer:%d\n", bi->branchPC,taken, bi->pathHist, bi->ptGhist);
     tHist.pathHist = bi->pathHist;
     tHist.ptGhist = bi->ptGhist;
-    tHist.gHist = &(tHist.globalHistory[tHist.ptGhist]);
-    tHist.gHist[0] = (taken ? 1 : 0);
+    tHist.globalHistory.set(tHist.ptGhist, taken);
     for (int i = 1; i <= nHistoryTables; i++) {
         tHist.computeIndices[i].comp = bi->ci[i];
         tHist.computeTags[0][i].comp = bi->ct0[i];
         tHist.computeTags[1][i].comp = bi->ct1[i];
-        tHist.computeIndices[i].update(tHist.gHist);
-        tHist.computeTags[0][i].update(tHist.gHist);
-        tHist.computeTags[1][i].update(tHist.gHist);
+        tHist.computeIndices[i].update(tHist.globalHistory, tHist.ptGhist);
+        tHist.computeTags[0][i].update(tHist.globalHistory, tHist.ptGhist);
+        tHist.computeTags[1][i].update(tHist.globalHistory, tHist.ptGhist);
     }
 }
 
@@ -710,16 +794,7 @@ TAGEBase::updateStats(bool taken, BranchInfo* bi)
 unsigned
 TAGEBase::getGHR(ThreadID tid, BranchInfo *bi) const
 {
-    unsigned val = 0;
-    for (unsigned i = 0; i < 32; i++) {
-        // Make sure we don't go out of bounds
-        int gh_offset = bi->ptGhist + i;
-        assert(&(threadHistory[tid].globalHistory[gh_offset]) <
-               threadHistory[tid].globalHistory + histBufferSize);
-        val |= ((threadHistory[tid].globalHistory[gh_offset] & 0x1) << i);
-    }
-
-    return val;
+    return threadHistory[tid].globalHistory.read(bi->ptGhist, 32);
 }
 
 TAGEBase::TAGEBaseStats::TAGEBaseStats(
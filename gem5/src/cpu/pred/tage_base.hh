@@ -48,6 +48,8 @@
 #ifndef __CPU_PRED_TAGE_BASE_HH__
 #define __CPU_PRED_TAGE_BASE_HH__
 
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 
 #include "base/statistics.hh"
@@ -68,6 +70,9 @@ class TAGEBase : public SimObject
     TAGEBase(const TAGEBaseParams &p);
     void init() override;
 
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+
   protected:
     // Prediction Structures
 
@@ -80,6 +85,93 @@ class TAGEBase : public SimObject
         TageEntry() : ctr(0), tag(0), u(0) { }
     };
 
+  public:
+    // The global history and the folded histories computed from it are
+    // also used by the ITTAGE indirect predictor.
+
+    // Global branch direction history, one bit per outcome, packed in a
+    // circular buffer of 64-bit words. Outcomes are pushed at decreasing
+    // positions, so that when the most recent one is at position pt, the
+    // outcome of the i-th previous branch is at position pt + i.
+    class GlobalHistory
+    {
+        std::vector<uint64_t> words;
+        unsigned numBits = 0;
+
+        unsigned
+        wrap(unsigned pos) const
+        {
+            return pos >= numBits ? pos - numBits : pos;
+        }
+
+      public:
+        void
+        init(unsigned num_bits)
+        {
+            numBits = num_bits;
+            words.assign((num_bits + 63) / 64, 0);
+        }
+
+        unsigned size() const { return numBits; }
+
+        void
+        serialize(CheckpointOut &cp, const std::string &name) const
+        {
+            arrayParamOut(cp, name, words);
+        }
+
+        void
+        unserialize(CheckpointIn &cp, const std::string &name)
+        {
+            arrayParamIn(cp, name, words.data(), words.size());
+        }
+
+        // Outcome of the age-th most recent branch, pt being the
+        // position of the most recent one
+        bool
+        at(int pt, unsigned age) const
+        {
+            const unsigned pos = wrap(pt + age);
+            return (words[pos / 64] >> (pos % 64)) & 1;
+        }
+
+        void
+        set(int pt, bool dir)
+        {
+            const uint64_t bit = 1ULL << (pt % 64);
+            if (dir) {
+                words[pt / 64] |= bit;
+            } else {
+                words[pt / 64] &= ~bit;
+            }
+        }
+
+        // Position the outcome following the one at pt goes to
+        int next(int pt) const { return (pt == 0 ? numBits : pt) - 1; }
+
+        // The outcomes of the n <= 64 branches starting at position pt,
+        // the most recent one in the least significant bit
+        uint64_t
+        read(int pt, unsigned n) const
+        {
+            uint64_t val = 0;
+            unsigned done = 0;
+            while (done < n) {
+                const unsigned pos = wrap(pt + done);
+                const unsigned offset = pos % 64;
+                const unsigned chunk =
+                    std::min({n - done, 64 - offset, numBits - pos});
+                uint64_t bits = words[pos / 64] >> offset;
+                if (chunk < 64) {
+                    bits &= (1ULL << chunk) - 1;
+                }
+                val |= bits << done;
+                done += chunk;
+            }
+            return val;
+        }
+    };
+
     // Folded History Table - compressed history
     // to mix with instruction PC to index partially
     // tagged tables.
@@ -103,10 +195,10 @@ class TAGEBase : public SimObject
             outpoint = original_length % compressed_length;
         }
 
-        void update(uint8_t * h)
+        void update(const GlobalHistory &h, int pt)
         {
-            comp = (comp << 1) | h[0];
-            comp ^= h[origLength] << outpoint;
+            comp = (comp << 1) | h.at(pt, 0);
+            comp ^= unsigned(h.at(pt, origLength)) << outpoint;
             comp ^= (comp >> compLength);
             comp &= (1ULL << compLength) - 1;
         }
@@ -259,13 +351,12 @@ class TAGEBase : public SimObject
 
    /**
     * (Speculatively) updates the global branch history.
-    * @param h Reference to pointer to global branch history.
+    * @param h Reference to the global branch history.
     * @param dir (Predicted) outcome to update the histories
     * with.
-    * @param tab
-    * @param PT Reference to path history.
+    * @param PT Reference to the index of the most recent outcome.
     */
-    void updateGHist(uint8_t * &h, bool dir, uint8_t * tab, int &PT);
+    void updateGHist(GlobalHistory &h, bool dir, int &PT);
 
     /**
      * Update TAGE. Called at execute to repair histories on a misprediction
@@ -447,11 +538,7 @@ class TAGEBase : public SimObject
 
         // Speculative branch direction
         // history (circular buffer)
-        // @TODO Convert to std::vector<bool>
-        uint8_t *globalHistory;
-
-        // Pointer to most recent branch outcome
-        uint8_t* gHist;
+        GlobalHistory globalHistory;
 
         // Index to most recent branch outcome
         int ptGhist;
@@ -247,16 +247,16 @@ TAGE_SC_L_TAGE::updatePathAndGlobalHistory(
         tmp >>= 1;
         int pathbit = (path & 127);
         path >>= 1;
-        updateGHist(tHist.gHist, dir, tHist.globalHistory, tHist.ptGhist);
+        updateGHist(tHist.globalHistory, dir, tHist.ptGhist);
         tHist.pathHist = (tHist.pathHist << 1) ^ pathbit;
         if (truncatePathHist) {
             // The 8KB implementation does not do this truncation
             tHist.pathHist = (tHist.pathHist & ((1ULL << pathHistBits) - 1));
         }
         for (int i = 1; i <= nHistoryTables; i++) {
-            tHist.computeIndices[i].update(tHist.gHist);
-            tHist.computeTags[0][i].update(tHist.gHist);
-            tHist.computeTags[1][i].update(tHist.gHist);
+            tHist.computeIndices[i].update(tHist.globalHistory, tHist.ptGhist);
+            tHist.computeTags[0][i].update(tHist.globalHistory, tHist.ptGhist);
+            tHist.computeTags[1][i].update(tHist.globalHistory, tHist.ptGhist);
         }
     }
 }
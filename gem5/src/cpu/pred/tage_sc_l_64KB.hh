@@ -82,28 +82,28 @@ class TAGE_SC_L_64KB_StatisticalCorrector : public StatisticalCorrector
     const unsigned pnb;
     const unsigned logPnb;
     std::vector<int> pm;
-    std::vector<int8_t> * pgehl;
+    std::vector<int8_t> pgehl;
     std::vector<int8_t> wp;
 
     // Second local history GEHL
     const unsigned snb;
     const unsigned logSnb;
     std::vector<int> sm;
-    std::vector<int8_t> * sgehl;
+    std::vector<int8_t> sgehl;
     std::vector<int8_t> ws;
 
     // Third local history GEHL
     const unsigned tnb;
     const unsigned logTnb;
     std::vector<int> tm;
-    std::vector<int8_t> * tgehl;
+    std::vector<int8_t> tgehl;
     std::vector<int8_t> wt;
 
     // Second IMLI GEHL
     const unsigned imnb;
     const unsigned logImnb;
     std::vector<int> imm;
-    std::vector<int8_t> * imgehl;
+    std::vector<int8_t> imgehl;
     std::vector<int8_t> wim;
 
     struct SC_64KB_ThreadHistory : public SCThreadHistory
@@ -79,7 +79,7 @@ class TAGE_SC_L_8KB_StatisticalCorrector : public StatisticalCorrector
     const unsigned gnb;
     const unsigned logGnb;
     std::vector<int> gm;
-    std::vector<int8_t> * ggehl;
+    std::vector<int8_t> ggehl;
     std::vector<int8_t> wg;
 
     struct SC_8KB_ThreadHistory : public SCThreadHistory
@@ -53,13 +53,12 @@ TournamentBP::TournamentBP(const TournamentBPParams &params)
     : BPredUnit(params),
       localPredictorSize(params.localPredictorSize),
       localCtrBits(params.localCtrBits),
-      localCtrs(localPredictorSize, SatCounter8(localCtrBits)),
+      localCtrs(localPredictorSize, localCtrBits),
       localHistoryTableSize(params.localHistoryTableSize),
       localHistoryBits(ceilLog2(params.localPredictorSize)),
       globalPredictorSize(params.globalPredictorSize),
       globalCtrBits(params.globalCtrBits),
-      globalCtrs(globalPredictorSize, SatCounter8(globalCtrBits)),
-      globalHistory(params.numThreads, 0),
+      globalCtrs(globalPredictorSize, globalCtrBits),
       globalHistoryBits(
           ceilLog2(params.globalPredictorSize) >
           ceilLog2(params.choicePredictorSize) ?
@@ -67,7 +66,10 @@ TournamentBP::TournamentBP(const TournamentBPParams &params)
           ceilLog2(params.choicePredictorSize)),
       choicePredictorSize(params.choicePredictorSize),
       choiceCtrBits(params.choiceCtrBits),
-      choiceCtrs(choicePredictorSize, SatCounter8(choiceCtrBits))
+      choiceCtrs(choicePredictorSize, choiceCtrBits),
+      specHistory(params.numThreads, globalHistoryBits,
+                  params.localHistoryTableSize, localHistoryBits),
+      historyPool(params.numThreads)
 {
     if (!isPowerOf2(localPredictorSize)) {
         fatal("Invalid local predictor size!\n");
@@ -83,12 +85,6 @@ TournamentBP::TournamentBP(const TournamentBPParams &params)
         fatal("Invalid local history table size!\n");
     }
 
-    //Setup the history table for the local table
-    localHistoryTable.resize(localHistoryTableSize);
-
-    for (int i = 0; i < localHistoryTableSize; ++i)
-        localHistoryTable[i] = 0;
-
     // Set up the global history mask
     // this is equivalent to mask(log2(globalPredictorSize)
     globalHistoryMask = globalPredictorSize - 1;
@@ -132,48 +128,11 @@ TournamentBP::calcLocHistIdx(Addr &branch_addr)
     return (branch_addr >> instShiftAmt) & (localHistoryTableSize - 1);
 }
 
-inline
-void
-TournamentBP::updateGlobalHistTaken(ThreadID tid)
-{
-    globalHistory[tid] = (globalHistory[tid] << 1) | 1;
-    globalHistory[tid] = globalHistory[tid] & historyRegisterMask;
-}
-
-inline
-void
-TournamentBP::updateGlobalHistNotTaken(ThreadID tid)
-{
-    globalHistory[tid] = (globalHistory[tid] << 1);
-    globalHistory[tid] = globalHistory[tid] & historyRegisterMask;
-}
-
-inline
-void
-TournamentBP::updateLocalHistTaken(unsigned local_history_idx)
-{
-    localHistoryTable[local_history_idx] =
-        (localHistoryTable[local_history_idx] << 1) | 1;
-}
-
-inline
-void
-TournamentBP::updateLocalHistNotTaken(unsigned local_history_idx)
-{
-    localHistoryTable[local_history_idx] =
-        (localHistoryTable[local_history_idx] << 1);
-}
-
-
 void
 TournamentBP::btbUpdate(ThreadID tid, Addr branch_addr, void * &bp_history)
 {
-    unsigned local_history_idx = calcLocHistIdx(branch_addr);
-    //Update Global History to Not Taken (clear LSB)
-    globalHistory[tid] &= (historyRegisterMask & ~1ULL);
-    //Update Local History to Not Taken
-    localHistoryTable[local_history_idx] =
-       localHistoryTable[local_history_idx] & (localPredictorMask & ~1ULL);
+    //Update the global and local histories to Not Taken
+    specHistory.clearLast(tid, calcLocHistIdx(branch_addr));
 }
 
 bool
@@ -188,69 +147,62 @@ TournamentBP::lookup(ThreadID tid, Addr branch_addr, void * &bp_history)
 
     //Lookup in the local predictor to get its branch prediction
     local_history_idx = calcLocHistIdx(branch_addr);
-    local_predictor_idx = localHistoryTable[local_history_idx]
+    local_predictor_idx = specHistory.local(local_history_idx)
         & localPredictorMask;
     local_prediction = localCtrs[local_predictor_idx] > localThreshold;
 
     //Lookup in the global predictor to get its branch prediction
     global_prediction = globalThreshold <
-      globalCtrs[globalHistory[tid] & globalHistoryMask];
+      globalCtrs[specHistory.global(tid) & globalHistoryMask];
 
     //Lookup in the choice predictor to see which one to use
     choice_prediction = choiceThreshold <
-      choiceCtrs[globalHistory[tid] & choiceHistoryMask];
+      choiceCtrs[specHistory.global(tid) & choiceHistoryMask];
 
     // Create BPHistory and pass it back to be recorded.
-    BPHistory *history = new BPHistory;
-    history->globalHistory = globalHistory[tid];
+    BPHistory *history = historyPool.acquire(tid);
+    history->hist = specHistory.checkpoint(tid, local_history_idx);
     history->localPredTaken = local_prediction;
     history->globalPredTaken = global_prediction;
     history->globalUsed = choice_prediction;
-    history->localHistoryIdx = local_history_idx;
-    history->localHistory = local_predictor_idx;
     bp_history = (void *)history;
 
     assert(local_history_idx < localHistoryTableSize);
 
     // Speculative update of the global history and the
     // selected local history.
-    if (choice_prediction) {
-        if (global_prediction) {
-            updateGlobalHistTaken(tid);
-            updateLocalHistTaken(local_history_idx);
-            return true;
-        } else {
-            updateGlobalHistNotTaken(tid);
-            updateLocalHistNotTaken(local_history_idx);
-            return false;
-        }
-    } else {
-        if (local_prediction) {
-            updateGlobalHistTaken(tid);
-            updateLocalHistTaken(local_history_idx);
-            return true;
-        } else {
-            updateGlobalHistNotTaken(tid);
-            updateLocalHistNotTaken(local_history_idx);
-            return false;
-        }
+    bool prediction = choice_prediction ? global_prediction :
+                                          local_prediction;
+    specHistory.speculate(tid, local_history_idx, prediction);
+    return prediction;
+}
+
+unsigned
+TournamentBP::lookupBlock(ThreadID tid, const Addr *pcs, unsigned num,
+                          bool *taken, void **bp_history)
+{
+    // The qualified call binds statically and is inlined here.
+    unsigned i = 0;
+    while (i < num) {
+        taken[i] = TournamentBP::lookup(tid, pcs[i], bp_history[i]);
+        if (taken[i++])
+            break;
     }
+    return i;
 }
 
 void
 TournamentBP::uncondBranch(ThreadID tid, Addr pc, void * &bp_history)
 {
     // Create BPHistory and pass it back to be recorded.
-    BPHistory *history = new BPHistory;
-    history->globalHistory = globalHistory[tid];
+    BPHistory *history = historyPool.acquire(tid);
+    history->hist = specHistory.checkpoint(tid);
     history->localPredTaken = true;
     history->globalPredTaken = true;
     history->globalUsed = true;
-    history->localHistoryIdx = invalidPredictorIndex;
-    history->localHistory = invalidPredictorIndex;
     bp_history = static_cast<void *>(history);
 
-    updateGlobalHistTaken(tid);
+    specHistory.speculate(tid, SpeculativeHistory::noLocal, true);
 }
 
 void
@@ -262,32 +214,18 @@ TournamentBP::update(ThreadID tid, Addr branch_addr, bool taken,
 
     BPHistory *history = static_cast<BPHistory *>(bp_history);
 
-    unsigned local_history_idx = calcLocHistIdx(branch_addr);
-
-    assert(local_history_idx < localHistoryTableSize);
-
     // Unconditional branches do not use local history.
-    bool old_local_pred_valid = history->localHistory !=
-            invalidPredictorIndex;
+    bool old_local_pred_valid = history->hist.hasLocal();
 
     // If this is a misprediction, restore the speculatively
     // updated state (global history register and local history)
     // and update again.
     if (squashed) {
-        // Global history restore and update
-        globalHistory[tid] = (history->globalHistory << 1) | taken;
-        globalHistory[tid] &= historyRegisterMask;
-
-        // Local history restore and update.
-        if (old_local_pred_valid) {
-            localHistoryTable[local_history_idx] =
-                        (history->localHistory << 1) | taken;
-        }
-
+        specHistory.repair(tid, history->hist, taken);
         return;
     }
 
-    unsigned old_local_pred_index = history->localHistory &
+    unsigned old_local_pred_index = history->hist.local &
         localPredictorMask;
 
     assert(old_local_pred_index < localPredictorSize);
@@ -301,7 +239,7 @@ TournamentBP::update(ThreadID tid, Addr branch_addr, bool taken,
         // decrement the counter. Otherwise increment the
         // counter.
         unsigned choice_predictor_idx =
-            history->globalHistory & choiceHistoryMask;
+            history->hist.global & choiceHistoryMask;
         if (history->localPredTaken == taken) {
             choiceCtrs[choice_predictor_idx]--;
         } else if (history->globalPredTaken == taken) {
@@ -315,7 +253,7 @@ TournamentBP::update(ThreadID tid, Addr branch_addr, bool taken,
     // recomputed upon update(squash = true) calls,
     // so they do not need to be updated.
     unsigned global_predictor_idx =
-            history->globalHistory & globalHistoryMask;
+            history->hist.global & globalHistoryMask;
     if (taken) {
         globalCtrs[global_predictor_idx]++;
         if (old_local_pred_valid) {
@@ -328,8 +266,8 @@ TournamentBP::update(ThreadID tid, Addr branch_addr, bool taken,
         }
     }
 
-    // We're done with this history, now delete it.
-    delete history;
+    // We're done with this history, now recycle it.
+    historyPool.release(tid, history);
 }
 
 void
@@ -337,16 +275,32 @@ TournamentBP::squash(ThreadID tid, void *bp_history)
 {
     BPHistory *history = static_cast<BPHistory *>(bp_history);
 
-    // Restore global history to state prior to this branch.
-    globalHistory[tid] = history->globalHistory;
+    // Restore the global and local histories to their state prior to
+    // this branch.
+    specHistory.restore(tid, history->hist);
 
-    // Restore local history
-    if (history->localHistoryIdx != invalidPredictorIndex) {
-        localHistoryTable[history->localHistoryIdx] = history->localHistory;
-    }
+    // Recycle this BPHistory now that we're done with it.
+    historyPool.release(tid, history);
+}
 
-    // Delete this BPHistory now that we're done with it.
-    delete history;
+void
+TournamentBP::serialize(CheckpointOut &cp) const
+{
+    serializeCounters(cp, "localCtrs", localCtrs);
+    arrayParamOut(cp, "localHistoryTable", specHistory.localHistory());
+    serializeCounters(cp, "globalCtrs", globalCtrs);
+    arrayParamOut(cp, "globalHistory", specHistory.globalHistory());
+    serializeCounters(cp, "choiceCtrs", choiceCtrs);
+}
+
+void
+TournamentBP::unserialize(CheckpointIn &cp)
+{
+    unserializeCounters(cp, "localCtrs", localCtrs);
+    unserializeTable(cp, "localHistoryTable", specHistory.localHistory());
+    unserializeCounters(cp, "globalCtrs", globalCtrs);
+    unserializeTable(cp, "globalHistory", specHistory.globalHistory());
+    unserializeCounters(cp, "choiceCtrs", choiceCtrs);
 }
 
 #ifdef DEBUG
@@ -46,6 +46,8 @@
 #include "base/sat_counter.hh"
 #include "base/types.hh"
 #include "cpu/pred/bpred_unit.hh"
+#include "cpu/pred/history_pool.hh"
+#include "cpu/pred/spec_history.hh"
 #include "params/TournamentBP.hh"
 
 namespace gem5
@@ -80,6 +82,13 @@ class TournamentBP : public BPredUnit
      */
     bool lookup(ThreadID tid, Addr branch_addr, void * &bp_history);
 
+    /**
+     * Looks up consecutive branches of a fetch block, until one is
+     * predicted taken.
+     */
+    unsigned lookupBlock(ThreadID tid, const Addr *pcs, unsigned num,
+                         bool *taken, void **bp_history) override;
+
     /**
      * Records that there was an unconditional branch, and modifies
      * the bp history to point to an object that has the previous
@@ -117,6 +126,9 @@ class TournamentBP : public BPredUnit
      */
     void squash(ThreadID tid, void *bp_history);
 
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+
   private:
     /**
      * Returns if the branch should be taken or not, given a counter
@@ -131,26 +143,6 @@ class TournamentBP : public BPredUnit
      */
     inline unsigned calcLocHistIdx(Addr &branch_addr);
 
-    /** Updates global history as taken. */
-    inline void updateGlobalHistTaken(ThreadID tid);
-
-    /** Updates global history as not taken. */
-    inline void updateGlobalHistNotTaken(ThreadID tid);
-
-    /**
-     * Updates local histories as taken.
-     * @param local_history_idx The local history table entry that
-     * will be updated.
-     */
-    inline void updateLocalHistTaken(unsigned local_history_idx);
-
-    /**
-     * Updates local histories as not taken.
-     * @param local_history_idx The local history table entry that
-     * will be updated.
-     */
-    inline void updateLocalHistNotTaken(unsigned local_history_idx);
-
     /**
      * The branch history information that is created upon predicting
      * a branch.  It will be passed back upon updating and squashing,
@@ -167,16 +159,13 @@ class TournamentBP : public BPredUnit
 
         static int newCount;
 #endif
-        unsigned globalHistory;
-        unsigned localHistoryIdx;
-        unsigned localHistory;
+        /** The histories the branch was predicted with. */
+        SpeculativeHistory::Checkpoint hist;
         bool localPredTaken;
         bool globalPredTaken;
         bool globalUsed;
     };
 
-    /** Flag for invalid predictor index */
-    static const int invalidPredictorIndex = -1;
     /** Number of counters in the local predictor. */
     unsigned localPredictorSize;
 
@@ -187,10 +176,7 @@ class TournamentBP : public BPredUnit
     unsigned localCtrBits;
 
     /** Local counters. */
-    std::vector<SatCounter8> localCtrs;
-
-    /** Array of local history table entries. */
-    std::vector<unsigned> localHistoryTable;
+    SatCounterArray<> localCtrs;
 
     /** Number of entries in the local history table. */
     unsigned localHistoryTableSize;
@@ -205,12 +191,7 @@ class TournamentBP : public BPredUnit
     unsigned globalCtrBits;
 
     /** Array of counters that make up the global predictor. */
-    std::vector<SatCounter8> globalCtrs;
-
-    /** Global history register. Contains as much history as specified by
-     *  globalHistoryBits. Actual number of bits used is determined by
-     *  globalHistoryMask and choiceHistoryMask. */
-    std::vector<unsigned> globalHistory;
+    SatCounterArray<> globalCtrs;
 
     /** Number of bits for the global history. Determines maximum number of
         entries in global and choice predictor tables. */
@@ -235,7 +216,7 @@ class TournamentBP : public BPredUnit
     unsigned choiceCtrBits;
 
     /** Array of counters that make up the choice predictor. */
-    std::vector<SatCounter8> choiceCtrs;
+    SatCounterArray<> choiceCtrs;
 
     /** Thresholds for the counter value; above the threshold is taken,
      *  equal to or below the threshold is not taken.
@@ -243,6 +224,15 @@ class TournamentBP : public BPredUnit
     unsigned localThreshold;
     unsigned globalThreshold;
     unsigned choiceThreshold;
+
+    /** The global history registers, which contain as much history as
+     *  specified by globalHistoryBits, and the local history table. The
+     *  number of global history bits actually used is determined by
+     *  globalHistoryMask and choiceHistoryMask. */
+    SpeculativeHistory specHistory;
+
+    /** Recycled storage for the in-flight BPHistory records. */
+    HistoryPool<BPHistory> historyPool;
 };
 
 } // namespace branch_prediction
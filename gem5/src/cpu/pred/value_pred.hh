@@ -0,0 +1,135 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_PRED_VALUE_PRED_HH__
+#define __CPU_PRED_VALUE_PRED_HH__
+
+#include "base/types.hh"
+#include "cpu/inst_seq.hh"
+#include "params/ValuePredictor.hh"
+#include "sim/sim_object.hh"
+
+namespace gem5
+{
+
+namespace value_prediction
+{
+
+/**
+ * Base class of the load value predictors. The CPU looks a predictor up
+ * for a load in program order, and uses the value when the predictor is
+ * confident, waking up the dependents of the load before it reads memory.
+ *
+ * A lookup hands back an opaque record of the state the prediction was
+ * made with. The record is given back exactly once, either to update()
+ * with the value the load read when it commits, or to squash() if it
+ * does not. Training in program order keeps the predictors simple, and
+ * mispredict() lowers the confidence of a wrong prediction right away.
+ *
+ * Predictors indexed with the branch history are told about the
+ * conditional branches, in program order as well, and about the squashes
+ * and commits that move their history.
+ */
+class ValuePredictor : public SimObject
+{
+  public:
+    typedef ValuePredictorParams Params;
+
+    ValuePredictor(const Params &params) : SimObject(params) {}
+
+    /**
+     * Predict the value of a load.
+     * @param tid The thread of the load.
+     * @param pc The address of the load.
+     * @param upc The micro-op of the load.
+     * @param value Set to the predicted value.
+     * @param vp_history Set to the record of the prediction.
+     * @return Whether the prediction is confident enough to be used.
+     */
+    virtual bool lookup(ThreadID tid, Addr pc, MicroPC upc, RegVal &value,
+                        void *&vp_history) = 0;
+
+    /**
+     * Tell the predictor that a value it was confident about was wrong, as
+     * soon as the load reads memory. The younger instances of the load
+     * should not be predicted with the same confidence until the load is
+     * trained.
+     * @param tid The thread of the load.
+     * @param vp_history The record of the prediction, kept.
+     */
+    virtual void mispredict(ThreadID tid, void *vp_history) = 0;
+
+    /**
+     * Train the predictor with the value a load read, when it commits.
+     * @param tid The thread of the load.
+     * @param value The value the load read.
+     * @param vp_history The record of the prediction, released.
+     */
+    virtual void update(ThreadID tid, RegVal value, void *vp_history) = 0;
+
+    /** Release the record of a load that was squashed. */
+    virtual void squash(ThreadID tid, void *vp_history) = 0;
+
+    /** Record the predicted direction of a conditional branch. */
+    virtual void
+    updateHistory(ThreadID tid, InstSeqNum seq_num, bool taken)
+    {
+    }
+
+    /**
+     * Undo the history of the branches younger than a squash.
+     * @param squashed_sn The youngest instruction that was not squashed.
+     * @param mispredicted Whether that instruction is a mispredicted
+     *                     conditional branch, whose direction is fixed.
+     * @param taken The actual direction of the mispredicted branch.
+     */
+    virtual void
+    squashHistory(ThreadID tid, InstSeqNum squashed_sn, bool mispredicted,
+                  bool taken)
+    {
+    }
+
+    /** Forget the history of the branches that committed. */
+    virtual void
+    commitHistory(ThreadID tid, InstSeqNum done_sn)
+    {
+    }
+
+  protected:
+    /**
+     * The address a load is indexed with. The micro-ops are spread over
+     * the table, and leave the address alone when there are none.
+     */
+    static Addr
+    loadKey(Addr pc, MicroPC upc, unsigned inst_shift_amt)
+    {
+        return (pc >> inst_shift_amt) ^ (Addr(upc) * 0x9e3779b1);
+    }
+};
+
+} // namespace value_prediction
+} // namespace gem5
+
+#endif // __CPU_PRED_VALUE_PRED_HH__
@@ -0,0 +1,330 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/pred/vtage.hh"
+
+#include <cmath>
+#include <cstdlib>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+namespace value_prediction
+{
+
+VTAGE::VTAGE(const VTAGEParams &p)
+    : ValuePredictor(p),
+      nHistoryTables(p.nHistoryTables),
+      instShiftAmt(p.instShiftAmt),
+      logTableSizes(p.logTableSizes),
+      tagWidths(p.tagTableTagWidths),
+      maxConf(mask(p.confBits)),
+      uResetPeriod(1ULL << p.logUResetPeriod),
+      maxBranches(p.histBufferSize - p.maxHist),
+      histLengths(p.nHistoryTables + 1, 0),
+      tables(p.nHistoryTables + 1),
+      threadHistory(p.numThreads),
+      historyPool(p.numThreads),
+      stats(this, p.nHistoryTables)
+{
+    fatal_if(nHistoryTables == 0 || nHistoryTables > maxTables,
+             "%s: between 1 and %d tagged tables are supported\n", name(),
+             maxTables);
+    fatal_if(logTableSizes.size() != nHistoryTables + 1 ||
+             tagWidths.size() != nHistoryTables + 1,
+             "%s: there must be a table size and a tag width for the base "
+             "table and each tagged table\n", name());
+    fatal_if(tagWidths[0] != 0, "%s: the base table is untagged\n", name());
+    for (unsigned t = 1; t <= nHistoryTables; ++t) {
+        fatal_if(tagWidths[t] < 2 || tagWidths[t] > 16,
+                 "%s: tags must have between 2 and 16 bits\n", name());
+    }
+    fatal_if(p.confBits == 0 || p.confBits > 8,
+             "%s: confidence counters have between 1 and 8 bits\n", name());
+    fatal_if(p.minHist == 0 || p.maxHist < p.minHist,
+             "%s: invalid history lengths\n", name());
+    fatal_if(p.histBufferSize <= p.maxHist * 2,
+             "%s: the history buffer must hold twice the longest history\n",
+             name());
+
+    // geometric history lengths, as in TAGEBase::calculateParameters()
+    histLengths[1] = p.minHist;
+    histLengths[nHistoryTables] = p.maxHist;
+    for (unsigned t = 2; t < nHistoryTables; ++t) {
+        histLengths[t] = (unsigned)(p.minHist *
+            std::pow((double)p.maxHist / p.minHist,
+                     (double)(t - 1) / (nHistoryTables - 1)) + 0.5);
+    }
+
+    for (unsigned t = 0; t <= nHistoryTables; ++t)
+        tables[t].resize(1ULL << logTableSizes[t]);
+
+    for (auto &hist : threadHistory) {
+        hist.globalHistory.init(p.histBufferSize);
+        for (unsigned t = 1; t <= nHistoryTables; ++t) {
+            hist.computeIndices[t].init(histLengths[t], logTableSizes[t]);
+            hist.computeTags[0][t].init(histLengths[t], tagWidths[t]);
+            hist.computeTags[1][t].init(histLengths[t], tagWidths[t] - 1);
+        }
+    }
+}
+
+void
+VTAGE::calculateIndicesAndTags(ThreadID tid, Addr key, LoadInfo &li)
+{
+    const ThreadHistory &hist = threadHistory[tid];
+
+    li.indices[0] = key & mask(logTableSizes[0]);
+    for (unsigned t = 1; t <= nHistoryTables; ++t) {
+        const unsigned log_size = logTableSizes[t];
+        li.indices[t] = (key ^ (key >> (std::abs((int)log_size - (int)t)
+                         + 1)) ^ hist.computeIndices[t].comp) &
+            mask(log_size);
+        li.tags[t] = (key ^ hist.computeTags[0][t].comp ^
+                      (hist.computeTags[1][t].comp << 1)) &
+            mask(tagWidths[t]);
+    }
+}
+
+bool
+VTAGE::matches(const LoadInfo &li, unsigned t) const
+{
+    const Entry &entry = tables[t][li.indices[t]];
+    return entry.valid && (t == 0 || entry.tag == li.tags[t]);
+}
+
+bool
+VTAGE::lookup(ThreadID tid, Addr pc, MicroPC upc, RegVal &value,
+              void *&vp_history)
+{
+    ++stats.lookups;
+
+    LoadInfo *li = historyPool.acquire(tid);
+    vp_history = li;
+    calculateIndicesAndTags(tid, loadKey(pc, upc, instShiftAmt), *li);
+
+    li->provider = 0;
+    for (unsigned t = nHistoryTables; t > 0; --t) {
+        if (matches(*li, t)) {
+            li->provider = t;
+            break;
+        }
+    }
+
+    const Entry &entry = tables[li->provider][li->indices[li->provider]];
+    li->hit = entry.valid;
+    if (!li->hit)
+        return false;
+
+    ++stats.tableHits[li->provider];
+    li->predValue = entry.value;
+    value = entry.value;
+    return entry.conf == maxConf;
+}
+
+void
+VTAGE::mispredict(ThreadID tid, void *vp_history)
+{
+    LoadInfo *li = static_cast<LoadInfo *>(vp_history);
+    if (li->hit && matches(*li, li->provider))
+        tables[li->provider][li->indices[li->provider]].conf = 0;
+}
+
+void
+VTAGE::allocate(const LoadInfo &li, RegVal value)
+{
+    for (unsigned t = li.provider + 1; t <= nHistoryTables; ++t) {
+        Entry &entry = tables[t][li.indices[t]];
+        if (entry.u == 0) {
+            entry.valid = true;
+            entry.tag = li.tags[t];
+            entry.value = value;
+            entry.conf = 0;
+            ++stats.allocations;
+            return;
+        }
+    }
+
+    // every candidate is useful, age them so that a later allocation
+    // succeeds
+    ++stats.allocationFailures;
+    for (unsigned t = li.provider + 1; t <= nHistoryTables; ++t)
+        tables[t][li.indices[t]].u = 0;
+}
+
+void
+VTAGE::update(ThreadID tid, RegVal value, void *vp_history)
+{
+    LoadInfo *li = static_cast<LoadInfo *>(vp_history);
+
+    bool provider_right = false;
+    if (matches(*li, li->provider)) {
+        Entry &entry = tables[li->provider][li->indices[li->provider]];
+        provider_right = entry.value == value;
+        if (provider_right) {
+            if (entry.conf < maxConf)
+                ++entry.conf;
+            if (li->provider && entry.conf == maxConf)
+                entry.u = 1;
+        } else {
+            // a confident value is given a second chance before it is
+            // replaced
+            if (entry.conf == 0)
+                entry.value = value;
+            entry.conf = 0;
+        }
+    } else if (li->provider == 0) {
+        Entry &base = tables[0][li->indices[0]];
+        base.valid = true;
+        base.value = value;
+        base.conf = 0;
+    }
+
+    // a value that the longest matching table got wrong is looked for in
+    // a longer history
+    if (li->hit && !provider_right && li->provider < nHistoryTables)
+        allocate(*li, value);
+
+    if (++uResetCounter >= uResetPeriod) {
+        uResetCounter = 0;
+        for (unsigned t = 1; t <= nHistoryTables; ++t) {
+            for (auto &entry : tables[t])
+                entry.u = 0;
+        }
+    }
+
+    historyPool.release(tid, li);
+}
+
+void
+VTAGE::squash(ThreadID tid, void *vp_history)
+{
+    historyPool.release(tid, static_cast<LoadInfo *>(vp_history));
+}
+
+void
+VTAGE::pushHistory(ThreadHistory &hist, bool taken)
+{
+    hist.ptGhist = hist.globalHistory.next(hist.ptGhist);
+    hist.globalHistory.set(hist.ptGhist, taken);
+    for (unsigned t = 1; t <= nHistoryTables; ++t) {
+        hist.computeIndices[t].update(hist.globalHistory, hist.ptGhist);
+        hist.computeTags[0][t].update(hist.globalHistory, hist.ptGhist);
+        hist.computeTags[1][t].update(hist.globalHistory, hist.ptGhist);
+    }
+}
+
+void
+VTAGE::refoldHistory(ThreadHistory &hist)
+{
+    // Folding is linear, so folding the outcomes in the window from the
+    // oldest one gives what the incremental updates would have.
+    auto refold = [&hist](FoldedHistory &folded) {
+        folded.comp = 0;
+        for (int age = folded.origLength - 1; age >= 0; --age) {
+            folded.comp = (folded.comp << 1) |
+                hist.globalHistory.at(hist.ptGhist, age);
+            folded.comp ^= folded.comp >> folded.compLength;
+            folded.comp &= mask(folded.compLength);
+        }
+    };
+
+    for (unsigned t = 1; t <= nHistoryTables; ++t) {
+        refold(hist.computeIndices[t]);
+        refold(hist.computeTags[0][t]);
+        refold(hist.computeTags[1][t]);
+    }
+}
+
+void
+VTAGE::updateHistory(ThreadID tid, InstSeqNum seq_num, bool taken)
+{
+    ThreadHistory &hist = threadHistory[tid];
+
+    // Without commits, forget the oldest branches before the history
+    // they would be rewound to is overwritten.
+    if (hist.branches.size() >= maxBranches)
+        hist.branches.pop_front();
+
+    hist.branches.push_back({seq_num, hist.ptGhist});
+    pushHistory(hist, taken);
+}
+
+void
+VTAGE::squashHistory(ThreadID tid, InstSeqNum squashed_sn,
+                     bool mispredicted, bool taken)
+{
+    ThreadHistory &hist = threadHistory[tid];
+
+    bool rewound = false;
+    while (!hist.branches.empty() &&
+           hist.branches.back().seqNum > squashed_sn) {
+        hist.ptGhist = hist.branches.back().ptGhist;
+        hist.branches.pop_back();
+        rewound = true;
+    }
+
+    if (mispredicted && !hist.branches.empty() &&
+        hist.branches.back().seqNum == squashed_sn) {
+        // replay the branch with its actual direction
+        hist.ptGhist = hist.branches.back().ptGhist;
+        hist.branches.pop_back();
+        refoldHistory(hist);
+        updateHistory(tid, squashed_sn, taken);
+    } else if (rewound) {
+        refoldHistory(hist);
+    }
+}
+
+void
+VTAGE::commitHistory(ThreadID tid, InstSeqNum done_sn)
+{
+    ThreadHistory &hist = threadHistory[tid];
+    while (!hist.branches.empty() &&
+           hist.branches.front().seqNum <= done_sn) {
+        hist.branches.pop_front();
+    }
+}
+
+VTAGE::VTAGEStats::VTAGEStats(statistics::Group *parent, unsigned n_tables)
+    : statistics::Group(parent),
+      ADD_STAT(lookups, statistics::units::Count::get(),
+               "Number of value lookups"),
+      ADD_STAT(tableHits, statistics::units::Count::get(),
+               "Number of values provided by each table, 0 being the base "
+               "table"),
+      ADD_STAT(allocations, statistics::units::Count::get(),
+               "Number of entries allocated"),
+      ADD_STAT(allocationFailures, statistics::units::Count::get(),
+               "Number of mispredictions that could not allocate an entry")
+{
+    tableHits.init(n_tables + 1);
+}
+
+} // namespace value_prediction
+} // namespace gem5
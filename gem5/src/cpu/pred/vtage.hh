@@ -0,0 +1,177 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_PRED_VTAGE_HH__
+#define __CPU_PRED_VTAGE_HH__
+
+#include <array>
+#include <deque>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "cpu/inst_seq.hh"
+#include "cpu/pred/history_pool.hh"
+#include "cpu/pred/tage_base.hh"
+#include "cpu/pred/value_pred.hh"
+#include "params/VTAGE.hh"
+
+namespace gem5
+{
+
+namespace value_prediction
+{
+
+/**
+ * A VTAGE load value predictor, after Perais and Seznec's "Practical data
+ * value speculation for future high-end processors" (HPCA 2014). A last
+ * value table indexed by the load address backs tagged tables indexed
+ * with geometrically increasing lengths of global branch history, and the
+ * longest matching table provides the value. Values are only used once
+ * their confidence counter saturated.
+ *
+ * The global history and its folded copies are the ones of TAGEBase. It
+ * is built from the predicted directions of the conditional branches as
+ * they are dispatched, so it is the history of the loads that are looked
+ * up at the same time. Each branch keeps the position of the history
+ * before it until it commits, and the folded histories are recomputed
+ * from the history when a squash rewinds it.
+ */
+class VTAGE : public ValuePredictor
+{
+  public:
+    VTAGE(const VTAGEParams &params);
+
+    bool lookup(ThreadID tid, Addr pc, MicroPC upc, RegVal &value,
+                void *&vp_history) override;
+    void mispredict(ThreadID tid, void *vp_history) override;
+    void update(ThreadID tid, RegVal value, void *vp_history) override;
+    void squash(ThreadID tid, void *vp_history) override;
+
+    void updateHistory(ThreadID tid, InstSeqNum seq_num,
+                       bool taken) override;
+    void squashHistory(ThreadID tid, InstSeqNum squashed_sn,
+                       bool mispredicted, bool taken) override;
+    void commitHistory(ThreadID tid, InstSeqNum done_sn) override;
+
+    /** Largest number of tagged tables supported. */
+    static constexpr unsigned maxTables = 16;
+
+  private:
+    using GlobalHistory = branch_prediction::TAGEBase::GlobalHistory;
+    using FoldedHistory = branch_prediction::TAGEBase::FoldedHistory;
+
+    struct Entry
+    {
+        RegVal value = 0;
+        uint16_t tag = 0;
+        uint8_t conf = 0;
+        uint8_t u = 0;
+        bool valid = false;
+    };
+
+    /** A branch in flight and the history position before it. */
+    struct BranchCheckpoint
+    {
+        InstSeqNum seqNum;
+        int ptGhist;
+    };
+
+    struct ThreadHistory
+    {
+        GlobalHistory globalHistory;
+        int ptGhist = 0;
+        std::array<FoldedHistory, maxTables + 1> computeIndices;
+        std::array<FoldedHistory, maxTables + 1> computeTags[2];
+        std::deque<BranchCheckpoint> branches;
+    };
+
+    /** Per load record, passed around as the value history. */
+    struct LoadInfo
+    {
+        /** Longest matching table, 0 for the base table. */
+        unsigned provider = 0;
+        /** Whether the provider had a value. */
+        bool hit = false;
+        RegVal predValue = 0;
+        std::array<unsigned, maxTables + 1> indices;
+        std::array<uint16_t, maxTables + 1> tags;
+    };
+
+    /** Compute the table indices and tags of a load. */
+    void calculateIndicesAndTags(ThreadID tid, Addr key, LoadInfo &li);
+
+    /** Whether the entry of table t used by a load is still its own. */
+    bool matches(const LoadInfo &li, unsigned t) const;
+
+    /** Allocate entries for a mispredicted load in longer tables. */
+    void allocate(const LoadInfo &li, RegVal value);
+
+    /** Push a direction into the global and folded histories. */
+    void pushHistory(ThreadHistory &hist, bool taken);
+
+    /** Recompute the folded histories from the global history. */
+    void refoldHistory(ThreadHistory &hist);
+
+    const unsigned nHistoryTables;
+    const unsigned instShiftAmt;
+    const std::vector<unsigned> logTableSizes;
+    const std::vector<unsigned> tagWidths;
+    const unsigned maxConf;
+    const uint64_t uResetPeriod;
+    const unsigned maxBranches;
+
+    /** History lengths of the tagged tables, 1-based. */
+    std::vector<unsigned> histLengths;
+
+    /** The tables, the base one first. */
+    std::vector<std::vector<Entry>> tables;
+
+    std::vector<ThreadHistory> threadHistory;
+
+    /** Loads trained since the last useful bits reset. */
+    uint64_t uResetCounter = 0;
+
+    branch_prediction::HistoryPool<LoadInfo> historyPool;
+
+    struct VTAGEStats : public statistics::Group
+    {
+        VTAGEStats(statistics::Group *parent, unsigned n_tables);
+
+        /** Stat for number of value lookups. */
+        statistics::Scalar lookups;
+        /** Stat for the table providing each value, 0 is the base. */
+        statistics::Vector tableHits;
+        /** Stat for number of entries allocated. */
+        statistics::Scalar allocations;
+        /** Stat for number of failed allocations. */
+        statistics::Scalar allocationFailures;
+    } stats;
+};
+
+} // namespace value_prediction
+} // namespace gem5
+
+#endif // __CPU_PRED_VTAGE_HH__
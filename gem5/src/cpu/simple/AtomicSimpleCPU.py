@@ -60,6 +60,21 @@ class AtomicSimpleCPU(BaseSimpleCPU):
     width = Param.Int(1, "CPU width")
     simulate_data_stalls = Param.Bool(False, "Simulate dcache stall cycles")
     simulate_inst_stalls = Param.Bool(False, "Simulate icache stall cycles")
+    functional_warmup = Param.Bool(False, "Only warm up the caches and "
+        "train their prefetchers, skipping cache latencies and stats")
+    use_backdoors = Param.Bool(False, "Do plain loads, stores and "
+        "instruction fetches directly on memory backdoors. These accesses "
+        "are not seen by caches, snoopers or memory stats and take no "
+        "time, so only use this without caches or other CPUs")
+    basic_block_cache = Param.Bool(False, "Cache decoded basic blocks and "
+        "execute them without fetching and decoding them again, checking "
+        "for interrupts and events once per block. Intended for "
+        "fast-forwarding; instruction fetches of cached blocks are not seen "
+        "by the memory system")
+    max_block_ops = Param.Unsigned(64, "Maximum number of micro-ops in a "
+        "cached basic block")
+    max_basic_blocks = Param.Unsigned(65536, "Number of cached basic blocks "
+        "above which the basic block cache is flushed")
 
     def addSimPointProbe(self, interval):
         simpoint = SimPoint()
@@ -50,3 +50,5 @@ class BaseSimpleCPU(BaseCPU):
             exit(1)
 
     branchPred = Param.BranchPredictor(NULL, "Branch Predictor")
+    count_nops = Param.Bool(True, "Count nops and instruction prefetches "
+        "as committed instructions (O3 does not)")
@@ -50,6 +50,7 @@ class NonCachingSimpleCPU(AtomicSimpleCPU):
     cxx_class = 'gem5::NonCachingSimpleCPU'
 
     numThreads = 1
+    use_backdoors = True
 
     @classmethod
     def memory_mode(cls):
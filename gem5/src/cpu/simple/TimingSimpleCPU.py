@@ -33,6 +33,11 @@ class TimingSimpleCPU(BaseSimpleCPU):
     cxx_header = "cpu/simple/timing.hh"
     cxx_class = 'gem5::TimingSimpleCPU'
 
+    fetchBufferSize = Param.Unsigned(0, "Fetch buffer size in bytes, "
+        "sequential fetches within the buffered block are served without "
+        "an instruction cache access. 0 fetches every instruction from the "
+        "cache")
+
     @classmethod
     def memory_mode(cls):
         return 'timing'
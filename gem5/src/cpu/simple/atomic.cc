@@ -79,16 +79,33 @@ AtomicSimpleCPU::AtomicSimpleCPU(const AtomicSimpleCPUParams &p)
       width(p.width), locked(false),
       simulate_data_stalls(p.simulate_data_stalls),
       simulate_inst_stalls(p.simulate_inst_stalls),
+      functional_warmup(p.functional_warmup),
+      useBackdoors(p.use_backdoors),
+      useBlockCache(p.basic_block_cache),
+      maxBlockOps(p.max_block_ops),
+      maxBasicBlocks(p.max_basic_blocks),
       icachePort(name() + ".icache_port", this),
       dcachePort(name() + ".dcache_port", this),
       dcache_access(false), dcache_latency(0),
       ppCommit(nullptr)
 {
+    fatal_if(useBackdoors && functional_warmup,
+             "%s: Memory backdoors bypass the caches and can't be used for "
+             "functional warmup.\n", name());
+    fatal_if(useBlockCache &&
+             (functional_warmup || simulate_inst_stalls || branchPred ||
+              numThreads > 1),
+             "%s: The basic block cache skips instruction fetches and is "
+             "only supported on single threaded CPUs without functional "
+             "warmup, instruction stalls or a branch predictor.\n", name());
+    fatal_if(useBlockCache && !maxBlockOps,
+             "%s: Basic blocks must hold at least one micro-op.\n", name());
+
     _status = Idle;
-    ifetch_req = std::make_shared<Request>();
-    data_read_req = std::make_shared<Request>();
-    data_write_req = std::make_shared<Request>();
-    data_amo_req = std::make_shared<Request>();
+    ifetch_req = makeRequest();
+    data_read_req = makeRequest();
+    data_write_req = makeRequest();
+    data_amo_req = makeRequest();
 }
 
 
@@ -149,6 +166,9 @@ AtomicSimpleCPU::drainResume()
     DPRINTF(SimpleCPU, "Resume\n");
     verifyMemoryMode();
 
+    // Code may have changed while the CPU was drained or switched out.
+    flushBasicBlocks();
+
     assert(!threadContexts.empty());
 
     _status = BaseSimpleCPU::Idle;
@@ -272,7 +292,61 @@ AtomicSimpleCPU::suspendContext(ThreadID thread_num)
 Tick
 AtomicSimpleCPU::sendPacket(RequestPort &port, const PacketPtr &pkt)
 {
-    return port.sendAtomic(pkt);
+    if (!useBackdoors)
+        return port.sendAtomic(pkt);
+
+    MemBackdoorPtr bd = nullptr;
+    Tick latency = port.sendAtomicBackdoor(pkt, bd);
+
+    // If the target gave us a backdoor for next time and we didn't
+    // already have it, record it.
+    if (bd && memBackdoors.insert(bd->range(), bd) != memBackdoors.end()) {
+        // Install a callback to erase this backdoor if it goes away.
+        auto callback = [this](const MemBackdoor &backdoor) {
+                for (auto it = memBackdoors.begin();
+                        it != memBackdoors.end(); it++) {
+                    if (it->second == &backdoor) {
+                        memBackdoors.erase(it);
+                        return;
+                    }
+                }
+                panic("Got invalidation for unknown memory backdoor.");
+            };
+        bd->addInvalidationCallback(callback);
+    }
+    return latency;
+}
+
+bool
+AtomicSimpleCPU::backdoorAccess(const RequestPtr &req, uint8_t *data,
+                                bool write)
+{
+    // Anything with side effects beyond reading or writing the data
+    // goes through the memory system.
+    if (memBackdoors.empty() || req->isUncacheable() ||
+            req->isStrictlyOrdered() || req->isLocalAccess() ||
+            req->isLLSC() || req->isLockedRMW() || req->isSwap() ||
+            req->isAtomic() || req->isMasked() || req->isPrefetch() ||
+            req->isCacheMaintenance() || req->isHTMCmd() ||
+            req->getFlags().isSet(Request::STORE_NO_DATA)) {
+        return false;
+    }
+
+    auto bd_it = memBackdoors.contains(
+        RangeSize(req->getPaddr(), req->getSize()));
+    if (bd_it == memBackdoors.end())
+        return false;
+
+    auto *bd = bd_it->second;
+    if (write ? !bd->writeable() : !bd->readable())
+        return false;
+
+    uint8_t *host_addr = bd->ptr() + (req->getPaddr() - bd->range().start());
+    if (write)
+        memcpy(host_addr, data, req->getSize());
+    else
+        memcpy(data, host_addr, req->getSize());
+    return true;
 }
 
 Tick
@@ -297,6 +371,7 @@ AtomicSimpleCPU::AtomicCPUDPort::recvAtomicSnoop(PacketPtr pkt)
     if (pkt->isInvalidate() || pkt->isWrite()) {
         DPRINTF(SimpleCPU, "received invalidation for addr:%#x\n",
                 pkt->getAddr());
+        cpu->noteCodeWrite(pkt->getAddr(), pkt->getSize());
         for (auto &t_info : cpu->threadInfo) {
             t_info->thread->getIsaPtr()->handleLockedSnoop(pkt,
                     cacheBlockMask);
@@ -320,10 +395,14 @@ AtomicSimpleCPU::AtomicCPUDPort::recvFunctionalSnoop(PacketPtr pkt)
         }
     }
 
+    if (pkt->isWrite())
+        cpu->noteCodeWrite(pkt->getAddr(), pkt->getSize());
+
     // if snoop invalidates, release any associated locks
     if (pkt->isInvalidate()) {
         DPRINTF(SimpleCPU, "received invalidation for addr:%#x\n",
                 pkt->getAddr());
+        cpu->noteCodeWrite(pkt->getAddr(), pkt->getSize());
         for (auto &t_info : cpu->threadInfo) {
             t_info->thread->getIsaPtr()->handleLockedSnoop(pkt,
                     cacheBlockMask);
@@ -351,6 +430,8 @@ AtomicSimpleCPU::genMemFragmentRequest(const RequestPtr &req, Addr frag_addr,
     if (isAnyActiveElement(it_start, it_end)) {
         req->setVirt(frag_addr, frag_size, flags, dataRequestorId(),
                      inst_addr);
+        if (functional_warmup)
+            req->setFlags(Request::WARMUP);
         req->setByteEnable(std::vector<bool>(it_start, it_end));
     } else {
         predicate = false;
@@ -395,6 +476,10 @@ AtomicSimpleCPU::readMem(Addr addr, uint8_t *data, unsigned size,
 
         // Now do the access.
         if (predicate && fault == NoFault &&
+            !req->getFlags().isSet(Request::NO_ACCESS) &&
+            backdoorAccess(req, data, false)) {
+            dcache_access = true;
+        } else if (predicate && fault == NoFault &&
             !req->getFlags().isSet(Request::NO_ACCESS)) {
             Packet pkt(req, Packet::makeReadCmd(req));
             pkt.dataStatic(data);
@@ -494,7 +579,17 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size, Addr addr,
                 }
             }
 
-            if (do_access && !req->getFlags().isSet(Request::NO_ACCESS)) {
+            if (do_access && !req->getFlags().isSet(Request::NO_ACCESS) &&
+                    backdoorAccess(req, data, true)) {
+                if (numThreads > 1) {
+                    // Notify other threads on this CPU of write
+                    Packet pkt(req, Packet::makeWriteCmd(req));
+                    pkt.dataStatic(data);
+                    threadSnoop(&pkt, curThread);
+                }
+                dcache_access = true;
+            } else if (do_access &&
+                    !req->getFlags().isSet(Request::NO_ACCESS)) {
                 Packet pkt(req, Packet::makeWriteCmd(req));
                 pkt.dataStatic(data);
 
@@ -516,6 +611,9 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size, Addr addr,
                 }
             }
 
+            if (do_access && !req->getFlags().isSet(Request::NO_ACCESS))
+                noteCodeWrite(req->getPaddr(), req->getSize());
+
             if (res && !req->isSwap()) {
                 *res = req->getExtraData();
             }
@@ -577,6 +675,8 @@ AtomicSimpleCPU::amoMem(Addr addr, uint8_t* data, unsigned size,
     req->taskId(taskId());
     req->setVirt(addr, size, flags, dataRequestorId(),
                  thread->pcState().instAddr(), std::move(amo_op));
+    if (functional_warmup)
+        req->setFlags(Request::WARMUP);
 
     // translate to physical address
     Fault fault = thread->mmu->translateAtomic(
@@ -596,6 +696,7 @@ AtomicSimpleCPU::amoMem(Addr addr, uint8_t* data, unsigned size,
         }
 
         dcache_access = true;
+        noteCodeWrite(req->getPaddr(), req->getSize());
 
         assert(!pkt.isError());
         assert(!req->isLLSC());
@@ -631,6 +732,8 @@ AtomicSimpleCPU::tick()
     SimpleThread *thread = t_info.thread;
 
     Tick latency = 0;
+    // Ops executed from basic blocks beyond one per iteration
+    int extra_block_ops = 0;
 
     for (int i = 0; i < width || locked; ++i) {
         baseStats.numCycles++;
@@ -649,6 +752,15 @@ AtomicSimpleCPU::tick()
 
         serviceInstCountEvents();
 
+        if (useBlockCache) {
+            int block_ops = executeBasicBlock(latency);
+            if (block_ops) {
+                baseStats.numCycles += block_ops - 1;
+                extra_block_ops += block_ops - 1;
+                continue;
+            }
+        }
+
         Fault fault = NoFault;
 
         const PCStateBase &pc = thread->pcState();
@@ -657,8 +769,25 @@ AtomicSimpleCPU::tick()
         if (needToFetch) {
             ifetch_req->taskId(taskId());
             setupFetchRequest(ifetch_req);
+            if (functional_warmup)
+                ifetch_req->setFlags(Request::WARMUP);
             fault = thread->mmu->translateAtomic(ifetch_req, thread->getTC(),
                                                  BaseMMU::Execute);
+
+            if (recording) {
+                if (fault != NoFault) {
+                    recording = false;
+                } else if (roundDown(ifetch_req->getVaddr(), blockPageBytes) !=
+                        roundDown(recordingPC, blockPageBytes)) {
+                    // Blocks don't leave the page they start on.
+                    finishRecording();
+                } else if (recordingBlock.ops.empty() &&
+                        t_info.fetchOffset == 0) {
+                    recordingBlock.fetchPaddr = ifetch_req->getPaddr();
+                    codePages.insert(roundDown(ifetch_req->getPaddr(),
+                                               blockPageBytes));
+                }
+            }
         }
 
         if (fault == NoFault) {
@@ -679,8 +808,14 @@ AtomicSimpleCPU::tick()
                 //}
             }
 
+            if (recording)
+                set(recordingPrePC, thread->pcState());
+
             preExecute();
 
+            if (recording)
+                recordOp(*recordingPrePC);
+
             Tick stall_ticks = 0;
             if (curStaticInst) {
                 fault = curStaticInst->execute(&t_info, traceData);
@@ -702,6 +837,21 @@ AtomicSimpleCPU::tick()
                 }
 
                 postExecute();
+
+                if (recording) {
+                    if (fault != NoFault || blocksStale) {
+                        recording = false;
+                    } else if (curStaticInst->isControl() ||
+                            recordingBlock.ops.size() >= maxBlockOps) {
+                        finishRecording();
+                    }
+                }
+
+                // Be conservative about state the decoder depends on.
+                if (useBlockCache && (curStaticInst->isSerializing() ||
+                            curStaticInst->isSquashAfter())) {
+                    blocksStale = true;
+                }
             }
 
             // @todo remove me after debugging with legion done
@@ -727,24 +877,287 @@ AtomicSimpleCPU::tick()
         }
         if (fault != NoFault || !t_info.stayAtPC)
             advancePC(fault);
+        if (recording)
+            set(recordingNextPC, thread->pcState());
     }
 
     if (tryCompleteDrain())
         return;
 
-    // instruction takes at least one cycle
-    if (latency < clockPeriod())
-        latency = clockPeriod();
+    // instruction takes at least one cycle, and ops executed from basic
+    // blocks still only retire width per cycle
+    const Tick min_latency =
+        clockPeriod() * (1 + extra_block_ops / width);
+    if (latency < min_latency)
+        latency = min_latency;
 
     if (_status != Idle)
         reschedule(tickEvent, curTick() + latency, true);
 }
 
+void
+AtomicSimpleCPU::OpCounts::add(const StaticInstPtr &inst, bool committed)
+{
+    if (committed) {
+        if (!inst->isMicroop() || inst->isLastMicroop())
+            insts++;
+        ops++;
+    }
+    if (!inst->isMicroop() || inst->isFirstMicroop())
+        firstMicroops++;
+
+    if (inst->isMemRef())
+        memRefs++;
+    if (inst->isLoad())
+        loads++;
+    if (inst->isControl())
+        branches++;
+    if (inst->isInteger())
+        intInsts++;
+    if (inst->isFloating())
+        fpInsts++;
+    if (inst->isVector())
+        vecInsts++;
+    if (inst->isCall() || inst->isReturn())
+        callsReturns++;
+    if (inst->isCondCtrl())
+        condCtrls++;
+    if (inst->isStore() || inst->isAtomic())
+        stores++;
+
+    for (auto &op_class : opClasses) {
+        if (op_class.first == inst->opClass()) {
+            op_class.second++;
+            return;
+        }
+    }
+    opClasses.emplace_back(inst->opClass(), 1);
+}
+
+void
+AtomicSimpleCPU::countOps(const OpCounts &counts)
+{
+    SimpleExecContext &t_info = *threadInfo[curThread];
+    auto &stats = t_info.execContextStats;
+
+    t_info.numInst += counts.insts;
+    stats.numInsts += counts.insts;
+    t_info.numOp += counts.ops;
+    stats.numOps += counts.ops;
+    instCnt += counts.firstMicroops;
+
+    stats.numMemRefs += counts.memRefs;
+    t_info.numLoad += counts.loads;
+    stats.numBranches += counts.branches;
+    stats.numIntAluAccesses += counts.intInsts;
+    stats.numIntInsts += counts.intInsts;
+    stats.numFpAluAccesses += counts.fpInsts;
+    stats.numFpInsts += counts.fpInsts;
+    stats.numVecAluAccesses += counts.vecInsts;
+    stats.numVecInsts += counts.vecInsts;
+    stats.numCallsReturns += counts.callsReturns;
+    stats.numCondCtrlInsts += counts.condCtrls;
+    stats.numLoadInsts += counts.loads;
+    stats.numStoreInsts += counts.stores;
+    for (const auto &op_class : counts.opClasses)
+        stats.statExecutedInstType[op_class.first] += op_class.second;
+}
+
+void
+AtomicSimpleCPU::flushBasicBlocks()
+{
+    if (!basicBlocks.empty())
+        DPRINTF(SimpleCPU, "Flushing %d basic blocks\n", basicBlocks.size());
+
+    basicBlocks.clear();
+    codePages.clear();
+    blocksStale = false;
+    recording = false;
+}
+
+void
+AtomicSimpleCPU::recordOp(const PCStateBase &pre_pc)
+{
+    // Wait for the decoder to have enough bytes.
+    if (!curStaticInst)
+        return;
+
+    // Anything that has to be seen by the CPU between instructions ends
+    // the block, and is executed by the normal path. So does anything
+    // which changed the PC since the last recorded op, like interrupts.
+    const StaticInstPtr &inst = curStaticInst;
+    if ((!recordingBlock.ops.empty() &&
+                !pre_pc.equals(*recordingNextPC)) ||
+            isRomMicroPC(pre_pc.microPC()) || inst->isNonSpeculative() ||
+            inst->isSerializing() || inst->isSquashAfter() ||
+            inst->isQuiesce() || inst->isSyscall() || inst->isHtmCmd()) {
+        finishRecording();
+        return;
+    }
+
+    BasicBlock::Op op;
+    op.inst = inst;
+    op.macroop = curMacroStaticInst;
+    op.prePC.reset(pre_pc.clone());
+    op.pc.reset(threadInfo[curThread]->thread->pcState().clone());
+    recordingBlock.ops.push_back(std::move(op));
+}
+
+void
+AtomicSimpleCPU::finishRecording()
+{
+    recording = false;
+    if (recordingBlock.ops.empty())
+        return;
+
+    BasicBlock &block = basicBlocks[recordingPC];
+    block = std::move(recordingBlock);
+    recordingBlock = BasicBlock();
+
+    block.lastPC = block.ops.back().pc->instAddr();
+    for (const auto &op : block.ops)
+        block.counts.add(op.inst, countsInst(op.inst));
+
+    DPRINTF(SimpleCPU, "Recorded basic block %#x-%#x, %d ops\n",
+            recordingPC, block.lastPC, block.ops.size());
+}
+
+int
+AtomicSimpleCPU::executeBasicBlock(Tick &latency)
+{
+    SimpleExecContext &t_info = *threadInfo[curThread];
+    SimpleThread *thread = t_info.thread;
+
+    if (blocksStale)
+        flushBasicBlocks();
+
+    // Blocks start on an instruction boundary.
+    if (recording || curMacroStaticInst || t_info.fetchOffset || locked ||
+            isRomMicroPC(thread->pcState().microPC())) {
+        return 0;
+    }
+
+    const Addr start_pc = thread->pcState().instAddr();
+    auto it = basicBlocks.find(start_pc);
+    if (it == basicBlocks.end()) {
+        if (basicBlocks.size() >= maxBasicBlocks)
+            flushBasicBlocks();
+        recording = true;
+        recordingPC = start_pc;
+        return 0;
+    }
+
+    BasicBlock &block = it->second;
+
+    // Nothing that is checked between instructions may be due inside the
+    // block. PC events at the first instruction have been serviced already.
+    auto &inst_events = thread->comInstEventQueue;
+    if (!block.ops.front().prePC->equals(thread->pcState()) ||
+            thread->pcEventQueue.anyInRange(start_pc + 1, block.lastPC) ||
+            (!inst_events.empty() &&
+             inst_events.nextTick() < t_info.numInst + block.counts.insts)) {
+        return 0;
+    }
+
+    // The code has to still be mapped where it was decoded from.
+    ifetch_req->taskId(taskId());
+    setupFetchRequest(ifetch_req);
+    Fault fault = thread->mmu->translateAtomic(ifetch_req, thread->getTC(),
+                                               BaseMMU::Execute);
+    if (fault != NoFault)
+        return 0;
+    if (ifetch_req->getPaddr() != block.fetchPaddr) {
+        basicBlocks.erase(it);
+        return 0;
+    }
+
+    int num_ops = 0;
+    for (const auto &op : block.ops) {
+        if (num_ops && !op.prePC->equals(thread->pcState()))
+            break;
+
+        // The parts of preExecute() which matter for decoded ops.
+        thread->setIntReg(zeroReg, 0);
+        t_info.setPredicate(true);
+        t_info.setMemAccPredicate(true);
+        thread->pcState(*op.pc);
+        curMacroStaticInst = op.macroop;
+        curStaticInst = op.inst;
+#if TRACING_ON
+        traceData = tracer->getInstRecord(curTick(), thread->getTC(),
+                curStaticInst, thread->pcState(), curMacroStaticInst);
+#endif // TRACING_ON
+
+        dcache_access = false;
+        fault = curStaticInst->execute(&t_info, traceData);
+        num_ops++;
+
+        Tick stall_ticks = 0;
+        if (fault == NoFault) {
+            ppCommit->notify(std::make_pair(thread, curStaticInst));
+        } else {
+            if (traceData)
+                traceFault();
+            if (std::dynamic_pointer_cast<SyscallRetryFault>(fault))
+                stall_ticks += clockEdge(syscallRetryLatency) - curTick();
+        }
+
+        // The parts of postExecute() which aren't statistics.
+        const Addr inst_addr = thread->pcState().instAddr();
+        if (FullSystem)
+            traceFunctions(inst_addr);
+        if (traceData) {
+            traceData->dump();
+            delete traceData;
+            traceData = NULL;
+        }
+        probeInstCommit(curStaticInst, inst_addr);
+
+        if (simulate_data_stalls && dcache_access)
+            stall_ticks += dcache_latency;
+        if (stall_ticks)
+            latency += divCeil(stall_ticks, clockPeriod()) * clockPeriod();
+
+        advancePC(fault);
+
+        // Stop early if the op wrote code or changed the CPU state.
+        if (fault != NoFault || blocksStale || _status == Idle)
+            break;
+    }
+
+    if (num_ops == (int)block.ops.size() && fault == NoFault) {
+        countOps(block.counts);
+    } else {
+        OpCounts counts;
+        for (int i = 0; i < num_ops; i++) {
+            counts.add(block.ops[i].inst,
+                       (fault == NoFault || i < num_ops - 1) &&
+                       countsInst(block.ops[i].inst));
+        }
+        countOps(counts);
+    }
+
+    thread->decoder->reset();
+
+    return num_ops;
+}
+
 Tick
 AtomicSimpleCPU::fetchInstMem()
 {
     auto &decoder = threadInfo[curThread]->thread->decoder;
 
+    if (!memBackdoors.empty()) {
+        auto bd_it = memBackdoors.contains(ifetch_req->getPaddr());
+        if (bd_it != memBackdoors.end()) {
+            auto *bd = bd_it->second;
+            Addr offset = ifetch_req->getPaddr() - bd->range().start();
+            memcpy(decoder->moreBytesPtr(), bd->ptr() + offset,
+                   ifetch_req->getSize());
+            return 0;
+        }
+    }
+
     Packet pkt = Packet(ifetch_req, MemCmd::ReadReq);
 
     // ifetch_req is initialized to read the instruction
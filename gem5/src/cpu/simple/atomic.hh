@@ -41,8 +41,17 @@
 #ifndef __CPU_SIMPLE_ATOMIC_HH__
 #define __CPU_SIMPLE_ATOMIC_HH__
 
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "base/addr_range_map.hh"
 #include "cpu/simple/base.hh"
+#include "cpu/op_class.hh"
 #include "cpu/simple/exec_context.hh"
+#include "mem/backdoor.hh"
 #include "mem/request.hh"
 #include "params/AtomicSimpleCPU.hh"
 #include "sim/probe/probe.hh"
@@ -66,6 +75,120 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     bool locked;
     const bool simulate_data_stalls;
     const bool simulate_inst_stalls;
+    const bool functional_warmup;
+    const bool useBackdoors;
+
+    /** Memory backdoors handed out by the memory system. */
+    AddrRangeMap<MemBackdoorPtr, 1> memBackdoors;
+
+    /**
+     * Statistics updates for a sequence of micro-ops, the same ones
+     * countInst() and postExecute() would do one op at a time.
+     */
+    struct OpCounts
+    {
+        Counter insts = 0;
+        Counter ops = 0;
+        Counter firstMicroops = 0;
+        Counter memRefs = 0;
+        Counter loads = 0;
+        Counter branches = 0;
+        Counter intInsts = 0;
+        Counter fpInsts = 0;
+        Counter vecInsts = 0;
+        Counter callsReturns = 0;
+        Counter condCtrls = 0;
+        Counter stores = 0;
+        std::vector<std::pair<OpClass, Counter>> opClasses;
+
+        /**
+         * Account for one micro-op.
+         *
+         * @param committed Whether the op completed without a fault and
+         *        counts towards the committed instructions and ops.
+         */
+        void add(const StaticInstPtr &inst, bool committed);
+    };
+
+    /**
+     * A sequence of decoded micro-ops that ends at a control op. Blocks
+     * never leave the code page they start on, so a single instruction
+     * translation is enough to check that the code is still mapped where
+     * it was when the block was recorded.
+     */
+    struct BasicBlock
+    {
+        struct Op
+        {
+            StaticInstPtr inst;
+            StaticInstPtr macroop;
+            /** PC state before the op is decoded, used to validate it. */
+            std::unique_ptr<PCStateBase> prePC;
+            /** PC state the op executes with. */
+            std::unique_ptr<PCStateBase> pc;
+        };
+
+        std::vector<Op> ops;
+        /** Physical address of the first instruction fetch. */
+        Addr fetchPaddr = 0;
+        /** Address of the last instruction in the block. */
+        Addr lastPC = 0;
+        OpCounts counts;
+    };
+
+    /** Size of the code regions blocks are confined to and tracked by. */
+    static constexpr Addr blockPageBytes = 4096;
+
+    /** Basic block cache configuration, see executeBasicBlock(). */
+    const bool useBlockCache;
+    const unsigned maxBlockOps;
+    const unsigned maxBasicBlocks;
+
+    /** Cached basic blocks, by the address of their first instruction. */
+    std::unordered_map<Addr, BasicBlock> basicBlocks;
+    /** Physical pages cached blocks were decoded from. */
+    std::unordered_set<Addr> codePages;
+    /** Set when code pages are written to, the blocks are flushed asap. */
+    bool blocksStale = false;
+
+    /** Whether a block is being recorded by the normal execution path. */
+    bool recording = false;
+    Addr recordingPC = 0;
+    BasicBlock recordingBlock;
+    std::unique_ptr<PCStateBase> recordingPrePC;
+    /** PC state the recorded ops left, to catch interrupts and events. */
+    std::unique_ptr<PCStateBase> recordingNextPC;
+
+    /**
+     * Execute the cached basic block at the current PC if there is one,
+     * or start recording one.
+     *
+     * @param latency Stall latency of the current tick, updated with the
+     *        stalls of the executed ops.
+     * @return The number of micro-ops executed, zero if the op at the
+     *         current PC has to go through the normal path.
+     */
+    int executeBasicBlock(Tick &latency);
+
+    /** Add the op just decoded by preExecute() to the recorded block. */
+    void recordOp(const PCStateBase &pre_pc);
+    void finishRecording();
+    void flushBasicBlocks();
+
+    /** Note a write to physical memory, flushing blocks if it hits code. */
+    void
+    noteCodeWrite(Addr paddr, Addr size)
+    {
+        if (!codePages.empty() &&
+                (codePages.count(roundDown(paddr, blockPageBytes)) ||
+                 codePages.count(roundDown(paddr + size - 1,
+                                           blockPageBytes)))) {
+            blocksStale = true;
+        }
+    }
+
+    /** Update the statistics for a sequence of executed ops. */
+    void countOps(const OpCounts &counts);
 
     // main simulation loop (one cycle)
     void tick();
@@ -106,6 +229,14 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     virtual Tick sendPacket(RequestPort &port, const PacketPtr &pkt);
     virtual Tick fetchInstMem();
 
+    /**
+     * Do a plain data access directly on a memory backdoor.
+     *
+     * @return Whether the access was done, false if it has to be sent
+     *         to memory as a packet.
+     */
+    bool backdoorAccess(const RequestPtr &req, uint8_t *data, bool write);
+
     /**
      * An AtomicCPUPort overrides the default behaviour of the
      * recvAtomicSnoop and ignores the packet instead of panicking. It
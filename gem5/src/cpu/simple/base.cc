@@ -86,6 +86,7 @@ BaseSimpleCPU::BaseSimpleCPU(const BaseSimpleCPUParams &p)
       curThread(0),
       branchPred(p.branchPred),
       zeroReg(p.isa[0]->regClasses().at(IntRegClass).zeroReg()),
+      countNops(p.count_nops),
       traceData(NULL),
       _status(Idle)
 {
@@ -154,6 +155,9 @@ BaseSimpleCPU::countInst()
 {
     SimpleExecContext& t_info = *threadInfo[curThread];
 
+    if (!countsInst(curStaticInst))
+        return;
+
     if (!curStaticInst->isMicroop() || curStaticInst->isLastMicroop()) {
         t_info.numInst++;
         t_info.execContextStats.numInsts++;
@@ -88,6 +88,13 @@ class BaseSimpleCPU : public BaseCPU
 
     const RegIndex zeroReg;
 
+    /**
+     * Whether nops and instruction prefetches count as committed
+     * instructions. O3 does not count them, so clearing this makes the
+     * instruction counts of the two models line up.
+     */
+    const bool countNops;
+
     void checkPcEventQueue();
     void swapActiveThread();
 
@@ -184,6 +191,13 @@ class BaseSimpleCPU : public BaseCPU
     }
 
     void countInst();
+
+    /** Whether committing inst advances the instruction counts. */
+    bool
+    countsInst(const StaticInstPtr &inst) const
+    {
+        return countNops || !(inst->isNop() || inst->isInstPrefetch());
+    }
     Counter totalInsts() const override;
     Counter totalOps() const override;
 
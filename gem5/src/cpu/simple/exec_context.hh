@@ -57,7 +57,7 @@ namespace gem5
 
 class BaseSimpleCPU;
 
-class SimpleExecContext : public ExecContext
+class SimpleExecContext final : public ExecContext
 {
   public:
     BaseSimpleCPU *cpu;
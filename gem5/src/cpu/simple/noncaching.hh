@@ -38,9 +38,7 @@
 #ifndef __CPU_SIMPLE_NONCACHING_HH__
 #define __CPU_SIMPLE_NONCACHING_HH__
 
-#include "base/addr_range_map.hh"
 #include "cpu/simple/atomic.hh"
-#include "mem/backdoor.hh"
 #include "params/NonCachingSimpleCPU.hh"
 
 namespace gem5
@@ -56,12 +54,6 @@ class NonCachingSimpleCPU : public AtomicSimpleCPU
     NonCachingSimpleCPU(const NonCachingSimpleCPUParams &p);
 
     void verifyMemoryMode() const override;
-
-  protected:
-    AddrRangeMap<MemBackdoorPtr, 1> memBackdoors;
-
-    Tick sendPacket(RequestPort &port, const PacketPtr &pkt) override;
-    Tick fetchInstMem() override;
 };
 
 } // namespace gem5
@@ -43,6 +43,7 @@
 
 #include "arch/generic/decoder.hh"
 #include "base/compiler.hh"
+#include "base/intmath.hh"
 #include "config/the_isa.hh"
 #include "cpu/exetrace.hh"
 #include "debug/Config.hh"
@@ -77,9 +78,26 @@ TimingSimpleCPU::TimingCPUPort::TickEvent::schedule(PacketPtr _pkt, Tick t)
 TimingSimpleCPU::TimingSimpleCPU(const TimingSimpleCPUParams &p)
     : BaseSimpleCPU(p), fetchTranslation(this), icachePort(this),
       dcachePort(this), ifetch_pkt(NULL), dcache_pkt(NULL), previousCycle(0),
+      fetchBufferSize(p.fetchBufferSize), fetchBufferVAddr(0),
+      fetchBufferTid(InvalidThreadID), fetchBufferValid(false),
       fetchEvent([this]{ fetch(); }, name())
 {
     _status = Idle;
+
+    if (fetchBufferSize) {
+        fatal_if(!isPowerOf2(fetchBufferSize),
+                 "%s: fetchBufferSize must be a power of 2.\n", name());
+        fatal_if(fetchBufferSize > cacheLineSize(),
+                 "%s: fetchBufferSize can't be larger than a cache line.\n",
+                 name());
+        for (auto &t_info : threadInfo) {
+            auto *decoder = t_info->thread->decoder;
+            fatal_if(fetchBufferSize < decoder->moreBytesSize(),
+                     "%s: fetchBufferSize is smaller than a fetch.\n",
+                     name());
+        }
+        fetchBuffer.reset(new uint8_t[fetchBufferSize]);
+    }
 }
 
 
@@ -125,6 +143,9 @@ TimingSimpleCPU::drainResume()
     DPRINTF(SimpleCPU, "Resume\n");
     verifyMemoryMode();
 
+    // the code may have changed while the CPU was drained
+    squashFetchBuffer();
+
     assert(!threadContexts.empty());
 
     _status = BaseSimpleCPU::Idle;
@@ -194,6 +215,7 @@ TimingSimpleCPU::takeOverFrom(BaseCPU *oldCPU)
     BaseSimpleCPU::takeOverFrom(oldCPU);
 
     previousCycle = curCycle();
+    squashFetchBuffer();
 }
 
 void
@@ -464,7 +486,9 @@ TimingSimpleCPU::initiateMemRead(Addr addr, unsigned size,
     if (traceData)
         traceData->setMem(addr, size, flags);
 
-    RequestPtr req = std::make_shared<Request>(
+    squashFetchBuffer(addr, size);
+
+    RequestPtr req = makeRequest(
         addr, size, flags, dataRequestorId(), pc, thread->contextId());
     req->setByteEnable(byte_enable);
 
@@ -546,7 +570,7 @@ TimingSimpleCPU::writeMem(uint8_t *data, unsigned size,
     if (traceData)
         traceData->setMem(addr, size, flags);
 
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = makeRequest(
         addr, size, flags, dataRequestorId(), pc, thread->contextId());
     req->setByteEnable(byte_enable);
 
@@ -602,7 +626,9 @@ TimingSimpleCPU::initiateMemAMO(Addr addr, unsigned size,
     if (traceData)
         traceData->setMem(addr, size, flags);
 
-    RequestPtr req = std::make_shared<Request>(addr, size, flags,
+    squashFetchBuffer(addr, size);
+
+    RequestPtr req = makeRequest(addr, size, flags,
                             dataRequestorId(), pc, thread->contextId(),
                             std::move(amo_op));
 
@@ -697,12 +723,29 @@ TimingSimpleCPU::fetch()
     MicroPC upc = thread->pcState().microPC();
     bool needToFetch = !isRomMicroPC(upc) && !curMacroStaticInst;
 
-    if (needToFetch) {
+    if (needToFetch && fetchBufferHit(fetchAddr())) {
+        DPRINTF(SimpleCPU, "Fetching %#x from the fetch buffer\n",
+                fetchAddr());
+        copyFromFetchBuffer(fetchAddr());
+        _status = IcacheWaitResponse;
+        completeIfetch(NULL);
+
+        updateCycleCounts();
+        updateCycleCounters(BaseCPU::CPU_STATE_ON);
+    } else if (needToFetch) {
         _status = BaseSimpleCPU::Running;
-        RequestPtr ifetch_req = std::make_shared<Request>();
+        RequestPtr ifetch_req = makeRequest();
         ifetch_req->taskId(taskId());
         ifetch_req->setContext(thread->contextId());
         setupFetchRequest(ifetch_req);
+        if (fetchBufferSize) {
+            // fetch the whole block into the fetch buffer
+            squashFetchBuffer();
+            ifetch_req->setVirt(
+                    roundDown(ifetch_req->getVaddr(), fetchBufferSize),
+                    fetchBufferSize, Request::INST_FETCH, instRequestorId(),
+                    thread->pcState().instAddr());
+        }
         DPRINTF(SimpleCPU, "Translating address %#x\n", ifetch_req->getVaddr());
         thread->mmu->translateTiming(ifetch_req, thread->getTC(),
                 &fetchTranslation, BaseMMU::Execute);
@@ -716,6 +759,34 @@ TimingSimpleCPU::fetch()
 }
 
 
+Addr
+TimingSimpleCPU::fetchAddr() const
+{
+    const SimpleExecContext &t_info = *threadInfo[curThread];
+    const SimpleThread *thread = t_info.thread;
+
+    return (thread->pcState().instAddr() & thread->decoder->pcMask()) +
+        t_info.fetchOffset;
+}
+
+bool
+TimingSimpleCPU::fetchBufferHit(Addr fetch_addr) const
+{
+    return fetchBufferValid && fetchBufferTid == curThread &&
+        roundDown(fetch_addr, fetchBufferSize) == fetchBufferVAddr;
+}
+
+void
+TimingSimpleCPU::copyFromFetchBuffer(Addr fetch_addr)
+{
+    auto *decoder = threadInfo[curThread]->thread->decoder;
+    Addr offset = fetch_addr - fetchBufferVAddr;
+
+    assert(offset + decoder->moreBytesSize() <= fetchBufferSize);
+    memcpy(decoder->moreBytesPtr(), fetchBuffer.get() + offset,
+           decoder->moreBytesSize());
+}
+
 void
 TimingSimpleCPU::sendFetch(const Fault &fault, const RequestPtr &req,
                            ThreadContext *tc)
@@ -726,7 +797,8 @@ TimingSimpleCPU::sendFetch(const Fault &fault, const RequestPtr &req,
         DPRINTF(SimpleCPU, "Sending fetch for addr %#x(pa: %#x)\n",
                 req->getVaddr(), req->getPaddr());
         ifetch_pkt = new Packet(req, MemCmd::ReadReq);
-        ifetch_pkt->dataStatic(decoder->moreBytesPtr());
+        ifetch_pkt->dataStatic(fetchBufferSize ? fetchBuffer.get() :
+                               decoder->moreBytesPtr());
         DPRINTF(SimpleCPU, " -- pkt addr: %#x\n", ifetch_pkt->getAddr());
 
         if (!icachePort.sendTimingReq(ifetch_pkt)) {
@@ -780,6 +852,7 @@ TimingSimpleCPU::advanceInst(const Fault &fault)
 
         DPRINTF(SimpleCPU, "Fault occured. Handling the fault\n");
 
+        squashFetchBuffer();
         advancePC(fault);
 
         // A syscall fault could suspend this CPU (e.g., futex_wait)
@@ -802,6 +875,13 @@ TimingSimpleCPU::advanceInst(const Fault &fault)
     if (!t_info.stayAtPC)
         advancePC(fault);
 
+    // system calls may remap the code, and serializing instructions are
+    // what the program uses to order its code changes with the fetches
+    if (curStaticInst && (curStaticInst->isSyscall() ||
+                curStaticInst->isSerializing() ||
+                curStaticInst->isSquashAfter()))
+        squashFetchBuffer();
+
     if (tryCompleteDrain())
         return;
 
@@ -837,6 +917,13 @@ TimingSimpleCPU::completeIfetch(PacketPtr pkt)
     if (pkt)
         pkt->req->setAccessLatency();
 
+    if (pkt && fetchBufferSize) {
+        // only buffer what the cache could have served again
+        fetchBufferVAddr = pkt->req->getVaddr();
+        fetchBufferTid = curThread;
+        fetchBufferValid = !pkt->req->isUncacheable();
+        copyFromFetchBuffer(fetchAddr());
+    }
 
     preExecute();
 
@@ -956,6 +1043,9 @@ TimingSimpleCPU::completeDataAccess(PacketPtr pkt)
 
     pkt->req->setAccessLatency();
 
+    // the CPU did nothing else while waiting for the response
+    if (_status == DcacheWaitResponse)
+        baseStats.memStallCycles += curCycle() - previousCycle;
     updateCycleCounts();
     updateCycleCounters(BaseCPU::CPU_STATE_ON);
 
@@ -1226,7 +1316,7 @@ TimingSimpleCPU::initiateHtmCmd(Request::Flags flags)
     if (traceData)
         traceData->setMem(addr, size, flags);
 
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = makeRequest(
         addr, size, flags, dataRequestorId());
 
     req->setPC(pc);
@@ -1276,7 +1366,7 @@ TimingSimpleCPU::htmSendAbortSignal(ThreadID tid, uint64_t htm_uid,
 
     // notify l1 d-cache (ruby) that core has aborted transaction
 
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = makeRequest(
         addr, size, flags, dataRequestorId());
 
     req->setPC(pc);
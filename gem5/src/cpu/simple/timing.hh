@@ -41,6 +41,8 @@
 #ifndef __CPU_SIMPLE_TIMING_HH__
 #define __CPU_SIMPLE_TIMING_HH__
 
+#include <memory>
+
 #include "arch/generic/mmu.hh"
 #include "cpu/simple/base.hh"
 #include "cpu/simple/exec_context.hh"
@@ -263,6 +265,50 @@ class TimingSimpleCPU : public BaseSimpleCPU
 
     Cycles previousCycle;
 
+    /**
+     * Fetch buffer size in bytes, 0 if there is no fetch buffer. When
+     * there is one, instruction fetches are for a whole aligned block of
+     * that size, and the next instructions in the block are fetched from
+     * the buffer without translating or accessing the instruction cache.
+     */
+    const unsigned fetchBufferSize;
+
+    /** The block of instructions last fetched. */
+    std::unique_ptr<uint8_t[]> fetchBuffer;
+
+    /** Virtual address of the buffered block. */
+    Addr fetchBufferVAddr;
+
+    /** Thread the buffered block was fetched for. */
+    ThreadID fetchBufferTid;
+
+    /** Whether the fetch buffer holds a block. */
+    bool fetchBufferValid;
+
+    /**
+     * Address the current thread fetches the next bytes of its
+     * instruction from.
+     */
+    Addr fetchAddr() const;
+
+    /** Whether the next instruction bytes are in the fetch buffer. */
+    bool fetchBufferHit(Addr fetch_addr) const;
+
+    /** Pass the bytes at fetch_addr from the fetch buffer to the decoder. */
+    void copyFromFetchBuffer(Addr fetch_addr);
+
+    /** Drop the buffered block, e.g. when it may have become stale. */
+    void squashFetchBuffer() { fetchBufferValid = false; }
+
+    /** Drop the buffered block if a store to addr overlaps it. */
+    void
+    squashFetchBuffer(Addr addr, unsigned size)
+    {
+        if (fetchBufferValid && addr < fetchBufferVAddr + fetchBufferSize &&
+                addr + size > fetchBufferVAddr)
+            fetchBufferValid = false;
+    }
+
   protected:
 
      /** Return a reference to the data port. */
@@ -166,6 +166,26 @@ SimpleThread::halt()
 void
 SimpleThread::copyArchRegs(ThreadContext *src_tc)
 {
+    // Between two SimpleThreads with the same register files, e.g., when
+    // switching between the simple CPU models, the register files are
+    // copied in bulk and only the rest of the state goes through the ISA.
+    auto *src = dynamic_cast<SimpleThread *>(src_tc);
+    if (src && src->intRegs.size() == intRegs.size() &&
+            src->floatRegs.size() == floatRegs.size() &&
+            src->vecRegs.size() == vecRegs.size() &&
+            src->vecElemRegs.size() == vecElemRegs.size() &&
+            src->vecPredRegs.size() == vecPredRegs.size() &&
+            src->ccRegs.size() == ccRegs.size()) {
+        intRegs = src->intRegs;
+        floatRegs = src->floatRegs;
+        vecRegs = src->vecRegs;
+        vecElemRegs = src->vecElemRegs;
+        vecPredRegs = src->vecPredRegs;
+        ccRegs = src->ccRegs;
+        getIsaPtr()->copyMiscRegsFrom(src_tc);
+        return;
+    }
+
     getIsaPtr()->copyRegsFrom(src_tc);
 }
 
@@ -88,9 +88,13 @@ class CheckerCPU;
  * all the necessary state for full architecture-level functional
  * simulation.  See the AtomicSimpleCPU or TimingSimpleCPU for
  * examples.
+ *
+ * The class is final so that the exec contexts of those CPU models, which
+ * hold a SimpleThread pointer, read and write registers with direct and
+ * inlinable calls instead of going through the ThreadContext vtable.
  */
 
-class SimpleThread : public ThreadState, public ThreadContext
+class SimpleThread final : public ThreadState, public ThreadContext
 {
   public:
     typedef ThreadContext::Status Status;
@@ -90,6 +90,10 @@ GarnetSyntheticTraffic::GarnetSyntheticTraffic(const Params &p)
       injRate(p.inj_rate),
       injVnet(p.inj_vnet),
       precision(p.precision),
+      injRange(pow((double) 10, (double) precision)),
+      injRates(p.inj_rates),
+      phase(0),
+      phaseEnd(p.sim_cycles),
       responseLimit(p.response_limit),
       requestorId(p.system->getRequestorId(this))
 {
@@ -103,6 +107,8 @@ GarnetSyntheticTraffic::GarnetSyntheticTraffic(const Params &p)
     }
     traffic = trafficStringToEnum[trafficType];
 
+    setInjRate(injRates.empty() ? injRate : injRates.front());
+
     id = TESTER_NETWORK++;
     DPRINTF(GarnetSyntheticTraffic,"Config Created: Name = %s , and id = %d\n",
             name(), id);
@@ -123,6 +129,13 @@ GarnetSyntheticTraffic::init()
     numPacketsSent = 0;
 }
 
+void
+GarnetSyntheticTraffic::setInjRate(double rate)
+{
+    injRate = rate;
+    injThreshold = injRate * injRange;
+}
+
 
 void
 GarnetSyntheticTraffic::completeRequest(PacketPtr pkt)
@@ -150,9 +163,8 @@ GarnetSyntheticTraffic::tick()
     // - generate a random number between 0 and 10^precision
     // - send pkt if this number is < injRate*(10^precision)
     bool sendAllowedThisCycle;
-    double injRange = pow((double) 10, (double) precision);
     unsigned trySending = random_mt.random<unsigned>(0, (int) injRange);
-    if (trySending < injRate*injRange)
+    if (trySending < injThreshold)
         sendAllowedThisCycle = true;
     else
         sendAllowedThisCycle = false;
@@ -161,6 +173,10 @@ GarnetSyntheticTraffic::tick()
     if (sendAllowedThisCycle) {
         bool senderEnable = true;
 
+        // the port is blocked until the retry of the last packet
+        if (retryPkt)
+            senderEnable = false;
+
         if (numPacketsMax >= 0 && numPacketsSent >= numPacketsMax)
             senderEnable = false;
 
@@ -171,8 +187,17 @@ GarnetSyntheticTraffic::tick()
             generatePkt();
     }
 
+    // Move on to the next injection rate of a sweep, stopping the
+    // simulation once so that the stats of the phase can be dumped
+    if (curTick() >= phaseEnd && phase + 1 < injRates.size()) {
+        setInjRate(injRates[++phase]);
+        phaseEnd += simCycles;
+        if (id == 0)
+            exitSimLoop("Network Tester completed phase");
+    }
+
     // Schedule wakeup
-    if (curTick() >= simCycles)
+    if (curTick() >= phaseEnd)
         exitSimLoop("Network Tester completed simCycles");
     else {
         if (!tickEvent.scheduled())
@@ -291,20 +316,20 @@ GarnetSyntheticTraffic::generatePkt()
     if (injReqType == 0) {
         // generate packet for virtual network 0
         requestType = MemCmd::ReadReq;
-        req = std::make_shared<Request>(paddr, access_size, flags,
-                                        requestorId);
+        req = makeRequest(paddr, access_size, flags,
+                          requestorId);
     } else if (injReqType == 1) {
         // generate packet for virtual network 1
         requestType = MemCmd::ReadReq;
         flags.set(Request::INST_FETCH);
-        req = std::make_shared<Request>(
+        req = makeRequest(
             0x0, access_size, flags, requestorId, 0x0, 0);
         req->setPaddr(paddr);
     } else {  // if (injReqType == 2)
         // generate packet for virtual network 2
         requestType = MemCmd::WriteReq;
-        req = std::make_shared<Request>(paddr, access_size, flags,
-                                        requestorId);
+        req = makeRequest(paddr, access_size, flags,
+                          requestorId);
     }
 
     req->setContext(id);
@@ -317,7 +342,8 @@ GarnetSyntheticTraffic::generatePkt()
             destination, req->getPaddr());
 
     PacketPtr pkt = new Packet(req, requestType);
-    pkt->dataDynamic(new uint8_t[req->getSize()]);
+    assert(req->getSize() <= sizeof(pktData));
+    pkt->dataStatic(pktData);
     pkt->senderState = NULL;
 
     sendPkt(pkt);
@@ -30,6 +30,7 @@
 #define __CPU_GARNET_SYNTHETIC_TRAFFIC_HH__
 
 #include <set>
+#include <vector>
 
 #include "base/statistics.hh"
 #include "mem/port.hh"
@@ -131,12 +132,30 @@ class GarnetSyntheticTraffic : public ClockedObject
     int injVnet;
     int precision;
 
+    /** Range the injection roll is drawn from, 10^precision */
+    const double injRange;
+    /** Rolls below this value inject, injRate scaled to injRange */
+    double injThreshold;
+
+    /**
+     * Injection rates of a sweep, one phase of simCycles each. With no
+     * rates there is a single phase at injRate.
+     */
+    const std::vector<double> injRates;
+    unsigned phase;
+    Tick phaseEnd;
+
+    /** Payload shared by all packets, its content is never used */
+    uint8_t pktData[8];
+
     const Cycles responseLimit;
 
     RequestorID requestorId;
 
     void completeRequest(PacketPtr pkt);
 
+    void setInjRate(double rate);
+
     void generatePkt();
     void sendPkt(PacketPtr pkt);
     void initTrafficType();
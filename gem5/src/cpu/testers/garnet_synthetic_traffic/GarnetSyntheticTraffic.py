@@ -46,6 +46,8 @@ class GarnetSyntheticTraffic(ClockedObject):
                                  Default depends on traffic_type")
     traffic_type = Param.String("uniform_random", "Traffic type")
     inj_rate = Param.Float(0.1, "Packet injection rate")
+    inj_rates = VectorParam.Float([], "Injection rates to sweep, each \
+                                       for sim_cycles, instead of inj_rate")
     inj_vnet = Param.Int(-1, "Vnet to inject in. \
                               0 and 1 are 1-flit, 2 is 5-flit. \
                                 Default is to inject in all three vnets")
@@ -61,7 +61,8 @@ class PyTrafficGen(BaseTrafficGen):
         PyBindMethod("createDramRot"),
         PyBindMethod("createHybrid"),
         PyBindMethod("createNvm"),
-        PyBindMethod("createStrided")
+        PyBindMethod("createStrided"),
+        PyBindMethod("createProfile")
     ]
 
     @cxxMethod(override=True)
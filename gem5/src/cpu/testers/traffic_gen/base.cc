@@ -49,6 +49,7 @@
 #include "cpu/testers/traffic_gen/idle_gen.hh"
 #include "cpu/testers/traffic_gen/linear_gen.hh"
 #include "cpu/testers/traffic_gen/nvm_gen.hh"
+#include "cpu/testers/traffic_gen/profile_gen.hh"
 #include "cpu/testers/traffic_gen/random_gen.hh"
 #include "cpu/testers/traffic_gen/stream_gen.hh"
 #include "cpu/testers/traffic_gen/strided_gen.hh"
@@ -177,44 +178,54 @@ BaseTrafficGen::update()
         transition();
     } else {
         assert(curTick() >= nextPacketTick);
-        // get the next packet and try to send it
-        PacketPtr pkt = activeGenerator->getNextPacket();
-
-        // If generating stream/substream IDs are enabled,
-        // try to pick and assign them to the new packet
-        if (streamGenerator) {
-            auto sid = streamGenerator->pickStreamID();
-            auto ssid = streamGenerator->pickSubstreamID();
-
-            pkt->req->setStreamId(sid);
-
-            if (streamGenerator->ssidValid()) {
-                pkt->req->setSubstreamId(ssid);
+        // send all the packets due at this tick in one go, rather than
+        // scheduling an update for each of them, e.g. for a trace
+        // with many requests at the same tick
+        do {
+            // get the next packet and try to send it
+            PacketPtr pkt = activeGenerator->getNextPacket();
+
+            // If generating stream/substream IDs are enabled,
+            // try to pick and assign them to the new packet
+            if (streamGenerator) {
+                auto sid = streamGenerator->pickStreamID();
+                auto ssid = streamGenerator->pickSubstreamID();
+
+                pkt->req->setStreamId(sid);
+
+                if (streamGenerator->ssidValid()) {
+                    pkt->req->setSubstreamId(ssid);
+                }
             }
-        }
 
-        // suppress packets that are not destined for a memory, such as
-        // device accesses that could be part of a trace
-        if (pkt && system->isMemAddr(pkt->getAddr())) {
-            stats.numPackets++;
-            // Only attempts to send if not blocked by pending responses
-            blockedWaitingResp = allocateWaitingRespSlot(pkt);
-            if (blockedWaitingResp || !port.sendTimingReq(pkt)) {
-                retryPkt = pkt;
-                retryPktTick = curTick();
+            // suppress packets that are not destined for a memory, such as
+            // device accesses that could be part of a trace
+            if (pkt && system->isMemAddr(pkt->getAddr())) {
+                stats.numPackets++;
+                // Only attempts to send if not blocked by pending responses
+                blockedWaitingResp = allocateWaitingRespSlot(pkt);
+                if (blockedWaitingResp || !port.sendTimingReq(pkt)) {
+                    retryPkt = pkt;
+                    retryPktTick = curTick();
+                }
+            } else if (pkt) {
+                DPRINTF(TrafficGen, "Suppressed packet %s 0x%x\n",
+                        pkt->cmdString(), pkt->getAddr());
+
+                ++stats.numSuppressed;
+                if (!(static_cast<int>(stats.numSuppressed.value()) % 10000))
+                    warn("%s suppressed %d packets with non-memory "
+                         "addresses\n", name(), stats.numSuppressed.value());
+
+                delete pkt;
+                pkt = nullptr;
             }
-        } else if (pkt) {
-            DPRINTF(TrafficGen, "Suppressed packet %s 0x%x\n",
-                    pkt->cmdString(), pkt->getAddr());
 
-            ++stats.numSuppressed;
-            if (!(static_cast<int>(stats.numSuppressed.value()) % 10000))
-                warn("%s suppressed %d packets with non-memory addresses\n",
-                     name(), stats.numSuppressed.value());
-
-            delete pkt;
-            pkt = nullptr;
-        }
+            if (retryPkt)
+                break;
+            nextPacketTick = activeGenerator->nextPacketTick(elasticReq, 0);
+        } while (nextPacketTick <= curTick() &&
+                 curTick() < nextTransitionTick);
     }
 
     // if we are waiting for a retry or for a response, do not schedule any
@@ -362,7 +373,11 @@ BaseTrafficGen::StatGroup::StatGroup(statistics::Group *parent)
                "Read bandwidth", bytesRead / simSeconds),
       ADD_STAT(writeBW, statistics::units::Rate<
                     statistics::units::Byte, statistics::units::Second>::get(),
-               "Write bandwidth", bytesWritten / simSeconds)
+               "Write bandwidth", bytesWritten / simSeconds),
+      ADD_STAT(hostPacketRate, statistics::units::Rate<
+                    statistics::units::Count,
+                    statistics::units::Second>::get(),
+               "Packets generated per host second", numPackets / hostSeconds)
 {
 }
 
@@ -542,6 +557,49 @@ BaseTrafficGen::createStrided(Tick duration,
                                                   read_percent, data_limit));
 }
 
+std::shared_ptr<BaseGen>
+BaseTrafficGen::createProfile(
+    Tick duration, Addr blocksize,
+    Tick min_period, Tick max_period, Addr data_limit,
+    const std::vector<Addr> &stream_starts,
+    const std::vector<Addr> &stream_ends,
+    const std::vector<double> &stream_weights,
+    const std::vector<double> &stream_read_fracs,
+    const std::vector<std::vector<int64_t>> &strides,
+    const std::vector<std::vector<double>> &stride_probs,
+    const std::vector<std::vector<unsigned>> &reuse_dists,
+    const std::vector<std::vector<double>> &reuse_probs)
+{
+    const size_t num_streams = stream_starts.size();
+    if (stream_ends.size() != num_streams ||
+        stream_weights.size() != num_streams ||
+        stream_read_fracs.size() != num_streams ||
+        strides.size() != num_streams ||
+        stride_probs.size() != num_streams ||
+        reuse_dists.size() != num_streams ||
+        reuse_probs.size() != num_streams)
+        fatal("%s: the profile lists do not have one entry per stream\n",
+              name());
+
+    std::vector<ProfileGen::Stream> streams(num_streams);
+    for (size_t i = 0; i < num_streams; i++) {
+        streams[i].start = stream_starts[i];
+        streams[i].end = stream_ends[i];
+        streams[i].weight = stream_weights[i];
+        streams[i].readFraction = stream_read_fracs[i];
+        streams[i].strides = strides[i];
+        streams[i].strideProbs = stride_probs[i];
+        streams[i].reuseDists = reuse_dists[i];
+        streams[i].reuseProbs = reuse_probs[i];
+    }
+
+    return std::shared_ptr<BaseGen>(new ProfileGen(*this, requestorId,
+                                                  duration, blocksize,
+                                                  system->cacheLineSize(),
+                                                  min_period, max_period,
+                                                  data_limit, streams));
+}
+
 std::shared_ptr<BaseGen>
 BaseTrafficGen::createTrace(Tick duration,
                             const std::string& trace_file, Addr addr_offset)
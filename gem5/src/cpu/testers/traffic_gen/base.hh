@@ -38,9 +38,11 @@
 #ifndef __CPU_TRAFFIC_GEN_BASE_HH__
 #define __CPU_TRAFFIC_GEN_BASE_HH__
 
+#include <cstdint>
 #include <memory>
 #include <tuple>
 #include <unordered_map>
+#include <vector>
 
 #include "base/statistics.hh"
 #include "enums/AddrMap.hh"
@@ -239,6 +241,9 @@ class BaseTrafficGen : public ClockedObject
 
         /** Write bandwidth in bytes/s  */
         statistics::Formula writeBW;
+
+        /** Replay rate in packets per host second */
+        statistics::Formula hostPacketRate;
     } stats;
 
   public:
@@ -325,6 +330,25 @@ class BaseTrafficGen : public ClockedObject
         Tick min_period, Tick max_period,
         uint8_t read_percent, Addr data_limit);
 
+    /**
+     * Create a ProfileGen. The i-th stream has the region
+     * [stream_starts[i], stream_ends[i]), the share stream_weights[i]
+     * of the requests, the read fraction stream_read_fracs[i], and the
+     * stride and reuse distributions given by the i-th lists of
+     * strides and reuse distances with their probabilities.
+     */
+    std::shared_ptr<BaseGen> createProfile(
+        Tick duration, Addr blocksize,
+        Tick min_period, Tick max_period, Addr data_limit,
+        const std::vector<Addr> &stream_starts,
+        const std::vector<Addr> &stream_ends,
+        const std::vector<double> &stream_weights,
+        const std::vector<double> &stream_read_fracs,
+        const std::vector<std::vector<int64_t>> &strides,
+        const std::vector<std::vector<double>> &stride_probs,
+        const std::vector<std::vector<unsigned>> &reuse_dists,
+        const std::vector<std::vector<double>> &reuse_probs);
+
     std::shared_ptr<BaseGen> createTrace(
         Tick duration,
         const std::string& trace_file, Addr addr_offset);
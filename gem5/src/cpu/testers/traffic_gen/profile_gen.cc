@@ -0,0 +1,242 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/testers/traffic_gen/profile_gen.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/logging.hh"
+#include "base/random.hh"
+#include "base/trace.hh"
+#include "debug/TrafficGen.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+Addr
+regionStart(const std::vector<ProfileGen::Stream> &streams)
+{
+    Addr start = MaxAddr;
+    for (const auto &stream : streams)
+        start = std::min(start, stream.start);
+    return streams.empty() ? 0 : start;
+}
+
+Addr
+regionEnd(const std::vector<ProfileGen::Stream> &streams)
+{
+    Addr end = 0;
+    for (const auto &stream : streams)
+        end = std::max(end, stream.end);
+    return end;
+}
+
+/** Overall read percentage, only informative as streams have their own */
+uint8_t
+overallReadPercent(const std::vector<ProfileGen::Stream> &streams)
+{
+    double weight = 0, reads = 0;
+    for (const auto &stream : streams) {
+        weight += stream.weight;
+        reads += stream.weight * stream.readFraction;
+    }
+    return weight > 0 ? std::lround(100 * reads / weight) : 0;
+}
+
+/** Cumulative distribution of a set of probabilities */
+std::vector<double>
+cumulative(const std::string &name, const std::vector<double> &probs)
+{
+    std::vector<double> cdf;
+    double sum = 0;
+    for (auto prob : probs) {
+        if (prob < 0)
+            fatal("%s: negative probability in profile\n", name);
+        sum += prob;
+        cdf.push_back(sum);
+    }
+    if (sum > 1 + 1e-6)
+        fatal("%s: probabilities of a distribution sum to %f > 1\n",
+              name, sum);
+    return cdf;
+}
+
+} // anonymous namespace
+
+ProfileGen::ProfileGen(SimObject &obj, RequestorID requestor_id,
+                       Tick _duration, Addr _blocksize, Addr cacheline_size,
+                       Tick min_period, Tick max_period, Addr data_limit,
+                       const std::vector<Stream> &_streams)
+    : StochasticGen(obj, requestor_id, _duration, regionStart(_streams),
+                    regionEnd(_streams), _blocksize, cacheline_size,
+                    min_period, max_period, overallReadPercent(_streams),
+                    data_limit),
+      dataManipulated(0)
+{
+    if (_streams.empty())
+        fatal("%s: a profile needs at least one stream\n", name());
+
+    double weight = 0;
+    for (const auto &profile : _streams) {
+        if (profile.end < profile.start + blocksize)
+            fatal("%s: stream region [%#x, %#x) is smaller than a block\n",
+                  name(), profile.start, profile.end);
+        if (profile.readFraction < 0 || profile.readFraction > 1)
+            fatal("%s: read fraction %f is not in [0, 1]\n", name(),
+                  profile.readFraction);
+        if (profile.strides.size() != profile.strideProbs.size() ||
+            profile.reuseDists.size() != profile.reuseProbs.size())
+            fatal("%s: distribution values and probabilities do not "
+                  "match\n", name());
+
+        StreamState stream;
+        stream.profile = profile;
+        stream.strideCdf = cumulative(name(), profile.strideProbs);
+        stream.reuseCdf = cumulative(name(), profile.reuseProbs);
+
+        unsigned max_dist = 1;
+        for (auto dist : profile.reuseDists) {
+            if (dist == 0)
+                fatal("%s: reuse distances start at 1\n", name());
+            max_dist = std::max(max_dist, dist);
+        }
+        stream.history.resize(max_dist);
+        streams.push_back(std::move(stream));
+
+        weight += profile.weight;
+        streamCdf.push_back(weight);
+    }
+    if (weight <= 0)
+        fatal("%s: the streams have no weight\n", name());
+    for (auto &cum : streamCdf)
+        cum /= weight;
+}
+
+void
+ProfileGen::enter()
+{
+    // every stream starts over at the beginning of its region
+    for (auto &stream : streams) {
+        stream.cursor = stream.profile.start;
+        stream.head = 0;
+        stream.count = 0;
+    }
+    dataManipulated = 0;
+}
+
+int
+ProfileGen::draw(const std::vector<double> &cdf, double sample)
+{
+    auto it = std::upper_bound(cdf.begin(), cdf.end(), sample);
+    return it == cdf.end() ? -1 : it - cdf.begin();
+}
+
+Addr
+ProfileGen::nextAddr(StreamState &stream)
+{
+    const Stream &profile = stream.profile;
+    const int64_t size = (profile.end - profile.start) / blocksize *
+        blocksize;
+    const size_t depth = stream.history.size();
+
+    Addr addr;
+    int reuse = stream.count ?
+        draw(stream.reuseCdf, random_mt.random<double>()) : -1;
+    if (reuse != -1) {
+        // access again a recent block, the cursor stays where it is
+        size_t dist = std::min<size_t>(profile.reuseDists[reuse],
+                                       stream.count);
+        addr = stream.history[(stream.head + depth - dist) % depth];
+    } else {
+        int stride = draw(stream.strideCdf, random_mt.random<double>());
+        int64_t offset = stream.cursor - profile.start;
+        if (stride != -1) {
+            // strides wrap around the region in either direction
+            offset = ((offset + profile.strides[stride]) % size + size) %
+                size;
+        } else {
+            offset = random_mt.random<int64_t>(0, size - 1);
+        }
+        stream.cursor = profile.start + offset;
+        addr = profile.start + offset / blocksize * blocksize;
+    }
+
+    stream.history[stream.head] = addr;
+    stream.head = (stream.head + 1) % depth;
+    stream.count = std::min(stream.count + 1, depth);
+    return addr;
+}
+
+PacketPtr
+ProfileGen::getNextPacket()
+{
+    auto &stream = streams[std::max(draw(streamCdf,
+                                         random_mt.random<double>()), 0)];
+    Addr addr = nextAddr(stream);
+    bool isRead = random_mt.random<double>() < stream.profile.readFraction;
+
+    DPRINTF(TrafficGen, "ProfileGen::getNextPacket: %c to addr %x, "
+            "size %d\n", isRead ? 'r' : 'w', addr, blocksize);
+
+    // Add the amount of data manipulated to the total
+    dataManipulated += blocksize;
+
+    return getPacket(addr, blocksize,
+                     isRead ? MemCmd::ReadReq : MemCmd::WriteReq);
+}
+
+Tick
+ProfileGen::nextPacketTick(bool elastic, Tick delay) const
+{
+    // Check to see if we have reached the data limit. If dataLimit is
+    // zero we do not have a data limit and therefore we will keep
+    // generating requests for the entire residency in this state.
+    if (dataLimit && dataManipulated >= dataLimit) {
+        DPRINTF(TrafficGen, "Data limit for ProfileGen reached.\n");
+        // there are no more requests, therefore return MaxTick
+        return MaxTick;
+    } else {
+        // the think time of the program between two of its accesses
+        Tick wait = random_mt.random(minPeriod, maxPeriod);
+
+        // compensate for the delay experienced to not be elastic, by
+        // default the value we generate is from the time we are
+        // asked, so the elasticity happens automatically
+        if (!elastic) {
+            if (wait < delay)
+                wait = 0;
+            else
+                wait -= delay;
+        }
+
+        return curTick() + wait;
+    }
+}
+
+} // namespace gem5
@@ -0,0 +1,156 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a generator replaying the memory access profile of a
+ * program as a set of address streams.
+ */
+
+#ifndef __CPU_TRAFFIC_GEN_PROFILE_GEN_HH__
+#define __CPU_TRAFFIC_GEN_PROFILE_GEN_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "base_gen.hh"
+#include "mem/packet.hh"
+
+namespace gem5
+{
+
+/**
+ * The profile generator emulates the memory traffic of a program from
+ * a statistical profile of its accesses, e.g. one extracted from a
+ * memory trace of a real run by util/traffic_profile.py. The accesses
+ * are split into streams, each with its own address region, share of
+ * the accesses, read fraction, stride distribution and reuse
+ * distribution.
+ *
+ * Every request picks a stream by weight. With the probability of its
+ * reuse distribution, it accesses again the block the stream accessed
+ * a given number of its accesses ago. Otherwise it moves the stream
+ * cursor by a stride drawn from the stride distribution, or, for the
+ * probability the strides leave, to a random block of the region.
+ *
+ * The think time between requests is drawn between min_period and
+ * max_period, and the memory level parallelism is the
+ * max_outstanding_reqs of the traffic generator, which makes the
+ * generation closed loop.
+ */
+class ProfileGen : public StochasticGen
+{
+  public:
+
+    /** The profile of an address stream */
+    struct Stream
+    {
+        /** Address region, end excluded */
+        Addr start;
+        Addr end;
+
+        /** Relative share of the requests */
+        double weight;
+
+        /** Fraction of the requests that are reads */
+        double readFraction;
+
+        /** Strides in bytes, possibly negative, and their probabilities */
+        std::vector<int64_t> strides;
+        std::vector<double> strideProbs;
+
+        /**
+         * Reuse distances, in accesses of the stream, and their
+         * probabilities.
+         */
+        std::vector<unsigned> reuseDists;
+        std::vector<double> reuseProbs;
+    };
+
+    /**
+     * Create a profile generator. Set min_period == max_period for a
+     * fixed think time.
+     *
+     * @param obj SimObject owning this sequence generator
+     * @param requestor_id RequestorID related to the memory requests
+     * @param _duration duration of this state before transitioning
+     * @param _blocksize Size used for transactions injected
+     * @param cacheline_size cache line size in the system
+     * @param min_period Lower limit of random inter-transaction time
+     * @param max_period Upper limit of random inter-transaction time
+     * @param data_limit Upper limit on how much data to read/write
+     * @param streams The address streams of the profile
+     */
+    ProfileGen(SimObject &obj, RequestorID requestor_id, Tick _duration,
+               Addr _blocksize, Addr cacheline_size,
+               Tick min_period, Tick max_period, Addr data_limit,
+               const std::vector<Stream> &streams);
+
+    void enter();
+
+    PacketPtr getNextPacket();
+
+    Tick nextPacketTick(bool elastic, Tick delay) const;
+
+  private:
+    /** A stream with its state and its cumulative distributions */
+    struct StreamState
+    {
+        Stream profile;
+
+        std::vector<double> strideCdf;
+        std::vector<double> reuseCdf;
+
+        /** Byte address moved by the strides, accessed by block */
+        Addr cursor;
+
+        /** Addresses of the last accesses, as a ring */
+        std::vector<Addr> history;
+        size_t head;
+        size_t count;
+    };
+
+    /** Index of the value drawn from a cumulative distribution */
+    static int draw(const std::vector<double> &cdf, double sample);
+
+    /** Address of the next access of a stream */
+    Addr nextAddr(StreamState &stream);
+
+    std::vector<StreamState> streams;
+
+    /** Cumulative stream weights */
+    std::vector<double> streamCdf;
+
+    /**
+     * Counter to determine the amount of data
+     * manipulated. Used to determine if we should continue
+     * generating requests.
+     */
+    Addr dataManipulated;
+};
+
+} // namespace gem5
+
+#endif
@@ -37,12 +37,21 @@
 
 #include "cpu/testers/traffic_gen/trace_gen.hh"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <algorithm>
+#include <cerrno>
+#include <cstring>
 
 #include "base/random.hh"
 #include "base/trace.hh"
 #include "debug/TrafficGen.hh"
+#include "mem/probes/mem_trace.hh"
 #include "proto/packet.pb.h"
+#include "sim/byteswap.hh"
 #include "sim/core.hh"
 #include "sim/cur_tick.hh"
 
@@ -50,9 +59,66 @@ namespace gem5
 {
 
 TraceGen::InputStream::InputStream(const std::string& filename)
-    : trace(filename)
 {
-    init();
+    if (!mapBinary(filename)) {
+        trace.reset(new ProtoInputStream(filename));
+        init();
+    }
+}
+
+TraceGen::InputStream::~InputStream()
+{
+    if (map)
+        munmap(map, mapSize);
+}
+
+bool
+TraceGen::InputStream::mapBinary(const std::string& filename)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    char magic[4];
+    if (fstat(fd, &st) != 0 || st.st_size < 24 ||
+        pread(fd, magic, sizeof(magic), 0) != sizeof(magic) ||
+        memcmp(magic, "g5mt", sizeof(magic)) != 0) {
+        close(fd);
+        return false;
+    }
+
+    mapSize = st.st_size;
+    void *addr = mmap(nullptr, mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+        fatal("Failed to map trace %s: %s\n", filename, strerror(errno));
+    map = (uint8_t *)addr;
+    madvise(map, mapSize, MADV_SEQUENTIAL);
+
+    // the header is the magic, then 32 bit little endian words and the
+    // requestor names
+    auto word = [this](size_t offset) {
+        panic_if(offset + 4 > mapSize, "Truncated trace header\n");
+        uint32_t val;
+        memcpy(&val, map + offset, sizeof(val));
+        return letoh(val);
+    };
+    panic_if(word(4) != 1, "Unsupported binary trace version %d\n",
+             word(4));
+    panic_if(word(8) != sizeof(MemTraceProbe::Record),
+             "Binary trace records of %d bytes, expected %d\n",
+             word(8), sizeof(MemTraceProbe::Record));
+    uint64_t freq = word(12) | (uint64_t)word(16) << 32;
+    panic_if(freq != sim_clock::Frequency,
+             "Trace was recorded with a different tick frequency %d\n",
+             freq);
+
+    size_t offset = 24;
+    for (uint32_t i = 0, n = word(20); i < n; i++)
+        offset += 4 + word(offset);
+    firstRecord = nextRecord = offset;
+    return true;
 }
 
 void
@@ -60,7 +126,7 @@ TraceGen::InputStream::init()
 {
     // Create a protobuf message for the header and read it from the stream
     ProtoMessage::PacketHeader header_msg;
-    if (!trace.read(header_msg)) {
+    if (!trace->read(header_msg)) {
         panic("Failed to read packet header from trace\n");
     } else if (header_msg.tick_freq() != sim_clock::Frequency) {
         panic("Trace was recorded with a different tick frequency %d\n",
@@ -71,15 +137,34 @@ TraceGen::InputStream::init()
 void
 TraceGen::InputStream::reset()
 {
-    trace.reset();
+    if (map) {
+        nextRecord = firstRecord;
+        return;
+    }
+    trace->reset();
     init();
 }
 
 bool
 TraceGen::InputStream::read(TraceElement& element)
 {
+    if (map) {
+        if (nextRecord + sizeof(MemTraceProbe::Record) > mapSize)
+            return false;
+        // the records are not necessarily aligned after the names
+        MemTraceProbe::Record rec;
+        memcpy(&rec, map + nextRecord, sizeof(rec));
+        nextRecord += sizeof(rec);
+        element.cmd = letoh(rec.cmd);
+        element.addr = letoh(rec.addr);
+        element.blocksize = letoh(rec.size);
+        element.tick = letoh(rec.tick);
+        element.flags = letoh(rec.flags);
+        return true;
+    }
+
     ProtoMessage::Packet pkt_msg;
-    if (trace.read(pkt_msg)) {
+    if (trace->read(pkt_msg)) {
         element.cmd = pkt_msg.cmd();
         element.addr = pkt_msg.addr();
         element.blocksize = pkt_msg.size();
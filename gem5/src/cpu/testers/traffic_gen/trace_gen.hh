@@ -44,6 +44,8 @@
 #ifndef __CPU_TRAFFIC_GEN_TRACE_GEN_HH__
 #define __CPU_TRAFFIC_GEN_TRACE_GEN_HH__
 
+#include <memory>
+
 #include "base/bitfield.hh"
 #include "base/intmath.hh"
 #include "base_gen.hh"
@@ -105,6 +107,10 @@ class TraceGen : public BaseGen
      * The InputStream encapsulates a trace file and the
      * internal buffers and populates TraceElements based on
      * the input.
+     *
+     * Besides protobuf traces, it plays the uncompressed binary traces
+     * of MemTraceProbe, which it maps in memory and reads records from
+     * in place.
      */
     class InputStream
     {
@@ -112,7 +118,20 @@ class TraceGen : public BaseGen
       private:
 
         /// Input file stream for the protobuf trace
-        ProtoInputStream trace;
+        std::unique_ptr<ProtoInputStream> trace;
+
+        /// Mapping of a binary trace, and the next record to read
+        uint8_t *map = nullptr;
+        size_t mapSize = 0;
+        size_t firstRecord = 0;
+        size_t nextRecord = 0;
+
+        /**
+         * Map the file if it is a binary trace.
+         *
+         * @return false if it is not one
+         */
+        bool mapBinary(const std::string& filename);
 
       public:
 
@@ -122,6 +141,7 @@ class TraceGen : public BaseGen
          * @param filename Path to the file to read from
          */
         InputStream(const std::string& filename);
+        ~InputStream();
 
         /**
          * Reset the stream such that it can be played once
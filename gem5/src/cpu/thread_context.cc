@@ -131,6 +131,53 @@ ThreadContext::compare(ThreadContext *one, ThreadContext *two)
 
 }
 
+namespace
+{
+
+uint64_t
+digestMix(uint64_t digest, uint64_t value)
+{
+    return digest ^ (value + 0x9e3779b97f4a7c15ULL + (digest << 6) +
+                     (digest >> 2));
+}
+
+} // anonymous namespace
+
+uint64_t
+ThreadContext::digest(ThreadContext *tc)
+{
+    const auto &regClasses = tc->getIsaPtr()->regClasses();
+
+    uint64_t digest = digestMix(0, tc->pcState().instAddr());
+    digest = digestMix(digest, tc->pcState().microPC());
+
+    for (int i = 0; i < regClasses.at(IntRegClass).size(); ++i)
+        digest = digestMix(digest, tc->readIntReg(i));
+
+    for (int i = 0; i < regClasses.at(FloatRegClass).size(); ++i)
+        digest = digestMix(digest, tc->readFloatReg(i));
+
+    for (int i = 0; i < regClasses.at(VecRegClass).size(); ++i) {
+        const TheISA::VecRegContainer &reg =
+            tc->readVecReg(RegId(VecRegClass, i));
+        const uint8_t *bytes = reg.as<uint8_t>();
+        for (int b = 0; b < reg.size(); ++b)
+            digest = digestMix(digest, bytes[b]);
+    }
+
+    for (int i = 0; i < regClasses.at(VecPredRegClass).size(); ++i) {
+        const TheISA::VecPredRegContainer &reg =
+            tc->readVecPredReg(RegId(VecPredRegClass, i));
+        for (int b = 0; b < TheISA::VecPredRegContainer::NUM_BITS; ++b)
+            digest = digestMix(digest, reg[b]);
+    }
+
+    for (int i = 0; i < regClasses.at(CCRegClass).size(); ++i)
+        digest = digestMix(digest, tc->readCCReg(i));
+
+    return digest;
+}
+
 void
 ThreadContext::sendFunctional(PacketPtr pkt)
 {
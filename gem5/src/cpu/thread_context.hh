@@ -260,6 +260,15 @@ class ThreadContext : public PCEventScope
     /** function to compare two thread contexts (for debugging) */
     static void compare(ThreadContext *one, ThreadContext *two);
 
+    /**
+     * Hash the architectural state of a thread context, its PC and all
+     * its registers but the misc ones, which hold state such as cycle
+     * counters that legitimately differs between CPU models. Two CPU
+     * models running the same program have the same digest after the
+     * same number of instructions.
+     */
+    static uint64_t digest(ThreadContext *tc);
+
     /** @{ */
     /**
      * Flat register interfaces
@@ -31,11 +31,25 @@
 
 #include <cassert>
 #include <cstring>
-#include <vector>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace gem5
 {
 
+/**
+ * Whether T can reset itself to its default state through a clear()
+ * member, in which case the time buffer recycles its slots with it
+ * instead of destroying and reconstructing them every cycle.
+ */
+template <class T, class = void>
+struct TimeBufferClearable : std::false_type {};
+
+template <class T>
+struct TimeBufferClearable<T,
+    std::void_t<decltype(std::declval<T &>().clear())>> : std::true_type {};
+
 template <class T>
 class TimeBuffer
 {
@@ -45,10 +59,12 @@ class TimeBuffer
     unsigned size;
     int _id;
 
+    /** The slots, laid out contiguously. */
     char *data;
-    std::vector<char *> index;
     unsigned base;
 
+    T *slot(unsigned i) const { return reinterpret_cast<T *>(data) + i; }
+
     void valid(int idx) const
     {
         assert (idx >= -past && idx <= future);
@@ -139,16 +155,12 @@ class TimeBuffer
   public:
     TimeBuffer(int p, int f)
         : past(p), future(f), size(past + future + 1),
-          data(new char[size * sizeof(T)]), index(size), base(0)
+          data(new char[size * sizeof(T)]), base(0)
     {
         assert(past >= 0 && future >= 0);
-        char *ptr = data;
-        for (unsigned i = 0; i < size; i++) {
-            index[i] = ptr;
-            std::memset(ptr, 0, sizeof(T));
-            new (ptr) T;
-            ptr += sizeof(T);
-        }
+        std::memset(data, 0, size * sizeof(T));
+        for (unsigned i = 0; i < size; i++)
+            new (slot(i)) T;
 
         _id = -1;
     }
@@ -161,7 +173,7 @@ class TimeBuffer
     ~TimeBuffer()
     {
         for (unsigned i = 0; i < size; ++i)
-            (reinterpret_cast<T *>(index[i]))->~T();
+            slot(i)->~T();
         delete [] data;
     }
 
@@ -184,13 +196,17 @@ class TimeBuffer
         int ptr = base + future;
         if (ptr >= (int)size)
             ptr -= size;
-        (reinterpret_cast<T *>(index[ptr]))->~T();
-        std::memset(index[ptr], 0, sizeof(T));
-        new (index[ptr]) T;
+        if constexpr (TimeBufferClearable<T>::value) {
+            slot(ptr)->clear();
+        } else {
+            slot(ptr)->~T();
+            std::memset(static_cast<void *>(slot(ptr)), 0, sizeof(T));
+            new (slot(ptr)) T;
+        }
     }
 
   protected:
-    //Calculate the index into this->index for element at position idx
+    //Calculate the index into the slots for element at position idx
     //relative to now
     inline int calculateVectorIndex(int idx) const
     {
@@ -212,21 +228,21 @@ class TimeBuffer
     {
         int vector_index = calculateVectorIndex(idx);
 
-        return reinterpret_cast<T *>(index[vector_index]);
+        return slot(vector_index);
     }
 
     T &operator[](int idx)
     {
         int vector_index = calculateVectorIndex(idx);
 
-        return reinterpret_cast<T &>(*index[vector_index]);
+        return *slot(vector_index);
     }
 
     const T &operator[] (int idx) const
     {
         int vector_index = calculateVectorIndex(idx);
 
-        return reinterpret_cast<const T &>(*index[vector_index]);
+        return *slot(vector_index);
     }
 
     wire getWire(int idx)
@@ -0,0 +1,110 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "cpu/timebuf.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/** A slot type that counts how it gets recycled. */
+struct Clearable
+{
+    static int constructed;
+    static int cleared;
+
+    int value;
+
+    Clearable() { ++constructed; }
+    void clear() { ++cleared; value = 0; }
+};
+
+int Clearable::constructed = 0;
+int Clearable::cleared = 0;
+
+/** A slot type with no clear() that the buffer reconstructs. */
+struct Plain
+{
+    std::shared_ptr<int> ptr;
+    int value;
+};
+
+} // anonymous namespace
+
+static_assert(TimeBufferClearable<Clearable>::value);
+static_assert(!TimeBufferClearable<Plain>::value);
+
+/** Values written to the future can be read back from the past. */
+TEST(TimeBufferTest, Delay)
+{
+    TimeBuffer<Plain> buf(2, 2);
+    auto in = buf.getWire(0);
+    auto out = buf.getWire(-2);
+
+    in->value = 1;
+    buf.advance();
+    in->value = 2;
+    buf.advance();
+    EXPECT_EQ(out->value, 1);
+    buf.advance();
+    EXPECT_EQ(out->value, 2);
+}
+
+/** Slots that come around again are reset to their default state. */
+TEST(TimeBufferTest, ReconstructSlots)
+{
+    TimeBuffer<Plain> buf(1, 1);
+    auto ptr = std::make_shared<int>(0);
+    buf[1].ptr = ptr;
+    buf[1].value = 5;
+
+    for (unsigned i = 0; i < buf.getSize(); ++i)
+        buf.advance();
+    EXPECT_EQ(buf[1].value, 0);
+    EXPECT_EQ(buf[1].ptr, nullptr);
+    EXPECT_EQ(ptr.use_count(), 1);
+}
+
+/** Types with a clear() are recycled without being reconstructed. */
+TEST(TimeBufferTest, ClearSlots)
+{
+    Clearable::constructed = 0;
+    Clearable::cleared = 0;
+
+    TimeBuffer<Clearable> buf(1, 1);
+    EXPECT_EQ(Clearable::constructed, buf.getSize());
+
+    buf[1].value = 5;
+    for (unsigned i = 0; i < buf.getSize(); ++i)
+        buf.advance();
+    EXPECT_EQ(buf[1].value, 0);
+    EXPECT_EQ(Clearable::constructed, buf.getSize());
+    EXPECT_EQ(Clearable::cleared, buf.getSize());
+}
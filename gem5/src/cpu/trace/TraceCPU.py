@@ -60,7 +60,10 @@ class TraceCPU(BaseCPU):
         return True
 
     instTraceFile = Param.String("", "Instruction trace file")
-    dataTraceFile = Param.String("", "Data dependency trace file")
+    dataTraceFile = Param.String("", "Data dependency trace file, either "\
+        "protobuf or converted by util/map_inst_dep_trace.py")
+    dataTraceStart = Param.UInt64(0, "Data dependency trace record to "\
+        "start replaying from, mapped traces skip to it directly")
     sizeStoreBuffer = Param.Unsigned(16, "Number of entries in the store "\
         "buffer")
     sizeLoadBuffer = Param.Unsigned(16, "Number of entries in the load buffer")
@@ -73,6 +76,13 @@ class TraceCPU(BaseCPU):
     freqMultiplier = Param.Float(1.0, "Multiplier scale the Trace CPU "\
                                  "frequency up or down")
 
+    # Number of data dependency trace records inflated and decoded ahead of
+    # the replay on a reader thread. Zero decodes them on the simulation
+    # thread when they are needed.
+    dataTraceReadAhead = Param.Unsigned(8192, "Number of data trace "\
+                                        "records to decode ahead on a "\
+                                        "reader thread")
+
     # Enable exiting when any one Trace CPU completes execution which is set to
     # false by default
     enableEarlyExit = Param.Bool(False, "Exit when any one Trace CPU "\
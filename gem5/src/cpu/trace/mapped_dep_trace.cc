@@ -0,0 +1,109 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/trace/mapped_dep_trace.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#include "base/logging.hh"
+#include "sim/byteswap.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+const char traceMagic[8] = {'g', 'e', 'm', '5', 'e', 'd', 't', '\0'};
+
+} // anonymous namespace
+
+bool
+MappedDepTrace::isMappedTrace(const std::string &filename)
+{
+    char magic[sizeof(traceMagic)];
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    file.read(magic, sizeof(magic));
+    return file.good() && memcmp(magic, traceMagic, sizeof(magic)) == 0;
+}
+
+MappedDepTrace::MappedDepTrace(const std::string &filename)
+    : buffer(nullptr), length(0), _header(nullptr), _records(nullptr)
+{
+    fatal_if(HostByteOrder != ByteOrder::little,
+             "Mapped trace %s needs a little endian host.", filename);
+
+    int fd = open(filename.c_str(), O_RDONLY);
+    fatal_if(fd == -1, "Could not open %s for reading: %s", filename,
+             strerror(errno));
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == -1)
+        panic("Cannot stat %s: %s", filename, strerror(errno));
+    length = file_stat.st_size;
+    fatal_if(length < sizeof(Header), "%s is too short for a trace header.",
+             filename);
+
+    // The mapping is shared and read only, so every TraceCPU (and every
+    // gem5 process) replaying this trace uses the same page cache copy
+    buffer = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (buffer == MAP_FAILED)
+        panic("Failed to map %s: %s", filename, strerror(errno));
+
+    _header = (const Header *)buffer;
+    _records = (const Record *)((const uint8_t *)buffer + sizeof(Header));
+
+    fatal_if(memcmp(_header->magic, traceMagic, sizeof(traceMagic)) != 0,
+             "%s is not a mapped instruction dependency trace.", filename);
+    fatal_if(_header->version != formatVersion ||
+             _header->recordSize != sizeof(Record) ||
+             _header->maxDeps != maxDeps,
+             "%s has version %d with %d byte records of up to %d "
+             "dependencies, expected version %d with %d byte records of "
+             "up to %d.", filename, _header->version, _header->recordSize,
+             _header->maxDeps, formatVersion, sizeof(Record), maxDeps);
+    fatal_if(length < sizeof(Header) + size() * sizeof(Record),
+             "%s is truncated, its header lists %d records.", filename,
+             size());
+
+    // Replay reads the trace sequentially
+    madvise(buffer, length, MADV_SEQUENTIAL);
+}
+
+MappedDepTrace::~MappedDepTrace()
+{
+    if (buffer)
+        munmap(buffer, length);
+}
+
+} // namespace gem5
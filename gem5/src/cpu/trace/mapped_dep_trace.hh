@@ -0,0 +1,131 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declares a reader for instruction dependency traces stored as
+ * uncompressed, fixed size records. Such a trace is memory mapped rather
+ * than inflated and parsed, so several TraceCPUs replaying it share the
+ * page cache copy of the file, and replay can start at any record.
+ * util/map_inst_dep_trace.py converts the protobuf traces of
+ * inst_dep_record.proto to this format.
+ */
+
+#ifndef __CPU_TRACE_MAPPED_DEP_TRACE_HH__
+#define __CPU_TRACE_MAPPED_DEP_TRACE_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace gem5
+{
+
+/**
+ * A memory mapped instruction dependency trace. The file is a header
+ * followed by one record per instruction, in host (little endian) byte
+ * order. Dependencies are stored as distances to earlier sequence
+ * numbers, order dependencies first, and register dependencies that are
+ * also order dependencies are dropped by the converter.
+ */
+class MappedDepTrace
+{
+  public:
+    /** Maximum number of dependencies of a record */
+    static constexpr unsigned maxDeps = 16;
+
+    /** Version of the format written by util/map_inst_dep_trace.py */
+    static constexpr uint32_t formatVersion = 1;
+
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t windowSize;
+        uint64_t tickFreq;
+        uint64_t numRecords;
+        uint32_t recordSize;
+        uint32_t maxDeps;
+        uint8_t reserved[24];
+    };
+
+    struct Record
+    {
+        uint64_t seqNum;
+        /** Committed and filtered micro-ops up to this one */
+        uint64_t robNum;
+        uint64_t physAddr;
+        uint64_t virtAddr;
+        uint64_t pc;
+        uint64_t compDelay;
+        uint32_t size;
+        uint32_t flags;
+        /** An InstDepRecord::RecordType */
+        uint8_t type;
+        uint8_t numRobDeps;
+        uint8_t numRegDeps;
+        uint8_t pad[5];
+        uint32_t depDistance[maxDeps];
+    };
+
+    static_assert(sizeof(Header) == 64, "Unexpected trace header layout");
+    static_assert(sizeof(Record) == 128, "Unexpected trace record layout");
+
+    /**
+     * Check if a file is a mapped trace, as opposed to a protobuf one.
+     *
+     * @param filename Path of the trace
+     * @return True if the file starts with the mapped trace magic
+     */
+    static bool isMappedTrace(const std::string &filename);
+
+    /**
+     * Map a trace, which is checked for consistency.
+     *
+     * @param filename Path of the trace
+     */
+    MappedDepTrace(const std::string &filename);
+    ~MappedDepTrace();
+
+    MappedDepTrace(const MappedDepTrace &) = delete;
+    MappedDepTrace &operator=(const MappedDepTrace &) = delete;
+
+    const Header &header() const { return *_header; }
+
+    /** Number of records in the trace */
+    uint64_t size() const { return _header->numRecords; }
+
+    const Record &operator[](uint64_t i) const { return _records[i]; }
+
+  private:
+    void *buffer;
+    size_t length;
+    const Header *_header;
+    const Record *_records;
+};
+
+} // namespace gem5
+
+#endif // __CPU_TRACE_MAPPED_DEP_TRACE_HH__
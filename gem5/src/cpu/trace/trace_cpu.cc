@@ -37,6 +37,8 @@
 
 #include "cpu/trace/trace_cpu.hh"
 
+#include <chrono>
+
 #include "base/compiler.hh"
 #include "sim/sim_exit.hh"
 
@@ -287,12 +289,38 @@ TraceCPU::ElasticDataGen::adjustInitTraceOffset(Tick& offset)
     }
 }
 
+TraceCPU::ElasticDataGen::~ElasticDataGen()
+{
+    for (auto& graph_node : depGraph)
+        delete graph_node.second;
+    for (auto free_node : freeNodes)
+        delete free_node;
+}
+
 void
 TraceCPU::ElasticDataGen::exit()
 {
     trace.reset();
 }
 
+TraceCPU::ElasticDataGen::GraphNode*
+TraceCPU::ElasticDataGen::allocNode()
+{
+    if (freeNodes.empty())
+        return new GraphNode;
+    GraphNode* node = freeNodes.back();
+    freeNodes.pop_back();
+    return node;
+}
+
+void
+TraceCPU::ElasticDataGen::freeNode(GraphNode* node)
+{
+    // clear the dependents but keep their storage for the next node
+    node->dependents.clear();
+    freeNodes.push_back(node);
+}
+
 bool
 TraceCPU::ElasticDataGen::readNextWindow()
 {
@@ -312,7 +340,7 @@ TraceCPU::ElasticDataGen::readNextWindow()
     while (num_read != windowSize) {
 
         // Create a new graph node
-        GraphNode* new_node = new GraphNode;
+        GraphNode* new_node = allocNode();
 
         // Read the next line to get the next record. If that fails then end of
         // trace has been reached and traceComplete needs to be set in addition
@@ -320,6 +348,7 @@ TraceCPU::ElasticDataGen::readNextWindow()
         if (!trace.read(new_node)) {
             DPRINTF(TraceCPUData, "\tTrace complete!\n");
             traceComplete = true;
+            freeNode(new_node);
             return false;
         }
 
@@ -505,12 +534,10 @@ TraceCPU::ElasticDataGen::execute()
         if (!node_ptr->isLoad() || node_ptr->isStrictlyOrdered()) {
             // Release all resources occupied by the completed node
             hwResource.release(node_ptr);
-            // clear the dynamically allocated set of dependents
-            (node_ptr->dependents).clear();
             // Update the stat for numOps simulated
             owner.updateNumOps(node_ptr->robNum);
-            // delete node
-            delete node_ptr;
+            // recycle node
+            freeNode(node_ptr);
             // remove from graph
             depGraph.erase(graph_itr);
         }
@@ -599,7 +626,7 @@ TraceCPU::ElasticDataGen::executeMemReq(GraphNode* node_ptr)
     }
 
     // Create a request and the packet containing request
-    auto req = std::make_shared<Request>(
+    auto req = makeRequest(
         node_ptr->physAddr, node_ptr->size, node_ptr->flags, requestorId);
     req->setReqInstSeqNum(node_ptr->seqNum);
 
@@ -713,12 +740,10 @@ TraceCPU::ElasticDataGen::completeMemAccess(PacketPtr pkt)
             }
         }
 
-        // clear the dynamically allocated set of dependents
-        (node_ptr->dependents).clear();
         // Update the stat for numOps completed
         owner.updateNumOps(node_ptr->robNum);
-        // delete node
-        delete node_ptr;
+        // recycle node
+        freeNode(node_ptr);
         // remove from graph
         depGraph.erase(graph_itr);
     }
@@ -1090,7 +1115,7 @@ TraceCPU::FixedRetryGen::send(Addr addr, unsigned size, const MemCmd& cmd,
 {
 
     // Create new request
-    auto req = std::make_shared<Request>(addr, size, flags, requestorId);
+    auto req = makeRequest(addr, size, flags, requestorId);
     req->setPC(pc);
 
     // If this is not done it triggers assert in L1 cache for invalid contextId
@@ -1195,14 +1220,32 @@ TraceCPU::DcachePort::recvReqRetry()
 }
 
 TraceCPU::ElasticDataGen::InputStream::InputStream(
-        const std::string& filename, const double time_multiplier) :
-    trace(filename),
+        const std::string& filename, const double time_multiplier,
+        unsigned read_ahead, uint64_t start_record) :
+    mappedTrace(MappedDepTrace::isMappedTrace(filename) ?
+                new MappedDepTrace(filename) : nullptr),
+    trace(mappedTrace ? nullptr : new ProtoInputStream(filename)),
+    mappedNext(0), startRecord(start_record),
+    ring(mappedTrace ? 0 : read_ahead),
+    ringHead(0), ringTail(0), traceEnd(false), stopThread(false),
     timeMultiplier(time_multiplier),
-    microOpCount(0)
+    microOpCount(0), decodedOpCount(0)
 {
+    if (mappedTrace) {
+        fatal_if(mappedTrace->header().tickFreq != sim_clock::Frequency,
+                 "Trace %s was recorded with a different tick frequency %d",
+                 filename, mappedTrace->header().tickFreq);
+        fatal_if(startRecord >= mappedTrace->size(),
+                 "Can't start at record %d of %s, it has %d records",
+                 startRecord, filename, mappedTrace->size());
+        windowSize = mappedTrace->header().windowSize;
+        skipToStart();
+        return;
+    }
+
     // Create a protobuf message for the header and read it from the stream
     ProtoMessage::InstDepRecordHeader header_msg;
-    if (!trace.read(header_msg)) {
+    if (!trace->read(header_msg)) {
         panic("Failed to read packet header from %s\n", filename);
 
         if (header_msg.tick_freq() != sim_clock::Frequency) {
@@ -1214,19 +1257,168 @@ TraceCPU::ElasticDataGen::InputStream::InputStream(
         // when the data dependency trace was captured in the o3cpu model
         windowSize = header_msg.window_size();
     }
+
+    skipToStart();
+    startThread();
+}
+
+TraceCPU::ElasticDataGen::InputStream::~InputStream()
+{
+    joinThread();
+}
+
+void
+TraceCPU::ElasticDataGen::InputStream::startThread()
+{
+    if (ring.empty())
+        return;
+
+    ringHead = 0;
+    ringTail = 0;
+    traceEnd = false;
+    stopThread = false;
+    readerThread = std::thread(&InputStream::readAhead, this);
+}
+
+void
+TraceCPU::ElasticDataGen::InputStream::joinThread()
+{
+    if (!readerThread.joinable())
+        return;
+
+    stopThread = true;
+    readerThread.join();
 }
 
 void
 TraceCPU::ElasticDataGen::InputStream::reset()
 {
-    trace.reset();
+    joinThread();
+    if (trace) {
+        // Skip the header again
+        ProtoMessage::InstDepRecordHeader header_msg;
+        trace->reset();
+        trace->read(header_msg);
+    }
+    skipToStart();
+    startThread();
+}
+
+void
+TraceCPU::ElasticDataGen::InputStream::skipToStart()
+{
+    if (mappedTrace) {
+        mappedNext = startRecord;
+        return;
+    }
+
+    // Protobuf traces can only be read sequentially
+    GraphNode skipped;
+    for (uint64_t i = 0; i < startRecord && decode(&skipped); i++);
+}
+
+void
+TraceCPU::ElasticDataGen::InputStream::readAhead()
+{
+    const uint64_t ring_size = ring.size();
+    while (!stopThread.load(std::memory_order_relaxed)) {
+        const uint64_t tail = ringTail.load(std::memory_order_relaxed);
+        if (tail - ringHead.load(std::memory_order_acquire) == ring_size) {
+            // The simulation is far enough behind, give it some time to
+            // catch up rather than spinning on the ring
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            continue;
+        }
+
+        if (!decode(&ring[tail % ring_size])) {
+            traceEnd.store(true, std::memory_order_release);
+            return;
+        }
+        ringTail.store(tail + 1, std::memory_order_release);
+    }
 }
 
 bool
 TraceCPU::ElasticDataGen::InputStream::read(GraphNode* element)
 {
+    if (ring.empty()) {
+        if (!decode(element))
+            return false;
+        microOpCount = element->robNum;
+        return true;
+    }
+
+    const uint64_t head = ringHead.load(std::memory_order_relaxed);
+    while (head == ringTail.load(std::memory_order_acquire)) {
+        // The thread publishes its last node before flagging the end of
+        // the trace, so check the ring once more after seeing the flag
+        if (traceEnd.load(std::memory_order_acquire)) {
+            if (head == ringTail.load(std::memory_order_acquire))
+                return false;
+            break;
+        }
+        std::this_thread::yield();
+    }
+
+    // Swap the dependencies rather than copying them, which hands the
+    // storage of the recycled node over to the ring slot
+    GraphNode& slot = ring[head % ring.size()];
+    element->seqNum = slot.seqNum;
+    element->robNum = slot.robNum;
+    element->type = slot.type;
+    element->physAddr = slot.physAddr;
+    element->virtAddr = slot.virtAddr;
+    element->size = slot.size;
+    element->flags = slot.flags;
+    element->pc = slot.pc;
+    element->compDelay = slot.compDelay;
+    element->robDep.swap(slot.robDep);
+    element->regDep.swap(slot.regDep);
+    ringHead.store(head + 1, std::memory_order_release);
+
+    microOpCount = element->robNum;
+    return true;
+}
+
+bool
+TraceCPU::ElasticDataGen::InputStream::decodeMapped(GraphNode* element)
+{
+    if (mappedNext == mappedTrace->size())
+        return false;
+
+    const MappedDepTrace::Record& record = (*mappedTrace)[mappedNext++];
+    assert(record.numRobDeps + record.numRegDeps <= MappedDepTrace::maxDeps);
+    element->seqNum = record.seqNum;
+    element->robNum = record.robNum;
+    element->type = RecordType(record.type);
+    element->physAddr = record.physAddr;
+    element->virtAddr = record.virtAddr;
+    element->size = record.size;
+    element->flags = record.flags;
+    element->pc = record.pc;
+    // Scale the compute delay to effectively scale the Trace CPU frequency
+    element->compDelay = record.compDelay * timeMultiplier;
+
+    // The order dependencies come first, and the converter already dropped
+    // the register dependencies that are also order dependencies
+    element->robDep.clear();
+    element->regDep.clear();
+    int dep = 0;
+    for (; dep < record.numRobDeps; dep++)
+        element->robDep.push_back(record.seqNum - record.depDistance[dep]);
+    for (; dep < record.numRobDeps + record.numRegDeps; dep++)
+        element->regDep.push_back(record.seqNum - record.depDistance[dep]);
+    return true;
+}
+
+bool
+TraceCPU::ElasticDataGen::InputStream::decode(GraphNode* element)
+{
+    if (mappedTrace)
+        return decodeMapped(element);
+
     ProtoMessage::InstDepRecord pkt_msg;
-    if (trace.read(pkt_msg)) {
+    if (trace->read(pkt_msg)) {
         // Required fields
         element->seqNum = pkt_msg.seq_num();
         element->type = pkt_msg.type();
@@ -1280,11 +1472,11 @@ TraceCPU::ElasticDataGen::InputStream::read(GraphNode* element)
             element->pc = 0;
 
         // ROB occupancy number
-        ++microOpCount;
+        ++decodedOpCount;
         if (pkt_msg.has_weight()) {
-            microOpCount += pkt_msg.weight();
+            decodedOpCount += pkt_msg.weight();
         }
-        element->robNum = microOpCount;
+        element->robNum = decodedOpCount;
         return true;
     }
 
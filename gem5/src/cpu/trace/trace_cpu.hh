@@ -38,14 +38,19 @@
 #ifndef __CPU_TRACE_TRACE_CPU_HH__
 #define __CPU_TRACE_TRACE_CPU_HH__
 
+#include <atomic>
 #include <cstdint>
 #include <list>
+#include <memory>
 #include <queue>
 #include <set>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "base/statistics.hh"
 #include "cpu/base.hh"
+#include "cpu/trace/mapped_dep_trace.hh"
 #include "debug/TraceCPUData.hh"
 #include "debug/TraceCPUInst.hh"
 #include "params/TraceCPU.hh"
@@ -557,11 +562,15 @@ class TraceCPU : public BaseCPU
         class GraphNode
         {
           public:
-            /** Typedef for the list containing the ROB dependencies */
-            typedef std::list<NodeSeqNum> RobDepList;
+            /**
+             * Typedef for the list containing the ROB dependencies. Nodes
+             * are recycled, so the lists keep their storage from one node
+             * to the next.
+             */
+            typedef std::vector<NodeSeqNum> RobDepList;
 
             /** Typedef for the list containing the register dependencies */
-            typedef std::list<NodeSeqNum> RegDepList;
+            typedef std::vector<NodeSeqNum> RegDepList;
 
             /** Instruction sequence number */
             NodeSeqNum seqNum;
@@ -756,13 +765,43 @@ class TraceCPU : public BaseCPU
         /**
          * The InputStream encapsulates a trace file and the
          * internal buffers and populates GraphNodes based on
-         * the input.
+         * the input. Unless the read ahead is zero, the records of
+         * protobuf traces are inflated and decoded on a reader thread into
+         * a single producer, single consumer ring of nodes, ahead of the
+         * simulation. Mapped traces are cheap enough to decode on read.
          */
         class InputStream
         {
           private:
-            /** Input file stream for the protobuf trace */
-            ProtoInputStream trace;
+            /** The mapped trace, if the trace is not a protobuf one */
+            std::unique_ptr<MappedDepTrace> mappedTrace;
+
+            /** Input file stream for the protobuf trace, if any */
+            std::unique_ptr<ProtoInputStream> trace;
+
+            /** Index of the next record of the mapped trace */
+            uint64_t mappedNext;
+
+            /** Record to start the replay from */
+            const uint64_t startRecord;
+
+            /** Decoded nodes waiting to be read, empty without read ahead */
+            std::vector<GraphNode> ring;
+
+            /** Number of nodes read from the ring, owned by the reader */
+            std::atomic<uint64_t> ringHead;
+
+            /** Number of nodes decoded into the ring, owned by the thread */
+            std::atomic<uint64_t> ringTail;
+
+            /** Set by the thread once it has decoded the last record */
+            std::atomic<bool> traceEnd;
+
+            /** Set to ask the thread to stop */
+            std::atomic<bool> stopThread;
+
+            /** Thread decoding the trace into the ring */
+            std::thread readerThread;
 
             /**
              * A multiplier for the compute delays in the trace to modulate
@@ -775,6 +814,9 @@ class TraceCPU : public BaseCPU
             /** Count of committed ops read from trace plus the filtered ops */
             uint64_t microOpCount;
 
+            /** Count of committed and filtered ops decoded from the trace */
+            uint64_t decodedOpCount;
+
             /**
              * The window size that is read from the header of the protobuf
              * trace and used to process the dependency trace
@@ -787,9 +829,15 @@ class TraceCPU : public BaseCPU
              *
              * @param filename Path to the file to read from
              * @param time_multiplier used to scale the compute delays
+             * @param read_ahead number of records to decode ahead on a
+             *                   reader thread, zero to decode them on read
+             * @param start_record number of records to skip
              */
             InputStream(const std::string& filename,
-                        const double time_multiplier);
+                        const double time_multiplier,
+                        unsigned read_ahead, uint64_t start_record);
+
+            ~InputStream();
 
             /**
              * Reset the stream such that it can be played once
@@ -808,6 +856,29 @@ class TraceCPU : public BaseCPU
              */
             bool read(GraphNode* element);
 
+          private:
+            /**
+             * Decode the next trace record into a node.
+             *
+             * @param element Trace element to populate
+             * @return True if a record could be decoded
+             */
+            bool decode(GraphNode* element);
+
+            /** Decode the next record of a mapped trace into a node */
+            bool decodeMapped(GraphNode* element);
+
+            /** Skip the records ahead of the start record */
+            void skipToStart();
+
+            /** Decode records into the ring until told to stop */
+            void readAhead();
+
+            /** Start and stop the reader thread, if reading ahead */
+            void startThread();
+            void joinThread();
+
+          public:
             /** Get window size from trace */
             uint32_t getWindowSize() const { return windowSize; }
 
@@ -824,7 +895,8 @@ class TraceCPU : public BaseCPU
             owner(_owner),
             port(_port),
             requestorId(requestor_id),
-            trace(trace_file, 1.0 / params.freqMultiplier),
+            trace(trace_file, 1.0 / params.freqMultiplier,
+                  params.dataTraceReadAhead, params.dataTraceStart),
             genName(owner.name() + ".elastic." + _name),
             retryPkt(nullptr),
             traceComplete(false),
@@ -838,6 +910,8 @@ class TraceCPU : public BaseCPU
                     windowSize);
         }
 
+        ~ElasticDataGen();
+
         /**
          * Called from TraceCPU init(). Reads the first message from the
          * input trace file and returns the send tick.
@@ -993,6 +1067,15 @@ class TraceCPU : public BaseCPU
         /** Store the depGraph of GraphNodes */
         std::unordered_map<NodeSeqNum, GraphNode*> depGraph;
 
+        /** Nodes that left the graph, to be reused for new ones */
+        std::vector<GraphNode*> freeNodes;
+
+        /** Get a node for a new trace record from the free nodes */
+        GraphNode* allocNode();
+
+        /** Return a completed node to the free nodes */
+        void freeNode(GraphNode* node);
+
         /**
          * Queue of dependency-free nodes that are pending issue because
          * resources are not available. This is chosen to be FIFO so that
@@ -113,7 +113,7 @@ DmaPort::handleResp(DmaReqState *state, Addr addr, Addr size, Tick delay)
 PacketPtr
 DmaPort::DmaReqState::createPacket()
 {
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = makeRequest(
             gen.addr(), gen.size(), flags, id);
     req->setStreamId(sid);
     req->setSubstreamId(ssid);
@@ -260,8 +260,12 @@ DmaPort::sendAtomicBdReq(DmaReqState *state)
     bool done = false;
 
     auto bd_it = memBackdoors.contains(state->gen.addr());
-    if (bd_it == memBackdoors.end()) {
-        // We don't have a backdoor for this address, so use a packet.
+    const bool is_read = MemCmd(state->cmd).isRead();
+    if (bd_it == memBackdoors.end() ||
+        !(is_read ? bd_it->second->readable() :
+                    bd_it->second->writeable())) {
+        // We don't have a backdoor for this address, or not one that
+        // allows this access, so use a packet.
 
         PacketPtr pkt = state->createPacket();
         DPRINTF(DMA, "Sending DMA for addr: %#x size: %d\n",
@@ -309,7 +313,7 @@ DmaPort::sendAtomicBdReq(DmaReqState *state)
         if (state->data) {
             uint8_t *bd_data = bd->ptr() + offset;
             uint8_t *state_data = state->data + state->gen.complete();
-            if (MemCmd(state->cmd).isRead())
+            if (is_read)
                 memcpy(state_data, bd_data, handled);
             else
                 memcpy(bd_data, state_data, handled);
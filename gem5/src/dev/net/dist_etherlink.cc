@@ -70,7 +70,7 @@ namespace gem5
 {
 
 DistEtherLink::DistEtherLink(const Params &p)
-    : SimObject(p), linkDelay(p.delay)
+    : SimObject(p), linkDelay(p.delay), stats(this)
 {
     DPRINTF(DistEthernet,"DistEtherLink::DistEtherLink() "
             "link delay:%llu ticksPerByte:%f\n", p.delay, p.speed);
@@ -107,6 +107,45 @@ DistEtherLink::~DistEtherLink()
     delete distIface;
 }
 
+DistEtherLink::DistEtherLinkStats::DistEtherLinkStats(DistEtherLink *link)
+    : statistics::Group(link),
+      ADD_STAT(txPackets, statistics::units::Count::get(),
+               "Data packets sent to the peer"),
+      ADD_STAT(txBytes, statistics::units::Byte::get(),
+               "Data bytes sent to the peer"),
+      ADD_STAT(txWrites, statistics::units::Count::get(),
+               "Transport writes the data packets were sent in"),
+      ADD_STAT(rxPackets, statistics::units::Count::get(),
+               "Data packets received from the peer"),
+      ADD_STAT(rxBytes, statistics::units::Byte::get(),
+               "Data bytes received from the peer"),
+      ADD_STAT(syncs, statistics::units::Count::get(),
+               "Global synchronisations of this gem5 process"),
+      ADD_STAT(syncWaitSeconds, statistics::units::Second::get(),
+               "Host seconds this gem5 process spent in global "
+               "synchronisations"),
+      ADD_STAT(syncSimSeconds, statistics::units::Second::get(),
+               "Host seconds this gem5 process spent simulating between "
+               "global synchronisations"),
+      ADD_STAT(syncWaitFraction, statistics::units::Ratio::get(),
+               "Fraction of the host time spent in global synchronisations")
+{
+    txPackets.functor([link]() {
+            return link->distIface->getCounters().txPackets; });
+    txBytes.functor([link]() {
+            return link->distIface->getCounters().txBytes; });
+    txWrites.functor([link]() {
+            return link->distIface->getCounters().txWrites; });
+    rxPackets.functor([link]() {
+            return link->distIface->getCounters().rxPackets.load(); });
+    rxBytes.functor([link]() {
+            return link->distIface->getCounters().rxBytes.load(); });
+    syncs.functor(DistIface::syncCount);
+    syncWaitSeconds.functor(DistIface::syncWaitSeconds).precision(6);
+    syncSimSeconds.functor(DistIface::syncSimSeconds).precision(6);
+    syncWaitFraction = syncWaitSeconds / (syncWaitSeconds + syncSimSeconds);
+}
+
 Port &
 DistEtherLink::getPort(const std::string &if_name, PortID idx)
 {
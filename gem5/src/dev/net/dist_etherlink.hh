@@ -51,6 +51,7 @@
 #include <cassert>
 #include <iostream>
 
+#include "base/statistics.hh"
 #include "base/types.hh"
 #include "dev/net/etherlink.hh"
 #include "params/DistEtherLink.hh"
@@ -217,6 +218,21 @@ class DistEtherLink : public SimObject
 
     Tick linkDelay;
 
+    struct DistEtherLinkStats : public statistics::Group
+    {
+        DistEtherLinkStats(DistEtherLink *link);
+
+        statistics::Value txPackets;
+        statistics::Value txBytes;
+        statistics::Value txWrites;
+        statistics::Value rxPackets;
+        statistics::Value rxBytes;
+        statistics::Value syncs;
+        statistics::Value syncWaitSeconds;
+        statistics::Value syncSimSeconds;
+        statistics::Formula syncWaitFraction;
+    } stats;
+
   public:
     using Params = DistEtherLinkParams;
     DistEtherLink(const Params &p);
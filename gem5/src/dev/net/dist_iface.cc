@@ -84,6 +84,21 @@ DistIface::Sync::init(Tick start_tick, Tick repeat_tick)
     }
 }
 
+bool
+DistIface::Sync::timedRun(bool same_tick)
+{
+    using namespace std::chrono;
+
+    auto start = steady_clock::now();
+    if (numSyncs > 0)
+        simSeconds += duration<double>(start - lastSyncEnd).count();
+    bool ret = run(same_tick);
+    lastSyncEnd = steady_clock::now();
+    waitSeconds += duration<double>(lastSyncEnd - start).count();
+    numSyncs++;
+    return ret;
+}
+
 void
 DistIface::Sync::abort()
 {
@@ -341,7 +356,7 @@ DistIface::SyncEvent::start()
     repeat = DistIface::sync->nextRepeat;
     // Do a global barrier to agree on a common repeat value (the smallest
     // one from all participating nodes.
-    if (!DistIface::sync->run(false))
+    if (!DistIface::sync->timedRun(false))
         panic("DistIface::SyncEvent::start() aborted\n");
 
     assert(!DistIface::sync->doCkpt);
@@ -394,7 +409,7 @@ DistIface::SyncEvent::process()
         EventQueue::ScopedRelease sr(curEventQueue());
         // we do a global sync here that is supposed to happen at the same
         // tick in all gem5 peers
-        if (!DistIface::sync->run(true))
+        if (!DistIface::sync->timedRun(true))
             return; // global sync aborted
         // global sync completed
     }
@@ -662,6 +677,8 @@ DistIface::packetOut(EthPacketPtr pkt, Tick send_delay)
 
     // Send out the packet and the meta info.
     sendPacket(header, pkt);
+    counters.txPackets++;
+    counters.txBytes += pkt->length;
 
     DPRINTF(DistEthernetPkt,
             "DistIface::sendDataPacket() done size:%d send_delay:%llu\n",
@@ -698,6 +715,8 @@ DistIface::recvThreadFunc(Event *recv_done, Tick link_delay)
         // We got a valid dist header packet, let's process it
         if (header.msgType == MsgType::dataDescriptor) {
             recvPacket(header, new_packet);
+            counters.rxPackets++;
+            counters.rxBytes += header.dataPacketLength;
             recvScheduler.pushPacket(new_packet,
                                      header.sendTick,
                                      header.sendDelay);
@@ -719,6 +738,8 @@ DistIface::spawnRecvThread(const Event *recv_done, Tick link_delay)
 {
     assert(recvThread == nullptr);
 
+    // the receiver thread schedules events on the simulation queues
+    externalEventThreads = true;
     recvThread = new std::thread(&DistIface::recvThreadFunc,
                                  this,
                                  const_cast<Event *>(recv_done),
@@ -942,4 +963,28 @@ DistIface::sizeParam()
     return val;
 }
 
+bool
+DistIface::periodicSync()
+{
+    return syncEvent && syncEvent->scheduled();
+}
+
+uint64_t
+DistIface::syncCount()
+{
+    return sync ? sync->numSyncs : 0;
+}
+
+double
+DistIface::syncWaitSeconds()
+{
+    return sync ? sync->waitSeconds : 0;
+}
+
+double
+DistIface::syncSimSeconds()
+{
+    return sync ? sync->simSeconds : 0;
+}
+
 } // namespace gem5
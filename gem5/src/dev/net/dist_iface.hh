@@ -76,6 +76,8 @@
 #define __DEV_DIST_IFACE_HH__
 
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <mutex>
 #include <queue>
 #include <thread>
@@ -157,8 +159,18 @@ class DistIface : public Drainable, public Serializable
          *  Flag is set if the sync is aborted (e.g. due to connection lost)
          */
         bool isAbort;
+        /**
+         * Host time accounting of the global synchronisations: the number
+         * of syncs, the host seconds spent in them (i.e. waiting for the
+         * peers) and the host seconds spent simulating between them.
+         */
+        uint64_t numSyncs = 0;
+        double waitSeconds = 0;
+        double simSeconds = 0;
+        std::chrono::steady_clock::time_point lastSyncEnd;
 
         friend class SyncEvent;
+        friend class DistIface;
 
       public:
         /**
@@ -175,6 +187,11 @@ class DistIface : public Drainable, public Serializable
          * @return true if the sync completes, false if it gets aborted
          */
         virtual bool run(bool same_tick) = 0;
+        /**
+         * Perform a full dist sync through run() and account for the host
+         * time it took.
+         */
+        bool timedRun(bool same_tick);
         /**
          * Callback when the receiver thread gets a sync ack message.
          *
@@ -495,6 +512,31 @@ class DistIface : public Drainable, public Serializable
 
     bool isPrimary;
 
+  public:
+    /**
+     * Traffic counters of a dist link. The receive side is updated by the
+     * receiver thread.
+     */
+    struct Counters
+    {
+        uint64_t txPackets = 0;
+        uint64_t txBytes = 0;
+        /** Writes the transport issued to send the data packets */
+        uint64_t txWrites = 0;
+        std::atomic<uint64_t> rxPackets{0};
+        std::atomic<uint64_t> rxBytes{0};
+    };
+
+  protected:
+    Counters counters;
+
+    /**
+     * A periodic sync is pending, so the transport may hold data packets
+     * back until the next command goes out and a peer still gets them in
+     * time.
+     */
+    static bool periodicSync();
+
   private:
     /**
      * Number of receiver threads (in this gem5 process)
@@ -640,6 +682,15 @@ class DistIface : public Drainable, public Serializable
      * Trigger the primary to start/stop synchronization.
      */
     static void toggleSync(ThreadContext *tc);
+
+    const Counters &getCounters() const { return counters; }
+    /**
+     * Host time accounting of the global synchronisations of this gem5
+     * process (see Sync::timedRun()).
+     */
+    static uint64_t syncCount();
+    static double syncWaitSeconds();
+    static double syncSimSeconds();
  };
 
 } // namespace gem5
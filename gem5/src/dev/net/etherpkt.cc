@@ -28,7 +28,9 @@
 
 #include "dev/net/etherpkt.hh"
 
+#include <array>
 #include <iostream>
+#include <vector>
 
 #include "base/inet.hh"
 #include "base/logging.hh"
@@ -37,6 +39,85 @@
 namespace gem5
 {
 
+namespace
+{
+
+/** Buffer size classes of the pool, 2KiB to 16KiB */
+constexpr unsigned minPoolBuffer = 2048;
+constexpr unsigned numPoolClasses = 4;
+constexpr unsigned maxPoolBuffer = minPoolBuffer << (numPoolClasses - 1);
+/** Free buffers kept per class, the rest go back to the heap */
+constexpr size_t maxFreeBuffers = 256;
+
+/**
+ * Set once the pool of the thread is gone, packets freed later on (e.g. by
+ * static destructors at exit) hand their buffers back to the heap.
+ */
+thread_local bool bufferPoolDone = false;
+
+struct BufferPool
+{
+    std::array<std::vector<uint8_t *>, numPoolClasses> free;
+
+    ~BufferPool()
+    {
+        bufferPoolDone = true;
+        for (auto &buffers : free) {
+            for (auto buffer : buffers)
+                delete [] buffer;
+        }
+    }
+};
+
+thread_local BufferPool bufferPool;
+
+unsigned
+poolClass(unsigned size)
+{
+    unsigned cls = 0;
+    while ((minPoolBuffer << cls) < size)
+        cls++;
+    return cls;
+}
+
+} // anonymous namespace
+
+uint8_t *
+EthPacketData::allocate(unsigned size)
+{
+    if (size > maxPoolBuffer || bufferPoolDone) {
+        allocLength = size;
+        return new uint8_t[size];
+    }
+
+    unsigned cls = poolClass(size);
+    allocLength = minPoolBuffer << cls;
+    auto &buffers = bufferPool.free[cls];
+    if (buffers.empty())
+        return new uint8_t[allocLength];
+    uint8_t *buffer = buffers.back();
+    buffers.pop_back();
+    return buffer;
+}
+
+void
+EthPacketData::release()
+{
+    if (!data)
+        return;
+
+    if (allocLength <= maxPoolBuffer && !bufferPoolDone) {
+        auto &buffers = bufferPool.free[poolClass(allocLength)];
+        if (buffers.size() < maxFreeBuffers) {
+            buffers.push_back(data);
+            data = nullptr;
+            return;
+        }
+    }
+    delete [] data;
+    data = nullptr;
+}
+
 void
 EthPacketData::serialize(const std::string &base, CheckpointOut &cp) const
 {
@@ -65,7 +146,7 @@ EthPacketData::unserialize(const std::string &base, CheckpointIn &cp)
     }
     assert(length <= bufLength);
     if (!data)
-        data = new uint8_t[bufLength];
+        data = allocate(bufLength);
     arrayParamIn(cp, base + ".data", data, length);
     if (!optParamIn(cp, base + ".simLength", simLength))
         simLength = length;
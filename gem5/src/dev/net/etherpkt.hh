@@ -78,13 +78,34 @@ class EthPacketData
     { }
 
     explicit EthPacketData(unsigned size)
-        : data(new uint8_t[size]), bufLength(size), length(0), simLength(0)
-    { }
+        : data(nullptr), bufLength(size), length(0), simLength(0)
+    {
+        data = allocate(size);
+    }
+
+    ~EthPacketData() { release(); }
 
-    ~EthPacketData() { if (data) delete [] data; }
+    EthPacketData(const EthPacketData &) = delete;
+    EthPacketData &operator=(const EthPacketData &) = delete;
 
     void serialize(const std::string &base, CheckpointOut &cp) const;
     void unserialize(const std::string &base, CheckpointIn &cp);
+
+  private:
+    /**
+     * Size of the buffer actually allocated for data, which may be
+     * larger than bufLength.
+     */
+    unsigned allocLength = 0;
+
+    /**
+     * Packet buffers come from per thread free lists of a few size
+     * classes (up to the 16KiB the NIC models ask for), so the frames of
+     * a throughput run recycle their buffers instead of going through
+     * new and delete once each. Larger buffers are allocated directly.
+     */
+    uint8_t *allocate(unsigned size);
+    void release();
 };
 
 typedef std::shared_ptr<EthPacketData> EthPacketPtr;
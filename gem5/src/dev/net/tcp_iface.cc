@@ -48,6 +48,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
 #include <vector>
@@ -76,6 +77,7 @@ namespace gem5
 
 std::vector<std::pair<TCPIface::NodeInfo, int> > TCPIface::nodes;
 std::vector<int> TCPIface::sockRegistry;
+std::vector<TCPIface *> TCPIface::ifaceRegistry;
 int TCPIface::fdStatic = -1;
 bool TCPIface::anyListening = false;
 
@@ -86,7 +88,8 @@ TCPIface::TCPIface(std::string server_name, unsigned server_port,
                    int num_nodes) :
     DistIface(dist_rank, dist_size, sync_start, sync_repeat, em, use_pseudo_op,
               is_switch, num_nodes), serverName(server_name),
-    serverPort(server_port), isSwitch(is_switch), listening(false)
+    serverPort(server_port), isSwitch(is_switch), listening(false),
+    rxBuffer(rxBufferBytes), rxHead(0), rxTail(0)
 {
     if (is_switch && isPrimary) {
         while (!listen(serverPort)) {
@@ -202,6 +205,7 @@ TCPIface::establishConnection()
                ni.distIfaceId);
     }
     sockRegistry.push_back(sock);
+    ifaceRegistry.push_back(this);
 }
 
 void
@@ -263,18 +267,24 @@ TCPIface::~TCPIface()
 void
 TCPIface::sendTCP(int sock, const void *buf, unsigned length)
 {
-    ssize_t ret;
-
-    ret = ::send(sock, buf, length, MSG_NOSIGNAL);
-    if (ret < 0) {
-        if (errno == ECONNRESET || errno == EPIPE) {
-            exitSimLoop("Message server closed connection, simulation "
-                        "is exiting");
-        } else {
-            panic("send() failed: %s", strerror(errno));
+    const char *data = static_cast<const char *>(buf);
+
+    while (length > 0) {
+        ssize_t ret = ::send(sock, data, length, MSG_NOSIGNAL);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == ECONNRESET || errno == EPIPE) {
+                exitSimLoop("Message server closed connection, simulation "
+                            "is exiting");
+                return;
+            } else {
+                panic("send() failed: %s", strerror(errno));
+            }
         }
+        data += ret;
+        length -= ret;
     }
-    panic_if(ret != length, "send() failed");
 }
 
 bool
@@ -296,11 +306,61 @@ TCPIface::recvTCP(int sock, void *buf, unsigned length)
     return (ret == length);
 }
 
+bool
+TCPIface::recvBuffered(void *buf, unsigned length)
+{
+    uint8_t *data = static_cast<uint8_t *>(buf);
+
+    while (length > 0) {
+        if (rxHead == rxTail) {
+            // nothing read ahead, large payloads bypass the buffer
+            if (length >= rxBuffer.size())
+                return recvTCP(sock, data, length);
+            ssize_t ret = ::recv(sock, rxBuffer.data(), rxBuffer.size(), 0);
+            if (ret < 0) {
+                if (errno == EINTR)
+                    continue;
+                if (errno == ECONNRESET || errno == EPIPE)
+                    inform("recv(): %s", strerror(errno));
+                else
+                    panic("recv() failed: %s", strerror(errno));
+                return false;
+            } else if (ret == 0) {
+                inform("recv(): Connection closed");
+                return false;
+            }
+            rxHead = 0;
+            rxTail = ret;
+        }
+        size_t chunk = std::min<size_t>(length, rxTail - rxHead);
+        memcpy(data, &rxBuffer[rxHead], chunk);
+        rxHead += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+    return true;
+}
+
+void
+TCPIface::flushTx()
+{
+    if (txBuffer.empty())
+        return;
+    sendTCP(sock, txBuffer.data(), txBuffer.size());
+    counters.txWrites++;
+    txBuffer.clear();
+}
+
 void
 TCPIface::sendPacket(const Header &header, const EthPacketPtr &packet)
 {
-    sendTCP(sock, &header, sizeof(header));
-    sendTCP(sock, packet->data, packet->length);
+    auto hdr = reinterpret_cast<const uint8_t *>(&header);
+    txBuffer.insert(txBuffer.end(), hdr, hdr + sizeof(header));
+    txBuffer.insert(txBuffer.end(), packet->data,
+                    packet->data + packet->length);
+    // Without a pending periodic sync nothing else would flush the packet
+    if (txBuffer.size() >= txBatchBytes || !periodicSync())
+        flushTx();
 }
 
 void
@@ -308,6 +368,10 @@ TCPIface::sendCmd(const Header &header)
 {
     DPRINTF(DistEthernetCmd, "TCPIface::sendCmd() type: %d\n",
             static_cast<int>(header.msgType));
+    // The data packets sent so far must reach the peers before the command
+    // (e.g. the sync request that closes their quantum)
+    for (auto iface: ifaceRegistry)
+        iface->flushTx();
     // Global commands (i.e. sync request) are always sent by the primary
     // DistIface. The transfer method is simply implemented as point-to-point
     // messages for now
@@ -318,7 +382,7 @@ TCPIface::sendCmd(const Header &header)
 bool
 TCPIface::recvHeader(Header &header)
 {
-    bool ret = recvTCP(sock, &header, sizeof(header));
+    bool ret = recvBuffered(&header, sizeof(header));
     DPRINTF(DistEthernetCmd, "TCPIface::recvHeader() type: %d ret: %d\n",
             static_cast<int>(header.msgType), ret);
     return ret;
@@ -328,7 +392,7 @@ void
 TCPIface::recvPacket(const Header &header, EthPacketPtr &packet)
 {
     packet = std::make_shared<EthPacketData>(header.dataPacketLength);
-    bool ret = recvTCP(sock, packet->data, header.dataPacketLength);
+    bool ret = recvBuffered(packet->data, header.dataPacketLength);
     panic_if(!ret, "Error while reading socket");
     packet->simLength = header.simLength;
     packet->length = header.dataPacketLength;
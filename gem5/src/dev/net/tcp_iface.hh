@@ -51,6 +51,7 @@
 
 
 #include <string>
+#include <vector>
 
 #include "dev/net/dist_iface.hh"
 
@@ -91,6 +92,30 @@ class TCPIface : public DistIface
      * Storage for all opened sockets
      */
     static std::vector<int> sockRegistry;
+    /**
+     * Storage for all connected interfaces (to flush their pending data
+     * packets before a command goes out)
+     */
+    static std::vector<TCPIface *> ifaceRegistry;
+
+    /**
+     * Data packets (headers and payloads) waiting to be written to the
+     * socket. While a periodic sync is pending, the packets of a quantum
+     * go out in a few large writes rather than two writes each. The
+     * buffer is flushed before any command, so a peer still gets the
+     * packets ahead of the sync that follows them.
+     */
+    std::vector<uint8_t> txBuffer;
+    static constexpr size_t txBatchBytes = 64 * 1024;
+
+    /**
+     * Bytes read ahead from the socket by the receiver thread, so the
+     * headers and payloads of a batch come in a few reads as well.
+     */
+    std::vector<uint8_t> rxBuffer;
+    size_t rxHead;
+    size_t rxTail;
+    static constexpr size_t rxBufferBytes = 64 * 1024;
 
   private:
 
@@ -112,6 +137,18 @@ class TCPIface : public DistIface
      * @param length Exact size of the expected message in bytes.
      */
     bool recvTCP(int sock, void *buf, unsigned length);
+    /**
+     * Receive the next bytes of the data stream from the connection of
+     * this interface, through the read ahead buffer.
+     *
+     * @param buf Start address of buffer to store the message.
+     * @param length Exact size of the expected message in bytes.
+     */
+    bool recvBuffered(void *buf, unsigned length);
+    /**
+     * Write the pending data packets to the socket.
+     */
+    void flushTx();
     bool listen(int port);
     void accept();
     void connect();
@@ -32,15 +32,19 @@
 
 #include "dev/storage/disk_image.hh"
 
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
 #include <fstream>
 #include <string>
 
+#include "base/bitfield.hh"
 #include "base/callback.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
@@ -53,12 +57,44 @@
 namespace gem5
 {
 
+////////////////////////////////////////////////////////////////////////
+//
+// Disk image
+//
+std::streampos
+DiskImage::readSectors(uint8_t *data, std::streampos offset,
+                       unsigned count) const
+{
+    std::streampos bytes = 0;
+    for (unsigned i = 0; i < count; i++) {
+        std::streampos done = read(data + i * SectorSize, offset + std::streamoff(i));
+        bytes += done;
+        if (done != SectorSize)
+            break;
+    }
+    return bytes;
+}
+
+std::streampos
+DiskImage::writeSectors(const uint8_t *data, std::streampos offset,
+                        unsigned count)
+{
+    std::streampos bytes = 0;
+    for (unsigned i = 0; i < count; i++) {
+        std::streampos done = write(data + i * SectorSize, offset + std::streamoff(i));
+        bytes += done;
+        if (done != SectorSize)
+            break;
+    }
+    return bytes;
+}
+
 ////////////////////////////////////////////////////////////////////////
 //
 // Raw Disk image
 //
 RawDiskImage::RawDiskImage(const Params &p)
-    : DiskImage(p), disk_size(0)
+    : DiskImage(p), fd(-1), mapping(nullptr), disk_size(0)
 {
     open(p.image_file, p.read_only);
 }
@@ -87,58 +123,94 @@ RawDiskImage::open(const std::string &filename, bool rd_only)
         readonly = rd_only;
         file = filename;
 
-        std::ios::openmode mode = std::ios::in | std::ios::binary;
-        if (!readonly)
-            mode |= std::ios::out;
-        stream.open(file.c_str(), mode);
-        if (!stream.is_open())
+        fd = ::open(file.c_str(), readonly ? O_RDONLY : O_RDWR);
+        if (fd < 0)
             panic("Error opening %s", filename);
+
+        // Seek rather than stat, so that the size of block devices used
+        // as images comes out right too
+        off_t end = lseek(fd, 0, SEEK_END);
+        if (end < 0)
+            panic("Could not find the size of %s", filename);
+        disk_size = end;
+
+        // Map the whole image so that accesses are a copy. If that isn't
+        // possible, fall back to reading and writing the file.
+        if (disk_size) {
+            int prot = PROT_READ | (readonly ? 0 : PROT_WRITE);
+            void *ptr = mmap(nullptr, disk_size, prot, MAP_SHARED, fd, 0);
+            if (ptr != MAP_FAILED)
+                mapping = static_cast<uint8_t *>(ptr);
+        }
     }
 }
 
 void
 RawDiskImage::close()
 {
-    stream.close();
+    if (mapping) {
+        munmap(mapping, disk_size);
+        mapping = nullptr;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
 }
 
 std::streampos
 RawDiskImage::size() const
 {
-    if (disk_size == 0) {
-        if (!stream.is_open())
-            panic("file not open!\n");
-        stream.seekg(0, std::ios::end);
-        disk_size = stream.tellg();
-    }
+    if (fd < 0)
+        panic("file not open!\n");
 
     return disk_size / SectorSize;
 }
 
 std::streampos
 RawDiskImage::read(uint8_t *data, std::streampos offset) const
+{
+    return readSectors(data, offset, 1);
+}
+
+std::streampos
+RawDiskImage::write(const uint8_t *data, std::streampos offset)
+{
+    return writeSectors(data, offset, 1);
+}
+
+std::streampos
+RawDiskImage::readSectors(uint8_t *data, std::streampos offset,
+                          unsigned count) const
 {
     if (!initialized)
         panic("RawDiskImage not initialized");
 
-    if (!stream.is_open())
+    if (fd < 0)
         panic("file not open!\n");
 
-    stream.seekg(offset * SectorSize, std::ios::beg);
-    if (!stream.good())
+    const uint64_t pos = (uint64_t)offset * SectorSize;
+    if (pos > disk_size)
         panic("Could not seek to location in file");
 
-    std::streampos pos = stream.tellg();
-    stream.read((char *)data, SectorSize);
+    const uint64_t len = std::min<uint64_t>(count * SectorSize,
+                                            disk_size - pos);
+    ssize_t done = len;
+    if (mapping)
+        std::memcpy(data, mapping + pos, len);
+    else
+        done = pread(fd, data, len, pos);
 
-    DPRINTF(DiskImageRead, "read: offset=%d\n", (uint64_t)offset);
-    DDUMP(DiskImageRead, data, SectorSize);
+    DPRINTF(DiskImageRead, "read: offset=%d count=%d\n", (uint64_t)offset,
+            count);
+    DDUMP(DiskImageRead, data, len);
 
-    return stream.tellg() - pos;
+    return std::max<ssize_t>(done, 0);
 }
 
 std::streampos
-RawDiskImage::write(const uint8_t *data, std::streampos offset)
+RawDiskImage::writeSectors(const uint8_t *data, std::streampos offset,
+                           unsigned count)
 {
     if (!initialized)
         panic("RawDiskImage not initialized");
@@ -146,19 +218,30 @@ RawDiskImage::write(const uint8_t *data, std::streampos offset)
     if (readonly)
         panic("Cannot write to a read only disk image");
 
-    if (!stream.is_open())
+    if (fd < 0)
         panic("file not open!\n");
 
-    stream.seekp(offset * SectorSize, std::ios::beg);
-    if (!stream.good())
+    const uint64_t pos = (uint64_t)offset * SectorSize;
+    if (pos > disk_size)
         panic("Could not seek to location in file");
 
-    DPRINTF(DiskImageWrite, "write: offset=%d\n", (uint64_t)offset);
-    DDUMP(DiskImageWrite, data, SectorSize);
+    DPRINTF(DiskImageWrite, "write: offset=%d count=%d\n", (uint64_t)offset,
+            count);
+    DDUMP(DiskImageWrite, data, count * SectorSize);
+
+    // The mapping can't grow, so only the unmapped fallback extends the
+    // image when writing past its end.
+    if (!mapping) {
+        ssize_t done = pwrite(fd, data, count * SectorSize, pos);
+        if (done > 0)
+            disk_size = std::max<uint64_t>(disk_size, pos + done);
+        return std::max<ssize_t>(done, 0);
+    }
 
-    std::streampos pos = stream.tellp();
-    stream.write((const char *)data, SectorSize);
-    return stream.tellp() - pos;
+    const uint64_t len = std::min<uint64_t>(count * SectorSize,
+                                            disk_size - pos);
+    std::memcpy(mapping + pos, data, len);
+    return len;
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -187,8 +270,8 @@ CowDiskImage::CowDiskImage(const Params &p)
 
 CowDiskImage::~CowDiskImage()
 {
-    SectorTable::iterator i = table->begin();
-    SectorTable::iterator end = table->end();
+    PageTable::iterator i = table->begin();
+    PageTable::iterator end = table->end();
 
     while (i != end) {
         delete (*i).second;
@@ -261,18 +344,17 @@ CowDiskImage::open(const std::string &file)
 
     uint64_t sector_count;
     SafeReadSwap(stream, sector_count);
-    table = new SectorTable(sector_count);
-
+    table = new PageTable(sector_count / SectorsPerPage);
 
+    uint8_t data[SectorSize];
     for (uint64_t i = 0; i < sector_count; i++) {
         uint64_t offset;
         SafeReadSwap(stream, offset);
+        SafeRead(stream, data, SectorSize);
 
-        Sector *sector = new Sector;
-        SafeRead(stream, sector, sizeof(Sector));
-
-        assert(table->find(offset) == table->end());
-        (*table)[offset] = sector;
+        assert(!findPage(offset) ||
+               !findPage(offset)->isValid(offset % SectorsPerPage));
+        writeSector(data, offset);
     }
 
     stream.close();
@@ -284,7 +366,7 @@ CowDiskImage::open(const std::string &file)
 void
 CowDiskImage::initSectorTable(int hash_size)
 {
-    table = new SectorTable(hash_size);
+    table = new PageTable(hash_size / SectorsPerPage);
 
     initialized = true;
 }
@@ -343,19 +425,21 @@ CowDiskImage::save(const std::string &file) const
 
     SafeWriteSwap(stream, (uint32_t)VersionMajor);
     SafeWriteSwap(stream, (uint32_t)VersionMinor);
-    SafeWriteSwap(stream, (uint64_t)table->size());
-
-    uint64_t size = table->size();
-    SectorTable::iterator iter = table->begin();
-    SectorTable::iterator end = table->end();
-
-    for (uint64_t i = 0; i < size; i++) {
-        if (iter == end)
-            panic("Incorrect Table Size during save of COW disk image");
 
-        SafeWriteSwap(stream, (uint64_t)(*iter).first);
-        SafeWrite(stream, (*iter).second->data, sizeof(Sector));
-        ++iter;
+    // The file keeps one entry per sector, as it did before sectors were
+    // grouped in pages
+    uint64_t sector_count = 0;
+    for (const auto &[page_num, page] : *table)
+        sector_count += popCount(page->valid);
+    SafeWriteSwap(stream, sector_count);
+
+    for (const auto &[page_num, page] : *table) {
+        for (unsigned i = 0; i < SectorsPerPage; i++) {
+            if (!page->isValid(i))
+                continue;
+            SafeWriteSwap(stream, page_num * SectorsPerPage + i);
+            SafeWrite(stream, page->data + i * SectorSize, SectorSize);
+        }
     }
 
     stream.close();
@@ -364,61 +448,119 @@ CowDiskImage::save(const std::string &file) const
 void
 CowDiskImage::writeback()
 {
-    SectorTable::iterator i = table->begin();
-    SectorTable::iterator end = table->end();
-
-    while (i != end) {
-        child->write((*i).second->data, (*i).first);
-        ++i;
+    for (const auto &[page_num, page] : *table) {
+        for (unsigned i = 0; i < SectorsPerPage; i++) {
+            if (page->isValid(i)) {
+                child->write(page->data + i * SectorSize,
+                             page_num * SectorsPerPage + i);
+            }
+        }
     }
 }
 
+const CowDiskImage::Page *
+CowDiskImage::findPage(uint64_t sector) const
+{
+    PageTable::const_iterator i = table->find(sector / SectorsPerPage);
+    return i == table->end() ? nullptr : i->second;
+}
+
+void
+CowDiskImage::writeSector(const uint8_t *data, uint64_t sector)
+{
+    Page *&page = (*table)[sector / SectorsPerPage];
+    if (!page)
+        page = new Page;
+
+    const unsigned idx = sector % SectorsPerPage;
+    memcpy(page->data + idx * SectorSize, data, SectorSize);
+    page->valid |= 1 << idx;
+}
+
 std::streampos
 CowDiskImage::size() const
 { return child->size(); }
 
 std::streampos
 CowDiskImage::read(uint8_t *data, std::streampos offset) const
+{
+    return readSectors(data, offset, 1);
+}
+
+std::streampos
+CowDiskImage::write(const uint8_t *data, std::streampos offset)
+{
+    return writeSectors(data, offset, 1);
+}
+
+std::streampos
+CowDiskImage::readSectors(uint8_t *data, std::streampos offset,
+                          unsigned count) const
 {
     if (!initialized)
         panic("CowDiskImage not initialized");
 
-    if (offset > size())
+    if ((uint64_t)offset + count - 1 > (uint64_t)size())
         panic("access out of bounds");
 
-    SectorTable::const_iterator i = table->find(offset);
-    if (i == table->end())
-        return child->read(data, offset);
-    else {
-        memcpy(data, (*i).second->data, SectorSize);
-        DPRINTF(DiskImageRead, "read: offset=%d\n", (uint64_t)offset);
-        DDUMP(DiskImageRead, data, SectorSize);
-        return SectorSize;
+    // Sectors the layer doesn't hold are read from the child, in runs as
+    // long as possible
+    std::streampos bytes = 0;
+    unsigned run = 0;
+    for (unsigned i = 0; i <= count; i++) {
+        const Page *page = nullptr;
+        const uint64_t sector = offset + std::streamoff(i);
+        const unsigned idx = sector % SectorsPerPage;
+        if (i < count) {
+            page = findPage(sector);
+            if (!page || !page->isValid(idx)) {
+                run++;
+                continue;
+            }
+        }
+
+        if (run) {
+            const unsigned first = i - run;
+            std::streampos done = child->readSectors(
+                    data + first * SectorSize, offset + std::streamoff(first),
+                    run);
+            bytes += done;
+            if (done != run * SectorSize)
+                return bytes;
+            run = 0;
+        }
+
+        if (page) {
+            memcpy(data + i * SectorSize, page->data + idx * SectorSize,
+                   SectorSize);
+            bytes += SectorSize;
+        }
     }
+
+    DPRINTF(DiskImageRead, "read: offset=%d count=%d\n", (uint64_t)offset,
+            count);
+    DDUMP(DiskImageRead, data, count * SectorSize);
+    return bytes;
 }
 
 std::streampos
-CowDiskImage::write(const uint8_t *data, std::streampos offset)
+CowDiskImage::writeSectors(const uint8_t *data, std::streampos offset,
+                           unsigned count)
 {
     if (!initialized)
         panic("RawDiskImage not initialized");
 
-    if (offset > size())
+    if ((uint64_t)offset + count - 1 > (uint64_t)size())
         panic("access out of bounds");
 
-    SectorTable::iterator i = table->find(offset);
-    if (i == table->end()) {
-        Sector *sector = new Sector;
-        memcpy(sector, data, SectorSize);
-        table->insert(make_pair(offset, sector));
-    } else {
-        memcpy((*i).second->data, data, SectorSize);
-    }
+    for (unsigned i = 0; i < count; i++)
+        writeSector(data + i * SectorSize, offset + std::streamoff(i));
 
-    DPRINTF(DiskImageWrite, "write: offset=%d\n", (uint64_t)offset);
-    DDUMP(DiskImageWrite, data, SectorSize);
+    DPRINTF(DiskImageWrite, "write: offset=%d count=%d\n", (uint64_t)offset,
+            count);
+    DDUMP(DiskImageWrite, data, count * SectorSize);
 
-    return SectorSize;
+    return count * SectorSize;
 }
 
 void
@@ -65,6 +65,25 @@ class DiskImage : public SimObject
                                 std::streampos offset) const = 0;
     virtual std::streampos write(const uint8_t *data,
                                  std::streampos offset) = 0;
+
+    /**
+     * Read count consecutive sectors starting at sector offset. Images
+     * that can move several sectors at once override this, the default
+     * goes one sector at a time.
+     *
+     * @return The number of bytes read.
+     */
+    virtual std::streampos readSectors(uint8_t *data, std::streampos offset,
+                                       unsigned count) const;
+
+    /**
+     * Write count consecutive sectors starting at sector offset.
+     *
+     * @return The number of bytes written.
+     */
+    virtual std::streampos writeSectors(const uint8_t *data,
+                                        std::streampos offset,
+                                        unsigned count);
 };
 
 /**
@@ -73,10 +92,16 @@ class DiskImage : public SimObject
 class RawDiskImage : public DiskImage
 {
   protected:
-    mutable std::fstream stream;
+    int fd;
+    /**
+     * The image mapped in the address space of the simulator, or null if
+     * it couldn't be mapped and accesses go through the file descriptor.
+     */
+    uint8_t *mapping;
     std::string file;
     bool readonly;
-    mutable std::streampos disk_size;
+    /** Size of the image in bytes. */
+    uint64_t disk_size;
 
   public:
     typedef RawDiskImageParams Params;
@@ -92,6 +117,11 @@ class RawDiskImage : public DiskImage
 
     std::streampos read(uint8_t *data, std::streampos offset) const override;
     std::streampos write(const uint8_t *data, std::streampos offset) override;
+
+    std::streampos readSectors(uint8_t *data, std::streampos offset,
+                               unsigned count) const override;
+    std::streampos writeSectors(const uint8_t *data, std::streampos offset,
+                                unsigned count) override;
 };
 
 /**
@@ -111,16 +141,37 @@ class CowDiskImage : public DiskImage
     static const uint32_t VersionMinor;
 
   protected:
-    struct Sector
+    /** Number of sectors the layer allocates at once. */
+    static constexpr unsigned SectorsPerPage = 8;
+
+    /**
+     * A page of consecutive sectors, of which only the ones that were
+     * written to the layer are valid; the others are still read from the
+     * child.
+     */
+    struct Page
     {
-        uint8_t data[SectorSize];
+        uint8_t valid = 0;
+        uint8_t data[SectorsPerPage * SectorSize];
+
+        bool
+        isValid(unsigned idx) const
+        {
+            return valid & (1 << idx);
+        }
     };
-    typedef std::unordered_map<uint64_t, Sector *> SectorTable;
+    static_assert(SectorsPerPage <= 8 * sizeof(Page::valid));
+    typedef std::unordered_map<uint64_t, Page *> PageTable;
 
   protected:
     std::string filename;
     DiskImage *child;
-    SectorTable *table;
+    PageTable *table;
+
+    /** The page holding a sector, if any of its sectors were written. */
+    const Page *findPage(uint64_t sector) const;
+    /** Write a sector to the layer, allocating its page if needed. */
+    void writeSector(const uint8_t *data, uint64_t sector);
 
   public:
     typedef CowDiskImageParams Params;
@@ -142,6 +193,11 @@ class CowDiskImage : public DiskImage
 
     std::streampos read(uint8_t *data, std::streampos offset) const override;
     std::streampos write(const uint8_t *data, std::streampos offset) override;
+
+    std::streampos readSectors(uint8_t *data, std::streampos offset,
+                               unsigned count) const override;
+    std::streampos writeSectors(const uint8_t *data, std::streampos offset,
+                                unsigned count) override;
 };
 
 void SafeRead(std::ifstream &stream, void *data, int count);
@@ -82,12 +82,10 @@ VirtIOBlock::read(const BlkRequest &req, VirtDescriptor *desc_chain,
     if (size % SectorSize != 0)
         panic("Unexpected request/sector size relationship\n");
 
-    for (Addr offset = 0; offset < size; offset += SectorSize) {
-        if (image.read(&data[offset], sector) != SectorSize) {
-            warn("Failed to read sector %i\n", sector);
-            return S_IOERR;
-        }
-        ++sector;
+    const unsigned count = size / SectorSize;
+    if (image.readSectors(&data[0], sector, count) != size) {
+        warn("Failed to read sectors %i-%i\n", sector, sector + count - 1);
+        return S_IOERR;
     }
 
     desc_chain->chainWrite(off_data, &data[0], size);
@@ -111,12 +109,10 @@ VirtIOBlock::write(const BlkRequest &req, VirtDescriptor *desc_chain,
 
     desc_chain->chainRead(off_data, &data[0], size);
 
-    for (Addr offset = 0; offset < size; offset += SectorSize) {
-        if (image.write(&data[offset], sector) != SectorSize) {
-            warn("Failed to write sector %i\n", sector);
-            return S_IOERR;
-        }
-        ++sector;
+    const unsigned count = size / SectorSize;
+    if (image.writeSectors(&data[0], sector, count) != size) {
+        warn("Failed to write sectors %i-%i\n", sector, sector + count - 1);
+        return S_IOERR;
     }
 
     return S_OK;
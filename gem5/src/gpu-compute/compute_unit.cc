@@ -136,6 +136,9 @@ ComputeUnit::ComputeUnit(const Params &p) : ClockedObject(p),
 
     // Initialization: all WF slots are assumed STOPPED
     idleWfs = p.n_wf * numVectorALUs;
+    fatal_if(p.n_wf > 64, "More than 64 WF slots per SIMD are not "
+             "supported");
+    activeWfMask.resize(numVectorALUs, 0);
     lastVaddrWF.resize(numVectorALUs);
     wfList.resize(numVectorALUs);
 
@@ -1234,7 +1237,7 @@ ComputeUnit::injectGlobalMemFence(GPUDynInstPtr gpuDynInst,
            gpuDynInst->executedAs() == enums::SC_GLOBAL);
 
     if (!req) {
-        req = std::make_shared<Request>(
+        req = makeRequest(
             0, 0, 0, requestorId(), 0, gpuDynInst->wfDynId);
     }
 
@@ -1494,7 +1497,7 @@ ComputeUnit::DTLBPort::recvTimingResp(PacketPtr pkt)
             if (!stride)
                 break;
 
-            RequestPtr prefetch_req = std::make_shared<Request>(
+            RequestPtr prefetch_req = makeRequest(
                 vaddr + stride * pf * X86ISA::PageBytes,
                 sizeof(uint8_t), 0,
                 computeUnit->requestorId(),
@@ -1996,7 +1999,7 @@ ComputeUnit::sendToLds(GPUDynInstPtr gpuDynInst)
 {
     // this is just a request to carry the GPUDynInstPtr
     // back and forth
-    RequestPtr newRequest = std::make_shared<Request>();
+    RequestPtr newRequest = makeRequest();
     newRequest->setPaddr(0x0);
 
     // ReadReq is not evaluted by the LDS but the Packet ctor requires this
@@ -289,6 +289,22 @@ class ComputeUnit : public ClockedObject
 
     typedef ComputeUnitParams Params;
     std::vector<std::vector<Wavefront*>> wfList;
+
+    /**
+     * Per SIMD mask of the WF slots holding a wave that is not stopped.
+     * The pipeline stages only scan these slots, as a stopped slot can
+     * neither fetch nor issue until a new wave is dispatched to it.
+     */
+    std::vector<uint64_t> activeWfMask;
+
+    void
+    setWfActive(int simd_id, int wf_slot, bool active)
+    {
+        if (active)
+            activeWfMask[simd_id] |= 1ULL << wf_slot;
+        else
+            activeWfMask[simd_id] &= ~(1ULL << wf_slot);
+    }
     int cu_id;
 
     // array of vector register files, one per SIMD
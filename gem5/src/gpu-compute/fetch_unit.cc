@@ -99,8 +99,11 @@ FetchUnit::exec()
         }
     }
 
-    // re-evaluate waves which are marked as not ready for fetch
-    for (int j = 0; j < computeUnit.shader->n_wf; ++j) {
+    // re-evaluate waves which are marked as not ready for fetch, only a
+    // wave in an active slot can be running
+    uint64_t active = computeUnit.activeWfMask[waveList->at(0)->simdId];
+    for (; active; active &= active - 1) {
+        const int j = findLsbSet(active);
         // Following code assumes 64-bit opertaion and all insts are
         // represented by 64-bit pointers to inst objects.
         Wavefront *curWave = fetchStatusQueue[j].first;
@@ -161,7 +164,7 @@ FetchUnit::initiateFetch(Wavefront *wavefront)
             computeUnit.cu_id, wavefront->simdId, wavefront->wfSlotId, vaddr);
 
     // set up virtual request
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = makeRequest(
         vaddr, computeUnit.cacheLineSize(), Request::INST_FETCH,
         computeUnit.requestorId(), 0, 0, nullptr);
 
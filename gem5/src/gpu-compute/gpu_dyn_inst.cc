@@ -31,6 +31,12 @@
 
 #include "gpu-compute/gpu_dyn_inst.hh"
 
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <new>
+#include <vector>
+
 #include "debug/GPUInst.hh"
 #include "debug/GPUMem.hh"
 #include "gpu-compute/gpu_static_inst.hh"
@@ -41,33 +47,115 @@
 namespace gem5
 {
 
+namespace
+{
+
+/** Alignment of the lane storage blocks and of each array in them */
+constexpr size_t laneAlign = 64;
+/** Free blocks kept per block size, the rest go back to the heap */
+constexpr size_t maxFreeLaneBlocks = 1024;
+
+/**
+ * Set once the pool of the thread is gone, instructions freed later on
+ * (e.g. by static destructors at exit) hand their blocks to the heap.
+ */
+thread_local bool laneStoragePoolDone = false;
+
+struct LaneStoragePool
+{
+    // blocks only differ in size between GPUs of different wavefront
+    // sizes, so there are very few lists
+    std::map<size_t, std::vector<uint8_t *>> free;
+
+    ~LaneStoragePool()
+    {
+        laneStoragePoolDone = true;
+        for (auto &blocks : free) {
+            for (auto block : blocks.second)
+                ::operator delete(block, std::align_val_t(laneAlign));
+        }
+    }
+};
+
+thread_local LaneStoragePool laneStoragePool;
+
+size_t
+laneArraySize(size_t size)
+{
+    return (size + laneAlign - 1) & ~(laneAlign - 1);
+}
+
+} // anonymous namespace
+
+uint8_t *
+GPUDynInst::allocateLaneStorage(size_t size)
+{
+    if (!laneStoragePoolDone) {
+        auto &blocks = laneStoragePool.free[size];
+        if (!blocks.empty()) {
+            uint8_t *block = blocks.back();
+            blocks.pop_back();
+            return block;
+        }
+    }
+    return static_cast<uint8_t *>(
+        ::operator new(size, std::align_val_t(laneAlign)));
+}
+
+void
+GPUDynInst::releaseLaneStorage(uint8_t *storage, size_t size)
+{
+    if (!laneStoragePoolDone) {
+        auto &blocks = laneStoragePool.free[size];
+        if (blocks.size() < maxFreeLaneBlocks) {
+            blocks.push_back(storage);
+            return;
+        }
+    }
+    ::operator delete(storage, std::align_val_t(laneAlign));
+}
+
 GPUDynInst::GPUDynInst(ComputeUnit *_cu, Wavefront *_wf,
                        GPUStaticInst *static_inst, InstSeqNum instSeqNum)
-    : GPUExecContext(_cu, _wf), scalarAddr(0), addr(computeUnit()->wfSize(),
-      (Addr)0), numScalarReqs(0), isSaveRestore(false),
-      _staticInst(static_inst), _seqNum(instSeqNum),
+    : GPUExecContext(_cu, _wf), scalarAddr(0), numScalarReqs(0),
+      isSaveRestore(false), _staticInst(static_inst), _seqNum(instSeqNum),
       maxSrcVecRegOpSize(-1), maxSrcScalarRegOpSize(-1)
 {
     _staticInst->initOperandInfo();
-    statusVector.assign(TheGpuISA::NumVecElemPerVecReg, 0);
-    tlbHitLevel.assign(computeUnit()->wfSize(), -1);
+
+    const size_t wf_size = computeUnit()->wfSize();
     // vector instructions can have up to 4 source/destination operands
-    d_data = new uint8_t[computeUnit()->wfSize() * 4 * sizeof(double)];
-    a_data = new uint8_t[computeUnit()->wfSize() * 8];
-    x_data = new uint8_t[computeUnit()->wfSize() * 8];
+    const size_t d_size = laneArraySize(wf_size * 4 * sizeof(double));
+    const size_t ax_size = laneArraySize(wf_size * 8);
+    const size_t addr_size = laneArraySize(wf_size * sizeof(Addr));
+    const size_t tlb_size = laneArraySize(wf_size * sizeof(int));
+    const size_t status_size =
+        laneArraySize(TheGpuISA::NumVecElemPerVecReg * sizeof(int));
     // scalar loads can read up to 16 Dwords of data (see publicly
     // available GCN3 ISA manual)
-    scalar_data = new uint8_t[16 * sizeof(uint32_t)];
-    for (int i = 0; i < (16 * sizeof(uint32_t)); ++i) {
-        scalar_data[i] = 0;
-    }
-    for (int i = 0; i < (computeUnit()->wfSize() * 8); ++i) {
-        a_data[i] = 0;
-        x_data[i] = 0;
-    }
-    for (int i = 0; i < (computeUnit()->wfSize() * 4 * sizeof(double)); ++i) {
-        d_data[i] = 0;
-    }
+    const size_t scalar_size = laneArraySize(16 * sizeof(uint32_t));
+
+    laneStorageSize = d_size + 2 * ax_size + addr_size + tlb_size +
+        status_size + scalar_size;
+    laneStorage = allocateLaneStorage(laneStorageSize);
+    std::memset(laneStorage, 0, laneStorageSize);
+
+    uint8_t *storage = laneStorage;
+    d_data = storage;
+    storage += d_size;
+    a_data = storage;
+    storage += ax_size;
+    x_data = storage;
+    storage += ax_size;
+    addr = reinterpret_cast<Addr *>(storage);
+    storage += addr_size;
+    tlbHitLevel = reinterpret_cast<int *>(storage);
+    storage += tlb_size;
+    statusVector = reinterpret_cast<int *>(storage);
+    storage += status_size;
+    scalar_data = storage;
+
+    std::fill(tlbHitLevel, tlbHitLevel + wf_size, -1);
     time = 0;
 
     cu_id = _cu->cu_id;
@@ -95,10 +183,7 @@ GPUDynInst::GPUDynInst(ComputeUnit *_cu, Wavefront *_wf,
 
 GPUDynInst::~GPUDynInst()
 {
-    delete[] d_data;
-    delete[] a_data;
-    delete[] x_data;
-    delete[] scalar_data;
+    releaseLaneStorage(laneStorage, laneStorageSize);
     delete _staticInst;
 }
 
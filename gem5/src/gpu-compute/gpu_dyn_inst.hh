@@ -168,7 +168,7 @@ class GPUDynInst : public GPUExecContext
     // virtual address for scalar memory operations
     Addr scalarAddr;
     // virtual addressies for vector memory operations
-    std::vector<Addr> addr;
+    Addr *addr;
     Addr pAddr;
 
     // vector data to get written
@@ -363,7 +363,6 @@ class GPUDynInst : public GPUExecContext
     void
     resetEntireStatusVector()
     {
-        assert(statusVector.size() == TheGpuISA::NumVecElemPerVecReg);
         for (int lane = 0; lane < TheGpuISA::NumVecElemPerVecReg; ++lane) {
             resetStatusVector(lane);
         }
@@ -455,9 +454,9 @@ class GPUDynInst : public GPUExecContext
 
     // Track the status of memory requests per lane, an int per lane to allow
     // unaligned accesses
-    std::vector<int> statusVector;
+    int *statusVector;
     // for ld_v# or st_v#
-    std::vector<int> tlbHitLevel;
+    int *tlbHitLevel;
 
     // for misaligned scalar ops we track the number
     // of outstanding reqs here
@@ -477,6 +476,19 @@ class GPUDynInst : public GPUExecContext
     // inst used to save/restore a wavefront context
     bool isSaveRestore;
   private:
+    /**
+     * The per lane arrays of the instruction (addr, statusVector,
+     * tlbHitLevel and the data buffers) are carved out of a single cache
+     * line aligned block sized to the wavefront, and the blocks are
+     * recycled through a per thread pool rather than allocated for every
+     * dynamic instruction.
+     */
+    uint8_t *laneStorage;
+    size_t laneStorageSize;
+
+    static uint8_t *allocateLaneStorage(size_t size);
+    static void releaseLaneStorage(uint8_t *storage, size_t size);
+
     GPUStaticInst *_staticInst;
     const InstSeqNum _seqNum;
     int maxSrcVecRegOpSize;
@@ -31,6 +31,7 @@
 
 #include "gpu-compute/scoreboard_check_stage.hh"
 
+#include "base/bitfield.hh"
 #include "debug/GPUExec.hh"
 #include "debug/GPUSched.hh"
 #include "debug/GPUSync.hh"
@@ -253,9 +254,14 @@ ScoreboardCheckStage::exec()
      */
     toSchedule.reset();
 
-    // Iterate over all WF slots across all SIMDs.
+    // Iterate over the active WF slots across all SIMDs. The stopped
+    // slots cannot be ready, so their stall reason is counted in bulk.
     for (int simdId = 0; simdId < computeUnit.numVectorALUs; ++simdId) {
-        for (int wfSlot = 0; wfSlot < computeUnit.shader->n_wf; ++wfSlot) {
+        uint64_t active = computeUnit.activeWfMask[simdId];
+        stats.stallCycles[NRDY_WF_STOP] +=
+            computeUnit.shader->n_wf - popCount(active);
+        for (; active; active &= active - 1) {
+            const int wfSlot = findLsbSet(active);
             // reset the ready status of each wavefront
             Wavefront *curWave = computeUnit.wfList[simdId][wfSlot];
             nonrdytype_e rdyStatus = NRDY_ILLEGAL;
@@ -548,6 +548,8 @@ Wavefront::setStatus(status_e newStatus)
             assert(computeUnit->idleWfs >= 0);
         }
     }
+    if ((status == S_STOPPED) != (newStatus == S_STOPPED))
+        computeUnit->setWfActive(simdId, wfSlotId, newStatus != S_STOPPED);
     status = newStatus;
 }
 
@@ -558,6 +560,7 @@ Wavefront::start(uint64_t _wf_dyn_id, Addr init_pc)
     _pc = init_pc;
 
     status = S_RUNNING;
+    computeUnit->setWfActive(simdId, wfSlotId, true);
 
     vecReads.resize(maxVgprs, 0);
 }
@@ -36,6 +36,7 @@
 # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+from m5.SimObject import *
 from m5.params import *
 from m5.objects.ClockedObject import ClockedObject
 
@@ -45,6 +46,10 @@ class AbstractMemory(ClockedObject):
     cxx_header = "mem/abstract_mem.hh"
     cxx_class = 'gem5::memory::AbstractMemory'
 
+    cxx_exports = [
+        PyBindMethod("digest"),
+    ]
+
     # A default memory size of 128 MiB (starting at 0) is used to
     # simplify the regressions
     range = Param.AddrRange('128MiB',
@@ -0,0 +1,87 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+from m5.params import *
+from m5.objects.AbstractMemory import *
+from m5.objects.DRAMInterface import PageManage
+from m5.objects.MemInterface import AddrMap
+
+# AnalyticalDRAM is a middle ground between SimpleMemory and a MemCtrl
+# with a DRAMInterface. It resolves the timing of every burst in closed
+# form at arrival, tracking the open row and the earliest activate,
+# column and precharge time of each bank, the activate spacing of each
+# rank and the data bus, without scheduling any per-command events. It
+# captures row buffer locality, bank parallelism, bus bandwidth and
+# turnarounds, write buffering and refresh, but serves reads in arrival
+# order rather than reordering them like FR-FCFS. The defaults match
+# DDR3_1600_8x8 behind a default MemCtrl.
+class AnalyticalDRAM(AbstractMemory):
+    type = 'AnalyticalDRAM'
+    cxx_header = "mem/analytical_dram.hh"
+    cxx_class = 'gem5::memory::AnalyticalDRAM'
+
+    port = ResponsePort("This port responds to memory requests")
+
+    # organisation, as for DRAMInterface
+    addr_mapping = Param.AddrMap('RoRaBaCoCh', "Address mapping policy")
+    page_policy = Param.PageManage('open_adaptive', "Page management "
+                                   "policy, the adaptive variants are "
+                                   "treated as their base policy")
+    device_bus_width = Param.Unsigned(8, "Data bus width in bits for each "
+                                      "DRAM device/chip")
+    burst_length = Param.Unsigned(8, "Burst lenght (BL) in beats")
+    device_rowbuffer_size = Param.MemorySize('1KiB', "Page (row buffer) "
+                                             "size per device/chip")
+    devices_per_rank = Param.Unsigned(8, "Number of devices/chips per rank")
+    ranks_per_channel = Param.Unsigned(2, "Number of ranks per channel")
+    banks_per_rank = Param.Unsigned(8, "Number of banks per rank")
+
+    # queueing, matching the MemCtrl write thresholds
+    read_buffer_size = Param.Unsigned(32, "Number of read queue entries")
+    write_buffer_size = Param.Unsigned(64, "Number of write queue entries")
+    write_high_thresh_perc = Param.Percent(85, "Threshold to force writes")
+    write_low_thresh_perc = Param.Percent(50, "Threshold to start writes "
+                                          "if the data bus is idle")
+
+    static_frontend_latency = Param.Latency("10ns", "Static frontend latency")
+    static_backend_latency = Param.Latency("10ns", "Static backend latency")
+
+    # timings, from DDR3_1600_8x8
+    tBURST = Param.Latency('5ns', "Burst duration")
+    tRCD = Param.Latency('13.75ns', "RAS to CAS delay")
+    tCL = Param.Latency('13.75ns', "CAS latency")
+    tRP = Param.Latency('13.75ns', "Row precharge time")
+    tRAS = Param.Latency('35ns', "ACT to PRE delay")
+    tRRD = Param.Latency('6ns', "ACT to ACT delay")
+    tWR = Param.Latency('15ns', "Write recovery time")
+    tRTP = Param.Latency('7.5ns', "Read to precharge")
+    tWTR = Param.Latency('7.5ns', "Write to read, same rank switching time")
+    tRTW = Param.Latency('2.5ns', "Read to write, same rank switching time")
+    tCS = Param.Latency('2.5ns', "Rank to rank switching time")
+    tRFC = Param.Latency('260ns', "Refresh cycle time")
+    tREFI = Param.Latency('7.8us', "Refresh command interval")
+
+    def controller(self):
+        # The analytical model does not use a MemCtrl
+        return self
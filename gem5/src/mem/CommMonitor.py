@@ -78,6 +78,11 @@ class CommMonitor(SimObject):
     latency_bins = Param.Unsigned('20', "# bins in latency histograms")
     disable_latency_hists = Param.Bool(False, "Disable latency histograms")
 
+    # only measure the latency of one in this many requests, as tagging
+    # a request to measure its latency is the main per-packet cost
+    latency_sample_rate = Param.Unsigned(1, "Measure the latency of 1 " \
+                                             "in N requests")
+
     # inter transaction time (ITT) distributions in uniformly sized
     # bins up to the maximum, independently for read-to-read,
     # write-to-write and the combined request-to-request that does not
@@ -104,3 +109,15 @@ class CommMonitor(SimObject):
     read_addr_mask = Param.Addr(MaxAddr, "Address mask for read address")
     write_addr_mask = Param.Addr(MaxAddr, "Address mask for write address")
     disable_addr_dists = Param.Bool(True, "Disable address distributions")
+
+    # low overhead mode, which only keeps the bandwidth and sampled
+    # latencies in fixed size arrays: the bandwidth of the last sample
+    # periods, and percentiles of the sampled latencies instead of the
+    # latency histograms. The per-packet histograms and distributions
+    # (burst length, ITT, outstanding requests, transactions and
+    # addresses) are disabled
+    low_overhead = Param.Bool(False, "Only keep per window bandwidth " \
+                                     "and sampled latency percentiles")
+    bandwidth_windows = Param.Unsigned(16, "# sample periods to keep the " \
+                                           "bandwidth of in the low " \
+                                           "overhead mode")
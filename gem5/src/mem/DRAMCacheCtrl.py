@@ -0,0 +1,63 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+
+from m5.params import *
+from m5.proxy import *
+from m5.objects.ClockedObject import ClockedObject
+
+# DRAMCacheCtrl is the controller of a direct-mapped die-stacked DRAM
+# cache, in front of the off-chip memory, that stores each block with
+# its tag (TAD) in the stacked DRAM. The latter is a memory controller,
+# typically a MemCtrl with a DRAMInterface such as HBM, that has no
+# backing store (null = True), is not in the address map
+# (in_addr_map = False), and covers the range [0, cache_side_size()).
+class DRAMCacheCtrl(ClockedObject):
+    type = 'DRAMCacheCtrl'
+    cxx_header = "mem/dram_cache_ctrl.hh"
+    cxx_class = 'gem5::memory::DRAMCacheCtrl'
+
+    port = ResponsePort("This port responds to memory requests")
+    cache_side = RequestPort("Port to the stacked DRAM holding the TADs")
+    mem_side = RequestPort("Port to the off-chip memory")
+
+    system = Param.System(Parent.any, "System the cache belongs to")
+
+    size = Param.MemorySize("Capacity of the cache, not counting the tags")
+    # a line as in the Alloy cache, or a page as in the Unison cache
+    block_size = Param.MemorySize("64B", "Granularity of the allocation "
+                                  "and the fetches from the off-chip memory")
+    tag_size = Param.MemorySize("8B", "Tag and metadata stored with each "
+                                "block")
+    latency = Param.Cycles(1, "Controller latency, on the way to the "
+                           "memories and on the way back")
+
+    # MAP-I predictor of the misses, indexed by PC
+    miss_predictor = Param.Bool(True, "Read the predicted misses from the "
+                                "off-chip memory in parallel with the lookup")
+    predictor_entries = Param.Unsigned(256, "Counters of the miss predictor")
+
+    max_transactions = Param.Unsigned(64, "Requests handled at once")
+
+    def cache_side_size(self):
+        """Size of the stacked DRAM needed to hold the TADs"""
+        return (self.size.value // self.block_size.value) * \
+            (self.block_size.value + self.tag_size.value)
@@ -67,6 +67,12 @@ class DRAMInterface(MemInterface):
     # performance being lower when enabled
     enable_dram_powerdown = Param.Bool(False, "Enable powerdown states")
 
+    # Commands a rank buffers before DRAMPower evaluates the ones that
+    # are complete, which bounds the memory and the sorting cost of the
+    # power accounting between two refreshes
+    power_cmd_batch = Param.Unsigned(256, "Commands buffered before "
+                                     "they are passed to DRAMPower")
+
     # For power modelling we need to know if the DRAM has a DLL or not
     dll = Param.Bool(True, "DRAM has DLL or not")
 
@@ -126,6 +132,13 @@ class DRAMInterface(MemInterface):
     # to be sent. It is 7.8 us for a 64ms refresh requirement
     tREFI = Param.Latency("Refresh command interval")
 
+    # refresh one bank at a time (REFpb), every tREFI / banks_per_rank,
+    # so that the other banks of the rank keep serving accesses
+    refresh_per_bank = Param.Bool(False, "Refresh banks one at a time")
+
+    # time taken to refresh a single bank with a per-bank refresh
+    tRFCpb = Param.Latency("0ns", "Per-bank refresh cycle time")
+
     # write-to-read, same rank turnaround penalty for same bank group
     tWTR_L = Param.Latency(Self.tWTR, "Write to read, same rank switching "
                            "time, same bank group")
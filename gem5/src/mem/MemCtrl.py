@@ -38,13 +38,16 @@
 # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+from m5.SimObject import *
 from m5.params import *
 from m5.proxy import *
 from m5.objects.QoSMemCtrl import *
 
 # Enum for memory scheduling algorithms, currently First-Come
-# First-Served and a First-Row Hit then First-Come First-Served
-class MemSched(Enum): vals = ['fcfs', 'frfcfs']
+# First-Served, a First-Row Hit then First-Come First-Served, and the
+# application-aware multi-core schedulers PAR-BS (batching), BLISS
+# (blacklisting) and ATLAS (least attained service ranking)
+class MemSched(Enum): vals = ['fcfs', 'frfcfs', 'parbs', 'bliss', 'atlas']
 
 # MemCtrl is a single-channel single-ported Memory controller model
 # that aims to model the most important system-level performance
@@ -55,6 +58,10 @@ class MemCtrl(QoSMemCtrl):
     cxx_header = "mem/mem_ctrl.hh"
     cxx_class = 'gem5::memory::MemCtrl'
 
+    cxx_exports = [
+        PyBindMethod("setMemSchedPolicy"),
+    ]
+
     # single-ported on the system interface side, instantiate with a
     # bus in front of the controller for multiple ports
     port = ResponsePort("This port responds to memory requests")
@@ -83,6 +90,46 @@ class MemCtrl(QoSMemCtrl):
     # scheduler, address map and page policy
     mem_sched_policy = Param.MemSched('frfcfs', "Memory scheduling policy")
 
+    # front-end coalescing, reads to a burst that is already queued
+    # share its access, and merged writes track the bytes they cover
+    # so that reads can be serviced from partial writes
+    coalesce_reads = Param.Bool(False, "Coalesce reads to a queued burst")
+    write_combining = Param.Bool(False, "Track merged writes with byte "
+                                 "masks to service reads from them")
+    link_compressor = Param.BaseCacheCompressor(NULL, "Compressor of the "
+        "lines moved over the DRAM data bus, an absent one sends them whole")
+
+    # parameters of the application-aware schedulers, only used when
+    # the corresponding policy is selected
+    batch_cap = Param.Unsigned(5, "PAR-BS requests per requestor and bank "
+                               "marked in each batch")
+    blacklist_threshold = Param.Unsigned(4, "BLISS consecutive bursts "
+                                         "served for one requestor before "
+                                         "it is blacklisted")
+    blacklist_clear_interval = Param.Latency("10us", "BLISS period after "
+                                             "which the blacklist is cleared")
+    atlas_quantum = Param.Latency("10us", "ATLAS quantum after which the "
+                                  "requestor ranking is recomputed")
+    atlas_alpha = Param.Float(0.875, "ATLAS weight of the history when "
+                              "accumulating attained service")
+    atlas_starvation_threshold = Param.Latency("5us", "ATLAS queueing time "
+                                               "after which a request "
+                                               "bypasses the ranking")
+
+    # hybrid memory tiering, with both a DRAM and an NVM interface: the
+    # NVM pages that are accessed the most are migrated to a region at
+    # the top of the DRAM range, which the system should not use itself
+    tier_cache_size = Param.MemorySize("0B", "Size of the DRAM region "
+                                       "caching hot NVM pages, zero "
+                                       "disables tiering")
+    tier_page_size = Param.MemorySize("4KiB", "Granularity of migration")
+    tier_hot_threshold = Param.Unsigned(8, "Sampled accesses after which an "
+                                        "NVM page is migrated")
+    tier_sample_interval = Param.Unsigned(1, "Sample one NVM access in "
+                                          "this many")
+    tier_max_tracked = Param.Unsigned(1024, "Number of NVM pages whose "
+                                      "accesses are counted at once")
+
     # pipeline latency of the controller and PHY, split into a
     # frontend part and a backend part, with reads and writes serviced
     # by the queues only seeing the frontend contribution, and reads
@@ -95,6 +95,12 @@ class BaseXBar(ClockedObject):
     use_default_range = Param.Bool(False, "Perform address mapping for " \
                                        "the default port")
 
+    # Every traffic_interval, write the occupancy of each layer and the
+    # bytes between each pair of ports over the interval to
+    # <name>.traffic.csv in the output directory
+    traffic_interval = Param.Latency('0ns', "Interval of the traffic "
+                                     "time series, 0 to disable it")
+
 class NoncoherentXBar(BaseXBar):
     type = 'NoncoherentXBar'
     cxx_header = "mem/noncoherent_xbar.hh"
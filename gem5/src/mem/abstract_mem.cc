@@ -40,6 +40,7 @@
 
 #include "mem/abstract_mem.hh"
 
+#include <cstring>
 #include <vector>
 
 #include "base/loader/memory_image.hh"
@@ -61,6 +62,7 @@ AbstractMemory::AbstractMemory(const Params &p) :
     backdoor(params().range, nullptr,
              (MemBackdoor::Flags)(MemBackdoor::Readable |
                                   MemBackdoor::Writeable)),
+    dirtyPages(nullptr),
     confTableReported(p.conf_table_reported), inAddrMap(p.in_addr_map),
     kvmMap(p.kvm_map), _system(NULL),
     stats(*this)
@@ -102,7 +104,8 @@ AbstractMemory::initState()
 }
 
 void
-AbstractMemory::setBackingStore(uint8_t* pmem_addr)
+AbstractMemory::setBackingStore(uint8_t* pmem_addr,
+                                DirtyPageMap *dirty_pages)
 {
     // If there was an existing backdoor, let everybody know it's going away.
     if (backdoor.ptr())
@@ -111,7 +114,12 @@ AbstractMemory::setBackingStore(uint8_t* pmem_addr)
     // The back door can't handle interleaved memory.
     backdoor.ptr(range.interleaved() ? nullptr : pmem_addr);
 
+    // Writes through the back door can't be tracked, so only hand out
+    // one for reading when the written pages are
+    backdoor.writeable(!dirty_pages);
+
     pmemAddr = pmem_addr;
+    dirtyPages = dirty_pages;
 }
 
 AbstractMemory::MemStats::MemStats(AbstractMemory &_mem)
@@ -399,6 +407,7 @@ AbstractMemory::access(PacketPtr pkt)
             if (pmemAddr) {
                 pkt->setData(host_addr);
                 (*(pkt->getAtomicOp()))(host_addr);
+                markDirty(pkt->getAddr(), pkt->getSize());
             }
         } else {
             std::vector<uint8_t> overwrite_val(pkt->getSize());
@@ -427,8 +436,10 @@ AbstractMemory::access(PacketPtr pkt)
                     panic("Invalid size for conditional read/write\n");
             }
 
-            if (overwrite_mem)
+            if (overwrite_mem) {
                 std::memcpy(host_addr, &overwrite_val[0], pkt->getSize());
+                markDirty(pkt->getAddr(), pkt->getSize());
+            }
 
             assert(!pkt->req->isInstFetch());
             TRACE_PACKET("Read/Write");
@@ -460,6 +471,7 @@ AbstractMemory::access(PacketPtr pkt)
         if (writeOK(pkt)) {
             if (pmemAddr) {
                 pkt->writeData(host_addr);
+                markDirty(pkt->getAddr(), pkt->getSize());
                 DPRINTF(MemoryAccess, "%s write due to %s\n",
                         __func__, pkt->print());
             }
@@ -493,6 +505,7 @@ AbstractMemory::functionalAccess(PacketPtr pkt)
     } else if (pkt->isWrite()) {
         if (pmemAddr) {
             pkt->writeData(host_addr);
+            markDirty(pkt->getAddr(), pkt->getSize());
         }
         TRACE_PACKET("Write");
         pkt->makeResponse();
@@ -511,5 +524,27 @@ AbstractMemory::functionalAccess(PacketPtr pkt)
     }
 }
 
+uint64_t
+AbstractMemory::digest() const
+{
+    if (!pmemAddr)
+        return 0;
+
+    // Only the non-zero words are hashed, along with their offset, which
+    // keeps the digest of large, mostly untouched memories cheap
+    uint64_t digest = 0;
+    const uint64_t words = size() / sizeof(uint64_t);
+    for (uint64_t i = 0; i < words; ++i) {
+        uint64_t word;
+        std::memcpy(&word, pmemAddr + i * sizeof(uint64_t), sizeof(word));
+        if (word == 0)
+            continue;
+        digest ^= (i + 0x9e3779b97f4a7c15ULL + (digest << 6) + (digest >> 2));
+        digest ^= (word + 0x9e3779b97f4a7c15ULL + (digest << 6) +
+                   (digest >> 2));
+    }
+    return digest;
+}
+
 } // namespace memory
 } // namespace gem5
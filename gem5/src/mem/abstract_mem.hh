@@ -47,6 +47,7 @@
 #define __MEM_ABSTRACT_MEMORY_HH__
 
 #include "mem/backdoor.hh"
+#include "mem/dirty_page_map.hh"
 #include "mem/port.hh"
 #include "params/AbstractMemory.hh"
 #include "sim/clocked_object.hh"
@@ -120,6 +121,9 @@ class AbstractMemory : public ClockedObject
     // Backdoor to access this memory.
     MemBackdoor backdoor;
 
+    // Pages written to since the last checkpoint, if they are tracked
+    DirtyPageMap *dirtyPages;
+
     // Enable specific memories to be reported to the configuration table
     const bool confTableReported;
 
@@ -231,8 +235,11 @@ class AbstractMemory : public ClockedObject
      * controller.
      *
      * @param pmem_addr Pointer to a segment of host memory
+     * @param dirty_pages Map of the pages of the segment written to, or
+     *                    nullptr if they are not tracked
      */
-    void setBackingStore(uint8_t* pmem_addr);
+    void setBackingStore(uint8_t* pmem_addr,
+                         DirtyPageMap *dirty_pages=nullptr);
 
     void
     getBackdoor(MemBackdoorPtr &bd_ptr)
@@ -293,6 +300,17 @@ class AbstractMemory : public ClockedObject
         return pmemAddr + addr - range.start();
     }
 
+    /**
+     * Record a write to the backing store that did not go through
+     * access() or functionalAccess(), for incremental checkpoints.
+     */
+    void
+    markDirty(Addr addr, Addr size) const
+    {
+        if (dirtyPages && pmemAddr)
+            dirtyPages->mark(toHostAddr(addr), size);
+    }
+
     /**
      * Get the memory size.
      *
@@ -307,6 +325,15 @@ class AbstractMemory : public ClockedObject
      */
     Addr start() const { return range.start(); }
 
+    /**
+     * Hash the contents of the memory, to compare the memory state of
+     * runs with different CPU models. Caches must have been written back
+     * for the digest to reflect the state seen by the CPUs.
+     *
+     * @return digest of the memory contents, 0 for a null memory
+     */
+    uint64_t digest() const;
+
     /**
      *  Should this memory be passed to the kernel and part of the OS
      *  physical memory layout.
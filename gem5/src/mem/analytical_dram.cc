@@ -0,0 +1,558 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/analytical_dram.hh"
+
+#include <algorithm>
+
+#include "base/intmath.hh"
+#include "base/trace.hh"
+#include "debug/DRAM.hh"
+#include "debug/Drain.hh"
+#include "sim/core.hh"
+#include "sim/stats.hh"
+
+namespace gem5
+{
+
+namespace memory
+{
+
+AnalyticalDRAM::AnalyticalDRAM(const AnalyticalDRAMParams &p) :
+    AbstractMemory(p),
+    port(name() + ".port", *this),
+    addrMapping(p.addr_mapping), pagePolicy(p.page_policy),
+    burstSize((p.devices_per_rank * p.burst_length *
+               p.device_bus_width) / 8),
+    rowBufferSize(p.devices_per_rank * p.device_rowbuffer_size),
+    burstsPerRowBuffer(rowBufferSize / burstSize),
+    burstsPerStripe(range.interleaved() ?
+                    range.granularity() / burstSize : 1),
+    ranksPerChannel(p.ranks_per_channel), banksPerRank(p.banks_per_rank),
+    readBufferSize(p.read_buffer_size),
+    writeBufferSize(p.write_buffer_size),
+    writeHighThreshold(writeBufferSize * p.write_high_thresh_perc / 100.0),
+    writeLowThreshold(writeBufferSize * p.write_low_thresh_perc / 100.0),
+    frontendLatency(p.static_frontend_latency),
+    backendLatency(p.static_backend_latency),
+    tBURST(p.tBURST), tRCD(p.tRCD), tCL(p.tCL), tRP(p.tRP), tRAS(p.tRAS),
+    tRRD(p.tRRD), tWR(p.tWR), tRTP(p.tRTP), tWTR(p.tWTR), tRTW(p.tRTW),
+    tCS(p.tCS), tRFC(p.tRFC), tREFI(p.tREFI),
+    banks(ranksPerChannel * banksPerRank),
+    rankActAllowedAt(ranksPerChannel, 0),
+    busFreeAt(0), lastWasRead(true), lastRank(0),
+    pendingReads(0), retryReq(false), retryResp(false),
+    dequeueEvent([this]{ dequeue(); }, name()),
+    retryEvent([this]{ retry(); }, name()),
+    stats(*this)
+{
+    fatal_if(!isPowerOf2(burstSize), "Burst size %d is not a power of 2\n",
+             burstSize);
+    fatal_if(burstsPerRowBuffer == 0, "Row buffer size %d is smaller than "
+             "a burst of %d bytes\n", rowBufferSize, burstSize);
+    fatal_if(tREFI <= tRFC, "tREFI (%d) must be larger than tRFC (%d)\n",
+             tREFI, tRFC);
+    fatal_if(p.write_low_thresh_perc >= p.write_high_thresh_perc,
+             "Write buffer low threshold %d must be smaller than the "
+             "high threshold %d\n", p.write_low_thresh_perc,
+             p.write_high_thresh_perc);
+    writeBuffer.reserve(writeBufferSize);
+}
+
+void
+AnalyticalDRAM::init()
+{
+    AbstractMemory::init();
+
+    if (port.isConnected()) {
+        port.sendRangeChange();
+    }
+}
+
+Tick
+AnalyticalDRAM::afterRefresh(Tick at) const
+{
+    // all ranks refresh for tRFC at the start of every tREFI, except
+    // for the very first interval
+    if (at >= tREFI) {
+        const Tick offset = at % tREFI;
+        if (offset < tRFC)
+            at += tRFC - offset;
+    }
+    return at;
+}
+
+Tick
+AnalyticalDRAM::accessBurst(Addr addr, bool is_read, Tick at)
+{
+    // decode the address as MemInterface::decodePacket does, with
+    // Ro, Ra, Co, Ba and Ch denoting row, rank, column, bank and
+    // channel, respectively
+    Addr a = range.getOffset(addr) / burstSize;
+    uint8_t rank;
+    uint8_t bank;
+    if (addrMapping == enums::RoRaBaChCo ||
+        addrMapping == enums::RoRaBaCoCh) {
+        a = a / burstsPerRowBuffer;
+        bank = a % banksPerRank;
+        a = a / banksPerRank;
+        rank = a % ranksPerChannel;
+        a = a / ranksPerChannel;
+    } else if (addrMapping == enums::RoCoRaBaCh) {
+        a = a / std::min(burstsPerStripe, burstsPerRowBuffer);
+        bank = a % banksPerRank;
+        a = a / banksPerRank;
+        rank = a % ranksPerChannel;
+        a = a / ranksPerChannel;
+        if (burstsPerStripe < burstsPerRowBuffer)
+            a = a / (burstsPerRowBuffer / burstsPerStripe);
+    } else {
+        panic("Unknown address mapping policy chosen!");
+    }
+    const uint32_t row = a;
+
+    Bank &bank_ref = banks[rank * banksPerRank + bank];
+
+    Tick cmd_at = afterRefresh(at);
+
+    // a refresh since the last access precharged the bank
+    const uint64_t epoch = cmd_at / tREFI;
+    if (epoch != bank_ref.refreshEpoch) {
+        bank_ref.openRow = Bank::NO_ROW;
+        bank_ref.actAllowedAt = std::max(bank_ref.actAllowedAt,
+                                         epoch * tREFI + tRFC);
+        bank_ref.refreshEpoch = epoch;
+    }
+
+    const bool row_hit = bank_ref.openRow == row;
+    Tick col_at;
+    if (row_hit) {
+        col_at = std::max(cmd_at, bank_ref.colAllowedAt);
+    } else {
+        Tick act_at = std::max(cmd_at, bank_ref.actAllowedAt);
+        if (bank_ref.openRow != Bank::NO_ROW) {
+            // precharge the open row first
+            act_at = std::max(act_at,
+                              std::max(cmd_at, bank_ref.preAllowedAt) + tRP);
+        }
+        act_at = std::max(act_at, rankActAllowedAt[rank]);
+        rankActAllowedAt[rank] = act_at + tRRD;
+
+        bank_ref.openRow = row;
+        bank_ref.preAllowedAt = act_at + tRAS;
+        col_at = act_at + tRCD;
+    }
+
+    // the data bus, including read/write and rank switching
+    Tick bus_at = busFreeAt;
+    if (is_read != lastWasRead)
+        bus_at += lastWasRead ? tRTW : tWTR + tCL;
+    else if (rank != lastRank)
+        bus_at += tCS;
+
+    const Tick data_at = std::max(col_at + tCL, bus_at);
+    col_at = data_at - tCL;
+    const Tick done = data_at + tBURST;
+
+    busFreeAt = done;
+    lastWasRead = is_read;
+    lastRank = rank;
+
+    bank_ref.colAllowedAt = col_at + tBURST;
+    bank_ref.preAllowedAt = std::max(bank_ref.preAllowedAt,
+                                     is_read ? col_at + tRTP : done + tWR);
+
+    if (pagePolicy == enums::close || pagePolicy == enums::close_adaptive) {
+        bank_ref.actAllowedAt = bank_ref.preAllowedAt + tRP;
+        bank_ref.openRow = Bank::NO_ROW;
+    }
+
+    DPRINTF(DRAM, "%s %#x rank %d bank %d row %d %s, data at %lld\n",
+            is_read ? "Read" : "Write", addr, rank, bank, row,
+            row_hit ? "hit" : "miss", data_at);
+
+    if (is_read) {
+        ++stats.readBursts;
+        stats.readRowHits += row_hit;
+        stats.totMemAccLat += done - at;
+    } else {
+        ++stats.writeBursts;
+        stats.writeRowHits += row_hit;
+    }
+
+    return done;
+}
+
+void
+AnalyticalDRAM::drainWrites(Tick at)
+{
+    DPRINTF(DRAM, "Issuing %d buffered writes\n", writeBuffer.size());
+    for (const auto addr : writeBuffer)
+        accessBurst(addr, false, at);
+    writeBuffer.clear();
+}
+
+bool
+AnalyticalDRAM::canAccept(PacketPtr pkt) const
+{
+    // the channel is backed up beyond what the buffers could hold
+    if (busFreeAt > curTick() + writeBufferSize * tBURST)
+        return false;
+
+    return !pkt->isRead() || pendingReads < readBufferSize;
+}
+
+Tick
+AnalyticalDRAM::recvAtomic(PacketPtr pkt)
+{
+    panic_if(pkt->cacheResponding(), "Should not see packets where cache "
+             "is responding");
+
+    access(pkt);
+
+    // this value is not supposed to be accurate, just enough to keep
+    // things going, mimic a closed page
+    return pkt->hasData() ? tRP + tRCD + tCL : 0;
+}
+
+Tick
+AnalyticalDRAM::recvAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr &_backdoor)
+{
+    Tick latency = recvAtomic(pkt);
+    getBackdoor(_backdoor);
+    return latency;
+}
+
+void
+AnalyticalDRAM::recvFunctional(PacketPtr pkt)
+{
+    pkt->pushLabel(name());
+
+    functionalAccess(pkt);
+
+    bool done = false;
+    auto p = packetQueue.begin();
+    // potentially update the packets in our packet queue as well
+    while (!done && p != packetQueue.end()) {
+        done = pkt->trySatisfyFunctional(p->pkt);
+        ++p;
+    }
+
+    pkt->popLabel();
+}
+
+bool
+AnalyticalDRAM::recvTimingReq(PacketPtr pkt)
+{
+    panic_if(pkt->cacheResponding(), "Should not see packets where cache "
+             "is responding");
+
+    panic_if(!(pkt->isRead() || pkt->isWrite()),
+             "Should only see read and writes at memory controller, "
+             "saw %s to %#llx\n", pkt->cmdString(), pkt->getAddr());
+
+    if (retryReq)
+        return false;
+
+    if (!canAccept(pkt)) {
+        retryReq = true;
+        if (pkt->isRead())
+            ++stats.numRdRetry;
+        else
+            ++stats.numWrRetry;
+        // a full read buffer is retried when a response is sent,
+        // otherwise wait until the bus backlog is back within bounds
+        const Tick backlog_at = busFreeAt - writeBufferSize * tBURST;
+        if (backlog_at > curTick() && !retryEvent.scheduled())
+            schedule(retryEvent, backlog_at);
+        return false;
+    }
+
+    // the packet only reaches us after the header and payload delay,
+    // and then goes through the controller frontend
+    const Tick arrival = curTick() + pkt->headerDelay + pkt->payloadDelay +
+        frontendLatency;
+    pkt->headerDelay = pkt->payloadDelay = 0;
+
+    const Addr base = pkt->getAddr();
+    const Addr end = base + pkt->getSize();
+    Tick when_to_send = arrival;
+
+    if (pkt->isRead()) {
+        ++stats.readReqs;
+        stats.bytesRead += pkt->getSize();
+        Tick done = 0;
+        for (Addr addr = burstAlign(base); addr < end; addr += burstSize) {
+            if (std::find(writeBuffer.begin(), writeBuffer.end(), addr) !=
+                writeBuffer.end()) {
+                ++stats.servicedByWrQ;
+            } else {
+                done = std::max(done, accessBurst(addr, true, arrival));
+            }
+        }
+        if (done)
+            when_to_send = done + backendLatency;
+        ++pendingReads;
+    } else {
+        ++stats.writeReqs;
+        stats.bytesWritten += pkt->getSize();
+        for (Addr addr = burstAlign(base); addr < end; addr += burstSize) {
+            // merge with a write to the same burst already buffered
+            if (std::find(writeBuffer.begin(), writeBuffer.end(), addr) ==
+                writeBuffer.end())
+                writeBuffer.push_back(addr);
+        }
+
+        // as for MemCtrl, drain the writes when above the high
+        // threshold, or above the low threshold with the bus idle
+        if (writeBuffer.size() >= writeHighThreshold ||
+            (writeBuffer.size() >= writeLowThreshold &&
+             busFreeAt <= arrival))
+            drainWrites(arrival);
+    }
+
+    bool needsResponse = pkt->needsResponse();
+    access(pkt);
+    if (needsResponse) {
+        assert(pkt->isResponse());
+
+        // start the insertion sort with the last element, and do not
+        // re-order in front of an existing packet with the same address
+        auto i = packetQueue.end();
+        while (i != packetQueue.begin()) {
+            auto prev = std::prev(i);
+            if (when_to_send >= prev->tick || prev->pkt->matchAddr(pkt))
+                break;
+            i = prev;
+        }
+        packetQueue.emplace(i, pkt, when_to_send);
+
+        if (!retryResp) {
+            if (!dequeueEvent.scheduled())
+                schedule(dequeueEvent, packetQueue.front().tick);
+            else if (packetQueue.front().tick < dequeueEvent.when())
+                reschedule(dequeueEvent, packetQueue.front().tick);
+        }
+    } else {
+        pendingDelete.reset(pkt);
+    }
+
+    return true;
+}
+
+void
+AnalyticalDRAM::retry()
+{
+    if (retryReq) {
+        retryReq = false;
+        port.sendRetryReq();
+    }
+}
+
+void
+AnalyticalDRAM::dequeue()
+{
+    assert(!packetQueue.empty());
+    DeferredPacket deferred_pkt = packetQueue.front();
+    // the packet is no longer ours once sent
+    const bool is_read = deferred_pkt.pkt->isRead();
+
+    retryResp = !port.sendTimingResp(deferred_pkt.pkt);
+
+    if (!retryResp) {
+        packetQueue.pop_front();
+
+        if (is_read) {
+            assert(pendingReads);
+            --pendingReads;
+            if (!retryEvent.scheduled())
+                retry();
+        }
+
+        if (!packetQueue.empty()) {
+            reschedule(dequeueEvent,
+                       std::max(packetQueue.front().tick, curTick()), true);
+        } else if (drainState() == DrainState::Draining) {
+            DPRINTF(Drain, "Draining of AnalyticalDRAM complete\n");
+            signalDrainDone();
+        }
+    }
+}
+
+void
+AnalyticalDRAM::recvRespRetry()
+{
+    assert(retryResp);
+
+    dequeue();
+}
+
+Port &
+AnalyticalDRAM::getPort(const std::string &if_name, PortID idx)
+{
+    if (if_name != "port") {
+        return AbstractMemory::getPort(if_name, idx);
+    } else {
+        return port;
+    }
+}
+
+DrainState
+AnalyticalDRAM::drain()
+{
+    // writes are timed when issued, so there is nothing to wait for
+    if (!writeBuffer.empty())
+        drainWrites(curTick());
+
+    if (!packetQueue.empty()) {
+        DPRINTF(Drain, "AnalyticalDRAM Queue has requests, "
+                "waiting to drain\n");
+        return DrainState::Draining;
+    } else {
+        return DrainState::Drained;
+    }
+}
+
+AnalyticalDRAM::AnalyticalDRAMStats::AnalyticalDRAMStats(
+    AnalyticalDRAM &_dram)
+    : statistics::Group(&_dram),
+    dram(_dram),
+
+    ADD_STAT(readReqs, statistics::units::Count::get(),
+             "Number of read requests accepted"),
+    ADD_STAT(writeReqs, statistics::units::Count::get(),
+             "Number of write requests accepted"),
+    ADD_STAT(readBursts, statistics::units::Count::get(),
+             "Number of DRAM read bursts"),
+    ADD_STAT(writeBursts, statistics::units::Count::get(),
+             "Number of DRAM write bursts"),
+    ADD_STAT(servicedByWrQ, statistics::units::Count::get(),
+             "Number of read bursts serviced by the write buffer"),
+    ADD_STAT(numRdRetry, statistics::units::Count::get(),
+             "Number of times read buffer was full causing retry"),
+    ADD_STAT(numWrRetry, statistics::units::Count::get(),
+             "Number of times the channel backlog caused a write retry"),
+
+    ADD_STAT(readRowHits, statistics::units::Count::get(),
+             "Number of row buffer hits during reads"),
+    ADD_STAT(writeRowHits, statistics::units::Count::get(),
+             "Number of row buffer hits during writes"),
+    ADD_STAT(readRowHitRate, statistics::units::Ratio::get(),
+             "Row buffer hit rate for reads"),
+    ADD_STAT(writeRowHitRate, statistics::units::Ratio::get(),
+             "Row buffer hit rate for writes"),
+
+    ADD_STAT(totMemAccLat, statistics::units::Tick::get(),
+             "Total ticks spent from burst creation until serviced "
+             "by the DRAM"),
+    ADD_STAT(avgMemAccLat, statistics::units::Rate<
+                statistics::units::Tick, statistics::units::Count>::get(),
+             "Average memory access latency per DRAM burst"),
+
+    ADD_STAT(bytesRead, statistics::units::Byte::get(),
+             "Total bytes read"),
+    ADD_STAT(bytesWritten, statistics::units::Byte::get(),
+             "Total bytes written"),
+    ADD_STAT(avgRdBW, statistics::units::Rate<
+                statistics::units::Byte, statistics::units::Second>::get(),
+             "Average DRAM read bandwidth in MiBytes/s"),
+    ADD_STAT(avgWrBW, statistics::units::Rate<
+                statistics::units::Byte, statistics::units::Second>::get(),
+             "Average DRAM write bandwidth in MiBytes/s"),
+    ADD_STAT(peakBW,  statistics::units::Rate<
+                statistics::units::Byte, statistics::units::Second>::get(),
+             "Theoretical peak bandwidth in MiByte/s"),
+    ADD_STAT(busUtil, statistics::units::Ratio::get(),
+             "Data bus utilization in percentage")
+{
+}
+
+void
+AnalyticalDRAM::AnalyticalDRAMStats::regStats()
+{
+    using namespace statistics;
+
+    readRowHitRate.precision(2);
+    writeRowHitRate.precision(2);
+    avgMemAccLat.precision(2);
+    peakBW.precision(2);
+    busUtil.precision(2);
+
+    readRowHitRate = (readRowHits / readBursts) * 100;
+    writeRowHitRate = (writeRowHits / writeBursts) * 100;
+    avgMemAccLat = totMemAccLat / readBursts;
+
+    avgRdBW = (bytesRead / 1000000) / simSeconds;
+    avgWrBW = (bytesWritten / 1000000) / simSeconds;
+    peakBW = (sim_clock::Frequency / dram.tBURST) * dram.burstSize / 1000000;
+    busUtil = (avgRdBW + avgWrBW) / peakBW * 100;
+}
+
+AnalyticalDRAM::MemoryPort::MemoryPort(const std::string& _name,
+                                       AnalyticalDRAM& _memory)
+    : ResponsePort(_name, &_memory), mem(_memory)
+{ }
+
+AddrRangeList
+AnalyticalDRAM::MemoryPort::getAddrRanges() const
+{
+    AddrRangeList ranges;
+    ranges.push_back(mem.getAddrRange());
+    return ranges;
+}
+
+Tick
+AnalyticalDRAM::MemoryPort::recvAtomic(PacketPtr pkt)
+{
+    return mem.recvAtomic(pkt);
+}
+
+Tick
+AnalyticalDRAM::MemoryPort::recvAtomicBackdoor(
+        PacketPtr pkt, MemBackdoorPtr &_backdoor)
+{
+    return mem.recvAtomicBackdoor(pkt, _backdoor);
+}
+
+void
+AnalyticalDRAM::MemoryPort::recvFunctional(PacketPtr pkt)
+{
+    mem.recvFunctional(pkt);
+}
+
+bool
+AnalyticalDRAM::MemoryPort::recvTimingReq(PacketPtr pkt)
+{
+    return mem.recvTimingReq(pkt);
+}
+
+void
+AnalyticalDRAM::MemoryPort::recvRespRetry()
+{
+    mem.recvRespRetry();
+}
+
+} // namespace memory
+} // namespace gem5
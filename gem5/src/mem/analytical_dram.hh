@@ -0,0 +1,307 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * AnalyticalDRAM declaration
+ */
+
+#ifndef __MEM_ANALYTICAL_DRAM_HH__
+#define __MEM_ANALYTICAL_DRAM_HH__
+
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "enums/AddrMap.hh"
+#include "enums/PageManage.hh"
+#include "mem/abstract_mem.hh"
+#include "mem/port.hh"
+#include "params/AnalyticalDRAM.hh"
+#include "sim/eventq.hh"
+
+namespace gem5
+{
+
+namespace memory
+{
+
+/**
+ * A DRAM channel modelled analytically. Rather than stepping every
+ * command through a MemCtrl and a DRAMInterface, the timing of each
+ * burst is resolved in closed form when the request arrives, from a
+ * handful of timers per bank and rank and the tick at which the data
+ * bus frees up. Reads are served in arrival order, writes are buffered
+ * and issued in batches as the MemCtrl write thresholds would, and
+ * refresh periodically blocks and precharges every rank. The only
+ * events are the response and retry events, as for SimpleMemory.
+ *
+ * @sa  \ref gem5MemorySystem "gem5 Memory System"
+ */
+class AnalyticalDRAM : public AbstractMemory
+{
+
+  private:
+
+    /**
+     * A deferred packet stores a packet along with its scheduled
+     * transmission time
+     */
+    class DeferredPacket
+    {
+
+      public:
+
+        const Tick tick;
+        const PacketPtr pkt;
+
+        DeferredPacket(PacketPtr _pkt, Tick _tick) : tick(_tick), pkt(_pkt)
+        { }
+    };
+
+    class MemoryPort : public ResponsePort
+    {
+      private:
+        AnalyticalDRAM& mem;
+
+      public:
+        MemoryPort(const std::string& _name, AnalyticalDRAM& _memory);
+
+      protected:
+        Tick recvAtomic(PacketPtr pkt) override;
+        Tick recvAtomicBackdoor(
+                PacketPtr pkt, MemBackdoorPtr &_backdoor) override;
+        void recvFunctional(PacketPtr pkt) override;
+        bool recvTimingReq(PacketPtr pkt) override;
+        void recvRespRetry() override;
+        AddrRangeList getAddrRanges() const override;
+    };
+
+    MemoryPort port;
+
+    /**
+     * Timers of a single bank, all in absolute ticks
+     */
+    struct Bank
+    {
+        static const uint32_t NO_ROW = -1;
+
+        uint32_t openRow = NO_ROW;
+        Tick actAllowedAt = 0;
+        Tick colAllowedAt = 0;
+        Tick preAllowedAt = 0;
+
+        /** Refresh interval of the last access, to detect refreshes */
+        uint64_t refreshEpoch = 0;
+    };
+
+    /**
+     * Organisation and timing parameters
+     */
+    const enums::AddrMap addrMapping;
+    const enums::PageManage pagePolicy;
+    const uint32_t burstSize;
+    const uint32_t rowBufferSize;
+    const uint32_t burstsPerRowBuffer;
+    const uint32_t burstsPerStripe;
+    const uint32_t ranksPerChannel;
+    const uint32_t banksPerRank;
+    const uint32_t readBufferSize;
+    const uint32_t writeBufferSize;
+    const uint32_t writeHighThreshold;
+    const uint32_t writeLowThreshold;
+    const Tick frontendLatency;
+    const Tick backendLatency;
+    const Tick tBURST;
+    const Tick tRCD;
+    const Tick tCL;
+    const Tick tRP;
+    const Tick tRAS;
+    const Tick tRRD;
+    const Tick tWR;
+    const Tick tRTP;
+    const Tick tWTR;
+    const Tick tRTW;
+    const Tick tCS;
+    const Tick tRFC;
+    const Tick tREFI;
+
+    /** Bank timers, indexed by rank * banksPerRank + bank */
+    std::vector<Bank> banks;
+
+    /** Earliest activate per rank, enforcing tRRD */
+    std::vector<Tick> rankActAllowedAt;
+
+    /**
+     * State of the data bus: when the last burst finishes, and its
+     * direction and rank, to account for turnarounds
+     */
+    Tick busFreeAt;
+    bool lastWasRead;
+    uint8_t lastRank;
+
+    /**
+     * Burst-aligned addresses of the writes accepted but not yet
+     * issued to the banks
+     */
+    std::vector<Addr> writeBuffer;
+
+    /** Number of reads waiting for their response */
+    uint32_t pendingReads;
+
+    /**
+     * Responses waiting to be sent, ordered on their tick
+     */
+    std::list<DeferredPacket> packetQueue;
+
+    /**
+     * Remember if we have to retry an outstanding request that
+     * arrived while the buffers were full.
+     */
+    bool retryReq;
+
+    /**
+     * Remember if we failed to send a response and are awaiting a
+     * retry. This is only used as a check.
+     */
+    bool retryResp;
+
+    /**
+     * Dequeue a packet from our internal packet queue and move it to
+     * the port where it will be sent as soon as possible.
+     */
+    void dequeue();
+
+    EventFunctionWrapper dequeueEvent;
+
+    /**
+     * Send a retry for a request rejected when the buffers were full.
+     */
+    void retry();
+
+    EventFunctionWrapper retryEvent;
+
+    /**
+     * Upstream caches need this packet until true is returned, so
+     * hold it for deletion until a subsequent call
+     */
+    std::unique_ptr<Packet> pendingDelete;
+
+    /**
+     * Determine if a request can be accepted, that is if there is
+     * space in the read or write buffer.
+     *
+     * @param pkt The request
+     * @return true if the request can be accepted
+     */
+    bool canAccept(PacketPtr pkt) const;
+
+    /**
+     * Resolve the timing of a single burst against the bank, rank and
+     * bus state, and update that state.
+     *
+     * @param addr Burst-aligned address
+     * @param is_read Is this a read burst?
+     * @param at Earliest tick the burst can be issued
+     * @return the tick at which the burst leaves the data bus
+     */
+    Tick accessBurst(Addr addr, bool is_read, Tick at);
+
+    /**
+     * Issue all the buffered writes to the banks.
+     *
+     * @param at Earliest tick the writes can be issued
+     */
+    void drainWrites(Tick at);
+
+    /**
+     * Push a tick out of any refresh window of the ranks.
+     */
+    Tick afterRefresh(Tick at) const;
+
+    /**
+     * Burst-align an address.
+     */
+    Addr burstAlign(Addr addr) const { return addr & ~Addr(burstSize - 1); }
+
+    struct AnalyticalDRAMStats : public statistics::Group
+    {
+        AnalyticalDRAMStats(AnalyticalDRAM &dram);
+
+        void regStats() override;
+
+        const AnalyticalDRAM &dram;
+
+        statistics::Scalar readReqs;
+        statistics::Scalar writeReqs;
+        statistics::Scalar readBursts;
+        statistics::Scalar writeBursts;
+        statistics::Scalar servicedByWrQ;
+        statistics::Scalar numRdRetry;
+        statistics::Scalar numWrRetry;
+
+        statistics::Scalar readRowHits;
+        statistics::Scalar writeRowHits;
+        statistics::Formula readRowHitRate;
+        statistics::Formula writeRowHitRate;
+
+        // Latencies summed over all read bursts, excluding static
+        // pipeline latency
+        statistics::Scalar totMemAccLat;
+        statistics::Formula avgMemAccLat;
+
+        statistics::Scalar bytesRead;
+        statistics::Scalar bytesWritten;
+        statistics::Formula avgRdBW;
+        statistics::Formula avgWrBW;
+        statistics::Formula peakBW;
+        statistics::Formula busUtil;
+    };
+
+    AnalyticalDRAMStats stats;
+
+  public:
+
+    AnalyticalDRAM(const AnalyticalDRAMParams &p);
+
+    DrainState drain() override;
+
+    Port &getPort(const std::string &if_name,
+                  PortID idx=InvalidPortID) override;
+    void init() override;
+
+  protected:
+    Tick recvAtomic(PacketPtr pkt);
+    Tick recvAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr &_backdoor);
+    void recvFunctional(PacketPtr pkt);
+    bool recvTimingReq(PacketPtr pkt);
+    void recvRespRetry();
+};
+
+} // namespace memory
+} // namespace gem5
+
+#endif //__MEM_ANALYTICAL_DRAM_HH__
@@ -70,6 +70,28 @@ class WriteAllocator(SimObject):
     block_size = Param.Int(Parent.cache_line_size, "block size in bytes")
 
 
+class DeadBlockPredictor(SimObject):
+    type = 'DeadBlockPredictor'
+    cxx_header = "mem/cache/dead_block_predictor.hh"
+    cxx_class = 'gem5::DeadBlockPredictor'
+
+    block_size = Param.Int(Parent.cache_line_size, "block size in bytes")
+
+    sampling_ratio = Param.Unsigned(64, "One set of block addresses in "
+        "that many is sampled")
+    sampler_sets = Param.Unsigned(32, "Number of sets of the sampler")
+    sampler_assoc = Param.Unsigned(12, "Associativity of the sampler")
+
+    num_tables = Param.Unsigned(3, "Number of prediction tables")
+    table_entries = Param.Unsigned(4096,
+        "Number of counters of each prediction table")
+    counter_bits = Param.Unsigned(2, "Number of bits of the counters")
+    threshold = Param.Unsigned(8, "Sum of the counters of a signature at "
+        "which its blocks are predicted dead")
+
+    bypass_history = Param.Unsigned(1024, "Number of bypassed blocks "
+        "remembered to measure the accuracy")
+
 class BaseCache(ClockedObject):
     type = 'BaseCache'
     abstract = True
@@ -114,10 +136,16 @@ class BaseCache(ClockedObject):
     # so try move the block to co-allocate it
     move_contractions = Param.Bool(True, "Try to co-allocate blocks that "
         "contract")
+    link_compression = Param.Bool(False, "Send compressed lines to the "
+        "next level with their compressed size")
 
     sequential_access = Param.Bool(False,
         "Whether to access tags and data sequentially")
 
+    share_line_buffers = Param.Bool(False, "Share whole line payloads "
+        "with packets and other caches, copy-on-write, rather than copying "
+        "them on every fill, response and writeback")
+
     cpu_side = ResponsePort("Upstream port closer to the CPU and/or device")
     mem_side = RequestPort("Downstream port closer to memory")
 
@@ -152,6 +180,20 @@ class BaseCache(ClockedObject):
     # data cache.
     write_allocator = Param.WriteAllocator(NULL, "Write allocator")
 
+    # A dead block predictor spots the demand fills whose block will not
+    # be touched again, and fills them without allocating a block, so
+    # that streaming data does not pollute the cache.
+    dead_block_predictor = Param.DeadBlockPredictor(NULL,
+        "Dead block predictor, NULL to allocate every fill")
+
+    # Memory controllers to ask whether a dirty line nearing eviction
+    # can be written back now, while its DRAM row is open or the
+    # controller is otherwise idle, rather than when it is evicted and
+    # competes with the demand reads. Typically only set for the
+    # last-level cache, and empty to only write back on eviction.
+    writeback_hints = VectorParam.MemCtrl([],
+        "Memory controllers hinting when to clean lines eagerly")
+
 class Cache(BaseCache):
     type = 'Cache'
     cxx_header = 'mem/cache/cache.hh'
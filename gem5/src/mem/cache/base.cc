@@ -54,11 +54,13 @@
 #include "debug/CacheVerbose.hh"
 #include "debug/HWPrefetch.hh"
 #include "mem/cache/compressors/base.hh"
+#include "mem/cache/dead_block_predictor.hh"
 #include "mem/cache/mshr.hh"
 #include "mem/cache/prefetch/base.hh"
 #include "mem/cache/queue_entry.hh"
 #include "mem/cache/tags/compressed_tags.hh"
 #include "mem/cache/tags/super_blk.hh"
+#include "mem/mem_ctrl.hh"
 #include "params/BaseCache.hh"
 #include "params/WriteAllocator.hh"
 #include "sim/cur_tick.hh"
@@ -86,6 +88,8 @@ BaseCache::BaseCache(const BaseCacheParams &p, unsigned blk_size)
       compressor(p.compressor),
       prefetcher(p.prefetcher),
       writeAllocator(p.write_allocator),
+      deadBlockPredictor(p.dead_block_predictor),
+      writebackHints(p.writeback_hints.begin(), p.writeback_hints.end()),
       writebackClean(p.writeback_clean),
       tempBlockWriteback(nullptr),
       writebackTempBlockAtomicEvent([this]{ writebackTempBlockAtomic(); },
@@ -98,12 +102,14 @@ BaseCache::BaseCache(const BaseCacheParams &p, unsigned blk_size)
       fillLatency(p.data_latency),
       responseLatency(p.response_latency),
       sequentialAccess(p.sequential_access),
+      shareLineBuffers(p.share_line_buffers),
       numTarget(p.tgts_per_mshr),
       forwardSnoops(true),
       clusivity(p.clusivity),
       isReadOnly(p.is_read_only),
       replaceExpansions(p.replace_expansions),
       moveContractions(p.move_contractions),
+      linkCompression(p.link_compression),
       blocked(0),
       order(0),
       noTargetMSHR(nullptr),
@@ -286,6 +292,11 @@ BaseCache::handleTimingReqMiss(PacketPtr pkt, MSHR *mshr, CacheBlk *blk,
                 assert(pkt->req->requestorId() < system->maxRequestors());
                 stats.cmdStats(pkt).mshrHits[pkt->req->requestorId()]++;
 
+                // A demand waiting for a prefetch still in flight means
+                // the prefetch was useful, but issued too late
+                if (prefetcher && pkt->isDemand() && mshr->isHWPrefetch())
+                    prefetcher->pfUsefulLate(mshr->getTarget()->pkt);
+
                 // We use forward_time here because it is the same
                 // considering new targets. We have multiple
                 // requests for the same address here. It
@@ -310,7 +321,7 @@ BaseCache::handleTimingReqMiss(PacketPtr pkt, MSHR *mshr, CacheBlk *blk,
         assert(pkt->req->requestorId() < system->maxRequestors());
         stats.cmdStats(pkt).mshrMisses[pkt->req->requestorId()]++;
         if (prefetcher && pkt->isDemand())
-            prefetcher->incrDemandMhsrMisses();
+            prefetcher->incrDemandMhsrMisses(pkt);
 
         if (pkt->isEviction() || pkt->cmd == MemCmd::WriteClean) {
             // We use forward_time here because there is an
@@ -357,11 +368,18 @@ BaseCache::recvTimingReq(PacketPtr pkt)
     CacheBlk *blk = nullptr;
     bool satisfied = false;
     {
+        // the access may turn the packet into a response, so note the
+        // set it touches beforehand
+        const Addr addr = pkt->getAddr();
+
         PacketList writebacks;
         // Note that lat is passed by reference here. The function
         // access() will set the lat value.
         satisfied = access(pkt, blk, lat, writebacks);
 
+        if (!writebackHints.empty())
+            eagerWriteback(addr, writebacks);
+
         // After the evicted blocks are selected, they must be forwarded
         // to the write buffer to ensure they logically precede anything
         // happening below
@@ -485,7 +503,8 @@ BaseCache::recvTimingResp(PacketPtr pkt)
                 pkt->getAddr());
 
         const bool allocate = (writeAllocator && mshr->wasWholeLineWrite) ?
-            writeAllocator->allocate() : mshr->allocOnFill();
+            writeAllocator->allocate() :
+            allocateFill(pkt, mshr->allocOnFill());
         blk = handleFill(pkt, blk, writebacks, allocate);
         assert(blk != nullptr);
         ppFill->notify(pkt);
@@ -587,11 +606,25 @@ BaseCache::recvAtomic(PacketPtr pkt)
     doWritebacksAtomic(writebacks);
     assert(writebacks.empty());
 
+    // Warmup accesses train the prefetcher like timing accesses do,
+    // but the prefetches it generates are not issued
+    const bool warmup = pkt->req->isWarmup();
+    if (warmup) {
+        if (satisfied) {
+            ppHit->notify(pkt);
+            if (blk && blk->wasPrefetched())
+                blk->clearPrefetched();
+        } else {
+            ppMiss->notify(pkt);
+        }
+    }
+
     if (!satisfied) {
         lat += handleAtomicReqMiss(pkt, blk, writebacks);
     }
 
-    // Note that we don't invoke the prefetcher at all in atomic mode.
+    // Note that we don't invoke the prefetcher at all in atomic mode,
+    // other than to train it with warmup accesses.
     // It's not clear how to do it properly, particularly for
     // prefetchers that aggressively generate prefetch candidates and
     // rely on bandwidth contention to throttle them; these will tend
@@ -632,7 +665,7 @@ BaseCache::recvAtomic(PacketPtr pkt)
         pkt->makeAtomicResponse();
     }
 
-    return lat * clockPeriod();
+    return warmup ? 0 : lat * clockPeriod();
 }
 
 void
@@ -652,6 +685,10 @@ BaseCache::functionalAccess(PacketPtr pkt, bool from_cpu_side)
     // needs to be found.  As a result we always update the request if
     // we have it, but only declare it satisfied if we are the owner.
 
+    // functional writes update the block data in place
+    if (blk && blk->isValid() && pkt->isWrite())
+        blk->makeDataWritable(blkSize);
+
     // see if we have data at all (owned or otherwise)
     bool have_data = blk && blk->isValid()
         && pkt->trySatisfyFunctional(&cbpw, blk_addr, is_secure, blkSize,
@@ -703,9 +740,17 @@ BaseCache::updateBlockData(CacheBlk *blk, const PacketPtr cpkt,
         }
     }
 
-    // Actually perform the data update
+    // Actually perform the data update, taking over the payload of
+    // a packet that carries a shared copy of the whole line
     if (cpkt) {
-        cpkt->writeDataToBlock(blk->data, blkSize);
+        if (shareLineBuffers && cpkt->getSharedData() &&
+            cpkt->getSize() == blkSize && !cpkt->isMaskedWrite()) {
+            blk->adoptData(cpkt->getSharedData());
+            stats.sharedLineTransfers++;
+        } else {
+            blk->makeDataWritable(blkSize);
+            cpkt->writeDataToBlock(blk->data, blkSize);
+        }
     }
 
     if (ppDataUpdate->hasListeners()) {
@@ -717,6 +762,22 @@ BaseCache::updateBlockData(CacheBlk *blk, const PacketPtr cpkt,
     }
 }
 
+void
+BaseCache::setDataFromBlock(PacketPtr pkt, CacheBlk *blk)
+{
+    // only packets exchanged with another cache qualify, the data of
+    // any other requestor may be accessed without going through the
+    // packet
+    if (shareLineBuffers && pkt->fromCache() && pkt->getSize() == blkSize &&
+        !pkt->hasStaticData()) {
+        pkt->deleteData();
+        pkt->dataShared(blk->shareData(blkSize));
+        stats.sharedLineTransfers++;
+    } else {
+        pkt->setDataFromBlock(blk->data, blkSize);
+    }
+}
+
 void
 BaseCache::cmpAndSwap(CacheBlk *blk, PacketPtr pkt)
 {
@@ -727,6 +788,7 @@ BaseCache::cmpAndSwap(CacheBlk *blk, PacketPtr pkt)
     uint64_t condition_val64;
     uint32_t condition_val32;
 
+    blk->makeDataWritable(blkSize);
     int offset = pkt->getOffset(blkSize);
     uint8_t *blk_data = blk->data + offset;
 
@@ -948,7 +1010,7 @@ BaseCache::updateCompressionData(CacheBlk *&blk, const uint64_t* data,
         CacheBlk *victim = nullptr;
         if (replaceExpansions || is_data_contraction) {
             victim = tags->findVictim(regenerateBlkAddr(blk),
-                blk->isSecure(), compression_size, evict_blks);
+                blk->isSecure(), compression_size, evict_blks, nullptr);
 
             // It is valid to return nullptr if there is no victim
             if (!victim) {
@@ -1039,6 +1101,7 @@ BaseCache::satisfyRequest(PacketPtr pkt, CacheBlk *blk, bool, bool)
             // extract data from cache and save it into the data field in
             // the packet as a return value from this atomic op
             int offset = tags->extractBlkOffset(pkt->getAddr());
+            blk->makeDataWritable(blkSize);
             uint8_t *blk_data = blk->data + offset;
             pkt->setData(blk_data);
 
@@ -1080,7 +1143,7 @@ BaseCache::satisfyRequest(PacketPtr pkt, CacheBlk *blk, bool, bool)
 
         // all read responses have a data payload
         assert(pkt->hasRespData());
-        pkt->setDataFromBlock(blk->data, blkSize);
+        setDataFromBlock(pkt, blk);
     } else if (pkt->isUpgrade()) {
         // sanity check
         assert(!pkt->hasSharers());
@@ -1165,6 +1228,9 @@ BaseCache::access(PacketPtr pkt, CacheBlk *&blk, Cycles &lat,
     Cycles tag_latency(0);
     blk = tags->accessBlock(pkt, tag_latency);
 
+    if (deadBlockPredictor)
+        deadBlockPredictor->access(pkt, blk != nullptr);
+
     DPRINTF(Cache, "%s for %s %s\n", __func__, pkt->print(),
             blk ? "hit " + blk->print() : "miss");
 
@@ -1555,9 +1621,9 @@ BaseCache::allocateBlock(const PacketPtr pkt, PacketList &writebacks)
     }
 
     // Find replacement victim
-    std::vector<CacheBlk*> evict_blks;
+    evictBlks.clear();
     CacheBlk *victim = tags->findVictim(addr, is_secure, blk_size_bits,
-                                        evict_blks);
+                                        evictBlks, pkt);
 
     // It is valid to return nullptr if there is no victim
     if (!victim)
@@ -1566,8 +1632,19 @@ BaseCache::allocateBlock(const PacketPtr pkt, PacketList &writebacks)
     // Print victim block's information
     DPRINTF(CacheRepl, "Replacement victim: %s\n", victim->print());
 
+    // Let the prefetcher know about the blocks its own fills push out of
+    // the cache, so that it can detect when they are missed on later
+    if (prefetcher && pkt->cmd == MemCmd::HardPFResp) {
+        for (const auto &blk : evictBlks) {
+            if (blk->isValid() && !blk->wasPrefetched()) {
+                prefetcher->prefetchEviction(regenerateBlkAddr(blk),
+                                             blk->isSecure());
+            }
+        }
+    }
+
     // Try to evict blocks; if it fails, give up on allocation
-    if (!handleEvictions(evict_blks, writebacks)) {
+    if (!handleEvictions(evictBlks, writebacks)) {
         return nullptr;
     }
 
@@ -1589,7 +1666,7 @@ BaseCache::invalidateBlock(CacheBlk *blk)
 {
     // If block is still marked as prefetched, then it hasn't been used
     if (blk->wasPrefetched()) {
-        prefetcher->prefetchUnused();
+        prefetcher->prefetchUnused(blk->getPrefetchPC());
     }
 
     // Notify that the data contents for this address are no longer present
@@ -1623,7 +1700,7 @@ BaseCache::writebackBlk(CacheBlk *blk)
 
     stats.writebacks[Request::wbRequestorId]++;
 
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = makeRequest(
         regenerateBlkAddr(blk), blkSize, 0, Request::wbRequestorId);
 
     if (blk->isSecure())
@@ -1652,21 +1729,65 @@ BaseCache::writebackBlk(CacheBlk *blk)
     blk->clearCoherenceBits(CacheBlk::DirtyBit);
 
     pkt->allocate();
-    pkt->setDataFromBlock(blk->data, blkSize);
+    setDataFromBlock(pkt, blk);
 
     // When a block is compressed, it must first be decompressed before being
-    // sent for writeback.
+    // sent for writeback, unless the link carries it compressed
     if (compressor) {
-        pkt->payloadDelay = compressor->getDecompressionLatency(blk);
+        setLinkCompressedSize(pkt, blk);
     }
 
     return pkt;
 }
 
+void
+BaseCache::setLinkCompressedSize(PacketPtr pkt, CacheBlk *blk) const
+{
+    const CompressionBlk* comp_blk = static_cast<const CompressionBlk*>(blk);
+    if (linkCompression && comp_blk->isCompressed()) {
+        pkt->compressedSize = divCeil(comp_blk->getSizeBits(), CHAR_BIT);
+    } else {
+        pkt->payloadDelay = compressor->getDecompressionLatency(blk);
+    }
+}
+
+void
+BaseCache::eagerWriteback(Addr addr, PacketList &writebacks)
+{
+    // never take the last write buffer entries from the evictions
+    if (writeBuffer.isFull())
+        return;
+
+    CacheBlk *blk = tags->findReplacementCandidate(addr);
+    if (!blk || !blk->isValid() || !blk->isSet(CacheBlk::DirtyBit))
+        return;
+
+    const Addr blk_addr = regenerateBlkAddr(blk);
+    const bool is_secure = blk->isSecure();
+    // leave the block alone while a request or writeback for it is
+    // in flight
+    if (mshrQueue.findMatch(blk_addr, is_secure) ||
+        writeBuffer.findMatch(blk_addr, is_secure))
+        return;
+
+    for (const auto *ctrl : writebackHints) {
+        if (!ctrl->servesAddr(blk_addr))
+            continue;
+        if (!ctrl->writebackWelcome(blk_addr))
+            return;
+
+        DPRINTF(Cache, "Eager writeback of %#llx (%s)\n", blk_addr,
+                is_secure ? "s" : "ns");
+        writebacks.push_back(writecleanBlk(blk, Request::Flags(), 0));
+        stats.eagerWritebacks++;
+        return;
+    }
+}
+
 PacketPtr
 BaseCache::writecleanBlk(CacheBlk *blk, Request::Flags dest, PacketId id)
 {
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = makeRequest(
         regenerateBlkAddr(blk), blkSize, 0, Request::wbRequestorId);
 
     if (blk->isSecure()) {
@@ -1697,12 +1818,12 @@ BaseCache::writecleanBlk(CacheBlk *blk, Request::Flags dest, PacketId id)
     blk->clearCoherenceBits(CacheBlk::DirtyBit);
 
     pkt->allocate();
-    pkt->setDataFromBlock(blk->data, blkSize);
+    setDataFromBlock(pkt, blk);
 
     // When a block is compressed, it must first be decompressed before being
-    // sent for writeback.
+    // sent for writeback, unless the link carries it compressed
     if (compressor) {
-        pkt->payloadDelay = compressor->getDecompressionLatency(blk);
+        setLinkCompressedSize(pkt, blk);
     }
 
     return pkt;
@@ -1740,7 +1861,7 @@ BaseCache::writebackVisitor(CacheBlk &blk)
     if (blk.isSet(CacheBlk::DirtyBit)) {
         assert(blk.isValid());
 
-        RequestPtr request = std::make_shared<Request>(
+        RequestPtr request = makeRequest(
             regenerateBlkAddr(&blk), blkSize, 0, Request::funcRequestorId);
 
         request->taskId(blk.getTaskId());
@@ -1770,6 +1891,18 @@ BaseCache::invalidateVisitor(CacheBlk &blk)
     }
 }
 
+bool
+BaseCache::allocateFill(const PacketPtr pkt, bool allocate)
+{
+    // Only demand reads are predicted, a block brought in by a prefetch
+    // is there to be used later
+    if (!allocate || !deadBlockPredictor || !pkt->isRead() ||
+        pkt->cmd.isHWPrefetch()) {
+        return allocate;
+    }
+    return !deadBlockPredictor->bypass(pkt);
+}
+
 Tick
 BaseCache::nextQueueReadyTime() const
 {
@@ -2197,6 +2330,11 @@ BaseCache::CacheStats::CacheStats(BaseCache &c)
              "number of data expansions"),
     ADD_STAT(dataContractions, statistics::units::Count::get(),
              "number of data contractions"),
+    ADD_STAT(sharedLineTransfers, statistics::units::Count::get(),
+             "number of line transfers that shared the payload instead of "
+             "copying it"),
+    ADD_STAT(eagerWritebacks, statistics::units::Count::get(),
+             "number of dirty blocks cleaned ahead of their eviction"),
     cmd(MemCmd::NUM_MEM_CMDS)
 {
     for (int idx = 0; idx < MemCmd::NUM_MEM_CMDS; ++idx)
@@ -2426,6 +2564,8 @@ BaseCache::CacheStats::regStats()
 
     dataExpansions.flags(nozero | nonan);
     dataContractions.flags(nozero | nonan);
+    sharedLineTransfers.flags(nozero | nonan);
+    eagerWritebacks.flags(nozero | nonan);
 }
 
 void
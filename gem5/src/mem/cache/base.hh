@@ -84,7 +84,12 @@ namespace prefetch
 {
     class Base;
 }
+class DeadBlockPredictor;
 class MSHR;
+namespace memory
+{
+    class MemCtrl;
+}
 class RequestPort;
 class QueueEntry;
 struct BaseCacheParams;
@@ -387,6 +392,28 @@ class BaseCache : public ClockedObject
      */
     WriteAllocator * const writeAllocator;
 
+    /**
+     * The dead block predictor, if any. Fills of demand reads which it
+     * predicts dead on arrival do not allocate a block.
+     */
+    DeadBlockPredictor * const deadBlockPredictor;
+
+    /**
+     * The memory controllers consulted for eager writebacks, empty if
+     * dirty lines are only written back when they are evicted.
+     */
+    const std::vector<memory::MemCtrl *> writebackHints;
+
+    /**
+     * Whether a fill allocates a block, given the allocation decided for
+     * the request, once the dead block predictor has had its say.
+     *
+     * @param pkt The fill
+     * @param allocate Whether the request allocates on fill
+     * @return Whether the fill should allocate a block
+     */
+    bool allocateFill(const PacketPtr pkt, bool allocate);
+
     /**
      * Temporary cache block for occasional transitory use.  We use
      * the tempBlock to fill when allocation fails (e.g., when there
@@ -395,6 +422,12 @@ class BaseCache : public ClockedObject
      */
     TempCacheBlk *tempBlock;
 
+    /**
+     * Blocks to be evicted by the current allocation. It is reused by
+     * every allocation so that finding a victim does not allocate memory.
+     */
+    std::vector<CacheBlk*> evictBlks;
+
     /**
      * Upstream caches need this packet until true is returned, so
      * hold it for deletion until a subsequent call
@@ -623,6 +656,17 @@ class BaseCache : public ClockedObject
     void updateBlockData(CacheBlk *blk, const PacketPtr cpkt,
         bool has_old_data);
 
+    /**
+     * Copy the data of a block into a packet. With share_line_buffers
+     * a packet carrying the whole line to or from another cache
+     * references the block payload instead, and the copy happens only
+     * if either side writes to it later.
+     *
+     * @param pkt The packet to provide the data to.
+     * @param blk The block holding the data.
+     */
+    void setDataFromBlock(PacketPtr pkt, CacheBlk *blk);
+
     /**
      * Handle doing the Compare and Swap function for SPARC.
      */
@@ -835,6 +879,16 @@ class BaseCache : public ClockedObject
      */
     PacketPtr writebackBlk(CacheBlk *blk);
 
+    /**
+     * Prepare the writeback of a block of a compressed cache: with link
+     * compression the line is sent compressed, and otherwise it must be
+     * decompressed first.
+     *
+     * @param pkt The writeback packet.
+     * @param blk The block being written back.
+     */
+    void setLinkCompressedSize(PacketPtr pkt, CacheBlk *blk) const;
+
     /**
      * Create a writeclean request for the given block.
      *
@@ -848,6 +902,18 @@ class BaseCache : public ClockedObject
      */
     PacketPtr writecleanBlk(CacheBlk *blk, Request::Flags dest, PacketId id);
 
+    /**
+     * Clean the next replacement candidate of the set an address maps
+     * to ahead of its eviction, if it is dirty and the memory
+     * controller hints that the write is cheap right now, i.e. its row
+     * is open or the controller has no reads waiting. The block stays
+     * in the cache, so a later eviction of it is a clean one.
+     *
+     * @param addr Address whose set was just accessed.
+     * @param writebacks List to add the write clean packet to.
+     */
+    void eagerWriteback(Addr addr, PacketList &writebacks);
+
     /**
      * Write back dirty blocks in the cache using functional accesses.
      */
@@ -921,6 +987,12 @@ class BaseCache : public ClockedObject
      */
     const bool sequentialAccess;
 
+    /**
+     * Whether whole lines passed to or from another cache share their
+     * payload with the packet instead of being copied.
+     */
+    const bool shareLineBuffers;
+
     /** The number of targets for each MSHR. */
     const int numTarget;
 
@@ -958,6 +1030,12 @@ class BaseCache : public ClockedObject
      */
     const bool moveContractions;
 
+    /**
+     * Whether the lines written back to the next level are tagged with
+     * their compressed size, modelling a compressed link.
+     */
+    const bool linkCompression;
+
     /**
      * Bit vector of the blocking reasons for the access path.
      * @sa #BlockedCause
@@ -1142,6 +1220,12 @@ class BaseCache : public ClockedObject
          */
         statistics::Scalar dataContractions;
 
+        /** Number of line transfers that shared the payload. */
+        statistics::Scalar sharedLineTransfers;
+
+        /** Number of dirty blocks cleaned ahead of their eviction. */
+        statistics::Scalar eagerWritebacks;
+
         /** Per-command statistics */
         std::vector<std::unique_ptr<CacheCmdStats>> cmd;
     } stats;
@@ -1289,6 +1373,20 @@ class BaseCache : public ClockedObject
         }
     }
 
+    /**
+     * Get the PC of the access which triggered the prefetch of a block.
+     * @return The PC, or MaxAddr if the block is not an unaccessed
+     *         prefetch or the PC is not known.
+     */
+    Addr prefetchPC(Addr addr, bool is_secure) const {
+        CacheBlk *block = tags->findBlock(addr, is_secure);
+        if (block && block->wasPrefetched()) {
+            return block->getPrefetchPC();
+        } else {
+            return MaxAddr;
+        }
+    }
+
     bool inMissQueue(Addr addr, bool is_secure) const {
         return mshrQueue.findMatch(addr, is_secure);
     }
@@ -1296,6 +1394,8 @@ class BaseCache : public ClockedObject
     void incMissCount(PacketPtr pkt)
     {
         assert(pkt->req->requestorId() < system->maxRequestors());
+        if (pkt->req->isWarmup())
+            return;
         stats.cmdStats(pkt).misses[pkt->req->requestorId()]++;
         pkt->req->incAccessDepth();
         if (missCount) {
@@ -1307,6 +1407,8 @@ class BaseCache : public ClockedObject
     void incHitCount(PacketPtr pkt)
     {
         assert(pkt->req->requestorId() < system->maxRequestors());
+        if (pkt->req->isWarmup())
+            return;
         stats.cmdStats(pkt).hits[pkt->req->requestorId()]++;
     }
 
@@ -48,8 +48,10 @@
 
 #include <cassert>
 #include <cstdint>
+#include <cstring>
 #include <iosfwd>
 #include <list>
+#include <memory>
 #include <string>
 
 #include "base/printable.hh"
@@ -151,6 +153,16 @@ class CacheBlk : public TaggedEntry
      * on the block since the last store. */
     std::list<Lock> lockList;
 
+    /**
+     * Line buffer the data pointer refers to while the payload is
+     * shared with packets or blocks of other caches, null if the data
+     * lives in the block's own storage.
+     */
+    std::shared_ptr<uint8_t[]> sharedData;
+
+    /** The block's own storage, set aside while the data is shared. */
+    uint8_t *ownData = nullptr;
+
   public:
     CacheBlk()
     {
@@ -179,7 +191,7 @@ class CacheBlk : public TaggedEntry
         insert(other.getTag(), other.isSecure());
 
         if (other.wasPrefetched()) {
-            setPrefetched();
+            setPrefetched(other.getPrefetchPC());
         }
         setCoherenceBits(other.coherence);
         setTaskId(other.getTaskId());
@@ -209,8 +221,73 @@ class CacheBlk : public TaggedEntry
         setRefCount(0);
         setSrcRequestorId(Request::invldRequestorId);
         lockList.clear();
+        releaseData();
+    }
+
+    /**
+     * Use a shared line buffer as the payload of this block instead of
+     * copying it into the block's own storage.
+     *
+     * @param buf Buffer holding the whole line.
+     */
+    void
+    adoptData(const std::shared_ptr<uint8_t[]> &buf)
+    {
+        if (!sharedData)
+            ownData = data;
+        sharedData = buf;
+        data = buf.get();
     }
 
+    /**
+     * Get a shared reference to the payload of this block. A block
+     * that holds its data privately moves it into a new line buffer
+     * first.
+     *
+     * @param size Block size in bytes.
+     * @return The shared line buffer of this block.
+     */
+    const std::shared_ptr<uint8_t[]> &
+    shareData(unsigned size)
+    {
+        if (!sharedData) {
+            std::shared_ptr<uint8_t[]> buf(new uint8_t[size]);
+            std::memcpy(buf.get(), data, size);
+            adoptData(buf);
+        }
+        return sharedData;
+    }
+
+    /**
+     * Must be called before writing to the data of the block. If the
+     * payload is shared with anyone else it is copied back into the
+     * block's own storage.
+     *
+     * @param size Block size in bytes.
+     */
+    void
+    makeDataWritable(unsigned size)
+    {
+        if (sharedData && sharedData.use_count() > 1) {
+            std::memcpy(ownData, data, size);
+            data = ownData;
+            sharedData.reset();
+        }
+    }
+
+  protected:
+    /** Drop the reference on a shared payload, if any. */
+    void
+    releaseData()
+    {
+        if (sharedData) {
+            data = ownData;
+            sharedData.reset();
+        }
+    }
+
+  public:
+
     /**
      * Sets the corresponding coherence bits.
      *
@@ -254,8 +331,23 @@ class CacheBlk : public TaggedEntry
      */
     void clearPrefetched() { _prefetched = false; }
 
-    /** Marks this blocks as a recently prefetched block. */
-    void setPrefetched() { _prefetched = true; }
+    /**
+     * Marks this blocks as a recently prefetched block.
+     * @param pc PC of the access which triggered the prefetch, if known.
+     */
+    void
+    setPrefetched(Addr pc = MaxAddr)
+    {
+        _prefetched = true;
+        _prefetchPC = pc;
+    }
+
+    /**
+     * Get the PC of the access which triggered the prefetch of this block.
+     * Only meaningful while the block is marked as prefetched.
+     * @return The PC, or MaxAddr if it is not known.
+     */
+    Addr getPrefetchPC() const { return _prefetchPC; }
 
     /**
      * Get tick at which block's data will be available for access.
@@ -490,6 +582,9 @@ class CacheBlk : public TaggedEntry
 
     /** Whether this block is an unaccessed hardware prefetch. */
     bool _prefetched = 0;
+
+    /** PC of the access which triggered the prefetch of this block. */
+    Addr _prefetchPC = MaxAddr;
 };
 
 /**
@@ -206,6 +206,9 @@ class Base : public SimObject
     /** The cache can only be set once. */
     virtual void setCache(BaseCache *_cache);
 
+    /** Get the size of the lines this compressor works on, in bytes. */
+    std::size_t getBlockSize() const { return blkSize; }
+
     /**
      * Apply the compression process to the cache line. Ignores compression
      * cycles.
@@ -107,6 +107,14 @@ class BaseDelta : public DictionaryCompressor<BaseType>
         return PatternFactory::getPattern(bytes, dict_bytes, match_location);
     }
 
+    std::size_t
+    getPatternSizeBits(const DictionaryEntry& bytes,
+        const DictionaryEntry& dict_bytes,
+        const int match_location) const override
+    {
+        return PatternFactory::getSizeBits(bytes, dict_bytes, match_location);
+    }
+
     std::string
     getName(int number) const override
     {
@@ -121,6 +129,31 @@ class BaseDelta : public DictionaryCompressor<BaseType>
 
     void addToDictionary(DictionaryEntry data) override;
 
+    /**
+     * Check whether a value can be stored as a delta from a base.
+     *
+     * @param value The value to be encoded.
+     * @param base The base it is compared against.
+     * @return Whether the delta fits in DeltaSizeBits.
+     */
+    static bool
+    fitsDelta(const BaseType value, const BaseType base)
+    {
+        const BaseType limit = DeltaSizeBits ? mask(DeltaSizeBits - 1) : 0;
+        return static_cast<BaseType>(value - base + limit) <=
+            static_cast<BaseType>(2 * limit);
+    }
+
+    /**
+     * Classify the whole line against the implicit zero base and the first
+     * value that is not an immediate, instead of searching the dictionary
+     * value by value. This is equivalent to the dictionary search whenever
+     * the line is compressible, which is the only case that is handled
+     * here; lines that need more bases use the generic path.
+     */
+    std::unique_ptr<Base::CompressionData> compress(
+        const std::vector<Base::Chunk>& chunks) override;
+
     std::unique_ptr<Base::CompressionData> compress(
         const std::vector<Base::Chunk>& chunks,
         Cycles& comp_lat, Cycles& decomp_lat) override;
@@ -70,6 +70,64 @@ BaseDelta<BaseType, DeltaSizeBits>::addToDictionary(DictionaryEntry data)
         DictionaryCompressor<BaseType>::numEntries++] = data;
 }
 
+template <class BaseType, std::size_t DeltaSizeBits>
+std::unique_ptr<Base::CompressionData>
+BaseDelta<BaseType, DeltaSizeBits>::compress(
+    const std::vector<Base::Chunk>& chunks)
+{
+    using Pattern = typename DictionaryCompressor<BaseType>::Pattern;
+    using CompData = typename DictionaryCompressor<BaseType>::CompData;
+    const std::size_t num_values = chunks.size();
+
+    // The first value that is not an immediate becomes the only base
+    std::size_t base_index = 0;
+    while ((base_index < num_values) &&
+        fitsDelta(static_cast<BaseType>(chunks[base_index]), 0)) {
+        base_index++;
+    }
+
+    // Check the remaining values against both bases at once. This loop has
+    // no early exit so that it can be vectorized
+    bool needs_more_bases = false;
+    if (base_index < num_values) {
+        const BaseType base = static_cast<BaseType>(chunks[base_index]);
+        for (std::size_t i = base_index + 1; i < num_values; i++) {
+            const BaseType value = static_cast<BaseType>(chunks[i]);
+            needs_more_bases |= !fitsDelta(value, 0) & !fitsDelta(value, base);
+        }
+    }
+    if (needs_more_bases) {
+        return DictionaryCompressor<BaseType>::compress(chunks);
+    }
+
+    std::unique_ptr<Base::CompressionData> comp_data =
+        DictionaryCompressor<BaseType>::instantiateDictionaryCompData();
+    CompData* const comp_data_ptr = static_cast<CompData*>(comp_data.get());
+    resetDictionary();
+
+    // Immediates match the zero base, which has priority over the other
+    // base, and the base itself is a no-match that allocates an entry
+    for (std::size_t i = 0; i < num_values; i++) {
+        const DictionaryEntry bytes =
+            DictionaryCompressor<BaseType>::toDictionaryEntry(chunks[i]);
+        std::unique_ptr<Pattern> pattern;
+        if (i == base_index) {
+            pattern.reset(new PatternX(bytes, -1));
+            addToDictionary(bytes);
+        } else {
+            pattern.reset(new PatternM(bytes,
+                fitsDelta(static_cast<BaseType>(chunks[i]), 0) ? 0 : 1));
+        }
+        DictionaryCompressor<BaseType>::dictionaryStats.patterns[
+            pattern->getPatternNumber()]++;
+        DPRINTF(CacheComp, "Compressed %016x to %s\n", chunks[i],
+            pattern->print());
+        comp_data_ptr->addEntry(std::move(pattern));
+    }
+
+    return comp_data;
+}
+
 template <class BaseType, std::size_t DeltaSizeBits>
 std::unique_ptr<Base::CompressionData>
 BaseDelta<BaseType, DeltaSizeBits>::compress(
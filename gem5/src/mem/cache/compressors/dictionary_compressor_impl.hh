@@ -100,21 +100,29 @@ DictionaryCompressor<T>::compressValue(const T data)
 
     // Start as a no-match pattern. A negative match location is used so that
     // patterns that depend on the dictionary entry don't match
-    std::unique_ptr<Pattern> pattern =
-        getPattern(bytes, toDictionaryEntry(0), -1);
-
-    // Search for word on dictionary
-    for (std::size_t i = 0; i < numEntries; i++) {
-        // Try matching input with possible patterns
-        std::unique_ptr<Pattern> temp_pattern =
-            getPattern(bytes, dictionary[i], i);
-
-        // Check if found pattern is better than previous
-        if (temp_pattern->getSizeBits() < pattern->getSizeBits()) {
-            pattern = std::move(temp_pattern);
+    int match_location = -1;
+    if (numEntries > 0) {
+        std::size_t size_bits =
+            getPatternSizeBits(bytes, toDictionaryEntry(0), -1);
+
+        // Search for word on dictionary
+        for (std::size_t i = 0; i < numEntries; i++) {
+            // Try matching input with possible patterns, and check if found
+            // pattern is better than previous
+            const std::size_t temp_size_bits =
+                getPatternSizeBits(bytes, dictionary[i], i);
+            if (temp_size_bits < size_bits) {
+                size_bits = temp_size_bits;
+                match_location = i;
+            }
         }
     }
 
+    // Only the best pattern is instantiated
+    std::unique_ptr<Pattern> pattern = getPattern(bytes,
+        (match_location < 0) ? toDictionaryEntry(0) :
+        dictionary[match_location], match_location);
+
     // Update stats
     dictionaryStats.patterns[pattern->getPatternNumber()]++;
 
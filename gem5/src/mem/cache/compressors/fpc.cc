@@ -99,5 +99,34 @@ FPC::instantiateDictionaryCompData() const
         new FPCCompData(zeroRunSizeBits));
 }
 
+std::unique_ptr<Base::CompressionData>
+FPC::compress(const std::vector<Chunk>& chunks)
+{
+    // Reduce the whole line without an early exit so that it vectorizes
+    Chunk line_bits = 0;
+    for (const auto& value : chunks) {
+        line_bits |= value;
+    }
+    if (line_bits != 0) {
+        return DictionaryCompressor<uint32_t>::compress(chunks);
+    }
+
+    std::unique_ptr<Base::CompressionData> comp_data =
+        instantiateDictionaryCompData();
+    FPCCompData* const comp_data_ptr =
+        static_cast<FPCCompData*>(comp_data.get());
+    resetDictionary();
+
+    // The compression data splits the zeros into runs of maximum length
+    const DictionaryEntry zero = toDictionaryEntry(0);
+    for (std::size_t i = 0; i < chunks.size(); i++) {
+        dictionaryStats.patterns[ZERO_RUN]++;
+        comp_data_ptr->addEntry(std::unique_ptr<Pattern>(new ZeroRun(zero,
+            -1)));
+    }
+
+    return comp_data;
+}
+
 } // namespace compression
 } // namespace gem5
@@ -113,22 +113,41 @@ class FPC : public DictionaryCompressor<uint32_t>
         return patternNames[number];
     };
 
+    using PatternFactory = Factory<ZeroRun, SignExtended4Bits,
+        SignExtended1Byte, SignExtendedHalfword, ZeroPaddedHalfword,
+        SignExtendedTwoHalfwords, RepBytes, Uncompressed>;
+
     std::unique_ptr<Pattern> getPattern(
         const DictionaryEntry& bytes,
         const DictionaryEntry& dict_bytes,
         const int match_location) const override
     {
-        using PatternFactory = Factory<ZeroRun, SignExtended4Bits,
-            SignExtended1Byte, SignExtendedHalfword, ZeroPaddedHalfword,
-            SignExtendedTwoHalfwords, RepBytes, Uncompressed>;
         return PatternFactory::getPattern(bytes, dict_bytes, match_location);
     }
 
+    std::size_t getPatternSizeBits(
+        const DictionaryEntry& bytes,
+        const DictionaryEntry& dict_bytes,
+        const int match_location) const override
+    {
+        return PatternFactory::getSizeBits(bytes, dict_bytes, match_location);
+    }
+
     void addToDictionary(const DictionaryEntry data) override;
 
     std::unique_ptr<DictionaryCompressor::CompData>
     instantiateDictionaryCompData() const override;
 
+    /**
+     * Zero lines are frequent on fills, so they are detected over the
+     * whole line at once and encoded as zero runs directly. Any other line
+     * goes through the pattern factory value by value.
+     */
+    std::unique_ptr<Base::CompressionData> compress(
+        const std::vector<Chunk>& chunks) override;
+
+    using DictionaryCompressor<uint32_t>::compress;
+
   public:
     typedef FPCParams Params;
     FPC(const Params &p);
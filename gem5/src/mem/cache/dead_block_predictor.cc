@@ -0,0 +1,211 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definition of a sampling dead block predictor.
+ */
+
+#include "mem/cache/dead_block_predictor.hh"
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/Cache.hh"
+
+namespace gem5
+{
+
+DeadBlockPredictor::DeadBlockPredictor(const Params &p)
+    : SimObject(p), blkShift(floorLog2(p.block_size)),
+      samplingShift(floorLog2(p.sampling_ratio)),
+      samplerSets(p.sampler_sets), samplerAssoc(p.sampler_assoc),
+      sampler(p.sampler_sets * p.sampler_assoc), samplerUses(0),
+      tables(p.num_tables, std::vector<SatCounter8>(
+          p.table_entries, SatCounter8(p.counter_bits))),
+      threshold(p.threshold), bypassed(p.bypass_history, MaxAddr),
+      bypassedHead(0), stats(*this)
+{
+    fatal_if(!isPowerOf2(p.sampling_ratio),
+             "%s: the sampling ratio must be a power of 2", name());
+    fatal_if(!isPowerOf2(p.table_entries),
+             "%s: the number of table entries must be a power of 2",
+             name());
+    fatal_if(samplerSets == 0 || samplerAssoc == 0 || p.num_tables == 0,
+             "%s: the sampler and the tables cannot be empty", name());
+    fatal_if(p.bypass_history == 0,
+             "%s: the bypass history cannot be empty", name());
+}
+
+uint32_t
+DeadBlockPredictor::signature(Addr pc)
+{
+    return ((pc >> 2) ^ (pc >> 17)) & mask(15);
+}
+
+size_t
+DeadBlockPredictor::index(uint32_t signature, unsigned table) const
+{
+    // Skewed hashes, so that signatures aliasing in a table rarely alias
+    // in the others too
+    const uint64_t hash = (signature + table) * 0x9e3779b97f4a7c15ULL;
+    return (hash >> (32 + 4 * table)) & (tables[table].size() - 1);
+}
+
+void
+DeadBlockPredictor::train(uint32_t signature, bool dead)
+{
+    for (unsigned t = 0; t < tables.size(); t++) {
+        SatCounter8 &counter = tables[t][index(signature, t)];
+        if (dead)
+            counter++;
+        else
+            counter--;
+    }
+}
+
+bool
+DeadBlockPredictor::isDead(uint32_t signature) const
+{
+    unsigned sum = 0;
+    for (unsigned t = 0; t < tables.size(); t++)
+        sum += tables[t][index(signature, t)];
+    return sum >= threshold;
+}
+
+void
+DeadBlockPredictor::checkBypassed(Addr blk_num)
+{
+    auto it = bypassedCount.find(blk_num);
+    if (it == bypassedCount.end())
+        return;
+
+    // Count a bypass reused once, however many times it was bypassed
+    stats.bypassesReused++;
+    const unsigned count = it->second;
+    bypassedCount.erase(it);
+    for (unsigned i = 0, left = count; left && i < bypassed.size(); i++) {
+        if (bypassed[i] == blk_num) {
+            bypassed[i] = MaxAddr;
+            left--;
+        }
+    }
+}
+
+void
+DeadBlockPredictor::access(const PacketPtr pkt, bool hit)
+{
+    if (!pkt->req->hasPC())
+        return;
+
+    const Addr blk_num = pkt->getAddr() >> blkShift;
+    if (!hit)
+        checkBypassed(blk_num);
+
+    if (blk_num & mask(samplingShift))
+        return;
+
+    const Addr sampled = blk_num >> samplingShift;
+    const unsigned set = sampled % samplerSets;
+    const Addr tag = sampled / samplerSets;
+    const uint32_t sig = signature(pkt->req->getPC());
+
+    SamplerEntry *victim = nullptr;
+    for (unsigned way = 0; way < samplerAssoc; way++) {
+        SamplerEntry &entry = sampler[set * samplerAssoc + way];
+        if (entry.valid && entry.tag == tag) {
+            // The last access to the block was not the last one after all
+            stats.samplerHits++;
+            train(entry.signature, false);
+            entry.signature = sig;
+            entry.lastUse = ++samplerUses;
+            return;
+        }
+        if (!victim || (victim->valid &&
+                        (!entry.valid || entry.lastUse < victim->lastUse))) {
+            victim = &entry;
+        }
+    }
+
+    // The block evicted was last touched by the access of its signature
+    if (victim->valid) {
+        stats.samplerEvictions++;
+        train(victim->signature, true);
+    }
+    victim->valid = true;
+    victim->tag = tag;
+    victim->signature = sig;
+    victim->lastUse = ++samplerUses;
+}
+
+bool
+DeadBlockPredictor::bypass(const PacketPtr pkt)
+{
+    if (!pkt->req->hasPC())
+        return false;
+
+    stats.predictions++;
+    if (!isDead(signature(pkt->req->getPC())))
+        return false;
+
+    stats.bypasses++;
+    const Addr blk_num = pkt->getAddr() >> blkShift;
+    DPRINTF(Cache, "%s: bypassing %#x, predicted dead by PC %#x\n",
+            __func__, pkt->getAddr(), pkt->req->getPC());
+
+    // Remember the bypass, forgetting the oldest one
+    Addr &slot = bypassed[bypassedHead];
+    if (slot != MaxAddr) {
+        auto it = bypassedCount.find(slot);
+        if (it != bypassedCount.end() && --it->second == 0)
+            bypassedCount.erase(it);
+    }
+    slot = blk_num;
+    bypassedCount[blk_num]++;
+    bypassedHead = (bypassedHead + 1) % bypassed.size();
+    return true;
+}
+
+DeadBlockPredictor::DeadBlockPredictorStats::DeadBlockPredictorStats(
+    DeadBlockPredictor &predictor)
+    : statistics::Group(&predictor),
+      ADD_STAT(samplerHits, statistics::units::Count::get(),
+               "Number of sampler accesses which hit"),
+      ADD_STAT(samplerEvictions, statistics::units::Count::get(),
+               "Number of sampler accesses which evicted an entry"),
+      ADD_STAT(predictions, statistics::units::Count::get(),
+               "Number of fills predicted"),
+      ADD_STAT(bypasses, statistics::units::Count::get(),
+               "Number of fills predicted dead and not allocated"),
+      ADD_STAT(bypassesReused, statistics::units::Count::get(),
+               "Number of bypassed blocks missed on again while among the "
+               "bypasses remembered"),
+      ADD_STAT(accuracy, statistics::units::Ratio::get(),
+               "Fraction of the bypassed blocks not missed on again",
+               (bypasses - bypassesReused) / bypasses)
+{
+}
+
+} // namespace gem5
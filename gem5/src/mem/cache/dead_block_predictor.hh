@@ -0,0 +1,159 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a sampling dead block predictor.
+ */
+
+#ifndef __MEM_CACHE_DEAD_BLOCK_PREDICTOR_HH__
+#define __MEM_CACHE_DEAD_BLOCK_PREDICTOR_HH__
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "base/sat_counter.hh"
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "mem/packet.hh"
+#include "params/DeadBlockPredictor.hh"
+#include "sim/sim_object.hh"
+
+namespace gem5
+{
+
+/**
+ * Sampling dead block predictor (SDBP), Khan, Tian and Jimenez, MICRO
+ * 2010. A block is predicted dead on arrival when the PC of the access
+ * which missed on it tends to be the last one to touch its blocks, and
+ * the cache then fills it without allocating it.
+ *
+ * A sampler keeps partial LRU tags of a few sets, each with the
+ * signature of the PC of its last access. A sampler hit shows that the
+ * previous access was not the last one, and trains its signature live; a
+ * sampler eviction shows that it was, and trains its signature dead. The
+ * training goes to a few skewed tables of saturating counters, and a
+ * signature is dead if the sum of its counters reaches a threshold.
+ *
+ * The sampled sets are picked from the block address, so that they map
+ * to whole sets of a cache with conventional indexing.
+ */
+class DeadBlockPredictor : public SimObject
+{
+  private:
+    /** Number of bits of the block offset. */
+    const unsigned blkShift;
+
+    /** One block address set in that many is sampled, log2. */
+    const unsigned samplingShift;
+
+    const unsigned samplerSets;
+    const unsigned samplerAssoc;
+
+    /** An entry of the sampler. */
+    struct SamplerEntry
+    {
+        bool valid = false;
+        Addr tag = 0;
+        /** Signature of the last access */
+        uint32_t signature = 0;
+        /** Last access, for LRU replacement */
+        uint64_t lastUse = 0;
+    };
+
+    std::vector<SamplerEntry> sampler;
+
+    /** Accesses of the sampler, to order its entries. */
+    uint64_t samplerUses;
+
+    /** The prediction tables. */
+    std::vector<std::vector<SatCounter8>> tables;
+
+    /** Sum of the counters of a dead signature. */
+    const unsigned threshold;
+
+    /**
+     * The blocks bypassed last, as a ring, with the number of times each
+     * is in it, to spot the bypassed blocks missed on again.
+     */
+    std::vector<Addr> bypassed;
+    unsigned bypassedHead;
+    std::unordered_map<Addr, unsigned> bypassedCount;
+
+    /** Signature of a PC. */
+    static uint32_t signature(Addr pc);
+
+    /** Index of a signature in a table. */
+    size_t index(uint32_t signature, unsigned table) const;
+
+    /** Train a signature towards dead or live. */
+    void train(uint32_t signature, bool dead);
+
+    /** Whether a signature is predicted dead. */
+    bool isDead(uint32_t signature) const;
+
+    /** Look a miss up among the blocks bypassed last. */
+    void checkBypassed(Addr blk_num);
+
+    struct DeadBlockPredictorStats : public statistics::Group
+    {
+        DeadBlockPredictorStats(DeadBlockPredictor &predictor);
+
+        /** Sampler accesses which hit */
+        statistics::Scalar samplerHits;
+        /** Sampler accesses which evicted a valid entry */
+        statistics::Scalar samplerEvictions;
+        /** Fills predicted */
+        statistics::Scalar predictions;
+        /** Fills predicted dead, hence not allocated */
+        statistics::Scalar bypasses;
+        /** Misses on a block bypassed recently */
+        statistics::Scalar bypassesReused;
+        statistics::Formula accuracy;
+    } stats;
+
+  public:
+    PARAMS(DeadBlockPredictor);
+    DeadBlockPredictor(const Params &p);
+
+    /**
+     * Observe an access of the cache, to train on the sampled sets.
+     * @param pkt The access
+     * @param hit Whether the access hit in the cache
+     */
+    void access(const PacketPtr pkt, bool hit);
+
+    /**
+     * Predict whether the block of a fill is dead on arrival.
+     * @param pkt The fill
+     * @return Whether the fill should not allocate a block
+     */
+    bool bypass(const PacketPtr pkt);
+};
+
+} // namespace gem5
+
+#endif // __MEM_CACHE_DEAD_BLOCK_PREDICTOR_HH__
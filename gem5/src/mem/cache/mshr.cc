@@ -259,6 +259,18 @@ MSHR::TargetList::clearDownstreamPending()
 }
 
 
+void
+MSHR::TargetList::append(MSHR::TargetList &other,
+                         MSHR::TargetList::iterator begin,
+                         MSHR::TargetList::iterator end)
+{
+    assert(&other != this);
+    for (auto t = begin; t != end; t++) {
+        push_back(std::move(*t));
+    }
+    other.erase(begin, end);
+}
+
 bool
 MSHR::TargetList::trySatisfyFunctional(PacketPtr pkt)
 {
@@ -495,7 +507,7 @@ MSHR::handleSnoop(PacketPtr pkt, Counter _order)
         // the packet and the request as part of handling the deferred
         // snoop.
         PacketPtr cp_pkt = will_respond ? new Packet(pkt, true, true) :
-            new Packet(std::make_shared<Request>(*pkt->req), pkt->cmd,
+            new Packet(makeRequest(*pkt->req), pkt->cmd,
                        blkSize, pkt->id);
 
         if (will_respond) {
@@ -570,7 +582,7 @@ MSHR::extractServiceableTargets(PacketPtr pkt)
         }
         ready_targets.populateFlags();
     } else {
-        std::swap(ready_targets, targets);
+        ready_targets.swap(targets);
     }
     targets.populateFlags();
 
@@ -598,14 +610,13 @@ MSHR::promoteDeferredTargets()
         // then we can promote provided the targets list is empty and
         // we can service it on its own
         if (targets.empty()) {
-            targets.splice(targets.end(), deferredTargets, it);
+            targets.append(deferredTargets, it, it + 1);
         }
     } else {
         // if a cache maintenance operation exists, we promote all the
         // deferred targets that precede it, or all deferred targets
         // otherwise
-        targets.splice(targets.end(), deferredTargets,
-                       deferredTargets.begin(), it);
+        targets.append(deferredTargets, deferredTargets.begin(), it);
     }
 
     deferredTargets.populateFlags();
@@ -632,8 +643,7 @@ MSHR::promoteIf(const std::function<bool (Target &)>& pred)
     // the downstreamPending flag and move them to the target list
     deferredTargets.clearDownstreamPending(deferredTargets.begin(),
                                            last_it);
-    targets.splice(targets.end(), deferredTargets,
-                   deferredTargets.begin(), last_it);
+    targets.append(deferredTargets, deferredTargets.begin(), last_it);
     // We need to update the flags for the target lists after the
     // modifications
     deferredTargets.populateFlags();
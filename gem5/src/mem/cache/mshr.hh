@@ -52,6 +52,7 @@
 #include <string>
 #include <vector>
 
+#include "base/inline_vector.hh"
 #include "base/printable.hh"
 #include "base/trace.hh"
 #include "base/types.hh"
@@ -166,7 +167,11 @@ class MSHR : public QueueEntry, public Printable
         {}
     };
 
-    class TargetList : public std::list<Target>, public Named
+    /**
+     * The targets of an MSHR. A handful of targets is stored inline, so
+     * that the common case does not allocate.
+     */
+    class TargetList : public InlineVector<Target, 4>, public Named
     {
 
       public:
@@ -268,6 +273,17 @@ class MSHR : public QueueEntry, public Printable
 
         void clearDownstreamPending();
         void clearDownstreamPending(iterator begin, iterator end);
+
+        /**
+         * Move a range of targets from another list to the end of this
+         * one, preserving their order.
+         *
+         * @param other The list to take the targets from.
+         * @param begin The first target to move.
+         * @param end The target following the last one to move.
+         */
+        void append(TargetList &other, iterator begin, iterator end);
+
         bool trySatisfyFunctional(PacketPtr pkt);
         void print(std::ostream &os, int verbosity,
                    const std::string &prefix) const;
@@ -450,6 +466,18 @@ class MSHR : public QueueEntry, public Printable
      */
     bool hasTargets() const { return !targets.empty(); }
 
+    /**
+     * Check if this MSHR was allocated for a prefetch of the cache's own
+     * prefetcher, i.e., if its first target comes from the prefetcher.
+     * @return true if the MSHR is fetching a hardware prefetch
+     */
+    bool
+    isHWPrefetch() const
+    {
+        return hasTargets() &&
+            targets.front().source == Target::FromPrefetcher;
+    }
+
     /**
      * Returns a reference to the first target.
      * @return A pointer to the first target.
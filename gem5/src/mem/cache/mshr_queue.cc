@@ -72,7 +72,7 @@ MSHRQueue::allocate(Addr blk_addr, unsigned blk_size, PacketPtr pkt,
             allocatedList.size() + 1, numEntries);
 
     mshr->allocate(blk_addr, blk_size, pkt, when_ready, order, alloc_on_fill);
-    mshr->allocIter = allocatedList.insert(allocatedList.end(), mshr);
+    mshr->allocIter = addToAllocatedList(mshr);
     mshr->readyIter = addToReadyList(mshr);
 
     allocated += 1;
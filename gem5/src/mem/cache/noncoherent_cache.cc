@@ -160,7 +160,12 @@ NoncoherentCache::createMissPacket(PacketPtr cpu_pkt, CacheBlk *blk,
     // the packet should be block aligned
     assert(pkt->getAddr() == pkt->getBlockAddr(blkSize));
 
-    pkt->allocate();
+    // with a shared buffer the fill can take over the response data
+    if (shareLineBuffers) {
+        pkt->allocateShared();
+    } else {
+        pkt->allocate();
+    }
     DPRINTF(Cache, "%s created %s from %s\n", __func__, pkt->print(),
             cpu_pkt->print());
     return pkt;
@@ -194,7 +199,8 @@ NoncoherentCache::handleAtomicReqMiss(PacketPtr pkt, CacheBlk *&blk,
         // afterall it is a read response
         DPRINTF(Cache, "Block for addr %#llx being updated in Cache\n",
                 bus_pkt->getAddr());
-        blk = handleFill(bus_pkt, blk, writebacks, allocOnFill(bus_pkt->cmd));
+        blk = handleFill(bus_pkt, blk, writebacks,
+                         allocateFill(bus_pkt, allocOnFill(bus_pkt->cmd)));
         assert(blk);
     }
     satisfyRequest(pkt, blk);
@@ -293,7 +299,8 @@ NoncoherentCache::serviceMSHRTargets(MSHR *mshr, const PacketPtr pkt,
             assert(tgt_pkt->cmd == MemCmd::HardPFReq);
 
             if (blk)
-                blk->setPrefetched();
+                blk->setPrefetched(tgt_pkt->req->hasPC() ?
+                                   tgt_pkt->req->getPC() : MaxAddr);
 
             // We have filled the block and the prefetcher does not
             // require responses.
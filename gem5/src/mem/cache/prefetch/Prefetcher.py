@@ -40,6 +40,7 @@ from m5.SimObject import *
 from m5.params import *
 from m5.proxy import *
 
+from m5.objects.BloomFilters import BloomFilterMultiBitSel
 from m5.objects.ClockedObject import ClockedObject
 from m5.objects.IndexingPolicies import *
 from m5.objects.ReplacementPolicies import *
@@ -83,6 +84,14 @@ class BasePrefetcher(ClockedObject):
         "Use virtual addresses for prefetching")
     page_bytes = Param.MemorySize('4KiB',
             "Size of pages for virtual addresses")
+    per_pc_stats = Param.Bool(False,
+        "Record the prefetch statistics of each triggering PC")
+    pollution_filter_entries = Param.Unsigned(4096,
+        "Entries of the filter of blocks evicted by prefetches, used to "
+        "detect cache pollution (0 to disable)")
+    feedback_interval = Param.Unsigned(0,
+        "Prefetches issued between two rounds of feedback on accuracy, "
+        "lateness and pollution (0 to disable)")
 
     def __init__(self, **kwargs):
         super().__init__(**kwargs)
@@ -129,6 +138,11 @@ class QueuedPrefetcher(BasePrefetcher):
     queue_size = Param.Int(32, "Maximum number of queued prefetches")
     max_prefetch_requests_with_pending_translation = Param.Int(32,
         "Maximum number of queued prefetches that have a missing translation")
+    translation_cache_entries = Param.Unsigned(16, "Number of page "
+        "translations the prefetcher keeps, 0 to always ask the MMU")
+    max_outstanding_translations = Param.Unsigned(4, "Maximum number of "
+        "pages being translated at once; the other prefetches to a page "
+        "wait for its translation")
     queue_squash = Param.Bool(True, "Squash queued prefetch on demand access")
     queue_filter = Param.Bool(True, "Don't queue redundant prefetches")
     cache_snoop = Param.Bool(False, "Snoop cache to eliminate redundant request")
@@ -146,6 +160,40 @@ class QueuedPrefetcher(BasePrefetcher):
     #   remaining 60% will be generated depending on the current accuracy
     throttle_control_percentage = Param.Percent(0, "Percentage of requests \
         that can be throttled depending on the accuracy of the prefetcher.")
+    feedback_max_degree = Param.Unsigned(16, "Maximum number of prefetches \
+        per access when throttling on feedback (see feedback_interval)")
+
+    coordinator = Param.PrefetchCoordinator(NULL,
+        "Coordinator shared with the prefetchers of the other cache levels")
+    coordinator_level = Param.Unsigned(1, "Cache level of the prefetcher "
+        "for the coordinator, 1 being the closest to the CPU")
+
+class PrefetchCoordinator(SimObject):
+    type = 'PrefetchCoordinator'
+    cxx_class = 'gem5::prefetch::Coordinator'
+    cxx_header = "mem/cache/prefetch/coordinator.hh"
+
+    filter = Param.BloomFilterBase(
+        BloomFilterMultiBitSel(size = 4096, num_hashes = 2),
+        "Filter of the lines recently prefetched by any level")
+    filter_window = Param.Unsigned(2048,
+        "Number of prefetches after which the filter is cleared")
+    hint_priority = Param.Int(1, "Lowest priority of the candidates a "
+        "level pushes into the upper level cache instead of its own")
+
+    mem_ctrls = VectorParam.MemCtrl([], "Memory controllers whose "
+        "bandwidth utilization sets the prefetch budget (none for no "
+        "budget)")
+    sample_period = Param.Latency("1us",
+        "Period of the bandwidth samples and of the budget")
+    high_utilization = Param.Percent(75,
+        "Bandwidth utilization above which the budget halves")
+    low_utilization = Param.Percent(50,
+        "Bandwidth utilization below which the budget doubles")
+    max_budget = Param.Unsigned(512,
+        "Largest number of prefetches of all the levels per sample period")
+    min_budget = Param.Unsigned(8,
+        "Smallest number of prefetches of all the levels per sample period")
 
 class StridePrefetcherHashedSetAssociative(SetAssociative):
     type = 'StridePrefetcherHashedSetAssociative'
@@ -156,6 +204,9 @@ class StridePrefetcher(QueuedPrefetcher):
     type = 'StridePrefetcher'
     cxx_class = 'gem5::prefetch::Stride'
     cxx_header = "mem/cache/prefetch/stride.hh"
+    cxx_exports = [
+        PyBindMethod("setDegree"),
+    ]
 
     # Do not consult stride prefetcher on instruction accesses
     on_inst = False
@@ -170,6 +221,9 @@ class StridePrefetcher(QueuedPrefetcher):
     use_requestor_id = Param.Bool(True, "Use requestor id based history")
 
     degree = Param.Int(4, "Number of prefetches to generate")
+    adaptive = Param.Bool(False, "Adapt the prefetch degree and distance to "
+        "the prefetch accuracy, lateness and pollution (needs a "
+        "feedback_interval)")
 
     table_assoc = Param.Int(4, "Associativity of the PC table")
     table_entries = Param.MemorySize("64", "Number of entries of the PC table")
@@ -186,6 +240,9 @@ class TaggedPrefetcher(QueuedPrefetcher):
     cxx_header = "mem/cache/prefetch/tagged.hh"
 
     degree = Param.Int(2, "Number of prefetches to generate")
+    adaptive = Param.Bool(False, "Adapt the prefetch degree and distance to "
+        "the prefetch accuracy, lateness and pollution (needs a "
+        "feedback_interval)")
 
 class IndirectMemoryPrefetcher(QueuedPrefetcher):
     type = 'IndirectMemoryPrefetcher'
@@ -359,6 +416,37 @@ class DCPTPrefetcher(QueuedPrefetcher):
         DeltaCorrelatingPredictionTables(),
         "Delta Correlating Prediction Tables object")
 
+class BertiPrefetcher(QueuedPrefetcher):
+    type = 'BertiPrefetcher'
+    cxx_class = 'gem5::prefetch::Berti'
+    cxx_header = "mem/cache/prefetch/berti.hh"
+
+    # Do not consult the prefetcher on instruction accesses
+    on_inst = False
+
+    history_length = Param.Unsigned(8,
+        "Number of accesses remembered per PC")
+    deltas_per_entry = Param.Unsigned(8, "Number of deltas learnt per PC")
+    max_delta = Param.Unsigned(64, "Largest delta learnt, in blocks")
+    learning_period = Param.Unsigned(16,
+        "Number of fills of a PC between two classifications of its deltas")
+    high_coverage = Param.Percent(65,
+        "Fraction of the fills a delta must cover to be prefetched at high "
+        "priority")
+    low_coverage = Param.Percent(35,
+        "Fraction of the fills a delta must cover to be prefetched at low "
+        "priority")
+    degree = Param.Unsigned(4, "Maximum number of prefetches per access")
+
+    table_assoc = Param.Unsigned(4, "Associativity of the PC table")
+    table_entries = Param.MemorySize("64", "Number of entries of the PC table")
+    table_indexing_policy = Param.BaseIndexingPolicy(
+        SetAssociative(entry_size = 1, assoc = Parent.table_assoc,
+        size = Parent.table_entries),
+        "Indexing policy of the PC table")
+    table_replacement_policy = Param.BaseReplacementPolicy(LRURP(),
+        "Replacement policy of the PC table")
+
 class IrregularStreamBufferPrefetcher(QueuedPrefetcher):
     type = "IrregularStreamBufferPrefetcher"
     cxx_class = 'gem5::prefetch::IrregularStreamBuffer'
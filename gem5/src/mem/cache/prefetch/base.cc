@@ -102,6 +102,9 @@ Base::Base(const BasePrefetcherParams &p)
       prefetchOnAccess(p.prefetch_on_access),
       prefetchOnPfHit(p.prefetch_on_pf_hit),
       useVirtualAddresses(p.use_virtual_addresses),
+      perPCStats(p.per_pc_stats),
+      pollutionFilter(p.pollution_filter_entries, false),
+      feedbackInterval(p.feedback_interval),
       prefetchStats(this), issuedPrefetches(0),
       usefulPrefetches(0), tlb(nullptr)
 {
@@ -142,7 +145,21 @@ Base::StatGroup::StatGroup(statistics::Group *parent)
     ADD_STAT(pfHitInWB, statistics::units::Count::get(),
         "number of prefetches hit in the Write Buffer"),
     ADD_STAT(pfLate, statistics::units::Count::get(),
-        "number of late prefetches (hitting in cache, MSHR or WB)")
+        "number of late prefetches (hitting in cache, MSHR or WB)"),
+    ADD_STAT(pfUsefulLate, statistics::units::Count::get(),
+        "number of demands hitting on the MSHR of an in-flight prefetch"),
+    ADD_STAT(pfPollution, statistics::units::Count::get(),
+        "number of demand misses on blocks evicted by prefetch fills"),
+    ADD_STAT(timeliness, statistics::units::Ratio::get(),
+        "fraction of the useful prefetches which arrived in time"),
+    ADD_STAT(pfIssuedPerPC, statistics::units::Count::get(),
+        "number of hwpf issued, per triggering PC"),
+    ADD_STAT(pfUsefulPerPC, statistics::units::Count::get(),
+        "number of useful prefetches, per triggering PC"),
+    ADD_STAT(pfUsefulLatePerPC, statistics::units::Count::get(),
+        "number of late useful prefetches, per triggering PC"),
+    ADD_STAT(pfUnusedPerPC, statistics::units::Count::get(),
+        "number of HardPF blocks evicted w/o reference, per triggering PC")
 {
     using namespace statistics;
 
@@ -155,6 +172,14 @@ Base::StatGroup::StatGroup(statistics::Group *parent)
     coverage = pfUseful / (pfUseful + demandMshrMisses);
 
     pfLate = pfHitInCache + pfHitInMSHR + pfHitInWB;
+
+    timeliness.flags(total);
+    timeliness = pfUseful / (pfUseful + pfUsefulLate);
+
+    pfIssuedPerPC.init(0).flags(nozero);
+    pfUsefulPerPC.init(0).flags(nozero);
+    pfUsefulLatePerPC.init(0).flags(nozero);
+    pfUnusedPerPC.init(0).flags(nozero);
 }
 
 bool
@@ -254,6 +279,12 @@ Base::probeNotify(const PacketPtr &pkt, bool miss)
     if (hasBeenPrefetched(pkt->getAddr(), pkt->isSecure())) {
         usefulPrefetches += 1;
         prefetchStats.pfUseful++;
+        feedback.useful++;
+        if (perPCStats) {
+            Addr pf_pc = cache->prefetchPC(pkt->getAddr(), pkt->isSecure());
+            if (pf_pc != MaxAddr)
+                prefetchStats.pfUsefulPerPC.sample(pf_pc);
+        }
         if (miss)
             // This case happens when a demand hits on a prefetched line
             // that's not in the requested coherency state.
@@ -272,6 +303,70 @@ Base::probeNotify(const PacketPtr &pkt, bool miss)
     }
 }
 
+void
+Base::prefetchIssued(const PacketPtr &pkt)
+{
+    prefetchStats.pfIssued++;
+    issuedPrefetches += 1;
+    if (perPCStats && pkt->req->hasPC())
+        prefetchStats.pfIssuedPerPC.sample(pkt->req->getPC());
+
+    if (feedbackInterval && ++feedback.issued >= feedbackInterval) {
+        processFeedback(feedback);
+        feedback = Feedback();
+    }
+}
+
+void
+Base::prefetchUnused(Addr pc)
+{
+    prefetchStats.pfUnused++;
+    feedback.unused++;
+    if (perPCStats && pc != MaxAddr)
+        prefetchStats.pfUnusedPerPC.sample(pc);
+}
+
+void
+Base::pfUsefulLate(const PacketPtr &pf_pkt)
+{
+    prefetchStats.pfUsefulLate++;
+    feedback.late++;
+    if (perPCStats && pf_pkt->req->hasPC())
+        prefetchStats.pfUsefulLatePerPC.sample(pf_pkt->req->getPC());
+}
+
+size_t
+Base::pollutionIndex(Addr addr, bool is_secure) const
+{
+    // Fibonacci hashing of the block number spreads strided blocks
+    // across the filter
+    uint64_t key = (blockIndex(addr) << 1) | is_secure;
+    return (key * 0x9e3779b97f4a7c15ULL >> 32) % pollutionFilter.size();
+}
+
+void
+Base::prefetchEviction(Addr addr, bool is_secure)
+{
+    if (!pollutionFilter.empty())
+        pollutionFilter[pollutionIndex(addr, is_secure)] = true;
+}
+
+void
+Base::incrDemandMhsrMisses(const PacketPtr &pkt)
+{
+    prefetchStats.demandMshrMisses++;
+    feedback.demandMisses++;
+
+    if (!pollutionFilter.empty()) {
+        size_t idx = pollutionIndex(pkt->getAddr(), pkt->isSecure());
+        if (pollutionFilter[idx]) {
+            prefetchStats.pfPollution++;
+            feedback.pollution++;
+            pollutionFilter[idx] = false;
+        }
+    }
+}
+
 void
 Base::regProbeListeners()
 {
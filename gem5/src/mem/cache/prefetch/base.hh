@@ -47,6 +47,7 @@
 #define __MEM_CACHE_PREFETCH_BASE_HH__
 
 #include <cstdint>
+#include <vector>
 
 #include "arch/generic/tlb.hh"
 #include "base/compiler.hh"
@@ -301,6 +302,50 @@ class Base : public ClockedObject
     /** Use Virtual Addresses for prefetching */
     const bool useVirtualAddresses;
 
+    /** Record the prefetch statistics of each triggering PC */
+    const bool perPCStats;
+
+    /**
+     * Filter of the blocks evicted by prefetch fills. A demand miss on a
+     * block marked here counts as cache pollution caused by the
+     * prefetcher.
+     */
+    std::vector<bool> pollutionFilter;
+
+    /** Number of prefetches issued between two feedback rounds */
+    const unsigned feedbackInterval;
+
+    /** Prefetch outcomes observed during a feedback interval. */
+    struct Feedback
+    {
+        /** Prefetches issued */
+        uint64_t issued = 0;
+        /** Prefetched blocks accessed by a demand */
+        uint64_t useful = 0;
+        /** Demands which found their prefetch still in flight */
+        uint64_t late = 0;
+        /** Prefetched blocks evicted without being accessed */
+        uint64_t unused = 0;
+        /** Demand misses on blocks evicted by prefetch fills */
+        uint64_t pollution = 0;
+        /** Demand misses which could not wait for any MSHR */
+        uint64_t demandMisses = 0;
+    };
+
+    /** The outcomes observed since the last feedback round */
+    Feedback feedback;
+
+    /**
+     * Hook called every feedbackInterval issued prefetches with the
+     * outcomes observed during the interval. Prefetchers can use it to
+     * adapt their aggressiveness.
+     * @param fb The prefetch outcomes of the interval
+     */
+    virtual void processFeedback(const Feedback &fb) {}
+
+    /** Index of the pollution filter entry tracking an address */
+    size_t pollutionIndex(Addr addr, bool is_secure) const;
+
     /**
      * Determine if this access should be observed
      * @param pkt The memory request causing the event
@@ -357,6 +402,22 @@ class Base : public ClockedObject
         /** The number of times a HW-prefetch is late
          * (hit in cache, MSHR, WB). */
         statistics::Formula pfLate;
+
+        /** The number of times a demand hits on an MSHR which is still
+         * fetching a HW-prefetch. */
+        statistics::Scalar pfUsefulLate;
+        /** The number of demand misses on blocks evicted by HW-prefetch
+         * fills. */
+        statistics::Scalar pfPollution;
+        statistics::Formula timeliness;
+
+        /** Per-PC counts of the PC triggering each prefetch, only
+         * sampled with per_pc_stats. @{ */
+        statistics::SparseHistogram pfIssuedPerPC;
+        statistics::SparseHistogram pfUsefulPerPC;
+        statistics::SparseHistogram pfUsefulLatePerPC;
+        statistics::SparseHistogram pfUnusedPerPC;
+        /** @} */
     } prefetchStats;
 
     /** Total prefetches issued */
@@ -387,17 +448,35 @@ class Base : public ClockedObject
 
     virtual Tick nextPrefetchReadyTime() const = 0;
 
-    void
-    prefetchUnused()
-    {
-        prefetchStats.pfUnused++;
-    }
+    /**
+     * Account for a prefetch handed to the cache.
+     * @param pkt The prefetch packet
+     */
+    void prefetchIssued(const PacketPtr &pkt);
 
-    void
-    incrDemandMhsrMisses()
-    {
-        prefetchStats.demandMshrMisses++;
-    }
+    /**
+     * A prefetched block has been evicted without being accessed.
+     * @param pc PC which triggered the prefetch, MaxAddr if unknown
+     */
+    void prefetchUnused(Addr pc);
+
+    /**
+     * A demand has hit on the MSHR of a prefetch which is still in flight.
+     * @param pf_pkt The prefetch packet
+     */
+    void pfUsefulLate(const PacketPtr &pf_pkt);
+
+    /**
+     * A block which was not prefetched has been evicted to make room for
+     * a prefetch.
+     */
+    void prefetchEviction(Addr addr, bool is_secure);
+
+    /**
+     * A demand has missed and could not be merged with any MSHR.
+     * @param pkt The demand packet
+     */
+    void incrDemandMhsrMisses(const PacketPtr &pkt);
 
     void
     pfHitInCache()
@@ -0,0 +1,269 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/prefetch/berti.hh"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/HWPrefetch.hh"
+#include "mem/cache/prefetch/associative_set_impl.hh"
+#include "params/BertiPrefetcher.hh"
+
+namespace gem5
+{
+
+GEM5_DEPRECATED_NAMESPACE(Prefetcher, prefetch);
+namespace prefetch
+{
+
+Berti::BertiEntry::BertiEntry(unsigned history_length, unsigned num_deltas)
+  : TaggedEntry(), history(history_length), deltas(num_deltas)
+{
+    invalidate();
+}
+
+void
+Berti::BertiEntry::invalidate()
+{
+    TaggedEntry::invalidate();
+    std::fill(history.begin(), history.end(), Access());
+    head = 0;
+    numAccesses = 0;
+    std::fill(deltas.begin(), deltas.end(), Delta());
+    searches = 0;
+}
+
+void
+Berti::BertiEntry::addAccess(Addr blk, Tick tick)
+{
+    // Repeated accesses to a block would only crowd the history out
+    if (numAccesses > 0) {
+        const unsigned last = (head + history.size() - 1) % history.size();
+        if (history[last].blk == blk)
+            return;
+    }
+
+    history[head].blk = blk;
+    history[head].tick = tick;
+    head = (head + 1) % history.size();
+    if (numAccesses < history.size())
+        numAccesses++;
+}
+
+bool
+Berti::BertiEntry::addCoverage(int delta)
+{
+    Delta *victim = nullptr;
+    for (auto &d : deltas) {
+        if (d.delta == delta) {
+            if (d.search == searches)
+                return false;
+            d.coverage++;
+            d.search = searches;
+            return true;
+        }
+        // Free slots have no coverage and no class, so they go first
+        if (!victim || d.coverage < victim->coverage ||
+            (d.coverage == victim->coverage && d.cls < victim->cls)) {
+            victim = &d;
+        }
+    }
+
+    victim->delta = delta;
+    victim->coverage = 1;
+    victim->cls = DeltaClass::None;
+    victim->search = searches;
+    return true;
+}
+
+void
+Berti::BertiEntry::classify(unsigned high_threshold, unsigned low_threshold)
+{
+    for (auto &d : deltas) {
+        const unsigned percent = d.coverage * 100;
+        if (percent >= high_threshold * searches) {
+            d.cls = DeltaClass::High;
+        } else if (percent >= low_threshold * searches) {
+            d.cls = DeltaClass::Low;
+        } else {
+            d.cls = DeltaClass::None;
+        }
+        d.coverage = 0;
+        d.search = 0;
+    }
+    searches = 0;
+}
+
+Berti::Berti(const BertiPrefetcherParams &p)
+  : Queued(p), historyLength(p.history_length),
+    deltasPerEntry(p.deltas_per_entry), maxDelta(p.max_delta),
+    learningPeriod(p.learning_period), highCoverage(p.high_coverage),
+    lowCoverage(p.low_coverage), degree(p.degree),
+    table(p.table_assoc, p.table_entries, p.table_indexing_policy,
+          p.table_replacement_policy,
+          BertiEntry(p.history_length, p.deltas_per_entry)),
+    bertiStats(this)
+{
+    fatal_if(historyLength == 0 || deltasPerEntry == 0,
+             "%s: the history and the deltas of a PC cannot be empty\n",
+             name());
+    fatal_if(learningPeriod == 0, "%s: the learning period must be at "
+             "least one fill\n", name());
+    fatal_if(lowCoverage > highCoverage, "%s: the low coverage threshold "
+             "is above the high coverage threshold\n", name());
+}
+
+void
+Berti::notifyFill(const PacketPtr &pkt)
+{
+    // Only the demands tell how early a prefetch has to be issued, and
+    // the fills of prefetches have no PC to learn for
+    if (pkt->cmd.isHWPrefetch() || !pkt->req->hasPC())
+        return;
+
+    Addr addr;
+    if (useVirtualAddresses) {
+        if (!pkt->req->hasVaddr())
+            return;
+        addr = pkt->req->getVaddr();
+    } else {
+        addr = pkt->getAddr();
+    }
+
+    BertiEntry *entry = table.findEntry(pkt->req->getPC(), pkt->isSecure());
+    if (entry == nullptr)
+        return;
+
+    // The request was created when the demand was issued, which is also
+    // when the miss was recorded in the history of its PC
+    const Tick demand_tick = pkt->req->time();
+    const Tick latency = curTick() - demand_tick;
+    bertiStats.trainingFills++;
+    bertiStats.fillLatency += latency;
+
+    // A prefetch triggered by an earlier access of the PC would have hidden
+    // the miss if the access happened at least one fill latency before it
+    const Addr blk = blockIndex(addr);
+    entry->searches++;
+    bool found = false;
+    for (unsigned i = 0; i < entry->numAccesses; i++) {
+        const Access &access = entry->history[i];
+        if (access.tick + latency > demand_tick)
+            continue;
+
+        const int delta = blk - access.blk;
+        if (delta == 0 || std::abs(delta) > maxDelta)
+            continue;
+
+        if (entry->addCoverage(delta)) {
+            bertiStats.timelyDeltas++;
+            found = true;
+        }
+    }
+    if (!found)
+        bertiStats.noTimelyDelta++;
+
+    DPRINTF(HWPrefetch, "Fill of PC %#x addr %#x after %d ticks: search "
+            "%d of the period %s a timely delta\n", pkt->req->getPC(), addr,
+            latency, entry->searches, found ? "found" : "did not find");
+
+    if (entry->searches == learningPeriod)
+        entry->classify(highCoverage, lowCoverage);
+}
+
+void
+Berti::calculatePrefetch(const PrefetchInfo &pfi,
+                         std::vector<AddrPriority> &addresses)
+{
+    if (!pfi.hasPC()) {
+        DPRINTF(HWPrefetch, "Ignoring request with no PC.\n");
+        return;
+    }
+
+    const Addr pc = pfi.getPC();
+    const bool is_secure = pfi.isSecure();
+    const Addr blk = blockIndex(pfi.getAddr());
+
+    BertiEntry *entry = table.findEntry(pc, is_secure);
+    if (entry != nullptr) {
+        table.accessEntry(entry);
+    } else {
+        entry = table.findVictim(pc);
+        table.insertEntry(pc, is_secure, entry);
+    }
+    entry->addAccess(blk, curTick());
+
+    // The deltas of high coverage go first, and at a higher priority
+    unsigned generated = 0;
+    for (DeltaClass cls : {DeltaClass::High, DeltaClass::Low}) {
+        for (const auto &d : entry->deltas) {
+            if (d.cls != cls)
+                continue;
+            if (generated == degree)
+                return;
+
+            const Addr pf_addr = (blk + d.delta) << lBlkSize;
+            if (cls == DeltaClass::High) {
+                addresses.push_back(AddrPriority(pf_addr, 1));
+                bertiStats.pfHighCoverage++;
+            } else {
+                addresses.push_back(AddrPriority(pf_addr, 0));
+                bertiStats.pfLowCoverage++;
+            }
+            generated++;
+
+            DPRINTF(HWPrefetch, "PC %#x delta %d: queuing prefetch to %#x\n",
+                    pc, d.delta, pf_addr);
+        }
+    }
+}
+
+Berti::BertiStats::BertiStats(statistics::Group *parent)
+  : statistics::Group(parent),
+    ADD_STAT(trainingFills, statistics::units::Count::get(),
+             "number of demand fills searched for timely deltas"),
+    ADD_STAT(fillLatency, statistics::units::Tick::get(),
+             "total latency of the demand fills searched"),
+    ADD_STAT(avgFillLatency, statistics::units::Rate<
+                statistics::units::Tick, statistics::units::Count>::get(),
+             "average latency of the demand fills searched"),
+    ADD_STAT(timelyDeltas, statistics::units::Count::get(),
+             "number of timely deltas found in the PC histories"),
+    ADD_STAT(noTimelyDelta, statistics::units::Count::get(),
+             "number of demand fills with no timely delta in the history "
+             "of their PC"),
+    ADD_STAT(pfHighCoverage, statistics::units::Count::get(),
+             "number of candidates generated from high coverage deltas"),
+    ADD_STAT(pfLowCoverage, statistics::units::Count::get(),
+             "number of candidates generated from low coverage deltas")
+{
+    avgFillLatency = fillLatency / trainingFills;
+}
+
+} // namespace prefetch
+} // namespace gem5
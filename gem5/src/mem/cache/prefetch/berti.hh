@@ -0,0 +1,189 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Berti-style L1D prefetcher: a per-PC local delta prefetcher which learns
+ * the deltas that would have been timely given the observed fill latency.
+ *
+ * References:
+ *   Berti: an Accurate Local-Delta Data Prefetcher.
+ *   Agustin Navarro-Torres, Biswabandan Panda, Jesus Alastruey-Benede,
+ *   Pablo Ibanez, Victor Vinals-Yufera, and Alberto Ros. 2022.
+ *   In Proceedings of the 55th IEEE/ACM International Symposium on
+ *   Microarchitecture (MICRO-55)
+ *
+ * Each PC remembers its last accesses and when they happened. When a demand
+ * miss of a PC is filled, the latency of the fill tells which of the
+ * earlier accesses of the PC happened long enough before the miss for a
+ * prefetch triggered by them to have arrived in time; the deltas to those
+ * accesses are the timely deltas, and their coverage is counted. Every
+ * learning period the deltas are classified by coverage, and the accesses
+ * of the PC prefetch the confident ones.
+ *
+ * Berti fills its high coverage deltas into the L1 and the medium coverage
+ * ones into the L2; here both are issued to the cache the prefetcher is
+ * attached to, the medium ones at a lower priority.
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_BERTI_HH__
+#define __MEM_CACHE_PREFETCH_BERTI_HH__
+
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "mem/cache/prefetch/associative_set.hh"
+#include "mem/cache/prefetch/queued.hh"
+#include "mem/packet.hh"
+
+namespace gem5
+{
+
+struct BertiPrefetcherParams;
+
+GEM5_DEPRECATED_NAMESPACE(Prefetcher, prefetch);
+namespace prefetch
+{
+
+class Berti : public Queued
+{
+  protected:
+    /** Number of accesses remembered per PC */
+    const unsigned historyLength;
+    /** Number of deltas tracked per PC */
+    const unsigned deltasPerEntry;
+    /** Largest delta learnt, in blocks */
+    const int maxDelta;
+    /** Number of fills of a PC between two classifications */
+    const unsigned learningPeriod;
+    /** Coverage of the deltas prefetched at high priority, in percent */
+    const unsigned highCoverage;
+    /** Coverage of the deltas prefetched at low priority, in percent */
+    const unsigned lowCoverage;
+    /** Maximum number of prefetches generated per access */
+    const unsigned degree;
+
+    /** Confidence class of a delta */
+    enum class DeltaClass
+    {
+        None,
+        Low,
+        High
+    };
+
+    /** An access of a PC */
+    struct Access
+    {
+        /** Block number of the address accessed */
+        Addr blk = 0;
+        /** When the access happened */
+        Tick tick = 0;
+    };
+
+    /** A delta being learnt */
+    struct Delta
+    {
+        /** Distance in blocks */
+        int delta = 0;
+        /** Fills of the learning period the delta would have covered */
+        unsigned coverage = 0;
+        /** Class given at the end of the last learning period */
+        DeltaClass cls = DeltaClass::None;
+        /** Last search of the learning period which counted the delta */
+        unsigned search = 0;
+    };
+
+    /** Per-PC table entry */
+    struct BertiEntry : public TaggedEntry
+    {
+        /** Last accesses of the PC, as a ring */
+        std::vector<Access> history;
+        /** Next slot of the ring to be written */
+        unsigned head;
+        /** Number of valid accesses of the ring */
+        unsigned numAccesses;
+        /** Deltas being learnt */
+        std::vector<Delta> deltas;
+        /** Fills searched for timely deltas in this learning period */
+        unsigned searches;
+
+        BertiEntry(unsigned history_length, unsigned num_deltas);
+
+        void invalidate() override;
+
+        /** Remember an access of the PC */
+        void addAccess(Addr blk, Tick tick);
+
+        /**
+         * Count a timely delta found by the current search, once per
+         * search, replacing the delta of lowest coverage if it is new.
+         * @return Whether the delta had not been counted by this search
+         */
+        bool addCoverage(int delta);
+
+        /** Classify the deltas and start a new learning period */
+        void classify(unsigned high_threshold, unsigned low_threshold);
+    };
+
+    /** The table of PCs */
+    AssociativeSet<BertiEntry> table;
+
+    struct BertiStats : public statistics::Group
+    {
+        BertiStats(statistics::Group *parent);
+
+        /** Demand fills the deltas were trained on */
+        statistics::Scalar trainingFills;
+        /** Total latency of those fills */
+        statistics::Scalar fillLatency;
+        statistics::Formula avgFillLatency;
+        /** Timely deltas found in the history of the fills */
+        statistics::Scalar timelyDeltas;
+        /** Fills whose PC had no access early enough to hide them */
+        statistics::Scalar noTimelyDelta;
+        /** Candidates generated from high coverage deltas */
+        statistics::Scalar pfHighCoverage;
+        /** Candidates generated from low coverage deltas */
+        statistics::Scalar pfLowCoverage;
+    } bertiStats;
+
+    /**
+     * Search the history of the PC of a demand fill for the deltas which
+     * would have prefetched the block in time.
+     */
+    void notifyFill(const PacketPtr &pkt) override;
+
+  public:
+    Berti(const BertiPrefetcherParams &p);
+    ~Berti() = default;
+
+    void calculatePrefetch(const PrefetchInfo &pfi,
+                           std::vector<AddrPriority> &addresses) override;
+};
+
+} // namespace prefetch
+} // namespace gem5
+
+#endif // __MEM_CACHE_PREFETCH_BERTI_HH__
@@ -0,0 +1,202 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/prefetch/coordinator.hh"
+
+#include <algorithm>
+
+#include "base/filters/base.hh"
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/HWPrefetch.hh"
+#include "mem/cache/prefetch/queued.hh"
+#include "mem/mem_ctrl.hh"
+#include "params/PrefetchCoordinator.hh"
+
+namespace gem5
+{
+
+GEM5_DEPRECATED_NAMESPACE(Prefetcher, prefetch);
+namespace prefetch
+{
+
+Coordinator::Coordinator(const PrefetchCoordinatorParams &p)
+  : SimObject(p), filter(p.filter), filterWindow(p.filter_window),
+    filterInsertions(0), hintPriority(p.hint_priority),
+    virtualAddresses(false), registered(false), memCtrls(p.mem_ctrls),
+    samplePeriod(p.sample_period), highUtilization(p.high_utilization),
+    lowUtilization(p.low_utilization), maxBudget(p.max_budget),
+    minBudget(p.min_budget), budget(p.max_budget), remaining(p.max_budget),
+    lastBytes(0), peakBandwidth(0),
+    sampleEvent([this]{ sample(); }, name()), stats(*this)
+{
+    fatal_if(filterWindow == 0, "%s: the filter window cannot be empty\n",
+             name());
+    fatal_if(minBudget == 0 || minBudget > maxBudget,
+             "%s: the budget must be between 1 and max_budget\n", name());
+    fatal_if(lowUtilization > highUtilization, "%s: the low utilization "
+             "threshold is above the high one\n", name());
+    fatal_if(!memCtrls.empty() && samplePeriod == 0,
+             "%s: the bandwidth needs a sample period\n", name());
+}
+
+void
+Coordinator::startup()
+{
+    if (memCtrls.empty())
+        return;
+
+    for (const auto *ctrl : memCtrls)
+        peakBandwidth += ctrl->peakBandwidth();
+    lastBytes = bytesAccepted();
+    schedule(sampleEvent, curTick() + samplePeriod);
+}
+
+uint64_t
+Coordinator::bytesAccepted() const
+{
+    uint64_t bytes = 0;
+    for (const auto *ctrl : memCtrls)
+        bytes += ctrl->bytesAccepted();
+    return bytes;
+}
+
+void
+Coordinator::sample()
+{
+    const uint64_t bytes = bytesAccepted();
+    const double utilization =
+        (bytes - lastBytes) / (peakBandwidth * samplePeriod) * 100;
+    lastBytes = bytes;
+    stats.utilization.sample(std::min(utilization, 100.0));
+
+    if (remaining == 0)
+        stats.exhaustedPeriods++;
+
+    if (utilization > highUtilization && budget > minBudget) {
+        budget = std::max(budget / 2, minBudget);
+        stats.throttleDowns++;
+    } else if (utilization < lowUtilization && budget < maxBudget) {
+        budget = std::min(budget * 2, maxBudget);
+        stats.throttleUps++;
+    }
+    remaining = budget;
+
+    DPRINTF(HWPrefetch, "Coordinator: bandwidth utilization %.1f%%, "
+            "budget of %d prefetches\n", utilization, budget);
+
+    schedule(sampleEvent, curTick() + samplePeriod);
+}
+
+void
+Coordinator::registerPrefetcher(const Queued *pf, bool virtual_addresses)
+{
+    fatal_if(registered && virtual_addresses != virtualAddresses,
+             "%s: %s does not train on the same kind of addresses as the "
+             "other coordinated prefetchers\n", name(), pf->name());
+    virtualAddresses = virtual_addresses;
+    registered = true;
+}
+
+void
+Coordinator::observe(Queued *pf, unsigned level, RequestorID requestor)
+{
+    prefetchers.emplace(std::make_pair(level, requestor), pf);
+}
+
+bool
+Coordinator::recentlyPrefetched(Addr blk_addr) const
+{
+    return filter->isSet(blk_addr);
+}
+
+void
+Coordinator::prefetchIssued(Addr blk_addr)
+{
+    filter->set(blk_addr);
+    stats.filterInsertions++;
+    if (++filterInsertions == filterWindow) {
+        filter->clear();
+        filterInsertions = 0;
+    }
+}
+
+bool
+Coordinator::pushUp(unsigned level, const PacketPtr &pkt,
+                    const Base::PrefetchInfo &pfi, int32_t priority)
+{
+    if (level <= 1 || priority < hintPriority)
+        return false;
+
+    auto it = prefetchers.find(
+        std::make_pair(level - 1, pkt->req->requestorId()));
+    if (it == prefetchers.end())
+        return false;
+
+    DPRINTF(HWPrefetch, "Coordinator: pushing %#x from level %d to %s\n",
+            pfi.getAddr(), level, it->second->name());
+    it->second->hint(pkt, pfi, priority);
+    stats.hints++;
+    return true;
+}
+
+bool
+Coordinator::consumeBudget()
+{
+    if (memCtrls.empty())
+        return true;
+    if (remaining == 0)
+        return false;
+    remaining--;
+    return true;
+}
+
+Coordinator::CoordinatorStats::CoordinatorStats(Coordinator &coordinator)
+  : statistics::Group(&coordinator),
+    ADD_STAT(hints, statistics::units::Count::get(),
+             "number of prefetch candidates pushed to the upper level"),
+    ADD_STAT(filterInsertions, statistics::units::Count::get(),
+             "number of prefetches recorded in the shared filter"),
+    ADD_STAT(exhaustedPeriods, statistics::units::Count::get(),
+             "number of sample periods which ran out of prefetch budget"),
+    ADD_STAT(throttleDowns, statistics::units::Count::get(),
+             "number of times the prefetch budget was lowered"),
+    ADD_STAT(throttleUps, statistics::units::Count::get(),
+             "number of times the prefetch budget was raised"),
+    ADD_STAT(utilization, statistics::units::Ratio::get(),
+             "memory bandwidth utilization per sample period (percent)")
+{
+}
+
+void
+Coordinator::CoordinatorStats::regStats()
+{
+    statistics::Group::regStats();
+
+    utilization.init(0, 100, 5).flags(statistics::nozero);
+}
+
+} // namespace prefetch
+} // namespace gem5
@@ -0,0 +1,202 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Coordination of the prefetchers of several cache levels.
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_COORDINATOR_HH__
+#define __MEM_CACHE_PREFETCH_COORDINATOR_HH__
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "mem/cache/prefetch/base.hh"
+#include "mem/packet.hh"
+#include "mem/request.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_object.hh"
+
+namespace gem5
+{
+
+struct PrefetchCoordinatorParams;
+
+namespace bloom_filter
+{
+class Base;
+} // namespace bloom_filter
+
+namespace memory
+{
+class MemCtrl;
+} // namespace memory
+
+GEM5_DEPRECATED_NAMESPACE(Prefetcher, prefetch);
+namespace prefetch
+{
+
+class Queued;
+
+/**
+ * Shared by the prefetchers of the cache levels of a hierarchy, so that
+ * they stop working against each other:
+ * - A Bloom filter remembers the lines recently prefetched by any level,
+ *   and the other levels drop their candidates for those lines.
+ * - A lower level pushes its most confident candidates into the upper
+ *   level cache of the requestor which triggered them, instead of only
+ *   filling them into its own cache.
+ * - All the levels draw their prefetches from a common budget, which is
+ *   set every sample period from the bandwidth utilization of the memory
+ *   controllers: it halves when the utilization is high and doubles when
+ *   it is low.
+ */
+class Coordinator : public SimObject
+{
+  protected:
+    /** Lines recently prefetched by any level */
+    bloom_filter::Base *filter;
+    /** Number of prefetches after which the filter is cleared */
+    const unsigned filterWindow;
+    /** Prefetches recorded in the filter since it was cleared */
+    unsigned filterInsertions;
+
+    /** Lowest priority of the candidates pushed to the upper level */
+    const int32_t hintPriority;
+
+    /**
+     * The prefetchers of each level, by the requestors they were seen
+     * serving, to route the candidates of the level below.
+     */
+    std::map<std::pair<unsigned, RequestorID>, Queued *> prefetchers;
+
+    /** Whether the registered prefetchers train on virtual addresses */
+    bool virtualAddresses;
+    /** Whether any prefetcher has registered yet */
+    bool registered;
+
+    /** Memory controllers whose bandwidth sets the budget */
+    const std::vector<memory::MemCtrl *> memCtrls;
+    const Tick samplePeriod;
+    const unsigned highUtilization;
+    const unsigned lowUtilization;
+    const unsigned maxBudget;
+    const unsigned minBudget;
+
+    /** Prefetches allowed per sample period */
+    unsigned budget;
+    /** Prefetches left in the current sample period */
+    unsigned remaining;
+    /** Bytes accepted by the controllers at the last sample */
+    uint64_t lastBytes;
+    /** Peak bandwidth of the controllers, in bytes per tick */
+    double peakBandwidth;
+
+    /** Sample the bandwidth and set the budget of the next period */
+    void sample();
+    EventFunctionWrapper sampleEvent;
+
+    /** Bytes accepted by the memory controllers so far */
+    uint64_t bytesAccepted() const;
+
+    struct CoordinatorStats : public statistics::Group
+    {
+        CoordinatorStats(Coordinator &coordinator);
+
+        void regStats() override;
+
+        /** Candidates pushed to the upper level */
+        statistics::Scalar hints;
+        /** Prefetches recorded in the filter */
+        statistics::Scalar filterInsertions;
+        /** Sample periods which ran out of budget */
+        statistics::Scalar exhaustedPeriods;
+        /** Times the budget was lowered */
+        statistics::Scalar throttleDowns;
+        /** Times the budget was raised */
+        statistics::Scalar throttleUps;
+        /** Bandwidth utilization of each sample period */
+        statistics::Distribution utilization;
+    } stats;
+
+  public:
+    Coordinator(const PrefetchCoordinatorParams &p);
+
+    void startup() override;
+
+    /**
+     * Register a prefetcher. The prefetchers of all the levels must train
+     * on the same kind of addresses, as they exchange candidates.
+     * @param virtual_addresses Whether the prefetcher uses virtual
+     *        addresses
+     */
+    void registerPrefetcher(const Queued *pf, bool virtual_addresses);
+
+    /**
+     * Note that a prefetcher serves a requestor, for the candidates of the
+     * level below to be pushed into its cache.
+     */
+    void observe(Queued *pf, unsigned level, RequestorID requestor);
+
+    /** Whether any level prefetched a line recently. */
+    bool recentlyPrefetched(Addr blk_addr) const;
+
+    /** Record a prefetch issued by any level. */
+    void prefetchIssued(Addr blk_addr);
+
+    /**
+     * Offer a prefetch candidate of a level to the upper level prefetcher
+     * serving the requestor of the triggering access.
+     * @param level The level of the prefetcher offering the candidate
+     * @param pkt The access which triggered the candidate
+     * @param pfi The candidate
+     * @param priority The priority of the candidate
+     * @return Whether the upper level took the candidate
+     */
+    bool pushUp(unsigned level, const PacketPtr &pkt,
+                const Base::PrefetchInfo &pfi, int32_t priority);
+
+    /**
+     * Take a prefetch from the budget of the current period.
+     * @return False if the budget is exhausted
+     */
+    bool consumeBudget();
+
+    /** When the budget allows the next prefetch. */
+    Tick
+    budgetReadyTime() const
+    {
+        return (memCtrls.empty() || remaining) ? 0 : sampleEvent.when();
+    }
+};
+
+} // namespace prefetch
+} // namespace gem5
+
+#endif // __MEM_CACHE_PREFETCH_COORDINATOR_HH__
@@ -77,8 +77,7 @@ Multi::getPacket()
         if (pf->nextPrefetchReadyTime() <= curTick()) {
             PacketPtr pkt = pf->getPacket();
             panic_if(!pkt, "Prefetcher is ready but didn't return a packet.");
-            prefetchStats.pfIssued++;
-            issuedPrefetches++;
+            prefetchIssued(pkt);
             return pkt;
         }
     }
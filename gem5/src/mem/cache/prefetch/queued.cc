@@ -37,7 +37,9 @@
 
 #include "mem/cache/prefetch/queued.hh"
 
+#include <algorithm>
 #include <cassert>
+#include <vector>
 
 #include "arch/generic/tlb.hh"
 #include "base/logging.hh"
@@ -45,6 +47,7 @@
 #include "debug/HWPrefetch.hh"
 #include "debug/HWPrefetchQueue.hh"
 #include "mem/cache/base.hh"
+#include "mem/cache/prefetch/coordinator.hh"
 #include "mem/request.hh"
 #include "params/QueuedPrefetcher.hh"
 
@@ -61,7 +64,7 @@ Queued::DeferredPacket::createPkt(Addr paddr, unsigned blk_size,
                                             bool tag_prefetch,
                                             Tick t) {
     /* Create a prefetch memory request */
-    RequestPtr req = std::make_shared<Request>(paddr, blk_size,
+    RequestPtr req = makeRequest(paddr, blk_size,
                                                 0, requestor_id);
 
     if (pfInfo.isSecure()) {
@@ -99,44 +102,54 @@ Queued::DeferredPacket::finish(const Fault &fault,
 }
 
 Queued::Queued(const QueuedPrefetcherParams &p)
-    : Base(p), queueSize(p.queue_size),
+    : Base(p), translationCacheUses(0), queueSize(p.queue_size),
       missingTranslationQueueSize(
         p.max_prefetch_requests_with_pending_translation),
+      translationCacheSize(p.translation_cache_entries),
+      maxPendingWalks(p.max_outstanding_translations),
       latency(p.latency), queueSquash(p.queue_squash),
       queueFilter(p.queue_filter), cacheSnoop(p.cache_snoop),
-      tagPrefetch(p.tag_prefetch),
-      throttleControlPct(p.throttle_control_percentage), statsQueued(this)
+      tagPrefetch(p.tag_prefetch), coordinator(p.coordinator),
+      coordinatorLevel(p.coordinator_level),
+      throttleControlPct(p.throttle_control_percentage),
+      maxFeedbackDegree(p.feedback_max_degree),
+      feedbackDegree(p.feedback_max_degree),
+      aggressiveness(NumAggressivenessLevels / 2), statsQueued(this)
 {
+    fatal_if(maxFeedbackDegree == 0,
+             "%s: the feedback must allow at least one prefetch\n", name());
+    fatal_if(maxPendingWalks == 0,
+             "%s: at least one translation must be allowed\n", name());
+    if (coordinator)
+        coordinator->registerPrefetcher(this, useVirtualAddresses);
 }
 
 Queued::~Queued()
 {
     // Delete the queued prefetch packets
-    for (DeferredPacket &p : pfq) {
-        delete p.pkt;
-    }
+    pfq.forEach([](const DeferredPacket &p) { delete p.pkt; });
 }
 
+template <class Queue>
 void
-Queued::printQueue(const std::list<DeferredPacket> &queue) const
+Queued::printQueue(const Queue &queue) const
 {
     int pos = 0;
     std::string queue_name = "";
-    if (&queue == &pfq) {
+    if (static_cast<const void *>(&queue) == &pfq) {
         queue_name = "PFQ";
     } else {
-        assert(&queue == &pfqMissingTranslation);
+        assert(static_cast<const void *>(&queue) == &pfqMissingTranslation);
         queue_name = "PFTransQ";
     }
 
-    for (const_iterator it = queue.cbegin(); it != queue.cend();
-                                                            it++, pos++) {
-        Addr vaddr = it->pfInfo.getAddr();
+    queue.forEach([&](const DeferredPacket &dp) {
+        Addr vaddr = dp.pfInfo.getAddr();
         /* Set paddr to 0 if not yet translated */
-        Addr paddr = it->pkt ? it->pkt->getAddr() : 0;
+        Addr paddr = dp.pkt ? dp.pkt->getAddr() : 0;
         DPRINTF(HWPrefetchQueue, "%s[%d]: Prefetch Req VA: %#x PA: %#x "
-                "prio: %3d\n", queue_name, pos, vaddr, paddr, it->priority);
-    }
+                "prio: %3d\n", queue_name, pos++, vaddr, paddr, dp.priority);
+    });
 }
 
 size_t
@@ -166,32 +179,97 @@ Queued::getMaxPermittedPrefetches(size_t total) const
         max_pfs = min_pfs + (total - min_pfs) *
             usefulPrefetches / issuedPrefetches;
     }
+    if (feedbackInterval)
+        max_pfs = std::min<size_t>(max_pfs, feedbackDegree);
     return max_pfs;
 }
 
+const Queued::Aggressiveness Queued::aggressivenessLevels[] = {
+    // very conservative, conservative, middle of the road, aggressive
+    // and very aggressive
+    {4, 1}, {8, 1}, {16, 2}, {32, 4}, {64, 4}
+};
+
+int
+Queued::feedbackDirection(const Feedback &fb) const
+{
+    // Thresholds of Feedback Directed Prefetching (Srinath et al., HPCA
+    // 2007): accuracy is high from 75% and low below 40%, prefetching is
+    // late when more than 1% of the useful prefetches arrive late, and
+    // it pollutes the cache when more than 0.5% of the demand misses are
+    // on blocks evicted by prefetches
+    const uint64_t used = fb.useful + fb.late;
+    const double accuracy = fb.issued ? (double)used / fb.issued : 0;
+    const bool late = used && (double)fb.late / used > 0.01;
+    const bool polluting = fb.demandMisses &&
+        (double)fb.pollution / fb.demandMisses > 0.005;
+
+    int direction = 0;
+    if (accuracy >= 0.75) {
+        if (late)
+            direction = 1;
+        else if (polluting)
+            direction = -1;
+    } else if (accuracy >= 0.40) {
+        if (polluting)
+            direction = -1;
+        else if (late)
+            direction = 1;
+    } else {
+        direction = -1;
+    }
+
+    DPRINTF(HWPrefetch, "Feedback: accuracy %.2f late %d polluting %d, "
+            "direction %d\n", accuracy, late, polluting, direction);
+    return direction;
+}
+
+void
+Queued::adaptAggressiveness(const Feedback &fb)
+{
+    int direction = feedbackDirection(fb);
+    if (direction > 0 && aggressiveness + 1 < NumAggressivenessLevels)
+        aggressiveness++;
+    else if (direction < 0 && aggressiveness > 0)
+        aggressiveness--;
+    DPRINTF(HWPrefetch, "Aggressiveness level %d: distance %d degree %d\n",
+            aggressiveness, aggressivenessLevels[aggressiveness].distance,
+            aggressivenessLevels[aggressiveness].degree);
+}
+
+void
+Queued::processFeedback(const Feedback &fb)
+{
+    int direction = feedbackDirection(fb);
+    if (direction > 0)
+        feedbackDegree = std::min(2 * feedbackDegree, maxFeedbackDegree);
+    else if (direction < 0)
+        feedbackDegree = std::max(feedbackDegree / 2, 1U);
+}
+
 void
 Queued::notify(const PacketPtr &pkt, const PrefetchInfo &pfi)
 {
     Addr blk_addr = blockAddress(pfi.getAddr());
     bool is_secure = pfi.isSecure();
 
+    if (coordinator)
+        coordinator->observe(this, coordinatorLevel, pfi.getRequestorId());
+
     // Squash queued prefetches if demand miss to same line
-    if (queueSquash) {
-        auto itr = pfq.begin();
-        while (itr != pfq.end()) {
-            if (itr->pfInfo.getAddr() == blk_addr &&
-                itr->pfInfo.isSecure() == is_secure) {
-                DPRINTF(HWPrefetch, "Removing pf candidate addr: %#x "
-                        "(cl: %#x), demand request going to the same addr\n",
-                        itr->pfInfo.getAddr(),
-                        blockAddress(itr->pfInfo.getAddr()));
-                delete itr->pkt;
-                itr = pfq.erase(itr);
-                statsQueued.pfRemovedDemand++;
-            } else {
-                ++itr;
+    if (queueSquash && pfq.contains(blk_addr)) {
+        pfq.eraseIf([&](const DeferredPacket &dp) {
+            if (dp.pfInfo.getAddr() != blk_addr ||
+                dp.pfInfo.isSecure() != is_secure) {
+                return false;
             }
-        }
+            DPRINTF(HWPrefetch, "Removing pf candidate addr: %#x "
+                    "(cl: %#x), demand request going to the same addr\n",
+                    dp.pfInfo.getAddr(), blockAddress(dp.pfInfo.getAddr()));
+            delete dp.pkt;
+            statsQueued.pfRemovedDemand++;
+            return true;
+        });
     }
 
     // Calculate prefetches given this access
@@ -218,8 +296,14 @@ Queued::notify(const PacketPtr &pkt, const PrefetchInfo &pfi)
             statsQueued.pfIdentified++;
             DPRINTF(HWPrefetch, "Found a pf candidate addr: %#x, "
                     "inserting into prefetch queue.\n", new_pfi.getAddr());
-            // Create and insert the request
-            insert(pkt, new_pfi, addr_prio.second);
+            // Hand the candidate to the upper level if it takes it, else
+            // create and insert the request
+            if (coordinator && coordinator->pushUp(
+                    coordinatorLevel, pkt, new_pfi, addr_prio.second)) {
+                statsQueued.pfPushedUp++;
+            } else {
+                insert(pkt, new_pfi, addr_prio.second);
+            }
             num_pfs += 1;
             if (num_pfs == max_pfs) {
                 break;
@@ -246,18 +330,51 @@ Queued::getPacket()
         return nullptr;
     }
 
+    if (coordinator && !coordinator->consumeBudget()) {
+        DPRINTF(HWPrefetch, "Prefetch budget exhausted.\n");
+        statsQueued.pfThrottled++;
+        return nullptr;
+    }
+
     PacketPtr pkt = pfq.front().pkt;
     pfq.pop_front();
 
-    prefetchStats.pfIssued++;
-    issuedPrefetches += 1;
     assert(pkt != nullptr);
+    prefetchIssued(pkt);
+    if (coordinator)
+        coordinator->prefetchIssued(pkt->getAddr());
     DPRINTF(HWPrefetch, "Generating prefetch for %#x.\n", pkt->getAddr());
 
     processMissingTranslations(queueSize - pfq.size());
     return pkt;
 }
 
+Tick
+Queued::nextPrefetchReadyTime() const
+{
+    if (pfq.empty())
+        return MaxTick;
+    if (coordinator)
+        return std::max(pfq.front().tick, coordinator->budgetReadyTime());
+    return pfq.front().tick;
+}
+
+void
+Queued::hint(const PacketPtr &pkt, const PrefetchInfo &pfi,
+             int32_t priority)
+{
+    PrefetchInfo new_pfi(pfi, blockAddress(pfi.getAddr()));
+    statsQueued.pfHinted++;
+    DPRINTF(HWPrefetch, "Hinted pf candidate addr: %#x, inserting into "
+            "prefetch queue.\n", new_pfi.getAddr());
+    insert(pkt, new_pfi, priority);
+
+    // The cache may be idle, wake it up to issue the prefetch
+    Tick next_pf_time = nextPrefetchReadyTime();
+    if (next_pf_time != MaxTick)
+        cache->schedMemSideSendEvent(next_pf_time);
+}
+
 Queued::QueuedStats::QueuedStats(statistics::Group *parent)
     : statistics::Group(parent),
     ADD_STAT(pfIdentified, statistics::units::Count::get(),
@@ -272,7 +389,24 @@ Queued::QueuedStats::QueuedStats(statistics::Group *parent)
     ADD_STAT(pfRemovedFull, statistics::units::Count::get(),
              "number of prefetches dropped due to prefetch queue size"),
     ADD_STAT(pfSpanPage, statistics::units::Count::get(),
-             "number of prefetches that crossed the page")
+             "number of prefetches that crossed the page"),
+    ADD_STAT(pfCoordFiltered, statistics::units::Count::get(),
+             "number of prefetches dropped as recently prefetched by a "
+             "coordinated level"),
+    ADD_STAT(pfPushedUp, statistics::units::Count::get(),
+             "number of prefetch candidates pushed to the upper level"),
+    ADD_STAT(pfHinted, statistics::units::Count::get(),
+             "number of prefetch candidates pushed by the lower level"),
+    ADD_STAT(pfThrottled, statistics::units::Count::get(),
+             "number of prefetches held back by the shared budget"),
+    ADD_STAT(pfTranslationWalks, statistics::units::Count::get(),
+             "number of translations requested to the MMU"),
+    ADD_STAT(pfTranslationCacheHits, statistics::units::Count::get(),
+             "number of prefetches translated by the prefetcher's own "
+             "translation cache"),
+    ADD_STAT(pfTranslationsCoalesced, statistics::units::Count::get(),
+             "number of prefetches translated by the walk of another "
+             "prefetch to the same page")
 {
 }
 
@@ -280,80 +414,169 @@ Queued::QueuedStats::QueuedStats(statistics::Group *parent)
 void
 Queued::processMissingTranslations(unsigned max)
 {
-    unsigned count = 0;
-    iterator it = pfqMissingTranslation.begin();
-    while (it != pfqMissingTranslation.end() && count < max) {
-        DeferredPacket &dp = *it;
-        // Increase the iterator first because dp.startTranslation can end up
-        // calling finishTranslation, which will erase "it"
-        it++;
-        dp.startTranslation(tlb);
-        count += 1;
+    // Prefetches to pages translated recently need no walk
+    unsigned done = 0;
+    pfqMissingTranslation.eraseIf([&](DeferredPacket &dp) {
+        if (done == max || dp.ongoingTranslation)
+            return false;
+        Addr paddr = lookupTranslation(translationPage(dp));
+        if (paddr == MaxAddr)
+            return false;
+        statsQueued.pfTranslationCacheHits++;
+        Addr target_paddr =
+            paddr + pageOffset(dp.translationRequest->getVaddr());
+        dp.translationRequest->setPaddr(target_paddr);
+        queueTranslated(dp, target_paddr);
+        done++;
+        return true;
+    });
+
+    // Walk each page once, the other prefetches to it wait for the walk.
+    // Starting a translation can complete it at once, and with it other
+    // prefetches of the queue, so look for the next one from scratch.
+    while (done < max && pendingWalks.size() < maxPendingWalks) {
+        DeferredPacket *next = nullptr;
+        pfqMissingTranslation.forFirst(pfqMissingTranslation.size(),
+            [&](DeferredPacket &dp) {
+                if (!next && !dp.ongoingTranslation &&
+                    !pendingWalks.count(translationPage(dp))) {
+                    next = &dp;
+                }
+            });
+        if (!next)
+            break;
+
+        pendingWalks.insert(translationPage(*next));
+        statsQueued.pfTranslationWalks++;
+        done++;
+        next->startTranslation(tlb);
+    }
+}
+
+Queued::TranslationPage
+Queued::translationPage(const DeferredPacket &dp) const
+{
+    return std::make_pair(dp.translationRequest->contextId(),
+                          pageAddress(dp.translationRequest->getVaddr()));
+}
+
+Addr
+Queued::lookupTranslation(const TranslationPage &page)
+{
+    for (auto &entry : translationCache) {
+        if (entry.page == page) {
+            entry.lastUse = ++translationCacheUses;
+            return entry.paddr;
+        }
     }
+    return MaxAddr;
 }
 
 void
-Queued::translationComplete(DeferredPacket *dp, bool failed)
+Queued::cacheTranslation(const TranslationPage &page, Addr paddr)
 {
-    auto it = pfqMissingTranslation.begin();
-    while (it != pfqMissingTranslation.end()) {
-        if (&(*it) == dp) {
+    if (translationCacheSize == 0)
+        return;
+
+    CachedTranslation *victim = nullptr;
+    for (auto &entry : translationCache) {
+        if (entry.page == page) {
+            victim = &entry;
             break;
         }
-        it++;
+        if (!victim || entry.lastUse < victim->lastUse)
+            victim = &entry;
+    }
+    if (translationCache.size() < translationCacheSize &&
+        (!victim || victim->page != page)) {
+        translationCache.push_back(CachedTranslation());
+        victim = &translationCache.back();
+    }
+
+    victim->page = page;
+    victim->paddr = paddr;
+    victim->lastUse = ++translationCacheUses;
+}
+
+unsigned
+Queued::resolvePage(const TranslationPage &page, bool failed, Addr paddr,
+                    unsigned max)
+{
+    unsigned resolved = 0;
+    pfqMissingTranslation.eraseIf([&](DeferredPacket &dp) {
+        if (resolved == max || dp.ongoingTranslation ||
+            translationPage(dp) != page) {
+            return false;
+        }
+        if (!failed) {
+            Addr target_paddr =
+                paddr + pageOffset(dp.translationRequest->getVaddr());
+            dp.translationRequest->setPaddr(target_paddr);
+            queueTranslated(dp, target_paddr);
+        }
+        resolved++;
+        return true;
+    });
+    return resolved;
+}
+
+void
+Queued::queueTranslated(DeferredPacket &dp, Addr target_paddr)
+{
+    // check if this prefetch is already redundant
+    if (cacheSnoop && (inCache(target_paddr, dp.pfInfo.isSecure()) ||
+                inMissQueue(target_paddr, dp.pfInfo.isSecure()))) {
+        statsQueued.pfInCache++;
+        DPRINTF(HWPrefetch, "Dropping redundant in "
+                "cache/MSHR prefetch addr:%#x\n", target_paddr);
+    } else {
+        Tick pf_time = curTick() + clockPeriod() * latency;
+        dp.createPkt(target_paddr, blkSize, requestorId, tagPrefetch,
+                     pf_time);
+        addToQueue(pfq, dp);
     }
-    assert(it != pfqMissingTranslation.end());
+}
+
+void
+Queued::translationComplete(DeferredPacket *dp, bool failed)
+{
+    const TranslationPage page = translationPage(*dp);
+    pendingWalks.erase(page);
+
+    Addr page_paddr = 0;
     if (!failed) {
         DPRINTF(HWPrefetch, "%s Translation of vaddr %#x succeeded: "
                 "paddr %#x \n", tlb->name(),
-                it->translationRequest->getVaddr(),
-                it->translationRequest->getPaddr());
-        Addr target_paddr = it->translationRequest->getPaddr();
-        // check if this prefetch is already redundant
-        if (cacheSnoop && (inCache(target_paddr, it->pfInfo.isSecure()) ||
-                    inMissQueue(target_paddr, it->pfInfo.isSecure()))) {
-            statsQueued.pfInCache++;
-            DPRINTF(HWPrefetch, "Dropping redundant in "
-                    "cache/MSHR prefetch addr:%#x\n", target_paddr);
-        } else {
-            Tick pf_time = curTick() + clockPeriod() * latency;
-            it->createPkt(target_paddr, blkSize, requestorId, tagPrefetch,
-                          pf_time);
-            addToQueue(pfq, *it);
-        }
+                dp->translationRequest->getVaddr(),
+                dp->translationRequest->getPaddr());
+        page_paddr = pageAddress(dp->translationRequest->getPaddr());
+        cacheTranslation(page, page_paddr);
     } else {
         DPRINTF(HWPrefetch, "%s Translation of vaddr %#x failed, dropping "
-                "prefetch request %#x \n", tlb->name(),
-                it->translationRequest->getVaddr());
+                "the prefetch requests to its page\n", tlb->name(),
+                dp->translationRequest->getVaddr());
     }
-    pfqMissingTranslation.erase(it);
+
+    // The prefetches which waited for this walk complete along with it
+    unsigned resolved = resolvePage(page, failed, page_paddr,
+                                    pfqMissingTranslation.size());
+    if (resolved > 1)
+        statsQueued.pfTranslationsCoalesced += resolved - 1;
 }
 
+template <class Queue>
 bool
-Queued::alreadyInQueue(std::list<DeferredPacket> &queue,
-                                 const PrefetchInfo &pfi, int32_t priority)
+Queued::alreadyInQueue(Queue &queue, const PrefetchInfo &pfi,
+                       int32_t priority)
 {
-    bool found = false;
-    iterator it;
-    for (it = queue.begin(); it != queue.end() && !found; it++) {
-        found = it->pfInfo.sameAddr(pfi);
-    }
+    DeferredPacket *dp = queue.find(pfi);
 
     /* If the address is already in the queue, update priority and leave */
-    if (it != queue.end()) {
+    if (dp) {
         statsQueued.pfBufferHit++;
-        if (it->priority < priority) {
+        if (dp->priority < priority) {
             /* Update priority value and position in the queue */
-            it->priority = priority;
-            iterator prev = it;
-            while (prev != queue.begin()) {
-                prev--;
-                /* If the packet has higher priority, swap */
-                if (*it > *prev) {
-                    std::swap(*it, *prev);
-                    it = prev;
-                }
-            }
+            queue.setPriority(dp, priority);
             DPRINTF(HWPrefetch, "Prefetch addr already in "
                 "prefetch queue, priority updated\n");
         } else {
@@ -361,14 +584,14 @@ Queued::alreadyInQueue(std::list<DeferredPacket> &queue,
                 "prefetch queue\n");
         }
     }
-    return found;
+    return dp != nullptr;
 }
 
 RequestPtr
 Queued::createPrefetchRequest(Addr addr, PrefetchInfo const &pfi,
                                         PacketPtr pkt)
 {
-    RequestPtr translation_req = std::make_shared<Request>(
+    RequestPtr translation_req = makeRequest(
             addr, blkSize, pkt->req->getFlags(), requestorId, pfi.getPC(),
             pkt->req->contextId());
     translation_req->setFlags(Request::PREFETCH);
@@ -445,6 +668,13 @@ Queued::insert(const PacketPtr &pkt, PrefetchInfo &new_pfi,
             return;
         }
     }
+    if (has_target_pa && coordinator &&
+            coordinator->recentlyPrefetched(blockAddress(target_paddr))) {
+        statsQueued.pfCoordFiltered++;
+        DPRINTF(HWPrefetch, "Dropping prefetch addr:%#x recently "
+                "prefetched by a coordinated level\n", target_paddr);
+        return;
+    }
     if (has_target_pa && cacheSnoop &&
             (inCache(target_paddr, new_pfi.isSecure()) ||
             inMissQueue(target_paddr, new_pfi.isSecure()))) {
@@ -474,51 +704,26 @@ Queued::insert(const PacketPtr &pkt, PrefetchInfo &new_pfi,
     }
 }
 
+template <class Queue>
 void
-Queued::addToQueue(std::list<DeferredPacket> &queue,
-                             DeferredPacket &dpp)
+Queued::addToQueue(Queue &queue, DeferredPacket &dpp)
 {
     /* Verify prefetch buffer space for request */
     if (queue.size() == queueSize) {
         statsQueued.pfRemovedFull++;
-        /* Lowest priority packet */
-        iterator it = queue.end();
-        panic_if (it == queue.begin(),
-            "Prefetch queue is both full and empty!");
-        --it;
-        /* Look for oldest in that level of priority */
-        panic_if (it == queue.begin(),
-            "Prefetch queue is full with 1 element!");
-        iterator prev = it;
-        bool cont = true;
-        /* While not at the head of the queue */
-        while (cont && prev != queue.begin()) {
-            prev--;
-            /* While at the same level of priority */
-            cont = prev->priority == it->priority;
-            if (cont)
-                /* update pointer */
-                it = prev;
-        }
+        panic_if(queue.empty(), "Prefetch queue is both full and empty!");
+        panic_if(queue.size() == 1, "Prefetch queue is full with 1 element!");
+        /* Oldest packet of the lowest priority */
+        DeferredPacket &victim = queue.lowest();
         DPRINTF(HWPrefetch, "Prefetch queue full, removing lowest priority "
-                            "oldest packet, addr: %#x\n",it->pfInfo.getAddr());
-        delete it->pkt;
-        queue.erase(it);
+                            "oldest packet, addr: %#x\n",
+                            victim.pfInfo.getAddr());
+        delete victim.pkt;
+        queue.popLowest();
     }
 
-    if ((queue.size() == 0) || (dpp <= queue.back())) {
-        queue.emplace_back(dpp);
-    } else {
-        iterator it = queue.end();
-        do {
-            --it;
-        } while (it != queue.begin() && dpp > *it);
-        /* If we reach the head, we have to see if the new element is new head
-         * or not */
-        if (it == queue.begin() && dpp <= *it)
-            it++;
-        queue.insert(it, dpp);
-    }
+    /* Queue behind every packet of the same or a higher priority */
+    queue.push(dpp);
 
     if (debug::HWPrefetchQueue)
         printQueue(queue);
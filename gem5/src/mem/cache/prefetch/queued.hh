@@ -38,9 +38,17 @@
 #ifndef __MEM_CACHE_PREFETCH_QUEUED_HH__
 #define __MEM_CACHE_PREFETCH_QUEUED_HH__
 
+#include <cassert>
 #include <cstdint>
+#include <deque>
+#include <functional>
 #include <list>
+#include <map>
+#include <set>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "arch/generic/mmu.hh"
 #include "base/statistics.hh"
@@ -57,6 +65,8 @@ GEM5_DEPRECATED_NAMESPACE(Prefetcher, prefetch);
 namespace prefetch
 {
 
+class Coordinator;
+
 class Queued : public Base
 {
   protected:
@@ -140,11 +150,248 @@ class Queued : public Base
         void startTranslation(BaseTLB *tlb);
     };
 
-    std::list<DeferredPacket> pfq;
-    std::list<DeferredPacket> pfqMissingTranslation;
+    /**
+     * A queue of deferred prefetches, ordered by decreasing priority and,
+     * within a priority level, from oldest to youngest. Every priority
+     * level is a FIFO of its own, so inserting a prefetch or dropping the
+     * oldest one of the lowest priority does not have to walk the queue,
+     * and an index of the queued block addresses answers most duplicate
+     * checks without a search.
+     *
+     * @tparam Bucket Container holding the prefetches of one level. It
+     *         must be a std::list when the entries have to keep their
+     *         address while queued (e.g., while being translated).
+     */
+    template <class Bucket>
+    class DeferredPacketQueue
+    {
+      private:
+        typedef std::map<int32_t, Bucket, std::greater<int32_t>> Levels;
+
+        /** The queued prefetches of each priority, highest first. */
+        Levels levels;
+
+        /** Number of queued prefetches to each address. */
+        std::unordered_map<Addr, unsigned> addrCount;
+
+        /** Total number of queued prefetches. */
+        size_t numEntries = 0;
+
+        /** Locate an entry of the queue, which must be present. */
+        std::pair<typename Levels::iterator, typename Bucket::iterator>
+        locate(const DeferredPacket *dp)
+        {
+            auto level = levels.find(dp->priority);
+            assert(level != levels.end());
+            auto pos = level->second.begin();
+            while (&*pos != dp) {
+                ++pos;
+                assert(pos != level->second.end());
+            }
+            return std::make_pair(level, pos);
+        }
+
+        /** Drop an entry which is leaving the queue from the index. */
+        void
+        unindex(Addr addr)
+        {
+            auto count = addrCount.find(addr);
+            assert(count != addrCount.end());
+            if (--count->second == 0)
+                addrCount.erase(count);
+            numEntries--;
+        }
+
+        void
+        erase(typename Levels::iterator level, typename Bucket::iterator pos)
+        {
+            unindex(pos->pfInfo.getAddr());
+            level->second.erase(pos);
+            if (level->second.empty())
+                levels.erase(level);
+        }
+
+      public:
+        size_t size() const { return numEntries; }
+        bool empty() const { return numEntries == 0; }
+
+        /** The oldest prefetch of the highest priority. */
+        DeferredPacket &front() { return levels.begin()->second.front(); }
+        const DeferredPacket &
+        front() const
+        {
+            return levels.begin()->second.front();
+        }
+
+        void
+        pop_front()
+        {
+            erase(levels.begin(), levels.begin()->second.begin());
+        }
+
+        /** The oldest prefetch of the lowest priority. */
+        DeferredPacket &lowest() { return levels.rbegin()->second.front(); }
+
+        void
+        popLowest()
+        {
+            auto level = std::prev(levels.end());
+            erase(level, level->second.begin());
+        }
+
+        /** Add a prefetch behind all others of the same priority. */
+        void
+        push(const DeferredPacket &dp)
+        {
+            levels[dp.priority].push_back(dp);
+            addrCount[dp.pfInfo.getAddr()]++;
+            numEntries++;
+        }
+
+        /** Remove the given entry of the queue. */
+        void
+        erase(const DeferredPacket *dp)
+        {
+            auto loc = locate(dp);
+            erase(loc.first, loc.second);
+        }
 
-    using const_iterator = std::list<DeferredPacket>::const_iterator;
-    using iterator = std::list<DeferredPacket>::iterator;
+        /** Whether any queued prefetch targets the given address. */
+        bool
+        contains(Addr addr) const
+        {
+            return addrCount.find(addr) != addrCount.end();
+        }
+
+        /**
+         * Find the queued prefetch to the same address as pfi.
+         * @return The prefetch, or nullptr if there is none.
+         */
+        DeferredPacket *
+        find(const PrefetchInfo &pfi)
+        {
+            if (!contains(pfi.getAddr()))
+                return nullptr;
+            for (auto &level : levels) {
+                for (auto &dp : level.second) {
+                    if (dp.pfInfo.sameAddr(pfi))
+                        return &dp;
+                }
+            }
+            return nullptr;
+        }
+
+        /**
+         * Change the priority of a queued prefetch, which moves it behind
+         * all others of its new priority.
+         * @return The prefetch after the move.
+         */
+        DeferredPacket *
+        setPriority(DeferredPacket *dp, int32_t priority)
+        {
+            if (dp->priority == priority)
+                return dp;
+            auto loc = locate(dp);
+            Bucket &dst = levels[priority];
+            if constexpr (std::is_same_v<Bucket, std::list<DeferredPacket>>) {
+                dst.splice(dst.end(), loc.first->second, loc.second);
+            } else {
+                dst.push_back(std::move(*loc.second));
+                loc.first->second.erase(loc.second);
+            }
+            if (loc.first->second.empty())
+                levels.erase(loc.first);
+            dst.back().priority = priority;
+            return &dst.back();
+        }
+
+        /**
+         * Remove every prefetch for which pred returns true. The predicate
+         * is called on each entry exactly once, in queue order.
+         */
+        template <class Pred>
+        void
+        eraseIf(Pred pred)
+        {
+            for (auto level = levels.begin(); level != levels.end();) {
+                Bucket &bucket = level->second;
+                for (auto pos = bucket.begin(); pos != bucket.end();) {
+                    if (pred(*pos)) {
+                        unindex(pos->pfInfo.getAddr());
+                        pos = bucket.erase(pos);
+                    } else {
+                        ++pos;
+                    }
+                }
+                level = bucket.empty() ? levels.erase(level) : ++level;
+            }
+        }
+
+        /** Call f on every queued prefetch, in queue order. */
+        template <class F>
+        void
+        forEach(F f) const
+        {
+            for (const auto &level : levels) {
+                for (const auto &dp : level.second)
+                    f(dp);
+            }
+        }
+
+        /**
+         * Call f on the first max prefetches of the queue, in queue order.
+         * f must not change the queue.
+         */
+        template <class F>
+        void
+        forFirst(size_t max, F f)
+        {
+            for (auto &level : levels) {
+                for (auto &dp : level.second) {
+                    if (max-- == 0)
+                        return;
+                    f(dp);
+                }
+            }
+        }
+    };
+
+    /** Prefetches which are ready to be issued once their time comes. */
+    DeferredPacketQueue<std::deque<DeferredPacket>> pfq;
+    /**
+     * Prefetches waiting for an address translation. The TLB keeps a
+     * pointer to the entry while translating it, so it must not move.
+     */
+    DeferredPacketQueue<std::list<DeferredPacket>> pfqMissingTranslation;
+
+    /** A virtual page of a context, the unit translations are shared at */
+    typedef std::pair<ContextID, Addr> TranslationPage;
+
+    /** A translation of the prefetcher-private translation cache */
+    struct CachedTranslation
+    {
+        TranslationPage page;
+        /** Physical address of the page */
+        Addr paddr;
+        /** Last use, for LRU replacement */
+        uint64_t lastUse;
+    };
+
+    /**
+     * The pages translated recently, so that further prefetches to them
+     * skip the MMU. It is not shot down by TLB flushes: a stale entry
+     * can only make a prefetch useless, never an access wrong.
+     */
+    std::vector<CachedTranslation> translationCache;
+
+    /** Uses of the translation cache, to order its entries */
+    uint64_t translationCacheUses;
+
+    /**
+     * Pages with a translation in flight. The other prefetches to these
+     * pages wait for it instead of walking the page table again.
+     */
+    std::set<TranslationPage> pendingWalks;
 
     // PARAMETERS
 
@@ -157,6 +404,12 @@ class Queued : public Base
      */
     const unsigned missingTranslationQueueSize;
 
+    /** Number of pages the translation cache holds */
+    const unsigned translationCacheSize;
+
+    /** Maximum number of pages being translated at once */
+    const unsigned maxPendingWalks;
+
     /** Cycles after generation when a prefetch can first be issued */
     const Cycles latency;
 
@@ -172,9 +425,59 @@ class Queued : public Base
     /** Tag prefetch with PC of generating access? */
     const bool tagPrefetch;
 
+    /** Coordinator shared with the prefetchers of other levels, if any */
+    Coordinator *coordinator;
+
+    /** Cache level of the prefetcher, 1 being the closest to the CPU */
+    const unsigned coordinatorLevel;
+
     /** Percentage of requests that can be throttled */
     const unsigned int throttleControlPct;
 
+    /** Largest number of prefetches per access the feedback can allow */
+    const unsigned maxFeedbackDegree;
+
+    /**
+     * Number of prefetches allowed per access, adjusted by the feedback
+     * of each interval. Only used if the feedback is enabled.
+     */
+    unsigned feedbackDegree;
+
+    /**
+     * Prefetch distance and degree of an aggressiveness level. The
+     * distance is how many blocks, or strides, ahead of the triggering
+     * access the furthest prefetch goes.
+     */
+    struct Aggressiveness
+    {
+        unsigned distance;
+        unsigned degree;
+    };
+
+    /**
+     * The aggressiveness levels of Feedback Directed Prefetching, from
+     * the most conservative to the most aggressive one.
+     */
+    static const unsigned NumAggressivenessLevels = 5;
+    static const Aggressiveness aggressivenessLevels[NumAggressivenessLevels];
+
+    /**
+     * Current aggressiveness level, for prefetchers which adapt their
+     * distance and degree to the feedback. Starts in the middle.
+     */
+    unsigned aggressiveness;
+
+    /**
+     * Decide from the feedback of an interval whether prefetching should
+     * get more aggressive.
+     * @return 1 to increase the aggressiveness, -1 to decrease it and 0
+     *         to keep it
+     */
+    int feedbackDirection(const Feedback &fb) const;
+
+    /** Move the aggressiveness level according to the feedback. */
+    void adaptAggressiveness(const Feedback &fb);
+
     struct QueuedStats : public statistics::Group
     {
         QueuedStats(statistics::Group *parent);
@@ -185,7 +488,20 @@ class Queued : public Base
         statistics::Scalar pfRemovedDemand;
         statistics::Scalar pfRemovedFull;
         statistics::Scalar pfSpanPage;
+        statistics::Scalar pfCoordFiltered;
+        statistics::Scalar pfPushedUp;
+        statistics::Scalar pfHinted;
+        statistics::Scalar pfThrottled;
+        statistics::Scalar pfTranslationWalks;
+        statistics::Scalar pfTranslationCacheHits;
+        statistics::Scalar pfTranslationsCoalesced;
     } statsQueued;
+    /**
+     * Adapt the number of prefetches generated per access to their
+     * accuracy, lateness and cache pollution during the last interval.
+     */
+    void processFeedback(const Feedback &fb) override;
+
   public:
     using AddrPriority = std::pair<Addr, int32_t>;
 
@@ -196,16 +512,23 @@ class Queued : public Base
 
     void insert(const PacketPtr &pkt, PrefetchInfo &new_pfi, int32_t priority);
 
+    /**
+     * Queue a candidate pushed by the prefetcher of the level below.
+     * @param pkt The access which triggered the candidate
+     * @param pfi The candidate
+     * @param priority The priority of the candidate
+     */
+    void hint(const PacketPtr &pkt, const PrefetchInfo &pfi,
+              int32_t priority);
+
     virtual void calculatePrefetch(const PrefetchInfo &pfi,
                                    std::vector<AddrPriority> &addresses) = 0;
     PacketPtr getPacket() override;
 
-    Tick nextPrefetchReadyTime() const override
-    {
-        return pfq.empty() ? MaxTick : pfq.front().tick;
-    }
+    Tick nextPrefetchReadyTime() const override;
 
-    void printQueue(const std::list<DeferredPacket> &queue) const;
+    template <class Queue>
+    void printQueue(const Queue &queue) const;
 
   private:
 
@@ -214,17 +537,51 @@ class Queued : public Base
      * @param queue selected queue to use
      * @param dpp DeferredPacket to add
      */
-    void addToQueue(std::list<DeferredPacket> &queue, DeferredPacket &dpp);
+    template <class Queue>
+    void addToQueue(Queue &queue, DeferredPacket &dpp);
 
     /**
      * Starts the translations of the queued prefetches with a
      * missing translation. It performs a maximum specified number of
-     * translations. Successful translations cause the prefetch request to be
-     * queued in the queue of ready requests.
+     * translations. Prefetches to a page in the translation cache complete
+     * at once, and a single walk is started per page, up to
+     * maxPendingWalks at a time. Successful translations cause the
+     * prefetch request to be queued in the queue of ready requests.
      * @param max maximum number of translations to perform
      */
     void processMissingTranslations(unsigned max);
 
+    /** The virtual page a prefetch with a missing translation targets */
+    TranslationPage translationPage(const DeferredPacket &dp) const;
+
+    /**
+     * Look a page up in the translation cache.
+     * @return the physical address of the page, or MaxAddr on a miss
+     */
+    Addr lookupTranslation(const TranslationPage &page);
+
+    /** Remember the translation of a page, replacing the LRU one. */
+    void cacheTranslation(const TranslationPage &page, Addr paddr);
+
+    /**
+     * Complete the prefetches to a page which are not being translated
+     * themselves, once the page has been translated.
+     * @param page The page translated
+     * @param failed Whether the translation failed, which drops them
+     * @param paddr Physical address of the page
+     * @param max Maximum number of prefetches to complete
+     * @return number of prefetches completed
+     */
+    unsigned resolvePage(const TranslationPage &page, bool failed,
+                         Addr paddr, unsigned max);
+
+    /**
+     * Queue a translated prefetch as ready, unless it is redundant.
+     * @param dp the deferred packet translated
+     * @param target_paddr the physical address of the prefetch
+     */
+    void queueTranslated(DeferredPacket &dp, Addr target_paddr);
+
     /**
      * Indicates that the translation of the address of the provided  deferred
      * packet has been successfully completed, and it can be enqueued as a
@@ -242,8 +599,9 @@ class Queued : public Base
      * @param priority priority of the prefetch request to be added
      * @return True if the prefetch request was found in the queue
      */
-    bool alreadyInQueue(std::list<DeferredPacket> &queue,
-                        const PrefetchInfo &pfi, int32_t priority);
+    template <class Queue>
+    bool alreadyInQueue(Queue &queue, const PrefetchInfo &pfi,
+                        int32_t priority);
 
     /**
      * Returns the maxmimum number of prefetch requests that are allowed
@@ -255,6 +613,7 @@ class Queued : public Base
      */
     size_t getMaxPermittedPrefetches(size_t total) const;
 
+
     RequestPtr createPrefetchRequest(Addr addr, PrefetchInfo const &pfi,
                                         PacketPtr pkt);
 };
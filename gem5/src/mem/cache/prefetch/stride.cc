@@ -84,10 +84,21 @@ Stride::Stride(const StridePrefetcherParams &p)
     initConfidence(p.confidence_counter_bits, p.initial_confidence),
     threshConf(p.confidence_threshold/100.0),
     useRequestorId(p.use_requestor_id),
-    degree(p.degree),
+    degree(p.degree), adaptive(p.adaptive),
     pcTableInfo(p.table_assoc, p.table_entries, p.table_indexing_policy,
         p.table_replacement_policy)
 {
+    fatal_if(adaptive && !feedbackInterval,
+             "%s: adaptive prefetching needs a feedback_interval\n", name());
+}
+
+void
+Stride::processFeedback(const Feedback &fb)
+{
+    if (adaptive)
+        adaptAggressiveness(fb);
+    else
+        Queued::processFeedback(fb);
 }
 
 Stride::PCTable*
@@ -168,8 +179,17 @@ Stride::calculatePrefetch(const PrefetchInfo &pfi,
             return;
         }
 
-        // Generate up to degree prefetches
-        for (int d = 1; d <= degree; d++) {
+        // Generate up to degree prefetches, starting right after the
+        // access, or in adaptive mode ending at the current distance
+        int first = 1;
+        int last = degree;
+        if (adaptive) {
+            const Aggressiveness &level =
+                aggressivenessLevels[aggressiveness];
+            last = level.distance;
+            first = level.distance - level.degree + 1;
+        }
+        for (int d = first; d <= last; d++) {
             // Round strides up to atleast 1 cacheline
             int prefetch_stride = new_stride;
             if (abs(new_stride) < blkSize) {
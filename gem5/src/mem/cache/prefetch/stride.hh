@@ -105,7 +105,12 @@ class Stride : public Queued
 
     const bool useRequestorId;
 
-    const int degree;
+    int degree;
+
+    /** Adapt distance and degree to the prefetch feedback */
+    const bool adaptive;
+
+    void processFeedback(const Feedback &fb) override;
 
     /**
      * Information used to create a new PC table. All of them behave equally.
@@ -161,6 +166,9 @@ class Stride : public Queued
   public:
     Stride(const StridePrefetcherParams &p);
 
+    /** Change the prefetch degree, e.g. in a forked simulation */
+    void setDegree(int new_degree) { degree = new_degree; }
+
     void calculatePrefetch(const PrefetchInfo &pfi,
                            std::vector<AddrPriority> &addresses) override;
 };
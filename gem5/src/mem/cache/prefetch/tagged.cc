@@ -33,6 +33,7 @@
 
 #include "mem/cache/prefetch/tagged.hh"
 
+#include "base/logging.hh"
 #include "params/TaggedPrefetcher.hh"
 
 namespace gem5
@@ -43,9 +44,19 @@ namespace prefetch
 {
 
 Tagged::Tagged(const TaggedPrefetcherParams &p)
-    : Queued(p), degree(p.degree)
+    : Queued(p), degree(p.degree), adaptive(p.adaptive)
 {
+    fatal_if(adaptive && !feedbackInterval,
+             "%s: adaptive prefetching needs a feedback_interval\n", name());
+}
 
+void
+Tagged::processFeedback(const Feedback &fb)
+{
+    if (adaptive)
+        adaptAggressiveness(fb);
+    else
+        Queued::processFeedback(fb);
 }
 
 void
@@ -54,7 +65,17 @@ Tagged::calculatePrefetch(const PrefetchInfo &pfi,
 {
     Addr blkAddr = blockAddress(pfi.getAddr());
 
-    for (int d = 1; d <= degree; d++) {
+    // In adaptive mode, prefetch the last blocks up to the current
+    // distance; otherwise the blocks right after the access
+    int first = 1;
+    int last = degree;
+    if (adaptive) {
+        const Aggressiveness &level = aggressivenessLevels[aggressiveness];
+        last = level.distance;
+        first = level.distance - level.degree + 1;
+    }
+
+    for (int d = first; d <= last; d++) {
         Addr newAddr = blkAddr + d*(blkSize);
         addresses.push_back(AddrPriority(newAddr,0));
     }
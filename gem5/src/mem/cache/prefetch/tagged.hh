@@ -51,6 +51,11 @@ class Tagged : public Queued
   protected:
       const int degree;
 
+      /** Adapt distance and degree to the prefetch feedback */
+      const bool adaptive;
+
+      void processFeedback(const Feedback &fb) override;
+
   public:
     Tagged(const TaggedPrefetcherParams &p);
     ~Tagged() = default;
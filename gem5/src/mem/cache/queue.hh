@@ -45,10 +45,14 @@
 #ifndef __MEM_CACHE_QUEUE_HH__
 #define __MEM_CACHE_QUEUE_HH__
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <string>
 #include <type_traits>
+#include <vector>
 
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/named.hh"
 #include "base/trace.hh"
@@ -101,6 +105,60 @@ class Queue : public Drainable, public Named
     /** Holds non allocated entries. */
     typename Entry::List freeList;
 
+    /**
+     * Index of the allocated entries by block address. A bucket chains its
+     * entries through QueueEntry::nextInBucket, in allocation order, so
+     * lookups only visit entries that are likely to match.
+     */
+    std::vector<QueueEntry*> buckets;
+
+    /** Shift turning a hashed address into a bucket index. */
+    const int bucketShift;
+
+    std::size_t bucketIndex(Addr blk_addr) const
+    {
+        // Fibonacci hashing, which spreads block aligned addresses well
+        return (blk_addr * 0x9e3779b97f4a7c15ULL) >> bucketShift;
+    }
+
+    Entry* bucketHead(Addr blk_addr) const
+    {
+        return static_cast<Entry*>(buckets[bucketIndex(blk_addr)]);
+    }
+
+    static Entry* nextInBucket(const Entry* entry)
+    {
+        return static_cast<Entry*>(entry->nextInBucket);
+    }
+
+    /**
+     * Add a newly allocated entry to the allocated list and to the index.
+     * This must be done once the entry's block address is set.
+     */
+    typename Entry::Iterator addToAllocatedList(Entry* entry)
+    {
+        QueueEntry** link = &buckets[bucketIndex(entry->blkAddr)];
+        while (*link) {
+            link = &(*link)->nextInBucket;
+        }
+        entry->nextInBucket = nullptr;
+        *link = entry;
+        return allocatedList.insert(allocatedList.end(), entry);
+    }
+
+    /** Remove an entry from the allocated list and the index. */
+    void removeFromAllocatedList(Entry* entry)
+    {
+        QueueEntry** link = &buckets[bucketIndex(entry->blkAddr)];
+        while (*link != entry) {
+            assert(*link);
+            link = &(*link)->nextInBucket;
+        }
+        *link = entry->nextInBucket;
+        entry->nextInBucket = nullptr;
+        allocatedList.erase(entry->allocIter);
+    }
+
     typename Entry::Iterator addToReadyList(Entry* entry)
     {
         if (readyList.empty() ||
@@ -135,6 +193,8 @@ class Queue : public Drainable, public Named
         Named(name),
         label(_label), numEntries(num_entries + reserve),
         numReserve(reserve), entries(numEntries, name + ".entry"),
+        buckets(std::max(16, 2 << ceilLog2(numEntries)), nullptr),
+        bucketShift(64 - floorLog2(buckets.size())),
         _numInService(0), allocated(0)
     {
         for (int i = 0; i < numEntries; ++i) {
@@ -168,7 +228,8 @@ class Queue : public Drainable, public Named
     Entry* findMatch(Addr blk_addr, bool is_secure,
                      bool ignore_uncacheable = true) const
     {
-        for (const auto& entry : allocatedList) {
+        for (Entry* entry = bucketHead(blk_addr); entry;
+             entry = nextInBucket(entry)) {
             // we ignore any entries allocated for uncacheable
             // accesses and simply ignore them when matching, in the
             // cache we never check for matches when adding new
@@ -206,6 +267,23 @@ class Queue : public Drainable, public Named
      */
     Entry* findPending(const QueueEntry* entry) const
     {
+        // Entries are on the ready list until they are in service. As
+        // conflicting entries have the same block address, they are in
+        // the same bucket, and a single one needs no ordering.
+        Entry* pending = nullptr;
+        int conflicts = 0;
+        for (Entry* candidate = bucketHead(entry->blkAddr);
+             candidate && conflicts < 2; candidate = nextInBucket(candidate)) {
+            if (!candidate->inService && candidate->conflictAddr(entry)) {
+                pending = candidate;
+                conflicts++;
+            }
+        }
+        if (conflicts < 2) {
+            return pending;
+        }
+
+        // Return the earliest of several conflicting entries
         for (const auto& ready_entry : readyList) {
             if (ready_entry->conflictAddr(entry)) {
                 return ready_entry;
@@ -240,7 +318,7 @@ class Queue : public Drainable, public Named
     virtual void
     deallocate(Entry *entry)
     {
-        allocatedList.erase(entry->allocIter);
+        removeFromAllocatedList(entry);
         freeList.push_front(entry);
         allocated--;
         if (entry->inService) {
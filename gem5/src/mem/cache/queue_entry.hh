@@ -121,10 +121,14 @@ class QueueEntry : public Packet::SenderState, public Named
     /** True if the entry targets the secure memory space. */
     bool isSecure;
 
+    /** Next allocated entry in the same bucket of the queue's index. */
+    QueueEntry *nextInBucket;
+
     QueueEntry(const std::string &name)
         : Named(name),
           readyTime(0), _isUncacheable(false),
-          inService(false), order(0), blkAddr(0), blkSize(0), isSecure(false)
+          inService(false), order(0), blkAddr(0), blkSize(0), isSecure(false),
+          nextInBucket(nullptr)
     {}
 
     bool isUncacheable() const { return _isUncacheable; }
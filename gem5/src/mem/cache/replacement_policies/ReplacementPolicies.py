@@ -47,11 +47,33 @@ class DuelingRP(BaseReplacementPolicy):
         "Sub-replacement policy A")
     replacement_policy_b = Param.BaseReplacementPolicy(
         "Sub-replacement policy B")
+    psel_bits = Param.Unsigned(10, "Number of bits of the policy selector")
+    psel_low_threshold = Param.Float(0.5, "Selector saturation below "
+        "which policy A becomes the winner")
+    psel_high_threshold = Param.Float(0.5, "Selector saturation at or above "
+        "which policy B becomes the winner")
+    leader_sets = Param.Unsigned(32, "Number of leader sets per sub-policy, "
+        "used by setGeometry() to derive the constituency size")
+    epoch_length = Param.Unsigned(16384, "Number of victimizations per "
+        "epoch when recording which sub-policy won")
+
+    def setGeometry(self, size, assoc, block_size):
+        """Derive the constituency and team sizes of a set-dueling policy
+        from the geometry of the tags it is attached to. Each constituency
+        holds one leader set of each team, so there are leader_sets of
+        them; the remaining sets follow the winner."""
+        num_sets = int(size) // (int(assoc) * int(block_size))
+        leader_sets = max(1, min(int(self.leader_sets), num_sets // 2))
+        self.constituency_size = (num_sets // leader_sets) * int(assoc)
+        self.team_size = int(assoc)
 
 class FIFORP(BaseReplacementPolicy):
     type = 'FIFORP'
     cxx_class = 'gem5::replacement_policy::FIFO'
     cxx_header = "mem/cache/replacement_policies/fifo_rp.hh"
+    set_size = Param.Unsigned(0, "Number of consecutive entries sharing "
+        "packed per-set metadata, usually the associativity. Requires "
+        "candidates from a single set. Zero keeps data per entry")
 
 class SecondChanceRP(FIFORP):
     type = 'SecondChanceRP'
@@ -67,6 +89,9 @@ class LRURP(BaseReplacementPolicy):
     type = 'LRURP'
     cxx_class = 'gem5::replacement_policy::LRU'
     cxx_header = "mem/cache/replacement_policies/lru_rp.hh"
+    set_size = Param.Unsigned(0, "Number of consecutive entries sharing "
+        "packed per-set metadata, usually the associativity. Requires "
+        "candidates from a single set. Zero keeps data per entry")
 
 class BIPRP(LRURP):
     type = 'BIPRP'
@@ -96,10 +121,20 @@ class BRRIPRP(BaseReplacementPolicy):
         "Prioritize evicting blocks that havent had a hit recently")
     btp = Param.Percent(3,
         "Percentage of blocks to be inserted with long RRPV")
+    set_size = Param.Unsigned(0, "Number of consecutive entries sharing "
+        "packed per-set metadata, usually the associativity. Requires "
+        "candidates from a single set. Zero keeps data per entry")
 
 class RRIPRP(BRRIPRP):
     btp = 100
 
+class DIPRP(DuelingRP):
+    # Dynamic insertion (Qureshi et al., ISCA'07): duel LRU against the
+    # thrash-resistant bimodal insertion. The constituency_size and the
+    # team_size must be provided, either manually or with setGeometry()
+    replacement_policy_a = LRURP()
+    replacement_policy_b = BIPRP()
+
 class DRRIPRP(DuelingRP):
     # The constituency_size and the team_size must be manually provided, where:
     #     constituency_size = num_cache_entries /
@@ -107,6 +142,8 @@ class DRRIPRP(DuelingRP):
     # The paper assumes that:
     #     num_dueling_sets = 32
     #     team_size = num_entries_per_set
+    # setGeometry() derives both from the cache size, using leader_sets as
+    # num_dueling_sets
     replacement_policy_a = BRRIPRP()
     replacement_policy_b = RRIPRP()
 
@@ -139,6 +176,22 @@ class SHiPPCRP(SHiPRP):
     cxx_class = 'gem5::replacement_policy::SHiPPC'
     cxx_header = "mem/cache/replacement_policies/ship_rp.hh"
 
+class HawkeyeRP(BRRIPRP):
+    type = 'HawkeyeRP'
+    cxx_class = 'gem5::replacement_policy::Hawkeye'
+    cxx_header = "mem/cache/replacement_policies/hawkeye_rp.hh"
+
+    num_bits = 3
+    predictor_size = Param.Unsigned(2048, "Number of predictor entries")
+    predictor_bits = Param.Unsigned(3, "Number of bits per predictor entry")
+    num_sampled_sets = Param.Unsigned(64, "Number of sets trained by OPTgen")
+    history_factor = Param.Unsigned(8, "Number of accesses to a sampled set "
+        "OPTgen looks back at, as a multiple of the associativity")
+    size = Param.MemorySize(Parent.size, "Capacity of the cache")
+    assoc = Param.Unsigned(Parent.assoc, "Associativity of the cache")
+    block_size = Param.Unsigned(Parent.cache_line_size,
+        "Size of a cache line, in bytes")
+
 class TreePLRURP(BaseReplacementPolicy):
     type = 'TreePLRURP'
     cxx_class = 'gem5::replacement_policy::TreePLRU'
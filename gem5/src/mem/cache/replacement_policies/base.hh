@@ -32,6 +32,7 @@
 #include <memory>
 
 #include "base/compiler.hh"
+#include "base/fast_random.hh"
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "mem/packet.hh"
 #include "params/BaseReplacementPolicy.hh"
@@ -40,11 +41,6 @@
 namespace gem5
 {
 
-/**
- * Replacement candidates as chosen by the indexing policy.
- */
-typedef std::vector<ReplaceableEntry*> ReplacementCandidates;
-
 GEM5_DEPRECATED_NAMESPACE(ReplacementPolicy, replacement_policy);
 namespace replacement_policy
 {
@@ -54,11 +50,30 @@ namespace replacement_policy
  */
 class Base : public SimObject
 {
+  protected:
+    /**
+     * Generator for the policies that make random decisions, seeded from
+     * the policy's name so its sequence doesn't depend on other objects.
+     */
+    mutable FastRandom rng;
+
   public:
     typedef BaseReplacementPolicyParams Params;
-    Base(const Params &p) : SimObject(p) {}
+    Base(const Params &p) : SimObject(p), rng(p.name) {}
     virtual ~Base() = default;
 
+    void
+    serialize(CheckpointOut &cp) const override
+    {
+        rng.serializeSection(cp, "rng");
+    }
+
+    void
+    unserialize(CheckpointIn &cp) override
+    {
+        rng.unserializeSection(cp, "rng");
+    }
+
     /**
      * Invalidate replacement data to set it as the next probable victim.
      *
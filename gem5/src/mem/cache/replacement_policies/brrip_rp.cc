@@ -28,11 +28,11 @@
 
 #include "mem/cache/replacement_policies/brrip_rp.hh"
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 
 #include "base/logging.hh" // For fatal_if
-#include "base/random.hh"
 #include "params/BRRIPRP.hh"
 
 namespace gem5
@@ -44,7 +44,7 @@ namespace replacement_policy
 
 BRRIP::BRRIP(const Params &p)
   : Base(p), numRRPVBits(p.num_bits), hitPriority(p.hit_priority),
-    btp(p.btp)
+    btp(p.btp), setSize(p.set_size), packedSets(std::max(setSize, 1U))
 {
     fatal_if(numRRPVBits <= 0, "There should be at least one bit per RRPV.\n");
 }
@@ -52,6 +52,12 @@ BRRIP::BRRIP(const Params &p)
 void
 BRRIP::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
 {
+    if (setSize) {
+        auto *data = PackedSets<RRPVSet>::get(replacement_data);
+        data->set->valid[data->way] = false;
+        return;
+    }
+
     std::shared_ptr<BRRIPReplData> casted_replacement_data =
         std::static_pointer_cast<BRRIPReplData>(replacement_data);
 
@@ -62,6 +68,14 @@ BRRIP::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
 void
 BRRIP::touch(const std::shared_ptr<ReplacementData>& replacement_data) const
 {
+    if (setSize) {
+        auto *data = PackedSets<RRPVSet>::get(replacement_data);
+        const unsigned rrpv = data->set->get(data->way);
+        data->set->set(data->way,
+            (hitPriority || rrpv == 0) ? 0 : rrpv - 1);
+        return;
+    }
+
     std::shared_ptr<BRRIPReplData> casted_replacement_data =
         std::static_pointer_cast<BRRIPReplData>(replacement_data);
 
@@ -78,6 +92,17 @@ BRRIP::touch(const std::shared_ptr<ReplacementData>& replacement_data) const
 void
 BRRIP::reset(const std::shared_ptr<ReplacementData>& replacement_data) const
 {
+    if (setSize) {
+        auto *data = PackedSets<RRPVSet>::get(replacement_data);
+        unsigned rrpv = data->set->maxRRPV();
+        if (rng.random<unsigned>(1, 100) <= btp) {
+            rrpv--;
+        }
+        data->set->set(data->way, rrpv);
+        data->set->valid[data->way] = true;
+        return;
+    }
+
     std::shared_ptr<BRRIPReplData> casted_replacement_data =
         std::static_pointer_cast<BRRIPReplData>(replacement_data);
 
@@ -85,7 +110,7 @@ BRRIP::reset(const std::shared_ptr<ReplacementData>& replacement_data) const
     // Replacement data is inserted as "long re-reference" if lower than btp,
     // "distant re-reference" otherwise
     casted_replacement_data->rrpv.saturate();
-    if (random_mt.random<unsigned>(1, 100) <= btp) {
+    if (rng.random<unsigned>(1, 100) <= btp) {
         casted_replacement_data->rrpv--;
     }
 
@@ -93,9 +118,49 @@ BRRIP::reset(const std::shared_ptr<ReplacementData>& replacement_data) const
     casted_replacement_data->valid = true;
 }
 
+ReplaceableEntry*
+BRRIP::getPackedVictim(const ReplacementCandidates& candidates) const
+{
+    assert(candidates.size() > 0);
+
+    ReplaceableEntry* victim = candidates[0];
+    RRPVSet *set = PackedSets<RRPVSet>::get(victim->replacementData)->set;
+    unsigned victim_rrpv = 0;
+
+    // Stop at the first invalid entry, otherwise pick the highest RRPV
+    for (const auto& candidate : candidates) {
+        auto *data = PackedSets<RRPVSet>::get(candidate->replacementData);
+        assert(data->set == set);
+        if (!set->valid[data->way]) {
+            return candidate;
+        }
+        const unsigned rrpv = set->get(data->way);
+        if (rrpv > victim_rrpv) {
+            victim = candidate;
+            victim_rrpv = rrpv;
+        }
+    }
+
+    // Age all candidates so that the victim has the most distant RRPV
+    const unsigned diff = set->maxRRPV() - victim_rrpv;
+    if (diff > 0) {
+        for (const auto& candidate : candidates) {
+            const unsigned way =
+                PackedSets<RRPVSet>::get(candidate->replacementData)->way;
+            set->set(way, std::min(set->get(way) + diff, set->maxRRPV()));
+        }
+    }
+
+    return victim;
+}
+
 ReplaceableEntry*
 BRRIP::getVictim(const ReplacementCandidates& candidates) const
 {
+    if (setSize) {
+        return getPackedVictim(candidates);
+    }
+
     // There must be at least one replacement candidate
     assert(candidates.size() > 0);
 
@@ -103,14 +168,13 @@ BRRIP::getVictim(const ReplacementCandidates& candidates) const
     ReplaceableEntry* victim = candidates[0];
 
     // Store victim->rrpv in a variable to improve code readability
-    int victim_RRPV = std::static_pointer_cast<BRRIPReplData>(
-                        victim->replacementData)->rrpv;
+    int victim_RRPV = static_cast<BRRIPReplData*>(
+                        victim->replacementData.get())->rrpv;
 
     // Visit all candidates to find victim
     for (const auto& candidate : candidates) {
-        std::shared_ptr<BRRIPReplData> candidate_repl_data =
-            std::static_pointer_cast<BRRIPReplData>(
-                candidate->replacementData);
+        BRRIPReplData* candidate_repl_data =
+            static_cast<BRRIPReplData*>(candidate->replacementData.get());
 
         // Stop searching for victims if an invalid entry is found
         if (!candidate_repl_data->valid) {
@@ -127,15 +191,15 @@ BRRIP::getVictim(const ReplacementCandidates& candidates) const
 
     // Get difference of victim's RRPV to the highest possible RRPV in
     // order to update the RRPV of all the other entries accordingly
-    int diff = std::static_pointer_cast<BRRIPReplData>(
-        victim->replacementData)->rrpv.saturate();
+    int diff = static_cast<BRRIPReplData*>(
+        victim->replacementData.get())->rrpv.saturate();
 
     // No need to update RRPV if there is no difference
     if (diff > 0){
         // Update RRPV of all candidates
         for (const auto& candidate : candidates) {
-            std::static_pointer_cast<BRRIPReplData>(
-                candidate->replacementData)->rrpv += diff;
+            static_cast<BRRIPReplData*>(
+                candidate->replacementData.get())->rrpv += diff;
         }
     }
 
@@ -145,6 +209,9 @@ BRRIP::getVictim(const ReplacementCandidates& candidates) const
 std::shared_ptr<ReplacementData>
 BRRIP::instantiateEntry()
 {
+    if (setSize) {
+        return packedSets.instantiateEntry(numRRPVBits);
+    }
     return std::shared_ptr<ReplacementData>(new BRRIPReplData(numRRPVBits));
 }
 
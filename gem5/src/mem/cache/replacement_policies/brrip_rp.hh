@@ -54,6 +54,7 @@
 
 #include "base/sat_counter.hh"
 #include "mem/cache/replacement_policies/base.hh"
+#include "mem/cache/replacement_policies/packed_repl_data.hh"
 
 namespace gem5
 {
@@ -91,6 +92,51 @@ class BRRIP : public Base
         }
     };
 
+    /**
+     * The RRPVs and valid bits of all the ways of a set, packed in words.
+     * A field never straddles two words.
+     */
+    struct RRPVSet
+    {
+        /** Number of bits per RRPV. */
+        const unsigned numBits;
+
+        /** Number of RRPVs per word. */
+        const unsigned perWord;
+
+        /** The packed RRPVs. */
+        std::vector<uint64_t> rrpvs;
+
+        /** The valid bits. */
+        std::vector<bool> valid;
+
+        RRPVSet(unsigned num_ways, unsigned num_bits)
+          : numBits(num_bits), perWord(64 / num_bits),
+            rrpvs((num_ways + perWord - 1) / perWord, 0),
+            valid(num_ways, false)
+        {
+        }
+
+        /** The highest RRPV. */
+        unsigned maxRRPV() const { return (1U << numBits) - 1; }
+
+        unsigned
+        get(unsigned way) const
+        {
+            const unsigned shift = (way % perWord) * numBits;
+            return (rrpvs[way / perWord] >> shift) & maxRRPV();
+        }
+
+        void
+        set(unsigned way, unsigned rrpv)
+        {
+            const unsigned shift = (way % perWord) * numBits;
+            uint64_t &word = rrpvs[way / perWord];
+            word = (word & ~(uint64_t(maxRRPV()) << shift)) |
+                (uint64_t(rrpv) << shift);
+        }
+    };
+
     /**
      * Number of RRPV bits. An entry that saturates its RRPV has the longest
      * possible re-reference interval, that is, it is likely not to be used
@@ -112,6 +158,19 @@ class BRRIP : public Base
      */
     const unsigned btp;
 
+    /**
+     * Number of ways sharing packed RRPVs, or zero to keep replacement data
+     * per entry.
+     */
+    const unsigned setSize;
+
+    /** The packed per-set metadata, used if setSize is not zero. */
+    PackedSets<RRPVSet> packedSets;
+
+    /** Find the victim among candidates using packed metadata. */
+    ReplaceableEntry* getPackedVictim(
+        const ReplacementCandidates& candidates) const;
+
   public:
     typedef BRRIPRPParams Params;
     BRRIP(const Params &p);
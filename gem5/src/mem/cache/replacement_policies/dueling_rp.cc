@@ -40,8 +40,10 @@ namespace replacement_policy
 Dueling::Dueling(const Params &p)
   : Base(p), replPolicyA(p.replacement_policy_a),
     replPolicyB(p.replacement_policy_b),
-    duelingMonitor(p.constituency_size, p.team_size),
-    duelingStats(this)
+    duelingMonitor(p.constituency_size, p.team_size, p.psel_bits,
+        p.psel_low_threshold, p.psel_high_threshold),
+    epochLength(p.epoch_length), epochVictims(0),
+    lastWinner(!duelingMonitor.getWinner()), duelingStats(this)
 {
     fatal_if((replPolicyA == nullptr) || (replPolicyB == nullptr),
         "All replacement policies must be instantiated");
@@ -117,6 +119,18 @@ Dueling::getVictim(const ReplacementCandidates& candidates) const
 
     // The team with the most misses loses
     bool winner = !duelingMonitor.getWinner();
+    if (winner != lastWinner) {
+        duelingStats.winnerChanges++;
+        lastWinner = winner;
+    }
+    if ((epochLength != 0) && (++epochVictims >= epochLength)) {
+        if (winner) {
+            duelingStats.epochsWonB++;
+        } else {
+            duelingStats.epochsWonA++;
+        }
+        epochVictims = 0;
+    }
 
     // If the entry is a sample, it can only be used with a certain policy.
     bool team;
@@ -185,7 +199,10 @@ Dueling::instantiateEntry()
 Dueling::DuelingStats::DuelingStats(statistics::Group* parent)
   : statistics::Group(parent),
     ADD_STAT(selectedA, "Number of times A was selected to victimize"),
-    ADD_STAT(selectedB, "Number of times B was selected to victimize")
+    ADD_STAT(selectedB, "Number of times B was selected to victimize"),
+    ADD_STAT(epochsWonA, "Number of epochs that ended with A winning"),
+    ADD_STAT(epochsWonB, "Number of epochs that ended with B winning"),
+    ADD_STAT(winnerChanges, "Number of times the winning policy changed")
 {
 }
 
@@ -82,6 +82,15 @@ class Dueling : public Base
      */
     mutable DuelingMonitor duelingMonitor;
 
+    /** Number of victimizations that make up an epoch. Zero disables. */
+    const unsigned epochLength;
+
+    /** Victimizations performed in the current epoch. */
+    mutable unsigned epochVictims;
+
+    /** Winner of the duel at the previous victimization. */
+    mutable bool lastWinner;
+
     mutable struct DuelingStats : public statistics::Group
     {
         DuelingStats(statistics::Group* parent);
@@ -91,6 +100,15 @@ class Dueling : public Base
 
         /** Number of times B was selected on victimization. */
         statistics::Scalar selectedB;
+
+        /** Number of epochs that ended with A as the winner. */
+        statistics::Scalar epochsWonA;
+
+        /** Number of epochs that ended with B as the winner. */
+        statistics::Scalar epochsWonB;
+
+        /** Number of times the winner changed. */
+        statistics::Scalar winnerChanges;
     } duelingStats;
 
   public:
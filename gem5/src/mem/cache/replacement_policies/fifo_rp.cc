@@ -28,6 +28,7 @@
 
 #include "mem/cache/replacement_policies/fifo_rp.hh"
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 
@@ -42,13 +43,19 @@ namespace replacement_policy
 {
 
 FIFO::FIFO(const Params &p)
-  : Base(p)
+  : Base(p), setSize(p.set_size), packedSets(std::max(setSize, 1U))
 {
 }
 
 void
 FIFO::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
 {
+    if (setSize) {
+        auto *data = PackedSets<RankSet>::get(replacement_data);
+        data->set->demote(data->way);
+        return;
+    }
+
     // Reset insertion tick
     std::static_pointer_cast<FIFOReplData>(
         replacement_data)->tickInserted = Tick(0);
@@ -63,6 +70,13 @@ FIFO::touch(const std::shared_ptr<ReplacementData>& replacement_data) const
 void
 FIFO::reset(const std::shared_ptr<ReplacementData>& replacement_data) const
 {
+    if (setSize) {
+        // The newest entry is the last one to be evicted
+        auto *data = PackedSets<RankSet>::get(replacement_data);
+        data->set->promote(data->way);
+        return;
+    }
+
     // Set insertion tick
     std::static_pointer_cast<FIFOReplData>(
         replacement_data)->tickInserted = curTick();
@@ -71,6 +85,10 @@ FIFO::reset(const std::shared_ptr<ReplacementData>& replacement_data) const
 ReplaceableEntry*
 FIFO::getVictim(const ReplacementCandidates& candidates) const
 {
+    if (setSize) {
+        return rankVictim(candidates);
+    }
+
     // There must be at least one replacement candidate
     assert(candidates.size() > 0);
 
@@ -78,10 +96,10 @@ FIFO::getVictim(const ReplacementCandidates& candidates) const
     ReplaceableEntry* victim = candidates[0];
     for (const auto& candidate : candidates) {
         // Update victim entry if necessary
-        if (std::static_pointer_cast<FIFOReplData>(
-                    candidate->replacementData)->tickInserted <
-                std::static_pointer_cast<FIFOReplData>(
-                    victim->replacementData)->tickInserted) {
+        if (static_cast<FIFOReplData*>(
+                    candidate->replacementData.get())->tickInserted <
+                static_cast<FIFOReplData*>(
+                    victim->replacementData.get())->tickInserted) {
             victim = candidate;
         }
     }
@@ -92,6 +110,9 @@ FIFO::getVictim(const ReplacementCandidates& candidates) const
 std::shared_ptr<ReplacementData>
 FIFO::instantiateEntry()
 {
+    if (setSize) {
+        return packedSets.instantiateEntry();
+    }
     return std::shared_ptr<ReplacementData>(new FIFOReplData());
 }
 
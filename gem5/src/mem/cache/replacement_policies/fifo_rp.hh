@@ -38,6 +38,7 @@
 
 #include "base/types.hh"
 #include "mem/cache/replacement_policies/base.hh"
+#include "mem/cache/replacement_policies/packed_repl_data.hh"
 
 namespace gem5
 {
@@ -63,6 +64,15 @@ class FIFO : public Base
         FIFOReplData() : tickInserted(0) {}
     };
 
+    /**
+     * Number of ways sharing packed rank metadata, or zero to keep a
+     * timestamp per entry.
+     */
+    const unsigned setSize;
+
+    /** The packed per-set metadata, used if setSize is not zero. */
+    PackedSets<RankSet> packedSets;
+
   public:
     typedef FIFORPParams Params;
     FIFO(const Params &p);
@@ -0,0 +1,229 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/replacement_policies/hawkeye_rp.hh"
+
+#include <algorithm>
+
+#include "base/logging.hh"
+#include "params/HawkeyeRP.hh"
+
+namespace gem5
+{
+
+namespace replacement_policy
+{
+
+Hawkeye::Hawkeye(const Params &p)
+  : BRRIP(p), assoc(p.assoc), blockSize(p.block_size),
+    numSets(std::max<uint64_t>(1, p.size / (p.assoc * p.block_size))),
+    setStride(std::max<uint64_t>(1, numSets / p.num_sampled_sets)),
+    historyLength(p.history_factor * p.assoc),
+    friendlyThreshold(1 << (p.predictor_bits - 1)),
+    predictor(p.predictor_size,
+        SatCounter8(p.predictor_bits, 1 << (p.predictor_bits - 1))),
+    sampledSets((numSets + setStride - 1) / setStride),
+    hawkeyeStats(this)
+{
+    fatal_if(setSize, "Hawkeye does not support packed metadata");
+    fatal_if(p.num_sampled_sets == 0, "Hawkeye needs sampled sets");
+    fatal_if(assoc > 255, "OPTgen occupancy is limited to 255 ways");
+    for (auto &set : sampledSets) {
+        set.occupancy.resize(historyLength, 0);
+    }
+}
+
+Hawkeye::SignatureType
+Hawkeye::getSignature(const PacketPtr pkt) const
+{
+    // Accesses without a PC, such as writebacks, share a signature
+    SignatureType signature = 0;
+    if (pkt->req->hasPC()) {
+        signature = static_cast<SignatureType>(pkt->req->getPC());
+    }
+    return signature % predictor.size();
+}
+
+void
+Hawkeye::sample(const PacketPtr pkt, SignatureType signature, bool friendly)
+{
+    const Addr line = pkt->getAddr() / blockSize;
+    const uint64_t set_index = line % numSets;
+    if (set_index % setStride) {
+        return;
+    }
+    hawkeyeStats.samplerAccesses++;
+
+    SampledSet &set = sampledSets[set_index / setStride];
+    const uint64_t now = set.time;
+
+    auto it = set.lines.find(line);
+    if (it != set.lines.end()) {
+        const SamplerEntry &last = it->second;
+
+        // OPT keeps the line alive since its last access if there was
+        // room for it at every access in between
+        bool opt_hit = (now - last.lastTime) < historyLength;
+        for (uint64_t t = last.lastTime; opt_hit && t < now; t++) {
+            if (set.occupancy[t % historyLength] >= assoc) {
+                opt_hit = false;
+            }
+        }
+
+        if (opt_hit) {
+            for (uint64_t t = last.lastTime; t < now; t++) {
+                set.occupancy[t % historyLength]++;
+            }
+            predictor[last.signature]++;
+            hawkeyeStats.optHits++;
+        } else {
+            predictor[last.signature]--;
+            hawkeyeStats.optMisses++;
+        }
+        if (opt_hit == last.friendly) {
+            hawkeyeStats.correctPredictions++;
+        }
+    }
+
+    // Advance OPTgen's time, forgetting the oldest access
+    set.occupancy[now % historyLength] = 0;
+    set.lines[line] = {now, signature, friendly};
+    set.time++;
+
+    // Lines not reused within the history would have been evicted by OPT
+    if (set.lines.size() > 2 * historyLength) {
+        for (auto line_it = set.lines.begin(); line_it != set.lines.end();) {
+            if (set.time - line_it->second.lastTime > historyLength) {
+                predictor[line_it->second.signature]--;
+                line_it = set.lines.erase(line_it);
+            } else {
+                line_it++;
+            }
+        }
+    }
+}
+
+void
+Hawkeye::access(const std::shared_ptr<ReplacementData>& replacement_data,
+    const PacketPtr pkt)
+{
+    HawkeyeReplData* casted_replacement_data =
+        static_cast<HawkeyeReplData*>(replacement_data.get());
+
+    const SignatureType signature = getSignature(pkt);
+    const bool friendly = predictor[signature] >= friendlyThreshold;
+    sample(pkt, signature, friendly);
+
+    // Cache-friendly lines are expected to be re-referenced soon, while
+    // cache-averse lines are the first candidates for eviction
+    casted_replacement_data->signature = signature;
+    casted_replacement_data->friendly = friendly;
+    if (friendly) {
+        casted_replacement_data->rrpv.reset();
+        hawkeyeStats.friendlyAccesses++;
+    } else {
+        casted_replacement_data->rrpv.saturate();
+        hawkeyeStats.averseAccesses++;
+    }
+}
+
+void
+Hawkeye::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
+{
+    HawkeyeReplData* casted_replacement_data =
+        static_cast<HawkeyeReplData*>(replacement_data.get());
+
+    // Evicting a line predicted cache-friendly means the predictor was
+    // too optimistic about the PC that last accessed it
+    if (casted_replacement_data->valid && casted_replacement_data->friendly) {
+        predictor[casted_replacement_data->signature]--;
+        hawkeyeStats.friendlyEvictions++;
+    }
+    casted_replacement_data->friendly = false;
+
+    BRRIP::invalidate(replacement_data);
+}
+
+void
+Hawkeye::touch(const std::shared_ptr<ReplacementData>& replacement_data,
+    const PacketPtr pkt)
+{
+    access(replacement_data, pkt);
+}
+
+void
+Hawkeye::touch(const std::shared_ptr<ReplacementData>& replacement_data)
+    const
+{
+    panic("Cant train Hawkeye's predictor without access information.");
+}
+
+void
+Hawkeye::reset(const std::shared_ptr<ReplacementData>& replacement_data,
+    const PacketPtr pkt)
+{
+    access(replacement_data, pkt);
+
+    // Mark entry as ready to be used
+    static_cast<HawkeyeReplData*>(replacement_data.get())->valid = true;
+}
+
+void
+Hawkeye::reset(const std::shared_ptr<ReplacementData>& replacement_data)
+    const
+{
+    panic("Cant train Hawkeye's predictor without access information.");
+}
+
+std::shared_ptr<ReplacementData>
+Hawkeye::instantiateEntry()
+{
+    return std::shared_ptr<ReplacementData>(new HawkeyeReplData(numRRPVBits));
+}
+
+Hawkeye::HawkeyeStats::HawkeyeStats(statistics::Group* parent)
+  : statistics::Group(parent),
+    ADD_STAT(samplerAccesses, statistics::units::Count::get(),
+             "Number of accesses to sampled sets"),
+    ADD_STAT(optHits, statistics::units::Count::get(),
+             "Number of sampled reuses OPT would have hit"),
+    ADD_STAT(optMisses, statistics::units::Count::get(),
+             "Number of sampled reuses OPT would have missed"),
+    ADD_STAT(correctPredictions, statistics::units::Count::get(),
+             "Number of sampled reuses predicted as OPT decided"),
+    ADD_STAT(accuracy, statistics::units::Ratio::get(),
+             "Fraction of sampled reuses predicted as OPT decided",
+             correctPredictions / (optHits + optMisses)),
+    ADD_STAT(friendlyAccesses, statistics::units::Count::get(),
+             "Number of accesses predicted cache-friendly"),
+    ADD_STAT(averseAccesses, statistics::units::Count::get(),
+             "Number of accesses predicted cache-averse"),
+    ADD_STAT(friendlyEvictions, statistics::units::Count::get(),
+             "Number of cache-friendly lines evicted")
+{
+}
+
+} // namespace replacement_policy
+} // namespace gem5
@@ -0,0 +1,237 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of the Hawkeye Replacement Policy, as described in "Back to
+ * the Future: Leveraging Belady's Algorithm for Improved Cache
+ * Replacement", by Jain and Lin.
+ */
+
+#ifndef __MEM_CACHE_REPLACEMENT_POLICIES_HAWKEYE_RP_HH__
+#define __MEM_CACHE_REPLACEMENT_POLICIES_HAWKEYE_RP_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "base/sat_counter.hh"
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "mem/cache/replacement_policies/brrip_rp.hh"
+#include "mem/packet.hh"
+
+namespace gem5
+{
+
+struct HawkeyeRPParams;
+
+namespace replacement_policy
+{
+
+/**
+ * Hawkeye trains a PC-indexed predictor with the decisions Belady's
+ * optimal policy would have taken on a few sampled sets. OPTgen rebuilds
+ * those decisions from an occupancy vector that tracks how many lines OPT
+ * would keep in the set at every past access. Lines brought or hit by a
+ * cache-friendly PC are kept with a near re-reference prediction, while
+ * lines of cache-averse PCs are inserted as the next victims.
+ */
+class Hawkeye : public BRRIP
+{
+  protected:
+    typedef std::size_t SignatureType;
+
+    /** Hawkeye-specific implementation of replacement data. */
+    struct HawkeyeReplData : BRRIPReplData
+    {
+        /** Signature of the last access to this entry. */
+        SignatureType signature;
+
+        /** Whether the last access was predicted cache-friendly. */
+        bool friendly;
+
+        HawkeyeReplData(int num_bits)
+          : BRRIPReplData(num_bits), signature(0), friendly(false)
+        {
+        }
+    };
+
+    /** Last access to a line of a sampled set. */
+    struct SamplerEntry
+    {
+        /** OPTgen time of the access. */
+        uint64_t lastTime;
+
+        /** Signature of the PC that performed the access. */
+        SignatureType signature;
+
+        /** Prediction made for the access. */
+        bool friendly;
+    };
+
+    /** OPTgen state of a sampled set. */
+    struct SampledSet
+    {
+        /** Number of lines OPT keeps at each of the last accesses. */
+        std::vector<uint8_t> occupancy;
+
+        /** Number of accesses seen by this set; the OPTgen time. */
+        uint64_t time = 0;
+
+        /** Last access to each line recently seen, by line address. */
+        std::unordered_map<Addr, SamplerEntry> lines;
+    };
+
+    /** Associativity of the cache; OPT's capacity per set. */
+    const unsigned assoc;
+
+    /** Size of a cache line, in bytes. */
+    const unsigned blockSize;
+
+    /** Number of sets of the cache. */
+    const uint64_t numSets;
+
+    /** Every setStride-th set of the cache is sampled. */
+    const uint64_t setStride;
+
+    /** Number of accesses OPTgen looks back at. */
+    const unsigned historyLength;
+
+    /** Predictor counter value from which a PC is cache-friendly. */
+    const unsigned friendlyThreshold;
+
+    /** PC-indexed predictor of cache-friendly accesses. */
+    std::vector<SatCounter8> predictor;
+
+    /** OPTgen state of the sampled sets. */
+    std::vector<SampledSet> sampledSets;
+
+    struct HawkeyeStats : public statistics::Group
+    {
+        HawkeyeStats(statistics::Group* parent);
+
+        /** Accesses that fell on sampled sets. */
+        statistics::Scalar samplerAccesses;
+
+        /** Reuses OPT would have hit. */
+        statistics::Scalar optHits;
+
+        /** Reuses OPT would have missed. */
+        statistics::Scalar optMisses;
+
+        /** Trained accesses whose prediction matched OPT. */
+        statistics::Scalar correctPredictions;
+
+        /** Fraction of trained accesses predicted as OPT decided. */
+        statistics::Formula accuracy;
+
+        /** Accesses predicted cache-friendly. */
+        statistics::Scalar friendlyAccesses;
+
+        /** Accesses predicted cache-averse. */
+        statistics::Scalar averseAccesses;
+
+        /** Cache-friendly lines that left the cache. */
+        statistics::Scalar friendlyEvictions;
+    } hawkeyeStats;
+
+    /**
+     * Extract signature from packet.
+     *
+     * @param pkt The packet to extract a signature from.
+     * @return The signature extracted.
+     */
+    SignatureType getSignature(const PacketPtr pkt) const;
+
+    /**
+     * Train the predictor with OPT's decision on the previous access to
+     * the same line, if the packet falls on a sampled set, and record the
+     * new access.
+     *
+     * @param pkt The packet accessing the cache.
+     * @param signature The packet's signature.
+     * @param friendly The prediction made for this access.
+     */
+    void sample(const PacketPtr pkt, SignatureType signature, bool friendly);
+
+    /**
+     * Predict and apply the re-reference interval of an accessed entry.
+     *
+     * @param replacement_data Replacement data of the accessed entry.
+     * @param pkt The packet accessing the entry.
+     */
+    void access(const std::shared_ptr<ReplacementData>& replacement_data,
+        const PacketPtr pkt);
+
+  public:
+    typedef HawkeyeRPParams Params;
+    Hawkeye(const Params &p);
+    ~Hawkeye() = default;
+
+    /**
+     * Invalidate replacement data to set it as the next probable victim.
+     * Detrains the predictor if a cache-friendly entry leaves the cache.
+     *
+     * @param replacement_data Replacement data to be invalidated.
+     */
+    void invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
+                                                                    override;
+
+    /**
+     * Touch an entry to update its replacement data.
+     *
+     * @param replacement_data Replacement data to be touched.
+     * @param pkt Packet that generated this hit.
+     */
+    void touch(const std::shared_ptr<ReplacementData>& replacement_data,
+        const PacketPtr pkt) override;
+    void touch(const std::shared_ptr<ReplacementData>& replacement_data) const
+        override;
+
+    /**
+     * Reset replacement data. Used when an entry is inserted.
+     *
+     * @param replacement_data Replacement data to be reset.
+     * @param pkt Packet that generated this miss.
+     */
+    void reset(const std::shared_ptr<ReplacementData>& replacement_data,
+        const PacketPtr pkt) override;
+    void reset(const std::shared_ptr<ReplacementData>& replacement_data) const
+        override;
+
+    /**
+     * Instantiate a replacement data entry.
+     *
+     * @return A shared pointer to the new replacement data.
+     */
+    std::shared_ptr<ReplacementData> instantiateEntry() override;
+};
+
+} // namespace replacement_policy
+} // namespace gem5
+
+#endif // __MEM_CACHE_REPLACEMENT_POLICIES_HAWKEYE_RP_HH__
@@ -28,6 +28,7 @@
 
 #include "mem/cache/replacement_policies/lru_rp.hh"
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 
@@ -42,13 +43,19 @@ namespace replacement_policy
 {
 
 LRU::LRU(const Params &p)
-  : Base(p)
+  : Base(p), setSize(p.set_size), packedSets(std::max(setSize, 1U))
 {
 }
 
 void
 LRU::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
 {
+    if (setSize) {
+        auto *data = PackedSets<RankSet>::get(replacement_data);
+        data->set->demote(data->way);
+        return;
+    }
+
     // Reset last touch timestamp
     std::static_pointer_cast<LRUReplData>(
         replacement_data)->lastTouchTick = Tick(0);
@@ -57,6 +64,12 @@ LRU::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
 void
 LRU::touch(const std::shared_ptr<ReplacementData>& replacement_data) const
 {
+    if (setSize) {
+        auto *data = PackedSets<RankSet>::get(replacement_data);
+        data->set->promote(data->way);
+        return;
+    }
+
     // Update last touch timestamp
     std::static_pointer_cast<LRUReplData>(
         replacement_data)->lastTouchTick = curTick();
@@ -65,6 +78,12 @@ LRU::touch(const std::shared_ptr<ReplacementData>& replacement_data) const
 void
 LRU::reset(const std::shared_ptr<ReplacementData>& replacement_data) const
 {
+    if (setSize) {
+        auto *data = PackedSets<RankSet>::get(replacement_data);
+        data->set->promote(data->way);
+        return;
+    }
+
     // Set last touch timestamp
     std::static_pointer_cast<LRUReplData>(
         replacement_data)->lastTouchTick = curTick();
@@ -73,6 +92,10 @@ LRU::reset(const std::shared_ptr<ReplacementData>& replacement_data) const
 ReplaceableEntry*
 LRU::getVictim(const ReplacementCandidates& candidates) const
 {
+    if (setSize) {
+        return rankVictim(candidates);
+    }
+
     // There must be at least one replacement candidate
     assert(candidates.size() > 0);
 
@@ -80,10 +103,10 @@ LRU::getVictim(const ReplacementCandidates& candidates) const
     ReplaceableEntry* victim = candidates[0];
     for (const auto& candidate : candidates) {
         // Update victim entry if necessary
-        if (std::static_pointer_cast<LRUReplData>(
-                    candidate->replacementData)->lastTouchTick <
-                std::static_pointer_cast<LRUReplData>(
-                    victim->replacementData)->lastTouchTick) {
+        if (static_cast<LRUReplData*>(
+                    candidate->replacementData.get())->lastTouchTick <
+                static_cast<LRUReplData*>(
+                    victim->replacementData.get())->lastTouchTick) {
             victim = candidate;
         }
     }
@@ -94,6 +117,9 @@ LRU::getVictim(const ReplacementCandidates& candidates) const
 std::shared_ptr<ReplacementData>
 LRU::instantiateEntry()
 {
+    if (setSize) {
+        return packedSets.instantiateEntry();
+    }
     return std::shared_ptr<ReplacementData>(new LRUReplData());
 }
 
@@ -36,6 +36,7 @@
 #define __MEM_CACHE_REPLACEMENT_POLICIES_LRU_RP_HH__
 
 #include "mem/cache/replacement_policies/base.hh"
+#include "mem/cache/replacement_policies/packed_repl_data.hh"
 
 namespace gem5
 {
@@ -61,6 +62,15 @@ class LRU : public Base
         LRUReplData() : lastTouchTick(0) {}
     };
 
+    /**
+     * Number of ways sharing packed rank metadata, or zero to keep a
+     * timestamp per entry.
+     */
+    const unsigned setSize;
+
+    /** The packed per-set metadata, used if setSize is not zero. */
+    PackedSets<RankSet> packedSets;
+
   public:
     typedef LRURPParams Params;
     LRU(const Params &p);
@@ -0,0 +1,195 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Helpers for replacement policies whose metadata is packed per set.
+ */
+
+#ifndef __MEM_CACHE_REPLACEMENT_POLICIES_PACKED_REPL_DATA_HH__
+#define __MEM_CACHE_REPLACEMENT_POLICIES_PACKED_REPL_DATA_HH__
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "base/logging.hh"
+#include "mem/cache/replacement_policies/replaceable_entry.hh"
+
+namespace gem5
+{
+
+GEM5_DEPRECATED_NAMESPACE(ReplacementPolicy, replacement_policy);
+namespace replacement_policy
+{
+
+/**
+ * Allocator of replacement data shared by all the ways of a set. The
+ * metadata of a set is a single Set object, and each way is handed a small
+ * WayData that points into it. The shared pointers given to the entries
+ * alias one allocation per set, instead of one heap object per entry.
+ *
+ * As with the tree PLRU, consecutive instantiations are assumed to belong
+ * to the same set, which holds for the set associative tag stores.
+ */
+template <class Set>
+class PackedSets
+{
+  public:
+    /** The replacement data of a way, which locates it within its set. */
+    struct WayData : ReplacementData
+    {
+        Set *set = nullptr;
+        unsigned way = 0;
+    };
+
+  private:
+    /** The storage of a set, shared by all of its ways. */
+    struct Storage
+    {
+        Set set;
+        std::vector<WayData> ways;
+
+        template <class... Args>
+        Storage(unsigned num_ways, Args&&... args)
+          : set(num_ways, std::forward<Args>(args)...), ways(num_ways)
+        {
+            for (unsigned way = 0; way < num_ways; way++) {
+                ways[way].set = &set;
+                ways[way].way = way;
+            }
+        }
+    };
+
+    /** The number of ways per set. */
+    const unsigned numWays;
+
+    /** The set being instantiated. */
+    std::shared_ptr<Storage> current;
+
+    /** Number of ways instantiated so far. */
+    uint64_t count = 0;
+
+  public:
+    PackedSets(unsigned num_ways) : numWays(num_ways) {}
+
+    /**
+     * Instantiate the replacement data of the next way.
+     *
+     * @param args Arguments forwarded to the constructor of a new set.
+     * @return A pointer to the way's data, sharing ownership of its set.
+     */
+    template <class... Args>
+    std::shared_ptr<ReplacementData>
+    instantiateEntry(Args&&... args)
+    {
+        if (count % numWays == 0) {
+            current = std::make_shared<Storage>(numWays,
+                                                std::forward<Args>(args)...);
+        }
+        WayData *data = &current->ways[count % numWays];
+        count++;
+        return std::shared_ptr<ReplacementData>(current, data);
+    }
+
+    /** Get the way data behind an entry's replacement data. */
+    static WayData *
+    get(const std::shared_ptr<ReplacementData>& replacement_data)
+    {
+        return static_cast<WayData *>(replacement_data.get());
+    }
+};
+
+/**
+ * The recency order of the ways in a set, as one rank byte per way. Rank
+ * zero is the most recently promoted way, and the highest rank is the next
+ * victim.
+ */
+struct RankSet
+{
+    std::vector<uint8_t> ranks;
+
+    RankSet(unsigned num_ways) : ranks(num_ways)
+    {
+        fatal_if(num_ways > 256, "At most 256 ways can be ranked");
+        // Fill the ways in order, the first being the initial victim
+        for (unsigned way = 0; way < num_ways; way++) {
+            ranks[way] = num_ways - 1 - way;
+        }
+    }
+
+    /** Make a way the most recent one. */
+    void
+    promote(unsigned way)
+    {
+        const uint8_t rank = ranks[way];
+        for (auto &r : ranks) {
+            r += (r < rank);
+        }
+        ranks[way] = 0;
+    }
+
+    /** Make a way the next victim. */
+    void
+    demote(unsigned way)
+    {
+        const uint8_t rank = ranks[way];
+        for (auto &r : ranks) {
+            r -= (r > rank);
+        }
+        ranks[way] = ranks.size() - 1;
+    }
+};
+
+/**
+ * Candidate selection for policies using a RankSet: the candidate with the
+ * highest rank is the victim.
+ */
+inline ReplaceableEntry*
+rankVictim(const ReplacementCandidates& candidates)
+{
+    assert(candidates.size() > 0);
+
+    ReplaceableEntry* victim = candidates[0];
+    auto *victim_data = PackedSets<RankSet>::get(victim->replacementData);
+    unsigned victim_rank = victim_data->set->ranks[victim_data->way];
+    for (const auto& candidate : candidates) {
+        auto *data = PackedSets<RankSet>::get(candidate->replacementData);
+        assert(data->set == victim_data->set);
+        const unsigned rank = data->set->ranks[data->way];
+        if (rank > victim_rank) {
+            victim = candidate;
+            victim_rank = rank;
+        }
+    }
+    return victim;
+}
+
+} // namespace replacement_policy
+} // namespace gem5
+
+#endif // __MEM_CACHE_REPLACEMENT_POLICIES_PACKED_REPL_DATA_HH__
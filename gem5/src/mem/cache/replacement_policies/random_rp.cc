@@ -31,7 +31,6 @@
 #include <cassert>
 #include <memory>
 
-#include "base/random.hh"
 #include "params/RandomRP.hh"
 
 namespace gem5
@@ -74,14 +73,14 @@ Random::getVictim(const ReplacementCandidates& candidates) const
     assert(candidates.size() > 0);
 
     // Choose one candidate at random
-    ReplaceableEntry* victim = candidates[random_mt.random<unsigned>(0,
+    ReplaceableEntry* victim = candidates[rng.random<unsigned>(0,
                                     candidates.size() - 1)];
 
     // Visit all candidates to search for an invalid entry. If one is found,
     // its eviction is prioritized
     for (const auto& candidate : candidates) {
-        if (!std::static_pointer_cast<RandomReplData>(
-                    candidate->replacementData)->valid) {
+        if (!static_cast<RandomReplData*>(
+                    candidate->replacementData.get())->valid) {
             victim = candidate;
             break;
         }
@@ -29,8 +29,11 @@
 #ifndef __MEM_CACHE_REPLACEMENT_POLICIES_REPLACEABLE_ENTRY_HH__
 #define __MEM_CACHE_REPLACEMENT_POLICIES_REPLACEABLE_ENTRY_HH__
 
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "base/compiler.hh"
 #include "base/cprintf.hh"
@@ -122,6 +125,49 @@ class ReplaceableEntry
     }
 };
 
+/**
+ * Replacement candidates as chosen by the indexing policy. This is a view
+ * over entry pointers owned by someone else, usually the indexing policy's
+ * per-set storage, so building one never allocates. A view returned by an
+ * indexing policy is only valid until the next call to that policy.
+ */
+class ReplacementCandidates
+{
+  private:
+    /** The first candidate. */
+    ReplaceableEntry* const* entries = nullptr;
+
+    /** The number of candidates. */
+    std::size_t numEntries = 0;
+
+  public:
+    typedef ReplaceableEntry* value_type;
+    typedef ReplaceableEntry* const* const_iterator;
+
+    ReplacementCandidates() = default;
+
+    ReplacementCandidates(ReplaceableEntry* const* _entries, std::size_t size)
+      : entries(_entries), numEntries(size)
+    {}
+
+    ReplacementCandidates(const std::vector<ReplaceableEntry*> &_entries)
+      : entries(_entries.data()), numEntries(_entries.size())
+    {}
+
+    const_iterator begin() const { return entries; }
+    const_iterator end() const { return entries + numEntries; }
+
+    std::size_t size() const { return numEntries; }
+    bool empty() const { return numEntries == 0; }
+
+    ReplaceableEntry*
+    operator[](std::size_t idx) const
+    {
+        assert(idx < numEntries);
+        return entries[idx];
+    }
+};
+
 } // namespace gem5
 
 #endif // __MEM_CACHE_REPLACEMENT_POLICIES_REPLACEABLE_ENTRY_HH_
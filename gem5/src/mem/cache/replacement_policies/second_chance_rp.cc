@@ -30,6 +30,7 @@
 
 #include <cassert>
 
+#include "base/logging.hh"
 #include "params/SecondChanceRP.hh"
 
 namespace gem5
@@ -41,7 +42,7 @@ namespace replacement_policy
 
 SecondChance::SecondChance(const Params &p)
   : FIFO(p)
-{
+{    fatal_if(setSize, "SecondChance does not support packed metadata");
 }
 
 void
@@ -33,6 +33,7 @@
 
 #include <cassert>
 
+#include "base/logging.hh"
 #include "params/WeightedLRURP.hh"
 #include "sim/cur_tick.hh"
 
@@ -45,7 +46,7 @@ namespace replacement_policy
 
 WeightedLRU::WeightedLRU(const Params &p)
   : LRU(p)
-{
+{    fatal_if(setSize, "WeightedLRU does not support packed metadata");
 }
 
 void
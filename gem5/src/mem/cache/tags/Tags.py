@@ -33,6 +33,7 @@
 # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+from m5.SimObject import *
 from m5.params import *
 from m5.proxy import *
 from m5.objects.ClockedObject import ClockedObject
@@ -76,6 +77,9 @@ class BaseSetAssoc(BaseTags):
     type = 'BaseSetAssoc'
     cxx_header = "mem/cache/tags/base_set_assoc.hh"
     cxx_class = 'gem5::BaseSetAssoc'
+    cxx_exports = [
+        PyBindMethod("setReplacementPolicy"),
+    ]
 
     # Get the cache associativity
     assoc = Param.Int(Parent.assoc, "associativity")
@@ -84,6 +88,48 @@ class BaseSetAssoc(BaseTags):
     replacement_policy = Param.BaseReplacementPolicy(
         Parent.replacement_policy, "Replacement policy")
 
+    partitioner = Param.UtilityPartitioner(NULL,
+        "Way partitioning among the cores, NULL for an unmanaged cache")
+
+    way_predictor = Param.BaseWayPredictor(NULL, "Way predictor, NULL to "
+        "read the data of every way along with the tags")
+
+class UtilityPartitioner(SimObject):
+    type = 'UtilityPartitioner'
+    cxx_header = "mem/cache/tags/utility_partitioner.hh"
+    cxx_class = 'gem5::UtilityPartitioner'
+
+    num_partitions = Param.Unsigned("Number of partitions, one per core, "
+        "indexed by the context ID of the requests")
+    sample_interval = Param.Unsigned(32, "One set in that many is "
+        "monitored by the utility monitors")
+    repartition_interval = Param.UInt64(100000, "Number of monitored "
+        "accesses between two repartitions")
+
+class BaseWayPredictor(SimObject):
+    type = 'BaseWayPredictor'
+    abstract = True
+    cxx_header = "mem/cache/tags/way_predictor.hh"
+    cxx_class = 'gem5::BaseWayPredictor'
+
+class MRUWayPredictor(BaseWayPredictor):
+    type = 'MRUWayPredictor'
+    cxx_header = "mem/cache/tags/way_predictor.hh"
+    cxx_class = 'gem5::MRUWayPredictor'
+
+class PCWayPredictor(BaseWayPredictor):
+    type = 'PCWayPredictor'
+    cxx_header = "mem/cache/tags/way_predictor.hh"
+    cxx_class = 'gem5::PCWayPredictor'
+
+    table_entries = Param.Unsigned(1024, "Number of entries of the table "
+        "indexed by the PC and the set")
+
+class PackedSetAssoc(BaseSetAssoc):
+    type = 'PackedSetAssoc'
+    cxx_header = "mem/cache/tags/packed_set_assoc.hh"
+    cxx_class = 'gem5::PackedSetAssoc'
+
 class SectorTags(BaseTags):
     type = 'SectorTags'
     cxx_header = "mem/cache/tags/sector_tags.hh"
@@ -128,3 +174,24 @@ class FALRU(BaseTags):
 
     # This tag uses its own embedded indexing
     indexing_policy = NULL
+
+class VictimTags(BaseTags):
+    type = 'VictimTags'
+    cxx_header = "mem/cache/tags/victim_tags.hh"
+    cxx_class = 'gem5::VictimTags'
+
+    tags = Param.BaseTags(BaseSetAssoc(), "Tags of the cache")
+
+    # Number of blocks of the victim buffer
+    victim_entries = Param.Int(8,
+        "Number of blocks of the victim buffer, a power of 2")
+
+    victim_tags = Param.BaseTags(
+        FALRU(size=Parent.victim_entries * Parent.block_size),
+        "Tags of the victim buffer")
+
+    swap_latency = Param.Cycles(1,
+        "Extra latency of a hit in the victim buffer")
+
+    # The blocks are those of the tags of the cache and the victim buffer
+    indexing_policy = NULL
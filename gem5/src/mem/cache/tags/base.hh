@@ -227,6 +227,15 @@ class BaseTags : public ClockedObject
         return (addr & blkMask);
     }
 
+    /**
+     * Get the size of the blocks held by the tags.
+     * @return The block size in bytes.
+     */
+    unsigned getBlockSize() const
+    {
+        return blkSize;
+    }
+
     /**
      * Limit the allocation for the cache ways.
      * @param ways The maximum number of ways available for replacement.
@@ -276,11 +285,27 @@ class BaseTags : public ClockedObject
      * @param is_secure True if the target memory space is secure.
      * @param size Size, in bits, of new block to allocate.
      * @param evict_blks Cache blocks to be evicted.
+     * @param pkt The request the block is allocated for, may be nullptr.
      * @return Cache block to be replaced.
      */
     virtual CacheBlk* findVictim(Addr addr, const bool is_secure,
                                  const std::size_t size,
-                                 std::vector<CacheBlk*>& evict_blks) = 0;
+                                 std::vector<CacheBlk*>& evict_blks,
+                                 const PacketPtr pkt) = 0;
+
+    /**
+     * Find the block the replacement policy would pick next in the set
+     * an address maps to, without evicting it or touching the
+     * replacement state. Used to clean lines ahead of their eviction.
+     *
+     * @param addr Address whose set to look at.
+     * @return The next replacement candidate, nullptr if unknown.
+     */
+    virtual CacheBlk*
+    findReplacementCandidate(Addr addr) const
+    {
+        return nullptr;
+    }
 
     /**
      * Access block and update replacement data. May not succeed, in which case
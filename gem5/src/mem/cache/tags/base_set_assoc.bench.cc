@@ -0,0 +1,251 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "base/gbench/sim_object_params.hh"
+#include "enums/PwrState.hh"
+#include "mem/cache/replacement_policies/bip_rp.hh"
+#include "mem/cache/replacement_policies/brrip_rp.hh"
+#include "mem/cache/replacement_policies/fifo_rp.hh"
+#include "mem/cache/replacement_policies/lfu_rp.hh"
+#include "mem/cache/replacement_policies/lru_rp.hh"
+#include "mem/cache/replacement_policies/mru_rp.hh"
+#include "mem/cache/replacement_policies/random_rp.hh"
+#include "mem/cache/replacement_policies/tree_plru_rp.hh"
+#include "mem/cache/tags/base_set_assoc.hh"
+#include "mem/cache/tags/indexing_policies/set_associative.hh"
+#include "mem/packet.hh"
+#include "mem/request.hh"
+#include "params/BIPRP.hh"
+#include "params/BRRIPRP.hh"
+#include "params/BaseSetAssoc.hh"
+#include "params/FIFORP.hh"
+#include "params/LFURP.hh"
+#include "params/LRURP.hh"
+#include "params/MRURP.hh"
+#include "params/PowerState.hh"
+#include "params/RandomRP.hh"
+#include "params/SetAssociative.hh"
+#include "params/SrcClockDomain.hh"
+#include "params/TreePLRURP.hh"
+#include "params/VoltageDomain.hh"
+#include "sim/eventq.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+const unsigned blockSize = 64;
+
+/** The replacement policies to benchmark, with their default parameters. */
+const std::map<std::string,
+               std::function<replacement_policy::Base *(unsigned)>>
+replacementPolicies = {
+    { "LRURP", [](unsigned) -> replacement_policy::Base * {
+        auto &p = simObjectParams<LRURPParams>("lru");
+        p.set_size = 0;
+        return p.create();
+    } },
+    { "FIFORP", [](unsigned) -> replacement_policy::Base * {
+        auto &p = simObjectParams<FIFORPParams>("fifo");
+        p.set_size = 0;
+        return p.create();
+    } },
+    { "RandomRP", [](unsigned) -> replacement_policy::Base * {
+        return simObjectParams<RandomRPParams>("random").create();
+    } },
+    { "MRURP", [](unsigned) -> replacement_policy::Base * {
+        return simObjectParams<MRURPParams>("mru").create();
+    } },
+    { "LFURP", [](unsigned) -> replacement_policy::Base * {
+        return simObjectParams<LFURPParams>("lfu").create();
+    } },
+    { "BIPRP", [](unsigned) -> replacement_policy::Base * {
+        auto &p = simObjectParams<BIPRPParams>("bip");
+        p.set_size = 0;
+        p.btp = 3;
+        return p.create();
+    } },
+    { "BRRIPRP", [](unsigned) -> replacement_policy::Base * {
+        auto &p = simObjectParams<BRRIPRPParams>("brrip");
+        p.btp = 3;
+        p.hit_priority = false;
+        p.num_bits = 2;
+        p.set_size = 0;
+        return p.create();
+    } },
+    { "TreePLRURP", [](unsigned assoc) -> replacement_policy::Base * {
+        auto &p = simObjectParams<TreePLRURPParams>("tree_plru");
+        p.num_leaves = assoc;
+        return p.create();
+    } },
+};
+
+ClockDomain *
+clockDomain()
+{
+    static ClockDomain *domain = []() {
+        auto &vp = simObjectParams<VoltageDomainParams>("voltage_domain");
+        vp.voltage = { 1.0 };
+        auto &cp = simObjectParams<SrcClockDomainParams>("clk_domain");
+        cp.clock = { 1000 };
+        cp.domain_id = -1;
+        cp.init_perf_level = 0;
+        cp.voltage_domain = vp.create();
+        return cp.create();
+    }();
+    return domain;
+}
+
+PowerState *
+powerState(const std::string &name)
+{
+    auto &p = simObjectParams<PowerStateParams>(name + ".power_state");
+    p.clk_gate_bins = 20;
+    p.clk_gate_min = 1000;
+    p.clk_gate_max = 1000000000000ULL;
+    p.default_state = enums::UNDEFINED;
+    return p.create();
+}
+
+/**
+ * Set associative tags under a stream of cache accesses, which look the
+ * blocks up with accessBlock and replace a victim from findVictim on a
+ * miss. Cache::insertBlock and its per requestor stats need a System,
+ * so the new block is inserted the same way by hand.
+ */
+struct TagsBench
+{
+    BaseSetAssoc *tags;
+    replacement_policy::Base *rp;
+    std::vector<PacketPtr> pkts;
+    std::vector<CacheBlk *> evictBlks;
+
+    TagsBench(const std::string &rp_name, uint64_t size, unsigned assoc)
+    {
+        curEventQueue(getEventQueue(0));
+
+        auto &ip = simObjectParams<SetAssociativeParams>("indexing_policy");
+        ip.assoc = assoc;
+        ip.entry_size = blockSize;
+        ip.size = size;
+
+        auto &p = simObjectParams<BaseSetAssocParams>("tags");
+        p.clk_domain = clockDomain();
+        p.power_state = powerState(p.name);
+        p.block_size = blockSize;
+        p.entry_size = blockSize;
+        p.indexing_policy = ip.create();
+        p.sequential_access = false;
+        p.size = size;
+        p.system = nullptr;
+        p.tag_latency = Cycles(2);
+        p.warmup_percentage = 0;
+        p.assoc = assoc;
+        p.partitioner = nullptr;
+        p.way_predictor = nullptr;
+        p.replacement_policy = rp = replacementPolicies.at(rp_name)(assoc);
+        tags = p.create();
+        tags->tagsInit();
+
+        // A working set of twice the capacity, with a hot quarter of it
+        // getting most of the accesses, gives hits and misses
+        std::mt19937_64 gen(1);
+        std::uniform_int_distribution<Addr> all(0, 2 * size / blockSize);
+        std::uniform_int_distribution<Addr> hot(0, size / 2 / blockSize);
+        std::bernoulli_distribution is_hot(0.8);
+        for (int i = 0; i < 8192; i++) {
+            Addr addr = (is_hot(gen) ? hot(gen) : all(gen)) * blockSize;
+            auto req = std::make_shared<Request>(addr, blockSize, 0, 0);
+            pkts.push_back(Packet::createRead(req));
+        }
+    }
+
+    ~TagsBench()
+    {
+        for (auto pkt : pkts)
+            delete pkt;
+    }
+
+    void
+    access(PacketPtr pkt)
+    {
+        Cycles lat;
+        if (tags->accessBlock(pkt, lat))
+            return;
+
+        const Addr addr = pkt->getAddr();
+        evictBlks.clear();
+        CacheBlk *blk = tags->findVictim(addr, false, 0, evictBlks, pkt);
+        if (blk->isValid())
+            tags->invalidate(blk);
+        blk->insert(tags->extractTag(addr), false, 0, 0);
+        rp->reset(blk->replacementData, pkt);
+    }
+};
+
+void
+BM_BaseSetAssocAccess(benchmark::State &state, const std::string &rp_name)
+{
+    TagsBench bench(rp_name, state.range(0) << 10, state.range(1));
+    size_t i = 0;
+    for (auto _ : state) {
+        bench.access(bench.pkts[i]);
+        i = (i + 1) % bench.pkts.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/** The sizes (in KiB) and associativities to run every policy with. */
+void
+tagsArgs(benchmark::internal::Benchmark *b)
+{
+    b->Args({ 32, 8 })->Args({ 1024, 16 });
+}
+
+} // anonymous namespace
+
+BENCHMARK_CAPTURE(BM_BaseSetAssocAccess, LRURP, "LRURP")->Apply(tagsArgs);
+BENCHMARK_CAPTURE(BM_BaseSetAssocAccess, FIFORP, "FIFORP")->Apply(tagsArgs);
+BENCHMARK_CAPTURE(BM_BaseSetAssocAccess, RandomRP, "RandomRP")
+    ->Apply(tagsArgs);
+BENCHMARK_CAPTURE(BM_BaseSetAssocAccess, MRURP, "MRURP")->Apply(tagsArgs);
+BENCHMARK_CAPTURE(BM_BaseSetAssocAccess, LFURP, "LFURP")->Apply(tagsArgs);
+BENCHMARK_CAPTURE(BM_BaseSetAssocAccess, BIPRP, "BIPRP")->Apply(tagsArgs);
+BENCHMARK_CAPTURE(BM_BaseSetAssocAccess, BRRIPRP, "BRRIPRP")
+    ->Apply(tagsArgs);
+BENCHMARK_CAPTURE(BM_BaseSetAssocAccess, TreePLRURP, "TreePLRURP")
+    ->Apply(tagsArgs);
+
+BENCHMARK_MAIN();
@@ -55,7 +55,8 @@ namespace gem5
 BaseSetAssoc::BaseSetAssoc(const Params &p)
     :BaseTags(p), allocAssoc(p.assoc), blks(p.size / p.block_size),
      sequentialAccess(p.sequential_access),
-     replacementPolicy(p.replacement_policy)
+     replacementPolicy(p.replacement_policy),
+     partitioner(p.partitioner), wayPredictor(p.way_predictor)
 {
     // There must be a indexing policy
     fatal_if(!p.indexing_policy, "An indexing policy is required");
@@ -64,6 +65,14 @@ BaseSetAssoc::BaseSetAssoc(const Params &p)
     if (blkSize < 4 || !isPowerOf2(blkSize)) {
         fatal("Block size must be at least 4 and a power of 2");
     }
+
+    if (partitioner)
+        partitioner->setup(numBlocks / p.assoc, p.assoc);
+
+    fatal_if(wayPredictor && sequentialAccess, "%s: a way predictor is of "
+             "no use when tags and data are accessed sequentially", name());
+    if (wayPredictor)
+        wayPredictor->setup(numBlocks / p.assoc, p.assoc);
 }
 
 void
@@ -95,6 +104,9 @@ BaseSetAssoc::invalidate(CacheBlk *blk)
 
     // Invalidate replacement data
     replacementPolicy->invalidate(blk->replacementData);
+
+    if (partitioner)
+        partitioner->release(blk);
 }
 
 void
@@ -107,6 +119,22 @@ BaseSetAssoc::moveBlock(CacheBlk *src_blk, CacheBlk *dest_blk)
     // the one that is being moved.
     replacementPolicy->invalidate(src_blk->replacementData);
     replacementPolicy->reset(dest_blk->replacementData);
+
+    if (partitioner)
+        partitioner->move(src_blk, dest_blk);
+}
+
+void
+BaseSetAssoc::setReplacementPolicy(replacement_policy::Base *policy)
+{
+    fatal_if(!policy, "%s: A replacement policy is required", name());
+    replacementPolicy = policy;
+
+    for (auto &blk : blks) {
+        blk.replacementData = replacementPolicy->instantiateEntry();
+        if (blk.isValid())
+            replacementPolicy->reset(blk.replacementData);
+    }
 }
 
 } // namespace gem5
@@ -59,6 +59,8 @@
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "mem/cache/tags/base.hh"
 #include "mem/cache/tags/indexing_policies/base.hh"
+#include "mem/cache/tags/utility_partitioner.hh"
+#include "mem/cache/tags/way_predictor.hh"
 #include "mem/packet.hh"
 #include "params/BaseSetAssoc.hh"
 
@@ -87,6 +89,20 @@ class BaseSetAssoc : public BaseTags
     /** Replacement policy */
     replacement_policy::Base *replacementPolicy;
 
+    /** Way partitioning among the cores, if any. */
+    UtilityPartitioner *partitioner;
+
+    /** Way predictor, if any. */
+    BaseWayPredictor *wayPredictor;
+
+    /** The set an access maps to, given the block it found, if any. */
+    uint32_t
+    setOf(const PacketPtr pkt, const CacheBlk *blk) const
+    {
+        return blk ? blk->getSet() :
+            indexingPolicy->getPossibleEntries(pkt->getAddr())[0]->getSet();
+    }
+
   public:
     /** Convenience typedef. */
      typedef BaseSetAssocParams Params;
@@ -130,12 +146,25 @@ class BaseSetAssoc : public BaseTags
 
         // Access all tags in parallel, hence one in each way.  The data side
         // either accesses all blocks in parallel, or one block sequentially on
-        // a hit.  Sequential access with a miss doesn't access data.
+        // a hit.  Sequential access with a miss doesn't access data.  With a
+        // way predictor only the predicted way is read along with the tags,
+        // and a block found in another way is read in the next cycle.
+        Cycles extra_lat(0);
         stats.tagAccesses += allocAssoc;
         if (sequentialAccess) {
             if (blk != nullptr) {
                 stats.dataAccesses += 1;
             }
+        } else if (wayPredictor) {
+            const uint32_t set = setOf(pkt, blk);
+            const uint32_t way = blk ? blk->getWay() : 0;
+            const unsigned reads = wayPredictor->resolve(
+                wayPredictor->predict(pkt, set), way, blk != nullptr);
+            stats.dataAccesses += reads;
+            if (reads > 1)
+                extra_lat = Cycles(1);
+            if (blk)
+                wayPredictor->update(pkt, set, way);
         } else {
             stats.dataAccesses += allocAssoc;
         }
@@ -149,8 +178,14 @@ class BaseSetAssoc : public BaseTags
             replacementPolicy->touch(blk->replacementData, pkt);
         }
 
+        if (partitioner) {
+            partitioner->access(partitioner->partitionOf(pkt),
+                                pkt->getAddr() & ~blkMask, setOf(pkt, blk),
+                                blk != nullptr);
+        }
+
         // The tag lookup latency is the same for a hit or a miss
-        lat = lookupLatency;
+        lat = lookupLatency + extra_lat;
 
         return blk;
     }
@@ -163,16 +198,24 @@ class BaseSetAssoc : public BaseTags
      * @param is_secure True if the target memory space is secure.
      * @param size Size, in bits, of new block to allocate.
      * @param evict_blks Cache blocks to be evicted.
+     * @param pkt The request the block is allocated for, may be nullptr.
      * @return Cache block to be replaced.
      */
     CacheBlk* findVictim(Addr addr, const bool is_secure,
                          const std::size_t size,
-                         std::vector<CacheBlk*>& evict_blks) override
+                         std::vector<CacheBlk*>& evict_blks,
+                         const PacketPtr pkt) override
     {
         // Get possible entries to be victimized
-        const std::vector<ReplaceableEntry*> entries =
+        ReplacementCandidates entries =
             indexingPolicy->getPossibleEntries(addr);
 
+        // Only keep the ones the requestor's partition may replace
+        if (partitioner) {
+            entries = partitioner->filterCandidates(
+                partitioner->partitionOf(pkt), entries);
+        }
+
         // Choose replacement victim from replacement candidates
         CacheBlk* victim = static_cast<CacheBlk*>(replacementPolicy->getVictim(
                                 entries));
@@ -183,6 +226,13 @@ class BaseSetAssoc : public BaseTags
         return victim;
     }
 
+    CacheBlk*
+    findReplacementCandidate(Addr addr) const override
+    {
+        return static_cast<CacheBlk*>(replacementPolicy->getVictim(
+            indexingPolicy->getPossibleEntries(addr)));
+    }
+
     /**
      * Insert the new block into the cache and update replacement data.
      *
@@ -197,12 +247,28 @@ class BaseSetAssoc : public BaseTags
         // Increment tag counter
         stats.tagsInUse++;
 
+        if (partitioner)
+            partitioner->insert(partitioner->partitionOf(pkt), blk);
+
+        if (wayPredictor)
+            wayPredictor->update(pkt, blk->getSet(), blk->getWay());
+
         // Update replacement policy
         replacementPolicy->reset(blk->replacementData, pkt);
     }
 
     void moveBlock(CacheBlk *src_blk, CacheBlk *dest_blk) override;
 
+    /**
+     * Switch to another replacement policy, e.g. in a simulation forked
+     * after the warmup. The blocks get new replacement data, so the
+     * replacement state starts over, with the valid blocks reset in
+     * block order as if they had just been inserted.
+     *
+     * @param policy The new replacement policy.
+     */
+    void setReplacementPolicy(replacement_policy::Base *policy);
+
     /**
      * Limit the allocation for the cache ways.
      * @param ways The maximum number of ways available for replacement.
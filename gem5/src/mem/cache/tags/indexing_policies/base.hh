@@ -49,14 +49,13 @@
 
 #include <vector>
 
+#include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "params/BaseIndexingPolicy.hh"
 #include "sim/sim_object.hh"
 
 namespace gem5
 {
 
-class ReplaceableEntry;
-
 /**
  * A common base class for indexing table locations. Classes that inherit
  * from it determine hash functions that should be applied based on the set
@@ -141,12 +140,13 @@ class BaseIndexingPolicy : public SimObject
     /**
      * Find all possible entries for insertion and replacement of an address.
      * Should be called immediately before ReplacementPolicy's findVictim()
-     * not to break cache resizing.
+     * not to break cache resizing. The returned view does not own the
+     * entries and is only valid until the next call.
      *
      * @param addr The addr to a find possible entries for.
      * @return The possible entries.
      */
-    virtual std::vector<ReplaceableEntry*> getPossibleEntries(const Addr addr)
+    virtual ReplacementCandidates getPossibleEntries(const Addr addr)
                                                                     const = 0;
 
     /**
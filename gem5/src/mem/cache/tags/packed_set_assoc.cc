@@ -0,0 +1,122 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a set associative tag store with packed tag arrays.
+ */
+
+#include "mem/cache/tags/packed_set_assoc.hh"
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "mem/cache/tags/indexing_policies/set_associative.hh"
+
+namespace gem5
+{
+
+PackedSetAssoc::PackedSetAssoc(const Params &p)
+    : BaseSetAssoc(p),
+      setIndexing(dynamic_cast<const SetAssociative *>(p.indexing_policy)),
+      assoc(p.assoc), rowSize(roundUp(p.assoc, 4)),
+      tags(numBlocks / assoc * rowSize, MaxAddr),
+      validMask(numBlocks / assoc, 0), secureMask(numBlocks / assoc, 0)
+{
+    fatal_if(!setIndexing, "%s requires a SetAssociative indexing policy",
+             name());
+    fatal_if(assoc > 64, "%s supports at most 64 ways", name());
+}
+
+void
+PackedSetAssoc::tagsInit()
+{
+    BaseSetAssoc::tagsInit();
+
+    for (const CacheBlk &blk : blks) {
+        updateEntry(&blk);
+    }
+}
+
+void
+PackedSetAssoc::updateEntry(const CacheBlk *blk)
+{
+    const uint32_t set = blk->getSet();
+    const uint64_t way_bit = 1ULL << blk->getWay();
+
+    tags[set * rowSize + blk->getWay()] = blk->getTag();
+    if (blk->isValid()) {
+        validMask[set] |= way_bit;
+    } else {
+        validMask[set] &= ~way_bit;
+    }
+    if (blk->isSecure()) {
+        secureMask[set] |= way_bit;
+    } else {
+        secureMask[set] &= ~way_bit;
+    }
+}
+
+CacheBlk *
+PackedSetAssoc::findBlock(Addr addr, bool is_secure) const
+{
+    const uint32_t set = setIndexing->extractSet(addr);
+
+    uint64_t hits = matchTags(&tags[set * rowSize], rowSize,
+                              extractTag(addr));
+    hits &= validMask[set];
+    hits &= is_secure ? secureMask[set] : ~secureMask[set];
+    if (!hits) {
+        return nullptr;
+    }
+
+    CacheBlk *blk =
+        static_cast<CacheBlk *>(findBlockBySetAndWay(set, ctz64(hits)));
+    assert(blk->matchTag(extractTag(addr), is_secure));
+    return blk;
+}
+
+void
+PackedSetAssoc::invalidate(CacheBlk *blk)
+{
+    BaseSetAssoc::invalidate(blk);
+    updateEntry(blk);
+}
+
+void
+PackedSetAssoc::insertBlock(const PacketPtr pkt, CacheBlk *blk)
+{
+    BaseSetAssoc::insertBlock(pkt, blk);
+    updateEntry(blk);
+}
+
+void
+PackedSetAssoc::moveBlock(CacheBlk *src_blk, CacheBlk *dest_blk)
+{
+    BaseSetAssoc::moveBlock(src_blk, dest_blk);
+    updateEntry(src_blk);
+    updateEntry(dest_blk);
+}
+
+} // namespace gem5
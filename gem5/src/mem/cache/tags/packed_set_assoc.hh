@@ -0,0 +1,147 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a set associative tag store that keeps its tags in
+ * per-set packed arrays.
+ */
+
+#ifndef __MEM_CACHE_TAGS_PACKED_SET_ASSOC_HH__
+#define __MEM_CACHE_TAGS_PACKED_SET_ASSOC_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "base/bitfield.hh"
+#include "base/types.hh"
+#include "mem/cache/cache_blk.hh"
+#include "mem/cache/tags/base_set_assoc.hh"
+#include "params/PackedSetAssoc.hh"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace gem5
+{
+
+class SetAssociative;
+
+/**
+ * A set associative tag store that mirrors the tag, valid and secure state
+ * of its blocks in per-set contiguous arrays. A lookup compares the tags of
+ * all ways of a set at once, using SIMD instructions when they are available,
+ * and only touches the matching CacheBlk. The mirrored state is updated
+ * whenever a block is inserted, moved or invalidated, so the tag store must
+ * be used with a SetAssociative indexing policy and at most 64 ways.
+ */
+class PackedSetAssoc : public BaseSetAssoc
+{
+  protected:
+    /** The indexing policy, which must map each address to a single set. */
+    const SetAssociative *setIndexing;
+
+    /** The number of ways per set. */
+    const unsigned assoc;
+
+    /** The number of tags in a row, rounded up to the SIMD width. */
+    const unsigned rowSize;
+
+    /** The tags of all blocks, one row of rowSize tags per set. */
+    std::vector<Addr> tags;
+
+    /** A bit per way for each set telling whether the way is valid. */
+    std::vector<uint64_t> validMask;
+
+    /** A bit per way for each set telling whether the way is secure. */
+    std::vector<uint64_t> secureMask;
+
+    /**
+     * Copy the tag state of a block into the packed arrays.
+     *
+     * @param blk The block to copy.
+     */
+    void updateEntry(const CacheBlk *blk);
+
+  public:
+    /** Convenience typedef. */
+    typedef PackedSetAssocParams Params;
+
+    PackedSetAssoc(const Params &p);
+
+    void tagsInit() override;
+
+    CacheBlk *findBlock(Addr addr, bool is_secure) const override;
+
+    void invalidate(CacheBlk *blk) override;
+
+    void insertBlock(const PacketPtr pkt, CacheBlk *blk) override;
+
+    void moveBlock(CacheBlk *src_blk, CacheBlk *dest_blk) override;
+
+    /**
+     * Compare a tag against a row of tags.
+     *
+     * @param row The row of tags, which must hold a multiple of four tags.
+     * @param size The number of tags in the row.
+     * @param tag The tag to look for.
+     * @return A mask with a bit set for each matching position.
+     */
+    static uint64_t
+    matchTags(const Addr *row, unsigned size, Addr tag)
+    {
+        uint64_t mask = 0;
+#if defined(__AVX2__)
+        const __m256i key = _mm256_set1_epi64x(tag);
+        for (unsigned i = 0; i < size; i += 4) {
+            const __m256i cmp = _mm256_cmpeq_epi64(key,
+                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(
+                    row + i)));
+            mask |= uint64_t(_mm256_movemask_pd(_mm256_castsi256_pd(cmp)))
+                << i;
+        }
+#elif defined(__SSE2__)
+        const __m128i key = _mm_set1_epi64x(tag);
+        for (unsigned i = 0; i < size; i += 2) {
+            // Compare 32-bit halves and require both halves to match
+            const __m128i cmp = _mm_cmpeq_epi32(key,
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i)));
+            const __m128i both = _mm_and_si128(cmp,
+                _mm_shuffle_epi32(cmp, _MM_SHUFFLE(2, 3, 0, 1)));
+            mask |= uint64_t(_mm_movemask_pd(_mm_castsi128_pd(both))) << i;
+        }
+#else
+        for (unsigned i = 0; i < size; i++) {
+            mask |= uint64_t(row[i] == tag) << i;
+        }
+#endif
+        return mask;
+    }
+};
+
+} // namespace gem5
+
+#endif //__MEM_CACHE_TAGS_PACKED_SET_ASSOC_HH__
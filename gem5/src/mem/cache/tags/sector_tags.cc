@@ -187,7 +187,12 @@ SectorTags::insertBlock(const PacketPtr pkt, CacheBlk *blk)
     if (sector_blk->isValid()) {
         // An existing entry's replacement data is just updated
         replacementPolicy->touch(sector_blk->replacementData, pkt);
+
+        // Only the missing sub-block was fetched
+        sectorStats.subBlockFills++;
     } else {
+        sectorStats.sectorFills++;
+
         // Increment tag counter
         stats.tagsInUse++;
         assert(stats.tagsInUse.value() <= numSectors);
@@ -257,7 +262,7 @@ SectorTags::findBlock(Addr addr, bool is_secure) const
     const Addr offset = extractSectorOffset(addr);
 
     // Find all possible sector entries that may contain the given address
-    const std::vector<ReplaceableEntry*> entries =
+    const ReplacementCandidates entries =
         indexingPolicy->getPossibleEntries(addr);
 
     // Search for block
@@ -274,10 +279,11 @@ SectorTags::findBlock(Addr addr, bool is_secure) const
 
 CacheBlk*
 SectorTags::findVictim(Addr addr, const bool is_secure, const std::size_t size,
-                       std::vector<CacheBlk*>& evict_blks)
+                       std::vector<CacheBlk*>& evict_blks,
+                       const PacketPtr pkt)
 {
     // Get possible entries to be victimized
-    const std::vector<ReplaceableEntry*> sector_entries =
+    const ReplacementCandidates sector_entries =
         indexingPolicy->getPossibleEntries(addr);
 
     // Check if the sector this address belongs to has been allocated
@@ -342,7 +348,15 @@ SectorTags::SectorTagsStats::SectorTagsStats(BaseTagStats &base_group,
     SectorTags& _tags)
   : statistics::Group(&base_group), tags(_tags),
     ADD_STAT(evictionsReplacement, statistics::units::Count::get(),
-             "Number of blocks evicted due to a replacement")
+             "Number of blocks evicted due to a replacement"),
+    ADD_STAT(sectorFills, statistics::units::Count::get(),
+             "Number of fills that allocated a new sector"),
+    ADD_STAT(subBlockFills, statistics::units::Count::get(),
+             "Number of fills of a sub-block of a present sector"),
+    ADD_STAT(fillsPerSector, statistics::units::Rate<
+                statistics::units::Count, statistics::units::Count>::get(),
+             "Average number of sub-blocks filled per allocated sector",
+             (sectorFills + subBlockFills) / sectorFills)
 {
 }
 
@@ -61,6 +61,13 @@ class ReplaceableEntry;
  * The SectorTags placement policy divides the cache into s sectors of w
  * consecutive sectors (ways). Each sector then consists of a number of
  * sequential cache lines that may or may not be present.
+ *
+ * The sub-blocks are the unit of transfer of the cache: a miss only
+ * fetches the requested sub-block, and its valid and dirty bits are kept
+ * per sub-block, while the tag and the replacement data are shared by the
+ * sector. A configuration with a large tag reach and a small fill size is
+ * hence set up with the line size of the system as the sub-block size,
+ * and the ratio of both as the number of blocks per sector.
  */
 class SectorTags : public BaseTags
 {
@@ -104,6 +111,15 @@ class SectorTags : public BaseTags
 
         /** Number of sub-blocks evicted due to a replacement. */
         statistics::Vector evictionsReplacement;
+
+        /** Number of fills that allocated a new sector. */
+        statistics::Scalar sectorFills;
+
+        /** Number of fills of a sub-block of an already present sector. */
+        statistics::Scalar subBlockFills;
+
+        /** Average number of sub-blocks filled per allocated sector. */
+        statistics::Formula fillsPerSector;
     } sectorStats;
 
   public:
@@ -172,11 +188,13 @@ class SectorTags : public BaseTags
      * @param is_secure True if the target memory space is secure.
      * @param size Size, in bits, of new block to allocate.
      * @param evict_blks Cache blocks to be evicted.
+     * @param pkt The request the block is allocated for, may be nullptr.
      * @return Cache block to be replaced.
      */
     CacheBlk* findVictim(Addr addr, const bool is_secure,
                          const std::size_t size,
-                         std::vector<CacheBlk*>& evict_blks) override;
+                         std::vector<CacheBlk*>& evict_blks,
+                         const PacketPtr pkt) override;
 
     /**
      * Calculate a block's offset in a sector from the address.
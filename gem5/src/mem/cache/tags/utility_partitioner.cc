@@ -0,0 +1,294 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a utility-based cache partitioner.
+ */
+
+#include "mem/cache/tags/utility_partitioner.hh"
+
+#include <algorithm>
+
+#include "base/logging.hh"
+#include "mem/cache/cache_blk.hh"
+
+namespace gem5
+{
+
+UtilityPartitioner::UtilityPartitioner(const Params &p)
+    : SimObject(p), numPartitions(p.num_partitions),
+      sampleInterval(p.sample_interval),
+      repartitionInterval(p.repartition_interval),
+      targetWays(p.num_partitions, 0), occupancy(p.num_partitions, 0),
+      setOccupancy(p.num_partitions), stats(*this)
+{
+    fatal_if(numPartitions == 0, "%s: At least one partition is required",
+             name());
+    fatal_if(sampleInterval == 0, "%s: The sample interval must be non-zero",
+             name());
+}
+
+void
+UtilityPartitioner::setup(unsigned num_sets, unsigned cache_assoc)
+{
+    fatal_if(cache_assoc < numPartitions, "%s: Each of the %d partitions "
+             "needs a way, the cache has %d", name(), numPartitions,
+             cache_assoc);
+
+    numSets = num_sets;
+    assoc = cache_assoc;
+    numSampledSets = (numSets + sampleInterval - 1) / sampleInterval;
+
+    shadowTags.assign(numPartitions * numSampledSets * assoc, MaxAddr);
+    stackHits.assign(numPartitions * assoc, 0);
+    owners.assign(numSets * assoc, noPartition);
+    occupancy.assign(numPartitions, 0);
+    filtered.reserve(assoc);
+
+    // Share the ways evenly until the UMONs know better
+    targetWays.assign(numPartitions, assoc / numPartitions);
+    for (unsigned i = 0; i < assoc % numPartitions; i++)
+        targetWays[i]++;
+}
+
+int
+UtilityPartitioner::partitionOf(const PacketPtr pkt) const
+{
+    if (!pkt || !pkt->req->hasContextId())
+        return noPartition;
+    return pkt->req->contextId() % numPartitions;
+}
+
+void
+UtilityPartitioner::monitor(int part, Addr blk_addr, uint32_t set)
+{
+    Addr *stack = &shadowTags[(part * numSampledSets + set / sampleInterval)
+                              * assoc];
+    Addr *end = stack + assoc;
+    Addr *pos = std::find(stack, end, blk_addr);
+    if (pos != end)
+        stackHits[part * assoc + (pos - stack)]++;
+    else
+        pos = end - 1;
+
+    // Move the block to the MRU position, dropping the LRU one on a miss
+    std::move_backward(stack, pos, pos + 1);
+    stack[0] = blk_addr;
+
+    if (++monitoredAccesses >= repartitionInterval) {
+        monitoredAccesses = 0;
+        repartition();
+    }
+}
+
+void
+UtilityPartitioner::access(int part, Addr blk_addr, uint32_t set, bool hit)
+{
+    if (part == noPartition)
+        return;
+
+    stats.accesses[part]++;
+    if (!hit)
+        stats.misses[part]++;
+
+    if (set % sampleInterval == 0)
+        monitor(part, blk_addr, set);
+}
+
+uint64_t
+UtilityPartitioner::hitsWithWays(int part, unsigned ways) const
+{
+    const uint64_t *hits = &stackHits[part * assoc];
+    uint64_t total = 0;
+    for (unsigned i = 0; i < ways; i++)
+        total += hits[i];
+    return total;
+}
+
+void
+UtilityPartitioner::repartition()
+{
+    ++stats.repartitions;
+
+    // Lookahead: every partition gets a way, then the remaining ones go,
+    // a batch at a time, to the partition with the highest marginal
+    // utility, i.e. the most extra hits per extra way.
+    std::vector<unsigned> alloc(numPartitions, 1);
+    unsigned balance = assoc - numPartitions;
+    while (balance) {
+        double best_mu = -1;
+        unsigned winner = 0;
+        unsigned winner_ways = 1;
+        for (unsigned p = 0; p < numPartitions; p++) {
+            const uint64_t base = hitsWithWays(p, alloc[p]);
+            for (unsigned k = 1; k <= balance; k++) {
+                const double mu =
+                    double(hitsWithWays(p, alloc[p] + k) - base) / k;
+                if (mu > best_mu) {
+                    best_mu = mu;
+                    winner = p;
+                    winner_ways = k;
+                }
+            }
+        }
+        alloc[winner] += winner_ways;
+        balance -= winner_ways;
+    }
+    targetWays = alloc;
+
+    // Age the counters so that the partitions follow program phases
+    for (auto &hits : stackHits)
+        hits /= 2;
+}
+
+ReplacementCandidates
+UtilityPartitioner::filterCandidates(int part,
+                                     const ReplacementCandidates &entries)
+{
+    if (part == noPartition)
+        return entries;
+
+    // Invalid blocks are free for everyone
+    filtered.clear();
+    for (const auto &entry : entries) {
+        if (!static_cast<CacheBlk *>(entry)->isValid())
+            filtered.push_back(entry);
+    }
+    if (!filtered.empty())
+        return ReplacementCandidates(filtered);
+
+    std::fill(setOccupancy.begin(), setOccupancy.end(), 0);
+    for (const auto &entry : entries) {
+        const int o = owner(entry);
+        if (o != noPartition)
+            setOccupancy[o]++;
+    }
+
+    if (setOccupancy[part] < targetWays[part]) {
+        // Take a block from a partition over its target
+        for (const auto &entry : entries) {
+            const int o = owner(entry);
+            if (o == noPartition || setOccupancy[o] > targetWays[o])
+                filtered.push_back(entry);
+        }
+        if (filtered.empty()) {
+            for (const auto &entry : entries) {
+                if (owner(entry) != part)
+                    filtered.push_back(entry);
+            }
+        }
+    } else {
+        for (const auto &entry : entries) {
+            if (owner(entry) == part)
+                filtered.push_back(entry);
+        }
+    }
+
+    if (filtered.empty())
+        return entries;
+    return ReplacementCandidates(filtered);
+}
+
+void
+UtilityPartitioner::insert(int part, const ReplaceableEntry *entry)
+{
+    int &o = owner(entry);
+    assert(o == noPartition);
+    o = part;
+    if (part != noPartition)
+        occupancy[part]++;
+}
+
+void
+UtilityPartitioner::release(const ReplaceableEntry *entry)
+{
+    int &o = owner(entry);
+    if (o != noPartition) {
+        assert(occupancy[o] > 0);
+        occupancy[o]--;
+        o = noPartition;
+    }
+}
+
+void
+UtilityPartitioner::move(const ReplaceableEntry *src,
+                         const ReplaceableEntry *dest)
+{
+    int &o = owner(src);
+    owner(dest) = o;
+    o = noPartition;
+}
+
+UtilityPartitioner::UtilityPartitionerStats::UtilityPartitionerStats(
+    UtilityPartitioner &part)
+    : statistics::Group(&part), partitioner(part),
+      ADD_STAT(accesses, statistics::units::Count::get(),
+               "Number of accesses of each partition"),
+      ADD_STAT(misses, statistics::units::Count::get(),
+               "Number of misses of each partition"),
+      ADD_STAT(missRate, statistics::units::Ratio::get(),
+               "Miss rate of each partition", misses / accesses),
+      ADD_STAT(occupancy, statistics::units::Count::get(),
+               "Number of blocks held by each partition"),
+      ADD_STAT(targetWays, statistics::units::Count::get(),
+               "Number of ways allocated to each partition"),
+      ADD_STAT(repartitions, statistics::units::Count::get(),
+               "Number of times the ways were divided again")
+{
+}
+
+void
+UtilityPartitioner::UtilityPartitionerStats::regStats()
+{
+    statistics::Group::regStats();
+
+    const unsigned n = partitioner.numPartitions;
+    accesses.init(n);
+    misses.init(n);
+    occupancy.init(n);
+    targetWays.init(n);
+    for (unsigned i = 0; i < n; i++) {
+        const std::string core = csprintf("core%d", i);
+        accesses.subname(i, core);
+        misses.subname(i, core);
+        missRate.subname(i, core);
+        occupancy.subname(i, core);
+        targetWays.subname(i, core);
+    }
+}
+
+void
+UtilityPartitioner::UtilityPartitionerStats::preDumpStats()
+{
+    statistics::Group::preDumpStats();
+
+    for (unsigned i = 0; i < partitioner.numPartitions; i++) {
+        occupancy[i] = partitioner.occupancy[i];
+        targetWays[i] = partitioner.targetWays[i];
+    }
+}
+
+} // namespace gem5
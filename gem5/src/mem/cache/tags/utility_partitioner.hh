@@ -0,0 +1,199 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a utility-based cache partitioner.
+ */
+
+#ifndef __MEM_CACHE_TAGS_UTILITY_PARTITIONER_HH__
+#define __MEM_CACHE_TAGS_UTILITY_PARTITIONER_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "mem/cache/replacement_policies/replaceable_entry.hh"
+#include "mem/packet.hh"
+#include "params/UtilityPartitioner.hh"
+#include "sim/sim_object.hh"
+
+namespace gem5
+{
+
+/**
+ * Utility-based cache partitioning (UCP), Qureshi and Patt, MICRO 2006.
+ *
+ * The ways of a set associative cache are divided among the cores sharing
+ * it. A utility monitor (UMON) per core keeps LRU shadow tags of a sample
+ * of the sets, as if the core had the whole cache to itself, and counts its
+ * hits at each LRU stack position. Periodically, the lookahead algorithm
+ * hands out the ways to the cores that gain the most hits per way, and the
+ * counters are halved.
+ *
+ * The partitions are enforced at replacement: a core that holds fewer
+ * blocks of a set than its target evicts a block of a core above its
+ * target, and otherwise evicts one of its own blocks. The replacement
+ * policy picks the victim among those blocks. Requests carry the core they
+ * come from in their context ID; requests without one, such as writebacks,
+ * are not monitored and may replace any block.
+ */
+class UtilityPartitioner : public SimObject
+{
+  public:
+    /** Partition of the requests that do not belong to a core. */
+    static constexpr int noPartition = -1;
+
+  private:
+    /** Number of partitions, one per core. */
+    const unsigned numPartitions;
+
+    /** One set in that many is monitored by the UMONs. */
+    const unsigned sampleInterval;
+
+    /** Number of monitored accesses between two repartitions. */
+    const uint64_t repartitionInterval;
+
+    /** Associativity of the cache. */
+    unsigned assoc = 0;
+
+    /** Number of sets of the cache. */
+    unsigned numSets = 0;
+
+    /** Number of sets monitored by each UMON. */
+    unsigned numSampledSets = 0;
+
+    /** Monitored accesses since the last repartition. */
+    uint64_t monitoredAccesses = 0;
+
+    /**
+     * Shadow tags of the UMONs, by partition, sampled set and LRU stack
+     * position, most recently used first. Invalid entries hold MaxAddr.
+     */
+    std::vector<Addr> shadowTags;
+
+    /** UMON hits by partition and LRU stack position. */
+    std::vector<uint64_t> stackHits;
+
+    /** Number of ways each partition may hold in a set. */
+    std::vector<unsigned> targetWays;
+
+    /** Partition owning each block, indexed by set and way. */
+    std::vector<int> owners;
+
+    /** Number of blocks held by each partition. */
+    std::vector<uint64_t> occupancy;
+
+    /** @{ */
+    /** Scratch storage of the victim selection. */
+    std::vector<ReplaceableEntry *> filtered;
+    std::vector<unsigned> setOccupancy;
+    /** @} */
+
+    int &
+    owner(const ReplaceableEntry *entry)
+    {
+        return owners[entry->getSet() * assoc + entry->getWay()];
+    }
+
+    /** Hits a partition would get with the given number of ways. */
+    uint64_t hitsWithWays(int part, unsigned ways) const;
+
+    /** Updates the UMON of a partition with an access to a sampled set. */
+    void monitor(int part, Addr blk_addr, uint32_t set);
+
+    /** Divides the ways among the partitions. */
+    void repartition();
+
+    struct UtilityPartitionerStats : public statistics::Group
+    {
+        UtilityPartitionerStats(UtilityPartitioner &part);
+
+        void regStats() override;
+        void preDumpStats() override;
+
+        UtilityPartitioner &partitioner;
+
+        /** Accesses of each partition. */
+        statistics::Vector accesses;
+        /** Misses of each partition. */
+        statistics::Vector misses;
+        /** Miss rate of each partition. */
+        statistics::Formula missRate;
+        /** Blocks held by each partition at the time of the dump. */
+        statistics::Vector occupancy;
+        /** Ways allocated to each partition at the time of the dump. */
+        statistics::Vector targetWays;
+        /** Number of times the ways were divided again. */
+        statistics::Scalar repartitions;
+    } stats;
+
+  public:
+    PARAMS(UtilityPartitioner);
+    UtilityPartitioner(const Params &p);
+
+    /**
+     * Sizes the partitioner for a cache.
+     * @param num_sets Number of sets of the cache.
+     * @param cache_assoc Associativity of the cache.
+     */
+    void setup(unsigned num_sets, unsigned cache_assoc);
+
+    /** The partition a request belongs to. */
+    int partitionOf(const PacketPtr pkt) const;
+
+    /**
+     * Records an access of a partition.
+     * @param part The partition of the access.
+     * @param blk_addr The block address accessed.
+     * @param set The set the address maps to.
+     * @param hit Whether the access hit in the cache.
+     */
+    void access(int part, Addr blk_addr, uint32_t set, bool hit);
+
+    /**
+     * Restricts the replacement candidates of a set to the blocks a
+     * partition may replace.
+     * @param part The partition that allocates a block.
+     * @param entries The blocks of the set.
+     * @return The blocks the victim has to be chosen among.
+     */
+    ReplacementCandidates filterCandidates(
+        int part, const ReplacementCandidates &entries);
+
+    /** Gives a newly inserted block to a partition. */
+    void insert(int part, const ReplaceableEntry *entry);
+
+    /** Takes an invalidated block away from its partition. */
+    void release(const ReplaceableEntry *entry);
+
+    /** Gives a block moved to another entry to the same partition. */
+    void move(const ReplaceableEntry *src, const ReplaceableEntry *dest);
+};
+
+} // namespace gem5
+
+#endif // __MEM_CACHE_TAGS_UTILITY_PARTITIONER_HH__
@@ -0,0 +1,276 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a tag store backed by a small victim buffer.
+ */
+
+#include "mem/cache/tags/victim_tags.hh"
+
+#include <cstring>
+
+#include "base/logging.hh"
+#include "mem/cache/cache_blk.hh"
+#include "mem/cache/tags/sector_tags.hh"
+#include "mem/request.hh"
+
+namespace gem5
+{
+
+VictimTags::VictimTags(const Params &p)
+    : BaseTags(p), tags(p.tags), victimTags(p.victim_tags),
+      swapLatency(p.swap_latency), demoted(nullptr), demotedTo(nullptr),
+      victimStats(stats), swapBuffer(new uint8_t[blkSize])
+{
+    fatal_if(!tags || !victimTags, "Both tags of %s are required.", name());
+    // A sector can only be replaced as a whole, which does not fit a
+    // victim buffer of single blocks
+    fatal_if(dynamic_cast<SectorTags*>(tags) ||
+             dynamic_cast<SectorTags*>(victimTags),
+             "%s does not support sector tags.", name());
+}
+
+void
+VictimTags::tagsInit()
+{
+    tags->tagsInit();
+    victimTags->tagsInit();
+
+    victimTags->forEachBlk([this](CacheBlk &blk) {
+        victimBlks.insert(&blk);
+    });
+}
+
+CacheBlk*
+VictimTags::findBlock(Addr addr, bool is_secure) const
+{
+    CacheBlk *blk = tags->findBlock(addr, is_secure);
+    return blk ? blk : victimTags->findBlock(addr, is_secure);
+}
+
+ReplaceableEntry*
+VictimTags::findBlockBySetAndWay(int set, int way) const
+{
+    return tags->findBlockBySetAndWay(set, way);
+}
+
+void
+VictimTags::setWayAllocationMax(int ways)
+{
+    tags->setWayAllocationMax(ways);
+}
+
+int
+VictimTags::getWayAllocationMax() const
+{
+    return tags->getWayAllocationMax();
+}
+
+void
+VictimTags::invalidate(CacheBlk *blk)
+{
+    if (blk == demoted) {
+        demoted = nullptr;
+    }
+    owner(blk)->invalidate(blk);
+}
+
+VictimTags::BlkState
+VictimTags::extract(CacheBlk *blk, BaseTags *blk_tags, uint8_t *data)
+{
+    assert(blk->isValid());
+
+    BlkState state;
+    state.addr = blk_tags->regenerateBlkAddr(blk);
+    state.isSecure = blk->isSecure();
+    state.coherence = 0;
+    for (const unsigned bit : {CacheBlk::WritableBit, CacheBlk::ReadableBit,
+                               CacheBlk::DirtyBit}) {
+        if (blk->isSet(bit)) {
+            state.coherence |= bit;
+        }
+    }
+    state.prefetched = blk->wasPrefetched();
+    state.prefetchPC = blk->getPrefetchPC();
+    state.taskId = blk->getTaskId();
+    state.requestorId = blk->getSrcRequestorId();
+    std::memcpy(data, blk->data, blkSize);
+
+    blk_tags->invalidate(blk);
+
+    return state;
+}
+
+void
+VictimTags::place(const BlkState &state, CacheBlk *blk, BaseTags *blk_tags,
+                  const PacketPtr pkt)
+{
+    assert(!blk->isValid());
+
+    if (pkt) {
+        blk_tags->insertBlock(pkt, blk);
+    } else {
+        RequestPtr req = std::make_shared<Request>(
+            state.addr, blkSize, 0, state.requestorId);
+        if (state.isSecure) {
+            req->setFlags(Request::SECURE);
+        }
+        req->taskId(state.taskId);
+        Packet tmp_pkt(req, MemCmd::WritebackDirty);
+        blk_tags->insertBlock(&tmp_pkt, blk);
+    }
+
+    blk->setCoherenceBits(state.coherence);
+    if (state.prefetched) {
+        blk->setPrefetched(state.prefetchPC);
+    }
+    blk->setWhenReady(curTick());
+}
+
+CacheBlk*
+VictimTags::findVictim(Addr addr, const bool is_secure,
+                       const std::size_t size,
+                       std::vector<CacheBlk*> &evict_blks,
+                       const PacketPtr pkt)
+{
+    std::vector<CacheBlk*> cache_evict_blks;
+    CacheBlk *victim = tags->findVictim(addr, is_secure, size,
+                                        cache_evict_blks, pkt);
+    demoted = nullptr;
+    demotedTo = nullptr;
+    if (!victim || !victim->isValid()) {
+        return victim;
+    }
+
+    // A valid victim moves to the victim buffer once the new block is
+    // inserted, so the blocks to evict are those it replaces there
+    demoted = victim;
+    demotedTo = victimTags->findVictim(regenerateBlkAddr(victim),
+                                       victim->isSecure(), size,
+                                       evict_blks, nullptr);
+    return victim;
+}
+
+CacheBlk*
+VictimTags::accessBlock(const PacketPtr pkt, Cycles &lat)
+{
+    CacheBlk *blk = tags->accessBlock(pkt, lat);
+    if (blk) {
+        return blk;
+    }
+
+    // The victim buffer is looked up in parallel with the cache
+    Cycles victim_lat;
+    CacheBlk *victim_blk = victimTags->accessBlock(pkt, victim_lat);
+    if (!victim_blk) {
+        return nullptr;
+    }
+    victimStats.hits++;
+    lat += swapLatency;
+
+    // If the cache has no room for the block it is accessed in the
+    // victim buffer
+    std::vector<CacheBlk*> evict_blks;
+    CacheBlk *victim = tags->findVictim(pkt->getAddr(), pkt->isSecure(),
+                                        blkSize * 8, evict_blks, pkt);
+    if (!victim) {
+        victim_blk->increaseRefCount();
+        return victim_blk;
+    }
+
+    // Swap the block with the one it replaces in the cache, which takes
+    // the entry it frees in the victim buffer, so nothing is evicted
+    const BlkState state = extract(victim_blk, victimTags, swapBuffer.get());
+    if (victim->isValid()) {
+        transfer(victim, tags, victim_blk, victimTags);
+        victimStats.demotions++;
+    }
+    std::memcpy(victim->data, swapBuffer.get(), blkSize);
+    place(state, victim, tags, pkt);
+    victim->increaseRefCount();
+    victimStats.swaps++;
+
+    return victim;
+}
+
+Addr
+VictimTags::extractTag(const Addr addr) const
+{
+    return tags->extractTag(addr);
+}
+
+void
+VictimTags::insertBlock(const PacketPtr pkt, CacheBlk *blk)
+{
+    if (blk == demoted && blk->isValid()) {
+        transfer(blk, tags, demotedTo, victimTags);
+        victimStats.demotions++;
+    }
+    demoted = nullptr;
+    demotedTo = nullptr;
+
+    owner(blk)->insertBlock(pkt, blk);
+}
+
+void
+VictimTags::moveBlock(CacheBlk *src_blk, CacheBlk *dest_blk)
+{
+    panic_if(isVictimBlk(src_blk) || isVictimBlk(dest_blk),
+             "Blocks cannot be moved in the victim buffer of %s.", name());
+    tags->moveBlock(src_blk, dest_blk);
+}
+
+Addr
+VictimTags::regenerateBlkAddr(const CacheBlk *blk) const
+{
+    return owner(blk)->regenerateBlkAddr(blk);
+}
+
+void
+VictimTags::forEachBlk(std::function<void(CacheBlk &)> visitor)
+{
+    tags->forEachBlk(visitor);
+    victimTags->forEachBlk(visitor);
+}
+
+bool
+VictimTags::anyBlk(std::function<bool(CacheBlk &)> visitor)
+{
+    return tags->anyBlk(visitor) || victimTags->anyBlk(visitor);
+}
+
+VictimTags::VictimTagsStats::VictimTagsStats(BaseTagStats &base_group)
+  : statistics::Group(&base_group, "victim"),
+    ADD_STAT(hits, statistics::units::Count::get(),
+             "Number of misses in the cache that hit in the victim buffer"),
+    ADD_STAT(demotions, statistics::units::Count::get(),
+             "Number of blocks moved into the victim buffer"),
+    ADD_STAT(swaps, statistics::units::Count::get(),
+             "Number of blocks swapped back into the cache")
+{
+}
+
+} // namespace gem5
@@ -0,0 +1,209 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a tag store backed by a small victim buffer.
+ */
+
+#ifndef __MEM_CACHE_TAGS_VICTIM_TAGS_HH__
+#define __MEM_CACHE_TAGS_VICTIM_TAGS_HH__
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "mem/cache/tags/base.hh"
+#include "mem/packet.hh"
+#include "params/VictimTags.hh"
+
+namespace gem5
+{
+
+class CacheBlk;
+
+/**
+ * A tag store made of the tags of the cache and of a small fully
+ * associative victim buffer, usually a FALRU. The blocks replaced in the
+ * cache are moved into the victim buffer instead of being evicted, and
+ * only the blocks replaced in the victim buffer leave the cache. A miss in
+ * the cache that hits in the victim buffer swaps the block back into the
+ * cache, in exchange for the block it replaces.
+ *
+ * The blocks of the victim buffer are still part of the cache, so that
+ * lookups, snoops and functional accesses find them: the cache only sees
+ * a tag store with a few more blocks, which mostly absorb the conflict
+ * misses of a low associativity cache.
+ */
+class VictimTags : public BaseTags
+{
+  protected:
+    /** The tags of the cache. */
+    BaseTags *tags;
+
+    /** The tags of the victim buffer. */
+    BaseTags *victimTags;
+
+    /** Extra latency of a hit in the victim buffer. */
+    const Cycles swapLatency;
+
+    /** The blocks of the victim buffer. */
+    std::unordered_set<const CacheBlk*> victimBlks;
+
+    /**
+     * The block of the cache chosen as a victim by the last call to
+     * findVictim, and the entry of the victim buffer it moves to once the
+     * new block is inserted in its place.
+     */
+    CacheBlk *demoted;
+    CacheBlk *demotedTo;
+
+    struct VictimTagsStats : public statistics::Group
+    {
+        VictimTagsStats(BaseTagStats &base_group);
+
+        /** Number of misses in the cache that hit in the victim buffer. */
+        statistics::Scalar hits;
+
+        /** Number of blocks moved into the victim buffer. */
+        statistics::Scalar demotions;
+
+        /** Number of blocks swapped back into the cache. */
+        statistics::Scalar swaps;
+    } victimStats;
+
+    /** Whether a block belongs to the victim buffer. */
+    bool
+    isVictimBlk(const CacheBlk *blk) const
+    {
+        return victimBlks.count(blk);
+    }
+
+    /** The tags a block belongs to. */
+    BaseTags *
+    owner(const CacheBlk *blk) const
+    {
+        return isVictimBlk(blk) ? victimTags : tags;
+    }
+
+    /** The state of a block that is moved between the tags. */
+    struct BlkState
+    {
+        Addr addr;
+        bool isSecure;
+        unsigned coherence;
+        bool prefetched;
+        Addr prefetchPC;
+        uint32_t taskId;
+        uint32_t requestorId;
+    };
+
+    /** Holds the data of a block swapped back into the cache. */
+    std::unique_ptr<uint8_t[]> swapBuffer;
+
+    /**
+     * Take a valid block out of its tags, with its data and state. Its
+     * load locks and reference count are lost, as on an eviction.
+     *
+     * @param blk The block.
+     * @param blk_tags The tags of the block.
+     * @param data Where to copy the data of the block.
+     * @return The state of the block.
+     */
+    BlkState extract(CacheBlk *blk, BaseTags *blk_tags, uint8_t *data);
+
+    /**
+     * Insert a block taken out of other tags in an invalid entry, whose
+     * data has already been filled.
+     *
+     * @param state The state of the block.
+     * @param blk The entry.
+     * @param blk_tags The tags of the entry.
+     * @param pkt The request inserting the block, or nullptr to insert it
+     *        on behalf of its previous requestor.
+     */
+    void place(const BlkState &state, CacheBlk *blk, BaseTags *blk_tags,
+               const PacketPtr pkt);
+
+    /** Move a valid block to an invalid entry of other tags. */
+    void
+    transfer(CacheBlk *src, BaseTags *src_tags, CacheBlk *dest,
+             BaseTags *dest_tags)
+    {
+        place(extract(src, src_tags, dest->data), dest, dest_tags, nullptr);
+    }
+
+  public:
+    PARAMS(VictimTags);
+    VictimTags(const Params &p);
+
+    void tagsInit() override;
+
+    CacheBlk *findBlock(Addr addr, bool is_secure) const override;
+
+    ReplaceableEntry *findBlockBySetAndWay(int set,
+                                           int way) const override;
+
+    void setWayAllocationMax(int ways) override;
+    int getWayAllocationMax() const override;
+
+    void invalidate(CacheBlk *blk) override;
+
+    /**
+     * Find a victim in the cache. If it is valid it will move into the
+     * victim buffer, so the blocks to evict are those of the victim
+     * buffer it replaces.
+     */
+    CacheBlk *findVictim(Addr addr, const bool is_secure,
+                         const std::size_t size,
+                         std::vector<CacheBlk*> &evict_blks,
+                         const PacketPtr pkt) override;
+
+    /**
+     * Look the block up in the cache, and on a miss in the victim buffer.
+     * A hit in the victim buffer swaps the block back into the cache.
+     */
+    CacheBlk *accessBlock(const PacketPtr pkt, Cycles &lat) override;
+
+    Addr extractTag(const Addr addr) const override;
+
+    void insertBlock(const PacketPtr pkt, CacheBlk *blk) override;
+
+    void moveBlock(CacheBlk *src_blk, CacheBlk *dest_blk) override;
+
+    Addr regenerateBlkAddr(const CacheBlk *blk) const override;
+
+    void forEachBlk(std::function<void(CacheBlk &)> visitor) override;
+
+    bool anyBlk(std::function<bool(CacheBlk &)> visitor) override;
+};
+
+} // namespace gem5
+
+#endif // __MEM_CACHE_TAGS_VICTIM_TAGS_HH__
@@ -0,0 +1,134 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of the way predictors of set associative tags.
+ */
+
+#include "mem/cache/tags/way_predictor.hh"
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+BaseWayPredictor::BaseWayPredictor(const Params &p)
+    : SimObject(p), numSets(0), assoc(0), stats(*this)
+{
+}
+
+void
+BaseWayPredictor::setup(uint32_t num_sets, uint32_t _assoc)
+{
+    numSets = num_sets;
+    assoc = _assoc;
+    mruWays.assign(num_sets, 0);
+}
+
+void
+BaseWayPredictor::update(const PacketPtr pkt, uint32_t set, uint32_t way)
+{
+    mruWays[set] = way;
+}
+
+unsigned
+BaseWayPredictor::resolve(uint32_t predicted, uint32_t way, bool hit)
+{
+    unsigned reads = 1;
+    if (!hit) {
+        stats.misses++;
+    } else if (predicted == way) {
+        stats.correct++;
+    } else {
+        stats.incorrect++;
+        reads++;
+    }
+    if (assoc > reads)
+        stats.dataReadsAvoided += assoc - reads;
+    return reads;
+}
+
+BaseWayPredictor::WayPredictorStats::WayPredictorStats(
+    BaseWayPredictor &predictor)
+    : statistics::Group(&predictor),
+      ADD_STAT(correct, statistics::units::Count::get(),
+               "Number of hits found in the predicted way"),
+      ADD_STAT(incorrect, statistics::units::Count::get(),
+               "Number of hits found in another way, which cost an extra "
+               "cycle"),
+      ADD_STAT(misses, statistics::units::Count::get(),
+               "Number of misses, which read the predicted way for nothing"),
+      ADD_STAT(accuracy, statistics::units::Ratio::get(),
+               "Fraction of the hits found in the predicted way",
+               correct / (correct + incorrect)),
+      ADD_STAT(dataReadsAvoided, statistics::units::Count::get(),
+               "Number of data array reads saved over reading every way")
+{
+}
+
+MRUWayPredictor::MRUWayPredictor(const Params &p)
+    : BaseWayPredictor(p)
+{
+}
+
+uint32_t
+MRUWayPredictor::predict(const PacketPtr pkt, uint32_t set) const
+{
+    return mruWays[set];
+}
+
+PCWayPredictor::PCWayPredictor(const Params &p)
+    : BaseWayPredictor(p), table(p.table_entries, 0)
+{
+    fatal_if(!isPowerOf2(p.table_entries),
+             "%s: the number of table entries must be a power of 2",
+             name());
+}
+
+size_t
+PCWayPredictor::index(const PacketPtr pkt, uint32_t set) const
+{
+    return ((pkt->req->getPC() >> 2) ^ set) & (table.size() - 1);
+}
+
+uint32_t
+PCWayPredictor::predict(const PacketPtr pkt, uint32_t set) const
+{
+    if (!pkt->req->hasPC())
+        return mruWays[set];
+    return table[index(pkt, set)];
+}
+
+void
+PCWayPredictor::update(const PacketPtr pkt, uint32_t set, uint32_t way)
+{
+    BaseWayPredictor::update(pkt, set, way);
+    if (pkt->req->hasPC())
+        table[index(pkt, set)] = way;
+}
+
+} // namespace gem5
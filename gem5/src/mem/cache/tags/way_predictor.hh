@@ -0,0 +1,156 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of the way predictors of set associative tags.
+ */
+
+#ifndef __MEM_CACHE_TAGS_WAY_PREDICTOR_HH__
+#define __MEM_CACHE_TAGS_WAY_PREDICTOR_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "mem/packet.hh"
+#include "params/BaseWayPredictor.hh"
+#include "params/MRUWayPredictor.hh"
+#include "params/PCWayPredictor.hh"
+#include "sim/sim_object.hh"
+
+namespace gem5
+{
+
+/**
+ * A way predictor lets a set associative cache read the data of a single
+ * way along with the tags, instead of the data of every way. If the block
+ * is found in another way, its data is read in the next cycle. A miss
+ * reads the data of the predicted way for nothing.
+ */
+class BaseWayPredictor : public SimObject
+{
+  protected:
+    /** Number of sets of the cache. */
+    uint32_t numSets;
+
+    /** Associativity of the cache. */
+    uint32_t assoc;
+
+    /** Way of each set accessed or filled last. */
+    std::vector<uint32_t> mruWays;
+
+    struct WayPredictorStats : public statistics::Group
+    {
+        WayPredictorStats(BaseWayPredictor &predictor);
+
+        /** Hits found in the predicted way */
+        statistics::Scalar correct;
+        /** Hits found in another way */
+        statistics::Scalar incorrect;
+        /** Misses, which read the predicted way for nothing */
+        statistics::Scalar misses;
+        statistics::Formula accuracy;
+        /** Data reads saved over reading every way in parallel */
+        statistics::Scalar dataReadsAvoided;
+    } stats;
+
+  public:
+    PARAMS(BaseWayPredictor);
+    BaseWayPredictor(const Params &p);
+
+    /**
+     * Size the predictor after the cache.
+     * @param num_sets Number of sets of the cache
+     * @param assoc Associativity of the cache
+     */
+    virtual void setup(uint32_t num_sets, uint32_t assoc);
+
+    /**
+     * Predict the way an access finds its block in.
+     * @param pkt The access
+     * @param set The set the access maps to
+     */
+    virtual uint32_t predict(const PacketPtr pkt, uint32_t set) const = 0;
+
+    /**
+     * Learn the way an access found its block in, or filled it into.
+     * @param pkt The access
+     * @param set The set of the block
+     * @param way The way of the block
+     */
+    virtual void update(const PacketPtr pkt, uint32_t set, uint32_t way);
+
+    /**
+     * Account for the outcome of a prediction.
+     * @param predicted The way predicted
+     * @param way The way the block was found in
+     * @param hit Whether the block was found at all
+     * @return The number of data arrays read
+     */
+    unsigned resolve(uint32_t predicted, uint32_t way, bool hit);
+};
+
+/**
+ * Predicts the way of a set which was accessed last, as in Inoue et al.,
+ * "Way-predicting set-associative cache for high performance and low
+ * energy consumption", ISLPED 1999.
+ */
+class MRUWayPredictor : public BaseWayPredictor
+{
+  public:
+    PARAMS(MRUWayPredictor);
+    MRUWayPredictor(const Params &p);
+
+    uint32_t predict(const PacketPtr pkt, uint32_t set) const override;
+};
+
+/**
+ * Predicts from a table indexed by the PC of the access and the set, as
+ * in Powell et al., "Reducing set-associative cache energy via
+ * way-prediction and selective direct-mapping", MICRO 2001. Accesses
+ * without a PC fall back to the way of the set accessed last.
+ */
+class PCWayPredictor : public BaseWayPredictor
+{
+  private:
+    /** Predicted way of each table entry. */
+    std::vector<uint32_t> table;
+
+    /** Table index of an access. */
+    size_t index(const PacketPtr pkt, uint32_t set) const;
+
+  public:
+    PARAMS(PCWayPredictor);
+    PCWayPredictor(const Params &p);
+
+    uint32_t predict(const PacketPtr pkt, uint32_t set) const override;
+    void update(const PacketPtr pkt, uint32_t set, uint32_t way) override;
+};
+
+} // namespace gem5
+
+#endif // __MEM_CACHE_TAGS_WAY_PREDICTOR_HH__
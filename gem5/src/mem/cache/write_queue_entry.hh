@@ -51,6 +51,7 @@
 #include <list>
 #include <string>
 
+#include "base/inline_vector.hh"
 #include "base/printable.hh"
 #include "base/types.hh"
 #include "mem/cache/queue_entry.hh"
@@ -75,7 +76,7 @@ class WriteQueueEntry : public QueueEntry, public Printable
     friend class WriteQueue;
 
   public:
-    class TargetList : public std::list<Target>
+    class TargetList : public InlineVector<Target, 1>
     {
 
       public:
@@ -133,6 +133,7 @@ CfiMemory::ProgramBuffer::writeback()
     } else {
         std::memcpy(parent.toHostAddr(parent.start() + blockPointer),
             buffer.data(), bytesWritten);
+        parent.markDirty(parent.start() + blockPointer, bytesWritten);
         return true;
     }
 }
@@ -741,6 +742,7 @@ CfiMemory::BlockData::erase(PacketPtr pkt)
 {
     auto host_address = parent.toHostAddr(pkt->getAddr());
     std::memset(host_address, 0xff, blockSize);
+    parent.markDirty(pkt->getAddr(), blockSize);
 }
 
 } // namespace memory
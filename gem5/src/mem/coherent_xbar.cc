@@ -340,8 +340,8 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id)
 
             // remember where to route the normal response to
             if (expect_response || expect_snoop_resp) {
-                assert(routeTo.find(pkt->req) == routeTo.end());
-                routeTo[pkt->req] = cpu_side_port_id;
+                assert(routeTo.find(pkt->req) == InvalidPortID);
+                routeTo.insert(pkt->req, cpu_side_port_id);
 
                 panic_if(routeTo.size() > maxRoutingTableSizeCheck,
                          "%s: Routing table exceeds %d packets\n",
@@ -353,8 +353,7 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id)
         }
 
         // stats updates only consider packets that were successfully sent
-        pktCount[cpu_side_port_id][mem_side_port_id]++;
-        pktSize[cpu_side_port_id][mem_side_port_id] += pkt_size;
+        countTraffic(cpu_side_port_id, mem_side_port_id, pkt_size);
         transDist[pkt_cmd]++;
 
         if (is_express_snoop) {
@@ -395,21 +394,19 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id)
                 assert(rsp_pkt);
 
                 // determine the destination
-                const auto route_lookup = routeTo.find(rsp_pkt->req);
-                assert(route_lookup != routeTo.end());
-                rsp_port_id = route_lookup->second;
+                rsp_port_id = routeTo.find(rsp_pkt->req);
                 assert(rsp_port_id != InvalidPortID);
                 assert(rsp_port_id < respLayers.size());
                 // remove the request from the routing table
-                routeTo.erase(route_lookup);
+                routeTo.erase(rsp_pkt->req);
             }
             outstandingCMO.erase(cmo_lookup);
         } else {
             respond_directly = false;
             outstandingCMO.emplace(pkt->id, deferred_rsp);
             if (!pkt->isWrite()) {
-                assert(routeTo.find(pkt->req) == routeTo.end());
-                routeTo[pkt->req] = cpu_side_port_id;
+                assert(routeTo.find(pkt->req) == InvalidPortID);
+                routeTo.insert(pkt->req, cpu_side_port_id);
 
                 panic_if(routeTo.size() > maxRoutingTableSizeCheck,
                          "%s: Routing table exceeds %d packets\n",
@@ -450,9 +447,7 @@ CoherentXBar::recvTimingResp(PacketPtr pkt, PortID mem_side_port_id)
     RequestPort *src_port = memSidePorts[mem_side_port_id];
 
     // determine the destination
-    const auto route_lookup = routeTo.find(pkt->req);
-    assert(route_lookup != routeTo.end());
-    const PortID cpu_side_port_id = route_lookup->second;
+    const PortID cpu_side_port_id = routeTo.find(pkt->req);
     assert(cpu_side_port_id != InvalidPortID);
     assert(cpu_side_port_id < respLayers.size());
 
@@ -494,13 +489,12 @@ CoherentXBar::recvTimingResp(PacketPtr pkt, PortID mem_side_port_id)
                                         + latency);
 
     // remove the request from the routing table
-    routeTo.erase(route_lookup);
+    routeTo.erase(pkt->req);
 
     respLayers[cpu_side_port_id]->succeededTiming(packetFinishTime);
 
     // stats updates
-    pktCount[cpu_side_port_id][mem_side_port_id]++;
-    pktSize[cpu_side_port_id][mem_side_port_id] += pkt_size;
+    countTraffic(cpu_side_port_id, mem_side_port_id, pkt_size);
     transDist[pkt_cmd]++;
 
     return true;
@@ -554,8 +548,8 @@ CoherentXBar::recvTimingSnoopReq(PacketPtr pkt, PortID mem_side_port_id)
 
     // if we can expect a response, remember how to route it
     if (!cache_responding && pkt->cacheResponding()) {
-        assert(routeTo.find(pkt->req) == routeTo.end());
-        routeTo[pkt->req] = mem_side_port_id;
+        assert(routeTo.find(pkt->req) == InvalidPortID);
+        routeTo.insert(pkt->req, mem_side_port_id);
     }
 
     // a snoop request came from a connected CPU-side-port device (one of
@@ -573,9 +567,7 @@ CoherentXBar::recvTimingSnoopResp(PacketPtr pkt, PortID cpu_side_port_id)
     ResponsePort* src_port = cpuSidePorts[cpu_side_port_id];
 
     // get the destination
-    const auto route_lookup = routeTo.find(pkt->req);
-    assert(route_lookup != routeTo.end());
-    const PortID dest_port_id = route_lookup->second;
+    const PortID dest_port_id = routeTo.find(pkt->req);
     assert(dest_port_id != InvalidPortID);
 
     // determine if the response is from a snoop request we
@@ -645,8 +637,7 @@ CoherentXBar::recvTimingSnoopResp(PacketPtr pkt, PortID cpu_side_port_id)
 
         [[maybe_unused]] bool success =
             memSidePorts[dest_port_id]->sendTimingSnoopResp(pkt);
-        pktCount[cpu_side_port_id][dest_port_id]++;
-        pktSize[cpu_side_port_id][dest_port_id] += pkt_size;
+        countTraffic(cpu_side_port_id, dest_port_id, pkt_size);
         assert(success);
 
         snoopLayers[dest_port_id]->succeededTiming(packetFinishTime);
@@ -685,7 +676,7 @@ CoherentXBar::recvTimingSnoopResp(PacketPtr pkt, PortID cpu_side_port_id)
     }
 
     // remove the request from the routing table
-    routeTo.erase(route_lookup);
+    routeTo.erase(pkt->req);
 
     // stats updates
     transDist[pkt_cmd]++;
@@ -827,8 +818,7 @@ CoherentXBar::recvAtomicBackdoor(PacketPtr pkt, PortID cpu_side_port_id,
     }
 
     // stats updates for the request
-    pktCount[cpu_side_port_id][mem_side_port_id]++;
-    pktSize[cpu_side_port_id][mem_side_port_id] += pkt_size;
+    countTraffic(cpu_side_port_id, mem_side_port_id, pkt_size);
     transDist[pkt_cmd]++;
 
 
@@ -875,8 +865,7 @@ CoherentXBar::recvAtomicBackdoor(PacketPtr pkt, PortID cpu_side_port_id,
         pkt_cmd = pkt->cmdToIndex();
 
         // stats updates
-        pktCount[cpu_side_port_id][mem_side_port_id]++;
-        pktSize[cpu_side_port_id][mem_side_port_id] += pkt_size;
+        countTraffic(cpu_side_port_id, mem_side_port_id, pkt_size);
         transDist[pkt_cmd]++;
     }
 
@@ -39,6 +39,7 @@
 
 #include "mem/comm_monitor.hh"
 
+#include "base/intmath.hh"
 #include "base/trace.hh"
 #include "debug/CommMonitor.hh"
 #include "sim/core.hh"
@@ -55,8 +56,16 @@ CommMonitor::CommMonitor(const Params &params)
       samplePeriodicEvent([this]{ samplePeriodic(); }, name()),
       samplePeriodTicks(params.sample_period),
       samplePeriod(params.sample_period / sim_clock::as_float::s),
+      latencySampleRate(params.latency_sample_rate),
+      latencyCount(0),
       stats(this, params)
 {
+    fatal_if(latencySampleRate == 0, "%s: latency_sample_rate must be at "
+             "least 1.\n", name());
+    fatal_if(params.low_overhead && params.bandwidth_windows == 0,
+             "%s: bandwidth_windows must be at least 1 in the low overhead "
+             "mode.\n", name());
+
     DPRINTF(CommMonitor,
             "Created monitor %s with sample period %d ticks (%f ms)\n",
             name(), samplePeriodTicks, samplePeriod * 1E3);
@@ -105,7 +114,8 @@ CommMonitor::MonitorStats::MonitorStats(statistics::Group *parent,
                                         const CommMonitorParams &params)
     : statistics::Group(parent),
 
-      disableBurstLengthHists(params.disable_burst_length_hists),
+      disableBurstLengthHists(params.disable_burst_length_hists ||
+                              params.low_overhead),
       ADD_STAT(readBurstLengthHist, statistics::units::Byte::get(),
                "Histogram of burst lengths of transmitted packets"),
       ADD_STAT(writeBurstLengthHist, statistics::units::Byte::get(),
@@ -135,13 +145,15 @@ CommMonitor::MonitorStats::MonitorStats(statistics::Group *parent,
                "Average write bandwidth",
                totalWrittenBytes / simSeconds),
 
-      disableLatencyHists(params.disable_latency_hists),
+      lowOverhead(params.low_overhead),
+      disableLatencyHists(params.disable_latency_hists || lowOverhead),
+      measureLatency(!params.disable_latency_hists),
       ADD_STAT(readLatencyHist, statistics::units::Tick::get(),
                "Read request-response latency"),
       ADD_STAT(writeLatencyHist, statistics::units::Tick::get(),
                "Write request-response latency"),
 
-      disableITTDists(params.disable_itt_dists),
+      disableITTDists(params.disable_itt_dists || params.low_overhead),
       ADD_STAT(ittReadRead, statistics::units::Tick::get(),
                "Read-to-read inter transaction time"),
       ADD_STAT(ittWriteWrite, statistics::units::Tick::get(),
@@ -150,7 +162,8 @@ CommMonitor::MonitorStats::MonitorStats(statistics::Group *parent,
                "Request-to-request inter transaction time"),
       timeOfLastRead(0), timeOfLastWrite(0), timeOfLastReq(0),
 
-      disableOutstandingHists(params.disable_outstanding_hists),
+      disableOutstandingHists(params.disable_outstanding_hists ||
+                              params.low_overhead),
       ADD_STAT(outstandingReadsHist, statistics::units::Count::get(),
                "Outstanding read transactions"),
       outstandingReadReqs(0),
@@ -158,7 +171,8 @@ CommMonitor::MonitorStats::MonitorStats(statistics::Group *parent,
                "Outstanding write transactions"),
       outstandingWriteReqs(0),
 
-      disableTransactionHists(params.disable_transaction_hists),
+      disableTransactionHists(params.disable_transaction_hists ||
+                              params.low_overhead),
       ADD_STAT(readTransHist, statistics::units::Count::get(),
                "Histogram of read transactions per sample period"),
       readTrans(0),
@@ -166,13 +180,27 @@ CommMonitor::MonitorStats::MonitorStats(statistics::Group *parent,
                "Histogram of write transactions per sample period"),
       writeTrans(0),
 
-      disableAddrDists(params.disable_addr_dists),
+      disableAddrDists(params.disable_addr_dists || params.low_overhead),
       readAddrMask(params.read_addr_mask),
       writeAddrMask(params.write_addr_mask),
       ADD_STAT(readAddrDist, statistics::units::Count::get(),
                "Read address distribution"),
       ADD_STAT(writeAddrDist, statistics::units::Count::get(),
-               "Write address distribution")
+               "Write address distribution"),
+
+      ADD_STAT(readLatencyPercentiles, statistics::units::Tick::get(),
+               "Percentiles of the sampled read latencies"),
+      ADD_STAT(writeLatencyPercentiles, statistics::units::Tick::get(),
+               "Percentiles of the sampled write latencies"),
+      readWindows(lowOverhead ? params.bandwidth_windows : 0),
+      writeWindows(lowOverhead ? params.bandwidth_windows : 0),
+      numWindows(0),
+      ADD_STAT(readWindowBandwidth, statistics::units::Rate<
+                    statistics::units::Byte, statistics::units::Second>::get(),
+               "Read bandwidth of the last sample periods, oldest first"),
+      ADD_STAT(writeWindowBandwidth, statistics::units::Rate<
+                    statistics::units::Byte, statistics::units::Second>::get(),
+               "Write bandwidth of the last sample periods, oldest first")
 {
     using namespace statistics;
 
@@ -253,6 +281,126 @@ CommMonitor::MonitorStats::MonitorStats(statistics::Group *parent,
     writeAddrDist
         .init(0)
         .flags(disableAddrDists ? nozero : pdf);
+
+    for (auto *percentiles : {&readLatencyPercentiles,
+                              &writeLatencyPercentiles}) {
+        percentiles->init(3).flags(lowOverhead ? none : nozero);
+        percentiles->subname(0, "p50");
+        percentiles->subname(1, "p90");
+        percentiles->subname(2, "p99");
+    }
+
+    readWindowBandwidth
+        .init(std::max<size_t>(readWindows.size(), 1))
+        .flags(lowOverhead ? none : nozero);
+
+    writeWindowBandwidth
+        .init(std::max<size_t>(writeWindows.size(), 1))
+        .flags(lowOverhead ? none : nozero);
+}
+
+void
+CommMonitor::MonitorStats::sampleWindow(double period)
+{
+    if (readWindows.empty())
+        return;
+
+    const size_t idx = numWindows % readWindows.size();
+    readWindows[idx] = readBytes / period;
+    writeWindows[idx] = writtenBytes / period;
+    ++numWindows;
+}
+
+void
+CommMonitor::MonitorStats::preDumpStats()
+{
+    statistics::Group::preDumpStats();
+
+    if (!lowOverhead)
+        return;
+
+    const double fractions[] = { 0.5, 0.9, 0.99 };
+    for (int i = 0; i < 3; i++) {
+        readLatencyPercentiles[i] =
+            readLatencySketch.percentile(fractions[i]);
+        writeLatencyPercentiles[i] =
+            writeLatencySketch.percentile(fractions[i]);
+    }
+
+    const size_t size = readWindows.size();
+    const uint64_t first = numWindows > size ? numWindows - size : 0;
+    for (size_t i = 0; i < size; i++) {
+        const uint64_t window = first + i;
+        const bool valid = window < numWindows;
+        readWindowBandwidth[i] = valid ? readWindows[window % size] : 0;
+        writeWindowBandwidth[i] = valid ? writeWindows[window % size] : 0;
+    }
+}
+
+void
+CommMonitor::MonitorStats::resetStats()
+{
+    statistics::Group::resetStats();
+
+    readLatencySketch.reset();
+    writeLatencySketch.reset();
+    numWindows = 0;
+}
+
+size_t
+CommMonitor::LatencySketch::bucket(Tick latency)
+{
+    // Latencies below 2^(subBits + 1) have a bucket of their own, the
+    // larger ones share them by the subBits bits below their leading one
+    if (latency < (Tick(1) << (subBits + 1)))
+        return latency;
+    const int log = floorLog2(latency);
+    return ((log - subBits + 1) << subBits) |
+        ((latency >> (log - subBits)) & mask(subBits));
+}
+
+Tick
+CommMonitor::LatencySketch::bucketStart(size_t idx)
+{
+    if (idx < (1 << (subBits + 1)))
+        return idx;
+    const int log = (idx >> subBits) + subBits - 1;
+    return (Tick(1) << log) | (Tick(idx & mask(subBits)) << (log - subBits));
+}
+
+void
+CommMonitor::LatencySketch::sample(Tick latency)
+{
+    ++buckets[bucket(latency)];
+    ++samples;
+}
+
+Tick
+CommMonitor::LatencySketch::percentile(double fraction) const
+{
+    if (samples == 0)
+        return 0;
+
+    // Number of samples up to and including the percentile
+    const uint64_t rank = std::max<uint64_t>(1, fraction * samples + 0.5);
+    uint64_t seen = 0;
+    for (size_t idx = 0; idx < numBuckets; idx++) {
+        seen += buckets[idx];
+        if (seen >= rank) {
+            const Tick start = bucketStart(idx);
+            if (idx + 1 == numBuckets)
+                return start;
+            return start + (bucketStart(idx + 1) - start) / 2;
+        }
+    }
+    return bucketStart(numBuckets - 1);
+}
+
+void
+CommMonitor::LatencySketch::reset()
+{
+    buckets.fill(0);
+    samples = 0;
 }
 
 void
@@ -324,7 +472,8 @@ CommMonitor::MonitorStats::updateReqStats(
 
 void
 CommMonitor::MonitorStats::updateRespStats(
-    const probing::PacketInfo& pkt_info, Tick latency, bool is_atomic)
+    const probing::PacketInfo& pkt_info, Tick latency, bool is_atomic,
+    bool sampled)
 {
     if (pkt_info.cmd.isRead()) {
         // Decrement number of outstanding read requests
@@ -333,8 +482,10 @@ CommMonitor::MonitorStats::updateRespStats(
             --outstandingReadReqs;
         }
 
-        if (!disableLatencyHists)
+        if (sampled && !disableLatencyHists)
             readLatencyHist.sample(latency);
+        if (sampled && lowOverhead)
+            readLatencySketch.sample(latency);
 
         // Update the bandwidth stats based on responses for reads
         if (!disableBandwidthHists) {
@@ -349,8 +500,10 @@ CommMonitor::MonitorStats::updateRespStats(
             --outstandingWriteReqs;
         }
 
-        if (!disableLatencyHists)
+        if (sampled && !disableLatencyHists)
             writeLatencyHist.sample(latency);
+        if (sampled && lowOverhead)
+            writeLatencySketch.sample(latency);
     }
 }
 
@@ -366,7 +519,7 @@ CommMonitor::recvAtomic(PacketPtr pkt)
 
     stats.updateReqStats(req_pkt_info, true, expects_response);
     if (expects_response)
-        stats.updateRespStats(req_pkt_info, delay, true);
+        stats.updateRespStats(req_pkt_info, delay, true, sampleLatency());
 
     // Some packets, such as WritebackDirty, don't need response.
     assert(pkt->isResponse() || !expects_response);
@@ -398,15 +551,16 @@ CommMonitor::recvTimingReq(PacketPtr pkt)
     // would see a request which needs a response, but this response
     // would not come back from the memory. Therefore we additionally
     // have to check the cacheResponding flag
-    if (expects_response && !stats.disableLatencyHists) {
-        pkt->pushSenderState(new CommMonitorSenderState(curTick()));
+    const bool sampled = expects_response && sampleLatency();
+    if (sampled) {
+        pkt->pushSenderState(new CommMonitorSenderState(curTick(), this));
     }
 
     // Attempt to send the packet
     bool successful = memSidePort.sendTimingReq(pkt);
 
     // If not successful, restore the sender state
-    if (!successful && expects_response && !stats.disableLatencyHists) {
+    if (!successful && sampled) {
         delete pkt->popSenderState();
     }
 
@@ -436,11 +590,12 @@ CommMonitor::recvTimingResp(PacketPtr pkt)
     CommMonitorSenderState* received_state =
         dynamic_cast<CommMonitorSenderState*>(pkt->senderState);
 
-    if (!stats.disableLatencyHists) {
-        // Restore initial sender state
-        if (received_state == NULL)
-            panic("Monitor got a response without monitor sender state\n");
+    // Only the sampled requests carry a sender state of this monitor
+    const bool sampled = received_state && received_state->monitor == this;
+    if (stats.measureLatency && latencySampleRate == 1 && !sampled)
+        panic("Monitor got a response without monitor sender state\n");
 
+    if (sampled) {
         // Restore the sate
         pkt->senderState = received_state->predecessor;
     }
@@ -448,7 +603,7 @@ CommMonitor::recvTimingResp(PacketPtr pkt)
     // Attempt to send the packet
     bool successful = cpuSidePort.sendTimingResp(pkt);
 
-    if (!stats.disableLatencyHists) {
+    if (sampled) {
         // If packet successfully send, sample value of latency,
         // afterwards delete sender state, otherwise restore state
         if (successful) {
@@ -466,7 +621,7 @@ CommMonitor::recvTimingResp(PacketPtr pkt)
         ppPktResp->notify(pkt_info);
         DPRINTF(CommMonitor, "Received %s response\n", pkt->isRead() ? "read" :
                 pkt->isWrite() ?  "write" : "non read/write");
-        stats.updateRespStats(pkt_info, latency, false);
+        stats.updateRespStats(pkt_info, latency, false, sampled);
     }
     return successful;
 }
@@ -547,6 +702,7 @@ CommMonitor::samplePeriodic()
         if (!stats.disableBandwidthHists) {
             stats.readBandwidthHist.sample(stats.readBytes / samplePeriod);
             stats.writeBandwidthHist.sample(stats.writtenBytes / samplePeriod);
+            stats.sampleWindow(samplePeriod);
         }
 
         if (!stats.disableOutstandingHists) {
@@ -40,6 +40,9 @@
 #ifndef __MEM_COMM_MONITOR_HH__
 #define __MEM_COMM_MONITOR_HH__
 
+#include <array>
+#include <vector>
+
 #include "base/statistics.hh"
 #include "mem/port.hh"
 #include "params/CommMonitor.hh"
@@ -59,6 +62,11 @@ namespace gem5
  * (read-read, write-write, read/write-read/write). Furthermore it allows
  * to capture the number of accesses to an address over time ("heat map").
  * All stats can be disabled from Python.
+ *
+ * In the low overhead mode only the bandwidth and the latency are
+ * measured, in fixed size arrays rather than histograms: the bandwidth of
+ * each of the last sample periods, and percentiles of the latency of one
+ * in every latency_sample_rate requests.
  */
 class CommMonitor : public SimObject
 {
@@ -99,9 +107,11 @@ class CommMonitor : public SimObject
          * calculate round-trip latency.
          *
          * @param _transmitTime Time of packet transmission
+         * @param _monitor Monitor measuring the latency
          */
-        CommMonitorSenderState(Tick _transmitTime)
-            : transmitTime(_transmitTime)
+        CommMonitorSenderState(Tick _transmitTime,
+                               const CommMonitor *_monitor)
+            : transmitTime(_transmitTime), monitor(_monitor)
         { }
 
         /** Destructor */
@@ -110,6 +120,46 @@ class CommMonitor : public SimObject
         /** Tick when request is transmitted */
         Tick transmitTime;
 
+        /**
+         * Monitor that pushed the state, as only some requests carry one
+         * when sampling and the state on top of a response may belong to
+         * another monitor
+         */
+        const CommMonitor *monitor;
+
+    };
+
+    /**
+     * Log-linear histogram of latencies in a fixed array, with eight
+     * buckets per power of two, to estimate percentiles within 12.5%.
+     */
+    class LatencySketch
+    {
+      public:
+        void sample(Tick latency);
+
+        /**
+         * Estimate a percentile of the samples.
+         *
+         * @param fraction Fraction of the samples below the percentile
+         * @return The middle of the bucket of the percentile, 0 without
+         *         samples
+         */
+        Tick percentile(double fraction) const;
+
+        void reset();
+
+      private:
+        /** Log2 of the number of buckets per power of two */
+        static constexpr int subBits = 3;
+        static constexpr size_t numBuckets = (64 - subBits + 1) << subBits;
+
+        static size_t bucket(Tick latency);
+        /** Smallest latency of a bucket */
+        static Tick bucketStart(size_t idx);
+
+        std::array<uint64_t, numBuckets> buckets{};
+        uint64_t samples = 0;
     };
 
     /**
@@ -302,9 +352,18 @@ class CommMonitor : public SimObject
         statistics::Scalar totalWrittenBytes;
         statistics::Formula averageWriteBandwidth;
 
+        /** Low overhead mode, see the class description */
+        const bool lowOverhead;
+
         /** Disable flag for latency histograms. */
         bool disableLatencyHists;
 
+        /**
+         * Whether the latency is measured, to the histograms or to the
+         * sketches of the low overhead mode
+         */
+        bool measureLatency;
+
         /** Histogram of read request-to-response latencies */
         statistics::Histogram readLatencyHist;
 
@@ -378,6 +437,28 @@ class CommMonitor : public SimObject
          */
         statistics::SparseHistogram writeAddrDist;
 
+        /**
+         * Sampled read and write latencies in the low overhead mode,
+         * and the percentiles estimated from them when the stats are
+         * dumped.
+         */
+        LatencySketch readLatencySketch;
+        LatencySketch writeLatencySketch;
+        statistics::Vector readLatencyPercentiles;
+        statistics::Vector writeLatencyPercentiles;
+
+        /**
+         * Read and write bandwidth of the last sample periods in the low
+         * overhead mode, in a ring indexed by the number of periods, and
+         * the stats they are copied to, oldest first, when the stats are
+         * dumped.
+         */
+        std::vector<double> readWindows;
+        std::vector<double> writeWindows;
+        uint64_t numWindows;
+        statistics::Vector readWindowBandwidth;
+        statistics::Vector writeWindowBandwidth;
+
         /**
          * Create the monitor stats and initialise all the members
          * that are not statistics themselves, but used to control the
@@ -389,9 +470,30 @@ class CommMonitor : public SimObject
         void updateReqStats(const probing::PacketInfo& pkt, bool is_atomic,
                             bool expects_response);
         void updateRespStats(const probing::PacketInfo& pkt, Tick latency,
-                             bool is_atomic);
+                             bool is_atomic, bool sampled);
+
+        /** Record the bandwidth of a sample period of the given length */
+        void sampleWindow(double period);
+
+        void preDumpStats() override;
+        void resetStats() override;
     };
 
+    /**
+     * Decide whether to measure the latency of a request, which is the
+     * case for one in latencySampleRate requests.
+     */
+    bool
+    sampleLatency()
+    {
+        if (!stats.measureLatency)
+            return false;
+        if (++latencyCount < latencySampleRate)
+            return false;
+        latencyCount = 0;
+        return true;
+    }
+
     /** This function is called periodically at the end of each time bin */
     void samplePeriodic();
 
@@ -408,8 +510,14 @@ class CommMonitor : public SimObject
     /** Sample period in seconds */
     const double samplePeriod;
 
+    /** Measure the latency of one in this many requests */
+    const unsigned latencySampleRate;
+
     /** @} */
 
+    /** Requests since the last one with a measured latency */
+    unsigned latencyCount;
+
     /** Instantiate stats */
     MonitorStats stats;
 
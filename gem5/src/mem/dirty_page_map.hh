@@ -0,0 +1,125 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_DIRTY_PAGE_MAP_HH__
+#define __MEM_DIRTY_PAGE_MAP_HH__
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+
+namespace gem5
+{
+
+namespace memory
+{
+
+/**
+ * A bitmap of the pages of a backing store written to since it was last
+ * cleared, so that an incremental checkpoint only has to write those.
+ * The memories mark the pages they write with their host address. The
+ * bits are set atomically, as the memories of a system may be accessed
+ * from the threads of several event queues.
+ */
+class DirtyPageMap
+{
+  private:
+    const uint8_t *base;
+    const uint64_t size;
+    const unsigned pageShift;
+    const uint64_t pages;
+
+    std::unique_ptr<std::atomic<uint64_t>[]> words;
+
+    uint64_t numWords() const { return divCeil(pages, 64); }
+
+  public:
+    /**
+     * @param _base Host address of the backing store.
+     * @param _size Size of the backing store.
+     * @param page_bytes Size of a page, a power of two.
+     */
+    DirtyPageMap(const uint8_t *_base, uint64_t _size, unsigned page_bytes)
+        : base(_base), size(_size), pageShift(floorLog2(page_bytes)),
+          pages(divCeil(_size, page_bytes)),
+          words(new std::atomic<uint64_t>[divCeil(pages, 64)]())
+    {
+        assert(isPowerOf2(page_bytes));
+    }
+
+    /** Mark the pages a write to host memory touches. */
+    void
+    mark(const uint8_t *host, uint64_t bytes)
+    {
+        if (bytes == 0)
+            return;
+        assert(host >= base && host + bytes <= base + size);
+        uint64_t first = (host - base) >> pageShift;
+        uint64_t last = (host - base + bytes - 1) >> pageShift;
+        for (uint64_t page = first; page <= last; page++) {
+            std::atomic<uint64_t> &word = words[page / 64];
+            const uint64_t bit = 1ULL << (page % 64);
+            // most writes go to pages that are already dirty
+            if (!(word.load(std::memory_order_relaxed) & bit))
+                word.fetch_or(bit, std::memory_order_relaxed);
+        }
+    }
+
+    bool
+    isDirty(uint64_t page) const
+    {
+        assert(page < pages);
+        return words[page / 64].load(std::memory_order_relaxed) &
+            (1ULL << (page % 64));
+    }
+
+    /** Number of dirty pages. */
+    uint64_t
+    count() const
+    {
+        uint64_t dirty = 0;
+        for (uint64_t i = 0; i < numWords(); i++)
+            dirty += popCount(words[i].load(std::memory_order_relaxed));
+        return dirty;
+    }
+
+    void
+    clear()
+    {
+        for (uint64_t i = 0; i < numWords(); i++)
+            words[i].store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t numPages() const { return pages; }
+};
+
+} // namespace memory
+} // namespace gem5
+
+#endif // __MEM_DIRTY_PAGE_MAP_HH__
@@ -0,0 +1,89 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "mem/dirty_page_map.hh"
+
+using namespace gem5;
+using namespace gem5::memory;
+
+TEST(DirtyPageMapTest, StartsClean)
+{
+    std::vector<uint8_t> store(10 * 4096);
+    DirtyPageMap map(store.data(), store.size(), 4096);
+    EXPECT_EQ(map.numPages(), 10);
+    EXPECT_EQ(map.count(), 0);
+    for (uint64_t page = 0; page < map.numPages(); page++)
+        EXPECT_FALSE(map.isDirty(page));
+}
+
+TEST(DirtyPageMapTest, MarksTouchedPages)
+{
+    std::vector<uint8_t> store(10 * 4096);
+    DirtyPageMap map(store.data(), store.size(), 4096);
+
+    map.mark(store.data() + 4096 + 100, 8);
+    EXPECT_TRUE(map.isDirty(1));
+    EXPECT_EQ(map.count(), 1);
+
+    // a write straddling pages 4 and 5
+    map.mark(store.data() + 5 * 4096 - 4, 8);
+    EXPECT_TRUE(map.isDirty(4));
+    EXPECT_TRUE(map.isDirty(5));
+    EXPECT_EQ(map.count(), 3);
+
+    // marking a dirty page again changes nothing
+    map.mark(store.data() + 4096, 4096);
+    EXPECT_EQ(map.count(), 3);
+
+    map.mark(store.data(), 0);
+    EXPECT_FALSE(map.isDirty(0));
+}
+
+TEST(DirtyPageMapTest, PartialLastPage)
+{
+    std::vector<uint8_t> store(64 * 4096 + 100);
+    DirtyPageMap map(store.data(), store.size(), 4096);
+    EXPECT_EQ(map.numPages(), 65);
+
+    map.mark(store.data() + store.size() - 1, 1);
+    EXPECT_TRUE(map.isDirty(64));
+    EXPECT_FALSE(map.isDirty(63));
+}
+
+TEST(DirtyPageMapTest, Clear)
+{
+    std::vector<uint8_t> store(200 * 4096);
+    DirtyPageMap map(store.data(), store.size(), 4096);
+    map.mark(store.data(), store.size());
+    EXPECT_EQ(map.count(), 200);
+
+    map.clear();
+    EXPECT_EQ(map.count(), 0);
+    EXPECT_FALSE(map.isDirty(199));
+}
@@ -0,0 +1,621 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/dram_cache_ctrl.hh"
+
+#include "base/cast.hh"
+#include "base/intmath.hh"
+#include "base/trace.hh"
+#include "debug/DRAMCache.hh"
+#include "sim/system.hh"
+
+namespace gem5
+{
+
+namespace memory
+{
+
+DRAMCacheCtrl::DRAMCacheCtrl(const DRAMCacheCtrlParams &p)
+    : ClockedObject(p),
+      cpuSidePort(name() + ".port", *this),
+      cacheSidePort(name() + ".cache_side", *this, true),
+      memSidePort(name() + ".mem_side", *this, false),
+      requestorId(p.system->getRequestorId(this)),
+      blockSize(p.block_size), tagSize(p.tag_size),
+      numEntries(p.size / p.block_size), latency(p.latency),
+      predictMisses(p.miss_predictor),
+      maxTransactions(p.max_transactions),
+      entries(numEntries),
+      predictorTable(p.predictor_entries, SatCounter8(3)),
+      stats(*this)
+{
+    fatal_if(!isPowerOf2(blockSize),
+             "%s: the block size must be a power of 2.", name());
+    fatal_if(p.size % blockSize || numEntries == 0,
+             "%s: the size must be a multiple of the block size.", name());
+    fatal_if(predictMisses && predictorTable.empty(),
+             "%s: the miss predictor needs at least an entry.", name());
+    fatal_if(maxTransactions == 0,
+             "%s: at least a transaction must be allowed.", name());
+}
+
+DRAMCacheCtrl::~DRAMCacheCtrl()
+{
+}
+
+void
+DRAMCacheCtrl::init()
+{
+    fatal_if(!cpuSidePort.isConnected() || !cacheSidePort.isConnected() ||
+             !memSidePort.isConnected(),
+             "%s is not connected on all its ports.", name());
+
+    // The stacked DRAM must hold every TAD, from address 0
+    const Addr footprint = numEntries * (blockSize + tagSize);
+    bool fits = false;
+    for (const auto &range : cacheSidePort.getAddrRanges())
+        fits |= range.start() == 0 && range.size() >= footprint;
+    fatal_if(!fits, "%s: the cache side memory must cover [0, %#x) to hold "
+             "the %d blocks and their tags.", name(), footprint, numEntries);
+
+    cpuSidePort.sendRangeChange();
+}
+
+Port &
+DRAMCacheCtrl::getPort(const std::string &if_name, PortID idx)
+{
+    if (if_name == "port") {
+        return cpuSidePort;
+    } else if (if_name == "cache_side") {
+        return cacheSidePort;
+    } else if (if_name == "mem_side") {
+        return memSidePort;
+    } else {
+        return ClockedObject::getPort(if_name, idx);
+    }
+}
+
+DrainState
+DRAMCacheCtrl::drain()
+{
+    return numTransactions ? DrainState::Draining : DrainState::Drained;
+}
+
+DRAMCacheCtrl::Entry &
+DRAMCacheCtrl::entry(Addr block_addr)
+{
+    return entries[(block_addr / blockSize) % numEntries];
+}
+
+Addr
+DRAMCacheCtrl::tag(Addr block_addr) const
+{
+    return block_addr / blockSize / numEntries;
+}
+
+Addr
+DRAMCacheCtrl::entryAddr(Addr block_addr) const
+{
+    return (block_addr / blockSize) % numEntries * (blockSize + tagSize);
+}
+
+SatCounter8 &
+DRAMCacheCtrl::predictor(PacketPtr pkt)
+{
+    // The requests of the LLC carry the PC of the access that missed
+    // when there is one, otherwise fall back on the requestor
+    Addr key = pkt->req->hasPC() ? pkt->req->getPC() :
+        pkt->req->requestorId();
+    return predictorTable[(key ^ (key >> 12)) % predictorTable.size()];
+}
+
+void
+DRAMCacheCtrl::accessData(PacketPtr pkt)
+{
+    RequestPtr req = std::make_shared<Request>(
+        pkt->getAddr(), pkt->getSize(), 0, requestorId);
+    Packet mem_pkt(req, pkt->isRead() ? MemCmd::ReadReq : MemCmd::WriteReq);
+    mem_pkt.dataStatic(pkt->getPtr<uint8_t>());
+
+    // The writebacks waiting to be sent carry the data of their blocks
+    // as it was when they were created, bring them up to date
+    if (pkt->isWrite())
+        memSidePort.trySatisfyFunctional(&mem_pkt);
+    memSidePort.sendFunctional(&mem_pkt);
+}
+
+bool
+DRAMCacheCtrl::lookup(PacketPtr pkt, Addr &writeback_addr)
+{
+    const Addr block_addr = blockAlign(pkt->getAddr());
+    Entry &e = entry(block_addr);
+
+    writeback_addr = MaxAddr;
+    if (e.valid && e.tag == tag(block_addr)) {
+        e.dirty |= pkt->isWrite();
+        return true;
+    }
+
+    if (e.valid && e.dirty) {
+        writeback_addr = (e.tag * numEntries +
+                          (block_addr / blockSize) % numEntries) * blockSize;
+    }
+    e.tag = tag(block_addr);
+    e.valid = true;
+    e.dirty = pkt->isWrite();
+    return false;
+}
+
+PacketPtr
+DRAMCacheCtrl::createPacket(MemCmd cmd, Addr addr, unsigned size)
+{
+    RequestPtr req = std::make_shared<Request>(addr, size, 0, requestorId);
+    PacketPtr pkt = new Packet(req, cmd);
+    pkt->allocate();
+    return pkt;
+}
+
+PacketPtr
+DRAMCacheCtrl::createWriteback(Addr block_addr)
+{
+    PacketPtr pkt = createPacket(MemCmd::WriteReq, block_addr, blockSize);
+
+    // Writing back the data of the off-chip memory leaves it unchanged,
+    // only the timing of the writeback matters
+    Packet read(pkt->req, MemCmd::ReadReq);
+    read.dataStatic(pkt->getPtr<uint8_t>());
+    memSidePort.sendFunctional(&read);
+
+    stats.dirtyWritebacks++;
+    return pkt;
+}
+
+Tick
+DRAMCacheCtrl::recvAtomic(PacketPtr pkt)
+{
+    panic_if(pkt->cacheResponding(), "Should not see packets where cache "
+             "is responding");
+
+    const Addr block_addr = blockAlign(pkt->getAddr());
+    const Addr offset = pkt->getAddr() - block_addr;
+    const bool whole_block = pkt->getSize() == blockSize;
+    Tick lat = clockPeriod() * latency;
+
+    accessData(pkt);
+
+    PacketPtr lookup_pkt = createPacket(MemCmd::ReadReq,
+        entryAddr(block_addr) + offset, pkt->getSize() + tagSize);
+    lat += cacheSidePort.sendAtomic(lookup_pkt);
+    delete lookup_pkt;
+
+    Addr writeback_addr;
+    const bool hit = lookup(pkt, writeback_addr);
+    if (writeback_addr != MaxAddr) {
+        PacketPtr writeback = createWriteback(writeback_addr);
+        memSidePort.sendAtomic(writeback);
+        delete writeback;
+    }
+
+    if (pkt->isRead())
+        hit ? stats.readHits++ : stats.readMisses++;
+    else
+        hit ? stats.writeHits++ : stats.writeMisses++;
+
+    // Only the fetch of a read miss delays the response
+    if (!hit && (pkt->isRead() || !whole_block)) {
+        PacketPtr fetch = createPacket(MemCmd::ReadReq, block_addr,
+                                       blockSize);
+        Tick fetch_lat = memSidePort.sendAtomic(fetch);
+        if (pkt->isRead())
+            lat += fetch_lat;
+        delete fetch;
+    }
+
+    if (!hit || pkt->isWrite()) {
+        PacketPtr fill = hit ?
+            createPacket(MemCmd::WriteReq, entryAddr(block_addr) + offset,
+                         pkt->getSize() + tagSize) :
+            createPacket(MemCmd::WriteReq, entryAddr(block_addr),
+                         blockSize + tagSize);
+        cacheSidePort.sendAtomic(fill);
+        delete fill;
+    }
+
+    if (pkt->needsResponse())
+        pkt->makeResponse();
+    return lat;
+}
+
+void
+DRAMCacheCtrl::recvFunctional(PacketPtr pkt)
+{
+    // The off-chip memory always has the data, which the writebacks
+    // waiting to be sent must follow
+    if (pkt->isWrite())
+        memSidePort.trySatisfyFunctional(pkt);
+    memSidePort.sendFunctional(pkt);
+}
+
+bool
+DRAMCacheCtrl::recvTimingReq(PacketPtr pkt)
+{
+    panic_if(pkt->cacheResponding(), "Should not see packets where cache "
+             "is responding");
+    panic_if(!(pkt->isRead() || pkt->isWrite()),
+             "Should only see reads and writes at a DRAM cache\n");
+    panic_if(blockAlign(pkt->getAddr()) !=
+             blockAlign(pkt->getAddr() + pkt->getSize() - 1),
+             "%s crosses a block of the DRAM cache.", pkt->print());
+
+    if (numTransactions == maxTransactions) {
+        DPRINTF(DRAMCache, "Too many transactions, retry %s\n",
+                pkt->print());
+        retryReq = true;
+        return false;
+    }
+    numTransactions++;
+
+    DPRINTF(DRAMCache, "recvTimingReq: %s\n", pkt->print());
+
+    stats.bytesRequested += pkt->getSize();
+
+    // The data is accessed as the request arrives, so that it is
+    // ordered with the other requests, and only the response waits for
+    // the timing of the cache
+    accessData(pkt);
+
+    Transaction *trans = new Transaction;
+    trans->pkt = pkt;
+    trans->entryTime = curTick();
+    trans->blockAddr = blockAlign(pkt->getAddr());
+    trans->predictedMiss = predictMisses && pkt->isRead() &&
+        predictor(pkt).calcSaturation() >= 0.5;
+
+    sendLookup(trans);
+
+    // Do not wait for the tag of a predicted miss to read the block
+    if (trans->predictedMiss) {
+        stats.predictedMisses++;
+        sendFetch(trans);
+    }
+
+    return true;
+}
+
+void
+DRAMCacheCtrl::sendLookup(Transaction *trans)
+{
+    const Addr offset = trans->pkt->getAddr() - trans->blockAddr;
+    const unsigned size = trans->pkt->getSize() + tagSize;
+
+    PacketPtr pkt = createPacket(MemCmd::ReadReq,
+                                 entryAddr(trans->blockAddr) + offset, size);
+    pkt->pushSenderState(new TransactionState(trans));
+    trans->pending++;
+
+    stats.bytesCache += size;
+    cacheSidePort.schedTimingReq(pkt, clockEdge(latency));
+}
+
+void
+DRAMCacheCtrl::sendFetch(Transaction *trans)
+{
+    PacketPtr pkt = createPacket(MemCmd::ReadReq, trans->blockAddr,
+                                 blockSize);
+    pkt->pushSenderState(new TransactionState(trans));
+    trans->pending++;
+    trans->fetching = true;
+
+    stats.bytesMem += blockSize;
+    memSidePort.schedTimingReq(pkt, clockEdge(latency));
+}
+
+void
+DRAMCacheCtrl::sendFill(Addr block_addr, Addr offset, unsigned size)
+{
+    PacketPtr pkt = createPacket(MemCmd::WriteReq,
+                                 entryAddr(block_addr) + offset,
+                                 size + tagSize);
+
+    stats.bytesCache += size + tagSize;
+    cacheSidePort.schedTimingReq(pkt, clockEdge(latency));
+}
+
+void
+DRAMCacheCtrl::recvCacheResp(PacketPtr pkt)
+{
+    // Only the lookups are waited for, not the fills
+    if (pkt->isRead()) {
+        auto *state = safe_cast<TransactionState *>(pkt->popSenderState());
+        Transaction *trans = state->trans;
+        delete state;
+        handleLookup(trans);
+    }
+    delete pkt;
+}
+
+void
+DRAMCacheCtrl::recvMemResp(PacketPtr pkt)
+{
+    // Only the fetches are waited for, not the writebacks
+    if (pkt->isRead()) {
+        auto *state = safe_cast<TransactionState *>(pkt->popSenderState());
+        Transaction *trans = state->trans;
+        delete state;
+        handleFetch(trans);
+    }
+    delete pkt;
+}
+
+void
+DRAMCacheCtrl::handleLookup(Transaction *trans)
+{
+    PacketPtr pkt = trans->pkt;
+    const Addr offset = pkt->getAddr() - trans->blockAddr;
+
+    trans->pending--;
+    trans->lookedUp = true;
+
+    Addr writeback_addr;
+    trans->hit = lookup(pkt, writeback_addr);
+
+    DPRINTF(DRAMCache, "Lookup of %s: %s\n", pkt->print(),
+            trans->hit ? "hit" : "miss");
+
+    if (writeback_addr != MaxAddr) {
+        stats.bytesMem += blockSize;
+        memSidePort.schedTimingReq(createWriteback(writeback_addr),
+                                   clockEdge(latency));
+    }
+
+    if (pkt->isRead()) {
+        if (predictMisses) {
+            SatCounter8 &counter = predictor(pkt);
+            if (trans->hit) {
+                counter--;
+                if (trans->predictedMiss)
+                    stats.mispredictedHits++;
+            } else {
+                counter++;
+                if (!trans->predictedMiss)
+                    stats.mispredictedMisses++;
+            }
+        }
+
+        if (trans->hit) {
+            stats.readHits++;
+            respond(trans);
+        } else {
+            stats.readMisses++;
+            if (trans->fetched) {
+                sendFill(trans->blockAddr, 0, blockSize);
+                respond(trans);
+            } else if (!trans->fetching) {
+                sendFetch(trans);
+            }
+        }
+    } else {
+        // Writes are posted, the rest of the block of a partial write
+        // miss being fetched afterwards
+        if (trans->hit) {
+            stats.writeHits++;
+            sendFill(trans->blockAddr, offset, pkt->getSize());
+        } else {
+            stats.writeMisses++;
+            if (pkt->getSize() == blockSize)
+                sendFill(trans->blockAddr, 0, blockSize);
+            else
+                sendFetch(trans);
+        }
+        respond(trans);
+    }
+
+    tryRelease(trans);
+}
+
+void
+DRAMCacheCtrl::handleFetch(Transaction *trans)
+{
+    trans->pending--;
+    trans->fetching = false;
+    trans->fetched = true;
+
+    // A fetch that arrives before its lookup waits for it, and the one
+    // of a hit is simply dropped
+    if (trans->lookedUp && !trans->hit) {
+        sendFill(trans->blockAddr, 0, blockSize);
+        if (!trans->responded)
+            respond(trans);
+    }
+
+    tryRelease(trans);
+}
+
+void
+DRAMCacheCtrl::respond(Transaction *trans)
+{
+    PacketPtr pkt = trans->pkt;
+    const Tick when = clockEdge(latency);
+
+    trans->responded = true;
+
+    if (pkt->isRead()) {
+        if (trans->hit)
+            stats.readHitLatency.sample(when - trans->entryTime);
+        else
+            stats.readMissLatency.sample(when - trans->entryTime);
+    }
+
+    if (pkt->needsResponse()) {
+        pkt->makeResponse();
+        pkt->headerDelay = pkt->payloadDelay = 0;
+        cpuSidePort.schedTimingResp(pkt, when);
+    } else {
+        pendingDelete.reset(pkt);
+    }
+}
+
+void
+DRAMCacheCtrl::tryRelease(Transaction *trans)
+{
+    if (!trans->responded || trans->pending)
+        return;
+
+    delete trans;
+    numTransactions--;
+
+    if (retryReq) {
+        retryReq = false;
+        cpuSidePort.sendRetryReq();
+    }
+
+    if (numTransactions == 0 && drainState() == DrainState::Draining)
+        signalDrainDone();
+}
+
+DRAMCacheCtrl::CPUSidePort::CPUSidePort(const std::string &name,
+                                        DRAMCacheCtrl &_ctrl)
+    : QueuedResponsePort(name, &_ctrl, queue), queue(_ctrl, *this, true),
+      ctrl(_ctrl)
+{
+}
+
+Tick
+DRAMCacheCtrl::CPUSidePort::recvAtomic(PacketPtr pkt)
+{
+    return ctrl.recvAtomic(pkt);
+}
+
+void
+DRAMCacheCtrl::CPUSidePort::recvFunctional(PacketPtr pkt)
+{
+    pkt->pushLabel(ctrl.name());
+    ctrl.recvFunctional(pkt);
+    pkt->popLabel();
+}
+
+bool
+DRAMCacheCtrl::CPUSidePort::recvTimingReq(PacketPtr pkt)
+{
+    return ctrl.recvTimingReq(pkt);
+}
+
+AddrRangeList
+DRAMCacheCtrl::CPUSidePort::getAddrRanges() const
+{
+    return ctrl.memSidePort.getAddrRanges();
+}
+
+DRAMCacheCtrl::MemSidePort::MemSidePort(const std::string &name,
+                                        DRAMCacheCtrl &_ctrl, bool is_cache)
+    : QueuedRequestPort(name, &_ctrl, reqQueue, snoopRespQueue),
+      reqQueue(_ctrl, *this), snoopRespQueue(_ctrl, *this), ctrl(_ctrl),
+      isCache(is_cache)
+{
+}
+
+bool
+DRAMCacheCtrl::MemSidePort::recvTimingResp(PacketPtr pkt)
+{
+    if (isCache)
+        ctrl.recvCacheResp(pkt);
+    else
+        ctrl.recvMemResp(pkt);
+    return true;
+}
+
+void
+DRAMCacheCtrl::MemSidePort::recvRangeChange()
+{
+    if (!isCache)
+        ctrl.cpuSidePort.sendRangeChange();
+}
+
+DRAMCacheCtrl::DRAMCacheStats::DRAMCacheStats(DRAMCacheCtrl &ctrl)
+    : statistics::Group(&ctrl),
+
+    ADD_STAT(readHits, statistics::units::Count::get(),
+             "Number of read requests that hit"),
+    ADD_STAT(readMisses, statistics::units::Count::get(),
+             "Number of read requests that miss"),
+    ADD_STAT(writeHits, statistics::units::Count::get(),
+             "Number of write requests that hit"),
+    ADD_STAT(writeMisses, statistics::units::Count::get(),
+             "Number of write requests that miss"),
+    ADD_STAT(dirtyWritebacks, statistics::units::Count::get(),
+             "Number of dirty blocks written back to the off-chip memory"),
+
+    ADD_STAT(predictedMisses, statistics::units::Count::get(),
+             "Number of reads fetched in parallel with their lookup"),
+    ADD_STAT(mispredictedHits, statistics::units::Count::get(),
+             "Number of predicted misses that hit"),
+    ADD_STAT(mispredictedMisses, statistics::units::Count::get(),
+             "Number of predicted hits that miss"),
+
+    ADD_STAT(readHitLatency, statistics::units::Tick::get(),
+             "Distribution of the latency of the read hits"),
+    ADD_STAT(readMissLatency, statistics::units::Tick::get(),
+             "Distribution of the latency of the read misses"),
+
+    ADD_STAT(bytesRequested, statistics::units::Byte::get(),
+             "Number of bytes read or written by the requests"),
+    ADD_STAT(bytesCache, statistics::units::Byte::get(),
+             "Number of bytes moved to or from the stacked DRAM"),
+    ADD_STAT(bytesMem, statistics::units::Byte::get(),
+             "Number of bytes moved to or from the off-chip memory"),
+
+    ADD_STAT(hitRate, statistics::units::Ratio::get(),
+             "Fraction of the requests that hit"),
+    ADD_STAT(predictorAccuracy, statistics::units::Ratio::get(),
+             "Fraction of the reads whose hit or miss was predicted"),
+    ADD_STAT(bandwidthBloat, statistics::units::Ratio::get(),
+             "Bytes moved to or from the stacked and off-chip DRAM per "
+             "byte requested")
+{
+}
+
+void
+DRAMCacheCtrl::DRAMCacheStats::regStats()
+{
+    using namespace statistics;
+
+    statistics::Group::regStats();
+
+    readHitLatency
+        .init(1ULL << 36, 2)
+        .flags(nozero);
+    readMissLatency
+        .init(1ULL << 36, 2)
+        .flags(nozero);
+
+    hitRate = (readHits + writeHits) /
+        (readHits + readMisses + writeHits + writeMisses);
+    predictorAccuracy = 1 - (mispredictedHits + mispredictedMisses) /
+        (readHits + readMisses);
+    bandwidthBloat = (bytesCache + bytesMem) / bytesRequested;
+}
+
+} // namespace memory
+} // namespace gem5
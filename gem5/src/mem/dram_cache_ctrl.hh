@@ -0,0 +1,246 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * DRAMCacheCtrl declaration
+ */
+
+#ifndef __MEM_DRAM_CACHE_CTRL_HH__
+#define __MEM_DRAM_CACHE_CTRL_HH__
+
+#include <memory>
+#include <vector>
+
+#include "base/sat_counter.hh"
+#include "base/statistics.hh"
+#include "mem/qport.hh"
+#include "params/DRAMCacheCtrl.hh"
+#include "sim/clocked_object.hh"
+
+namespace gem5
+{
+
+namespace memory
+{
+
+/**
+ * The controller of a die-stacked DRAM cache in front of the off-chip
+ * memory, in the style of the Alloy and Unison caches.
+ *
+ * The cache is direct mapped, and each block is stored in the stacked
+ * DRAM together with its tag (TAD), so a lookup is a single access to
+ * the stacked DRAM that returns both. The granularity of the blocks is
+ * configurable, from a line as in the Alloy cache to a page as in the
+ * Unison cache, a miss fetching the whole block from the off-chip
+ * memory.
+ *
+ * The stacked DRAM is any memory controller behind the cache side port,
+ * typically a MemCtrl with a DRAMInterface holding no data, which is
+ * accessed with the addresses of the TADs. The data of every block is
+ * kept up to date in the off-chip memory, functionally, and only the
+ * timing of the accesses depends on where it is cached.
+ *
+ * A MAP-I style predictor of the misses, indexed by the PC of the
+ * request, sends the off-chip read of a predicted miss in parallel with
+ * the lookup rather than after it.
+ */
+class DRAMCacheCtrl : public ClockedObject
+{
+  public:
+    DRAMCacheCtrl(const DRAMCacheCtrlParams &p);
+    ~DRAMCacheCtrl();
+
+    void init() override;
+
+    Port &getPort(const std::string &if_name,
+                  PortID idx=InvalidPortID) override;
+
+    DrainState drain() override;
+
+  private:
+    /** A request from the CPU side, until it is done with. */
+    struct Transaction
+    {
+        PacketPtr pkt;
+        Tick entryTime;
+        Addr blockAddr;
+        bool predictedMiss;
+
+        bool lookedUp = false;
+        bool hit = false;
+        bool fetching = false;
+        bool fetched = false;
+        bool responded = false;
+
+        /** Lookups and fetches in flight */
+        int pending = 0;
+    };
+
+    /** Tells which transaction a lookup or a fetch is for. */
+    struct TransactionState : public Packet::SenderState
+    {
+        Transaction *trans;
+        TransactionState(Transaction *t) : trans(t) {}
+    };
+
+    /** A block of the cache, whose data lives in the stacked DRAM */
+    struct Entry
+    {
+        Addr tag = 0;
+        bool valid = false;
+        bool dirty = false;
+    };
+
+    class CPUSidePort : public QueuedResponsePort
+    {
+      public:
+        CPUSidePort(const std::string &name, DRAMCacheCtrl &ctrl);
+
+      protected:
+        Tick recvAtomic(PacketPtr pkt) override;
+        void recvFunctional(PacketPtr pkt) override;
+        bool recvTimingReq(PacketPtr pkt) override;
+        AddrRangeList getAddrRanges() const override;
+
+      private:
+        RespPacketQueue queue;
+        DRAMCacheCtrl &ctrl;
+    };
+
+    class MemSidePort : public QueuedRequestPort
+    {
+      public:
+        MemSidePort(const std::string &name, DRAMCacheCtrl &ctrl,
+                    bool is_cache);
+
+      protected:
+        bool recvTimingResp(PacketPtr pkt) override;
+        void recvRangeChange() override;
+
+      private:
+        ReqPacketQueue reqQueue;
+        SnoopRespPacketQueue snoopRespQueue;
+        DRAMCacheCtrl &ctrl;
+        const bool isCache;
+    };
+
+    Tick recvAtomic(PacketPtr pkt);
+    void recvFunctional(PacketPtr pkt);
+    bool recvTimingReq(PacketPtr pkt);
+    void recvCacheResp(PacketPtr pkt);
+    void recvMemResp(PacketPtr pkt);
+
+    Addr blockAlign(Addr addr) const { return addr & ~(blockSize - 1); }
+    Entry &entry(Addr block_addr);
+    Addr tag(Addr block_addr) const;
+    Addr entryAddr(Addr block_addr) const;
+
+    /** Predict whether a request misses, from its PC */
+    SatCounter8 &predictor(PacketPtr pkt);
+
+    /**
+     * Do the access of a request from the CPU side on the data in the
+     * off-chip memory.
+     */
+    void accessData(PacketPtr pkt);
+
+    /**
+     * Look the block of a request up, replacing the block in its entry
+     * on a miss.
+     *
+     * @return Whether the request hits, and sets the block to write
+     *         back if the replaced one was dirty.
+     */
+    bool lookup(PacketPtr pkt, Addr &writeback_addr);
+
+    PacketPtr createPacket(MemCmd cmd, Addr addr, unsigned size);
+    PacketPtr createWriteback(Addr block_addr);
+
+    void sendLookup(Transaction *trans);
+    void sendFetch(Transaction *trans);
+    void sendFill(Addr block_addr, Addr offset, unsigned size);
+
+    void handleLookup(Transaction *trans);
+    void handleFetch(Transaction *trans);
+    void respond(Transaction *trans);
+    void tryRelease(Transaction *trans);
+
+    CPUSidePort cpuSidePort;
+    MemSidePort cacheSidePort;
+    MemSidePort memSidePort;
+
+    const RequestorID requestorId;
+
+    const Addr blockSize;
+    const unsigned tagSize;
+    const Addr numEntries;
+    const Cycles latency;
+    const bool predictMisses;
+    const unsigned maxTransactions;
+
+    std::vector<Entry> entries;
+    std::vector<SatCounter8> predictorTable;
+
+    /** Requests accepted and not released yet */
+    unsigned numTransactions = 0;
+    bool retryReq = false;
+
+    /** Upstream caches do not delete the writebacks they send */
+    std::unique_ptr<Packet> pendingDelete;
+
+    struct DRAMCacheStats : public statistics::Group
+    {
+        DRAMCacheStats(DRAMCacheCtrl &ctrl);
+
+        void regStats() override;
+
+        statistics::Scalar readHits;
+        statistics::Scalar readMisses;
+        statistics::Scalar writeHits;
+        statistics::Scalar writeMisses;
+        statistics::Scalar dirtyWritebacks;
+
+        statistics::Scalar predictedMisses;
+        statistics::Scalar mispredictedHits;
+        statistics::Scalar mispredictedMisses;
+
+        statistics::LogHistogram readHitLatency;
+        statistics::LogHistogram readMissLatency;
+
+        statistics::Scalar bytesRequested;
+        statistics::Scalar bytesCache;
+        statistics::Scalar bytesMem;
+
+        statistics::Formula hitRate;
+        statistics::Formula predictorAccuracy;
+        statistics::Formula bandwidthBloat;
+    } stats;
+};
+
+} // namespace memory
+} // namespace gem5
+
+#endif // __MEM_DRAM_CACHE_CTRL_HH__
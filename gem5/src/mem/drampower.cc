@@ -83,6 +83,7 @@ DRAMPower::getTimingParams(const DRAMInterfaceParams &p)
     timingSpec.RL = divCeil(p.tCL, p.tCK);
     timingSpec.RP = divCeil(p.tRP, p.tCK);
     timingSpec.RFC = divCeil(p.tRFC, p.tCK);
+    timingSpec.REFB = divCeil(p.tRFCpb, p.tCK);
     timingSpec.RAS = divCeil(p.tRAS, p.tCK);
     // Write latency is read latency - 1 cycle
     // Source: B.Jacob Memory Systems Cache, DRAM, Disk
@@ -40,12 +40,16 @@
 
 #include "mem/mem_ctrl.hh"
 
+#include <algorithm>
+#include <tuple>
+
 #include "base/trace.hh"
 #include "debug/DRAM.hh"
 #include "debug/Drain.hh"
 #include "debug/MemCtrl.hh"
 #include "debug/NVM.hh"
 #include "debug/QOS.hh"
+#include "mem/cache/compressors/base.hh"
 #include "mem/mem_interface.hh"
 #include "sim/system.hh"
 
@@ -55,6 +59,107 @@ namespace gem5
 namespace memory
 {
 
+const MemPacketQueue::Entry *
+MemPacketQueue::BankQueue::oldestTo(uint32_t row) const
+{
+    auto it = rows.find(row);
+    return it == rows.end() ? nullptr : &it->second.front();
+}
+
+const MemPacketQueue::Entry *
+MemPacketQueue::BankQueue::oldestNotTo(uint32_t row) const
+{
+    // the heads are ordered by age, so at most the first one is to
+    // the excluded row
+    for (const auto &head : heads) {
+        if (head.second != row)
+            return &rows.at(head.second).front();
+    }
+    return nullptr;
+}
+
+void
+MemPacketQueue::push_back(MemPacket *pkt)
+{
+    const uint64_t seq = nextSeq++;
+    packets.push_back(pkt);
+    seqs.push_back(seq);
+
+    if (!pkt->isDram())
+        return;
+
+    if (pkt->bankId >= banks.size())
+        banks.resize(pkt->bankId + 1);
+    BankQueue &bank = banks[pkt->bankId];
+    auto &row = bank.rows[pkt->row];
+    if (row.empty())
+        bank.heads.emplace(seq, pkt->row);
+    row.push_back({seq, pkt});
+}
+
+MemPacketQueue::iterator
+MemPacketQueue::erase(iterator it)
+{
+    const auto pos = it - packets.begin();
+    const uint64_t seq = seqs[pos];
+    MemPacket *pkt = *it;
+    seqs.erase(seqs.begin() + pos);
+
+    if (pkt->isDram()) {
+        BankQueue &bank = banks[pkt->bankId];
+        auto row_it = bank.rows.find(pkt->row);
+        assert(row_it != bank.rows.end());
+        auto &row = row_it->second;
+        // packets usually leave in order within a row
+        auto entry = row.begin();
+        while (entry->seq != seq)
+            ++entry;
+        if (entry == row.begin()) {
+            bank.heads.erase({seq, pkt->row});
+            row.pop_front();
+            if (row.empty())
+                bank.rows.erase(row_it);
+            else
+                bank.heads.emplace(row.front().seq, pkt->row);
+        } else {
+            row.erase(entry);
+        }
+    }
+
+    return packets.erase(it);
+}
+
+MemPacketQueue::iterator
+MemPacketQueue::find(const Entry &entry)
+{
+    // packets are only ever appended, so the queue is sorted by age
+    auto seq_it = std::lower_bound(seqs.begin(), seqs.end(), entry.seq);
+    assert(seq_it != seqs.end() && *seq_it == entry.seq);
+    auto it = packets.begin() + (seq_it - seqs.begin());
+    assert(*it == entry.pkt);
+    return it;
+}
+
+bool
+MemPacketQueue::hasRowHit(const MemPacket *pkt) const
+{
+    if (pkt->bankId >= banks.size())
+        return false;
+    const auto &rows = banks[pkt->bankId].rows;
+    auto it = rows.find(pkt->row);
+    if (it == rows.end())
+        return false;
+    return it->second.size() > 1 || it->second.front().pkt != pkt;
+}
+
+bool
+MemPacketQueue::hasBankConflict(const MemPacket *pkt) const
+{
+    if (pkt->bankId >= banks.size())
+        return false;
+    return banks[pkt->bankId].oldestNotTo(pkt->row) != nullptr;
+}
+
 MemCtrl::MemCtrl(const MemCtrlParams &p) :
     qos::MemCtrl(p),
     port(name() + ".port", *this), isTimingMode(false),
@@ -69,14 +174,25 @@ MemCtrl::MemCtrl(const MemCtrlParams &p) :
     writeHighThreshold(writeBufferSize * p.write_high_thresh_perc / 100.0),
     writeLowThreshold(writeBufferSize * p.write_low_thresh_perc / 100.0),
     minWritesPerSwitch(p.min_writes_per_switch),
+    coalesceReads(p.coalesce_reads), writeCombining(p.write_combining),
+    linkCompressor(p.link_compressor),
+    tierRequestorId(Request::invldRequestorId), tierChunk(0),
+    tierPromoting(false),
     writesThisTime(0), readsThisTime(0),
     memSchedPolicy(p.mem_sched_policy),
+    batchCap(p.batch_cap), blacklistThreshold(p.blacklist_threshold),
+    blacklistClearInterval(p.blacklist_clear_interval),
+    atlasQuantum(p.atlas_quantum), atlasAlpha(p.atlas_alpha),
+    atlasStarvationThreshold(p.atlas_starvation_threshold),
+    lastServedRequestor(Request::invldRequestorId), servedStreak(0),
+    nextBlacklistClear(p.blacklist_clear_interval),
+    nextQuantumAt(p.atlas_quantum),
     frontendLatency(p.static_frontend_latency),
     backendLatency(p.static_backend_latency),
     commandWindow(p.command_window),
     nextBurstAt(0), prevArrival(0),
     nextReqTime(0),
-    stats(*this)
+    stats(*this), totalBytesAccepted(0)
 {
     DPRINTF(MemCtrl, "Setting up controller\n");
     readQueue.resize(p.qos_priorities);
@@ -95,6 +211,41 @@ MemCtrl::MemCtrl(const MemCtrlParams &p) :
         fatal("Write buffer low threshold %d must be smaller than the "
               "high threshold %d\n", p.write_low_thresh_perc,
               p.write_high_thresh_perc);
+
+    fatal_if(memSchedPolicy == enums::parbs && batchCap == 0,
+             "PAR-BS batch cap must be non-zero\n");
+    fatal_if(memSchedPolicy == enums::bliss &&
+             (blacklistThreshold == 0 || blacklistClearInterval == 0),
+             "BLISS blacklist threshold and clearing interval must be "
+             "non-zero\n");
+    fatal_if(memSchedPolicy == enums::atlas &&
+             (atlasQuantum == 0 || atlasAlpha < 0 || atlasAlpha >= 1),
+             "ATLAS quantum must be non-zero and alpha in [0, 1)\n");
+
+    if (p.tier_cache_size) {
+        fatal_if(!dram || !nvm, "Tiering needs both a DRAM and an NVM "
+                 "interface\n");
+        const AddrRange &dram_range = dram->getAddrRange();
+        fatal_if(dram_range.interleaved(), "Tiering needs a DRAM range that "
+                 "is not interleaved\n");
+        fatal_if(p.tier_cache_size > dram_range.size(), "Tiering cache "
+                 "region is larger than the DRAM\n");
+        tierChunk = std::max(dram->bytesPerBurst(), nvm->bytesPerBurst());
+        fatal_if(p.tier_page_size < tierChunk,
+                 "Tiering page size is smaller than a burst\n");
+        tierMap = std::make_unique<TierMap>(nvm->getAddrRange(),
+            dram_range.end() - p.tier_cache_size, p.tier_cache_size,
+            p.tier_page_size, p.tier_hot_threshold, p.tier_sample_interval,
+            p.tier_max_tracked);
+        tierRequestorId = system()->getRequestorId(this, "tiering");
+        const unsigned int chunk_bursts =
+            std::max(tierBursts(dram_range.start()),
+                     tierBursts(nvm->getAddrRange().start()));
+        fatal_if(chunk_bursts > readBufferSize / 2 ||
+                 chunk_bursts > writeBufferSize / 2,
+                 "Tiering needs read and write buffers of at least twice "
+                 "the bursts of a %d byte chunk\n", tierChunk);
+    }
 }
 
 void
@@ -194,7 +345,8 @@ MemCtrl::writeQueueFull(unsigned int neededEntries) const
 }
 
 void
-MemCtrl::addToReadQueue(PacketPtr pkt, unsigned int pkt_count, bool is_dram)
+MemCtrl::addToReadQueue(PacketPtr pkt, unsigned int pkt_count, bool is_dram,
+                        Addr media_addr)
 {
     // only add to the read queue here. whenever the request is
     // eventually done, set the readyTime, and call schedule()
@@ -208,7 +360,7 @@ MemCtrl::addToReadQueue(PacketPtr pkt, unsigned int pkt_count, bool is_dram)
     // address of first packet is kept unaliged. Subsequent packets
     // are aligned to burst size boundaries. This is to ensure we accurately
     // check read packets against packets in write queue.
-    const Addr base_addr = pkt->getAddr();
+    const Addr base_addr = media_addr;
     Addr addr = base_addr;
     unsigned pktsServicedByWrQ = 0;
     BurstHelper* burst_helper = NULL;
@@ -226,9 +378,25 @@ MemCtrl::addToReadQueue(PacketPtr pkt, unsigned int pkt_count, bool is_dram)
         // the controller
         bool foundInWrQ = false;
         Addr burst_addr = burstAlign(addr, is_dram);
+        auto wr_burst = isInWriteQueue.find(burst_addr);
         // if the burst address is not present then there is no need
         // looking any further
-        if (isInWriteQueue.find(burst_addr) != isInWriteQueue.end()) {
+        if (wr_burst != isInWriteQueue.end() && writeCombining) {
+            // the merged writes must have written every byte read
+            const auto& mask = wr_burst->second;
+            const Addr offset = addr - burst_addr;
+            foundInWrQ = std::all_of(mask.begin() + offset,
+                                     mask.begin() + offset + size,
+                                     [](bool b) { return b; });
+            if (foundInWrQ) {
+                stats.servicedByWrQ++;
+                pktsServicedByWrQ++;
+                DPRINTF(MemCtrl,
+                        "Read to addr %#x with size %d serviced by "
+                        "write combining\n", addr, size);
+                stats.bytesReadWrQ += burst_size;
+            }
+        } else if (wr_burst != isInWriteQueue.end()) {
             for (const auto& vec : writeQueue) {
                 for (const auto& p : vec) {
                     // check if the read is subsumed in the write queue
@@ -261,11 +429,28 @@ MemCtrl::addToReadQueue(PacketPtr pkt, unsigned int pkt_count, bool is_dram)
                 burst_helper = new BurstHelper(pkt_count);
             }
 
+            auto host = coalesceReads && is_dram ?
+                pendingReadBursts.find(burst_addr) : pendingReadBursts.end();
+
             MemPacket* mem_pkt;
-            if (is_dram) {
+            if (host != pendingReadBursts.end()) {
+                // piggyback on the read to the same burst that is
+                // already queued, it carries the data for both
+                mem_pkt = dram->decodePacket(pkt, addr, size, true, true);
+                mem_pkt->burstHelper = burst_helper;
+                host->second->coalesced.push_back(mem_pkt);
+                stats.coalescedRdBursts++;
+                DPRINTF(MemCtrl, "Read to addr %#x coalesced with queued "
+                        "burst\n", addr);
+                addr = (addr | (burst_size - 1)) + 1;
+                continue;
+            } else if (is_dram) {
                 mem_pkt = dram->decodePacket(pkt, addr, size, true, true);
+                mem_pkt->transferSize = linkTransferSize(pkt, size);
                 // increment read entries of the rank
                 dram->setupRank(mem_pkt->rank, true);
+                if (coalesceReads)
+                    pendingReadBursts.emplace(burst_addr, mem_pkt);
             } else {
                 mem_pkt = nvm->decodePacket(pkt, addr, size, true, false);
                 // Increment count to trigger issue of non-deterministic read
@@ -312,8 +497,42 @@ MemCtrl::addToReadQueue(PacketPtr pkt, unsigned int pkt_count, bool is_dram)
     }
 }
 
+unsigned int
+MemCtrl::linkTransferSize(PacketPtr pkt, unsigned int size) const
+{
+    if (!linkCompressor || pkt->getSize() != linkCompressor->getBlockSize())
+        return size;
+
+    unsigned int line_size = pkt->compressedSize;
+    if (line_size == 0) {
+        const uint64_t* line = nullptr;
+        // with tiering, the line may live in the NVM
+        const MemInterface* owner =
+            dram->getAddrRange().contains(pkt->getAddr()) ?
+            static_cast<MemInterface*>(dram) : nvm;
+        if (pkt->isWrite()) {
+            line = pkt->getConstPtr<uint64_t>();
+        } else if (!owner->isNull()) {
+            line = reinterpret_cast<const uint64_t*>(
+                owner->toHostAddr(pkt->getAddr()));
+        }
+        if (!line)
+            return size;
+
+        Cycles comp_lat, decomp_lat;
+        line_size = linkCompressor->compress(line, comp_lat,
+                                             decomp_lat)->getSize();
+    }
+
+    // a line split over bursts is compressed evenly across them, and
+    // every burst moves at least some data
+    return std::max(1U, std::min(size,
+        divCeil(size * line_size, pkt->getSize())));
+}
+
 void
-MemCtrl::addToWriteQueue(PacketPtr pkt, unsigned int pkt_count, bool is_dram)
+MemCtrl::addToWriteQueue(PacketPtr pkt, unsigned int pkt_count, bool is_dram,
+                         Addr media_addr)
 {
     // only add to the write queue here. whenever the request is
     // eventually done, set the readyTime, and call schedule()
@@ -321,7 +540,7 @@ MemCtrl::addToWriteQueue(PacketPtr pkt, unsigned int pkt_count, bool is_dram)
 
     // if the request size is larger than burst size, the pkt is split into
     // multiple packets
-    const Addr base_addr = pkt->getAddr();
+    const Addr base_addr = media_addr;
     Addr addr = base_addr;
     uint32_t burst_size = is_dram ? dram->bytesPerBurst() :
                                     nvm->bytesPerBurst();
@@ -334,8 +553,20 @@ MemCtrl::addToWriteQueue(PacketPtr pkt, unsigned int pkt_count, bool is_dram)
 
         // see if we can merge with an existing item in the write
         // queue and keep track of whether we have merged or not
-        bool merged = isInWriteQueue.find(burstAlign(addr, is_dram)) !=
-            isInWriteQueue.end();
+        const Addr burst_addr = burstAlign(addr, is_dram);
+        auto wr_burst = isInWriteQueue.find(burst_addr);
+        bool merged = wr_burst != isInWriteQueue.end();
+
+        // record the bytes written, so that reads covered by several
+        // partial writes can still be serviced by the write queue
+        if (writeCombining) {
+            if (!merged) {
+                wr_burst = isInWriteQueue.emplace(burst_addr,
+                    std::vector<bool>(burst_size, false)).first;
+            }
+            std::fill_n(wr_burst->second.begin() + (addr - burst_addr),
+                        size, true);
+        }
 
         // if the item was not merged we need to create a new write
         // and enqueue it
@@ -343,6 +574,7 @@ MemCtrl::addToWriteQueue(PacketPtr pkt, unsigned int pkt_count, bool is_dram)
             MemPacket* mem_pkt;
             if (is_dram) {
                 mem_pkt = dram->decodePacket(pkt, addr, size, false, true);
+                mem_pkt->transferSize = linkTransferSize(pkt, size);
                 dram->setupRank(mem_pkt->rank, false);
             } else {
                 mem_pkt = nvm->decodePacket(pkt, addr, size, false, false);
@@ -354,7 +586,7 @@ MemCtrl::addToWriteQueue(PacketPtr pkt, unsigned int pkt_count, bool is_dram)
             DPRINTF(MemCtrl, "Adding to write queue\n");
 
             writeQueue[mem_pkt->qosValue()].push_back(mem_pkt);
-            isInWriteQueue.insert(burstAlign(addr, is_dram));
+            isInWriteQueue.emplace(burst_addr, std::vector<bool>());
 
             // log packet
             logRequest(MemCtrl::WRITE, pkt->requestorId(), pkt->qosValue(),
@@ -437,11 +669,17 @@ MemCtrl::recvTimingReq(PacketPtr pkt)
     }
     prevArrival = curTick();
 
+    // Where is this packet accessed, which with tiering is in the DRAM
+    // for the NVM pages that were migrated there?
+    const Addr addr = pkt->getAddr();
+    const bool is_write = pkt->isWrite();
+    const Addr media_addr = tierMap ? tierMap->translate(addr) : addr;
+
     // What type of media does this packet access?
     bool is_dram;
-    if (dram && dram->getAddrRange().contains(pkt->getAddr())) {
+    if (dram && dram->getAddrRange().contains(media_addr)) {
         is_dram = true;
-    } else if (nvm && nvm->getAddrRange().contains(pkt->getAddr())) {
+    } else if (nvm && nvm->getAddrRange().contains(media_addr)) {
         is_dram = false;
     } else {
         panic("Can't handle address range for packet %s\n",
@@ -456,7 +694,7 @@ MemCtrl::recvTimingReq(PacketPtr pkt)
     unsigned size = pkt->getSize();
     uint32_t burst_size = is_dram ? dram->bytesPerBurst() :
                                     nvm->bytesPerBurst();
-    unsigned offset = pkt->getAddr() & (burst_size - 1);
+    unsigned offset = media_addr & (burst_size - 1);
     unsigned int pkt_count = divCeil(offset + size, burst_size);
 
     // run the QoS scheduler and assign a QoS priority value to the packet
@@ -472,9 +710,10 @@ MemCtrl::recvTimingReq(PacketPtr pkt)
             stats.numWrRetry++;
             return false;
         } else {
-            addToWriteQueue(pkt, pkt_count, is_dram);
+            addToWriteQueue(pkt, pkt_count, is_dram, media_addr);
             stats.writeReqs++;
             stats.bytesWrittenSys += size;
+            totalBytesAccepted += size;
         }
     } else {
         assert(pkt->isRead());
@@ -486,15 +725,144 @@ MemCtrl::recvTimingReq(PacketPtr pkt)
             stats.numRdRetry++;
             return false;
         } else {
-            addToReadQueue(pkt, pkt_count, is_dram);
+            addToReadQueue(pkt, pkt_count, is_dram, media_addr);
             stats.readReqs++;
             stats.bytesReadSys += size;
+            totalBytesAccepted += size;
         }
     }
 
+    if (tierMap)
+        tierRecord(addr, is_write);
+
     return true;
 }
 
+void
+MemCtrl::tierRecord(Addr addr, bool is_write)
+{
+    if (!tierMap->isSlow(addr))
+        return;
+
+    if (tierMap->isCached(addr)) {
+        stats.tierHits++;
+        if (is_write)
+            tierMap->markDirty(addr);
+    } else {
+        stats.tierMisses++;
+        if (tierMap->recordAccess(addr)) {
+            DPRINTF(MemCtrl, "Tiering: page %#x is hot\n",
+                    tierMap->pageOf(addr));
+            tierHotPages.push_back(tierMap->pageOf(addr));
+        }
+    }
+
+    tierMigrate();
+}
+
+unsigned int
+MemCtrl::tierBursts(Addr media_addr) const
+{
+    return tierChunk / (dram->getAddrRange().contains(media_addr) ?
+                        dram->bytesPerBurst() : nvm->bytesPerBurst());
+}
+
+bool
+MemCtrl::tierIdle() const
+{
+    return !tierMap || tierCopies.empty();
+}
+
+void
+MemCtrl::tierMigrate()
+{
+    // promote the next hot page once the previous one is done
+    if (!tierPromoting && !tierHotPages.empty() &&
+        drainState() == DrainState::Running) {
+        const Addr page = tierHotPages.front();
+        tierHotPages.pop_front();
+
+        const TierMap::Promotion promo = tierMap->allocate(page);
+        DPRINTF(MemCtrl, "Tiering: promoting page %#x to %#x\n", page,
+                promo.slot);
+        if (promo.evicted) {
+            stats.tierEvictions++;
+            if (promo.victimDirty) {
+                DPRINTF(MemCtrl, "Tiering: writing back page %#x\n",
+                        promo.victim);
+                stats.tierWritebacks++;
+                tierCopies.push_back({promo.slot, promo.victim, false});
+            }
+        }
+
+        tierPromoting = true;
+        tierCopies.push_back({page, promo.slot, true});
+    }
+
+    const unsigned int chunks = tierMap->pageSize() / tierChunk;
+    for (auto it = tierCopies.begin(); it != tierCopies.end(); ) {
+        tierIssue(it);
+        if (it->writesIssued == chunks)
+            it = tierCopies.erase(it);
+        else
+            ++it;
+    }
+}
+
+void
+MemCtrl::tierIssue(std::list<TierCopy>::iterator copy)
+{
+    const unsigned int chunks = tierMap->pageSize() / tierChunk;
+
+    // the copies only use half of the queues, leaving the rest to the
+    // requests of the system
+    const unsigned int rd_bursts = tierBursts(copy->src);
+    while (copy->readsIssued < chunks &&
+           !readQueueFull(rd_bursts + readBufferSize / 2)) {
+        const Addr addr = copy->src + copy->readsIssued++ * tierChunk;
+        RequestPtr req = std::make_shared<Request>(addr, tierChunk, 0,
+                                                   tierRequestorId);
+        PacketPtr pkt = new Packet(req, MemCmd::ReadReq);
+
+        stats.tierBytesRead += tierChunk;
+        tierReads.emplace(pkt, copy);
+        addToReadQueue(pkt, rd_bursts,
+                       dram->getAddrRange().contains(addr), addr);
+    }
+
+    const unsigned int wr_bursts = tierBursts(copy->dst);
+    while (copy->writesIssued < copy->readsDone &&
+           !writeQueueFull(wr_bursts + writeBufferSize / 2)) {
+        const Addr addr = copy->dst + copy->writesIssued++ * tierChunk;
+        RequestPtr req = std::make_shared<Request>(addr, tierChunk, 0,
+                                                   tierRequestorId);
+        PacketPtr pkt = new Packet(req, MemCmd::WriteReq);
+
+        stats.tierBytesWritten += tierChunk;
+        addToWriteQueue(pkt, wr_bursts,
+                        dram->getAddrRange().contains(addr), addr);
+    }
+}
+
+void
+MemCtrl::tierReadDone(PacketPtr pkt)
+{
+    auto it = tierReads.find(pkt);
+    assert(it != tierReads.end());
+    TierCopy &copy = *it->second;
+    tierReads.erase(it);
+    delete pkt;
+
+    // once all of it is at the controller, the accesses to a promoted
+    // page can go to the DRAM
+    ++copy.readsDone;
+    if (copy.promote && copy.readsDone == tierMap->pageSize() / tierChunk) {
+        tierMap->install(copy.src, copy.dst);
+        stats.tierPromotions++;
+        tierPromoting = false;
+    }
+}
+
 void
 MemCtrl::processRespondEvent()
 {
@@ -508,26 +876,20 @@ MemCtrl::processRespondEvent()
         dram->respondEvent(mem_pkt->rank);
     }
 
-    if (mem_pkt->burstHelper) {
-        // it is a split packet
-        mem_pkt->burstHelper->burstsServiced++;
-        if (mem_pkt->burstHelper->burstsServiced ==
-            mem_pkt->burstHelper->burstCount) {
-            // we have now serviced all children packets of a system packet
-            // so we can now respond to the requestor
-            // @todo we probably want to have a different front end and back
-            // end latency for split packets
-            accessAndRespond(mem_pkt->pkt, frontendLatency + backendLatency);
-            delete mem_pkt->burstHelper;
-            mem_pkt->burstHelper = NULL;
-        }
-    } else {
-        // it is not a split packet
-        accessAndRespond(mem_pkt->pkt, frontendLatency + backendLatency);
+    respondBurst(mem_pkt);
+
+    // reads coalesced with this burst are complete as well
+    for (auto coalesced_pkt : mem_pkt->coalesced) {
+        respondBurst(coalesced_pkt);
+        delete coalesced_pkt;
     }
 
     respQueue.pop_front();
 
+    // page copies can use the room that was made
+    if (tierMap)
+        tierMigrate();
+
     if (!respQueue.empty()) {
         assert(respQueue.front()->readyTime >= curTick());
         assert(!respondEvent.scheduled());
@@ -536,7 +898,7 @@ MemCtrl::processRespondEvent()
         // if there is nothing left in any queue, signal a drain
         if (drainState() == DrainState::Draining &&
             !totalWriteQueueSize && !totalReadQueueSize &&
-            allIntfDrained()) {
+            allIntfDrained() && tierIdle()) {
 
             DPRINTF(Drain, "Controller done draining\n");
             signalDrainDone();
@@ -558,6 +920,28 @@ MemCtrl::processRespondEvent()
     }
 }
 
+void
+MemCtrl::respondBurst(MemPacket* mem_pkt)
+{
+    if (mem_pkt->burstHelper) {
+        // it is a split packet
+        mem_pkt->burstHelper->burstsServiced++;
+        if (mem_pkt->burstHelper->burstsServiced ==
+            mem_pkt->burstHelper->burstCount) {
+            // we have now serviced all children packets of a system packet
+            // so we can now respond to the requestor
+            // @todo we probably want to have a different front end and back
+            // end latency for split packets
+            accessAndRespond(mem_pkt->pkt, frontendLatency + backendLatency);
+            delete mem_pkt->burstHelper;
+            mem_pkt->burstHelper = NULL;
+        }
+    } else {
+        // it is not a split packet
+        accessAndRespond(mem_pkt->pkt, frontendLatency + backendLatency);
+    }
+}
+
 MemPacketQueue::iterator
 MemCtrl::chooseNext(MemPacketQueue& queue, Tick extra_col_delay)
 {
@@ -586,6 +970,10 @@ MemCtrl::chooseNext(MemPacketQueue& queue, Tick extra_col_delay)
             }
         } else if (memSchedPolicy == enums::frfcfs) {
             ret = chooseNextFRFCFS(queue, extra_col_delay);
+        } else if (memSchedPolicy == enums::parbs ||
+                   memSchedPolicy == enums::bliss ||
+                   memSchedPolicy == enums::atlas) {
+            ret = chooseNextAppAware(queue);
         } else {
             panic("No scheduling policy chosen\n");
         }
@@ -635,11 +1023,165 @@ MemCtrl::chooseNextFRFCFS(MemPacketQueue& queue, Tick extra_col_delay)
     return selected_pkt_it;
 }
 
+MemPacketQueue::iterator
+MemCtrl::chooseNextAppAware(MemPacketQueue& queue)
+{
+    updateServiceEpochs();
+
+    if (memSchedPolicy == enums::parbs) {
+        bool batch_pending = false;
+        for (const auto mem_pkt : queue) {
+            if (mem_pkt->marked) {
+                batch_pending = true;
+                break;
+            }
+        }
+        if (!batch_pending)
+            formBatch(queue);
+    }
+
+    // Lexicographic priority, smaller is better: policy class
+    // (unmarked, blacklisted or not starving), least attained
+    // service, row miss and batch rank. Ties go to the oldest packet
+    // as the queue is in arrival order.
+    using Key = std::tuple<bool, double, bool, uint32_t>;
+    auto key = [this](const MemPacket* mem_pkt) -> Key {
+        const bool miss = !(mem_pkt->isDram() ? dram->rowHit(mem_pkt) :
+                                                nvm->rowHit(mem_pkt));
+        const RequestorID id = mem_pkt->requestorId();
+        switch (memSchedPolicy) {
+          case enums::parbs:
+            return Key(!mem_pkt->marked, 0, miss, mem_pkt->batchRank);
+          case enums::bliss:
+            return Key(blacklist.count(id) != 0, 0, miss, 0);
+          case enums::atlas: {
+            const bool starving = curTick() - mem_pkt->entryTime >
+                atlasStarvationThreshold;
+            auto total = totalAttainedService.find(id);
+            return Key(!starving, total == totalAttainedService.end() ?
+                       0 : total->second, miss, 0);
+          }
+          default:
+            panic("Policy is not application aware\n");
+        }
+    };
+
+    auto selected_pkt_it = queue.end();
+    Key selected_key;
+    for (auto i = queue.begin(); i != queue.end(); ++i) {
+        MemPacket* mem_pkt = *i;
+        if (!packetReady(mem_pkt))
+            continue;
+        const Key k = key(mem_pkt);
+        if (selected_pkt_it == queue.end() || k < selected_key) {
+            selected_pkt_it = i;
+            selected_key = k;
+        }
+    }
+
+    if (selected_pkt_it == queue.end()) {
+        DPRINTF(MemCtrl, "%s no available packets found\n", __func__);
+    }
+
+    return selected_pkt_it;
+}
+
+void
+MemCtrl::formBatch(MemPacketQueue& queue)
+{
+    // requests marked per requestor and bank, and per requestor the
+    // largest per-bank and the total number marked
+    std::unordered_map<RequestorID,
+                       std::unordered_map<uint16_t, uint32_t>> bank_load;
+    std::unordered_map<RequestorID, std::pair<uint32_t, uint32_t>> load;
+
+    for (auto mem_pkt : queue) {
+        const RequestorID id = mem_pkt->requestorId();
+        uint32_t &marked = bank_load[id][mem_pkt->bankId];
+        if (marked < batchCap) {
+            mem_pkt->marked = true;
+            ++marked;
+            auto &l = load[id];
+            l.first = std::max(l.first, marked);
+            ++l.second;
+        }
+    }
+
+    // shortest job first, the requestor with the lightest maximum
+    // bank load goes first, with the total load as a tie breaker
+    std::vector<std::pair<std::pair<uint32_t, uint32_t>, RequestorID>>
+        order;
+    for (const auto &l : load)
+        order.emplace_back(l.second, l.first);
+    std::sort(order.begin(), order.end());
+
+    std::unordered_map<RequestorID, uint32_t> rank;
+    for (uint32_t r = 0; r < order.size(); ++r)
+        rank[order[r].second] = r;
+
+    for (auto mem_pkt : queue) {
+        if (mem_pkt->marked)
+            mem_pkt->batchRank = rank[mem_pkt->requestorId()];
+    }
+
+    DPRINTF(MemCtrl, "Formed PAR-BS batch over %d requestors\n",
+            order.size());
+    ++stats.batchesFormed;
+}
+
+void
+MemCtrl::recordService(const MemPacket* mem_pkt)
+{
+    const RequestorID id = mem_pkt->requestorId();
+
+    if (memSchedPolicy == enums::bliss) {
+        if (id == lastServedRequestor) {
+            ++servedStreak;
+        } else {
+            lastServedRequestor = id;
+            servedStreak = 1;
+        }
+        if (servedStreak >= blacklistThreshold &&
+            blacklist.insert(id).second) {
+            DPRINTF(MemCtrl, "Blacklisting requestor %d\n", id);
+            stats.requestorBlacklisted[id]++;
+        }
+    } else if (memSchedPolicy == enums::atlas) {
+        attainedService[id] += 1;
+    }
+}
+
+void
+MemCtrl::updateServiceEpochs()
+{
+    if (memSchedPolicy == enums::bliss && curTick() >= nextBlacklistClear) {
+        blacklist.clear();
+        nextBlacklistClear = curTick() + blacklistClearInterval;
+    } else if (memSchedPolicy == enums::atlas && curTick() >= nextQuantumAt) {
+        for (auto &total : totalAttainedService)
+            total.second *= atlasAlpha;
+        for (const auto &as : attainedService)
+            totalAttainedService[as.first] += (1 - atlasAlpha) * as.second;
+        attainedService.clear();
+        nextQuantumAt = curTick() + atlasQuantum;
+    }
+}
+
 void
 MemCtrl::accessAndRespond(PacketPtr pkt, Tick static_latency)
 {
     DPRINTF(MemCtrl, "Responding to Address %#x.. \n", pkt->getAddr());
 
+    // page copies for tiering only model the timing, the data stays
+    // where it is
+    if (tierMap && pkt->requestorId() == tierRequestorId) {
+        if (pkt->isRead())
+            tierReadDone(pkt);
+        else
+            pendingDelete.reset(pkt);
+        return;
+    }
+
     bool needsResponse = pkt->needsResponse();
     // do the actual memory access which also turns the packet into a
     // response
@@ -823,6 +1365,10 @@ MemCtrl::doBurstAccess(MemPacket* mem_pkt)
     // When was command issued?
     Tick cmd_at;
 
+    if (memSchedPolicy == enums::parbs || memSchedPolicy == enums::bliss ||
+        memSchedPolicy == enums::atlas)
+        recordService(mem_pkt);
+
     // Issue the next burst and update bus state to reflect
     // when previous command was issued
     if (mem_pkt->isDram()) {
@@ -861,18 +1407,27 @@ MemCtrl::doBurstAccess(MemPacket* mem_pkt)
         // Update latency stats
         stats.requestorReadTotalLat[mem_pkt->requestorId()] +=
             mem_pkt->readyTime - mem_pkt->entryTime;
+        stats.readLatencyHist.sample(mem_pkt->readyTime - mem_pkt->entryTime);
         stats.requestorReadBytes[mem_pkt->requestorId()] += mem_pkt->size;
+        stats.requestorReadUnloadedLat[mem_pkt->requestorId()] +=
+            mem_pkt->isDram() ? dram->accessLatency() : nvm->accessLatency();
     } else {
         ++writesThisTime;
         stats.requestorWriteBytes[mem_pkt->requestorId()] += mem_pkt->size;
         stats.requestorWriteTotalLat[mem_pkt->requestorId()] +=
             mem_pkt->readyTime - mem_pkt->entryTime;
+        stats.writeLatencyHist.sample(
+            mem_pkt->readyTime - mem_pkt->entryTime);
     }
 }
 
 void
 MemCtrl::processNextReqEvent()
 {
+    // page copies may have been waiting for room in the queues
+    if (tierMap)
+        tierMigrate();
+
     // transition is handled by QoS algorithm if enabled
     if (turnPolicy) {
         // select bus state - only done if QoS algorithms are in use
@@ -963,7 +1518,7 @@ MemCtrl::processNextReqEvent()
                 // ensuring all banks are closed and
                 // have exited low power states
                 if (drainState() == DrainState::Draining &&
-                    respQueue.empty() && allIntfDrained()) {
+                    respQueue.empty() && allIntfDrained() && tierIdle()) {
 
                     DPRINTF(Drain, "MemCtrl controller done draining\n");
                     signalDrainDone();
@@ -1050,6 +1605,15 @@ MemCtrl::processNextReqEvent()
             // remove the request from the queue
             // the iterator is no longer valid .
             readQueue[mem_pkt->qosValue()].erase(to_read);
+
+            // the burst has issued, later reads to it are queued anew
+            if (coalesceReads && mem_pkt->isDram()) {
+                auto host = pendingReadBursts.find(
+                    burstAlign(mem_pkt->addr, true));
+                if (host != pendingReadBursts.end() &&
+                    host->second == mem_pkt)
+                    pendingReadBursts.erase(host);
+            }
         }
 
         // switching to writes, either because the read queue is empty
@@ -1207,6 +1771,8 @@ MemCtrl::CtrlStats::CtrlStats(MemCtrl &_ctrl)
              "Number of controller read bursts serviced by the write queue"),
     ADD_STAT(mergedWrBursts, statistics::units::Count::get(),
              "Number of controller write bursts merged with an existing one"),
+    ADD_STAT(coalescedRdBursts, statistics::units::Count::get(),
+             "Number of controller read bursts coalesced with a queued one"),
 
     ADD_STAT(neitherReadNorWriteReqs, statistics::units::Count::get(),
              "Number of requests that are neither read nor write"),
@@ -1237,6 +1803,10 @@ MemCtrl::CtrlStats::CtrlStats(MemCtrl &_ctrl)
              "Reads before turning the bus around for writes"),
     ADD_STAT(wrPerTurnAround, statistics::units::Count::get(),
              "Writes before turning the bus around for reads"),
+    ADD_STAT(readLatencyHist, statistics::units::Tick::get(),
+             "Distribution of the latency of the reads"),
+    ADD_STAT(writeLatencyHist, statistics::units::Tick::get(),
+             "Distribution of the latency of the writes"),
 
     ADD_STAT(bytesReadWrQ, statistics::units::Byte::get(),
              "Total number of bytes read from write queue"),
@@ -1280,7 +1850,31 @@ MemCtrl::CtrlStats::CtrlStats(MemCtrl &_ctrl)
              "Per-requestor read average memory access latency"),
     ADD_STAT(requestorWriteAvgLat, statistics::units::Rate<
                 statistics::units::Tick, statistics::units::Count>::get(),
-             "Per-requestor write average memory access latency")
+             "Per-requestor write average memory access latency"),
+    ADD_STAT(requestorReadUnloadedLat, statistics::units::Tick::get(),
+             "Per-requestor read latency of the same accesses without "
+             "contention"),
+    ADD_STAT(requestorReadSlowdown, statistics::units::Ratio::get(),
+             "Per-requestor read slowdown relative to unloaded accesses"),
+    ADD_STAT(requestorBlacklisted, statistics::units::Count::get(),
+             "Per-requestor number of times blacklisted by BLISS"),
+    ADD_STAT(batchesFormed, statistics::units::Count::get(),
+             "Number of PAR-BS batches formed"),
+
+    ADD_STAT(tierHits, statistics::units::Count::get(),
+             "Number of NVM requests served by pages migrated to the DRAM"),
+    ADD_STAT(tierMisses, statistics::units::Count::get(),
+             "Number of NVM requests served by the NVM"),
+    ADD_STAT(tierPromotions, statistics::units::Count::get(),
+             "Number of NVM pages migrated to the DRAM"),
+    ADD_STAT(tierEvictions, statistics::units::Count::get(),
+             "Number of migrated pages evicted from the DRAM"),
+    ADD_STAT(tierWritebacks, statistics::units::Count::get(),
+             "Number of evicted pages written back to the NVM"),
+    ADD_STAT(tierBytesRead, statistics::units::Byte::get(),
+             "Number of bytes read to migrate pages"),
+    ADD_STAT(tierBytesWritten, statistics::units::Byte::get(),
+             "Number of bytes written to migrate pages")
 {
 }
 
@@ -1308,6 +1902,13 @@ MemCtrl::CtrlStats::regStats()
         .init(ctrl.writeBufferSize)
         .flags(nozero);
 
+    readLatencyHist
+        .init(1ULL << 36, 2)
+        .flags(nozero);
+    writeLatencyHist
+        .init(1ULL << 36, 2)
+        .flags(nozero);
+
     avgRdBWSys.precision(8);
     avgWrBWSys.precision(8);
     avgGap.precision(2);
@@ -1354,6 +1955,18 @@ MemCtrl::CtrlStats::regStats()
         .flags(nonan)
         .precision(2);
 
+    requestorReadUnloadedLat
+        .init(max_requestors)
+        .flags(nozero | nonan);
+
+    requestorReadSlowdown
+        .flags(nonan)
+        .precision(2);
+
+    requestorBlacklisted
+        .init(max_requestors)
+        .flags(nozero);
+
     for (int i = 0; i < max_requestors; i++) {
         const std::string requestor = ctrl.system()->getRequestorName(i);
         requestorReadBytes.subname(i, requestor);
@@ -1366,6 +1979,9 @@ MemCtrl::CtrlStats::regStats()
         requestorReadAvgLat.subname(i, requestor);
         requestorWriteTotalLat.subname(i, requestor);
         requestorWriteAvgLat.subname(i, requestor);
+        requestorReadUnloadedLat.subname(i, requestor);
+        requestorReadSlowdown.subname(i, requestor);
+        requestorBlacklisted.subname(i, requestor);
     }
 
     // Formula stats
@@ -1378,6 +1994,7 @@ MemCtrl::CtrlStats::regStats()
     requestorWriteRate = requestorWriteBytes / simSeconds;
     requestorReadAvgLat = requestorReadTotalLat / requestorReadAccesses;
     requestorWriteAvgLat = requestorWriteTotalLat / requestorWriteAccesses;
+    requestorReadSlowdown = requestorReadTotalLat / requestorReadUnloadedLat;
 }
 
 void
@@ -1416,13 +2033,46 @@ MemCtrl::allIntfDrained() const
    return (dram_drained && nvm_drained);
 }
 
+double
+MemCtrl::peakBandwidth() const
+{
+    double bandwidth = 0;
+    if (dram)
+        bandwidth += dram->peakBandwidth();
+    if (nvm)
+        bandwidth += nvm->peakBandwidth();
+    return bandwidth;
+}
+
+bool
+MemCtrl::servesAddr(Addr addr) const
+{
+    return (dram && dram->getAddrRange().contains(addr)) ||
+           (nvm && nvm->getAddrRange().contains(addr));
+}
+
+bool
+MemCtrl::writebackWelcome(Addr addr) const
+{
+    if (totalReadQueueSize == 0 &&
+        totalWriteQueueSize + minWritesPerSwitch < writeLowThreshold)
+        return true;
+    return dram && dram->getAddrRange().contains(addr) &&
+           dram->rowOpen(addr);
+}
+
 DrainState
 MemCtrl::drain()
 {
+    // no new promotions start while draining, but the page copies that
+    // are under way have to complete
+    if (tierMap)
+        tierMigrate();
+
     // if there is anything in any of our internal queues, keep track
     // of that as well
     if (!(!totalWriteQueueSize && !totalReadQueueSize && respQueue.empty() &&
-          allIntfDrained())) {
+          allIntfDrained() && tierIdle())) {
 
         DPRINTF(Drain, "Memory controller not drained, write: %d, read: %d,"
                 " resp: %d\n", totalWriteQueueSize, totalReadQueueSize,
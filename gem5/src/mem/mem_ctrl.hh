@@ -46,8 +46,13 @@
 #ifndef __MEM_CTRL_HH__
 #define __MEM_CTRL_HH__
 
+#include <cassert>
 #include <deque>
+#include <list>
+#include <memory>
+#include <set>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -57,6 +62,7 @@
 #include "enums/MemSched.hh"
 #include "mem/qos/mem_ctrl.hh"
 #include "mem/qport.hh"
+#include "mem/tier_map.hh"
 #include "params/MemCtrl.hh"
 #include "sim/eventq.hh"
 
@@ -69,6 +75,16 @@ namespace memory
 class DRAMInterface;
 class NVMInterface;
 
+} // namespace memory
+
+namespace compression
+{
+class Base;
+} // namespace compression
+
+namespace memory
+{
+
 /**
  * A burst helper helps organize and manage a packet that is larger than
  * the memory burst size. A system packet that is larger than the burst size
@@ -127,6 +143,14 @@ class MemPacket
      */
     const uint16_t bankId;
 
+    /**
+     * PAR-BS batch state, set when the packet is marked as part of
+     * the batch being serviced, along with the rank of its requestor
+     * within that batch (lower is serviced first)
+     */
+    bool marked;
+    uint32_t batchRank;
+
     /**
      * The starting address of the packet.
      * This address could be unaligned to burst size boundaries. The
@@ -141,12 +165,24 @@ class MemPacket
      */
     unsigned int size;
 
+    /**
+     * The number of bytes the burst moves over the data bus, smaller
+     * than its size when the line is transferred compressed
+     */
+    unsigned int transferSize;
+
     /**
      * A pointer to the BurstHelper if this MemPacket is a split packet
      * If not a split packet (common case), this is set to NULL
      */
     BurstHelper* burstHelper;
 
+    /**
+     * Reads to the same burst that were coalesced with this one, and
+     * complete along with it
+     */
+    std::vector<MemPacket*> coalesced;
+
     /**
      * QoS value of the encapsulated packet read at queuing time
      */
@@ -205,15 +241,100 @@ class MemPacket
         : entryTime(curTick()), readyTime(curTick()), pkt(_pkt),
           _requestorId(pkt->requestorId()),
           read(is_read), dram(is_dram), rank(_rank), bank(_bank), row(_row),
-          bankId(bank_id), addr(_addr), size(_size), burstHelper(NULL),
+          bankId(bank_id), marked(false), batchRank(0), addr(_addr),
+          size(_size), transferSize(_size), burstHelper(NULL),
           _qosValue(_pkt->qosValue())
     { }
 
 };
 
-// The memory packets are store in a multiple dequeue structure,
-// based on their QoS priority
-typedef std::deque<MemPacket*> MemPacketQueue;
+/**
+ * The memory packets are stored in a multiple dequeue structure,
+ * based on their QoS priority. Each queue holds its packets in arrival
+ * order, and in addition buckets the DRAM packets per bank and per
+ * row, so that the scheduler can find the oldest row hit and the
+ * oldest row miss of each bank without scanning the whole queue.
+ */
+class MemPacketQueue
+{
+  public:
+    typedef std::deque<MemPacket*>::iterator iterator;
+    typedef std::deque<MemPacket*>::const_iterator const_iterator;
+
+    /** A queued DRAM packet and its age within the queue */
+    struct Entry
+    {
+        /** Arrival order, lower is older */
+        uint64_t seq;
+        MemPacket *pkt;
+    };
+
+    /** The queued DRAM packets to a single bank */
+    class BankQueue
+    {
+      public:
+        bool empty() const { return heads.empty(); }
+
+        /** The oldest packet to the bank */
+        const Entry &
+        oldest() const
+        {
+            assert(!empty());
+            return rows.at(heads.begin()->second).front();
+        }
+
+        /** The oldest packet to the given row, or nullptr */
+        const Entry *oldestTo(uint32_t row) const;
+
+        /** The oldest packet to any but the given row, or nullptr */
+        const Entry *oldestNotTo(uint32_t row) const;
+
+      private:
+        friend class MemPacketQueue;
+
+        /** Packets of each row, oldest first */
+        std::unordered_map<uint32_t, std::deque<Entry>> rows;
+
+        /** Age and row of the oldest packet of each row */
+        std::set<std::pair<uint64_t, uint32_t>> heads;
+    };
+
+    iterator begin() { return packets.begin(); }
+    iterator end() { return packets.end(); }
+    const_iterator begin() const { return packets.begin(); }
+    const_iterator end() const { return packets.end(); }
+
+    bool empty() const { return packets.empty(); }
+    size_t size() const { return packets.size(); }
+
+    void push_back(MemPacket *pkt);
+    iterator erase(iterator it);
+
+    /** Position of a queued DRAM packet, found through its entry */
+    iterator find(const Entry &entry);
+
+    /** Per bank view of the DRAM packets, indexed by bank id */
+    const std::vector<BankQueue> &bankQueues() const { return banks; }
+
+    /**
+     * Is there a packet other than the given one to the same bank
+     * and row?
+     */
+    bool hasRowHit(const MemPacket *pkt) const;
+
+    /** Is there a packet to the same bank but a different row? */
+    bool hasBankConflict(const MemPacket *pkt) const;
+
+  private:
+    std::deque<MemPacket*> packets;
+
+    /** Arrival order of every packet, in the same positions */
+    std::deque<uint64_t> seqs;
+
+    std::vector<BankQueue> banks;
+
+    uint64_t nextSeq = 0;
+};
 
 
 /**
@@ -328,8 +449,11 @@ class MemCtrl : public qos::MemCtrl
      * @param is_dram Does this packet access DRAM?
      * translate to. If pkt size is larger then one full burst,
      * then pkt_count is greater than one.
+     * @param media_addr Address the media is accessed at, which differs
+     * from the packet address when tiering migrated its page
      */
-    void addToReadQueue(PacketPtr pkt, unsigned int pkt_count, bool is_dram);
+    void addToReadQueue(PacketPtr pkt, unsigned int pkt_count, bool is_dram,
+                        Addr media_addr);
 
     /**
      * Decode the incoming pkt, create a mem_pkt and push to the
@@ -342,8 +466,10 @@ class MemCtrl : public qos::MemCtrl
      * @param is_dram Does this packet access DRAM?
      * translate to. If pkt size is larger then one full burst,
      * then pkt_count is greater than one.
+     * @param media_addr Address the media is accessed at
      */
-    void addToWriteQueue(PacketPtr pkt, unsigned int pkt_count, bool is_dram);
+    void addToWriteQueue(PacketPtr pkt, unsigned int pkt_count, bool is_dram,
+                         Addr media_addr);
 
     /**
      * Actually do the burst based on media specific access function.
@@ -364,6 +490,14 @@ class MemCtrl : public qos::MemCtrl
      */
     void accessAndRespond(PacketPtr pkt, Tick static_latency);
 
+    /**
+     * Complete a read burst that has reached its readyTime, and
+     * respond once all the bursts of its packet are done.
+     *
+     * @param mem_pkt The read burst
+     */
+    void respondBurst(MemPacket* mem_pkt);
+
     /**
      * Determine if there is a packet that can issue.
      *
@@ -410,6 +544,40 @@ class MemCtrl : public qos::MemCtrl
     MemPacketQueue::iterator chooseNextFRFCFS(MemPacketQueue& queue,
             Tick extra_col_delay);
 
+    /**
+     * For the application-aware policies (PAR-BS, BLISS and ATLAS)
+     * pick the ready packet with the highest requestor priority,
+     * breaking ties on row buffer hits and then on age. Unlike
+     * FR-FCFS this scans the whole queue.
+     *
+     * @param queue Queued requests to consider
+     * @return an iterator to the selected packet, else queue.end()
+     */
+    MemPacketQueue::iterator chooseNextAppAware(MemPacketQueue& queue);
+
+    /**
+     * Start a new PAR-BS batch by marking up to batchCap of the oldest
+     * requests of each requestor to each bank, and rank the requestors
+     * shortest job first on their maximum per-bank and total load.
+     *
+     * @param queue Queued requests to mark
+     */
+    void formBatch(MemPacketQueue& queue);
+
+    /**
+     * Update the per-requestor state of the application-aware
+     * policies once a burst is issued.
+     *
+     * @param mem_pkt The burst that was issued
+     */
+    void recordService(const MemPacket* mem_pkt);
+
+    /**
+     * Clear the BLISS blacklist and fold the ATLAS attained service
+     * into the long-term history when their intervals elapse.
+     */
+    void updateServiceEpochs();
+
     /**
      * Calculate burst window aligned tick
      *
@@ -445,9 +613,17 @@ class MemCtrl : public qos::MemCtrl
      * overlapping transactions, maintain a set of burst addresses
      * that are currently queued. Since we merge writes to the same
      * location we never have more than one address to the same burst
-     * address.
+     * address. With write combining, each burst also holds the mask
+     * of bytes written by the writes merged into it.
      */
-    std::unordered_set<Addr> isInWriteQueue;
+    std::unordered_map<Addr, std::vector<bool>> isInWriteQueue;
+
+    /**
+     * With read coalescing, the queued read for each burst address,
+     * which later reads to the same burst are attached to until it
+     * issues.
+     */
+    std::unordered_map<Addr, MemPacket*> pendingReadBursts;
 
     /**
      * Response queue where read packets wait after we're done working
@@ -487,6 +663,90 @@ class MemCtrl : public qos::MemCtrl
     const uint32_t writeHighThreshold;
     const uint32_t writeLowThreshold;
     const uint32_t minWritesPerSwitch;
+    const bool coalesceReads;
+    const bool writeCombining;
+
+    /**
+     * Compressor of the lines transferred over a compressed DRAM data
+     * bus, null when lines are transferred uncompressed
+     */
+    compression::Base* const linkCompressor;
+
+    /**
+     * Work out how many bytes a DRAM burst moves when the line it is part
+     * of travels compressed. Writebacks from a compressed cache carry
+     * their compressed size; other lines are compressed here, reads using
+     * the current contents of the memory.
+     *
+     * @param pkt The packet the burst belongs to
+     * @param size The number of bytes the burst covers
+     * @return The number of bytes to transfer
+     */
+    unsigned int linkTransferSize(PacketPtr pkt, unsigned int size) const;
+
+    /**
+     * Hybrid memory tiering, which caches the hot pages of the NVM in a
+     * region at the top of the DRAM, null when disabled. The pages are
+     * copied through the read and write queues like any other traffic,
+     * on behalf of a requestor of their own.
+     */
+    std::unique_ptr<TierMap> tierMap;
+    RequestorID tierRequestorId;
+
+    /**
+     * A page copied between the media, by reading and then writing it a
+     * chunk at a time
+     */
+    struct TierCopy
+    {
+        Addr src;
+        Addr dst;
+        /** Whether the page is promoted, rather than written back */
+        bool promote;
+        unsigned int readsIssued = 0;
+        unsigned int readsDone = 0;
+        unsigned int writesIssued = 0;
+    };
+
+    /** Size of the chunks, the largest burst of the two media */
+    unsigned int tierChunk;
+
+    /** The page copies under way */
+    std::list<TierCopy> tierCopies;
+
+    /** The copy each chunk read in flight belongs to */
+    std::unordered_map<PacketPtr, std::list<TierCopy>::iterator> tierReads;
+
+    /** Hot pages waiting for their promotion */
+    std::deque<Addr> tierHotPages;
+
+    /** Is a promotion in flight? They are done one at a time */
+    bool tierPromoting;
+
+    /**
+     * Count an accepted access for tiering and start promoting the hot
+     * pages.
+     */
+    void tierRecord(Addr addr, bool is_write);
+
+    /**
+     * Start the next promotion if the previous one is done, and queue the
+     * chunk reads and writes of the copies that there is room for.
+     */
+    void tierMigrate();
+
+    /** Queue the chunk reads and writes of a copy there is room for */
+    void tierIssue(std::list<TierCopy>::iterator copy);
+
+    /** A chunk read of a copy is done, so the chunk can be written */
+    void tierReadDone(PacketPtr pkt);
+
+    /** Number of bursts to copy a chunk from or to a media address */
+    unsigned int tierBursts(Addr media_addr) const;
+
+    /** Are there no page copies under way? */
+    bool tierIdle() const;
+
     uint32_t writesThisTime;
     uint32_t readsThisTime;
 
@@ -496,6 +756,31 @@ class MemCtrl : public qos::MemCtrl
      */
     enums::MemSched memSchedPolicy;
 
+    /**
+     * Parameters and state of the application-aware schedulers.
+     */
+    const uint32_t batchCap;
+    const uint32_t blacklistThreshold;
+    const Tick blacklistClearInterval;
+    const Tick atlasQuantum;
+    const double atlasAlpha;
+    const Tick atlasStarvationThreshold;
+
+    /** BLISS: requestor of the last burst and its streak length */
+    RequestorID lastServedRequestor;
+    uint32_t servedStreak;
+    std::unordered_set<RequestorID> blacklist;
+    Tick nextBlacklistClear;
+
+    /**
+     * ATLAS: bursts served per requestor in the current quantum, and
+     * the exponentially weighted service over past quanta, which is
+     * what the requestors are ranked on (least attained first)
+     */
+    std::unordered_map<RequestorID, double> attainedService;
+    std::unordered_map<RequestorID, double> totalAttainedService;
+    Tick nextQuantumAt;
+
     /**
      * Pipeline latency of the controller frontend. The frontend
      * contribution is added to writes (that complete when they are in
@@ -546,6 +831,7 @@ class MemCtrl : public qos::MemCtrl
         statistics::Scalar writeBursts;
         statistics::Scalar servicedByWrQ;
         statistics::Scalar mergedWrBursts;
+        statistics::Scalar coalescedRdBursts;
         statistics::Scalar neitherReadNorWriteReqs;
         // Average queue lengths
         statistics::Average avgRdQLen;
@@ -560,6 +846,10 @@ class MemCtrl : public qos::MemCtrl
         statistics::Histogram rdPerTurnAround;
         statistics::Histogram wrPerTurnAround;
 
+        // Distribution of the read and write access latencies
+        statistics::LogHistogram readLatencyHist;
+        statistics::LogHistogram writeLatencyHist;
+
         statistics::Scalar bytesReadWrQ;
         statistics::Scalar bytesReadSys;
         statistics::Scalar bytesWrittenSys;
@@ -589,10 +879,31 @@ class MemCtrl : public qos::MemCtrl
         // per-requestor raed and write average memory access latency
         statistics::Formula requestorReadAvgLat;
         statistics::Formula requestorWriteAvgLat;
+
+        // per-requestor unloaded read latency and the resulting
+        // slowdown estimate, relative to an uncontended access
+        statistics::Vector requestorReadUnloadedLat;
+        statistics::Formula requestorReadSlowdown;
+
+        // application-aware scheduler activity
+        statistics::Vector requestorBlacklisted;
+        statistics::Scalar batchesFormed;
+
+        // hybrid memory tiering
+        statistics::Scalar tierHits;
+        statistics::Scalar tierMisses;
+        statistics::Scalar tierPromotions;
+        statistics::Scalar tierEvictions;
+        statistics::Scalar tierWritebacks;
+        statistics::Scalar tierBytesRead;
+        statistics::Scalar tierBytesWritten;
     };
 
     CtrlStats stats;
 
+    /** Bytes of the requests accepted, see bytesAccepted() */
+    uint64_t totalBytesAccepted;
+
     /**
      * Upstream caches need this packet until true is returned, so
      * hold it for deletion until a subsequent call
@@ -619,6 +930,15 @@ class MemCtrl : public qos::MemCtrl
 
     MemCtrl(const MemCtrlParams &p);
 
+    /**
+     * Change the scheduling policy, e.g. in a simulation forked after
+     * the warmup. The queued requests are left in place.
+     */
+    void setMemSchedPolicy(enums::MemSched policy)
+    {
+        memSchedPolicy = policy;
+    }
+
     /**
      * Ensure that all interfaced have drained commands
      *
@@ -626,6 +946,34 @@ class MemCtrl : public qos::MemCtrl
      */
     bool allIntfDrained() const;
 
+    /**
+     * Bytes of the requests accepted since the start of the simulation.
+     * Unlike the stats this is never reset, so that other objects can
+     * sample the bandwidth used over intervals of their own.
+     */
+    uint64_t bytesAccepted() const { return totalBytesAccepted; }
+
+    /**
+     * @return peak bandwidth of the interfaces, in bytes per tick
+     */
+    double peakBandwidth() const;
+
+    /**
+     * @return true if the address belongs to one of the interfaces
+     */
+    bool servesAddr(Addr addr) const;
+
+    /**
+     * Hint for the caches above whether writing back the given line
+     * now is cheap, i.e. the write would hit an open DRAM row, or no
+     * reads are waiting and the write queue is below the threshold
+     * that would force a switch to writes.
+     *
+     * @param addr Address of the line to write back
+     * @return true if an eager writeback is unlikely to delay reads
+     */
+    bool writebackWelcome(Addr addr) const;
+
     DrainState drain() override;
 
     /**
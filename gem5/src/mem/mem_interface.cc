@@ -40,6 +40,8 @@
 
 #include "mem/mem_interface.hh"
 
+#include <algorithm>
+
 #include "base/bitfield.hh"
 #include "base/cprintf.hh"
 #include "base/trace.hh"
@@ -85,18 +87,13 @@ MemInterface::setCtrl(MemCtrl* _ctrl, unsigned int command_window)
     maxCommandsPerWindow = command_window / tCK;
 }
 
-MemPacket*
-MemInterface::decodePacket(const PacketPtr pkt, Addr pkt_addr,
-                       unsigned size, bool is_read, bool is_dram)
+void
+MemInterface::decodeAddr(Addr pkt_addr, uint8_t &rank, uint8_t &bank,
+                         uint64_t &row) const
 {
     // decode the address based on the address mapping scheme, with
     // Ro, Ra, Co, Ba and Ch denoting row, rank, column, bank and
     // channel, respectively
-    uint8_t rank;
-    uint8_t bank;
-    // use a 64-bit unsigned during the computations as the row is
-    // always the top bits, and check before creating the packet
-    uint64_t row;
 
     // Get packed address, starting at 0
     Addr addr = getCtrlAddr(pkt_addr);
@@ -161,6 +158,18 @@ MemInterface::decodePacket(const PacketPtr pkt, Addr pkt_addr,
 
     DPRINTF(DRAM, "Address: %#x Rank %d Bank %d Row %d\n",
             pkt_addr, rank, bank, row);
+}
+
+MemPacket*
+MemInterface::decodePacket(const PacketPtr pkt, Addr pkt_addr,
+                       unsigned size, bool is_read, bool is_dram)
+{
+    uint8_t rank;
+    uint8_t bank;
+    // use a 64-bit unsigned during the computations as the row is
+    // always the top bits, and check before creating the packet
+    uint64_t row;
+    decodeAddr(pkt_addr, rank, bank, row);
 
     // create the corresponding memory packet with the entry time and
     // ready time set to the current tick, the latter will be updated
@@ -174,116 +183,108 @@ MemInterface::decodePacket(const PacketPtr pkt, Addr pkt_addr,
 std::pair<MemPacketQueue::iterator, Tick>
 DRAMInterface::chooseNextFRFCFS(MemPacketQueue& queue, Tick min_col_at) const
 {
-    std::vector<uint32_t> earliest_banks(ranksPerChannel, 0);
-
-    // Has minBankPrep been called to populate earliest_banks?
-    bool filled_earliest_banks = false;
-    // can the PRE/ACT sequence be done without impacting utlization?
-    bool hidden_bank_prep = false;
-
-    // search for seamless row hits first, if no seamless row hit is
-    // found then determine if there are other packets that can be issued
-    // without incurring additional bus delay due to bank timing
-    // Will select closed rows first to enable more open row possibilies
-    // in future selections
-    bool found_hidden_bank = false;
-
-    // remember if we found a row hit, not seamless, but bank prepped
-    // and ready
-    bool found_prepped_pkt = false;
-
-    // if we have no row hit, prepped or not, and no seamless packet,
-    // just go for the earliest possible
-    bool found_earliest_pkt = false;
-
-    Tick selected_col_at = MaxTick;
-    auto selected_pkt_it = queue.end();
-
-    for (auto i = queue.begin(); i != queue.end() ; ++i) {
-        MemPacket* pkt = *i;
-
-        // select optimal DRAM packet in Q
-        if (pkt->isDram()) {
-            const Bank& bank = ranks[pkt->rank]->banks[pkt->bank];
-            const Tick col_allowed_at = pkt->isRead() ? bank.rdAllowedAt :
-                                                        bank.wrAllowedAt;
-
-            DPRINTF(DRAM, "%s checking DRAM packet in bank %d, row %d\n",
-                    __func__, pkt->bank, pkt->row);
-
-            // check if rank is not doing a refresh and thus is available,
-            // if not, jump to the next packet
-            if (burstReady(pkt)) {
+    // The queue buckets its DRAM packets per bank and row, so only the
+    // oldest row hit and the oldest row miss of every bank are
+    // candidates. The choice is the same as walking the whole queue in
+    // arrival order: the oldest seamless row hit, else the oldest miss
+    // to one of the banks that can be prepared first if that can
+    // happen without impacting utilization, else the oldest prepped
+    // row hit, else that oldest miss.
+    const auto& bank_queues = queue.bankQueues();
+
+    const MemPacketQueue::Entry* seamless_hit = nullptr;
+    const MemPacketQueue::Entry* prepped_hit = nullptr;
+    bool got_miss = false;
+
+    auto older = [](const MemPacketQueue::Entry* a,
+                    const MemPacketQueue::Entry* b) {
+        return !b || a->seq < b->seq;
+    };
+
+    for (const auto& bank_queue : bank_queues) {
+        if (bank_queue.empty())
+            continue;
+
+        // all packets in a bank queue share the rank and the bank
+        MemPacket* pkt = bank_queue.oldest().pkt;
+        const Bank& bank = ranks[pkt->rank]->banks[pkt->bank];
+
+        // check if rank is not doing a refresh and thus is available,
+        // if not, jump to the next bank
+        if (!burstReady(pkt)) {
+            DPRINTF(DRAM, "%s bank %d - Rank %d not available\n", __func__,
+                    pkt->bank, pkt->rank);
+            continue;
+        }
 
-                DPRINTF(DRAM,
-                        "%s bank %d - Rank %d available\n", __func__,
-                        pkt->bank, pkt->rank);
+        const MemPacketQueue::Entry* hit = bank_queue.oldestTo(bank.openRow);
+        if (hit) {
+            const Tick col_allowed_at = hit->pkt->isRead() ?
+                bank.rdAllowedAt : bank.wrAllowedAt;
+
+            // no additional rank-to-rank or same bank-group delays, or
+            // we switched read/write and might as well go for the row
+            // hit, FCFS within the hits, giving priority to commands
+            // that can issue seamlessly
+            if (col_allowed_at <= min_col_at) {
+                if (older(hit, seamless_hit))
+                    seamless_hit = hit;
+            } else if (older(hit, prepped_hit)) {
+                prepped_hit = hit;
+            }
+        }
 
-                // check if it is a row hit
-                if (bank.openRow == pkt->row) {
-                    // no additional rank-to-rank or same bank-group
-                    // delays, or we switched read/write and might as well
-                    // go for the row hit
-                    if (col_allowed_at <= min_col_at) {
-                        // FCFS within the hits, giving priority to
-                        // commands that can issue seamlessly, without
-                        // additional delay, such as same rank accesses
-                        // and/or different bank-group accesses
-                        DPRINTF(DRAM, "%s Seamless buffer hit\n", __func__);
-                        selected_pkt_it = i;
-                        selected_col_at = col_allowed_at;
-                        // no need to look through the remaining queue entries
-                        break;
-                    } else if (!found_hidden_bank && !found_prepped_pkt) {
-                        // if we did not find a packet to a closed row that can
-                        // issue the bank commands without incurring delay, and
-                        // did not yet find a packet to a prepped row, remember
-                        // the current one
-                        selected_pkt_it = i;
-                        selected_col_at = col_allowed_at;
-                        found_prepped_pkt = true;
-                        DPRINTF(DRAM, "%s Prepped row buffer hit\n", __func__);
-                    }
-                } else if (!found_earliest_pkt) {
-                    // if we have not initialised the bank status, do it
-                    // now, and only once per scheduling decisions
-                    if (!filled_earliest_banks) {
-                        // determine entries with earliest bank delay
-                        std::tie(earliest_banks, hidden_bank_prep) =
-                            minBankPrep(queue, min_col_at);
-                        filled_earliest_banks = true;
-                    }
+        got_miss |= bank_queue.oldestNotTo(bank.openRow) != nullptr;
+    }
 
-                    // bank is amongst first available banks
-                    // minBankPrep will give priority to packets that can
-                    // issue seamlessly
-                    if (bits(earliest_banks[pkt->rank],
-                             pkt->bank, pkt->bank)) {
-                        found_earliest_pkt = true;
-                        found_hidden_bank = hidden_bank_prep;
-
-                        // give priority to packets that can issue
-                        // bank commands 'behind the scenes'
-                        // any additional delay if any will be due to
-                        // col-to-col command requirements
-                        if (hidden_bank_prep || !found_prepped_pkt) {
-                            selected_pkt_it = i;
-                            selected_col_at = col_allowed_at;
-                        }
-                    }
-                }
-            } else {
-                DPRINTF(DRAM, "%s bank %d - Rank %d not available\n", __func__,
-                        pkt->bank, pkt->rank);
+    const MemPacketQueue::Entry* selected = seamless_hit;
+    if (selected) {
+        DPRINTF(DRAM, "%s Seamless buffer hit\n", __func__);
+    } else {
+        // if we have no seamless row hit, go for the banks that can be
+        // prepared first, giving priority to those that can issue the
+        // bank commands 'behind the scenes'
+        const MemPacketQueue::Entry* earliest_miss = nullptr;
+        bool hidden_bank_prep = false;
+
+        if (got_miss) {
+            std::vector<uint32_t> earliest_banks;
+            std::tie(earliest_banks, hidden_bank_prep) =
+                minBankPrep(queue, min_col_at);
+
+            for (const auto& bank_queue : bank_queues) {
+                if (bank_queue.empty())
+                    continue;
+                MemPacket* pkt = bank_queue.oldest().pkt;
+                if (!burstReady(pkt) ||
+                    !bits(earliest_banks[pkt->rank], pkt->bank, pkt->bank))
+                    continue;
+                const MemPacketQueue::Entry* miss = bank_queue.oldestNotTo(
+                    ranks[pkt->rank]->banks[pkt->bank].openRow);
+                if (miss && older(miss, earliest_miss))
+                    earliest_miss = miss;
             }
         }
+
+        if (earliest_miss && (hidden_bank_prep || !prepped_hit)) {
+            selected = earliest_miss;
+        } else if (prepped_hit) {
+            selected = prepped_hit;
+            DPRINTF(DRAM, "%s Prepped row buffer hit\n", __func__);
+        }
     }
 
-    if (selected_pkt_it == queue.end()) {
+    if (!selected) {
         DPRINTF(DRAM, "%s no available DRAM ranks found\n", __func__);
+        return std::make_pair(queue.end(), MaxTick);
     }
 
-    return std::make_pair(selected_pkt_it, selected_col_at);
+    const Bank& bank = ranks[selected->pkt->rank]->banks[selected->pkt->bank];
+    DPRINTF(DRAM, "%s selected packet in bank %d, row %d\n", __func__,
+            selected->pkt->bank, selected->pkt->row);
+    return std::make_pair(queue.find(*selected),
+                          selected->pkt->isRead() ? bank.rdAllowedAt :
+                                                    bank.wrAllowedAt);
 }
 
 void
@@ -319,7 +320,7 @@ DRAMInterface::activateBank(Rank& rank_ref, Bank& bank_ref,
             "%d active\n", bank_ref.bank, rank_ref.rank, act_at,
             ranks[rank_ref.rank]->numBanksActive);
 
-    rank_ref.cmdList.push_back(Command(MemCommand::ACT, bank_ref.bank,
+    rank_ref.pushCommand(Command(MemCommand::ACT, bank_ref.bank,
                                act_at));
 
     DPRINTF(DRAMPower, "%llu,ACT,%d,%d\n", divCeil(act_at, tCK) -
@@ -437,7 +438,7 @@ DRAMInterface::prechargeBank(Rank& rank_ref, Bank& bank, Tick pre_tick,
 
     if (trace) {
 
-        rank_ref.cmdList.push_back(Command(MemCommand::PRE, bank.bank,
+        rank_ref.pushCommand(Command(MemCommand::PRE, bank.bank,
                                    pre_at));
         DPRINTF(DRAMPower, "%llu,PRE,%d,%d\n", divCeil(pre_at, tCK) -
                 timeStampOffset, bank.bank, rank_ref.rank);
@@ -537,8 +538,13 @@ DRAMInterface::doBurstAccess(MemPacket* mem_pkt, Tick next_burst_at,
     }
     DPRINTF(DRAM, "Schedule RD/WR burst at tick %d\n", cmd_at);
 
+    // a compressed burst frees the data bus early
+    const Tick burst_time = transferTime(mem_pkt);
+    if (burst_time < burst_gap)
+        burst_gap = burst_time;
+
     // update the packet ready time
-    mem_pkt->readyTime = cmd_at + tCL + tBURST;
+    mem_pkt->readyTime = cmd_at + tCL + burst_time;
 
     rank_ref.lastBurstTick = cmd_at;
 
@@ -617,30 +623,17 @@ DRAMInterface::doBurstAccess(MemPacket* mem_pkt, Tick next_burst_at,
         bool got_more_hits = false;
         bool got_bank_conflict = false;
 
+        // 1) if a hit is found, then both open and close adaptive
+        //    policies keep the page open
+        // 2) if no hit is found, got_bank_conflict is set to true if a
+        //    bank conflict request is waiting in the queue
+        // 3) make sure we are not considering the packet that we are
+        //    currently dealing with
         for (uint8_t i = 0; i < ctrl->numPriorities(); ++i) {
-            auto p = queue[i].begin();
-            // keep on looking until we find a hit or reach the end of the
-            // queue
-            // 1) if a hit is found, then both open and close adaptive
-            //    policies keep the page open
-            // 2) if no hit is found, got_bank_conflict is set to true if a
-            //    bank conflict request is waiting in the queue
-            // 3) make sure we are not considering the packet that we are
-            //    currently dealing with
-            while (!got_more_hits && p != queue[i].end()) {
-                if (mem_pkt != (*p)) {
-                    bool same_rank_bank = (mem_pkt->rank == (*p)->rank) &&
-                                          (mem_pkt->bank == (*p)->bank);
-
-                    bool same_row = mem_pkt->row == (*p)->row;
-                    got_more_hits |= same_rank_bank && same_row;
-                    got_bank_conflict |= same_rank_bank && !same_row;
-                }
-                ++p;
-            }
-
+            got_more_hits = queue[i].hasRowHit(mem_pkt);
             if (got_more_hits)
                 break;
+            got_bank_conflict |= queue[i].hasBankConflict(mem_pkt);
         }
 
         // auto pre-charge when either
@@ -658,7 +651,7 @@ DRAMInterface::doBurstAccess(MemPacket* mem_pkt, Tick next_burst_at,
     MemCommand::cmds command = (mem_cmd == "RD") ? MemCommand::RD :
                                                    MemCommand::WR;
 
-    rank_ref.cmdList.push_back(Command(command, mem_pkt->bank, cmd_at));
+    rank_ref.pushCommand(Command(command, mem_pkt->bank, cmd_at));
 
     DPRINTF(DRAMPower, "%llu,%s,%d,%d\n", divCeil(cmd_at, tCK) -
             timeStampOffset, mem_cmd, mem_pkt->bank, mem_pkt->rank);
@@ -688,7 +681,7 @@ DRAMInterface::doBurstAccess(MemPacket* mem_pkt, Tick next_burst_at,
         // Update latency stats
         stats.totMemAccLat += mem_pkt->readyTime - mem_pkt->entryTime;
         stats.totQLat += cmd_at - mem_pkt->entryTime;
-        stats.totBusLat += tBURST;
+        stats.totBusLat += burst_time;
     } else {
         // Schedule write done event to decrement event count
         // after the readyTime has been reached
@@ -715,6 +708,11 @@ DRAMInterface::doBurstAccess(MemPacket* mem_pkt, Tick next_burst_at,
         stats.perBankWrBursts[mem_pkt->bankId]++;
 
     }
+    if (mem_pkt->transferSize < mem_pkt->size) {
+        stats.compressedBursts++;
+        stats.bytesSavedByCompression +=
+            mem_pkt->size - mem_pkt->transferSize;
+    }
     // Update bus state to reflect when previous command was issued
     return std::make_pair(cmd_at, cmd_at + burst_gap);
 }
@@ -740,11 +738,14 @@ DRAMInterface::DRAMInterface(const DRAMInterfaceParams &_p)
     : MemInterface(_p),
       bankGroupsPerRank(_p.bank_groups_per_rank),
       bankGroupArch(_p.bank_groups_per_rank > 0),
+      burstLength(_p.burst_length),
       tCL(_p.tCL),
       tBURST_MIN(_p.tBURST_MIN), tBURST_MAX(_p.tBURST_MAX),
       tCCD_L_WR(_p.tCCD_L_WR), tCCD_L(_p.tCCD_L), tRCD(_p.tRCD),
       tRP(_p.tRP), tRAS(_p.tRAS), tWR(_p.tWR), tRTP(_p.tRTP),
-      tRFC(_p.tRFC), tREFI(_p.tREFI), tRRD(_p.tRRD), tRRD_L(_p.tRRD_L),
+      tRFC(_p.tRFC), tREFI(_p.tREFI), refreshPerBank(_p.refresh_per_bank),
+      tRFCpb(_p.tRFCpb), tREFIpb(_p.tREFI / _p.banks_per_rank),
+      tRRD(_p.tRRD), tRRD_L(_p.tRRD_L),
       tPPD(_p.tPPD), tAAD(_p.tAAD),
       tXAW(_p.tXAW), tXP(_p.tXP), tXS(_p.tXS),
       clkResyncDelay(tCL + _p.tBURST_MAX),
@@ -758,6 +759,7 @@ DRAMInterface::DRAMInterface(const DRAMInterfaceParams &_p)
       maxAccessesPerRow(_p.max_accesses_per_row),
       timeStampOffset(0), activeRank(0),
       enableDRAMPowerdown(_p.enable_dram_powerdown),
+      powerCmdBatch(_p.power_cmd_batch),
       lastStatsResetTick(0),
       stats(*this)
 {
@@ -803,6 +805,14 @@ DRAMInterface::DRAMInterface(const DRAMInterfaceParams &_p)
               tREFI, tRP, tRFC);
     }
 
+    if (refreshPerBank) {
+        fatal_if(tRFCpb == 0, "tRFCpb must be set to refresh per bank\n");
+        fatal_if(tREFIpb <= tRFCpb, "tREFI / banks per rank (%d) must be "
+                 "larger than tRFCpb (%d)\n", tREFIpb, tRFCpb);
+        fatal_if(enableDRAMPowerdown, "Per-bank refresh is not supported "
+                 "with DRAM powerdown enabled\n");
+    }
+
     // basic bank group architecture checks ->
     if (bankGroupArch) {
         // must have at least one bank per bank group
@@ -934,6 +944,9 @@ DRAMInterface::isBusy()
 
 void DRAMInterface::setupRank(const uint8_t rank, const bool is_read)
 {
+    // a parked rank catches up with its refreshes before it is used
+    ranks[rank]->fastForwardRefresh(true);
+
     // increment entry count of the rank based on packet type
     if (is_read) {
         ++ranks[rank]->readEntries;
@@ -1060,9 +1073,11 @@ DRAMInterface::minBankPrep(const MemPacketQueue& queue,
     // determine if we have queued transactions targetting the
     // bank in question
     std::vector<bool> got_waiting(ranksPerChannel * banksPerRank, false);
-    for (const auto& p : queue) {
-        if (p->isDram() && ranks[p->rank]->inRefIdleState())
-            got_waiting[p->bankId] = true;
+    const auto& bank_queues = queue.bankQueues();
+    for (uint16_t bank_id = 0; bank_id < bank_queues.size(); ++bank_id) {
+        if (!bank_queues[bank_id].empty() &&
+            ranks[bank_id / banksPerRank]->inRefIdleState())
+            got_waiting[bank_id] = true;
     }
 
     // Find command with optimal bank timing
@@ -1128,7 +1143,8 @@ DRAMInterface::Rank::Rank(const DRAMInterfaceParams &_p,
                          int _rank, DRAMInterface& _dram)
     : EventManager(&_dram), dram(_dram),
       pwrStateTrans(PWR_IDLE), pwrStatePostRefresh(PWR_IDLE),
-      pwrStateTick(0), refreshDueAt(0), pwrState(PWR_IDLE),
+      pwrStateTick(0), refreshDueAt(0), refreshBank(0),
+      refreshParked(false), pwrState(PWR_IDLE),
       refreshState(REF_IDLE), inLowPowerState(false), rank(_rank),
       readEntries(0), writeEntries(0), outstandingEvents(0),
       wakeUpAllowedAt(0), power(_p, false), banks(_p.banks_per_rank),
@@ -1137,6 +1153,7 @@ DRAMInterface::Rank::Rank(const DRAMInterfaceParams &_p,
       activateEvent([this]{ processActivateEvent(); }, name()),
       prechargeEvent([this]{ processPrechargeEvent(); }, name()),
       refreshEvent([this]{ processRefreshEvent(); }, name()),
+      bankRefreshEvent([this]{ processBankRefreshEvent(); }, name()),
       powerEvent([this]{ processPowerEvent(); }, name()),
       wakeUpEvent([this]{ processWakeUpEvent(); }, name()),
       stats(_dram, *this)
@@ -1168,16 +1185,31 @@ DRAMInterface::Rank::startup(Tick ref_tick)
     assert(ref_tick > curTick());
 
     pwrStateTick = curTick();
+    refreshParked = false;
 
-    // kick off the refresh, and give ourselves enough time to
-    // precharge
-    schedule(refreshEvent, ref_tick);
+    if (dram.refreshPerBank) {
+        // spread the refreshes of the banks over tREFI
+        refreshDueAt = curTick() + dram.tREFIpb;
+        schedule(bankRefreshEvent, refreshDueAt);
+    } else {
+        // kick off the refresh, and give ourselves enough time to
+        // precharge
+        schedule(refreshEvent, ref_tick);
+    }
 }
 
 void
 DRAMInterface::Rank::suspend()
 {
-    deschedule(refreshEvent);
+    if (refreshParked) {
+        // account for the refreshes done while idle
+        fastForwardRefresh(false);
+        refreshParked = false;
+    } else if (dram.refreshPerBank) {
+        deschedule(bankRefreshEvent);
+    } else {
+        deschedule(refreshEvent);
+    }
 
     // Update the stats
     updatePowerStats();
@@ -1240,6 +1272,31 @@ DRAMInterface::Rank::flushCmdList()
     cmdList.assign(next_iter, cmdList.end());
 }
 
+void
+DRAMInterface::Rank::evaluateCmdList()
+{
+    // any command issued from now on is at or after the cycle of
+    // curTick(), and does not need to be ordered with the earlier ones
+    const Tick cycle = divCeil(curTick(), dram.tCK);
+    if (cycle <= dram.timeStampOffset + 1)
+        return;
+    auto done = std::partition(cmdList.begin(), cmdList.end(),
+        [this, cycle](const Command &cmd) {
+            return divCeil(cmd.timeStamp, dram.tCK) < cycle;
+        });
+    if (done == cmdList.begin())
+        return;
+
+    sort(cmdList.begin(), done, DRAMInterface::sortTime);
+    for (auto it = cmdList.begin(); it != done; ++it) {
+        power.powerlib.doCommand(it->type, it->bank,
+                                 divCeil(it->timeStamp, dram.tCK) -
+                                 dram.timeStampOffset);
+    }
+    power.powerlib.evaluateCommands(cycle - 1 - dram.timeStampOffset);
+    cmdList.erase(cmdList.begin(), done);
+}
+
 void
 DRAMInterface::Rank::processActivateEvent()
 {
@@ -1292,9 +1349,113 @@ DRAMInterface::Rank::processWriteDoneEvent()
     --outstandingEvents;
 }
 
+bool
+DRAMInterface::Rank::idleForRefresh() const
+{
+    // in a low-power state the refresh events stop by themselves, in
+    // self-refresh
+    return !dram.enableDRAMPowerdown && readEntries == 0 &&
+        writeEntries == 0 && outstandingEvents == 0 &&
+        numBanksActive == 0 && pwrState == PWR_IDLE && !inLowPowerState &&
+        !activateEvent.scheduled() && !prechargeEvent.scheduled() &&
+        !powerEvent.scheduled() && !wakeUpEvent.scheduled();
+}
+
+void
+DRAMInterface::Rank::fastForwardRefresh(bool resume)
+{
+    if (!refreshParked)
+        return;
+
+    // an all-bank refresh of an idle rank is issued as soon as its
+    // event fires, and the event is scheduled tRP ahead of when the
+    // next refresh is due
+    const Tick period = dram.refreshPerBank ? dram.tREFIpb :
+        dram.tREFI - dram.tRP;
+
+    unsigned refreshes = 0;
+    for (; refreshDueAt <= curTick(); refreshDueAt += period) {
+        if (dram.refreshPerBank) {
+            refreshNextBank(refreshDueAt);
+        } else {
+            Tick ref_done_at = refreshDueAt + dram.tRFC;
+            for (auto &b : banks)
+                b.actAllowedAt = std::max(b.actAllowedAt, ref_done_at);
+
+            pushCommand(Command(MemCommand::REF, 0, refreshDueAt));
+
+            // the rank is idle in between the refreshes, and a
+            // refresh still running is only accounted for up to now
+            Tick ref_start = std::max(refreshDueAt, pwrStateTick);
+            Tick ref_end = std::min(ref_done_at, curTick());
+            stats.pwrStateTime[PWR_IDLE] += ref_start - pwrStateTick;
+            stats.pwrStateTime[PWR_REF] += ref_end - ref_start;
+            pwrStateTick = ref_end;
+        }
+        ++refreshes;
+    }
+
+    DPRINTF(DRAMState, "Rank %d fast-forwarded %d refreshes, next one "
+            "due at %llu\n", rank, refreshes, refreshDueAt);
+
+    if (resume) {
+        refreshParked = false;
+        if (dram.refreshPerBank)
+            schedule(bankRefreshEvent, refreshDueAt);
+        else
+            schedule(refreshEvent, refreshDueAt);
+    }
+}
+
+void
+DRAMInterface::Rank::refreshNextBank(Tick ref_at)
+{
+    Bank &bank = banks[refreshBank];
+    bank.actAllowedAt = std::max(bank.actAllowedAt, ref_at + dram.tRFCpb);
+
+    pushCommand(Command(MemCommand::REFB, bank.bank, ref_at));
+    DPRINTF(DRAMPower, "%llu,REFB,%d,%d\n", divCeil(ref_at, dram.tCK) -
+            dram.timeStampOffset, bank.bank, rank);
+
+    refreshBank = (refreshBank + 1) % banks.size();
+}
+
+void
+DRAMInterface::Rank::processBankRefreshEvent()
+{
+    // park an idle rank rather than refreshing it one bank at a time
+    if (idleForRefresh()) {
+        DPRINTF(DRAMState, "Rank %d idle, parking its refresh\n", rank);
+        refreshParked = true;
+        return;
+    }
+
+    // the other banks carry on, only the one refreshed is closed,
+    // after any access already scheduled to it
+    Bank &bank = banks[refreshBank];
+    if (bank.openRow != Bank::NO_ROW) {
+        dram.prechargeBank(*this, bank,
+                           std::max(bank.preAllowedAt, curTick()),
+                           false, true);
+    }
+    refreshNextBank(std::max(bank.actAllowedAt, curTick()));
+
+    refreshDueAt += dram.tREFIpb;
+    schedule(bankRefreshEvent, refreshDueAt);
+}
+
 void
 DRAMInterface::Rank::processRefreshEvent()
 {
+    // an idle rank does not go through the refresh one event at a
+    // time, it is parked until it is used again
+    if ((refreshState == REF_IDLE) && idleForRefresh()) {
+        DPRINTF(DRAMState, "Rank %d idle, parking its refresh\n", rank);
+        refreshDueAt = curTick();
+        refreshParked = true;
+        return;
+    }
+
     // when first preparing the refresh, remember when it was due
     if ((refreshState == REF_IDLE) || (refreshState == REF_SREF_EXIT)) {
         // remember when the refresh is due
@@ -1374,7 +1535,7 @@ DRAMInterface::Rank::processRefreshEvent()
             }
 
             // precharge all banks in rank
-            cmdList.push_back(Command(MemCommand::PREA, 0, pre_at));
+            pushCommand(Command(MemCommand::PREA, 0, pre_at));
 
             DPRINTF(DRAMPower, "%llu,PREA,0,%d\n",
                     divCeil(pre_at, dram.tCK) -
@@ -1421,7 +1582,7 @@ DRAMInterface::Rank::processRefreshEvent()
         }
 
         // at the moment this affects all ranks
-        cmdList.push_back(Command(MemCommand::REF, 0, curTick()));
+        pushCommand(Command(MemCommand::REF, 0, curTick()));
 
         // Update the stats
         updatePowerStats();
@@ -1528,7 +1689,7 @@ DRAMInterface::Rank::powerDownSleep(PowerState pwr_state, Tick tick)
     if (pwr_state == PWR_ACT_PDN) {
         schedulePowerEvent(pwr_state, tick);
         // push command to DRAMPower
-        cmdList.push_back(Command(MemCommand::PDN_F_ACT, 0, tick));
+        pushCommand(Command(MemCommand::PDN_F_ACT, 0, tick));
         DPRINTF(DRAMPower, "%llu,PDN_F_ACT,0,%d\n", divCeil(tick,
                 dram.tCK) - dram.timeStampOffset, rank);
     } else if (pwr_state == PWR_PRE_PDN) {
@@ -1537,7 +1698,7 @@ DRAMInterface::Rank::powerDownSleep(PowerState pwr_state, Tick tick)
         // This is neglected here.
         schedulePowerEvent(pwr_state, tick);
         //push Command to DRAMPower
-        cmdList.push_back(Command(MemCommand::PDN_F_PRE, 0, tick));
+        pushCommand(Command(MemCommand::PDN_F_PRE, 0, tick));
         DPRINTF(DRAMPower, "%llu,PDN_F_PRE,0,%d\n", divCeil(tick,
                 dram.tCK) - dram.timeStampOffset, rank);
     } else if (pwr_state == PWR_REF) {
@@ -1547,7 +1708,7 @@ DRAMInterface::Rank::powerDownSleep(PowerState pwr_state, Tick tick)
         // this is not considered.
         schedulePowerEvent(PWR_PRE_PDN, tick);
         //push Command to DRAMPower
-        cmdList.push_back(Command(MemCommand::PDN_F_PRE, 0, tick));
+        pushCommand(Command(MemCommand::PDN_F_PRE, 0, tick));
         DPRINTF(DRAMPower, "%llu,PDN_F_PRE,0,%d\n", divCeil(tick,
                 dram.tCK) - dram.timeStampOffset, rank);
     } else if (pwr_state == PWR_SREF) {
@@ -1557,7 +1718,7 @@ DRAMInterface::Rank::powerDownSleep(PowerState pwr_state, Tick tick)
         // this is not considered.
         schedulePowerEvent(PWR_SREF, tick);
         // push Command to DRAMPower
-        cmdList.push_back(Command(MemCommand::SREN, 0, tick));
+        pushCommand(Command(MemCommand::SREN, 0, tick));
         DPRINTF(DRAMPower, "%llu,SREN,0,%d\n", divCeil(tick,
                 dram.tCK) - dram.timeStampOffset, rank);
     }
@@ -1607,16 +1768,16 @@ DRAMInterface::Rank::scheduleWakeUpEvent(Tick exit_delay)
     // use pwrStateTrans for cases where we have a power event scheduled
     // to enter low power that has not yet been processed
     if (pwrStateTrans == PWR_ACT_PDN) {
-        cmdList.push_back(Command(MemCommand::PUP_ACT, 0, wake_up_tick));
+        pushCommand(Command(MemCommand::PUP_ACT, 0, wake_up_tick));
         DPRINTF(DRAMPower, "%llu,PUP_ACT,0,%d\n", divCeil(wake_up_tick,
                 dram.tCK) - dram.timeStampOffset, rank);
 
     } else if (pwrStateTrans == PWR_PRE_PDN) {
-        cmdList.push_back(Command(MemCommand::PUP_PRE, 0, wake_up_tick));
+        pushCommand(Command(MemCommand::PUP_PRE, 0, wake_up_tick));
         DPRINTF(DRAMPower, "%llu,PUP_PRE,0,%d\n", divCeil(wake_up_tick,
                 dram.tCK) - dram.timeStampOffset, rank);
     } else if (pwrStateTrans == PWR_SREF) {
-        cmdList.push_back(Command(MemCommand::SREX, 0, wake_up_tick));
+        pushCommand(Command(MemCommand::SREX, 0, wake_up_tick));
         DPRINTF(DRAMPower, "%llu,SREX,0,%d\n", divCeil(wake_up_tick,
                 dram.tCK) - dram.timeStampOffset, rank);
     }
@@ -1821,6 +1982,9 @@ DRAMInterface::Rank::computeStats()
 {
     DPRINTF(DRAM,"Computing stats due to a dump callback\n");
 
+    // catch up with the refreshes of a parked rank
+    fastForwardRefresh(false);
+
     // Update the stats
     updatePowerStats();
 
@@ -1899,6 +2063,13 @@ DRAMInterface::DRAMStats::DRAMStats(DRAMInterface &_dram)
     ADD_STAT(bytesWritten, statistics::units::Byte::get(),
             "Total bytes written"),
 
+    ADD_STAT(compressedBursts, statistics::units::Count::get(),
+             "Number of bursts transferred compressed"),
+    ADD_STAT(bytesSavedByCompression, statistics::units::Byte::get(),
+             "Data bus bytes saved by link compression"),
+    ADD_STAT(busBytesSavedRatio, statistics::units::Ratio::get(),
+             "Fraction of the data bus bytes saved by link compression"),
+
     ADD_STAT(avgRdBW, statistics::units::Rate<
                 statistics::units::Byte, statistics::units::Second>::get(),
              "Average DRAM read bandwidth in MiBytes/s"),
@@ -1957,6 +2128,9 @@ DRAMInterface::DRAMStats::regStats()
     readRowHitRate = (readRowHits / readBursts) * 100;
     writeRowHitRate = (writeRowHits / writeBursts) * 100;
 
+    busBytesSavedRatio.precision(4);
+    busBytesSavedRatio = bytesSavedByCompression / (bytesRead + bytesWritten);
+
     avgRdBW = (bytesRead / 1000000) / simSeconds;
     avgWrBW = (bytesWritten / 1000000) / simSeconds;
     peakBW = (sim_clock::Frequency / dram.burstDelay()) *
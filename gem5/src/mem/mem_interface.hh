@@ -197,7 +197,7 @@ class MemInterface : public AbstractMemory
      * @param addr The intput address which should be in the addrRange
      * @return An address in the continues range [0, max)
      */
-    Addr getCtrlAddr(Addr addr) { return range.getOffset(addr); }
+    Addr getCtrlAddr(Addr addr) const { return range.getOffset(addr); }
 
     /**
      * Setup the rank based on packet received
@@ -239,6 +239,15 @@ class MemInterface : public AbstractMemory
      */
     uint32_t bytesPerBurst() const { return burstSize; }
 
+    /**
+     * @return peak bandwidth of the interface, in bytes per tick
+     */
+    virtual double
+    peakBandwidth() const
+    {
+        return (double)burstSize / tBURST;
+    }
+
     /*
      * @return time to offset next command
      */
@@ -251,6 +260,15 @@ class MemInterface : public AbstractMemory
      */
     virtual bool burstReady(MemPacket* pkt) const = 0;
 
+    /**
+     * Check if a burst would hit in the row buffer of its bank, used
+     * by the application-aware schedulers to rank candidates
+     *
+     * @param pkt Packet to check
+     * @return true if the row targeted by the packet is open
+     */
+    virtual bool rowHit(const MemPacket* pkt) const = 0;
+
     /**
      * Determine the required delay for an access to a different rank
      *
@@ -286,6 +304,28 @@ class MemInterface : public AbstractMemory
     MemPacket* decodePacket(const PacketPtr pkt, Addr pkt_addr,
                            unsigned int size, bool is_read, bool is_dram);
 
+    /**
+     * Decode an address into the rank, bank and row it maps to, using
+     * the same mapping as decodePacket.
+     *
+     * @param pkt_addr The address to decode
+     * @param rank Decoded rank
+     * @param bank Decoded bank within the rank
+     * @param row Decoded row within the bank
+     */
+    void decodeAddr(Addr pkt_addr, uint8_t &rank, uint8_t &bank,
+                    uint64_t &row) const;
+
+    /**
+     * Check if the row an address maps to is currently open, so that a
+     * write to it would be a row buffer hit. Used to hint upstream
+     * caches when a writeback is cheap.
+     *
+     * @param addr Address to check
+     * @return true if the row is open
+     */
+    virtual bool rowOpen(Addr addr) const { return false; }
+
     /**
      *  Add rank to rank delay to bus timing to all banks in all ranks
      *  when access to an alternate interface is issued
@@ -366,7 +406,11 @@ class DRAMInterface : public MemInterface
      * refresh scheduling. When normal operation is in progress the
      * refresh state is idle. Once tREFI has elasped, a refresh event
      * is triggered to start the following STM transitions which are
-     * used to issue a refresh and return back to normal operation
+     * used to issue a refresh and return back to normal operation.
+     * A rank that is idle when its refresh is due stays in REF_IDLE
+     * with its refresh parked, and catches up once it is used again.
+     * With per-bank refresh the banks are refreshed one at a time
+     * outside of this state machine, which then remains in REF_IDLE.
      *
      * REF_IDLE      : IDLE state used during normal operation
      *                 From here can transition to:  REF_DRAIN
@@ -499,6 +543,32 @@ class DRAMInterface : public MemInterface
          */
         Tick refreshDueAt;
 
+        /**
+         * Bank the next per-bank refresh goes to.
+         */
+        uint8_t refreshBank;
+
+        /**
+         * The refreshes of an idle rank are not run one event at a time,
+         * the rank is parked instead and they are accounted for in one
+         * go once it is used again. Refresh is then due at refreshDueAt.
+         */
+        bool refreshParked;
+
+        /**
+         * Check if nothing is going on in the rank that a refresh would
+         * have to wait for, so its refreshes can be fast-forwarded.
+         */
+        bool idleForRefresh() const;
+
+        /**
+         * Refresh the next bank in turn, and keep it from being activated
+         * until the refresh is done.
+         *
+         * @param ref_at Tick when the per-bank refresh is issued
+         */
+        void refreshNextBank(Tick ref_at);
+
         /**
          * Function to update Power Stats
          */
@@ -570,6 +640,19 @@ class DRAMInterface : public MemInterface
          */
         std::vector<Command> cmdList;
 
+        /**
+         * Add a command to cmdList, and hand the commands of the
+         * previous cycles over to DRAMPower once there are
+         * power_cmd_batch of them, to keep the lists of both short.
+         */
+        void
+        pushCommand(const Command &cmd)
+        {
+            cmdList.push_back(cmd);
+            if (cmdList.size() >= dram.powerCmdBatch)
+                evaluateCmdList();
+        }
+
         /**
          * Vector of Banks. Each rank is made of several devices which in
          * term are made from several banks.
@@ -608,6 +691,15 @@ class DRAMInterface : public MemInterface
          */
         void suspend();
 
+        /**
+         * Account for the refreshes a parked rank did up to curTick(),
+         * as the refresh events would have, and possibly get the
+         * refresh events going again.
+         *
+         * @param resume Restart the refresh events
+         */
+        void fastForwardRefresh(bool resume);
+
         /**
          * Check if there is no refresh and no preparation of refresh ongoing
          * i.e. the refresh state machine is in idle
@@ -659,6 +751,14 @@ class DRAMInterface : public MemInterface
          */
         void flushCmdList();
 
+        /**
+         * Let DRAMPower evaluate the commands of cmdList issued in the
+         * cycles before the one of curTick(), no command can be issued
+         * in them any more. It updates the DRAMPower counters, the
+         * energy is only computed at refresh and stats dump.
+         */
+        void evaluateCmdList();
+
         /**
          * Computes stats just prior to dump event
          */
@@ -698,6 +798,9 @@ class DRAMInterface : public MemInterface
         void processRefreshEvent();
         EventFunctionWrapper refreshEvent;
 
+        void processBankRefreshEvent();
+        EventFunctionWrapper bankRefreshEvent;
+
         void processPowerEvent();
         EventFunctionWrapper powerEvent;
 
@@ -726,6 +829,7 @@ class DRAMInterface : public MemInterface
      */
     const uint32_t bankGroupsPerRank;
     const bool bankGroupArch;
+    const uint32_t burstLength;
 
     /**
      * DRAM specific timing requirements
@@ -742,6 +846,9 @@ class DRAMInterface : public MemInterface
     const Tick tRTP;
     const Tick tRFC;
     const Tick tREFI;
+    const bool refreshPerBank;
+    const Tick tRFCpb;
+    const Tick tREFIpb;
     const Tick tRRD;
     const Tick tRRD_L;
     const Tick tPPD;
@@ -774,6 +881,9 @@ class DRAMInterface : public MemInterface
     /** Enable or disable DRAM powerdown states. */
     bool enableDRAMPowerdown;
 
+    /** Commands buffered by a rank before they go to DRAMPower */
+    const unsigned powerCmdBatch;
+
     /** The time when stats were last reset used to calculate average power */
     Tick lastStatsResetTick;
 
@@ -843,6 +953,11 @@ class DRAMInterface : public MemInterface
         statistics::Scalar bytesRead;
         statistics::Scalar bytesWritten;
 
+        // Bursts sent compressed, and the data bus bytes they saved
+        statistics::Scalar compressedBursts;
+        statistics::Scalar bytesSavedByCompression;
+        statistics::Formula busBytesSavedRatio;
+
         // Average bandwidth
         statistics::Formula avgRdBW;
         statistics::Formula avgWrBW;
@@ -866,6 +981,23 @@ class DRAMInterface : public MemInterface
      */
     Tick writeToReadDelay() const override { return tBURST + tWTR + tCL; }
 
+    /**
+     * Time the data of a burst occupies the bus. A burst carrying a
+     * compressed line only takes the beats its compressed bytes need.
+     *
+     * @param mem_pkt The burst being issued
+     * @return The data transfer time
+     */
+    Tick
+    transferTime(const MemPacket* mem_pkt) const
+    {
+        if (mem_pkt->transferSize >= burstSize)
+            return tBURST;
+        const uint32_t beats = std::max<uint32_t>(1,
+            divCeil(mem_pkt->transferSize * burstLength, burstSize));
+        return tBURST * beats / burstLength;
+    }
+
     /**
      * Find which are the earliest banks ready to issue an activate
      * for the enqueued requests. Assumes maximum of 32 banks per rank
@@ -894,6 +1026,12 @@ class DRAMInterface : public MemInterface
      */
     void init() override;
 
+    double
+    peakBandwidth() const override
+    {
+        return (double)bytesPerBurst() / burstDelay();
+    }
+
     /**
      * Iterate through dram ranks and instantiate per rank startup routine
      */
@@ -980,6 +1118,22 @@ class DRAMInterface : public MemInterface
         return ranks[pkt->rank]->inRefIdleState();
     }
 
+    bool
+    rowHit(const MemPacket* pkt) const override
+    {
+        return ranks[pkt->rank]->banks[pkt->bank].openRow == pkt->row;
+    }
+
+    bool
+    rowOpen(Addr addr) const override
+    {
+        uint8_t rank;
+        uint8_t bank;
+        uint64_t row;
+        decodeAddr(addr, rank, bank, row);
+        return ranks[rank]->banks[bank].openRow == row;
+    }
+
     /**
      * This function checks if ranks are actively refreshing and
      * therefore busy. The function also checks if ranks are in
@@ -1190,6 +1344,12 @@ class NVMInterface : public MemInterface
      */
     bool burstReady(MemPacket* pkt) const override;
 
+    /**
+     * NVM has no row buffer exposed to the scheduler, so every
+     * access is treated as a miss
+     */
+    bool rowHit(const MemPacket* pkt) const override { return false; }
+
     /**
      * This function checks if ranks are busy.
      * This state is true when either:
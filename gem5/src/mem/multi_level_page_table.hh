@@ -34,6 +34,7 @@
 #ifndef __MEM_MULTI_LEVEL_PAGE_TABLE_HH__
 #define __MEM_MULTI_LEVEL_PAGE_TABLE_HH__
 
+#include <mutex>
 #include <string>
 
 #include "base/types.hh"
@@ -219,6 +220,7 @@ public:
     void
     map(Addr vaddr, Addr paddr, int64_t size, uint64_t flags = 0) override
     {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
         EmulationPageTable::map(vaddr, paddr, size, flags);
 
         Final entry;
@@ -239,6 +241,7 @@ public:
     void
     remap(Addr vaddr, int64_t size, Addr new_vaddr) override
     {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
         EmulationPageTable::remap(vaddr, size, new_vaddr);
 
         Final old_entry, new_entry;
@@ -262,6 +265,7 @@ public:
     void
     unmap(Addr vaddr, int64_t size) override
     {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
         EmulationPageTable::unmap(vaddr, size);
 
         Final entry;
@@ -162,15 +162,14 @@ NoncoherentXBar::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id)
 
     // remember where to route the response to
     if (expect_response) {
-        assert(routeTo.find(pkt->req) == routeTo.end());
-        routeTo[pkt->req] = cpu_side_port_id;
+        assert(routeTo.find(pkt->req) == InvalidPortID);
+        routeTo.insert(pkt->req, cpu_side_port_id);
     }
 
     reqLayers[mem_side_port_id]->succeededTiming(packetFinishTime);
 
     // stats updates
-    pktCount[cpu_side_port_id][mem_side_port_id]++;
-    pktSize[cpu_side_port_id][mem_side_port_id] += pkt_size;
+    countTraffic(cpu_side_port_id, mem_side_port_id, pkt_size);
     transDist[pkt_cmd]++;
 
     return true;
@@ -183,9 +182,7 @@ NoncoherentXBar::recvTimingResp(PacketPtr pkt, PortID mem_side_port_id)
     RequestPort *src_port = memSidePorts[mem_side_port_id];
 
     // determine the destination
-    const auto route_lookup = routeTo.find(pkt->req);
-    assert(route_lookup != routeTo.end());
-    const PortID cpu_side_port_id = route_lookup->second;
+    const PortID cpu_side_port_id = routeTo.find(pkt->req);
     assert(cpu_side_port_id != InvalidPortID);
     assert(cpu_side_port_id < respLayers.size());
 
@@ -222,13 +219,12 @@ NoncoherentXBar::recvTimingResp(PacketPtr pkt, PortID mem_side_port_id)
                                         curTick() + latency);
 
     // remove the request from the routing table
-    routeTo.erase(route_lookup);
+    routeTo.erase(pkt->req);
 
     respLayers[cpu_side_port_id]->succeededTiming(packetFinishTime);
 
     // stats updates
-    pktCount[cpu_side_port_id][mem_side_port_id]++;
-    pktSize[cpu_side_port_id][mem_side_port_id] += pkt_size;
+    countTraffic(cpu_side_port_id, mem_side_port_id, pkt_size);
     transDist[pkt_cmd]++;
 
     return true;
@@ -258,8 +254,7 @@ NoncoherentXBar::recvAtomicBackdoor(PacketPtr pkt, PortID cpu_side_port_id,
     PortID mem_side_port_id = findPort(pkt->getAddrRange());
 
     // stats updates for the request
-    pktCount[cpu_side_port_id][mem_side_port_id]++;
-    pktSize[cpu_side_port_id][mem_side_port_id] += pkt_size;
+    countTraffic(cpu_side_port_id, mem_side_port_id, pkt_size);
     transDist[pkt_cmd]++;
 
     // forward the request to the appropriate destination
@@ -274,8 +269,7 @@ NoncoherentXBar::recvAtomicBackdoor(PacketPtr pkt, PortID cpu_side_port_id,
         pkt_cmd = pkt->cmdToIndex();
 
         // stats updates
-        pktCount[cpu_side_port_id][mem_side_port_id]++;
-        pktSize[cpu_side_port_id][mem_side_port_id] += pkt_size;
+        countTraffic(cpu_side_port_id, mem_side_port_id, pkt_size);
         transDist[pkt_cmd]++;
     }
 
@@ -0,0 +1,105 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#include "mem/packet.hh"
+#include "mem/request.hh"
+#include "sim/cur_tick.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/** Requests are stamped with the current tick, there is no event queue. */
+Tick benchTick = 0;
+
+void
+setCurTick()
+{
+    Gem5Internal::_curTickPtr = &benchTick;
+}
+
+/**
+ * A cache line read as a cache sends it: a packet is made for an
+ * existing request, gets its data allocated when responded to, and is
+ * deleted by the requestor.
+ */
+void
+BM_PacketAllocRead(benchmark::State &state)
+{
+    setCurTick();
+    auto req = std::make_shared<Request>(0x1000, 64, 0, 0);
+    for (auto _ : state) {
+        PacketPtr pkt = Packet::createRead(req);
+        pkt->allocate();
+        benchmark::DoNotOptimize(pkt->getPtr<uint8_t>());
+        delete pkt;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/** A CPU access, which makes its request as well as its packet. */
+void
+BM_PacketAllocWithRequest(benchmark::State &state)
+{
+    setCurTick();
+    for (auto _ : state) {
+        auto req = std::make_shared<Request>(0x1000, 8, 0, 0);
+        PacketPtr pkt = Packet::createRead(req);
+        pkt->allocate();
+        benchmark::DoNotOptimize(pkt->getPtr<uint8_t>());
+        delete pkt;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/** Many packets in flight at once, freed in the order they were made. */
+void
+BM_PacketAllocInFlight(benchmark::State &state)
+{
+    setCurTick();
+    auto req = std::make_shared<Request>(0x1000, 64, 0, 0);
+    std::vector<PacketPtr> pkts(state.range(0));
+    for (auto _ : state) {
+        for (auto &pkt : pkts)
+            pkt = Packet::createRead(req);
+        for (auto pkt : pkts)
+            delete pkt;
+    }
+    state.SetItemsProcessed(state.iterations() * pkts.size());
+}
+
+} // anonymous namespace
+
+BENCHMARK(BM_PacketAllocRead);
+BENCHMARK(BM_PacketAllocWithRequest);
+BENCHMARK(BM_PacketAllocInFlight)->RangeMultiplier(8)->Range(8, 4096);
+
+BENCHMARK_MAIN();
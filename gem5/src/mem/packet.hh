@@ -51,12 +51,14 @@
 #include <cassert>
 #include <initializer_list>
 #include <list>
+#include <memory>
 
 #include "base/addr_range.hh"
 #include "base/cast.hh"
 #include "base/compiler.hh"
 #include "base/flags.hh"
 #include "base/logging.hh"
+#include "base/pool_allocator.hh"
 #include "base/printable.hh"
 #include "base/types.hh"
 #include "mem/htm.hh"
@@ -342,6 +344,10 @@ class Packet : public Printable
         /// the packet is destroyed. The pointer is assumed to be pointing
         /// to an array, and delete [] is consequently called
         DYNAMIC_DATA           = 0x00002000,
+        /// The data pointer points into a reference counted line
+        /// buffer that may also be referenced by cache blocks or other
+        /// packets. It is copied before the packet writes to it.
+        SHARED_DATA            = 0x00004000,
 
         /// suppress the error if this packet encounters a functional
         /// access failure.
@@ -375,6 +381,20 @@ class Packet : public Printable
     */
     PacketDataPtr data;
 
+    /// Payloads up to this size are allocated inside the packet itself.
+    static const unsigned InlineDataSize = 64;
+
+    /**
+     * Storage for small dynamically allocated payloads, such as a cache
+     * line or a CPU load or store. When the data pointer points here the
+     * packet is still marked as having DYNAMIC_DATA, but there is nothing
+     * to free when the packet is destroyed.
+     */
+    alignas(8) uint8_t inlineData[InlineDataSize];
+
+    /** Reference held on the line buffer when the data is shared */
+    std::shared_ptr<uint8_t[]> sharedData;
+
     /// The address of the request.  This address could be virtual or
     /// physical, depending on the system configuration.
     Addr addr;
@@ -437,6 +457,14 @@ class Packet : public Printable
      */
     uint32_t payloadDelay;
 
+    /**
+     * Size, in bytes, the payload takes on a compressed link, or zero if
+     * it is transferred uncompressed. A compressed cache sets it on the
+     * lines it writes back, so that the memory controller can charge
+     * the data bus for the compressed bytes only.
+     */
+    uint32_t compressedSize;
+
     /**
      * A virtual base opaque structure used to hold state associated
      * with the packet (e.g., an MSHR), specific to a SimObject that
@@ -855,7 +883,7 @@ class Packet : public Printable
            htmReturnReason(HtmCacheFailure::NO_FAIL),
            htmTransactionUid(0),
            headerDelay(0), snoopDelay(0),
-           payloadDelay(0), senderState(NULL)
+           payloadDelay(0), compressedSize(0), senderState(NULL)
     {
         flags.clear();
         if (req->hasPaddr()) {
@@ -896,7 +924,7 @@ class Packet : public Printable
            htmReturnReason(HtmCacheFailure::NO_FAIL),
            htmTransactionUid(0),
            headerDelay(0),
-           snoopDelay(0), payloadDelay(0), senderState(NULL)
+           snoopDelay(0), payloadDelay(0), compressedSize(0), senderState(NULL)
     {
         flags.clear();
         if (req->hasPaddr()) {
@@ -926,6 +954,7 @@ class Packet : public Printable
            headerDelay(pkt->headerDelay),
            snoopDelay(0),
            payloadDelay(pkt->payloadDelay),
+           compressedSize(pkt->compressedSize),
            senderState(pkt->senderState)
     {
         if (!clear_flags)
@@ -1023,6 +1052,28 @@ class Packet : public Printable
         deleteData();
     }
 
+    /**
+     * Packets are allocated and freed at a very high rate, so their
+     * storage is recycled through a per-thread free list rather than
+     * going back to the system allocator every time.
+     */
+    static void *
+    operator new(std::size_t size)
+    {
+        if (size != sizeof(Packet))
+            return ::operator new(size);
+        return FreeListPool<sizeof(Packet)>::allocate();
+    }
+
+    static void
+    operator delete(void *ptr, std::size_t size)
+    {
+        if (size != sizeof(Packet))
+            ::operator delete(ptr);
+        else
+            FreeListPool<sizeof(Packet)>::deallocate(ptr);
+    }
+
     /**
      * Take a request packet and modify it in place to be suitable for
      * returning as a response to that request.
@@ -1133,7 +1184,7 @@ class Packet : public Printable
     void
     dataStatic(T *p)
     {
-        assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
+        assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA|SHARED_DATA));
         data = (PacketDataPtr)p;
         flags.set(STATIC_DATA);
     }
@@ -1150,7 +1201,7 @@ class Packet : public Printable
     void
     dataStaticConst(const T *p)
     {
-        assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
+        assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA|SHARED_DATA));
         data = const_cast<PacketDataPtr>(p);
         flags.set(STATIC_DATA);
     }
@@ -1171,11 +1222,42 @@ class Packet : public Printable
     void
     dataDynamic(T *p)
     {
-        assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
+        assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA|SHARED_DATA));
         data = (PacketDataPtr)p;
         flags.set(DYNAMIC_DATA);
     }
 
+    /**
+     * Point the data at a reference counted line buffer, typically
+     * the payload of a cache block. The packet keeps the buffer alive,
+     * and only reads it until the first write through getPtr() or
+     * set(), which gives the packet a private copy if anyone else
+     * still references the buffer.
+     */
+    void
+    dataShared(const std::shared_ptr<uint8_t[]> &buf)
+    {
+        assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA|SHARED_DATA));
+        assert(buf);
+        sharedData = buf;
+        data = buf.get();
+        flags.set(SHARED_DATA);
+    }
+
+    /** The shared line buffer of this packet, if it has one */
+    const std::shared_ptr<uint8_t[]> &
+    getSharedData() const
+    {
+        return sharedData;
+    }
+
+    /**
+     * Does the data pointer belong to the requestor? Such packets
+     * must have their payload copied into that location, it cannot be
+     * replaced by a shared buffer.
+     */
+    bool hasStaticData() const { return flags.isSet(STATIC_DATA); }
+
     /**
      * get a pointer to the data ptr.
      */
@@ -1183,8 +1265,10 @@ class Packet : public Printable
     T*
     getPtr()
     {
-        assert(flags.isSet(STATIC_DATA|DYNAMIC_DATA));
+        assert(flags.isSet(STATIC_DATA|DYNAMIC_DATA|SHARED_DATA));
         assert(!isMaskedWrite());
+        if (flags.isSet(SHARED_DATA))
+            unshareData();
         return (T*)data;
     }
 
@@ -1192,7 +1276,7 @@ class Packet : public Printable
     const T*
     getConstPtr() const
     {
-        assert(flags.isSet(STATIC_DATA|DYNAMIC_DATA));
+        assert(flags.isSet(STATIC_DATA|DYNAMIC_DATA|SHARED_DATA));
         return (const T*)data;
     }
 
@@ -1314,13 +1398,45 @@ class Packet : public Printable
     void
     deleteData()
     {
-        if (flags.isSet(DYNAMIC_DATA))
+        if (flags.isSet(DYNAMIC_DATA) && data != inlineData)
             delete [] data;
+        sharedData.reset();
 
-        flags.clear(STATIC_DATA|DYNAMIC_DATA);
+        flags.clear(STATIC_DATA|DYNAMIC_DATA|SHARED_DATA);
         data = NULL;
     }
 
+    /**
+     * Give the packet a private copy of its shared data before it is
+     * written, unless the packet holds the only reference.
+     */
+    void
+    unshareData()
+    {
+        assert(flags.isSet(SHARED_DATA));
+        if (sharedData.use_count() == 1)
+            return;
+
+        std::shared_ptr<uint8_t[]> buf = std::move(sharedData);
+        flags.clear(SHARED_DATA);
+        allocate();
+        std::memcpy(data, buf.get(), getSize());
+    }
+
+    /**
+     * Allocate memory for the packet as a shared line buffer, which a
+     * cache can adopt as the payload of a block on a fill instead of
+     * copying it.
+     */
+    void
+    allocateShared()
+    {
+        if (hasData() || hasRespData()) {
+            assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA|SHARED_DATA));
+            dataShared(std::shared_ptr<uint8_t[]>(new uint8_t[getSize()]));
+        }
+    }
+
     /** Allocate memory for the packet. */
     void
     allocate()
@@ -1328,9 +1444,12 @@ class Packet : public Printable
         // if either this command or the response command has a data
         // payload, actually allocate space
         if (hasData() || hasRespData()) {
-            assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
+            assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA|SHARED_DATA));
             flags.set(DYNAMIC_DATA);
-            data = new uint8_t[getSize()];
+            if (getSize() <= InlineDataSize)
+                data = inlineData;
+            else
+                data = new uint8_t[getSize()];
         }
     }
 
@@ -49,7 +49,7 @@
  * for the flow control of the port.
  */
 
-#include <list>
+#include <deque>
 
 #include "mem/port.hh"
 #include "sim/drain.hh"
@@ -76,7 +76,7 @@ class PacketQueue : public Drainable
         {}
     };
 
-    typedef std::list<DeferredPacket> DeferredPacketList;
+    typedef std::deque<DeferredPacket> DeferredPacketList;
 
     /** A list of outgoing packets. */
     DeferredPacketList transmitList;
@@ -44,9 +44,113 @@
 namespace gem5
 {
 
+EmulationPageTable::PTable::PTable(int vpn_bits)
+    : levels(divCeil(vpn_bits, LevelBits) - 1)
+{
+    assert(levels >= 1);
+}
+
+EmulationPageTable::PTable::~PTable()
+{
+    free(&root, levels);
+}
+
+void
+EmulationPageTable::PTable::free(Interior *node, int level)
+{
+    for (void *child : node->children) {
+        if (!child)
+            continue;
+        if (level == 1) {
+            delete static_cast<Leaf *>(child);
+        } else {
+            free(static_cast<Interior *>(child), level - 1);
+            delete static_cast<Interior *>(child);
+        }
+    }
+}
+
+EmulationPageTable::PTable::Leaf *
+EmulationPageTable::PTable::findLeaf(Addr vpn, bool allocate)
+{
+    Interior *node = &root;
+    for (int level = levels; level >= 1; level--) {
+        void *&child =
+            node->children[(vpn >> (level * LevelBits)) % LevelSize];
+        if (!child) {
+            if (!allocate)
+                return nullptr;
+            if (level == 1)
+                child = new Leaf;
+            else
+                child = new Interior;
+        }
+        if (level == 1) {
+            lastLeaf = static_cast<Leaf *>(child);
+            lastKey = vpn >> LevelBits;
+            return lastLeaf;
+        }
+        node = static_cast<Interior *>(child);
+    }
+    return nullptr;
+}
+
+void
+EmulationPageTable::PTable::insert(Addr vpn, const Entry &entry)
+{
+    Leaf *leaf = findLeaf(vpn, true);
+    int i = vpn % LevelSize;
+    uint64_t bit = 1ULL << (i % 64);
+    if (!(leaf->present[i / 64] & bit)) {
+        leaf->present[i / 64] |= bit;
+        _size++;
+    }
+    leaf->entries[i] = entry;
+}
+
+bool
+EmulationPageTable::PTable::erase(Addr vpn)
+{
+    // empty leaves are kept until the table goes away
+    Leaf *leaf = findLeaf(vpn, false);
+    if (!leaf)
+        return false;
+    int i = vpn % LevelSize;
+    uint64_t bit = 1ULL << (i % 64);
+    if (!(leaf->present[i / 64] & bit))
+        return false;
+    leaf->present[i / 64] &= ~bit;
+    _size--;
+    return true;
+}
+
+void
+EmulationPageTable::PTable::forEach(const Interior *node, int level,
+        Addr prefix,
+        const std::function<void(Addr, const Entry &)> &func) const
+{
+    for (int c = 0; c < LevelSize; c++) {
+        const void *child = node->children[c];
+        if (!child)
+            continue;
+        Addr child_prefix = (prefix << LevelBits) | c;
+        if (level > 1) {
+            forEach(static_cast<const Interior *>(child), level - 1,
+                    child_prefix, func);
+            continue;
+        }
+        auto *leaf = static_cast<const Leaf *>(child);
+        for (int i = 0; i < LevelSize; i++) {
+            if (leaf->present[i / 64] & (1ULL << (i % 64)))
+                func((child_prefix << LevelBits) | i, leaf->entries[i]);
+        }
+    }
+}
+
 void
 EmulationPageTable::map(Addr vaddr, Addr paddr, int64_t size, uint64_t flags)
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     bool clobber = flags & Clobber;
     // starting address must be page aligned
     assert(pageOffset(vaddr) == 0);
@@ -54,16 +158,11 @@ EmulationPageTable::map(Addr vaddr, Addr paddr, int64_t size, uint64_t flags)
     DPRINTF(MMU, "Allocating Page: %#x-%#x\n", vaddr, vaddr + size);
 
     while (size > 0) {
-        auto it = pTable.find(vaddr);
-        if (it != pTable.end()) {
-            // already mapped
-            panic_if(!clobber,
-                     "EmulationPageTable::allocate: addr %#x already mapped",
-                     vaddr);
-            it->second = Entry(paddr, flags);
-        } else {
-            pTable.emplace(vaddr, Entry(paddr, flags));
-        }
+        // already mapped
+        panic_if(!clobber && pTable.find(vpn(vaddr)),
+                 "EmulationPageTable::allocate: addr %#x already mapped",
+                 vaddr);
+        pTable.insert(vpn(vaddr), Entry(paddr, flags));
 
         size -= _pageSize;
         vaddr += _pageSize;
@@ -74,6 +173,7 @@ EmulationPageTable::map(Addr vaddr, Addr paddr, int64_t size, uint64_t flags)
 void
 EmulationPageTable::remap(Addr vaddr, int64_t size, Addr new_vaddr)
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     assert(pageOffset(vaddr) == 0);
     assert(pageOffset(new_vaddr) == 0);
 
@@ -81,12 +181,11 @@ EmulationPageTable::remap(Addr vaddr, int64_t size, Addr new_vaddr)
             new_vaddr, size);
 
     while (size > 0) {
-        [[maybe_unused]] auto new_it = pTable.find(new_vaddr);
-        auto old_it = pTable.find(vaddr);
-        assert(old_it != pTable.end() && new_it == pTable.end());
+        const Entry *old_entry = pTable.find(vpn(vaddr));
+        assert(old_entry && !pTable.find(vpn(new_vaddr)));
 
-        pTable.emplace(new_vaddr, old_it->second);
-        pTable.erase(old_it);
+        pTable.insert(vpn(new_vaddr), *old_entry);
+        pTable.erase(vpn(vaddr));
         size -= _pageSize;
         vaddr += _pageSize;
         new_vaddr += _pageSize;
@@ -96,21 +195,23 @@ EmulationPageTable::remap(Addr vaddr, int64_t size, Addr new_vaddr)
 void
 EmulationPageTable::getMappings(std::vector<std::pair<Addr, Addr>> *addr_maps)
 {
-    for (auto &iter : pTable)
-        addr_maps->push_back(std::make_pair(iter.first, iter.second.paddr));
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    pTable.forEach([this, addr_maps](Addr vpn, const Entry &entry) {
+        addr_maps->push_back(std::make_pair(vpn * _pageSize, entry.paddr));
+    });
 }
 
 void
 EmulationPageTable::unmap(Addr vaddr, int64_t size)
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     assert(pageOffset(vaddr) == 0);
 
     DPRINTF(MMU, "Unmapping page: %#x-%#x\n", vaddr, vaddr + size);
 
     while (size > 0) {
-        auto it = pTable.find(vaddr);
-        assert(it != pTable.end());
-        pTable.erase(it);
+        [[maybe_unused]] bool mapped = pTable.erase(vpn(vaddr));
+        assert(mapped);
         size -= _pageSize;
         vaddr += _pageSize;
     }
@@ -119,11 +220,12 @@ EmulationPageTable::unmap(Addr vaddr, int64_t size)
 bool
 EmulationPageTable::isUnmapped(Addr vaddr, int64_t size)
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     // starting address must be page aligned
     assert(pageOffset(vaddr) == 0);
 
     for (int64_t offset = 0; offset < size; offset += _pageSize)
-        if (pTable.find(vaddr + offset) != pTable.end())
+        if (pTable.find(vpn(vaddr + offset)))
             return false;
 
     return true;
@@ -132,17 +234,15 @@ EmulationPageTable::isUnmapped(Addr vaddr, int64_t size)
 const EmulationPageTable::Entry *
 EmulationPageTable::lookup(Addr vaddr)
 {
-    Addr page_addr = pageAlign(vaddr);
-    PTableItr iter = pTable.find(page_addr);
-    if (iter == pTable.end())
-        return nullptr;
-    return &(iter->second);
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    return pTable.find(vpn(vaddr));
 }
 
 bool
 EmulationPageTable::translate(Addr vaddr, Addr &paddr)
 {
-    const Entry *entry = lookup(vaddr);
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    const Entry *entry = pTable.find(vpn(vaddr));
     if (!entry) {
         DPRINTF(MMU, "Couldn't Translate: %#x\n", vaddr);
         return false;
@@ -188,14 +288,14 @@ EmulationPageTable::serialize(CheckpointOut &cp) const
     ScopedCheckpointSection sec(cp, "ptable");
     paramOut(cp, "size", pTable.size());
 
-    PTable::size_type count = 0;
-    for (auto &pte : pTable) {
+    std::size_t count = 0;
+    pTable.forEach([this, &cp, &count](Addr vpn, const Entry &entry) {
         ScopedCheckpointSection sec(cp, csprintf("Entry%d", count++));
 
-        paramOut(cp, "vaddr", pte.first);
-        paramOut(cp, "paddr", pte.second.paddr);
-        paramOut(cp, "flags", pte.second.flags);
-    }
+        paramOut(cp, "vaddr", vpn * _pageSize);
+        paramOut(cp, "paddr", entry.paddr);
+        paramOut(cp, "flags", entry.flags);
+    });
     assert(count == pTable.size());
 }
 
@@ -216,7 +316,7 @@ EmulationPageTable::unserialize(CheckpointIn &cp)
         UNSERIALIZE_SCALAR(paddr);
         UNSERIALIZE_SCALAR(flags);
 
-        pTable.emplace(vaddr, Entry(paddr, flags));
+        pTable.insert(vpn(vaddr), Entry(paddr, flags));
     }
 }
 
@@ -224,9 +324,9 @@ const std::string
 EmulationPageTable::externalize() const
 {
     std::stringstream ss;
-    for (PTable::const_iterator it=pTable.begin(); it != pTable.end(); ++it) {
-        ss << std::hex << it->first << ":" << it->second.paddr << ";";
-    }
+    pTable.forEach([this, &ss](Addr vpn, const Entry &entry) {
+        ss << std::hex << vpn * _pageSize << ":" << entry.paddr << ";";
+    });
     return ss.str();
 }
 
@@ -35,8 +35,10 @@
 #ifndef __MEM_PAGE_TABLE_HH__
 #define __MEM_PAGE_TABLE_HH__
 
+#include <cstdint>
+#include <functional>
+#include <mutex>
 #include <string>
-#include <unordered_map>
 
 #include "base/bitfield.hh"
 #include "base/intmath.hh"
@@ -63,12 +65,90 @@ class EmulationPageTable : public Serializable
     };
 
   protected:
-    typedef std::unordered_map<Addr, Entry> PTable;
-    typedef PTable::iterator PTableItr;
+    /**
+     * The entries by virtual page number, in a radix tree with 512 entries
+     * per node. The leaf of the last lookup is remembered, so that the
+     * lookups of nearby pages skip the walk from the root.
+     */
+    class PTable
+    {
+      public:
+        static constexpr int LevelBits = 9;
+        static constexpr int LevelSize = 1 << LevelBits;
+
+      private:
+        struct Leaf
+        {
+            Entry entries[LevelSize];
+            uint64_t present[LevelSize / 64] = {};
+        };
+
+        struct Interior
+        {
+            void *children[LevelSize] = {};
+        };
+
+        /** Levels of interior nodes above the leaves */
+        const int levels;
+        Interior root;
+        std::size_t _size = 0;
+
+        /** Last leaf looked up, and its virtual page number >> LevelBits */
+        Leaf *lastLeaf = nullptr;
+        Addr lastKey = 0;
+
+        Leaf *findLeaf(Addr vpn, bool allocate);
+        void free(Interior *node, int level);
+        void forEach(const Interior *node, int level, Addr prefix,
+                const std::function<void(Addr, const Entry &)> &func) const;
+
+      public:
+        PTable(int vpn_bits);
+        ~PTable();
+
+        PTable(const PTable &) = delete;
+        PTable &operator=(const PTable &) = delete;
+
+        Entry *
+        find(Addr vpn)
+        {
+            Leaf *leaf = (lastLeaf && (vpn >> LevelBits) == lastKey) ?
+                lastLeaf : findLeaf(vpn, false);
+            if (!leaf)
+                return nullptr;
+            int i = vpn % LevelSize;
+            return (leaf->present[i / 64] & (1ULL << (i % 64))) ?
+                &leaf->entries[i] : nullptr;
+        }
+
+        /** Add or replace the entry of a page */
+        void insert(Addr vpn, const Entry &entry);
+        /** @return Whether the page had an entry */
+        bool erase(Addr vpn);
+
+        std::size_t size() const { return _size; }
+
+        /** Call func on every entry, in virtual page number order */
+        void
+        forEach(const std::function<void(Addr, const Entry &)> &func) const
+        {
+            forEach(&root, levels, 0, func);
+        }
+    };
+
     PTable pTable;
 
+    /**
+     * Protects the entries, which are shared by the threads of a process
+     * whose CPUs may be simulated on different threads. Even lookups
+     * update the last leaf of the table. Subclasses hold it while they
+     * update their own copy of the mappings.
+     */
+    std::recursive_mutex mutex;
+
     const Addr _pageSize;
     const Addr offsetMask;
+    const int pageShift;
 
     const uint64_t _pid;
     const std::string _name;
@@ -77,7 +157,9 @@ class EmulationPageTable : public Serializable
 
     EmulationPageTable(
             const std::string &__name, uint64_t _pid, Addr _pageSize) :
+            pTable(64 - floorLog2(_pageSize)),
             _pageSize(_pageSize), offsetMask(mask(floorLog2(_pageSize))),
+            pageShift(floorLog2(_pageSize)),
             _pid(_pid), _name(__name), shared(false)
     {
         assert(isPowerOf2(_pageSize));
@@ -109,6 +191,7 @@ class EmulationPageTable : public Serializable
     const std::string name() const { return _name; }
 
     Addr pageAlign(Addr a)  { return (a & ~offsetMask); }
+    Addr vpn(Addr a) const  { return a >> pageShift; }
     Addr pageOffset(Addr a) { return (a &  offsetMask); }
     // Page size can technically vary based on the virtual address, but we'll
     // ignore that for now.
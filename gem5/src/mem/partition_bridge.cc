@@ -0,0 +1,244 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/partition_bridge.hh"
+
+#include <algorithm>
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/Drain.hh"
+#include "debug/PartitionBridge.hh"
+#include "params/PartitionBridge.hh"
+#include "sim/quantum_controller.hh"
+
+namespace gem5
+{
+
+PartitionBridge::Channel::Channel(PartitionBridge &_bridge,
+                                  const std::string &_name, EventQueue *_dst,
+                                  std::function<bool(PacketPtr)> _send)
+    : Named(_name), bridge(_bridge), dst(_dst), send(_send), lastWhen(0),
+      waitingForRetry(false)
+{
+}
+
+void
+PartitionBridge::Channel::push(PacketPtr pkt, Tick when)
+{
+    // a packet never overtakes an earlier one, every delivery event
+    // takes the oldest packet from the mailbox
+    when = std::max(when, lastWhen);
+    lastWhen = when;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        mailbox.push_back(pkt);
+    }
+    ++bridge.inFlight;
+
+    // in parallel mode the event goes to the asynchronous insertion
+    // list of the receiving queue and is merged at the next barrier
+    dst->schedule(new EventFunctionWrapper([this]{ deliver(); }, name(), true),
+                  when, true);
+}
+
+void
+PartitionBridge::Channel::deliver()
+{
+    PacketPtr pkt;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        assert(!mailbox.empty());
+        pkt = mailbox.front();
+        mailbox.pop_front();
+    }
+
+    DPRINTF(PartitionBridge, "deliver: %s addr %#x\n", pkt->cmdString(),
+            pkt->getAddr());
+
+    pending.push_back(pkt);
+    if (!waitingForRetry)
+        trySend();
+}
+
+void
+PartitionBridge::Channel::trySend()
+{
+    while (!pending.empty()) {
+        if (!send(pending.front())) {
+            DPRINTF(PartitionBridge, "waiting for retry\n");
+            waitingForRetry = true;
+            return;
+        }
+        pending.pop_front();
+
+        if (--bridge.inFlight == 0 &&
+            bridge.drainState() == DrainState::Draining) {
+            DPRINTF(Drain, "%s done draining\n", bridge.name());
+            bridge.signalDrainDone();
+        }
+    }
+}
+
+void
+PartitionBridge::Channel::retry()
+{
+    waitingForRetry = false;
+    trySend();
+}
+
+bool
+PartitionBridge::Channel::trySatisfyFunctional(PacketPtr pkt)
+{
+    // look at the youngest packets first
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto i = mailbox.rbegin(); i != mailbox.rend(); ++i) {
+        if (pkt->trySatisfyFunctional(*i))
+            return true;
+    }
+    for (auto i = pending.rbegin(); i != pending.rend(); ++i) {
+        if (pkt->trySatisfyFunctional(*i))
+            return true;
+    }
+    return false;
+}
+
+PartitionBridge::PartitionBridge(const Params &p)
+    : SimObject(p),
+      cpuSidePort(p.name + ".cpu_side_port", *this),
+      memSidePort(p.name + ".mem_side_port", *this),
+      memSideQueue(getEventQueue(p.mem_side_eventq_index)),
+      delay(p.delay),
+      reqChannel(*this, p.name + ".req_delivery", memSideQueue,
+                 [this](PacketPtr pkt)
+                 { return memSidePort.sendTimingReq(pkt); }),
+      respChannel(*this, p.name + ".resp_delivery", eventQueue(),
+                  [this](PacketPtr pkt)
+                  { return cpuSidePort.sendTimingResp(pkt); }),
+      inFlight(0)
+{
+}
+
+Port &
+PartitionBridge::getPort(const std::string &if_name, PortID idx)
+{
+    if (if_name == "mem_side_port") {
+        return memSidePort;
+    } else if (if_name == "cpu_side_port") {
+        return cpuSidePort;
+    } else {
+        return SimObject::getPort(if_name, idx);
+    }
+}
+
+void
+PartitionBridge::init()
+{
+    if (!cpuSidePort.isConnected() || !memSidePort.isConnected())
+        fatal("Partition bridge %s is not connected on both sides.\n",
+              name());
+
+    // packets sent during a quantum are only merged into the other
+    // queue at the end of it, so they must not arrive any earlier
+    const Tick max_quantum = quantumController ?
+        quantumController->maxSimQuantum() : simQuantum;
+    fatal_if(memSideQueue != eventQueue() &&
+             (max_quantum == 0 || delay < max_quantum),
+             "%s: the delay (%llu ticks) of a bridge between event queues "
+             "must be at least the largest simulation quantum (%llu "
+             "ticks).\n", name(), delay, max_quantum);
+}
+
+DrainState
+PartitionBridge::drain()
+{
+    return inFlight == 0 ? DrainState::Drained : DrainState::Draining;
+}
+
+Tick
+PartitionBridge::arrival(PacketPtr pkt)
+{
+    // the packet pays for the delay added by the crossbar before us
+    Tick receive_delay = pkt->headerDelay + pkt->payloadDelay;
+    pkt->headerDelay = pkt->payloadDelay = 0;
+    return curTick() + delay + receive_delay;
+}
+
+bool
+PartitionBridge::recvTimingReq(PacketPtr pkt)
+{
+    DPRINTF(PartitionBridge, "recvTimingReq: %s addr %#x\n",
+            pkt->cmdString(), pkt->getAddr());
+
+    // the packet from the previous call can now be deleted
+    pendingDelete.reset();
+
+    if (pkt->cacheResponding()) {
+        // a cache upstream has taken ownership of the response
+        pendingDelete.reset(pkt);
+        return true;
+    }
+
+    reqChannel.push(pkt, arrival(pkt));
+    return true;
+}
+
+bool
+PartitionBridge::recvTimingResp(PacketPtr pkt)
+{
+    DPRINTF(PartitionBridge, "recvTimingResp: %s addr %#x\n",
+            pkt->cmdString(), pkt->getAddr());
+
+    respChannel.push(pkt, arrival(pkt));
+    return true;
+}
+
+Tick
+PartitionBridge::recvAtomic(PacketPtr pkt)
+{
+    panic_if(pkt->cacheResponding(), "Should not see packets where cache "
+             "is responding");
+
+    EventQueue::ScopedMigration migrate(memSideQueue);
+    return delay + memSidePort.sendAtomic(pkt);
+}
+
+void
+PartitionBridge::recvFunctional(PacketPtr pkt)
+{
+    // holding the memory-side queue keeps its thread away from the
+    // packets it has not sent yet
+    EventQueue::ScopedMigration migrate(memSideQueue);
+
+    if (respChannel.trySatisfyFunctional(pkt) ||
+        reqChannel.trySatisfyFunctional(pkt)) {
+        return;
+    }
+
+    memSidePort.sendFunctional(pkt);
+}
+
+} // namespace gem5
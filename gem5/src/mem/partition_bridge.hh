@@ -0,0 +1,265 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a bridge between two event queues, used to simulate
+ * the halves of a memory system on different host threads.
+ */
+
+#ifndef __MEM_PARTITION_BRIDGE_HH__
+#define __MEM_PARTITION_BRIDGE_HH__
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "base/named.hh"
+#include "base/types.hh"
+#include "mem/port.hh"
+#include "sim/drain.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_object.hh"
+
+namespace gem5
+{
+
+struct PartitionBridgeParams;
+
+/**
+ * A non-coherent bridge whose two sides live on different event
+ * queues. The CPU-side port is serviced by the bridge's own event queue
+ * and the memory-side port by the queue selected with
+ * mem_side_eventq_index, which lets a CPU and its private caches run on
+ * their own simulation thread while sharing a memory system with other
+ * CPUs.
+ *
+ * Timing packets cross the bridge through a mailbox per direction. The
+ * sending thread appends the packet to the mailbox and schedules a
+ * delivery event on the receiving queue through its asynchronous
+ * insertion list. The delivery events are merged at the next quantum
+ * barrier, which is only safe if the bridge delay, the lookahead of the
+ * partition, is at least one simulation quantum. Since packets are
+ * delivered in mailbox order and the asynchronous insertions are
+ * merged in a fixed order, the simulation stays deterministic.
+ *
+ * Atomic and functional accesses migrate the calling thread to the
+ * memory-side event queue for the duration of the access. The bridge
+ * does not forward snoops, so caches on either side are not kept
+ * coherent with each other.
+ */
+class PartitionBridge : public SimObject
+{
+  private:
+
+    /**
+     * One direction of the bridge. Packets are pushed by the thread of
+     * the sending side and are delivered, in order, on the receiving
+     * event queue.
+     */
+    class Channel : public Named
+    {
+      public:
+
+        /**
+         * @param _bridge the bridge owning the channel
+         * @param _name name of the channel and its delivery events
+         * @param _dst event queue of the receiving side
+         * @param _send function sending a packet on the receiving side,
+         *              returning false if the port has to wait for a retry
+         */
+        Channel(PartitionBridge &_bridge, const std::string &_name,
+                EventQueue *_dst, std::function<bool(PacketPtr)> _send);
+
+        /**
+         * Hand a packet to the receiving side. Called by the thread
+         * servicing the sending side.
+         *
+         * @param pkt packet to deliver
+         * @param when tick at which the packet reaches the other side
+         */
+        void push(PacketPtr pkt, Tick when);
+
+        /** The receiving port may send again. */
+        void retry();
+
+        /**
+         * Check the packets in flight for a functional access. The
+         * caller must hold the event queues of both sides.
+         */
+        bool trySatisfyFunctional(PacketPtr pkt);
+
+      private:
+
+        /** Move the oldest mailbox packet to the send queue. */
+        void deliver();
+
+        /** Send as many queued packets as the receiver accepts. */
+        void trySend();
+
+        PartitionBridge &bridge;
+
+        /** Event queue of the receiving side. */
+        EventQueue *const dst;
+
+        const std::function<bool(PacketPtr)> send;
+
+        /** Protects the mailbox, which is shared by both threads. */
+        std::mutex mutex;
+
+        /** Packets pushed but not yet delivered. */
+        std::deque<PacketPtr> mailbox;
+
+        /** Delivered packets waiting for the receiving port. */
+        std::deque<PacketPtr> pending;
+
+        /**
+         * Delivery tick of the previous push, so a packet never
+         * overtakes an earlier one. Only used by the sending thread.
+         */
+        Tick lastWhen;
+
+        /** Whether the receiving port owes us a retry. */
+        bool waitingForRetry;
+    };
+
+    class BridgeResponsePort : public ResponsePort
+    {
+      public:
+
+        BridgeResponsePort(const std::string &_name,
+                           PartitionBridge &_bridge)
+            : ResponsePort(_name, &_bridge), bridge(_bridge)
+        { }
+
+      protected:
+
+        bool recvTimingReq(PacketPtr pkt) override
+        {
+            return bridge.recvTimingReq(pkt);
+        }
+
+        void recvRespRetry() override { bridge.respChannel.retry(); }
+
+        Tick recvAtomic(PacketPtr pkt) override
+        {
+            return bridge.recvAtomic(pkt);
+        }
+
+        void recvFunctional(PacketPtr pkt) override
+        {
+            bridge.recvFunctional(pkt);
+        }
+
+        AddrRangeList getAddrRanges() const override
+        {
+            return bridge.memSidePort.getAddrRanges();
+        }
+
+      private:
+
+        PartitionBridge &bridge;
+    };
+
+    class BridgeRequestPort : public RequestPort
+    {
+      public:
+
+        BridgeRequestPort(const std::string &_name,
+                          PartitionBridge &_bridge)
+            : RequestPort(_name, &_bridge), bridge(_bridge)
+        { }
+
+      protected:
+
+        bool recvTimingResp(PacketPtr pkt) override
+        {
+            return bridge.recvTimingResp(pkt);
+        }
+
+        void recvReqRetry() override { bridge.reqChannel.retry(); }
+
+        void recvRangeChange() override
+        {
+            bridge.cpuSidePort.sendRangeChange();
+        }
+
+      private:
+
+        PartitionBridge &bridge;
+    };
+
+    bool recvTimingReq(PacketPtr pkt);
+    bool recvTimingResp(PacketPtr pkt);
+    Tick recvAtomic(PacketPtr pkt);
+    void recvFunctional(PacketPtr pkt);
+
+    /** Delivery tick of a packet received now. */
+    Tick arrival(PacketPtr pkt);
+
+    BridgeResponsePort cpuSidePort;
+    BridgeRequestPort memSidePort;
+
+    /** Event queue servicing the memory side of the bridge. */
+    EventQueue *const memSideQueue;
+
+    /** Latency of the bridge, and lookahead of the partition. */
+    const Tick delay;
+
+    /** Requests towards the memory side. */
+    Channel reqChannel;
+
+    /** Responses towards the CPU side. */
+    Channel respChannel;
+
+    /**
+     * Requests that a cache upstream responds to are sunk by the
+     * bridge, but the sender needs them until the call returns, so
+     * hold them for deletion until the next one.
+     */
+    std::unique_ptr<Packet> pendingDelete;
+
+    /** Packets in either channel, updated by both threads. */
+    std::atomic<unsigned> inFlight;
+
+  public:
+
+    using Params = PartitionBridgeParams;
+    PartitionBridge(const Params &p);
+
+    Port &getPort(const std::string &if_name,
+                  PortID idx=InvalidPortID) override;
+
+    void init() override;
+
+    DrainState drain() override;
+};
+
+} // namespace gem5
+
+#endif //__MEM_PARTITION_BRIDGE_HH__
@@ -39,17 +39,26 @@
 
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/user.h>
 #include <unistd.h>
 #include <zlib.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <climits>
+#include <cstdlib>
 #include <cstdio>
+#include <cstring>
+#include <functional>
 #include <iostream>
 #include <string>
+#include <thread>
 
+#include "base/intmath.hh"
+#include "base/str.hh"
 #include "base/trace.hh"
 #include "debug/AddrRanges.hh"
 #include "debug/Checkpoint.hh"
@@ -74,12 +83,133 @@ namespace gem5
 namespace memory
 {
 
+namespace
+{
+
+/**
+ * Layout of the chunked memory checkpoints. The header is followed by
+ * the compressed chunks, and then by the chunk table, one ChunkEntry per
+ * chunk of the store.
+ */
+const char chunkedMagic[8] = "gem5mem";
+const uint32_t chunkedPageBytes = 4096;
+const uint32_t chunkedChunkPages = 256;
+const uint64_t chunkedChunkBytes = (uint64_t)chunkedPageBytes *
+    chunkedChunkPages;
+
+const uint8_t zeroPage[chunkedPageBytes] = {};
+
+struct ChunkedHeader
+{
+    char magic[8];
+    uint64_t rangeSize;
+    uint32_t pageBytes;
+    uint32_t chunkPages;
+    uint64_t numChunks;
+    uint64_t tableOffset;
+};
+
+struct ChunkEntry
+{
+    // pages of the chunk that are in the file, the others are all zero
+    uint64_t pageMask[chunkedChunkPages / 64];
+    uint64_t offset;
+    uint64_t size;
+};
+
+/** The absolute path of a file of a checkpoint. */
+std::string
+absolutePath(const std::string &path)
+{
+    char buf[PATH_MAX];
+    fatal_if(!realpath(path.c_str(), buf),
+             "Can't find physical memory checkpoint file '%s'\n", path);
+    return buf;
+}
+
+/** The absolute path of a file named relative to a checkpoint. */
+std::string
+absolutePath(const std::string &cpt_dir, const std::string &path)
+{
+    return absolutePath(path[0] == '/' ? path : cpt_dir + "/" + path);
+}
+
+/**
+ * The path of a file relative to a checkpoint directory, so that the
+ * checkpoints of a delta chain can be moved together.
+ */
+std::string
+relativePath(const std::string &path, const std::string &cpt_dir)
+{
+    const auto split = [](const std::string &p) {
+        std::vector<std::string> parts;
+        tokenize(parts, p, '/');
+        return parts;
+    };
+    const auto from = split(absolutePath(cpt_dir));
+    const auto to = split(path);
+
+    size_t common = 0;
+    while (common < from.size() && common + 1 < to.size() &&
+           from[common] == to[common]) {
+        common++;
+    }
+
+    std::string rel;
+    for (size_t i = common; i < from.size(); i++)
+        rel += "../";
+    for (size_t i = common; i < to.size(); i++)
+        rel += to[i] + (i + 1 < to.size() ? "/" : "");
+    return rel;
+}
+
+unsigned
+checkpointThreadCount(unsigned threads)
+{
+    if (threads == 0)
+        threads = std::thread::hardware_concurrency();
+    return std::max(threads, 1U);
+}
+
+/**
+ * Call work(i) for every i in [0, n), spread over the given number of
+ * threads, the calling one included.
+ */
+void
+parallelFor(unsigned threads, uint64_t n,
+            const std::function<void(uint64_t)> &work)
+{
+    std::atomic<uint64_t> next(0);
+    auto worker = [&]() {
+        for (uint64_t i = next++; i < n; i = next++)
+            work(i);
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < std::min<uint64_t>(threads, n); t++)
+        pool.emplace_back(worker);
+    worker();
+    for (auto &thread : pool)
+        thread.join();
+}
+
+} // anonymous namespace
+
 PhysicalMemory::PhysicalMemory(const std::string& _name,
                                const std::vector<AbstractMemory*>& _memories,
                                bool mmap_using_noreserve,
-                               const std::string& shared_backstore) :
+                               const std::string& shared_backstore,
+                               enums::MemoryCheckpointFormat
+                                   checkpoint_format,
+                               unsigned checkpoint_threads,
+                               bool incremental_checkpoints,
+                               unsigned max_delta_chain) :
     _name(_name), size(0), mmapUsingNoReserve(mmap_using_noreserve),
-    sharedBackstore(shared_backstore)
+    sharedBackstore(shared_backstore),
+    checkpointFormat(checkpoint_format),
+    checkpointThreads(checkpointThreadCount(checkpoint_threads)),
+    incrementalCheckpoints(incremental_checkpoints),
+    maxDeltaChain(max_delta_chain), untrackedWrites(false)
 {
     if (mmap_using_noreserve)
         warn("Not reserving swap space. May cause SIGSEGV on actual usage\n");
@@ -236,12 +366,20 @@ PhysicalMemory::createBackingStore(
     // it appropriately
     backingStore.emplace_back(range, pmem,
                               conf_table_reported, in_addr_map, kvm_map);
+    deltaChains.emplace_back();
+
+    DirtyPageMap *dirty = nullptr;
+    if (incrementalCheckpoints) {
+        dirtyPages.emplace_back(
+            new DirtyPageMap(pmem, range.size(), chunkedPageBytes));
+        dirty = dirtyPages.back().get();
+    }
 
     // point the memories to their backing store
     for (const auto& m : _memories) {
         DPRINTF(AddrRanges, "Mapping memory %s to backing store\n",
                 m->name());
-        m->setBackingStore(pmem);
+        m->setBackingStore(pmem, dirty);
     }
 }
 
@@ -258,6 +396,24 @@ PhysicalMemory::isMemAddr(Addr addr) const
     return addrMap.contains(addr) != addrMap.end();
 }
 
+uint8_t *
+PhysicalMemory::toHostAddr(Addr addr, Addr size, bool write) const
+{
+    for (int i = 0; i < backingStore.size(); i++) {
+        const BackingStoreEntry &entry = backingStore[i];
+        const AddrRange &range = entry.range;
+        if (entry.inAddrMap && !range.interleaved() &&
+                addr >= range.start() && addr < range.end() &&
+                size <= range.end() - addr) {
+            uint8_t *host = entry.pmem + (addr - range.start());
+            if (write && !dirtyPages.empty())
+                dirtyPages[i]->mark(host, size);
+            return host;
+        }
+    }
+    return nullptr;
+}
+
 AddrRangeList
 PhysicalMemory::getConfAddrRanges() const
 {
@@ -361,10 +517,68 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
 
     // write memory file
     std::string filepath = CheckpointIn::dir() + "/" + filename.c_str();
+    DirtyPageMap *dirty =
+        dirtyPages.empty() ? nullptr : dirtyPages[store_id].get();
+    DeltaChain &chain = deltaChains[store_id];
+    int store_format;
+    if (dirty && !untrackedWrites && !chain.base.empty() &&
+        (maxDeltaChain == 0 || chain.deltas.size() < maxDeltaChain)) {
+        // Only write the pages dirtied since the previous checkpoint,
+        // and refer to the checkpoints to apply them to
+        DPRINTF(Checkpoint, "Writing %d dirty pages of %s as a delta\n",
+                dirty->count(), filename);
+        store_format = 3;
+        std::string delta_base = relativePath(chain.base,
+                                              CheckpointIn::dir());
+        int delta_base_format = chain.baseFormat;
+        std::vector<std::string> delta_files;
+        for (const auto &delta : chain.deltas)
+            delta_files.push_back(relativePath(delta, CheckpointIn::dir()));
+        SERIALIZE_SCALAR(delta_base);
+        SERIALIZE_SCALAR(delta_base_format);
+        SERIALIZE_CONTAINER(delta_files);
+        serializeStoreChunked(filepath, range, pmem, dirty);
+        chain.deltas.push_back(absolutePath(filepath));
+    } else {
+        switch (checkpointFormat) {
+          case enums::MemoryCheckpointFormat::gzip:
+            store_format = 0;
+            serializeStoreGzip(filepath, range, pmem);
+            break;
+          case enums::MemoryCheckpointFormat::chunked:
+            store_format = 1;
+            serializeStoreChunked(filepath, range, pmem);
+            break;
+          case enums::MemoryCheckpointFormat::image:
+            store_format = 2;
+            serializeStoreImage(filepath, range, pmem);
+            break;
+          default:
+            panic("Unknown memory checkpoint format %d\n",
+                  checkpointFormat);
+        }
+        if (dirty) {
+            chain.base = absolutePath(filepath);
+            chain.baseFormat = store_format;
+            chain.deltas.clear();
+        }
+    }
+    if (dirty)
+        dirty->clear();
+
+    // checkpoints without a format have the store as a gzip stream
+    if (store_format != 0)
+        SERIALIZE_SCALAR(store_format);
+}
+
+void
+PhysicalMemory::serializeStoreGzip(const std::string &filepath,
+                                   AddrRange range, uint8_t* pmem) const
+{
     gzFile compressed_mem = gzopen(filepath.c_str(), "wb");
     if (compressed_mem == NULL)
         fatal("Can't open physical memory checkpoint file '%s'\n",
-              filename);
+              filepath);
 
     uint64_t pass_size = 0;
 
@@ -377,7 +591,7 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
         if (gzwrite(compressed_mem, pmem + written,
                     (unsigned int) pass_size) != (int) pass_size) {
             fatal("Write failed on physical memory checkpoint file '%s'\n",
-                  filename);
+                  filepath);
         }
     }
 
@@ -385,8 +599,144 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
     // is zero
     if (gzclose(compressed_mem))
         fatal("Close failed on physical memory checkpoint file '%s'\n",
-              filename);
+              filepath);
+}
+
+void
+PhysicalMemory::serializeStoreChunked(const std::string &filepath,
+                                      AddrRange range, uint8_t* pmem,
+                                      const DirtyPageMap *dirty) const
+{
+    const uint64_t range_size = range.size();
+    const uint64_t num_chunks = divCeil(range_size, chunkedChunkBytes);
+
+    std::FILE *file = std::fopen(filepath.c_str(), "wb");
+    if (!file)
+        fatal("Can't open physical memory checkpoint file '%s'\n",
+              filepath);
+
+    ChunkedHeader header = {};
+    std::memcpy(header.magic, chunkedMagic, sizeof(header.magic));
+    header.rangeSize = range_size;
+    header.pageBytes = chunkedPageBytes;
+    header.chunkPages = chunkedChunkPages;
+    header.numChunks = num_chunks;
+    uint64_t offset = sizeof(header);
+    if (std::fseek(file, offset, SEEK_SET))
+        fatal("Write failed on physical memory checkpoint file '%s'\n",
+              filepath);
+
+    std::vector<ChunkEntry> table(num_chunks);
+    std::atomic<bool> failed(false);
+
+    // Compress a batch of chunks in parallel, write it out in order, and
+    // go on with the next one, so as to bound the buffered output
+    const uint64_t batch_chunks = checkpointThreads * 4;
+    std::vector<std::vector<uint8_t>> out(batch_chunks);
+    for (uint64_t first = 0; first < num_chunks; first += batch_chunks) {
+        uint64_t batch = std::min(batch_chunks, num_chunks - first);
+        parallelFor(checkpointThreads, batch, [&](uint64_t i) {
+            ChunkEntry &entry = table[first + i];
+            uint64_t chunk_start = (first + i) * chunkedChunkBytes;
+            std::vector<uint8_t> pages;
+            for (uint32_t page = 0; page < chunkedChunkPages; page++) {
+                uint64_t start = chunk_start +
+                    (uint64_t)page * chunkedPageBytes;
+                if (start >= range_size)
+                    break;
+                uint64_t bytes = std::min<uint64_t>(chunkedPageBytes,
+                                                    range_size - start);
+                if (dirty ?
+                    !dirty->isDirty(start / chunkedPageBytes) :
+                    !std::memcmp(pmem + start, zeroPage, bytes)) {
+                    continue;
+                }
+                entry.pageMask[page / 64] |= 1ULL << (page % 64);
+                pages.insert(pages.end(), pmem + start, pmem + start + bytes);
+            }
+
+            std::vector<uint8_t> &compressed = out[i];
+            if (pages.empty()) {
+                compressed.clear();
+                return;
+            }
+            uLongf size = compressBound(pages.size());
+            compressed.resize(size);
+            if (compress2(compressed.data(), &size, pages.data(),
+                          pages.size(), Z_BEST_SPEED) != Z_OK) {
+                failed = true;
+            }
+            compressed.resize(size);
+        });
+        if (failed)
+            fatal("Compression failed on physical memory checkpoint "
+                  "file '%s'\n", filepath);
+
+        for (uint64_t i = 0; i < batch; i++) {
+            ChunkEntry &entry = table[first + i];
+            entry.offset = offset;
+            entry.size = out[i].size();
+            if (std::fwrite(out[i].data(), 1, entry.size, file) !=
+                entry.size) {
+                fatal("Write failed on physical memory checkpoint "
+                      "file '%s'\n", filepath);
+            }
+            offset += entry.size;
+        }
+    }
+
+    header.tableOffset = offset;
+    if (std::fwrite(table.data(), sizeof(ChunkEntry), num_chunks, file) !=
+            num_chunks ||
+        std::fseek(file, 0, SEEK_SET) ||
+        std::fwrite(&header, sizeof(header), 1, file) != 1) {
+        fatal("Write failed on physical memory checkpoint file '%s'\n",
+              filepath);
+    }
+
+    if (std::fclose(file))
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filepath);
+}
+
+void
+PhysicalMemory::serializeStoreImage(const std::string &filepath,
+                                    AddrRange range, uint8_t* pmem) const
+{
+    // Write a new file and rename it, as the store may be mapped from
+    // the image it was restored from if it has the same name
+    const std::string tmppath = filepath + ".tmp";
+    int fd = open(tmppath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0)
+        fatal("Can't open physical memory checkpoint file '%s'\n",
+              tmppath);
+    if (ftruncate(fd, range.size()))
+        fatal("Write failed on physical memory checkpoint file '%s'\n",
+              tmppath);
+
+    // Only the pages that are not all zero are written, the others are
+    // holes in the file
+    std::atomic<bool> failed(false);
+    const uint64_t num_chunks = divCeil(range.size(), chunkedChunkBytes);
+    parallelFor(checkpointThreads, num_chunks, [&](uint64_t i) {
+        uint64_t end = std::min(range.size(), (i + 1) * chunkedChunkBytes);
+        for (uint64_t start = i * chunkedChunkBytes; start < end;
+             start += chunkedPageBytes) {
+            uint64_t bytes = std::min<uint64_t>(chunkedPageBytes,
+                                                end - start);
+            if (std::memcmp(pmem + start, zeroPage, bytes) &&
+                pwrite(fd, pmem + start, bytes, start) != (ssize_t)bytes) {
+                failed = true;
+            }
+        }
+    });
 
+    if (failed)
+        fatal("Write failed on physical memory checkpoint file '%s'\n",
+              tmppath);
+    if (close(fd) || rename(tmppath.c_str(), filepath.c_str()))
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filepath);
 }
 
 void
@@ -417,8 +767,6 @@ PhysicalMemory::unserialize(CheckpointIn &cp)
 void
 PhysicalMemory::unserializeStore(CheckpointIn &cp)
 {
-    const uint32_t chunk_size = 16384;
-
     unsigned int store_id;
     UNSERIALIZE_SCALAR(store_id);
 
@@ -426,11 +774,6 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(filename);
     std::string filepath = cp.getCptDir() + "/" + filename;
 
-    // mmap memoryfile
-    gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
-    if (compressed_mem == NULL)
-        fatal("Can't open physical memory checkpoint file '%s'", filename);
-
     // we've already got the actual backing store mapped
     uint8_t* pmem = backingStore[store_id].pmem;
     AddrRange range = backingStore[store_id].range;
@@ -445,6 +788,71 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
         fatal("Memory range size has changed! Saw %lld, expected %lld\n",
               range_size, range.size());
 
+    // checkpoints without a format have the store as a gzip stream
+    int store_format = 0;
+    UNSERIALIZE_OPT_SCALAR(store_format);
+    DeltaChain chain;
+    if (store_format == 3) {
+        // a delta, to apply on top of the checkpoints it is chained to
+        std::string delta_base;
+        int delta_base_format;
+        std::vector<std::string> delta_files;
+        UNSERIALIZE_SCALAR(delta_base);
+        UNSERIALIZE_SCALAR(delta_base_format);
+        UNSERIALIZE_CONTAINER(delta_files);
+        fatal_if(delta_base_format == 3, "The base of the memory "
+                 "checkpoint '%s' is a delta\n", filename);
+
+        chain.base = absolutePath(cp.getCptDir(), delta_base);
+        chain.baseFormat = delta_base_format;
+        unserializeStoreFile(chain.base, chain.baseFormat, range, pmem);
+        for (const auto &delta : delta_files) {
+            chain.deltas.push_back(absolutePath(cp.getCptDir(), delta));
+            unserializeStoreFile(chain.deltas.back(), 1, range, pmem);
+        }
+        unserializeStoreFile(filepath, 1, range, pmem);
+        chain.deltas.push_back(absolutePath(filepath));
+    } else {
+        unserializeStoreFile(filepath, store_format, range, pmem);
+        chain.base = absolutePath(filepath);
+        chain.baseFormat = store_format;
+    }
+
+    // the next incremental checkpoint is a delta to this one
+    if (!dirtyPages.empty()) {
+        deltaChains[store_id] = chain;
+        dirtyPages[store_id]->clear();
+    }
+}
+
+void
+PhysicalMemory::unserializeStoreFile(const std::string &filepath,
+                                     int format, AddrRange range,
+                                     uint8_t* pmem)
+{
+    DPRINTF(Checkpoint, "Restoring physical memory from %s\n", filepath);
+    if (format == 0) {
+        unserializeStoreGzip(filepath, range, pmem);
+    } else if (format == 1) {
+        unserializeStoreChunked(filepath, range, pmem);
+    } else {
+        fatal_if(format != 2, "Unknown physical memory checkpoint "
+                 "format %d for '%s'\n", format, filepath);
+        unserializeStoreImage(filepath, range, pmem);
+    }
+}
+
+void
+PhysicalMemory::unserializeStoreGzip(const std::string &filepath,
+                                     AddrRange range, uint8_t* pmem)
+{
+    const uint32_t chunk_size = 16384;
+
+    // mmap memoryfile
+    gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
+    if (compressed_mem == NULL)
+        fatal("Can't open physical memory checkpoint file '%s'", filepath);
+
     uint64_t curr_size = 0;
     long* temp_page = new long[chunk_size];
     long* pmem_current;
@@ -471,7 +879,135 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
 
     if (gzclose(compressed_mem))
         fatal("Close failed on physical memory checkpoint file '%s'\n",
-              filename);
+              filepath);
+}
+
+void
+PhysicalMemory::unserializeStoreChunked(const std::string &filepath,
+                                        AddrRange range, uint8_t* pmem)
+{
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0)
+        fatal("Can't open physical memory checkpoint file '%s'", filepath);
+
+    ChunkedHeader header;
+    if (pread(fd, &header, sizeof(header), 0) != sizeof(header) ||
+        std::memcmp(header.magic, chunkedMagic, sizeof(header.magic))) {
+        fatal("Physical memory checkpoint file '%s' is not in the chunked "
+              "format\n", filepath);
+    }
+    fatal_if(header.rangeSize != range.size() ||
+             header.pageBytes != chunkedPageBytes ||
+             header.chunkPages != chunkedChunkPages ||
+             header.numChunks != divCeil(range.size(), chunkedChunkBytes),
+             "Unexpected layout of physical memory checkpoint file '%s'\n",
+             filepath);
+
+    std::vector<ChunkEntry> table(header.numChunks);
+    const ssize_t table_size = header.numChunks * sizeof(ChunkEntry);
+    if (pread(fd, table.data(), table_size, header.tableOffset) !=
+        table_size) {
+        fatal("Read failed on physical memory checkpoint file '%s'\n",
+              filepath);
+    }
+
+    std::atomic<bool> failed(false);
+    parallelFor(checkpointThreads, header.numChunks, [&](uint64_t i) {
+        const ChunkEntry &entry = table[i];
+        if (entry.size == 0)
+            return;
+
+        std::vector<uint8_t> compressed(entry.size);
+        std::vector<uint8_t> pages(chunkedChunkBytes);
+        uLongf size = pages.size();
+        if (pread(fd, compressed.data(), entry.size, entry.offset) !=
+            (ssize_t)entry.size ||
+            uncompress(pages.data(), &size, compressed.data(),
+                       entry.size) != Z_OK) {
+            failed = true;
+            return;
+        }
+
+        // put each page back where it belongs, the pages left out of
+        // the checkpoint are zero in the fresh backing store already, or
+        // unchanged since the checkpoint a delta applies to
+        uint64_t chunk_start = i * chunkedChunkBytes;
+        uint64_t in = 0;
+        for (uint32_t page = 0; page < chunkedChunkPages; page++) {
+            if (!(entry.pageMask[page / 64] & (1ULL << (page % 64))))
+                continue;
+            uint64_t start = chunk_start + (uint64_t)page * chunkedPageBytes;
+            if (start >= range.size()) {
+                failed = true;
+                return;
+            }
+            uint64_t bytes = std::min<uint64_t>(chunkedPageBytes,
+                                                range.size() - start);
+            if (in + bytes > size) {
+                failed = true;
+                return;
+            }
+            std::memcpy(pmem + start, pages.data() + in, bytes);
+            in += bytes;
+        }
+    });
+    close(fd);
+
+    if (failed)
+        fatal("Physical memory checkpoint file '%s' is corrupted\n",
+              filepath);
+}
+
+void
+PhysicalMemory::unserializeStoreImage(const std::string &filepath,
+                                      AddrRange range, uint8_t* pmem)
+{
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0)
+        fatal("Can't open physical memory checkpoint file '%s'", filepath);
+
+    struct stat st;
+    fatal_if(fstat(fd, &st) || st.st_size != range.size(),
+             "Physical memory checkpoint file '%s' has the wrong size\n",
+             filepath);
+
+    if (sharedBackstore.empty()) {
+        // Replace the anonymous mapping of the store, at the same
+        // address, so that the memories keep using the same pointer
+        int map_flags = MAP_PRIVATE | MAP_FIXED;
+        if (mmapUsingNoReserve)
+            map_flags |= MAP_NORESERVE;
+        if (mmap(pmem, range.size(), PROT_READ | PROT_WRITE, map_flags,
+                 fd, 0) != pmem) {
+            perror("mmap");
+            fatal("Could not mmap physical memory checkpoint file '%s'\n",
+                  filepath);
+        }
+    } else {
+        // A store shared with other processes has to stay in its shared
+        // memory segment, so copy the pages that are not zero into it
+        uint8_t *image = (uint8_t *)mmap(NULL, range.size(), PROT_READ,
+                                         MAP_PRIVATE, fd, 0);
+        if (image == (uint8_t *)MAP_FAILED) {
+            perror("mmap");
+            fatal("Could not mmap physical memory checkpoint file '%s'\n",
+                  filepath);
+        }
+        uint64_t num_chunks = divCeil(range.size(), chunkedChunkBytes);
+        parallelFor(checkpointThreads, num_chunks, [&](uint64_t i) {
+            uint64_t end = std::min(range.size(),
+                                    (i + 1) * chunkedChunkBytes);
+            for (uint64_t start = i * chunkedChunkBytes; start < end;
+                 start += chunkedPageBytes) {
+                uint64_t bytes = std::min<uint64_t>(chunkedPageBytes,
+                                                    end - start);
+                if (std::memcmp(image + start, zeroPage, bytes))
+                    std::memcpy(pmem + start, image + start, bytes);
+            }
+        });
+        munmap(image, range.size());
+    }
+    close(fd);
 }
 
 } // namespace memory
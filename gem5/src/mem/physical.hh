@@ -39,11 +39,14 @@
 #define __MEM_PHYSICAL_HH__
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "base/addr_range.hh"
 #include "base/addr_range_map.hh"
+#include "enums/MemoryCheckpointFormat.hh"
+#include "mem/dirty_page_map.hh"
 #include "mem/packet.hh"
 #include "sim/serialize.hh"
 
@@ -141,10 +144,44 @@ class PhysicalMemory : public Serializable
 
     const std::string sharedBackstore;
 
+    // Format of the backing stores in the checkpoints we write
+    const enums::MemoryCheckpointFormat checkpointFormat;
+
+    // Threads (de)compressing the chunks of a checkpoint
+    const unsigned checkpointThreads;
+
+    // Write only the pages dirtied since the previous checkpoint
+    const bool incrementalCheckpoints;
+
+    // Deltas chained to a full checkpoint, 0 for no limit
+    const unsigned maxDeltaChain;
+
     // The physical memory used to provide the memory in the simulated
     // system
     std::vector<BackingStoreEntry> backingStore;
 
+    // The pages of each backing store written to since the previous
+    // checkpoint, when checkpoints are incremental
+    std::vector<std::unique_ptr<DirtyPageMap>> dirtyPages;
+
+    // Whether the backing stores were handed out to be written to
+    // directly, which leaves the dirty pages unknown
+    mutable bool untrackedWrites;
+
+    /**
+     * The checkpoint files the memory of a backing store is restored
+     * from: a full checkpoint in any format and the deltas written
+     * after it, in order, with their absolute paths. The base is empty
+     * until a checkpoint of the store is written or restored.
+     */
+    struct DeltaChain
+    {
+        std::string base;
+        int baseFormat = 0;
+        std::vector<std::string> deltas;
+    };
+    mutable std::vector<DeltaChain> deltaChains;
+
     // Prevent copying
     PhysicalMemory(const PhysicalMemory&);
 
@@ -173,7 +210,11 @@ class PhysicalMemory : public Serializable
     PhysicalMemory(const std::string& _name,
                    const std::vector<AbstractMemory*>& _memories,
                    bool mmap_using_noreserve,
-                   const std::string& shared_backstore);
+                   const std::string& shared_backstore,
+                   enums::MemoryCheckpointFormat checkpoint_format,
+                   unsigned checkpoint_threads,
+                   bool incremental_checkpoints=false,
+                   unsigned max_delta_chain=0);
 
     /**
      * Unmap all the backing store we have used.
@@ -220,12 +261,32 @@ class PhysicalMemory : public Serializable
      * that memories that are null are not present, and that the
      * backing store may also contain memories that are not part of
      * the OS-visible global address map and thus are allowed to
-     * overlap.
+     * overlap. The pages written to through these pointers can't be
+     * tracked, so the checkpoints taken afterwards are all full.
      *
      * @return Pointers to the memory backing store
      */
-    std::vector<BackingStoreEntry> getBackingStore() const
-    { return backingStore; }
+    std::vector<BackingStoreEntry>
+    getBackingStore() const
+    {
+        untrackedWrites = true;
+        return backingStore;
+    }
+
+    /**
+     * Get the host address of a range of memory of the global address
+     * map, for the few accesses which may bypass the memory system, e.g.
+     * when the caches are bypassed. Like getBackingStore(), this skips any
+     * state of the memory system the access should have updated.
+     *
+     * @param addr Start of the range
+     * @param size Size of the range
+     * @param write Whether the range may be written to through the
+     *              host address, to track the pages it dirties
+     * @return The host address of addr, or nullptr if the range is not
+     *         within a single, non-interleaved backing store
+     */
+    uint8_t *toHostAddr(Addr addr, Addr size, bool write) const;
 
     /**
      * Perform an untimed memory access and update all the state
@@ -266,6 +327,33 @@ class PhysicalMemory : public Serializable
     void serializeStore(CheckpointOut &cp, unsigned int store_id,
                         AddrRange range, uint8_t* pmem) const;
 
+    /**
+     * Write a backing store as a single gzip stream, the format of the
+     * checkpoints without a store_format.
+     */
+    void serializeStoreGzip(const std::string &filepath, AddrRange range,
+                            uint8_t* pmem) const;
+
+    /**
+     * Write a backing store in the chunked format: the pages of each
+     * chunk that are not all zero, compressed on their own by one of
+     * the checkpoint threads, followed by a table giving, per chunk,
+     * which pages are present and where they are in the file.
+     *
+     * @param dirty If not null, write the dirty pages instead, zero or
+     *              not, as a delta to apply to the previous checkpoint
+     */
+    void serializeStoreChunked(const std::string &filepath,
+                               AddrRange range, uint8_t* pmem,
+                               const DirtyPageMap *dirty=nullptr) const;
+
+    /**
+     * Write a backing store as is, leaving holes in the file for the
+     * zero pages, so that it can be mapped back as a backing store.
+     */
+    void serializeStoreImage(const std::string &filepath, AddrRange range,
+                             uint8_t* pmem) const;
+
     /**
      * Unserialize the memories in the system. As with the
      * serialization, this action is independent of how the address
@@ -278,6 +366,28 @@ class PhysicalMemory : public Serializable
      */
     void unserializeStore(CheckpointIn &cp);
 
+    /** Restore a backing store from a checkpoint file of a format. */
+    void unserializeStoreFile(const std::string &filepath, int format,
+                              AddrRange range, uint8_t* pmem);
+
+    void unserializeStoreGzip(const std::string &filepath, AddrRange range,
+                              uint8_t* pmem);
+
+    /**
+     * Decompress the chunks in parallel straight into a backing store,
+     * leaving the pages missing from the checkpoint untouched.
+     */
+    void unserializeStoreChunked(const std::string &filepath,
+                                 AddrRange range, uint8_t* pmem);
+
+    /**
+     * Map a memory image copy-on-write in place of a backing store. The
+     * pages are read in on first touch, and are shared with any other
+     * process mapping the same image until they are written to.
+     */
+    void unserializeStoreImage(const std::string &filepath,
+                               AddrRange range, uint8_t* pmem);
+
 };
 
 } // namespace memory
@@ -116,6 +116,7 @@ DefaultResponsePort defaultResponsePort;
  */
 RequestPort::RequestPort(const std::string& name, SimObject* _owner,
     PortID _id) : Port(name, _id), _responsePort(&defaultResponsePort),
+    hostAccount(_owner ? _owner->hostTimeAccount() : nullptr),
     owner(*_owner)
 {
 }
@@ -156,7 +157,7 @@ RequestPort::getAddrRanges() const
 void
 RequestPort::printAddr(Addr a)
 {
-    auto req = std::make_shared<Request>(
+    auto req = makeRequest(
         a, 1, 0, Request::funcRequestorId);
 
     Packet pkt(req, MemCmd::PrintReq);
@@ -171,7 +172,9 @@ RequestPort::printAddr(Addr a)
  */
 ResponsePort::ResponsePort(const std::string& name, SimObject* _owner,
     PortID id) : Port(name, id), _requestPort(&defaultRequestPort),
-    defaultBackdoorWarned(false), owner(*_owner)
+    defaultBackdoorWarned(false),
+    hostAccount(_owner ? _owner->hostTimeAccount() : nullptr),
+    owner(*_owner)
 {
 }
 
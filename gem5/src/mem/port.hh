@@ -51,6 +51,7 @@
 #include "mem/protocol/atomic.hh"
 #include "mem/protocol/functional.hh"
 #include "mem/protocol/timing.hh"
+#include "sim/host_time.hh"
 #include "sim/port.hh"
 
 namespace gem5
@@ -82,6 +83,9 @@ class RequestPort: public Port, public AtomicRequestProtocol,
   private:
     ResponsePort *_responsePort;
 
+    /** Host time account of the owner, charged for timing responses. */
+    HostTimeAccount *hostAccount;
+
   protected:
     SimObject &owner;
 
@@ -275,6 +279,9 @@ class ResponsePort : public Port, public AtomicResponseProtocol,
 
     bool defaultBackdoorWarned;
 
+    /** Host time account of the owner, charged for timing requests. */
+    HostTimeAccount *hostAccount;
+
   protected:
     SimObject& owner;
 
@@ -369,6 +376,8 @@ class ResponsePort : public Port, public AtomicResponseProtocol,
     bool
     sendTimingResp(PacketPtr pkt)
     {
+        HostTimeScope host_time(_requestPort->hostAccount,
+                                &HostTimeAccount::timingResps);
         try {
             return TimingResponseProtocol::sendResp(_requestPort, pkt);
         } catch (UnboundPortException) {
@@ -494,6 +503,8 @@ RequestPort::sendFunctional(PacketPtr pkt) const
 inline bool
 RequestPort::sendTimingReq(PacketPtr pkt)
 {
+    HostTimeScope host_time(_responsePort->hostAccount,
+                            &HostTimeAccount::timingReqs);
     try {
         return TimingRequestProtocol::sendReq(_responsePort, pkt);
     } catch (UnboundPortException) {
@@ -37,6 +37,9 @@
 
 #include "mem/port_proxy.hh"
 
+#include <algorithm>
+#include <cstring>
+
 #include "base/chunk_generator.hh"
 #include "cpu/thread_context.hh"
 #include "mem/port.hh"
@@ -61,7 +64,7 @@ PortProxy::readBlobPhys(Addr addr, Request::Flags flags,
     for (ChunkGenerator gen(addr, size, _cacheLineSize); !gen.done();
          gen.next()) {
 
-        auto req = std::make_shared<Request>(
+        auto req = makeRequest(
             gen.addr(), gen.size(), flags, Request::funcRequestorId);
 
         Packet pkt(req, MemCmd::ReadReq);
@@ -78,7 +81,7 @@ PortProxy::writeBlobPhys(Addr addr, Request::Flags flags,
     for (ChunkGenerator gen(addr, size, _cacheLineSize); !gen.done();
          gen.next()) {
 
-        auto req = std::make_shared<Request>(
+        auto req = makeRequest(
             gen.addr(), gen.size(), flags, Request::funcRequestorId);
 
         Packet pkt(req, MemCmd::WriteReq);
@@ -111,16 +114,26 @@ PortProxy::tryWriteString(Addr addr, const char *str) const
     return true;
 }
 
+// Strings are read a chunk at a time rather than a byte at a time. A chunk
+// never crosses an aligned block of this size, so it is within the page and
+// usually the cache line of its first byte.
+static constexpr Addr stringChunk = 64;
+
 bool
 PortProxy::tryReadString(std::string &str, Addr addr) const
 {
     while (true) {
-        uint8_t c;
-        if (!tryReadBlob(addr++, &c, 1))
+        char buf[stringChunk];
+        Addr size = stringChunk - addr % stringChunk;
+        if (!tryReadBlob(addr, buf, size))
             return false;
-        if (!c)
+        if (auto *end = static_cast<const char *>(
+                    std::memchr(buf, 0, size))) {
+            str.append(buf, end - buf);
             return true;
-        str += c;
+        }
+        str.append(buf, size);
+        addr += size;
     }
 }
 
@@ -128,11 +141,15 @@ bool
 PortProxy::tryReadString(char *str, Addr addr, size_t maxlen) const
 {
     assert(maxlen);
-    while (maxlen--) {
-        if (!tryReadBlob(addr++, str, 1))
+    while (maxlen) {
+        Addr size = std::min<Addr>(stringChunk - addr % stringChunk, maxlen);
+        if (!tryReadBlob(addr, str, size))
             return false;
-        if (!*str++)
+        if (std::memchr(str, 0, size))
             return true;
+        str += size;
+        addr += size;
+        maxlen -= size;
     }
     // We ran out of room, so back up and add a terminator.
     *--str = '\0';
@@ -51,5 +51,25 @@ class MemTraceProbe(BaseMemProbe):
     # packet trace output file, disabled by default
     trace_file = Param.String("", "Packet trace output file")
 
+    # Write fixed size binary records instead of protobuf messages. The
+    # records are compressed and written out on a thread of their own
+    binary = Param.Bool(False, "Write binary records instead of protobuf")
+
+    # Only trace the accesses to these address ranges, and from these
+    # requestors, if any are given
+    addr_ranges = VectorParam.AddrRange([], "Address ranges to trace")
+    requestors = VectorParam.String([], "Names of the requestors to trace")
+
+    # Sampling of the accesses left after filtering. They can be sampled
+    # one in sample_every, in a window of window_length at the start of
+    # every window_period, and in a uniform sample of reservoir_size
+    # accesses written at the end of the simulation
+    sample_every = Param.Unsigned(1, "Trace one in this many accesses")
+    window_period = Param.Latency('0ns', "Period of the tracing windows, "
+                                  "0 to trace all the time")
+    window_length = Param.Latency('0ns', "Length of the tracing windows")
+    reservoir_size = Param.Unsigned(0, "Size of the uniform sample of "
+                                    "accesses, 0 to trace them as they come")
+
     # System object to look up the name associated with a requestor ID
     system = Param.System(Parent.any, "System the probe belongs to")
@@ -0,0 +1,50 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from m5.proxy import *
+from m5.objects.BaseMemProbe import BaseMemProbe
+
+class ReuseDistProbe(BaseMemProbe):
+    type = 'ReuseDistProbe'
+    cxx_header = "mem/probes/reuse_dist.hh"
+    cxx_class = 'gem5::ReuseDistProbe'
+
+    # Packet probe points to listen to on the managers, on top of the
+    # packet info one of probe_name. The default ones see every access to
+    # a BaseCache
+    packet_probe_names = VectorParam.String(["Hit", "Miss"],
+        "Probe points notifying packets to listen to")
+
+    line_size = Param.Unsigned(Parent.cache_line_size,
+                               "Cache line size in bytes")
+
+    # Lines are sampled by hashed address, and the sampling rate is
+    # lowered to track at most max_lines lines
+    sampling_rate = Param.Float(0.01, "Initial fraction of sampled lines")
+    max_lines = Param.Unsigned(8192, "Most sampled lines tracked at once")
+
+    max_pcs = Param.Unsigned(64, "PCs with a histogram of their own, "
+                             "the other ones share one")
+    dist_buckets = Param.Unsigned(24, "Logarithmic reuse distance buckets, "
+                                  "including the 0 and first access ones")
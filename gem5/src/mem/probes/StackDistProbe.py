@@ -60,3 +60,10 @@ class StackDistProbe(BaseMemProbe):
     # logarithmic histogram bins and enable/disable
     log_hist_bins = Param.Unsigned('32', "Bins in logarithmic histograms")
     disable_log_hists = Param.Bool(False, "Disable logarithmic histograms")
+
+    # LRU miss ratio curves, one per associativity, over a set of sizes
+    mrc_sizes = VectorParam.MemorySize([], "Cache sizes to compute LRU miss "
+                                       "ratios for (empty to disable)")
+    mrc_assocs = VectorParam.Unsigned([0], "Associativities to compute LRU "
+                                      "miss ratios for (0 for fully "
+                                      "associative)")
@@ -37,8 +37,12 @@
 
 #include "mem/probes/mem_trace.hh"
 
+#include <algorithm>
+
 #include "base/callback.hh"
+#include "base/logging.hh"
 #include "base/output.hh"
+#include "base/random.hh"
 #include "params/MemTraceProbe.hh"
 #include "proto/packet.pb.h"
 #include "sim/core.hh"
@@ -52,8 +56,19 @@ MemTraceProbe::MemTraceProbe(const MemTraceProbeParams &p)
     : BaseMemProbe(p),
       traceStream(nullptr),
       system(p.system),
-      withPC(p.with_pc)
+      withPC(p.with_pc),
+      addrRanges(p.addr_ranges.begin(), p.addr_ranges.end()),
+      requestorNames(p.requestors),
+      sampleEvery(p.sample_every),
+      windowPeriod(p.window_period),
+      windowLength(p.window_length),
+      reservoirSize(p.reservoir_size)
 {
+    fatal_if(sampleEvery == 0, "%s: sample_every must be at least 1",
+             name());
+    fatal_if(windowPeriod && windowLength > windowPeriod,
+             "%s: window_length is longer than window_period", name());
+
     std::string filename;
     if (p.trace_file != "") {
         // If the trace file is not specified as an absolute path,
@@ -74,7 +89,14 @@ MemTraceProbe::MemTraceProbe(const MemTraceProbeParams &p)
                                   (p.trace_compress ? ".gz" : ""));
     }
 
-    traceStream = new ProtoOutputStream(filename);
+    if (p.binary) {
+        binaryWriter.reset(new BinaryTraceWriter<Record>(filename,
+                                                       p.trace_compress));
+        buffer.reserve(BinaryTraceWriter<Record>::bufferRecords);
+    } else {
+        traceStream = new ProtoOutputStream(filename);
+    }
+    reservoir.reserve(reservoirSize);
 
     // Register a callback to compensate for the destructor not
     // being called. The callback forces the stream to flush and
@@ -82,9 +104,42 @@ MemTraceProbe::MemTraceProbe(const MemTraceProbeParams &p)
     registerExitCallback([this]() { closeStreams(); });
 }
 
+MemTraceProbe::~MemTraceProbe()
+{
+}
+
 void
 MemTraceProbe::startup()
 {
+    for (const auto &requestor : requestorNames) {
+        RequestorID id = system->lookupRequestorId(requestor);
+        fatal_if(id == Request::invldRequestorId,
+                 "%s: No requestor called %s", name(), requestor);
+        if (id >= tracedRequestors.size())
+            tracedRequestors.resize(id + 1, false);
+        tracedRequestors[id] = true;
+    }
+
+    if (binaryWriter) {
+        std::string header("g5mt");
+        auto put32 = [&header](uint32_t val) {
+            for (int i = 0; i < 4; i++)
+                header.push_back(val >> (8 * i));
+        };
+        put32(1);
+        put32(sizeof(Record));
+        put32(sim_clock::Frequency);
+        put32(sim_clock::Frequency >> 32);
+        put32(system->maxRequestors());
+        for (int i = 0; i < system->maxRequestors(); i++) {
+            std::string requestor = system->getRequestorName(i);
+            put32(requestor.size());
+            header += requestor;
+        }
+        binaryWriter->writeRaw(header.data(), header.size());
+        return;
+    }
+
     // Create a protobuf message for the header and write it to
     // the stream
     ProtoMessage::PacketHeader header_msg;
@@ -103,23 +158,96 @@ MemTraceProbe::startup()
 void
 MemTraceProbe::closeStreams()
 {
-    if (traceStream != NULL)
+    // the reservoir is only complete now
+    std::sort(reservoir.begin(), reservoir.end(),
+              [](const Record &a, const Record &b) {
+                  return a.tick < b.tick;
+              });
+    for (const auto &rec : reservoir)
+        write(rec);
+    reservoir.clear();
+
+    if (binaryWriter) {
+        if (!buffer.empty())
+            binaryWriter->queue(buffer);
+        binaryWriter.reset();
+    }
+
+    if (traceStream != NULL) {
         delete traceStream;
+        traceStream = nullptr;
+    }
 }
 
 void
 MemTraceProbe::handleRequest(const probing::PacketInfo &pkt_info)
 {
+    if (!addrRanges.empty() &&
+        std::none_of(addrRanges.begin(), addrRanges.end(),
+                     [&pkt_info](const AddrRange &r) {
+                         return r.contains(pkt_info.addr);
+                     })) {
+        return;
+    }
+
+    if (!requestorNames.empty() &&
+        (pkt_info.id >= tracedRequestors.size() ||
+         !tracedRequestors[pkt_info.id])) {
+        return;
+    }
+
+    if (windowPeriod && curTick() % windowPeriod >= windowLength)
+        return;
+
+    if (sampleEvery > 1 && sampleCount++ % sampleEvery != 0)
+        return;
+
+    Record rec;
+    rec.tick = curTick();
+    rec.addr = pkt_info.addr;
+    rec.pc = withPC ? pkt_info.pc : 0;
+    rec.flags = pkt_info.flags;
+    rec.size = pkt_info.size;
+    rec.cmd = pkt_info.cmd.toInt();
+    rec.requestor = pkt_info.id;
+
+    if (reservoirSize) {
+        // keep every access with the same probability of
+        // reservoirSize / reservoirSeen
+        reservoirSeen++;
+        if (reservoir.size() < reservoirSize) {
+            reservoir.push_back(rec);
+        } else {
+            uint64_t i = random_mt.random<uint64_t>(0, reservoirSeen - 1);
+            if (i < reservoirSize)
+                reservoir[i] = rec;
+        }
+        return;
+    }
+
+    write(rec);
+}
+
+void
+MemTraceProbe::write(const Record &rec)
+{
+    if (binaryWriter) {
+        buffer.push_back(rec);
+        if (buffer.size() == BinaryTraceWriter<Record>::bufferRecords)
+            binaryWriter->queue(buffer);
+        return;
+    }
+
     ProtoMessage::Packet pkt_msg;
 
-    pkt_msg.set_tick(curTick());
-    pkt_msg.set_cmd(pkt_info.cmd.toInt());
-    pkt_msg.set_flags(pkt_info.flags);
-    pkt_msg.set_addr(pkt_info.addr);
-    pkt_msg.set_size(pkt_info.size);
-    if (withPC && pkt_info.pc != 0)
-        pkt_msg.set_pc(pkt_info.pc);
-    pkt_msg.set_pkt_id(pkt_info.id);
+    pkt_msg.set_tick(rec.tick);
+    pkt_msg.set_cmd(rec.cmd);
+    pkt_msg.set_flags(rec.flags);
+    pkt_msg.set_addr(rec.addr);
+    pkt_msg.set_size(rec.size);
+    if (rec.pc != 0)
+        pkt_msg.set_pc(rec.pc);
+    pkt_msg.set_pkt_id(rec.requestor);
 
     traceStream->write(pkt_msg);
 }
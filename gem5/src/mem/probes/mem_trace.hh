@@ -38,6 +38,11 @@
 #ifndef __MEM_PROBES_MEM_TRACE_HH__
 #define __MEM_PROBES_MEM_TRACE_HH__
 
+#include <memory>
+#include <vector>
+
+#include "base/addr_range.hh"
+#include "base/binary_trace_writer.hh"
 #include "mem/packet.hh"
 #include "mem/probes/base.hh"
 #include "proto/protoio.hh"
@@ -48,10 +53,36 @@ namespace gem5
 struct MemTraceProbeParams;
 class System;
 
+/**
+ * Trace the packets seen by a probe point, either as protobuf messages or
+ * as fixed size binary records. The accesses can be filtered by address
+ * range and requestor, and sampled one in N, in periodic time windows or
+ * into a fixed size uniform reservoir, to keep the cost of leaving the
+ * probe attached in long runs low.
+ */
 class MemTraceProbe : public BaseMemProbe
 {
   public:
     MemTraceProbe(const MemTraceProbeParams &params);
+    ~MemTraceProbe();
+
+    /**
+     * A record of the binary format. The file starts with the magic
+     * "g5mt", the version, the record size, the tick frequency and the
+     * requestor names, each as a 32 bit length and the characters, all
+     * little endian, followed by the records.
+     */
+    struct Record
+    {
+        uint64_t tick;
+        uint64_t addr;
+        uint64_t pc;
+        uint64_t flags;
+        uint32_t size;
+        uint16_t cmd;
+        uint16_t requestor;
+    };
+    static_assert(sizeof(Record) == 40, "Unexpected binary record size");
 
   protected:
     void handleRequest(const probing::PacketInfo &pkt_info) override;
@@ -75,6 +106,38 @@ class MemTraceProbe : public BaseMemProbe
 
     /** Include the Program Counter in the memory trace */
     const bool withPC;
+
+    /** Only trace the accesses to these ranges, if there are any */
+    const AddrRangeList addrRanges;
+    /** Names of the only requestors to trace, if there are any */
+    const std::vector<std::string> requestorNames;
+    /** The requestors to trace by id, set up from their names */
+    std::vector<bool> tracedRequestors;
+
+    /** Trace one in sampleEvery of the accesses left after filtering */
+    const unsigned sampleEvery;
+    uint64_t sampleCount = 0;
+
+    /** Only trace the first windowLength ticks of every windowPeriod */
+    const Tick windowPeriod;
+    const Tick windowLength;
+
+    /**
+     * A uniform sample of reservoirSize of the accesses which got that
+     * far, written in tick order at the end of the simulation.
+     */
+    const unsigned reservoirSize;
+    std::vector<Record> reservoir;
+    uint64_t reservoirSeen = 0;
+
+    void write(const Record &rec);
+
+    /**
+     * In the binary format, records are accumulated in a buffer which is
+     * handed to a thread compressing and writing it out once full.
+     */
+    std::unique_ptr<BinaryTraceWriter<Record>> binaryWriter;
+    std::vector<Record> buffer;
 };
 
 } // namespace gem5
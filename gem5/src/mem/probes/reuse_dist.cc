@@ -0,0 +1,193 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/probes/reuse_dist.hh"
+
+#include <algorithm>
+#include <iterator>
+
+#include "base/cprintf.hh"
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "params/ReuseDistProbe.hh"
+
+namespace gem5
+{
+
+ReuseDistProbe::ReuseDistProbe(const ReuseDistProbeParams &p)
+    : BaseMemProbe(p),
+      lineSize(p.line_size),
+      maxPcs(p.max_pcs),
+      maxLines(p.max_lines),
+      numBuckets(p.dist_buckets),
+      threshold(std::min<uint64_t>(
+                  p.sampling_rate * (1ULL << hashBits), 1ULL << hashBits)),
+      stats(this)
+{
+    fatal_if(!isPowerOf2(lineSize), "%s: line_size must be a power of 2",
+             name());
+    fatal_if(threshold == 0, "%s: sampling_rate is too low, no line would "
+             "be sampled", name());
+    fatal_if(maxLines == 0, "%s: max_lines must be at least 1", name());
+    fatal_if(numBuckets < 3, "%s: dist_buckets must be at least 3",
+             name());
+
+    stats.samplingRate = (double)threshold / (1ULL << hashBits);
+}
+
+void
+ReuseDistProbe::regProbeListeners()
+{
+    BaseMemProbe::regProbeListeners();
+
+    const ReuseDistProbeParams &p =
+        dynamic_cast<const ReuseDistProbeParams &>(params());
+
+    for (auto manager : p.manager) {
+        for (const auto &point : p.packet_probe_names) {
+            packetListeners.emplace_back(new PacketPtrListener(
+                        *this, manager->getProbeManager(), point));
+        }
+    }
+}
+
+int
+ReuseDistProbe::pcSlot(Addr pc)
+{
+    auto it = pcSlots.find(pc);
+    if (it != pcSlots.end())
+        return it->second;
+    if (slotPcs.size() == maxPcs)
+        return maxPcs;
+
+    int slot = slotPcs.size();
+    slotPcs.push_back(pc);
+    pcSlots.emplace(pc, slot);
+    stats.pcs[slot] = pc;
+    return slot;
+}
+
+void
+ReuseDistProbe::shrinkSample()
+{
+    while (trackedLines.size() > maxLines) {
+        threshold = std::prev(trackedLines.end())->first;
+        while (!trackedLines.empty() &&
+               std::prev(trackedLines.end())->first >= threshold) {
+            auto last = std::prev(trackedLines.end());
+            calc.calcStackDistAndUpdate(last->second, false);
+            trackedLines.erase(last);
+        }
+    }
+    stats.samplingRate = (double)threshold / (1ULL << hashBits);
+}
+
+void
+ReuseDistProbe::handleRequest(const probing::PacketInfo &pkt_info)
+{
+    // writebacks and evictions are not reuses by the program
+    if (!pkt_info.cmd.isRequest() || pkt_info.cmd.isEviction())
+        return;
+
+    const Addr line = pkt_info.addr / lineSize;
+    const uint64_t hash = lineHash(line);
+    if (hash >= threshold)
+        return;
+
+    stats.sampledAccesses++;
+    const int slot = pcSlot(pkt_info.pc);
+
+    const uint64_t sd = calc.calcStackDistAndUpdate(line).first;
+    int bucket;
+    if (sd == StackDistCalc::Infinity) {
+        bucket = numBuckets - 1;
+        trackedLines.emplace(hash, line);
+        if (trackedLines.size() > maxLines)
+            shrinkSample();
+    } else {
+        // only a fraction threshold / 2^hashBits of the lines is
+        // tracked, scale the distance among them back up
+        const uint64_t dist = (sd << hashBits) / threshold;
+        bucket = dist ? std::min<int>(floorLog2(dist) + 1, numBuckets - 2)
+                      : 0;
+    }
+    stats.reuseDist[slot][bucket]++;
+}
+
+ReuseDistProbe::ReuseDistProbeStats::ReuseDistProbeStats(
+    ReuseDistProbe *parent)
+    : statistics::Group(parent),
+      probe(*parent),
+      ADD_STAT(sampledAccesses, statistics::units::Count::get(),
+               "Number of sampled accesses"),
+      ADD_STAT(samplingRate, statistics::units::Ratio::get(),
+               "Fraction of the lines sampled"),
+      ADD_STAT(pcs, statistics::units::Count::get(),
+               "PC of each reuse distance histogram"),
+      ADD_STAT(reuseDist, statistics::units::Count::get(),
+               "Sampled accesses per PC and reuse distance in lines")
+{
+    using namespace statistics;
+
+    const ReuseDistProbeParams &p =
+        dynamic_cast<const ReuseDistProbeParams &>(parent->params());
+
+    pcs
+        .init(p.max_pcs + 1)
+        .flags(nozero);
+
+    reuseDist
+        .init(p.max_pcs + 1, p.dist_buckets)
+        .flags(total | nozero | nonan);
+
+    for (int i = 0; i < p.max_pcs; i++) {
+        pcs.subname(i, csprintf("pc%d", i));
+        reuseDist.subname(i, csprintf("pc%d", i));
+    }
+    pcs.subname(p.max_pcs, "other");
+    reuseDist.subname(p.max_pcs, "other");
+
+    reuseDist.ysubname(0, "0");
+    for (int i = 1; i < p.dist_buckets - 1; i++) {
+        if (i == p.dist_buckets - 2)
+            reuseDist.ysubname(i, csprintf("%d-inf", 1ULL << (i - 1)));
+        else
+            reuseDist.ysubname(i, csprintf("%d-%d", 1ULL << (i - 1),
+                                           (1ULL << i) - 1));
+    }
+    reuseDist.ysubname(p.dist_buckets - 1, "cold");
+}
+
+void
+ReuseDistProbe::ReuseDistProbeStats::resetStats()
+{
+    statistics::Group::resetStats();
+
+    for (int i = 0; i < probe.slotPcs.size(); i++)
+        pcs[i] = probe.slotPcs[i];
+    samplingRate = (double)probe.threshold / (1ULL << hashBits);
+}
+
+} // namespace gem5
@@ -0,0 +1,148 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_PROBES_REUSE_DIST_HH__
+#define __MEM_PROBES_REUSE_DIST_HH__
+
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "mem/packet.hh"
+#include "mem/probes/base.hh"
+#include "mem/stack_dist_calc.hh"
+#include "sim/probe/probe.hh"
+#include "sim/stats.hh"
+
+namespace gem5
+{
+
+struct ReuseDistProbeParams;
+
+/**
+ * Probe keeping a histogram of the reuse distances of the accesses of
+ * each PC, to find the loads whose lines are accessed again too late to
+ * stay in a cache.
+ *
+ * Only the lines whose hashed address falls below a threshold are
+ * tracked, as in SHARDS, and their stack distances among themselves are
+ * scaled up by the inverse of the sampling rate. When more than maxLines
+ * lines are tracked, the threshold is lowered down to the hash of the
+ * highest tracked line, which is then dropped, so that the memory used is
+ * bounded whatever the footprint. The first maxPcs PCs seen get a
+ * histogram of their own, the other ones share a last one.
+ *
+ * Besides the packet info probe points of BaseMemProbe, the probe can
+ * listen to the packet probe points of a BaseCache, e.g. Hit and Miss.
+ */
+class ReuseDistProbe : public BaseMemProbe
+{
+  public:
+    ReuseDistProbe(const ReuseDistProbeParams &params);
+
+    void regProbeListeners() override;
+
+  protected:
+    void handleRequest(const probing::PacketInfo &pkt_info) override;
+
+    /** The line address hash space is [0, 2^hashBits) */
+    static const int hashBits = 24;
+
+    uint64_t
+    lineHash(Addr line) const
+    {
+        return (line * 0x9e3779b97f4a7c15ULL) >> (64 - hashBits);
+    }
+
+    /** The histogram slot of a PC, allocating one if there is room. */
+    int pcSlot(Addr pc);
+
+    /** Lower the threshold until at most maxLines lines are tracked. */
+    void shrinkSample();
+
+    const unsigned lineSize;
+    const unsigned maxPcs;
+    const unsigned maxLines;
+    const unsigned numBuckets;
+
+    /** Lines with a hash below the threshold are sampled. */
+    uint64_t threshold;
+
+    /** The tracked lines, ordered by hash to drop the highest ones. */
+    std::set<std::pair<uint64_t, Addr>> trackedLines;
+    StackDistCalc calc;
+
+    std::unordered_map<Addr, int> pcSlots;
+    std::vector<Addr> slotPcs;
+
+    /** Listener of the probe points notifying packets, as in caches */
+    class PacketPtrListener : public ProbeListenerArgBase<PacketPtr>
+    {
+      public:
+        PacketPtrListener(ReuseDistProbe &_parent, ProbeManager *pm,
+                          const std::string &name)
+            : ProbeListenerArgBase(pm, name), parent(_parent)
+        {}
+
+        void
+        notify(const PacketPtr &pkt) override
+        {
+            parent.handleRequest(probing::PacketInfo(pkt));
+        }
+
+      protected:
+        ReuseDistProbe &parent;
+    };
+
+    std::vector<std::unique_ptr<PacketPtrListener>> packetListeners;
+
+    struct ReuseDistProbeStats : public statistics::Group
+    {
+        ReuseDistProbeStats(ReuseDistProbe *parent);
+
+        /** The PCs are values, not counters, keep them across resets. */
+        void resetStats() override;
+
+        ReuseDistProbe &probe;
+
+        /** Sampled accesses */
+        statistics::Scalar sampledAccesses;
+        /** Fraction of the lines currently sampled */
+        statistics::Scalar samplingRate;
+        /** The PC of every histogram, the last one is for the others */
+        statistics::Vector pcs;
+        /**
+         * Sampled accesses of each PC per reuse distance in lines: 0,
+         * then [2^(i-1), 2^i) for bucket i, then first accesses.
+         */
+        statistics::Vector2d reuseDist;
+    } stats;
+};
+
+} // namespace gem5
+
+#endif //__MEM_PROBES_REUSE_DIST_HH__
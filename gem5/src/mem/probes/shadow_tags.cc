@@ -0,0 +1,126 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/probes/shadow_tags.hh"
+
+#include "base/cprintf.hh"
+#include "base/logging.hh"
+#include "mem/cache/cache_blk.hh"
+#include "mem/cache/tags/base.hh"
+#include "params/ShadowTagsProbe.hh"
+#include "sim/system.hh"
+
+namespace gem5
+{
+
+ShadowTagsProbe::ShadowTagsProbe(const ShadowTagsProbeParams &p)
+    : SimObject(p),
+      manager(p.manager),
+      tags(p.tags)
+{
+    fatal_if(tags.empty(), "%s: ShadowTagsProbe needs at least one shadow.",
+             name());
+
+    for (int i = 0; i < tags.size(); i++) {
+        // Requests are at most one system cache line long, so they cannot
+        // span several blocks of the shadow
+        fatal_if(tags[i]->getBlockSize() < p.system->cacheLineSize(),
+                 "%s: shadow %s has blocks smaller than the system's "
+                 "cache line.", name(), tags[i]->name());
+
+        // The tags are not owned by a cache, so initialize them here
+        tags[i]->tagsInit();
+        stats.emplace_back(new ShadowStats(this, i));
+    }
+}
+
+void
+ShadowTagsProbe::regProbeListeners()
+{
+    ProbeManager *const mgr(manager->getProbeManager());
+    listeners.emplace_back(new PacketListener(*this, mgr, "Hit"));
+    listeners.emplace_back(new PacketListener(*this, mgr, "Miss"));
+}
+
+void
+ShadowTagsProbe::handleRequest(const PacketPtr &pkt)
+{
+    // Only consider requests that a cache would look up in its tags
+    if (pkt->req->isUncacheable() || pkt->req->isCacheMaintenance() ||
+        pkt->cmd == MemCmd::CleanEvict) {
+        return;
+    }
+
+    // Writebacks from the level above allocate on a miss, but are not
+    // accounted as accesses
+    const bool demand = !pkt->isEviction();
+
+    for (int i = 0; i < tags.size(); i++) {
+        BaseTags *const shadow = tags[i];
+        ShadowStats &shadow_stats = *stats[i];
+
+        Cycles lat;
+        if (shadow->accessBlock(pkt, lat)) {
+            if (demand)
+                shadow_stats.hits++;
+            continue;
+        }
+
+        if (demand)
+            shadow_stats.misses++;
+
+        std::vector<CacheBlk*> evict_blks;
+        CacheBlk *victim = shadow->findVictim(pkt->getAddr(),
+            pkt->isSecure(), shadow->getBlockSize() * 8, evict_blks, pkt);
+        if (!victim)
+            continue;
+
+        for (auto blk : evict_blks) {
+            if (blk->isValid()) {
+                shadow_stats.evictions++;
+                shadow->invalidate(blk);
+            }
+        }
+
+        shadow->insertBlock(pkt, victim);
+    }
+}
+
+ShadowTagsProbe::ShadowStats::ShadowStats(ShadowTagsProbe *parent,
+                                          int index)
+    : statistics::Group(parent, csprintf("shadow%d", index).c_str()),
+      ADD_STAT(hits, statistics::units::Count::get(),
+               "Number of requests that hit in the shadow tags"),
+      ADD_STAT(misses, statistics::units::Count::get(),
+               "Number of requests that missed in the shadow tags"),
+      ADD_STAT(evictions, statistics::units::Count::get(),
+               "Number of valid blocks replaced in the shadow tags"),
+      ADD_STAT(missRate, statistics::units::Ratio::get(),
+               "Miss rate of the shadow tags", misses / (hits + misses))
+{
+    missRate.flags(statistics::nonan);
+}
+
+} // namespace gem5
@@ -0,0 +1,112 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_PROBES_SHADOW_TAGS_HH__
+#define __MEM_PROBES_SHADOW_TAGS_HH__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "mem/packet.hh"
+#include "sim/probe/probe.hh"
+#include "sim/sim_object.hh"
+
+namespace gem5
+{
+
+class BaseTags;
+struct ShadowTagsProbeParams;
+
+/**
+ * Replays the request stream seen by a cache on a set of shadow tag
+ * stores. The shadows only hold tags and replacement state, so a single
+ * simulation can evaluate several geometries and replacement policies
+ * for the same cache. Each shadow keeps its own hit, miss and eviction
+ * statistics.
+ *
+ * The probe listens to the "Hit" and "Miss" probe points of its
+ * manager, i.e., to every request the cache receives on its CPU side
+ * port in timing mode. The shadows are updated instantly and model
+ * neither MSHRs nor writebacks to the next level. As they never disturb
+ * the simulated cache, the stream they see is the one produced by the
+ * cache configuration actually simulated.
+ */
+class ShadowTagsProbe : public SimObject
+{
+  public:
+    ShadowTagsProbe(const ShadowTagsProbeParams &p);
+
+    void regProbeListeners() override;
+
+  protected:
+    /** Look up a request in every shadow and update it. */
+    void handleRequest(const PacketPtr &pkt);
+
+    struct ShadowStats : public statistics::Group
+    {
+        ShadowStats(ShadowTagsProbe *parent, int index);
+
+        /** Requests that found their block in the shadow */
+        statistics::Scalar hits;
+        /** Requests that had to allocate a block in the shadow */
+        statistics::Scalar misses;
+        /** Valid blocks replaced to make room for a miss */
+        statistics::Scalar evictions;
+        /** Fraction of the requests that missed */
+        statistics::Formula missRate;
+    };
+
+    /** The cache whose requests are replayed */
+    SimObject *manager;
+
+    /** The shadow tag stores */
+    std::vector<BaseTags *> tags;
+
+    std::vector<std::unique_ptr<ShadowStats>> stats;
+
+    class PacketListener : public ProbeListenerArgBase<PacketPtr>
+    {
+      public:
+        PacketListener(ShadowTagsProbe &_parent, ProbeManager *pm,
+                       const std::string &name)
+            : ProbeListenerArgBase(pm, name), parent(_parent) {}
+
+        void notify(const PacketPtr &pkt) override
+        {
+            parent.handleRequest(pkt);
+        }
+
+      protected:
+        ShadowTagsProbe &parent;
+    };
+
+    std::vector<std::unique_ptr<PacketListener>> listeners;
+};
+
+} // namespace gem5
+
+#endif //__MEM_PROBES_SHADOW_TAGS_HH__
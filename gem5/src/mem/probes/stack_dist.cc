@@ -37,23 +37,87 @@
 
 #include "mem/probes/stack_dist.hh"
 
+#include <algorithm>
+#include <map>
+
+#include "base/cprintf.hh"
+#include "base/intmath.hh"
 #include "params/StackDistProbe.hh"
 #include "sim/system.hh"
 
 namespace gem5
 {
 
+namespace
+{
+
+std::vector<uint64_t>
+sizesInLines(const std::vector<uint64_t> &sizes, unsigned line_size)
+{
+    std::vector<uint64_t> lines;
+    for (auto size : sizes)
+        lines.push_back(size / line_size);
+    return lines;
+}
+
+std::string
+sizeName(uint64_t bytes)
+{
+    if (bytes % (1 << 20) == 0)
+        return csprintf("%dMiB", bytes >> 20);
+    else if (bytes % (1 << 10) == 0)
+        return csprintf("%dKiB", bytes >> 10);
+    else
+        return csprintf("%dB", bytes);
+}
+
+} // anonymous namespace
+
 StackDistProbe::StackDistProbe(const StackDistProbeParams &p)
     : BaseMemProbe(p),
       lineSize(p.line_size),
       disableLinearHists(p.disable_linear_hists),
       disableLogHists(p.disable_log_hists),
+      mrcLines(sizesInLines(p.mrc_sizes, p.line_size)),
       calc(p.verify),
       stats(this)
 {
     fatal_if(p.system->cacheLineSize() > p.line_size,
              "The stack distance probe must use a cache line size that is "
              "larger or equal to the system's cahce line size.");
+
+    if (mrcLines.empty())
+        return;
+
+    // Set associative curves need one truncated stack per number of
+    // sets, as deep as the largest associativity using it
+    std::map<uint64_t, unsigned> depths;
+    for (auto assoc : p.mrc_assocs) {
+        if (assoc == 0)
+            continue;
+        for (auto lines : mrcLines) {
+            fatal_if(lines % assoc != 0 || !isPowerOf2(lines / assoc),
+                     "%s: a %d-way cache of %d lines does not have a power "
+                     "of two number of sets.", name(), assoc, lines);
+            unsigned &depth = depths[lines / assoc];
+            depth = std::max(depth, assoc);
+        }
+    }
+
+    std::map<uint64_t, int> stack_ids;
+    for (const auto &num_sets_depth : depths) {
+        stack_ids[num_sets_depth.first] = setStacks.size();
+        setStacks.emplace_back(num_sets_depth.first, num_sets_depth.second);
+    }
+    setStackDists.resize(setStacks.size());
+
+    for (auto assoc : p.mrc_assocs) {
+        curves.emplace_back(new MissRatioCurve(this, assoc));
+        if (assoc == 0)
+            continue;
+        for (auto lines : mrcLines)
+            curves.back()->stacks.push_back(stack_ids[lines / assoc]);
+    }
 }
 
 StackDistProbe::StackDistProbeStats::StackDistProbeStats(
@@ -68,7 +132,9 @@ StackDistProbe::StackDistProbeStats::StackDistProbeStats(
       ADD_STAT(writeLogHist, statistics::units::Ratio::get(),
                "Writes logarithmic distribution"),
       ADD_STAT(infiniteSD, statistics::units::Count::get(),
-               "Number of requests with infinite stack distance")
+               "Number of requests with infinite stack distance"),
+      ADD_STAT(mrcAccesses, statistics::units::Count::get(),
+               "Number of requests accounted in the miss ratio curves")
 {
     using namespace statistics;
 
@@ -93,6 +159,77 @@ StackDistProbe::StackDistProbeStats::StackDistProbeStats(
 
     infiniteSD
         .flags(nozero);
+
+    mrcAccesses
+        .flags(nozero);
+}
+
+StackDistProbe::SetStacks::SetStacks(unsigned num_sets, unsigned _depth)
+    : setMask(num_sets - 1), depth(_depth),
+      lines(num_sets * _depth, MaxAddr)
+{
+}
+
+unsigned
+StackDistProbe::SetStacks::access(Addr line_addr)
+{
+    Addr *const set = &lines[(line_addr & setMask) * depth];
+
+    unsigned pos = 0;
+    while (pos < depth && set[pos] != line_addr)
+        ++pos;
+
+    // Push the more recent lines down; a line that was not found pushes
+    // the least recent one out of the stack
+    for (unsigned i = std::min(pos, depth - 1); i > 0; --i)
+        set[i] = set[i - 1];
+    set[0] = line_addr;
+
+    return pos;
+}
+
+StackDistProbe::MissRatioCurve::MissRatioCurve(StackDistProbe *parent,
+                                               unsigned _assoc)
+    : statistics::Group(parent, _assoc == 0 ? "mrcFullAssoc" :
+                        csprintf("mrcAssoc%d", _assoc).c_str()),
+      assoc(_assoc),
+      ADD_STAT(misses, statistics::units::Count::get(),
+               "LRU misses for each cache size"),
+      ADD_STAT(missRatio, statistics::units::Ratio::get(),
+               "LRU miss ratio for each cache size",
+               misses / parent->stats.mrcAccesses)
+{
+    misses.init(parent->mrcLines.size());
+    for (int i = 0; i < parent->mrcLines.size(); i++) {
+        const std::string size_name(
+            sizeName(parent->mrcLines[i] * parent->lineSize));
+        misses.subname(i, size_name);
+        missRatio.subname(i, size_name);
+    }
+
+    missRatio.flags(statistics::nonan);
+}
+
+void
+StackDistProbe::updateMissRatioCurves(Addr line_addr, uint64_t sd)
+{
+    stats.mrcAccesses++;
+
+    for (int i = 0; i < setStacks.size(); i++)
+        setStackDists[i] = setStacks[i].access(line_addr);
+
+    for (auto &curve : curves) {
+        for (int i = 0; i < mrcLines.size(); i++) {
+            // A fully associative cache of N lines misses when more than
+            // N - 1 other lines were used since the last access, a set
+            // associative one when it happens within the set
+            const bool miss = curve->assoc == 0 ?
+                sd >= mrcLines[i] :
+                setStackDists[curve->stacks[i]] >= curve->assoc;
+            if (miss)
+                curve->misses[i]++;
+        }
+    }
 }
 
 void
@@ -108,6 +245,9 @@ StackDistProbe::handleRequest(const probing::PacketInfo &pkt_info)
 
     // Calculate the stack distance
     const uint64_t sd(calc.calcStackDistAndUpdate(aligned_addr).first);
+    if (!curves.empty())
+        updateMissRatioCurves(aligned_addr / lineSize, sd);
+
     if (sd == StackDistCalc::Infinity) {
         stats.infiniteSD++;
         return;
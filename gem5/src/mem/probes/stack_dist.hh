@@ -38,6 +38,9 @@
 #ifndef __MEM_PROBES_STACK_DIST_HH__
 #define __MEM_PROBES_STACK_DIST_HH__
 
+#include <memory>
+#include <vector>
+
 #include "mem/packet.hh"
 #include "mem/probes/base.hh"
 #include "mem/stack_dist_calc.hh"
@@ -56,6 +59,14 @@ class StackDistProbe : public BaseMemProbe
   protected:
     void handleRequest(const probing::PacketInfo &pkt_info) override;
 
+    /**
+     * Count the misses of the given line in all miss ratio curves.
+     *
+     * @param line_addr The line address of the request
+     * @param sd Its fully associative stack distance
+     */
+    void updateMissRatioCurves(Addr line_addr, uint64_t sd);
+
   protected:
     // Cache line size to simulate
     const unsigned lineSize;
@@ -66,6 +77,9 @@ class StackDistProbe : public BaseMemProbe
     // Disable the logarithmic histograms
     const bool disableLogHists;
 
+    // Cache sizes of the miss ratio curves, in lines
+    const std::vector<uint64_t> mrcLines;
+
   protected:
     StackDistCalc calc;
 
@@ -87,7 +101,62 @@ class StackDistProbe : public BaseMemProbe
 
         // Writes logarithmic histogram
         statistics::Scalar infiniteSD;
+
+        // Requests accounted in the miss ratio curves
+        statistics::Scalar mrcAccesses;
     } stats;
+
+    /**
+     * Truncated LRU stacks of all the sets of a set associative cache.
+     * Only the stack distances below the depth, i.e., the largest
+     * associativity looked at for this number of sets, are needed.
+     */
+    struct SetStacks
+    {
+        SetStacks(unsigned num_sets, unsigned _depth);
+
+        /**
+         * Move a line to the top of its set's stack.
+         *
+         * @param line_addr The line address
+         * @return The stack distance of the line in its set, or the
+         *         depth if it is not in the truncated stack.
+         */
+        unsigned access(Addr line_addr);
+
+        const Addr setMask;
+        const unsigned depth;
+
+        // Lines of each set, most recent first
+        std::vector<Addr> lines;
+    };
+
+    /**
+     * Miss ratio curve of one associativity over the configured sizes.
+     */
+    struct MissRatioCurve : public statistics::Group
+    {
+        MissRatioCurve(StackDistProbe *parent, unsigned assoc);
+
+        // Associativity, 0 for fully associative
+        const unsigned assoc;
+
+        // Truncated stacks used for each size
+        std::vector<int> stacks;
+
+        // Misses for each size
+        statistics::Vector misses;
+
+        // Miss ratio for each size
+        statistics::Formula missRatio;
+    };
+
+    std::vector<SetStacks> setStacks;
+
+    std::vector<std::unique_ptr<MissRatioCurve>> curves;
+
+    // Scratch stack distance of each set stack for the current request
+    std::vector<unsigned> setStackDists;
 };
 
 } // namespace gem5
@@ -59,6 +59,7 @@
 #include "base/amo.hh"
 #include "base/compiler.hh"
 #include "base/flags.hh"
+#include "base/pool_allocator.hh"
 #include "base/types.hh"
 #include "cpu/inst_seq.hh"
 #include "mem/htm.hh"
@@ -94,6 +95,14 @@ class ThreadContext;
 typedef std::shared_ptr<Request> RequestPtr;
 typedef uint16_t RequestorID;
 
+/**
+ * Create a new Request. This should be used instead of
+ * std::make_shared<Request>, as the request and its reference count are
+ * allocated from a per-thread pool rather than the system allocator.
+ */
+template <typename... Args>
+RequestPtr makeRequest(Args&&... args);
+
 class Request
 {
   public:
@@ -191,6 +200,11 @@ class Request
         INVALIDATE                  = 0x0000000100000000,
         /** The request cleans a memory location */
         CLEAN                       = 0x0000000200000000,
+        /**
+         * The request only warms up the caches, which skip their stats
+         * and latencies for it, see BaseCache::recvAtomic().
+         */
+        WARMUP                      = 0x0000000400000000,
 
         /** The request targets the point of unification */
         DST_POU                     = 0x0000001000000000,
@@ -572,8 +586,8 @@ class Request
         assert(hasVaddr());
         assert(!hasPaddr());
         assert(split_addr > _vaddr && split_addr < _vaddr + _size);
-        req1 = std::make_shared<Request>(*this);
-        req2 = std::make_shared<Request>(*this);
+        req1 = makeRequest(*this);
+        req2 = makeRequest(*this);
         req1->_size = split_addr - _vaddr;
         req2->_vaddr = split_addr;
         req2->_size = _size - req1->_size;
@@ -959,6 +973,7 @@ class Request
     }
     bool isSecure() const { return _flags.isSet(SECURE); }
     bool isPTWalk() const { return _flags.isSet(PT_WALK); }
+    bool isWarmup() const { return _flags.isSet(WARMUP); }
     bool isRelease() const { return _flags.isSet(RELEASE); }
     bool isKernel() const { return _flags.isSet(KERNEL); }
     bool isAtomicReturn() const { return _flags.isSet(ATOMIC_RETURN_OP); }
@@ -1026,6 +1041,14 @@ class Request
     /** @} */
 };
 
+template <typename... Args>
+inline RequestPtr
+makeRequest(Args&&... args)
+{
+    return std::allocate_shared<Request>(PoolAllocator<Request>(),
+                                         std::forward<Args>(args)...);
+}
+
 } // namespace gem5
 
 #endif // __MEM_REQUEST_HH__
@@ -0,0 +1,280 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_COMMON_ADDRMAP_HH__
+#define __MEM_RUBY_COMMON_ADDRMAP_HH__
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "base/intmath.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+
+namespace ruby
+{
+
+/**
+ * A map from addresses to values for the small tables of in-flight
+ * transactions of Ruby (outstanding requests, TBEs). The values live in
+ * a pool allocated up front for the expected number of entries and never
+ * move, so a reference to a value stays valid until it is erased, even
+ * if other addresses are inserted in the meantime. The addresses are
+ * found through an open addressed index at most half full, with linear
+ * probing and backward shift deletion. Inserting and erasing an entry do
+ * not allocate memory unless the map grows past its initial capacity.
+ */
+template <class VALUE>
+class AddrMap
+{
+  public:
+    typedef std::pair<Addr, VALUE> Entry;
+
+  private:
+    struct Slot
+    {
+        Entry entry;
+        bool used = false;
+    };
+
+    typedef std::deque<Slot> Pool;
+
+    template <class ENTRY, class POOL_ITERATOR>
+    class IteratorBase
+    {
+      public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef ENTRY value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef ENTRY *pointer;
+        typedef ENTRY &reference;
+
+        IteratorBase(POOL_ITERATOR _it, POOL_ITERATOR _end)
+            : it(_it), end(_end)
+        {
+            skipUnused();
+        }
+
+        reference operator*() const { return it->entry; }
+        pointer operator->() const { return &it->entry; }
+
+        IteratorBase &
+        operator++()
+        {
+            ++it;
+            skipUnused();
+            return *this;
+        }
+
+        bool operator==(const IteratorBase &o) const { return it == o.it; }
+        bool operator!=(const IteratorBase &o) const { return it != o.it; }
+
+      private:
+        void
+        skipUnused()
+        {
+            while (it != end && !it->used)
+                ++it;
+        }
+
+        POOL_ITERATOR it;
+        POOL_ITERATOR end;
+    };
+
+  public:
+    typedef IteratorBase<Entry, typename Pool::iterator> iterator;
+    typedef IteratorBase<const Entry,
+                         typename Pool::const_iterator> const_iterator;
+
+    /**
+     * @param capacity Number of entries to allocate storage for.
+     */
+    AddrMap(int capacity)
+    {
+        grow(std::max(capacity, 1));
+    }
+
+    int size() const { return numUsed; }
+    bool empty() const { return numUsed == 0; }
+
+    /** The value of an address, or nullptr if it is not in the map. */
+    VALUE *
+    find(Addr addr)
+    {
+        int pos = findPos(addr);
+        return pos < 0 ? nullptr : &pool[index[pos]].entry.second;
+    }
+
+    const VALUE *
+    find(Addr addr) const
+    {
+        int pos = findPos(addr);
+        return pos < 0 ? nullptr : &pool[index[pos]].entry.second;
+    }
+
+    bool count(Addr addr) const { return findPos(addr) >= 0; }
+
+    /**
+     * The value of an address. If the address is not in the map, it is
+     * inserted with a value copied from a default constructed VALUE
+     * kept for the purpose, which does not allocate anything for the
+     * values (e.g. a DataBlock) that only copy into their own storage.
+     */
+    VALUE &
+    operator[](Addr addr)
+    {
+        VALUE *value = find(addr);
+        if (value)
+            return *value;
+
+        if (freeSlots.empty())
+            grow(pool.size());
+        int s = freeSlots.back();
+        freeSlots.pop_back();
+
+        Slot &slot = pool[s];
+        assert(!slot.used);
+        slot.used = true;
+        slot.entry.first = addr;
+        slot.entry.second = defaultValue;
+        numUsed++;
+
+        int pos = home(addr);
+        while (index[pos] != -1)
+            pos = (pos + 1) & indexMask;
+        index[pos] = s;
+
+        return slot.entry.second;
+    }
+
+    /** Remove an address from the map, return the number of removed. */
+    int
+    erase(Addr addr)
+    {
+        int pos = findPos(addr);
+        if (pos < 0)
+            return 0;
+
+        int s = index[pos];
+        pool[s].used = false;
+        freeSlots.push_back(s);
+        numUsed--;
+
+        // shift back the entries that probed past the freed position,
+        // so that a search never needs to go past an empty position
+        int hole = pos;
+        for (int next = (pos + 1) & indexMask; index[next] != -1;
+             next = (next + 1) & indexMask) {
+            int want = home(pool[index[next]].entry.first);
+            if (((next - want) & indexMask) >= ((next - hole) & indexMask)) {
+                index[hole] = index[next];
+                hole = next;
+            }
+        }
+        index[hole] = -1;
+
+        return 1;
+    }
+
+    iterator begin() { return iterator(pool.begin(), pool.end()); }
+    iterator end() { return iterator(pool.end(), pool.end()); }
+
+    const_iterator
+    begin() const
+    {
+        return const_iterator(pool.begin(), pool.end());
+    }
+
+    const_iterator
+    end() const
+    {
+        return const_iterator(pool.end(), pool.end());
+    }
+
+  private:
+    int
+    home(Addr addr) const
+    {
+        // Fibonacci hashing, the low bits of line addresses are all zeros
+        return (addr * 0x9e3779b97f4a7c15ULL) >> (64 - indexBits);
+    }
+
+    int
+    findPos(Addr addr) const
+    {
+        for (int pos = home(addr); index[pos] != -1;
+             pos = (pos + 1) & indexMask) {
+            if (pool[index[pos]].entry.first == addr)
+                return pos;
+        }
+        return -1;
+    }
+
+    /** Add storage for n more values and rebuild the index. */
+    void
+    grow(int n)
+    {
+        int first = pool.size();
+        int total = first + n;
+        pool.resize(total);
+        freeSlots.reserve(total);
+        for (int s = total - 1; s >= first; s--)
+            freeSlots.push_back(s);
+
+        indexBits = std::max(ceilLog2(2 * total), 1);
+        indexMask = (1 << indexBits) - 1;
+        index.assign(1 << indexBits, -1);
+        for (int s = 0; s < total; s++) {
+            if (!pool[s].used)
+                continue;
+            int pos = home(pool[s].entry.first);
+            while (index[pos] != -1)
+                pos = (pos + 1) & indexMask;
+            index[pos] = s;
+        }
+    }
+
+    /** Value storage, a deque so that growing does not move values. */
+    Pool pool;
+    std::vector<int> freeSlots;
+    /** Pool slot of each position of the index, -1 if empty. */
+    std::vector<int> index;
+    int indexBits = 0;
+    int indexMask = 0;
+    int numUsed = 0;
+    const VALUE defaultValue = VALUE();
+};
+
+} // namespace ruby
+} // namespace gem5
+
+#endif // __MEM_RUBY_COMMON_ADDRMAP_HH__
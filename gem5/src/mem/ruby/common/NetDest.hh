@@ -29,6 +29,7 @@
 #ifndef __MEM_RUBY_COMMON_NETDEST_HH__
 #define __MEM_RUBY_COMMON_NETDEST_HH__
 
+#include <cstdint>
 #include <iostream>
 #include <vector>
 
@@ -85,13 +86,15 @@ class NetDest
     bool isEmpty() const;
 
     // For Princeton Network
-    std::vector<NodeID> getAllDest();
+    // Replaces the contents of dest with the network node ids (see
+    // MachineType_base_number) of the destinations, in increasing order
+    void getAllDest(std::vector<NodeID> &dest) const;
 
     MachineID smallestElement() const;
     MachineID smallestElement(MachineType machine) const;
 
     void resize();
-    int getSize() const { return m_bits.size(); }
+    int getSize() const { return MachineType_NUM; }
 
     // get element for a index
     NodeID elementAt(MachineID index);
@@ -99,19 +102,31 @@ class NetDest
     void print(std::ostream& out) const;
 
   private:
-    // returns a value >= MachineType_base_level("this machine")
-    // and < MachineType_base_level("next highest machine")
-    int
-    vecIndex(MachineID m) const
+    // The destinations are a single bit vector indexed by network node
+    // id, wide enough for NUMBER_BITS_PER_SET machines of every type, so
+    // that a NetDest needs no allocation and the operations on two of
+    // them are loops over a few words that the compiler vectorizes.
+    static const int numBits = MachineType_NUM * NUMBER_BITS_PER_SET;
+    static const int numWords = (numBits + 63) / 64;
+
+    // returns the network node id of a machine
+    static int
+    bitIndex(MachineID m)
     {
-        int vec_index = MachineType_base_level(m.type);
-        assert(vec_index < m_bits.size());
-        return vec_index;
+        assert(m.num < MachineType_base_count(m.type));
+        return MachineType_base_number(m.type) + m.num;
     }
 
-    NodeID bitIndex(NodeID index) const { return index; }
+    // returns the machine of a network node id
+    static MachineID machineAt(int index);
 
-    std::vector<Set> m_bits;  // a vector of bit vectors - i.e. Sets
+    bool
+    testBit(int index) const
+    {
+        return m_bits[index / 64] & (1ULL << (index % 64));
+    }
+
+    uint64_t m_bits[numWords];
 };
 
 inline std::ostream&
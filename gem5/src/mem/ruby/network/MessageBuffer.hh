@@ -48,10 +48,12 @@
 
 #include <algorithm>
 #include <cassert>
+#include <deque>
 #include <functional>
 #include <iostream>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "base/trace.hh"
@@ -89,10 +91,7 @@ class MessageBuffer : public SimObject
     void
     delayHead(Tick current_time, Tick delta)
     {
-        MsgPtr m = m_prio_heap.front();
-        std::pop_heap(m_prio_heap.begin(), m_prio_heap.end(),
-                      std::greater<MsgPtr>());
-        m_prio_heap.pop_back();
+        MsgPtr m = popHead();
         enqueue(m, current_time, delta);
     }
 
@@ -118,7 +117,7 @@ class MessageBuffer : public SimObject
     //! message queue.  The function assumes that the queue is nonempty.
     const Message* peek() const;
 
-    const MsgPtr &peekMsgPtr() const { return m_prio_heap.front(); }
+    const MsgPtr &peekMsgPtr() const { return head(); }
 
     void enqueue(MsgPtr message, Tick curTime, Tick delta);
 
@@ -142,7 +141,7 @@ class MessageBuffer : public SimObject
     void unregisterDequeueCallback();
 
     void recycle(Tick current_time, Tick recycle_latency);
-    bool isEmpty() const { return m_prio_heap.size() == 0; }
+    bool isEmpty() const { return m_fifo.empty() && m_prio_heap.empty(); }
     bool isStallMapEmpty() { return m_stall_msg_map.size() == 0; }
     unsigned int getStallMapSize() { return m_stall_msg_map.size(); }
 
@@ -185,7 +184,39 @@ class MessageBuffer : public SimObject
     }
 
   private:
-    void reanalyzeList(std::list<MsgPtr> &, Tick);
+    // The stalled messages of a line, oldest first
+    typedef std::vector<MsgPtr> StalledMsgs;
+
+    void reanalyzeList(StalledMsgs &, Tick);
+
+    // Number of messages in the queue, not counting the stalled ones
+    size_t numMsgs() const { return m_fifo.size() + m_prio_heap.size(); }
+
+    // The message of the queue due first, of m_fifo and m_prio_heap
+    bool
+    headInFifo() const
+    {
+        return !m_fifo.empty() &&
+            (m_prio_heap.empty() || m_prio_heap.front() > m_fifo.front());
+    }
+
+    const MsgPtr &
+    head() const
+    {
+        return headInFifo() ? m_fifo.front() : m_prio_heap.front();
+    }
+
+    // Add a message to the queue, in the order of its enqueue time
+    void insertMsg(MsgPtr message);
+
+    // Remove the message at the head of the queue and return it
+    MsgPtr popHead();
+
+    // Find the stalled messages of addr, or where to insert them
+    std::vector<std::pair<Addr, StalledMsgs>>::iterator
+    findStalled(Addr addr);
+    std::vector<std::pair<Addr, StalledMsgs>>::const_iterator
+    findStalled(Addr addr) const;
 
     uint32_t functionalAccess(Packet *pkt, bool is_read, WriteMask *mask);
 
@@ -193,25 +224,36 @@ class MessageBuffer : public SimObject
     // Data Members (m_ prefix)
     //! Consumer to signal a wakeup(), can be NULL
     Consumer* m_consumer;
+
+    /**
+     * The queued messages, ordered by enqueue time and then by message
+     * counter (see operator> of MsgPtr). Messages usually leave a buffer
+     * in the order they were enqueued in, and those that sort after all of
+     * m_fifo are simply appended to it. The others, e.g. enqueued with a
+     * shorter delay, recycled or reanalyzed ones, go to m_prio_heap. The
+     * head of the queue is the earlier of the heads of the two.
+     */
+    std::deque<MsgPtr> m_fifo;
     std::vector<MsgPtr> m_prio_heap;
 
     std::function<void()> m_dequeue_callback;
 
-    // use a std::map for the stalled messages as this container is
-    // sorted and ensures a well-defined iteration order
-    typedef std::map<Addr, std::list<MsgPtr> > StallMsgMapType;
+    // use a vector sorted by address for the stalled messages as it
+    // ensures a well-defined iteration order and only a few lines are
+    // stalled at a time
+    typedef std::vector<std::pair<Addr, StalledMsgs>> StallMsgMapType;
 
     /**
      * A map from line addresses to lists of stalled messages for that line.
      * If this buffer allows the receiver to stall messages, on a stall
-     * request, the stalled message is removed from the m_prio_heap and placed
+     * request, the stalled message is removed from the queue and placed
      * in the m_stall_msg_map. Messages are held there until the receiver
      * requests they be reanalyzed, at which point they are moved back to
-     * m_prio_heap.
+     * the queue.
      *
      * NOTE: The stall map holds messages in the order in which they were
      * initially received, and when a line is unblocked, the messages are
-     * moved back to the m_prio_heap in the same order. This prevents starving
+     * moved back to the queue in the same order. This prevents starving
      * older requests with younger ones.
      */
     StallMsgMapType m_stall_msg_map;
@@ -228,7 +270,7 @@ class MessageBuffer : public SimObject
      * Current size of the stall map.
      * Track the number of messages held in stall map lists. This is used to
      * ensure that if the buffer is finite-sized, it blocks further requests
-     * when the m_prio_heap and m_stall_msg_map contain m_max_size messages.
+     * when the queue and m_stall_msg_map contain m_max_size messages.
      */
     int m_stall_map_size;
 
@@ -0,0 +1,332 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/ruby/network/analytical/AnalyticalNetwork.hh"
+
+#include <algorithm>
+#include <cassert>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/RubyNetwork.hh"
+#include "mem/ruby/network/BasicLink.hh"
+#include "mem/ruby/network/BasicRouter.hh"
+#include "mem/ruby/network/MessageBuffer.hh"
+
+namespace gem5
+{
+
+namespace ruby
+{
+
+AnalyticalNetwork::AnalyticalNetwork(const Params &p)
+    : Network(p), Consumer(this),
+      updatePeriod(p.update_period), maxUtilization(p.max_utilization),
+      updateEvent([this]{ updateDelays(); }, name() + ".updateEvent"),
+      networkStats(this)
+{
+    fatal_if(updatePeriod == 0, "%s: update_period must not be 0.\n",
+             name());
+    fatal_if(maxUtilization <= 0 || maxUtilization >= 1,
+             "%s: max_utilization must be in (0, 1).\n", name());
+
+    for (auto router : p.routers)
+        m_router_latency.push_back(router->params().latency);
+    m_router_links.resize(p.routers.size());
+    m_in_links.resize(m_nodes, std::vector<int>(m_virtual_networks, -1));
+    m_last_arrival.resize(m_nodes, std::vector<Tick>(m_virtual_networks, 0));
+}
+
+void
+AnalyticalNetwork::init()
+{
+    Network::init();
+
+    // The topology pointer should have already been initialized in
+    // the parent class network constructor.
+    assert(m_topology_ptr != NULL);
+    m_topology_ptr->createLinks(this);
+
+    for (NodeID node = 0; node < m_nodes; node++) {
+        for (int vnet = 0; vnet < m_toNetQueues[node].size(); vnet++) {
+            MessageBuffer *buffer = m_toNetQueues[node][vnet];
+            if (!buffer)
+                continue;
+            fatal_if(m_in_links[node][vnet] == -1,
+                     "%s: no link injects vnet %d of node %d.\n",
+                     name(), vnet, node);
+            buffer->setConsumer(this);
+        }
+    }
+}
+
+int
+AnalyticalNetwork::addLink(BasicLink *link, int dst_router, NodeID dst_node,
+                           const std::vector<NetDest> &routing_table_entry)
+{
+    fatal_if(link->m_bandwidth_factor <= 0,
+             "%s: the bandwidth of %s must be positive.\n",
+             name(), link->name());
+
+    Link l;
+    l.latency = link->m_latency;
+    l.bandwidth = link->m_bandwidth_factor;
+    l.dstRouter = dst_router;
+    l.dstNode = dst_node;
+    l.routing = routing_table_entry;
+    m_links.push_back(l);
+    return m_links.size() - 1;
+}
+
+// From a switch to an endpoint node
+void
+AnalyticalNetwork::makeExtOutLink(SwitchID src, NodeID global_dest,
+                                  BasicLink* link,
+                                  std::vector<NetDest>& routing_table_entry)
+{
+    NodeID local_dest = getLocalNodeID(global_dest);
+    assert(local_dest < m_nodes);
+    assert(src < m_router_links.size());
+
+    m_router_links[src].push_back(
+        addLink(link, -1, local_dest, routing_table_entry));
+}
+
+// From an endpoint node to a switch
+void
+AnalyticalNetwork::makeExtInLink(NodeID global_src, SwitchID dest,
+                                 BasicLink* link,
+                                 std::vector<NetDest>& routing_table_entry)
+{
+    NodeID local_src = getLocalNodeID(global_src);
+    assert(local_src < m_nodes);
+    assert(dest < m_router_links.size());
+
+    int id = addLink(link, dest, 0, routing_table_entry);
+    for (int vnet = 0; vnet < m_virtual_networks; vnet++) {
+        bool carries_vnet = link->mVnets.empty() ||
+            std::find(link->mVnets.begin(), link->mVnets.end(), vnet) !=
+                link->mVnets.end();
+        if (carries_vnet && m_in_links[local_src][vnet] == -1)
+            m_in_links[local_src][vnet] = id;
+    }
+}
+
+// From a switch to a switch
+void
+AnalyticalNetwork::makeInternalLink(SwitchID src, SwitchID dest,
+                                    BasicLink* link,
+                                    std::vector<NetDest>& routing_table_entry,
+                                    PortDirection src_outport,
+                                    PortDirection dst_inport)
+{
+    assert(src < m_router_links.size() && dest < m_router_links.size());
+
+    m_router_links[src].push_back(
+        addLink(link, dest, 0, routing_table_entry));
+}
+
+void
+AnalyticalNetwork::wakeup()
+{
+    Tick current_time = clockEdge();
+
+    for (NodeID node = 0; node < m_nodes; node++) {
+        for (int vnet = 0; vnet < m_toNetQueues[node].size(); vnet++) {
+            MessageBuffer *buffer = m_toNetQueues[node][vnet];
+            if (!buffer)
+                continue;
+
+            while (buffer->isReady(current_time)) {
+                MsgPtr msg_ptr = buffer->peekMsgPtr();
+                DPRINTF(RubyNetwork, "Node %d vnet %d injects %s\n",
+                        node, vnet, *msg_ptr);
+                buffer->dequeue(current_time);
+                traverse(msg_ptr, vnet, m_in_links[node][vnet], 0, 0);
+            }
+        }
+    }
+}
+
+void
+AnalyticalNetwork::traverse(MsgPtr msg_ptr, int vnet, int link_id,
+                            Tick latency, Tick contention)
+{
+    Link &link = m_links[link_id];
+    const int bytes = MessageSizeType_to_int(msg_ptr->getMessageSize());
+
+    link.bytes += bytes;
+    link.msgs++;
+    if (!updateEvent.scheduled())
+        schedule(updateEvent, clockEdge(updatePeriod));
+
+    // Latency of the link, serialization of the message, and waiting
+    // behind the other messages of the link
+    const Tick delay = Tick(link.delay * clockPeriod());
+    latency += cyclesToTicks(link.latency +
+                             Cycles(divCeil(bytes, link.bandwidth))) + delay;
+    contention += delay;
+
+    if (link.dstRouter == -1) {
+        const Tick current_time = clockEdge();
+        Tick &last_arrival = m_last_arrival[link.dstNode][vnet];
+        last_arrival = std::max(last_arrival, current_time + latency);
+
+        networkStats.m_packets_received[vnet]++;
+        networkStats.m_packet_network_latency[vnet] +=
+            last_arrival - current_time;
+        networkStats.m_packet_contention_latency[vnet] += contention;
+
+        DPRINTF(RubyNetwork, "Node %d vnet %d receives %s at %d\n",
+                link.dstNode, vnet, *msg_ptr, last_arrival);
+        m_fromNetQueues[link.dstNode][vnet]->enqueue(
+            msg_ptr, current_time, last_arrival - current_time);
+        return;
+    }
+
+    latency += cyclesToTicks(m_router_latency[link.dstRouter]);
+
+    // Split the destinations among the outgoing links of the router,
+    // as PerfectSwitch does
+    std::vector<std::pair<int, NetDest>> branches;
+    NetDest msg_dsts = msg_ptr->getDestination();
+    for (int out : m_router_links[link.dstRouter]) {
+        const NetDest &dst = m_links[out].routing[vnet];
+        if (!msg_dsts.intersectionIsNotEmpty(dst))
+            continue;
+        branches.emplace_back(out, msg_dsts.AND(dst));
+        msg_dsts.removeNetDest(dst);
+    }
+    assert(msg_dsts.count() == 0);
+
+    for (int i = 0; i < branches.size(); i++) {
+        // every branch but the last works on a private copy
+        MsgPtr branch_msg =
+            i + 1 < branches.size() ? msg_ptr->clone() : msg_ptr;
+        branch_msg->getDestination() = branches[i].second;
+        traverse(branch_msg, vnet, branches[i].first, latency, contention);
+    }
+}
+
+/*
+ * Each link is an M/D/1 queue: messages arrive at random and take a
+ * fixed time to serialize. With a utilization rho and a service time S,
+ * a message waits rho * S / (2 * (1 - rho)) on average. Both come from
+ * the traffic of the last period, and the utilization saturates at
+ * max_utilization to keep the delay finite.
+ */
+void
+AnalyticalNetwork::updateDelays()
+{
+    networkStats.m_updates++;
+
+    bool traffic = false;
+    for (auto &link : m_links) {
+        if (!link.msgs) {
+            link.delay = 0;
+            continue;
+        }
+        traffic = true;
+
+        const double service = double(link.bytes) / link.msgs /
+            link.bandwidth;
+        const double rho = std::min(
+            double(link.bytes) / (double(updatePeriod) * link.bandwidth),
+            maxUtilization);
+        link.delay = rho * service / (2 * (1 - rho));
+
+        link.bytes = 0;
+        link.msgs = 0;
+    }
+
+    // An idle network waits for its next message to start a period
+    if (traffic)
+        schedule(updateEvent, clockEdge(updatePeriod));
+}
+
+void
+AnalyticalNetwork::print(std::ostream& out) const
+{
+    out << "[AnalyticalNetwork]";
+}
+
+using TickPerPacket = statistics::units::Rate<statistics::units::Tick,
+                                              statistics::units::Count>;
+
+AnalyticalNetwork::
+NetworkStats::NetworkStats(AnalyticalNetwork *parent)
+    : statistics::Group(parent),
+      m_packets_received(this, "packets_received",
+                         statistics::units::Count::get(),
+                         "Packets delivered per vnet"),
+      m_packet_network_latency(this, "packet_network_latency",
+                               statistics::units::Tick::get(),
+                               "Latency of the delivered packets per vnet"),
+      m_packet_contention_latency(this, "packet_contention_latency",
+                                  statistics::units::Tick::get(),
+                                  "Part of the latency spent waiting "
+                                  "behind other packets per vnet"),
+      m_updates(this, "delay_updates", statistics::units::Count::get(),
+                "Updates of the contention delays"),
+      m_avg_packet_vnet_latency(this, "average_packet_vnet_latency",
+                                TickPerPacket::get(),
+                                "Average packet latency per vnet"),
+      m_avg_packet_network_latency(this, "average_packet_network_latency",
+                                   TickPerPacket::get(),
+                                   "Average packet latency"),
+      m_avg_packet_contention_latency(this,
+                                      "average_packet_contention_latency",
+                                      TickPerPacket::get(),
+                                      "Average packet contention delay"),
+      m_avg_packet_latency(this, "average_packet_latency",
+                           TickPerPacket::get(),
+                           "Average packet latency, as garnet reports it")
+{
+    const int vnets = Network::getNumberOfVirtualNetworks();
+    m_packets_received.init(vnets).flags(statistics::total |
+                                         statistics::nozero);
+    m_packet_network_latency.init(vnets).flags(statistics::oneline);
+    m_packet_contention_latency.init(vnets).flags(statistics::oneline);
+    for (int i = 0; i < vnets; i++) {
+        m_packets_received.subname(i, csprintf("vnet-%i", i));
+        m_packet_network_latency.subname(i, csprintf("vnet-%i", i));
+        m_packet_contention_latency.subname(i, csprintf("vnet-%i", i));
+    }
+
+    m_avg_packet_vnet_latency.flags(statistics::oneline);
+    m_avg_packet_vnet_latency =
+        m_packet_network_latency / m_packets_received;
+    m_avg_packet_network_latency =
+        sum(m_packet_network_latency) / sum(m_packets_received);
+    m_avg_packet_contention_latency =
+        sum(m_packet_contention_latency) / sum(m_packets_received);
+    // no time is spent waiting for injection
+    m_avg_packet_latency =
+        sum(m_packet_network_latency) / sum(m_packets_received);
+}
+
+} // namespace ruby
+} // namespace gem5
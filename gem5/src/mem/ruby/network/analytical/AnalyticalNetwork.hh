@@ -0,0 +1,152 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_NETWORK_ANALYTICAL_ANALYTICALNETWORK_HH__
+#define __MEM_RUBY_NETWORK_ANALYTICAL_ANALYTICALNETWORK_HH__
+
+#include <iostream>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "mem/ruby/common/Consumer.hh"
+#include "mem/ruby/common/NetDest.hh"
+#include "mem/ruby/network/Network.hh"
+#include "mem/ruby/slicc_interface/Message.hh"
+#include "params/AnalyticalNetwork.hh"
+
+namespace gem5
+{
+
+namespace ruby
+{
+
+/**
+ * A network of queues for coarse design space sweeps. Every link is a
+ * queue whose contention delay follows from its utilization over the
+ * last update period, and every router adds its pipeline latency. A
+ * message is routed through the topology as soon as it is injected, and
+ * enqueued at its destinations with the latency of its path, without
+ * any per-flit or per-hop event.
+ */
+class AnalyticalNetwork : public Network, public Consumer
+{
+  public:
+    PARAMS(AnalyticalNetwork);
+    AnalyticalNetwork(const Params &p);
+
+    void init() override;
+
+    /** Route the messages injected this cycle. */
+    void wakeup() override;
+
+    void collateStats() override {}
+    void print(std::ostream& out) const override;
+
+    // Methods used by Topology to setup the network
+    void makeExtOutLink(SwitchID src, NodeID dest, BasicLink* link,
+                        std::vector<NetDest>& routing_table_entry) override;
+    void makeExtInLink(NodeID src, SwitchID dest, BasicLink* link,
+                       std::vector<NetDest>& routing_table_entry) override;
+    void makeInternalLink(SwitchID src, SwitchID dest, BasicLink* link,
+                          std::vector<NetDest>& routing_table_entry,
+                          PortDirection src_outport,
+                          PortDirection dst_inport) override;
+
+    // The messages in flight are already in the buffers of their
+    // destinations, where the controllers look them up
+    bool functionalRead(Packet *pkt) override { return false; }
+    bool functionalRead(Packet *pkt, WriteMask &mask) override
+    { return false; }
+    uint32_t functionalWrite(Packet *pkt) override { return 0; }
+
+  private:
+    struct Link
+    {
+        Cycles latency;
+        /** Bytes per cycle */
+        int bandwidth;
+        /** Router at the far end, or -1 for a link to an endpoint */
+        int dstRouter;
+        NodeID dstNode;
+        std::vector<NetDest> routing;
+
+        /** Traffic of the current update period */
+        uint64_t bytes = 0;
+        uint64_t msgs = 0;
+
+        /** Contention delay of a message, in cycles */
+        double delay = 0;
+    };
+
+    int addLink(BasicLink *link, int dst_router, NodeID dst_node,
+                const std::vector<NetDest> &routing_table_entry);
+
+    /**
+     * Send a message down a link, and on through the routers after it
+     * to every destination of the message.
+     */
+    void traverse(MsgPtr msg_ptr, int vnet, int link_id, Tick latency,
+                  Tick contention);
+
+    /** Recompute the contention delays from the last period. */
+    void updateDelays();
+
+    const Cycles updatePeriod;
+    const double maxUtilization;
+
+    std::vector<Cycles> m_router_latency;
+    std::vector<Link> m_links;
+    /** Outgoing links of each router */
+    std::vector<std::vector<int>> m_router_links;
+    /** Injection link of each node and vnet */
+    std::vector<std::vector<int>> m_in_links;
+    /**
+     * Last arrival at each destination buffer, the messages of a buffer
+     * leave the network in the order they entered it
+     */
+    std::vector<std::vector<Tick>> m_last_arrival;
+
+    EventFunctionWrapper updateEvent;
+
+    struct NetworkStats : public statistics::Group
+    {
+        NetworkStats(AnalyticalNetwork *parent);
+
+        statistics::Vector m_packets_received;
+        statistics::Vector m_packet_network_latency;
+        statistics::Vector m_packet_contention_latency;
+        statistics::Scalar m_updates;
+
+        statistics::Formula m_avg_packet_vnet_latency;
+        statistics::Formula m_avg_packet_network_latency;
+        statistics::Formula m_avg_packet_contention_latency;
+        statistics::Formula m_avg_packet_latency;
+    } networkStats;
+};
+
+} // namespace ruby
+} // namespace gem5
+
+#endif // __MEM_RUBY_NETWORK_ANALYTICAL_ANALYTICALNETWORK_HH__
@@ -0,0 +1,135 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_NETWORK_GARNET_0_ARBITERMASK_HH__
+#define __MEM_RUBY_NETWORK_GARNET_0_ARBITERMASK_HH__
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "base/bitfield.hh"
+
+namespace gem5
+{
+
+namespace ruby
+{
+
+namespace garnet
+{
+
+/**
+ * A set of requesters of an arbiter (input VCs, input ports, free output
+ * VCs) as a bitmask. The round robin arbiters of the router look for the
+ * first set bit from their pointer, a word at a time, rather than asking
+ * every requester in turn.
+ */
+class ArbiterMask
+{
+  public:
+    void
+    resize(int size)
+    {
+        numBits = size;
+        words.assign((size + 63) / 64, 0);
+    }
+
+    int size() const { return numBits; }
+
+    void
+    set(int i)
+    {
+        assert(i >= 0 && i < numBits);
+        words[i / 64] |= 1ULL << (i % 64);
+    }
+
+    void
+    clear(int i)
+    {
+        assert(i >= 0 && i < numBits);
+        words[i / 64] &= ~(1ULL << (i % 64));
+    }
+
+    bool
+    test(int i) const
+    {
+        assert(i >= 0 && i < numBits);
+        return words[i / 64] & (1ULL << (i % 64));
+    }
+
+    void clearAll() { std::fill(words.begin(), words.end(), 0); }
+
+    bool
+    any() const
+    {
+        for (auto word : words) {
+            if (word)
+                return true;
+        }
+        return false;
+    }
+
+    /**
+     * First set bit in [begin, end), or -1 if there is none.
+     */
+    int
+    findFirst(int begin, int end) const
+    {
+        assert(begin >= 0 && end <= numBits);
+        for (int w = begin / 64; w * 64 < end; w++) {
+            uint64_t word = words[w];
+            if (w == begin / 64)
+                word &= ~0ULL << (begin % 64);
+            if (word) {
+                int i = w * 64 + findLsbSet(word);
+                return i < end ? i : -1;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * First set bit at or after the round robin pointer, wrapping around,
+     * or -1 if the mask is empty.
+     */
+    int
+    findNext(int pointer) const
+    {
+        int i = findFirst(pointer, numBits);
+        return i != -1 ? i : findFirst(0, pointer);
+    }
+
+  private:
+    int numBits = 0;
+    std::vector<uint64_t> words;
+};
+
+} // namespace garnet
+} // namespace ruby
+} // namespace gem5
+
+#endif // __MEM_RUBY_NETWORK_GARNET_0_ARBITERMASK_HH__
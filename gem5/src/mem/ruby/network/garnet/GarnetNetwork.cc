@@ -45,6 +45,7 @@
 #include "mem/ruby/network/garnet/NetworkLink.hh"
 #include "mem/ruby/network/garnet/Router.hh"
 #include "mem/ruby/system/RubySystem.hh"
+#include "sim/core.hh"
 
 namespace gem5
 {
@@ -75,6 +76,11 @@ GarnetNetwork::GarnetNetwork(const Params &p)
     if (m_enable_fault_model)
         fault_model = p.fault_model;
 
+    if (!p.dsent_router_config.empty()) {
+        m_power.reset(new NetworkPower(p.dsent_router_config,
+                                       p.dsent_link_config));
+    }
+
     m_vnet_type.resize(m_virtual_networks);
 
     for (int i = 0 ; i < m_virtual_networks ; i++) {
@@ -149,6 +155,31 @@ GarnetNetwork::init()
             router->printFaultVector(std::cout);
         }
     }
+
+    // Power: look up the DSENT model of each router and flit link, the
+    // widths being in bytes like the flit size
+    if (m_power) {
+        for (Router *router : m_routers) {
+            std::vector<int> vcs(router->get_num_vnets(),
+                                 router->get_vc_per_vnet());
+            std::vector<int> buffers(router->get_num_vnets());
+            for (int vnet = 0; vnet < buffers.size(); vnet++) {
+                buffers[vnet] = get_vnet_type(vnet) == DATA_VNET_ ?
+                    getBuffersPerDataVC() : getBuffersPerCtrlVC();
+            }
+
+            m_router_power.push_back(&m_power->router(
+                sim_clock::as_float::s / router->clockPeriod(),
+                router->get_num_inports(), router->get_num_outports(),
+                vcs, buffers, 8 * router->getBitWidth()));
+        }
+
+        for (NetworkLink *link : m_networklinks) {
+            m_link_power.push_back(&m_power->link(
+                sim_clock::as_float::s / link->clockPeriod(),
+                8 * link->bitWidth));
+        }
+    }
 }
 
 /*
@@ -536,6 +567,43 @@ GarnetNetwork::regStats()
             m_ctrl_traffic_distribution[source].push_back(ctrl_packets);
         }
     }
+
+    // Power
+    m_router_dynamic_energy
+        .init(m_routers.size())
+        .name(name() + ".router_dynamic_energy")
+        .flags(statistics::total | statistics::nozero)
+        ;
+    m_router_leakage_energy
+        .init(m_routers.size())
+        .name(name() + ".router_leakage_energy")
+        .flags(statistics::total | statistics::nozero)
+        ;
+    for (int i = 0; i < m_routers.size(); i++) {
+        m_router_dynamic_energy.subname(i, "router" + std::to_string(i));
+        m_router_leakage_energy.subname(i, "router" + std::to_string(i));
+    }
+
+    m_link_dynamic_energy
+        .name(name() + ".link_dynamic_energy")
+        .flags(statistics::nozero);
+    m_link_leakage_energy
+        .name(name() + ".link_leakage_energy")
+        .flags(statistics::nozero);
+
+    m_total_energy
+        .name(name() + ".total_energy")
+        .flags(statistics::nozero);
+    m_total_energy = sum(m_router_dynamic_energy) +
+        sum(m_router_leakage_energy) + m_link_dynamic_energy +
+        m_link_leakage_energy;
+
+    m_router_area
+        .name(name() + ".router_area")
+        .flags(statistics::nozero);
+    m_link_area
+        .name(name() + ".link_area")
+        .flags(statistics::nozero);
 }
 
 void
@@ -568,6 +636,48 @@ GarnetNetwork::collateStats()
     for (int i = 0; i < m_routers.size(); i++) {
         m_routers[i]->collateStats();
     }
+
+    if (m_power)
+        collatePowerStats(time_delta * clockPeriod() / sim_clock::as_float::s);
+}
+
+void
+GarnetNetwork::collatePowerStats(double seconds)
+{
+    // The activity of the routers and links, collated above, is counted
+    // from the last reset, so the energies are assigned, not accumulated
+    double router_area = 0;
+    for (int i = 0; i < m_routers.size(); i++) {
+        const Router *router = m_routers[i];
+        const NetworkPower::RouterModel &model = *m_router_power[i];
+        double cycles =
+            seconds * sim_clock::as_float::s / router->clockPeriod();
+
+        m_router_dynamic_energy[i] =
+            router->getBufferWrites() * model.bufferWrite +
+            router->getBufferReads() * model.bufferRead +
+            router->getCrossbarActivity() * model.crossbar +
+            router->getSwInputArbiterActivity() * model.swInputArbiter +
+            router->getSwOutputArbiterActivity() * model.swOutputArbiter +
+            cycles * model.clock;
+        m_router_leakage_energy[i] = seconds * model.leakage;
+        router_area += model.area;
+    }
+    m_router_area = router_area;
+
+    double link_dynamic_energy = 0;
+    double link_leakage_energy = 0;
+    double link_area = 0;
+    for (int i = 0; i < m_networklinks.size(); i++) {
+        const NetworkPower::LinkModel &model = *m_link_power[i];
+        link_dynamic_energy +=
+            m_networklinks[i]->getLinkUtilization() * model.send;
+        link_leakage_energy += seconds * model.leakage;
+        link_area += model.area;
+    }
+    m_link_dynamic_energy = link_dynamic_energy;
+    m_link_leakage_energy = link_leakage_energy;
+    m_link_area = link_area;
 }
 
 void
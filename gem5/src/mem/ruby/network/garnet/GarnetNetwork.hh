@@ -33,11 +33,13 @@
 #define __MEM_RUBY_NETWORK_GARNET_0_GARNETNETWORK_HH__
 
 #include <iostream>
+#include <memory>
 #include <vector>
 
 #include "mem/ruby/network/Network.hh"
 #include "mem/ruby/network/fault_model/FaultModel.hh"
 #include "mem/ruby/network/garnet/CommonTypes.hh"
+#include "mem/ruby/network/garnet/NetworkPower.hh"
 #include "params/GarnetNetwork.hh"
 
 namespace gem5
@@ -200,6 +202,17 @@ class GarnetNetwork : public Network
     std::vector<std::vector<statistics::Scalar *>> m_data_traffic_distribution;
     std::vector<std::vector<statistics::Scalar *>> m_ctrl_traffic_distribution;
 
+    // Energy since the last reset, estimated with DSENT, in J
+    statistics::Vector m_router_dynamic_energy;
+    statistics::Vector m_router_leakage_energy;
+    statistics::Scalar m_link_dynamic_energy;
+    statistics::Scalar m_link_leakage_energy;
+    statistics::Formula m_total_energy;
+
+    // Area, in m^2
+    statistics::Scalar m_router_area;
+    statistics::Scalar m_link_area;
+
   private:
     GarnetNetwork(const GarnetNetwork& obj);
     GarnetNetwork& operator=(const GarnetNetwork& obj);
@@ -209,6 +222,13 @@ class GarnetNetwork : public Network
     std::vector<NetworkLink *> m_networklinks; // All flit links in the network
     std::vector<CreditLink *> m_creditlinks; // All credit links in the network
     std::vector<NetworkInterface *> m_nis;   // All NI's in Network
+
+    // DSENT models of the routers and flit links, null if disabled
+    std::unique_ptr<NetworkPower> m_power;
+    std::vector<const NetworkPower::RouterModel *> m_router_power;
+    std::vector<const NetworkPower::LinkModel *> m_link_power;
+
+    void collatePowerStats(double seconds);
 };
 
 inline std::ostream&
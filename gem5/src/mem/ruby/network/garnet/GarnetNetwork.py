@@ -50,6 +50,11 @@ class GarnetNetwork(RubyNetwork):
     fault_model = Param.FaultModel(NULL, "network fault model");
     garnet_deadlock_threshold = Param.UInt32(50000,
                               "network-level deadlock threshold")
+    dsent_router_config = Param.String("",
+        "DSENT configuration of the routers, to estimate the network energy "
+        "(e.g. ext/dsent/configs/router.cfg), disabled if empty")
+    dsent_link_config = Param.String("ext/dsent/configs/electrical-link.cfg",
+        "DSENT configuration of the links")
 
 class GarnetNetworkInterface(ClockedObject):
     type = 'GarnetNetworkInterface'
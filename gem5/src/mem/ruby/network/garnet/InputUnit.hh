@@ -36,6 +36,7 @@
 #include <vector>
 
 #include "mem/ruby/common/Consumer.hh"
+#include "mem/ruby/network/garnet/ArbiterMask.hh"
 #include "mem/ruby/network/garnet/CommonTypes.hh"
 #include "mem/ruby/network/garnet/CreditLink.hh"
 #include "mem/ruby/network/garnet/NetworkLink.hh"
@@ -116,9 +117,15 @@ class InputUnit : public Consumer
     inline flit*
     getTopFlit(int vc)
     {
-        return virtualChannels[vc].getTopFlit();
+        flit *t_flit = virtualChannels[vc].getTopFlit();
+        if (virtualChannels[vc].isEmpty())
+            m_busy_vcs.clear(vc);
+        return t_flit;
     }
 
+    // The VCs which buffer at least one flit
+    inline const ArbiterMask &get_busy_vcs() const { return m_busy_vcs; }
+
     inline bool
     need_stage(int vc, flit_stage stage, Tick time)
     {
@@ -166,6 +173,7 @@ class InputUnit : public Consumer
 
     // Input Virtual channels
     std::vector<VirtualChannel> virtualChannels;
+    ArbiterMask m_busy_vcs;
 
     // Statistical variables
     std::vector<double> m_num_buffer_writes;
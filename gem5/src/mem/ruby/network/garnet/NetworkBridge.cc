@@ -95,6 +95,17 @@ NetworkBridge::~NetworkBridge()
 {
 }
 
+void
+NetworkBridge::startup()
+{
+    CreditLink::startup();
+
+    // The bridge schedules its consumer directly, so it must sit in the
+    // network partition of its consumer
+    fatal_if(remoteConsumer, "%s and %s must run on the same event queue.\n",
+             name(), link_consumer->getObject()->name());
+}
+
 void
 NetworkBridge::scheduleFlit(flit *t_flit, Cycles latency)
 {
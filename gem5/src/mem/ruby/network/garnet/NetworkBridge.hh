@@ -65,6 +65,7 @@ class NetworkBridge: public CreditLink
     void initBridge(NetworkBridge *coBrid, bool cdc_en, bool serdes_en);
 
     void wakeup();
+    void startup() override;
     void neutralize(int vc, int eCredit);
 
     void scheduleFlit(flit *t_flit, Cycles latency);
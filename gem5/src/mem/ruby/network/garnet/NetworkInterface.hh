@@ -291,6 +291,9 @@ class NetworkInterface : public ClockedObject, public Consumer
     std::vector<MessageBuffer *> outNode_ptr;
     // When a vc stays busy for a long time, it indicates a deadlock
     std::vector<int> vc_busy_counter;
+    // Destinations of the message being flitisized, kept to reuse its
+    // storage from one message to the next
+    std::vector<NodeID> m_dest_nodes;
 
     void checkStallQueue();
     bool flitisizeMessage(MsgPtr msg_ptr, int vnet);
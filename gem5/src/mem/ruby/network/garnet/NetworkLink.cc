@@ -35,6 +35,7 @@
 #include "base/trace.hh"
 #include "debug/RubyNetwork.hh"
 #include "mem/ruby/network/garnet/CreditLink.hh"
+#include "sim/quantum_controller.hh"
 
 namespace gem5
 {
@@ -48,9 +49,9 @@ namespace garnet
 NetworkLink::NetworkLink(const Params &p)
     : ClockedObject(p), Consumer(this), m_id(p.link_id),
       m_type(NUM_LINK_TYPES_),
-      m_latency(p.link_latency), m_link_utilized(0),
+      m_latency(p.link_latency), src_object(nullptr), m_link_utilized(0),
       m_virt_nets(p.virt_nets), linkBuffer(),
-      link_consumer(nullptr), link_srcQueue(nullptr)
+      link_consumer(nullptr), link_srcQueue(nullptr), remoteConsumer(false)
 {
     int num_vnets = (p.supported_vnets).size();
     mVnets.resize(num_vnets);
@@ -98,8 +99,12 @@ NetworkLink::wakeup()
                 (mVnets.size() == 0));
         }
         t_flit->set_time(clockEdge(m_latency));
-        linkBuffer.insert(t_flit);
-        link_consumer->scheduleEventAbsolute(clockEdge(m_latency));
+        if (remoteConsumer) {
+            sendRemote(t_flit);
+        } else {
+            linkBuffer.insert(t_flit);
+            link_consumer->scheduleEventAbsolute(clockEdge(m_latency));
+        }
         m_link_utilized++;
         m_vc_load[t_flit->get_vc()]++;
     }
@@ -109,6 +114,41 @@ NetworkLink::wakeup()
     }
 }
 
+void
+NetworkLink::startup()
+{
+    ClockedObject::startup();
+
+    // Bridges which are not enabled are never connected
+    if (!link_consumer || !src_object)
+        return;
+
+    // A partitioned network (see configs/network/Network.py) simulates
+    // its routers on several event queues. A link runs on the queue of
+    // its source, and the flits it sends to another queue must arrive
+    // after the end of the current quantum.
+    remoteConsumer = link_consumer->getObject()->eventQueue() != eventQueue();
+    fatal_if(remoteConsumer &&
+             cyclesToTicks(m_latency) < quantumController->maxSimQuantum(),
+             "The latency of %s (%d ticks) connecting two network "
+             "partitions is lower than the simulation quantum (%d ticks).\n",
+             name(), cyclesToTicks(m_latency),
+             quantumController->maxSimQuantum());
+}
+
+void
+NetworkLink::sendRemote(flit *t_flit)
+{
+    // The flit is delivered before the consumer wakes up in the same
+    // tick, as if it had been in the link buffer all along
+    const Tick when = t_flit->get_time();
+    auto deliver = new EventFunctionWrapper([this, t_flit, when] {
+            linkBuffer.insert(t_flit);
+            link_consumer->scheduleEventAbsolute(when);
+        }, name() + ".deliver", true, Event::Delayed_Writeback_Pri);
+    link_consumer->getObject()->eventQueue()->schedule(deliver, when);
+}
+
 void
 NetworkLink::resetStats()
 {
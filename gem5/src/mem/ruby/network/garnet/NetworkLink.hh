@@ -69,6 +69,7 @@ class NetworkLink : public ClockedObject, public Consumer
     int get_id() const { return m_id; }
     flitBuffer *getBuffer() { return &linkBuffer;}
     virtual void wakeup();
+    void startup() override;
 
     unsigned int getLinkUtilization() const { return m_link_utilized; }
     const std::vector<unsigned int> & getVcLoad() const { return m_vc_load; }
@@ -88,6 +89,13 @@ class NetworkLink : public ClockedObject, public Consumer
     uint32_t bitWidth;
 
   private:
+    /**
+     * Hand a flit over to a consumer simulated on another event queue.
+     * It enters the link buffer at its arrival time, from an event on
+     * the queue of the consumer.
+     */
+    void sendRemote(flit *t_flit);
+
     const int m_id;
     link_type m_type;
     const Cycles m_latency;
@@ -104,6 +112,11 @@ class NetworkLink : public ClockedObject, public Consumer
     Consumer *link_consumer;
     flitBuffer *link_srcQueue;
 
+    /**
+     * The consumer runs on another event queue. The link latency is
+     * then the lookahead between the two queues.
+     */
+    bool remoteConsumer;
 };
 
 } // namespace garnet
@@ -0,0 +1,157 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/ruby/network/garnet/NetworkPower.hh"
+
+#include <cassert>
+
+#include "DSENT.h"
+#include "base/logging.hh"
+#include "libutil/Config.h"
+#include "model/std_cells/StdCellLib.h"
+#include "tech/TechModel.h"
+
+namespace gem5
+{
+
+namespace ruby
+{
+
+namespace garnet
+{
+
+namespace
+{
+
+typedef std::map<LibUtil::String, LibUtil::String> DSENTConfig;
+
+DSENTConfig
+readConfig(const std::string &filename, const std::string &model)
+{
+    DSENTConfig config;
+    LibUtil::readFile(filename.c_str(), config);
+    fatal_if(!config.count("ModelName") || config.at("ModelName") != model,
+             "%s is not the DSENT configuration of a %s.", filename, model);
+    return config;
+}
+
+std::string
+toList(const std::vector<int> &values)
+{
+    std::string list = "[";
+    for (size_t i = 0; i < values.size(); i++)
+        list += (i ? ", " : "") + std::to_string(values[i]);
+    return list + "]";
+}
+
+} // anonymous namespace
+
+NetworkPower::NetworkPower(const std::string &router_config,
+                           const std::string &link_config)
+{
+    DSENTConfig router = readConfig(router_config, "Router");
+    DSENTConfig link = readConfig(link_config, "RepeatedLink");
+
+    routerConfig.insert(router.begin(), router.end());
+    linkConfig.insert(link.begin(), link.end());
+
+    routerTech = DSENT::constructTechModel(router);
+    linkTech = DSENT::constructTechModel(link);
+}
+
+NetworkPower::~NetworkPower()
+{
+    for (DSENT::TechModel *tech : { routerTech, linkTech }) {
+        delete tech->getStdCellLib();
+        delete tech;
+    }
+}
+
+const NetworkPower::RouterModel &
+NetworkPower::router(double frequency, int inports, int outports,
+                     const std::vector<int> &vcs,
+                     const std::vector<int> &buffers, int bits)
+{
+    assert(vcs.size() == buffers.size());
+
+    RouterKey key(frequency, inports, outports, vcs, buffers, bits);
+    auto it = routers.find(key);
+    if (it != routers.end())
+        return it->second;
+
+    DSENTConfig config(routerConfig.begin(), routerConfig.end());
+    config["Frequency"] = LibUtil::String::toString(frequency);
+    config["NumberInputPorts"] = std::to_string(inports);
+    config["NumberOutputPorts"] = std::to_string(outports);
+    config["NumberVirtualNetworks"] = std::to_string(vcs.size());
+    config["NumberVirtualChannelsPerVirtualNetwork"] = toList(vcs);
+    config["NumberBuffersPerVirtualChannel"] = toList(buffers);
+    config["NumberBitsPerFlit"] = std::to_string(bits);
+
+    DSENT::Model *model = DSENT::buildModel(config, routerTech);
+
+    RouterModel &router = routers[key];
+    router.bufferWrite = DSENT::query("Energy>>Router:WriteBuffer", model);
+    router.bufferRead = DSENT::query("Energy>>Router:ReadBuffer", model);
+    router.crossbar = DSENT::query(
+        "Energy>>Router:TraverseCrossbar->Multicast1", model);
+    router.swInputArbiter = DSENT::query(
+        "Energy>>Router:ArbitrateSwitch->ArbitrateStage1", model);
+    router.swOutputArbiter = DSENT::query(
+        "Energy>>Router:ArbitrateSwitch->ArbitrateStage2", model);
+    router.clock = DSENT::query("Energy>>Router:DistributeClock", model);
+    router.leakage = DSENT::query("NddPower>>Router:Leakage", model);
+    router.area = DSENT::query("Area>>Router:Active", model);
+
+    delete model;
+    return router;
+}
+
+const NetworkPower::LinkModel &
+NetworkPower::link(double frequency, int bits)
+{
+    LinkKey key(frequency, bits);
+    auto it = links.find(key);
+    if (it != links.end())
+        return it->second;
+
+    DSENTConfig config(linkConfig.begin(), linkConfig.end());
+    config["Frequency"] = LibUtil::String::toString(frequency);
+    config["NumberBits"] = std::to_string(bits);
+
+    DSENT::Model *model = DSENT::buildModel(config, linkTech);
+
+    LinkModel &link = links[key];
+    link.send = DSENT::query("Energy>>RepeatedLink:Send", model);
+    link.leakage = DSENT::query("NddPower>>RepeatedLink:Leakage", model);
+    link.area = DSENT::query("Area>>RepeatedLink:Active", model);
+
+    delete model;
+    return link;
+}
+
+} // namespace garnet
+} // namespace ruby
+} // namespace gem5
@@ -0,0 +1,120 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_NETWORK_GARNET_0_NETWORKPOWER_HH__
+#define __MEM_RUBY_NETWORK_GARNET_0_NETWORKPOWER_HH__
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace DSENT
+{
+class TechModel;
+} // namespace DSENT
+
+namespace gem5
+{
+
+namespace ruby
+{
+
+namespace garnet
+{
+
+/**
+ * The DSENT models of the routers and links of a Garnet network.
+ *
+ * Building a DSENT model is expensive, and most networks are made of a
+ * handful of distinct router and link configurations, so the models are
+ * built once per configuration, and only the per-event energies, the
+ * leakage power and the area they report are kept.
+ */
+class NetworkPower
+{
+  public:
+    /** Energies in J per event, leakage in W and area in m^2. */
+    struct RouterModel
+    {
+        double bufferWrite;
+        double bufferRead;
+        double crossbar;
+        double swInputArbiter;
+        double swOutputArbiter;
+        double clock;
+        double leakage;
+        double area;
+    };
+
+    struct LinkModel
+    {
+        double send;
+        double leakage;
+        double area;
+    };
+
+    /**
+     * @param router_config DSENT configuration of a Router model.
+     * @param link_config DSENT configuration of a RepeatedLink model.
+     */
+    NetworkPower(const std::string &router_config,
+                 const std::string &link_config);
+    ~NetworkPower();
+
+    /**
+     * @param frequency Clock frequency, in Hz.
+     * @param vcs Virtual channels of each virtual network.
+     * @param buffers Buffers per virtual channel of each virtual network.
+     * @param bits Width of a flit.
+     */
+    const RouterModel &router(double frequency, int inports, int outports,
+                              const std::vector<int> &vcs,
+                              const std::vector<int> &buffers, int bits);
+
+    const LinkModel &link(double frequency, int bits);
+
+  private:
+    typedef std::map<std::string, std::string> Config;
+
+    typedef std::tuple<double, int, int, std::vector<int>,
+                       std::vector<int>, int> RouterKey;
+    typedef std::tuple<double, int> LinkKey;
+
+    Config routerConfig;
+    Config linkConfig;
+
+    DSENT::TechModel *routerTech;
+    DSENT::TechModel *linkTech;
+
+    std::map<RouterKey, RouterModel> routers;
+    std::map<LinkKey, LinkModel> links;
+};
+
+} // namespace garnet
+} // namespace ruby
+} // namespace gem5
+
+#endif // __MEM_RUBY_NETWORK_GARNET_0_NETWORKPOWER_HH__
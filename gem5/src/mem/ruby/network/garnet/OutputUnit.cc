@@ -56,6 +56,10 @@ OutputUnit::OutputUnit(int id, PortDirection direction, Router *router,
     for (int i = 0; i < m_num_vcs; i++) {
         outVcState.emplace_back(i, m_router->get_net_ptr(), consumerVcs);
     }
+    m_idle_vcs.resize(m_num_vcs);
+    for (int i = 0; i < m_num_vcs; i++) {
+        m_idle_vcs.set(i);
+    }
 }
 
 void
@@ -93,32 +97,37 @@ OutputUnit::has_credit(int out_vc)
 }
 
 
-// Check if the output port (i.e., input port at next router) has free VCs.
-bool
-OutputUnit::has_free_vc(int vnet)
+// First free VC of a vnet, or -1
+int
+OutputUnit::find_free_vc(int vnet)
 {
     int vc_base = vnet*m_vc_per_vnet;
-    for (int vc = vc_base; vc < vc_base + m_vc_per_vnet; vc++) {
+    int vc_end = vc_base + m_vc_per_vnet;
+    for (int vc = m_idle_vcs.findFirst(vc_base, vc_end); vc != -1;
+         vc = m_idle_vcs.findFirst(vc + 1, vc_end)) {
         if (is_vc_idle(vc, curTick()))
-            return true;
+            return vc;
     }
 
-    return false;
+    return -1;
+}
+
+// Check if the output port (i.e., input port at next router) has free VCs.
+bool
+OutputUnit::has_free_vc(int vnet)
+{
+    return find_free_vc(vnet) != -1;
 }
 
 // Assign a free output VC to the winner of Switch Allocation
 int
 OutputUnit::select_free_vc(int vnet)
 {
-    int vc_base = vnet*m_vc_per_vnet;
-    for (int vc = vc_base; vc < vc_base + m_vc_per_vnet; vc++) {
-        if (is_vc_idle(vc, curTick())) {
-            outVcState[vc].setState(ACTIVE_, curTick());
-            return vc;
-        }
-    }
+    int vc = find_free_vc(vnet);
+    if (vc != -1)
+        set_vc_state(ACTIVE_, vc, curTick());
 
-    return -1;
+    return vc;
 }
 
 /*
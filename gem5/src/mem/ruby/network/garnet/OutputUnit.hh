@@ -37,6 +37,7 @@
 
 #include "base/compiler.hh"
 #include "mem/ruby/common/Consumer.hh"
+#include "mem/ruby/network/garnet/ArbiterMask.hh"
 #include "mem/ruby/network/garnet/CommonTypes.hh"
 #include "mem/ruby/network/garnet/NetworkLink.hh"
 #include "mem/ruby/network/garnet/OutVcState.hh"
@@ -88,6 +89,10 @@ class OutputUnit : public Consumer
     set_vc_state(VC_state_type state, int vc, Tick curTime)
     {
       outVcState[vc].setState(state, curTime);
+      if (state == IDLE_)
+          m_idle_vcs.set(vc);
+      else
+          m_idle_vcs.clear(vc);
     }
 
     inline bool
@@ -118,6 +123,10 @@ class OutputUnit : public Consumer
     flitBuffer outBuffer;
     // vc state of downstream router
     std::vector<OutVcState> outVcState;
+    // output VCs in the IDLE_ state, possibly from a later tick
+    ArbiterMask m_idle_vcs;
+
+    int find_free_vc(int vnet);
 };
 
 } // namespace garnet
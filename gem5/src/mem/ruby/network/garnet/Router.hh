@@ -128,6 +128,23 @@ class Router : public BasicRouter, public Consumer
     void collateStats();
     void resetStats();
 
+    // Activity since the last reset, as of the last collateStats()
+    double getBufferReads() const { return m_buffer_reads.value(); }
+    double getBufferWrites() const { return m_buffer_writes.value(); }
+    double getCrossbarActivity() const { return m_crossbar_activity.value(); }
+
+    double
+    getSwInputArbiterActivity() const
+    {
+        return m_sw_input_arbiter_activity.value();
+    }
+
+    double
+    getSwOutputArbiterActivity() const
+    {
+        return m_sw_output_arbiter_activity.value();
+    }
+
     // For Fault Model:
     bool get_fault_vector(int temperature, float fault_vector[]) {
         return m_network_ptr->fault_model->fault_vector(m_id, temperature,
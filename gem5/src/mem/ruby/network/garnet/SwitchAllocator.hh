@@ -36,6 +36,7 @@
 #include <vector>
 
 #include "mem/ruby/common/Consumer.hh"
+#include "mem/ruby/network/garnet/ArbiterMask.hh"
 #include "mem/ruby/network/garnet/CommonTypes.hh"
 
 namespace gem5
@@ -61,7 +62,7 @@ class SwitchAllocator : public Consumer
     void check_for_wakeup();
     int get_vnet (int invc);
     void print(std::ostream& out) const {};
-    void arbitrate_inports();
+    bool arbitrate_inports();
     void arbitrate_outports();
     bool send_allowed(int inport, int invc, int outport, int outvc);
     int vc_allocate(int outport, int inport, int invc);
@@ -88,7 +89,9 @@ class SwitchAllocator : public Consumer
     Router *m_router;
     std::vector<int> m_round_robin_invc;
     std::vector<int> m_round_robin_inport;
-    std::vector<int> m_port_requests;
+    // Request matrix of SA-I: the inports requesting each outport
+    std::vector<ArbiterMask> m_port_requests;
+    ArbiterMask m_requested_outports;
     std::vector<int> m_vc_winners;
 };
 
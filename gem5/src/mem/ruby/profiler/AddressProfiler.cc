@@ -28,9 +28,11 @@
 
 #include "mem/ruby/profiler/AddressProfiler.hh"
 
+#include <algorithm>
 #include <vector>
 
 #include "base/bitfield.hh"
+#include "base/logging.hh"
 #include "base/stl_helpers.hh"
 #include "mem/ruby/profiler/Profiler.hh"
 #include "mem/ruby/protocol/RubyRequest.hh"
@@ -46,26 +48,10 @@ typedef AddressProfiler::AddressMap AddressMap;
 using gem5::stl_helpers::operator<<;
 
 // Helper functions
-AccessTraceForAddress&
+AccessTraceForAddress*
 lookupTraceForAddress(Addr addr, AddressMap& record_map)
 {
-    // we create a static default object here that is used to insert
-    // since the insertion will create a copy of the object in the
-    // process.  Perhaps this is optimizing early, but it doesn't seem
-    // like it could hurt.
-    static const AccessTraceForAddress dflt;
-
-    std::pair<AddressMap::iterator, bool> r =
-        record_map.insert(std::make_pair(addr, dflt));
-    AddressMap::iterator i = r.first;
-    AccessTraceForAddress &access_trace = i->second;
-    if (r.second) {
-        // there was nothing there and the insert succeed, so we need
-        // to actually set the address.
-        access_trace.setAddress(addr);
-    }
-
-    return access_trace;
+    return record_map.lookup(addr);
 }
 
 void
@@ -78,17 +64,30 @@ printSorted(std::ostream& out, int num_of_sequencers,
     uint64_t misses = 0;
     std::vector<const AccessTraceForAddress *> sorted;
 
-    AddressMap::const_iterator i = record_map.begin();
-    AddressMap::const_iterator end = record_map.end();
-    for (; i != end; ++i) {
-        const AccessTraceForAddress* record = &i->second;
+    for (const auto &trace : record_map.traces()) {
+        const AccessTraceForAddress* record = &trace.second;
         misses += record->getTotal();
         sorted.push_back(record);
     }
-    sort(sorted.begin(), sorted.end(), AccessTraceForAddress::less_equal);
+    std::sort(sorted.begin(), sorted.end(),
+              [](const AccessTraceForAddress *a,
+                 const AccessTraceForAddress *b)
+              { return a->getTotal() > b->getTotal(); });
+
+    // When bounded, the traces only hold the samples seen since their
+    // address was last tracked, so report them against all samples.
+    if (record_map.bounded()) {
+        misses = record_map.samples();
+        out << "Tracked_entries_" << description << ": "
+            << record_map.traces().size() << " of "
+            << record_map.maxEntries() << " (sketch "
+            << record_map.sketchWidth() << "x"
+            << record_map.sketchDepth() << ", "
+            << record_map.evictions() << " evictions)" << std::endl;
+    }
 
-    out << "Total_entries_" << description << ": " << record_map.size()
-        << std::endl;
+    out << "Total_entries_" << description << ": "
+        << record_map.traces().size() << std::endl;
     if (profiler->getAllInstructions()) {
         out << "Total_Instructions_" << description << ": " << misses
             << std::endl;
@@ -135,6 +134,7 @@ printSorted(std::ostream& out, int num_of_sequencers,
         remaining_records.add(record->getTotal());
         all_records_log.add(record->getTotal());
         remaining_records_log.add(record->getTotal());
+        counter++;
         m_touched_vec[record->getTouchedBy()]++;
         m_touched_weighted_vec[record->getTouchedBy()] += record->getTotal();
     }
@@ -154,10 +154,27 @@ printSorted(std::ostream& out, int num_of_sequencers,
         << std::endl;
 }
 
-AddressProfiler::AddressProfiler(int num_of_sequencers, Profiler *profiler)
-    : m_profiler(profiler)
+AddressProfiler::AddressProfiler(const RubySystemParams &p,
+                                 Profiler *profiler)
+    : m_sample_interval(p.profile_sample_interval),
+      m_dataAccessTrace(p.profile_max_entries, p.profile_sketch_width,
+                        p.profile_sketch_depth),
+      m_macroBlockAccessTrace(p.profile_max_entries, p.profile_sketch_width,
+                              p.profile_sketch_depth),
+      m_programCounterAccessTrace(p.profile_max_entries,
+                                  p.profile_sketch_width,
+                                  p.profile_sketch_depth),
+      m_retryProfileMap(p.profile_max_entries, p.profile_sketch_width,
+                        p.profile_sketch_depth),
+      m_profiler(profiler), m_hot_lines(false), m_all_instructions(false)
 {
-    m_num_of_sequencers = num_of_sequencers;
+    fatal_if(m_sample_interval == 0,
+             "The profile sample interval must be at least 1.");
+    fatal_if(p.profile_max_entries &&
+             (p.profile_sketch_width == 0 || p.profile_sketch_depth == 0),
+             "A bounded address profile needs a non-empty sketch.");
+
+    m_num_of_sequencers = p.num_of_sequencers;
     clearStats();
 }
 
@@ -249,6 +266,7 @@ AddressProfiler::clearStats()
 {
     // Clear the maps
     m_sharing_miss_counter = 0;
+    m_trace_samples = 0;
     m_dataAccessTrace.clear();
     m_macroBlockAccessTrace.clear();
     m_programCounterAccessTrace.clear();
@@ -295,40 +313,51 @@ AddressProfiler::profileGetS(Addr datablock, Addr PC,
                    requestor, indirection_miss);
 }
 
+bool
+AddressProfiler::sampleTrace()
+{
+    return m_trace_samples++ % m_sample_interval == 0;
+}
+
 void
 AddressProfiler::addTraceSample(Addr data_addr, Addr pc_addr,
                                 RubyRequestType type,
                                 RubyAccessMode access_mode, NodeID id,
                                 bool sharing_miss)
 {
-    if (m_all_instructions) {
-        if (sharing_miss) {
-            m_sharing_miss_counter++;
-        }
+    if (!m_hot_lines && !m_all_instructions)
+        return;
+
+    if (m_hot_lines && sharing_miss) {
+        m_sharing_miss_counter++;
+    }
 
+    if (!sampleTrace())
+        return;
+
+    if (m_hot_lines) {
         // record data address trace info
         data_addr = makeLineAddress(data_addr);
-        lookupTraceForAddress(data_addr, m_dataAccessTrace).
-            update(type, access_mode, id, sharing_miss);
+        if (auto *trace = lookupTraceForAddress(data_addr,
+                                                m_dataAccessTrace)) {
+            trace->update(type, access_mode, id, sharing_miss);
+        }
 
         // record macro data address trace info
 
         // 6 for datablock, 4 to make it 16x more coarse
         Addr macro_addr = mbits<Addr>(data_addr, 63, 10);
-        lookupTraceForAddress(macro_addr, m_macroBlockAccessTrace).
-            update(type, access_mode, id, sharing_miss);
-
-        // record program counter address trace info
-        lookupTraceForAddress(pc_addr, m_programCounterAccessTrace).
-            update(type, access_mode, id, sharing_miss);
+        if (auto *trace = lookupTraceForAddress(macro_addr,
+                                                m_macroBlockAccessTrace)) {
+            trace->update(type, access_mode, id, sharing_miss);
+        }
     }
 
-    if (m_all_instructions) {
-        // This code is used if the address profiler is an
-        // all-instructions profiler record program counter address
-        // trace info
-        lookupTraceForAddress(pc_addr, m_programCounterAccessTrace).
-            update(type, access_mode, id, sharing_miss);
+    // record program counter address trace info. This is all an
+    // all-instructions profiler records.
+    if (auto *trace = lookupTraceForAddress(pc_addr,
+                                            m_programCounterAccessTrace)) {
+        trace->update(type, access_mode, id, sharing_miss);
     }
 }
 
@@ -341,8 +370,11 @@ AddressProfiler::profileRetry(Addr data_addr, AccessType type, int count)
     } else {
         m_retryProfileHistoWrite.add(count);
     }
-    if (count > 1) {
-        lookupTraceForAddress(data_addr, m_retryProfileMap).addSample(count);
+    if (count > 1 && sampleTrace()) {
+        if (auto *trace = lookupTraceForAddress(data_addr,
+                                                m_retryProfileMap)) {
+            trace->addSample(count);
+        }
     }
 }
 
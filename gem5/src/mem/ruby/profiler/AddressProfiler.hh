@@ -30,11 +30,11 @@
 #define __MEM_RUBY_PROFILER_ADDRESSPROFILER_HH__
 
 #include <iostream>
-#include <unordered_map>
 
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/common/Histogram.hh"
 #include "mem/ruby/profiler/AccessTraceForAddress.hh"
+#include "mem/ruby/profiler/AddressTraceTable.hh"
 #include "mem/ruby/profiler/Profiler.hh"
 #include "mem/ruby/protocol/AccessType.hh"
 #include "mem/ruby/protocol/RubyRequest.hh"
@@ -50,10 +50,10 @@ class Set;
 class AddressProfiler
 {
   public:
-    typedef std::unordered_map<Addr, AccessTraceForAddress> AddressMap;
+    typedef AddressTraceTable AddressMap;
 
   public:
-    AddressProfiler(int num_of_sequencers, Profiler *profiler);
+    AddressProfiler(const RubySystemParams &p, Profiler *profiler);
     ~AddressProfiler();
 
     void printStats(std::ostream& out) const;
@@ -81,8 +81,15 @@ class AddressProfiler
     AddressProfiler(const AddressProfiler& obj);
     AddressProfiler& operator=(const AddressProfiler& obj);
 
+    /** Whether the next trace sample is recorded. */
+    bool sampleTrace();
+
     int64_t m_sharing_miss_counter;
 
+    /** Record one in this many trace samples. */
+    const unsigned m_sample_interval;
+    uint64_t m_trace_samples;
+
     AddressMap m_dataAccessTrace;
     AddressMap m_macroBlockAccessTrace;
     AddressMap m_programCounterAccessTrace;
@@ -102,7 +109,11 @@ class AddressProfiler
     int m_num_of_sequencers;
 };
 
-AccessTraceForAddress& lookupTraceForAddress(Addr addr,
+/**
+ * The trace of an address, or nullptr if the map is bounded and the
+ * address is not among its heaviest ones.
+ */
+AccessTraceForAddress* lookupTraceForAddress(Addr addr,
                                              AddressProfiler::AddressMap&
                                              record_map);
 
@@ -0,0 +1,143 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/ruby/profiler/AddressTraceTable.hh"
+
+#include <algorithm>
+#include <limits>
+
+namespace gem5
+{
+
+namespace ruby
+{
+
+AddressTraceTable::AddressTraceTable(unsigned max_entries,
+                                     unsigned sketch_width,
+                                     unsigned sketch_depth)
+    : m_max_entries(max_entries),
+      m_width(max_entries ? sketch_width : 0),
+      m_depth(max_entries ? sketch_depth : 0),
+      m_sketch(m_width * m_depth, 0),
+      m_min_addr(0), m_min_estimate(0),
+      m_samples(0), m_evictions(0)
+{
+    if (bounded())
+        m_traces.reserve(m_max_entries + 1);
+}
+
+unsigned
+AddressTraceTable::hash(Addr addr, unsigned row) const
+{
+    uint64_t h = addr ^ ((row + 1) * 0x9e3779b97f4a7c15ULL);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h % m_width;
+}
+
+uint64_t
+AddressTraceTable::estimate(Addr addr) const
+{
+    if (!bounded()) {
+        auto it = m_traces.find(addr);
+        return it == m_traces.end() ? 0 : it->second.getTotal();
+    }
+
+    uint64_t est = std::numeric_limits<uint64_t>::max();
+    for (unsigned row = 0; row < m_depth; row++)
+        est = std::min(est, m_sketch[row * m_width + hash(addr, row)]);
+    return est;
+}
+
+void
+AddressTraceTable::updateMin()
+{
+    m_min_estimate = std::numeric_limits<uint64_t>::max();
+    for (const auto &trace : m_traces) {
+        uint64_t est = estimate(trace.first);
+        if (est < m_min_estimate) {
+            m_min_estimate = est;
+            m_min_addr = trace.first;
+        }
+    }
+}
+
+AccessTraceForAddress *
+AddressTraceTable::lookup(Addr addr)
+{
+    m_samples++;
+
+    if (!bounded()) {
+        auto &trace = m_traces[addr];
+        trace.setAddress(addr);
+        return &trace;
+    }
+
+    uint64_t est = std::numeric_limits<uint64_t>::max();
+    for (unsigned row = 0; row < m_depth; row++) {
+        uint64_t &count = m_sketch[row * m_width + hash(addr, row)];
+        est = std::min(est, ++count);
+    }
+
+    auto it = m_traces.find(addr);
+    if (it != m_traces.end())
+        return &it->second;
+
+    if (m_traces.size() >= m_max_entries) {
+        if (est <= m_min_estimate)
+            return nullptr;
+
+        // The cached minimum may have grown since it was computed.
+        updateMin();
+        if (est <= m_min_estimate)
+            return nullptr;
+
+        m_traces.erase(m_min_addr);
+        m_evictions++;
+    }
+
+    auto &trace = m_traces[addr];
+    trace.setAddress(addr);
+    if (m_traces.size() >= m_max_entries)
+        updateMin();
+    return &trace;
+}
+
+void
+AddressTraceTable::clear()
+{
+    m_traces.clear();
+    std::fill(m_sketch.begin(), m_sketch.end(), 0);
+    m_min_addr = 0;
+    m_min_estimate = 0;
+    m_samples = 0;
+    m_evictions = 0;
+}
+
+} // namespace ruby
+} // namespace gem5
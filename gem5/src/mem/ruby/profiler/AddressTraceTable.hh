@@ -0,0 +1,119 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_PROFILER_ADDRESSTRACETABLE_HH__
+#define __MEM_RUBY_PROFILER_ADDRESSTRACETABLE_HH__
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "mem/ruby/common/Address.hh"
+#include "mem/ruby/profiler/AccessTraceForAddress.hh"
+
+namespace gem5
+{
+
+namespace ruby
+{
+
+/**
+ * The access traces of the addresses seen by a profiler. Unbounded, the
+ * table keeps a trace of every address. Bounded, it only keeps the
+ * traces of the heaviest addresses: a count-min sketch estimates how
+ * often every address was seen, and the kept address with the lowest
+ * estimate makes room for an address whose estimate exceeds it.
+ */
+class AddressTraceTable
+{
+  public:
+    typedef std::unordered_map<Addr, AccessTraceForAddress> TraceMap;
+
+    /**
+     * @param max_entries Number of traces kept, 0 for no limit.
+     * @param sketch_width Counters per row of the sketch.
+     * @param sketch_depth Rows of the sketch.
+     */
+    AddressTraceTable(unsigned max_entries=0, unsigned sketch_width=0,
+                      unsigned sketch_depth=0);
+
+    AddressTraceTable(const AddressTraceTable &) = delete;
+    AddressTraceTable &operator=(const AddressTraceTable &) = delete;
+
+    /**
+     * Count a sample of an address.
+     * @return The trace of the address, or nullptr if it is not among
+     * the heaviest ones.
+     */
+    AccessTraceForAddress *lookup(Addr addr);
+
+    /** The estimated number of samples of an address. */
+    uint64_t estimate(Addr addr) const;
+
+    const TraceMap &traces() const { return m_traces; }
+    bool bounded() const { return m_max_entries != 0; }
+    unsigned maxEntries() const { return m_max_entries; }
+    unsigned sketchWidth() const { return m_width; }
+    unsigned sketchDepth() const { return m_depth; }
+
+    /** Samples counted, including those of addresses not kept. */
+    uint64_t samples() const { return m_samples; }
+
+    /** Traces dropped to make room for heavier addresses. */
+    uint64_t evictions() const { return m_evictions; }
+
+    void clear();
+
+  private:
+    /** Index of an address in a row of the sketch. */
+    unsigned hash(Addr addr, unsigned row) const;
+
+    /** Find the kept address with the lowest estimate. */
+    void updateMin();
+
+    TraceMap m_traces;
+
+    const unsigned m_max_entries;
+    const unsigned m_width;
+    const unsigned m_depth;
+
+    /** The sketch, one row of m_width counters after the other. */
+    std::vector<uint64_t> m_sketch;
+
+    /**
+     * The kept address with the lowest estimate, and that estimate when
+     * it was last computed. Estimates only grow, so it is a lower bound.
+     */
+    Addr m_min_addr;
+    uint64_t m_min_estimate;
+
+    uint64_t m_samples;
+    uint64_t m_evictions;
+};
+
+} // namespace ruby
+} // namespace gem5
+
+#endif // __MEM_RUBY_PROFILER_ADDRESSTRACETABLE_HH__
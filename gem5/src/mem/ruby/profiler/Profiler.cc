@@ -50,6 +50,7 @@
 #include <algorithm>
 #include <fstream>
 
+#include "base/output.hh"
 #include "base/stl_helpers.hh"
 #include "base/str.hh"
 #include "config/build_gpu.hh"
@@ -57,6 +58,7 @@
 #include "mem/ruby/profiler/AddressProfiler.hh"
 #include "mem/ruby/protocol/MachineType.hh"
 #include "mem/ruby/protocol/RubyRequest.hh"
+#include "sim/core.hh"
 
 /**
  * the profiler uses GPUCoalescer code even
@@ -92,15 +94,27 @@ Profiler::Profiler(const RubySystemParams &p, RubySystem *rs)
       m_num_vnets(p.number_of_virtual_networks),
       rubyProfilerStats(rs, this)
 {
-    m_address_profiler_ptr = new AddressProfiler(p.num_of_sequencers, this);
+    m_address_profiler_ptr = new AddressProfiler(p, this);
     m_address_profiler_ptr->setHotLines(m_hot_lines);
     m_address_profiler_ptr->setAllInstructions(m_all_instructions);
 
+    m_inst_profiler_ptr = nullptr;
     if (m_all_instructions) {
-        m_inst_profiler_ptr = new AddressProfiler(p.num_of_sequencers, this);
+        m_inst_profiler_ptr = new AddressProfiler(p, this);
         m_inst_profiler_ptr->setHotLines(m_hot_lines);
         m_inst_profiler_ptr->setAllInstructions(m_all_instructions);
     }
+
+    if (m_hot_lines || m_all_instructions) {
+        std::string file_name = rs->name() + ".address_profile.txt";
+        registerExitCallback([this, file_name]() {
+            OutputStream *os = simout.create(file_name);
+            m_address_profiler_ptr->printStats(*os->stream());
+            if (m_inst_profiler_ptr)
+                m_inst_profiler_ptr->printStats(*os->stream());
+            simout.close(os);
+        });
+    }
 }
 
 Profiler::~Profiler()
@@ -571,7 +585,16 @@ Profiler::collateStats()
 void
 Profiler::addAddressTraceSample(const RubyRequest& msg, NodeID id)
 {
-    if (msg.getType() != RubyRequestType_IFETCH) {
+    if (!m_hot_lines && !m_all_instructions)
+        return;
+
+    if (msg.getType() == RubyRequestType_IFETCH) {
+        if (m_inst_profiler_ptr) {
+            m_inst_profiler_ptr->
+                addTraceSample(msg.getLineAddress(), msg.getProgramCounter(),
+                               msg.getType(), msg.getAccessMode(), id, false);
+        }
+    } else {
         // Note: The following line should be commented out if you
         // want to use the special profiling that is part of the GS320
         // protocol
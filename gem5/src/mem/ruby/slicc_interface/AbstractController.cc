@@ -267,7 +267,7 @@ AbstractController::serviceMemoryQueue()
     }
 
     RequestPtr req
-        = std::make_shared<Request>(mem_msg->m_addr, req_size, 0, m_id);
+        = makeRequest(mem_msg->m_addr, req_size, 0, m_id);
     PacketPtr pkt;
     if (mem_msg->getType() == MemoryRequestType_MEMORY_WB) {
         pkt = Packet::createWrite(req);
@@ -363,13 +363,25 @@ AbstractController::functionalMemoryWrite(PacketPtr pkt)
     return num_functional_writes + 1;
 }
 
+void
+AbstractController::updateLineOwner(Addr addr)
+{
+    Addr line_addr = makeLineAddress(addr);
+    if (getAccessPermission(line_addr) == AccessPermission_Read_Write) {
+        if (m_owned_lines.insert(line_addr).second)
+            params().ruby_system->addLineOwner(line_addr, this);
+    } else if (m_owned_lines.erase(line_addr)) {
+        params().ruby_system->removeLineOwner(line_addr, this);
+    }
+}
+
 void
 AbstractController::recvTimingResp(PacketPtr pkt)
 {
     assert(getMemRespQueue());
     assert(pkt->isResponse());
 
-    std::shared_ptr<MemoryMsg> msg = std::make_shared<MemoryMsg>(clockEdge());
+    std::shared_ptr<MemoryMsg> msg = makeMessage<MemoryMsg>(clockEdge());
     (*msg).m_addr = pkt->getAddr();
     (*msg).m_Sender = m_machineID;
 
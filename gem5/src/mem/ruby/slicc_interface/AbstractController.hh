@@ -45,6 +45,7 @@
 #include <iostream>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "base/addr_range.hh"
 #include "base/addr_range_map.hh"
@@ -139,6 +140,11 @@ class AbstractController : public ClockedObject, public Consumer
     virtual int functionalWrite(const Addr &addr, PacketPtr) = 0;
     int functionalMemoryWrite(PacketPtr);
 
+    //! Updates the RubySystem index of the lines held with Read_Write
+    //! permission, which functional reads go to before searching every
+    //! controller. Called by the generated code after each transition.
+    void updateLineOwner(Addr addr);
+
     //! Function for enqueuing a prefetch request
     virtual void enqueuePrefetch(const Addr &, const RubyRequestType&)
     { fatal("Prefetches not implemented!");}
@@ -330,6 +336,9 @@ class AbstractController : public ClockedObject, public Consumer
     const Cycles m_mandatory_queue_latency;
     bool m_waiting_mem_retry;
 
+    //! Lines this controller is recorded as Read_Write owner of
+    std::unordered_set<Addr> m_owned_lines;
+
     /**
      * Port that forwards requests and receives responses from the
      * memory controller.
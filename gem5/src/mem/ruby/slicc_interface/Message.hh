@@ -44,7 +44,9 @@
 #include <iostream>
 #include <memory>
 #include <stack>
+#include <utility>
 
+#include "base/pool_allocator.hh"
 #include "mem/packet.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/common/WriteMask.hh"
@@ -144,6 +146,18 @@ operator>(const MsgPtr &lhs, const MsgPtr &rhs)
     return l->getLastEnqueueTime() > r->getLastEnqueueTime();
 }
 
+/**
+ * Messages are created and dropped at a very high rate, allocate them
+ * together with their reference count from a FreeListPool.
+ */
+template <class T, typename... Args>
+inline std::shared_ptr<T>
+makeMessage(Args&&... args)
+{
+    return std::allocate_shared<T>(PoolAllocator<T>(),
+                                   std::forward<Args>(args)...);
+}
+
 inline std::ostream&
 operator<<(std::ostream& out, const Message& obj)
 {
@@ -45,6 +45,7 @@
 
 #include "base/bitfield.hh"
 #include "debug/RubyPrefetcher.hh"
+#include "mem/cache/prefetch/associative_set_impl.hh"
 #include "mem/ruby/slicc_interface/RubySlicc_ComponentMapping.hh"
 #include "mem/ruby/system/RubySystem.hh"
 
@@ -58,15 +59,24 @@ RubyPrefetcher::RubyPrefetcher(const Params &p)
     : SimObject(p), m_num_streams(p.num_streams),
     m_array(p.num_streams), m_train_misses(p.train_misses),
     m_num_startup_pfs(p.num_startup_pfs),
-    unitFilter(p.unit_filter),
-    negativeFilter(p.unit_filter),
-    nonUnitFilter(p.nonunit_filter),
+    unitFilter(p.unit_filter_assoc, p.unit_filter,
+               p.unit_filter_indexing_policy,
+               p.unit_filter_replacement_policy),
+    negativeFilter(p.unit_filter_assoc, p.unit_filter,
+                   p.negative_filter_indexing_policy,
+                   p.unit_filter_replacement_policy),
+    nonUnitFilter(p.nonunit_filter_assoc, p.nonunit_filter,
+                  p.nonunit_filter_indexing_policy,
+                  p.nonunit_filter_replacement_policy),
     m_prefetch_cross_pages(p.cross_page),
     pageShift(p.page_shift),
     rubyPrefetcherStats(this)
 {
     assert(m_num_streams > 0);
-    assert(m_num_startup_pfs <= MAX_PF_INFLIGHT);
+    for (auto &stream : m_array) {
+        stream.requestIssued.resize(m_num_startup_pfs, false);
+        stream.requestCompleted.resize(m_num_startup_pfs, false);
+    }
 }
 
 RubyPrefetcher::
@@ -168,6 +178,10 @@ RubyPrefetcher::issueNextPrefetch(Addr address, PrefetchEntry *stream)
     Addr line_addr = makeNextStrideAddress(stream->m_address,
                                          stream->m_stride);
 
+    // the addresses in flight move with the stream
+    const uint32_t index = stream - m_array.data();
+    unindexStream(index);
+
     // possibly stop prefetching at page boundaries
     if (page_addr != pageAddress(line_addr)) {
         if (!m_prefetch_cross_pages) {
@@ -182,6 +196,7 @@ RubyPrefetcher::issueNextPrefetch(Addr address, PrefetchEntry *stream)
     // launch next prefetch
     rubyPrefetcherStats.numPrefetchRequested++;
     stream->m_address = line_addr;
+    indexStream(index);
     stream->m_use_time = m_controller->curCycle();
     DPRINTF(RubyPrefetcher, "Requesting prefetch for %#x\n", line_addr);
     m_controller->enqueuePrefetch(line_addr, stream->m_type);
@@ -214,6 +229,7 @@ RubyPrefetcher::initializeStream(Addr address, int stride,
 
     // initialize the stream prefetcher
     PrefetchEntry *mystream = &(m_array[index]);
+    unindexStream(index);
     mystream->m_address = makeLineAddress(address);
     mystream->m_stride = stride;
     mystream->m_use_time = m_controller->curCycle();
@@ -245,47 +261,99 @@ RubyPrefetcher::initializeStream(Addr address, int stride,
 
     // update the address to be the last address prefetched
     mystream->m_address = line_addr;
+    indexStream(index);
+}
+
+void
+RubyPrefetcher::indexStream(uint32_t stream)
+{
+    const PrefetchEntry &entry = m_array[stream];
+    if (!entry.m_is_valid) {
+        return;
+    }
+    for (int j = 0; j < m_num_startup_pfs; j++) {
+        m_stream_index.emplace(
+            makeNextStrideAddress(entry.m_address, -(entry.m_stride * j)),
+            stream);
+    }
+}
+
+void
+RubyPrefetcher::unindexStream(uint32_t stream)
+{
+    const PrefetchEntry &entry = m_array[stream];
+    if (!entry.m_is_valid) {
+        return;
+    }
+    for (int j = 0; j < m_num_startup_pfs; j++) {
+        auto range = m_stream_index.equal_range(
+            makeNextStrideAddress(entry.m_address, -(entry.m_stride * j)));
+        for (auto it = range.first; it != range.second;) {
+            if (it->second == stream) {
+                it = m_stream_index.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
 }
 
 PrefetchEntry *
 RubyPrefetcher::getPrefetchEntry(Addr address, uint32_t &index)
 {
-    // search all streams for a match
-    for (int i = 0; i < m_num_streams; i++) {
-        // search all the outstanding prefetches for this stream
-        if (m_array[i].m_is_valid) {
-            for (int j = 0; j < m_num_startup_pfs; j++) {
-                if (makeNextStrideAddress(m_array[i].m_address,
-                    -(m_array[i].m_stride*j)) == address) {
-                    return &(m_array[i]);
-                }
-            }
+    // several streams may have the address in flight, pick the first one
+    // of the array as a scan of all the streams would
+    auto range = m_stream_index.equal_range(address);
+    PrefetchEntry *stream = NULL;
+    for (auto it = range.first; it != range.second; ++it) {
+        if (stream == NULL || &m_array[it->second] < stream) {
+            stream = &m_array[it->second];
         }
     }
-    return NULL;
+    if (stream == NULL) {
+        return NULL;
+    }
+
+    for (int j = 0; j < m_num_startup_pfs; j++) {
+        if (makeNextStrideAddress(stream->m_address,
+            -(stream->m_stride*j)) == address) {
+            index = j;
+            break;
+        }
+    }
+    return stream;
 }
 
 bool
-RubyPrefetcher::accessUnitFilter(CircularQueue<UnitFilterEntry>* const filter,
+RubyPrefetcher::accessUnitFilter(UnitFilter* const filter,
     Addr line_addr, int stride, const RubyRequestType& type)
 {
-    for (auto& entry : *filter) {
-        if (entry.addr == line_addr) {
-            entry.addr = makeNextStrideAddress(entry.addr, stride);
-            entry.hits++;
-            if (entry.hits >= m_train_misses) {
-                // Allocate a new prefetch stream
-                initializeStream(line_addr, stride, getLRUindex(), type);
-            }
-            return true;
+    // the filters are keyed by line number, so that consecutive lines
+    // map to different sets
+    const unsigned line_shift = RubySystem::getBlockSizeBits();
+
+    uint32_t hits = 0;
+    UnitFilterEntry *entry = filter->findEntry(line_addr >> line_shift,
+                                               false);
+    if (entry != nullptr) {
+        hits = entry->hits + 1;
+        // the entry now waits for the next line of the stride, which is
+        // in another set, so it is moved there
+        filter->invalidate(entry);
+        if (hits >= m_train_misses) {
+            // Allocate a new prefetch stream
+            initializeStream(line_addr, stride, getLRUindex(), type);
         }
     }
 
-    // Enter this address in the filter
-    filter->push_back(UnitFilterEntry(
-        makeNextStrideAddress(line_addr, stride)));
+    // Enter the next address in the filter
+    const Addr next_addr = makeNextStrideAddress(line_addr, stride);
+    UnitFilterEntry *victim = filter->findVictim(next_addr >> line_shift);
+    filter->insertEntry(next_addr >> line_shift, false, victim);
+    victim->addr = next_addr;
+    victim->hits = hits;
 
-    return false;
+    return entry != nullptr;
 }
 
 bool
@@ -295,49 +363,53 @@ RubyPrefetcher::accessNonunitFilter(Addr line_addr,
     /// look for non-unit strides based on a (user-defined) page size
     Addr page_addr = pageAddress(line_addr);
 
-    for (auto& entry : nonUnitFilter) {
-        if (pageAddress(entry.addr) == page_addr) {
-            // hit in the non-unit filter
-            // compute the actual stride (for this reference)
-            int delta = line_addr - entry.addr;
-
-            if (delta != 0) {
-                // no zero stride prefetches
-                // check that the stride matches (for the last N times)
-                if (delta == entry.stride) {
-                    // -> stride hit
-                    // increment count (if > 2) allocate stream
-                    entry.hits++;
-                    if (entry.hits > m_train_misses) {
-                        // This stride HAS to be the multiplicative constant of
-                        // dataBlockBytes (bc makeNextStrideAddress is
-                        // calculated based on this multiplicative constant!)
-                        const int stride = entry.stride /
-                            RubySystem::getBlockSizeBytes();
-
-                        // clear this filter entry
-                        entry.clear();
-
-                        initializeStream(line_addr, stride, getLRUindex(),
-                            type);
-                    }
-                } else {
-                    // If delta didn't match reset entry's hit count
-                    entry.hits = 0;
+    NonUnitFilterEntry *entry = nonUnitFilter.findEntry(
+        page_addr >> pageShift, false);
+    if (entry != nullptr) {
+        // hit in the non-unit filter
+        nonUnitFilter.accessEntry(entry);
+
+        // compute the actual stride (for this reference)
+        int delta = line_addr - entry->addr;
+
+        if (delta != 0) {
+            // no zero stride prefetches
+            // check that the stride matches (for the last N times)
+            if (delta == entry->stride) {
+                // -> stride hit
+                // increment count (if > 2) allocate stream
+                entry->hits++;
+                if (entry->hits > m_train_misses) {
+                    // This stride HAS to be the multiplicative constant of
+                    // dataBlockBytes (bc makeNextStrideAddress is
+                    // calculated based on this multiplicative constant!)
+                    const int stride = entry->stride /
+                        RubySystem::getBlockSizeBytes();
+
+                    // clear this filter entry
+                    entry->clear();
+
+                    initializeStream(line_addr, stride, getLRUindex(),
+                        type);
                 }
-
-                // update the last address seen & the stride
-                entry.addr = line_addr;
-                entry.stride = delta;
-                return true;
             } else {
-                return false;
+                // If delta didn't match reset entry's hit count
+                entry->hits = 0;
             }
+
+            // update the last address seen & the stride
+            entry->addr = line_addr;
+            entry->stride = delta;
+            return true;
+        } else {
+            return false;
         }
     }
 
     // not found: enter this address in the table
-    nonUnitFilter.push_back(NonUnitFilterEntry(line_addr));
+    entry = nonUnitFilter.findVictim(page_addr >> pageShift);
+    nonUnitFilter.insertEntry(page_addr >> pageShift, false, entry);
+    entry->addr = line_addr;
 
     return false;
 }
@@ -349,17 +421,21 @@ RubyPrefetcher::print(std::ostream& out) const
     // print out unit filter
     out << "unit table:\n";
     for (const auto& entry : unitFilter) {
-        out << entry.addr << std::endl;
+        if (entry.isValid())
+            out << entry.addr << std::endl;
     }
 
     out << "negative table:\n";
     for (const auto& entry : negativeFilter) {
-        out << entry.addr << std::endl;
+        if (entry.isValid())
+            out << entry.addr << std::endl;
     }
 
     // print out non-unit stride filter
     out << "non-unit table:\n";
     for (const auto& entry : nonUnitFilter) {
+        if (!entry.isValid())
+            continue;
         out << entry.addr << " "
             << entry.stride << " "
             << entry.hits << std::endl;
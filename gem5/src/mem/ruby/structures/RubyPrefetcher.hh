@@ -44,10 +44,11 @@
 
 // Implements Power 4 like prefetching
 
-#include <bitset>
+#include <unordered_map>
+#include <vector>
 
-#include "base/circular_queue.hh"
 #include "base/statistics.hh"
+#include "mem/cache/prefetch/associative_set.hh"
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/network/MessageBuffer.hh"
 #include "mem/ruby/slicc_interface/AbstractController.hh"
@@ -56,8 +57,6 @@
 #include "params/RubyPrefetcher.hh"
 #include "sim/sim_object.hh"
 
-#define MAX_PF_INFLIGHT 8
-
 namespace gem5
 {
 
@@ -91,10 +90,10 @@ class PrefetchEntry
         //! L1D prefetches loads and stores
         RubyRequestType m_type;
 
-        //! Bitset for tracking prefetches for which addresses have been
-        //! issued, which ones have completed.
-        std::bitset<MAX_PF_INFLIGHT> requestIssued;
-        std::bitset<MAX_PF_INFLIGHT> requestCompleted;
+        //! Bits for tracking prefetches for which addresses have been
+        //! issued, which ones have completed, one per prefetch in flight.
+        std::vector<bool> requestIssued;
+        std::vector<bool> requestCompleted;
 };
 
 class RubyPrefetcher : public SimObject
@@ -129,26 +128,39 @@ class RubyPrefetcher : public SimObject
         { m_controller = _ctrl; }
 
     private:
-        struct UnitFilterEntry
+        /**
+         * A unit filter entry, tagged with the line number it expects
+         * next.
+         */
+        struct UnitFilterEntry : public TaggedEntry
         {
             /** Address to which this filter entry refers. */
             Addr addr;
             /** Counter of the number of times this entry has been hit. */
             uint32_t hits;
 
-            UnitFilterEntry(Addr _addr = 0)
-              : addr(_addr), hits(0)
+            UnitFilterEntry()
+              : TaggedEntry(), addr(0), hits(0)
             {
             }
+
+            void
+            invalidate() override
+            {
+                TaggedEntry::invalidate();
+                addr = 0;
+                hits = 0;
+            }
         };
 
+        /** A non-unit filter entry, tagged with its page number. */
         struct NonUnitFilterEntry : public UnitFilterEntry
         {
             /** Stride (in # of cache lines). */
             int stride;
 
-            NonUnitFilterEntry(Addr _addr = 0)
-              : UnitFilterEntry(_addr), stride(0)
+            NonUnitFilterEntry()
+              : UnitFilterEntry(), stride(0)
             {
             }
 
@@ -159,8 +171,18 @@ class RubyPrefetcher : public SimObject
                 stride = 0;
                 hits = 0;
             }
+
+            void
+            invalidate() override
+            {
+                UnitFilterEntry::invalidate();
+                stride = 0;
+            }
         };
 
+        typedef AssociativeSet<UnitFilterEntry> UnitFilter;
+        typedef AssociativeSet<NonUnitFilterEntry> NonUnitFilter;
+
         /**
          * Returns an unused stream buffer (or if all are used, returns the
          * least recently used (accessed) stream buffer).
@@ -177,6 +199,15 @@ class RubyPrefetcher : public SimObject
         PrefetchEntry* getPrefetchEntry(Addr address,
             uint32_t &index);
 
+        /**
+         * Add (remove) the addresses a valid stream has in flight to
+         * (from) the stream index.
+         *
+         * @param stream Index of the stream in m_array.
+         */
+        void indexStream(uint32_t stream);
+        void unindexStream(uint32_t stream);
+
         /**
          * Access a unit stride filter to determine if there is a hit, and
          * update it otherwise.
@@ -187,7 +218,7 @@ class RubyPrefetcher : public SimObject
          * @param type Type of the request that generated the access.
          * @return True if a corresponding entry was found.
          */
-        bool accessUnitFilter(CircularQueue<UnitFilterEntry>* const filter,
+        bool accessUnitFilter(UnitFilter* const filter,
             Addr line_addr, int stride, const RubyRequestType& type);
 
         /**
@@ -208,6 +239,11 @@ class RubyPrefetcher : public SimObject
         uint32_t m_num_streams;
         //! an array of the active prefetch streams
         std::vector<PrefetchEntry> m_array;
+        /**
+         * The streams of m_array, hashed by the line addresses they have
+         * in flight, so that a miss does not scan all the streams.
+         */
+        std::unordered_multimap<Addr, uint32_t> m_stream_index;
 
         //! number of misses I must see before allocating a stream
         uint32_t m_train_misses;
@@ -218,19 +254,19 @@ class RubyPrefetcher : public SimObject
          * A unit stride filter array: helps reduce BW requirement
          * of prefetching.
          */
-        CircularQueue<UnitFilterEntry> unitFilter;
+        UnitFilter unitFilter;
 
         /**
          * A negative unit stride filter array: helps reduce BW requirement
          * of prefetching.
          */
-        CircularQueue<UnitFilterEntry> negativeFilter;
+        UnitFilter negativeFilter;
 
         /**
          * A non-unit stride filter array: helps reduce BW requirement of
          * prefetching.
          */
-        CircularQueue<NonUnitFilterEntry> nonUnitFilter;
+        NonUnitFilter nonUnitFilter;
 
         /// Used for allowing prefetches across pages.
         bool m_prefetch_cross_pages;
@@ -40,6 +40,8 @@ from m5.SimObject import SimObject
 from m5.params import *
 from m5.proxy import *
 
+from m5.objects.IndexingPolicies import *
+from m5.objects.ReplacementPolicies import *
 from m5.objects.System import System
 
 class RubyPrefetcher(SimObject):
@@ -51,10 +53,31 @@ class RubyPrefetcher(SimObject):
         "Number of prefetch streams to be allocated")
     unit_filter  = Param.UInt32(8,
         "Number of entries in the unit filter array")
+    unit_filter_assoc = Param.UInt32(8,
+        "Associativity of the unit filter arrays")
+    unit_filter_indexing_policy = Param.BaseIndexingPolicy(
+        SetAssociative(entry_size = 1, assoc = Parent.unit_filter_assoc,
+        size = Parent.unit_filter),
+        "Indexing policy of the unit filter array")
+    negative_filter_indexing_policy = Param.BaseIndexingPolicy(
+        SetAssociative(entry_size = 1, assoc = Parent.unit_filter_assoc,
+        size = Parent.unit_filter),
+        "Indexing policy of the negative unit filter array")
+    unit_filter_replacement_policy = Param.BaseReplacementPolicy(LRURP(),
+        "Replacement policy of the unit filter arrays")
     nonunit_filter = Param.UInt32(8,
         "Number of entries in the non-unit filter array")
+    nonunit_filter_assoc = Param.UInt32(8,
+        "Associativity of the non-unit filter array")
+    nonunit_filter_indexing_policy = Param.BaseIndexingPolicy(
+        SetAssociative(entry_size = 1, assoc = Parent.nonunit_filter_assoc,
+        size = Parent.nonunit_filter),
+        "Indexing policy of the non-unit filter array")
+    nonunit_filter_replacement_policy = Param.BaseReplacementPolicy(LRURP(),
+        "Replacement policy of the non-unit filter array")
     train_misses = Param.UInt32(4, "")
-    num_startup_pfs = Param.UInt32(1, "")
+    num_startup_pfs = Param.UInt32(1, "Number of prefetches a stream "
+        "keeps in flight, i.e. its prefetch distance")
     cross_page = Param.Bool(False, """True if prefetched address can be on a
             page different from the observed address""")
     page_shift = Param.UInt32(12,
@@ -42,8 +42,8 @@
 #define __MEM_RUBY_STRUCTURES_TBETABLE_HH__
 
 #include <iostream>
-#include <unordered_map>
 
+#include "mem/ruby/common/AddrMap.hh"
 #include "mem/ruby/common/Address.hh"
 
 namespace gem5
@@ -57,7 +57,7 @@ class TBETable
 {
   public:
     TBETable(int number_of_TBEs)
-        : m_number_of_TBEs(number_of_TBEs)
+        : m_map(number_of_TBEs), m_number_of_TBEs(number_of_TBEs)
     {
     }
 
@@ -82,7 +82,8 @@ class TBETable
     TBETable& operator=(const TBETable& obj);
 
     // Data Members (m_prefix)
-    std::unordered_map<Addr, ENTRY> m_map;
+    // All the TBEs are allocated up front, allocate() only resets one
+    AddrMap<ENTRY> m_map;
 
   private:
     int m_number_of_TBEs;
@@ -103,7 +104,7 @@ TBETable<ENTRY>::isPresent(Addr address) const
 {
     assert(address == makeLineAddress(address));
     assert(m_map.size() <= m_number_of_TBEs);
-    return !!m_map.count(address);
+    return m_map.count(address);
 }
 
 template<class ENTRY>
@@ -112,7 +113,7 @@ TBETable<ENTRY>::allocate(Addr address)
 {
     assert(!isPresent(address));
     assert(m_map.size() < m_number_of_TBEs);
-    m_map[address] = ENTRY();
+    m_map[address];
 }
 
 template<class ENTRY>
@@ -136,8 +137,7 @@ template<class ENTRY>
 inline ENTRY*
 TBETable<ENTRY>::lookup(Addr address)
 {
-  if (m_map.find(address) != m_map.end()) return &(m_map.find(address)->second);
-  return NULL;
+    return m_map.find(address);
 }
 
 
@@ -29,6 +29,8 @@
 
 #include "mem/ruby/system/CacheRecorder.hh"
 
+#include <algorithm>
+
 #include "debug/RubyCacheTrace.hh"
 #include "mem/ruby/system/RubySystem.hh"
 #include "mem/ruby/system/Sequencer.hh"
@@ -50,18 +52,22 @@ TraceRecord::print(std::ostream& out) const
 CacheRecorder::CacheRecorder()
     : m_uncompressed_trace(NULL),
       m_uncompressed_trace_size(0),
-      m_block_size_bytes(RubySystem::getBlockSizeBytes())
+      m_block_size_bytes(RubySystem::getBlockSizeBytes()),
+      m_parallel_fetch(false)
 {
 }
 
 CacheRecorder::CacheRecorder(uint8_t* uncompressed_trace,
                              uint64_t uncompressed_trace_size,
+                             int trace_format,
                              std::vector<Sequencer*>& seq_map,
-                             uint64_t block_size_bytes)
+                             uint64_t block_size_bytes,
+                             bool parallel_fetch)
     : m_uncompressed_trace(uncompressed_trace),
       m_uncompressed_trace_size(uncompressed_trace_size),
-      m_seq_map(seq_map),  m_bytes_read(0), m_records_read(0),
-      m_records_flushed(0), m_block_size_bytes(block_size_bytes)
+      m_seq_map(seq_map), m_records_read(0),
+      m_records_flushed(0), m_block_size_bytes(block_size_bytes),
+      m_parallel_fetch(parallel_fetch)
 {
     if (m_uncompressed_trace != NULL) {
         if (m_block_size_bytes < RubySystem::getBlockSizeBytes()) {
@@ -71,6 +77,29 @@ CacheRecorder::CacheRecorder(uint8_t* uncompressed_trace,
             panic("Recorded cache block size (%d) < current block size (%d) !!",
                     m_block_size_bytes, RubySystem::getBlockSizeBytes());
         }
+
+        if (trace_format == traceFormat) {
+            decodeTrace();
+        } else if (trace_format != 0) {
+            fatal("Unknown ruby cache trace format %d\n", trace_format);
+        }
+
+        // Without parallel_fetch, all the records share the queue of the
+        // null sequencer
+        uint64_t record_size = sizeof(TraceRecord) + m_block_size_bytes;
+        for (uint64_t offset = 0; offset < m_uncompressed_trace_size;
+             offset += record_size) {
+            TraceRecord *rec = (TraceRecord*)(m_uncompressed_trace + offset);
+            Sequencer *seq =
+                m_parallel_fetch ? m_seq_map[rec->m_cntrl_id] : nullptr;
+            auto it = m_fetch_queue_of.find(seq);
+            if (it == m_fetch_queue_of.end()) {
+                it = m_fetch_queue_of.emplace(seq,
+                                              m_fetch_queues.size()).first;
+                m_fetch_queues.emplace_back();
+            }
+            m_fetch_queues[it->second].records.push_back(rec);
+        }
     }
 }
 
@@ -89,9 +118,9 @@ CacheRecorder::enqueueNextFlushRequest()
     if (m_records_flushed < m_records.size()) {
         TraceRecord* rec = m_records[m_records_flushed];
         m_records_flushed++;
-        auto req = std::make_shared<Request>(rec->m_data_address,
-                                             m_block_size_bytes, 0,
-                                             Request::funcRequestorId);
+        auto req = makeRequest(rec->m_data_address,
+                               m_block_size_bytes, 0,
+                               Request::funcRequestorId);
         MemCmd::Command requestType = MemCmd::FlushReq;
         Packet *pkt = new Packet(req, requestType);
 
@@ -106,52 +135,77 @@ CacheRecorder::enqueueNextFlushRequest()
 }
 
 void
-CacheRecorder::enqueueNextFetchRequest()
+CacheRecorder::startFetchRequests()
 {
-    if (m_bytes_read < m_uncompressed_trace_size) {
-        TraceRecord* traceRecord = (TraceRecord*) (m_uncompressed_trace +
-                                                                m_bytes_read);
+    for (auto &queue : m_fetch_queues) {
+        if (!queue.records.empty())
+            issueFetchRequest(queue);
+    }
+    if (m_fetch_queues.empty())
+        DPRINTF(RubyCacheTrace, "Fetched all %d records\n", m_records_read);
+}
 
-        DPRINTF(RubyCacheTrace, "Issuing %s\n", *traceRecord);
+void
+CacheRecorder::enqueueNextFetchRequest(Sequencer *seq)
+{
+    FetchQueue &queue =
+        m_fetch_queues[m_fetch_queue_of.at(m_parallel_fetch ? seq : nullptr)];
+    assert(queue.outstanding > 0);
+    if (--queue.outstanding > 0)
+        return;
 
-        for (int rec_bytes_read = 0; rec_bytes_read < m_block_size_bytes;
-                rec_bytes_read += RubySystem::getBlockSizeBytes()) {
-            RequestPtr req;
-            MemCmd::Command requestType;
+    if (queue.next < queue.records.size()) {
+        issueFetchRequest(queue);
+    } else {
+        DPRINTF(RubyCacheTrace, "Fetched all %d records of a queue, %d "
+                "records in total\n", queue.records.size(), m_records_read);
+    }
+}
 
-            if (traceRecord->m_type == RubyRequestType_LD) {
-                requestType = MemCmd::ReadReq;
-                req = std::make_shared<Request>(
-                    traceRecord->m_data_address + rec_bytes_read,
-                    RubySystem::getBlockSizeBytes(), 0,
-                                    Request::funcRequestorId);
-            }   else if (traceRecord->m_type == RubyRequestType_IFETCH) {
-                requestType = MemCmd::ReadReq;
-                req = std::make_shared<Request>(
-                        traceRecord->m_data_address + rec_bytes_read,
-                        RubySystem::getBlockSizeBytes(),
-                        Request::INST_FETCH, Request::funcRequestorId);
-            }   else {
-                requestType = MemCmd::WriteReq;
-                req = std::make_shared<Request>(
-                    traceRecord->m_data_address + rec_bytes_read,
-                    RubySystem::getBlockSizeBytes(), 0,
-                                Request::funcRequestorId);
-            }
+void
+CacheRecorder::issueFetchRequest(FetchQueue &queue)
+{
+    TraceRecord* traceRecord = queue.records[queue.next++];
 
-            Packet *pkt = new Packet(req, requestType);
-            pkt->dataStatic(traceRecord->m_data + rec_bytes_read);
+    DPRINTF(RubyCacheTrace, "Issuing %s\n", *traceRecord);
 
-            Sequencer* m_sequencer_ptr = m_seq_map[traceRecord->m_cntrl_id];
-            assert(m_sequencer_ptr != NULL);
-            m_sequencer_ptr->makeRequest(pkt);
+    // The sequencer may call back before the last request is issued
+    queue.outstanding = m_block_size_bytes / RubySystem::getBlockSizeBytes();
+
+    for (int rec_bytes_read = 0; rec_bytes_read < m_block_size_bytes;
+            rec_bytes_read += RubySystem::getBlockSizeBytes()) {
+        RequestPtr req;
+        MemCmd::Command requestType;
+
+        if (traceRecord->m_type == RubyRequestType_LD) {
+            requestType = MemCmd::ReadReq;
+            req = makeRequest(
+                traceRecord->m_data_address + rec_bytes_read,
+                RubySystem::getBlockSizeBytes(), 0,
+                                Request::funcRequestorId);
+        }   else if (traceRecord->m_type == RubyRequestType_IFETCH) {
+            requestType = MemCmd::ReadReq;
+            req = makeRequest(
+                    traceRecord->m_data_address + rec_bytes_read,
+                    RubySystem::getBlockSizeBytes(),
+                    Request::INST_FETCH, Request::funcRequestorId);
+        }   else {
+            requestType = MemCmd::WriteReq;
+            req = makeRequest(
+                traceRecord->m_data_address + rec_bytes_read,
+                RubySystem::getBlockSizeBytes(), 0,
+                            Request::funcRequestorId);
         }
 
-        m_bytes_read += (sizeof(TraceRecord) + m_block_size_bytes);
-        m_records_read++;
-    } else {
-        DPRINTF(RubyCacheTrace, "Fetched all %d records\n", m_records_read);
+        Packet *pkt = new Packet(req, requestType);
+        pkt->dataStatic(traceRecord->m_data + rec_bytes_read);
+
+        Sequencer* m_sequencer_ptr = m_seq_map[traceRecord->m_cntrl_id];
+        assert(m_sequencer_ptr != NULL);
+        m_sequencer_ptr->makeRequest(pkt);
     }
+
+    m_records_read++;
 }
 
 void
@@ -171,40 +225,125 @@ CacheRecorder::addRecord(int cntrl, Addr data_addr, Addr pc_addr,
     m_records.push_back(rec);
 }
 
+namespace
+{
+
+// Set in the type byte of a record whose data is all zeros
+const uint8_t zeroDataFlag = 0x80;
+
+void
+putVarint(std::vector<uint8_t> &out, uint64_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(value | 0x80);
+        value >>= 7;
+    }
+    out.push_back(value);
+}
+
+uint64_t
+getVarint(const uint8_t *&in, const uint8_t *end)
+{
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (in == end)
+            break;
+        uint8_t byte = *in++;
+        value |= uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+    fatal("Corrupted ruby cache trace\n");
+}
+
+} // anonymous namespace
+
 uint64_t
 CacheRecorder::aggregateRecords(uint8_t **buf, uint64_t total_size)
 {
     std::sort(m_records.begin(), m_records.end(), compareTraceRecords);
 
-    int size = m_records.size();
-    uint64_t current_size = 0;
-    int record_size = sizeof(TraceRecord) + m_block_size_bytes;
-
-    for (int i = 0; i < size; ++i) {
-        // Determine if we need to expand the buffer size
-        if (current_size + record_size > total_size) {
-            uint8_t* new_buf = new (std::nothrow) uint8_t[total_size * 2];
-            if (new_buf == NULL) {
-                fatal("Unable to allocate buffer of size %s\n",
-                      total_size * 2);
-            }
-            total_size = total_size * 2;
-            uint8_t* old_buf = *buf;
-            memcpy(new_buf, old_buf, current_size);
-            *buf = new_buf;
-            delete [] old_buf;
+    std::vector<uint8_t> trace;
+    Addr last_line = 0;
+    for (auto rec : m_records) {
+        assert(rec->m_data_address % m_block_size_bytes == 0);
+        Addr line = rec->m_data_address / m_block_size_bytes;
+        // zigzag encoding of the signed change, the lines of a
+        // controller are usually close to each other
+        int64_t delta = line - last_line;
+        last_line = line;
+
+        bool zero = std::all_of(rec->m_data, rec->m_data + m_block_size_bytes,
+                                [](uint8_t byte) { return byte == 0; });
+
+        putVarint(trace, rec->m_cntrl_id);
+        putVarint(trace, (uint64_t(delta) << 1) ^ uint64_t(delta >> 63));
+        trace.push_back(rec->m_type | (zero ? zeroDataFlag : 0));
+        if (!zero) {
+            trace.insert(trace.end(), rec->m_data,
+                         rec->m_data + m_block_size_bytes);
         }
 
-        // Copy the current record into the buffer
-        memcpy(&((*buf)[current_size]), m_records[i], record_size);
-        current_size += record_size;
+        free(rec);
+    }
+    m_records.clear();
 
-        free(m_records[i]);
-        m_records[i] = NULL;
+    // Determine if we need to expand the buffer size
+    if (trace.size() > total_size) {
+        uint8_t* new_buf = new (std::nothrow) uint8_t[trace.size()];
+        if (new_buf == NULL) {
+            fatal("Unable to allocate buffer of size %s\n", trace.size());
+        }
+        delete [] *buf;
+        *buf = new_buf;
     }
+    std::copy(trace.begin(), trace.end(), *buf);
 
-    m_records.clear();
-    return current_size;
+    return trace.size();
+}
+
+void
+CacheRecorder::decodeTrace()
+{
+    std::vector<uint8_t> records;
+    uint64_t record_size = sizeof(TraceRecord) + m_block_size_bytes;
+
+    const uint8_t *in = m_uncompressed_trace;
+    const uint8_t *end = in + m_uncompressed_trace_size;
+    Addr line = 0;
+    while (in < end) {
+        records.resize(records.size() + record_size);
+        TraceRecord *rec =
+            (TraceRecord*)(records.data() + records.size() - record_size);
+
+        rec->m_cntrl_id = getVarint(in, end);
+        uint64_t zigzag = getVarint(in, end);
+        line += int64_t(zigzag >> 1) ^ -int64_t(zigzag & 1);
+        rec->m_data_address = line * m_block_size_bytes;
+        rec->m_pc_address = 0;
+        rec->m_time = 0;
+
+        if (in == end)
+            fatal("Corrupted ruby cache trace\n");
+        uint8_t type = *in++;
+        rec->m_type = RubyRequestType(type & ~zeroDataFlag);
+        if (rec->m_type >= RubyRequestType_NUM)
+            fatal("Corrupted ruby cache trace\n");
+
+        if (type & zeroDataFlag) {
+            std::fill(rec->m_data, rec->m_data + m_block_size_bytes, 0);
+        } else {
+            if (uint64_t(end - in) < m_block_size_bytes)
+                fatal("Corrupted ruby cache trace\n");
+            std::copy(in, in + m_block_size_bytes, rec->m_data);
+            in += m_block_size_bytes;
+        }
+    }
+
+    delete [] m_uncompressed_trace;
+    m_uncompressed_trace = new uint8_t[records.size()];
+    m_uncompressed_trace_size = records.size();
+    std::copy(records.begin(), records.end(), m_uncompressed_trace);
 }
 
 } // namespace ruby
@@ -29,12 +29,14 @@
 
 /*
  * Recording cache requests made to a ruby cache at certain ruby
- * time. Also dump the requests to a gziped file.
+ * time. Also dump the requests to a gziped file, in a compact encoding
+ * (see CacheRecorder::aggregateRecords).
  */
 
 #ifndef __MEM_RUBY_SYSTEM_CACHERECORDER_HH__
 #define __MEM_RUBY_SYSTEM_CACHERECORDER_HH__
 
+#include <unordered_map>
 #include <vector>
 
 #include "base/types.hh"
@@ -76,15 +78,36 @@ class CacheRecorder
     CacheRecorder();
     ~CacheRecorder();
 
+    /**
+     * @param uncompressed_trace Trace read from a checkpoint, in the
+     *        given format, owned by the recorder from then on.
+     * @param parallel_fetch Warm up the caches with a request in flight
+     *        per sequencer rather than a single one overall.
+     */
     CacheRecorder(uint8_t* uncompressed_trace,
                   uint64_t uncompressed_trace_size,
+                  int trace_format,
                   std::vector<Sequencer*>& SequencerMap,
-                  uint64_t block_size_bytes);
+                  uint64_t block_size_bytes,
+                  bool parallel_fetch);
     void addRecord(int cntrl, Addr data_addr, Addr pc_addr,
                    RubyRequestType type, Tick time, DataBlock& data);
 
+    /**
+     * Encode the recorded trace into a buffer for the checkpoint. A
+     * record is the controller id and the change of line address since
+     * the previous record as variable length integers, the access type,
+     * and the data unless it is all zeros. The times and PCs are only
+     * used to order the records, and are left out.
+     */
     uint64_t aggregateRecords(uint8_t **data, uint64_t size);
 
+    /**
+     * Format of the trace aggregateRecords() writes. Format 0 is the
+     * TraceRecord layout of the checkpoints written before it.
+     */
+    static const int traceFormat = 1;
+
     /*!
      * Function for flushing the memory contents of the caches to the
      * main memory. It goes through the recorded contents of the caches,
@@ -99,24 +122,45 @@ class CacheRecorder
      * Function for fetching warming up the memory and the caches. It goes
      * through the recorded contents of the caches, as available in the
      * checkpoint and issues fetch requests. Except for the first one, a
-     * fetch request is issued only after the previous one has completed.
+     * fetch request is issued only after the previous one has completed,
+     * or the previous one of the same sequencer with parallel_fetch.
      * It should be possible to use this with any protocol.
      */
-    void enqueueNextFetchRequest();
+    void startFetchRequests();
+
+    /** Issue the fetch request after the one seq just completed. */
+    void enqueueNextFetchRequest(Sequencer *seq);
 
   private:
     // Private copy constructor and assignment operator
     CacheRecorder(const CacheRecorder& obj);
     CacheRecorder& operator=(const CacheRecorder& obj);
 
+    /** Expand a format 1 trace into TraceRecords. */
+    void decodeTrace();
+
+    /** Fetch requests sharing a request in flight. */
+    struct FetchQueue
+    {
+        std::vector<TraceRecord*> records;
+        size_t next = 0;
+        // requests of the current record still in flight
+        int outstanding = 0;
+    };
+
+    void issueFetchRequest(FetchQueue &queue);
+
     std::vector<TraceRecord*> m_records;
     uint8_t* m_uncompressed_trace;
     uint64_t m_uncompressed_trace_size;
     std::vector<Sequencer*> m_seq_map;
-    uint64_t m_bytes_read;
     uint64_t m_records_read;
     uint64_t m_records_flushed;
     uint64_t m_block_size_bytes;
+
+    bool m_parallel_fetch;
+    std::vector<FetchQueue> m_fetch_queues;
+    std::unordered_map<Sequencer*, int> m_fetch_queue_of;
 };
 
 inline bool
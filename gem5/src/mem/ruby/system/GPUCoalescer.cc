@@ -190,6 +190,7 @@ GPUCoalescer::GPUCoalescer(const Params &p)
                  false, Event::Progress_Event_Pri),
       uncoalescedTable(this),
       deadlockCheckEvent([this]{ wakeup(); }, "GPUCoalescer deadlock check"),
+      coalescerStats(this),
       gmTokenPort(name() + ".gmTokenPort", this)
 {
     m_store_waiting_on_load_cycles = 0;
@@ -707,8 +708,21 @@ GPUCoalescer::getDynInst(PacketPtr pkt) const
     return cu_state->_gpuDynInst;
 }
 
+GPUCoalescer::GPUCoalescerStats::GPUCoalescerStats(statistics::Group *parent)
+    : statistics::Group(parent),
+      ADD_STAT(coalescedInsts, statistics::units::Count::get(),
+               "Number of memory instructions coalesced"),
+      ADD_STAT(contiguousInsts, statistics::units::Count::get(),
+               "Number of memory instructions coalesced as one contiguous "
+               "access"),
+      ADD_STAT(contiguousFraction, statistics::units::Ratio::get(),
+               "Fraction of the memory instructions coalesced as one "
+               "contiguous access", contiguousInsts / coalescedInsts)
+{
+}
+
 bool
-GPUCoalescer::coalescePacket(PacketPtr pkt)
+GPUCoalescer::coalescePacket(PacketPtr pkt, CoalescedRequest **creq_out)
 {
     uint64_t seqNum = pkt->req->getReqInstSeqNum();
     Addr line_addr = makeLineAddress(pkt->getAddr());
@@ -723,6 +737,8 @@ GPUCoalescer::coalescePacket(PacketPtr pkt)
         );
         if (citer != creqQueue.end()) {
             (*citer)->insertPacket(pkt);
+            if (creq_out)
+                *creq_out = *citer;
             return true;
         }
     }
@@ -737,6 +753,8 @@ GPUCoalescer::coalescePacket(PacketPtr pkt)
         creq->insertPacket(pkt);
         creq->setRubyType(getRequestType(pkt));
         creq->setIssueTime(curCycle());
+        if (creq_out)
+            *creq_out = creq;
 
         if (!coalescedTable.count(line_addr)) {
             // If there is no outstanding request for this line address,
@@ -801,6 +819,42 @@ GPUCoalescer::coalescePacket(PacketPtr pkt)
     return false;
 }
 
+bool
+GPUCoalescer::isContiguous(const PerInstPackets &pkts) const
+{
+    PacketPtr prev = nullptr;
+    for (auto pkt : pkts) {
+        if (prev && (pkt->cmd != prev->cmd ||
+                     pkt->getAddr() != prev->getAddr() + prev->getSize())) {
+            return false;
+        }
+        prev = pkt;
+    }
+    return true;
+}
+
+void
+GPUCoalescer::coalesceContiguous(PerInstPackets &pkts)
+{
+    Addr line_addr = 0;
+    CoalescedRequest *creq = nullptr;
+
+    pkts.remove_if([&](PacketPtr pkt) {
+        Addr pkt_line = makeLineAddress(pkt->getAddr());
+        if (creq && pkt_line == line_addr) {
+            // coalescePacket would find this request for the line too
+            creq->insertPacket(pkt);
+            return true;
+        }
+
+        creq = nullptr;
+        if (!coalescePacket(pkt, &creq))
+            return false;
+        line_addr = pkt_line;
+        return true;
+    });
+}
+
 void
 GPUCoalescer::completeIssue()
 {
@@ -831,9 +885,22 @@ GPUCoalescer::completeIssue()
             // erase them from the list if coalescing is successful and
             // leave them in the list otherwise. This aggressively attempts
             // to coalesce as many packets as possible from the current inst.
-            pkt_list->remove_if(
-                [&](PacketPtr pkt) { return coalescePacket(pkt); }
-            );
+            bool contiguous = isContiguous(*pkt_list);
+            if (pkt_list_size ==
+                uncoalescedTable.getPacketsRemaining(seq_num)) {
+                // first attempt at coalescing this instruction
+                coalescerStats.coalescedInsts++;
+                if (contiguous)
+                    coalescerStats.contiguousInsts++;
+            }
+
+            if (contiguous) {
+                coalesceContiguous(*pkt_list);
+            } else {
+                pkt_list->remove_if(
+                    [&](PacketPtr pkt) { return coalescePacket(pkt); }
+                );
+            }
 
             if (coalescedReqs.count(seq_num)) {
                 auto& creqs = coalescedReqs.at(seq_num);
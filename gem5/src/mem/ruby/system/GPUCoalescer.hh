@@ -176,7 +176,7 @@ class PendingWriteInst
         assert(numPendingStores == 0);
 
         // make a response packet
-        PacketPtr pkt = new Packet(std::make_shared<Request>(),
+        PacketPtr pkt = new Packet(makeRequest(),
                                    MemCmd::WriteCompleteResp);
 
         if (!usingRubyTester) {
@@ -406,8 +406,19 @@ class GPUCoalescer : public RubyPort
     // with a previous request from the same instruction. If there is no
     // previous instruction and the max number of outstanding requests has
     // not be reached, a new coalesced request is created and added to the
-    // "target" list of the coalescedTable.
-    bool coalescePacket(PacketPtr pkt);
+    // "target" list of the coalescedTable. If creq is given, it is set to
+    // the coalesced request the packet has been added to.
+    bool coalescePacket(PacketPtr pkt, CoalescedRequest **creq = nullptr);
+
+    // Whether the packets of an instruction access one contiguous range
+    // of memory, in lane order and with the same command, as unit stride
+    // accesses do.
+    bool isContiguous(const PerInstPackets &pkts) const;
+
+    // Coalesce the packets of a contiguous access. Consecutive packets in
+    // the same line go straight to the coalesced request of the first one
+    // rather than being looked up in the coalescedTable one by one.
+    void coalesceContiguous(PerInstPackets &pkts);
 
     EventFunctionWrapper issueEvent;
 
@@ -459,6 +470,15 @@ class GPUCoalescer : public RubyPort
     EventFunctionWrapper deadlockCheckEvent;
     bool assumingRfOCoherence;
 
+    struct GPUCoalescerStats : public statistics::Group
+    {
+        GPUCoalescerStats(statistics::Group *parent);
+
+        statistics::Scalar coalescedInsts;
+        statistics::Scalar contiguousInsts;
+        statistics::Formula contiguousFraction;
+    } coalescerStats;
+
 // TODO - Need to update the following stats once the VIPER protocol
 //        is re-integrated.
 //    // m5 style stats for TCP hit/miss counts
@@ -173,7 +173,7 @@ HTMSequencer::htmCallback(Addr address,
                mode == HtmCallbackMode_ST_FAIL) {
         // transaction failed
         assert(address == makeLineAddress(address));
-        assert(m_RequestTable.find(address) != m_RequestTable.end());
+        assert(m_RequestTable.count(address));
 
         auto &seq_req_list = m_RequestTable[address];
         while (!seq_req_list.empty()) {
@@ -198,7 +198,7 @@ HTMSequencer::htmCallback(Addr address,
             rubyHtmCallback(pkt, htm_return_code);
             testDrainComplete();
             pkt = nullptr;
-            seq_req_list.pop_front();
+            freeRequest(seq_req_list.pop_front());
         }
         // free all outstanding requests corresponding to this address
         if (seq_req_list.empty()) {
@@ -43,6 +43,7 @@
 #include <fcntl.h>
 #include <zlib.h>
 
+#include <algorithm>
 #include <cstdio>
 #include <list>
 
@@ -78,7 +79,7 @@ bool RubySystem::m_cooldown_enabled = false;
 
 RubySystem::RubySystem(const Params &p)
     : ClockedObject(p), m_access_backing_store(p.access_backing_store),
-      m_cache_recorder(NULL)
+      m_parallel_warmup(p.parallel_warmup), m_cache_recorder(NULL)
 {
     m_randomization = p.randomization;
 
@@ -167,6 +168,40 @@ RubySystem::registerRequestorIDs()
     }
 }
 
+void
+RubySystem::addLineOwner(Addr line_addr, AbstractController *cntrl)
+{
+    lineOwners[line_addr].push_back(cntrl);
+}
+
+void
+RubySystem::removeLineOwner(Addr line_addr, AbstractController *cntrl)
+{
+    auto it = lineOwners.find(line_addr);
+    assert(it != lineOwners.end());
+    auto &owners = it->second;
+    auto owner = std::find(owners.begin(), owners.end(), cntrl);
+    assert(owner != owners.end());
+    owners.erase(owner);
+    if (owners.empty())
+        lineOwners.erase(it);
+}
+
+AbstractController *
+RubySystem::getLineOwner(Addr line_addr)
+{
+    auto it = lineOwners.find(line_addr);
+    if (it == lineOwners.end() || it->second.size() != 1)
+        return nullptr;
+
+    // Permissions may also change outside of transitions on the line, so
+    // check the owner still holds it before trusting the index
+    AbstractController *owner = it->second.front();
+    if (owner->getAccessPermission(line_addr) != AccessPermission_Read_Write)
+        return nullptr;
+    return owner;
+}
+
 RubySystem::~RubySystem()
 {
     delete m_profiler;
@@ -175,6 +210,7 @@ RubySystem::~RubySystem()
 void
 RubySystem::makeCacheRecorder(uint8_t *uncompressed_trace,
                               uint64_t cache_trace_size,
+                              int cache_trace_format,
                               uint64_t block_size_bytes)
 {
     std::vector<Sequencer*> sequencer_map;
@@ -202,7 +238,8 @@ RubySystem::makeCacheRecorder(uint8_t *uncompressed_trace,
 
     // Create the CacheRecorder and record the cache trace
     m_cache_recorder = new CacheRecorder(uncompressed_trace, cache_trace_size,
-                                         sequencer_map, block_size_bytes);
+                                         cache_trace_format, sequencer_map,
+                                         block_size_bytes, m_parallel_warmup);
 }
 
 void
@@ -212,7 +249,8 @@ RubySystem::memWriteback()
 
     // Make the trace so we know what to write back.
     DPRINTF(RubyCacheTrace, "Recording Cache Trace\n");
-    makeCacheRecorder(NULL, 0, getBlockSizeBytes());
+    makeCacheRecorder(NULL, 0, CacheRecorder::traceFormat,
+                      getBlockSizeBytes());
     for (int cntrl = 0; cntrl < m_abs_cntrl_vec.size(); cntrl++) {
         m_abs_cntrl_vec[cntrl]->recordCacheTrace(cntrl, m_cache_recorder);
     }
@@ -330,8 +368,10 @@ RubySystem::serialize(CheckpointOut &cp) const
     std::string cache_trace_file = name() + ".cache.gz";
     writeCompressedTrace(raw_data, cache_trace_file, cache_trace_size);
 
+    int cache_trace_format = CacheRecorder::traceFormat;
     SERIALIZE_SCALAR(cache_trace_file);
     SERIALIZE_SCALAR(cache_trace_size);
+    SERIALIZE_SCALAR(cache_trace_format);
 }
 
 void
@@ -390,8 +430,12 @@ RubySystem::unserialize(CheckpointIn &cp)
     std::string cache_trace_file;
     uint64_t cache_trace_size = 0;
 
+    // Checkpoints without a format have the TraceRecords as they are
+    int cache_trace_format = 0;
+
     UNSERIALIZE_SCALAR(cache_trace_file);
     UNSERIALIZE_SCALAR(cache_trace_size);
+    UNSERIALIZE_OPT_SCALAR(cache_trace_format);
     cache_trace_file = cp.getCptDir() + "/" + cache_trace_file;
 
     readCompressedTrace(cache_trace_file, uncompressed_trace,
@@ -400,7 +444,8 @@ RubySystem::unserialize(CheckpointIn &cp)
     m_systems_to_warmup++;
 
     // Create the cache recorder that will hang around until startup.
-    makeCacheRecorder(uncompressed_trace, cache_trace_size, block_size_bytes);
+    makeCacheRecorder(uncompressed_trace, cache_trace_size, cache_trace_format,
+                      block_size_bytes);
 }
 
 void
@@ -464,7 +509,7 @@ void
 RubySystem::processRubyEvent()
 {
     if (getWarmupEnabled()) {
-        m_cache_recorder->enqueueNextFetchRequest();
+        m_cache_recorder->startFetchRequests();
     } else if (getCooldownEnabled()) {
         m_cache_recorder->enqueueNextFlushRequest();
     }
@@ -502,6 +547,15 @@ RubySystem::functionalRead(PacketPtr pkt)
     int request_net_id = requestorToNetwork[pkt->requestorId()];
     assert(netCntrls.count(request_net_id));
 
+    // A single controller with a Read_Write copy is where the search
+    // below would read from too
+    AbstractController *owner = getLineOwner(line_address);
+    if (owner && machineToNetwork[owner->getMachineID()] == request_net_id) {
+        DPRINTF(RubySystem, "Read from owner %s\n", owner->name());
+        owner->functionalRead(line_address, pkt);
+        return true;
+    }
+
     AbstractController *ctrl_ro = nullptr;
     AbstractController *ctrl_rw = nullptr;
     AbstractController *ctrl_backing_store = nullptr;
@@ -604,6 +658,17 @@ RubySystem::functionalRead(PacketPtr pkt)
 
     DPRINTF(RubySystem, "Functional Read request for %#x\n", address);
 
+    // A full line from a single controller with a Read_Write copy is
+    // all the search below would return
+    if (AbstractController *owner = getLineOwner(line_address)) {
+        WriteMask bytes;
+        owner->functionalRead(line_address, pkt, bytes);
+        if (bytes.isFull()) {
+            DPRINTF(RubySystem, "Read from owner %s\n", owner->name());
+            return true;
+        }
+    }
+
     std::vector<AbstractController*> ctrl_ro;
     std::vector<AbstractController*> ctrl_busy;
     std::vector<AbstractController*> ctrl_others;
@@ -108,6 +108,11 @@ class RubySystem : public ClockedObject
     void registerMachineID(const MachineID& mach_id, Network* network);
     void registerRequestorIDs();
 
+    //! Index of the controllers holding a line with Read_Write permission,
+    //! kept up to date by AbstractController::updateLineOwner().
+    void addLineOwner(Addr line_addr, AbstractController *cntrl);
+    void removeLineOwner(Addr line_addr, AbstractController *cntrl);
+
     bool eventQueueEmpty() { return eventq->empty(); }
     void enqueueRubyEvent(Tick tick)
     {
@@ -123,6 +128,7 @@ class RubySystem : public ClockedObject
 
     void makeCacheRecorder(uint8_t *uncompressed_trace,
                            uint64_t cache_trace_size,
+                           int cache_trace_format,
                            uint64_t block_size_bytes);
 
     static void readCompressedTrace(std::string filename,
@@ -132,6 +138,15 @@ class RubySystem : public ClockedObject
                                      uint64_t uncompressed_trace_size);
 
     void processRubyEvent();
+
+    /**
+     * The only controller holding the line with Read_Write permission
+     * according to the owner index, or nullptr if there is none, several,
+     * or if the index is out of date. A functional read may then be
+     * served by this controller alone.
+     */
+    AbstractController *getLineOwner(Addr line_addr);
+
   private:
     // configuration parameters
     static bool m_randomization;
@@ -144,6 +159,7 @@ class RubySystem : public ClockedObject
     static bool m_cooldown_enabled;
     memory::SimpleMemory *m_phys_mem;
     const bool m_access_backing_store;
+    const bool m_parallel_warmup;
 
     //std::vector<Network *> m_networks;
     std::vector<std::unique_ptr<Network>> m_networks;
@@ -153,6 +169,7 @@ class RubySystem : public ClockedObject
     std::unordered_map<MachineID, unsigned> machineToNetwork;
     std::unordered_map<RequestorID, unsigned> requestorToNetwork;
     std::unordered_map<unsigned, std::vector<AbstractController*>> netCntrls;
+    std::unordered_map<Addr, std::vector<AbstractController *>> lineOwners;
 
   public:
     Profiler* m_profiler;
@@ -49,8 +49,21 @@ class RubySystem(ClockedObject):
     access_backing_store = Param.Bool(False, "Use phys_mem as the functional \
         store and only use ruby for timing.")
 
+    parallel_warmup = Param.Bool(False, "Restore the caches from a \
+        checkpoint with a request in flight per sequencer rather than one \
+        at a time. Faster, but the lines cached by several controllers may \
+        not end up in the same states as with serial requests.")
+
     # Profiler related configuration variables
     hot_lines = Param.Bool(False, "")
     all_instructions = Param.Bool(False, "")
+    profile_max_entries = Param.Unsigned(0, "Addresses traced per address \
+        profile, keeping the heaviest ones seen; 0 traces every address")
+    profile_sketch_width = Param.Unsigned(4096, "Counters per row of the \
+        sketch estimating the access counts of a bounded address profile")
+    profile_sketch_depth = Param.Unsigned(4, "Rows of the sketch \
+        estimating the access counts of a bounded address profile")
+    profile_sample_interval = Param.Unsigned(1, "Trace one in this many \
+        accesses in the address profiles")
     num_of_sequencers = Param.Int("")
     number_of_virtual_networks = Param.Unsigned("")
@@ -66,7 +66,8 @@ namespace ruby
 {
 
 Sequencer::Sequencer(const Params &p)
-    : RubyPort(p), m_IncompleteTimes(MachineType_NUM),
+    : RubyPort(p), m_RequestTable(p.max_outstanding_requests),
+      m_freeRequests(nullptr), m_IncompleteTimes(MachineType_NUM),
       deadlockCheckEvent([this]{ wakeup(); }, "Sequencer deadlock check")
 {
     m_outstanding_count = 0;
@@ -79,6 +80,12 @@ Sequencer::Sequencer(const Params &p)
     assert(m_max_outstanding_requests > 0);
     assert(m_deadlock_threshold > 0);
 
+    for (int i = 0; i < m_max_outstanding_requests; i++) {
+        m_requestPool.emplace_back(nullptr, RubyRequestType_NULL,
+                                   RubyRequestType_NULL, Cycles(0));
+        freeRequest(&m_requestPool.back());
+    }
+
     m_runningGarnetStandalone = p.garnet_standalone;
 
 
@@ -312,8 +319,8 @@ Sequencer::insertRequest(PacketPtr pkt, RubyRequestType primary_type,
     // Check if there is any outstanding request for the same cache line.
     auto &seq_req_list = m_RequestTable[line_addr];
     // Create a default entry
-    seq_req_list.emplace_back(pkt, primary_type,
-        secondary_type, curCycle());
+    seq_req_list.push_back(allocateRequest(pkt, primary_type,
+                                           secondary_type));
     m_outstanding_count++;
 
     if (seq_req_list.size() > 1) {
@@ -325,6 +332,29 @@ Sequencer::insertRequest(PacketPtr pkt, RubyRequestType primary_type,
     return RequestStatus_Ready;
 }
 
+SequencerRequest *
+Sequencer::allocateRequest(PacketPtr pkt, RubyRequestType primary_type,
+                           RubyRequestType secondary_type)
+{
+    if (!m_freeRequests) {
+        m_requestPool.emplace_back(pkt, primary_type, secondary_type,
+                                   curCycle());
+        return &m_requestPool.back();
+    }
+
+    SequencerRequest *req = m_freeRequests;
+    m_freeRequests = req->next;
+    *req = SequencerRequest(pkt, primary_type, secondary_type, curCycle());
+    return req;
+}
+
+void
+Sequencer::freeRequest(SequencerRequest *req)
+{
+    req->next = m_freeRequests;
+    m_freeRequests = req;
+}
+
 void
 Sequencer::markRemoved()
 {
@@ -417,7 +447,7 @@ Sequencer::writeCallback(Addr address, DataBlock& data,
     // to this cache line when response for the write comes back
     //
     assert(address == makeLineAddress(address));
-    assert(m_RequestTable.find(address) != m_RequestTable.end());
+    assert(m_RequestTable.count(address));
     auto &seq_req_list = m_RequestTable[address];
 
     // Perform hitCallback on every cpu request made to this cache block while
@@ -497,7 +527,7 @@ Sequencer::writeCallback(Addr address, DataBlock& data,
                         initialRequestTime, forwardRequestTime,
                         firstResponseTime, !ruby_request);
         }
-        seq_req_list.pop_front();
+        freeRequest(seq_req_list.pop_front());
     }
 
     // free all outstanding requests corresponding to this address
@@ -518,7 +548,7 @@ Sequencer::readCallback(Addr address, DataBlock& data,
     // or end of the corresponding list.
     //
     assert(address == makeLineAddress(address));
-    assert(m_RequestTable.find(address) != m_RequestTable.end());
+    assert(m_RequestTable.count(address));
     auto &seq_req_list = m_RequestTable[address];
 
     // Perform hitCallback on every cpu request made to this cache block while
@@ -552,7 +582,7 @@ Sequencer::readCallback(Addr address, DataBlock& data,
                     initialRequestTime, forwardRequestTime,
                     firstResponseTime, !ruby_request);
         ruby_request = false;
-        seq_req_list.pop_front();
+        freeRequest(seq_req_list.pop_front());
     }
 
     // free all outstanding requests corresponding to this address
@@ -646,7 +676,7 @@ Sequencer::hitCallback(SequencerRequest* srequest, DataBlock& data,
     if (RubySystem::getWarmupEnabled()) {
         assert(pkt->req);
         delete pkt;
-        rs->m_cache_recorder->enqueueNextFetchRequest();
+        rs->m_cache_recorder->enqueueNextFetchRequest(this);
     } else if (RubySystem::getCooldownEnabled()) {
         delete pkt;
         rs->m_cache_recorder->enqueueNextFlushRequest();
@@ -789,16 +819,18 @@ Sequencer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
     // check if the packet has data as for example prefetch and flush
     // requests do not
     std::shared_ptr<RubyRequest> msg =
-        std::make_shared<RubyRequest>(clockEdge(), pkt->getAddr(),
-                                      pkt->getSize(), pc, secondary_type,
-                                      RubyAccessMode_Supervisor, pkt,
-                                      PrefetchBit_No, proc_id, core_id);
+        makeMessage<RubyRequest>(clockEdge(), pkt->getAddr(),
+                                 pkt->getSize(), pc, secondary_type,
+                                 RubyAccessMode_Supervisor, pkt,
+                                 PrefetchBit_No, proc_id, core_id);
 
     DPRINTFR(ProtocolTrace, "%15s %3s %10s%20s %6s>%-6s %#x %s\n",
             curTick(), m_version, "Seq", "Begin", "", "",
             printAddress(msg->getPhysicalAddress()),
             RubyRequestType_to_string(secondary_type));
 
+    m_ruby_system->getProfiler()->addAddressTraceSample(*msg, m_version);
+
     // hardware transactional memory
     // If the request originates in a transaction,
     // then mark the Ruby message as such.
@@ -815,9 +847,8 @@ Sequencer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
     m_mandatory_q_ptr->enqueue(msg, clockEdge(), latency);
 }
 
-template <class KEY, class VALUE>
 std::ostream &
-operator<<(std::ostream &out, const std::unordered_map<KEY, VALUE> &map)
+operator<<(std::ostream &out, const AddrMap<SequencerRequestList> &map)
 {
     for (const auto &table_entry : map) {
         out << "[ " << table_entry.first << " =";
@@ -41,10 +41,10 @@
 #ifndef __MEM_RUBY_SYSTEM_SEQUENCER_HH__
 #define __MEM_RUBY_SYSTEM_SEQUENCER_HH__
 
+#include <deque>
 #include <iostream>
-#include <list>
-#include <unordered_map>
 
+#include "mem/ruby/common/AddrMap.hh"
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/protocol/MachineType.hh"
 #include "mem/ruby/protocol/RubyRequestType.hh"
@@ -65,6 +65,8 @@ struct SequencerRequest
     RubyRequestType m_type;
     RubyRequestType m_second_type;
     Cycles issue_time;
+    // Next request to the same line, see SequencerRequestList
+    SequencerRequest *next = nullptr;
     SequencerRequest(PacketPtr _pkt, RubyRequestType _m_type,
                      RubyRequestType _m_second_type, Cycles _issue_time)
                 : pkt(_pkt), m_type(_m_type), m_second_type(_m_second_type),
@@ -83,6 +85,68 @@ struct SequencerRequest
 
 std::ostream& operator<<(std::ostream& out, const SequencerRequest& obj);
 
+/**
+ * The requests outstanding for a line, oldest first, linked through
+ * SequencerRequest::next. The requests themselves belong to the request
+ * pool of the Sequencer.
+ */
+class SequencerRequestList
+{
+  public:
+    class const_iterator
+    {
+      public:
+        const_iterator(const SequencerRequest *_req) : req(_req) {}
+        const SequencerRequest &operator*() const { return *req; }
+        const_iterator &operator++() { req = req->next; return *this; }
+        bool
+        operator!=(const const_iterator &o) const
+        {
+            return req != o.req;
+        }
+
+      private:
+        const SequencerRequest *req;
+    };
+
+    bool empty() const { return !head; }
+    int size() const { return count; }
+    SequencerRequest &front() { return *head; }
+
+    void
+    push_back(SequencerRequest *req)
+    {
+        assert(!req->next);
+        if (tail)
+            tail->next = req;
+        else
+            head = req;
+        tail = req;
+        count++;
+    }
+
+    SequencerRequest *
+    pop_front()
+    {
+        assert(head);
+        SequencerRequest *req = head;
+        head = req->next;
+        if (!head)
+            tail = nullptr;
+        req->next = nullptr;
+        count--;
+        return req;
+    }
+
+    const_iterator begin() const { return const_iterator(head); }
+    const_iterator end() const { return const_iterator(nullptr); }
+
+  private:
+    SequencerRequest *head = nullptr;
+    SequencerRequest *tail = nullptr;
+    int count = 0;
+};
+
 class Sequencer : public RubyPort
 {
   public:
@@ -214,7 +278,18 @@ class Sequencer : public RubyPort
 
   protected:
     // RequestTable contains both read and write requests, handles aliasing
-    std::unordered_map<Addr, std::list<SequencerRequest>> m_RequestTable;
+    AddrMap<SequencerRequestList> m_RequestTable;
+
+    /**
+     * Take a request from the pool. The pool holds enough requests for
+     * max_outstanding_requests, and only grows for the HTM aborts that
+     * are let through past that limit.
+     */
+    SequencerRequest *allocateRequest(PacketPtr pkt,
+                                      RubyRequestType primary_type,
+                                      RubyRequestType secondary_type);
+    /** Give a request popped from a request list back to the pool. */
+    void freeRequest(SequencerRequest *req);
 
     Cycles m_deadlock_threshold;
 
@@ -225,6 +300,11 @@ class Sequencer : public RubyPort
   private:
     int m_max_outstanding_requests;
 
+    // Storage of the requests of m_RequestTable, a deque so that growing
+    // does not move them, and the unused ones linked through next
+    std::deque<SequencerRequest> m_requestPool;
+    SequencerRequest *m_freeRequests;
+
     CacheMemory* m_dataCache_ptr;
 
     // The cache access latency for top-level caches (L0/L1). These are
@@ -40,6 +40,10 @@
 
 #include "mem/se_translating_port_proxy.hh"
 
+#include <cstring>
+
+#include "cpu/thread_context.hh"
+#include "mem/physical.hh"
 #include "sim/process.hh"
 #include "sim/system.hh"
 
@@ -48,9 +52,109 @@ namespace gem5
 
 SETranslatingPortProxy::SETranslatingPortProxy(
         ThreadContext *tc, AllocType alloc, Request::Flags _flags) :
-    TranslatingPortProxy(tc, _flags), allocating(alloc)
+    TranslatingPortProxy(tc, _flags), allocating(alloc),
+    direct(tc->getProcessPtr()->directSyscallCopies ||
+           tc->getSystemPtr()->bypassCaches())
 {}
 
+uint8_t *
+SETranslatingPortProxy::hostAddr(const TranslationGen::Range &range,
+                                 BaseMMU::Mode mode) const
+{
+    if (!direct || flags.isSet(Request::UNCACHEABLE))
+        return nullptr;
+    return _tc->getSystemPtr()->getPhysMem().toHostAddr(
+            range.paddr, range.size, mode != BaseMMU::Read);
+}
+
+bool
+SETranslatingPortProxy::hostRanges(Addr addr, int size, BaseMMU::Mode mode,
+        std::vector<struct iovec> &iov) const
+{
+    iov.clear();
+    if (!direct)
+        return false;
+
+    bool in_host = true;
+    bool mapped = tryOnBlob(mode, _tc->getMMUPtr()->translateFunctional(
+            addr, size, _tc, mode, flags),
+        [this, mode, &in_host, &iov](const auto &range) {
+            uint8_t *host = in_host ? hostAddr(range, mode) : nullptr;
+            if (!host) {
+                in_host = false;
+                return;
+            }
+            if (!iov.empty()) {
+                auto &last = iov.back();
+                if ((uint8_t *)last.iov_base + last.iov_len == host) {
+                    last.iov_len += range.size;
+                    return;
+                }
+            }
+            iov.push_back({host, (size_t)range.size});
+    });
+
+    if (!mapped || !in_host) {
+        iov.clear();
+        return false;
+    }
+    return true;
+}
+
+bool
+SETranslatingPortProxy::tryReadBlob(Addr addr, void *p, int size) const
+{
+    if (!direct)
+        return TranslatingPortProxy::tryReadBlob(addr, p, size);
+
+    constexpr auto mode = BaseMMU::Read;
+    return tryOnBlob(mode, _tc->getMMUPtr()->translateFunctional(
+            addr, size, _tc, mode, flags),
+        [this, &p](const auto &range) {
+            if (uint8_t *host = hostAddr(range, mode))
+                std::memcpy(p, host, range.size);
+            else
+                PortProxy::readBlobPhys(range.paddr, flags, p, range.size);
+            p = static_cast<uint8_t *>(p) + range.size;
+    });
+}
+
+bool
+SETranslatingPortProxy::tryWriteBlob(Addr addr, const void *p,
+        int size) const
+{
+    if (!direct)
+        return TranslatingPortProxy::tryWriteBlob(addr, p, size);
+
+    constexpr auto mode = BaseMMU::Write;
+    return tryOnBlob(mode, _tc->getMMUPtr()->translateFunctional(
+            addr, size, _tc, mode, flags),
+        [this, &p](const auto &range) {
+            if (uint8_t *host = hostAddr(range, mode))
+                std::memcpy(host, p, range.size);
+            else
+                PortProxy::writeBlobPhys(range.paddr, flags, p, range.size);
+            p = static_cast<const uint8_t *>(p) + range.size;
+    });
+}
+
+bool
+SETranslatingPortProxy::tryMemsetBlob(Addr addr, uint8_t v, int size) const
+{
+    if (!direct)
+        return TranslatingPortProxy::tryMemsetBlob(addr, v, size);
+
+    constexpr auto mode = BaseMMU::Write;
+    return tryOnBlob(mode, _tc->getMMUPtr()->translateFunctional(
+            addr, size, _tc, mode, flags),
+        [this, v](const auto &range) {
+            if (uint8_t *host = hostAddr(range, mode))
+                std::memset(host, v, range.size);
+            else
+                PortProxy::memsetBlobPhys(range.paddr, flags, v, range.size);
+    });
+}
+
 bool
 SETranslatingPortProxy::fixupRange(const TranslationGen::Range &range,
         BaseMMU::Mode mode) const
@@ -41,11 +41,22 @@
 #ifndef __MEM_SE_TRANSLATING_PORT_PROXY_HH__
 #define __MEM_SE_TRANSLATING_PORT_PROXY_HH__
 
+#include <sys/uio.h>
+
+#include <vector>
+
 #include "mem/translating_port_proxy.hh"
 
 namespace gem5
 {
 
+/**
+ * Translating proxy for the syscalls of SE mode, which maps the pages the
+ * stack grows into. When the process asks for it (directSyscallCopies) or
+ * the caches are bypassed, the buffers are copied straight from and to the
+ * host memory rather than through the memory system, a cache line at a
+ * time.
+ */
 class SETranslatingPortProxy : public TranslatingPortProxy
 {
 
@@ -64,9 +75,36 @@ class SETranslatingPortProxy : public TranslatingPortProxy
     bool fixupRange(const TranslationGen::Range &range,
             BaseMMU::Mode mode) const override;
 
+    /**
+     * Host address of a translated range, or nullptr if it has to go
+     * through the memory system. The range is recorded as written to
+     * unless the access is a read.
+     */
+    uint8_t *hostAddr(const TranslationGen::Range &range,
+                      BaseMMU::Mode mode) const;
+
   public:
     SETranslatingPortProxy(ThreadContext *tc, AllocType alloc=NextPage,
                            Request::Flags _flags=0);
+
+    bool tryReadBlob(Addr addr, void *p, int size) const override;
+    bool tryWriteBlob(Addr addr, const void *p, int size) const override;
+    bool tryMemsetBlob(Addr addr, uint8_t v, int size) const override;
+
+    /**
+     * The host memory behind [addr, addr + size), for syscalls that read
+     * or write a buffer in place. The pages that are contiguous on the
+     * host are merged into a single iovec.
+     *
+     * @return false, with iov cleared, if any part of the buffer can't be
+     *         mapped or has to go through the memory system.
+     */
+    bool hostRanges(Addr addr, int size, BaseMMU::Mode mode,
+                    std::vector<struct iovec> &iov) const;
+
+  private:
+    /** Whether the accesses may bypass the memory system */
+    const bool direct;
 };
 
 } // namespace gem5
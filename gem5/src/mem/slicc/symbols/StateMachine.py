@@ -206,6 +206,73 @@ class StateMachine(Symbol):
                     error_msg += ", "  + action.desc
                 action.warning(error_msg)
         self.table = table
+        self.buildTransitionTable()
+
+    def buildTransitionTable(self):
+        '''Lay the transitions out as a dense table in HASH_FUN order, with
+        the action sequences of the transitions packed into a single array
+        and the resource checks numbered from 1'''
+        self.trans_rows = []
+        self.trans_actions = []
+        self.trans_resources = []
+        self.trans_wildcard = False
+
+        action_seqs = {}
+        resource_ids = {}
+        for state in self.states.values():
+            for event in self.events.values():
+                trans = self.table.get((state, event))
+                if trans is None:
+                    self.trans_rows.append(None)
+                    continue
+
+                if trans.state == trans.nextState:
+                    next_state = None
+                elif trans.nextState.isWildcard():
+                    next_state = "*"
+                    self.trans_wildcard = True
+                else:
+                    next_state = trans.nextState.ident
+
+                # Check for resources and for the request types, in a
+                # sorted order so that the output is deterministic, then
+                # record the access types
+                checks = [
+                    'if (!%s.areNSlotsAvailable(%s, clockEdge()))\n'
+                    '    return false;' % (key.code, val)
+                    for key, val in trans.resources.items()]
+                checks += [
+                    'if (!checkResourceAvailable(%s_RequestType_%s, addr))\n'
+                    '    return false;' % (self.ident, request_type.ident)
+                    for request_type in trans.request_types]
+                checks.sort()
+                for request_type in trans.request_types:
+                    checks.append('recordRequestType(%s_RequestType_%s, addr);'
+                                  % (self.ident, request_type.ident))
+                resources = 0
+                if checks:
+                    checks = tuple(checks)
+                    if checks not in resource_ids:
+                        self.trans_resources.append(checks)
+                        resource_ids[checks] = len(self.trans_resources)
+                    resources = resource_ids[checks]
+
+                stall = any(a.ident == "z_stall" for a in trans.actions)
+                actions = () if stall else \
+                    tuple(a.ident for a in trans.actions)
+                if len(actions) > 255:
+                    trans.error("Too many actions in transition: %s" % trans)
+                if actions not in action_seqs:
+                    action_seqs[actions] = len(self.trans_actions)
+                    self.trans_actions.extend(actions)
+
+                self.trans_rows.append((stall, next_state, resources,
+                                        action_seqs[actions], len(actions)))
+
+        if len(self.trans_actions) < 2**16:
+            self.trans_action_index_type = "uint16_t"
+        else:
+            self.trans_action_index_type = "uint32_t"
 
     # determine the port->msg buffer mappings
     def getBufferMaps(self, ident):
@@ -384,6 +451,49 @@ TransitionResult doTransitionWorker(${ident}_Event event,
         code('''
                                     Addr addr);
 
+// The transitions, indexed by HASH_FUN(state, event), see
+// ${ident}_Transitions.cc
+enum TransitionKind : uint8_t
+{
+    TransitionInvalid,
+    TransitionValid,
+    TransitionStall
+};
+
+// TransitionInfo::nextState of the transitions that keep the state, and
+// of those whose next state is given by getNextState()
+static const int transitionSameState = ${ident}_State_NUM;
+static const int transitionGetNextState = ${ident}_State_NUM + 1;
+
+struct TransitionInfo
+{
+    TransitionKind kind;
+    uint16_t nextState;
+    // case of checkTransitionResources(), 0 if there is nothing to check
+    uint16_t resources;
+    // the actions are transitionActions[firstAction, firstAction + numActions)
+    ${{self.trans_action_index_type}} firstAction;
+    uint8_t numActions;
+};
+
+typedef void (${ident}_Controller::*TransitionAction)(''')
+        if self.TBEType != None and self.EntryType != None:
+            code('    ${{self.TBEType.c_ident}}*&, '
+                 '${{self.EntryType.c_ident}}*&, Addr);')
+        elif self.TBEType != None:
+            code('    ${{self.TBEType.c_ident}}*&, Addr);')
+        elif self.EntryType != None:
+            code('    ${{self.EntryType.c_ident}}*&, Addr);')
+        else:
+            code('    Addr);')
+
+        code('''
+
+static const TransitionInfo transitionTable[];
+static const TransitionAction transitionActions[];
+
+bool checkTransitionResources(int resources, Addr addr);
+
 ${ident}_Event m_curTransitionEvent;
 ${ident}_State m_curTransitionNextState;
 
@@ -1390,6 +1500,45 @@ namespace gem5
 namespace ruby
 {
 
+const ${ident}_Controller::TransitionAction
+${ident}_Controller::transitionActions[] = {
+''')
+        code.indent()
+        for action in self.trans_actions:
+            code('&${ident}_Controller::${action},')
+        if not self.trans_actions:
+            code('nullptr')
+        code.dedent()
+        code('''
+};
+
+const ${ident}_Controller::TransitionInfo
+${ident}_Controller::transitionTable[] = {
+''')
+        code.indent()
+        rows = iter(self.trans_rows)
+        for state in self.states.values():
+            code('// ${ident}_State_${{state.ident}}')
+            for event in self.events.values():
+                row = next(rows)
+                if row is None:
+                    code('{TransitionInvalid, transitionSameState, 0, 0, 0}, '
+                         '// ${{event.ident}}')
+                    continue
+                stall, next_state, resources, first, num = row
+                kind = "TransitionStall" if stall else "TransitionValid"
+                if next_state is None:
+                    next_state = "transitionSameState"
+                elif next_state == "*":
+                    next_state = "transitionGetNextState"
+                else:
+                    next_state = "%s_State_%s" % (ident, next_state)
+                code('{$kind, $next_state, $resources, $first, $num}, '
+                     '// ${{event.ident}}')
+        code.dedent()
+        code('''
+};
+
 TransitionResult
 ${ident}_Controller::doTransition(${ident}_Event event,
 ''')
@@ -1464,6 +1613,7 @@ if (result == TransitionResult_Valid) {
         else:
             code('setState(addr, next_state);')
             code('setAccessPermission(addr, next_state);')
+        code('updateLineOwner(addr);')
 
         code('''
 } else if (result == TransitionResult_ResourceStall) {
@@ -1508,114 +1658,82 @@ ${ident}_Controller::doTransitionWorker(${ident}_Event event,
 {
     m_curTransitionEvent = event;
     m_curTransitionNextState = next_state;
-    switch(HASH_FUN(state, event)) {
-''')
 
-        # This map will allow suppress generating duplicate code
-        cases = OrderedDict()
-
-        for trans in self.transitions:
-            case_string = "%s_State_%s, %s_Event_%s" % \
-                (self.ident, trans.state.ident, self.ident, trans.event.ident)
-
-            case = self.symtab.codeFormatter()
-            # Only set next_state if it changes
-            if trans.state != trans.nextState:
-                if trans.nextState.isWildcard():
-                    # When * is encountered as an end state of a transition,
-                    # the next state is determined by calling the
-                    # machine-specific getNextState function. The next state
-                    # is determined before any actions of the transition
-                    # execute, and therefore the next state calculation cannot
-                    # depend on any of the transitionactions.
-                    case('next_state = getNextState(addr); '
-                         'm_curTransitionNextState = next_state;')
-                else:
-                    ns_ident = trans.nextState.ident
-                    case('next_state = ${ident}_State_${ns_ident}; '
-                         'm_curTransitionNextState = next_state;')
-
-            actions = trans.actions
-            request_types = trans.request_types
-
-            # Check for resources
-            case_sorter = []
-            res = trans.resources
-            for key,val in res.items():
-                val = '''
-if (!%s.areNSlotsAvailable(%s, clockEdge()))
-    return TransitionResult_ResourceStall;
-''' % (key.code, val)
-                case_sorter.append(val)
+    static_assert(sizeof(transitionTable) == sizeof(TransitionInfo) *
+                  ${ident}_State_NUM * ${ident}_Event_NUM,
+                  "One transition for each state and event");
+    assert(state < ${ident}_State_NUM && event < ${ident}_Event_NUM);
+    const TransitionInfo &trans = transitionTable[HASH_FUN(state, event)];
+    if (trans.kind == TransitionInvalid) {
+        panic("Invalid transition\\n"
+              "%s time: %d addr: %#x event: %s state: %s\\n",
+              name(), curCycle(), addr, event, state);
+    }
 
-            # Check all of the request_types for resource constraints
-            for request_type in request_types:
-                val = '''
-if (!checkResourceAvailable(%s_RequestType_%s, addr)) {
-    return TransitionResult_ResourceStall;
+    // Only set next_state if it changes
+''')
+        code.indent()
+        if self.trans_wildcard:
+            # When * is encountered as an end state of a transition, the
+            # next state is determined by calling the machine-specific
+            # getNextState function. The next state is determined before
+            # any actions of the transition execute, and therefore the next
+            # state calculation cannot depend on any of the
+            # transitionactions.
+            code('''
+if (trans.nextState == transitionGetNextState) {
+    next_state = getNextState(addr);
+    m_curTransitionNextState = next_state;
+} else if (trans.nextState != transitionSameState) {
+''')
+        else:
+            code('if (trans.nextState != transitionSameState) {')
+        code('''
+    next_state = ${ident}_State(trans.nextState);
+    m_curTransitionNextState = next_state;
 }
-''' % (self.ident, request_type.ident)
-                case_sorter.append(val)
-
-            # Emit the code sequences in a sorted order.  This makes the
-            # output deterministic (without this the output order can vary
-            # since Map's keys() on a vector of pointers is not deterministic
-            for c in sorted(case_sorter):
-                case("$c")
 
-            # Record access types for this transition
-            for request_type in request_types:
-                case('recordRequestType(${ident}_RequestType_${{request_type.ident}}, addr);')
-
-            # Figure out if we stall
-            stall = False
-            for action in actions:
-                if action.ident == "z_stall":
-                    stall = True
-                    break
-
-            if stall:
-                case('return TransitionResult_ProtocolStall;')
-            else:
-                if self.TBEType != None and self.EntryType != None:
-                    for action in actions:
-                        case('${{action.ident}}(m_tbe_ptr, m_cache_entry_ptr, addr);')
-                elif self.TBEType != None:
-                    for action in actions:
-                        case('${{action.ident}}(m_tbe_ptr, addr);')
-                elif self.EntryType != None:
-                    for action in actions:
-                        case('${{action.ident}}(m_cache_entry_ptr, addr);')
-                else:
-                    for action in actions:
-                        case('${{action.ident}}(addr);')
-                case('return TransitionResult_Valid;')
-
-            case = str(case)
+if (trans.resources && !checkTransitionResources(trans.resources, addr))
+    return TransitionResult_ResourceStall;
 
-            # Look to see if this transition code is unique.
-            if case not in cases:
-                cases[case] = []
+if (trans.kind == TransitionStall)
+    return TransitionResult_ProtocolStall;
 
-            cases[case].append(case_string)
+const TransitionAction *actions = &transitionActions[trans.firstAction];
+for (int i = 0; i < trans.numActions; i++) {
+''')
+        args = []
+        if self.TBEType != None:
+            args.append("m_tbe_ptr")
+        if self.EntryType != None:
+            args.append("m_cache_entry_ptr")
+        args = ", ".join(args + ["addr"])
+        code('    (this->*actions[i])($args);')
+        code('''
+}
 
-        # Walk through all of the unique code blocks and spit out the
-        # corresponding case statement elements
-        for case,transitions in cases.items():
-            # Iterative over all the multiple transitions that share
-            # the same code
-            for trans in transitions:
-                code('  case HASH_FUN($trans):')
-            code('    $case\n')
+return TransitionResult_Valid;
+''')
+        code.dedent()
+        code('''
+}
 
+bool
+${ident}_Controller::checkTransitionResources(int resources, Addr addr)
+{
+    switch (resources) {
+''')
+        for i, checks in enumerate(self.trans_resources):
+            code('      case ${{i + 1}}:')
+            code.indent(2)
+            for check in checks:
+                code('$check')
+            code('return true;')
+            code.dedent(2)
         code('''
       default:
-        panic("Invalid transition\\n"
-              "%s time: %d addr: %#x event: %s state: %s\\n",
-              name(), curCycle(), addr, event, state);
+        panic("Invalid transition resources %d\\n", resources);
     }
-
-    return TransitionResult_Valid;
 }
 
 } // namespace ruby
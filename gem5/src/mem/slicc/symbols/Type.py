@@ -135,6 +135,9 @@ class Type(Symbol):
     @property
     def isInterface(self):
         return "interface" in self
+    @property
+    def isCacheEntry(self):
+        return self.pairs.get("interface") == "AbstractCacheEntry"
 
     # Return false on error
     def addDataMember(self, ident, type, pairs, init_code):
@@ -220,6 +223,8 @@ class Type(Symbol):
         if "interface" in self:
             code('#include "mem/ruby/protocol/$0.hh"', self["interface"])
             parent = " :  public %s" % self["interface"]
+        if self.isCacheEntry:
+            code('#include "base/pool_allocator.hh"')
 
         code('''
 namespace gem5
@@ -297,7 +302,7 @@ $klass ${{self.c_ident}}$parent
 MsgPtr
 clone() const
 {
-     return std::shared_ptr<Message>(new ${{self.c_ident}}(*this));
+     return makeMessage<${{self.c_ident}}>(*this);
 }
 ''')
         else:
@@ -307,6 +312,28 @@ clone() const
 {
      return new ${{self.c_ident}}(*this);
 }
+''')
+
+        # Cache entries come and go with every fill and eviction, recycle
+        # their storage through a free list rather than the heap
+        if self.isCacheEntry:
+            code('''
+static void *
+operator new(std::size_t size)
+{
+    if (size != sizeof(${{self.c_ident}}))
+        return ::operator new(size);
+    return FreeListPool<sizeof(${{self.c_ident}})>::allocate();
+}
+
+static void
+operator delete(void *ptr, std::size_t size)
+{
+    if (size != sizeof(${{self.c_ident}}))
+        ::operator delete(ptr);
+    else
+        FreeListPool<sizeof(${{self.c_ident}})>::deallocate(ptr);
+}
 ''')
 
         if not self.isGlobal:
@@ -42,6 +42,9 @@
 
 #include "mem/snoop_filter.hh"
 
+#include <algorithm>
+
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/SnoopFilter.hh"
@@ -52,12 +55,96 @@ namespace gem5
 
 const int SnoopFilter::SNOOP_MASK_SIZE;
 
+SnoopFilter::SnoopFilterCache::SnoopFilterCache(size_t max_entries)
+    : numEntries(0)
+{
+    // Keep the load factor at or below 3/4 even when tracking the
+    // maximum number of entries, but start out small since most
+    // filters never get close to their capacity.
+    maxSlots = size_t(1) << ceilLog2(std::max<size_t>(
+        (max_entries * 4 + 2) / 3, 2));
+    const size_t slots = std::min<size_t>(maxSlots, 4096);
+    keys.assign(slots, InvalidKey);
+    items.resize(slots, SnoopItem{0, 0});
+    mask = slots - 1;
+    shift = 64 - floorLog2(slots);
+}
+
+size_t
+SnoopFilter::SnoopFilterCache::insert(Addr key)
+{
+    assert(key != InvalidKey);
+    if ((numEntries + 1) * 4 > keys.size() * 3 && keys.size() < maxSlots)
+        grow();
+
+    size_t slot = home(key);
+    for (; keys[slot] != InvalidKey; slot = (slot + 1) & mask) {
+        if (keys[slot] == key)
+            return slot;
+    }
+
+    // The table is sized to hold max_capacity at 3/4 load. Always
+    // keep one slot empty so that every probe terminates.
+    panic_if(numEntries + 1 >= keys.size(),
+             "snoop filter table full with %d entries\n", numEntries);
+    keys[slot] = key;
+    items[slot] = SnoopItem{0, 0};
+    ++numEntries;
+    return slot;
+}
+
 void
-SnoopFilter::eraseIfNullEntry(SnoopFilterCache::iterator& sf_it)
+SnoopFilter::SnoopFilterCache::erase(size_t slot)
 {
-    SnoopItem& sf_item = sf_it->second;
+    assert(keys[slot] != InvalidKey);
+    // Backward-shift deletion: move any later entry of the probe
+    // sequence whose home slot is not in (slot, next] into the hole,
+    // so that lookups never need to skip over deleted slots.
+    size_t next = slot;
+    while (true) {
+        next = (next + 1) & mask;
+        if (keys[next] == InvalidKey)
+            break;
+        const size_t h = home(keys[next]);
+        const bool stays = slot <= next ? (slot < h && h <= next) :
+                                          (slot < h || h <= next);
+        if (stays)
+            continue;
+        keys[slot] = keys[next];
+        items[slot] = items[next];
+        slot = next;
+    }
+    keys[slot] = InvalidKey;
+    --numEntries;
+}
+
+void
+SnoopFilter::SnoopFilterCache::grow()
+{
+    std::vector<Addr> old_keys = std::move(keys);
+    std::vector<SnoopItem> old_items = std::move(items);
+    keys.assign(old_keys.size() * 2, InvalidKey);
+    items.assign(old_items.size() * 2, SnoopItem{0, 0});
+    mask = keys.size() - 1;
+    shift = 64 - floorLog2(keys.size());
+
+    for (size_t i = 0; i < old_keys.size(); ++i) {
+        if (old_keys[i] == InvalidKey)
+            continue;
+        size_t slot = home(old_keys[i]);
+        while (keys[slot] != InvalidKey)
+            slot = (slot + 1) & mask;
+        keys[slot] = old_keys[i];
+        items[slot] = old_items[i];
+    }
+}
+
+void
+SnoopFilter::eraseIfNullEntry(size_t slot)
+{
+    SnoopItem& sf_item = cachedLocations.item(slot);
     if ((sf_item.requested | sf_item.holder).none()) {
-        cachedLocations.erase(sf_it);
+        cachedLocations.erase(slot);
         DPRINTF(SnoopFilter, "%s:   Removed SF entry.\n",
                 __func__);
     }
@@ -78,8 +165,9 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
         line_addr |= LineSecure;
     }
     SnoopMask req_port = portToMask(cpu_side_port);
-    reqLookupResult.it = cachedLocations.find(line_addr);
-    bool is_hit = (reqLookupResult.it != cachedLocations.end());
+    reqLookupResult.slot = cachedLocations.find(line_addr);
+    reqLookupResult.key = line_addr;
+    bool is_hit = (reqLookupResult.slot != SnoopFilterCache::NotFound);
 
     // If the snoop filter has no entry, and we should not allocate,
     // do not create a new snoop filter entry, simply return a NULL
@@ -87,12 +175,11 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
     if (!is_hit && !allocate)
         return snoopDown(lookupLatency);
 
-    // If no hit in snoop filter create a new element and update iterator
+    // If no hit in snoop filter create a new element and update the slot
     if (!is_hit) {
-        reqLookupResult.it =
-            cachedLocations.emplace(line_addr, SnoopItem()).first;
+        reqLookupResult.slot = cachedLocations.insert(line_addr);
     }
-    SnoopItem& sf_item = reqLookupResult.it->second;
+    SnoopItem& sf_item = cachedLocations.item(reqLookupResult.slot);
     SnoopMask interested = sf_item.holder | sf_item.requested;
 
     // Store unmodified value of snoop filter item in temp storage in
@@ -159,26 +246,35 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
 void
 SnoopFilter::finishRequest(bool will_retry, Addr addr, bool is_secure)
 {
-    if (reqLookupResult.it != cachedLocations.end()) {
+    if (reqLookupResult.slot != SnoopFilterCache::NotFound) {
         // since we rely on the caller, do a basic check to ensure
         // that finishRequest is being called following lookupRequest
         Addr line_addr = (addr & ~(Addr(linesize - 1)));
         if (is_secure) {
             line_addr |= LineSecure;
         }
-        assert(reqLookupResult.it->first == line_addr);
+        assert(reqLookupResult.key == line_addr);
+
+        // other updates between the lookup and now may have moved
+        // the entry to a different slot
+        const size_t slot = cachedLocations.relocate(reqLookupResult.slot,
+                                                     reqLookupResult.key);
+        reqLookupResult.slot = SnoopFilterCache::NotFound;
+        if (slot == SnoopFilterCache::NotFound)
+            return;
+
         if (will_retry) {
             SnoopItem retry_item = reqLookupResult.retryItem;
             // Undo any changes made in lookupRequest to the snoop filter
             // entry if the request will come again. retryItem holds
             // the previous value of the snoopfilter entry.
-            reqLookupResult.it->second = retry_item;
+            cachedLocations.item(slot) = retry_item;
 
             DPRINTF(SnoopFilter, "%s:   restored SF value %x.%x\n",
                     __func__,  retry_item.requested, retry_item.holder);
         }
 
-        eraseIfNullEntry(reqLookupResult.it);
+        eraseIfNullEntry(slot);
     }
 }
 
@@ -193,8 +289,8 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = (sf_it != cachedLocations.end());
+    const size_t slot = cachedLocations.find(line_addr);
+    bool is_hit = (slot != SnoopFilterCache::NotFound);
 
     panic_if(!is_hit && (cachedLocations.size() >= maxEntryCount),
              "snoop filter exceeded capacity of %d cache blocks\n",
@@ -206,7 +302,7 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     if (!is_hit)
         return snoopDown(lookupLatency);
 
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = cachedLocations.item(slot);
 
     SnoopMask interested = (sf_item.holder | sf_item.requested);
 
@@ -236,7 +332,7 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
         sf_item.holder = 0;
         DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(slot);
     }
 
     return snoopSelected(maskToPortList(interested), lookupLatency);
@@ -266,7 +362,8 @@ SnoopFilter::updateSnoopResponse(const Packet* cpkt,
     }
     SnoopMask rsp_mask = portToMask(rsp_port);
     SnoopMask req_mask = portToMask(req_port);
-    SnoopItem& sf_item = cachedLocations[line_addr];
+    SnoopItem& sf_item =
+        cachedLocations.item(cachedLocations.insert(line_addr));
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -313,8 +410,8 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = sf_it != cachedLocations.end();
+    const size_t slot = cachedLocations.find(line_addr);
+    bool is_hit = slot != SnoopFilterCache::NotFound;
 
     // Nothing to do if it is not a hit
     if (!is_hit)
@@ -324,7 +421,7 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
     // Modified state, and we know that there are no other copies, or
     // they will all be invalidated imminently
     if (!cpkt->hasSharers()) {
-        SnoopItem& sf_item = sf_it->second;
+        SnoopItem& sf_item = cachedLocations.item(slot);
 
         DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
@@ -332,7 +429,7 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
         DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
 
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(slot);
     }
 }
 
@@ -355,12 +452,12 @@ SnoopFilter::updateResponse(const Packet* cpkt, const ResponsePort&
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    if (sf_it == cachedLocations.end())
+    const size_t slot = cachedLocations.find(line_addr);
+    if (slot == SnoopFilterCache::NotFound)
         return;
 
     SnoopMask response_mask = portToMask(cpu_side_port);
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = cachedLocations.item(slot);
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -379,7 +476,7 @@ SnoopFilter::updateResponse(const Packet* cpkt, const ResponsePort&
         if (cpkt->isInvalidate()) {
             sf_item.holder &= ~response_mask;
         }
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(slot);
     } else {
         // Any other response implies that a cache above will have the
         // block.
@@ -44,8 +44,9 @@
 #define __MEM_SNOOP_FILTER_HH__
 
 #include <bitset>
-#include <unordered_map>
+#include <cstddef>
 #include <utility>
+#include <vector>
 
 #include "mem/packet.hh"
 #include "mem/port.hh"
@@ -96,7 +97,8 @@ class SnoopFilter : public SimObject
     typedef std::vector<QueuedResponsePort*> SnoopList;
 
     SnoopFilter (const SnoopFilterParams &p) :
-        SimObject(p), reqLookupResult(cachedLocations.end()),
+        SimObject(p),
+        cachedLocations(p.max_capacity / p.system->cacheLineSize()),
         linesize(p.system->cacheLineSize()), lookupLatency(p.lookup_latency),
         maxEntryCount(p.max_capacity / p.system->cacheLineSize()),
         stats(this)
@@ -221,10 +223,110 @@ class SnoopFilter : public SimObject
         SnoopMask holder;
     };
     /**
-     * HashMap of SnoopItems indexed by line address
+     * Open-addressed table of SnoopItems indexed by line address. The
+     * keys and items live in two flat arrays so that probing only
+     * touches the (small) keys, and collisions are resolved by linear
+     * probing. Entries are removed with backward-shift deletion, so
+     * the table never accumulates tombstones and needs no periodic
+     * clean up. The table doubles in size whenever it becomes 3/4
+     * full, up to the size needed to track the entries bounded by
+     * max_capacity, and it never shrinks, so once warmed up there is
+     * no allocation on the lookup path.
+     *
+     * Entries are referred to by slot index. A slot index is only
+     * stable until the next insertion or removal, since both may move
+     * entries around.
      */
-    typedef std::unordered_map<Addr, SnoopItem> SnoopFilterCache;
+    class SnoopFilterCache
+    {
+      public:
+        /** Slot index returned when an address is not in the table */
+        static constexpr size_t NotFound = ~size_t(0);
+
+        /**
+         * @param max_entries Maximum number of entries that will ever
+         *                    be tracked, used to bound the table size
+         */
+        SnoopFilterCache(size_t max_entries);
+
+        /**
+         * Find the slot of an address.
+         *
+         * @param key Line address (including the LineStatus bits).
+         * @return Slot index, or NotFound on a miss.
+         */
+        size_t
+        find(Addr key) const
+        {
+            for (size_t slot = home(key); ; slot = (slot + 1) & mask) {
+                if (keys[slot] == key)
+                    return slot;
+                if (keys[slot] == InvalidKey)
+                    return NotFound;
+            }
+        }
+
+        /**
+         * Find the slot of an address, and allocate a cleared item
+         * for it if it is not in the table yet.
+         *
+         * @param key Line address (including the LineStatus bits).
+         * @return Slot index of the (possibly new) entry.
+         */
+        size_t insert(Addr key);
 
+        /**
+         * Remove the entry in a slot. All other slot indices that
+         * have been handed out are invalidated.
+         */
+        void erase(size_t slot);
+
+        /**
+         * Re-validate a slot index that may have been invalidated by
+         * insertions or removals since it was found.
+         *
+         * @return The current slot of the key, or NotFound.
+         */
+        size_t
+        relocate(size_t slot, Addr key) const
+        {
+            return (slot < keys.size() && keys[slot] == key) ?
+                slot : find(key);
+        }
+
+        SnoopItem &item(size_t slot) { return items[slot]; }
+        Addr key(size_t slot) const { return keys[slot]; }
+
+        /** Number of entries currently tracked */
+        size_t size() const { return numEntries; }
+
+      private:
+        /**
+         * Marker for an empty slot. Line addresses are aligned, so
+         * this can never be a valid key.
+         */
+        static constexpr Addr InvalidKey = MaxAddr;
+
+        /** Preferred slot of a key (Fibonacci hashing) */
+        size_t
+        home(Addr key) const
+        {
+            return (key * 0x9E3779B97F4A7C15ULL) >> shift;
+        }
+
+        /** Re-hash all entries into a table of twice the size */
+        void grow();
+
+        std::vector<Addr> keys;
+        std::vector<SnoopItem> items;
+        /** Number of slots minus one, the number of slots is a power of 2 */
+        size_t mask;
+        /** Shift to turn a 64-bit hash into a slot index */
+        unsigned shift;
+        size_t numEntries;
+        /** Number of slots beyond which the table stops growing */
+        size_t maxSlots;
+    };
     /**
      * Simple factory methods for standard return values.
      */
@@ -261,9 +363,9 @@ class SnoopFilter : public SimObject
     /**
      * Removes snoop filter items which have no requestors and no holders.
      */
-    void eraseIfNullEntry(SnoopFilterCache::iterator& sf_it);
+    void eraseIfNullEntry(size_t slot);
 
-    /** Simple hash set of cached addresses. */
+    /** Open-addressed table of cached addresses. */
     SnoopFilterCache cachedLocations;
 
     /**
@@ -274,27 +376,21 @@ class SnoopFilter : public SimObject
      */
     struct ReqLookupResult
     {
-        /** Iterator used to store the result from lookupRequest. */
-        SnoopFilterCache::iterator it;
+        /**
+         * Slot of the entry found or allocated by lookupRequest, or
+         * NotFound if lookupRequest neither hit nor allocated.
+         */
+        size_t slot = SnoopFilterCache::NotFound;
+
+        /** Key of that entry, to find it again if it has moved. */
+        Addr key = 0;
 
         /**
          * Variable to temporarily store value of snoopfilter entry
          * in case finishRequest needs to undo changes made in lookupRequest
          * (because of crossbar retry)
          */
-        SnoopItem retryItem;
-
-        /**
-         * The constructor must be informed of the internal cache's end
-         * iterator, so do not allow the compiler to implictly define it.
-         *
-         * @param end_it Iterator to the end of the internal cache.
-         */
-        ReqLookupResult(SnoopFilterCache::iterator end_it)
-            : it(end_it), retryItem{0, 0}
-        {
-        }
-        ReqLookupResult() = delete;
+        SnoopItem retryItem{0, 0};
     } reqLookupResult;
 
     /** List of all attached snooping CPU-side ports. */
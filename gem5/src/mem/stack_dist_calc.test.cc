@@ -0,0 +1,137 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "mem/stack_dist_calc.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/** Naive LRU stack, most recent address at the back. */
+uint64_t
+referenceDist(std::vector<Addr> &stack, Addr addr, bool push)
+{
+    auto it = std::find(stack.rbegin(), stack.rend(), addr);
+    if (it == stack.rend()) {
+        if (push)
+            stack.push_back(addr);
+        return StackDistCalc::Infinity;
+    }
+
+    const uint64_t dist = it - stack.rbegin();
+    stack.erase(std::next(it).base());
+    if (push)
+        stack.push_back(addr);
+    return dist;
+}
+
+} // anonymous namespace
+
+/** The first access to an address has an infinite stack distance. */
+TEST(StackDistCalcTest, FirstAccessIsInfinite)
+{
+    StackDistCalc calc;
+    EXPECT_EQ(calc.calcStackDistAndUpdate(0x40).first,
+              StackDistCalc::Infinity);
+    EXPECT_EQ(calc.calcStackDistAndUpdate(0x80).first,
+              StackDistCalc::Infinity);
+    EXPECT_EQ(calc.calcStackDist(0xc0).first, StackDistCalc::Infinity);
+}
+
+/** The stack distance counts the unique addresses seen in between. */
+TEST(StackDistCalcTest, UniqueAddressesInBetween)
+{
+    StackDistCalc calc;
+    calc.calcStackDistAndUpdate(0x0);
+    calc.calcStackDistAndUpdate(0x40);
+    calc.calcStackDistAndUpdate(0x40);
+    calc.calcStackDistAndUpdate(0x80);
+    EXPECT_EQ(calc.calcStackDist(0x0).first, 2);
+    EXPECT_EQ(calc.calcStackDistAndUpdate(0x0).first, 2);
+    EXPECT_EQ(calc.calcStackDistAndUpdate(0x0).first, 0);
+    EXPECT_EQ(calc.calcStackDistAndUpdate(0x40).first, 2);
+}
+
+/** Removing an address takes it off the stack. */
+TEST(StackDistCalcTest, Remove)
+{
+    StackDistCalc calc;
+    calc.calcStackDistAndUpdate(0x0);
+    calc.calcStackDistAndUpdate(0x40);
+    calc.calcStackDistAndUpdate(0x80);
+    EXPECT_EQ(calc.calcStackDistAndUpdate(0x40, false).first, 1);
+    EXPECT_EQ(calc.calcStackDist(0x40).first, StackDistCalc::Infinity);
+    EXPECT_EQ(calc.calcStackDist(0x0).first, 1);
+}
+
+/** Marks are returned by later lookups and cleared by new accesses. */
+TEST(StackDistCalcTest, Mark)
+{
+    StackDistCalc calc;
+    calc.calcStackDistAndUpdate(0x0);
+    EXPECT_FALSE(calc.calcStackDist(0x0, true).second);
+    EXPECT_TRUE(calc.calcStackDist(0x0).second);
+    EXPECT_FALSE(calc.calcStackDist(0x0).second);
+
+    calc.calcStackDist(0x0, true);
+    EXPECT_TRUE(calc.calcStackDistAndUpdate(0x0).second);
+    EXPECT_FALSE(calc.calcStackDist(0x0).second);
+}
+
+/**
+ * Compare against a naive stack on a random stream long enough to
+ * compact the tree several times.
+ */
+TEST(StackDistCalcTest, MatchesNaiveStack)
+{
+    StackDistCalc calc;
+    std::vector<Addr> stack;
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<Addr> addr_dist(0, 3000);
+    std::uniform_int_distribution<int> op_dist(0, 15);
+
+    for (int i = 0; i < 50000; i++) {
+        const Addr addr = addr_dist(gen) * 64;
+        const int op = op_dist(gen);
+        if (op == 0) {
+            ASSERT_EQ(calc.calcStackDistAndUpdate(addr, false).first,
+                      referenceDist(stack, addr, false));
+        } else if (op == 1) {
+            std::vector<Addr> copy(stack);
+            ASSERT_EQ(calc.calcStackDist(addr).first,
+                      referenceDist(copy, addr, false));
+        } else {
+            ASSERT_EQ(calc.calcStackDistAndUpdate(addr).first,
+                      referenceDist(stack, addr, true));
+        }
+    }
+}
@@ -0,0 +1,153 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/tier_map.hh"
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+namespace memory
+{
+
+TierMap::TierMap(const AddrRange &slow_range, Addr cache_base,
+                 Addr cache_size, Addr page_size, unsigned hot_threshold,
+                 unsigned sample_interval, unsigned max_tracked)
+    : slowRange(slow_range), cacheBase(cache_base), _pageSize(page_size),
+      hotThreshold(hot_threshold), sampleInterval(sample_interval),
+      maxTracked(max_tracked), sinceSample(0),
+      slots(cache_size / page_size), nextSlot(0)
+{
+    fatal_if(!isPowerOf2(page_size), "Tiering page size %d is not a power "
+             "of two\n", page_size);
+    fatal_if(cache_base % page_size, "Tiering cache region at %#x is not "
+             "page aligned\n", cache_base);
+    fatal_if(slots.empty(), "Tiering cache region is smaller than a page\n");
+    fatal_if(hot_threshold == 0 || sample_interval == 0 || max_tracked == 0,
+             "Tiering threshold, sampling interval and tracked pages must "
+             "be non-zero\n");
+}
+
+Addr
+TierMap::translate(Addr addr) const
+{
+    const Addr page = pageOf(addr);
+    auto it = remap.find(page);
+    return it == remap.end() ? addr : it->second + (addr - page);
+}
+
+bool
+TierMap::recordAccess(Addr addr)
+{
+    if (++sinceSample < sampleInterval)
+        return false;
+    sinceSample = 0;
+
+    const Addr page = pageOf(addr);
+    if (pending.count(page) || remap.count(page))
+        return false;
+
+    auto it = counts.find(page);
+    if (it == counts.end()) {
+        if (counts.size() >= maxTracked)
+            age();
+        // Every tracked page is warmer than this one
+        if (counts.size() >= maxTracked)
+            return false;
+        it = counts.emplace(page, 0).first;
+    }
+
+    if (++it->second < hotThreshold)
+        return false;
+
+    // As many hot pages as tracked ones are waiting already, so leave
+    // this one to a later access
+    if (pending.size() >= maxTracked) {
+        --it->second;
+        return false;
+    }
+
+    counts.erase(it);
+    pending.insert(page);
+    return true;
+}
+
+void
+TierMap::age()
+{
+    for (auto it = counts.begin(); it != counts.end(); ) {
+        it->second /= 2;
+        if (it->second == 0)
+            it = counts.erase(it);
+        else
+            ++it;
+    }
+}
+
+void
+TierMap::markDirty(Addr addr)
+{
+    auto it = remap.find(pageOf(addr));
+    if (it != remap.end())
+        slots[(it->second - cacheBase) / _pageSize].dirty = true;
+}
+
+TierMap::Promotion
+TierMap::allocate(Addr page)
+{
+    assert(pending.count(page));
+
+    Slot &slot = slots[nextSlot];
+    Promotion promo;
+    promo.page = page;
+    promo.slot = cacheBase + nextSlot * _pageSize;
+    promo.evicted = slot.page != MaxAddr;
+    promo.victim = slot.page;
+    promo.victimDirty = slot.dirty;
+
+    if (promo.evicted) {
+        // The page must have been installed, or it would be remapped to
+        // a slot that holds another page
+        assert(!pending.count(slot.page));
+        remap.erase(slot.page);
+    }
+    slot.page = page;
+    slot.dirty = false;
+
+    nextSlot = (nextSlot + 1) % slots.size();
+    return promo;
+}
+
+void
+TierMap::install(Addr page, Addr slot)
+{
+    pending.erase(page);
+    remap[page] = slot;
+}
+
+} // namespace memory
+} // namespace gem5
@@ -0,0 +1,171 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_TIER_MAP_HH__
+#define __MEM_TIER_MAP_HH__
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "base/addr_range.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+
+namespace memory
+{
+
+/**
+ * Bookkeeping of a hybrid memory in which the hot pages of a slow memory
+ * (NVM) are migrated to a region of a fast memory (DRAM) that acts as a
+ * cache for them. It counts a sample of the accesses to the slow memory
+ * per page, in a table of bounded size, decides which pages are hot, and
+ * remaps the pages it migrated. Moving the data is left to the memory
+ * controller, which only uses the map for timing: the contents stay in
+ * the memory that owns the address.
+ *
+ * The cache region is filled in order and then replaced first in, first
+ * out, so the page evicted to make room for a hot one is the one that
+ * was migrated the longest ago.
+ */
+class TierMap
+{
+  public:
+    /** What promoting a hot page into the cache region involves. */
+    struct Promotion
+    {
+        /** The page of the slow memory. */
+        Addr page;
+        /** Where it is copied in the fast memory. */
+        Addr slot;
+        /** Whether another page is evicted from the slot. */
+        bool evicted;
+        /** The evicted page, if any. */
+        Addr victim;
+        /** Whether the evicted page was written while it was cached. */
+        bool victimDirty;
+    };
+
+    /**
+     * @param slow_range Addresses of the slow memory.
+     * @param cache_base Start address of the cache region.
+     * @param cache_size Size of the cache region.
+     * @param page_size Granularity of migration, a power of two.
+     * @param hot_threshold Sampled accesses after which a page is hot.
+     * @param sample_interval Count one access in this many.
+     * @param max_tracked Number of pages whose accesses are counted, and
+     *                    of hot pages waiting to be installed.
+     */
+    TierMap(const AddrRange &slow_range, Addr cache_base, Addr cache_size,
+            Addr page_size, unsigned hot_threshold, unsigned sample_interval,
+            unsigned max_tracked);
+
+    Addr pageSize() const { return _pageSize; }
+
+    /** The page an address belongs to. */
+    Addr pageOf(Addr addr) const { return addr & ~(_pageSize - 1); }
+
+    /** Whether an address is in the slow memory. */
+    bool isSlow(Addr addr) const { return slowRange.contains(addr); }
+
+    /** Whether the page of an address of the slow memory is cached. */
+    bool
+    isCached(Addr addr) const
+    {
+        return remap.find(pageOf(addr)) != remap.end();
+    }
+
+    /**
+     * The address the media is accessed at for an address: its copy in
+     * the cache region if its page was migrated, itself otherwise.
+     */
+    Addr translate(Addr addr) const;
+
+    /**
+     * Count an access to the slow memory.
+     *
+     * @return Whether the page of the address just became hot. It is
+     * then pending until it is installed, and not counted meanwhile.
+     */
+    bool recordAccess(Addr addr);
+
+    /** Note that the cached copy of the page of an address changed. */
+    void markDirty(Addr addr);
+
+    /**
+     * Take a slot for a hot page, evicting the oldest page when the
+     * cache region is full. The evicted page is accessed in the slow
+     * memory from now on; the hot page only once it is installed.
+     */
+    Promotion allocate(Addr page);
+
+    /** Direct the accesses to a page to its slot, once it is copied. */
+    void install(Addr page, Addr slot);
+
+    /** Number of pages whose accesses are being counted. */
+    size_t tracked() const { return counts.size(); }
+
+  private:
+    /** A page of the cache region and the slow memory page it holds. */
+    struct Slot
+    {
+        Addr page = MaxAddr;
+        bool dirty = false;
+    };
+
+    /** Halve the counts, forgetting the pages that drop to zero. */
+    void age();
+
+    const AddrRange slowRange;
+    const Addr cacheBase;
+    const Addr _pageSize;
+    const unsigned hotThreshold;
+    const unsigned sampleInterval;
+    const unsigned maxTracked;
+
+    /** Accesses seen since the last sampled one. */
+    unsigned sinceSample;
+
+    /** Sampled accesses per page of the slow memory. */
+    std::unordered_map<Addr, unsigned> counts;
+
+    /** Hot pages that are not installed yet. */
+    std::unordered_set<Addr> pending;
+
+    /** Slot of each installed page. */
+    std::unordered_map<Addr, Addr> remap;
+
+    std::vector<Slot> slots;
+
+    /** The next slot to fill, which is also the oldest one. */
+    unsigned nextSlot;
+};
+
+} // namespace memory
+} // namespace gem5
+
+#endif // __MEM_TIER_MAP_HH__
@@ -0,0 +1,151 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "mem/tier_map.hh"
+
+using namespace gem5;
+using namespace gem5::memory;
+
+namespace
+{
+
+const AddrRange slowRange(0x100000000, 0x200000000);
+const Addr cacheBase = 0x10000;
+const Addr pageSize = 0x1000;
+
+} // anonymous namespace
+
+/** Pages become hot after the threshold of accesses, once. */
+TEST(TierMapTest, HotThreshold)
+{
+    TierMap map(slowRange, cacheBase, 4 * pageSize, pageSize, 3, 1, 16);
+    const Addr addr = slowRange.start() + 0x1234;
+
+    EXPECT_FALSE(map.recordAccess(addr));
+    EXPECT_FALSE(map.recordAccess(addr + 8));
+    EXPECT_TRUE(map.recordAccess(addr));
+    // Pending pages are not counted again
+    for (int i = 0; i < 10; i++)
+        EXPECT_FALSE(map.recordAccess(addr));
+}
+
+/** Only one access in the sampling interval is counted. */
+TEST(TierMapTest, Sampling)
+{
+    TierMap map(slowRange, cacheBase, 4 * pageSize, pageSize, 2, 4, 16);
+    const Addr addr = slowRange.start();
+
+    int hot_at = 0;
+    for (int i = 1; i <= 8 && !hot_at; i++) {
+        if (map.recordAccess(addr))
+            hot_at = i;
+    }
+    EXPECT_EQ(hot_at, 8);
+}
+
+/** The count table is bounded, and ages to make room. */
+TEST(TierMapTest, BoundedTracking)
+{
+    TierMap map(slowRange, cacheBase, 4 * pageSize, pageSize, 8, 1, 4);
+    const Addr base = slowRange.start();
+
+    // Two accesses to each of four pages fill the table
+    for (int i = 0; i < 4; i++) {
+        map.recordAccess(base + i * pageSize);
+        map.recordAccess(base + i * pageSize);
+    }
+    EXPECT_EQ(map.tracked(), 4);
+
+    // Halving the counts keeps every page, so a new one isn't tracked
+    map.recordAccess(base + 4 * pageSize);
+    EXPECT_EQ(map.tracked(), 4);
+
+    // Halving them again drops them all
+    map.recordAccess(base + 4 * pageSize);
+    EXPECT_EQ(map.tracked(), 1);
+}
+
+/** Installed pages are remapped to their slot, keeping the offset. */
+TEST(TierMapTest, Remap)
+{
+    TierMap map(slowRange, cacheBase, 4 * pageSize, pageSize, 1, 1, 16);
+    const Addr page = slowRange.start() + 5 * pageSize;
+
+    ASSERT_TRUE(map.recordAccess(page));
+    auto promo = map.allocate(page);
+    EXPECT_EQ(promo.slot, cacheBase);
+    EXPECT_FALSE(promo.evicted);
+    EXPECT_FALSE(map.isCached(page));
+    EXPECT_EQ(map.translate(page + 0x40), page + 0x40);
+
+    map.install(page, promo.slot);
+    EXPECT_TRUE(map.isCached(page + 0x40));
+    EXPECT_EQ(map.translate(page + 0x40), cacheBase + 0x40);
+    EXPECT_EQ(map.translate(page + pageSize), page + pageSize);
+}
+
+/** A full cache region evicts the oldest page, remembering writes. */
+TEST(TierMapTest, Evict)
+{
+    TierMap map(slowRange, cacheBase, 2 * pageSize, pageSize, 1, 1, 16);
+    const Addr base = slowRange.start();
+
+    for (int i = 0; i < 2; i++) {
+        const Addr page = base + i * pageSize;
+        ASSERT_TRUE(map.recordAccess(page));
+        map.install(page, map.allocate(page).slot);
+    }
+    map.markDirty(base + 8);
+
+    const Addr page = base + 2 * pageSize;
+    ASSERT_TRUE(map.recordAccess(page));
+    auto promo = map.allocate(page);
+    EXPECT_EQ(promo.slot, cacheBase);
+    EXPECT_TRUE(promo.evicted);
+    EXPECT_EQ(promo.victim, base);
+    EXPECT_TRUE(promo.victimDirty);
+    EXPECT_FALSE(map.isCached(base));
+    EXPECT_TRUE(map.isCached(base + pageSize));
+
+    // The evicted page can become hot again
+    EXPECT_TRUE(map.recordAccess(base));
+}
+
+/** The hot pages waiting to be installed are bounded too. */
+TEST(TierMapTest, BoundedPending)
+{
+    TierMap map(slowRange, cacheBase, 4 * pageSize, pageSize, 1, 1, 2);
+    const Addr base = slowRange.start();
+
+    EXPECT_TRUE(map.recordAccess(base));
+    EXPECT_TRUE(map.recordAccess(base + pageSize));
+    EXPECT_FALSE(map.recordAccess(base + 2 * pageSize));
+
+    // Installing a page makes room for the next one
+    map.install(base, map.allocate(base).slot);
+    EXPECT_TRUE(map.recordAccess(base + 2 * pageSize));
+}
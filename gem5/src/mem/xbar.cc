@@ -61,6 +61,8 @@ BaseXBar::BaseXBar(const BaseXBarParams &p)
       responseLatency(p.response_latency),
       headerLatency(p.header_latency),
       width(p.width),
+      trafficInterval(p.traffic_interval),
+      trafficEvent([this]{ dumpTraffic(); }, name() + ".traffic"),
       gotAddrRanges(p.port_default_connection_count +
                           p.port_mem_side_ports_connection_count, false),
       gotAllAddrRanges(false), defaultPortID(InvalidPortID),
@@ -144,9 +146,17 @@ BaseXBar::Layer<SrcType, DstType>::Layer(DstType& _port, BaseXBar& _xbar,
                                        const std::string& _name) :
     statistics::Group(&_xbar, _name.c_str()),
     port(_port), xbar(_xbar), _name(xbar.name() + "." + _name), state(IDLE),
-    waitingForPeer(NULL), releaseEvent([this]{ releaseLayer(); }, name()),
+    waitingForPeer(NULL), waitingForPeerSince(0),
+    releaseEvent([this]{ releaseLayer(); }, name()),
     ADD_STAT(occupancy, statistics::units::Tick::get(), "Layer occupancy (ticks)"),
-    ADD_STAT(utilization, statistics::units::Ratio::get(), "Layer utilization")
+    ADD_STAT(utilization, statistics::units::Ratio::get(),
+             "Layer utilization"),
+    ADD_STAT(occupancyDist, statistics::units::Tick::get(),
+             "Ticks the layer is occupied for per transfer"),
+    ADD_STAT(waitTime, statistics::units::Tick::get(),
+             "Ticks a port waits for the layer before a retry"),
+    ADD_STAT(retries, statistics::units::Count::get(),
+             "Retries sent to waiting ports")
 {
     occupancy
         .flags(statistics::nozero);
@@ -156,6 +166,19 @@ BaseXBar::Layer<SrcType, DstType>::Layer(DstType& _port, BaseXBar& _xbar,
         .flags(statistics::nozero);
 
     utilization = occupancy / simTicks;
+
+    occupancyDist
+        .init(16)
+        .flags(statistics::nozero);
+
+    waitTime
+        .init(16)
+        .flags(statistics::nozero);
+
+    retries
+        .flags(statistics::nozero);
+
+    xbar.trafficLayers.emplace_back(_name, &busyTicks);
 }
 
 template <typename SrcType, typename DstType>
@@ -173,6 +196,8 @@ void BaseXBar::Layer<SrcType, DstType>::occupyLayer(Tick until)
 
     // account for the occupied ticks
     occupancy += until - curTick();
+    occupancyDist.sample(until - curTick());
+    busyTicks += until - curTick();
 
     DPRINTF(BaseXBar, "The crossbar layer is now busy from tick %d to %d\n",
             curTick(), until);
@@ -201,6 +226,7 @@ BaseXBar::Layer<SrcType, DstType>::tryTiming(SrcType* src_port)
         // that transaction to go through, and then the layer to free
         // up)
         waitingForLayer.push_back(src_port);
+        waitingSince.push_back(curTick());
         return false;
     }
 
@@ -234,6 +260,7 @@ BaseXBar::Layer<SrcType, DstType>::failedTiming(SrcType* src_port,
     // failed in forwarding and should track that we are now waiting
     // for the peer to send a retry
     waitingForPeer = src_port;
+    waitingForPeerSince = curTick();
 
     // we should have gone from idle or retry to busy in the tryTiming
     // test
@@ -284,6 +311,9 @@ BaseXBar::Layer<SrcType, DstType>::retryWaiting()
     // off the list
     SrcType* retryingPort = waitingForLayer.front();
     waitingForLayer.pop_front();
+    waitTime.sample(curTick() - waitingSince.front());
+    waitingSince.pop_front();
+    retries++;
 
     // tell the port to retry, which in some cases ends up calling the
     // layer again
@@ -314,6 +344,7 @@ BaseXBar::Layer<SrcType, DstType>::recvRetry()
     // the waiting ports for the layer, this allows us to call retry
     // on the port immediately if the crossbar layer is idle
     waitingForLayer.push_front(waitingForPeer);
+    waitingSince.push_front(waitingForPeerSince);
 
     // we are no longer waiting for the peer
     waitingForPeer = NULL;
@@ -334,9 +365,18 @@ BaseXBar::findPort(AddrRange addr_range)
     // ranges of all connected CPU-side-port modules
     assert(gotAllAddrRanges);
 
-    // Check the address map interval tree
+    // Check the ranges which matched recently, and then the address map
+    // interval tree. Only ranges of the map go in the cache, as they
+    // never overlap each other, unlike the default range
+    PortCacheEntry &entry =
+        portCache[(addr_range.start() >> 6) % portCacheSize];
+    if (entry.range && addr_range.isSubset(*entry.range))
+        return entry.port;
+
     auto i = portMap.contains(addr_range);
     if (i != portMap.end()) {
+        entry.range = &i->first;
+        entry.port = i->second;
         return i->second;
     }
 
@@ -359,6 +399,75 @@ BaseXBar::findPort(AddrRange addr_range)
           name());
 }
 
+BaseXBar::RouteTable::RouteTable()
+    : slots(64), indexBits(6)
+{
+}
+
+size_t
+BaseXBar::RouteTable::slotOf(const Request *req) const
+{
+    size_t mask = slots.size() - 1;
+    size_t i = home(req);
+    while (slots[i].req && slots[i].req != req)
+        i = (i + 1) & mask;
+    return i;
+}
+
+PortID
+BaseXBar::RouteTable::find(const RequestPtr &req) const
+{
+    const Slot &slot = slots[slotOf(req.get())];
+    return slot.req ? slot.port : InvalidPortID;
+}
+
+void
+BaseXBar::RouteTable::insert(const RequestPtr &req, PortID port)
+{
+    // keep the table at most half full so that the probes stay short
+    if (2 * (used + 1) > slots.size())
+        grow();
+
+    Slot &slot = slots[slotOf(req.get())];
+    assert(!slot.req);
+    slot.req = req.get();
+    slot.port = port;
+    used++;
+}
+
+void
+BaseXBar::RouteTable::erase(const RequestPtr &req)
+{
+    size_t mask = slots.size() - 1;
+    size_t i = slotOf(req.get());
+    assert(slots[i].req);
+
+    // Shift back the entries after the hole which would no longer be
+    // found past it, rather than leaving a tombstone.
+    for (size_t j = (i + 1) & mask; slots[j].req; j = (j + 1) & mask) {
+        size_t h = home(slots[j].req);
+        if (((j - h) & mask) >= ((j - i) & mask)) {
+            slots[i] = slots[j];
+            i = j;
+        }
+    }
+    slots[i] = Slot();
+    used--;
+}
+
+void
+BaseXBar::RouteTable::grow()
+{
+    std::vector<Slot> old;
+    old.swap(slots);
+    slots.resize(old.size() * 2);
+    indexBits++;
+    for (const auto &slot : old) {
+        if (slot.req)
+            slots[slotOf(slot.req)] = slot;
+    }
+}
+
 /** Function called by the port when the crossbar is receiving a range change.*/
 void
 BaseXBar::recvRangeChange(PortID mem_side_port_id)
@@ -366,6 +475,9 @@ BaseXBar::recvRangeChange(PortID mem_side_port_id)
     DPRINTF(AddrRanges, "Received range change from cpu_side_ports %s\n",
             memSidePorts[mem_side_port_id]->getPeer());
 
+    // the cached ranges may be about to go away
+    portCache.fill(PortCacheEntry());
+
     // remember that we got a range from this memory-side port and thus the
     // connected CPU-side-port module
     gotAddrRanges[mem_side_port_id] = true;
@@ -583,6 +695,59 @@ BaseXBar::regStats()
     }
 }
 
+void
+BaseXBar::init()
+{
+    ClockedObject::init();
+
+    trafficBytes.assign(cpuSidePorts.size() * memSidePorts.size(), 0);
+}
+
+void
+BaseXBar::startup()
+{
+    ClockedObject::startup();
+
+    if (!trafficInterval)
+        return;
+
+    trafficStream = simout.create(name() + ".traffic.csv");
+    std::ostream &os = *trafficStream->stream();
+    os << "tick";
+    for (const auto &layer : trafficLayers)
+        os << "," << layer.first;
+    for (auto cpu_side_port : cpuSidePorts) {
+        for (auto mem_side_port : memSidePorts) {
+            os << "," << cpu_side_port->getPeer().name() << ":"
+               << mem_side_port->getPeer().name();
+        }
+    }
+    os << "\n";
+
+    lastBusyTicks.assign(trafficLayers.size(), 0);
+    lastTrafficBytes.assign(trafficBytes.size(), 0);
+    schedule(trafficEvent, curTick() + trafficInterval);
+}
+
+void
+BaseXBar::dumpTraffic()
+{
+    std::ostream &os = *trafficStream->stream();
+    os << curTick();
+    for (int i = 0; i < trafficLayers.size(); i++) {
+        Tick busy = *trafficLayers[i].second;
+        os << "," << busy - lastBusyTicks[i];
+        lastBusyTicks[i] = busy;
+    }
+    for (int i = 0; i < trafficBytes.size(); i++) {
+        os << "," << trafficBytes[i] - lastTrafficBytes[i];
+        lastTrafficBytes[i] = trafficBytes[i];
+    }
+    os << "\n";
+
+    schedule(trafficEvent, curTick() + trafficInterval);
+}
+
 template <typename SrcType, typename DstType>
 DrainState
 BaseXBar::Layer<SrcType, DstType>::drain()
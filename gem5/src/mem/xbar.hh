@@ -46,10 +46,12 @@
 #ifndef __MEM_XBAR_HH__
 #define __MEM_XBAR_HH__
 
+#include <array>
 #include <deque>
-#include <unordered_map>
+#include <vector>
 
 #include "base/addr_range_map.hh"
+#include "base/output.hh"
 #include "base/types.hh"
 #include "mem/qport.hh"
 #include "params/BaseXBar.hh"
@@ -216,6 +218,14 @@ class BaseXBar : public ClockedObject
          */
         SrcType* waitingForPeer;
 
+        /**
+         * When each of the ports in waitingForLayer was turned away, and
+         * when the port waiting for the peer was, to sample how long
+         * they wait for their retry.
+         */
+        std::deque<Tick> waitingSince;
+        Tick waitingForPeerSince;
+
         /**
          * Release the layer after being occupied and return to an
          * idle state where we proceed to send a retry to any
@@ -232,6 +242,18 @@ class BaseXBar : public ClockedObject
         statistics::Scalar occupancy;
         statistics::Formula utilization;
 
+        /**
+         * Distribution of the ticks the layer stays busy for each
+         * transfer, of the ticks a port waits between being turned away
+         * and being sent a retry, and the number of retries sent.
+         */
+        statistics::Histogram occupancyDist;
+        statistics::Histogram waitTime;
+        statistics::Scalar retries;
+
+        /** Ticks spent busy since the start, for the traffic trace. */
+        Tick busyTicks = 0;
+
     };
 
     class ReqLayer : public Layer<ResponsePort, RequestPort>
@@ -318,13 +340,104 @@ class BaseXBar : public ClockedObject
 
     AddrRangeMap<PortID, 3> portMap;
 
+    /**
+     * A direct mapped cache of the ranges of portMap recently used by
+     * findPort, indexed by the block the start of the packet falls in,
+     * so that most lookups only check one range. Flushed whenever the
+     * address map changes.
+     */
+    struct PortCacheEntry
+    {
+        const AddrRange *range = nullptr;
+        PortID port = InvalidPortID;
+    };
+
+    static const int portCacheSize = 64;
+    std::array<PortCacheEntry, portCacheSize> portCache;
+
+    /**
+     * Table from the requests in flight to the port their response goes
+     * to. It is an open addressing hash table of request pointers which
+     * only allocates when it grows, so that adding and removing a route
+     * for every transaction does not go through the heap.
+     */
+    class RouteTable
+    {
+      public:
+        RouteTable();
+
+        /** The port of a request, or InvalidPortID if it has no route. */
+        PortID find(const RequestPtr &req) const;
+        void insert(const RequestPtr &req, PortID port);
+        void erase(const RequestPtr &req);
+
+        size_t size() const { return used; }
+
+      private:
+        struct Slot
+        {
+            const Request *req = nullptr;
+            PortID port = InvalidPortID;
+        };
+
+        std::vector<Slot> slots;
+        size_t used = 0;
+        int indexBits;
+
+        size_t
+        home(const Request *req) const
+        {
+            return ((uint64_t)(uintptr_t)req * 0x9e3779b97f4a7c15ULL) >>
+                (64 - indexBits);
+        }
+
+        size_t slotOf(const Request *req) const;
+        void grow();
+    };
+
     /**
      * Remember where request packets came from so that we can route
      * responses to the appropriate port. This relies on the fact that
      * the underlying Request pointer inside the Packet stays
      * constant.
      */
-    std::unordered_map<RequestPtr, PortID> routeTo;
+    RouteTable routeTo;
+
+    /**
+     * Time series of the traffic through the crossbar, written every
+     * trafficInterval ticks if it is not 0. Each line has the occupancy
+     * of every layer and the bytes between every pair of CPU-side and
+     * memory-side ports over the interval.
+     */
+    const Tick trafficInterval;
+    OutputStream *trafficStream = nullptr;
+    EventFunctionWrapper trafficEvent;
+
+    /** The busy ticks of every layer, in construction order. */
+    std::vector<std::pair<std::string, const Tick *>> trafficLayers;
+    std::vector<Tick> lastBusyTicks;
+
+    /** Bytes from CPU-side port i to memory-side port j, row major. */
+    std::vector<uint64_t> trafficBytes;
+    std::vector<uint64_t> lastTrafficBytes;
+
+    void dumpTraffic();
+
+    /**
+     * Account a packet between a CPU-side and a memory-side port in both
+     * the stats and the traffic trace.
+     */
+    void
+    countTraffic(PortID cpu_side_port_id, PortID mem_side_port_id,
+                 unsigned int pkt_size)
+    {
+        pktCount[cpu_side_port_id][mem_side_port_id]++;
+        pktSize[cpu_side_port_id][mem_side_port_id] += pkt_size;
+        if (trafficInterval) {
+            trafficBytes[cpu_side_port_id * memSidePorts.size() +
+                         mem_side_port_id] += pkt_size;
+        }
+    }
 
     /** all contigous ranges seen by this crossbar */
     AddrRangeList xbarRanges;
@@ -411,7 +524,9 @@ class BaseXBar : public ClockedObject
     Port &getPort(const std::string &if_name,
                   PortID idx=InvalidPortID) override;
 
+    void init() override;
     void regStats() override;
+    void startup() override;
 };
 
 } // namespace gem5
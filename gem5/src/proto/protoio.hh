@@ -49,7 +49,15 @@
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/message.h>
 
+#include <unistd.h>
+
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 /**
  * A ProtoStream provides the shared functionality of the input and
@@ -137,6 +145,130 @@ class ProtoOutputStream : public ProtoStream
  * huge data structures. The latter assumes the length of each message
  * is encoded in the stream when it is written.
  */
+/**
+ * An output stream of messages of a single type, which serializes and
+ * compresses them on a thread of its own, so that the simulation only
+ * pays for filling the messages.
+ *
+ * The owner fills the messages returned by next(), which come from
+ * buffers of bufferMessages messages that are handed over to the thread
+ * when full, and reused once written so that their memory is recycled.
+ * The owner only waits when maxQueued buffers are already waiting to be
+ * written. Deleting the stream writes the remaining messages.
+ */
+template <class Message>
+class AsyncProtoOutputStream
+{
+  public:
+    /** Messages of a buffer, and buffers queued before the owner waits */
+    static const size_t bufferMessages = 4096;
+    static const size_t maxQueued = 4;
+
+    AsyncProtoOutputStream(const std::string& filename)
+        : stream(filename), pid(getpid()), buf(bufferMessages)
+    {
+        thread = std::thread([this]() { run(); });
+    }
+
+    ~AsyncProtoOutputStream()
+    {
+        // a forked child has no writer thread, and must not write to
+        // the file of its parent
+        if (getpid() != pid)
+            return;
+        std::unique_lock<std::mutex> lock(mutex);
+        if (used != 0)
+            queued.emplace_back(std::move(buf), used);
+        done = true;
+        lock.unlock();
+        ready.notify_one();
+        thread.join();
+    }
+
+    /**
+     * Write a message of another type, such as a header, before any
+     * message is handed over.
+     */
+    void
+    writeHeader(const google::protobuf::Message& msg)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stream.write(msg);
+    }
+
+    /** Get the next message to fill, cleared. */
+    Message&
+    next()
+    {
+        if (used == buf.size())
+            queue();
+        Message &msg = buf[used++];
+        msg.Clear();
+        return msg;
+    }
+
+  private:
+    /** Hand the full buffer over and get an empty one in its place. */
+    void
+    queue()
+    {
+        if (getpid() != pid) {
+            used = 0;
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        written.wait(lock, [this]() { return queued.size() < maxQueued; });
+        queued.emplace_back(std::move(buf), used);
+        if (spare.empty()) {
+            buf = std::vector<Message>(bufferMessages);
+        } else {
+            buf = std::move(spare.back());
+            spare.pop_back();
+        }
+        used = 0;
+        lock.unlock();
+        ready.notify_one();
+    }
+
+    void
+    run()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            ready.wait(lock, [this]() { return done || !queued.empty(); });
+            if (queued.empty())
+                return;
+            auto full = std::move(queued.front());
+            queued.pop_front();
+            lock.unlock();
+
+            for (size_t i = 0; i < full.second; i++)
+                stream.write(full.first[i]);
+
+            lock.lock();
+            spare.push_back(std::move(full.first));
+            written.notify_one();
+        }
+    }
+
+    /// The underlying stream, only written by the thread once started
+    ProtoOutputStream stream;
+
+    const pid_t pid;
+    std::thread thread;
+
+    /// The buffer being filled by the owner, and its used messages
+    std::vector<Message> buf;
+    size_t used = 0;
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::condition_variable written;
+    std::deque<std::pair<std::vector<Message>, size_t>> queued;
+    std::vector<std::vector<Message>> spare;
+    bool done = false;
+};
+
 class ProtoInputStream : public ProtoStream
 {
 
@@ -1218,6 +1218,9 @@ class SimObject(object, metaclass=MetaSimObject):
     cxx_class = 'gem5::SimObject'
     cxx_extra_bases = [ "Drainable", "Serializable", "statistics::Group" ]
     eventq_index = Param.UInt32(Parent.eventq_index, "Event Queue Index")
+    host_time_stats = Param.Bool(Parent.host_time_stats,
+        "Account the host time spent in the events and timing port "
+        "handlers of this object in its hostTime stats")
 
     cxx_exports = [
         PyBindMethod("init"),
@@ -1799,6 +1802,35 @@ class SimObject(object, metaclass=MetaSimObject):
                   % self.path())
         return self._ccObject
 
+    # Parameters that don't change the structure of an object can be
+    # changed after instantiation, e.g. in simulations forked from a
+    # warmed up one, if the C++ object exports a setter for them, named
+    # set followed by the parameter name in camel case (setDegree for
+    # degree, setMemSchedPolicy for mem_sched_policy).
+    def _reconfigure_setter(self, name):
+        return "set" + "".join(w[:1].upper() + w[1:] for w in name.split("_"))
+
+    def reconfigurable(self, name):
+        return name in self._params and \
+            hasattr(self.getCCObject(), self._reconfigure_setter(name))
+
+    def reconfigure(self, **params):
+        for name, value in params.items():
+            if not self.reconfigurable(name):
+                raise RuntimeError("%s: parameter %s can't be changed after "
+                                   "instantiation" % (self.path(), name))
+            value = self._params[name].convert(value)
+            if isSimObject(value):
+                if not value._ccObject:
+                    raise RuntimeError("%s: %s is not instantiated" %
+                                       (self.path(), value))
+                cc_value = value.getCCObject()
+            else:
+                cc_value = value.getValue()
+            getattr(self.getCCObject(), self._reconfigure_setter(name))(
+                cc_value)
+            self._values[name] = value
+
     def descendants(self):
         yield self
         # The order of the dict is implementation dependent, so sort
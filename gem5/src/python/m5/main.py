@@ -95,6 +95,10 @@ def parse_options():
         choices=listener_modes, default="auto",
         help="Port (e.g., gdb) listener mode (auto: Enable if running " \
         "interactively) [Default: %default]")
+    option("--eventq-backend", metavar="{list,tree}",
+        choices=["list", "tree"], default="list",
+        help="Event queue lookup (list: fastest with few pending events, " \
+        "tree: scales to many pending events) [Default: %default]")
     option("--allow-remote-connections", action="store_true", default=False,
         help="Port listeners will accept connections from anywhere (0.0.0.0). "
         "Default is only localhost.")
@@ -145,6 +149,9 @@ def parse_options():
     option("--debug-file", metavar="FILE", default="cout",
         help="Sets the output file for debug. Append '.gz' to the name for it"
               " to be compressed automatically [Default: %default]")
+    option("--debug-binary", action='store_true', default=False,
+        help="Record the debug output to --debug-file as binary records, to "
+             "be rendered with util/trace_format.py")
     option("--debug-ignore", metavar="EXPR", action='append', split=':',
         help="Ignore EXPR sim objects")
     option("--remote-gdb-port", type='int', default=7000,
@@ -221,6 +228,7 @@ def main():
     m5.options = options
 
     # Set the main event queue for the main thread.
+    event.setEventQueueBackend(options.eventq_backend)
     event.mainq = event.getEventQueue(0)
     event.setEventQueue(event.mainq)
 
@@ -404,7 +412,13 @@ def main():
         e = event.create(trace.disable, event.Event.Debug_Enable_Pri)
         event.mainq.schedule(e, options.debug_end)
 
-    trace.output(options.debug_file)
+    if options.debug_binary:
+        _check_tracing()
+        if options.debug_file in ("cout", "cerr"):
+            fatal("--debug-binary needs a --debug-file")
+        trace.outputBinary(options.debug_file)
+    else:
+        trace.output(options.debug_file)
 
     for ignore in options.debug_ignore:
         _check_tracing()
@@ -54,7 +54,7 @@ from . import params
 from m5.util.dot_writer import do_dot, do_dvfs_dot
 from m5.util.dot_writer_ruby import do_ruby_dot
 
-from .util import fatal
+from .util import fatal, warn
 from .util import attrdict
 
 # define a MaxTick parameter, unsigned 64 bit
@@ -153,6 +153,72 @@ def instantiate(ckpt_dir=None):
     # a checkpoint, If so, this call will shift them to be at a valid time.
     updateStatEvents()
 
+# C++ configuration of a simulation instantiated from a configuration file
+_cxx_config = None
+
+def instantiate_from_config(config_file, overrides={}, ckpt_dir=None):
+    """Instantiate the simulator from a configuration file.
+
+    This function instantiates the simulator from the config.ini an
+    earlier m5.instantiate() wrote, with the C++ configuration manager,
+    instead of a graph of Python SimObjects. This skips building the
+    Python objects, resolving their parameters and creating the
+    parameter structs from Python, so that e.g. the runs of a sweep over
+    parameters only pay for that once. It needs gem5 to be built with
+    --with-cxx-config.
+
+    There are no Python SimObjects afterwards, so this only supports
+    simulating and the text statistics. Anything that walks the Python
+    object graph (checkpointing, switching CPUs, forking) is not
+    supported.
+
+    Arguments:
+      config_file -- The config.ini to instantiate.
+      overrides -- Dictionary of parameter values by "object.parameter"
+                   path, strings or lists of strings for vector
+                   parameters, as they are written in config.ini.
+      ckpt_dir -- Checkpoint to restore from.
+    """
+    global _instantiated
+    global _cxx_config
+
+    if _instantiated:
+        fatal("m5.instantiate() called twice.")
+    if objects.Root.getInstance():
+        fatal("Can't instantiate from a configuration file with a Root()")
+    if not hasattr(_m5, "cxx_config"):
+        fatal("gem5 must be built with --with-cxx-config to instantiate "
+              "from a configuration file")
+
+    _instantiated = True
+
+    ticks.fixGlobalFrequency()
+    stats.initSimStats()
+
+    try:
+        _cxx_config = _m5.cxx_config.CxxConfig(config_file)
+        for path, value in overrides.items():
+            obj, _, param = path.rpartition(".")
+            if isinstance(value, (list, tuple)):
+                _cxx_config.setParamVector(obj, param,
+                                           [str(v) for v in value])
+            else:
+                _cxx_config.setParam(obj, param, str(value))
+        _cxx_config.instantiate()
+    except RuntimeError as e:
+        fatal("Can't instantiate %s: %s" % (config_file, e))
+
+    stats._cxx_root = _cxx_config.getObject("root")
+    stats.enable()
+
+    if ckpt_dir:
+        _drain_manager.preCheckpointRestore()
+        _cxx_config.loadState(ckpt_dir)
+    else:
+        _cxx_config.initState()
+
+    updateStatEvents()
+
 need_startup = True
 def simulate(*args, **kwargs):
     global need_startup
@@ -162,8 +228,11 @@ def simulate(*args, **kwargs):
         fatal("m5.instantiate() must be called before m5.simulate().")
 
     if need_startup:
-        root = objects.Root.getInstance()
-        for obj in root.descendants(): obj.startup()
+        if _cxx_config:
+            _cxx_config.startup()
+        else:
+            root = objects.Root.getInstance()
+            for obj in root.descendants(): obj.startup()
         need_startup = False
 
         # Python exit handlers happen in reverse order.
@@ -189,15 +258,21 @@ def simulate(*args, **kwargs):
 
     return sim_out
 
-def drain():
+def drain(objs=None):
     """Drain the simulator in preparation of a checkpoint or memory mode
     switch.
 
     This operation is a no-op if the simulator is already in the
     Drained state.
 
+    Arguments:
+      objs -- SimObjects to drain, the rest of the simulator keeps
+              running. Drain all objects if None.
     """
 
+    if objs is not None:
+        objs = [ obj.getCCObject() for obj in objs ]
+
     # Try to drain all objects. Draining might not be completed unless
     # all objects return that they are drained on the first call. This
     # is because as objects drain they may cause other objects to no
@@ -206,7 +281,11 @@ def drain():
         # Try to drain the system. The drain is successful if all
         # objects are done without simulation. We need to simulate
         # more if not.
-        if _drain_manager.tryDrain():
+        if objs is None:
+            drained = _drain_manager.tryDrain()
+        else:
+            drained = _drain_manager.tryDrain(objs)
+        if drained:
             return True
 
         # WARNING: if a valid exit event occurs while draining, it
@@ -224,6 +303,30 @@ def drain():
 
     assert _drain_manager.isDrained(), "Drain state inconsistent"
 
+def drainStats():
+    """Return statistics of the drain operations so far.
+
+    The result has the number of completed drains (drains), the number
+    of drain rounds they took (rounds), and the simulated ticks (ticks)
+    and host seconds (host_seconds) spent draining.
+    """
+
+    return attrdict(drains=_drain_manager.numDrains(),
+                    rounds=_drain_manager.numDrainRounds(),
+                    ticks=_drain_manager.drainTicks(),
+                    host_seconds=_drain_manager.drainHostSeconds())
+
+def _cpuPrivateObjects(cpu):
+    """Yield a CPU and the objects private to it, leaving out its caches
+    as they are part of the memory system."""
+
+    if isinstance(cpu, objects.BaseCache):
+        return
+    yield cpu
+    for (name, child) in sorted(cpu._children.items()):
+        for obj in _cpuPrivateObjects(child):
+            yield obj
+
 def memWriteback(root):
     for obj in root.descendants():
         obj.memWriteback()
@@ -240,7 +343,7 @@ def checkpoint(dir):
     drain()
     memWriteback(root)
     print("Writing checkpoint")
-    _m5.core.serializeAll(dir)
+    _m5.core.serializeAll(dir, bool(root.binary_checkpoints))
 
 def _changeMemoryMode(system, mode):
     if not isinstance(system, (objects.Root, objects.System)):
@@ -256,7 +359,9 @@ def switchCpus(system, cpuList, verbose=True):
 
     Note: This method may switch the memory mode of the system if that
     is required by the CPUs. It may also flush all caches in the
-    system.
+    system. If the memory mode doesn't change, only the old CPUs and
+    the objects private to them are drained, and the memory system
+    keeps running.
 
     Arguments:
       system -- Simulated system.
@@ -305,7 +410,14 @@ def switchCpus(system, cpuList, verbose=True):
     except KeyError:
         raise RuntimeError("Invalid memory mode (%s)" % memory_mode_name)
 
-    drain()
+    # The memory system only needs to be drained if the memory mode
+    # changes, the CPUs are handed over with their caches running
+    # otherwise.
+    if system.getMemoryMode() == memory_mode:
+        drain([ obj for old_cpu in old_cpus
+                for obj in _cpuPrivateObjects(old_cpu) ])
+    else:
+        drain()
 
     # Now all of the CPUs are ready to be switched out
     for old_cpu, new_cpu in cpuList:
@@ -363,6 +475,10 @@ def fork(simout="%(parent)s.f%(fork_seq)i"):
     # Terminate helper threads that service parallel event queues.
     _m5.event.terminateEventQueueThreads()
 
+    # The stats writer threads are not forked, so their dumps have to
+    # be written before the child inherits the output streams.
+    stats.flush()
+
     try:
         pid = os.fork()
     except OSError as e:
@@ -385,6 +501,64 @@ def fork(simout="%(parent)s.f%(fork_seq)i"):
 
     return pid
 
+def fork_sweep(deltas, simout="%(parent)s.d%(delta)i", max_children=None):
+    """Fork a simulation per set of parameter changes.
+
+    This function forks a child per delta, which reconfigures the
+    simulator as given by the delta and goes on with the simulation. All
+    the children start from the state of the parent, e.g. after a
+    warmup, which they share copy-on-write. Only parameters the objects
+    can change after instantiation can be swept (see
+    SimObject.reconfigure()).
+
+    Output file formatting dictionary, as for fork():
+      parent -- Path to the parent process's output directory.
+      fork_seq -- Fork sequence number.
+      pid -- PID of the child process.
+      delta -- Index of the delta of the child.
+
+    Arguments:
+      deltas -- List of deltas, each one a list of (SimObject, dict of
+                parameter values) pairs.
+
+    Keyword Arguments:
+      simout -- Simulation output directory of the children.
+      max_children -- Maximum number of children running at the same
+                      time, one per host CPU by default.
+
+    Return Value:
+      Index of the delta in a child, None in the parent once all the
+      children have exited.
+    """
+    if max_children is None:
+        max_children = os.cpu_count() or 1
+
+    running = {}
+    def wait_child():
+        pid, status = os.wait()
+        delta = running.pop(pid)
+        if not os.WIFEXITED(status) or os.WEXITSTATUS(status):
+            warn("The simulation of delta %d failed (status %d)" %
+                 (delta, status))
+
+    for delta, changes in enumerate(deltas):
+        while len(running) >= max_children:
+            wait_child()
+        # keep the placeholders of fork() in the output directory name
+        pid = fork(simout % {"parent" : "%(parent)s",
+                             "fork_seq" : "%(fork_seq)i",
+                             "pid" : "%(pid)i",
+                             "delta" : delta})
+        if pid == 0:
+            for obj, params in changes:
+                obj.reconfigure(**params)
+            return delta
+        running[pid] = delta
+
+    while running:
+        wait_child()
+    return None
+
 from _m5.core import disableAllListeners, listenersDisabled
 from _m5.core import listenersLoopbackOnly
 from _m5.core import curTick
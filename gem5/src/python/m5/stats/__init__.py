@@ -129,23 +129,50 @@ def _url_factory(schemes, enable=True):
     return decorator
 
 @_url_factory([ None, "", "text", "file", ])
-def _textFactory(fn, desc=True, spaces=True):
+def _textFactory(fn, desc=True, spaces=True, changed=False):
     """Output stats in text format.
 
     Text stat files contain one stat per line with an optional
     description. The description is enabled by default, but can be
     disabled by setting the desc parameter to False.
 
+    When changed is set, only stats whose value changed since the
+    previous dump are printed. Formulas are only evaluated if one of
+    their operands changed.
+
     Parameters:
       * desc (bool): Output stat descriptions (default: True)
       * spaces (bool): Output alignment spaces (default: True)
+      * changed (bool): Only output changed stats (default: False)
 
     Example:
       text://stats.txt?desc=False;spaces=False
+      text://stats.txt?changed=True
+
+    """
+
+    return _m5.stats.initText(fn, desc, spaces, changed)
+
+@_url_factory([ "bin", ])
+def _binaryFactory(fn):
+    """Output stats in a columnar binary format.
+
+    Every stat is flattened into double precision columns. The column
+    names are stored once and each dump only appends the simulated
+    tick and the stat values, which makes frequent dumps much cheaper
+    than the text format. The file can be loaded into a pandas
+    DataFrame with util/stats/binary.py.
+
+    Known limitations:
+      * Sparse histograms only record their sample count.
+      * Stat descriptions and units are not stored.
+
+    Example:
+      bin://stats.bin
 
     """
 
-    return _m5.stats.initText(fn, desc, spaces)
+    return _m5.stats.initBinary(fn)
 
 @_url_factory([ "h5", ], enable=hasattr(_m5.stats, "initHDF5"))
 def _hdf5Factory(fn, chunking=10, desc=True, formulas=True):
@@ -242,13 +269,20 @@ def printStatVisitorTypes():
         # Try to extract the factory doc string
         print_doc(inspect.getdoc(factory))
 
+# C++ root object of a simulation instantiated from a configuration file,
+# see m5.instantiate_from_config()
+_cxx_root = None
+
+def _root():
+    return Root.getInstance() or _cxx_root
+
 def initSimStats():
     _m5.stats.initSimStats()
     _m5.stats.registerPythonStatsHandlers()
 
 def _visit_groups(visitor, root=None):
     if root is None:
-        root = Root.getInstance()
+        root = _root()
     for group in root.getStatGroups().values():
         visitor(group)
         _visit_groups(visitor, root=group)
@@ -335,6 +369,15 @@ def prepare():
     # New stats
     _visit_stats(lambda g, s: s.prepare())
 
+def _update_changed():
+    '''Record which stats changed since the previous dump. This must be
+    done once per dump, after the stats have been prepared.'''
+
+    for stat in stats_list:
+        stat.updateChanged()
+
+    _visit_stats(lambda g, s: s.updateChanged())
+
 def _dump_to_visitor(visitor, roots=None):
     # New stats
     def dump_group(group):
@@ -355,7 +398,7 @@ def _dump_to_visitor(visitor, roots=None):
                 visitor.endGroup()
     else:
         # New stats starting from root.
-        dump_group(Root.getInstance())
+        dump_group(_root())
 
         # Legacy stats
         for stat in stats_list:
@@ -389,15 +432,16 @@ def dump(roots=None):
     if new_dump:
         _m5.stats.processDumpQueue()
         # Notify new-style stats group that we are about to dump stats.
-        sim_root = Root.getInstance()
+        sim_root = _root()
         if sim_root:
             sim_root.preDumpStats();
         prepare()
+        _update_changed()
 
     for output in outputList:
         if isinstance(output, JsonOutputVistor):
             if not all_roots:
-                output.dump(Root.getInstance())
+                output.dump(_root())
             else:
                 output.dump(all_roots)
         else:
@@ -406,11 +450,18 @@ def dump(roots=None):
                 _dump_to_visitor(output, roots=all_roots)
                 output.end()
 
+def flush():
+    '''Wait until the outputs have written all the dumps'''
+
+    for output in outputList:
+        if not isinstance(output, JsonOutputVistor):
+            output.flush()
+
 def reset():
     '''Reset all statistics to the base state'''
 
     # call reset stats on all SimObjects
-    root = Root.getInstance()
+    root = _root()
     if root:
         root.resetStats()
 
@@ -420,6 +471,76 @@ def reset():
 
     _m5.stats.processResetQueue()
 
+def _sampled_stats(names):
+    '''Resolve stat names into the (group, stat) pairs of a Sampler'''
+
+    root = _root()
+    stats = []
+    for name in names:
+        if name in stats_dict:
+            # Legacy stats have their full name
+            stats.append(("", stats_dict[name]))
+            continue
+
+        try:
+            stats.append((name.rpartition('.')[0], root.resolveStat(name)))
+        except KeyError:
+            fatal("Unknown stat '%s'" % name)
+    return stats
+
+def snapshot(names):
+    '''Sample the current values of the named stats, without dumping.
+
+    Every stat is flattened into double precision columns, as in the
+    binary output. Returns the names of the columns and a NumPy array
+    of their values. The stats updated by dump callbacks hold the value
+    of the last dump.'''
+
+    sampler = _m5.stats.Sampler(_sampled_stats(names), 1)
+    return sampler.names(), sampler.values
+
+class Subscription(object):
+    '''The named stats sampled every period ticks into a ring of
+    preallocated rows, which holds the tick then the columns of the
+    stats, as in snapshot().
+
+    The ring is a NumPy array that shares the memory of the sampler, so
+    it can be inspected as the simulation runs, without any copy.'''
+
+    def __init__(self, names, period, capacity=1024):
+        self._sampler = _m5.stats.Sampler(_sampled_stats(names), capacity)
+        self.names = [ "tick" ] + self._sampler.names()
+        self.ring = self._sampler.ring
+        self._sampler.start(period)
+
+    @property
+    def count(self):
+        '''Samples recorded since the subscription'''
+        return self._sampler.count
+
+    def latest(self):
+        '''Row of the last sample, or None before the first one'''
+        count = self._sampler.count
+        if not count:
+            return None
+        return self.ring[(count - 1) % len(self.ring)]
+
+    def history(self):
+        '''Copy of the samples still in the ring, oldest first'''
+        import numpy
+        count = self._sampler.count
+        if count <= len(self.ring):
+            return self.ring[:count].copy()
+        return numpy.roll(self.ring, -(count % len(self.ring)), axis=0)
+
+    def stop(self):
+        self._sampler.stop()
+
+def subscribe(names, period, capacity=1024):
+    '''Sample the named stats every period ticks, see Subscription'''
+
+    return Subscription(names, period, capacity)
+
 flags = attrdict({
     'none'    : 0x0000,
     'init'    : 0x0001,
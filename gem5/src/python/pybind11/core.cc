@@ -106,12 +106,18 @@ init_drain(py::module_ &m_native)
     // destructor. Disable deallocation from the Python binding.
     py::class_<DrainManager, std::unique_ptr<DrainManager, py::nodelete>>(
         m, "DrainManager")
-        .def("tryDrain", &DrainManager::tryDrain)
+        .def("tryDrain", py::overload_cast<>(&DrainManager::tryDrain))
+        .def("tryDrain", py::overload_cast<const std::vector<Drainable *> &>(
+                 &DrainManager::tryDrain))
         .def("resume", &DrainManager::resume)
         .def("preCheckpointRestore", &DrainManager::preCheckpointRestore)
         .def("isDrained", &DrainManager::isDrained)
         .def("state", &DrainManager::state)
         .def("signalDrainDone", &DrainManager::signalDrainDone)
+        .def("numDrains", &DrainManager::numDrains)
+        .def("numDrainRounds", &DrainManager::numDrainRounds)
+        .def("drainTicks", &DrainManager::drainTicks)
+        .def("drainHostSeconds", &DrainManager::drainHostSeconds)
         .def_static("instance", &DrainManager::instance,
                     py::return_value_policy::reference)
         ;
@@ -0,0 +1,120 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "pybind11/pybind11.h"
+#include "pybind11/stl.h"
+#include "sim/cxx_config.hh"
+#include "sim/cxx_config_ini.hh"
+#include "sim/cxx_manager.hh"
+#include "sim/init.hh"
+#include "sim/serialize.hh"
+#include "sim/sim_object.hh"
+
+namespace py = pybind11;
+
+namespace gem5
+{
+
+namespace
+{
+
+/**
+ * The C++ configuration of a simulation loaded from a config.ini, for
+ * m5.instantiate_from_config().
+ */
+class CxxConfig
+{
+  private:
+    CxxIniFile configFile;
+    std::unique_ptr<CxxConfigManager> manager;
+
+  public:
+    CxxConfig(const std::string &config_file)
+    {
+        cxxConfigInit();
+        if (!configFile.load(config_file))
+            throw std::runtime_error("Can't open config file " + config_file);
+        manager = std::make_unique<CxxConfigManager>(configFile);
+    }
+
+    CxxConfigManager &get() { return *manager; }
+};
+
+void
+cxx_config_pybind(py::module_ &m_internal)
+{
+    py::module_ m = m_internal.def_submodule("cxx_config");
+
+    py::register_exception_translator([](std::exception_ptr p) {
+        try {
+            if (p)
+                std::rethrow_exception(p);
+        } catch (const CxxConfigManager::Exception &e) {
+            PyErr_SetString(PyExc_RuntimeError,
+                            (e.name + ": " + e.message).c_str());
+        }
+    });
+
+    py::class_<CxxConfig>(m, "CxxConfig")
+        .def(py::init<const std::string &>())
+        .def("setParam", [](CxxConfig &c, const std::string &object,
+                            const std::string &param,
+                            const std::string &value) {
+                c.get().setParam(object, param, value);
+            })
+        .def("setParamVector", [](CxxConfig &c, const std::string &object,
+                                  const std::string &param,
+                                  const std::vector<std::string> &values) {
+                c.get().setParamVector(object, param, values);
+            })
+        .def("instantiate", [](CxxConfig &c) {
+                c.get().instantiate(true, true);
+            })
+        .def("initState", [](CxxConfig &c) { c.get().initState(); })
+        .def("startup", [](CxxConfig &c) { c.get().startup(); })
+        .def("loadState", [](CxxConfig &c, const std::string &cpt_dir) {
+                SimObject::setSimObjectResolver(
+                    &c.get().getSimObjectResolver());
+                CheckpointIn cpt(cpt_dir);
+                c.get().loadState(cpt);
+            })
+        .def("getObject", [](CxxConfig &c, const std::string &name) {
+                return &c.get().getObject<SimObject>(name);
+            }, py::return_value_policy::reference)
+        .def("getObjects", [](CxxConfig &c) {
+                return std::vector<SimObject *>(
+                    c.get().objectsInOrder.begin(),
+                    c.get().objectsInOrder.end());
+            }, py::return_value_policy::reference)
+        ;
+}
+EmbeddedPyBind embed_("cxx_config", &cxx_config_pybind);
+
+} // anonymous namespace
+} // namespace gem5
@@ -42,11 +42,15 @@
 #include "pybind11/pybind11.h"
 #include "pybind11/stl.h"
 
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
 #include <map>
 #include <vector>
 
 #include "base/compiler.hh"
 #include "base/debug.hh"
+#include "base/logging.hh"
 #include "base/output.hh"
 #include "base/trace.hh"
 #include "sim/debug.hh"
@@ -67,6 +71,45 @@ output(const char *filename)
     Trace::setDebugLogger(new Trace::OstreamLogger(*file_stream->stream()));
 }
 
+static Trace::BinaryLogger *binaryLogger = nullptr;
+
+static void
+outputBinary(const char *filename)
+{
+    OutputStream *file_stream = simout.find(filename);
+
+    if (!file_stream)
+        file_stream = simout.create(filename, true);
+
+    // the records left in the buffers are written out at exit, the
+    // logger is never deleted
+    static bool registered = false;
+    if (!registered) {
+        std::atexit([]() { binaryLogger->flush(); });
+        registered = true;
+    } else {
+        binaryLogger->flush();
+    }
+
+    binaryLogger = new Trace::BinaryLogger(*file_stream->stream());
+    Trace::setDebugLogger(binaryLogger);
+}
+
+static bool
+formatBinary(const char *in_filename, const char *out_filename)
+{
+    std::ifstream in(in_filename, std::ios::binary);
+    if (!in) {
+        warn("Could not open %s\n", in_filename);
+        return false;
+    }
+    std::ofstream out_file;
+    if (std::string(out_filename) != "-")
+        out_file.open(out_filename);
+    Trace::OstreamLogger logger(out_file.is_open() ? out_file : std::cout);
+    return Trace::replayBinaryTrace(in, logger);
+}
+
 static void
 ignore(const char *expr)
 {
@@ -122,6 +165,8 @@ pybind_init_debug(py::module_ &m_native)
     py::module_ m_trace = m_native.def_submodule("trace");
     m_trace
         .def("output", &output)
+        .def("outputBinary", &outputBinary)
+        .def("formatBinary", &formatBinary)
         .def("ignore", &ignore)
         .def("enable", &Trace::enable)
         .def("disable", &Trace::disable)
@@ -114,6 +114,14 @@ pybind_init_event(py::module_ &m_native)
     m.def("setEventQueue", [](EventQueue *q) { return curEventQueue(q); });
     m.def("getEventQueue", &getEventQueue,
           py::return_value_policy::reference);
+    m.def("setEventQueueBackend", [](const std::string &backend) {
+            if (backend == "list")
+                setEventQueueBackend(EventQueue::Backend::List);
+            else if (backend == "tree")
+                setEventQueueBackend(EventQueue::Backend::Tree);
+            else
+                fatal("Unknown event queue backend '%s'.", backend);
+        });
 
     py::class_<EventQueue>(m, "EventQueue")
         .def("name",  [](EventQueue *eq) { return eq->name(); })
@@ -38,10 +38,12 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "pybind11/numpy.h"
 #include "pybind11/pybind11.h"
 #include "pybind11/stl.h"
 
 #include "base/statistics.hh"
+#include "base/stats/binary.hh"
 #include "base/stats/text.hh"
 #include "config/have_hdf5.hh"
 
@@ -51,6 +53,7 @@
 #endif
 #include "sim/stat_control.hh"
 #include "sim/stat_register.hh"
+#include "sim/stat_sampler.hh"
 
 namespace py = pybind11;
 
@@ -112,6 +115,8 @@ pybind_init_stats(py::module_ &m_native)
         .def("initSimStats", &statistics::initSimStats)
         .def("initText", &statistics::initText,
             py::return_value_policy::reference)
+        .def("initBinary", &statistics::initBinary,
+            py::return_value_policy::reference)
 #if HAVE_HDF5
         .def("initHDF5", &statistics::initHDF5)
 #endif
@@ -131,6 +136,7 @@ pybind_init_stats(py::module_ &m_native)
         .def("begin", &statistics::Output::begin)
         .def("end", &statistics::Output::end)
         .def("valid", &statistics::Output::valid)
+        .def("flush", &statistics::Output::flush)
         .def("beginGroup", &statistics::Output::beginGroup)
         .def("endGroup", &statistics::Output::endGroup)
         ;
@@ -152,6 +158,8 @@ pybind_init_stats(py::module_ &m_native)
         .def("prepare", &statistics::Info::prepare)
         .def("reset", &statistics::Info::reset)
         .def("zero", &statistics::Info::zero)
+        .def("updateChanged", &statistics::Info::updateChanged)
+        .def("changed", &statistics::Info::changed)
         .def("visit", &statistics::Info::visit)
         ;
 
@@ -199,6 +207,10 @@ pybind_init_stats(py::module_ &m_native)
             [](const statistics::DistInfo &info) {
                 return info.data.bucket_size;
             })
+        .def_property_readonly("bucket_lows",
+            [](const statistics::DistInfo &info) {
+                return info.data.bucket_lows;
+            })
         .def_property_readonly("values",
             [](const statistics::DistInfo &info) { return info.data.cvec; })
         .def_property_readonly("overflow",
@@ -217,6 +229,32 @@ pybind_init_stats(py::module_ &m_native)
             [](const statistics::DistInfo &info) { return info.data.squares; })
         ;
 
+    // The arrays share the memory of the sampler, which they keep alive
+    py::class_<statistics::Sampler>(m, "Sampler")
+        .def(py::init<const std::vector<statistics::Sampler::Stat> &,
+                      size_t>())
+        .def("sample", &statistics::Sampler::sample)
+        .def("start", &statistics::Sampler::start)
+        .def("stop", &statistics::Sampler::stop)
+        .def("names", &statistics::Sampler::columnNames)
+        .def_property_readonly("values", [](py::object self) {
+                const auto &values =
+                    self.cast<const statistics::Sampler &>().columns();
+                return py::array_t<double>(values.size(), values.data(),
+                                           self);
+            })
+        .def_property_readonly("ring", [](py::object self) {
+                const auto &sampler = self.cast<const statistics::Sampler &>();
+                const size_t row_size = sampler.rowSize();
+                return py::array_t<double>(
+                    { sampler.capacity(), row_size },
+                    { row_size * sizeof(double), sizeof(double) },
+                    sampler.ring().data(), self);
+            })
+        .def_property_readonly("capacity", &statistics::Sampler::capacity)
+        .def_property_readonly("count", &statistics::Sampler::count)
+        ;
+
     py::class_<statistics::Group,
         std::unique_ptr<statistics::Group, py::nodelete>>(m, "Group")
         .def("regStats", &statistics::Group::regStats)
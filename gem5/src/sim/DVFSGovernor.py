@@ -0,0 +1,60 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from m5.SimObject import SimObject
+from m5.proxy import *
+
+# How the governor picks the performance level of a domain every epoch:
+#   ondemand:     the slowest level at which the CPUs would have been busy
+#                 for up_threshold of the epoch, the fastest level once
+#                 they are busier than that
+#   memory_bound: ondemand, scaled down further by the fraction of the
+#                 cycles the CPUs stalled on memory above
+#                 mem_stall_threshold, as those don't get faster with the
+#                 clock
+#   min_edp:      the level minimizing the energy-delay product of the
+#                 work of the last epoch, predicted from its memory stalls
+#                 and from the power of the CPUs and the voltage of the
+#                 levels
+class DVFSGovernorPolicy(Enum):
+    vals = ['ondemand', 'memory_bound', 'min_edp']
+
+# Drives the DVFS handler from the activity of the CPUs, rather than from
+# guest software. The domains governed are the clock domains of the CPUs,
+# which the handler must control.
+class DVFSGovernor(SimObject):
+    type = 'DVFSGovernor'
+    cxx_header = "sim/dvfs_governor.hh"
+    cxx_class = 'gem5::DVFSGovernor'
+
+    handler = Param.DVFSHandler(Parent.dvfs_handler,
+        "Handler changing the performance levels")
+    cpus = VectorParam.BaseCPU([], "CPUs whose clock domains are governed")
+    epoch = Param.Latency('1ms', "Time between two decisions")
+    policy = Param.DVFSGovernorPolicy('ondemand',
+        "How the performance levels are picked")
+    up_threshold = Param.Float(0.8, "Fraction of the cycles of an epoch "
+        "the CPUs of a domain are busy above which it runs at full speed")
+    mem_stall_threshold = Param.Float(0.3, "Fraction of the busy cycles "
+        "stalled on memory above which memory_bound lowers the clock")
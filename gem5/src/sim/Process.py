@@ -45,6 +45,11 @@ class Process(SimObject):
     useArchPT = Param.Bool('false', 'maintain an in-memory version of the page\
                             table in an architecture-specific format')
     kvmInSE = Param.Bool('false', 'initialize the process for KvmCPU in SE')
+    directSyscallCopies = Param.Bool(False, "copy the syscall buffers "
+        "straight from and to the host memory rather than through the "
+        "memory system. This is only correct when no cache can hold the "
+        "data of the process, it is always done when the caches are "
+        "bypassed")
     maxStackSize = Param.MemorySize('64MiB', 'maximum size of the stack')
 
     uid = Param.Int(100, 'user id')
@@ -63,12 +63,33 @@ class Root(SimObject):
     # event on the eventq with index 0.
     eventq_index = 0
 
+    # Host time stats are enabled per subtree, see SimObject.
+    host_time_stats = False
+
     # Simulation Quantum for multiple main event queue simulation.
     # Needs to be set explicitly for a multi-eventq simulation.
     sim_quantum = Param.Tick(0, "simulation quantum")
 
+    # The quantum adapts to the interaction between the event queues
+    # when given a range. 0 means sim_quantum.
+    sim_quantum_min = Param.Tick(0, "smallest simulation quantum")
+    sim_quantum_max = Param.Tick(0, "largest simulation quantum")
+    sim_quantum_cross_limit = Param.UInt64(1000, "events exchanged between "
+        "event queues per quantum above which the quantum shrinks")
+    sim_quantum_wait_limit = Param.Float(0.1, "fraction of the host time "
+        "spent in quantum barriers above which the quantum grows")
+
+    binary_checkpoints = Param.Bool(False, "write checkpoints as a binary "
+        "container (m5.bcpt) rather than INI text (m5.cpt), see "
+        "util/cpt_convert.py")
+
     full_system = Param.Bool("if this is a full system simulation")
 
+    # Profile the host time spent in the events of the main event queues
+    # and write it to host_profile.txt.
+    host_profile_period = Param.Unsigned(0, "time one in this many events "
+        "on the host, 0 disables host profiling")
+
     # Time syncing prevents the simulation from running faster than real time.
     time_sync_enable = Param.Bool(False, "whether time syncing is enabled")
     time_sync_period = Param.Clock("100ms", "how often to sync with real time")
@@ -49,6 +49,8 @@ from m5.objects.Workload import StubWorkload
 class MemoryMode(Enum): vals = ['invalid', 'atomic', 'timing',
                                 'atomic_noncaching']
 
+class MemoryCheckpointFormat(Enum): vals = ['gzip', 'chunked', 'image']
+
 class System(SimObject):
     type = 'System'
     cxx_header = "sim/system.hh"
@@ -89,6 +91,27 @@ class System(SimObject):
         "use to directly address the backstore from another host-OS process. "
         "Leave this empty to unset the MAP_SHARED flag.")
 
+    # How checkpoints store the memory: as a single gzip stream, as
+    # independently compressed chunks without the zero pages, which are
+    # compressed and restored in parallel, or as a sparse uncompressed
+    # image. Restoring an image maps it copy-on-write as the backing
+    # store, so the checkpoint must not be changed while it is in use.
+    memory_checkpoint_format = Param.MemoryCheckpointFormat('chunked',
+        "Format of the memory in checkpoints")
+    memory_checkpoint_threads = Param.Unsigned(0, "Threads compressing "
+        "and restoring the memory in checkpoints, 0 for one per host CPU")
+
+    # Incremental checkpoints only write the pages written to since the
+    # previous checkpoint, as a delta that refers to it. Restoring one
+    # reads the whole chain, so the earlier checkpoints must be kept, or
+    # flattened into it with util/cpt_flatten.py. The memory is handed
+    # out for reading only to the CPUs, and the checkpoints are all full
+    # once KVM maps it.
+    memory_checkpoint_incremental = Param.Bool(False, "Write only the "
+        "memory pages dirtied since the previous checkpoint")
+    memory_checkpoint_max_deltas = Param.Unsigned(0, "Incremental "
+        "checkpoints chained before a full one is written, 0 for no limit")
+
     cache_line_size = Param.Unsigned(64, "Cache line size in bytes")
 
     redirect_paths = VectorParam.RedirectPath([], "Path redirections")
@@ -0,0 +1,417 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/binary_checkpoint.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+
+#include "base/logging.hh"
+#include "base/str.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+template <class T>
+T
+loadElement(const void *data, uint64_t i)
+{
+    T value;
+    std::memcpy(&value, (const uint8_t *)data + i * sizeof(T), sizeof(T));
+    return value;
+}
+
+template <class T>
+std::string
+showElement(const void *data, uint64_t i)
+{
+    std::ostringstream os;
+    ShowParam<T>::show(os, loadElement<T>(data, i));
+    return os.str();
+}
+
+} // anonymous namespace
+
+size_t
+BinaryCheckpoint::typeSize(Type type)
+{
+    switch (type) {
+      case Type::Text:
+      case Type::Int8:
+      case Type::UInt8:
+        return 1;
+      case Type::Int16:
+      case Type::UInt16:
+        return 2;
+      case Type::Int32:
+      case Type::UInt32:
+      case Type::Float:
+        return 4;
+      case Type::Int64:
+      case Type::UInt64:
+      case Type::Double:
+        return 8;
+      default:
+        return 0;
+    }
+}
+
+int64_t
+BinaryCheckpoint::signedElement(const Entry &entry, uint64_t i)
+{
+    switch (entry.type) {
+      case Type::Int8: return loadElement<int8_t>(entry.data, i);
+      case Type::Int16: return loadElement<int16_t>(entry.data, i);
+      case Type::Int32: return loadElement<int32_t>(entry.data, i);
+      case Type::Int64: return loadElement<int64_t>(entry.data, i);
+      default: panic("Not an array of signed integers");
+    }
+}
+
+uint64_t
+BinaryCheckpoint::unsignedElement(const Entry &entry, uint64_t i)
+{
+    switch (entry.type) {
+      case Type::UInt8: return loadElement<uint8_t>(entry.data, i);
+      case Type::UInt16: return loadElement<uint16_t>(entry.data, i);
+      case Type::UInt32: return loadElement<uint32_t>(entry.data, i);
+      case Type::UInt64: return loadElement<uint64_t>(entry.data, i);
+      default: panic("Not an array of unsigned integers");
+    }
+}
+
+std::string
+BinaryCheckpoint::elementText(const Entry &entry, uint64_t i)
+{
+    switch (entry.type) {
+      case Type::Int8: return showElement<int8_t>(entry.data, i);
+      case Type::UInt8: return showElement<uint8_t>(entry.data, i);
+      case Type::Int16: return showElement<int16_t>(entry.data, i);
+      case Type::UInt16: return showElement<uint16_t>(entry.data, i);
+      case Type::Int32: return showElement<int32_t>(entry.data, i);
+      case Type::UInt32: return showElement<uint32_t>(entry.data, i);
+      case Type::Int64: return showElement<int64_t>(entry.data, i);
+      case Type::UInt64: return showElement<uint64_t>(entry.data, i);
+      case Type::Float: return showElement<float>(entry.data, i);
+      case Type::Double: return showElement<double>(entry.data, i);
+      default: panic("Not an array checkpoint entry");
+    }
+}
+
+std::string
+BinaryCheckpoint::text(const Entry &entry)
+{
+    if (entry.type == Type::Text)
+        return std::string((const char *)entry.data, entry.count);
+
+    std::string str;
+    for (uint64_t i = 0; i < entry.count; i++) {
+        if (i)
+            str += ' ';
+        str += elementText(entry, i);
+    }
+    return str;
+}
+
+BinaryCheckpoint::~BinaryCheckpoint()
+{
+    if (base)
+        munmap((void *)base, length);
+}
+
+bool
+BinaryCheckpoint::load(const std::string &file_name)
+{
+    int fd = open(file_name.c_str(), O_RDONLY);
+    if (fd == -1)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) == -1)
+        fatal("Can't stat checkpoint %s: %s", file_name, strerror(errno));
+    file = file_name;
+    length = st.st_size;
+    fatal_if(length < sizeof(Header), "Checkpoint %s is truncated", file);
+
+    void *addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+        fatal("Can't map checkpoint %s: %s", file, strerror(errno));
+    base = (const uint8_t *)addr;
+
+    Header header;
+    std::memcpy(&header, base, sizeof(header));
+    fatal_if(std::memcmp(header.magic, magic, sizeof(magic)),
+             "%s isn't a binary checkpoint", file);
+    fatal_if(header.byteOrderMark != byteOrderMark,
+             "Checkpoint %s was written on a host of another byte order, "
+             "convert it to the INI form first", file);
+    fatal_if(header.version != version,
+             "Checkpoint %s has unsupported version %d", file,
+             header.version);
+
+    uint64_t offset = header.indexOffset;
+    for (uint64_t i = 0; i < header.numSections; i++) {
+        IndexHeader index;
+        fatal_if(offset + sizeof(index) > length,
+                 "Checkpoint %s is truncated", file);
+        std::memcpy(&index, base + offset, sizeof(index));
+        offset += sizeof(index);
+        fatal_if(offset + index.nameSize > length ||
+                 index.offset + index.size > length,
+                 "Checkpoint %s is truncated", file);
+
+        std::string name((const char *)base + offset, index.nameSize);
+        offset += padded(index.nameSize);
+        Section &section = sections[name];
+        section.offset = index.offset;
+        section.size = index.size;
+        section.numEntries = index.numEntries;
+    }
+    return true;
+}
+
+BinaryCheckpoint::Section *
+BinaryCheckpoint::findSection(const std::string &name)
+{
+    auto it = sections.find(name);
+    if (it == sections.end())
+        return nullptr;
+
+    Section &section = it->second;
+    if (section.parsed)
+        return &section;
+
+    uint64_t offset = section.offset;
+    const uint64_t end = section.offset + section.size;
+    section.order.reserve(section.numEntries);
+    for (uint32_t i = 0; i < section.numEntries; i++) {
+        EntryHeader header;
+        fatal_if(offset + sizeof(header) > end,
+                 "Section %s of checkpoint %s is truncated", name, file);
+        std::memcpy(&header, base + offset, sizeof(header));
+        offset += sizeof(header);
+
+        const uint64_t size = header.count * typeSize(header.type);
+        fatal_if(!typeSize(header.type) ||
+                 offset + header.nameSize > end ||
+                 offset + padded(header.nameSize) + size > end,
+                 "Section %s of checkpoint %s is corrupt", name, file);
+        std::string entry_name((const char *)base + offset, header.nameSize);
+        offset += padded(header.nameSize);
+
+        Entry entry{header.type, header.count, base + offset};
+        offset += padded(size);
+
+        section.order.emplace_back(entry_name, entry);
+        // as in the INI form, a later entry of the same name wins
+        section.entries[entry_name] = entry;
+    }
+    section.parsed = true;
+    return &section;
+}
+
+const BinaryCheckpoint::Entry *
+BinaryCheckpoint::find(const std::string &section_name,
+                       const std::string &entry_name)
+{
+    Section *section = findSection(section_name);
+    if (!section)
+        return nullptr;
+    auto it = section->entries.find(entry_name);
+    return it == section->entries.end() ? nullptr : &it->second;
+}
+
+bool
+BinaryCheckpoint::find(const std::string &section,
+                       const std::string &entry, std::string &value)
+{
+    const Entry *found = find(section, entry);
+    if (!found)
+        return false;
+    value = text(*found);
+    return true;
+}
+
+bool
+BinaryCheckpoint::entryExists(const std::string &section,
+                              const std::string &entry)
+{
+    return find(section, entry) != nullptr;
+}
+
+bool
+BinaryCheckpoint::sectionExists(const std::string &section)
+{
+    return sections.count(section);
+}
+
+void
+BinaryCheckpoint::visitSection(const std::string &section_name,
+                               IniFile::VisitSectionCallback cb)
+{
+    Section *section = findSection(section_name);
+    panic_if(!section, "No section %s in checkpoint %s", section_name, file);
+    for (const auto &[name, entry] : section->order) {
+        // skip the entries overridden by a later one of the same name
+        if (section->entries.at(name).data == entry.data)
+            cb(name, text(entry));
+    }
+}
+
+BinaryCheckpointOut::BinaryCheckpointOut(const std::string &file_name)
+    : std::ostream(nullptr), file(file_name)
+{
+    rdbuf(&textBuf);
+}
+
+BinaryCheckpointOut::~BinaryCheckpointOut()
+{
+    close();
+}
+
+void
+BinaryCheckpointOut::takeText()
+{
+    std::istringstream text(textBuf.str());
+    textBuf.str("");
+
+    // the same syntax as IniFile::load()
+    std::string line;
+    while (std::getline(text, line)) {
+        eat_white(line);
+        if (line.empty())
+            continue;
+
+        if (line.front() == '[' && line.back() == ']') {
+            std::string name = line.substr(1, line.size() - 2);
+            eat_white(name);
+            auto [it, inserted] = sectionIndex.emplace(name, sections.size());
+            if (inserted)
+                sections.emplace_back().name = name;
+            current = it->second;
+            continue;
+        }
+
+        // anything before the first section, e.g. the header comment, is
+        // ignored as by IniFile
+        if (current == -1)
+            continue;
+
+        auto offset = line.find('=');
+        fatal_if(offset == std::string::npos,
+                 "Can't parse checkpoint line %s", line);
+        std::string name = line.substr(0, offset);
+        std::string value = line.substr(offset + 1);
+        eat_white(name);
+        eat_white(value);
+        addEntry(name, BinaryCheckpoint::Type::Text, value.size(),
+                 value.data(), value.size());
+    }
+}
+
+void
+BinaryCheckpointOut::addEntry(const std::string &name,
+                              BinaryCheckpoint::Type type, uint64_t count,
+                              const void *data, size_t size)
+{
+    // keep the entries in the order they are written, text and arrays
+    if (type != BinaryCheckpoint::Type::Text)
+        takeText();
+    fatal_if(current == -1, "Checkpoint entry %s outside of a section",
+             name);
+
+    BinaryCheckpoint::EntryHeader header{};
+    header.nameSize = name.size();
+    header.type = type;
+    header.count = count;
+
+    auto &buf = sections[current].data;
+    const size_t offset = buf.size();
+    buf.resize(offset + sizeof(header) +
+               BinaryCheckpoint::padded(name.size()) +
+               BinaryCheckpoint::padded(size));
+    uint8_t *ptr = buf.data() + offset;
+    std::memcpy(ptr, &header, sizeof(header));
+    ptr += sizeof(header);
+    std::memcpy(ptr, name.data(), name.size());
+    ptr += BinaryCheckpoint::padded(name.size());
+    std::memcpy(ptr, data, size);
+    sections[current].numEntries++;
+}
+
+void
+BinaryCheckpointOut::close()
+{
+    if (closed)
+        return;
+    closed = true;
+    takeText();
+
+    FILE *f = fopen(file.c_str(), "wb");
+    fatal_if(!f, "Unable to open file %s for writing", file);
+
+    BinaryCheckpoint::Header header{};
+    std::memcpy(header.magic, BinaryCheckpoint::magic, sizeof(header.magic));
+    header.byteOrderMark = BinaryCheckpoint::byteOrderMark;
+    header.version = BinaryCheckpoint::version;
+    header.numSections = sections.size();
+
+    std::vector<BinaryCheckpoint::IndexHeader> index;
+    uint64_t offset = sizeof(header);
+    for (auto &section : sections) {
+        index.push_back({(uint32_t)section.name.size(), section.numEntries,
+                         offset, section.data.size()});
+        offset += section.data.size();
+    }
+    header.indexOffset = offset;
+
+    static const uint8_t zeros[8] = {};
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+    for (auto &section : sections) {
+        ok = ok && fwrite(section.data.data(), 1, section.data.size(), f) ==
+            section.data.size();
+    }
+    for (size_t i = 0; i < sections.size(); i++) {
+        const std::string &name = sections[i].name;
+        const size_t pad = BinaryCheckpoint::padded(name.size()) -
+            name.size();
+        ok = ok && fwrite(&index[i], sizeof(index[i]), 1, f) == 1 &&
+            fwrite(name.data(), 1, name.size(), f) == name.size() &&
+            fwrite(zeros, 1, pad, f) == pad;
+    }
+    ok = fclose(f) == 0 && ok;
+    fatal_if(!ok, "Error writing checkpoint %s", file);
+}
+
+} // namespace gem5
@@ -0,0 +1,318 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Binary checkpoint container, the m5.bcpt alternative to the INI text of
+ * m5.cpt.
+ *
+ * The container holds the same sections and entries as the INI form, but
+ * the arrays of numbers written with arrayParamOut() are stored as typed
+ * blobs, which arrayParamIn() copies straight into the array they are
+ * restored to rather than parsing them token by token. Any other entry
+ * is stored as its text.
+ *
+ * Layout, in host byte order:
+ *   header: magic "gem5bcpt", byte order mark, version, number of
+ *           sections, offset of the section index
+ *   section data: entries, each an EntryHeader followed by the entry
+ *           name and the entry data, both padded to 8 bytes
+ *   section index: per section, an IndexHeader followed by the section
+ *           name padded to 8 bytes
+ *
+ * The container is mapped in memory when restoring, and only the sections
+ * looked up are parsed.
+ */
+
+#ifndef __SIM_BINARY_CHECKPOINT_HH__
+#define __SIM_BINARY_CHECKPOINT_HH__
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/inifile.hh"
+#include "sim/serialize_handlers.hh"
+
+namespace gem5
+{
+
+class BinaryCheckpoint
+{
+  public:
+    /** Type of the elements of an entry. */
+    enum class Type : uint8_t
+    {
+        Text, Int8, UInt8, Int16, UInt16, Int32, UInt32, Int64, UInt64,
+        Float, Double
+    };
+
+    /** An entry of a section, pointing into the mapped container. */
+    struct Entry
+    {
+        Type type;
+        /** Number of elements, or of characters of a text. */
+        uint64_t count;
+        const void *data;
+    };
+
+    /**
+     * Type of the array blobs of elements of type T, Text if they are
+     * written as text.
+     */
+    template <class T>
+    static constexpr Type
+    typeOf()
+    {
+        if constexpr (std::is_same_v<T, bool> || !std::is_arithmetic_v<T>) {
+            return Type::Text;
+        } else if constexpr (std::is_floating_point_v<T>) {
+            return sizeof(T) == 4 ? Type::Float :
+                sizeof(T) == 8 ? Type::Double : Type::Text;
+        } else {
+            constexpr bool is_signed = std::is_signed_v<T>;
+            switch (sizeof(T)) {
+              case 1: return is_signed ? Type::Int8 : Type::UInt8;
+              case 2: return is_signed ? Type::Int16 : Type::UInt16;
+              case 4: return is_signed ? Type::Int32 : Type::UInt32;
+              case 8: return is_signed ? Type::Int64 : Type::UInt64;
+              default: return Type::Text;
+            }
+        }
+    }
+
+    /** Size of an element of the given type. */
+    static size_t typeSize(Type type);
+
+    /** Element i of an array entry as in the INI form. */
+    static std::string elementText(const Entry &entry, uint64_t i);
+
+    /** The value of an entry as in the INI form. */
+    static std::string text(const Entry &entry);
+
+    static bool
+    isSigned(Type type)
+    {
+        return type == Type::Int8 || type == Type::Int16 ||
+            type == Type::Int32 || type == Type::Int64;
+    }
+
+    static bool
+    isUnsigned(Type type)
+    {
+        return type == Type::UInt8 || type == Type::UInt16 ||
+            type == Type::UInt32 || type == Type::UInt64;
+    }
+
+    /** Element i of an array entry of integers, widened. */
+    static int64_t signedElement(const Entry &entry, uint64_t i);
+    static uint64_t unsignedElement(const Entry &entry, uint64_t i);
+
+    /**
+     * Element i of an array entry as a T. Integers are converted to
+     * integers of another size if they fit, anything else goes through
+     * the INI form if the entry holds another type.
+     *
+     * @return False if the element can't be represented as a T.
+     */
+    template <class T>
+    static bool
+    element(const Entry &entry, uint64_t i, T &value)
+    {
+        if constexpr (typeOf<T>() != Type::Text) {
+            if (entry.type == typeOf<T>()) {
+                std::memcpy(&value,
+                            (const uint8_t *)entry.data + i * sizeof(T),
+                            sizeof(T));
+                return true;
+            }
+        }
+        if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>) {
+            using Limits = std::numeric_limits<T>;
+            if (isSigned(entry.type)) {
+                const int64_t v = signedElement(entry, i);
+                if (v < 0 ? v < (int64_t)Limits::min() :
+                        (uint64_t)v > (uint64_t)Limits::max()) {
+                    return false;
+                }
+                value = v;
+                return true;
+            } else if (isUnsigned(entry.type)) {
+                const uint64_t v = unsignedElement(entry, i);
+                if (v > (uint64_t)Limits::max())
+                    return false;
+                value = v;
+                return true;
+            }
+        }
+        return ParseParam<T>::parse(elementText(entry, i), value);
+    }
+
+    BinaryCheckpoint() = default;
+    ~BinaryCheckpoint();
+
+    BinaryCheckpoint(const BinaryCheckpoint &) = delete;
+    BinaryCheckpoint &operator=(const BinaryCheckpoint &) = delete;
+
+    /**
+     * Map a container file.
+     *
+     * @return False if the file can't be opened.
+     */
+    bool load(const std::string &file);
+
+    /** Find an entry, nullptr if there is none. */
+    const Entry *find(const std::string &section, const std::string &entry);
+
+    /** Find the value of an entry as in the INI form. */
+    bool find(const std::string &section, const std::string &entry,
+              std::string &value);
+
+    bool entryExists(const std::string &section, const std::string &entry);
+    bool sectionExists(const std::string &section);
+    void visitSection(const std::string &section,
+                      IniFile::VisitSectionCallback cb);
+
+    static constexpr char magic[8] = {'g', 'e', 'm', '5', 'b', 'c', 'p', 't'};
+    static constexpr uint32_t byteOrderMark = 0x01020304;
+    static constexpr uint32_t version = 1;
+
+    struct Header
+    {
+        char magic[8];
+        uint32_t byteOrderMark;
+        uint32_t version;
+        uint64_t numSections;
+        uint64_t indexOffset;
+    };
+
+    struct EntryHeader
+    {
+        uint32_t nameSize;
+        Type type;
+        uint8_t pad[3];
+        uint64_t count;
+    };
+
+    struct IndexHeader
+    {
+        uint32_t nameSize;
+        uint32_t numEntries;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    /** Size of a name or of entry data with its padding. */
+    static uint64_t padded(uint64_t size) { return (size + 7) & ~7ULL; }
+
+  private:
+    struct Section
+    {
+        uint64_t offset;
+        uint64_t size;
+        uint32_t numEntries;
+        bool parsed = false;
+        /** Entries in file order, and by name. */
+        std::vector<std::pair<std::string, Entry>> order;
+        std::unordered_map<std::string, Entry> entries;
+    };
+
+    /** Look a section up, parsing it on first use. */
+    Section *findSection(const std::string &name);
+
+    std::string file;
+    const uint8_t *base = nullptr;
+    size_t length = 0;
+    std::unordered_map<std::string, Section> sections;
+};
+
+/**
+ * Checkpoint output stream writing a binary container. The serialize()
+ * functions write the INI text as usual, which is moved into the
+ * container as they go, and arrayParamOut() hands it its arrays of
+ * numbers as blobs. The container is written out when the stream is
+ * closed.
+ */
+class BinaryCheckpointOut : public std::ostream
+{
+  public:
+    BinaryCheckpointOut(const std::string &file);
+    ~BinaryCheckpointOut();
+
+    /** The binary container an output stream writes to, if any. */
+    static BinaryCheckpointOut *
+    get(std::ostream &os)
+    {
+        return dynamic_cast<BinaryCheckpointOut *>(&os);
+    }
+
+    /** Add an array entry to the current section. */
+    template <class T>
+    void
+    arrayOut(const std::string &name, const T *data, size_t count)
+    {
+        static_assert(BinaryCheckpoint::typeOf<T>() !=
+                      BinaryCheckpoint::Type::Text);
+        addEntry(name, BinaryCheckpoint::typeOf<T>(), count, data,
+                 count * sizeof(T));
+    }
+
+    /** Write the container out. */
+    void close();
+
+  private:
+    /** Move the INI text written so far into the container. */
+    void takeText();
+
+    void addEntry(const std::string &name, BinaryCheckpoint::Type type,
+                  uint64_t count, const void *data, size_t size);
+
+    struct Section
+    {
+        std::string name;
+        uint32_t numEntries = 0;
+        std::vector<uint8_t> data;
+    };
+
+    const std::string file;
+    std::stringbuf textBuf;
+    bool closed = false;
+
+    std::vector<Section> sections;
+    std::unordered_map<std::string, size_t> sectionIndex;
+    /** Index of the section being written, -1 before the first one. */
+    int current = -1;
+};
+
+} // namespace gem5
+
+#endif // __SIM_BINARY_CHECKPOINT_HH__
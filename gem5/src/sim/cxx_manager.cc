@@ -438,6 +438,28 @@ CxxConfigManager::findTraversalOrder(const std::string &object_name)
     }
 }
 
+void
+CxxConfigManager::bindStatGroups()
+{
+    for (auto &[object_name, object] : objectsByName) {
+        if (object_name == "root")
+            continue;
+
+        auto dot = object_name.rfind('.');
+        const std::string parent_name =
+            dot == std::string::npos ? "root" : object_name.substr(0, dot);
+        auto parent = objectsByName.find(parent_name);
+        if (parent == objectsByName.end()) {
+            throw Exception(object_name, csprintf("No parent object %s"
+                " for the stats", parent_name));
+        }
+
+        DPRINTF(CxxConfig, "Binding stats group %s\n", object_name);
+        const std::string group_name = object_name.substr(dot + 1);
+        parent->second->addStatGroup(group_name.c_str(), object);
+    }
+}
+
 void
 CxxConfigManager::bindAllPorts()
 {
@@ -592,7 +614,7 @@ CxxConfigManager::forEachObject(void (SimObject::*mem_func)())
 }
 
 void
-CxxConfigManager::instantiate(bool build_all)
+CxxConfigManager::instantiate(bool build_all, bool stat_groups)
 {
     if (build_all) {
         findAllObjects();
@@ -603,7 +625,12 @@ CxxConfigManager::instantiate(bool build_all)
     forEachObject(&SimObject::init);
 
     DPRINTF(CxxConfig, "Registering stats\n");
-    forEachObject(&SimObject::regStats);
+    if (stat_groups) {
+        bindStatGroups();
+        getObject<SimObject>("root").regStats();
+    } else {
+        forEachObject(&SimObject::regStats);
+    }
 
     DPRINTF(CxxConfig, "Registering probe points\n");
     forEachObject(&SimObject::regProbePoints);
@@ -274,8 +274,18 @@ class CxxConfigManager
      *
      *  If you want to set some parameters before completing instantiation,
      *  call findObjectParams on the objects you want to modify, then call
-     *  instantiate */
-    void instantiate(bool build_all = true);
+     *  instantiate.
+     *
+     *  If stat_groups is true, the stats groups of the objects are bound
+     *  into a hierarchy (see bindStatGroups) and the stats are registered
+     *  from the root, as the Python instantiation does, rather than on
+     *  every object */
+    void instantiate(bool build_all = true, bool stat_groups = false);
+
+    /** Make every object a stats group of its parent in the configuration,
+     *  named after its last path component, so that the stats can be
+     *  walked and dumped from the root object */
+    void bindStatGroups();
 
     /** Call initState on all objects */
     void initState();
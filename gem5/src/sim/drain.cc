@@ -43,6 +43,7 @@
 #include "base/named.hh"
 #include "base/trace.hh"
 #include "debug/Drain.hh"
+#include "sim/cur_tick.hh"
 #include "sim/sim_exit.hh"
 
 namespace gem5
@@ -52,7 +53,9 @@ DrainManager DrainManager::_instance;
 
 DrainManager::DrainManager()
     : _count(0),
-      _state(DrainState::Running)
+      _state(DrainState::Running),
+      _numDrains(0), _numDrainRounds(0), _drainTicks(0),
+      _drainHostSeconds(0), _drainStartTick(0)
 {
 }
 
@@ -62,6 +65,12 @@ DrainManager::~DrainManager()
 
 bool
 DrainManager::tryDrain()
+{
+    return tryDrain(_allDrainable);
+}
+
+bool
+DrainManager::tryDrain(const std::vector<Drainable *> &objs)
 {
     panic_if(_state == DrainState::Drained,
              "Trying to drain a drained system\n");
@@ -69,9 +78,16 @@ DrainManager::tryDrain()
     panic_if(_count != 0,
              "Drain counter must be zero at the start of a drain cycle\n");
 
-    DPRINTF(Drain, "Trying to drain %u objects.\n", drainableCount());
+    if (_state == DrainState::Running) {
+        _drainStartTick = curTick();
+        _drainStartTime = std::chrono::steady_clock::now();
+    }
+    ++_numDrainRounds;
+
+    DPRINTF(Drain, "Trying to drain %u of %u objects.\n", objs.size(),
+            drainableCount());
     _state = DrainState::Draining;
-    for (auto *obj : _allDrainable) {
+    for (auto *obj : objs) {
         DrainState status = obj->dmDrain();
         if (debug::Drain && status != DrainState::Drained) {
             Named *temp = dynamic_cast<Named*>(obj);
@@ -84,10 +100,14 @@ DrainManager::tryDrain()
     if (_count == 0) {
         DPRINTF(Drain, "Drain done.\n");
         _state = DrainState::Drained;
+        ++_numDrains;
+        _drainTicks += curTick() - _drainStartTick;
+        _drainHostSeconds += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - _drainStartTime).count();
         return true;
     } else {
         DPRINTF(Drain, "Need another drain cycle. %u/%u objects not ready.\n",
-                _count, drainableCount());
+                _count, objs.size());
         return false;
     }
 }
@@ -111,7 +131,8 @@ DrainManager::resume()
              "left to drain.\n", _count);
 
     // At this point in time the DrainManager and all objects will be
-    // in the the Drained state. New objects (i.e., objects created
+    // in the the Drained state, or in the Running state if they were
+    // not part of a partial drain. New objects (i.e., objects created
     // while resuming) will inherit the Resuming state from the
     // DrainManager, which means we have to resume objects until all
     // objects are in the Running state.
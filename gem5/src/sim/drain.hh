@@ -39,9 +39,12 @@
 #define __SIM_DRAIN_HH__
 
 #include <atomic>
+#include <chrono>
 #include <mutex>
 #include <vector>
 
+#include "base/types.hh"
+
 namespace gem5
 {
 
@@ -108,6 +111,24 @@ class DrainManager
      */
     bool tryDrain();
 
+    /**
+     * Try to drain a subset of the system.
+     *
+     * This works like tryDrain(), but only the objects in objs are
+     * asked to drain, the rest of the simulator keeps running. This
+     * is used to switch CPUs without draining the memory system when
+     * the memory mode does not change. Once the objects are drained,
+     * the DrainManager is in the Drained state and resume() resumes
+     * them.
+     *
+     * @param objs Objects to drain.
+     * @return true if all objects in objs were drained successfully,
+     * false if more simulation is needed.
+     *
+     * @ingroup api_drain
+     */
+    bool tryDrain(const std::vector<Drainable *> &objs);
+
     /**
      * Resume normal simulation in a Drained system.
      *
@@ -159,6 +180,18 @@ class DrainManager
      */
     void signalDrainDone();
 
+    /** Number of drain operations that completed */
+    uint64_t numDrains() const { return _numDrains; }
+
+    /** Number of drain rounds, i.e., calls to tryDrain() */
+    uint64_t numDrainRounds() const { return _numDrainRounds; }
+
+    /** Simulated ticks spent draining */
+    Tick drainTicks() const { return _drainTicks; }
+
+    /** Host seconds spent draining, including the simulation needed */
+    double drainHostSeconds() const { return _drainHostSeconds; }
+
   public:
     void registerDrainable(Drainable *obj);
     void unregisterDrainable(Drainable *obj);
@@ -192,6 +225,20 @@ class DrainManager
     /** Global simulator drain state */
     DrainState _state;
 
+    /** @{ */
+    /** Drain statistics, see the accessors above */
+    uint64_t _numDrains;
+    uint64_t _numDrainRounds;
+    Tick _drainTicks;
+    double _drainHostSeconds;
+    /** @} */
+
+    /** Tick at which the ongoing drain operation started */
+    Tick _drainStartTick;
+
+    /** Host time at which the ongoing drain operation started */
+    std::chrono::steady_clock::time_point _drainStartTime;
+
     /** Singleton instance of the drain manager */
     static DrainManager _instance;
 };
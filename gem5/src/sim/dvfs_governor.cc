@@ -0,0 +1,307 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/dvfs_governor.hh"
+
+#include <algorithm>
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "cpu/base.hh"
+#include "debug/DVFS.hh"
+#include "sim/core.hh"
+#include "sim/dvfs_handler.hh"
+#include "sim/power/power_model.hh"
+
+namespace gem5
+{
+
+DVFSGovernor::DVFSGovernor(const Params &p)
+    : SimObject(p), handler(p.handler), epoch(p.epoch), policy(p.policy),
+      upThreshold(p.up_threshold), memStallThreshold(p.mem_stall_threshold),
+      epochStart(0), epochEvent([this]{ epochEnd(); }, name() + ".epoch"),
+      stats(*this)
+{
+    fatal_if(!handler || !handler->isEnabled(),
+             "%s: The DVFS handler must be enabled.\n", name());
+    fatal_if(epoch == 0, "%s: The epoch must not be empty.\n", name());
+    fatal_if(upThreshold <= 0 || upThreshold > 1,
+             "%s: up_threshold must be in (0, 1].\n", name());
+    fatal_if(memStallThreshold < 0 || memStallThreshold >= 1,
+             "%s: mem_stall_threshold must be in [0, 1).\n", name());
+
+    for (auto *cpu : p.cpus) {
+        auto *clk = dynamic_cast<SrcClockDomain *>(cpu->params().clk_domain);
+        fatal_if(!clk, "%s: The clock domain of %s can't be scaled.\n",
+                 name(), cpu->name());
+
+        const DomainID id = clk->domainID();
+        bool handled = false;
+        for (uint32_t i = 0; i < handler->numDomains(); i++)
+            handled = handled || handler->domainID(i) == id;
+        fatal_if(!handled, "%s: The DVFS handler doesn't control the clock "
+                 "domain of %s.\n", name(), cpu->name());
+
+        auto it = std::find_if(domains.begin(), domains.end(),
+                               [id](const Domain &d) { return d.id == id; });
+        if (it == domains.end()) {
+            domains.emplace_back();
+            it = std::prev(domains.end());
+            it->id = id;
+        }
+        it->cpus.push_back(cpu);
+        for (auto *pm : cpu->params().power_model)
+            it->powerModels.push_back(pm);
+    }
+    fatal_if(domains.empty(), "%s: There are no CPUs to govern.\n", name());
+}
+
+void
+DVFSGovernor::startup()
+{
+    for (auto &domain : domains)
+        sample(domain);
+    epochStart = curTick();
+    schedule(epochEvent, curTick() + epoch);
+}
+
+DVFSGovernor::Sample
+DVFSGovernor::sample(Domain &domain)
+{
+    Sample now;
+    for (auto *cpu : domain.cpus) {
+        now.insts += cpu->totalInsts();
+        now.cycles += cpu->baseStats.numCycles.value();
+        now.stalls += cpu->baseStats.memStallCycles.value();
+    }
+    for (auto *pm : domain.powerModels) {
+        now.dynamicPower += pm->getDynamicPower();
+        now.staticPower += pm->getStaticPower();
+    }
+
+    // The counters start over when the stats are reset
+    const auto since = [](Counter cur, Counter last) {
+        return cur >= last ? cur - last : cur;
+    };
+    Sample delta = now;
+    delta.insts = since(now.insts, domain.last.insts);
+    delta.cycles = since(now.cycles, domain.last.cycles);
+    delta.stalls = since(now.stalls, domain.last.stalls);
+    domain.last = now;
+    return delta;
+}
+
+double
+DVFSGovernor::frequency(DomainID id, PerfLevel level) const
+{
+    return sim_clock::as_float::s / handler->clkPeriodAtPerfLevel(id, level);
+}
+
+DVFSGovernor::PerfLevel
+DVFSGovernor::slowestAbove(DomainID id, double freq) const
+{
+    // the levels go from the fastest to the slowest
+    for (PerfLevel level = handler->numPerfLevels(id); level-- > 0; ) {
+        if (frequency(id, level) >= freq)
+            return level;
+    }
+    return 0;
+}
+
+DVFSGovernor::PerfLevel
+DVFSGovernor::pick(const Domain &domain, const Sample &s, Tick elapsed)
+{
+    const DomainID id = domain.id;
+    const PerfLevel cur = handler->perfLevel(id);
+    const double cur_freq = frequency(id, cur);
+
+    const double avail = (double)elapsed /
+        handler->clkPeriodAtPerfLevel(id, cur) * domain.cpus.size();
+    const double busy = avail > 0 ? std::min(1.0, s.cycles / avail) : 0;
+    const double stall =
+        s.cycles > 0 ? std::min(1.0, (double)s.stalls / s.cycles) : 0;
+
+    // the frequency at which the CPUs would have been busy for
+    // upThreshold of the epoch
+    const double ondemand_freq =
+        busy > upThreshold ? frequency(id, 0) : cur_freq * busy / upThreshold;
+
+    switch (policy) {
+      case enums::DVFSGovernorPolicy::ondemand:
+        return slowestAbove(id, ondemand_freq);
+
+      case enums::DVFSGovernorPolicy::memory_bound:
+        if (stall > memStallThreshold) {
+            return slowestAbove(id, ondemand_freq * (1 - stall) /
+                                (1 - memStallThreshold));
+        }
+        return slowestAbove(id, ondemand_freq);
+
+      case enums::DVFSGovernorPolicy::min_edp:
+        {
+            if (s.cycles == 0)
+                return handler->numPerfLevels(id) - 1;
+
+            // Without a power model, only the dynamic power is known to
+            // scale with the frequency and the voltage
+            double dyn_power = s.dynamicPower;
+            double static_power = s.staticPower;
+            if (dyn_power + static_power <= 0)
+                dyn_power = 1;
+
+            const double cur_volt = handler->voltageAtPerfLevel(id, cur);
+            PerfLevel best = cur;
+            double best_edp = 0;
+            for (PerfLevel level = 0; level < handler->numPerfLevels(id);
+                 level++) {
+                const double freq = frequency(id, level);
+                const double volt =
+                    handler->voltageAtPerfLevel(id, level) / cur_volt;
+                // the stalls on memory don't get shorter with the clock
+                const double delay =
+                    busy * ((1 - stall) * cur_freq / freq + stall);
+                const double power =
+                    dyn_power * volt * volt * freq / cur_freq +
+                    static_power * volt;
+                const double edp = power * delay * delay;
+                if (level == 0 || edp < best_edp) {
+                    best = level;
+                    best_edp = edp;
+                }
+            }
+            return best;
+        }
+
+      default:
+        panic("%s: Unknown DVFS governor policy.\n", name());
+    }
+}
+
+void
+DVFSGovernor::epochEnd()
+{
+    const Tick elapsed = curTick() - epochStart;
+    const double seconds = elapsed / sim_clock::as_float::s;
+    stats.epochs++;
+    stats.time += seconds;
+
+    for (int i = 0; i < domains.size(); i++) {
+        Domain &domain = domains[i];
+        const Sample s = sample(domain);
+        const PerfLevel cur = handler->perfLevel(domain.id);
+
+        stats.insts[i] += s.insts;
+        stats.cycles[i] += s.cycles;
+        stats.stalls[i] += s.stalls;
+        stats.energy[i] += (s.dynamicPower + s.staticPower) * seconds;
+        stats.epochsAtLevel[i][cur]++;
+
+        const PerfLevel next = pick(domain, s, elapsed);
+        DPRINTF(DVFS, "DVFS governor: domain %d committed %d insts in %d "
+                "cycles, %d stalled on memory, level %d -> %d\n",
+                domain.id, s.insts, s.cycles, s.stalls, cur, next);
+        if (next != cur) {
+            handler->perfLevel(domain.id, next);
+            if (next < cur)
+                stats.raises[i]++;
+            else
+                stats.drops[i]++;
+        }
+    }
+
+    epochStart = curTick();
+    schedule(epochEvent, curTick() + epoch);
+}
+
+DVFSGovernor::GovernorStats::GovernorStats(DVFSGovernor &_gov)
+    : statistics::Group(&_gov), gov(_gov),
+      ADD_STAT(epochs, statistics::units::Count::get(),
+               "Number of epochs the governor decided after"),
+      ADD_STAT(raises, statistics::units::Count::get(),
+               "Number of times the performance level of a domain was "
+               "raised"),
+      ADD_STAT(drops, statistics::units::Count::get(),
+               "Number of times the performance level of a domain was "
+               "lowered"),
+      ADD_STAT(epochsAtLevel, statistics::units::Count::get(),
+               "Number of epochs a domain spent at each performance level"),
+      ADD_STAT(insts, statistics::units::Count::get(),
+               "Number of instructions committed by the CPUs of a domain"),
+      ADD_STAT(cycles, statistics::units::Cycle::get(),
+               "Number of cycles the CPUs of a domain were busy"),
+      ADD_STAT(stalls, statistics::units::Cycle::get(),
+               "Number of busy cycles stalled on memory"),
+      ADD_STAT(ipc, statistics::units::Rate<
+                    statistics::units::Count, statistics::units::Cycle>::get(),
+               "IPC of the CPUs of a domain", insts / cycles),
+      ADD_STAT(memStallFraction, statistics::units::Ratio::get(),
+               "Fraction of the busy cycles stalled on memory",
+               stalls / cycles),
+      ADD_STAT(energy, statistics::units::Joule::get(),
+               "Energy drawn by the CPUs of a domain, from their power "
+               "models"),
+      ADD_STAT(time, statistics::units::Second::get(),
+               "Time the governor ran for"),
+      ADD_STAT(edp, statistics::units::Unspecified::get(),
+               "Energy-delay product of a domain (J s)", energy * time)
+{
+}
+
+void
+DVFSGovernor::GovernorStats::regStats()
+{
+    statistics::Group::regStats();
+
+    const size_t num_domains = gov.domains.size();
+    PerfLevel max_levels = 0;
+    for (const auto &domain : gov.domains) {
+        max_levels = std::max(max_levels,
+                              gov.handler->numPerfLevels(domain.id));
+    }
+
+    raises.init(num_domains);
+    drops.init(num_domains);
+    epochsAtLevel.init(num_domains, max_levels);
+    insts.init(num_domains);
+    cycles.init(num_domains);
+    stalls.init(num_domains);
+    energy.init(num_domains);
+
+    for (int i = 0; i < num_domains; i++) {
+        const std::string domain =
+            csprintf("domain%d", gov.domains[i].id);
+        raises.subname(i, domain);
+        drops.subname(i, domain);
+        epochsAtLevel.subname(i, domain);
+        insts.subname(i, domain);
+        cycles.subname(i, domain);
+        stalls.subname(i, domain);
+        energy.subname(i, domain);
+    }
+    for (int l = 0; l < max_levels; l++)
+        epochsAtLevel.ysubname(l, csprintf("level%d", l));
+}
+
+} // namespace gem5
@@ -0,0 +1,138 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SIM_DVFS_GOVERNOR_HH__
+#define __SIM_DVFS_GOVERNOR_HH__
+
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "enums/DVFSGovernorPolicy.hh"
+#include "params/DVFSGovernor.hh"
+#include "sim/clock_domain.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_object.hh"
+
+namespace gem5
+{
+
+class BaseCPU;
+class DVFSHandler;
+class PowerModel;
+
+/**
+ * Picks the performance level of the clock domains of a set of CPUs at
+ * the end of every epoch, from how busy their CPUs were, how much they
+ * stalled on memory and how much power they drew during the epoch, and
+ * asks the DVFS handler for it.
+ */
+class DVFSGovernor : public SimObject
+{
+  public:
+    typedef DVFSGovernorParams Params;
+    typedef SrcClockDomain::DomainID DomainID;
+    typedef SrcClockDomain::PerfLevel PerfLevel;
+
+    DVFSGovernor(const Params &p);
+
+    void startup() override;
+
+  private:
+    /** What the CPUs of a domain did during an epoch. */
+    struct Sample
+    {
+        /** Instructions committed. */
+        Counter insts = 0;
+        /** Cycles the CPUs were busy. */
+        Counter cycles = 0;
+        /** Busy cycles stalled on memory. */
+        Counter stalls = 0;
+        /** Power drawn at the end of the epoch, in watts. */
+        double dynamicPower = 0;
+        double staticPower = 0;
+    };
+
+    struct Domain
+    {
+        DomainID id;
+        std::vector<BaseCPU *> cpus;
+        std::vector<PowerModel *> powerModels;
+        /** Counters of the CPUs at the start of the epoch. */
+        Sample last;
+    };
+
+    /** Sample the CPUs of a domain, updating its counters. */
+    Sample sample(Domain &domain);
+
+    /** The level the policy picks for a domain after an epoch. */
+    PerfLevel pick(const Domain &domain, const Sample &s, Tick elapsed);
+
+    /** The level with the lowest frequency at least freq Hz. */
+    PerfLevel slowestAbove(DomainID id, double freq) const;
+
+    double frequency(DomainID id, PerfLevel level) const;
+
+    void epochEnd();
+
+    DVFSHandler *handler;
+    const Tick epoch;
+    const enums::DVFSGovernorPolicy policy;
+    const double upThreshold;
+    const double memStallThreshold;
+
+    std::vector<Domain> domains;
+
+    /** Start of the current epoch. */
+    Tick epochStart;
+
+    EventFunctionWrapper epochEvent;
+
+    struct GovernorStats : public statistics::Group
+    {
+        GovernorStats(DVFSGovernor &gov);
+
+        void regStats() override;
+
+        const DVFSGovernor &gov;
+
+        statistics::Scalar epochs;
+        statistics::Vector raises;
+        statistics::Vector drops;
+        statistics::Vector2d epochsAtLevel;
+        statistics::Vector insts;
+        statistics::Vector cycles;
+        statistics::Vector stalls;
+        statistics::Formula ipc;
+        statistics::Formula memStallFraction;
+        statistics::Vector energy;
+        statistics::Scalar time;
+        statistics::Formula edp;
+    } stats;
+};
+
+} // namespace gem5
+
+#endif // __SIM_DVFS_GOVERNOR_HH__
@@ -0,0 +1,130 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "sim/eventq.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/**
+ * A queue holding a fixed number of pending events, which reschedule
+ * themselves a pseudo random delay later when they are serviced, as
+ * clocked objects do. Servicing an event is then one dequeue and one
+ * insertion at a queue of constant size.
+ */
+struct SteadyQueue
+{
+    EventQueue queue;
+    std::vector<std::unique_ptr<EventFunctionWrapper>> events;
+    std::vector<Tick> delays;
+    size_t next = 0;
+
+    SteadyQueue(EventQueue::Backend backend, int num_events)
+        : queue("bench_queue"), delays(4096)
+    {
+        queue.setBackend(backend);
+        std::mt19937 gen(1);
+        // Mostly a few cycles ahead, with the odd distant event
+        std::geometric_distribution<Tick> delay_dist(0.01);
+        for (auto &delay : delays)
+            delay = 1 + delay_dist(gen) * 500;
+
+        for (int i = 0; i < num_events; i++) {
+            EventFunctionWrapper *event = new EventFunctionWrapper(
+                [this, i]() {
+                    queue.schedule(events[i].get(),
+                                   queue.getCurTick() + nextDelay());
+                }, "bench_event", false, i % 3 - 1);
+            events.emplace_back(event);
+            queue.schedule(event, nextDelay());
+        }
+    }
+
+    ~SteadyQueue()
+    {
+        for (auto &event : events) {
+            if (event->scheduled())
+                queue.deschedule(event.get());
+        }
+    }
+
+    Tick
+    nextDelay()
+    {
+        next = (next + 1) % delays.size();
+        return delays[next];
+    }
+};
+
+void
+serviceOne(benchmark::State &state, EventQueue::Backend backend)
+{
+    SteadyQueue q(backend, state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(q.queue.serviceOne());
+    state.SetItemsProcessed(state.iterations());
+}
+
+void
+BM_EventQueueList(benchmark::State &state)
+{
+    serviceOne(state, EventQueue::Backend::List);
+}
+
+void
+BM_EventQueueTree(benchmark::State &state)
+{
+    serviceOne(state, EventQueue::Backend::Tree);
+}
+
+/** Schedule events and deschedule them before they run. */
+void
+BM_EventQueueScheduleDeschedule(benchmark::State &state)
+{
+    SteadyQueue q(EventQueue::Backend::List, state.range(0));
+    EventFunctionWrapper event([]() {}, "bench_cancelled");
+    for (auto _ : state) {
+        q.queue.schedule(&event, q.queue.getCurTick() + q.nextDelay());
+        q.queue.deschedule(&event);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // anonymous namespace
+
+BENCHMARK(BM_EventQueueList)->RangeMultiplier(16)->Range(16, 4096);
+BENCHMARK(BM_EventQueueTree)->RangeMultiplier(16)->Range(16, 4096);
+BENCHMARK(BM_EventQueueScheduleDeschedule)->RangeMultiplier(16)
+    ->Range(16, 4096);
+
+BENCHMARK_MAIN();
@@ -30,6 +30,8 @@
 
 #include "sim/eventq.hh"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <iostream>
 #include <mutex>
@@ -41,6 +43,8 @@
 #include "base/trace.hh"
 #include "cpu/smt.hh"
 #include "debug/Checkpoint.hh"
+#include "sim/host_profile.hh"
+#include "sim/host_time.hh"
 
 namespace gem5
 {
@@ -57,6 +61,8 @@ uint32_t numMainEventQueues = 0;
 std::vector<EventQueue *> mainEventQueue;
 __thread EventQueue *_curEventQueue = NULL;
 bool inParallelMode = false;
+bool externalEventThreads = false;
+EventQueue::Backend defaultEventQueueBackend = EventQueue::Backend::List;
 
 EventQueue *
 getEventQueue(uint32_t index)
@@ -111,6 +117,11 @@ Event::insertBefore(Event *event, Event *curr)
 void
 EventQueue::insert(Event *event)
 {
+    if (binIndex) {
+        insertIndexed(event);
+        return;
+    }
+
     // Deal with the head case
     if (!head || *event <= *head) {
         head = Event::insertBefore(event, head);
@@ -170,6 +181,11 @@ EventQueue::remove(Event *event)
 
     assert(event->queue == this);
 
+    if (binIndex) {
+        removeIndexed(event);
+        return;
+    }
+
     // deal with an event on the head's 'in bin' list (event has the same
     // time as the head)
     if (*head == *event) {
@@ -194,14 +210,97 @@ EventQueue::remove(Event *event)
     prev->nextBin = Event::removeItem(event, curr);
 }
 
+// The bin index mirrors the bin list: every operation on the list is
+// followed by the same operation on the index, and the bin before the
+// one being changed is found in the index instead of by walking the
+// list.
+void
+EventQueue::insertIndexed(Event *event)
+{
+    const BinIndex::key_type key(event->when(), event->priority());
+    auto bin = binIndex->lower_bound(key);
+    Event *prev = bin == binIndex->begin() ? nullptr : std::prev(bin)->second;
+    Event *curr = bin == binIndex->end() ? nullptr : bin->second;
+
+    Event *top = Event::insertBefore(event, curr);
+    if (prev)
+        prev->nextBin = top;
+    else
+        head = top;
+
+    if (bin != binIndex->end() && bin->first == key)
+        bin->second = event;
+    else
+        binIndex->emplace_hint(bin, key, event);
+}
+
+void
+EventQueue::removeIndexed(Event *event)
+{
+    auto bin = binIndex->find(BinIndex::key_type(event->when(),
+                                                 event->priority()));
+    if (bin == binIndex->end())
+        panic("event not found!");
+
+    Event *top = bin->second;
+    Event *next_in_bin = top->nextInBin;
+    Event *prev = bin == binIndex->begin() ? nullptr : std::prev(bin)->second;
+
+    Event *new_top = Event::removeItem(event, top);
+    if (prev)
+        prev->nextBin = new_top;
+    else
+        head = new_top;
+
+    if (event == top) {
+        if (next_in_bin)
+            bin->second = next_in_bin;
+        else
+            binIndex->erase(bin);
+    }
+}
+
+void
+EventQueue::rebuildBinIndex()
+{
+    binIndex->clear();
+    for (Event *top = head; top; top = top->nextBin) {
+        binIndex->emplace_hint(binIndex->end(),
+            BinIndex::key_type(top->when(), top->priority()), top);
+    }
+}
+
+void
+EventQueue::setBackend(Backend backend)
+{
+    if (backend == Backend::Tree) {
+        if (!binIndex) {
+            binIndex.reset(new BinIndex);
+            rebuildBinIndex();
+        }
+    } else {
+        binIndex.reset();
+    }
+}
+
 Event *
 EventQueue::serviceOne()
 {
-    std::lock_guard<EventQueue> lock(*this);
+    std::unique_lock<EventQueue> lock(*this, std::defer_lock);
+    if (serviceLocking())
+        lock.lock();
+
     Event *event = head;
     Event *next = head->nextInBin;
     event->flags.clear(Event::Scheduled);
 
+    if (binIndex) {
+        if (next)
+            binIndex->begin()->second = next;
+        else
+            binIndex->erase(binIndex->begin());
+    }
+
     if (next) {
         // update the next bin pointer since it could be stale
         next->nextBin = head->nextBin;
@@ -220,7 +319,14 @@ EventQueue::serviceOne()
         setCurTick(event->when());
         if (debug::Event)
             event->trace("executed");
-        event->process();
+        {
+            HostTimeScope host_time(event->hostAccount,
+                                    &HostTimeAccount::events);
+            if (hostProfile)
+                hostProfile->process(event);
+            else
+                event->process();
+        }
         if (event->isExitEvent()) {
             assert(!event->flags.isSet(Event::Managed) ||
                    !event->flags.isSet(Event::IsMainQueue)); // would be silly
@@ -357,6 +463,8 @@ EventQueue::replaceHead(Event* s)
 {
     Event* t = head;
     head = s;
+    if (binIndex)
+        rebuildBinIndex();
     return t;
 }
 
@@ -368,6 +476,15 @@ dumpMainQueue()
     }
 }
 
+void
+setEventQueueBackend(EventQueue::Backend backend)
+{
+    defaultEventQueueBackend = backend;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+        mainEventQueue[i]->setBackend(backend);
+    }
+}
+
 
 const char *
 Event::description() const
@@ -416,30 +533,73 @@ Event::dump() const
 }
 
 EventQueue::EventQueue(const std::string &n)
-    : objName(n), head(NULL), _curTick(0)
+    : objName(n), head(NULL), _curTick(0), asyncHead(nullptr),
+      crossQueueEvents(0), migrations(0), lateEvents(0),
+      hostProfile(nullptr)
 {
+    setBackend(defaultEventQueueBackend);
 }
 
 void
 EventQueue::asyncInsert(Event *event)
 {
-    async_queue_mutex.lock();
-    async_queue.push_back(event);
-    async_queue_mutex.unlock();
+    // The event is not in any bin until it is merged, so its bin
+    // pointer links it into the list of asynchronous events.
+    Event *next = asyncHead.load(std::memory_order_relaxed);
+    do {
+        event->nextBin = next;
+    } while (!asyncHead.compare_exchange_weak(next, event,
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed));
+
+    if (this != curEventQueue() && !event->globalEvent())
+        crossQueueEvents.fetch_add(1, std::memory_order_relaxed);
+}
+
+EventQueue::SyncCounters
+EventQueue::takeSyncCounters()
+{
+    SyncCounters counters = { crossQueueEvents.exchange(0), migrations,
+                              lateEvents };
+    migrations = lateEvents = 0;
+    return counters;
 }
 
 void
 EventQueue::handleAsyncInsertions()
 {
     assert(this == curEventQueue());
-    async_queue_mutex.lock();
 
-    while (!async_queue.empty()) {
-        insert(async_queue.front());
-        async_queue.pop_front();
-    }
+    // most of the time there is nothing to merge, and a plain load is
+    // enough to tell
+    if (!asyncHead.load(std::memory_order_relaxed))
+        return;
 
-    async_queue_mutex.unlock();
+    Event *event = asyncHead.exchange(nullptr, std::memory_order_acquire);
+    for (; event; event = event->nextBin)
+        asyncMerge.push_back(event);
+
+    // The list holds the events in the order the threads scheduled
+    // them in, most recent first, which depends on the host. Events in
+    // the same bin are serviced in reverse order of insertion, so sort
+    // them first to keep the simulation deterministic. Events of the
+    // same object keep the order they were scheduled in.
+    std::reverse(asyncMerge.begin(), asyncMerge.end());
+    std::stable_sort(asyncMerge.begin(), asyncMerge.end(),
+                     [](const Event *a, const Event *b) {
+        if (a->when() != b->when())
+            return a->when() < b->when();
+        if (a->priority() != b->priority())
+            return a->priority() < b->priority();
+        return a->name() < b->name();
+    });
+
+    for (Event *e : asyncMerge) {
+        if (e->when() < getCurTick())
+            ++lateEvents;
+        insert(e);
+    }
+    asyncMerge.clear();
 }
 
 } // namespace gem5
@@ -36,13 +36,16 @@
 #define __SIM_EVENTQ_HH__
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <climits>
 #include <functional>
 #include <iosfwd>
-#include <list>
+#include <map>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "base/debug.hh"
 #include "base/flags.hh"
@@ -57,6 +60,8 @@ namespace gem5
 
 class EventQueue;       // forward declaration
 class BaseGlobalEvent;
+class HostProfile;
+struct HostTimeAccount;
 
 //! Simulation Quantum for multiple eventq simulation.
 //! The quantum value is the period length after which the queues
@@ -79,6 +84,11 @@ extern __thread EventQueue *_curEventQueue;
 //! Current mode of execution: parallel / serial
 extern bool inParallelMode;
 
+//! Set when threads other than the simulation threads lock the event
+//! queues to schedule events (e.g., the receiver thread of dist-gem5).
+//! Serial simulations only take the event queue locks if it is set.
+extern bool externalEventThreads;
+
 //! Function for returning eventq queue for the provided
 //! index. The function allocates a new queue in case one
 //! does not exist for the index, provided that the index
@@ -272,6 +282,10 @@ class Event : public EventBase, public Serializable
     Priority _priority; //!< event priority
     Flags flags;
 
+    /// Host time account charged for processing this event, see
+    /// EventManager::schedule().
+    HostTimeAccount *hostAccount;
+
 #ifndef NDEBUG
     /// Global counter to generate unique IDs for Event instances
     static Counter instanceCounter;
@@ -413,7 +427,7 @@ class Event : public EventBase, public Serializable
      */
     Event(Priority p = Default_Pri, Flags f = 0)
         : nextBin(nullptr), nextInBin(nullptr), _when(0), _priority(p),
-          flags(Initialized | f)
+          flags(Initialized | f), hostAccount(nullptr)
     {
         assert(f.noneSet(~PublicWrite));
 #ifndef NDEBUG
@@ -500,6 +514,9 @@ class Event : public EventBase, public Serializable
      */
     bool isAutoDelete() const { return isManaged(); }
 
+    /** Charge the host time spent processing this event to an account. */
+    void setHostTimeAccount(HostTimeAccount *a) { hostAccount = a; }
+
     /**
      * Get the time that the event is scheduled
      *
@@ -591,9 +608,11 @@ operator!=(const Event &l, const Event &r)
  * Synchronous events are scheduled using schedule() method with the
  * argument 'global' set to false (default). This should only be done
  * from a thread holding the event queue lock
- * (EventQueue::service_mutex). The lock is always held when an event
- * handler is called, it can therefore always insert events into its
- * own event queue unless it voluntarily releases the lock.
+ * (EventQueue::service_mutex). The lock is held when an event handler
+ * is called whenever another thread may use the queue (see
+ * EventQueue::serviceLocking()), a handler can therefore always insert
+ * events into its own event queue unless it voluntarily releases the
+ * lock.
  *
  * Events can be scheduled across thread (and event queue borders) by
  * either scheduling asynchronous events or taking the target event
@@ -612,7 +631,7 @@ operator!=(const Event &l, const Event &r)
  * schedule() method with the 'global' parameter set to true. Unlike
  * the previous queue migration strategy, this strategy is fully
  * deterministic. This causes the event to be inserted in a separate
- * queue of asynchronous events (async_queue), which is merged main
+ * queue of asynchronous events (asyncHead), which is merged main
  * event queue at the end of each simulation quantum (by calling the
  * handleAsyncInsertions() method). Note that this implies that such
  * events must happen at least one simulation quantum into the future,
@@ -621,6 +640,17 @@ operator!=(const Event &l, const Event &r)
  */
 class EventQueue
 {
+  public:
+    /**
+     * How the queue finds the bin (when+priority) of an event. The List
+     * backend walks the bins from the head, which is fast as long as
+     * few bins are pending. The Tree backend also keeps the bins in an
+     * ordered map, which makes insertion and removal logarithmic in the
+     * number of pending bins. The bins themselves, and therefore the
+     * order in which events are serviced, are the same for both.
+     */
+    enum class Backend { List, Tree };
+
   private:
     friend void curEventQueue(EventQueue *);
 
@@ -628,16 +658,43 @@ class EventQueue
     Event *head;
     Tick _curTick;
 
-    //! Mutex to protect async queue.
-    UncontendedMutex async_queue_mutex;
+    //! Top event of each bin, ordered by when and priority. Only
+    //! maintained by the Tree backend.
+    typedef std::map<std::pair<Tick, Event::Priority>, Event *> BinIndex;
+    std::unique_ptr<BinIndex> binIndex;
+
+    //! Fill the bin index from the bin list.
+    void rebuildBinIndex();
+
+    //! Events added by other threads to this event queue, linked
+    //! through their nextBin pointers, most recent first. Threads push
+    //! events with a compare and swap, the owning thread takes them all
+    //! at once, so no lock is needed.
+    std::atomic<Event *> asyncHead;
+
+    //! Events taken from asyncHead, reused to avoid allocations.
+    std::vector<Event *> asyncMerge;
+
+    //! Events scheduled on this queue by other threads.
+    std::atomic<uint64_t> crossQueueEvents;
 
-    //! List of events added by other threads to this event queue.
-    std::list<Event*> async_queue;
+    //! Migrations of other threads to this queue, protected by
+    //! service_mutex.
+    uint64_t migrations;
+
+    //! Asynchronous events that were merged after their tick had
+    //! passed. Only updated by the thread operating this queue.
+    uint64_t lateEvents;
+
+    //! Host time profile of the serviced events, if profiling.
+    HostProfile *hostProfile;
 
     /**
      * Lock protecting event handling.
      *
-     * This lock is always taken when servicing events. It is assumed
+     * This lock is taken when servicing events, unless the simulation
+     * is serial and no other thread uses the queue (see
+     * serviceLocking()). It is assumed
      * that the thread scheduling new events (not asynchronous events
      * though) have taken this lock. This is normally done by
      * serviceOne() since new events are typically scheduled as a
@@ -661,6 +718,10 @@ class EventQueue
     void insert(Event *event);
     void remove(Event *event);
 
+    //! Tree backend versions of insert() and remove().
+    void insertIndexed(Event *event);
+    void removeIndexed(Event *event);
+
     //! Function for adding events to the async queue. The added events
     //! are added to main event queue later. Threads, other than the
     //! owning thread, should call this function instead of insert().
@@ -688,11 +749,15 @@ class EventQueue
          */
         ScopedMigration(EventQueue *_new_eq, bool _doMigrate = true)
             :new_eq(*_new_eq), old_eq(*curEventQueue()),
-             doMigrate((&new_eq != &old_eq)&&_doMigrate)
+             doMigrate((&new_eq != &old_eq)&&_doMigrate),
+             doLock(serviceLocking())
         {
             if (doMigrate){
-                old_eq.unlock();
-                new_eq.lock();
+                if (doLock) {
+                    old_eq.unlock();
+                    new_eq.lock();
+                }
+                ++new_eq.migrations;
                 curEventQueue(&new_eq);
             }
         }
@@ -700,8 +765,10 @@ class EventQueue
         ~ScopedMigration()
         {
             if (doMigrate){
-                new_eq.unlock();
-                old_eq.lock();
+                if (doLock) {
+                    new_eq.unlock();
+                    old_eq.lock();
+                }
                 curEventQueue(&old_eq);
             }
         }
@@ -710,6 +777,7 @@ class EventQueue
         EventQueue &new_eq;
         EventQueue &old_eq;
         bool doMigrate;
+        const bool doLock;
     };
 
 
@@ -728,20 +796,34 @@ class EventQueue
          * @group api_eventq
          */
         ScopedRelease(EventQueue *_eq)
-            :  eq(*_eq)
+            :  eq(*_eq), doLock(serviceLocking())
         {
-            eq.unlock();
+            if (doLock)
+                eq.unlock();
         }
 
         ~ScopedRelease()
         {
-            eq.lock();
+            if (doLock)
+                eq.lock();
         }
 
       private:
         EventQueue &eq;
+        const bool doLock;
     };
 
+    /**
+     * Whether the event queues are locked while servicing events. A
+     * serial simulation without other threads using the queues skips
+     * the locks.
+     */
+    static bool
+    serviceLocking()
+    {
+        return inParallelMode || externalEventThreads;
+    }
+
     /**
      * @ingroup api_eventq
      */
@@ -907,8 +989,32 @@ class EventQueue
 
     bool debugVerify() const;
 
+    /** Interaction with other threads since the last quantum barrier. */
+    struct SyncCounters
+    {
+        uint64_t crossQueueEvents;
+        uint64_t migrations;
+        uint64_t lateEvents;
+    };
+
     /**
-     * Function for moving events from the async_queue to the main queue.
+     * Get and clear the counters of the interaction with other threads.
+     * Must only be called while all the threads wait at a barrier.
+     */
+    SyncCounters takeSyncCounters();
+
+    /**
+     * Profile the host time spent in the events of this queue. The
+     * queue does not take ownership of the profile, nullptr disables
+     * profiling.
+     */
+    void setHostProfile(HostProfile *profile) { hostProfile = profile; }
+    const HostProfile *getHostProfile() const { return hostProfile; }
+
+    /**
+     * Function for moving events from the asynchronous list to the main queue.
+     * The events are inserted in (when, priority, name) order, so the
+     * result does not depend on the order the threads scheduled them in.
      */
     void handleAsyncInsertions();
 
@@ -939,6 +1045,18 @@ class EventQueue
      */
     Event* replaceHead(Event* s);
 
+    /**
+     * Switch the way events are looked up, keeping the pending ones.
+     * Must not be called while the queue is being serviced.
+     */
+    void setBackend(Backend backend);
+
+    Backend
+    backend() const
+    {
+        return binIndex ? Backend::Tree : Backend::List;
+    }
+
     /**@{*/
     /**
      * Provide an interface for locking/unlocking the event queue.
@@ -984,12 +1102,32 @@ curEventQueue(EventQueue *q)
 
 void dumpMainQueue();
 
+//! Backend of event queues created from now on.
+extern EventQueue::Backend defaultEventQueueBackend;
+
+//! Set the backend of all main event queues, including the ones that
+//! are created later.
+void setEventQueueBackend(EventQueue::Backend backend);
+
 class EventManager
 {
   protected:
     /** A pointer to this object's event queue */
     EventQueue *eventq;
 
+    /**
+     * Host time account of the events scheduled through this manager,
+     * nullptr unless host time stats are enabled.
+     */
+    HostTimeAccount *hostAccount = nullptr;
+
+    void
+    claim(Event *event)
+    {
+        if (hostAccount)
+            event->setHostTimeAccount(hostAccount);
+    }
+
   public:
     /**
      * Event manger manages events in the event queue. Where
@@ -1018,6 +1156,7 @@ class EventManager
     void
     schedule(Event &event, Tick when)
     {
+        claim(&event);
         eventq->schedule(&event, when);
     }
 
@@ -1036,6 +1175,7 @@ class EventManager
     void
     reschedule(Event &event, Tick when, bool always = false)
     {
+        claim(&event);
         eventq->reschedule(&event, when, always);
     }
 
@@ -1045,6 +1185,7 @@ class EventManager
     void
     schedule(Event *event, Tick when)
     {
+        claim(event);
         eventq->schedule(event, when);
     }
 
@@ -1063,6 +1204,7 @@ class EventManager
     void
     reschedule(Event *event, Tick when, bool always = false)
     {
+        claim(event);
         eventq->reschedule(event, when, always);
     }
 
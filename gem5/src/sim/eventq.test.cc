@@ -0,0 +1,335 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sim/eventq.hh"
+#include "sim/host_profile.hh"
+#include "sim/host_time.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/** A queue and events that log the order in which they run. */
+struct LoggingQueue
+{
+    EventQueue queue;
+    std::vector<std::unique_ptr<EventFunctionWrapper>> events;
+    std::vector<int> order;
+
+    LoggingQueue(EventQueue::Backend backend, const std::vector<int> &prios)
+        : queue("test_queue")
+    {
+        queue.setBackend(backend);
+        for (int i = 0; i < prios.size(); i++) {
+            events.emplace_back(new EventFunctionWrapper(
+                [this, i]() { order.push_back(i); }, "test_event", false,
+                prios[i]));
+        }
+    }
+
+    ~LoggingQueue()
+    {
+        for (auto &event : events) {
+            if (event->scheduled())
+                queue.deschedule(event.get());
+        }
+    }
+
+    void
+    runAll()
+    {
+        while (!queue.empty())
+            queue.serviceOne();
+    }
+};
+
+/** An event manager that charges its events to a host time account. */
+struct AccountingManager : public EventManager
+{
+    AccountingManager(EventQueue *q, HostTimeAccount *account)
+        : EventManager(q)
+    {
+        hostAccount = account;
+    }
+};
+
+} // anonymous namespace
+
+/** Events in the same bin run in LIFO order with both backends. */
+TEST(EventQueueTest, SameBinIsLifo)
+{
+    for (auto backend : { EventQueue::Backend::List,
+                          EventQueue::Backend::Tree }) {
+        LoggingQueue q(backend, { 0, 0, 0, -1, 1 });
+        q.queue.schedule(q.events[0].get(), 10);
+        q.queue.schedule(q.events[1].get(), 10);
+        q.queue.schedule(q.events[4].get(), 10);
+        q.queue.schedule(q.events[2].get(), 10);
+        q.queue.schedule(q.events[3].get(), 10);
+        q.runAll();
+        EXPECT_EQ(q.order, std::vector<int>({ 3, 2, 1, 0, 4 }));
+    }
+}
+
+/**
+ * The tree backend runs a random mix of schedule, deschedule and
+ * reschedule calls in exactly the order of the list backend, including
+ * when it is switched on and off while events are pending.
+ */
+TEST(EventQueueTest, TreeMatchesList)
+{
+    const int num_events = 300;
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<int> prio_dist(-2, 2);
+    std::vector<int> prios;
+    for (int i = 0; i < num_events; i++)
+        prios.push_back(prio_dist(gen));
+
+    LoggingQueue list(EventQueue::Backend::List, prios);
+    LoggingQueue tree(EventQueue::Backend::Tree, prios);
+
+    std::uniform_int_distribution<int> event_dist(0, num_events - 1);
+    std::uniform_int_distribution<int> delay_dist(0, 40);
+    std::uniform_int_distribution<int> op_dist(0, 9);
+    for (int step = 0; step < 20000; step++) {
+        const int op = op_dist(gen);
+        const int i = event_dist(gen);
+        const Tick when = list.queue.getCurTick() + delay_dist(gen);
+
+        if (op < 3) {
+            if (!list.queue.empty()) {
+                list.queue.serviceOne();
+                tree.queue.serviceOne();
+            }
+        } else if (!list.events[i]->scheduled()) {
+            list.queue.schedule(list.events[i].get(), when);
+            tree.queue.schedule(tree.events[i].get(), when);
+        } else if (op < 6) {
+            list.queue.deschedule(list.events[i].get());
+            tree.queue.deschedule(tree.events[i].get());
+        } else {
+            list.queue.reschedule(list.events[i].get(), when);
+            tree.queue.reschedule(tree.events[i].get(), when);
+        }
+
+        if (step % 5000 == 4999) {
+            tree.queue.setBackend(EventQueue::Backend::List);
+            tree.queue.setBackend(EventQueue::Backend::Tree);
+        }
+
+        ASSERT_EQ(list.order, tree.order);
+        ASSERT_EQ(list.queue.empty(), tree.queue.empty());
+    }
+
+    EXPECT_TRUE(tree.queue.debugVerify());
+    list.runAll();
+    tree.runAll();
+    EXPECT_EQ(list.order, tree.order);
+}
+
+/**
+ * Events inserted through the asynchronous queue run in the same order
+ * whatever order they were scheduled in.
+ */
+TEST(EventQueueTest, AsyncInsertionsAreOrdered)
+{
+    const int num_events = 12;
+    std::vector<int> schedule_order;
+    for (int i = 0; i < num_events; i++)
+        schedule_order.push_back(i);
+
+    std::vector<int> first_order;
+    std::mt19937 gen(1);
+    for (int round = 0; round < 4; round++) {
+        EventQueue queue("test_queue");
+        std::vector<std::unique_ptr<EventFunctionWrapper>> events;
+        std::vector<int> order;
+        // events 0-3 and 4-7 each share a bin, with different names
+        for (int i = 0; i < num_events; i++) {
+            events.emplace_back(new EventFunctionWrapper(
+                [&order, i]() { order.push_back(i); },
+                "event" + std::to_string(i % 4), false,
+                i < 4 ? 0 : 1));
+        }
+
+        std::shuffle(schedule_order.begin(), schedule_order.end(), gen);
+        EventQueue *old_queue = curEventQueue();
+        curEventQueue(&queue);
+        inParallelMode = true;
+        for (int i : schedule_order)
+            queue.schedule(events[i].get(), i < 8 ? 10 : 10 + i, true);
+        EXPECT_TRUE(queue.empty());
+        queue.handleAsyncInsertions();
+        inParallelMode = false;
+        curEventQueue(old_queue);
+
+        while (!queue.empty())
+            queue.serviceOne();
+
+        ASSERT_EQ(order.size(), num_events);
+        if (round == 0)
+            first_order = order;
+        EXPECT_EQ(order, first_order);
+    }
+}
+
+/**
+ * Events scheduled by another thread, and events merged after their
+ * tick, show up in the sync counters of the receiving queue.
+ */
+TEST(EventQueueTest, SyncCounters)
+{
+    EventQueue sender("sender_queue");
+    EventQueue receiver("receiver_queue");
+    EventFunctionWrapper early([]() {}, "early_event");
+    EventFunctionWrapper late([]() {}, "late_event");
+
+    EventQueue *old_queue = curEventQueue();
+    curEventQueue(&sender);
+    inParallelMode = true;
+    receiver.schedule(&early, 100);
+    receiver.schedule(&late, 10);
+    receiver.setCurTick(50);
+
+    curEventQueue(&receiver);
+    receiver.handleAsyncInsertions();
+    inParallelMode = false;
+
+    EventQueue::SyncCounters c = receiver.takeSyncCounters();
+    EXPECT_EQ(c.crossQueueEvents, 2);
+    EXPECT_EQ(c.lateEvents, 1);
+    EXPECT_EQ(c.migrations, 0);
+
+    {
+        EventQueue::ScopedMigration migrate(&sender);
+    }
+    EXPECT_EQ(sender.takeSyncCounters().migrations, 1);
+
+    c = receiver.takeSyncCounters();
+    EXPECT_EQ(c.crossQueueEvents, 0);
+    EXPECT_EQ(c.lateEvents, 0);
+
+    receiver.deschedule(&early);
+    receiver.deschedule(&late);
+    curEventQueue(old_queue);
+}
+
+/** Threads inserting events at the same time do not lose any. */
+TEST(EventQueueTest, ConcurrentAsyncInsertions)
+{
+    const int num_threads = 4;
+    const int num_events = 2000;
+    EventQueue receiver("receiver_queue");
+    std::vector<std::unique_ptr<EventFunctionWrapper>> events;
+    int serviced = 0;
+    for (int i = 0; i < num_threads * num_events; i++) {
+        events.emplace_back(new EventFunctionWrapper(
+            [&serviced]() { serviced++; },
+            "event" + std::to_string(i / num_events)));
+    }
+
+    inParallelMode = true;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t]() {
+            EventQueue sender("sender_queue");
+            curEventQueue(&sender);
+            for (int i = 0; i < num_events; i++) {
+                receiver.schedule(events[t * num_events + i].get(),
+                                  10 + i % 7);
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    EventQueue *old_queue = curEventQueue();
+    curEventQueue(&receiver);
+    receiver.handleAsyncInsertions();
+    inParallelMode = false;
+    curEventQueue(old_queue);
+
+    while (!receiver.empty())
+        receiver.serviceOne();
+    EXPECT_EQ(serviced, num_threads * num_events);
+    EXPECT_EQ(receiver.takeSyncCounters().crossQueueEvents,
+              num_threads * num_events);
+}
+
+/** A host profile counts every event but only times the sampled ones. */
+TEST(EventQueueTest, HostProfile)
+{
+    LoggingQueue q(EventQueue::Backend::List, { 0, 0, 0, 0, 0, 0 });
+    HostProfile profile(3);
+    q.queue.setHostProfile(&profile);
+    for (int i = 0; i < q.events.size(); i++)
+        q.queue.schedule(q.events[i].get(), 10 + i);
+    q.runAll();
+    q.queue.setHostProfile(nullptr);
+
+    EXPECT_EQ(q.order, std::vector<int>({ 0, 1, 2, 3, 4, 5 }));
+    EXPECT_EQ(profile.events(), 6);
+    EXPECT_EQ(profile.samples(), 2);
+    ASSERT_EQ(profile.entries().size(), 1);
+    const HostProfile::Entry &entry =
+        profile.entries().at("test_event.wrapped_function_event");
+    EXPECT_EQ(entry.samples, 2);
+    EXPECT_EQ(entry.description, "EventFunctionWrapped");
+}
+
+/**
+ * Events are charged to the account of the manager that scheduled them,
+ * excluding the time spent in nested accounts.
+ */
+TEST(EventQueueTest, HostTimeAccounts)
+{
+    EventQueue queue("test_queue");
+    HostTimeAccount outer, inner;
+    AccountingManager manager(&queue, &outer);
+    EventFunctionWrapper event([&inner]() {
+        HostTimeScope scope(&inner, &HostTimeAccount::timingReqs);
+    }, "test_event");
+
+    manager.schedule(event, 10);
+    queue.serviceOne();
+    manager.schedule(event, 20);
+    queue.serviceOne();
+
+    EXPECT_EQ(outer.events, 2);
+    EXPECT_EQ(outer.timingReqs, 0);
+    EXPECT_EQ(inner.events, 0);
+    EXPECT_EQ(inner.timingReqs, 2);
+    EXPECT_EQ(host_time::current, nullptr);
+}
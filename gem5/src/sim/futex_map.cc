@@ -28,6 +28,9 @@
 
 #include <sim/futex_map.hh>
 
+#include "cpu/base.hh"
+#include "sim/eventq.hh"
+
 namespace gem5
 {
 
@@ -72,11 +75,9 @@ FutexMap::wakeup(Addr addr, uint64_t tgid, int count)
         // memory addresses outside of syscalls, so we
         // must only count threads that were actually
         // woken up by this syscall.
-        auto& tc = waiterList.front().tc;
-        tc->activate();
+        wake(waiterList.front().tc);
         woken_up++;
         waiterList.pop_front();
-        waitingTcs.erase(tc);
     }
 
     if (waiterList.empty())
@@ -98,7 +99,10 @@ FutexMap::suspend_bitset(Addr addr, uint64_t tgid, ThreadContext *tc,
     } else {
         it->second.push_back(WaiterState(tc, bitmask));
     }
-    waitingTcs.emplace(tc);
+    {
+        std::lock_guard<std::mutex> lock(waitingMutex);
+        waitingTcs.emplace(tc);
+    }
 
     /** Suspend the thread context */
     tc->suspend();
@@ -122,9 +126,8 @@ FutexMap::wakeup_bitset(Addr addr, uint64_t tgid, int bitmask)
         WaiterState& waiter = *iter;
 
         if (waiter.checkMask(bitmask)) {
-            waiter.tc->activate();
+            wake(waiter.tc);
             iter = waiterList.erase(iter);
-            waitingTcs.erase(waiter.tc);
             woken_up++;
         } else {
             ++iter;
@@ -150,7 +153,7 @@ FutexMap::requeue(Addr addr1, uint64_t tgid, int count, int count2, Addr addr2)
     auto &waiterList1 = it1->second;
 
     while (!waiterList1.empty() && woken_up < count) {
-        waiterList1.front().tc->activate();
+        wake(waiterList1.front().tc);
         waiterList1.pop_front();
         woken_up++;
     }
@@ -184,7 +187,20 @@ FutexMap::requeue(Addr addr1, uint64_t tgid, int count, int count2, Addr addr2)
 bool
 FutexMap::is_waiting(ThreadContext *tc)
 {
+    std::lock_guard<std::mutex> lock(waitingMutex);
     return waitingTcs.find(tc) != waitingTcs.end();
 }
 
+void
+FutexMap::wake(ThreadContext *tc)
+{
+    {
+        std::lock_guard<std::mutex> lock(waitingMutex);
+        waitingTcs.erase(tc);
+    }
+
+    EventQueue::ScopedMigration migrate(tc->getCpuPtr()->eventQueue());
+    tc->activate();
+}
+
 } // namespace gem5
@@ -29,6 +29,7 @@
 #ifndef __FUTEX_MAP_HH__
 #define __FUTEX_MAP_HH__
 
+#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -104,7 +105,9 @@ class WaiterState
 typedef std::list<WaiterState> WaiterList;
 
 /**
- * FutexMap class holds a map of all futexes used in the system
+ * FutexMap class holds a map of all futexes used in the system. The futexes
+ * are only operated on by syscalls, which are emulated one at a time, but
+ * the CPUs of the waiters may be simulated on other event queues.
  */
 class FutexMap : public std::unordered_map<FutexKey, WaiterList>
 {
@@ -139,8 +142,13 @@ class FutexMap : public std::unordered_map<FutexKey, WaiterList>
     bool is_waiting(ThreadContext *tc);
 
   private:
+    /** Wake up a waiting thread, migrating to the event queue of its CPU */
+    void wake(ThreadContext *tc);
 
     std::unordered_set<ThreadContext *> waitingTcs;
+
+    /** Protects waitingTcs, which CPUs check outside of syscalls */
+    std::mutex waitingMutex;
 };
 
 } // namespace gem5
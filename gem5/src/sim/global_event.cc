@@ -29,7 +29,10 @@
 
 #include "sim/global_event.hh"
 
+#include <chrono>
+
 #include "sim/cur_tick.hh"
+#include "sim/quantum_controller.hh"
 
 namespace gem5
 {
@@ -143,6 +146,8 @@ GlobalEvent::BarrierEvent::process()
 void
 GlobalSyncEvent::BarrierEvent::process()
 {
+    const auto start = std::chrono::steady_clock::now();
+
     // wait for all queues to arrive at barrier, then process event
     if (globalBarrier()) {
         _globalEvent->process();
@@ -151,6 +156,13 @@ GlobalSyncEvent::BarrierEvent::process()
     // second barrier to force all queues to wait for event processing
     // to finish before continuing
     globalBarrier();
+
+    if (quantumController) {
+        quantumController->barrierWaited(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start));
+    }
+
     curEventQueue()->handleAsyncInsertions();
 }
 
@@ -158,6 +170,8 @@ void
 GlobalSyncEvent::process()
 {
     if (repeat) {
+        if (quantumController)
+            repeat = quantumController->nextQuantum(repeat);
         schedule(curTick() + repeat);
     }
 }
@@ -0,0 +1,181 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/host_profile.hh"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "base/cprintf.hh"
+#include "base/output.hh"
+#include "sim/core.hh"
+#include "sim/sim_object.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+/** Profiles of the main event queues, indexed like mainEventQueue. */
+std::vector<std::unique_ptr<HostProfile>> profiles;
+
+/** Time and cycle counter when profiling started. */
+std::chrono::steady_clock::time_point startTime;
+uint64_t startCycles;
+
+struct Total
+{
+    uint64_t samples = 0;
+    uint64_t cycles = 0;
+};
+
+/** Print totals in decreasing order of host time. */
+void
+printTotals(std::ostream &os, const char *title,
+            const std::map<std::string, Total> &totals,
+            double seconds_per_cycle, unsigned period, uint64_t all_cycles)
+{
+    std::vector<std::pair<std::string, Total>> sorted(
+        totals.begin(), totals.end());
+    std::stable_sort(sorted.begin(), sorted.end(),
+        [](const auto &a, const auto &b) {
+            return a.second.cycles > b.second.cycles;
+        });
+
+    ccprintf(os, "\n---------- %s ----------\n", title);
+    ccprintf(os, "%-60s %12s %14s %8s\n", "name", "samples", "host_seconds",
+             "share");
+    for (const auto &[name, total] : sorted) {
+        ccprintf(os, "%-60s %12d %14.6f %7.2f%%\n", name, total.samples,
+                 total.cycles * period * seconds_per_cycle,
+                 all_cycles ? 100.0 * total.cycles / all_cycles : 0.0);
+    }
+}
+
+/**
+ * Find the SimObject an event belongs to from the event name, which
+ * usually starts with the name of its SimObject.
+ */
+std::string
+ownerName(const std::string &name,
+          std::map<std::string, bool> &is_object)
+{
+    std::string prefix = name;
+    while (!prefix.empty()) {
+        auto it = is_object.find(prefix);
+        if (it == is_object.end()) {
+            it = is_object.emplace(prefix,
+                SimObject::find(prefix.c_str()) != nullptr).first;
+        }
+        if (it->second)
+            return prefix;
+
+        const auto dot = prefix.rfind('.');
+        prefix.resize(dot == std::string::npos ? 0 : dot);
+    }
+    return "(unknown)";
+}
+
+} // anonymous namespace
+
+void
+enableHostProfile(unsigned period)
+{
+    if (!profiles.empty())
+        return;
+
+    startTime = std::chrono::steady_clock::now();
+    startCycles = hostCycles();
+
+    for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+        profiles.emplace_back(new HostProfile(period));
+        mainEventQueue[i]->setHostProfile(profiles.back().get());
+    }
+
+    registerExitCallback([]() {
+        OutputStream *os = simout.create("host_profile.txt");
+        dumpHostProfile(*os->stream());
+        simout.close(os);
+    });
+}
+
+void
+dumpHostProfile(std::ostream &os)
+{
+    if (profiles.empty())
+        return;
+
+    const double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - startTime).count();
+    const uint64_t cycles = hostCycles() - startCycles;
+    const double seconds_per_cycle = cycles ? seconds / cycles : 0.0;
+    const unsigned period = profiles.front()->samplePeriod();
+
+    std::map<std::string, Total> objects;
+    std::map<std::string, Total> descriptions;
+    std::map<std::string, Total> events;
+    std::map<std::string, bool> is_object;
+    uint64_t all_events = 0;
+    uint64_t all_cycles = 0;
+
+    for (const auto &profile : profiles) {
+        all_events += profile->events();
+        all_cycles += profile->cycles();
+        for (const auto &[name, entry] : profile->entries()) {
+            for (Total *total : { &objects[ownerName(name, is_object)],
+                                  &descriptions[entry.description],
+                                  &events[name] }) {
+                total->samples += entry.samples;
+                total->cycles += entry.cycles;
+            }
+        }
+    }
+
+    ccprintf(os, "host_seconds %.6f\n", seconds);
+    ccprintf(os, "events %d\n", all_events);
+    ccprintf(os, "sample_period %d\n", period);
+    ccprintf(os, "sampled_event_seconds %.6f\n",
+             all_cycles * period * seconds_per_cycle);
+
+    ccprintf(os, "\n---------- Event queues ----------\n");
+    ccprintf(os, "%-40s %14s %14s\n", "queue", "events", "host_seconds");
+    for (uint32_t i = 0; i < profiles.size(); ++i) {
+        ccprintf(os, "%-40s %14d %14.6f\n", mainEventQueue[i]->name(),
+                 profiles[i]->events(),
+                 profiles[i]->cycles() * period * seconds_per_cycle);
+    }
+
+    printTotals(os, "SimObjects", objects, seconds_per_cycle, period,
+                all_cycles);
+    printTotals(os, "Event descriptions", descriptions, seconds_per_cycle,
+                period, all_cycles);
+    printTotals(os, "Events", events, seconds_per_cycle, period,
+                all_cycles);
+}
+
+} // namespace gem5
@@ -0,0 +1,128 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SIM_HOST_PROFILE_HH__
+#define __SIM_HOST_PROFILE_HH__
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+#include "sim/eventq.hh"
+#include "sim/host_time.hh"
+
+namespace gem5
+{
+
+/**
+ * Host time profile of a single event queue.
+ *
+ * Every event serviced by the queue is counted, but only one in
+ * period events is timed with the host cycle counter. The sampled
+ * events are attributed to their name and description, which keeps
+ * the cost of an unsampled event to a decrement and a branch.
+ */
+class HostProfile
+{
+  public:
+    struct Entry
+    {
+        std::string description;
+        uint64_t samples = 0;
+        uint64_t cycles = 0;
+    };
+
+  private:
+    const unsigned period;
+    unsigned countdown;
+
+    uint64_t _events = 0;
+    uint64_t _samples = 0;
+    uint64_t _cycles = 0;
+
+    /** Sampled events, by event name. */
+    std::unordered_map<std::string, Entry> _entries;
+
+    void
+    processSampled(Event *event)
+    {
+        countdown = period;
+
+        const uint64_t start = hostCycles();
+        event->process();
+        const uint64_t cycles = hostCycles() - start;
+
+        Entry &entry = _entries[event->name()];
+        if (entry.samples == 0)
+            entry.description = event->description();
+        entry.samples++;
+        entry.cycles += cycles;
+        _samples++;
+        _cycles += cycles;
+    }
+
+  public:
+    HostProfile(unsigned _period) : period(_period), countdown(_period) {}
+
+    /** Process an event on behalf of its event queue. */
+    void
+    process(Event *event)
+    {
+        _events++;
+        if (--countdown == 0)
+            processSampled(event);
+        else
+            event->process();
+    }
+
+    unsigned samplePeriod() const { return period; }
+    /** Events serviced. */
+    uint64_t events() const { return _events; }
+    /** Events timed. */
+    uint64_t samples() const { return _samples; }
+    /** Host cycles spent in the timed events. */
+    uint64_t cycles() const { return _cycles; }
+    const std::unordered_map<std::string, Entry> &
+    entries() const
+    {
+        return _entries;
+    }
+};
+
+/**
+ * Start profiling the main event queues and write host_profile.txt to
+ * the output directory when the simulator exits.
+ *
+ * @param period time one in this many events
+ */
+void enableHostProfile(unsigned period);
+
+/** Write a report of the host profile of all main event queues. */
+void dumpHostProfile(std::ostream &os);
+
+} // namespace gem5
+
+#endif // __SIM_HOST_PROFILE_HH__
@@ -0,0 +1,107 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/host_time.hh"
+
+#include "base/statistics.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+const auto startTime = std::chrono::steady_clock::now();
+const uint64_t startCycles = hostCycles();
+
+/** The "hostTime" stats of a SimObject. */
+struct HostTimeStats : public statistics::Group
+{
+    HostTimeAccount &account;
+
+    statistics::Value hostSeconds;
+    statistics::Value events;
+    statistics::Value timingReqs;
+    statistics::Value timingResps;
+    statistics::Formula eventRate;
+
+    HostTimeStats(statistics::Group *parent, HostTimeAccount &_account)
+        : statistics::Group(parent, "hostTime"),
+          account(_account),
+          ADD_STAT(hostSeconds, statistics::units::Second::get(),
+                   "Host time spent in the events and timing port "
+                   "handlers of this object"),
+          ADD_STAT(events, statistics::units::Count::get(),
+                   "Events of this object serviced"),
+          ADD_STAT(timingReqs, statistics::units::Count::get(),
+                   "Timing requests received by this object"),
+          ADD_STAT(timingResps, statistics::units::Count::get(),
+                   "Timing responses received by this object"),
+          ADD_STAT(eventRate, statistics::units::Rate<
+                      statistics::units::Count,
+                      statistics::units::Second>::get(),
+                   "Events of this object serviced per host second")
+    {
+        hostSeconds
+            .functor([this]() {
+                    return account.cycles * hostSecondsPerCycle();
+                })
+            .precision(6)
+            ;
+        events.functor([this]() { return account.events; });
+        timingReqs.functor([this]() { return account.timingReqs; });
+        timingResps.functor([this]() { return account.timingResps; });
+
+        eventRate.precision(0);
+        eventRate = events / hostSeconds;
+    }
+
+    void
+    resetStats() override
+    {
+        statistics::Group::resetStats();
+        account = HostTimeAccount();
+    }
+};
+
+} // anonymous namespace
+
+double
+hostSecondsPerCycle()
+{
+    const double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - startTime).count();
+    const uint64_t cycles = hostCycles() - startCycles;
+    return cycles ? seconds / cycles : 0.0;
+}
+
+std::unique_ptr<statistics::Group>
+makeHostTimeStats(statistics::Group *parent, HostTimeAccount &account)
+{
+    return std::unique_ptr<statistics::Group>(
+        new HostTimeStats(parent, account));
+}
+
+} // namespace gem5
@@ -0,0 +1,153 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SIM_HOST_TIME_HH__
+#define __SIM_HOST_TIME_HH__
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace gem5
+{
+
+namespace statistics
+{
+class Group;
+} // namespace statistics
+
+/**
+ * Read the host's cycle counter. Falls back to a nanosecond clock on
+ * hosts without a user readable counter.
+ */
+inline uint64_t
+hostCycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t cycles;
+    asm volatile("mrs %0, cntvct_el0" : "=r" (cycles));
+    return cycles;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+ * Host seconds per hostCycles() cycle, measured against the wall clock
+ * since the simulator started.
+ */
+double hostSecondsPerCycle();
+
+/**
+ * Host time spent on behalf of a SimObject. The cycles exclude the
+ * time spent in nested accounts, e.g., the time a CPU event spends
+ * in the recvTimingReq() of a cache is charged to the cache.
+ */
+struct HostTimeAccount
+{
+    uint64_t cycles = 0;
+    uint64_t events = 0;
+    uint64_t timingReqs = 0;
+    uint64_t timingResps = 0;
+};
+
+namespace host_time
+{
+
+/** The account host time is charged to on this thread. */
+inline thread_local HostTimeAccount *current = nullptr;
+/** Cycle counter when current was last charged. */
+inline thread_local uint64_t start = 0;
+
+} // namespace host_time
+
+/**
+ * Charge the host time spent in a scope to an account. Scopes nest,
+ * the enclosing account is not charged while the scope is active. A
+ * null account leaves the accounting untouched, which makes the scope
+ * cheap when host time stats are disabled.
+ */
+class HostTimeScope
+{
+  private:
+    HostTimeAccount *const account;
+    HostTimeAccount *saved;
+
+  public:
+    /**
+     * @param _account account to charge, may be nullptr
+     * @param counter counter of the account to increment
+     */
+    HostTimeScope(HostTimeAccount *_account,
+                  uint64_t HostTimeAccount::*counter)
+        : account(_account)
+    {
+        if (!account)
+            return;
+
+        const uint64_t now = hostCycles();
+        saved = host_time::current;
+        if (saved)
+            saved->cycles += now - host_time::start;
+        host_time::current = account;
+        host_time::start = now;
+        account->*counter += 1;
+    }
+
+    ~HostTimeScope()
+    {
+        if (!account)
+            return;
+
+        const uint64_t now = hostCycles();
+        account->cycles += now - host_time::start;
+        host_time::current = saved;
+        host_time::start = now;
+    }
+
+    HostTimeScope(const HostTimeScope &) = delete;
+    HostTimeScope &operator=(const HostTimeScope &) = delete;
+};
+
+/**
+ * Create the host time stats of a SimObject.
+ *
+ * @param parent stat group of the SimObject
+ * @param account account the stats report
+ * @return the "hostTime" stat group, a child of parent
+ */
+std::unique_ptr<statistics::Group> makeHostTimeStats(
+    statistics::Group *parent, HostTimeAccount &account);
+
+} // namespace gem5
+
+#endif // __SIM_HOST_TIME_HH__
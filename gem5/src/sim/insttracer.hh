@@ -256,6 +256,7 @@ class InstRecord
     bool getCpSeqValid() const { return cp_seq_valid; }
 
     bool getFaulting() const { return faulting; }
+    bool getPredicate() const { return predicate; }
 };
 
 class InstTracer : public SimObject
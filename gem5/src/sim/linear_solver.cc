@@ -37,6 +37,10 @@
 
 #include "sim/linear_solver.hh"
 
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
 namespace gem5
 {
 
@@ -87,4 +91,156 @@ LinearSystem::solve() const
     return ret;
 }
 
+double
+SparseLinearSystem::get(unsigned row, unsigned col) const
+{
+    assert(row < rows.size() && col < rows.size());
+    auto it = rows[row].find(col);
+    return it == rows[row].end() ? 0.0 : it->second;
+}
+
+void
+SparseLinearSystem::factor()
+{
+    const unsigned n = rows.size();
+    factored = true;
+    banded = false;
+
+    // Symmetric structure of the matrix
+    std::vector<std::vector<unsigned>> adj(n);
+    for (unsigned i = 0; i < n; i++) {
+        for (auto &[j, value] : rows[i]) {
+            if (i != j && value != 0.0) {
+                adj[i].push_back(j);
+                adj[j].push_back(i);
+            }
+        }
+    }
+    for (auto &neighbours : adj) {
+        std::sort(neighbours.begin(), neighbours.end());
+        neighbours.erase(std::unique(neighbours.begin(), neighbours.end()),
+                         neighbours.end());
+    }
+
+    // Cuthill-McKee from a node of lowest degree of every connected
+    // component, visiting the neighbours by increasing degree
+    auto by_degree = [&adj](unsigned a, unsigned b) {
+        return adj[a].size() < adj[b].size() ||
+            (adj[a].size() == adj[b].size() && a < b);
+    };
+    std::vector<unsigned> nodes(n);
+    for (unsigned i = 0; i < n; i++)
+        nodes[i] = i;
+    std::sort(nodes.begin(), nodes.end(), by_degree);
+
+    unknown.clear();
+    std::vector<bool> visited(n, false);
+    for (auto start : nodes) {
+        if (visited[start])
+            continue;
+        std::queue<unsigned> next;
+        next.push(start);
+        visited[start] = true;
+        while (!next.empty()) {
+            unsigned i = next.front();
+            next.pop();
+            unknown.push_back(i);
+            std::vector<unsigned> neighbours;
+            for (auto j : adj[i]) {
+                if (!visited[j]) {
+                    visited[j] = true;
+                    neighbours.push_back(j);
+                }
+            }
+            std::sort(neighbours.begin(), neighbours.end(), by_degree);
+            for (auto j : neighbours)
+                next.push(j);
+        }
+    }
+    std::reverse(unknown.begin(), unknown.end());
+    order.assign(n, 0);
+    for (unsigned k = 0; k < n; k++)
+        order[unknown[k]] = k;
+
+    bandwidth = 0;
+    for (unsigned i = 0; i < n; i++) {
+        for (auto j : adj[i]) {
+            bandwidth = std::max<unsigned>(bandwidth,
+                std::abs(int(order[i]) - int(order[j])));
+        }
+    }
+
+    lu.assign(n * (2 * bandwidth + 1), 0.0);
+    double scale = 0.0;
+    for (unsigned i = 0; i < n; i++) {
+        for (auto &[j, value] : rows[i]) {
+            band(order[i], order[j]) = value;
+            scale = std::max(scale, std::fabs(value));
+        }
+    }
+
+    // LU decomposition in place, the fill in stays in the band
+    for (unsigned k = 0; k < n; k++) {
+        double pivot = band(k, k);
+        if (std::fabs(pivot) <= 1e-12 * scale)
+            return;
+        unsigned last = std::min(n - 1, k + bandwidth);
+        for (unsigned i = k + 1; i <= last; i++) {
+            double &l = band(i, k);
+            if (l == 0.0)
+                continue;
+            l /= pivot;
+            for (unsigned j = k + 1; j <= last; j++)
+                band(i, j) -= l * band(k, j);
+        }
+    }
+    banded = true;
+}
+
+std::vector<double>
+SparseLinearSystem::solve(const std::vector<double> &b)
+{
+    assert(b.size() == rows.size());
+    if (!factored)
+        factor();
+    if (!banded)
+        return solveDense(b);
+
+    const unsigned n = rows.size();
+    std::vector<double> y(n);
+    for (unsigned k = 0; k < n; k++)
+        y[k] = b[unknown[k]];
+
+    // L * y = b, then U * x = y
+    for (unsigned k = 0; k < n; k++) {
+        unsigned last = std::min(n - 1, k + bandwidth);
+        for (unsigned i = k + 1; i <= last; i++)
+            y[i] -= band(i, k) * y[k];
+    }
+    for (int k = n - 1; k >= 0; k--) {
+        unsigned last = std::min(n - 1, k + bandwidth);
+        for (unsigned j = k + 1; j <= last; j++)
+            y[k] -= band(k, j) * y[j];
+        y[k] /= band(k, k);
+    }
+
+    std::vector<double> x(n);
+    for (unsigned k = 0; k < n; k++)
+        x[unknown[k]] = y[k];
+    return x;
+}
+
+std::vector<double>
+SparseLinearSystem::solveDense(const std::vector<double> &b) const
+{
+    const unsigned n = rows.size();
+    LinearSystem ls(n);
+    for (unsigned i = 0; i < n; i++) {
+        for (auto &[j, value] : rows[i])
+            ls[i][j] = value;
+        ls[i][ls[i].cnt()] = -b[i];
+    }
+    return ls.solve();
+}
+
 } // namespace gem5
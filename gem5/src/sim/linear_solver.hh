@@ -39,6 +39,7 @@
 #define __SIM_LINEAR_SOLVER_HH__
 
 #include <cassert>
+#include <map>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -134,6 +135,73 @@ class LinearSystem
     std::vector < LinearEquation > matrix;
 };
 
+/**
+ * A linear system A * x = b with a sparse matrix A that is factored once
+ * and then solved for many right hand sides b, e.g. the nodal equations
+ * of a thermal RC network, whose coefficients only depend on its
+ * topology and time step.
+ *
+ * The unknowns are renumbered by reverse Cuthill-McKee to make the
+ * matrix banded, and the band is factored by LU decomposition without
+ * pivoting. This suits the diagonally dominant matrices of RC networks.
+ * A matrix with a zero pivot is solved by LinearSystem instead.
+ */
+class SparseLinearSystem
+{
+  public:
+    SparseLinearSystem(unsigned unknowns)
+      : rows(unknowns), factored(false), banded(false), bandwidth(0)
+    {}
+
+    unsigned size() const { return rows.size(); }
+
+    /** Add value to A[row][col], the system has to be factored again */
+    void
+    add(unsigned row, unsigned col, double value)
+    {
+        assert(row < rows.size() && col < rows.size());
+        rows[row][col] += value;
+        factored = false;
+    }
+
+    /** Coefficient of A, for inspection */
+    double get(unsigned row, unsigned col) const;
+
+    /** Factor the matrix, solve() does it if it was not done already */
+    void factor();
+
+    /** Whether the banded factorization succeeded */
+    bool isBanded() const { return factored && banded; }
+
+    /** Solve A * x = b */
+    std::vector<double> solve(const std::vector<double> &b);
+
+  private:
+    /** Entry (row, col) of the band, in the renumbered unknowns */
+    double &
+    band(unsigned row, unsigned col)
+    {
+        return lu[row * (2 * bandwidth + 1) + col + bandwidth - row];
+    }
+
+    /** Solve with LinearSystem when the matrix cannot be factored */
+    std::vector<double> solveDense(const std::vector<double> &b) const;
+
+    /** Non zero coefficients of every row, by column */
+    std::vector<std::map<unsigned, double>> rows;
+
+    bool factored;
+    bool banded;
+
+    /** Renumbered unknown of each unknown and the reverse */
+    std::vector<unsigned> order;
+    std::vector<unsigned> unknown;
+
+    /** The L and U factors in the band, L with a unit diagonal */
+    unsigned bandwidth;
+    std::vector<double> lu;
+};
+
 } // namespace gem5
 
 #endif
@@ -0,0 +1,111 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "sim/linear_solver.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/** Dense solution of a * x = b */
+std::vector<double>
+denseSolve(const SparseLinearSystem &a, const std::vector<double> &b)
+{
+    LinearSystem ls(a.size());
+    for (unsigned i = 0; i < a.size(); i++) {
+        for (unsigned j = 0; j < a.size(); j++)
+            ls[i][j] = a.get(i, j);
+        ls[i][ls[i].cnt()] = -b[i];
+    }
+    return ls.solve();
+}
+
+} // anonymous namespace
+
+/** The nodal equations of a grid of RC nodes, as for a floorplan */
+TEST(SparseLinearSystemTest, Grid)
+{
+    const unsigned side = 6;
+    const unsigned n = side * side;
+    SparseLinearSystem a(n);
+    auto connect = [&a](unsigned i, unsigned j, double g) {
+        a.add(i, i, -g);
+        a.add(j, j, -g);
+        a.add(i, j, g);
+        a.add(j, i, g);
+    };
+    for (unsigned y = 0; y < side; y++) {
+        for (unsigned x = 0; x < side; x++) {
+            unsigned i = y * side + x;
+            if (x + 1 < side)
+                connect(i, i + 1, 2.0 + x);
+            if (y + 1 < side)
+                connect(i, i + side, 1.0 + y);
+            // capacitance and a resistance to the ambient
+            a.add(i, i, -0.5 - 0.1 * i);
+        }
+    }
+
+    a.factor();
+    EXPECT_TRUE(a.isBanded());
+    for (unsigned step = 0; step < 3; step++) {
+        std::vector<double> b(n);
+        for (unsigned i = 0; i < n; i++)
+            b[i] = -std::sin(i + step);
+        std::vector<double> x = a.solve(b);
+        std::vector<double> ref = denseSolve(a, b);
+        ASSERT_EQ(n, x.size());
+        for (unsigned i = 0; i < n; i++)
+            EXPECT_NEAR(ref[i], x[i], 1e-9);
+    }
+}
+
+/** A zero pivot falls back to Gaussian elimination with row swaps */
+TEST(SparseLinearSystemTest, ZeroPivot)
+{
+    SparseLinearSystem a(2);
+    a.add(0, 1, 1.0);
+    a.add(1, 0, 2.0);
+    std::vector<double> x = a.solve({3.0, 4.0});
+    EXPECT_FALSE(a.isBanded());
+    EXPECT_NEAR(2.0, x[0], 1e-12);
+    EXPECT_NEAR(3.0, x[1], 1e-12);
+}
+
+/** More coefficients invalidate the factorization */
+TEST(SparseLinearSystemTest, Refactor)
+{
+    SparseLinearSystem a(1);
+    a.add(0, 0, 2.0);
+    EXPECT_NEAR(2.0, a.solve({4.0})[0], 1e-12);
+    a.add(0, 0, 2.0);
+    EXPECT_NEAR(1.0, a.solve({4.0})[0], 1e-12);
+}
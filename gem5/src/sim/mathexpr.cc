@@ -166,6 +166,76 @@ MathExpr::eval(const Node *n, EvalCallback fn) const {
     return 0;
 }
 
+MathExpr::Program
+MathExpr::compile(IndexCallback fn) const
+{
+    Program prog;
+    prog.depth = compile(root, fn, prog.code);
+    return prog;
+}
+
+unsigned
+MathExpr::compile(const Node *n, IndexCallback &fn,
+                  std::vector<Program::Instr> &code) const
+{
+    if (!n) {
+        // the missing operand of a unary operator
+        code.push_back({sValue, 0, 0});
+        return 1;
+    } else if (n->op == sValue) {
+        code.push_back({sValue, n->value, 0});
+        return 1;
+    } else if (n->op == sVariable) {
+        code.push_back({sVariable, 0, fn(n->variable)});
+        return 1;
+    }
+
+    panic_if(n->op >= sValue, "Invalid node!\n");
+    unsigned l = compile(n->l, fn, code);
+    unsigned r = compile(n->r, fn, code);
+    code.push_back({n->op, 0, 0});
+    return std::max(l, r + 1);
+}
+
+double
+MathExpr::Program::eval(const double *vars) const
+{
+    constexpr unsigned MaxInline = 32;
+    double inline_stack[MaxInline];
+    std::vector<double> heap_stack;
+    double *stack = inline_stack;
+    if (depth > MaxInline) {
+        heap_stack.resize(depth);
+        stack = heap_stack.data();
+    }
+
+    unsigned top = 0;
+    for (const auto &instr : code) {
+        switch (instr.op) {
+          case sValue:
+            stack[top++] = instr.value;
+            continue;
+          case sVariable:
+            stack[top++] = vars[instr.var];
+            continue;
+          default:
+            break;
+        }
+        double b = stack[--top];
+        double &a = stack[top - 1];
+        switch (instr.op) {
+          case bAdd: a = a + b; break;
+          case bSub: a = a - b; break;
+          case bMul: a = a * b; break;
+          case bDiv: a = a / b; break;
+          case bPow: a = std::pow(a, b); break;
+          case uNeg: a = -b; break;
+          default: panic("Invalid instruction!\n");
+        }
+    }
+    return top ? stack[0] : 0;
+}
+
 std::string
 MathExpr::toStr(Node *n, std::string prefix) const {
     std::string ret;
@@ -93,6 +93,57 @@ class MathExpr
         bAdd, bSub, bMul, bDiv, bPow, uNeg, sValue, sVariable, nInvalid
     };
 
+  public:
+    /**
+     * The expression flattened into a program of a stack machine, with
+     * its variables replaced by indices into an array of values. It is
+     * evaluated without walking the tree or looking up the variables by
+     * name.
+     */
+    class Program
+    {
+      public:
+        /**
+         * Evaluate the program
+         *
+         * @param vars Values of the variables, by index
+         *
+         * @return The value for the expression
+         */
+        double eval(const double *vars) const;
+
+        bool empty() const { return code.empty(); }
+
+      private:
+        friend class MathExpr;
+
+        struct Instr
+        {
+            Operator op;
+            // constant of sValue, index of sVariable
+            double value;
+            unsigned var;
+        };
+
+        std::vector<Instr> code;
+
+        /** Deepest stack of the evaluation */
+        unsigned depth = 0;
+    };
+
+    typedef std::function<unsigned(const std::string &)> IndexCallback;
+
+    /**
+     * Compile the expression
+     *
+     * @param fn A callback function giving the index of a variable
+     *
+     * @return The program for this expression
+     */
+    Program compile(IndexCallback fn) const;
+
+  private:
+
     // Match operators
     const int MAX_PRIO = 4;
     typedef double (*binOp)(double, double);
@@ -144,6 +195,10 @@ class MathExpr
     /** Eval a node */
     double eval(const Node *n, EvalCallback fn) const;
 
+    /** Append the program of a node, return its stack depth */
+    unsigned compile(const Node *n, IndexCallback &fn,
+                     std::vector<Program::Instr> &code) const;
+
     /** Return all variable reachable from a node to a vector of
      * strings */
     void getVariables(const Node *n, std::vector<std::string> &vars) const;
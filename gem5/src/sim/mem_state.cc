@@ -32,6 +32,8 @@
 
 #include "arch/generic/mmu.hh"
 #include "debug/Vma.hh"
+#include "mem/page_table.hh"
+#include "mem/physical.hh"
 #include "mem/se_translating_port_proxy.hh"
 #include "sim/process.hh"
 #include "sim/syscall_debug_macros.hh"
@@ -82,6 +84,7 @@ MemState::resetOwner(Process *owner)
 bool
 MemState::isUnmapped(Addr start_addr, Addr length)
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     Addr end_addr = start_addr + length;
     const AddrRange range(start_addr, end_addr);
     for (const auto &vma : _vmaList) {
@@ -107,6 +110,7 @@ MemState::isUnmapped(Addr start_addr, Addr length)
 void
 MemState::updateBrkRegion(Addr old_brk, Addr new_brk)
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     /**
      * To make this simple, avoid reducing the heap memory area if the
      * new_brk point is less than the old_brk; this occurs when the heap is
@@ -167,6 +171,7 @@ void
 MemState::mapRegion(Addr start_addr, Addr length,
                     const std::string& region_name, int sim_fd, Addr offset)
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     DPRINTF(Vma, "memstate: creating vma (%s) [0x%x - 0x%x]\n",
             region_name.c_str(), start_addr, start_addr + length);
 
@@ -186,6 +191,7 @@ MemState::mapRegion(Addr start_addr, Addr length,
 void
 MemState::unmapRegion(Addr start_addr, Addr length)
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     Addr end_addr = start_addr + length;
     const AddrRange range(start_addr, end_addr);
 
@@ -283,6 +289,7 @@ MemState::unmapRegion(Addr start_addr, Addr length)
 void
 MemState::remapRegion(Addr start_addr, Addr new_start_addr, Addr length)
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     Addr end_addr = start_addr + length;
     const AddrRange range(start_addr, end_addr);
 
@@ -386,6 +393,13 @@ MemState::remapRegion(Addr start_addr, Addr new_start_addr, Addr length)
 bool
 MemState::fixupFault(Addr vaddr)
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+
+    // Another thread of the process may have faulted on the page first,
+    // unless the fault is a write to a read-only page.
+    if (auto *pte = _ownerProcess->pTable->lookup(vaddr))
+        return !(pte->flags & EmulationPageTable::ReadOnly);
+
     /**
      * Check if we are accessing a mapped virtual address. If so then we
      * just haven't allocated it a physical page yet and can do so here.
@@ -403,11 +417,20 @@ MemState::fixupFault(Addr vaddr)
              */
             if (vma.hasHostBuf()) {
                 /**
-                 * Write the memory for the host buffer contents for all
-                 * ThreadContexts associated with this process.
+                 * No cache can hold a line of the fresh frame yet, so the
+                 * file can be mapped straight into its host memory. The
+                 * contexts of this process share its page table, so one of
+                 * them is enough to fill the page otherwise.
                  */
-                for (auto &cid : _ownerProcess->contextIds) {
-                    auto *tc = _ownerProcess->system->threads[cid];
+                Addr paddr;
+                uint8_t *host = nullptr;
+                if (_ownerProcess->pTable->translate(vpage_start, paddr)) {
+                    host = _ownerProcess->system->getPhysMem().toHostAddr(
+                            paddr, _pageBytes, true);
+                }
+                if (!vma.mapMemPage(vpage_start, host)) {
+                    auto *tc = _ownerProcess->system->threads[
+                        _ownerProcess->contextIds.front()];
                     SETranslatingPortProxy
                         virt_mem(tc, SETranslatingPortProxy::Always);
                     vma.fillMemPages(vpage_start, _pageBytes, virt_mem);
@@ -451,6 +474,7 @@ MemState::fixupFault(Addr vaddr)
 Addr
 MemState::extendMmap(Addr length)
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     Addr start = _mmapEnd;
 
     if (_ownerProcess->mmapGrowsDown())
@@ -479,6 +503,7 @@ MemState::extendMmap(Addr length)
 std::string
 MemState::printVmaList()
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     std::stringstream file_content;
 
     for (auto vma : _vmaList) {
@@ -31,6 +31,7 @@
 
 #include <list>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -279,6 +280,12 @@ class MemState : public Serializable
      * support this or the unmapping method must be changed.
      */
     std::list<VMA> _vmaList;
+
+    /**
+     * Protects the regions, which the threads of the process fault on
+     * concurrently when their CPUs are simulated on different threads.
+     */
+    std::recursive_mutex mutex;
 };
 
 } // namespace gem5
@@ -0,0 +1,129 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+
+from m5.params import *
+from m5.SimObject import SimObject
+
+# Evaluates a McPAT model of the chip from the gem5 stats at every stats
+# dump. The chip is described by a McPAT XML file whose components are
+# built once, at startup, which is where McPAT spends most of its time. At
+# every dump the stats of the XML components are bound to the activity of
+# the interval since the previous dump (or reset), and only the runtime
+# energy of the components is evaluated again.
+#
+# A binding has the form "<component id>:<stat> = <expression>", where the
+# component id is the "id" attribute of a component of the XML file, and
+# the expression is a math expression of gem5 stats, named by their full
+# path (e.g. "system.cpu.numCycles"). The expression is evaluated on the
+# increase of each stat over the interval, so the stats used should be
+# counts. McPAT keeps its state in globals: a simulation has at most one
+# McPAT object.
+class McPAT(SimObject):
+    type = 'McPAT'
+    cxx_header = "sim/power/mcpat.hh"
+    cxx_class = 'gem5::McPAT'
+
+    config = Param.String("McPAT XML description of the chip")
+    bindings = VectorParam.String([], "McPAT stats bound to gem5 stats, as "
+        "'<component id>:<stat> = <expression>'")
+    opt_for_clk = Param.Bool(True, "Optimize the arrays for the target "
+        "clock rate rather than only for ED^2P")
+
+# Helpers to generate the bindings of common gem5 objects. The component id
+# defaults to the path of the object, which is how the McPAT XML files
+# converted from gem5 configurations name their components.
+
+def system_bindings(cpu, component="system"):
+    """Bind the cycles of a McPAT system to those of its target CPU."""
+    return [ "%s:total_cycles = %s.numCycles" % (component, cpu.path()) ]
+
+def o3_bindings(cpu, component=None):
+    """Bind the stats of a McPAT core to an O3 CPU."""
+    return _bindings(cpu, component, [
+        ("total_instructions", "{p}.numInsts"),
+        ("int_instructions", "{p}.intInstsIssued"),
+        ("fp_instructions", "{p}.floatInstsIssued"),
+        ("branch_instructions", "{p}.branchInstsIssued"),
+        ("branch_mispredictions", "{p}.commit.branchMispredicts"),
+        ("load_instructions", "{p}.numLoadInsts"),
+        ("store_instructions", "{p}.numStoreInsts"),
+        ("committed_instructions", "{p}.commit.instsCommitted"),
+        ("committed_int_instructions", "{p}.commit.integer"),
+        ("committed_fp_instructions", "{p}.commit.floating"),
+        ("total_cycles", "{p}.numCycles"),
+        ("idle_cycles", "{p}.idleCycles"),
+        ("busy_cycles", "{p}.numCycles - {p}.idleCycles"),
+        ("ROB_reads", "{p}.rob.reads"),
+        ("ROB_writes", "{p}.rob.writes"),
+        ("rename_reads", "{p}.rename.intLookups"),
+        ("rename_writes", "{p}.rename.renamedOperands"),
+        ("fp_rename_reads", "{p}.rename.fpLookups"),
+        ("inst_window_reads", "{p}.intInstQueueReads"),
+        ("inst_window_writes", "{p}.intInstQueueWrites"),
+        ("inst_window_wakeup_accesses", "{p}.intInstQueueWakeupAccesses"),
+        ("fp_inst_window_reads", "{p}.fpInstQueueReads"),
+        ("fp_inst_window_writes", "{p}.fpInstQueueWrites"),
+        ("fp_inst_window_wakeup_accesses", "{p}.fpInstQueueWakeupAccesses"),
+        ("int_regfile_reads", "{p}.intRegfileReads"),
+        ("int_regfile_writes", "{p}.intRegfileWrites"),
+        ("float_regfile_reads", "{p}.fpRegfileReads"),
+        ("float_regfile_writes", "{p}.fpRegfileWrites"),
+        ("function_calls", "{p}.commit.functionCalls"),
+        ("ialu_accesses", "{p}.intAluAccesses"),
+        ("fpu_accesses", "{p}.fpAluAccesses"),
+        ("cdb_alu_accesses", "{p}.intAluAccesses"),
+        ("cdb_fpu_accesses", "{p}.fpAluAccesses"),
+    ])
+
+def cache_bindings(cache, component=None):
+    """Bind the stats of a McPAT cache unit to a classic cache."""
+    reads = ("ReadReq", "ReadCleanReq", "ReadSharedReq")
+    writes = ("WriteReq", "WriteLineReq", "ReadExReq")
+    def total(cmds, stat):
+        return " + ".join("{p}.%s.%s" % (cmd, stat) for cmd in cmds)
+    return _bindings(cache, component, [
+        ("read_accesses", total(reads, "accesses")),
+        ("write_accesses", total(writes, "accesses")),
+        ("read_misses", total(reads, "misses")),
+        ("write_misses", total(writes, "misses")),
+        ("conflicts", "{p}.replacements"),
+    ])
+
+def xbar_bindings(xbar, component=None):
+    """Bind the stats of a McPAT bus to a crossbar."""
+    return _bindings(xbar, component, [
+        ("total_accesses", "{p}.transDist"),
+    ])
+
+def mem_ctrl_bindings(ctrl, component=None):
+    """Bind the stats of a McPAT memory controller to a memory
+    controller."""
+    return _bindings(ctrl, component, [
+        ("memory_reads", "{p}.readReqs"),
+        ("memory_writes", "{p}.writeReqs"),
+    ])
+
+def _bindings(obj, component, stats):
+    # Expressions name the stats of the object as {p}.<stat>
+    p = obj.path()
+    return [ "%s:%s = %s" % (component or p, stat, expr.format(p=p))
+             for stat, expr in stats ]
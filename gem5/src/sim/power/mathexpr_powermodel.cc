@@ -41,6 +41,7 @@
 
 #include "base/statistics.hh"
 #include "params/MathExprPowerModel.hh"
+#include "sim/cur_tick.hh"
 #include "sim/mathexpr.hh"
 #include "sim/power/thermal_model.hh"
 #include "sim/sim_object.hh"
@@ -49,37 +50,105 @@ namespace gem5
 {
 
 MathExprPowerModel::MathExprPowerModel(const Params &p)
-    : PowerModelState(p), dyn_expr(p.dyn), st_expr(p.st)
+    : PowerModelState(p), dyn_expr(p.dyn), st_expr(p.st), bound(false),
+      evalTick(MaxTick), dynPower(0), stPower(0)
 {
 }
 
 void
 MathExprPowerModel::startup()
 {
-    for (auto expr: {dyn_expr, st_expr}) {
-        std::vector<std::string> vars = expr.getVariables();
+    bind();
+}
 
-        for (auto var: vars) {
-            // Automatic variables:
-            if (var == "temp" || var == "voltage" || var == "clock_period") {
-                continue;
-            }
+void
+MathExprPowerModel::bind()
+{
+    using namespace statistics;
 
-            auto *info = statistics::resolve(var);
+    std::unordered_map<std::string, unsigned> indices;
+    variables.clear();
+    auto index = [this, &indices](const MathExpr &expr,
+                                  const std::string &var) {
+        auto it = indices.find(var);
+        if (it != indices.end())
+            return it->second;
+
+        Variable v{Variable::Scalar, nullptr, nullptr};
+        // Automatic variables:
+        if (var == "temp") {
+            v.kind = Variable::Temp;
+        } else if (var == "voltage") {
+            v.kind = Variable::Voltage;
+        } else if (var == "clock_period") {
+            v.kind = Variable::ClockPeriod;
+        } else {
+            auto *info = resolve(var);
             fatal_if(!info, "Failed to evaluate %s in expression:\n%s\n",
                      var, expr.toStr());
             statsMap[var] = info;
+
+            // Try to cast the stat, only these are supported right now
+            v.scalar = dynamic_cast<const ScalarInfo *>(info);
+            v.formula = dynamic_cast<const FormulaInfo *>(info);
+            if (v.formula)
+                v.kind = Variable::Formula;
+            else if (!v.scalar)
+                panic("Unknown stat type!\n");
+        }
+
+        variables.push_back(v);
+        return indices[var] = variables.size() - 1;
+    };
+
+    dynProg = dyn_expr.compile([&](const std::string &var) {
+        return index(dyn_expr, var); });
+    stProg = st_expr.compile([&](const std::string &var) {
+        return index(st_expr, var); });
+    values.resize(variables.size());
+    evalTick = MaxTick;
+    bound = true;
+}
+
+void
+MathExprPowerModel::update() const
+{
+    if (bound && evalTick == curTick())
+        return;
+    if (!bound)
+        const_cast<MathExprPowerModel *>(this)->bind();
+
+    for (unsigned i = 0; i < variables.size(); i++) {
+        const Variable &v = variables[i];
+        switch (v.kind) {
+          case Variable::Temp:
+            values[i] = _temp.toCelsius();
+            break;
+          case Variable::Voltage:
+            values[i] = clocked_object->voltage();
+            break;
+          case Variable::ClockPeriod:
+            values[i] = clocked_object->clockPeriod();
+            break;
+          case Variable::Scalar:
+            values[i] = v.scalar->value();
+            break;
+          case Variable::Formula:
+            values[i] = v.formula->total();
+            break;
         }
     }
+
+    dynPower = dynProg.eval(values.data());
+    stPower = stProg.eval(values.data());
+    evalTick = curTick();
 }
 
-double
-MathExprPowerModel::eval(const MathExpr &expr) const
+void
+MathExprPowerModel::setTemperature(Temperature temp)
 {
-    return expr.eval(
-        std::bind(&MathExprPowerModel::getStatValue,
-                  this, std::placeholders::_1)
-        );
+    PowerModelState::setTemperature(temp);
+    evalTick = MaxTick;
 }
 
 double
@@ -117,4 +186,12 @@ MathExprPowerModel::regStats()
     PowerModelState::regStats();
 }
 
+void
+MathExprPowerModel::resetStats()
+{
+    PowerModelState::resetStats();
+    // the stats of the expressions may have been reset too
+    evalTick = MaxTick;
+}
+
 } // namespace gem5
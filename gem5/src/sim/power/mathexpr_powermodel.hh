@@ -39,6 +39,9 @@
 #define __SIM_MATHEXPR_POWERMODEL_PM_HH__
 
 #include <unordered_map>
+#include <vector>
+
+#include "base/types.hh"
 
 #include "params/MathExprPowerModel.hh"
 #include "sim/mathexpr.hh"
@@ -51,6 +54,8 @@ GEM5_DEPRECATED_NAMESPACE(Stats, statistics);
 namespace statistics
 {
     class Info;
+    class ScalarInfo;
+    class FormulaInfo;
 }
 
 /**
@@ -69,14 +74,24 @@ class MathExprPowerModel : public PowerModelState
      *
      * @return Power (Watts) consumed by this object (dynamic component)
      */
-    double getDynamicPower() const override { return eval(dyn_expr); }
+    double
+    getDynamicPower() const override
+    {
+        update();
+        return dynPower;
+    }
 
     /**
      * Get the static power consumption.
      *
      * @return Power (Watts) consumed by this object (static component)
      */
-    double getStaticPower() const override { return eval(st_expr); }
+    double
+    getStaticPower() const override
+    {
+        update();
+        return stPower;
+    }
 
     /**
      * Get the value for a variable (maps to a stat)
@@ -87,24 +102,52 @@ class MathExprPowerModel : public PowerModelState
      */
     double getStatValue(const std::string & name) const;
 
+    void setTemperature(Temperature temp) override;
+
     void startup() override;
     void regStats() override;
+    void resetStats() override;
 
   private:
+    /** A variable of the expressions, read once per evaluation */
+    struct Variable
+    {
+        enum Kind { Temp, Voltage, ClockPeriod, Scalar, Formula };
+        Kind kind;
+        const statistics::ScalarInfo *scalar;
+        const statistics::FormulaInfo *formula;
+    };
+
     /**
-     * Evaluate an expression in the context of this object, fatal if
-     * evaluation fails.
-     *
-     * @param expr Expression to evaluate
-     * @return Value of expression.
+     * Resolve the variables of the expressions, and compile them into
+     * programs reading the variables by index.
+     */
+    void bind();
+
+    /**
+     * Evaluate the dynamic and static power together, once per tick:
+     * the stats and the power do not change as long as the tick and the
+     * temperature do not.
      */
-    double eval(const MathExpr &expr) const;
+    void update() const;
 
     // Math expressions for dynamic and static power
     MathExpr dyn_expr, st_expr;
 
+    // Compiled expressions
+    MathExpr::Program dynProg, stProg;
+    bool bound;
+
     // Map that contains relevant stats for this power model
     std::unordered_map<std::string, const statistics::Info*> statsMap;
+
+    // Variables of both expressions, and their values
+    std::vector<Variable> variables;
+    mutable std::vector<double> values;
+
+    // Power at the last evaluation
+    mutable Tick evalTick;
+    mutable double dynPower, stPower;
 };
 
 } // namespace gem5
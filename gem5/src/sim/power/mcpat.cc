@@ -0,0 +1,289 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/power/mcpat.hh"
+
+#include <cstring>
+#include <unordered_map>
+
+#include "base/cprintf.hh"
+#include "base/logging.hh"
+#include "base/str.hh"
+#include "sim/cur_tick.hh"
+
+// McPAT's headers are included last, as they define macros and pull the
+// std namespace in
+#include "mcpat/system.h"
+#include "mcpat/xmlParser.h"
+
+namespace gem5
+{
+
+bool McPAT::instantiated = false;
+
+McPAT::McPAT(const Params &p)
+    : SimObject(p), config(p.config), bindingStrs(p.bindings),
+      intervalStart(0), stats(*this)
+{
+    fatal_if(instantiated, "%s: McPAT keeps its state in globals, only one "
+             "McPAT object can be instantiated.", name());
+    instantiated = true;
+
+    ::McPATComponent::opt_for_clk = p.opt_for_clk;
+}
+
+McPAT::~McPAT()
+{
+}
+
+void
+McPAT::init()
+{
+    SimObject::init();
+
+    xml.reset(new XMLNode(XMLNode::openFileHelper(config.c_str(),
+                                                  "component")));
+    fatal_if(xml->nChildNode("component") != 1,
+             "%s: %s should describe a single system.", name(), config);
+    systemXml.reset(new XMLNode(xml->getChildNode("component")));
+    const char *type = systemXml->getAttribute("type");
+    fatal_if(!type || strcmp(type, "System") != 0,
+             "%s: The top component of %s is not a System.", name(),
+             config);
+
+    // Building the chip runs the CACTI search of all its arrays, which is
+    // the slow part of McPAT, and the area only depends on it
+    chip.reset(new ::System(systemXml.get()));
+    chip->computeArea();
+
+    components.push_back(chip.get());
+    for (auto *child : chip->children)
+        components.push_back(child);
+}
+
+void
+McPAT::startup()
+{
+    SimObject::startup();
+
+    bind();
+    resetInterval();
+    statistics::registerResetCallback([this]() { resetInterval(); });
+}
+
+XMLNode *
+McPAT::findComponent(XMLNode *node, const std::string &id)
+{
+    const char *node_id = node->getAttribute("id");
+    if (node_id && id == node_id)
+        return node;
+
+    const int num_children = node->nChildNode("component");
+    for (int i = 0; i < num_children; i++) {
+        XMLNode *found = findComponent(
+            node->getChildNodePtr("component", &i), id);
+        if (found)
+            return found;
+    }
+    return nullptr;
+}
+
+void
+McPAT::bind()
+{
+    std::unordered_map<std::string, unsigned> indices;
+    auto index = [this, &indices](const std::string &binding,
+                                  const std::string &var) {
+        auto it = indices.find(var);
+        if (it != indices.end())
+            return it->second;
+
+        auto *info = statistics::resolve(var);
+        fatal_if(!info, "%s: Unknown stat %s in binding:\n%s\n", name(),
+                 var, binding);
+
+        // Try to cast the stat, only these are supported right now
+        Variable v;
+        v.scalar = dynamic_cast<const statistics::ScalarInfo *>(info);
+        v.vector = dynamic_cast<const statistics::VectorInfo *>(info);
+        v.vector2d = dynamic_cast<const statistics::Vector2dInfo *>(info);
+        fatal_if(!v.scalar && !v.vector && !v.vector2d,
+                 "%s: Unsupported type of stat %s in binding:\n%s\n",
+                 name(), var, binding);
+
+        variables.push_back(v);
+        return indices[var] = variables.size() - 1;
+    };
+
+    bindings.clear();
+    variables.clear();
+    for (const auto &str : bindingStrs) {
+        // <component id>:<stat> = <expression>
+        const auto eq = str.find('=');
+        const auto colon = str.rfind(':', eq);
+        fatal_if(eq == std::string::npos || colon == std::string::npos,
+                 "%s: Malformed binding, expected '<component id>:<stat> "
+                 "= <expression>':\n%s\n", name(), str);
+
+        std::string id = str.substr(0, colon);
+        std::string stat = str.substr(colon + 1, eq - colon - 1);
+        eat_white(id);
+        eat_white(stat);
+
+        XMLNode *component = findComponent(systemXml.get(), id);
+        fatal_if(!component, "%s: No component %s in %s.", name(), id,
+                 config);
+
+        Binding b{nullptr, {}};
+        const int num_stats = component->nChildNode("stat");
+        for (int i = 0; i < num_stats; i++) {
+            XMLNode *node = component->getChildNodePtr("stat", &i);
+            const char *node_name = node->getAttribute("name");
+            if (node_name && stat == node_name) {
+                b.node = node;
+                break;
+            }
+        }
+        fatal_if(!b.node, "%s: Component %s of %s has no stat %s.", name(),
+                 id, config, stat);
+
+        MathExpr expr(str.substr(eq + 1));
+        b.prog = expr.compile([&](const std::string &var) {
+            return index(str, var); });
+        bindings.push_back(std::move(b));
+    }
+
+    start.resize(variables.size());
+    deltas.resize(variables.size());
+}
+
+double
+McPAT::Variable::value() const
+{
+    if (scalar)
+        return scalar->value();
+    else if (vector)
+        return vector->total();
+    else
+        return vector2d->total();
+}
+
+void
+McPAT::resetInterval()
+{
+    for (unsigned i = 0; i < variables.size(); i++)
+        start[i] = variables[i].value();
+    intervalStart = curTick();
+}
+
+void
+McPAT::preDumpStats()
+{
+    SimObject::preDumpStats();
+
+    // A dump in the same tick as the previous one has nothing to add
+    if (chip && curTick() != intervalStart)
+        evaluate();
+}
+
+void
+McPAT::evaluate()
+{
+    for (unsigned i = 0; i < variables.size(); i++) {
+        const double value = variables[i].value();
+        deltas[i] = value - start[i];
+        start[i] = value;
+    }
+    intervalStart = curTick();
+
+    // McPAT reads its stats from the XML description, so the activity of
+    // the interval is written there before the components read it again
+    for (const auto &b : bindings) {
+        const std::string value =
+            csprintf("%.17g", b.prog.eval(deltas.data()));
+        b.node->updateAttribute(value.c_str(), nullptr, "value");
+    }
+
+    chip->updateStats();
+    chip->computeEnergy();
+
+    const double time = ::McPATComponent::execution_time;
+    for (unsigned i = 0; i < components.size(); i++) {
+        const auto &out = components[i]->output_data;
+        const double leakage =
+            out.subthreshold_leakage_power + out.gate_leakage_power;
+        stats.area[i] = out.area;
+        stats.peakDynamicPower[i] = out.peak_dynamic_power;
+        stats.leakagePower[i] = leakage;
+        stats.dynamicPower[i] =
+            time > 0 ? out.runtime_dynamic_energy / time : 0;
+        stats.energy[i] = out.runtime_dynamic_energy + leakage * time;
+    }
+}
+
+McPAT::McPATStats::McPATStats(McPAT &_mcpat)
+    : statistics::Group(&_mcpat), mcpat(_mcpat),
+      ADD_STAT(area, statistics::units::Unspecified::get(),
+               "Area of the component (mm^2)"),
+      ADD_STAT(peakDynamicPower, statistics::units::Watt::get(),
+               "Peak dynamic power of the component"),
+      ADD_STAT(leakagePower, statistics::units::Watt::get(),
+               "Subthreshold and gate leakage power of the component"),
+      ADD_STAT(dynamicPower, statistics::units::Watt::get(),
+               "Runtime dynamic power of the component over the interval"),
+      ADD_STAT(energy, statistics::units::Joule::get(),
+               "Dynamic and leakage energy of the component over the "
+               "interval")
+{
+}
+
+void
+McPAT::McPATStats::regStats()
+{
+    statistics::Group::regStats();
+
+    const size_t num_components = mcpat.components.size();
+    area.init(num_components);
+    peakDynamicPower.init(num_components);
+    leakagePower.init(num_components);
+    dynamicPower.init(num_components);
+    energy.init(num_components);
+
+    for (unsigned i = 0; i < num_components; i++) {
+        // Components are named after the last part of their id, which is
+        // unique among the children of the chip
+        const char *id_attr =
+            mcpat.components[i]->xml_data->getAttribute("id");
+        std::string id = id_attr ? id_attr : csprintf("component%d", i);
+        id = id.substr(id.rfind('.') + 1);
+        area.subname(i, id);
+        peakDynamicPower.subname(i, id);
+        leakagePower.subname(i, id);
+        dynamicPower.subname(i, id);
+        energy.subname(i, id);
+    }
+}
+
+} // namespace gem5
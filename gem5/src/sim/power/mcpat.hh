@@ -0,0 +1,137 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SIM_POWER_MCPAT_HH__
+#define __SIM_POWER_MCPAT_HH__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "params/McPAT.hh"
+#include "sim/mathexpr.hh"
+#include "sim/sim_object.hh"
+
+// McPAT lives in the global namespace
+class McPATComponent;
+class System;
+struct XMLNode;
+
+namespace gem5
+{
+
+/**
+ * Evaluates a McPAT model of the chip from the activity in the gem5 stats,
+ * and reports the area and power of its components as stats. The model is
+ * built from the McPAT XML description at startup, which runs the CACTI
+ * search of all its arrays, and only its runtime energy is evaluated again
+ * at each stats dump, from the activity of the interval since the previous
+ * dump or reset.
+ */
+class McPAT : public SimObject
+{
+  public:
+    typedef McPATParams Params;
+
+    McPAT(const Params &p);
+    ~McPAT();
+
+    void init() override;
+    void startup() override;
+    void preDumpStats() override;
+
+  private:
+    /** A gem5 stat used by the bindings. */
+    struct Variable
+    {
+        const statistics::ScalarInfo *scalar = nullptr;
+        const statistics::VectorInfo *vector = nullptr;
+        const statistics::Vector2dInfo *vector2d = nullptr;
+
+        double value() const;
+    };
+
+    /** A McPAT stat computed from gem5 stats. */
+    struct Binding
+    {
+        /** The stat node of the McPAT component. */
+        XMLNode *node;
+        MathExpr::Program prog;
+    };
+
+    /** Parse the bindings and find the gem5 stats they use. */
+    void bind();
+
+    /** Take the values of the variables as the start of an interval. */
+    void resetInterval();
+
+    /** Evaluate the McPAT model for the interval up to now. */
+    void evaluate();
+
+    /** The XML node of a McPAT component by id, or null. */
+    static XMLNode *findComponent(XMLNode *node, const std::string &id);
+
+    const std::string config;
+    const std::vector<std::string> bindingStrs;
+
+    std::unique_ptr<XMLNode> xml;
+    std::unique_ptr<XMLNode> systemXml;
+    std::unique_ptr<System> chip;
+
+    /** The chip, then its top level components. */
+    std::vector<McPATComponent *> components;
+
+    std::vector<Binding> bindings;
+    std::vector<Variable> variables;
+    /** Values of the variables at the start of the interval. */
+    std::vector<double> start;
+    /** Increase of the variables over the interval. */
+    std::vector<double> deltas;
+
+    Tick intervalStart;
+
+    /** McPAT keeps its state in globals, so it can only be used once. */
+    static bool instantiated;
+
+    struct McPATStats : public statistics::Group
+    {
+        McPATStats(McPAT &mcpat);
+
+        void regStats() override;
+
+        const McPAT &mcpat;
+
+        statistics::Vector area;
+        statistics::Vector peakDynamicPower;
+        statistics::Vector leakagePower;
+        statistics::Vector dynamicPower;
+        statistics::Vector energy;
+    } stats;
+};
+
+} // namespace gem5
+
+#endif // __SIM_POWER_MCPAT_HH__
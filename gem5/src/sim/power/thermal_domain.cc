@@ -93,4 +93,14 @@ ThermalDomain::getEquation(ThermalNode * tn, unsigned n, double step) const
     return eq;
 }
 
+void
+ThermalDomain::addConstants(const std::vector<ThermalNode *> &nodes,
+                            std::vector<double> &b, double step) const
+{
+    if (!node->isref) {
+        b[node->id] -= subsystem->getDynamicPower() +
+            subsystem->getStaticPower();
+    }
+}
+
 } // namespace gem5
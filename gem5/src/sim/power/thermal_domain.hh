@@ -87,6 +87,13 @@ class ThermalDomain : public SimObject, public ThermalEntity
     LinearEquation getEquation(ThermalNode * tn, unsigned n,
                                double step) const override;
 
+    /** The power of the domain goes into its node */
+    void addCoefficients(const std::vector<ThermalNode *> &nodes,
+                         SparseLinearSystem &a, double step) const override
+    {}
+    void addConstants(const std::vector<ThermalNode *> &nodes,
+                      std::vector<double> &b, double step) const override;
+
     /**
       *  Emit a temperature update through probe points interface
       */
@@ -0,0 +1,57 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/power/thermal_entity.hh"
+
+#include "sim/linear_solver.hh"
+#include "sim/power/thermal_node.hh"
+
+namespace gem5
+{
+
+void
+ThermalEntity::addCoefficients(const std::vector<ThermalNode *> &nodes,
+                               SparseLinearSystem &a, double step) const
+{
+    for (auto n : nodes) {
+        LinearEquation eq = getEquation(n, nodes.size(), step);
+        for (unsigned i = 0; i < eq.cnt(); i++) {
+            if (eq[i] != 0.0)
+                a.add(n->id, i, eq[i]);
+        }
+    }
+}
+
+void
+ThermalEntity::addConstants(const std::vector<ThermalNode *> &nodes,
+                            std::vector<double> &b, double step) const
+{
+    for (auto n : nodes) {
+        LinearEquation eq = getEquation(n, nodes.size(), step);
+        b[n->id] -= eq[eq.cnt()];
+    }
+}
+
+} // namespace gem5
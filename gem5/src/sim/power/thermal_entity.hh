@@ -38,12 +38,15 @@
 #ifndef __SIM_THERMAL_ENTITY_HH__
 #define __SIM_THERMAL_ENTITY_HH__
 
+#include <vector>
+
 #include "sim/sim_object.hh"
 
 namespace gem5
 {
 
 class LinearEquation;
+class SparseLinearSystem;
 class ThermalNode;
 
 /**
@@ -57,6 +60,19 @@ class ThermalEntity
     // Get the equation given a node and a step in seconds (assuming N nodes)
     virtual LinearEquation getEquation(ThermalNode *tn, unsigned n,
                                        double step) const = 0;
+
+    /**
+     * Add the contribution of the entity to the nodal equations A * x = b
+     * of the given unknown nodes, numbered by their id: to the
+     * coefficients of A, which only depend on the topology and the step,
+     * and to b, which is computed again at every step. Both default to
+     * the equations of getEquation, which is quadratic in the number of
+     * nodes, entities should only add to the rows of their own nodes.
+     */
+    virtual void addCoefficients(const std::vector<ThermalNode *> &nodes,
+                                 SparseLinearSystem &a, double step) const;
+    virtual void addConstants(const std::vector<ThermalNode *> &nodes,
+                              std::vector<double> &b, double step) const;
 };
 
 } // namespace gem5
@@ -37,6 +37,9 @@
 
 #include "sim/power/thermal_model.hh"
 
+#include <utility>
+
+#include "base/logging.hh"
 #include "base/statistics.hh"
 #include "params/ThermalCapacitor.hh"
 #include "params/ThermalModel.hh"
@@ -50,6 +53,38 @@
 namespace gem5
 {
 
+namespace
+{
+
+/**
+ * Add the coefficients of a conductance g between n1 and n2 to the
+ * nodal equations of the nodes which are not references.
+ */
+void
+addBranch(ThermalNode *n1, ThermalNode *n2, double g, SparseLinearSystem &a)
+{
+    for (auto [n, other] : {std::pair{n1, n2}, std::pair{n2, n1}}) {
+        if (n->isref)
+            continue;
+        a.add(n->id, n->id, -g);
+        if (!other->isref)
+            a.add(n->id, other->id, g);
+    }
+}
+
+/** Add the current flowing through g from a reference to the other node */
+void
+addReferenceCurrent(ThermalNode *n1, ThermalNode *n2, double g,
+                    std::vector<double> &b)
+{
+    for (auto [n, other] : {std::pair{n1, n2}, std::pair{n2, n1}}) {
+        if (!n->isref && other->isref)
+            b[n->id] -= g * other->temp.toKelvin();
+    }
+}
+
+} // anonymous namespace
+
 /**
  * ThermalReference
  */
@@ -100,6 +135,20 @@ ThermalResistor::getEquation(ThermalNode * n, unsigned nnodes,
     return eq;
 }
 
+void
+ThermalResistor::addCoefficients(const std::vector<ThermalNode *> &nodes,
+                                 SparseLinearSystem &a, double step) const
+{
+    addBranch(node1, node2, 1.0 / _resistance, a);
+}
+
+void
+ThermalResistor::addConstants(const std::vector<ThermalNode *> &nodes,
+                              std::vector<double> &b, double step) const
+{
+    addReferenceCurrent(node1, node2, 1.0 / _resistance, b);
+}
+
 /**
  * ThermalCapacitor
  */
@@ -139,32 +188,51 @@ ThermalCapacitor::getEquation(ThermalNode * n, unsigned nnodes,
     return eq;
 }
 
+void
+ThermalCapacitor::addCoefficients(const std::vector<ThermalNode *> &nodes,
+                                  SparseLinearSystem &a, double step) const
+{
+    addBranch(node1, node2, _capacitance / step, a);
+}
+
+void
+ThermalCapacitor::addConstants(const std::vector<ThermalNode *> &nodes,
+                               std::vector<double> &b, double step) const
+{
+    // The current of the previous step
+    double g = _capacitance / step;
+    double prev = g * (node1->temp - node2->temp).toKelvin();
+    if (!node1->isref)
+        b[node1->id] -= prev;
+    if (!node2->isref)
+        b[node2->id] += prev;
+    addReferenceCurrent(node1, node2, g, b);
+}
+
 /**
  * ThermalModel
  */
 ThermalModel::ThermalModel(const Params &p)
-    : ClockedObject(p), stepEvent([this]{ doStep(); }, name()), _step(p.step)
+    : ClockedObject(p), topologyChanged(true),
+      stepEvent([this]{ doStep(); }, name()), _step(p.step)
 {
 }
 
 void
 ThermalModel::doStep()
 {
+    if (topologyChanged)
+        buildSystem();
+
     // Calculate new temperatures!
-    // For each node in the system, create the kirchhoff nodal equation
-    LinearSystem ls(eq_nodes.size());
-    for (unsigned i = 0; i < eq_nodes.size(); i++) {
-        auto n = eq_nodes[i];
-        LinearEquation node_equation (eq_nodes.size());
-        for (auto e : entities) {
-            LinearEquation eq = e->getEquation(n, eq_nodes.size(), _step);
-            node_equation = node_equation + eq;
-        }
-        ls[i] = node_equation;
-    }
+    // The kirchhoff nodal equations only change in their constant terms,
+    // the power of the domains and the temperatures of the previous step
+    std::vector <double> b(eq_nodes.size(), 0.0);
+    for (auto e : entities)
+        e->addConstants(eq_nodes, b, _step);
 
     // Get temperatures for this iteration
-    std::vector <double> temps = ls.solve();
+    std::vector <double> temps = system->solve(b);
     for (unsigned i = 0; i < eq_nodes.size(); i++)
         eq_nodes[i]->temp = Temperature::fromKelvin(temps[i]);
 
@@ -177,7 +245,7 @@ ThermalModel::doStep()
 }
 
 void
-ThermalModel::startup()
+ThermalModel::buildSystem()
 {
     // Look for nodes connected to voltage references, these
     // can be just set to the reference value (no nodal equation)
@@ -185,11 +253,9 @@ ThermalModel::startup()
         ref->node->temp = ref->_temperature;
         ref->node->isref = true;
     }
-    // Setup the initial temperatures
-    for (auto dom : domains)
-        dom->getNode()->temp = dom->initialTemperature();
 
     // Create a list of unknown temperature nodes
+    eq_nodes.clear();
     for (auto n : nodes) {
         bool found = false;
         for (auto ref : references)
@@ -205,6 +271,32 @@ ThermalModel::startup()
     for (unsigned i = 0; i < eq_nodes.size(); i++)
         eq_nodes[i]->id = i;
 
+    // For each node in the system, create the kirchhoff nodal equation
+    system = std::make_unique<SparseLinearSystem>(eq_nodes.size());
+    for (auto e : entities)
+        e->addCoefficients(eq_nodes, *system, _step);
+    system->factor();
+    if (!system->isBanded())
+        warn("%s: the thermal network cannot be factored, it will be "
+             "solved by Gaussian elimination at every step\n", name());
+
+    topologyChanged = false;
+}
+
+void
+ThermalModel::startup()
+{
+    // Set the references before the initial temperatures of the domains
+    for (auto ref : references) {
+        ref->node->temp = ref->_temperature;
+        ref->node->isref = true;
+    }
+    // Setup the initial temperatures
+    for (auto dom : domains)
+        dom->getNode()->temp = dom->initialTemperature();
+
+    buildSystem();
+
     // Schedule first thermal update
     schedule(stepEvent, curTick() + sim_clock::as_int::s * _step);
 }
@@ -214,6 +306,7 @@ ThermalModel::addDomain(ThermalDomain * d)
 {
     domains.push_back(d);
     entities.push_back(d);
+    topologyChanged = true;
 }
 
 void
@@ -221,6 +314,7 @@ ThermalModel::addReference(ThermalReference * r)
 {
     references.push_back(r);
     entities.push_back(r);
+    topologyChanged = true;
 }
 
 void
@@ -228,6 +322,7 @@ ThermalModel::addCapacitor(ThermalCapacitor * c)
 {
     capacitors.push_back(c);
     entities.push_back(c);
+    topologyChanged = true;
 }
 
 void
@@ -235,6 +330,7 @@ ThermalModel::addResistor(ThermalResistor * r)
 {
     resistors.push_back(r);
     entities.push_back(r);
+    topologyChanged = true;
 }
 
 Temperature
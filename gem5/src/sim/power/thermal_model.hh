@@ -38,10 +38,12 @@
 #ifndef __SIM_THERMAL_MODEL_HH__
 #define __SIM_THERMAL_MODEL_HH__
 
+#include <memory>
 #include <vector>
 
 #include "base/temperature.hh"
 #include "sim/clocked_object.hh"
+#include "sim/linear_solver.hh"
 #include "sim/power/thermal_domain.hh"
 #include "sim/power/thermal_entity.hh"
 #include "sim/power/thermal_node.hh"
@@ -74,6 +76,11 @@ class ThermalResistor : public SimObject, public ThermalEntity
     LinearEquation getEquation(ThermalNode * tn, unsigned n,
                                double step) const override;
 
+    void addCoefficients(const std::vector<ThermalNode *> &nodes,
+                         SparseLinearSystem &a, double step) const override;
+    void addConstants(const std::vector<ThermalNode *> &nodes,
+                      std::vector<double> &b, double step) const override;
+
   private:
     /* Resistance value in K/W */
     const double _resistance;
@@ -95,6 +102,11 @@ class ThermalCapacitor : public SimObject, public ThermalEntity
     LinearEquation getEquation(ThermalNode * tn, unsigned n,
                                double step) const override;
 
+    void addCoefficients(const std::vector<ThermalNode *> &nodes,
+                         SparseLinearSystem &a, double step) const override;
+    void addConstants(const std::vector<ThermalNode *> &nodes,
+                      std::vector<double> &b, double step) const override;
+
     void setNodes(ThermalNode * n1, ThermalNode * n2) {
         node1 = n1;
         node2 = n2;
@@ -126,6 +138,14 @@ class ThermalReference : public SimObject, public ThermalEntity
     LinearEquation getEquation(ThermalNode * tn, unsigned n,
                                double step) const override;
 
+    /** A reference has no nodal equation */
+    void addCoefficients(const std::vector<ThermalNode *> &nodes,
+                         SparseLinearSystem &a, double step) const override
+    {}
+    void addConstants(const std::vector<ThermalNode *> &nodes,
+                      std::vector<double> &b, double step) const override
+    {}
+
     /* Fixed temperature value */
     const Temperature _temperature;
     /* Nodes connected to the resistor */
@@ -152,7 +172,12 @@ class ThermalModel : public ClockedObject
     void addCapacitor(ThermalCapacitor * c);
     void addResistor(ThermalResistor * r);
 
-    void addNode(ThermalNode * n) { nodes.push_back(n); }
+    void
+    addNode(ThermalNode * n)
+    {
+        nodes.push_back(n);
+        topologyChanged = true;
+    }
 
     Temperature getTemperature() const;
 
@@ -160,6 +185,11 @@ class ThermalModel : public ClockedObject
     void doStep();
 
   private:
+    /**
+     * Number the unknown temperature nodes and factor the matrix of
+     * their nodal equations, which only changes with the topology.
+     */
+    void buildSystem();
 
     /* Keep track of all components used for the thermal model */
     std::vector <ThermalDomain *> domains;
@@ -173,6 +203,10 @@ class ThermalModel : public ClockedObject
     std::vector <ThermalNode*> nodes;
     std::vector <ThermalNode*> eq_nodes;
 
+    /** Nodal equations of eq_nodes, factored once */
+    std::unique_ptr<SparseLinearSystem> system;
+    bool topologyChanged;
+
     /** Stepping event to update the model values */
     EventFunctionWrapper stepEvent;
 
@@ -116,6 +116,7 @@ Process::Process(const ProcessParams &params, EmulationPageTable *pTable,
       seWorkload(dynamic_cast<SEWorkload *>(system->workload)),
       useArchPT(params.useArchPT),
       kvmInSE(params.kvmInSE),
+      directSyscallCopies(params.directSyscallCopies),
       useForClone(false),
       pTable(pTable),
       objFile(obj_file),
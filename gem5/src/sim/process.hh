@@ -179,6 +179,8 @@ class Process : public SimObject
     bool useArchPT;
     // running KVM requires special initialization
     bool kvmInSE;
+    // copy syscall buffers with memcpy, see SETranslatingPortProxy
+    bool directSyscallCopies;
     // flag for using the process as a thread which shares page tables
     bool useForClone;
 
@@ -0,0 +1,128 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/quantum_controller.hh"
+
+#include <algorithm>
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/SimQuantum.hh"
+#include "sim/eventq.hh"
+
+namespace gem5
+{
+
+QuantumController *quantumController = nullptr;
+
+QuantumController::QuantumController(statistics::Group *parent,
+                                     Tick min_quantum, Tick max_quantum,
+                                     uint64_t cross_limit,
+                                     double wait_limit)
+    : statistics::Group(parent, "simQuantum"),
+      minQuantum(min_quantum), maxQuantum(max_quantum),
+      crossLimit(cross_limit), waitLimit(wait_limit),
+      barrierWaitNs(0), synced(false),
+      ADD_STAT(quantum, statistics::units::Tick::get(),
+               "Current simulation quantum"),
+      ADD_STAT(syncs, statistics::units::Count::get(),
+               "Number of quantum barriers"),
+      ADD_STAT(barrierWait, statistics::units::Second::get(),
+               "Host time the threads spent waiting in quantum barriers"),
+      ADD_STAT(crossQueueEvents, statistics::units::Count::get(),
+               "Events scheduled on the queue of another thread"),
+      ADD_STAT(migrations, statistics::units::Count::get(),
+               "Accesses done by migrating to the queue of another thread"),
+      ADD_STAT(lateEvents, statistics::units::Count::get(),
+               "Events from other threads that arrived after their tick"),
+      ADD_STAT(grows, statistics::units::Count::get(),
+               "Number of times the quantum grew"),
+      ADD_STAT(shrinks, statistics::units::Count::get(),
+               "Number of times the quantum shrank")
+{
+    fatal_if(min_quantum > max_quantum,
+             "The minimum simulation quantum (%llu) is larger than the "
+             "maximum (%llu).\n", min_quantum, max_quantum);
+
+    quantum.scalar(simQuantum);
+    barrierWait.precision(6);
+}
+
+Tick
+QuantumController::nextQuantum(Tick cur_quantum)
+{
+    // the other threads are blocked in the barrier, so the queues can
+    // be looked at
+    EventQueue::SyncCounters total = { 0, 0, 0 };
+    for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+        EventQueue::SyncCounters c = mainEventQueue[i]->takeSyncCounters();
+        total.crossQueueEvents += c.crossQueueEvents;
+        total.migrations += c.migrations;
+        total.lateEvents += c.lateEvents;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    const double host_seconds =
+        std::chrono::duration<double>(now - lastSync).count();
+    const bool measured = synced;
+    lastSync = now;
+    synced = true;
+    const double wait_seconds = barrierWaitNs.exchange(0) * 1e-9;
+
+    ++syncs;
+    barrierWait += wait_seconds;
+    crossQueueEvents += total.crossQueueEvents;
+    migrations += total.migrations;
+    lateEvents += total.lateEvents;
+
+    const uint64_t traffic = total.crossQueueEvents + total.migrations;
+    Tick next = cur_quantum;
+    if (total.lateEvents || traffic > crossLimit) {
+        next = std::max(minQuantum, cur_quantum / 2);
+        warn_if_once(total.lateEvents && next == cur_quantum,
+                     "Events crossing event queues arrived after their "
+                     "tick with a %llu tick simulation quantum, timing "
+                     "may be inaccurate.\n", cur_quantum);
+    } else if (measured && traffic <= crossLimit / 2 && host_seconds > 0 &&
+               wait_seconds / (host_seconds * numMainEventQueues) >
+               waitLimit) {
+        next = std::min(maxQuantum, cur_quantum * 2);
+    }
+
+    if (next < cur_quantum)
+        ++shrinks;
+    else if (next > cur_quantum)
+        ++grows;
+
+    DPRINTF(SimQuantum, "%llu events, %llu migrations, %llu late, "
+            "%.6fs of %.6fs waiting: quantum %llu -> %llu\n",
+            total.crossQueueEvents, total.migrations, total.lateEvents,
+            wait_seconds, host_seconds, cur_quantum, next);
+
+    simQuantum = next;
+    return next;
+}
+
+} // namespace gem5
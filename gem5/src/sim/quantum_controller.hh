@@ -0,0 +1,124 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SIM_QUANTUM_CONTROLLER_HH__
+#define __SIM_QUANTUM_CONTROLLER_HH__
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+
+/**
+ * Chooses the simulation quantum of multi-queue simulations. At every
+ * quantum barrier, the controller looks at how much the event queues
+ * interacted during the last quantum and at how long the threads waited
+ * in the barriers.
+ *
+ * A quantum bounds the error of the interaction between threads: an
+ * event scheduled on another queue, or an access done by migrating to
+ * it, sees that queue up to one quantum away from the current tick.
+ * The quantum is therefore halved when the queues exchanged more events
+ * than the configured limit, or when an event scheduled on another
+ * queue arrived too late. It is doubled when the queues hardly
+ * interacted but the threads spent more than the configured fraction
+ * of the host time waiting in barriers. The quantum always stays
+ * within the configured bounds.
+ */
+class QuantumController : public statistics::Group
+{
+  public:
+    /**
+     * @param parent statistics parent
+     * @param min_quantum smallest quantum the controller picks
+     * @param max_quantum largest quantum the controller picks
+     * @param cross_limit events exchanged per quantum above which the
+     *                    quantum shrinks
+     * @param wait_limit fraction of the host time spent in barriers
+     *                   above which the quantum grows
+     */
+    QuantumController(statistics::Group *parent, Tick min_quantum,
+                      Tick max_quantum, uint64_t cross_limit,
+                      double wait_limit);
+
+    /** Smallest quantum the simulation can run with. */
+    Tick minSimQuantum() const { return minQuantum; }
+
+    /** Largest quantum the simulation can run with. */
+    Tick maxSimQuantum() const { return maxQuantum; }
+
+    /**
+     * Account for the host time a thread spent in a quantum barrier.
+     * Called by every thread, the time shows up at the next barrier.
+     */
+    void
+    barrierWaited(std::chrono::nanoseconds wait)
+    {
+        barrierWaitNs += wait.count();
+    }
+
+    /**
+     * Choose the length of the next quantum. Called at every quantum
+     * barrier by a single thread while the others wait.
+     *
+     * @param quantum the current quantum
+     * @return the next quantum
+     */
+    Tick nextQuantum(Tick quantum);
+
+  private:
+    const Tick minQuantum;
+    const Tick maxQuantum;
+    const uint64_t crossLimit;
+    const double waitLimit;
+
+    /** Barrier wait of all threads since the last barrier. */
+    std::atomic<uint64_t> barrierWaitNs;
+
+    /** Host time of the last barrier. */
+    std::chrono::steady_clock::time_point lastSync;
+    bool synced;
+
+    statistics::Value quantum;
+    statistics::Scalar syncs;
+    statistics::Scalar barrierWait;
+    statistics::Scalar crossQueueEvents;
+    statistics::Scalar migrations;
+    statistics::Scalar lateEvents;
+    statistics::Scalar grows;
+    statistics::Scalar shrinks;
+};
+
+/** Controller of the running simulation, if any. */
+extern QuantumController *quantumController;
+
+} // namespace gem5
+
+#endif // __SIM_QUANTUM_CONTROLLER_HH__
@@ -47,6 +47,7 @@
 #include "sim/cur_tick.hh"
 #include "sim/eventq.hh"
 #include "sim/full_system.hh"
+#include "sim/host_profile.hh"
 #include "sim/root.hh"
 
 namespace gem5
@@ -177,7 +178,14 @@ Root::timeSyncSpinThreshold(Time newThreshold)
 
 Root::Root(const RootParams &p, int)
     : SimObject(p), _enabled(false), _periodTick(p.time_sync_period),
-      syncEvent([this]{ timeSync(); }, name())
+      syncEvent([this]{ timeSync(); }, name()),
+      _quantumController(this,
+                         p.sim_quantum_min ? p.sim_quantum_min :
+                                             p.sim_quantum,
+                         p.sim_quantum_max ? p.sim_quantum_max :
+                                             p.sim_quantum,
+                         p.sim_quantum_cross_limit,
+                         p.sim_quantum_wait_limit)
 {
     _period.setTick(p.time_sync_period);
     _spinThreshold.setTick(p.time_sync_spin_threshold);
@@ -187,6 +195,11 @@ Root::Root(const RootParams &p, int)
     lastTime.setTimer();
 
     simQuantum = p.sim_quantum;
+    fatal_if(simQuantum < _quantumController.minSimQuantum() ||
+             simQuantum > _quantumController.maxSimQuantum(),
+             "The simulation quantum (%llu) is outside its bounds.\n",
+             simQuantum);
+    quantumController = &_quantumController;
 
     // Some of the statistics are global and need to be accessed by
     // stat formulas. The most convenient way to implement that is by
@@ -199,6 +212,8 @@ void
 Root::startup()
 {
     timeSyncEnable(params().time_sync_enable);
+    if (params().host_profile_period)
+        enableHostProfile(params().host_profile_period);
 }
 
 void
@@ -57,6 +57,7 @@
 #include "params/Root.hh"
 #include "sim/eventq.hh"
 #include "sim/globals.hh"
+#include "sim/quantum_controller.hh"
 #include "sim/sim_object.hh"
 
 namespace gem5
@@ -80,6 +81,9 @@ class Root : public SimObject
     void timeSync();
     EventFunctionWrapper syncEvent;
 
+    /// Picks the simulation quantum of multi-queue simulations.
+    QuantumController _quantumController;
+
   public:
     /**
      * Use this function to get a pointer to the single Root object in the
@@ -29,6 +29,7 @@
 
 #include "cpu/thread_context.hh"
 #include "params/SEWorkload.hh"
+#include "sim/eventq.hh"
 #include "sim/process.hh"
 #include "sim/system.hh"
 
@@ -56,12 +57,20 @@ SEWorkload::setSystem(System *sys)
 void
 SEWorkload::syscall(ThreadContext *tc)
 {
+    // Don't hold our event queue while waiting for another thread's
+    // syscall, which may have to migrate to it.
+    std::unique_lock<std::mutex> lock(syscallMutex, std::defer_lock);
+    {
+        EventQueue::ScopedRelease release(curEventQueue());
+        lock.lock();
+    }
     tc->getProcessPtr()->syscall(tc);
 }
 
 Addr
 SEWorkload::allocPhysPages(int npages, int pool_id)
 {
+    std::lock_guard<std::mutex> lock(memPoolsMutex);
     return memPools.allocPhysPages(npages, pool_id);
 }
 
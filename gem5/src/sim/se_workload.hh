@@ -28,6 +28,8 @@
 #ifndef __SIM_SE_WORKLOAD_HH__
 #define __SIM_SE_WORKLOAD_HH__
 
+#include <mutex>
+
 #include "params/SEWorkload.hh"
 #include "sim/mem_pool.hh"
 #include "sim/workload.hh"
@@ -41,6 +43,19 @@ class SEWorkload : public Workload
     /** Memory allocation objects for all physical memories in the system. */
     MemPools memPools;
 
+    /**
+     * CPUs simulated on different threads can allocate pages at the
+     * same time.
+     */
+    std::mutex memPoolsMutex;
+
+    /**
+     * Syscalls of CPUs simulated on different threads are emulated one
+     * at a time, since they share the state of the processes and of the
+     * futexes.
+     */
+    std::mutex syscallMutex;
+
   public:
     using Params = SEWorkloadParams;
 
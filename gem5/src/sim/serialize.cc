@@ -100,6 +100,17 @@ Serializable::generateCheckpointOut(const std::string &cpt_dir,
     outstream << "## checkpoint generated: " << ctime(&t);
 }
 
+std::unique_ptr<BinaryCheckpointOut>
+Serializable::generateBinaryCheckpointOut(const std::string &cpt_dir)
+{
+    std::string dir = CheckpointIn::setDir(cpt_dir);
+    if (mkdir(dir.c_str(), 0775) == -1 && errno != EEXIST)
+            fatal("couldn't mkdir %s\n", dir);
+
+    return std::make_unique<BinaryCheckpointOut>(
+        dir + CheckpointIn::binaryFilename);
+}
+
 Serializable::ScopedCheckpointSection::~ScopedCheckpointSection()
 {
     assert(!path.empty());
@@ -135,6 +146,7 @@ Serializable::currentSection()
 }
 
 const char *CheckpointIn::baseFilename = "m5.cpt";
+const char *CheckpointIn::binaryFilename = "m5.bcpt";
 
 std::string CheckpointIn::currentDirectory;
 
@@ -159,6 +171,10 @@ CheckpointIn::dir()
 CheckpointIn::CheckpointIn(const std::string &cpt_dir)
     : db(), _cptDir(setDir(cpt_dir))
 {
+    binary = binaryDb.load(getCptDir() + "/" + CheckpointIn::binaryFilename);
+    if (binary)
+        return;
+
     std::string filename = getCptDir() + "/" + CheckpointIn::baseFilename;
     if (!db.load(filename)) {
         fatal("Can't load checkpoint file '%s'\n", filename);
@@ -177,7 +193,8 @@ CheckpointIn::CheckpointIn(const std::string &cpt_dir)
 bool
 CheckpointIn::entryExists(const std::string &section, const std::string &entry)
 {
-    return db.entryExists(section, entry);
+    return binary ? binaryDb.entryExists(section, entry) :
+        db.entryExists(section, entry);
 }
 /**
  * @param section Here we mention the section we are looking for
@@ -193,20 +210,35 @@ bool
 CheckpointIn::find(const std::string &section, const std::string &entry,
         std::string &value)
 {
-    return db.find(section, entry, value);
+    return binary ? binaryDb.find(section, entry, value) :
+        db.find(section, entry, value);
 }
 
 bool
 CheckpointIn::sectionExists(const std::string &section)
 {
-    return db.sectionExists(section);
+    return binary ? binaryDb.sectionExists(section) :
+        db.sectionExists(section);
 }
 
 void
 CheckpointIn::visitSection(const std::string &section,
     IniFile::VisitSectionCallback cb)
 {
-    db.visitSection(section, cb);
+    if (binary)
+        binaryDb.visitSection(section, cb);
+    else
+        db.visitSection(section, cb);
+}
+
+const BinaryCheckpoint::Entry *
+CheckpointIn::findArray(const std::string &section, const std::string &entry)
+{
+    if (!binary)
+        return nullptr;
+    const BinaryCheckpoint::Entry *found = binaryDb.find(section, entry);
+    return found && found->type != BinaryCheckpoint::Type::Text ?
+        found : nullptr;
 }
 
 } // namespace gem5
@@ -47,9 +47,11 @@
 
 
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <memory>
 #include <stack>
 #include <string>
 #include <type_traits>
@@ -58,6 +60,7 @@
 
 #include "base/inifile.hh"
 #include "base/logging.hh"
+#include "sim/binary_checkpoint.hh"
 #include "sim/serialize_handlers.hh"
 
 namespace gem5
@@ -69,6 +72,9 @@ class CheckpointIn
 {
   private:
     IniFile db;
+    /** The binary container, used instead of db if there is one. */
+    BinaryCheckpoint binaryDb;
+    bool binary;
 
     const std::string _cptDir;
 
@@ -93,6 +99,15 @@ class CheckpointIn
         IniFile::VisitSectionCallback cb);
     /** @}*/ //end of api_checkout group
 
+    /**
+     * Find an array blob of a binary checkpoint.
+     *
+     * @return nullptr if the entry isn't an array blob, e.g. because the
+     * checkpoint is in the INI form.
+     */
+    const BinaryCheckpoint::Entry *findArray(const std::string &section,
+                                             const std::string &entry);
+
     // The following static functions have to do with checkpoint
     // creation rather than restoration.  This class makes a handy
     // namespace for them though.  Currently no Checkpoint object is
@@ -130,6 +145,8 @@ class CheckpointIn
 
     // Filename for base checkpoint file within directory.
     static const char *baseFilename;
+    // Filename for the binary container used instead of it.
+    static const char *binaryFilename;
 };
 
 /**
@@ -311,6 +328,16 @@ class Serializable
     static void generateCheckpointOut(const std::string &cpt_dir,
         std::ofstream &outstream);
 
+    /**
+     * Generate a binary checkpoint container (@see BinaryCheckpointOut)
+     * so that the serialization can be routed to it.
+     *
+     * @param cpt_dir The dir at which the container will be created.
+     * @ingroup api_serialize
+     */
+    static std::unique_ptr<BinaryCheckpointOut>
+    generateBinaryCheckpointOut(const std::string &cpt_dir);
+
   private:
     static std::stack<std::string> path;
 };
@@ -388,9 +415,23 @@ void
 arrayParamOut(CheckpointOut &os, const std::string &name,
               InputIterator start, InputIterator end)
 {
-    os << name << "=";
     auto it = start;
     using Elem = std::remove_cv_t<std::remove_reference_t<decltype(*it)>>;
+    if constexpr (BinaryCheckpoint::typeOf<Elem>() !=
+                  BinaryCheckpoint::Type::Text) {
+        // numbers go into binary containers as an array blob
+        if (auto *bcp = BinaryCheckpointOut::get(os)) {
+            if constexpr (std::is_pointer_v<InputIterator>) {
+                bcp->arrayOut(name, start, end - start);
+            } else {
+                std::vector<Elem> values(start, end);
+                bcp->arrayOut(name, values.data(), values.size());
+            }
+            return;
+        }
+    }
+
+    os << name << "=";
     if (it != end)
         ShowParam<Elem>::show(os, *it++);
     while (it != end) {
@@ -442,6 +483,20 @@ arrayParamIn(CheckpointIn &cp, const std::string &name,
              InsertIterator inserter, ssize_t fixed_size=-1)
 {
     const std::string &section = Serializable::currentSection();
+    if (const auto *array = cp.findArray(section, name)) {
+        fatal_if(fixed_size >= 0 && array->count != (uint64_t)fixed_size,
+                 "Array size mismatch on %s:%s (Got %u, expected %u)'\n",
+                 section, name, array->count, fixed_size);
+        for (uint64_t i = 0; i < array->count; i++) {
+            T value;
+            fatal_if(!BinaryCheckpoint::element(*array, i, value),
+                     "Could not parse \"%s\".",
+                     BinaryCheckpoint::elementText(*array, i));
+            *inserter = value;
+        }
+        return;
+    }
+
     std::string str;
     fatal_if(!cp.find(section, name, str),
         "Can't unserialize '%s:%s'.", section, name);
@@ -461,6 +516,52 @@ arrayParamIn(CheckpointIn &cp, const std::string &name,
     }
 }
 
+/**
+ * Copy an array blob of a binary checkpoint straight into the array it is
+ * restored to, if it holds elements of the same type.
+ *
+ * @param size The number of elements of the array, or -1 to resize the
+ * vector to the size of the blob.
+ * @return False if there is no such blob.
+ */
+template <class T>
+bool
+arrayBlobIn(CheckpointIn &cp, const std::string &name, T *param,
+            ssize_t size)
+{
+    if constexpr (BinaryCheckpoint::typeOf<T>() ==
+                  BinaryCheckpoint::Type::Text) {
+        return false;
+    } else {
+        const auto *array =
+            cp.findArray(Serializable::currentSection(), name);
+        if (!array || array->type != BinaryCheckpoint::typeOf<T>() ||
+                (size >= 0 && array->count != (uint64_t)size)) {
+            return false;
+        }
+        std::memcpy(param, array->data, array->count * sizeof(T));
+        return true;
+    }
+}
+
+template <class T>
+bool
+arrayBlobIn(CheckpointIn &cp, const std::string &name,
+            std::vector<T> &param)
+{
+    if constexpr (BinaryCheckpoint::typeOf<T>() ==
+                  BinaryCheckpoint::Type::Text) {
+        return false;
+    } else {
+        const auto *array =
+            cp.findArray(Serializable::currentSection(), name);
+        if (!array || array->type != BinaryCheckpoint::typeOf<T>())
+            return false;
+        param.resize(array->count);
+        return arrayBlobIn(cp, name, param.data(), -1);
+    }
+}
+
 /**
  * @ingroup api_serialize
  */
@@ -486,6 +587,20 @@ arrayParamIn(CheckpointIn &cp, const std::string &name, T &param)
     arrayParamIn<typename T::value_type>(cp, name, std::back_inserter(param));
 }
 
+/**
+ * @ingroup api_serialize
+ */
+template <class T>
+void
+arrayParamIn(CheckpointIn &cp, const std::string &name,
+             std::vector<T> &param)
+{
+    if (arrayBlobIn(cp, name, param))
+        return;
+    param.clear();
+    arrayParamIn<T>(cp, name, std::back_inserter(param));
+}
+
 /**
  * @ingroup api_serialize
  */
@@ -494,6 +609,9 @@ void
 arrayParamIn(CheckpointIn &cp, const std::string &name,
              T *param, unsigned size)
 {
+    if (arrayBlobIn(cp, name, param, size))
+        return;
+
     struct ArrayInserter
     {
         T *data;
@@ -961,6 +961,90 @@ TEST_F(SerializeFixtureDeathTest, ArrayParamOutInSmaller)
     }
 }
 
+/**
+ * Test arrayParamOut and arrayParamIn through a binary checkpoint
+ * container, with the arrays of numbers stored as blobs and the rest as
+ * text.
+ */
+TEST_F(SerializeFixture, BinaryArrayParamOutIn)
+{
+    const int integer[] = {5, 10, 15};
+    std::array<double, 4> real = {0.1, 1.345, 892.72, 1e+10};
+    std::list<bool> boolean = {true, false};
+    std::vector<std::string> str = {"a", "string", "test"};
+    std::vector<uint16_t> uint16 = {1, 65535, 42};
+    std::deque<uint8_t> uint8 = {17, 42, 255};
+    const std::string path =
+        getDirName() + std::string(CheckpointIn::binaryFilename);
+
+    // Serialization
+    {
+        BinaryCheckpointOut cpt(path);
+        Serializable::ScopedCheckpointSection scs(cpt, "Section1");
+        arrayParamOut(cpt, "Param1", integer);
+        arrayParamOut(cpt, "Param2", real);
+        arrayParamOut(cpt, "Param3", boolean);
+        paramOut(cpt, "Param4", 7);
+        arrayParamOut(cpt, "Param5", str);
+        arrayParamOut(cpt, "Param6", uint16);
+        arrayParamOut(cpt, "Param7", uint8);
+    }
+
+    // Unserialization
+    {
+        CheckpointIn cpt(getDirName());
+
+        int unserialized_integer[3];
+        std::array<double, 4> unserialized_real;
+        std::list<bool> unserialized_boolean;
+        int unserialized_scalar;
+        std::vector<std::string> unserialized_str;
+        std::vector<uint16_t> unserialized_uint16 = {3};
+        std::vector<int> unserialized_int;
+        std::deque<uint8_t> unserialized_uint8;
+
+        Serializable::ScopedCheckpointSection scs(cpt, "Section1");
+
+        ASSERT_NE(cpt.findArray("Section1", "Param1"), nullptr);
+        ASSERT_EQ(cpt.findArray("Section1", "Param3"), nullptr);
+
+        arrayParamIn(cpt, "Param1", unserialized_integer, 3);
+        ASSERT_THAT(unserialized_integer, testing::ElementsAre(5, 10, 15));
+
+        arrayParamIn(cpt, "Param2", unserialized_real.data(),
+            unserialized_real.size());
+        ASSERT_EQ(real, unserialized_real);
+
+        arrayParamIn(cpt, "Param3", unserialized_boolean);
+        ASSERT_EQ(boolean, unserialized_boolean);
+
+        paramIn(cpt, "Param4", unserialized_scalar);
+        ASSERT_EQ(7, unserialized_scalar);
+
+        arrayParamIn(cpt, "Param5", unserialized_str);
+        ASSERT_EQ(str, unserialized_str);
+
+        arrayParamIn(cpt, "Param6", unserialized_uint16);
+        ASSERT_EQ(uint16, unserialized_uint16);
+
+        // restored to another type
+        arrayParamIn(cpt, "Param6", unserialized_int);
+        ASSERT_THAT(unserialized_int, testing::ElementsAre(1, 65535, 42));
+
+        arrayParamIn(cpt, "Param7", unserialized_uint8);
+        ASSERT_EQ(uint8, unserialized_uint8);
+
+        // the blobs read as in the INI form
+        std::string value;
+        ASSERT_TRUE(cpt.find("Section1", "Param2", value));
+        ASSERT_EQ("0.1 1.345 892.72 1e+10", value);
+        ASSERT_TRUE(cpt.find("Section1", "Param7", value));
+        ASSERT_EQ("17 42 255", value);
+    }
+
+    std::remove(path.c_str());
+}
+
 /** Test mappingParamOut and mappingParamIn with all keys. */
 TEST_F(SerializeFixture, MappingParamOutIn)
 {
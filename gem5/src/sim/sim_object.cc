@@ -65,6 +65,11 @@ SimObject::SimObject(const Params &p)
 #endif
     simObjectList.push_back(this);
     probeManager = new ProbeManager(this);
+
+    if (p.host_time_stats) {
+        hostTimeStats = makeHostTimeStats(this, _hostTimeAccount);
+        hostAccount = &_hostTimeAccount;
+    }
 }
 
 SimObject::~SimObject()
@@ -132,10 +137,16 @@ SimObject::getPort(const std::string &if_name, PortID idx)
 // static function: serialize all SimObjects.
 //
 void
-SimObject::serializeAll(const std::string &cpt_dir)
-{
-    std::ofstream cp;
-    Serializable::generateCheckpointOut(cpt_dir, cp);
+SimObject::serializeAll(const std::string &cpt_dir, bool binary)
+{
+    std::ofstream text_cp;
+    std::unique_ptr<BinaryCheckpointOut> binary_cp;
+    if (binary)
+        binary_cp = Serializable::generateBinaryCheckpointOut(cpt_dir);
+    else
+        Serializable::generateCheckpointOut(cpt_dir, text_cp);
+    CheckpointOut &cp = binary ? static_cast<CheckpointOut &>(*binary_cp) :
+        text_cp;
 
     SimObjectList::reverse_iterator ri = simObjectList.rbegin();
     SimObjectList::reverse_iterator rend = simObjectList.rend();
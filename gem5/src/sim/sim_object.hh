@@ -46,6 +46,7 @@
 #ifndef __SIM_OBJECT_HH__
 #define __SIM_OBJECT_HH__
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -54,6 +55,7 @@
 #include "params/SimObject.hh"
 #include "sim/drain.hh"
 #include "sim/eventq.hh"
+#include "sim/host_time.hh"
 #include "sim/port.hh"
 #include "sim/serialize.hh"
 
@@ -158,6 +160,10 @@ class SimObject : public EventManager, public Serializable, public Drainable,
     /** Manager coordinates hooking up probe points with listeners. */
     ProbeManager *probeManager;
 
+    /** Host time spent on behalf of this object, see host_time_stats. */
+    HostTimeAccount _hostTimeAccount;
+    std::unique_ptr<statistics::Group> hostTimeStats;
+
   protected:
     /**
      * Cached copy of the object parameters.
@@ -182,6 +188,13 @@ class SimObject : public EventManager, public Serializable, public Drainable,
 
     virtual ~SimObject();
 
+    /**
+     * @return the account charged for the host time spent in the
+     * events and timing port handlers of this object, nullptr if
+     * host time stats are disabled.
+     */
+    HostTimeAccount *hostTimeAccount() const { return hostAccount; }
+
   public:
     /**
      * init() is called after all C++ SimObjects have been created and
@@ -326,8 +339,11 @@ class SimObject : public EventManager, public Serializable, public Drainable,
      * in its own section. As such, the serialization functions should not
      * be called on sim objects anywhere else; otherwise, these objects
      * would be needlessly serialized more than once.
+     *
+     * @param binary Write a binary container (m5.bcpt) rather than the
+     * INI text (m5.cpt).
      */
-    static void serializeAll(const std::string &cpt_dir);
+    static void serializeAll(const std::string &cpt_dir, bool binary=false);
 
 #ifdef DEBUG
   public:
@@ -0,0 +1,107 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/stat_sampler.hh"
+
+#include <algorithm>
+
+#include "base/logging.hh"
+#include "base/stats/info.hh"
+#include "sim/cur_tick.hh"
+
+namespace gem5
+{
+
+namespace statistics
+{
+
+Sampler::Sampler(const std::vector<Stat> &_stats, size_t capacity)
+    : stats(_stats), _capacity(capacity), numColumns(0), _count(0),
+      period(0),
+      event([this]{ record(); }, "statistics.Sampler", false,
+            Event::Stat_Event_Pri)
+{
+    fatal_if(capacity == 0, "A stat sampler needs at least a row.");
+
+    // The columns of the stats do not change once they are initialized
+    sample();
+    numColumns = columns().size();
+    _ring.resize(_capacity * rowSize());
+}
+
+Sampler::~Sampler()
+{
+    stop();
+}
+
+void
+Sampler::sample()
+{
+    begin();
+    for (const auto &stat : stats) {
+        if (!stat.first.empty())
+            beginGroup(stat.first.c_str());
+        stat.second->prepare();
+        stat.second->visit(*this);
+        if (!stat.first.empty())
+            endGroup();
+    }
+    end();
+}
+
+void
+Sampler::start(Tick _period)
+{
+    fatal_if(_period == 0, "Stats cannot be sampled every 0 ticks.");
+
+    stop();
+    period = _period;
+    getEventQueue(0)->schedule(&event, curTick() + period);
+}
+
+void
+Sampler::stop()
+{
+    if (event.scheduled())
+        getEventQueue(0)->deschedule(&event);
+}
+
+void
+Sampler::record()
+{
+    sample();
+    panic_if(columns().size() != numColumns,
+             "The number of columns of sampled stats changed.");
+
+    double *row = &_ring[(_count % _capacity) * rowSize()];
+    row[0] = curTick();
+    std::copy(columns().begin(), columns().end(), row + 1);
+    _count++;
+
+    getEventQueue(0)->schedule(&event, curTick() + period);
+}
+
+} // namespace statistics
+} // namespace gem5
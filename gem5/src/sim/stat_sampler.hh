@@ -0,0 +1,106 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SIM_STAT_SAMPLER_HH__
+#define __SIM_STAT_SAMPLER_HH__
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/stats/columnar.hh"
+#include "base/types.hh"
+#include "sim/eventq.hh"
+
+namespace gem5
+{
+
+namespace statistics
+{
+
+/**
+ * Samples a selection of stats, for scripts that analyse them while the
+ * simulation runs, without dumping all of them to a file.
+ *
+ * The stats are flattened into double precision columns, as in the
+ * binary output, either on demand or every period into a ring of
+ * preallocated rows that hold the tick then the columns. Both are
+ * exposed to Python as NumPy arrays that share their memory.
+ *
+ * The dump callbacks are not run before a sample, so the stats that
+ * are only updated by those hold the value of the last dump.
+ */
+class Sampler : public Columnar
+{
+  public:
+    /** A stat to sample, with the full name of its group, if any. */
+    typedef std::pair<std::string, Info *> Stat;
+
+    /**
+     * @param stats Stats to sample.
+     * @param capacity Rows in the ring of the periodic samples.
+     */
+    Sampler(const std::vector<Stat> &stats, size_t capacity);
+    ~Sampler();
+
+    /** Flatten the current values of the stats into columns(). */
+    void sample();
+
+    /** Record a sample in the ring every period, from now on. */
+    void start(Tick period);
+    void stop();
+
+    const std::vector<double> &ring() const { return _ring; }
+    size_t capacity() const { return _capacity; }
+    size_t rowSize() const { return 1 + numColumns; }
+
+    /**
+     * Samples recorded in the ring, the last one being in the row
+     * (count() - 1) % capacity().
+     */
+    uint64_t count() const { return _count; }
+
+  public: // Output interface
+    void end() override {}
+    bool valid() const override { return true; }
+
+  private:
+    void record();
+
+    const std::vector<Stat> stats;
+    const size_t _capacity;
+    size_t numColumns;
+
+    std::vector<double> _ring;
+    uint64_t _count;
+
+    Tick period;
+    EventFunctionWrapper event;
+};
+
+} // namespace statistics
+} // namespace gem5
+
+#endif // __SIM_STAT_SAMPLER_HH__
@@ -29,14 +29,19 @@
 #include "sim/syscall_emul.hh"
 
 #include <fcntl.h>
+#include <sys/stat.h>
 #include <sys/syscall.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <climits>
 #include <csignal>
 #include <iostream>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "base/chunk_generator.hh"
 #include "base/trace.hh"
@@ -61,6 +66,101 @@ warnUnsupportedOS(std::string syscall_name)
     warn("Cannot invoke %s on host operating system.", syscall_name);
 }
 
+namespace
+{
+
+/**
+ * Largest bounce buffer for the regular files, which can be read and
+ * written in several calls.
+ */
+constexpr int bounceChunk = 1 << 20;
+
+bool
+directIo(ThreadContext *tc, Addr buf, int nbytes, BaseMMU::Mode mode,
+         std::vector<struct iovec> &iov)
+{
+    return nbytes > 0 &&
+        SETranslatingPortProxy(tc).hostRanges(buf, nbytes, mode, iov) &&
+        iov.size() <= IOV_MAX;
+}
+
+int
+chunkSize(int sim_fd, int nbytes)
+{
+    struct stat st;
+    if (fstat(sim_fd, &st) == 0 && S_ISREG(st.st_mode))
+        return std::min(nbytes, bounceChunk);
+    return nbytes;
+}
+
+} // anonymous namespace
+
+ssize_t
+readToTarget(ThreadContext *tc, int sim_fd, Addr buf, int nbytes,
+             std::optional<off_t> offset)
+{
+    std::vector<struct iovec> iov;
+    if (directIo(tc, buf, nbytes, BaseMMU::Write, iov)) {
+        return offset ? preadv(sim_fd, iov.data(), iov.size(), *offset) :
+                        readv(sim_fd, iov.data(), iov.size());
+    }
+
+    if (nbytes < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    SETranslatingPortProxy proxy(tc);
+    std::vector<uint8_t> bounce(chunkSize(sim_fd, nbytes));
+    ssize_t done = 0;
+    do {
+        int len = std::min<ssize_t>(nbytes - done, bounce.size());
+        ssize_t n = offset ?
+            pread(sim_fd, bounce.data(), len, *offset + done) :
+            read(sim_fd, bounce.data(), len);
+        if (n == -1)
+            return done ? done : -1;
+        proxy.writeBlob(buf + done, bounce.data(), n);
+        done += n;
+        if (n < len)
+            break;
+    } while (done < nbytes);
+    return done;
+}
+
+ssize_t
+writeFromTarget(ThreadContext *tc, int sim_fd, Addr buf, int nbytes,
+                std::optional<off_t> offset)
+{
+    std::vector<struct iovec> iov;
+    if (directIo(tc, buf, nbytes, BaseMMU::Read, iov)) {
+        return offset ? pwritev(sim_fd, iov.data(), iov.size(), *offset) :
+                        writev(sim_fd, iov.data(), iov.size());
+    }
+
+    if (nbytes < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    SETranslatingPortProxy proxy(tc);
+    std::vector<uint8_t> bounce(chunkSize(sim_fd, nbytes));
+    ssize_t done = 0;
+    do {
+        int len = std::min<ssize_t>(nbytes - done, bounce.size());
+        proxy.readBlob(buf + done, bounce.data(), len);
+        ssize_t n = offset ?
+            pwrite(sim_fd, bounce.data(), len, *offset + done) :
+            write(sim_fd, bounce.data(), len);
+        if (n == -1)
+            return done ? done : -1;
+        done += n;
+        if (n < len)
+            break;
+    } while (done < nbytes);
+    return done;
+}
+
 SyscallReturn
 unimplementedFunc(SyscallDesc *desc, ThreadContext *tc)
 {
@@ -157,6 +257,8 @@ exitImpl(SyscallDesc *desc, ThreadContext *tc, bool group, int status)
                  * all threads in the group.
                  */
                 if (*(p->exitGroup)) {
+                    EventQueue::ScopedMigration migrate(
+                            tc->getCpuPtr()->eventQueue());
                     tc->halt();
                 } else {
                     last_thread = false;
@@ -201,6 +303,7 @@ exitImpl(SyscallDesc *desc, ThreadContext *tc, bool group, int status)
     if (!p->vforkContexts.empty()) {
         ThreadContext *vtc = sys->threads[p->vforkContexts.front()];
         assert(vtc->status() == ThreadContext::Suspended);
+        EventQueue::ScopedMigration migrate(vtc->getCpuPtr()->eventQueue());
         vtc->activate();
     }
 
@@ -84,6 +84,7 @@
 
 #include <cerrno>
 #include <memory>
+#include <optional>
 #include <string>
 
 #include "arch/generic/tlb.hh"
@@ -128,6 +129,22 @@ namespace gem5
 
 void warnUnsupportedOS(std::string syscall_name);
 
+/**
+ * Read up to nbytes of the host file sim_fd into the target buffer at buf,
+ * from the file offset, or from offset if there is one. The data goes
+ * straight into the host memory of the buffer when
+ * SETranslatingPortProxy::hostRanges allows it. Otherwise it is bounced
+ * through the simulator, a MiB at a time for regular files.
+ *
+ * @return The number of bytes read, or -1 with errno set.
+ */
+ssize_t readToTarget(ThreadContext *tc, int sim_fd, Addr buf, int nbytes,
+                     std::optional<off_t> offset={});
+
+/** Write, the other way round from readToTarget. */
+ssize_t writeFromTarget(ThreadContext *tc, int sim_fd, Addr buf, int nbytes,
+                        std::optional<off_t> offset={});
+
 /// Handler for unimplemented syscalls that we haven't thought about.
 SyscallReturn unimplementedFunc(SyscallDesc *desc, ThreadContext *tc);
 
@@ -1703,7 +1720,11 @@ cloneFunc(SyscallDesc *desc, ThreadContext *tc, RegVal flags, RegVal newStack,
 
     desc->returnInto(ctc, 0);
 
-    ctc->activate();
+    {
+        // The child may run on a CPU simulated by another event queue.
+        EventQueue::ScopedMigration migrate(ctc->getCpuPtr()->eventQueue());
+        ctc->activate();
+    }
 
     if (flags & OS::TGT_CLONE_VFORK) {
         tc->suspend();
@@ -1973,11 +1994,7 @@ pread64Func(SyscallDesc *desc, ThreadContext *tc,
         return -EBADF;
     int sim_fd = ffdp->getSimFD();
 
-    BufferArg bufArg(bufPtr, nbytes);
-
-    int bytes_read = pread(sim_fd, bufArg.bufferPtr(), nbytes, offset);
-
-    bufArg.copyOut(SETranslatingPortProxy(tc));
+    int bytes_read = readToTarget(tc, sim_fd, bufPtr, nbytes, offset);
 
     return (bytes_read == -1) ? -errno : bytes_read;
 }
@@ -1994,10 +2011,7 @@ pwrite64Func(SyscallDesc *desc, ThreadContext *tc,
         return -EBADF;
     int sim_fd = ffdp->getSimFD();
 
-    BufferArg bufArg(bufPtr, nbytes);
-    bufArg.copyIn(SETranslatingPortProxy(tc));
-
-    int bytes_written = pwrite(sim_fd, bufArg.bufferPtr(), nbytes, offset);
+    int bytes_written = writeFromTarget(tc, sim_fd, bufPtr, nbytes, offset);
 
     return (bytes_written == -1) ? -errno : bytes_written;
 }
@@ -2206,6 +2220,7 @@ execveFunc(SyscallDesc *desc, ThreadContext *tc,
     if (!p->vforkContexts.empty()) {
         ThreadContext *vtc = p->system->threads[p->vforkContexts.front()];
         assert(vtc->status() == ThreadContext::Suspended);
+        EventQueue::ScopedMigration migrate(vtc->getCpuPtr()->eventQueue());
         vtc->activate();
     }
 
@@ -2634,11 +2649,7 @@ readFunc(SyscallDesc *desc, ThreadContext *tc,
         && !(hbfdp->getFlags() & OS::TGT_O_NONBLOCK))
         return SyscallReturn::retry();
 
-    BufferArg buf_arg(buf_ptr, nbytes);
-    int bytes_read = read(sim_fd, buf_arg.bufferPtr(), nbytes);
-
-    if (bytes_read > 0)
-        buf_arg.copyOut(SETranslatingPortProxy(tc));
+    int bytes_read = readToTarget(tc, sim_fd, buf_ptr, nbytes);
 
     return (bytes_read == -1) ? -errno : bytes_read;
 }
@@ -2655,9 +2666,6 @@ writeFunc(SyscallDesc *desc, ThreadContext *tc,
         return -EBADF;
     int sim_fd = hbfdp->getSimFD();
 
-    BufferArg buf_arg(buf_ptr, nbytes);
-    buf_arg.copyIn(SETranslatingPortProxy(tc));
-
     struct pollfd pfd;
     pfd.fd = sim_fd;
     pfd.events = POLLOUT;
@@ -2674,7 +2682,7 @@ writeFunc(SyscallDesc *desc, ThreadContext *tc,
             return SyscallReturn::retry();
     }
 
-    int bytes_written = write(sim_fd, buf_arg.bufferPtr(), nbytes);
+    int bytes_written = writeFromTarget(tc, sim_fd, buf_ptr, nbytes);
 
     if (bytes_written != -1)
         fsync(sim_fd);
@@ -203,7 +203,9 @@ System::System(const Params &p)
       kvmVM(p.kvm_vm),
 #endif
       physmem(name() + ".physmem", p.memories, p.mmap_using_noreserve,
-              p.shared_backstore),
+              p.shared_backstore, p.memory_checkpoint_format,
+              p.memory_checkpoint_threads, p.memory_checkpoint_incremental,
+              p.memory_checkpoint_max_deltas),
       ShadowRomRanges(p.shadow_rom_ranges.begin(),
                       p.shadow_rom_ranges.end()),
       memoryMode(p.mem_mode),
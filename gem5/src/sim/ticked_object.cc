@@ -49,6 +49,7 @@ Ticked::Ticked(ClockedObject &object_,
     Event::Priority priority) :
     object(object_),
     event([this]{ processClockEvent(); }, object_.name(), false, priority),
+    wakeEvent([this]{ start(); }, object_.name() + ".wake", false, priority),
     running(false),
     lastStopped(0),
     /* Allocate numCycles if an external stat wasn't passed in */
@@ -92,6 +93,11 @@ Ticked::serialize(CheckpointOut &cp) const
     uint64_t lastStoppedUint = lastStopped;
 
     paramOut(cp, "lastStopped", lastStoppedUint);
+
+    if (wakeEvent.scheduled()) {
+        Tick wakeTick = wakeEvent.when();
+        paramOut(cp, "wakeTick", wakeTick);
+    }
 }
 
 void
@@ -108,6 +114,10 @@ Ticked::unserialize(CheckpointIn &cp)
     optParamIn(cp, "lastStopped", lastStoppedUint);
 
     lastStopped = Cycles(lastStoppedUint);
+
+    Tick wakeTick = MaxTick;
+    if (optParamIn(cp, "wakeTick", wakeTick, false))
+        object.schedule(wakeEvent, wakeTick);
 }
 
 TickedObject::TickedObject(const TickedObjectParams &params,
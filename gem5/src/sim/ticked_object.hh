@@ -70,6 +70,9 @@ class Ticked : public Serializable
     /** Evaluate and reschedule */
     void processClockEvent();
 
+    /** Restarts ticking at the end of sleepFor */
+    EventFunctionWrapper wakeEvent;
+
     /** Have I been started? and am not stopped */
     bool running;
 
@@ -105,6 +108,8 @@ class Ticked : public Serializable
     void
     start()
     {
+        if (wakeEvent.scheduled())
+            object.deschedule(wakeEvent);
         if (!running) {
             if (!event.scheduled())
                 object.schedule(event, object.clockEdge(Cycles(1)));
@@ -132,6 +137,8 @@ class Ticked : public Serializable
     void
     stop()
     {
+        if (wakeEvent.scheduled())
+            object.deschedule(wakeEvent);
         if (running) {
             if (event.scheduled())
                 object.deschedule(event);
@@ -140,7 +147,26 @@ class Ticked : public Serializable
         }
     }
 
-    /** Checkpoint lastStopped */
+    /**
+     * Stop ticking for the given number of cycles, for objects that know
+     * that nothing will happen until then. The cycles slept are not
+     * evaluated but accounted in bulk as idle cycles when ticking
+     * restarts, either after the given cycles or earlier through
+     * start().
+     *
+     * @param cycles Number of cycles from now to restart ticking at.
+     */
+    void
+    sleepFor(Cycles cycles)
+    {
+        stop();
+        object.schedule(wakeEvent, object.clockEdge(cycles));
+    }
+
+    /** Is ticking stopped until a known cycle? */
+    bool sleeping() const { return wakeEvent.scheduled(); }
+
+    /** Checkpoint lastStopped and the end of any sleepFor */
     void serialize(CheckpointOut &cp) const override;
     void unserialize(CheckpointIn &cp) override;
 
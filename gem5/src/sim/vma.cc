@@ -30,6 +30,9 @@
 
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
 
 #include "base/types.hh"
 
@@ -50,6 +53,31 @@ VMA::fillMemPages(Addr start, Addr size, PortProxy &port) const
     }
 }
 
+bool
+VMA::mapMemPage(Addr start, uint8_t *host) const
+{
+    static const Addr host_page_bytes = sysconf(_SC_PAGESIZE);
+
+    auto offset = start - _addrRange.start();
+    if (!host || offset + _pageBytes > _hostBufLen)
+        return false;
+
+    off_t file_off = _origHostBuf->getOffset() + offset +
+        ((uint8_t *)_hostBuf - (uint8_t *)_origHostBuf->getBuffer());
+    if (_pageBytes % host_page_bytes || (uintptr_t)host % host_page_bytes ||
+            file_off % host_page_bytes) {
+        return false;
+    }
+
+    void *mapped = mmap(host, _pageBytes, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_FIXED, _origHostBuf->getFD(),
+                        file_off);
+    panic_if(mapped == MAP_FAILED,
+             "Failed to map file into simulated memory: %s",
+             strerror(errno));
+    return true;
+}
+
 bool
 VMA::isStrictSuperset(const AddrRange &r) const
 {
@@ -120,7 +148,7 @@ VMA::sanityCheck()
 
 VMA::MappedFileBuffer::MappedFileBuffer(int fd, size_t length,
                                         off_t offset)
-    : _buffer(nullptr), _length(length)
+    : _buffer(nullptr), _length(length), _fd(-1), _offset(offset)
 {
     panic_if(_length == 0, "Tried to mmap file of length zero");
 
@@ -145,6 +173,12 @@ VMA::MappedFileBuffer::MappedFileBuffer(int fd, size_t length,
     } else {
         panic("Tried to mmap 0 bytes");
     }
+
+    // The target may close its descriptor while the pages are still
+    // mapped lazily.
+    _fd = dup(fd);
+    panic_if(_fd == -1, "Cannot duplicate file descriptor: %s",
+             strerror(errno));
 }
 
 VMA::MappedFileBuffer::~MappedFileBuffer()
@@ -154,6 +188,8 @@ VMA::MappedFileBuffer::~MappedFileBuffer()
                  "mmap: failed to unmap file-backed host memory: %s",
                  strerror(errno));
     }
+    if (_fd != -1)
+        close(_fd);
 }
 
 } // namespace gem5
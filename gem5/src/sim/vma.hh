@@ -88,6 +88,18 @@ class VMA
      */
     void fillMemPages(Addr start, Addr size, PortProxy &port) const;
 
+    /**
+     * Map the file behind the page at start straight over the host memory
+     * of its fresh physical frame, at host, copy on write. The host kernel
+     * then reads the page in on its first access, and the pages that are
+     * never touched cost nothing.
+     *
+     * @return false if the page can't be mapped that way (it isn't a full
+     *         page of the file or the host pages don't line up with it),
+     *         and has to be filled with fillMemPages instead.
+     */
+    bool mapMemPage(Addr start, uint8_t *host) const;
+
     /**
      * Returns true if desired range exists within this virtual memory area
      * and does not include the start and end addresses.
@@ -191,10 +203,14 @@ class VMA
 
         void *getBuffer() const { return _buffer; }
         uint64_t getLength() const { return _length; }
+        int getFD() const { return _fd; }
+        off_t getOffset() const { return _offset; }
 
       private:
         void *_buffer;       // Host buffer ptr
         size_t _length;       // Length of host ptr
+        int _fd;              // Private copy of the file descriptor
+        off_t _offset;        // File offset of the buffer
     };
 };
 
@@ -23,6 +23,7 @@
 # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+from m5.params import *
 from m5.SimObject import SimObject, cxxMethod
 
 # This class represents the systemc kernel. There should be exactly one in the
@@ -33,6 +34,11 @@ class SystemC_Kernel(SimObject):
     cxx_class = 'sc_gem5::Kernel'
     cxx_header = 'systemc/core/kernel.hh'
 
+    eval_threads = Param.Unsigned(1, "Host threads of the evaluation "
+        "phase. With more than one, the ready methods marked parallel safe "
+        "(see sc_gem5::Process::parallelSafe) run side by side within a "
+        "delta cycle")
+
 # This class represents systemc sc_object instances in python config files. It
 # inherits from SimObject in python, but the c++ version, sc_core::sc_object,
 # doesn't inherit from gem5's c++ SimObject class.
@@ -157,6 +157,8 @@ Event::notify(DynamicSensitivities &senses)
 void
 Event::notify()
 {
+    EvalLock lock;
+
     if (scheduler.inUpdate())
         SC_REPORT_ERROR(sc_core::SC_ID_IMMEDIATE_NOTIFICATION_, "");
 
@@ -174,6 +176,8 @@ Event::notify()
 void
 Event::notify(const sc_core::sc_time &t)
 {
+    EvalLock lock;
+
     if (delayedNotify.scheduled()) {
         if (scheduler.delayed(t) >= delayedNotify.when())
             return;
@@ -186,6 +190,8 @@ Event::notify(const sc_core::sc_time &t)
 void
 Event::notifyDelayed(const sc_core::sc_time &t)
 {
+    EvalLock lock;
+
     if (delayedNotify.scheduled())
         SC_REPORT_ERROR(sc_core::SC_ID_NOTIFY_DELAYED_, "");
     notify(t);
@@ -194,6 +200,8 @@ Event::notifyDelayed(const sc_core::sc_time &t)
 void
 Event::cancel()
 {
+    EvalLock lock;
+
     if (delayedNotify.scheduled())
         scheduler.deschedule(&delayedNotify);
 }
@@ -60,6 +60,7 @@ Kernel::Kernel(const Params &params, int) :
 {
     // Install ourselves as the scheduler's event manager.
     ::sc_gem5::scheduler.setEventQueue(eventQueue());
+    ::sc_gem5::scheduler.evalThreads(params.eval_threads);
 }
 
 void
@@ -287,6 +287,7 @@ Process::addStatic(StaticSensitivity *s)
 void
 Process::setDynamic(DynamicSensitivity *s)
 {
+    EvalLock lock;
     if (dynamicSensitivity) {
         dynamicSensitivity->clear();
         delete dynamicSensitivity;
@@ -354,6 +355,7 @@ Process::satisfySensitivity(Sensitivity *s)
 void
 Process::ready()
 {
+    EvalLock lock;
     if (disabled())
         return;
     if (suspended())
@@ -379,8 +381,8 @@ Process::Process(const char *name, ProcessFuncWrapper *func, bool internal) :
     ::sc_core::sc_process_b(name), excWrapper(nullptr),
     timeoutEvent([this]() { this->timeout(); }),
     func(func), _internal(internal), _timedOut(false), _dontInitialize(false),
-    _needsStart(true), _isUnwinding(false), _terminated(false),
-    _scheduled(false), _suspended(false), _disabled(false),
+    _parallelSafe(false), _needsStart(true), _isUnwinding(false),
+    _terminated(false), _scheduled(false), _suspended(false), _disabled(false),
     _syncReset(false), syncResetCount(0), asyncResetCount(0), _waitCount(0),
     refCount(0), stackSize(gem5::Fiber::DefaultStackSize),
     dynamicSensitivity(nullptr)
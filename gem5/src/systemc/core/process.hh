@@ -133,6 +133,14 @@ class Process : public ::sc_core::sc_process_b, public ListNode
     bool dontInitialize() { return _dontInitialize; }
     void dontInitialize(bool di) { _dontInitialize = di; }
 
+    // A method marked parallel safe may run on another host thread, next to
+    // other such methods, when the kernel has more than one evaluation
+    // thread. Its calls into the kernel (notifications, channel update
+    // requests, next_trigger) are serialized, but it must not touch any
+    // other state it shares with other processes.
+    bool parallelSafe() { return _parallelSafe; }
+    void parallelSafe(bool ps) { _parallelSafe = ps; }
+
     void joinWait(::sc_core::sc_join *join) { joinWaiters.push_back(join); }
 
     void waitCount(int count) { _waitCount = count; }
@@ -168,6 +176,7 @@ class Process : public ::sc_core::sc_process_b, public ListNode
     bool _timedOut;
 
     bool _dontInitialize;
+    bool _parallelSafe;
 
     bool _needsStart;
     bool _dynamic;
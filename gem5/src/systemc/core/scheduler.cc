@@ -43,6 +43,8 @@
 namespace sc_gem5
 {
 
+thread_local Process *Scheduler::_parallelCurrent = nullptr;
+
 Scheduler::Scheduler() :
     eq(nullptr), readyEvent(this, false, ReadyPriority),
     pauseEvent(this, false, PausePriority),
@@ -198,6 +200,8 @@ Scheduler::yield()
 void
 Scheduler::ready(Process *p)
 {
+    EvalLock lock;
+
     if (_stopNow)
         return;
 
@@ -249,6 +253,8 @@ Scheduler::suspend(Process *p)
 void
 Scheduler::requestUpdate(Channel *c)
 {
+    EvalLock lock;
+
     updateList.pushLast(c);
     if (!inEvaluate())
         scheduleReadyEvent();
@@ -294,7 +300,8 @@ Scheduler::runReady()
     // The evaluation phase.
     status(StatusEvaluate);
     do {
-        yield();
+        if (evalPool.empty() || !runParallelBatch())
+            yield();
     } while (getNextReady());
     _current = nullptr;
 
@@ -322,6 +329,147 @@ Scheduler::runReady()
     status(StatusOther);
 }
 
+void
+Scheduler::evalThreads(unsigned threads)
+{
+    if (threads > 1)
+        evalPool.start(threads - 1);
+    else
+        evalPool.stop();
+}
+
+bool
+Scheduler::runParallelBatch()
+{
+    parallelBatch.clear();
+    for (ListNode *n = readyListMethods.nextListNode;
+            n != &readyListMethods; n = n->nextListNode) {
+        auto *p = static_cast<Process *>(n);
+        // Anything which needs more than a plain call of the method, (re)set
+        // or exception injection, ends the batch.
+        if (p->procKind() != ::sc_core::SC_METHOD_PROC_ ||
+                !p->parallelSafe() || !p->needsStart() || p->inReset() ||
+                p->excWrapper) {
+            break;
+        }
+        parallelBatch.push_back(p);
+    }
+    if (parallelBatch.size() < 2)
+        return false;
+
+    parallelExcs.assign(parallelBatch.size(), nullptr);
+    _parallelEval = true;
+    evalPool.run(parallelBatch.size(), [this](size_t i) {
+        runParallel(parallelBatch[i], parallelExcs[i]);
+    });
+    _parallelEval = false;
+
+    // Report the first exception as if its process had run on its own.
+    for (size_t i = 0; i < parallelExcs.size(); i++) {
+        if (!parallelExcs[i])
+            continue;
+        _current = parallelBatch[i];
+        try {
+            std::rethrow_exception(parallelExcs[i]);
+        } catch (...) {
+            throwUp();
+        }
+        break;
+    }
+    return true;
+}
+
+void
+Scheduler::runParallel(Process *p, std::exception_ptr &exc)
+{
+    {
+        EvalLock lock;
+        // An earlier method of the batch may have taken p off of the ready
+        // list in the meantime, e.g. by disabling it.
+        if (!p->scheduled() || !p->nextListNode)
+            return;
+        p->popListNode();
+        p->scheduled(false);
+        p->needsStart(false);
+    }
+    _parallelCurrent = p;
+    try {
+        p->run();
+    } catch (...) {
+        exc = std::current_exception();
+    }
+    _parallelCurrent = nullptr;
+}
+
+void
+Scheduler::EvalPool::start(unsigned threads)
+{
+    stop();
+    stopping = false;
+    for (unsigned i = 0; i < threads; i++)
+        workers.emplace_back(&EvalPool::worker, this);
+}
+
+void
+Scheduler::EvalPool::stop()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    jobCv.notify_all();
+    for (auto &thread: workers)
+        thread.join();
+    workers.clear();
+}
+
+void
+Scheduler::EvalPool::run(size_t n, const std::function<void(size_t)> &work)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        job = &work;
+        jobSize = n;
+        nextItem = 0;
+        generation++;
+    }
+    jobCv.notify_all();
+    drain();
+
+    // Some workers may still be running the last items.
+    std::unique_lock<std::mutex> guard(lock);
+    doneCv.wait(guard, [this]() { return busy == 0; });
+    job = nullptr;
+}
+
+void
+Scheduler::EvalPool::drain()
+{
+    for (size_t i = nextItem++; i < jobSize; i = nextItem++)
+        (*job)(i);
+}
+
+void
+Scheduler::EvalPool::worker()
+{
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+        jobCv.wait(guard, [this, &seen]() {
+            return stopping || (job && generation != seen);
+        });
+        if (stopping)
+            return;
+        seen = generation;
+        busy++;
+        guard.unlock();
+        drain();
+        guard.lock();
+        if (--busy == 0)
+            doneCv.notify_one();
+    }
+}
+
 void
 Scheduler::runUpdate()
 {
@@ -29,11 +29,14 @@
 #define __SYSTEMC_CORE_SCHEDULER_HH__
 
 #include <atomic>
+#include <condition_variable>
+#include <exception>
 #include <functional>
 #include <list>
 #include <map>
 #include <mutex>
 #include <set>
+#include <thread>
 #include <vector>
 
 #include "base/logging.hh"
@@ -182,7 +185,19 @@ class Scheduler
     const std::string name() const { return "systemc_scheduler"; }
 
     uint64_t numCycles() { return _numCycles; }
-    Process *current() { return _current; }
+    Process *
+    current()
+    {
+        return _parallelCurrent ? _parallelCurrent : _current;
+    }
+
+    // Run the evaluation phase on this many host threads. With more than
+    // one, consecutive ready methods marked parallel safe run as a batch
+    // across the threads, and the kernel calls they make are serialized
+    // through evalMutex().
+    void evalThreads(unsigned threads);
+    bool parallelEval() const { return _parallelEval; }
+    std::recursive_mutex &evalMutex() { return _evalMutex; }
 
     void initPhase();
 
@@ -466,6 +481,51 @@ class Scheduler
 
     void runReady();
     gem5::EventWrapper<Scheduler, &Scheduler::runReady> readyEvent;
+
+    // Host threads which help the simulation thread run a batch of
+    // parallel safe methods.
+    class EvalPool
+    {
+      public:
+        ~EvalPool() { stop(); }
+
+        void start(unsigned threads);
+        void stop();
+        bool empty() const { return workers.empty(); }
+
+        // Call work(i) for every i in [0, n) on the workers and the calling
+        // thread, and return once all of them are done.
+        void run(size_t n, const std::function<void(size_t)> &work);
+
+      private:
+        void worker();
+        void drain();
+
+        std::vector<std::thread> workers;
+        std::mutex lock;
+        std::condition_variable jobCv;
+        std::condition_variable doneCv;
+        const std::function<void(size_t)> *job = nullptr;
+        size_t jobSize = 0;
+        std::atomic<size_t> nextItem{0};
+        uint64_t generation = 0;
+        unsigned busy = 0;
+        bool stopping = false;
+    };
+
+    EvalPool evalPool;
+    bool _parallelEval = false;
+    std::recursive_mutex _evalMutex;
+    std::vector<Process *> parallelBatch;
+    std::vector<std::exception_ptr> parallelExcs;
+    // The process a pool thread (or the simulation thread, while it helps
+    // with a batch) is running.
+    static thread_local Process *_parallelCurrent;
+
+    // Run the parallel safe methods at the head of the method ready list as
+    // a batch, if there are at least two of them.
+    bool runParallelBatch();
+    void runParallel(Process *p, std::exception_ptr &exc);
     void scheduleReadyEvent();
 
     void pause();
@@ -542,6 +602,30 @@ class Scheduler
 
 extern Scheduler scheduler;
 
+// Serializes a kernel call made by a process of a parallel evaluation batch.
+// It's a no-op outside of such a batch.
+class EvalLock
+{
+  public:
+    EvalLock() : locked(scheduler.parallelEval())
+    {
+        if (locked)
+            scheduler.evalMutex().lock();
+    }
+
+    ~EvalLock()
+    {
+        if (locked)
+            scheduler.evalMutex().unlock();
+    }
+
+    EvalLock(const EvalLock &) = delete;
+    EvalLock &operator=(const EvalLock &) = delete;
+
+  private:
+    bool locked;
+};
+
 // A proxy function to avoid having to expose the scheduler in header files.
 Process *getCurrentProcess();
 
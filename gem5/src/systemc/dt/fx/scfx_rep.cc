@@ -60,6 +60,7 @@
 
 #include <cctype>
 #include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 
@@ -1171,8 +1172,9 @@ scfx_rep::to_string(sc_numrep numrep, int w_prefix,
 //  returns carry of operation
 // ----------------------------------------------------------------------------
 
+template <class Mant>
 static inline int
-add_mants(int size, scfx_mant &result, const scfx_mant &a, const scfx_mant &b)
+add_mants(int size, scfx_mant &result, const Mant &a, const Mant &b)
 {
     unsigned int carry = 0;
 
@@ -1193,7 +1195,8 @@ add_mants(int size, scfx_mant &result, const scfx_mant &a, const scfx_mant &b)
 }
 
 static inline int
-sub_mants(int size, scfx_mant &result, const scfx_mant &a, const scfx_mant &b)
+sub_mants(int size, scfx_mant &result, const scfx_mant_view &a,
+          const scfx_mant_view &b)
 {
     unsigned carry = 0;
 
@@ -1240,8 +1243,8 @@ add_scfx_rep(const scfx_rep &lhs, const scfx_rep &rhs, int max_wl)
     //
     // align operands if needed
     //
-    scfx_mant_ref lhs_mant;
-    scfx_mant_ref rhs_mant;
+    scfx_mant_view lhs_mant;
+    scfx_mant_view rhs_mant;
 
     int len_mant = lhs.size();
     int new_wp = lhs.m_wp;
@@ -1349,8 +1352,8 @@ sub_scfx_rep(const scfx_rep &lhs, const scfx_rep &rhs, int max_wl)
     //
     // align operands if needed
     //
-    scfx_mant_ref lhs_mant;
-    scfx_mant_ref rhs_mant;
+    scfx_mant_view lhs_mant;
+    scfx_mant_view rhs_mant;
 
     int len_mant = lhs.size();
     int new_wp = lhs.m_wp;
@@ -1410,12 +1413,6 @@ union word_short
     } s;
 };
 
-#if defined(SC_BOOST_BIG_ENDIAN)
-static const int half_word_incr = -1;
-#elif defined(SC_BOOST_LITTLE_ENDIAN)
-static const int half_word_incr = 1;
-#endif
-
 void
 multiply(scfx_rep &result, const scfx_rep &lhs, const scfx_rep &rhs,
          int max_wl)
@@ -1456,30 +1453,20 @@ multiply(scfx_rep &result, const scfx_rep &lhs, const scfx_rep &rhs,
     result.m_sign = new_sign;
     result.m_state = scfx_rep::normal;
 
-    half_word *s1 = lhs.m_mant.half_addr(lhs.m_lsw);
-    half_word *s2 = rhs.m_mant.half_addr(rhs.m_lsw);
-
-    half_word *t = result.m_mant.half_addr();
-
-    len_lhs <<= 1;
-    len_rhs <<= 1;
-
-    int i1, i2;
-
-    for (i1 = 0; i1 * half_word_incr < len_lhs; i1 += half_word_incr) {
-        word_short ls;
-        ls.l = 0;
-
-        half_word v1 = s1[i1];
-
-        for (i2  = 0; i2 * half_word_incr < len_rhs; i2 += half_word_incr) {
-            ls.l  += v1 * s2[i2];
-            ls.s.l = ls.s.u + ((t[i2] += ls.s.l) < ls.s.l);
-            ls.s.u = 0;
+    // multiply a word at a time, the product of two words and the carries
+    // fit in a 64 bit accumulator
+    for (int i1 = 0; i1 < len_lhs; i1++) {
+        uint64_t v1 = lhs.m_mant[lhs.m_lsw + i1];
+        uint64_t acc = 0;
+
+        int i2;
+        for (i2 = 0; i2 < len_rhs; i2++) {
+            acc += v1 * rhs.m_mant[rhs.m_lsw + i2] + result.m_mant[i1 + i2];
+            result.m_mant[i1 + i2] = static_cast<word>(acc);
+            acc >>= bits_in_word;
         }
 
-        t[i2] = ls.s.l;
-        t += half_word_incr;
+        result.m_mant[i1 + i2] = static_cast<word>(acc);
     }
 
     result.find_sw();
@@ -2049,7 +2036,7 @@ scfx_rep::cast(const scfx_params &params, bool &q_flag, bool &o_flag)
 
 void
 align(const scfx_rep &lhs, const scfx_rep &rhs, int &new_wp,
-      int &len_mant, scfx_mant_ref &lhs_mant, scfx_mant_ref &rhs_mant)
+      int &len_mant, scfx_mant_view &lhs_mant, scfx_mant_view &rhs_mant)
 {
     bool need_lhs = true;
     bool need_rhs = true;
@@ -2066,23 +2053,29 @@ align(const scfx_rep &lhs, const scfx_rep &rhs, int &new_wp,
         new_wp = -lower_bound;
         len_mant = sc_max(min_mant, upper_bound - lower_bound + 1);
 
+        // view the operands as if they had been resized to the new
+        // alignment rather than copying them
         if (new_wp != lhs.m_wp || len_mant != lhs.size()) {
-            lhs_mant = lhs.resize(len_mant, new_wp);
+            int shift = new_wp - lhs.m_wp;
+            lhs_mant.set(lhs.m_mant, shift,
+                         lhs.m_lsw + shift, lhs.m_msw + shift);
             need_lhs = false;
         }
 
         if (new_wp != rhs.m_wp || len_mant != rhs.size()) {
-            rhs_mant = rhs.resize(len_mant, new_wp);
+            int shift = new_wp - rhs.m_wp;
+            rhs_mant.set(rhs.m_mant, shift,
+                         rhs.m_lsw + shift, rhs.m_msw + shift);
             need_rhs = false;
         }
     }
 
     if (need_lhs) {
-        lhs_mant = lhs.m_mant;
+        lhs_mant.set(lhs.m_mant, 0, 0, lhs.size() - 1);
     }
 
     if (need_rhs) {
-        rhs_mant = rhs.m_mant;
+        rhs_mant.set(rhs.m_mant, 0, 0, rhs.size() - 1);
     }
 }
 
@@ -62,6 +62,7 @@ namespace sc_dt
 // classes defined in this module
 class scfx_mant;
 class scfx_mant_ref;
+class scfx_mant_view;
 
 typedef unsigned int word;       // Using int because of 64-bit machines.
 typedef unsigned short half_word;
@@ -409,6 +410,40 @@ scfx_mant_ref::operator [] (int i)
     return (*m_mant)[i];
 }
 
+// ----------------------------------------------------------------------------
+//  CLASS : scfx_mant_view
+//
+//  Read only view of a mantissa shifted by a number of words, which reads
+//  as zero outside of the words [lo, hi] of the view. It lets operands be
+//  aligned without copying their mantissas.
+// ----------------------------------------------------------------------------
+
+class scfx_mant_view
+{
+    const scfx_mant *m_mant;
+    int m_shift;
+    int m_lo;
+    int m_hi;
+
+  public:
+    scfx_mant_view() : m_mant(0), m_shift(0), m_lo(0), m_hi(-1) {}
+
+    void
+    set(const scfx_mant &mant, int shift, int lo, int hi)
+    {
+        m_mant = &mant;
+        m_shift = shift;
+        m_lo = lo;
+        m_hi = hi;
+    }
+
+    word
+    operator [] (int i) const
+    {
+        return (i >= m_lo && i <= m_hi) ? (*m_mant)[i - m_shift] : 0;
+    }
+};
+
 } // namespace sc_dt
 
 
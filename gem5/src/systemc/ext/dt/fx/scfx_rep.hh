@@ -225,7 +225,7 @@ class scfx_rep
 
   private:
     friend void align(const scfx_rep &, const scfx_rep &, int &, int &,
-                      scfx_mant_ref &, scfx_mant_ref &);
+                      scfx_mant_view &, scfx_mant_view &);
     friend int compare_msw(const scfx_rep &, const scfx_rep &);
     friend int compare_msw_ff(const scfx_rep &lhs, const scfx_rep &rhs);
     unsigned int divide_by_ten();
@@ -452,6 +452,19 @@ from_uint(int ulen, sc_digit *u, Type v)
     vec_zero(i, ulen, u);
 }
 
+// v = u
+// - Type is an unsigned type with enough bits for the ulen digits of u.
+template<class Type>
+inline Type
+to_uint(int ulen, const sc_digit *u)
+{
+    Type v = 0;
+
+    while (--ulen >= 0)
+        v = (v << BITS_PER_DIGIT) | u[ulen];
+    return v;
+}
+
 #ifndef __GNUC__
 #  define SC_LIKELY_(x) !!(x)
 #else
@@ -51,6 +51,11 @@ class TlmToGem5BridgeBase(SystemC_ScModule):
 
     gem5 = RequestPort('gem5 request port')
 
+    use_backdoors = Param.Bool(False, "Serve blocking and debug TLM reads "
+        "and writes from the gem5 back doors earlier transactions got, "
+        "without going through the gem5 memory system. Each access is "
+        "charged the latency of the transaction which got its back door.")
+
 
 class Gem5ToTlmBridge32(Gem5ToTlmBridgeBase):
     type = 'Gem5ToTlmBridge32'
@@ -153,9 +153,14 @@ packet2payload(PacketPtr packet)
         trans->set_command(tlm::TLM_IGNORE_COMMAND);
     }
 
-    // Attach the packet pointer to the TLM transaction to keep track.
-    auto *extension = new Gem5SystemC::Gem5Extension(packet);
-    trans->set_auto_extension(extension);
+    // Attach the packet pointer to the TLM transaction to keep track. The
+    // extension stays with the pooled payload, so it's only allocated
+    // once per payload rather than once per packet.
+    auto *extension = trans->get_extension<Gem5SystemC::Gem5Extension>();
+    if (extension)
+        extension->setPacket(packet);
+    else
+        trans->set_extension(new Gem5SystemC::Gem5Extension(packet));
 
     if (packet->isAtomicOp()) {
         auto *atomic_ex = new Gem5SystemC::AtomicExtension(
@@ -56,6 +56,7 @@ class Gem5Extension: public tlm::tlm_extension<Gem5Extension>
     static Gem5Extension &getExtension(
             const tlm::tlm_generic_payload &payload);
     gem5::PacketPtr getPacket();
+    void setPacket(gem5::PacketPtr _packet) { packet = _packet; }
 
   private:
     gem5::PacketPtr packet;
@@ -57,6 +57,7 @@
 
 #include "systemc/tlm_bridge/tlm_to_gem5.hh"
 
+#include <cstring>
 #include <utility>
 
 #include "params/TlmToGem5Bridge32.hh"
@@ -111,7 +112,7 @@ payload2packet(RequestorID _id, tlm::tlm_generic_payload &trans)
         AtomicOpFunctorPtr amo_op = AtomicOpFunctorPtr(
             atomic_ex->getAtomicOpFunctor()->clone());
         // FIXME: correct the context_id and pc state.
-        req = std::make_shared<Request>(
+        req = makeRequest(
             trans.get_address(), trans.get_data_length(), flags, _id,
             0, 0, std::move(amo_op));
         req->setPaddr(trans.get_address());
@@ -131,7 +132,7 @@ payload2packet(RequestorID _id, tlm::tlm_generic_payload &trans)
                             "command");
         }
         Request::Flags flags;
-        req = std::make_shared<Request>(
+        req = makeRequest(
             trans.get_address(), trans.get_data_length(), flags, _id);
     }
 
@@ -273,6 +274,64 @@ TlmToGem5Bridge<BITWIDTH>::invalidateDmi(const gem5::MemBackdoor &backdoor)
             backdoor.range().start(), backdoor.range().end());
 }
 
+template <unsigned int BITWIDTH>
+void
+TlmToGem5Bridge<BITWIDTH>::cacheBackdoor(MemBackdoorPtr backdoor,
+                                         Tick latency)
+{
+    if (!useBackdoors ||
+            backdoorMap.intersects(backdoor->range()) != backdoorMap.end()) {
+        return;
+    }
+
+    backdoorMap.insert(backdoor->range(), {backdoor, latency});
+    backdoor->addInvalidationCallback(
+        [this](const MemBackdoor &backdoor)
+        {
+            auto it = backdoorMap.contains(backdoor.range());
+            if (it != backdoorMap.end() && it->second.backdoor == &backdoor)
+                backdoorMap.erase(it);
+        }
+    );
+}
+
+template <unsigned int BITWIDTH>
+bool
+TlmToGem5Bridge<BITWIDTH>::accessBackdoor(tlm::tlm_generic_payload &trans,
+                                          Tick &latency)
+{
+    if (backdoorMap.empty())
+        return false;
+
+    // Only plain reads and writes, which a packet would carry as they are.
+    unsigned len = trans.get_data_length();
+    if (!(trans.is_read() || trans.is_write()) ||
+            trans.get_byte_enable_ptr() || trans.get_streaming_width() < len ||
+            trans.get_extension<Gem5SystemC::AtomicExtension>() ||
+            !extraPayloadToPacketSteps.empty()) {
+        return false;
+    }
+
+    auto it = backdoorMap.contains(RangeSize(trans.get_address(), len));
+    if (it == backdoorMap.end())
+        return false;
+    MemBackdoorPtr backdoor = it->second.backdoor;
+    if (trans.is_read() ? !backdoor->readable() : !backdoor->writeable())
+        return false;
+
+    uint8_t *ptr = backdoor->ptr() +
+        (trans.get_address() - backdoor->range().start());
+    if (trans.is_read())
+        std::memcpy(trans.get_data_ptr(), ptr, len);
+    else
+        std::memcpy(ptr, trans.get_data_ptr(), len);
+
+    latency = it->second.latency;
+    trans.set_dmi_allowed(true);
+    trans.set_response_status(tlm::TLM_OK_RESPONSE);
+    return true;
+}
+
 template <unsigned int BITWIDTH>
 void
 TlmToGem5Bridge<BITWIDTH>::peq_cb(tlm::tlm_generic_payload &trans,
@@ -331,13 +390,22 @@ TlmToGem5Bridge<BITWIDTH>::b_transport(tlm::tlm_generic_payload &trans,
     if (extension != nullptr) {
         pkt = extension->getPacket();
     } else {
+        Tick latency;
+        if (accessBackdoor(trans, latency)) {
+            t += sc_core::sc_time(
+                    (double)(latency / sim_clock::as_int::ps), sc_core::SC_PS);
+            return;
+        }
         pkt = payload2packet(_id, trans);
     }
 
     MemBackdoorPtr backdoor = nullptr;
     Tick ticks = bmp.sendAtomicBackdoor(pkt, backdoor);
-    if (backdoor)
+    if (backdoor) {
         trans.set_dmi_allowed(true);
+        if (extension == nullptr)
+            cacheBackdoor(backdoor, ticks);
+    }
 
     // send an atomic request to gem5
     panic_if(pkt->needsResponse() && !pkt->isResponse(),
@@ -368,10 +436,13 @@ TlmToGem5Bridge<BITWIDTH>::transport_dbg(tlm::tlm_generic_payload &trans)
     if (extension != nullptr) {
         bmp.sendFunctional(extension->getPacket());
     } else {
-        auto pkt = payload2packet(_id, trans);
-        if (pkt) {
-            bmp.sendFunctional(pkt);
-            destroyPacket(pkt);
+        Tick latency;
+        if (!accessBackdoor(trans, latency)) {
+            auto pkt = payload2packet(_id, trans);
+            if (pkt) {
+                bmp.sendFunctional(pkt);
+                destroyPacket(pkt);
+            }
         }
     }
 
@@ -530,7 +601,7 @@ TlmToGem5Bridge<BITWIDTH>::TlmToGem5Bridge(
     needToSendRetry(false), responseInProgress(false),
     bmp(std::string(name()) + "master", *this), socket("tlm_socket"),
     wrapper(socket, std::string(name()) + ".tlm", InvalidPortID),
-    system(params.system),
+    system(params.system), useBackdoors(params.use_backdoors),
     _id(params.system->getGlobalRequestorId(
                 std::string("[systemc].") + name()))
 {
@@ -60,6 +60,8 @@
 
 #include <functional>
 
+#include "base/addr_range_map.hh"
+#include "mem/backdoor.hh"
 #include "mem/port.hh"
 #include "params/TlmToGem5BridgeBase.hh"
 #include "systemc/ext/core/sc_module.hh"
@@ -147,6 +149,24 @@ class TlmToGem5Bridge : public TlmToGem5BridgeBase
 
     void invalidateDmi(const gem5::MemBackdoor &backdoor);
 
+    /**
+     * Back doors gem5 handed out for earlier blocking transactions, with
+     * the latency of the transaction which returned them. With
+     * use_backdoors set, later plain reads and writes they cover are served
+     * from them directly, without a gem5 packet.
+     */
+    struct CachedBackdoor
+    {
+        gem5::MemBackdoorPtr backdoor;
+        gem5::Tick latency;
+    };
+    gem5::AddrRangeMap<CachedBackdoor> backdoorMap;
+    const bool useBackdoors;
+
+    void cacheBackdoor(gem5::MemBackdoorPtr backdoor, gem5::Tick latency);
+    bool accessBackdoor(tlm::tlm_generic_payload &trans,
+                        gem5::Tick &latency);
+
   protected:
     // payload event call back
     void peq_cb(tlm::tlm_generic_payload &trans, const tlm::tlm_phase &phase);
@@ -0,0 +1,215 @@
+#!/usr/bin/env python3
+
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Convert the binary instruction traces of InstBinTrace into the inputs
+# of the trace driven models:
+#  - a protobuf branch trace, as recorded by BranchTraceProbe and
+#    replayed against branch predictors by BranchTraceReplay
+#  - a binary memory trace of the loads and stores, as recorded by
+#    MemTraceProbe with binary set and replayed by TraceGen
+# e.g.
+#   util/convert_inst_trace.py m5out/inst.trc.gz --branches branch.trc.gz \
+#       --mem mem.trc.gz
+#
+# Records are unpacked a chunk at a time, so that converting a trace of
+# a few billion instructions stays bound by the decompression.
+
+import argparse
+import gzip
+import os
+import struct
+import subprocess
+import sys
+
+import protolib
+
+# Layout of InstBinTrace::Record and its flags, see cpu/inst_bin_trace.hh
+RECORD = struct.Struct('<4QI6H')
+
+CONTROL = 0x1
+CONDITIONAL = 0x2
+CALL = 0x4
+RETURN = 0x8
+INDIRECT = 0x10
+TAKEN = 0x20
+LOAD = 0x40
+STORE = 0x80
+MEM_VALID = 0x100
+MICROOP = 0x200
+LAST_MICROOP = 0x400
+FAULTING = 0x800
+NOT_EXECUTED = 0x1000
+NEXT_VALID = 0x2000
+
+# MemTraceProbe binary record, and the read and write commands of
+# mem/packet.hh
+MEM_RECORD = struct.Struct('<4QIHH')
+READ_REQ = 1
+WRITE_REQ = 4
+
+CHUNK_RECORDS = 65536
+
+def read_header(trace_in):
+    if trace_in.read(4) != b'g5it':
+        sys.exit("Not an InstBinTrace instruction trace")
+    version, rec_size, freq_lo, freq_hi = \
+        struct.unpack('<4I', trace_in.read(16))
+    if version != 1 or rec_size != RECORD.size:
+        sys.exit("Unsupported instruction trace version %d" % version)
+    return freq_lo | freq_hi << 32
+
+def records(trace_in):
+    """Generate the records of the trace as tuples"""
+    chunk_size = CHUNK_RECORDS * RECORD.size
+    while True:
+        chunk = trace_in.read(chunk_size)
+        usable = len(chunk) - len(chunk) % RECORD.size
+        yield from RECORD.iter_unpack(chunk[:usable])
+        if len(chunk) < chunk_size:
+            return
+
+class BranchWriter:
+    """Write the branches in the format of BranchTraceProbe"""
+    def __init__(self, filename, with_uncond):
+        util_dir = os.path.dirname(os.path.realpath(__file__))
+        # Make sure the proto definitions are up to date.
+        subprocess.check_call(['make', '--quiet', '-C', util_dir,
+                               'branch_pb2.py'])
+        import branch_pb2
+        self.branch_pb2 = branch_pb2
+
+        self.out = gzip.open(filename, 'wb') if filename.endswith('.gz') \
+            else open(filename, 'wb')
+        self.out.write(b'gem5')
+        header = branch_pb2.BranchHeader()
+        header.obj_id = 'converted instruction trace'
+        protolib.encodeMessage(self.out, header)
+        self.with_uncond = with_uncond
+        self.count = 0
+
+    def add(self, pc, next_pc, flags, context, fall_through):
+        # branches inside the micro-code of an instruction are not seen
+        # by the branch predictors
+        if not flags & CONTROL or not flags & NEXT_VALID:
+            return
+        if flags & MICROOP and not flags & LAST_MICROOP:
+            return
+        if not self.with_uncond and not flags & CONDITIONAL:
+            return
+
+        branch = self.branch_pb2.Branch()
+        branch.pc = pc
+        branch.taken = bool(flags & TAKEN)
+        branch.target = next_pc
+        branch.fall_through = pc + fall_through
+        kind = ((flags & CONDITIONAL and 0x1) | (flags & CALL and 0x2) |
+                (flags & RETURN and 0x4) | (flags & INDIRECT and 0x8))
+        if kind:
+            branch.flags = kind
+        if context:
+            branch.tid = context
+        protolib.encodeMessage(self.out, branch)
+        self.count += 1
+
+    def close(self):
+        self.out.close()
+
+class MemWriter:
+    """Write the memory accesses in the binary format of MemTraceProbe"""
+    def __init__(self, filename, freq):
+        self.out = gzip.open(filename, 'wb') if filename.endswith('.gz') \
+            else open(filename, 'wb')
+        name = b'inst_trace'
+        self.out.write(b'g5mt' + struct.pack('<5I', 1, MEM_RECORD.size,
+                                             freq & 0xffffffff, freq >> 32,
+                                             1))
+        self.out.write(struct.pack('<I', len(name)) + name)
+        self.buf = []
+        self.count = 0
+
+    def add(self, tick, pc, addr, size, flags):
+        if not flags & MEM_VALID or flags & (FAULTING | NOT_EXECUTED):
+            return
+        cmd = WRITE_REQ if flags & STORE else READ_REQ
+        self.buf.append(MEM_RECORD.pack(tick, addr, pc, 0, size, cmd, 0))
+        self.count += 1
+        if len(self.buf) == CHUNK_RECORDS:
+            self.flush()
+
+    def flush(self):
+        self.out.write(b''.join(self.buf))
+        self.buf = []
+
+    def close(self):
+        self.flush()
+        self.out.close()
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Convert an InstBinTrace instruction trace")
+    parser.add_argument("trace", help="Instruction trace")
+    parser.add_argument("--branches", metavar="FILE",
+        help="Write the branches as a BranchTraceProbe trace")
+    parser.add_argument("--with-uncond", action="store_true",
+        help="Include the unconditional branches, calls and returns")
+    parser.add_argument("--mem", metavar="FILE",
+        help="Write the loads and stores as a binary MemTraceProbe trace")
+    parser.add_argument("--context", type=int,
+        help="Only convert the instructions of this context")
+    args = parser.parse_args()
+
+    if not args.branches and not args.mem:
+        parser.error("Nothing to do, use --branches and/or --mem")
+
+    trace_in = protolib.openFileRd(args.trace)
+    freq = read_header(trace_in)
+
+    branches = BranchWriter(args.branches, args.with_uncond) \
+        if args.branches else None
+    mem = MemWriter(args.mem, freq) if args.mem else None
+
+    num_insts = 0
+    for (tick, pc, addr, next_pc, size, upc, op_class, flags, context,
+         fall_through, _) in records(trace_in):
+        if args.context is not None:
+            if context != args.context:
+                continue
+            context = 0
+        num_insts += 1
+        if branches:
+            branches.add(pc, next_pc, flags, context, fall_through)
+        if mem:
+            mem.add(tick, pc, addr, size, flags)
+
+    print("Instructions:", num_insts)
+    if branches:
+        branches.close()
+        print("Branches:", branches.count)
+    if mem:
+        mem.close()
+        print("Memory accesses:", mem.count)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,198 @@
+#!/usr/bin/env python3
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Convert a checkpoint between the INI text form (m5.cpt) and the binary
+# container (m5.bcpt) written with Root.binary_checkpoints, see
+# src/sim/binary_checkpoint.hh for the layout of the container.
+#
+# gem5 restores from m5.bcpt when a checkpoint directory has both, so
+# remove it after converting a checkpoint to INI text to e.g. upgrade it
+# with cpt_upgrader.py.
+#
+# Converting from INI text doesn't know the types of the arrays, so
+# arrays of integers are stored as 64 bit integers, which gem5 converts to
+# the type restored to, and other entries as text. This keeps the INI text
+# of every entry as it is.
+#
+# e.g.
+#   util/cpt_convert.py --to-ini m5out/cpt.1000
+#   util/cpt_convert.py --to-binary m5out/cpt.1000
+
+import argparse
+import os
+import struct
+import sys
+
+MAGIC = b"gem5bcpt"
+BYTE_ORDER_MARK = 0x01020304
+VERSION = 1
+
+HEADER = struct.Struct("<8sIIQQ")
+ENTRY_HEADER = struct.Struct("<IB3xQ")
+INDEX_HEADER = struct.Struct("<IIQQ")
+
+# BinaryCheckpoint::Type: struct format, or None for text
+TEXT, INT64, UINT64 = 0, 7, 8
+TYPES = [None, "b", "B", "h", "H", "i", "I", "q", "Q", "f", "d"]
+
+def padded(size):
+    return (size + 7) & ~7
+
+def pad(data):
+    return data + b"\0" * (padded(len(data)) - len(data))
+
+def read_ini(path):
+    """Sections of an INI checkpoint, in order, as lists of entries"""
+    sections = {}
+    section = None
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line:
+                continue
+            if line[0] == "[" and line[-1] == "]":
+                section = sections.setdefault(line[1:-1].strip(), {})
+                continue
+            # comments before the first section
+            if section is None:
+                continue
+            name, eq, value = line.partition("=")
+            if not eq:
+                sys.exit("Can't parse line %s of %s" % (line, path))
+            section[name.strip()] = value.strip()
+    return sections
+
+def show(type, value):
+    """An element as ShowParam prints it"""
+    if TYPES[type] in ("f", "d"):
+        return "%g" % value
+    return str(value)
+
+def read_binary(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    magic, bom, version, num_sections, offset = HEADER.unpack_from(data)
+    if magic != MAGIC:
+        sys.exit("%s isn't a binary checkpoint" % path)
+    if bom != BYTE_ORDER_MARK:
+        sys.exit("%s was written on a big endian host" % path)
+    if version != VERSION:
+        sys.exit("%s has unsupported version %d" % (path, version))
+
+    sections = {}
+    for _ in range(num_sections):
+        name_size, num_entries, sec_offset, _ = \
+            INDEX_HEADER.unpack_from(data, offset)
+        offset += INDEX_HEADER.size
+        name = data[offset:offset + name_size].decode()
+        offset += padded(name_size)
+
+        section = sections.setdefault(name, {})
+        for _ in range(num_entries):
+            entry_name_size, type, count = \
+                ENTRY_HEADER.unpack_from(data, sec_offset)
+            sec_offset += ENTRY_HEADER.size
+            entry_name = data[sec_offset:sec_offset + entry_name_size]
+            sec_offset += padded(entry_name_size)
+            if TYPES[type] is None:
+                size = count
+                value = data[sec_offset:sec_offset + size].decode()
+            else:
+                fmt = "<%d%s" % (count, TYPES[type])
+                size = struct.calcsize(fmt)
+                value = " ".join(show(type, v) for v in
+                                 struct.unpack_from(fmt, data, sec_offset))
+            sec_offset += padded(size)
+            section[entry_name.decode()] = value
+    return sections
+
+def write_ini(path, sections):
+    with open(path, "w") as f:
+        f.write("## checkpoint converted by cpt_convert.py\n")
+        for name, entries in sections.items():
+            f.write("\n[%s]\n" % name)
+            for entry, value in entries.items():
+                f.write("%s=%s\n" % (entry, value))
+
+def encode(name, value):
+    """A section entry of the binary container"""
+    tokens = value.split(" ")
+    type = TEXT
+    if len(tokens) > 1:
+        try:
+            ints = [int(token) for token in tokens]
+            # only when the text doesn't change
+            if all(str(i) == t for i, t in zip(ints, tokens)):
+                if all(0 <= i < 2**64 for i in ints):
+                    type = UINT64
+                elif all(-2**63 <= i < 2**63 for i in ints):
+                    type = INT64
+        except ValueError:
+            pass
+    if type == TEXT:
+        data = value.encode()
+        count = len(data)
+    else:
+        data = struct.pack("<%d%s" % (len(ints), TYPES[type]), *ints)
+        count = len(ints)
+    name = name.encode()
+    return ENTRY_HEADER.pack(len(name), type, count) + pad(name) + pad(data)
+
+def write_binary(path, sections):
+    blobs = []
+    index = b""
+    offset = HEADER.size
+    for name, entries in sections.items():
+        blob = b"".join(encode(entry, value)
+                        for entry, value in entries.items())
+        name = name.encode()
+        index += INDEX_HEADER.pack(len(name), len(entries), offset,
+                                   len(blob)) + pad(name)
+        blobs.append(blob)
+        offset += len(blob)
+    with open(path, "wb") as f:
+        f.write(HEADER.pack(MAGIC, BYTE_ORDER_MARK, VERSION, len(sections),
+                            offset))
+        for blob in blobs:
+            f.write(blob)
+        f.write(index)
+
+parser = argparse.ArgumentParser(
+    description="Convert a checkpoint between INI text and binary")
+group = parser.add_mutually_exclusive_group(required=True)
+group.add_argument("--to-ini", action="store_true",
+    help="Convert m5.bcpt to m5.cpt")
+group.add_argument("--to-binary", action="store_true",
+    help="Convert m5.cpt to m5.bcpt")
+parser.add_argument("checkpoint", help="Checkpoint directory")
+args = parser.parse_args()
+
+ini = os.path.join(args.checkpoint, "m5.cpt")
+binary = os.path.join(args.checkpoint, "m5.bcpt")
+if args.to_ini:
+    write_ini(ini, read_binary(binary))
+    print("Wrote %s, remove %s for gem5 to restore from it" % (ini, binary))
+else:
+    write_binary(binary, read_ini(ini))
+    print("Wrote %s" % binary)
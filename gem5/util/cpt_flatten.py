@@ -0,0 +1,234 @@
+#!/usr/bin/env python3
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Flatten the memory of an incremental checkpoint, written with
+# System.memory_checkpoint_incremental, into a single full image, so that
+# it no longer needs the checkpoints its memory deltas are chained to.
+#
+# The memory of an incremental checkpoint is a delta in the chunked
+# format holding the pages dirtied since the previous checkpoint, which
+# refers to the full checkpoint the chain starts from and the deltas
+# written since. The flattened store is written next to the delta, which
+# is kept, as later checkpoints may be chained to it.
+#
+# e.g.
+#   util/cpt_flatten.py m5out/cpt.3000
+#   util/cpt_flatten.py --format image m5out/cpt.3000
+
+import argparse
+import gzip
+import os
+import struct
+import sys
+import zlib
+
+MAGIC = b"gem5mem\0"
+HEADER = struct.Struct("<8sQIIQQ")
+CHUNK_ENTRY = struct.Struct("<4QQQ")
+
+PAGE_BYTES = 4096
+CHUNK_PAGES = 256
+CHUNK_BYTES = PAGE_BYTES * CHUNK_PAGES
+ZERO_PAGE = bytes(PAGE_BYTES)
+
+# store_format of the memory stores
+GZIP, CHUNKED, IMAGE, DELTA = 0, 1, 2, 3
+
+class ChunkedStore:
+    """A store in the chunked format, a full one or a delta"""
+    def __init__(self, path, range_size):
+        self.file = open(path, "rb")
+        header = self.file.read(HEADER.size)
+        if len(header) != HEADER.size:
+            sys.exit("%s isn't in the chunked format" % path)
+        magic, size, self.page_bytes, self.chunk_pages, num_chunks, \
+            table_offset = HEADER.unpack(header)
+        if magic != MAGIC:
+            sys.exit("%s isn't in the chunked format" % path)
+        if size != range_size:
+            sys.exit("%s has size %d rather than %d" %
+                     (path, size, range_size))
+        if (self.page_bytes, self.chunk_pages) != (PAGE_BYTES, CHUNK_PAGES):
+            sys.exit("%s has an unexpected layout" % path)
+        self.file.seek(table_offset)
+        table = self.file.read(num_chunks * CHUNK_ENTRY.size)
+        self.table = [CHUNK_ENTRY.unpack_from(table, i * CHUNK_ENTRY.size)
+                      for i in range(num_chunks)]
+
+    def apply(self, index, chunk):
+        """Copy the pages of a chunk the store has into it"""
+        *mask, offset, size = self.table[index]
+        if size == 0:
+            return
+        self.file.seek(offset)
+        pages = zlib.decompress(self.file.read(size))
+        pos = 0
+        for page in range(self.chunk_pages):
+            if not mask[page // 64] & (1 << (page % 64)):
+                continue
+            start = page * self.page_bytes
+            end = min(start + self.page_bytes, len(chunk))
+            chunk[start:end] = pages[pos:pos + end - start]
+            pos += end - start
+
+class ImageStore:
+    def __init__(self, path, range_size):
+        self.file = open(path, "rb")
+        if os.fstat(self.file.fileno()).st_size != range_size:
+            sys.exit("%s has the wrong size" % path)
+
+    def apply(self, index, chunk):
+        self.file.seek(index * CHUNK_BYTES)
+        chunk[:] = self.file.read(len(chunk))
+
+class GzipStore:
+    """A gzip stream, which can only be read in order"""
+    def __init__(self, path, range_size):
+        self.file = gzip.open(path, "rb")
+
+    def apply(self, index, chunk):
+        data = self.file.read(len(chunk))
+        chunk[:len(data)] = data
+
+def open_store(path, format, range_size):
+    stores = { GZIP: GzipStore, CHUNKED: ChunkedStore, IMAGE: ImageStore }
+    if format not in stores:
+        sys.exit("%s has unsupported format %d" % (path, format))
+    return stores[format](path, range_size)
+
+def flatten(chain, range_size, out_path, out_format):
+    num_chunks = (range_size + CHUNK_BYTES - 1) // CHUNK_BYTES
+    with open(out_path, "wb") as out:
+        if out_format == CHUNKED:
+            out.seek(HEADER.size)
+        else:
+            out.truncate(range_size)
+        table = []
+        for index in range(num_chunks):
+            start = index * CHUNK_BYTES
+            chunk = bytearray(min(CHUNK_BYTES, range_size - start))
+            for store in chain:
+                store.apply(index, chunk)
+
+            # leave the zero pages out, as gem5 does
+            mask = [0] * 4
+            pages = []
+            for page in range(0, len(chunk), PAGE_BYTES):
+                data = bytes(chunk[page:page + PAGE_BYTES])
+                if data == ZERO_PAGE[:len(data)]:
+                    continue
+                if out_format == CHUNKED:
+                    n = page // PAGE_BYTES
+                    mask[n // 64] |= 1 << (n % 64)
+                    pages.append(data)
+                else:
+                    out.seek(start + page)
+                    out.write(data)
+            if out_format == CHUNKED:
+                data = zlib.compress(b"".join(pages), 1) if pages else b""
+                table.append(CHUNK_ENTRY.pack(*mask, out.tell(), len(data)))
+                out.write(data)
+        if out_format == CHUNKED:
+            table_offset = out.tell()
+            out.write(b"".join(table))
+            out.seek(0)
+            out.write(HEADER.pack(MAGIC, range_size, PAGE_BYTES,
+                                  CHUNK_PAGES, num_chunks, table_offset))
+
+def read_ini(path):
+    """The lines of an INI checkpoint, grouped by section"""
+    sections = [(None, [])]
+    with open(path) as f:
+        for line in f:
+            stripped = line.strip()
+            if stripped[:1] == "[" and stripped[-1:] == "]":
+                sections.append((stripped[1:-1].strip(), []))
+            else:
+                sections[-1][1].append(line)
+    return sections
+
+def entries(lines):
+    result = {}
+    for line in lines:
+        name, eq, value = line.partition("=")
+        if eq:
+            result[name.strip()] = value.strip()
+    return result
+
+parser = argparse.ArgumentParser(
+    description="Flatten the memory deltas of an incremental checkpoint")
+parser.add_argument("--format", choices=["chunked", "image"],
+    default="chunked", help="Format of the flattened memory")
+parser.add_argument("checkpoint", help="Checkpoint directory")
+args = parser.parse_args()
+
+cpt_dir = args.checkpoint
+ini = os.path.join(cpt_dir, "m5.cpt")
+if os.path.exists(os.path.join(cpt_dir, "m5.bcpt")):
+    sys.exit("%s is a binary checkpoint, convert it with cpt_convert.py "
+             "--to-ini and remove m5.bcpt first" % cpt_dir)
+
+out_format = CHUNKED if args.format == "chunked" else IMAGE
+sections = read_ini(ini)
+flattened = 0
+for i, (name, lines) in enumerate(sections):
+    values = entries(lines)
+    if int(values.get("store_format", GZIP)) != DELTA:
+        continue
+
+    def path(p):
+        return p if os.path.isabs(p) else os.path.join(cpt_dir, p)
+
+    range_size = int(values["range_size"])
+    chain = [open_store(path(values["delta_base"]),
+                        int(values["delta_base_format"]), range_size)]
+    chain += [ChunkedStore(path(p), range_size)
+              for p in values.get("delta_files", "").split()]
+    chain.append(ChunkedStore(path(values["filename"]), range_size))
+
+    filename = values["filename"] + ".flat"
+    flatten(chain, range_size, os.path.join(cpt_dir, filename), out_format)
+    print("Flattened %s into %s" % (name, filename))
+
+    dropped = ("delta_base", "delta_base_format", "delta_files",
+               "store_format", "filename")
+    lines[:] = [l for l in lines
+                if l.partition("=")[0].strip() not in dropped]
+    # keep the blank line separating the sections last
+    at = len(lines)
+    while at and not lines[at - 1].strip():
+        at -= 1
+    lines[at:at] = ["filename=%s\n" % filename,
+                    "store_format=%d\n" % out_format]
+    flattened += 1
+
+if not flattened:
+    sys.exit("%s has no memory deltas" % cpt_dir)
+
+with open(ini + ".tmp", "w") as f:
+    for name, lines in sections:
+        if name is not None:
+            f.write("[%s]\n" % name)
+        f.writelines(lines)
+os.replace(ini + ".tmp", ini)
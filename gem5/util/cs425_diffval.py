@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Differential validation of a detailed CPU model of cs425_pa3.py against
+# AtomicSimpleCPU.
+#
+# Both models run the benchmark at the same time, each in its own gem5
+# process, and record digests of their architectural state every
+# --interval instructions (see --state-digest-interval). The two digest
+# streams are compared afterwards. On the first mismatch, both models are
+# run again from the last matching instruction count, fast forwarding up
+# to it on AtomicSimpleCPU, with a digest after every instruction, to
+# find the first instruction the models disagree on.
+#
+# The register digests leave out the miscellaneous registers, and the
+# benchmark must not depend on the host time (e.g. through gettimeofday)
+# for the two runs to be comparable.
+#
+# e.g.
+#   util/cs425_diffval.py --gem5 build/X86/gem5.opt \
+#       --bench "benchmarks/bzip2 input.txt" --interval 100000 \
+#       -- --cpu-type=DerivO3CPU --maxinsts=50000000
+
+import argparse
+import concurrent.futures
+import csv
+import os
+import subprocess
+import sys
+
+parser = argparse.ArgumentParser(
+    description="Differential validation of a cs425_pa3.py CPU model")
+parser.add_argument("--gem5", required=True, help="gem5 binary")
+parser.add_argument("--config",
+    default=os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                         os.pardir, "configs", "tutorial", "cs425_pa3.py"),
+    help="Configuration script (default: %(default)s)")
+parser.add_argument("--bench", required=True, metavar="CMD [ARGS]",
+    help="Benchmark to run")
+parser.add_argument("--reference", default="AtomicSimpleCPU",
+    help="CPU model to validate against (default: %(default)s)")
+parser.add_argument("--interval", type=int, default=100000,
+    help="Instructions between two state digests (default: %(default)s)")
+parser.add_argument("--mem-every", type=int, default=16,
+    help="Digest the memory every this many state digests "
+    "(default: %(default)s)")
+parser.add_argument("-d", "--outdir", default="diffval",
+    help="Output directory (default: %(default)s)")
+parser.add_argument("args", nargs=argparse.REMAINDER,
+    help="Options of the model under test, after --. They must include "
+    "--cpu-type")
+args = parser.parse_args()
+test_args = args.args[1:] if args.args[:1] == ["--"] else args.args
+if not any(arg.startswith("--cpu-type") for arg in test_args):
+    parser.error("no --cpu-type for the model under test")
+# every option but the CPU type is shared by the two runs
+common_args = [arg for arg in test_args if not arg.startswith("--cpu-type")]
+ref_args = common_args + ["--cpu-type=%s" % args.reference]
+
+exe, _, opts = args.bench.strip().partition(" ")
+
+def gem5(outdir, model_args, extra):
+    os.makedirs(outdir, exist_ok=True)
+    cmd = [args.gem5, "-re", "-d", outdir, args.config,
+           "--cmd=%s" % exe, "--options=%s" % opts.strip()] + \
+          model_args + extra
+    with open(os.path.join(outdir, "cmdline"), "w") as f:
+        f.write(" ".join(cmd) + "\n")
+    subprocess.call(cmd, stdout=subprocess.DEVNULL,
+                    stderr=subprocess.DEVNULL)
+    try:
+        with open(os.path.join(outdir, "state_digest.csv")) as f:
+            return list(csv.DictReader(f))
+    except OSError:
+        sys.exit("No state digests in %s, see %s" %
+                 (outdir, os.path.join(outdir, "simerr")))
+
+def run_both(name, extra):
+    with concurrent.futures.ThreadPoolExecutor(max_workers=2) as pool:
+        test = pool.submit(gem5, os.path.join(args.outdir, name, "test"),
+                           test_args, extra)
+        ref = pool.submit(gem5, os.path.join(args.outdir, name, "ref"),
+                          ref_args, extra)
+        return test.result(), ref.result()
+
+def first_mismatch(test, ref):
+    """Index of the first digest the runs disagree on, and what differs"""
+    for i, (t, r) in enumerate(zip(test, ref)):
+        if t["insts"] != r["insts"]:
+            return i, "instruction count"
+        if t["regs"] != r["regs"]:
+            return i, "registers"
+        if t["mem"] and r["mem"] and t["mem"] != r["mem"]:
+            return i, "memory"
+    if len(test) != len(ref):
+        return min(len(test), len(ref)), "program end"
+    return None, None
+
+print("Running %s and %s" % (" ".join(test_args), args.reference))
+test, ref = run_both("full", ["--state-digest-interval=%d" % args.interval,
+                              "--state-digest-mem-every=%d" % args.mem_every])
+i, what = first_mismatch(test, ref)
+if i is None:
+    print("No divergence in %d state digests" % len(test))
+    sys.exit(0)
+
+good = int(test[i - 1]["insts"]) if i > 0 else 0
+print("The %s diverge between instructions %d and %d" %
+      (what, good, good + args.interval))
+if what == "memory":
+    # the registers agree at every instruction of the window, only a
+    # memory digest per instruction could narrow it down further
+    print("The registers match, look for a store in that window")
+    sys.exit(1)
+
+# rerun the window with a register digest after every instruction
+extra = ["--state-digest-interval=1", "--state-digest-mem-every=0",
+         "--maxinsts=%d" % args.interval]
+if good:
+    extra += ["--fast-forward=%d" % good]
+test, ref = run_both("window", extra)
+j, what = first_mismatch(test, ref)
+if j is None:
+    print("No divergence when replaying the window, the models may depend "
+          "on the host time")
+    sys.exit(1)
+print("First divergence of the %s after instruction %s" %
+      (what, ref[j]["insts"] if j < len(ref) else test[j]["insts"]))
+if j < len(test) and j < len(ref):
+    print("  %s @ tick %s, %s @ tick %s" %
+          (args.reference, ref[j]["tick"], "test", test[j]["tick"]))
+print("Rerun %s with --debug-flags=Exec to see the instruction" %
+      os.path.join(args.outdir, "window", "test", "cmdline"))
+sys.exit(1)
@@ -0,0 +1,226 @@
+#!/usr/bin/env python3
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Host performance regression suite: run a fixed, short window of each of
+# the five PA3 benchmarks on every CPU model, with the classic caches of
+# cs425_pa3.py and, given a gem5 binary built with a Ruby protocol, with
+# Ruby through configs/example/se.py. The host instruction and tick
+# rates, the peak resident set size and the startup time (the wall clock
+# time not spent in the simulation loop) of every run are written to
+# results.csv, and compared against a baseline results.csv, e.g. one of
+# the parent commit, when given. A rate more than --tolerance below the
+# baseline, or a peak RSS or startup time more than --tolerance above it,
+# is a regression.
+#
+# The runs are timed one at a time by default, as concurrent runs compete
+# for the host caches and memory bandwidth.
+#
+# e.g.
+#   util/cs425_hostperf.py --gem5 build/X86/gem5.opt -d hostperf-base
+#   (apply the change and rebuild)
+#   util/cs425_hostperf.py --gem5 build/X86/gem5.opt -d hostperf \
+#       --baseline hostperf-base/results.csv
+
+import argparse
+import concurrent.futures
+import csv
+import os
+import subprocess
+import sys
+import time
+
+GEM5_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                        os.pardir)
+
+# the benchmarks of benchmarks/runall.sh, relative to its directory
+BENCHMARKS = [
+    ("benchmark1", "./benchmark1/benchmark1", ""),
+    ("benchmark2", "./benchmark2/bin/benchmark", "./benchmark2/data/inp.in"),
+    ("benchmark3", "./benchmark3/bin/benchmark",
+     "./benchmark3/data/bombesin.hmm.new"),
+    ("benchmark4", "./benchmark4/bin/benchmark", "./benchmark4/data/test.txt"),
+    ("benchmark5", "./benchmark5/bin/benchmark",
+     "20 reference.dat 0 1 ./benchmark5/data/100_100_130_cf_a.of"),
+]
+
+CPUS = ["AtomicSimpleCPU", "TimingSimpleCPU", "MinorCPU", "O3CPU"]
+
+# metric, stat it is read from, whether larger is better
+METRICS = [
+    ("host_inst_rate", "hostInstRate", True),
+    ("host_tick_rate", "hostTickRate", True),
+    ("peak_rss_kb", None, False),
+    ("startup_s", None, False),
+]
+
+parser = argparse.ArgumentParser(
+    description="Host performance regression suite of the PA3 benchmarks")
+parser.add_argument("--gem5", required=True,
+    help="gem5 binary for the classic memory runs")
+parser.add_argument("--gem5-ruby", default=None,
+    help="gem5 binary built with a Ruby protocol for the Ruby runs, "
+    "skipped without it")
+parser.add_argument("--benchmarks",
+    default=os.path.join(GEM5_DIR, os.pardir, "benchmarks"),
+    help="Directory of the PA3 benchmarks (default: %(default)s)")
+parser.add_argument("--cpu", action="append", default=[],
+    help="CPU model to run, may be repeated (default: %s)" % ", ".join(CPUS))
+parser.add_argument("--bench", action="append", default=[],
+    help="Benchmark to run, may be repeated (default: all five)")
+parser.add_argument("-I", "--maxinsts", type=int, default=2000000,
+    help="Instructions simulated per run (default: %(default)s)")
+parser.add_argument("--baseline", default=None,
+    help="results.csv of a previous run to compare against")
+parser.add_argument("--tolerance", type=float, default=0.1,
+    help="Relative change from the baseline that is a regression "
+    "(default: %(default)s)")
+parser.add_argument("-j", "--jobs", type=int, default=1,
+    help="Number of simulations to run in parallel (default: %(default)s)")
+parser.add_argument("-d", "--outdir", default="hostperf",
+    help="Output directory (default: %(default)s)")
+args = parser.parse_args()
+
+cpus = args.cpu or CPUS
+benchmarks = [b for b in BENCHMARKS if not args.bench or b[0] in args.bench]
+if args.bench and len(benchmarks) != len(args.bench):
+    parser.error("unknown benchmark in %s" % ", ".join(args.bench))
+outdir_root = os.path.abspath(args.outdir)
+
+def command(outdir, bench, cpu, memory):
+    _, exe, opts = bench
+    common = ["--cmd=%s" % exe, "--options=%s" % opts,
+              "--cpu-type=%s" % cpu, "--maxinsts=%d" % args.maxinsts]
+    if memory == "classic":
+        return [args.gem5, "-re", "-d", outdir,
+                os.path.join(GEM5_DIR, "configs", "tutorial",
+                             "cs425_pa3.py")] + common
+    return [args.gem5_ruby, "-re", "-d", outdir,
+            os.path.join(GEM5_DIR, "configs", "example", "se.py"),
+            "--ruby"] + common
+
+def read_stats(path):
+    values = {}
+    try:
+        with open(path) as f:
+            for line in f:
+                if line.startswith("---------- End"):
+                    break
+                fields = line.split()
+                if len(fields) >= 2:
+                    values[fields[0]] = fields[1]
+    except OSError:
+        pass
+    return values
+
+def run(bench, cpu, memory):
+    outdir = os.path.join(outdir_root, bench[0], "%s-%s" % (cpu, memory))
+    os.makedirs(outdir, exist_ok=True)
+    cmd = command(outdir, bench, cpu, memory)
+    with open(os.path.join(outdir, "cmdline"), "w") as f:
+        f.write(" ".join(cmd) + "\n")
+    # the benchmark options are relative to the benchmarks directory
+    start = time.monotonic()
+    proc = subprocess.Popen(cmd, cwd=args.benchmarks,
+                            stdout=subprocess.DEVNULL,
+                            stderr=subprocess.DEVNULL)
+    # the peak RSS of this child only, unlike RUSAGE_CHILDREN
+    _, status, usage = os.wait4(proc.pid, 0)
+    wall = time.monotonic() - start
+
+    stats = read_stats(os.path.join(outdir, "stats.txt"))
+    if status != 0 or "hostSeconds" not in stats:
+        return dict(status="failed")
+    result = {metric: stats[stat] for metric, stat, _ in METRICS if stat}
+    result["peak_rss_kb"] = usage.ru_maxrss
+    result["startup_s"] = "%.3f" % (wall - float(stats["hostSeconds"]))
+    result["status"] = "ok"
+    return result
+
+runs = [(bench, cpu, "classic") for bench in benchmarks for cpu in cpus]
+if args.gem5_ruby:
+    # Ruby only supports timing accesses
+    runs += [(bench, cpu, "ruby") for bench in benchmarks for cpu in cpus
+             if cpu != "AtomicSimpleCPU"]
+
+print("Running %d simulations of %d instructions" %
+      (len(runs), args.maxinsts))
+with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as pool:
+    futures = [pool.submit(run, *r) for r in runs]
+    rows = []
+    for (bench, cpu, memory), future in zip(runs, futures):
+        result = future.result()
+        rows.append(dict(result, benchmark=bench[0], cpu=cpu,
+                         memory=memory))
+
+header = ["benchmark", "cpu", "memory"] + \
+         [metric for metric, _, _ in METRICS] + ["status"]
+os.makedirs(outdir_root, exist_ok=True)
+with open(os.path.join(outdir_root, "results.csv"), "w", newline="") as f:
+    writer = csv.DictWriter(f, header, restval="")
+    writer.writeheader()
+    writer.writerows(rows)
+
+def key(row):
+    return row["benchmark"], row["cpu"], row["memory"]
+
+regressions = []
+baseline = {}
+if args.baseline:
+    with open(args.baseline) as f:
+        baseline = {key(row): row for row in csv.DictReader(f)}
+
+table = [["run"] + [metric for metric, _, _ in METRICS]]
+for row in rows:
+    base = baseline.get(key(row))
+    cells = ["/".join(key(row))]
+    for metric, _, higher_better in METRICS:
+        value = row.get(metric, "")
+        if not value:
+            cells.append(row["status"])
+            continue
+        cell = str(value)
+        if base and base.get(metric):
+            old = float(base[metric])
+            change = (float(value) - old) / old if old else 0.0
+            cell += " (%+.1f%%)" % (100 * change)
+            if (-change if higher_better else change) > args.tolerance:
+                cell += " !"
+                regressions.append("%s %s" % (cells[0], metric))
+        cells.append(cell)
+    table.append(cells)
+
+widths = [max(len(row[i]) for row in table) for i in range(len(table[0]))]
+for row in table:
+    print("  ".join(c.ljust(w) for c, w in zip(row, widths)))
+
+failed = [row for row in rows if row["status"] != "ok"]
+if failed:
+    print("%d runs failed, see their simerr in %s" %
+          (len(failed), outdir_root))
+if regressions:
+    print("%d regressions beyond %.0f%% of %s:" %
+          (len(regressions), 100 * args.tolerance, args.baseline))
+    for regression in regressions:
+        print("  " + regression)
+sys.exit(1 if failed or regressions else 0)
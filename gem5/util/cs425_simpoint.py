@@ -0,0 +1,338 @@
+#!/usr/bin/env python3
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# SimPoint sampled simulation of configs/tutorial/cs425_pa3.py.
+#
+# For every benchmark, this
+#  1. profiles the basic block vectors (BBVs) of the whole program with
+#     the atomic CPU,
+#  2. clusters the BBVs the way SimPoint 3.2 does (random projection,
+#     k-means and the BIC to pick the number of clusters), and picks the
+#     interval closest to the centre of each cluster as its simpoint,
+#  3. takes a checkpoint ahead of every simpoint with the atomic CPU,
+#  4. simulates every simpoint from its checkpoint in detail, after a
+#     detailed warmup, on all host cores,
+#  5. weights the statistics of the simpoints by the size of their
+#     clusters to estimate the statistics of the whole program.
+#
+# The first three steps only depend on the benchmark and are reused by
+# later runs with the same output directory, so a sweep over the
+# detailed configuration only pays for step 4.
+#
+# e.g.
+#   util/cs425_simpoint.py --gem5 build/X86/gem5.opt \
+#       --bench "mcf=benchmarks/mcf inp.in" \
+#       -- --cpu-type=O3CPU --l1d_assoc=4 --bp-type=TournamentBP
+
+import argparse
+import concurrent.futures
+import csv
+import gzip
+import math
+import os
+import random
+import re
+import subprocess
+import sys
+
+DEFAULT_STATS = [
+    "system.cpu.cpi",
+    "system.cpu.dcache.overallMissRate::total",
+    "system.l2cache.overallMissRate::total",
+    "system.cpu.branchPred.condIncorrect",
+]
+
+parser = argparse.ArgumentParser(
+    description="SimPoint sampled simulation of cs425_pa3.py")
+parser.add_argument("--gem5", required=True, help="gem5 binary")
+parser.add_argument("--config",
+    default=os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                         os.pardir, "configs", "tutorial", "cs425_pa3.py"),
+    help="Configuration script (default: %(default)s)")
+parser.add_argument("--bench", action="append", default=[], required=True,
+    metavar="NAME=CMD [ARGS]",
+    help="Benchmark to run, may be repeated")
+parser.add_argument("--interval", type=int, default=10000000,
+    help="Instructions per interval (default: %(default)s)")
+parser.add_argument("--warmup", type=int, default=1000000,
+    help="Detailed warmup before every simpoint, in instructions "
+    "(default: %(default)s)")
+parser.add_argument("--max-k", type=int, default=10,
+    help="Maximum number of simpoints (default: %(default)s)")
+parser.add_argument("--dims", type=int, default=15,
+    help="Dimensions the BBVs are projected to (default: %(default)s)")
+parser.add_argument("--bic-threshold", type=float, default=0.9,
+    help="Pick the smallest number of clusters whose BIC reaches this "
+    "fraction of the range of BICs (default: %(default)s)")
+parser.add_argument("--seed", type=int, default=1,
+    help="Seed of the projection and the clustering (default: %(default)s)")
+parser.add_argument("--fast-args", default="",
+    help="Options for the profiling and checkpointing runs, which always "
+    "use the atomic CPU, e.g. a non default --mem-size")
+parser.add_argument("--stat", action="append", default=[],
+    help="Statistic to estimate, may be repeated (default: %s)" %
+    ", ".join(DEFAULT_STATS))
+parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count(),
+    help="Number of simulations to run in parallel (default: %(default)s)")
+parser.add_argument("-d", "--outdir", default="simpoint",
+    help="Output directory (default: %(default)s)")
+parser.add_argument("args", nargs=argparse.REMAINDER,
+    help="Options of the detailed runs, after --")
+
+args = parser.parse_args()
+detailed_args = args.args[1:] if args.args[:1] == ["--"] else args.args
+fast_args = args.fast_args.split() + ["--cpu-type=AtomicSimpleCPU"]
+stats = args.stat or DEFAULT_STATS
+
+benchmarks = []
+for bench in args.bench:
+    name, sep, cmd = bench.partition("=")
+    if not sep or not cmd.split():
+        parser.error("invalid benchmark '%s'" % bench)
+    exe, _, opts = cmd.strip().partition(" ")
+    benchmarks.append((name, exe, opts.strip()))
+
+def gem5(outdir, bench, extra):
+    name, exe, opts = bench
+    os.makedirs(outdir, exist_ok=True)
+    cmd = [args.gem5, "-re", "-d", outdir, args.config,
+           "--cmd=%s" % exe, "--options=%s" % opts] + extra
+    with open(os.path.join(outdir, "cmdline"), "w") as f:
+        f.write(" ".join(cmd) + "\n")
+    return subprocess.call(cmd, stdout=subprocess.DEVNULL,
+                           stderr=subprocess.DEVNULL) == 0
+
+def read_bbvs(path):
+    """Read the BBV of every interval, normalized to frequencies."""
+    bbvs = []
+    with gzip.open(path, "rt") as f:
+        for line in f:
+            if not line.startswith("T"):
+                continue
+            counts = {}
+            for field in line[1:].split():
+                _, bb, count = field.split(":")
+                counts[int(bb)] = int(count)
+            total = sum(counts.values())
+            if total:
+                bbvs.append({bb: c / total for bb, c in counts.items()})
+    return bbvs
+
+def project(bbvs):
+    """Random linear projection of the BBVs to args.dims dimensions."""
+    columns = {}
+    points = []
+    for bbv in bbvs:
+        point = [0.0] * args.dims
+        for bb, freq in bbv.items():
+            column = columns.get(bb)
+            if column is None:
+                rng = random.Random(args.seed * 1000003 + bb)
+                column = [rng.uniform(-1, 1) for _ in range(args.dims)]
+                columns[bb] = column
+            for d in range(args.dims):
+                point[d] += freq * column[d]
+        points.append(point)
+    return points
+
+def distance(a, b):
+    return sum((x - y) * (x - y) for x, y in zip(a, b))
+
+def kmeans(points, k, rng, iterations=100):
+    centres = [list(p) for p in rng.sample(points, k)]
+    labels = [0] * len(points)
+    for iteration in range(iterations):
+        new_labels = [min(range(k), key=lambda c: distance(p, centres[c]))
+                      for p in points]
+        if new_labels == labels and iteration:
+            break
+        labels = new_labels
+        for c in range(k):
+            members = [p for p, l in zip(points, labels) if l == c]
+            if members:
+                centres[c] = [sum(x) / len(members) for x in zip(*members)]
+            else:
+                # restart an empty cluster at the worst placed point
+                worst = max(range(len(points)), key=lambda i:
+                            distance(points[i], centres[labels[i]]))
+                centres[c] = list(points[worst])
+    distortion = sum(distance(p, centres[l]) for p, l in zip(points, labels))
+    return labels, centres, distortion
+
+def bic(points, labels, k, distortion):
+    """Bayesian information criterion of a clustering, as in X-means."""
+    n, dims = len(points), len(points[0])
+    if n <= k:
+        return float("-inf")
+    variance = max(distortion / (n - k), 1e-300) / dims
+    likelihood = 0.0
+    for c in range(k):
+        size = labels.count(c)
+        if not size:
+            continue
+        likelihood += size * math.log(size / n) - \
+            size * dims / 2 * math.log(2 * math.pi * variance) - \
+            (size - k) / 2
+    parameters = (k - 1) + k * dims + 1
+    return likelihood - parameters / 2 * math.log(n)
+
+def cluster(points):
+    """Return the (interval, weight) of the simpoints of the points."""
+    rng = random.Random(args.seed)
+    runs = []
+    for k in range(1, min(args.max_k, len(points)) + 1):
+        # keep the best of a few initializations
+        labels, centres, distortion = min(
+            (kmeans(points, k, rng) for _ in range(5)), key=lambda r: r[2])
+        runs.append((bic(points, labels, k, distortion), labels, centres))
+
+    scores = [r[0] for r in runs]
+    low, high = min(scores), max(scores)
+    for score, labels, centres in runs:
+        if high == low or (score - low) / (high - low) >= args.bic_threshold:
+            break
+
+    simpoints = []
+    for c, centre in enumerate(centres):
+        members = [i for i, l in enumerate(labels) if l == c]
+        if members:
+            closest = min(members, key=lambda i: distance(points[i], centre))
+            simpoints.append((closest, len(members) / len(points)))
+    return sorted(simpoints)
+
+def read_last_dump(path):
+    """Values of the statistics in the last dump of a stats file."""
+    values = {}
+    try:
+        with open(path) as f:
+            for line in f:
+                if line.startswith("---------- Begin"):
+                    values = {}
+                fields = line.split()
+                if len(fields) >= 2 and fields[0] in stats:
+                    values[fields[0]] = float(fields[1])
+    except (OSError, ValueError):
+        pass
+    return values
+
+def prepare(bench):
+    """Profile, cluster and checkpoint a benchmark, unless already done."""
+    root = os.path.join(args.outdir, bench[0])
+    profile = os.path.join(root, "profile")
+    bbv_file = os.path.join(profile, "simpoint.bb.gz")
+    simpoint_file = os.path.join(root, "simpoints")
+    weight_file = os.path.join(root, "weights")
+    cpt_dir = os.path.join(root, "checkpoints")
+
+    if not os.path.isfile(bbv_file):
+        if not gem5(profile, bench, fast_args + ["--simpoint-profile",
+                "--simpoint-interval=%d" % args.interval]):
+            return None, "profiling failed, see %s" % profile
+
+    if not os.path.isfile(weight_file):
+        points = project(read_bbvs(bbv_file))
+        if not points:
+            return None, "no complete interval in %s" % bbv_file
+        simpoints = cluster(points)
+        with open(simpoint_file, "w") as f:
+            for c, (interval, _) in enumerate(simpoints):
+                f.write("%d %d\n" % (interval, c))
+        with open(weight_file, "w") as f:
+            for c, (_, weight) in enumerate(simpoints):
+                f.write("%f %d\n" % (weight, c))
+        print("%s: %d simpoints out of %d intervals" %
+              (bench[0], len(simpoints), len(points)))
+
+    cpts = [d for d in os.listdir(cpt_dir) if d.startswith("cpt.simpoint_")] \
+        if os.path.isdir(cpt_dir) else []
+    if not cpts:
+        if not gem5(cpt_dir, bench, fast_args + [
+                "--take-simpoint-checkpoints=%s,%s,%d,%d" % (
+                    os.path.abspath(simpoint_file),
+                    os.path.abspath(weight_file),
+                    args.interval, args.warmup)]):
+            return None, "checkpointing failed, see %s" % cpt_dir
+        cpts = [d for d in os.listdir(cpt_dir)
+                if d.startswith("cpt.simpoint_")]
+
+    # same order as the -r numbering of cs425_pa3.py
+    weights = [float(re.search(r"_weight_([\d.e-]+)_", d).group(1))
+               for d in sorted(cpts)]
+    return (cpt_dir, weights), None
+
+with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as pool:
+    print("Preparing the simpoints of %d benchmarks" % len(benchmarks))
+    prepared = list(pool.map(prepare, benchmarks))
+    for bench, (_, error) in zip(benchmarks, prepared):
+        if error:
+            sys.exit("%s: %s" % (bench[0], error))
+
+    runs = []
+    for bench, ((cpt_dir, weights), _) in zip(benchmarks, prepared):
+        for i, weight in enumerate(weights):
+            outdir = os.path.join(args.outdir, bench[0], "run",
+                                  "simpoint_%02d" % i)
+            runs.append((bench, weight, outdir, pool.submit(
+                gem5, outdir, bench, detailed_args + [
+                    "--restore-simpoint-checkpoint",
+                    "--checkpoint-restore=%d" % (i + 1),
+                    "--checkpoint-dir=%s" % os.path.abspath(cpt_dir)])))
+    print("Simulating %d simpoints on %d cores" % (len(runs), args.jobs))
+
+    results = {bench[0]: {} for bench in benchmarks}
+    status = {bench[0]: "ok" for bench in benchmarks}
+    for bench, weight, outdir, future in runs:
+        ok = future.result()
+        values = read_last_dump(os.path.join(outdir, "stats.txt"))
+        if not ok or not values:
+            status[bench[0]] = "failed, see %s" % outdir
+            continue
+        # weighted sums, renormalized over the simpoints with the stat
+        for stat, value in values.items():
+            total, weights = results[bench[0]].get(stat, (0.0, 0.0))
+            results[bench[0]][stat] = (total + weight * value,
+                                       weights + weight)
+
+columns = stats + (["system.cpu.ipc"] if "system.cpu.cpi" in stats else [])
+rows = []
+for bench in benchmarks:
+    estimates = {stat: total / weights for stat, (total, weights) in
+                 results[bench[0]].items() if weights}
+    # the IPC of the program is the inverse of the weighted CPI
+    if estimates.get("system.cpu.cpi"):
+        estimates["system.cpu.ipc"] = 1 / estimates["system.cpu.cpi"]
+    rows.append([bench[0]] +
+                ["%g" % estimates[s] if s in estimates else ""
+                 for s in columns] + [status[bench[0]]])
+
+header = ["benchmark"] + columns + ["status"]
+with open(os.path.join(args.outdir, "results.csv"), "w", newline="") as f:
+    writer = csv.writer(f)
+    writer.writerow(header)
+    writer.writerows(rows)
+
+widths = [max(len(str(row[i])) for row in [header] + rows)
+          for i in range(len(header))]
+for row in [header] + rows:
+    print("  ".join(str(c).ljust(w) for c, w in zip(row, widths)))
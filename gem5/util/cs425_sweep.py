@@ -0,0 +1,258 @@
+#!/usr/bin/env python3
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Run a parameter sweep of configs/tutorial/cs425_pa3.py on all host cores.
+#
+# Every benchmark is initialized once per group of configurations that can
+# share a checkpoint (by default, configurations that only differ in their
+# cache and prefetcher options), and every point of the grid is then run
+# from that checkpoint. The requested statistics of all the runs are
+# collected in a single table.
+#
+# e.g. the L1D associativity / replacement policy study of Task 1:
+#   util/cs425_sweep.py --gem5 build/X86/gem5.opt \
+#       --bench "bzip2=benchmarks/bzip2 input.txt" \
+#       --bench "mcf=benchmarks/mcf inp.in" \
+#       --grid l1d_assoc=1,2,4,8 --grid rp-type=LRURP,RandomRP \
+#       -- --cpu-type=DerivO3CPU --maxinsts=10000000
+#
+# With --param-grid, the grid is over parameters of the configured
+# objects instead: every point of the option grid is configured once in
+# Python, and the parameter points are run from its config.ini by
+# configs/tutorial/cs425_cached.py, skipping the Python configuration
+# (gem5 must be built with --with-cxx-config). e.g.
+#   util/cs425_sweep.py --gem5 build/X86/gem5.opt --bench ... \
+#       --param-grid system.cpu.numROBEntries=32,64,128 \
+#       -- --cpu-type=DerivO3CPU --maxinsts=10000000
+
+import argparse
+import concurrent.futures
+import csv
+import hashlib
+import itertools
+import os
+import re
+import subprocess
+import sys
+
+# cs425_pa3.py options that do not change the checkpointed state
+RESTORABLE = [
+    "l1i_size", "l1d_size", "l2_size", "l1i_assoc", "l1d_assoc", "l2_assoc",
+    "cacheline_size", "rp-type", "l1i-hwp-type", "l1d-hwp-type",
+    "l2-hwp-type", "pref_degree", "pref_feedback_interval",
+]
+
+DEFAULT_STATS = [
+    "simInsts", "system.cpu.ipc",
+    "system.cpu.dcache.overallMissRate::total",
+    "system.l2cache.overallMissRate::total",
+]
+
+parser = argparse.ArgumentParser(
+    description="Parallel parameter sweep of cs425_pa3.py")
+parser.add_argument("--gem5", required=True, help="gem5 binary")
+parser.add_argument("--config",
+    default=os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                         os.pardir, "configs", "tutorial", "cs425_pa3.py"),
+    help="Configuration script (default: %(default)s)")
+parser.add_argument("--bench", action="append", default=[], required=True,
+    metavar="NAME=CMD [ARGS]",
+    help="Benchmark to run, may be repeated")
+parser.add_argument("--grid", action="append", default=[],
+    metavar="OPTION=V1,V2,...",
+    help="Values of a cs425_pa3.py option to sweep, may be repeated")
+parser.add_argument("--param-grid", action="append", default=[],
+    metavar="OBJ.PARAM=V1,V2,...",
+    help="Values of a parameter of config.ini to sweep from the "
+    "configuration of every point of --grid, may be repeated")
+parser.add_argument("--restorable", default=",".join(RESTORABLE),
+    help="Comma separated options that configurations sharing a "
+    "checkpoint may differ in (default: %(default)s)")
+parser.add_argument("--stat", action="append", default=[],
+    help="Statistic to collect, may be repeated (default: %s)" %
+    ", ".join(DEFAULT_STATS))
+parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count(),
+    help="Number of simulations to run in parallel (default: %(default)s)")
+parser.add_argument("-d", "--outdir", default="sweep",
+    help="Output directory (default: %(default)s)")
+parser.add_argument("args", nargs=argparse.REMAINDER,
+    help="Options passed to every run, after --")
+
+args = parser.parse_args()
+common_args = args.args[1:] if args.args[:1] == ["--"] else args.args
+restorable = set(args.restorable.split(","))
+stats = args.stat or DEFAULT_STATS
+
+benchmarks = []
+for bench in args.bench:
+    name, sep, cmd = bench.partition("=")
+    if not sep or not cmd.split():
+        parser.error("invalid benchmark '%s'" % bench)
+    exe, _, opts = cmd.strip().partition(" ")
+    benchmarks.append((name, exe, opts.strip()))
+
+grid = []
+for sweep in args.grid:
+    option, sep, values = sweep.partition("=")
+    if not sep or not values:
+        parser.error("invalid grid '%s'" % sweep)
+    grid.append([(option, value) for value in values.split(",")])
+
+param_grid = []
+for sweep in args.param_grid:
+    param, sep, values = sweep.partition("=")
+    if not sep or not values:
+        parser.error("invalid parameter grid '%s'" % sweep)
+    param_grid.append([(param, value) for value in values.split(",")])
+
+def option_args(point):
+    return ["--%s=%s" % option for option in point]
+
+def point_name(point):
+    name = "-".join("%s_%s" % option for option in point) or "default"
+    return re.sub(r"[^\w.=-]", "_", name)
+
+def checkpoint_name(bench, point):
+    shared = [option for option in point if option[0] not in restorable]
+    key = repr((bench, common_args, shared)).encode()
+    return "%s-%s" % (bench, hashlib.sha1(key).hexdigest()[:12])
+
+def run(outdir, cmd):
+    os.makedirs(outdir, exist_ok=True)
+    with open(os.path.join(outdir, "cmdline"), "w") as f:
+        f.write(" ".join(cmd) + "\n")
+    return subprocess.call(cmd, stdout=subprocess.DEVNULL,
+                           stderr=subprocess.DEVNULL) == 0
+
+def gem5(outdir, bench, point, extra):
+    name, exe, opts = bench
+    return run(outdir, [args.gem5, "-re", "-d", outdir, args.config,
+                        "--cmd=%s" % exe, "--options=%s" % opts] +
+               common_args + option_args(point) + extra)
+
+def gem5_cached(outdir, config_ini, param_point):
+    cached = os.path.join(os.path.dirname(os.path.abspath(args.config)),
+                          "cs425_cached.py")
+    return run(outdir, [args.gem5, "-re", "-d", outdir, cached, config_ini] +
+               ["--param=%s=%s" % param for param in param_point])
+
+def read_stats(path):
+    values = {}
+    try:
+        with open(path) as f:
+            for line in f:
+                fields = line.split()
+                # only keep the first dump
+                if line.startswith("---------- End"):
+                    break
+                if len(fields) >= 2 and fields[0] in stats:
+                    values[fields[0]] = fields[1]
+    except OSError:
+        pass
+    return values
+
+points = list(itertools.product(*grid))
+param_points = list(itertools.product(*param_grid))
+ckpt_root = os.path.join(args.outdir, "checkpoints")
+
+def sweep_checkpoints(pool):
+    """Run the points from a post-init checkpoint of each group of them"""
+    # One checkpoint per benchmark and group of points that can share it
+    checkpoints = {}
+    for bench, point in itertools.product(benchmarks, points):
+        name = checkpoint_name(bench[0], point)
+        checkpoints.setdefault(name, (bench, point))
+
+    print("Taking %d post-init checkpoints" % len(checkpoints))
+    futures = {}
+    for name, (bench, point) in checkpoints.items():
+        cpt_dir = os.path.abspath(os.path.join(ckpt_root, name))
+        if os.path.isfile(os.path.join(cpt_dir, "m5.cpt")):
+            continue
+        futures[name] = pool.submit(gem5, cpt_dir + "-init", bench, point,
+                                    ["--init-checkpoint=%s" % cpt_dir])
+    for name, future in futures.items():
+        if not future.result():
+            sys.exit("Could not take checkpoint %s, see %s-init" %
+                     (name, os.path.join(ckpt_root, name)))
+
+    print("Running %d simulations on %d cores" %
+          (len(benchmarks) * len(points), args.jobs))
+    runs = []
+    for bench, point in itertools.product(benchmarks, points):
+        cpt_dir = os.path.abspath(
+            os.path.join(ckpt_root, checkpoint_name(bench[0], point)))
+        outdir = os.path.join(args.outdir, bench[0], point_name(point))
+        runs.append((bench[0], point, outdir,
+                     pool.submit(gem5, outdir, bench, point,
+                                 ["--restore-init-checkpoint=%s" % cpt_dir])))
+    return runs
+
+def sweep_configs(pool):
+    """Configure every point once, and run the parameter points from it"""
+    print("Configuring %d points" % (len(benchmarks) * len(points)))
+    configs = {}
+    for bench, point in itertools.product(benchmarks, points):
+        outdir = os.path.join(args.outdir, bench[0], point_name(point),
+                              "config")
+        configs[bench[0], point] = (outdir, pool.submit(
+            gem5, outdir, bench, point, ["--config-only"]))
+    for outdir, future in configs.values():
+        if not future.result():
+            sys.exit("Could not configure %s, see %s" % (outdir, outdir))
+
+    print("Running %d simulations on %d cores" %
+          (len(configs) * len(param_points), args.jobs))
+    runs = []
+    for (name, point), (config, _) in configs.items():
+        config_ini = os.path.abspath(os.path.join(config, "config.ini"))
+        for param_point in param_points:
+            outdir = os.path.join(args.outdir, name, point_name(point),
+                                  point_name(param_point))
+            runs.append((name, point + param_point, outdir,
+                         pool.submit(gem5_cached, outdir, config_ini,
+                                     param_point)))
+    return runs
+
+with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as pool:
+    runs = sweep_configs(pool) if param_grid else sweep_checkpoints(pool)
+    rows = []
+    for name, point, outdir, future in runs:
+        ok = future.result()
+        values = read_stats(os.path.join(outdir, "stats.txt"))
+        rows.append([name] + [value for _, value in point] +
+                    [values.get(stat, "") for stat in stats] +
+                    ["ok" if ok else "failed"])
+
+header = ["benchmark"] + [options[0][0] for options in grid + param_grid] + \
+         stats + ["status"]
+with open(os.path.join(args.outdir, "results.csv"), "w", newline="") as f:
+    writer = csv.writer(f)
+    writer.writerow(header)
+    writer.writerows(rows)
+
+widths = [max(len(str(row[i])) for row in [header] + rows)
+          for i in range(len(header))]
+for row in [header] + rows:
+    print("  ".join(str(c).ljust(w) for c, w in zip(row, widths)))
@@ -35,11 +35,12 @@
 # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
-# This script is used to dump protobuf packet traces to ASCII
-# format.
+# This script is used to dump protobuf packet traces, and the binary
+# traces of MemTraceProbe, to ASCII format.
 
 import os
 import protolib
+import struct
 import subprocess
 import sys
 
@@ -48,6 +49,33 @@ util_dir = os.path.dirname(os.path.realpath(__file__))
 subprocess.check_call(['make', '--quiet', '-C', util_dir, 'packet_pb2.py'])
 import packet_pb2
 
+def decode_binary(trace_in, ascii_out):
+    """Dump the binary records of a MemTraceProbe with binary set"""
+    version, rec_size, freq_lo, freq_hi, num_ids = \
+        struct.unpack('<5I', trace_in.read(20))
+    if version != 1 or rec_size != 40:
+        print("Unsupported binary trace version", version)
+        exit(-1)
+    print("Tick frequency:", freq_lo | freq_hi << 32)
+    for i in range(num_ids):
+        (length,) = struct.unpack('<I', trace_in.read(4))
+        print('Master id %d: %s' % (i, trace_in.read(length).decode()))
+
+    print("Parsing packets")
+    num_packets = 0
+    while True:
+        rec = trace_in.read(rec_size)
+        if len(rec) < rec_size:
+            break
+        tick, addr, pc, flags, size, cmd, requestor = \
+            struct.unpack('<4QIHH', rec)
+        num_packets += 1
+        cmd = 'r' if cmd == 1 else ('w' if cmd == 4 else 'u')
+        ascii_out.write('%s,%s,%s,%s,%s,%s' % (requestor, cmd, addr, size,
+                                               flags, tick))
+        ascii_out.write(',%s\n' % pc if pc else '\n')
+    print("Parsed packets:", num_packets)
+
 def main():
     if len(sys.argv) != 3:
         print("Usage: ", sys.argv[0], " <protobuf input> <ASCII output>")
@@ -65,6 +93,12 @@ def main():
     # Read the magic number in 4-byte Little Endian
     magic_number = proto_in.read(4).decode()
 
+    if magic_number == "g5mt":
+        decode_binary(proto_in, ascii_out)
+        ascii_out.close()
+        proto_in.close()
+        return
+
     if magic_number != "gem5":
         print("Unrecognized file", sys.argv[1])
         exit(-1)
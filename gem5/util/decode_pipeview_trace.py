@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+
+
+# This script reads the protobuf pipeline view traces written by the O3
+# PipeViewTrace probe listener. By default it converts them to the text
+# format of the O3PipeView debug flag, which o3-pipeview.py takes as its
+# input. With --stalls it instead prints, for the PCs that spend the most
+# time in flight, how long their committed instances spent between each
+# pair of pipeline stages. It assumes that protoc has been executed and
+# already generated the Python package for the pipeview messages. This can
+# be done manually using:
+# protoc --python_out=. pipeview.proto
+
+import argparse
+import sys
+from collections import defaultdict
+
+import protolib
+
+# Import the pipeview proto definitions
+try:
+    import pipeview_pb2
+except:
+    print("Did not find protobuf pipeview definitions, attempting to generate")
+    from subprocess import call
+    error = call(['protoc', '--python_out=util', '--proto_path=src/proto',
+                  'src/proto/pipeview.proto'])
+    if not error:
+        print("Generated pipeview proto definitions")
+
+        try:
+            import google.protobuf
+        except:
+            print("Please install Python protobuf module")
+            exit(-1)
+
+        import pipeview_pb2
+    else:
+        print("Failed to import pipeview proto definitions")
+        exit(-1)
+
+# Stages in pipeline order, as named in the trace records
+stages = ('decode', 'rename', 'dispatch', 'issue', 'complete', 'commit')
+
+def stage_tick(inst, stage):
+    """Absolute tick at which inst reached stage, or 0 if it never did."""
+    return inst.fetch + getattr(inst, stage) if inst.HasField(stage) else 0
+
+def disasm(inst):
+    return inst.disasm if inst.HasField('disasm') else '%#x' % inst.pc
+
+def write_pipeview(inst, out):
+    out.write('O3PipeView:fetch:%d:0x%08x:%d:%d:%s\n' %
+              (inst.fetch, inst.pc, inst.upc, inst.seq_num, disasm(inst)))
+    for stage in stages[:-1]:
+        out.write('O3PipeView:%s:%d\n' % (stage, stage_tick(inst, stage)))
+    out.write('O3PipeView:retire:%d:store:%d\n' %
+              (stage_tick(inst, 'commit'), stage_tick(inst, 'store')))
+
+class PCStalls(object):
+    """Time spent by the instances of one PC waiting to leave each stage"""
+    def __init__(self):
+        self.disasm = None
+        self.committed = 0
+        self.squashed = 0
+        self.ticks = defaultdict(int)
+
+    def add(self, inst):
+        if inst.squashed:
+            self.squashed += 1
+            return
+        self.committed += 1
+        if self.disasm is None:
+            self.disasm = disasm(inst)
+        prev, prev_tick = 'fetch', inst.fetch
+        for stage in stages:
+            tick = stage_tick(inst, stage)
+            if tick:
+                self.ticks[prev] += tick - prev_tick
+                prev, prev_tick = stage, tick
+
+    def total(self):
+        return sum(self.ticks.values())
+
+def write_stalls(pcs, out, cycle_time, top):
+    columns = ('fetch', ) + stages[:-1]
+    out.write('%-18s %10s %10s' % ('pc', 'committed', 'squashed'))
+    for stage in columns:
+        out.write(' %10s' % stage)
+    out.write('  disasm\n')
+    ranked = sorted(pcs.items(), key=lambda item: item[1].total(),
+                    reverse=True)
+    for pc, stalls in ranked[:top]:
+        if not stalls.committed:
+            continue
+        out.write('%#-18x %10d %10d' % (pc, stalls.committed,
+                                         stalls.squashed))
+        # Average cycles spent in a stage before reaching the next one
+        for stage in columns:
+            out.write(' %10.1f' % (stalls.ticks[stage] / cycle_time /
+                                    stalls.committed))
+        out.write('  %s\n' % stalls.disasm)
+
+def main():
+    parser = argparse.ArgumentParser(
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+    parser.add_argument('--stalls', action='store_true', default=False,
+                        help="print a per-PC stage latency breakdown "
+                        "instead of o3-pipeview.py input")
+    parser.add_argument('-c', '--cycle-time', type=int, default=1000,
+                        help="CPU cycle time in ticks")
+    parser.add_argument('-n', '--top', type=int, default=50,
+                        help="number of PCs in the stall breakdown")
+    parser.add_argument('tracefile', help="protobuf input")
+    parser.add_argument('outfile', help="text output")
+    args = parser.parse_args()
+
+    # Open the file in read mode
+    proto_in = protolib.openFileRd(args.tracefile)
+
+    try:
+        out = open(args.outfile, 'w')
+    except IOError:
+        print("Failed to open ", args.outfile, " for writing")
+        exit(-1)
+
+    # Read the magic number in 4-byte Little Endian
+    magic_number = proto_in.read(4)
+
+    if magic_number != b"gem5":
+        print("Unrecognized file", args.tracefile)
+        exit(-1)
+
+    header = pipeview_pb2.PipeViewHeader()
+    protolib.decodeMessage(proto_in, header)
+
+    print("Object id:", header.obj_id)
+    print("Tick frequency:", header.tick_freq)
+
+    if header.ver != 0:
+        print("Warning: file version newer than decoder:", header.ver)
+        print("This decoder may not understand how to decode this file")
+
+    num_insts = 0
+    pcs = defaultdict(PCStalls)
+    inst = pipeview_pb2.PipeViewInst()
+    while protolib.decodeMessage(proto_in, inst):
+        if args.stalls:
+            pcs[inst.pc].add(inst)
+        else:
+            write_pipeview(inst, out)
+        num_insts += 1
+
+    if args.stalls:
+        write_stalls(pcs, out, args.cycle_time, args.top)
+
+    print("Parsed instructions:", num_insts)
+
+    out.close()
+    proto_in.close()
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Convert a protobuf instruction dependency trace (inst_dep_record.proto),
+# as recorded by the elastic trace probe of the O3CPU, to the uncompressed
+# fixed size record format of src/cpu/trace/mapped_dep_trace.hh.
+#
+# TraceCPU memory maps traces in that format instead of inflating and
+# parsing them, so TraceCPUs replaying the same trace (in one or several
+# gem5 processes) share one page cache copy of it, and dataTraceStart can
+# start the replay at any record without reading the ones ahead of it.
+#
+# The records are decoded as in decode_inst_dep_trace.py. Dependencies
+# are stored as distances to the sequence number of the record, up to 16
+# per record, and register dependencies that are also order dependencies
+# are dropped as TraceCPU would do on replay.
+#
+# usage: util/map_inst_dep_trace.py <protobuf input> <mapped output>
+
+import protolib
+import struct
+import sys
+
+# Import the packet proto definitions. If they are not found, attempt
+# to generate them automatically. This assumes that the script is
+# executed from the gem5 root.
+try:
+    import inst_dep_record_pb2
+except:
+    print("Did not find proto definition, attempting to generate")
+    from subprocess import call
+    error = call(['protoc', '--python_out=util', '--proto_path=src/proto',
+                  'src/proto/inst_dep_record.proto'])
+    if not error:
+        import inst_dep_record_pb2
+        print("Generated proto definitions for instruction dependency record")
+    else:
+        print("Failed to import proto definitions")
+        exit(-1)
+
+# These must match MappedDepTrace
+FORMAT_VERSION = 1
+MAX_DEPS = 16
+HEADER = struct.Struct('<8sIIQQII24x')
+RECORD = struct.Struct('<QQQQQQIIBBB5x%dI' % MAX_DEPS)
+MAGIC = b'gem5edt\0'
+
+def main():
+    if len(sys.argv) != 3:
+        print("Usage: ", sys.argv[0], " <protobuf input> <mapped output>")
+        exit(-1)
+
+    proto_in = protolib.openFileRd(sys.argv[1])
+
+    try:
+        mapped_out = open(sys.argv[2], 'wb')
+    except IOError:
+        print("Failed to open ", sys.argv[2], " for writing")
+        exit(-1)
+
+    # Read the magic number in 4-byte Little Endian
+    magic_number = proto_in.read(4)
+
+    if magic_number != b"gem5":
+        print("Unrecognized file")
+        exit(-1)
+
+    header = inst_dep_record_pb2.InstDepRecordHeader()
+    protolib.decodeMessage(proto_in, header)
+
+    print("Object id:", header.obj_id)
+    print("Tick frequency:", header.tick_freq)
+    print("Window size:", header.window_size)
+
+    def write_header(num_records):
+        mapped_out.write(HEADER.pack(MAGIC, FORMAT_VERSION,
+                                     header.window_size, header.tick_freq,
+                                     num_records, RECORD.size, MAX_DEPS))
+
+    # The number of records is filled in at the end
+    write_header(0)
+
+    num_packets = 0
+    rob_num = 0
+    packet = inst_dep_record_pb2.InstDepRecord()
+
+    # Decode the packet messages until we hit the end of the file
+    while protolib.decodeMessage(proto_in, packet):
+        num_packets += 1
+
+        # ROB occupancy number, counting the filtered out instructions
+        rob_num += 1 + packet.weight
+
+        rob_deps = list(packet.rob_dep)
+        reg_deps = [dep for dep in packet.reg_dep if dep not in rob_deps]
+        deps = rob_deps + reg_deps
+        if len(deps) > MAX_DEPS:
+            print("Seq. num", packet.seq_num, "has", len(deps),
+                  "dependencies, at most", MAX_DEPS, "are supported")
+            exit(-1)
+
+        distances = [packet.seq_num - dep for dep in deps]
+        if any(d <= 0 or d >= 2 ** 32 for d in distances):
+            print("Seq. num", packet.seq_num, "has a dependency out of "
+                  "range:", deps)
+            exit(-1)
+        distances += [0] * (MAX_DEPS - len(deps))
+
+        mapped_out.write(RECORD.pack(packet.seq_num, rob_num, packet.p_addr,
+                                     packet.v_addr, packet.pc,
+                                     packet.comp_delay, packet.size,
+                                     packet.flags, packet.type,
+                                     len(rob_deps), len(reg_deps),
+                                     *distances))
+
+    mapped_out.seek(0)
+    write_header(num_packets)
+
+    print("Converted packets:", num_packets)
+
+    # We're done
+    mapped_out.close()
+    proto_in.close()
+
+if __name__ == "__main__":
+    main()
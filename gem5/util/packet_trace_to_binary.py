@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Convert a protobuf packet trace, as written by MemTraceProbe or CommMonitor
+# and read by TraceGen, to the uncompressed binary trace format of
+# MemTraceProbe. TraceGen maps binary traces in memory and reads their
+# fixed size records in place, which replays them much faster.
+#
+# e.g.
+#   util/packet_trace_to_binary.py system.monitor.trc.gz trace.bin
+
+import os
+import protolib
+import struct
+import subprocess
+import sys
+
+util_dir = os.path.dirname(os.path.realpath(__file__))
+# Make sure the proto definitions are up to date.
+subprocess.check_call(['make', '--quiet', '-C', util_dir, 'packet_pb2.py'])
+import packet_pb2
+
+def main():
+    if len(sys.argv) != 3:
+        print("Usage: ", sys.argv[0], " <protobuf input> <binary output>")
+        exit(-1)
+
+    proto_in = protolib.openFileRd(sys.argv[1])
+    if proto_in.read(4).decode() != "gem5":
+        print("Unrecognized file", sys.argv[1])
+        exit(-1)
+
+    header = packet_pb2.PacketHeader()
+    protolib.decodeMessage(proto_in, header)
+
+    # requestor names, by id, with holes left empty
+    names = {}
+    for id_string in header.id_strings:
+        names[id_string.key] = id_string.value
+    num_ids = max(names) + 1 if names else 0
+
+    with open(sys.argv[2], 'wb') as out:
+        out.write(b"g5mt")
+        out.write(struct.pack('<5I', 1, 40, header.tick_freq & 0xffffffff,
+                              header.tick_freq >> 32, num_ids))
+        for i in range(num_ids):
+            name = names.get(i, "").encode()
+            out.write(struct.pack('<I', len(name)) + name)
+
+        num_packets = 0
+        packet = packet_pb2.Packet()
+        while protolib.decodeMessage(proto_in, packet):
+            num_packets += 1
+            out.write(struct.pack('<4QIHH', packet.tick, packet.addr,
+                                  packet.pc if packet.HasField('pc') else 0,
+                                  packet.flags, packet.size, packet.cmd,
+                                  packet.pkt_id & 0xffff))
+
+    print("Converted packets:", num_packets)
+    proto_in.close()
+
+if __name__ == "__main__":
+    main()
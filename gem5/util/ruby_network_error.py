@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+
+# Error estimate of the analytical Ruby network against garnet.
+#
+# Runs a configuration twice on the same topology, once with
+# --network=garnet and once with --network=analytical, both at the same
+# time, and reports the relative error of the analytical model on the
+# network latency, the network traffic and the simulated time.
+#
+# e.g.
+#   util/ruby_network_error.py --gem5 build/X86_MESI_Two_Level/gem5.opt \
+#       -- configs/example/ruby_random_test.py --num-cpus=16 \
+#       --topology=Mesh_XY --mesh-rows=4
+#
+# Both runs share every option given after --, which must not include
+# --network. Scripts like se.py also need --ruby there.
+
+import argparse
+import concurrent.futures
+import os
+import re
+import subprocess
+import sys
+
+STATS = [
+    ("simTicks", "simulated ticks"),
+    ("system.ruby.network.average_packet_latency",
+     "average packet latency (ticks)"),
+    ("system.ruby.network.packets_received::total", "packets received"),
+]
+
+parser = argparse.ArgumentParser(
+    description="Error of the analytical Ruby network against garnet")
+parser.add_argument("--gem5", required=True, help="gem5 binary")
+parser.add_argument("-d", "--outdir", default="network_error",
+    help="Output directory (default: %(default)s)")
+parser.add_argument("args", nargs=argparse.REMAINDER,
+    help="Configuration script and its options, after --")
+args = parser.parse_args()
+config_args = args.args[1:] if args.args[:1] == ["--"] else args.args
+if not config_args:
+    parser.error("no configuration script")
+if any(arg.startswith("--network=") or arg == "--network"
+       for arg in config_args):
+    parser.error("--network is set by this script")
+
+def gem5(network):
+    outdir = os.path.join(args.outdir, network)
+    os.makedirs(outdir, exist_ok=True)
+    cmd = [args.gem5, "-re", "-d", outdir, config_args[0],
+           "--network=%s" % network] + config_args[1:]
+    with open(os.path.join(outdir, "cmdline"), "w") as f:
+        f.write(" ".join(cmd) + "\n")
+    subprocess.call(cmd, stdout=subprocess.DEVNULL,
+                    stderr=subprocess.DEVNULL)
+
+    # the stats of the first dump
+    stats = {}
+    try:
+        with open(os.path.join(outdir, "stats.txt")) as f:
+            for line in f:
+                if line.startswith("---------- End"):
+                    break
+                m = re.match(r"(\S+)\s+(\S+)", line)
+                if m:
+                    stats[m.group(1)] = m.group(2)
+    except OSError:
+        pass
+    if not stats:
+        sys.exit("No stats in %s, see %s" %
+                 (outdir, os.path.join(outdir, "simerr")))
+    return stats
+
+with concurrent.futures.ThreadPoolExecutor(max_workers=2) as pool:
+    garnet = pool.submit(gem5, "garnet")
+    analytical = pool.submit(gem5, "analytical")
+    garnet, analytical = garnet.result(), analytical.result()
+
+print("%-32s %14s %14s %9s" % ("", "garnet", "analytical", "error"))
+for stat, desc in STATS:
+    try:
+        ref, est = float(garnet[stat]), float(analytical[stat])
+    except (KeyError, ValueError):
+        print("%-32s %14s %14s" %
+              (desc, garnet.get(stat, "-"), analytical.get(stat, "-")))
+        continue
+    error = "%+8.2f%%" % (100 * (est - ref) / ref) if ref else "-"
+    print("%-32s %14g %14g %9s" % (desc, ref, est, error))
@@ -0,0 +1,147 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""Reader for the columnar binary stat files written by the "bin://"
+stats output (statistics::Binary).
+
+Example:
+    import binary
+    df = binary.load("m5out/stats.bin")
+    df["system.cpu.numCycles"].diff()
+
+The file is memory mapped and each dump is viewed in place, so loading
+a long time series does not parse any text.
+"""
+
+import mmap
+import struct
+import sys
+
+import numpy as np
+
+MAGIC = b"gem5stb\0"
+VERSION = 1
+
+RECORD_SCHEMA = 1
+RECORD_DUMP = 2
+
+def _byte_order(mark):
+    if struct.unpack("<I", mark)[0] == 0x01020304:
+        return "<"
+    elif struct.unpack(">I", mark)[0] == 0x01020304:
+        return ">"
+    raise ValueError("Invalid byte order marker")
+
+def records(path):
+    """Iterate over the dumps in a binary stat file.
+
+    Yields (columns, ticks, values) tuples, one per schema, where
+    columns is a list of column names, ticks a 1-D array with the tick
+    of every dump and values a 2-D array with one row per dump.
+    """
+
+    with open(path, "rb") as f:
+        buf = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+
+    if buf[:8] != MAGIC:
+        raise ValueError("%s is not a binary stat file" % path)
+    order = _byte_order(buf[12:16])
+    version, = struct.unpack(order + "I", buf[8:12])
+    if version != VERSION:
+        raise ValueError("Unsupported binary stat version %d" % version)
+
+    u64 = np.dtype(order + "u8")
+    f64 = np.dtype(order + "f8")
+
+    schemas = {}
+    current = None
+    ticks = []
+    rows = []
+
+    def flush():
+        if current is not None and rows:
+            yield (schemas[current], np.array(ticks, dtype=u64),
+                   np.vstack(rows))
+
+    offset = 16
+    while offset + 16 <= len(buf):
+        rtype, _, length = struct.unpack_from(order + "IIQ", buf, offset)
+        offset += 16
+        if offset + length > len(buf):
+            # Truncated record, e.g., from a simulation that is still
+            # running.
+            break
+
+        if rtype == RECORD_SCHEMA:
+            sid, count = struct.unpack_from(order + "QQ", buf, offset)
+            pos = offset + 16
+            names = []
+            for _ in range(count):
+                n, = struct.unpack_from(order + "I", buf, pos)
+                pos += 4
+                names.append(buf[pos:pos + n].decode())
+                pos += n
+            schemas[sid] = names
+        elif rtype == RECORD_DUMP:
+            sid, tick = struct.unpack_from(order + "QQ", buf, offset)
+            if sid != current:
+                yield from flush()
+                current = sid
+                ticks = []
+                rows = []
+            ticks.append(tick)
+            rows.append(np.frombuffer(buf, dtype=f64,
+                                      count=len(schemas[sid]),
+                                      offset=offset + 16))
+
+        offset += length
+
+    yield from flush()
+
+def load(path):
+    """Load a binary stat file into a pandas DataFrame indexed by tick.
+
+    Dumps that were written with different schemas are concatenated,
+    columns that are missing from a dump are NaN.
+    """
+
+    import pandas as pd
+
+    frames = [ pd.DataFrame(values, index=pd.Index(ticks, name="tick"),
+                            columns=columns)
+               for columns, ticks, values in records(path) ]
+    if not frames:
+        return pd.DataFrame()
+    return pd.concat(frames, sort=False)
+
+if __name__ == "__main__":
+    import argparse
+
+    parser = argparse.ArgumentParser(
+        description="Convert a binary gem5 stat file to CSV.")
+    parser.add_argument("stats", help="Binary stat file")
+    parser.add_argument("--output", "-o", default=None,
+                        help="CSV output file (default: stdout)")
+    args = parser.parse_args()
+
+    load(args.stats).to_csv(args.output or sys.stdout)
@@ -0,0 +1,48 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+
+# Render a binary debug trace, recorded with --debug-binary, as the text
+# gem5 would have printed. The rendering is done by gem5 itself, so that
+# the format strings are interpreted exactly as with ccprintf, and the
+# script must be run by a gem5 binary built with TRACING_ON. e.g.
+#   build/X86/gem5.opt -re --debug-flags=Cache,MemCtrl --debug-binary \
+#       --debug-file=trace.bin configs/tutorial/cs425_pa3.py ...
+#   build/X86/gem5.opt --debug-flags=FmtFlag util/trace_format.py \
+#       m5out/trace.bin -o trace.txt
+#
+# The format debug flags (FmtFlag, FmtTicksOff) apply to the rendering,
+# not to the recording.
+
+import argparse
+import sys
+
+from m5 import trace
+
+parser = argparse.ArgumentParser(
+    description="Render a binary debug trace as text")
+parser.add_argument("trace", help="Binary debug trace")
+parser.add_argument("-o", "--output", default="-",
+    help="Text trace (default: standard output)")
+args = parser.parse_args()
+
+if not trace.formatBinary(args.trace, args.output):
+    sys.exit("Could not render all of %s" % args.trace)
@@ -0,0 +1,202 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Extract the memory access profile of a program from a binary trace of
+# MemTraceProbe (binary=True), for ProfileGen, the generator that
+# configs/example/profile_tgen.py runs to emulate the program traffic.
+#
+# The accesses are split into streams by address region: the regions are
+# separated by gaps of more than --gap bytes, and regions with less than
+# --min-share of the accesses are merged into their closest larger one.
+# For every stream, the profile has the share of the accesses, the read
+# fraction, the --reuse-bins most frequent reuse distances (in accesses
+# of the stream since the last access to the same line, up to
+# --history), and the --strides most frequent line strides between the
+# other accesses. The least frequent strides are left to random accesses
+# to the region.
+#
+# The trace only has the requests, so the think time is taken from the
+# median time between two requests, and the memory level parallelism,
+# which bounds the outstanding requests, is given by --mlp, e.g. from
+# the average MSHR occupancy of the L1 data cache in the real run.
+#
+# e.g.
+#   util/traffic_profile.py m5out/memtrace.gz mcf.json --mlp 6
+
+import argparse
+import bisect
+import collections
+import gzip
+import json
+import math
+import statistics
+import struct
+import sys
+
+def records(path):
+    """Reads, writes and their ticks of a binary MemTraceProbe trace"""
+    with open(path, 'rb') as f:
+        gzipped = f.read(2) == b'\x1f\x8b'
+    trace = gzip.open(path, 'rb') if gzipped else open(path, 'rb')
+    with trace:
+        if trace.read(4) != b'g5mt':
+            sys.exit("%s is not a binary MemTraceProbe trace" % path)
+        version, rec_size, _, _, num_ids = \
+            struct.unpack('<5I', trace.read(20))
+        if version != 1 or rec_size != 40:
+            sys.exit("Unsupported binary trace version %d" % version)
+        for _ in range(num_ids):
+            (length,) = struct.unpack('<I', trace.read(4))
+            trace.read(length)
+        while True:
+            rec = trace.read(rec_size)
+            if len(rec) < rec_size:
+                break
+            tick, addr, _, _, _, cmd, _ = struct.unpack('<4QIHH', rec)
+            # ReadReq is 1 and WriteReq is 4 in src/mem/packet.hh
+            if cmd in (1, 4):
+                yield tick, addr, cmd == 1
+
+def regions(lines, counts, gap, min_share):
+    """Address regions, in lines, of the streams"""
+    bounds = []
+    for line in lines:
+        if bounds and line - bounds[-1][1] <= gap:
+            bounds[-1][1] = line
+        else:
+            bounds.append([line, line])
+    starts = [b[0] for b in bounds]
+    accesses = [0] * len(bounds)
+    for line, count in counts.items():
+        accesses[bisect.bisect_right(starts, line) - 1] += count
+
+    total = sum(accesses)
+    kept = [i for i, n in enumerate(accesses) if n >= min_share * total]
+    if not kept:
+        kept = [max(range(len(bounds)), key=accesses.__getitem__)]
+    for i, (start, end) in enumerate(bounds):
+        if i in kept:
+            continue
+        j = min(kept, key=lambda k: min(abs(bounds[k][0] - end),
+                                        abs(start - bounds[k][1])))
+        bounds[j] = [min(bounds[j][0], start), max(bounds[j][1], end)]
+    return [bounds[k] for k in kept]
+
+def top(counter, n, total):
+    """The n most frequent values with their probabilities"""
+    return [[value, count / total] for value, count in
+            counter.most_common(n)] if total else []
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Extract a ProfileGen profile from a memory trace")
+    parser.add_argument("trace", help="Binary MemTraceProbe trace")
+    parser.add_argument("profile", help="JSON profile to write")
+    parser.add_argument("--line-size", type=int, default=64,
+        help="Line size in bytes (default: %(default)s)")
+    parser.add_argument("--gap", type=int, default=16 << 20,
+        help="Smallest gap in bytes between two regions "
+        "(default: %(default)s)")
+    parser.add_argument("--min-share", type=float, default=0.01,
+        help="Smallest share of the accesses of a stream "
+        "(default: %(default)s)")
+    parser.add_argument("--strides", type=int, default=16,
+        help="Strides per stream (default: %(default)s)")
+    parser.add_argument("--reuse-bins", type=int, default=32,
+        help="Reuse distances per stream (default: %(default)s)")
+    parser.add_argument("--history", type=int, default=1024,
+        help="Longest reuse distance (default: %(default)s)")
+    parser.add_argument("--mlp", type=int, default=4,
+        help="Outstanding requests (default: %(default)s)")
+    args = parser.parse_args()
+
+    line_size = args.line_size
+    trace = list(records(args.trace))
+    if not trace:
+        sys.exit("No reads or writes in %s" % args.trace)
+    counts = collections.Counter(addr // line_size for _, addr, _ in trace)
+    bounds = regions(sorted(counts), counts, args.gap // line_size,
+                     args.min_share)
+    starts = [b[0] for b in bounds]
+
+    streams = [{'accesses': 0, 'reads': 0, 'last': {}, 'cursor': None,
+                'strides': collections.Counter(),
+                'reuse': collections.Counter(), 'moves': 0}
+               for _ in bounds]
+    for _, addr, is_read in trace:
+        line = addr // line_size
+        s = streams[bisect.bisect_right(starts, line) - 1]
+        index = s['accesses']
+        s['accesses'] += 1
+        s['reads'] += is_read
+        dist = index - s['last'].get(line, -args.history - 1)
+        s['last'][line] = index
+        if dist <= args.history:
+            s['reuse'][dist] += 1
+            continue
+        if s['cursor'] is not None:
+            s['strides'][(line - s['cursor']) * line_size] += 1
+            s['moves'] += 1
+        s['cursor'] = line
+
+    gaps = [b[0] - a[0] for a, b in zip(trace, trace[1:])]
+    period = int(statistics.median(gaps)) if gaps else 0
+    total = len(trace)
+    profile = {
+        'line_size': line_size,
+        'min_period': period // 2,
+        'max_period': period + period // 2,
+        'max_outstanding': args.mlp,
+        'streams': [],
+        # what the generated traffic can be compared against
+        'source': {
+            'accesses': total,
+            'reads': sum(s['reads'] for s in streams),
+            'footprint': len(counts) * line_size,
+            'ticks': trace[-1][0] - trace[0][0],
+        },
+    }
+    for (start, end), s in zip(bounds, streams):
+        n = s['accesses']
+        # reuse distances are binned by powers of two, at the middle of
+        # their bin
+        bins = collections.Counter()
+        for dist, count in s['reuse'].items():
+            low = 1 << int(math.log2(dist))
+            bins[(low + min(2 * low - 1, args.history)) // 2] += count
+        profile['streams'].append({
+            'start': start * line_size,
+            'end': (end + 1) * line_size,
+            'weight': n / total,
+            'read_fraction': s['reads'] / n,
+            'strides': top(s['strides'], args.strides, s['moves']),
+            'reuse': top(bins, args.reuse_bins, n),
+        })
+
+    with open(args.profile, 'w') as f:
+        json.dump(profile, f, indent=2)
+    print("%d accesses, %d streams, %d bytes footprint" %
+          (total, len(bounds), profile['source']['footprint']))
+
+if __name__ == "__main__":
+    main()